@@ -0,0 +1,121 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/al/auxeffectslot.cpp" "CMakeFiles/OpenAL.dir/al/auxeffectslot.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/auxeffectslot.cpp.o.d"
+  "/root/repo/al/buffer.cpp" "CMakeFiles/OpenAL.dir/al/buffer.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/buffer.cpp.o.d"
+  "/root/repo/al/debug.cpp" "CMakeFiles/OpenAL.dir/al/debug.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/debug.cpp.o.d"
+  "/root/repo/al/effect.cpp" "CMakeFiles/OpenAL.dir/al/effect.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/effect.cpp.o.d"
+  "/root/repo/al/effects/autowah.cpp" "CMakeFiles/OpenAL.dir/al/effects/autowah.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/effects/autowah.cpp.o.d"
+  "/root/repo/al/effects/chorus.cpp" "CMakeFiles/OpenAL.dir/al/effects/chorus.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/effects/chorus.cpp.o.d"
+  "/root/repo/al/effects/compressor.cpp" "CMakeFiles/OpenAL.dir/al/effects/compressor.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/effects/compressor.cpp.o.d"
+  "/root/repo/al/effects/convolution.cpp" "CMakeFiles/OpenAL.dir/al/effects/convolution.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/effects/convolution.cpp.o.d"
+  "/root/repo/al/effects/dedicated.cpp" "CMakeFiles/OpenAL.dir/al/effects/dedicated.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/effects/dedicated.cpp.o.d"
+  "/root/repo/al/effects/distortion.cpp" "CMakeFiles/OpenAL.dir/al/effects/distortion.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/effects/distortion.cpp.o.d"
+  "/root/repo/al/effects/echo.cpp" "CMakeFiles/OpenAL.dir/al/effects/echo.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/effects/echo.cpp.o.d"
+  "/root/repo/al/effects/effects.cpp" "CMakeFiles/OpenAL.dir/al/effects/effects.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/effects/effects.cpp.o.d"
+  "/root/repo/al/effects/equalizer.cpp" "CMakeFiles/OpenAL.dir/al/effects/equalizer.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/effects/equalizer.cpp.o.d"
+  "/root/repo/al/effects/fshifter.cpp" "CMakeFiles/OpenAL.dir/al/effects/fshifter.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/effects/fshifter.cpp.o.d"
+  "/root/repo/al/effects/modulator.cpp" "CMakeFiles/OpenAL.dir/al/effects/modulator.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/effects/modulator.cpp.o.d"
+  "/root/repo/al/effects/null.cpp" "CMakeFiles/OpenAL.dir/al/effects/null.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/effects/null.cpp.o.d"
+  "/root/repo/al/effects/pshifter.cpp" "CMakeFiles/OpenAL.dir/al/effects/pshifter.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/effects/pshifter.cpp.o.d"
+  "/root/repo/al/effects/reverb.cpp" "CMakeFiles/OpenAL.dir/al/effects/reverb.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/effects/reverb.cpp.o.d"
+  "/root/repo/al/effects/sourcegroup.cpp" "CMakeFiles/OpenAL.dir/al/effects/sourcegroup.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/effects/sourcegroup.cpp.o.d"
+  "/root/repo/al/effects/vmorpher.cpp" "CMakeFiles/OpenAL.dir/al/effects/vmorpher.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/effects/vmorpher.cpp.o.d"
+  "/root/repo/al/error.cpp" "CMakeFiles/OpenAL.dir/al/error.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/error.cpp.o.d"
+  "/root/repo/al/event.cpp" "CMakeFiles/OpenAL.dir/al/event.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/event.cpp.o.d"
+  "/root/repo/al/extension.cpp" "CMakeFiles/OpenAL.dir/al/extension.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/extension.cpp.o.d"
+  "/root/repo/al/filter.cpp" "CMakeFiles/OpenAL.dir/al/filter.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/filter.cpp.o.d"
+  "/root/repo/al/listener.cpp" "CMakeFiles/OpenAL.dir/al/listener.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/listener.cpp.o.d"
+  "/root/repo/al/source.cpp" "CMakeFiles/OpenAL.dir/al/source.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/source.cpp.o.d"
+  "/root/repo/al/state.cpp" "CMakeFiles/OpenAL.dir/al/state.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/al/state.cpp.o.d"
+  "/root/repo/alc/alc.cpp" "CMakeFiles/OpenAL.dir/alc/alc.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/alc.cpp.o.d"
+  "/root/repo/alc/alconfig.cpp" "CMakeFiles/OpenAL.dir/alc/alconfig.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/alconfig.cpp.o.d"
+  "/root/repo/alc/alu.cpp" "CMakeFiles/OpenAL.dir/alc/alu.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/alu.cpp.o.d"
+  "/root/repo/alc/backends/base.cpp" "CMakeFiles/OpenAL.dir/alc/backends/base.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/backends/base.cpp.o.d"
+  "/root/repo/alc/backends/loopback.cpp" "CMakeFiles/OpenAL.dir/alc/backends/loopback.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/backends/loopback.cpp.o.d"
+  "/root/repo/alc/backends/null.cpp" "CMakeFiles/OpenAL.dir/alc/backends/null.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/backends/null.cpp.o.d"
+  "/root/repo/alc/backends/oss.cpp" "CMakeFiles/OpenAL.dir/alc/backends/oss.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/backends/oss.cpp.o.d"
+  "/root/repo/alc/backends/shmem.cpp" "CMakeFiles/OpenAL.dir/alc/backends/shmem.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/backends/shmem.cpp.o.d"
+  "/root/repo/alc/backends/wave.cpp" "CMakeFiles/OpenAL.dir/alc/backends/wave.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/backends/wave.cpp.o.d"
+  "/root/repo/alc/context.cpp" "CMakeFiles/OpenAL.dir/alc/context.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/context.cpp.o.d"
+  "/root/repo/alc/device.cpp" "CMakeFiles/OpenAL.dir/alc/device.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/device.cpp.o.d"
+  "/root/repo/alc/effects/autowah.cpp" "CMakeFiles/OpenAL.dir/alc/effects/autowah.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/effects/autowah.cpp.o.d"
+  "/root/repo/alc/effects/chorus.cpp" "CMakeFiles/OpenAL.dir/alc/effects/chorus.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/effects/chorus.cpp.o.d"
+  "/root/repo/alc/effects/compressor.cpp" "CMakeFiles/OpenAL.dir/alc/effects/compressor.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/effects/compressor.cpp.o.d"
+  "/root/repo/alc/effects/convolution.cpp" "CMakeFiles/OpenAL.dir/alc/effects/convolution.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/effects/convolution.cpp.o.d"
+  "/root/repo/alc/effects/dedicated.cpp" "CMakeFiles/OpenAL.dir/alc/effects/dedicated.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/effects/dedicated.cpp.o.d"
+  "/root/repo/alc/effects/distortion.cpp" "CMakeFiles/OpenAL.dir/alc/effects/distortion.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/effects/distortion.cpp.o.d"
+  "/root/repo/alc/effects/echo.cpp" "CMakeFiles/OpenAL.dir/alc/effects/echo.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/effects/echo.cpp.o.d"
+  "/root/repo/alc/effects/equalizer.cpp" "CMakeFiles/OpenAL.dir/alc/effects/equalizer.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/effects/equalizer.cpp.o.d"
+  "/root/repo/alc/effects/fshifter.cpp" "CMakeFiles/OpenAL.dir/alc/effects/fshifter.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/effects/fshifter.cpp.o.d"
+  "/root/repo/alc/effects/modulator.cpp" "CMakeFiles/OpenAL.dir/alc/effects/modulator.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/effects/modulator.cpp.o.d"
+  "/root/repo/alc/effects/null.cpp" "CMakeFiles/OpenAL.dir/alc/effects/null.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/effects/null.cpp.o.d"
+  "/root/repo/alc/effects/pshifter.cpp" "CMakeFiles/OpenAL.dir/alc/effects/pshifter.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/effects/pshifter.cpp.o.d"
+  "/root/repo/alc/effects/reverb.cpp" "CMakeFiles/OpenAL.dir/alc/effects/reverb.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/effects/reverb.cpp.o.d"
+  "/root/repo/alc/effects/sourcegroup.cpp" "CMakeFiles/OpenAL.dir/alc/effects/sourcegroup.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/effects/sourcegroup.cpp.o.d"
+  "/root/repo/alc/effects/vmorpher.cpp" "CMakeFiles/OpenAL.dir/alc/effects/vmorpher.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/effects/vmorpher.cpp.o.d"
+  "/root/repo/alc/events.cpp" "CMakeFiles/OpenAL.dir/alc/events.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/events.cpp.o.d"
+  "/root/repo/alc/panning.cpp" "CMakeFiles/OpenAL.dir/alc/panning.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/alc/panning.cpp.o.d"
+  "/root/repo/core/ambdec.cpp" "CMakeFiles/OpenAL.dir/core/ambdec.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/ambdec.cpp.o.d"
+  "/root/repo/core/ambidefs.cpp" "CMakeFiles/OpenAL.dir/core/ambidefs.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/ambidefs.cpp.o.d"
+  "/root/repo/core/bformatdec.cpp" "CMakeFiles/OpenAL.dir/core/bformatdec.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/bformatdec.cpp.o.d"
+  "/root/repo/core/bs2b.cpp" "CMakeFiles/OpenAL.dir/core/bs2b.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/bs2b.cpp.o.d"
+  "/root/repo/core/bsinc_tables.cpp" "CMakeFiles/OpenAL.dir/core/bsinc_tables.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/bsinc_tables.cpp.o.d"
+  "/root/repo/core/buffer_storage.cpp" "CMakeFiles/OpenAL.dir/core/buffer_storage.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/buffer_storage.cpp.o.d"
+  "/root/repo/core/context.cpp" "CMakeFiles/OpenAL.dir/core/context.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/context.cpp.o.d"
+  "/root/repo/core/converter.cpp" "CMakeFiles/OpenAL.dir/core/converter.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/converter.cpp.o.d"
+  "/root/repo/core/convolution_offload.cpp" "CMakeFiles/OpenAL.dir/core/convolution_offload.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/convolution_offload.cpp.o.d"
+  "/root/repo/core/cpu_caps.cpp" "CMakeFiles/OpenAL.dir/core/cpu_caps.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/cpu_caps.cpp.o.d"
+  "/root/repo/core/cubic_tables.cpp" "CMakeFiles/OpenAL.dir/core/cubic_tables.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/cubic_tables.cpp.o.d"
+  "/root/repo/core/devformat.cpp" "CMakeFiles/OpenAL.dir/core/devformat.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/devformat.cpp.o.d"
+  "/root/repo/core/device.cpp" "CMakeFiles/OpenAL.dir/core/device.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/device.cpp.o.d"
+  "/root/repo/core/effects/rate_converter.cpp" "CMakeFiles/OpenAL.dir/core/effects/rate_converter.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/effects/rate_converter.cpp.o.d"
+  "/root/repo/core/effectslot.cpp" "CMakeFiles/OpenAL.dir/core/effectslot.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/effectslot.cpp.o.d"
+  "/root/repo/core/except.cpp" "CMakeFiles/OpenAL.dir/core/except.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/except.cpp.o.d"
+  "/root/repo/core/filters/biquad.cpp" "CMakeFiles/OpenAL.dir/core/filters/biquad.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/filters/biquad.cpp.o.d"
+  "/root/repo/core/filters/nfc.cpp" "CMakeFiles/OpenAL.dir/core/filters/nfc.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/filters/nfc.cpp.o.d"
+  "/root/repo/core/filters/splitter.cpp" "CMakeFiles/OpenAL.dir/core/filters/splitter.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/filters/splitter.cpp.o.d"
+  "/root/repo/core/fmt_traits.cpp" "CMakeFiles/OpenAL.dir/core/fmt_traits.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/fmt_traits.cpp.o.d"
+  "/root/repo/core/fpu_ctrl.cpp" "CMakeFiles/OpenAL.dir/core/fpu_ctrl.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/fpu_ctrl.cpp.o.d"
+  "/root/repo/core/helpers.cpp" "CMakeFiles/OpenAL.dir/core/helpers.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/helpers.cpp.o.d"
+  "/root/repo/core/hrtf.cpp" "CMakeFiles/OpenAL.dir/core/hrtf.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/hrtf.cpp.o.d"
+  "/root/repo/core/logging.cpp" "CMakeFiles/OpenAL.dir/core/logging.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/logging.cpp.o.d"
+  "/root/repo/core/mastering.cpp" "CMakeFiles/OpenAL.dir/core/mastering.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/mastering.cpp.o.d"
+  "/root/repo/core/mixer.cpp" "CMakeFiles/OpenAL.dir/core/mixer.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/mixer.cpp.o.d"
+  "/root/repo/core/mixer/mixer_avx2.cpp" "CMakeFiles/OpenAL.dir/core/mixer/mixer_avx2.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/mixer/mixer_avx2.cpp.o.d"
+  "/root/repo/core/mixer/mixer_c.cpp" "CMakeFiles/OpenAL.dir/core/mixer/mixer_c.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/mixer/mixer_c.cpp.o.d"
+  "/root/repo/core/mixer/mixer_sse.cpp" "CMakeFiles/OpenAL.dir/core/mixer/mixer_sse.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/mixer/mixer_sse.cpp.o.d"
+  "/root/repo/core/mixer/mixer_sse2.cpp" "CMakeFiles/OpenAL.dir/core/mixer/mixer_sse2.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/mixer/mixer_sse2.cpp.o.d"
+  "/root/repo/core/mixer/mixer_sse3.cpp" "CMakeFiles/OpenAL.dir/core/mixer/mixer_sse3.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/mixer/mixer_sse3.cpp.o.d"
+  "/root/repo/core/mixer/mixer_sse41.cpp" "CMakeFiles/OpenAL.dir/core/mixer/mixer_sse41.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/mixer/mixer_sse41.cpp.o.d"
+  "/root/repo/core/mixer_pool.cpp" "CMakeFiles/OpenAL.dir/core/mixer_pool.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/mixer_pool.cpp.o.d"
+  "/root/repo/core/param_thread.cpp" "CMakeFiles/OpenAL.dir/core/param_thread.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/param_thread.cpp.o.d"
+  "/root/repo/core/render_pool.cpp" "CMakeFiles/OpenAL.dir/core/render_pool.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/render_pool.cpp.o.d"
+  "/root/repo/core/storage_formats.cpp" "CMakeFiles/OpenAL.dir/core/storage_formats.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/storage_formats.cpp.o.d"
+  "/root/repo/core/tracing.cpp" "CMakeFiles/OpenAL.dir/core/tracing.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/tracing.cpp.o.d"
+  "/root/repo/core/uhjfilter.cpp" "CMakeFiles/OpenAL.dir/core/uhjfilter.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/uhjfilter.cpp.o.d"
+  "/root/repo/core/uiddefs.cpp" "CMakeFiles/OpenAL.dir/core/uiddefs.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/uiddefs.cpp.o.d"
+  "/root/repo/core/voice.cpp" "CMakeFiles/OpenAL.dir/core/voice.cpp.o" "gcc" "CMakeFiles/OpenAL.dir/core/voice.cpp.o.d"
+  )
+
+# Pairs of files generated by the same build rule.
+set(CMAKE_MULTIPLE_OUTPUT_PAIRS
+  "/root/repo/_bench_build/libopenal.so" "/root/repo/_bench_build/libopenal.so.1.23.1"
+  "/root/repo/_bench_build/libopenal.so.1" "/root/repo/_bench_build/libopenal.so.1.23.1"
+  )
+
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_bench_build/CMakeFiles/alcommon.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/al-excommon.dir/examples/common/alhelpers.c.o"
+  "CMakeFiles/al-excommon.dir/examples/common/alhelpers.c.o.d"
+  "libal-excommon.a"
+  "libal-excommon.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/al-excommon.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
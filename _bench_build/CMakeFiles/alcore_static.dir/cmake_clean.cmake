@@ -0,0 +1,89 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/alcore_static.dir/core/ambdec.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/ambdec.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/ambidefs.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/ambidefs.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/bformatdec.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/bformatdec.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/bs2b.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/bs2b.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/bsinc_tables.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/bsinc_tables.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/buffer_storage.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/buffer_storage.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/context.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/context.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/converter.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/converter.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/convolution_offload.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/convolution_offload.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/cpu_caps.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/cpu_caps.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/cubic_tables.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/cubic_tables.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/devformat.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/devformat.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/device.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/device.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/effects/rate_converter.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/effects/rate_converter.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/effectslot.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/effectslot.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/except.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/except.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/filters/biquad.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/filters/biquad.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/filters/nfc.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/filters/nfc.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/filters/splitter.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/filters/splitter.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/fmt_traits.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/fmt_traits.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/fpu_ctrl.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/fpu_ctrl.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/helpers.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/helpers.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/hrtf.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/hrtf.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/logging.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/logging.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/mastering.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/mastering.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/mixer.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/mixer.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/mixer/mixer_avx2.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/mixer/mixer_avx2.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/mixer/mixer_c.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/mixer/mixer_c.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/mixer/mixer_sse.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/mixer/mixer_sse.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/mixer/mixer_sse2.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/mixer/mixer_sse2.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/mixer/mixer_sse3.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/mixer/mixer_sse3.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/mixer/mixer_sse41.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/mixer/mixer_sse41.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/mixer_pool.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/mixer_pool.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/param_thread.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/param_thread.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/render_pool.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/render_pool.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/storage_formats.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/storage_formats.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/tracing.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/tracing.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/uhjfilter.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/uhjfilter.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/uiddefs.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/uiddefs.cpp.o.d"
+  "CMakeFiles/alcore_static.dir/core/voice.cpp.o"
+  "CMakeFiles/alcore_static.dir/core/voice.cpp.o.d"
+  "libalcore_static.a"
+  "libalcore_static.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/alcore_static.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
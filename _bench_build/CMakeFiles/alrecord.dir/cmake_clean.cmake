@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/alrecord.dir/examples/alrecord.c.o"
+  "CMakeFiles/alrecord.dir/examples/alrecord.c.o.d"
+  "alrecord"
+  "alrecord.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/alrecord.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
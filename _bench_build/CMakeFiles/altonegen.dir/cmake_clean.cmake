@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/altonegen.dir/examples/altonegen.c.o"
+  "CMakeFiles/altonegen.dir/examples/altonegen.c.o.d"
+  "altonegen"
+  "altonegen.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/altonegen.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
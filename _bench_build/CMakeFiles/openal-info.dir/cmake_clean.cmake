@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/openal-info.dir/utils/openal-info.c.o"
+  "CMakeFiles/openal-info.dir/utils/openal-info.c.o.d"
+  "openal-info"
+  "openal-info.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/openal-info.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
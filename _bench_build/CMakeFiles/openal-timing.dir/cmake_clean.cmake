@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/openal-timing.dir/utils/openal-timing.c.o"
+  "CMakeFiles/openal-timing.dir/utils/openal-timing.c.o.d"
+  "openal-timing"
+  "openal-timing.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/openal-timing.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,23 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/benchmarks/bench_filters.cpp" "benchmarks/CMakeFiles/OpenAL_Benchmarks.dir/bench_filters.cpp.o" "gcc" "benchmarks/CMakeFiles/OpenAL_Benchmarks.dir/bench_filters.cpp.o.d"
+  "/root/repo/benchmarks/bench_main.cpp" "benchmarks/CMakeFiles/OpenAL_Benchmarks.dir/bench_main.cpp.o" "gcc" "benchmarks/CMakeFiles/OpenAL_Benchmarks.dir/bench_main.cpp.o.d"
+  "/root/repo/benchmarks/bench_mixer.cpp" "benchmarks/CMakeFiles/OpenAL_Benchmarks.dir/bench_mixer.cpp.o" "gcc" "benchmarks/CMakeFiles/OpenAL_Benchmarks.dir/bench_mixer.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_bench_build/CMakeFiles/alcore_static.dir/DependInfo.cmake"
+  "/root/repo/_bench_build/CMakeFiles/alcommon.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/OpenAL_Benchmarks.dir/bench_filters.cpp.o"
+  "CMakeFiles/OpenAL_Benchmarks.dir/bench_filters.cpp.o.d"
+  "CMakeFiles/OpenAL_Benchmarks.dir/bench_main.cpp.o"
+  "CMakeFiles/OpenAL_Benchmarks.dir/bench_main.cpp.o.d"
+  "CMakeFiles/OpenAL_Benchmarks.dir/bench_mixer.cpp.o"
+  "CMakeFiles/OpenAL_Benchmarks.dir/bench_mixer.cpp.o.d"
+  "OpenAL_Benchmarks"
+  "OpenAL_Benchmarks.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/OpenAL_Benchmarks.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,57 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/core/ambdec.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/ambdec.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/ambdec.cpp.o.d"
+  "/root/repo/core/ambidefs.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/ambidefs.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/ambidefs.cpp.o.d"
+  "/root/repo/core/bformatdec.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/bformatdec.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/bformatdec.cpp.o.d"
+  "/root/repo/core/bs2b.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/bs2b.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/bs2b.cpp.o.d"
+  "/root/repo/core/bsinc_tables.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/bsinc_tables.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/bsinc_tables.cpp.o.d"
+  "/root/repo/core/buffer_storage.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/buffer_storage.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/buffer_storage.cpp.o.d"
+  "/root/repo/core/context.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/context.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/context.cpp.o.d"
+  "/root/repo/core/converter.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/converter.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/converter.cpp.o.d"
+  "/root/repo/core/cpu_caps.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/cpu_caps.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/cpu_caps.cpp.o.d"
+  "/root/repo/core/cubic_tables.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/cubic_tables.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/cubic_tables.cpp.o.d"
+  "/root/repo/core/devformat.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/devformat.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/devformat.cpp.o.d"
+  "/root/repo/core/device.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/device.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/device.cpp.o.d"
+  "/root/repo/core/effects/rate_converter.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/effects/rate_converter.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/effects/rate_converter.cpp.o.d"
+  "/root/repo/core/effectslot.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/effectslot.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/effectslot.cpp.o.d"
+  "/root/repo/core/except.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/except.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/except.cpp.o.d"
+  "/root/repo/core/filters/biquad.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/filters/biquad.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/filters/biquad.cpp.o.d"
+  "/root/repo/core/filters/nfc.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/filters/nfc.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/filters/nfc.cpp.o.d"
+  "/root/repo/core/filters/splitter.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/filters/splitter.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/filters/splitter.cpp.o.d"
+  "/root/repo/core/fmt_traits.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/fmt_traits.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/fmt_traits.cpp.o.d"
+  "/root/repo/core/fpu_ctrl.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/fpu_ctrl.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/fpu_ctrl.cpp.o.d"
+  "/root/repo/core/helpers.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/helpers.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/helpers.cpp.o.d"
+  "/root/repo/core/hrtf.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/hrtf.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/hrtf.cpp.o.d"
+  "/root/repo/core/logging.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/logging.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/logging.cpp.o.d"
+  "/root/repo/core/mastering.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/mastering.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/mastering.cpp.o.d"
+  "/root/repo/core/mixer.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/mixer.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/mixer.cpp.o.d"
+  "/root/repo/core/mixer/mixer_avx2.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/mixer/mixer_avx2.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/mixer/mixer_avx2.cpp.o.d"
+  "/root/repo/core/mixer/mixer_c.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/mixer/mixer_c.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/mixer/mixer_c.cpp.o.d"
+  "/root/repo/core/mixer/mixer_sse.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/mixer/mixer_sse.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/mixer/mixer_sse.cpp.o.d"
+  "/root/repo/core/mixer/mixer_sse2.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/mixer/mixer_sse2.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/mixer/mixer_sse2.cpp.o.d"
+  "/root/repo/core/mixer/mixer_sse3.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/mixer/mixer_sse3.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/mixer/mixer_sse3.cpp.o.d"
+  "/root/repo/core/mixer/mixer_sse41.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/mixer/mixer_sse41.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/mixer/mixer_sse41.cpp.o.d"
+  "/root/repo/core/mixer_pool.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/mixer_pool.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/mixer_pool.cpp.o.d"
+  "/root/repo/core/render_pool.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/render_pool.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/render_pool.cpp.o.d"
+  "/root/repo/core/storage_formats.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/storage_formats.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/storage_formats.cpp.o.d"
+  "/root/repo/core/tracing.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/tracing.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/tracing.cpp.o.d"
+  "/root/repo/core/uhjfilter.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/uhjfilter.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/uhjfilter.cpp.o.d"
+  "/root/repo/core/uiddefs.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/uiddefs.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/uiddefs.cpp.o.d"
+  "/root/repo/core/voice.cpp" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/voice.cpp.o" "gcc" "benchmarks/CMakeFiles/alcore_bench.dir/__/core/voice.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_bench_build/CMakeFiles/alcommon.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,85 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/alcore_bench.dir/__/core/ambdec.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/ambdec.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/ambidefs.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/ambidefs.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/bformatdec.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/bformatdec.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/bs2b.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/bs2b.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/bsinc_tables.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/bsinc_tables.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/buffer_storage.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/buffer_storage.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/context.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/context.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/converter.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/converter.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/cpu_caps.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/cpu_caps.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/cubic_tables.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/cubic_tables.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/devformat.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/devformat.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/device.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/device.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/effects/rate_converter.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/effects/rate_converter.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/effectslot.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/effectslot.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/except.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/except.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/filters/biquad.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/filters/biquad.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/filters/nfc.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/filters/nfc.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/filters/splitter.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/filters/splitter.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/fmt_traits.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/fmt_traits.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/fpu_ctrl.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/fpu_ctrl.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/helpers.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/helpers.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/hrtf.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/hrtf.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/logging.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/logging.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/mastering.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/mastering.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/mixer.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/mixer.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/mixer/mixer_avx2.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/mixer/mixer_avx2.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/mixer/mixer_c.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/mixer/mixer_c.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/mixer/mixer_sse.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/mixer/mixer_sse.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/mixer/mixer_sse2.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/mixer/mixer_sse2.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/mixer/mixer_sse3.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/mixer/mixer_sse3.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/mixer/mixer_sse41.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/mixer/mixer_sse41.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/mixer_pool.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/mixer_pool.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/render_pool.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/render_pool.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/storage_formats.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/storage_formats.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/tracing.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/tracing.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/uhjfilter.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/uhjfilter.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/uiddefs.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/uiddefs.cpp.o.d"
+  "CMakeFiles/alcore_bench.dir/__/core/voice.cpp.o"
+  "CMakeFiles/alcore_bench.dir/__/core/voice.cpp.o.d"
+  "libalcore_bench.a"
+  "libalcore_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/alcore_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/alscenebench.dir/alscenebench.cpp.o"
+  "CMakeFiles/alscenebench.dir/alscenebench.cpp.o.d"
+  "alscenebench"
+  "alscenebench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/alscenebench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
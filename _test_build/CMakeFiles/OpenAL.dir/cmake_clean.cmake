@@ -0,0 +1,206 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/OpenAL.dir/al/auxeffectslot.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/auxeffectslot.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/al/buffer.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/buffer.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/al/debug.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/debug.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/al/effect.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/effect.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/al/effects/autowah.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/effects/autowah.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/al/effects/chorus.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/effects/chorus.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/al/effects/compressor.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/effects/compressor.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/al/effects/convolution.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/effects/convolution.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/al/effects/dedicated.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/effects/dedicated.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/al/effects/distortion.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/effects/distortion.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/al/effects/echo.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/effects/echo.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/al/effects/effects.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/effects/effects.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/al/effects/equalizer.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/effects/equalizer.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/al/effects/fshifter.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/effects/fshifter.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/al/effects/modulator.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/effects/modulator.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/al/effects/null.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/effects/null.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/al/effects/pshifter.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/effects/pshifter.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/al/effects/reverb.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/effects/reverb.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/al/effects/sourcegroup.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/effects/sourcegroup.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/al/effects/vmorpher.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/effects/vmorpher.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/al/error.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/error.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/al/event.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/event.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/al/extension.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/extension.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/al/filter.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/filter.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/al/listener.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/listener.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/al/source.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/source.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/al/state.cpp.o"
+  "CMakeFiles/OpenAL.dir/al/state.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/alc.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/alc.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/alconfig.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/alconfig.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/alu.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/alu.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/backends/base.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/backends/base.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/backends/loopback.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/backends/loopback.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/backends/null.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/backends/null.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/backends/oss.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/backends/oss.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/backends/shmem.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/backends/shmem.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/backends/wave.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/backends/wave.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/context.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/context.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/device.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/device.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/effects/autowah.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/effects/autowah.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/effects/chorus.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/effects/chorus.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/effects/compressor.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/effects/compressor.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/effects/convolution.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/effects/convolution.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/effects/dedicated.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/effects/dedicated.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/effects/distortion.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/effects/distortion.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/effects/echo.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/effects/echo.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/effects/equalizer.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/effects/equalizer.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/effects/fshifter.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/effects/fshifter.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/effects/modulator.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/effects/modulator.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/effects/null.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/effects/null.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/effects/pshifter.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/effects/pshifter.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/effects/reverb.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/effects/reverb.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/effects/sourcegroup.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/effects/sourcegroup.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/effects/vmorpher.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/effects/vmorpher.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/events.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/events.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/alc/panning.cpp.o"
+  "CMakeFiles/OpenAL.dir/alc/panning.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/ambdec.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/ambdec.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/ambidefs.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/ambidefs.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/bformatdec.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/bformatdec.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/bs2b.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/bs2b.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/bsinc_tables.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/bsinc_tables.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/buffer_storage.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/buffer_storage.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/context.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/context.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/converter.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/converter.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/convolution_offload.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/convolution_offload.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/cpu_caps.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/cpu_caps.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/cubic_tables.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/cubic_tables.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/dbus_wrap.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/dbus_wrap.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/devformat.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/devformat.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/device.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/device.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/effects/rate_converter.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/effects/rate_converter.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/effectslot.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/effectslot.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/except.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/except.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/filters/biquad.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/filters/biquad.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/filters/nfc.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/filters/nfc.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/filters/splitter.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/filters/splitter.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/fmt_traits.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/fmt_traits.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/fpu_ctrl.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/fpu_ctrl.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/helpers.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/helpers.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/hrtf.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/hrtf.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/logging.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/logging.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/mastering.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/mastering.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/mixer.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/mixer.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/mixer/mixer_avx2.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/mixer/mixer_avx2.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/mixer/mixer_c.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/mixer/mixer_c.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/mixer/mixer_sse.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/mixer/mixer_sse.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/mixer/mixer_sse2.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/mixer/mixer_sse2.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/mixer/mixer_sse3.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/mixer/mixer_sse3.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/mixer/mixer_sse41.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/mixer/mixer_sse41.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/mixer_pool.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/mixer_pool.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/param_thread.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/param_thread.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/render_pool.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/render_pool.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/rtkit.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/rtkit.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/storage_formats.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/storage_formats.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/tracing.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/tracing.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/uhjfilter.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/uhjfilter.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/uiddefs.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/uiddefs.cpp.o.d"
+  "CMakeFiles/OpenAL.dir/core/voice.cpp.o"
+  "CMakeFiles/OpenAL.dir/core/voice.cpp.o.d"
+  "default_hrtf.txt"
+  "libopenal.pdb"
+  "libopenal.so"
+  "libopenal.so.1"
+  "libopenal.so.1.23.1"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/OpenAL.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,29 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/common/alassert.cpp" "CMakeFiles/alcommon.dir/common/alassert.cpp.o" "gcc" "CMakeFiles/alcommon.dir/common/alassert.cpp.o.d"
+  "/root/repo/common/alcomplex.cpp" "CMakeFiles/alcommon.dir/common/alcomplex.cpp.o" "gcc" "CMakeFiles/alcommon.dir/common/alcomplex.cpp.o.d"
+  "/root/repo/common/alsem.cpp" "CMakeFiles/alcommon.dir/common/alsem.cpp.o" "gcc" "CMakeFiles/alcommon.dir/common/alsem.cpp.o.d"
+  "/root/repo/common/alstring.cpp" "CMakeFiles/alcommon.dir/common/alstring.cpp.o" "gcc" "CMakeFiles/alcommon.dir/common/alstring.cpp.o.d"
+  "/root/repo/common/althrd_setname.cpp" "CMakeFiles/alcommon.dir/common/althrd_setname.cpp.o" "gcc" "CMakeFiles/alcommon.dir/common/althrd_setname.cpp.o.d"
+  "/root/repo/common/dynload.cpp" "CMakeFiles/alcommon.dir/common/dynload.cpp.o" "gcc" "CMakeFiles/alcommon.dir/common/dynload.cpp.o.d"
+  "/root/repo/common/fixedpool.cpp" "CMakeFiles/alcommon.dir/common/fixedpool.cpp.o" "gcc" "CMakeFiles/alcommon.dir/common/fixedpool.cpp.o.d"
+  "/root/repo/common/pffft.cpp" "CMakeFiles/alcommon.dir/common/pffft.cpp.o" "gcc" "CMakeFiles/alcommon.dir/common/pffft.cpp.o.d"
+  "/root/repo/common/polyphase_resampler.cpp" "CMakeFiles/alcommon.dir/common/polyphase_resampler.cpp.o" "gcc" "CMakeFiles/alcommon.dir/common/polyphase_resampler.cpp.o.d"
+  "/root/repo/common/ringbuffer.cpp" "CMakeFiles/alcommon.dir/common/ringbuffer.cpp.o" "gcc" "CMakeFiles/alcommon.dir/common/ringbuffer.cpp.o.d"
+  "/root/repo/common/strutils.cpp" "CMakeFiles/alcommon.dir/common/strutils.cpp.o" "gcc" "CMakeFiles/alcommon.dir/common/strutils.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,31 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/alcommon.dir/common/alassert.cpp.o"
+  "CMakeFiles/alcommon.dir/common/alassert.cpp.o.d"
+  "CMakeFiles/alcommon.dir/common/alcomplex.cpp.o"
+  "CMakeFiles/alcommon.dir/common/alcomplex.cpp.o.d"
+  "CMakeFiles/alcommon.dir/common/alsem.cpp.o"
+  "CMakeFiles/alcommon.dir/common/alsem.cpp.o.d"
+  "CMakeFiles/alcommon.dir/common/alstring.cpp.o"
+  "CMakeFiles/alcommon.dir/common/alstring.cpp.o.d"
+  "CMakeFiles/alcommon.dir/common/althrd_setname.cpp.o"
+  "CMakeFiles/alcommon.dir/common/althrd_setname.cpp.o.d"
+  "CMakeFiles/alcommon.dir/common/dynload.cpp.o"
+  "CMakeFiles/alcommon.dir/common/dynload.cpp.o.d"
+  "CMakeFiles/alcommon.dir/common/fixedpool.cpp.o"
+  "CMakeFiles/alcommon.dir/common/fixedpool.cpp.o.d"
+  "CMakeFiles/alcommon.dir/common/pffft.cpp.o"
+  "CMakeFiles/alcommon.dir/common/pffft.cpp.o.d"
+  "CMakeFiles/alcommon.dir/common/polyphase_resampler.cpp.o"
+  "CMakeFiles/alcommon.dir/common/polyphase_resampler.cpp.o.d"
+  "CMakeFiles/alcommon.dir/common/ringbuffer.cpp.o"
+  "CMakeFiles/alcommon.dir/common/ringbuffer.cpp.o.d"
+  "CMakeFiles/alcommon.dir/common/strutils.cpp.o"
+  "CMakeFiles/alcommon.dir/common/strutils.cpp.o.d"
+  "libalcommon.a"
+  "libalcommon.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/alcommon.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,61 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/core/ambdec.cpp" "CMakeFiles/alcore_static.dir/core/ambdec.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/ambdec.cpp.o.d"
+  "/root/repo/core/ambidefs.cpp" "CMakeFiles/alcore_static.dir/core/ambidefs.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/ambidefs.cpp.o.d"
+  "/root/repo/core/bformatdec.cpp" "CMakeFiles/alcore_static.dir/core/bformatdec.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/bformatdec.cpp.o.d"
+  "/root/repo/core/bs2b.cpp" "CMakeFiles/alcore_static.dir/core/bs2b.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/bs2b.cpp.o.d"
+  "/root/repo/core/bsinc_tables.cpp" "CMakeFiles/alcore_static.dir/core/bsinc_tables.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/bsinc_tables.cpp.o.d"
+  "/root/repo/core/buffer_storage.cpp" "CMakeFiles/alcore_static.dir/core/buffer_storage.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/buffer_storage.cpp.o.d"
+  "/root/repo/core/context.cpp" "CMakeFiles/alcore_static.dir/core/context.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/context.cpp.o.d"
+  "/root/repo/core/converter.cpp" "CMakeFiles/alcore_static.dir/core/converter.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/converter.cpp.o.d"
+  "/root/repo/core/convolution_offload.cpp" "CMakeFiles/alcore_static.dir/core/convolution_offload.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/convolution_offload.cpp.o.d"
+  "/root/repo/core/cpu_caps.cpp" "CMakeFiles/alcore_static.dir/core/cpu_caps.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/cpu_caps.cpp.o.d"
+  "/root/repo/core/cubic_tables.cpp" "CMakeFiles/alcore_static.dir/core/cubic_tables.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/cubic_tables.cpp.o.d"
+  "/root/repo/core/dbus_wrap.cpp" "CMakeFiles/alcore_static.dir/core/dbus_wrap.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/dbus_wrap.cpp.o.d"
+  "/root/repo/core/devformat.cpp" "CMakeFiles/alcore_static.dir/core/devformat.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/devformat.cpp.o.d"
+  "/root/repo/core/device.cpp" "CMakeFiles/alcore_static.dir/core/device.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/device.cpp.o.d"
+  "/root/repo/core/effects/rate_converter.cpp" "CMakeFiles/alcore_static.dir/core/effects/rate_converter.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/effects/rate_converter.cpp.o.d"
+  "/root/repo/core/effectslot.cpp" "CMakeFiles/alcore_static.dir/core/effectslot.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/effectslot.cpp.o.d"
+  "/root/repo/core/except.cpp" "CMakeFiles/alcore_static.dir/core/except.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/except.cpp.o.d"
+  "/root/repo/core/filters/biquad.cpp" "CMakeFiles/alcore_static.dir/core/filters/biquad.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/filters/biquad.cpp.o.d"
+  "/root/repo/core/filters/nfc.cpp" "CMakeFiles/alcore_static.dir/core/filters/nfc.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/filters/nfc.cpp.o.d"
+  "/root/repo/core/filters/splitter.cpp" "CMakeFiles/alcore_static.dir/core/filters/splitter.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/filters/splitter.cpp.o.d"
+  "/root/repo/core/fmt_traits.cpp" "CMakeFiles/alcore_static.dir/core/fmt_traits.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/fmt_traits.cpp.o.d"
+  "/root/repo/core/fpu_ctrl.cpp" "CMakeFiles/alcore_static.dir/core/fpu_ctrl.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/fpu_ctrl.cpp.o.d"
+  "/root/repo/core/helpers.cpp" "CMakeFiles/alcore_static.dir/core/helpers.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/helpers.cpp.o.d"
+  "/root/repo/core/hrtf.cpp" "CMakeFiles/alcore_static.dir/core/hrtf.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/hrtf.cpp.o.d"
+  "/root/repo/core/logging.cpp" "CMakeFiles/alcore_static.dir/core/logging.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/logging.cpp.o.d"
+  "/root/repo/core/mastering.cpp" "CMakeFiles/alcore_static.dir/core/mastering.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/mastering.cpp.o.d"
+  "/root/repo/core/mixer.cpp" "CMakeFiles/alcore_static.dir/core/mixer.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/mixer.cpp.o.d"
+  "/root/repo/core/mixer/mixer_avx2.cpp" "CMakeFiles/alcore_static.dir/core/mixer/mixer_avx2.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/mixer/mixer_avx2.cpp.o.d"
+  "/root/repo/core/mixer/mixer_c.cpp" "CMakeFiles/alcore_static.dir/core/mixer/mixer_c.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/mixer/mixer_c.cpp.o.d"
+  "/root/repo/core/mixer/mixer_sse.cpp" "CMakeFiles/alcore_static.dir/core/mixer/mixer_sse.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/mixer/mixer_sse.cpp.o.d"
+  "/root/repo/core/mixer/mixer_sse2.cpp" "CMakeFiles/alcore_static.dir/core/mixer/mixer_sse2.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/mixer/mixer_sse2.cpp.o.d"
+  "/root/repo/core/mixer/mixer_sse3.cpp" "CMakeFiles/alcore_static.dir/core/mixer/mixer_sse3.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/mixer/mixer_sse3.cpp.o.d"
+  "/root/repo/core/mixer/mixer_sse41.cpp" "CMakeFiles/alcore_static.dir/core/mixer/mixer_sse41.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/mixer/mixer_sse41.cpp.o.d"
+  "/root/repo/core/mixer_pool.cpp" "CMakeFiles/alcore_static.dir/core/mixer_pool.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/mixer_pool.cpp.o.d"
+  "/root/repo/core/param_thread.cpp" "CMakeFiles/alcore_static.dir/core/param_thread.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/param_thread.cpp.o.d"
+  "/root/repo/core/render_pool.cpp" "CMakeFiles/alcore_static.dir/core/render_pool.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/render_pool.cpp.o.d"
+  "/root/repo/core/rtkit.cpp" "CMakeFiles/alcore_static.dir/core/rtkit.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/rtkit.cpp.o.d"
+  "/root/repo/core/storage_formats.cpp" "CMakeFiles/alcore_static.dir/core/storage_formats.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/storage_formats.cpp.o.d"
+  "/root/repo/core/tracing.cpp" "CMakeFiles/alcore_static.dir/core/tracing.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/tracing.cpp.o.d"
+  "/root/repo/core/uhjfilter.cpp" "CMakeFiles/alcore_static.dir/core/uhjfilter.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/uhjfilter.cpp.o.d"
+  "/root/repo/core/uiddefs.cpp" "CMakeFiles/alcore_static.dir/core/uiddefs.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/uiddefs.cpp.o.d"
+  "/root/repo/core/voice.cpp" "CMakeFiles/alcore_static.dir/core/voice.cpp.o" "gcc" "CMakeFiles/alcore_static.dir/core/voice.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_test_build/CMakeFiles/alcommon.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
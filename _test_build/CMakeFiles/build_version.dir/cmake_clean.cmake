@@ -0,0 +1,10 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/build_version"
+  "version.h"
+  "version_witness.txt"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/build_version.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,12 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/OpenAL_EventTests.dir/voice_events.t.cpp.o"
+  "CMakeFiles/OpenAL_EventTests.dir/voice_events.t.cpp.o.d"
+  "OpenAL_EventTests"
+  "OpenAL_EventTests.pdb"
+  "OpenAL_EventTests[1]_tests.cmake"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/OpenAL_EventTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
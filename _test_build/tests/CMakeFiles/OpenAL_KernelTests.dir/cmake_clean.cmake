@@ -0,0 +1,14 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/OpenAL_KernelTests.dir/converter.t.cpp.o"
+  "CMakeFiles/OpenAL_KernelTests.dir/converter.t.cpp.o.d"
+  "CMakeFiles/OpenAL_KernelTests.dir/kernels.t.cpp.o"
+  "CMakeFiles/OpenAL_KernelTests.dir/kernels.t.cpp.o.d"
+  "OpenAL_KernelTests"
+  "OpenAL_KernelTests.pdb"
+  "OpenAL_KernelTests[1]_tests.cmake"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/OpenAL_KernelTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
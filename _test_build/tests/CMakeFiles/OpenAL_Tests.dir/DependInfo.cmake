@@ -0,0 +1,22 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/tests/example.t.cpp" "tests/CMakeFiles/OpenAL_Tests.dir/example.t.cpp.o" "gcc" "tests/CMakeFiles/OpenAL_Tests.dir/example.t.cpp.o.d"
+  "/root/repo/tests/golden.t.cpp" "tests/CMakeFiles/OpenAL_Tests.dir/golden.t.cpp.o" "gcc" "tests/CMakeFiles/OpenAL_Tests.dir/golden.t.cpp.o.d"
+  "/root/repo/tests/voices.t.cpp" "tests/CMakeFiles/OpenAL_Tests.dir/voices.t.cpp.o" "gcc" "tests/CMakeFiles/OpenAL_Tests.dir/voices.t.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_test_build/CMakeFiles/OpenAL.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
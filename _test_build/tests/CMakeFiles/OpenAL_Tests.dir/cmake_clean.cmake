@@ -0,0 +1,17 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/OpenAL_Tests.dir/example.t.cpp.o"
+  "CMakeFiles/OpenAL_Tests.dir/example.t.cpp.o.d"
+  "CMakeFiles/OpenAL_Tests.dir/golden.t.cpp.o"
+  "CMakeFiles/OpenAL_Tests.dir/golden.t.cpp.o.d"
+  "CMakeFiles/OpenAL_Tests.dir/voices.t.cpp.o"
+  "CMakeFiles/OpenAL_Tests.dir/voices.t.cpp.o.d"
+  "OpenAL_Tests"
+  "OpenAL_Tests.pdb"
+  "OpenAL_Tests[1]_tests.cmake"
+  "OpenAL_Tests[2]_tests.cmake"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/OpenAL_Tests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,10 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/tests
+# Build directory: /root/repo/_test_build/tests
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+include("/root/repo/_test_build/tests/OpenAL_Tests[1]_include.cmake")
+include("/root/repo/_test_build/tests/OpenAL_Tests[2]_include.cmake")
+include("/root/repo/_test_build/tests/OpenAL_KernelTests[1]_include.cmake")
+include("/root/repo/_test_build/tests/OpenAL_EventTests[1]_include.cmake")
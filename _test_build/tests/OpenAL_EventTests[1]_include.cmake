@@ -0,0 +1,5 @@
+if(EXISTS "/root/repo/_test_build/tests/OpenAL_EventTests[1]_tests.cmake")
+  include("/root/repo/_test_build/tests/OpenAL_EventTests[1]_tests.cmake")
+else()
+  add_test(OpenAL_EventTests_NOT_BUILT OpenAL_EventTests_NOT_BUILT)
+endif()
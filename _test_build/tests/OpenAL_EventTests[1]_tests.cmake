@@ -0,0 +1,3 @@
+add_test([=[VoiceEvents.ManyVoicesStopTogether]=]  /root/repo/_test_build/tests/OpenAL_EventTests [==[--gtest_filter=VoiceEvents.ManyVoicesStopTogether]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[VoiceEvents.ManyVoicesStopTogether]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==] ENVIRONMENT [==[ALSOFT_CONF=/root/repo/tests/voice_events.conf]==])
+set(  OpenAL_EventTests_TESTS VoiceEvents.ManyVoicesStopTogether)
@@ -0,0 +1,5 @@
+if(EXISTS "/root/repo/_test_build/tests/OpenAL_KernelTests[1]_tests.cmake")
+  include("/root/repo/_test_build/tests/OpenAL_KernelTests[1]_tests.cmake")
+else()
+  add_test(OpenAL_KernelTests_NOT_BUILT OpenAL_KernelTests_NOT_BUILT)
+endif()
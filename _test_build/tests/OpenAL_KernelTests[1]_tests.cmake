@@ -0,0 +1,43 @@
+add_test([=[ConverterTest.PassthroughIntToFloat]=]  /root/repo/_test_build/tests/OpenAL_KernelTests [==[--gtest_filter=ConverterTest.PassthroughIntToFloat]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ConverterTest.PassthroughIntToFloat]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ConverterTest.PassthroughShortToFloat]=]  /root/repo/_test_build/tests/OpenAL_KernelTests [==[--gtest_filter=ConverterTest.PassthroughShortToFloat]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ConverterTest.PassthroughShortToFloat]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ConverterTest.PassthroughFloatToInteger]=]  /root/repo/_test_build/tests/OpenAL_KernelTests [==[--gtest_filter=ConverterTest.PassthroughFloatToInteger]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ConverterTest.PassthroughFloatToInteger]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ConverterTest.PassthroughPlanar]=]  /root/repo/_test_build/tests/OpenAL_KernelTests [==[--gtest_filter=ConverterTest.PassthroughPlanar]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ConverterTest.PassthroughPlanar]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ConverterTest.ResamplingKeepsDelay]=]  /root/repo/_test_build/tests/OpenAL_KernelTests [==[--gtest_filter=ConverterTest.ResamplingKeepsDelay]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ConverterTest.ResamplingKeepsDelay]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ConverterTest.StereoToMono]=]  /root/repo/_test_build/tests/OpenAL_KernelTests [==[--gtest_filter=ConverterTest.StereoToMono]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ConverterTest.StereoToMono]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ConverterTest.MultiToMono]=]  /root/repo/_test_build/tests/OpenAL_KernelTests [==[--gtest_filter=ConverterTest.MultiToMono]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ConverterTest.MultiToMono]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[ConverterTest.MonoToStereo]=]  /root/repo/_test_build/tests/OpenAL_KernelTests [==[--gtest_filter=ConverterTest.MonoToStereo]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[ConverterTest.MonoToStereo]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[KernelTest.ResampleLerp]=]  /root/repo/_test_build/tests/OpenAL_KernelTests [==[--gtest_filter=KernelTest.ResampleLerp]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[KernelTest.ResampleLerp]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[KernelTest.ResampleCubic]=]  /root/repo/_test_build/tests/OpenAL_KernelTests [==[--gtest_filter=KernelTest.ResampleCubic]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[KernelTest.ResampleCubic]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[KernelTest.ResampleBSinc]=]  /root/repo/_test_build/tests/OpenAL_KernelTests [==[--gtest_filter=KernelTest.ResampleBSinc]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[KernelTest.ResampleBSinc]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[KernelTest.ResampleBSincPoly]=]  /root/repo/_test_build/tests/OpenAL_KernelTests [==[--gtest_filter=KernelTest.ResampleBSincPoly]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[KernelTest.ResampleBSincPoly]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[KernelTest.Mix]=]  /root/repo/_test_build/tests/OpenAL_KernelTests [==[--gtest_filter=KernelTest.Mix]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[KernelTest.Mix]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[KernelTest.MixLine]=]  /root/repo/_test_build/tests/OpenAL_KernelTests [==[--gtest_filter=KernelTest.MixLine]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[KernelTest.MixLine]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[KernelTest.MixBatch]=]  /root/repo/_test_build/tests/OpenAL_KernelTests [==[--gtest_filter=KernelTest.MixBatch]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[KernelTest.MixBatch]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[KernelTest.MixHrtf]=]  /root/repo/_test_build/tests/OpenAL_KernelTests [==[--gtest_filter=KernelTest.MixHrtf]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[KernelTest.MixHrtf]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[KernelTest.MixHrtfBlend]=]  /root/repo/_test_build/tests/OpenAL_KernelTests [==[--gtest_filter=KernelTest.MixHrtfBlend]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[KernelTest.MixHrtfBlend]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[KernelTest.MixDirectHrtf]=]  /root/repo/_test_build/tests/OpenAL_KernelTests [==[--gtest_filter=KernelTest.MixDirectHrtf]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[KernelTest.MixDirectHrtf]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[KernelTest.LoadIMA4]=]  /root/repo/_test_build/tests/OpenAL_KernelTests [==[--gtest_filter=KernelTest.LoadIMA4]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[KernelTest.LoadIMA4]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[KernelTest.LoadIMA4Random]=]  /root/repo/_test_build/tests/OpenAL_KernelTests [==[--gtest_filter=KernelTest.LoadIMA4Random]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[KernelTest.LoadIMA4Random]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+add_test([=[KernelTest.LoadHalf]=]  /root/repo/_test_build/tests/OpenAL_KernelTests [==[--gtest_filter=KernelTest.LoadHalf]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[KernelTest.LoadHalf]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==])
+set(  OpenAL_KernelTests_TESTS ConverterTest.PassthroughIntToFloat ConverterTest.PassthroughShortToFloat ConverterTest.PassthroughFloatToInteger ConverterTest.PassthroughPlanar ConverterTest.ResamplingKeepsDelay ConverterTest.StereoToMono ConverterTest.MultiToMono ConverterTest.MonoToStereo KernelTest.ResampleLerp KernelTest.ResampleCubic KernelTest.ResampleBSinc KernelTest.ResampleBSincPoly KernelTest.Mix KernelTest.MixLine KernelTest.MixBatch KernelTest.MixHrtf KernelTest.MixHrtfBlend KernelTest.MixDirectHrtf KernelTest.LoadIMA4 KernelTest.LoadIMA4Random KernelTest.LoadHalf)
@@ -0,0 +1,19 @@
+add_test([=[cmixer.ExampleTest.Basic]=]  /root/repo/_test_build/tests/OpenAL_Tests [==[--gtest_filter=ExampleTest.Basic]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[cmixer.ExampleTest.Basic]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==] ENVIRONMENT [==[ALSOFT_CONF=/root/repo/tests/golden/golden.conf]==] [==[ALSOFT_GOLDEN_DISABLE_CPU_EXTS=all]==])
+add_test([=[cmixer.GoldenTest.StereoPanning]=]  /root/repo/_test_build/tests/OpenAL_Tests [==[--gtest_filter=GoldenTest.StereoPanning]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[cmixer.GoldenTest.StereoPanning]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==] ENVIRONMENT [==[ALSOFT_CONF=/root/repo/tests/golden/golden.conf]==] [==[ALSOFT_GOLDEN_DISABLE_CPU_EXTS=all]==])
+add_test([=[cmixer.GoldenTest.StereoHrtf]=]  /root/repo/_test_build/tests/OpenAL_Tests [==[--gtest_filter=GoldenTest.StereoHrtf]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[cmixer.GoldenTest.StereoHrtf]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==] ENVIRONMENT [==[ALSOFT_CONF=/root/repo/tests/golden/golden.conf]==] [==[ALSOFT_GOLDEN_DISABLE_CPU_EXTS=all]==])
+add_test([=[cmixer.GoldenTest.StereoUhj]=]  /root/repo/_test_build/tests/OpenAL_Tests [==[--gtest_filter=GoldenTest.StereoUhj]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[cmixer.GoldenTest.StereoUhj]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==] ENVIRONMENT [==[ALSOFT_CONF=/root/repo/tests/golden/golden.conf]==] [==[ALSOFT_GOLDEN_DISABLE_CPU_EXTS=all]==])
+add_test([=[cmixer.GoldenTest.Surround51Reverb]=]  /root/repo/_test_build/tests/OpenAL_Tests [==[--gtest_filter=GoldenTest.Surround51Reverb]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[cmixer.GoldenTest.Surround51Reverb]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==] ENVIRONMENT [==[ALSOFT_CONF=/root/repo/tests/golden/golden.conf]==] [==[ALSOFT_GOLDEN_DISABLE_CPU_EXTS=all]==])
+add_test([=[cmixer.GoldenTest.AmbisonicConvolution]=]  /root/repo/_test_build/tests/OpenAL_Tests [==[--gtest_filter=GoldenTest.AmbisonicConvolution]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[cmixer.GoldenTest.AmbisonicConvolution]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==] ENVIRONMENT [==[ALSOFT_CONF=/root/repo/tests/golden/golden.conf]==] [==[ALSOFT_GOLDEN_DISABLE_CPU_EXTS=all]==])
+add_test([=[cmixer.VoiceTest.MaskWordFull]=]  /root/repo/_test_build/tests/OpenAL_Tests [==[--gtest_filter=VoiceTest.MaskWordFull]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[cmixer.VoiceTest.MaskWordFull]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==] ENVIRONMENT [==[ALSOFT_CONF=/root/repo/tests/golden/golden.conf]==] [==[ALSOFT_GOLDEN_DISABLE_CPU_EXTS=all]==])
+add_test([=[cmixer.VoiceTest.FreedVoicesReused]=]  /root/repo/_test_build/tests/OpenAL_Tests [==[--gtest_filter=VoiceTest.FreedVoicesReused]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[cmixer.VoiceTest.FreedVoicesReused]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==] ENVIRONMENT [==[ALSOFT_CONF=/root/repo/tests/golden/golden.conf]==] [==[ALSOFT_GOLDEN_DISABLE_CPU_EXTS=all]==])
+add_test([=[cmixer.VoiceTest.VoiceCountGrowth]=]  /root/repo/_test_build/tests/OpenAL_Tests [==[--gtest_filter=VoiceTest.VoiceCountGrowth]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[cmixer.VoiceTest.VoiceCountGrowth]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==] ENVIRONMENT [==[ALSOFT_CONF=/root/repo/tests/golden/golden.conf]==] [==[ALSOFT_GOLDEN_DISABLE_CPU_EXTS=all]==])
+set(  OpenAL_Tests_CMixer cmixer.ExampleTest.Basic cmixer.GoldenTest.StereoPanning cmixer.GoldenTest.StereoHrtf cmixer.GoldenTest.StereoUhj cmixer.GoldenTest.Surround51Reverb cmixer.GoldenTest.AmbisonicConvolution cmixer.VoiceTest.MaskWordFull cmixer.VoiceTest.FreedVoicesReused cmixer.VoiceTest.VoiceCountGrowth)
@@ -0,0 +1,5 @@
+if(EXISTS "/root/repo/_test_build/tests/OpenAL_Tests[2]_tests.cmake")
+  include("/root/repo/_test_build/tests/OpenAL_Tests[2]_tests.cmake")
+else()
+  add_test(OpenAL_Tests_NOT_BUILT OpenAL_Tests_NOT_BUILT)
+endif()
@@ -0,0 +1,19 @@
+add_test([=[simd.ExampleTest.Basic]=]  /root/repo/_test_build/tests/OpenAL_Tests [==[--gtest_filter=ExampleTest.Basic]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[simd.ExampleTest.Basic]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==] ENVIRONMENT [==[ALSOFT_CONF=/root/repo/tests/golden/golden.conf]==])
+add_test([=[simd.GoldenTest.StereoPanning]=]  /root/repo/_test_build/tests/OpenAL_Tests [==[--gtest_filter=GoldenTest.StereoPanning]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[simd.GoldenTest.StereoPanning]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==] ENVIRONMENT [==[ALSOFT_CONF=/root/repo/tests/golden/golden.conf]==])
+add_test([=[simd.GoldenTest.StereoHrtf]=]  /root/repo/_test_build/tests/OpenAL_Tests [==[--gtest_filter=GoldenTest.StereoHrtf]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[simd.GoldenTest.StereoHrtf]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==] ENVIRONMENT [==[ALSOFT_CONF=/root/repo/tests/golden/golden.conf]==])
+add_test([=[simd.GoldenTest.StereoUhj]=]  /root/repo/_test_build/tests/OpenAL_Tests [==[--gtest_filter=GoldenTest.StereoUhj]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[simd.GoldenTest.StereoUhj]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==] ENVIRONMENT [==[ALSOFT_CONF=/root/repo/tests/golden/golden.conf]==])
+add_test([=[simd.GoldenTest.Surround51Reverb]=]  /root/repo/_test_build/tests/OpenAL_Tests [==[--gtest_filter=GoldenTest.Surround51Reverb]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[simd.GoldenTest.Surround51Reverb]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==] ENVIRONMENT [==[ALSOFT_CONF=/root/repo/tests/golden/golden.conf]==])
+add_test([=[simd.GoldenTest.AmbisonicConvolution]=]  /root/repo/_test_build/tests/OpenAL_Tests [==[--gtest_filter=GoldenTest.AmbisonicConvolution]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[simd.GoldenTest.AmbisonicConvolution]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==] ENVIRONMENT [==[ALSOFT_CONF=/root/repo/tests/golden/golden.conf]==])
+add_test([=[simd.VoiceTest.MaskWordFull]=]  /root/repo/_test_build/tests/OpenAL_Tests [==[--gtest_filter=VoiceTest.MaskWordFull]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[simd.VoiceTest.MaskWordFull]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==] ENVIRONMENT [==[ALSOFT_CONF=/root/repo/tests/golden/golden.conf]==])
+add_test([=[simd.VoiceTest.FreedVoicesReused]=]  /root/repo/_test_build/tests/OpenAL_Tests [==[--gtest_filter=VoiceTest.FreedVoicesReused]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[simd.VoiceTest.FreedVoicesReused]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==] ENVIRONMENT [==[ALSOFT_CONF=/root/repo/tests/golden/golden.conf]==])
+add_test([=[simd.VoiceTest.VoiceCountGrowth]=]  /root/repo/_test_build/tests/OpenAL_Tests [==[--gtest_filter=VoiceTest.VoiceCountGrowth]==] --gtest_also_run_disabled_tests)
+set_tests_properties([=[simd.VoiceTest.VoiceCountGrowth]=]  PROPERTIES WORKING_DIRECTORY /root/repo/_test_build/tests SKIP_REGULAR_EXPRESSION [==[\[  SKIPPED \]]==] ENVIRONMENT [==[ALSOFT_CONF=/root/repo/tests/golden/golden.conf]==])
+set(  OpenAL_Tests_SIMD simd.ExampleTest.Basic simd.GoldenTest.StereoPanning simd.GoldenTest.StereoHrtf simd.GoldenTest.StereoUhj simd.GoldenTest.Surround51Reverb simd.GoldenTest.AmbisonicConvolution simd.VoiceTest.MaskWordFull simd.VoiceTest.FreedVoicesReused simd.VoiceTest.VoiceCountGrowth)
@@ -0,0 +1,9 @@
+/* Define to the library version */
+#define ALSOFT_VERSION "1.23.1"
+#define ALSOFT_VERSION_NUM 1,23,1,0
+
+/* Define the branch being built */
+#define ALSOFT_GIT_BRANCH "master"
+
+/* Define the hash of the head commit */
+#define ALSOFT_GIT_COMMIT_HASH "09682ad"
@@ -23,8 +23,12 @@
 #include "auxeffectslot.h"
 
 #include <algorithm>
+#include <cassert>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
+#include <exception>
 #include <functional>
 #include <iterator>
 #include <memory>
@@ -32,8 +36,10 @@
 #include <numeric>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
+#include <variant>
 #include <vector>
 
 #include "AL/al.h"
@@ -50,6 +56,7 @@
 #include "almalloc.h"
 #include "alnumeric.h"
 #include "alspan.h"
+#include "althrd_setname.h"
 #include "atomic.h"
 #include "buffer.h"
 #include "core/buffer_storage.h"
@@ -92,6 +99,7 @@ EffectStateFactory *getFactoryByType(EffectSlotType type)
     case EffectSlotType::FrequencyShifter: return FshifterStateFactory_getFactory();
     case EffectSlotType::RingModulator: return ModulatorStateFactory_getFactory();
     case EffectSlotType::PitchShifter: return PshifterStateFactory_getFactory();
+    case EffectSlotType::SourceGroup: return SourceGroupStateFactory_getFactory();
     case EffectSlotType::VocalMorpher: return VmorpherStateFactory_getFactory();
     }
     return nullptr;
@@ -238,6 +246,7 @@ constexpr auto EffectSlotTypeFromEnum(ALenum type) noexcept -> EffectSlotType
     case AL_EFFECT_DEDICATED_LOW_FREQUENCY_EFFECT: return EffectSlotType::Dedicated;
     case AL_EFFECT_DEDICATED_DIALOGUE: return EffectSlotType::Dedicated;
     case AL_EFFECT_CONVOLUTION_SOFT: return EffectSlotType::Convolution;
+    case AL_EFFECT_SOURCE_GROUP_SOFT: return EffectSlotType::SourceGroup;
     }
     ERR("Unhandled effect enum: 0x%04x\n", type);
     return EffectSlotType::None;
@@ -282,6 +291,7 @@ ALeffectslot *AllocEffectSlot(ALCcontext *context)
 
     /* Add 1 to avoid ID 0. */
     slot->id = ((lidx<<6) | slidx) + 1;
+    slot->mSlot->mId = slot->id;
 
     context->mNumEffectSlots += 1;
     sublist->FreeMask &= ~(1_u64 << slidx);
@@ -314,6 +324,186 @@ inline void UpdateProps(ALeffectslot *slot, ALCcontext *context)
     slot->mPropsDirty = true;
 }
 
+
+/* Preparing an effect state for a new buffer can take a while (e.g. resampling
+ * and transforming a long impulse response for convolution), so it's done on
+ * a background thread. The slot keeps using its current state until the new
+ * one is ready.
+ */
+struct SlotBufferJob {
+    ContextRef mContext;
+    ALuint mSlotId{};
+    uint mJobId{};
+    EffectSlotType mType{};
+    ALbuffer *mBuffer{};
+};
+
+/* Makes spare effect states of a type for the device's pool. */
+struct StatePoolJob {
+    al::intrusive_ptr<ALCdevice> mDevice;
+    EffectSlotType mType{};
+};
+
+std::atomic<uint> NextSlotBufferJob{1u};
+
+void PrepareSlotBuffer(const SlotBufferJob &job)
+{
+    ALCcontext *context{job.mContext.get()};
+    ALCdevice *device{context->mALDevice.get()};
+
+    /* Skip it if the slot already moved on. */
+    {
+        std::lock_guard<std::shared_mutex> slotlock{context->mEffectSlotLock};
+        ALeffectslot *slot{LookupEffectSlot(context, job.mSlotId)};
+        if(!slot || slot->mBufferJob != job.mJobId)
+            return;
+    }
+
+    EffectStateFactory *factory{getFactoryByType(job.mType)};
+    assert(factory);
+    al::intrusive_ptr<EffectState> state{factory->create()};
+    {
+        FPUCtl mixer_mode{};
+        state->deviceUpdate(device, job.mBuffer);
+    }
+
+    std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
+    std::lock_guard<std::shared_mutex> slotlock{context->mEffectSlotLock};
+
+    /* The slot may have been deleted, had its buffer or effect changed again,
+     * or had its state reset with the device while this was preparing, in
+     * which case the new state is no longer wanted.
+     */
+    ALeffectslot *slot{LookupEffectSlot(context, job.mSlotId)};
+    if(!slot || slot->mBufferJob != job.mJobId)
+        return;
+    slot->mBufferJob = 0u;
+    if(slot->mState != SlotState::Playing || slot->Effect.Type != job.mType)
+        return;
+
+    state->mOutTarget = device->Dry.Buffer;
+
+    /* Stop the effect slot from processing while we switch buffers. */
+    RemoveActiveEffectSlots({&slot, 1}, context);
+
+    slot->Effect.State = std::move(state);
+    slot->mStateReady = true;
+
+    slot->mPropsDirty = false;
+    slot->updateProps(context);
+    AddActiveEffectSlots({&slot, 1}, context);
+}
+
+class SlotBufferWorker {
+    using Job = std::variant<SlotBufferJob,StatePoolJob>;
+
+    std::mutex mLock;
+    std::condition_variable mCond;
+    std::deque<Job> mJobs;
+    bool mQuit{false};
+    std::thread mThread;
+
+    static void RunJob(SlotBufferJob &job)
+    {
+        try {
+            PrepareSlotBuffer(job);
+        }
+        catch(std::exception &e) {
+            ERR("Failed to prepare effect slot buffer: %s\n", e.what());
+        }
+    }
+
+    static void RunJob(StatePoolJob &job)
+    {
+        ALCdevice *device{job.mDevice.get()};
+        try {
+            std::lock_guard<std::mutex> statelock{device->StateLock};
+            device->mEffectStatePool->fill(device, job.mType);
+        }
+        catch(std::exception &e) {
+            ERR("Failed to make spare effect state: %s\n", e.what());
+        }
+    }
+
+    static void ReleaseJob(SlotBufferJob &job)
+    {
+        if(job.mBuffer)
+            DecrementRef(job.mBuffer->ref);
+        job.mBuffer = nullptr;
+        job.mContext = nullptr;
+    }
+
+    static void ReleaseJob(StatePoolJob &job)
+    { job.mDevice = nullptr; }
+
+    void run()
+    {
+        althrd_setname(GetSlotBufferThreadName());
+
+        std::unique_lock<std::mutex> joblock{mLock};
+        while(true)
+        {
+            mCond.wait(joblock, [this]{ return mQuit || !mJobs.empty(); });
+            if(mQuit) break;
+
+            Job job{std::move(mJobs.front())};
+            mJobs.pop_front();
+            joblock.unlock();
+
+            std::visit([](auto &j) { RunJob(j); ReleaseJob(j); }, job);
+
+            joblock.lock();
+        }
+        for(auto &job : mJobs)
+            std::visit([](auto &j) { ReleaseJob(j); }, job);
+        mJobs.clear();
+    }
+
+public:
+    ~SlotBufferWorker()
+    {
+        {
+            std::lock_guard<std::mutex> joblock{mLock};
+            mQuit = true;
+        }
+        mCond.notify_all();
+        if(mThread.joinable())
+            mThread.join();
+    }
+
+    /* Queues the job for the background thread, taking its context, device,
+     * and buffer references. Returns false if the thread couldn't be started.
+     */
+    bool push(Job &&job)
+    {
+        std::lock_guard<std::mutex> joblock{mLock};
+        if(!mThread.joinable())
+        {
+            try {
+                mThread = std::thread{&SlotBufferWorker::run, this};
+            }
+            catch(std::exception &e) {
+                ERR("Failed to start effect slot buffer thread: %s\n", e.what());
+                return false;
+            }
+        }
+        mJobs.emplace_back(std::move(job));
+        mCond.notify_one();
+        return true;
+    }
+
+    static SlotBufferWorker &Get()
+    {
+        static SlotBufferWorker worker;
+        return worker;
+    }
+
+    /* Must be less than 15 characters (16 including terminating null) for
+     * compatibility with pthread_setname_np limitations. */
+    static constexpr auto GetSlotBufferThreadName() noexcept -> const char*
+    { return "alsoft-slotbuf"; }
+};
+
 } // namespace
 
 
@@ -325,7 +515,7 @@ try {
         throw al::context_error{AL_INVALID_VALUE, "Generating %d effect slots", n};
     if(n <= 0) UNLIKELY return;
 
-    std::lock_guard<std::mutex> slotlock{context->mEffectSlotLock};
+    std::lock_guard<std::shared_mutex> slotlock{context->mEffectSlotLock};
     ALCdevice *device{context->mALDevice.get()};
 
     const al::span eids{effectslots, static_cast<ALuint>(n)};
@@ -375,7 +565,7 @@ try {
         throw al::context_error{AL_INVALID_VALUE, "Deleting %d effect slots", n};
     if(n <= 0) UNLIKELY return;
 
-    std::lock_guard<std::mutex> slotlock{context->mEffectSlotLock};
+    std::lock_guard<std::shared_mutex> slotlock{context->mEffectSlotLock};
     if(n == 1)
     {
         ALeffectslot *slot{LookupEffectSlot(context, *effectslots)};
@@ -425,7 +615,7 @@ AL_API DECL_FUNC1(ALboolean, alIsAuxiliaryEffectSlot, ALuint,effectslot)
 FORCE_ALIGN ALboolean AL_APIENTRY alIsAuxiliaryEffectSlotDirect(ALCcontext *context,
     ALuint effectslot) noexcept
 {
-    std::lock_guard<std::mutex> slotlock{context->mEffectSlotLock};
+    std::shared_lock<std::shared_mutex> slotlock{context->mEffectSlotLock};
     if(LookupEffectSlot(context, effectslot) != nullptr)
         return AL_TRUE;
     return AL_FALSE;
@@ -434,7 +624,7 @@ FORCE_ALIGN ALboolean AL_APIENTRY alIsAuxiliaryEffectSlotDirect(ALCcontext *cont
 
 AL_API void AL_APIENTRY alAuxiliaryEffectSlotPlaySOFT(ALuint) noexcept
 {
-    ContextRef context{GetContextRef()};
+    auto context = GetCurrentContext();
     if(!context) UNLIKELY return;
 
     context->setError(AL_INVALID_OPERATION, "alAuxiliaryEffectSlotPlaySOFT not supported");
@@ -442,7 +632,7 @@ AL_API void AL_APIENTRY alAuxiliaryEffectSlotPlaySOFT(ALuint) noexcept
 
 AL_API void AL_APIENTRY alAuxiliaryEffectSlotPlayvSOFT(ALsizei, const ALuint*) noexcept
 {
-    ContextRef context{GetContextRef()};
+    auto context = GetCurrentContext();
     if(!context) UNLIKELY return;
 
     context->setError(AL_INVALID_OPERATION, "alAuxiliaryEffectSlotPlayvSOFT not supported");
@@ -450,7 +640,7 @@ AL_API void AL_APIENTRY alAuxiliaryEffectSlotPlayvSOFT(ALsizei, const ALuint*) n
 
 AL_API void AL_APIENTRY alAuxiliaryEffectSlotStopSOFT(ALuint) noexcept
 {
-    ContextRef context{GetContextRef()};
+    auto context = GetCurrentContext();
     if(!context) UNLIKELY return;
 
     context->setError(AL_INVALID_OPERATION, "alAuxiliaryEffectSlotStopSOFT not supported");
@@ -458,7 +648,7 @@ AL_API void AL_APIENTRY alAuxiliaryEffectSlotStopSOFT(ALuint) noexcept
 
 AL_API void AL_APIENTRY alAuxiliaryEffectSlotStopvSOFT(ALsizei, const ALuint*) noexcept
 {
-    ContextRef context{GetContextRef()};
+    auto context = GetCurrentContext();
     if(!context) UNLIKELY return;
 
     context->setError(AL_INVALID_OPERATION, "alAuxiliaryEffectSlotStopvSOFT not supported");
@@ -469,8 +659,8 @@ AL_API DECL_FUNC3(void, alAuxiliaryEffectSloti, ALuint,effectslot, ALenum,param,
 FORCE_ALIGN void AL_APIENTRY alAuxiliaryEffectSlotiDirect(ALCcontext *context, ALuint effectslot,
     ALenum param, ALint value) noexcept
 try {
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
-    std::lock_guard<std::mutex> slotlock{context->mEffectSlotLock};
+    std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
+    std::lock_guard<std::shared_mutex> slotlock{context->mEffectSlotLock};
 
     ALeffectslot *slot{LookupEffectSlot(context, effectslot)};
     if(!slot) UNLIKELY
@@ -565,10 +755,6 @@ try {
 
         if(slot->mState == SlotState::Playing)
         {
-            EffectStateFactory *factory{getFactoryByType(slot->Effect.Type)};
-            assert(factory);
-            al::intrusive_ptr<EffectState> state{factory->create()};
-
             ALCdevice *device{context->mALDevice.get()};
             auto bufferlock = std::unique_lock{device->BufferLock};
             ALbuffer *buffer{};
@@ -580,24 +766,51 @@ try {
                 if(buffer->mCallback)
                     throw al::context_error{AL_INVALID_OPERATION,
                         "Callback buffer not valid for effects"};
+                if(buffer->mUploadFence != 0)
+                    throw al::context_error{AL_INVALID_OPERATION,
+                        "Buffer %u has a pending upload", buffer->id};
 
                 IncrementRef(buffer->ref);
             }
 
-            /* Stop the effect slot from processing while we switch buffers. */
-            RemoveActiveEffectSlots({&slot, 1}, context);
-
             if(ALbuffer *oldbuffer{slot->Buffer})
                 DecrementRef(oldbuffer->ref);
             slot->Buffer = buffer;
+
+            /* Prepare the new state in the background, with its own reference
+             * to the buffer. The slot keeps processing with its current state
+             * until then.
+             */
+            uint jobid{NextSlotBufferJob.fetch_add(1u, std::memory_order_relaxed)};
+            if(jobid == 0) UNLIKELY
+                jobid = NextSlotBufferJob.fetch_add(1u, std::memory_order_relaxed);
+            if(buffer)
+                IncrementRef(buffer->ref);
             bufferlock.unlock();
 
+            slot->mBufferJob = jobid;
+            context->add_ref();
+            if(SlotBufferWorker::Get().push(SlotBufferJob{ContextRef{context}, slot->id,
+                jobid, slot->Effect.Type, buffer}))
+                return;
+            slot->mBufferJob = 0u;
+            if(buffer)
+                DecrementRef(buffer->ref);
+
+            EffectStateFactory *factory{getFactoryByType(slot->Effect.Type)};
+            assert(factory);
+            al::intrusive_ptr<EffectState> state{factory->create()};
+
+            /* Stop the effect slot from processing while we switch buffers. */
+            RemoveActiveEffectSlots({&slot, 1}, context);
+
             state->mOutTarget = device->Dry.Buffer;
             {
                 FPUCtl mixer_mode{};
                 state->deviceUpdate(device, buffer);
             }
             slot->Effect.State = std::move(state);
+            slot->mStateReady = false;
 
             slot->mPropsDirty = false;
             slot->updateProps(context);
@@ -616,6 +829,9 @@ try {
                 if(buffer->mCallback)
                     throw al::context_error{AL_INVALID_OPERATION,
                                             "Callback buffer not valid for effects"};
+                if(buffer->mUploadFence != 0)
+                    throw al::context_error{AL_INVALID_OPERATION,
+                                            "Buffer %u has a pending upload", buffer->id};
 
                 IncrementRef(buffer->ref);
             }
@@ -628,6 +844,7 @@ try {
             FPUCtl mixer_mode{};
             auto *state = slot->Effect.State.get();
             state->deviceUpdate(device, buffer);
+            slot->mBufferJob = 0u;
             slot->mPropsDirty = true;
         }
         return;
@@ -657,7 +874,7 @@ try {
         return;
     }
 
-    std::lock_guard<std::mutex> slotlock{context->mEffectSlotLock};
+    std::lock_guard<std::shared_mutex> slotlock{context->mEffectSlotLock};
     ALeffectslot *slot{LookupEffectSlot(context, effectslot)};
     if(!slot)
         throw al::context_error{AL_INVALID_NAME, "Invalid effect slot ID %u", effectslot};
@@ -676,8 +893,8 @@ AL_API DECL_FUNC3(void, alAuxiliaryEffectSlotf, ALuint,effectslot, ALenum,param,
 FORCE_ALIGN void AL_APIENTRY alAuxiliaryEffectSlotfDirect(ALCcontext *context, ALuint effectslot,
     ALenum param, ALfloat value) noexcept
 try {
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
-    std::lock_guard<std::mutex> slotlock{context->mEffectSlotLock};
+    std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
+    std::lock_guard<std::shared_mutex> slotlock{context->mEffectSlotLock};
 
     ALeffectslot *slot{LookupEffectSlot(context, effectslot)};
     if(!slot)
@@ -713,7 +930,7 @@ try {
         return;
     }
 
-    std::lock_guard<std::mutex> slotlock{context->mEffectSlotLock};
+    std::lock_guard<std::shared_mutex> slotlock{context->mEffectSlotLock};
     ALeffectslot *slot{LookupEffectSlot(context, effectslot)};
     if(!slot)
         throw al::context_error{AL_INVALID_NAME, "Invalid effect slot ID %u", effectslot};
@@ -733,7 +950,7 @@ AL_API DECL_FUNC3(void, alGetAuxiliaryEffectSloti, ALuint,effectslot, ALenum,par
 FORCE_ALIGN void AL_APIENTRY alGetAuxiliaryEffectSlotiDirect(ALCcontext *context,
     ALuint effectslot, ALenum param, ALint *value) noexcept
 try {
-    std::lock_guard<std::mutex> slotlock{context->mEffectSlotLock};
+    std::shared_lock<std::shared_mutex> slotlock{context->mEffectSlotLock};
     ALeffectslot *slot{LookupEffectSlot(context, effectslot)};
     if(!slot)
         throw al::context_error{AL_INVALID_NAME, "Invalid effect slot ID %u", effectslot};
@@ -788,7 +1005,7 @@ try {
         return;
     }
 
-    std::lock_guard<std::mutex> slotlock{context->mEffectSlotLock};
+    std::shared_lock<std::shared_mutex> slotlock{context->mEffectSlotLock};
     ALeffectslot *slot = LookupEffectSlot(context, effectslot);
     if(!slot)
         throw al::context_error{AL_INVALID_NAME, "Invalid effect slot ID %u", effectslot};
@@ -807,7 +1024,7 @@ AL_API DECL_FUNC3(void, alGetAuxiliaryEffectSlotf, ALuint,effectslot, ALenum,par
 FORCE_ALIGN void AL_APIENTRY alGetAuxiliaryEffectSlotfDirect(ALCcontext *context,
     ALuint effectslot, ALenum param, ALfloat *value) noexcept
 try {
-    std::lock_guard<std::mutex> slotlock{context->mEffectSlotLock};
+    std::shared_lock<std::shared_mutex> slotlock{context->mEffectSlotLock};
     ALeffectslot *slot{LookupEffectSlot(context, effectslot)};
     if(!slot)
         throw al::context_error{AL_INVALID_NAME, "Invalid effect slot ID %u", effectslot};
@@ -836,7 +1053,7 @@ try {
         return;
     }
 
-    std::lock_guard<std::mutex> slotlock{context->mEffectSlotLock};
+    std::shared_lock<std::shared_mutex> slotlock{context->mEffectSlotLock};
     ALeffectslot *slot{LookupEffectSlot(context, effectslot)};
     if(!slot)
         throw al::context_error{AL_INVALID_NAME, "Invalid effect slot ID %u", effectslot};
@@ -878,6 +1095,7 @@ ALeffectslot::~ALeffectslot()
         slot->State = nullptr;
 
     mSlot->mEffectState = nullptr;
+    mSlot->mId = 0u;
     mSlot->InUse = false;
 }
 
@@ -893,31 +1111,35 @@ ALenum ALeffectslot::initEffect(ALuint effectId, ALenum effectType, const Effect
             ERR("Failed to find factory for effect slot type %d\n", static_cast<int>(newtype));
             return AL_INVALID_ENUM;
         }
-        al::intrusive_ptr<EffectState> state{factory->create()};
 
+        /* A spare state from the pool is already set up for the device, but
+         * not for a buffer.
+         */
         ALCdevice *device{context->mALDevice.get()};
-        state->mOutTarget = device->Dry.Buffer;
+        al::intrusive_ptr<EffectState> state;
+        if(!Buffer)
+            state = device->mEffectStatePool->take(device, newtype);
+        if(!state)
         {
+            state = factory->create();
             FPUCtl mixer_mode{};
             state->deviceUpdate(device, Buffer);
         }
+        state->mOutTarget = device->Dry.Buffer;
 
         Effect.Type = newtype;
         Effect.Props = effectProps;
 
         Effect.State = std::move(state);
+        mBufferJob = 0u;
+        mStateReady = false;
     }
     else if(newtype != EffectSlotType::None)
         Effect.Props = effectProps;
     EffectId = effectId;
 
     /* Remove state references from old effect slot property updates. */
-    EffectSlotProps *props{context->mFreeEffectSlotProps.load()};
-    while(props)
-    {
-        props->State = nullptr;
-        props = props->next.load(std::memory_order_relaxed);
-    }
+    context->mFreeEffectSlotProps.forEach([](EffectSlotProps &props) { props.State = nullptr; });
 
     return AL_NO_ERROR;
 }
@@ -925,17 +1147,12 @@ ALenum ALeffectslot::initEffect(ALuint effectId, ALenum effectType, const Effect
 void ALeffectslot::updateProps(ALCcontext *context) const
 {
     /* Get an unused property container, or allocate a new one as needed. */
-    EffectSlotProps *props{context->mFreeEffectSlotProps.load(std::memory_order_acquire)};
+    EffectSlotProps *props{context->mFreeEffectSlotProps.pop()};
     if(!props)
     {
         context->allocEffectSlotProps();
-        props = context->mFreeEffectSlotProps.load(std::memory_order_acquire);
+        props = context->mFreeEffectSlotProps.pop();
     }
-    EffectSlotProps *next;
-    do {
-        next = props->next.load(std::memory_order_relaxed);
-    } while(!context->mFreeEffectSlotProps.compare_exchange_weak(props, next,
-        std::memory_order_acq_rel, std::memory_order_acquire));
 
     /* Copy in current property values. */
     props->Gain = Gain;
@@ -945,6 +1162,7 @@ void ALeffectslot::updateProps(ALCcontext *context) const
     props->Type = Effect.Type;
     props->Props = Effect.Props;
     props->State = Effect.State;
+    props->ReadyId = mStateReady ? id : 0u;
 
     /* Set the new container for updating internal parameters. */
     props = mSlot->Update.exchange(props, std::memory_order_acq_rel);
@@ -954,13 +1172,13 @@ void ALeffectslot::updateProps(ALCcontext *context) const
          * freelist.
          */
         props->State = nullptr;
-        AtomicReplaceHead(context->mFreeEffectSlotProps, props);
+        context->mFreeEffectSlotProps.push(props);
     }
 }
 
 void ALeffectslot::SetName(ALCcontext* context, ALuint id, std::string_view name)
 {
-    std::lock_guard<std::mutex> slotlock{context->mEffectSlotLock};
+    std::lock_guard<std::shared_mutex> slotlock{context->mEffectSlotLock};
 
     auto slot = LookupEffectSlot(context, id);
     if(!slot)
@@ -971,7 +1189,7 @@ void ALeffectslot::SetName(ALCcontext* context, ALuint id, std::string_view name
 
 void UpdateAllEffectSlotProps(ALCcontext *context)
 {
-    std::lock_guard<std::mutex> slotlock{context->mEffectSlotLock};
+    std::lock_guard<std::shared_mutex> slotlock{context->mEffectSlotLock};
     for(auto &sublist : context->mEffectSlotList)
     {
         uint64_t usemask{~sublist.FreeMask};
@@ -987,6 +1205,69 @@ void UpdateAllEffectSlotProps(ALCcontext *context)
     }
 }
 
+void EffectStatePool::reset(ALCdevice *device, uint size)
+{
+    std::array<std::vector<al::intrusive_ptr<EffectState>>,NumTypes> oldstates;
+    {
+        std::lock_guard<std::mutex> poollock{mLock};
+        std::swap(oldstates, mStates);
+        mSize = size;
+    }
+    if(size == 0)
+        return;
+
+    TRACE("Keeping %u spare effect state%s per type\n", size, (size == 1) ? "" : "s");
+    for(size_t i{1};i < NumTypes;++i)
+    {
+        const auto type = static_cast<EffectSlotType>(i);
+        if(type == EffectSlotType::Convolution)
+            continue;
+        device->add_ref();
+        SlotBufferWorker::Get().push(StatePoolJob{al::intrusive_ptr<ALCdevice>{device}, type});
+    }
+}
+
+auto EffectStatePool::take(ALCdevice *device, EffectSlotType type)
+    -> al::intrusive_ptr<EffectState>
+{
+    al::intrusive_ptr<EffectState> state;
+    {
+        std::lock_guard<std::mutex> poollock{mLock};
+        auto &states = mStates[al::to_underlying(type)];
+        if(states.empty())
+            return state;
+        state = std::move(states.back());
+        states.pop_back();
+    }
+
+    device->add_ref();
+    SlotBufferWorker::Get().push(StatePoolJob{al::intrusive_ptr<ALCdevice>{device}, type});
+    return state;
+}
+
+void EffectStatePool::fill(ALCdevice *device, EffectSlotType type)
+{
+    EffectStateFactory *factory{getFactoryByType(type)};
+    if(!factory) UNLIKELY
+        return;
+
+    auto &states = mStates[al::to_underlying(type)];
+    std::unique_lock<std::mutex> poollock{mLock};
+    while(states.size() < mSize)
+    {
+        poollock.unlock();
+
+        al::intrusive_ptr<EffectState> state{factory->create()};
+        {
+            FPUCtl mixer_mode{};
+            state->deviceUpdate(device, nullptr);
+        }
+
+        poollock.lock();
+        states.emplace_back(std::move(state));
+    }
+}
+
 EffectSlotSubList::~EffectSlotSubList()
 {
     if(!EffectSlots)
@@ -1491,7 +1772,7 @@ EaxAlEffectSlotUPtr eax_create_al_effect_slot(ALCcontext& context)
 {
 #define EAX_PREFIX "[EAX_MAKE_EFFECT_SLOT] "
 
-    std::lock_guard<std::mutex> slotlock{context.mEffectSlotLock};
+    std::lock_guard<std::shared_mutex> slotlock{context.mEffectSlotLock};
     auto& device = *context.mALDevice;
 
     if(context.mNumEffectSlots == device.AuxiliaryEffectSlotMax) {
@@ -1513,7 +1794,7 @@ void eax_delete_al_effect_slot(ALCcontext& context, ALeffectslot& effect_slot)
 {
 #define EAX_PREFIX "[EAX_DELETE_EFFECT_SLOT] "
 
-    std::lock_guard<std::mutex> slotlock{context.mEffectSlotLock};
+    std::lock_guard<std::shared_mutex> slotlock{context.mEffectSlotLock};
 
     if(effect_slot.ref.load(std::memory_order_relaxed) != 0)
     {
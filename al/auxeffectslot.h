@@ -4,8 +4,10 @@
 #include <array>
 #include <atomic>
 #include <cstdint>
+#include <mutex>
 #include <string_view>
 #include <utility>
+#include <vector>
 
 #include "AL/al.h"
 #include "AL/alc.h"
@@ -15,6 +17,7 @@
 #include "core/effects/base.h"
 #include "core/effectslot.h"
 #include "intrusive_ptr.h"
+#include "opthelpers.h"
 
 #ifdef ALSOFT_EAX
 #include <memory>
@@ -60,6 +63,15 @@ struct ALeffectslot {
 
     SlotState mState{SlotState::Initial};
 
+    /* The pending background preparation of a new buffer's effect state, or
+     * 0 if there is none.
+     */
+    uint mBufferJob{0u};
+    /* Set when the current effect state was prepared in the background, so a
+     * ready event is sent once it gets used.
+     */
+    bool mStateReady{false};
+
     std::atomic<ALuint> ref{0u};
 
     EffectSlot *mSlot{nullptr};
@@ -360,6 +372,42 @@ public:
 
 void UpdateAllEffectSlotProps(ALCcontext *context);
 
+
+/* Spare effect states for each effect type, created and updated for the
+ * device ahead of time, so changing a slot's effect type can take one instead
+ * of allocating and clearing delay lines and such. States taken are replaced
+ * in the background. Convolution states depend on the slot's buffer, so they
+ * aren't kept.
+ */
+class EffectStatePool {
+public:
+    /**
+     * Drops the spare states and sets how many to keep for each effect type,
+     * queueing new ones to be made for the device's current parameters. Must
+     * be called with the device's state lock held.
+     */
+    void reset(ALCdevice *device, uint size);
+
+    /**
+     * Takes a spare state for the given type, or returns null if there are
+     * none.
+     */
+    auto take(ALCdevice *device, EffectSlotType type) -> al::intrusive_ptr<EffectState>;
+
+    /**
+     * Makes spare states for the given type until there are enough. Must be
+     * called with the device's state lock held.
+     */
+    void fill(ALCdevice *device, EffectSlotType type);
+
+private:
+    static constexpr size_t NumTypes{al::to_underlying(EffectSlotType::VocalMorpher) + 1};
+
+    std::mutex mLock;
+    std::array<std::vector<al::intrusive_ptr<EffectState>>,NumTypes> mStates;
+    uint mSize{0};
+};
+
 #ifdef ALSOFT_EAX
 using EaxAlEffectSlotUPtr = std::unique_ptr<ALeffectslot, ALeffectslot::EaxDeleter>;
 
@@ -22,21 +22,36 @@
 
 #include "buffer.h"
 
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include <algorithm>
 #include <array>
 #include <atomic>
 #include <cassert>
+#include <cinttypes>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <deque>
 #include <iterator>
 #include <limits>
 #include <memory>
 #include <mutex>
 #include <numeric>
 #include <optional>
+#include <shared_mutex>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -52,13 +67,17 @@
 #include "almalloc.h"
 #include "alnumeric.h"
 #include "alspan.h"
+#include "althrd_setname.h"
+#include "core/async_event.h"
 #include "core/device.h"
+#include "core/logging.h"
 #include "core/resampler_limits.h"
 #include "core/voice.h"
 #include "direct_defs.h"
 #include "error.h"
 #include "intrusive_ptr.h"
 #include "opthelpers.h"
+#include "strutils.h"
 
 #ifdef ALSOFT_EAX
 #include <unordered_set>
@@ -70,6 +89,8 @@
 
 namespace {
 
+using namespace std::string_view_literals;
+
 using SubListAllocator = al::allocator<std::array<ALbuffer,64>>;
 
 constexpr auto AmbiLayoutFromEnum(ALenum layout) noexcept -> std::optional<AmbiLayout>
@@ -218,6 +239,18 @@ ALbuffer *AllocBuffer(ALCdevice *device) noexcept
     return buffer;
 }
 
+/* Updates the device's buffer memory usage with the buffer's current storage.
+ * Shared data is counted for each buffer using it, as any of them may keep it
+ * alive.
+ */
+void UpdateBufferMemory(ALCdevice *device, ALbuffer *buffer) noexcept
+{
+    size_t size{buffer->mDataStorage.size() + buffer->mDecodedStorage.size()};
+    if(const auto &shared = buffer->mSharedData)
+        size += shared->mData.size() + shared->mDecoded.size();
+    device->mMemory->update(MemoryUsage::Buffers, std::exchange(buffer->mMemUsage, size), size);
+}
+
 void FreeBuffer(ALCdevice *device, ALbuffer *buffer)
 {
 #ifdef ALSOFT_EAX
@@ -230,6 +263,8 @@ void FreeBuffer(ALCdevice *device, ALbuffer *buffer)
     const size_t lidx{id >> 6};
     const ALuint slidx{id & 0x3f};
 
+    device->mBufferPool->release(std::move(buffer->mDataStorage));
+    device->mMemory->sub(MemoryUsage::Buffers, buffer->mMemUsage);
     std::destroy_at(buffer);
 
     device->BufferList[lidx].FreeMask |= 1_u64 << slidx;
@@ -263,6 +298,8 @@ constexpr auto SanitizeAlignment(FmtType type, ALuint align) noexcept -> ALuint
         }
         if(type == FmtMSADPCM)
             return 64;
+        if(type == FmtIMA2)
+            return 65;
         return 1;
     }
 
@@ -278,15 +315,47 @@ constexpr auto SanitizeAlignment(FmtType type, ALuint align) noexcept -> ALuint
         if((align&1) == 0) return static_cast<ALuint>(align);
         return 0;
     }
+    if(type == FmtIMA2)
+    {
+        /* IMA2 block alignment must be a multiple of 16, plus 1. */
+        if((align&15) == 1) return static_cast<ALuint>(align);
+        return 0;
+    }
 
     return static_cast<ALuint>(align);
 }
 
+constexpr bool IsCompressed(FmtType type) noexcept
+{
+    return type == FmtMulaw || type == FmtAlaw || type == FmtIMA4 || type == FmtMSADPCM
+        || type == FmtIMA2;
+}
+
 
-/** Loads the specified data into the buffer, using the specified format. */
-void LoadData(ALCcontext *context [[maybe_unused]], ALbuffer *ALBuf, ALsizei freq, ALuint size,
-    const FmtChannels DstChannels, const FmtType DstType, const std::byte *SrcData,
-    ALbitfieldSOFT access)
+/* The sample layout of new buffer data, checked against the buffer. */
+struct DataLayout {
+    ALuint align;
+    ALuint ambiorder;
+    ALuint numChannels;
+    ALuint blockSize;
+    ALuint blocks;
+    bool decode;
+    bool decodeUhj;
+
+    [[nodiscard]] auto dataSize() const noexcept -> size_t
+    { return static_cast<size_t>(blocks) * blockSize; }
+    /* The size in bytes of the decoded copy, if any. */
+    [[nodiscard]] auto decodedSize() const noexcept -> size_t
+    {
+        if(decodeUhj)
+            return size_t{blocks} * align * std::max(numChannels, 3u) * sizeof(float);
+        return decode ? size_t{blocks} * align * numChannels * sizeof(int16_t) : 0_uz;
+    }
+};
+
+/** Checks that the buffer can be given new storage of the specified format. */
+auto CheckDataLayout(ALCcontext *context, const ALbuffer *ALBuf, ALuint size,
+    const FmtChannels DstChannels, const FmtType DstType, ALbitfieldSOFT access) -> DataLayout
 {
     if(ALBuf->ref.load(std::memory_order_relaxed) != 0 || ALBuf->MappedAccess != 0)
         throw al::context_error{AL_INVALID_OPERATION, "Modifying storage for in-use buffer %u",
@@ -317,6 +386,7 @@ void LoadData(ALCcontext *context [[maybe_unused]], ALbuffer *ALBuf, ALsizei fre
     const ALuint BlockSize{NumChannels *
         ((DstType == FmtIMA4) ? (align-1)/2 + 4 :
         (DstType == FmtMSADPCM) ? (align-2)/2 + 7 :
+        (DstType == FmtIMA2) ? (align-1)/4 + 4 :
         (align * BytesFromFmt(DstType)))};
     if((size%BlockSize) != 0)
         throw al::context_error{AL_INVALID_VALUE,
@@ -331,7 +401,17 @@ void LoadData(ALCcontext *context [[maybe_unused]], ALbuffer *ALBuf, ALsizei fre
         throw al::context_error{AL_OUT_OF_MEMORY,
             "Buffer size overflow, %d frames x %d bytes per frame", blocks, BlockSize};
 
-    const size_t newsize{static_cast<size_t>(blocks) * BlockSize};
+    /* Compressed samples can optionally be decoded once here, instead of by
+     * each voice as it plays. A writable mapping could change the samples
+     * without updating the decoded copy, so those are left compressed.
+     */
+    const bool decode{IsCompressed(DstType) && !(access&AL_MAP_WRITE_BIT_SOFT)
+        && context->mALDevice->getConfigValueBool({}, "decode-compressed-buffers"sv, false)};
+    /* UHJ samples can likewise be decoded to B-Format once, instead of each
+     * voice running its own UHJ decoder.
+     */
+    const bool decodeUhj{IsUHJ(DstChannels) && !(access&AL_MAP_WRITE_BIT_SOFT)
+        && context->mALDevice->getConfigValueBool("uhj"sv, "decode-buffers"sv, false)};
 
 #ifdef ALSOFT_EAX
     if(ALBuf->eax_x_ram_mode == EaxStorage::Hardware)
@@ -343,30 +423,28 @@ void LoadData(ALCcontext *context [[maybe_unused]], ALbuffer *ALBuf, ALsizei fre
     }
 #endif
 
-    /* This could reallocate only when increasing the size or the new size is
-     * less than half the current, but then the buffer's AL_SIZE would not be
-     * very reliable for accounting buffer memory usage, and reporting the real
-     * size could cause problems for apps that use AL_SIZE to try to get the
-     * buffer's play length.
-     */
-    if(newsize != ALBuf->mDataStorage.size())
-    {
-        auto newdata = decltype(ALBuf->mDataStorage)(newsize, std::byte{});
-        if((access&AL_PRESERVE_DATA_BIT_SOFT))
-        {
-            const size_t tocopy{std::min(newdata.size(), ALBuf->mDataStorage.size())};
-            std::copy_n(ALBuf->mDataStorage.begin(), tocopy, newdata.begin());
-        }
-        newdata.swap(ALBuf->mDataStorage);
-    }
-    ALBuf->mData = ALBuf->mDataStorage;
-#ifdef ALSOFT_EAX
-    eax_x_ram_clear(*context->mALDevice, *ALBuf);
-#endif
+    return DataLayout{align, ambiorder, NumChannels, BlockSize, blocks, decode, decodeUhj};
+}
 
-    if(SrcData != nullptr && !ALBuf->mData.empty())
-        std::copy_n(SrcData, blocks*BlockSize, ALBuf->mData.begin());
-    ALBuf->mBlockAlign = (DstType == FmtIMA4 || DstType == FmtMSADPCM) ? align : 1;
+/** Fills the decoded copy of the given sample data, as specified by the layout. */
+void DecodeData(const al::span<std::byte> decoded, const al::span<const std::byte> data,
+    const FmtChannels channels, const FmtType type, const DataLayout &layout,
+    const UhjQualityType quality)
+{
+    if(layout.decodeUhj)
+        DecodeUhjSamples({reinterpret_cast<float*>(decoded.data()), decoded.size()/sizeof(float)},
+            data, channels, type, layout.align, quality);
+    else if(layout.decode)
+        DecodeSamples({reinterpret_cast<int16_t*>(decoded.data()),
+            decoded.size()/sizeof(int16_t)}, data, type, layout.numChannels, layout.align);
+}
+
+/** Sets the buffer's format after its storage has been filled. */
+void SetDataFormat(ALCcontext *context, ALbuffer *ALBuf, ALsizei freq,
+    ALuint size, const FmtChannels DstChannels, const FmtType DstType, const DataLayout &layout,
+    ALbitfieldSOFT access)
+{
+    ALBuf->mBlockAlign = (DstType == FmtIMA4 || DstType == FmtMSADPCM || DstType == FmtIMA2) ? layout.align : 1;
 
     ALBuf->OriginalSize = size;
 
@@ -375,14 +453,18 @@ void LoadData(ALCcontext *context [[maybe_unused]], ALbuffer *ALBuf, ALsizei fre
     ALBuf->mSampleRate = static_cast<ALuint>(freq);
     ALBuf->mChannels = DstChannels;
     ALBuf->mType = DstType;
-    ALBuf->mAmbiOrder = ambiorder;
+    ALBuf->mAmbiOrder = layout.ambiorder;
 
     ALBuf->mCallback = nullptr;
     ALBuf->mUserData = nullptr;
+    ALBuf->mRing = nullptr;
+    ALBuf->mCallbackThread = nullptr;
+    ALBuf->mSharedData = nullptr;
 
-    ALBuf->mSampleLen = blocks * align;
+    ALBuf->mSampleLen = layout.blocks * layout.align;
     ALBuf->mLoopStart = 0;
     ALBuf->mLoopEnd = ALBuf->mSampleLen;
+    UpdateBufferMemory(context->mALDevice.get(), ALBuf);
 
 #ifdef ALSOFT_EAX
     if(eax_g_is_enabled && ALBuf->eax_x_ram_mode == EaxStorage::Hardware)
@@ -390,10 +472,59 @@ void LoadData(ALCcontext *context [[maybe_unused]], ALbuffer *ALBuf, ALsizei fre
 #endif
 }
 
+/** Loads the specified data into the buffer, using the specified format. */
+void LoadData(ALCcontext *context, ALbuffer *ALBuf, ALsizei freq, ALuint size,
+    const FmtChannels DstChannels, const FmtType DstType, const std::byte *SrcData,
+    ALbitfieldSOFT access)
+{
+    const DataLayout layout{CheckDataLayout(context, ALBuf, size, DstChannels, DstType, access)};
+    const size_t newsize{layout.dataSize()};
+    auto decodedStorage = decltype(ALBuf->mDecodedStorage)(layout.decodedSize());
+
+    /* AL_SIZE reports the size of the data rather than the storage, so the
+     * current storage is kept if it's big enough and isn't more than twice
+     * the size needed (or reserved). Otherwise new storage is taken from the
+     * device's pool, which also takes back the old storage.
+     */
+    const size_t oldsize{(ALBuf->mData.data() == ALBuf->mDataStorage.data())
+        ? ALBuf->mData.size() : 0_uz};
+    const size_t keepsize{(access&AL_PRESERVE_DATA_BIT_SOFT) ? std::min(oldsize, newsize) : 0_uz};
+    const size_t wantsize{std::max(newsize, size_t{ALBuf->mReserveSize})};
+    if(newsize > ALBuf->mDataStorage.size() || ALBuf->mDataStorage.size()/2 > wantsize)
+    {
+        BufferStoragePool &pool = *context->mALDevice->mBufferPool;
+        auto newdata = pool.acquire(wantsize);
+        std::copy_n(ALBuf->mDataStorage.begin(), keepsize, newdata.begin());
+        newdata.swap(ALBuf->mDataStorage);
+        pool.release(std::move(newdata));
+    }
+    ALBuf->mData = al::span{ALBuf->mDataStorage}.first(newsize);
+#ifdef ALSOFT_EAX
+    eax_x_ram_clear(*context->mALDevice, *ALBuf);
+#endif
+
+    /* Reused storage may have old samples, so clear anything that isn't being
+     * set or preserved.
+     */
+    if(SrcData != nullptr && !ALBuf->mData.empty())
+        std::copy_n(SrcData, newsize, ALBuf->mData.begin());
+    else
+        std::fill(ALBuf->mData.begin()+ptrdiff_t(keepsize), ALBuf->mData.end(), std::byte{});
+
+    decodedStorage.swap(ALBuf->mDecodedStorage);
+    ALBuf->mDecodedData = ALBuf->mDecodedStorage;
+    ALBuf->mIsDecoded = layout.decode || layout.decodeUhj;
+    ALBuf->mIsUhjDecoded = layout.decodeUhj;
+    DecodeData(ALBuf->mDecodedData, ALBuf->mData, DstChannels, DstType, layout,
+        context->mALDevice->mUhjDecodeQuality);
+
+    SetDataFormat(context, ALBuf, freq, size, DstChannels, DstType, layout, access);
+}
+
 /** Prepares the buffer to use the specified callback, using the specified format. */
-void PrepareCallback(ALCcontext *context [[maybe_unused]], ALbuffer *ALBuf, ALsizei freq,
+void PrepareCallback(ALCcontext *context, ALbuffer *ALBuf, ALsizei freq,
     const FmtChannels DstChannels, const FmtType DstType, ALBUFFERCALLBACKTYPESOFT callback,
-    void *userptr)
+    void *userptr, const ALuint requestSize)
 {
     if(ALBuf->ref.load(std::memory_order_relaxed) != 0 || ALBuf->MappedAccess != 0)
         throw al::context_error{AL_INVALID_OPERATION, "Modifying callback for in-use buffer %u",
@@ -411,20 +542,25 @@ void PrepareCallback(ALCcontext *context [[maybe_unused]], ALbuffer *ALBuf, ALsi
     const ALuint BlockSize{ChannelsFromFmt(DstChannels, ambiorder) *
         ((DstType == FmtIMA4) ? (align-1)/2 + 4 :
         (DstType == FmtMSADPCM) ? (align-2)/2 + 7 :
+        (DstType == FmtIMA2) ? (align-1)/4 + 4 :
         (align * BytesFromFmt(DstType)))};
 
     /* The maximum number of samples a callback buffer may need to store is a
      * full mixing line * max pitch * channel count, since it may need to hold
      * a full line's worth of sample frames before downsampling. An additional
      * MaxResamplerEdge is needed for "future" samples during resampling (the
-     * voice will hold a history for the past samples).
+     * voice will hold a history for the past samples). A minimum request
+     * size adds to this, so a full request always fits after what's left.
      */
     static constexpr size_t line_size{DeviceBase::MixerLineSize*MaxPitch + MaxResamplerEdge};
     const size_t line_blocks{(line_size + align-1) / align};
+    const size_t request_blocks{(size_t{requestSize} + align-1) / align};
+    const size_t storage_size{(line_blocks+request_blocks) * BlockSize};
 
-    using BufferVectorType = decltype(ALBuf->mDataStorage);
-    BufferVectorType(line_blocks*BlockSize).swap(ALBuf->mDataStorage);
-    ALBuf->mData = ALBuf->mDataStorage;
+    BufferStoragePool &pool = *context->mALDevice->mBufferPool;
+    pool.release(std::exchange(ALBuf->mDataStorage, pool.acquire(storage_size)));
+    ALBuf->mData = al::span{ALBuf->mDataStorage}.first(storage_size);
+    ALBuf->clearDecoded();
 
 #ifdef ALSOFT_EAX
     eax_x_ram_clear(*context->mALDevice, *ALBuf);
@@ -432,11 +568,15 @@ void PrepareCallback(ALCcontext *context [[maybe_unused]], ALbuffer *ALBuf, ALsi
 
     ALBuf->mCallback = callback;
     ALBuf->mUserData = userptr;
+    ALBuf->mCallbackRequest = static_cast<ALuint>(request_blocks);
+    ALBuf->mRing = nullptr;
+    ALBuf->mCallbackThread = nullptr;
+    ALBuf->mSharedData = nullptr;
 
     ALBuf->OriginalSize = 0;
     ALBuf->Access = 0;
 
-    ALBuf->mBlockAlign = (DstType == FmtIMA4 || DstType == FmtMSADPCM) ? align : 1;
+    ALBuf->mBlockAlign = (DstType == FmtIMA4 || DstType == FmtMSADPCM || DstType == FmtIMA2) ? align : 1;
     ALBuf->mSampleRate = static_cast<ALuint>(freq);
     ALBuf->mChannels = DstChannels;
     ALBuf->mType = DstType;
@@ -445,10 +585,11 @@ void PrepareCallback(ALCcontext *context [[maybe_unused]], ALbuffer *ALBuf, ALsi
     ALBuf->mSampleLen = 0;
     ALBuf->mLoopStart = 0;
     ALBuf->mLoopEnd = ALBuf->mSampleLen;
+    UpdateBufferMemory(context->mALDevice.get(), ALBuf);
 }
 
 /** Prepares the buffer to use caller-specified storage. */
-void PrepareUserPtr(ALCcontext *context [[maybe_unused]], ALbuffer *ALBuf, ALsizei freq,
+void PrepareUserPtr(ALCcontext *context, ALbuffer *ALBuf, ALsizei freq,
     const FmtChannels DstChannels, const FmtType DstType, std::byte *sdata, const ALuint sdatalen)
 {
     if(ALBuf->ref.load(std::memory_order_relaxed) != 0 || ALBuf->MappedAccess != 0)
@@ -473,10 +614,12 @@ void PrepareUserPtr(ALCcontext *context [[maybe_unused]], ALbuffer *ALBuf, ALsiz
         case FmtInt: return alignof(ALint);
         case FmtFloat: return alignof(ALfloat);
         case FmtDouble: return alignof(ALdouble);
+        case FmtHalf: return alignof(ALushort);
         case FmtMulaw: return alignof(ALubyte);
         case FmtAlaw: return alignof(ALubyte);
         case FmtIMA4: break;
         case FmtMSADPCM: break;
+        case FmtIMA2: break;
         }
         return 1;
     };
@@ -493,6 +636,7 @@ void PrepareUserPtr(ALCcontext *context [[maybe_unused]], ALbuffer *ALBuf, ALsiz
     const ALuint BlockSize{NumChannels *
         ((DstType == FmtIMA4) ? (align-1)/2 + 4 :
         (DstType == FmtMSADPCM) ? (align-2)/2 + 7 :
+        (DstType == FmtIMA2) ? (align-1)/4 + 4 :
         (align * BytesFromFmt(DstType)))};
     if((sdatalen%BlockSize) != 0)
         throw al::context_error{AL_INVALID_VALUE,
@@ -518,8 +662,9 @@ void PrepareUserPtr(ALCcontext *context [[maybe_unused]], ALbuffer *ALBuf, ALsiz
     }
 #endif
 
-    decltype(ALBuf->mDataStorage){}.swap(ALBuf->mDataStorage);
+    context->mALDevice->mBufferPool->release(std::move(ALBuf->mDataStorage));
     ALBuf->mData = {static_cast<std::byte*>(sdata), sdatalen};
+    ALBuf->clearDecoded();
 
 #ifdef ALSOFT_EAX
     eax_x_ram_clear(*context->mALDevice, *ALBuf);
@@ -527,11 +672,14 @@ void PrepareUserPtr(ALCcontext *context [[maybe_unused]], ALbuffer *ALBuf, ALsiz
 
     ALBuf->mCallback = nullptr;
     ALBuf->mUserData = nullptr;
+    ALBuf->mRing = nullptr;
+    ALBuf->mCallbackThread = nullptr;
+    ALBuf->mSharedData = nullptr;
 
     ALBuf->OriginalSize = sdatalen;
     ALBuf->Access = 0;
 
-    ALBuf->mBlockAlign = (DstType == FmtIMA4 || DstType == FmtMSADPCM) ? align : 1;
+    ALBuf->mBlockAlign = (DstType == FmtIMA4 || DstType == FmtMSADPCM || DstType == FmtIMA2) ? align : 1;
     ALBuf->mSampleRate = static_cast<ALuint>(freq);
     ALBuf->mChannels = DstChannels;
     ALBuf->mType = DstType;
@@ -540,6 +688,7 @@ void PrepareUserPtr(ALCcontext *context [[maybe_unused]], ALbuffer *ALBuf, ALsiz
     ALBuf->mSampleLen = blocks * align;
     ALBuf->mLoopStart = 0;
     ALBuf->mLoopEnd = ALBuf->mSampleLen;
+    UpdateBufferMemory(context->mALDevice.get(), ALBuf);
 
 #ifdef ALSOFT_EAX
     if(ALBuf->eax_x_ram_mode == EaxStorage::Hardware)
@@ -548,6 +697,248 @@ void PrepareUserPtr(ALCcontext *context [[maybe_unused]], ALbuffer *ALBuf, ALsiz
 }
 
 
+/* The callback for ring buffers. Underruns are filled with silence so the
+ * voice keeps playing, unless the ring was ended.
+ */
+ALsizei AL_APIENTRY ReadBufferRing(ALvoid *userptr, ALvoid *sampledata, ALsizei numbytes)
+    noexcept
+{
+    auto *bufring = static_cast<BufferRing*>(userptr);
+    /* Check for the end first, so everything written before it gets read. */
+    const bool ended{bufring->mEnded.load(std::memory_order_acquire)};
+
+    RingBuffer *ring{bufring->mRing.get()};
+    const size_t framesize{ring->getElemSize()};
+    const size_t numframes{static_cast<ALuint>(numbytes) / framesize};
+    const size_t gotbytes{ring->read(sampledata, numframes) * framesize};
+    if(gotbytes < static_cast<ALuint>(numbytes) && !ended)
+    {
+        const auto output = al::span{static_cast<std::byte*>(sampledata),
+            static_cast<ALuint>(numbytes)};
+        std::fill(output.begin()+ptrdiff_t(gotbytes), output.end(), bufring->mSilence);
+        return numbytes;
+    }
+    return static_cast<ALsizei>(gotbytes);
+}
+
+/** Prepares the buffer to play from a ring buffer of the given size. */
+void PrepareRing(ALCcontext *context, ALbuffer *ALBuf, ALsizei freq,
+    const FmtChannels DstChannels, const FmtType DstType, const ALuint size)
+{
+    if(DstType == FmtIMA4 || DstType == FmtMSADPCM || DstType == FmtIMA2)
+        throw al::context_error{AL_INVALID_ENUM, "Ring buffers do not support %s samples",
+            NameFromFormat(DstType)};
+
+    const ALuint ambiorder{IsBFormat(DstChannels) ? ALBuf->UnpackAmbiOrder :
+        (IsUHJ(DstChannels) ? 1 : 0)};
+    const ALuint framesize{ChannelsFromFmt(DstChannels, ambiorder) * BytesFromFmt(DstType)};
+    if(size < framesize)
+        throw al::context_error{AL_INVALID_VALUE, "Ring buffer size %u is less than a frame (%u)",
+            size, framesize};
+
+    auto bufring = std::make_unique<BufferRing>();
+    bufring->mRing = RingBuffer::Create(size/framesize, framesize, true);
+    switch(DstType)
+    {
+    case FmtUByte: bufring->mSilence = std::byte{0x80}; break;
+    case FmtMulaw: bufring->mSilence = std::byte{0xff}; break;
+    case FmtAlaw: bufring->mSilence = std::byte{0xd5}; break;
+    case FmtShort:
+    case FmtInt:
+    case FmtFloat:
+    case FmtDouble:
+    case FmtIMA4:
+    case FmtMSADPCM:
+    case FmtIMA2:
+    case FmtHalf:
+        bufring->mSilence = std::byte{0x00};
+        break;
+    }
+
+    PrepareCallback(context, ALBuf, freq, DstChannels, DstType, ReadBufferRing, bufring.get(), 0);
+    ALBuf->mRing = std::move(bufring);
+}
+
+
+/* The callback for buffers with a callback thread. This reads the ring the
+ * thread fills, and wakes the thread to refill it.
+ */
+ALsizei AL_APIENTRY ReadCallbackThread(ALvoid *userptr, ALvoid *sampledata, ALsizei numbytes)
+    noexcept
+{
+    auto *cbthread = static_cast<BufferCallbackThread*>(userptr);
+    const ALsizei ret{ReadBufferRing(&cbthread->mRing, sampledata, numbytes)};
+    cbthread->mSem.post();
+    return ret;
+}
+
+/** Prepares the buffer to call the specified callback from its own thread. */
+void PrepareCallbackThread(ALCcontext *context, ALbuffer *ALBuf, ALsizei freq,
+    const FmtChannels DstChannels, const FmtType DstType, ALBUFFERCALLBACKTYPESOFT callback,
+    void *userptr)
+{
+    if(DstType == FmtIMA4 || DstType == FmtMSADPCM || DstType == FmtIMA2)
+        throw al::context_error{AL_INVALID_ENUM, "Callback threads do not support %s samples",
+            NameFromFormat(DstType)};
+
+    const ALuint ambiorder{IsBFormat(DstChannels) ? ALBuf->UnpackAmbiOrder :
+        (IsUHJ(DstChannels) ? 1 : 0)};
+    const ALuint framesize{ChannelsFromFmt(DstChannels, ambiorder) * BytesFromFmt(DstType)};
+
+    /* Without a request size, ask for a mixing line's worth of samples. */
+    auto cbthread = std::make_unique<BufferCallbackThread>();
+    cbthread->mCallback = callback;
+    cbthread->mUserData = userptr;
+    cbthread->mRequestFrames = ALBuf->mCallbackRequestSize ? ALBuf->mCallbackRequestSize
+        : DeviceBase::MixerLineSize;
+    cbthread->mRing.mRing = RingBuffer::Create(cbthread->mRequestFrames*ALBuf->mCallbackPrefetch,
+        framesize, false);
+    switch(DstType)
+    {
+    case FmtUByte: cbthread->mRing.mSilence = std::byte{0x80}; break;
+    case FmtMulaw: cbthread->mRing.mSilence = std::byte{0xff}; break;
+    case FmtAlaw: cbthread->mRing.mSilence = std::byte{0xd5}; break;
+    case FmtShort:
+    case FmtInt:
+    case FmtFloat:
+    case FmtDouble:
+    case FmtIMA4:
+    case FmtMSADPCM:
+    case FmtIMA2:
+    case FmtHalf:
+        cbthread->mRing.mSilence = std::byte{0x00};
+        break;
+    }
+
+    PrepareCallback(context, ALBuf, freq, DstChannels, DstType, ReadCallbackThread,
+        cbthread.get(), 0);
+
+    /* Start filling the ring right away, so it's ready when played. */
+    try {
+        cbthread->mThread = std::thread{&BufferCallbackThread::run, cbthread.get()};
+    }
+    catch(std::exception &e) {
+        ERR("Failed to start buffer callback thread: %s\n", e.what());
+        PrepareCallback(context, ALBuf, freq, DstChannels, DstType, callback, userptr,
+            ALBuf->mCallbackRequestSize);
+        return;
+    }
+    cbthread->mSem.post();
+    ALBuf->mCallbackThread = std::move(cbthread);
+}
+
+
+/* Maps the given region of a file as read-only memory, returning a pointer to
+ * the start of the region. Pages are loaded as they're read.
+ */
+auto MapFileRegion(const char *filename, uint64_t offset, size_t size)
+    -> std::shared_ptr<const void>
+{
+#ifdef _WIN32
+    HANDLE file{CreateFileW(utf8_to_wstr(filename).c_str(), GENERIC_READ,
+        FILE_SHARE_READ|FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL|FILE_FLAG_SEQUENTIAL_SCAN, nullptr)};
+    if(file == INVALID_HANDLE_VALUE)
+        throw al::context_error{AL_INVALID_VALUE, "Failed to open %s", filename};
+
+    LARGE_INTEGER filesize{};
+    if(!GetFileSizeEx(file, &filesize) || static_cast<uint64_t>(filesize.QuadPart) < offset
+        || static_cast<uint64_t>(filesize.QuadPart) - offset < size)
+    {
+        CloseHandle(file);
+        throw al::context_error{AL_INVALID_VALUE, "Region %" PRIu64 "+%zu is outside of %s",
+            offset, size, filename};
+    }
+
+    /* The view keeps the mapping alive after the handles are closed. Views
+     * need to start on an allocation boundary.
+     */
+    HANDLE mapping{CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr)};
+    CloseHandle(file);
+    if(!mapping)
+        throw al::context_error{AL_OUT_OF_MEMORY, "Failed to map %s", filename};
+
+    SYSTEM_INFO sysinfo{};
+    GetSystemInfo(&sysinfo);
+    const uint64_t base{offset - offset%sysinfo.dwAllocationGranularity};
+    const auto skip = static_cast<size_t>(offset - base);
+    void *ptr{MapViewOfFile(mapping, FILE_MAP_READ, static_cast<DWORD>(base>>32),
+        static_cast<DWORD>(base), skip+size)};
+    CloseHandle(mapping);
+    if(!ptr)
+        throw al::context_error{AL_OUT_OF_MEMORY, "Failed to map %s", filename};
+
+    auto view = std::shared_ptr<const void>{ptr, [](const void *p) { UnmapViewOfFile(p); }};
+#else
+
+    const int fd{open(filename, O_RDONLY | O_CLOEXEC)};
+    if(fd == -1)
+        throw al::context_error{AL_INVALID_VALUE, "Failed to open %s", filename};
+
+    struct stat st{};
+    if(fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) < offset
+        || static_cast<uint64_t>(st.st_size) - offset < size)
+    {
+        close(fd);
+        throw al::context_error{AL_INVALID_VALUE, "Region %" PRIu64 "+%zu is outside of %s",
+            offset, size, filename};
+    }
+
+    /* The mapping stays valid after the descriptor is closed. Mappings need
+     * to start on a page boundary.
+     */
+    const auto pagesize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    const uint64_t base{offset - offset%pagesize};
+    const auto skip = static_cast<size_t>(offset - base);
+    const size_t mapsize{skip + size};
+    void *ptr{mmap(nullptr, mapsize, PROT_READ, MAP_SHARED, fd, static_cast<off_t>(base))};
+    close(fd);
+    if(ptr == MAP_FAILED)
+        throw al::context_error{AL_OUT_OF_MEMORY, "Failed to map %s", filename};
+
+    /* Samples are mostly read in order, so ask for aggressive read-ahead and
+     * start reading now, without waiting for it.
+     */
+    std::ignore = madvise(ptr, mapsize, MADV_SEQUENTIAL);
+    std::ignore = madvise(ptr, mapsize, MADV_WILLNEED);
+
+    /* NOLINTNEXTLINE(*-const-cast) */
+    auto view = std::shared_ptr<const void>{ptr, [mapsize](const void *p)
+        { munmap(const_cast<void*>(p), mapsize); }};
+#endif
+
+    /* Alias the region start with the mapping's ownership. */
+    return std::shared_ptr<const void>{view, static_cast<const std::byte*>(view.get()) + skip};
+}
+
+/** Prepares the buffer to use a read-only mapping of a file region. */
+void PrepareMapped(ALCcontext *context, ALbuffer *ALBuf, ALsizei freq,
+    const FmtChannels DstChannels, const FmtType DstType, const char *filename, uint64_t offset,
+    const ALuint size)
+{
+    /* The mapping can't be written to, so compressed samples aren't decoded.
+     * That would also read the whole file up front.
+     */
+    DataLayout layout{CheckDataLayout(context, ALBuf, size, DstChannels, DstType, 0)};
+    layout.decode = false;
+    layout.decodeUhj = false;
+
+    auto shared = std::make_shared<BufferSharedData>();
+    shared->mMapping = MapFileRegion(filename, offset, size);
+
+    context->mALDevice->mBufferPool->release(std::move(ALBuf->mDataStorage));
+    ALBuf->clearDecoded();
+#ifdef ALSOFT_EAX
+    eax_x_ram_clear(*context->mALDevice, *ALBuf);
+#endif
+
+    /* NOLINTNEXTLINE(*-const-cast) Shared data is never written. */
+    ALBuf->mData = {static_cast<std::byte*>(const_cast<void*>(shared->mMapping.get())), size};
+    SetDataFormat(context, ALBuf, freq, size, DstChannels, DstType, layout, 0);
+    ALBuf->mSharedData = std::move(shared);
+}
+
+
 struct DecompResult { FmtChannels channels; FmtType type; };
 auto DecomposeUserFormat(ALenum format) noexcept -> std::optional<DecompResult>
 {
@@ -565,6 +956,8 @@ auto DecomposeUserFormat(ALenum format) noexcept -> std::optional<DecompResult>
         FormatMap{AL_FORMAT_MONO_MSADPCM_SOFT, {FmtMono, FmtMSADPCM}},
         FormatMap{AL_FORMAT_MONO_MULAW,        {FmtMono, FmtMulaw}  },
         FormatMap{AL_FORMAT_MONO_ALAW_EXT,     {FmtMono, FmtAlaw}   },
+        FormatMap{AL_FORMAT_MONO_IMA2_SOFT,    {FmtMono, FmtIMA2}   },
+        FormatMap{AL_FORMAT_MONO_HALF_SOFT,    {FmtMono, FmtHalf}   },
 
         FormatMap{AL_FORMAT_STEREO8,             {FmtStereo, FmtUByte}  },
         FormatMap{AL_FORMAT_STEREO16,            {FmtStereo, FmtShort}  },
@@ -575,6 +968,8 @@ auto DecomposeUserFormat(ALenum format) noexcept -> std::optional<DecompResult>
         FormatMap{AL_FORMAT_STEREO_MSADPCM_SOFT, {FmtStereo, FmtMSADPCM}},
         FormatMap{AL_FORMAT_STEREO_MULAW,        {FmtStereo, FmtMulaw}  },
         FormatMap{AL_FORMAT_STEREO_ALAW_EXT,     {FmtStereo, FmtAlaw}   },
+        FormatMap{AL_FORMAT_STEREO_IMA2_SOFT,    {FmtStereo, FmtIMA2}   },
+        FormatMap{AL_FORMAT_STEREO_HALF_SOFT,    {FmtStereo, FmtHalf}   },
 
         FormatMap{AL_FORMAT_REAR8,        {FmtRear, FmtUByte}},
         FormatMap{AL_FORMAT_REAR16,       {FmtRear, FmtShort}},
@@ -592,6 +987,7 @@ auto DecomposeUserFormat(ALenum format) noexcept -> std::optional<DecompResult>
         FormatMap{AL_FORMAT_QUAD_I32,     {FmtQuad, FmtInt}  },
         FormatMap{AL_FORMAT_QUAD_FLOAT32, {FmtQuad, FmtFloat}},
         FormatMap{AL_FORMAT_QUAD_MULAW,   {FmtQuad, FmtMulaw}},
+        FormatMap{AL_FORMAT_QUAD_HALF_SOFT, {FmtQuad, FmtHalf}},
 
         FormatMap{AL_FORMAT_51CHN8,        {FmtX51, FmtUByte}},
         FormatMap{AL_FORMAT_51CHN16,       {FmtX51, FmtShort}},
@@ -599,6 +995,7 @@ auto DecomposeUserFormat(ALenum format) noexcept -> std::optional<DecompResult>
         FormatMap{AL_FORMAT_51CHN_I32,     {FmtX51, FmtInt}  },
         FormatMap{AL_FORMAT_51CHN_FLOAT32, {FmtX51, FmtFloat}},
         FormatMap{AL_FORMAT_51CHN_MULAW,   {FmtX51, FmtMulaw}},
+        FormatMap{AL_FORMAT_51CHN_HALF_SOFT, {FmtX51, FmtHalf}},
 
         FormatMap{AL_FORMAT_61CHN8,        {FmtX61, FmtUByte}},
         FormatMap{AL_FORMAT_61CHN16,       {FmtX61, FmtShort}},
@@ -606,6 +1003,7 @@ auto DecomposeUserFormat(ALenum format) noexcept -> std::optional<DecompResult>
         FormatMap{AL_FORMAT_61CHN_I32,     {FmtX61, FmtInt}  },
         FormatMap{AL_FORMAT_61CHN_FLOAT32, {FmtX61, FmtFloat}},
         FormatMap{AL_FORMAT_61CHN_MULAW,   {FmtX61, FmtMulaw}},
+        FormatMap{AL_FORMAT_61CHN_HALF_SOFT, {FmtX61, FmtHalf}},
 
         FormatMap{AL_FORMAT_71CHN8,        {FmtX71, FmtUByte}},
         FormatMap{AL_FORMAT_71CHN16,       {FmtX71, FmtShort}},
@@ -613,16 +1011,19 @@ auto DecomposeUserFormat(ALenum format) noexcept -> std::optional<DecompResult>
         FormatMap{AL_FORMAT_71CHN_I32,     {FmtX71, FmtInt}  },
         FormatMap{AL_FORMAT_71CHN_FLOAT32, {FmtX71, FmtFloat}},
         FormatMap{AL_FORMAT_71CHN_MULAW,   {FmtX71, FmtMulaw}},
+        FormatMap{AL_FORMAT_71CHN_HALF_SOFT, {FmtX71, FmtHalf}},
 
         FormatMap{AL_FORMAT_BFORMAT2D_8,       {FmtBFormat2D, FmtUByte}},
         FormatMap{AL_FORMAT_BFORMAT2D_16,      {FmtBFormat2D, FmtShort}},
         FormatMap{AL_FORMAT_BFORMAT2D_FLOAT32, {FmtBFormat2D, FmtFloat}},
         FormatMap{AL_FORMAT_BFORMAT2D_MULAW,   {FmtBFormat2D, FmtMulaw}},
+        FormatMap{AL_FORMAT_BFORMAT2D_HALF_SOFT, {FmtBFormat2D, FmtHalf}},
 
         FormatMap{AL_FORMAT_BFORMAT3D_8,       {FmtBFormat3D, FmtUByte}},
         FormatMap{AL_FORMAT_BFORMAT3D_16,      {FmtBFormat3D, FmtShort}},
         FormatMap{AL_FORMAT_BFORMAT3D_FLOAT32, {FmtBFormat3D, FmtFloat}},
         FormatMap{AL_FORMAT_BFORMAT3D_MULAW,   {FmtBFormat3D, FmtMulaw}},
+        FormatMap{AL_FORMAT_BFORMAT3D_HALF_SOFT, {FmtBFormat3D, FmtHalf}},
 
         FormatMap{AL_FORMAT_UHJ2CHN8_SOFT,        {FmtUHJ2, FmtUByte}  },
         FormatMap{AL_FORMAT_UHJ2CHN16_SOFT,       {FmtUHJ2, FmtShort}  },
@@ -655,9 +1056,397 @@ auto DecomposeUserFormat(ALenum format) noexcept -> std::optional<DecompResult>
     return std::nullopt;
 }
 
+
+std::atomic<ALuint> NextUploadFence{1u};
+
+struct BufferUploadJob {
+    ContextRef mContext;
+    ALuint mBufferId{};
+    ALuint mFence{};
+    const std::byte *mData{};
+    ALuint mSize{};
+    ALsizei mFreq{};
+    FmtChannels mChannels{};
+    FmtType mType{};
+    DataLayout mLayout{};
+    size_t mStorageSize{};
+};
+
+/* Fills new storage for the job's buffer, installs it, then signals the fence
+ * with an event.
+ */
+void ProcessUpload(BufferUploadJob &job)
+{
+    ALCcontext *context{job.mContext.get()};
+    ALCdevice *device{context->mALDevice.get()};
+    BufferStoragePool &pool = *device->mBufferPool;
+
+    /* Copy and decode the samples into new storage without holding the buffer
+     * lock, so other buffer operations can continue in the mean time.
+     */
+    decltype(ALbuffer::mDataStorage) datastorage;
+    decltype(ALbuffer::mDecodedStorage) decodedstorage;
+    std::string error;
+    try {
+        const size_t datasize{job.mLayout.dataSize()};
+        datastorage = pool.acquire(job.mStorageSize);
+        if(job.mData != nullptr && datasize > 0)
+            std::copy_n(job.mData, datasize, datastorage.begin());
+        else
+            std::fill_n(datastorage.begin(), datasize, std::byte{});
+
+        decodedstorage = decltype(decodedstorage)(job.mLayout.decodedSize());
+        DecodeData(decodedstorage, al::span{datastorage}.first(datasize), job.mChannels,
+            job.mType, job.mLayout, device->mUhjDecodeQuality);
+    }
+    catch(std::exception &e) {
+        error = e.what();
+    }
+
+    {
+        std::lock_guard<std::shared_mutex> buflock{device->BufferLock};
+        /* The upload's reference keeps the buffer from being deleted. */
+        ALbuffer *albuf{LookupBuffer(device, job.mBufferId)};
+        assert(albuf && albuf->mUploadFence == job.mFence);
+
+        if(error.empty())
+        {
+            datastorage.swap(albuf->mDataStorage);
+            albuf->mData = al::span{albuf->mDataStorage}.first(job.mLayout.dataSize());
+#ifdef ALSOFT_EAX
+            eax_x_ram_clear(*device, *albuf);
+#endif
+            decodedstorage.swap(albuf->mDecodedStorage);
+            albuf->mDecodedData = albuf->mDecodedStorage;
+            albuf->mIsDecoded = job.mLayout.decode || job.mLayout.decodeUhj;
+            albuf->mIsUhjDecoded = job.mLayout.decodeUhj;
+            SetDataFormat(context, albuf, job.mFreq, job.mSize, job.mChannels, job.mType,
+                job.mLayout, 0);
+        }
+        albuf->mUploadFence = 0u;
+        DecrementRef(albuf->ref);
+    }
+    pool.release(std::move(datastorage));
+
+    std::string msg{"Buffer ID " + std::to_string(job.mBufferId)};
+    if(error.empty())
+        msg += " upload complete";
+    else
+    {
+        msg += " upload failed: " + error;
+        ERR("%s\n", msg.c_str());
+    }
+
+    std::lock_guard<std::mutex> eventlock{context->mEventCbLock};
+    auto enabledevts = context->mEnabledEvts.load(std::memory_order_acquire);
+    if(!enabledevts.test(al::to_underlying(AsyncEnableBits::BufferUploaded)))
+        return;
+    if(context->mEventBatchCb)
+    {
+        const ALeventSOFT evt{AL_EVENT_TYPE_BUFFER_UPLOADED_SOFT, job.mBufferId, job.mFence};
+        context->mEventBatchCb(1, &evt, context->mEventBatchParam);
+    }
+    else if(context->mEventCb)
+        context->mEventCb(AL_EVENT_TYPE_BUFFER_UPLOADED_SOFT, job.mBufferId, job.mFence,
+            static_cast<ALsizei>(msg.length()), msg.c_str(), context->mEventParam);
+}
+
+/* A small pool of threads to process buffer uploads, started as needed. */
+class BufferUploadPool {
+    static constexpr size_t MaxThreads{4};
+
+    std::mutex mLock;
+    std::condition_variable mCond;
+    std::deque<BufferUploadJob> mJobs;
+    std::vector<std::thread> mThreads;
+    size_t mIdleThreads{0};
+    bool mQuit{false};
+
+    void run()
+    {
+        althrd_setname(GetUploadThreadName());
+
+        std::unique_lock<std::mutex> joblock{mLock};
+        while(true)
+        {
+            ++mIdleThreads;
+            mCond.wait(joblock, [this]{ return mQuit || !mJobs.empty(); });
+            --mIdleThreads;
+            if(mQuit) break;
+
+            BufferUploadJob job{std::move(mJobs.front())};
+            mJobs.pop_front();
+            joblock.unlock();
+
+            ProcessUpload(job);
+            job.mContext = nullptr;
+
+            joblock.lock();
+        }
+    }
+
+public:
+    ~BufferUploadPool()
+    {
+        {
+            std::lock_guard<std::mutex> joblock{mLock};
+            mQuit = true;
+        }
+        mCond.notify_all();
+        for(auto &thrd : mThreads)
+        {
+            if(thrd.joinable())
+                thrd.join();
+        }
+        mJobs.clear();
+    }
+
+    /* Queues the job for a worker thread. Returns false if no thread is
+     * available to process it.
+     */
+    bool push(BufferUploadJob &&job)
+    {
+        std::lock_guard<std::mutex> joblock{mLock};
+        if(mIdleThreads <= mJobs.size() && mThreads.size() < MaxThreads)
+        {
+            try {
+                mThreads.emplace_back(&BufferUploadPool::run, this);
+            }
+            catch(std::exception &e) {
+                ERR("Failed to start buffer upload thread: %s\n", e.what());
+                if(mThreads.empty())
+                    return false;
+            }
+        }
+        mJobs.emplace_back(std::move(job));
+        mCond.notify_one();
+        return true;
+    }
+
+    static BufferUploadPool &Get()
+    {
+        static BufferUploadPool pool;
+        return pool;
+    }
+
+    /* Must be less than 15 characters (16 including terminating null) for
+     * compatibility with pthread_setname_np limitations. */
+    static constexpr auto GetUploadThreadName() noexcept -> const char*
+    { return "alsoft-upload"; }
+};
+
 } // namespace
 
 
+BufferCallbackThread::~BufferCallbackThread()
+{
+    if(mThread.joinable())
+    {
+        mQuit.store(true, std::memory_order_release);
+        mSem.post();
+        mThread.join();
+    }
+}
+
+void BufferCallbackThread::run()
+{
+    althrd_setname("alsoft-callback");
+
+    RingBuffer *ring{mRing.mRing.get()};
+    const size_t framesize{ring->getElemSize()};
+    std::vector<std::byte> staging;
+
+    while(true)
+    {
+        mSem.wait();
+        if(mQuit.load(std::memory_order_acquire))
+            break;
+
+        /* Refill while a whole request fits. Requests are written directly to
+         * the ring when they fit without wrapping around.
+         */
+        while(!mRing.mEnded.load(std::memory_order_relaxed)
+            && ring->writeSpace() >= mRequestFrames)
+        {
+            const auto vec = ring->getWriteVector();
+            const bool direct{vec.first.len >= mRequestFrames};
+            if(!direct && staging.empty())
+                staging.resize(mRequestFrames*framesize);
+            std::byte *dst{direct ? vec.first.buf : staging.data()};
+
+            const int got{mCallback(mUserData, dst, static_cast<int>(mRequestFrames*framesize))};
+            const size_t gotframes{(got > 0) ? static_cast<size_t>(got)/framesize : 0};
+            if(direct)
+                ring->writeAdvance(gotframes);
+            else
+                std::ignore = ring->write(staging.data(), gotframes);
+
+            /* A short read ends the stream, once the ring plays out. */
+            if(gotframes < mRequestFrames)
+                mRing.mEnded.store(true, std::memory_order_release);
+        }
+    }
+}
+
+
+auto BufferStoragePool::classIndex(size_t size) noexcept -> size_t
+{
+    if(size <= MinClassSize)
+        return 0;
+
+    /* Each octave above the minimum is split into evenly spaced steps, with
+     * the last step of one octave being the start of the next.
+     */
+    size_t octave{0};
+    while(octave < NumClasses/StepsPerOctave && (MinClassSize << (octave+1)) < size)
+        ++octave;
+    const size_t base{MinClassSize << octave};
+    const size_t stepsize{base / StepsPerOctave};
+    const size_t step{(size - base + stepsize-1) / stepsize};
+    return octave*StepsPerOctave + step;
+}
+
+auto BufferStoragePool::classSize(size_t index) noexcept -> size_t
+{
+    const size_t base{MinClassSize << (index/StepsPerOctave)};
+    return base + base/StepsPerOctave*(index%StepsPerOctave);
+}
+
+void BufferStoragePool::setLimit(size_t limit)
+{
+    std::lock_guard<std::mutex> poollock{mLock};
+    mLimit = limit;
+    for(size_t idx{NumClasses};idx > 0 && mPooledSize > mLimit;)
+    {
+        auto &freelist = mFree[--idx];
+        while(!freelist.empty() && mPooledSize > mLimit)
+        {
+            mPooledSize -= freelist.back().size();
+            freelist.pop_back();
+        }
+    }
+}
+
+auto BufferStoragePool::acquire(size_t size) -> Storage
+{
+    if(size == 0)
+        return Storage{};
+
+    const size_t idx{classIndex(size)};
+    {
+        std::lock_guard<std::mutex> poollock{mLock};
+        if(mLimit == 0 || idx >= NumClasses)
+            return Storage(size, std::byte{});
+
+        auto &freelist = mFree[idx];
+        if(!freelist.empty())
+        {
+            Storage ret{std::move(freelist.back())};
+            freelist.pop_back();
+            mPooledSize -= ret.size();
+            return ret;
+        }
+    }
+    return Storage(classSize(idx), std::byte{});
+}
+
+void BufferStoragePool::release(Storage&& storage) noexcept
+{
+    /* Anything not kept is freed after the lock is released. */
+    Storage old{std::move(storage)};
+    if(old.empty())
+        return;
+
+    const size_t idx{classIndex(old.size())};
+    if(idx >= NumClasses || classSize(idx) != old.size())
+        return;
+
+    std::lock_guard<std::mutex> poollock{mLock};
+    if(old.size() > mLimit - std::min(mLimit, mPooledSize))
+        return;
+    try {
+        mFree[idx].emplace_back(std::move(old));
+        mPooledSize += mFree[idx].back().size();
+    }
+    catch(...) {
+    }
+}
+
+auto BufferStoragePool::pooledSize() -> size_t
+{
+    std::lock_guard<std::mutex> poollock{mLock};
+    return mPooledSize;
+}
+
+
+auto ShareBufferData(ALCdevice *device, ALuint buffer, ALCdevice *srcdevice, ALuint srcbuffer)
+    -> ALCenum
+try {
+    std::unique_lock<std::shared_mutex> buflock{device->BufferLock, std::defer_lock};
+    std::unique_lock<std::shared_mutex> srclock{srcdevice->BufferLock, std::defer_lock};
+    if(srcdevice == device)
+        buflock.lock();
+    else
+        std::lock(buflock, srclock);
+
+    ALbuffer *albuf{LookupBuffer(device, buffer)};
+    ALbuffer *srcbuf{LookupBuffer(srcdevice, srcbuffer)};
+    if(!albuf || !srcbuf || albuf == srcbuf)
+    {
+        WARN("Invalid buffers for sharing: %u from %u\n", buffer, srcbuffer);
+        return ALC_INVALID_VALUE;
+    }
+    /* Only data the library owns can be shared, and not while it may be
+     * changing.
+     */
+    if(srcbuf->mCallback || srcbuf->MappedAccess != 0 || srcbuf->mUploadFence != 0
+        || (!srcbuf->mSharedData && srcbuf->mData.data() != srcbuf->mDataStorage.data()))
+    {
+        WARN("Buffer %u's data can't be shared\n", srcbuffer);
+        return ALC_INVALID_VALUE;
+    }
+    if(albuf->ref.load(std::memory_order_relaxed) != 0 || albuf->MappedAccess != 0
+        || albuf->mUploadFence != 0)
+    {
+        WARN("Sharing data into in-use buffer %u\n", buffer);
+        return ALC_INVALID_VALUE;
+    }
+
+    /* Move the source buffer's storage to be shared, if it isn't already.
+     * Moving the vectors doesn't move their data, so the buffer's spans stay
+     * valid.
+     */
+    if(!srcbuf->mSharedData)
+    {
+        auto shared = std::make_shared<BufferSharedData>();
+        shared->mData = std::move(srcbuf->mDataStorage);
+        shared->mDecoded = std::move(srcbuf->mDecodedStorage);
+        srcbuf->mSharedData = std::move(shared);
+    }
+
+    device->mBufferPool->release(std::move(albuf->mDataStorage));
+    albuf->clearDecoded();
+#ifdef ALSOFT_EAX
+    eax_x_ram_clear(*device, *albuf);
+#endif
+    albuf->mRing = nullptr;
+    albuf->mCallbackThread = nullptr;
+    albuf->mSharedData = srcbuf->mSharedData;
+
+    static_cast<BufferStorage&>(*albuf) = *srcbuf;
+    albuf->OriginalSize = srcbuf->OriginalSize;
+    albuf->Access = srcbuf->Access & ~ALbitfieldSOFT{AL_MAP_WRITE_BIT_SOFT};
+    albuf->mLoopStart = srcbuf->mLoopStart;
+    albuf->mLoopEnd = srcbuf->mLoopEnd;
+    UpdateBufferMemory(device, albuf);
+
+    return ALC_NO_ERROR;
+}
+catch(std::bad_alloc&) {
+    return ALC_OUT_OF_MEMORY;
+}
+
+
 AL_API DECL_FUNC2(void, alGenBuffers, ALsizei,n, ALuint*,buffers)
 FORCE_ALIGN void AL_APIENTRY alGenBuffersDirect(ALCcontext *context, ALsizei n, ALuint *buffers) noexcept
 try {
@@ -666,7 +1455,7 @@ try {
     if(n <= 0) UNLIKELY return;
 
     ALCdevice *device{context->mALDevice.get()};
-    std::lock_guard<std::mutex> buflock{device->BufferLock};
+    std::lock_guard<std::shared_mutex> buflock{device->BufferLock};
 
     const al::span bids{buffers, static_cast<ALuint>(n)};
     if(!EnsureBuffers(device, bids.size()))
@@ -688,7 +1477,7 @@ try {
     if(n <= 0) UNLIKELY return;
 
     ALCdevice *device{context->mALDevice.get()};
-    std::lock_guard<std::mutex> buflock{device->BufferLock};
+    std::lock_guard<std::shared_mutex> buflock{device->BufferLock};
 
     /* First try to find any buffers that are invalid or in-use. */
     auto validate_buffer = [device](const ALuint bid)
@@ -720,7 +1509,7 @@ AL_API DECL_FUNC1(ALboolean, alIsBuffer, ALuint,buffer)
 FORCE_ALIGN ALboolean AL_APIENTRY alIsBufferDirect(ALCcontext *context, ALuint buffer) noexcept
 {
     ALCdevice *device{context->mALDevice.get()};
-    std::lock_guard<std::mutex> buflock{device->BufferLock};
+    std::shared_lock<std::shared_mutex> buflock{device->BufferLock};
     if(!buffer || LookupBuffer(device, buffer))
         return AL_TRUE;
     return AL_FALSE;
@@ -729,7 +1518,7 @@ FORCE_ALIGN ALboolean AL_APIENTRY alIsBufferDirect(ALCcontext *context, ALuint b
 
 AL_API void AL_APIENTRY alBufferData(ALuint buffer, ALenum format, const ALvoid *data, ALsizei size, ALsizei freq) noexcept
 {
-    auto context = GetContextRef();
+    auto context = GetCurrentContext();
     if(!context) UNLIKELY return;
     alBufferStorageDirectSOFT(context.get(), buffer, format, data, size, freq, 0);
 }
@@ -742,7 +1531,7 @@ FORCE_ALIGN void AL_APIENTRY alBufferStorageDirectSOFT(ALCcontext *context, ALui
     ALenum format, const ALvoid *data, ALsizei size, ALsizei freq, ALbitfieldSOFT flags) noexcept
 try {
     ALCdevice *device{context->mALDevice.get()};
-    std::lock_guard<std::mutex> buflock{device->BufferLock};
+    std::lock_guard<std::shared_mutex> buflock{device->BufferLock};
 
     ALbuffer *albuf{LookupBuffer(device, buffer)};
     if(!albuf)
@@ -769,12 +1558,60 @@ catch(al::context_error& e) {
     context->setError(e.errorCode(), "%s", e.what());
 }
 
+AL_API DECL_FUNCEXT5(ALuint, alBufferDataAsync,SOFT, ALuint,buffer, ALenum,format, const ALvoid*,data, ALsizei,size, ALsizei,freq)
+FORCE_ALIGN ALuint AL_APIENTRY alBufferDataAsyncDirectSOFT(ALCcontext *context, ALuint buffer,
+    ALenum format, const ALvoid *data, ALsizei size, ALsizei freq) noexcept
+try {
+    ALCdevice *device{context->mALDevice.get()};
+    std::unique_lock<std::shared_mutex> buflock{device->BufferLock};
+
+    ALbuffer *albuf{LookupBuffer(device, buffer)};
+    if(!albuf)
+        throw al::context_error{AL_INVALID_NAME, "Invalid buffer ID %u", buffer};
+    if(size < 0)
+        throw al::context_error{AL_INVALID_VALUE, "Negative storage size %d", size};
+    if(freq < 1)
+        throw al::context_error{AL_INVALID_VALUE, "Invalid sample rate %d", freq};
+
+    auto usrfmt = DecomposeUserFormat(format);
+    if(!usrfmt)
+        throw al::context_error{AL_INVALID_ENUM, "Invalid format 0x%04x", format};
+
+    /* Everything that can be checked up front is, so the upload itself can
+     * only fail from running out of memory. The data needs to remain valid
+     * until the upload is done.
+     */
+    const auto usize = static_cast<ALuint>(size);
+    const DataLayout layout{CheckDataLayout(context, albuf, usize, usrfmt->channels,
+        usrfmt->type, 0)};
+
+    ALuint fence{NextUploadFence.fetch_add(1u, std::memory_order_relaxed)};
+    if(fence == 0) UNLIKELY
+        fence = NextUploadFence.fetch_add(1u, std::memory_order_relaxed);
+
+    IncrementRef(albuf->ref);
+    albuf->mUploadFence = fence;
+    const size_t storagesize{std::max(layout.dataSize(), size_t{albuf->mReserveSize})};
+    buflock.unlock();
+
+    context->add_ref();
+    BufferUploadJob job{ContextRef{context}, buffer, fence, static_cast<const std::byte*>(data),
+        usize, freq, usrfmt->channels, usrfmt->type, layout, storagesize};
+    if(!BufferUploadPool::Get().push(std::move(job)))
+        ProcessUpload(job);
+    return fence;
+}
+catch(al::context_error& e) {
+    context->setError(e.errorCode(), "%s", e.what());
+    return 0u;
+}
+
 FORCE_ALIGN DECL_FUNC5(void, alBufferDataStatic, ALuint,buffer, ALenum,format, ALvoid*,data, ALsizei,size, ALsizei,freq)
 FORCE_ALIGN void AL_APIENTRY alBufferDataStaticDirect(ALCcontext *context, const ALuint buffer,
     ALenum format, ALvoid *data, ALsizei size, ALsizei freq) noexcept
 try {
     ALCdevice *device{context->mALDevice.get()};
-    std::lock_guard<std::mutex> buflock{device->BufferLock};
+    std::lock_guard<std::shared_mutex> buflock{device->BufferLock};
 
     ALbuffer *albuf{LookupBuffer(device, buffer)};
     if(!albuf)
@@ -800,7 +1637,7 @@ FORCE_ALIGN void* AL_APIENTRY alMapBufferDirectSOFT(ALCcontext *context, ALuint
     ALsizei offset, ALsizei length, ALbitfieldSOFT access) noexcept
 try {
     ALCdevice *device{context->mALDevice.get()};
-    std::lock_guard<std::mutex> buflock{device->BufferLock};
+    std::lock_guard<std::shared_mutex> buflock{device->BufferLock};
 
     ALbuffer *albuf{LookupBuffer(device, buffer)};
     if(!albuf)
@@ -818,12 +1655,18 @@ try {
             "Mapping in-use buffer %u without persistent mapping", buffer};
     if(albuf->MappedAccess != 0)
         throw al::context_error{AL_INVALID_OPERATION, "Mapping already-mapped buffer %u", buffer};
+    if(albuf->mUploadFence != 0)
+        throw al::context_error{AL_INVALID_OPERATION, "Mapping buffer %u with a pending upload",
+            buffer};
     if((unavailable&AL_MAP_READ_BIT_SOFT))
         throw al::context_error{AL_INVALID_VALUE,
             "Mapping buffer %u for reading without read access", buffer};
     if((unavailable&AL_MAP_WRITE_BIT_SOFT))
         throw al::context_error{AL_INVALID_VALUE,
             "Mapping buffer %u for writing without write access", buffer};
+    if((access&AL_MAP_WRITE_BIT_SOFT) && albuf->mSharedData)
+        throw al::context_error{AL_INVALID_OPERATION,
+            "Mapping buffer %u with shared data for writing", buffer};
     if((unavailable&AL_MAP_PERSISTENT_BIT_SOFT))
         throw al::context_error{AL_INVALID_VALUE,
             "Mapping buffer %u persistently without persistent access", buffer};
@@ -847,7 +1690,7 @@ AL_API DECL_FUNCEXT1(void, alUnmapBuffer,SOFT, ALuint,buffer)
 FORCE_ALIGN void AL_APIENTRY alUnmapBufferDirectSOFT(ALCcontext *context, ALuint buffer) noexcept
 try {
     ALCdevice *device{context->mALDevice.get()};
-    std::lock_guard<std::mutex> buflock{device->BufferLock};
+    std::lock_guard<std::shared_mutex> buflock{device->BufferLock};
 
     ALbuffer *albuf{LookupBuffer(device, buffer)};
     if(!albuf)
@@ -868,7 +1711,7 @@ FORCE_ALIGN void AL_APIENTRY alFlushMappedBufferDirectSOFT(ALCcontext *context,
     ALsizei offset, ALsizei length) noexcept
 try {
     ALCdevice *device{context->mALDevice.get()};
-    std::lock_guard<std::mutex> buflock{device->BufferLock};
+    std::lock_guard<std::shared_mutex> buflock{device->BufferLock};
 
     ALbuffer *albuf{LookupBuffer(device, buffer)};
     if(!albuf)
@@ -898,7 +1741,7 @@ FORCE_ALIGN void AL_APIENTRY alBufferSubDataDirectSOFT(ALCcontext *context, ALui
     ALenum format, const ALvoid *data, ALsizei offset, ALsizei length) noexcept
 try {
     ALCdevice *device{context->mALDevice.get()};
-    std::lock_guard<std::mutex> buflock{device->BufferLock};
+    std::lock_guard<std::shared_mutex> buflock{device->BufferLock};
 
     ALbuffer *albuf{LookupBuffer(device, buffer)};
     if(!albuf)
@@ -924,11 +1767,18 @@ try {
     if(albuf->MappedAccess != 0)
         throw al::context_error{AL_INVALID_OPERATION, "Unpacking data into mapped buffer %u",
             buffer};
+    if(albuf->mUploadFence != 0)
+        throw al::context_error{AL_INVALID_OPERATION,
+            "Unpacking data into buffer %u with a pending upload", buffer};
+    if(albuf->mSharedData)
+        throw al::context_error{AL_INVALID_OPERATION,
+            "Unpacking data into buffer %u with shared data", buffer};
 
     const ALuint num_chans{albuf->channelsFromFmt()};
     const ALuint byte_align{
         (albuf->mType == FmtIMA4) ? ((align-1)/2 + 4) * num_chans :
         (albuf->mType == FmtMSADPCM) ? ((align-2)/2 + 7) * num_chans :
+        (albuf->mType == FmtIMA2) ? ((align-1)/4 + 4) * num_chans :
         (align * albuf->bytesFromFmt() * num_chans)};
 
     if(offset < 0 || length < 0 || static_cast<ALuint>(offset) > albuf->OriginalSize
@@ -945,6 +1795,26 @@ try {
             length, byte_align, align};
 
     std::memcpy(albuf->mData.data()+offset, data, static_cast<ALuint>(length));
+
+    /* Update the decoded copy of the replaced blocks, if there is one. The UHJ
+     * decoder looks ahead and keeps history, so changing any samples affects
+     * the decoded output around them. Simply decode it all again.
+     */
+    if(albuf->mIsUhjDecoded)
+    {
+        auto decoded = al::span{reinterpret_cast<float*>(albuf->mDecodedData.data()),
+            albuf->mDecodedData.size()/sizeof(float)};
+        DecodeUhjSamples(decoded, albuf->mData, albuf->mChannels, albuf->mType,
+            albuf->mBlockAlign, device->mUhjDecodeQuality);
+    }
+    else if(albuf->mIsDecoded)
+    {
+        const size_t startFrame{static_cast<ALuint>(offset)/byte_align * align};
+        const size_t numFrames{static_cast<ALuint>(length)/byte_align * align};
+        DecodeSamples(albuf->decodedSamples().subspan(startFrame*num_chans, numFrames*num_chans),
+            albuf->mData.subspan(static_cast<ALuint>(offset), static_cast<ALuint>(length)),
+            albuf->mType, num_chans, align);
+    }
 }
 catch(al::context_error& e) {
     context->setError(e.errorCode(), "%s", e.what());
@@ -956,7 +1826,7 @@ FORCE_ALIGN void AL_APIENTRY alBufferfDirect(ALCcontext *context, ALuint buffer,
     ALfloat value [[maybe_unused]]) noexcept
 try {
     ALCdevice *device{context->mALDevice.get()};
-    std::lock_guard<std::mutex> buflock{device->BufferLock};
+    std::lock_guard<std::shared_mutex> buflock{device->BufferLock};
 
     if(LookupBuffer(device, buffer) == nullptr)
         throw al::context_error{AL_INVALID_NAME, "Invalid buffer ID %u", buffer};
@@ -976,7 +1846,7 @@ FORCE_ALIGN void AL_APIENTRY alBuffer3fDirect(ALCcontext *context, ALuint buffer
     ALfloat value3 [[maybe_unused]]) noexcept
 try {
     ALCdevice *device{context->mALDevice.get()};
-    std::lock_guard<std::mutex> buflock{device->BufferLock};
+    std::lock_guard<std::shared_mutex> buflock{device->BufferLock};
 
     if(LookupBuffer(device, buffer) == nullptr)
         throw al::context_error{AL_INVALID_NAME, "Invalid buffer ID %u", buffer};
@@ -995,7 +1865,7 @@ FORCE_ALIGN void AL_APIENTRY alBufferfvDirect(ALCcontext *context, ALuint buffer
     const ALfloat *values) noexcept
 try {
     ALCdevice *device{context->mALDevice.get()};
-    std::lock_guard<std::mutex> buflock{device->BufferLock};
+    std::lock_guard<std::shared_mutex> buflock{device->BufferLock};
 
     if(LookupBuffer(device, buffer) == nullptr)
         throw al::context_error{AL_INVALID_NAME, "Invalid buffer ID %u", buffer};
@@ -1017,7 +1887,7 @@ FORCE_ALIGN void AL_APIENTRY alBufferiDirect(ALCcontext *context, ALuint buffer,
     ALint value) noexcept
 try {
     ALCdevice *device{context->mALDevice.get()};
-    std::lock_guard<std::mutex> buflock{device->BufferLock};
+    std::lock_guard<std::shared_mutex> buflock{device->BufferLock};
 
     ALbuffer *albuf{LookupBuffer(device, buffer)};
     if(!albuf)
@@ -1064,6 +1934,52 @@ try {
             throw al::context_error{AL_INVALID_VALUE, "Invalid unpack ambisonic order %d", value};
         albuf->UnpackAmbiOrder = static_cast<ALuint>(value);
         return;
+
+    case AL_RESERVE_SIZE_SOFT:
+        if(value < 0)
+            throw al::context_error{AL_INVALID_VALUE, "Invalid reserve size %d", value};
+        albuf->mReserveSize = static_cast<ALuint>(value);
+
+        /* Grow the storage now if the buffer isn't being used, otherwise it
+         * will grow when next filled.
+         */
+        if(albuf->mReserveSize > albuf->mDataStorage.size()
+            && albuf->ref.load(std::memory_order_relaxed) == 0 && albuf->MappedAccess == 0
+            && albuf->mUploadFence == 0)
+        {
+            BufferStoragePool &pool = *device->mBufferPool;
+            auto newdata = pool.acquire(albuf->mReserveSize);
+            if(!albuf->mDataStorage.empty() && albuf->mData.data() == albuf->mDataStorage.data())
+            {
+                std::copy(albuf->mData.begin(), albuf->mData.end(), newdata.begin());
+                albuf->mData = al::span{newdata}.first(albuf->mData.size());
+            }
+            newdata.swap(albuf->mDataStorage);
+            pool.release(std::move(newdata));
+            UpdateBufferMemory(device, albuf);
+        }
+        return;
+
+    case AL_CALLBACK_REQUEST_SIZE_SOFT:
+        if(value < 0 || value > 1048576)
+            throw al::context_error{AL_INVALID_VALUE, "Invalid callback request size %d", value};
+        albuf->mCallbackRequestSize = static_cast<ALuint>(value);
+        return;
+
+    case AL_CALLBACK_PREFETCH_SOFT:
+        if(value < 0 || value > 64)
+            throw al::context_error{AL_INVALID_VALUE, "Invalid callback prefetch %d", value};
+        albuf->mCallbackPrefetch = static_cast<ALuint>(value);
+        return;
+
+    case AL_RING_END_OF_STREAM_SOFT:
+        if(!albuf->mRing)
+            throw al::context_error{AL_INVALID_OPERATION, "Buffer %u is not a ring buffer",
+                buffer};
+        if(!(value == AL_FALSE || value == AL_TRUE))
+            throw al::context_error{AL_INVALID_VALUE, "Invalid end of stream %d", value};
+        albuf->mRing->mEnded.store(value != AL_FALSE, std::memory_order_release);
+        return;
     }
 
     throw al::context_error{AL_INVALID_ENUM, "Invalid buffer integer property 0x%04x", param};
@@ -1077,7 +1993,7 @@ FORCE_ALIGN void AL_APIENTRY alBuffer3iDirect(ALCcontext *context, ALuint buffer
     ALint value1 [[maybe_unused]], ALint value2 [[maybe_unused]], ALint value3 [[maybe_unused]]) noexcept
 try {
     ALCdevice *device{context->mALDevice.get()};
-    std::lock_guard<std::mutex> buflock{device->BufferLock};
+    std::lock_guard<std::shared_mutex> buflock{device->BufferLock};
 
     if(LookupBuffer(device, buffer) == nullptr)
         throw al::context_error{AL_INVALID_NAME, "Invalid buffer ID %u", buffer};
@@ -1105,12 +2021,16 @@ try {
     case AL_AMBISONIC_LAYOUT_SOFT:
     case AL_AMBISONIC_SCALING_SOFT:
     case AL_UNPACK_AMBISONIC_ORDER_SOFT:
+    case AL_RESERVE_SIZE_SOFT:
+    case AL_CALLBACK_REQUEST_SIZE_SOFT:
+    case AL_CALLBACK_PREFETCH_SOFT:
+    case AL_RING_END_OF_STREAM_SOFT:
         alBufferiDirect(context, buffer, param, *values);
         return;
     }
 
     ALCdevice *device{context->mALDevice.get()};
-    std::lock_guard<std::mutex> buflock{device->BufferLock};
+    std::lock_guard<std::shared_mutex> buflock{device->BufferLock};
 
     ALbuffer *albuf{LookupBuffer(device, buffer)};
     if(!albuf)
@@ -1145,7 +2065,7 @@ FORCE_ALIGN void AL_APIENTRY alGetBufferfDirect(ALCcontext *context, ALuint buff
     ALfloat *value) noexcept
 try {
     ALCdevice *device{context->mALDevice.get()};
-    std::lock_guard<std::mutex> buflock{device->BufferLock};
+    std::shared_lock<std::shared_mutex> buflock{device->BufferLock};
 
     ALbuffer *albuf{LookupBuffer(device, buffer)};
     if(!albuf)
@@ -1172,7 +2092,7 @@ FORCE_ALIGN void AL_APIENTRY alGetBuffer3fDirect(ALCcontext *context, ALuint buf
     ALfloat *value1, ALfloat *value2, ALfloat *value3) noexcept
 try {
     ALCdevice *device{context->mALDevice.get()};
-    std::lock_guard<std::mutex> buflock{device->BufferLock};
+    std::shared_lock<std::shared_mutex> buflock{device->BufferLock};
 
     if(LookupBuffer(device, buffer) == nullptr)
         throw al::context_error{AL_INVALID_NAME, "Invalid buffer ID %u", buffer};
@@ -1200,7 +2120,7 @@ try {
     }
 
     ALCdevice *device{context->mALDevice.get()};
-    std::lock_guard<std::mutex> buflock{device->BufferLock};
+    std::shared_lock<std::shared_mutex> buflock{device->BufferLock};
 
     if(LookupBuffer(device, buffer) == nullptr)
         throw al::context_error{AL_INVALID_NAME, "Invalid buffer ID %u", buffer};
@@ -1222,7 +2142,7 @@ FORCE_ALIGN void AL_APIENTRY alGetBufferiDirect(ALCcontext *context, ALuint buff
     ALint *value) noexcept
 try {
     ALCdevice *device{context->mALDevice.get()};
-    std::lock_guard<std::mutex> buflock{device->BufferLock};
+    std::shared_lock<std::shared_mutex> buflock{device->BufferLock};
 
     ALbuffer *albuf{LookupBuffer(device, buffer)};
     if(!albuf)
@@ -1238,6 +2158,7 @@ try {
 
     case AL_BITS:
         *value = (albuf->mType == FmtIMA4 || albuf->mType == FmtMSADPCM) ? 4
+            : (albuf->mType == FmtIMA2) ? 2
             : static_cast<ALint>(albuf->bytesFromFmt() * 8);
         return;
 
@@ -1277,6 +2198,32 @@ try {
     case AL_UNPACK_AMBISONIC_ORDER_SOFT:
         *value = static_cast<int>(albuf->UnpackAmbiOrder);
         return;
+
+    case AL_BUFFER_UPLOAD_PENDING_SOFT:
+        *value = (albuf->mUploadFence != 0) ? AL_TRUE : AL_FALSE;
+        return;
+
+    case AL_RESERVE_SIZE_SOFT:
+        *value = static_cast<ALint>(albuf->mReserveSize);
+        return;
+
+    case AL_CALLBACK_REQUEST_SIZE_SOFT:
+        *value = static_cast<ALint>(albuf->mCallbackRequestSize);
+        return;
+
+    case AL_CALLBACK_PREFETCH_SOFT:
+        *value = static_cast<ALint>(albuf->mCallbackPrefetch);
+        return;
+
+    case AL_RING_WRITE_SPACE_SOFT:
+        *value = !albuf->mRing ? 0 : static_cast<ALint>(albuf->mRing->mRing->writeSpace()
+            * albuf->mRing->mRing->getElemSize());
+        return;
+
+    case AL_RING_END_OF_STREAM_SOFT:
+        *value = (albuf->mRing && albuf->mRing->mEnded.load(std::memory_order_relaxed))
+            ? AL_TRUE : AL_FALSE;
+        return;
     }
 
     throw al::context_error{AL_INVALID_ENUM, "Invalid buffer integer property 0x%04x", param};
@@ -1290,7 +2237,7 @@ FORCE_ALIGN void AL_APIENTRY alGetBuffer3iDirect(ALCcontext *context, ALuint buf
     ALint *value1, ALint *value2, ALint *value3) noexcept
 try {
     ALCdevice *device{context->mALDevice.get()};
-    std::lock_guard<std::mutex> buflock{device->BufferLock};
+    std::shared_lock<std::shared_mutex> buflock{device->BufferLock};
 
     if(LookupBuffer(device, buffer) == nullptr)
         throw al::context_error{AL_INVALID_NAME, "Invalid buffer ID %u", buffer};
@@ -1324,12 +2271,18 @@ try {
     case AL_AMBISONIC_LAYOUT_SOFT:
     case AL_AMBISONIC_SCALING_SOFT:
     case AL_UNPACK_AMBISONIC_ORDER_SOFT:
+    case AL_BUFFER_UPLOAD_PENDING_SOFT:
+    case AL_RESERVE_SIZE_SOFT:
+    case AL_CALLBACK_REQUEST_SIZE_SOFT:
+    case AL_CALLBACK_PREFETCH_SOFT:
+    case AL_RING_WRITE_SPACE_SOFT:
+    case AL_RING_END_OF_STREAM_SOFT:
         alGetBufferiDirect(context, buffer, param, values);
         return;
     }
 
     ALCdevice *device{context->mALDevice.get()};
-    std::lock_guard<std::mutex> buflock{device->BufferLock};
+    std::shared_lock<std::shared_mutex> buflock{device->BufferLock};
 
     ALbuffer *albuf{LookupBuffer(device, buffer)};
     if(!albuf)
@@ -1359,7 +2312,7 @@ FORCE_ALIGN void AL_APIENTRY alBufferCallbackDirectSOFT(ALCcontext *context, ALu
     ALenum format, ALsizei freq, ALBUFFERCALLBACKTYPESOFT callback, ALvoid *userptr) noexcept
 try {
     ALCdevice *device{context->mALDevice.get()};
-    std::lock_guard<std::mutex> buflock{device->BufferLock};
+    std::lock_guard<std::shared_mutex> buflock{device->BufferLock};
 
     ALbuffer *albuf{LookupBuffer(device, buffer)};
     if(!albuf)
@@ -1373,10 +2326,100 @@ try {
     if(!usrfmt)
         throw al::context_error{AL_INVALID_ENUM, "Invalid format 0x%04x", format};
 
-    PrepareCallback(context, albuf, freq, usrfmt->channels, usrfmt->type, callback, userptr);
+    if(albuf->mCallbackPrefetch > 0)
+        PrepareCallbackThread(context, albuf, freq, usrfmt->channels, usrfmt->type, callback,
+            userptr);
+    else
+        PrepareCallback(context, albuf, freq, usrfmt->channels, usrfmt->type, callback,
+            userptr, albuf->mCallbackRequestSize);
+}
+catch(al::context_error& e) {
+    context->setError(e.errorCode(), "%s", e.what());
+}
+
+AL_API DECL_FUNCEXT6(void, alBufferFile,SOFT, ALuint,buffer, ALenum,format, const ALchar*,filename, ALint64SOFT,offset, ALsizei,size, ALsizei,freq)
+FORCE_ALIGN void AL_APIENTRY alBufferFileDirectSOFT(ALCcontext *context, ALuint buffer,
+    ALenum format, const ALchar *filename, ALint64SOFT offset, ALsizei size, ALsizei freq) noexcept
+try {
+    ALCdevice *device{context->mALDevice.get()};
+    std::lock_guard<std::shared_mutex> buflock{device->BufferLock};
+
+    ALbuffer *albuf{LookupBuffer(device, buffer)};
+    if(!albuf)
+        throw al::context_error{AL_INVALID_NAME, "Invalid buffer ID %u", buffer};
+    if(!filename)
+        throw al::context_error{AL_INVALID_VALUE, "NULL filename"};
+    if(offset < 0)
+        throw al::context_error{AL_INVALID_VALUE, "Negative file offset %" PRId64, offset};
+    if(size < 1)
+        throw al::context_error{AL_INVALID_VALUE, "Invalid data size %d", size};
+    if(freq < 1)
+        throw al::context_error{AL_INVALID_VALUE, "Invalid sample rate %d", freq};
+
+    auto usrfmt = DecomposeUserFormat(format);
+    if(!usrfmt)
+        throw al::context_error{AL_INVALID_ENUM, "Invalid format 0x%04x", format};
+
+    PrepareMapped(context, albuf, freq, usrfmt->channels, usrfmt->type, filename,
+        static_cast<uint64_t>(offset), static_cast<ALuint>(size));
+}
+catch(al::context_error& e) {
+    context->setError(e.errorCode(), "%s", e.what());
+}
+
+AL_API DECL_FUNCEXT4(void, alBufferRing,SOFT, ALuint,buffer, ALenum,format, ALsizei,freq, ALsizei,size)
+FORCE_ALIGN void AL_APIENTRY alBufferRingDirectSOFT(ALCcontext *context, ALuint buffer,
+    ALenum format, ALsizei freq, ALsizei size) noexcept
+try {
+    ALCdevice *device{context->mALDevice.get()};
+    std::lock_guard<std::shared_mutex> buflock{device->BufferLock};
+
+    ALbuffer *albuf{LookupBuffer(device, buffer)};
+    if(!albuf)
+        throw al::context_error{AL_INVALID_NAME, "Invalid buffer ID %u", buffer};
+    if(freq < 1)
+        throw al::context_error{AL_INVALID_VALUE, "Invalid sample rate %d", freq};
+    if(size < 1)
+        throw al::context_error{AL_INVALID_VALUE, "Invalid ring buffer size %d", size};
+
+    auto usrfmt = DecomposeUserFormat(format);
+    if(!usrfmt)
+        throw al::context_error{AL_INVALID_ENUM, "Invalid format 0x%04x", format};
+
+    PrepareRing(context, albuf, freq, usrfmt->channels, usrfmt->type, static_cast<ALuint>(size));
+}
+catch(al::context_error& e) {
+    context->setError(e.errorCode(), "%s", e.what());
+}
+
+AL_API DECL_FUNCEXT3(ALsizei, alBufferRingWrite,SOFT, ALuint,buffer, const ALvoid*,data, ALsizei,size)
+FORCE_ALIGN ALsizei AL_APIENTRY alBufferRingWriteDirectSOFT(ALCcontext *context, ALuint buffer,
+    const ALvoid *data, ALsizei size) noexcept
+try {
+    /* The shared lock only keeps the ring from being replaced, while the ring
+     * itself is lock-free with the mixer.
+     */
+    ALCdevice *device{context->mALDevice.get()};
+    std::shared_lock<std::shared_mutex> buflock{device->BufferLock};
+
+    ALbuffer *albuf{LookupBuffer(device, buffer)};
+    if(!albuf)
+        throw al::context_error{AL_INVALID_NAME, "Invalid buffer ID %u", buffer};
+    if(!albuf->mRing)
+        throw al::context_error{AL_INVALID_OPERATION, "Buffer %u is not a ring buffer", buffer};
+    if(size < 0)
+        throw al::context_error{AL_INVALID_VALUE, "Negative write size %d", size};
+    if(!data && size > 0)
+        throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
+
+    RingBuffer *ring{albuf->mRing->mRing.get()};
+    const size_t framesize{ring->getElemSize()};
+    const size_t written{ring->write(data, static_cast<ALuint>(size) / framesize)};
+    return static_cast<ALsizei>(written * framesize);
 }
 catch(al::context_error& e) {
     context->setError(e.errorCode(), "%s", e.what());
+    return 0;
 }
 
 AL_API DECL_FUNCEXT3(void, alGetBufferPtr,SOFT, ALuint,buffer, ALenum,param, ALvoid**,value)
@@ -1384,7 +2427,7 @@ FORCE_ALIGN void AL_APIENTRY alGetBufferPtrDirectSOFT(ALCcontext *context, ALuin
     ALenum param, ALvoid **value) noexcept
 try {
     ALCdevice *device{context->mALDevice.get()};
-    std::lock_guard<std::mutex> buflock{device->BufferLock};
+    std::shared_lock<std::shared_mutex> buflock{device->BufferLock};
 
     ALbuffer *albuf{LookupBuffer(device, buffer)};
     if(!albuf)
@@ -1395,10 +2438,12 @@ try {
     switch(param)
     {
     case AL_BUFFER_CALLBACK_FUNCTION_SOFT:
-        *value = reinterpret_cast<void*>(albuf->mCallback);
+        *value = albuf->mCallbackThread
+            ? reinterpret_cast<void*>(albuf->mCallbackThread->mCallback)
+            : reinterpret_cast<void*>(albuf->mCallback);
         return;
     case AL_BUFFER_CALLBACK_USER_PARAM_SOFT:
-        *value = albuf->mUserData;
+        *value = albuf->mCallbackThread ? albuf->mCallbackThread->mUserData : albuf->mUserData;
         return;
     }
 
@@ -1413,7 +2458,7 @@ FORCE_ALIGN void AL_APIENTRY alGetBuffer3PtrDirectSOFT(ALCcontext *context, ALui
     ALenum param, ALvoid **value1, ALvoid **value2, ALvoid **value3) noexcept
 try {
     ALCdevice *device{context->mALDevice.get()};
-    std::lock_guard<std::mutex> buflock{device->BufferLock};
+    std::shared_lock<std::shared_mutex> buflock{device->BufferLock};
 
     if(LookupBuffer(device, buffer) == nullptr)
         throw al::context_error{AL_INVALID_NAME, "Invalid buffer ID %u", buffer};
@@ -1442,7 +2487,7 @@ try {
     }
 
     ALCdevice *device{context->mALDevice.get()};
-    std::lock_guard<std::mutex> buflock{device->BufferLock};
+    std::shared_lock<std::shared_mutex> buflock{device->BufferLock};
 
     if(LookupBuffer(device, buffer) == nullptr)
         throw al::context_error{AL_INVALID_NAME, "Invalid buffer ID %u", buffer};
@@ -1464,7 +2509,7 @@ AL_API void AL_APIENTRY alBufferSamplesSOFT(ALuint /*buffer*/, ALuint /*samplera
     ALenum /*internalformat*/, ALsizei /*samples*/, ALenum /*channels*/, ALenum /*type*/,
     const ALvoid* /*data*/) noexcept
 {
-    ContextRef context{GetContextRef()};
+    auto context = GetCurrentContext();
     if(!context) UNLIKELY return;
 
     context->setError(AL_INVALID_OPERATION, "alBufferSamplesSOFT not supported");
@@ -1473,7 +2518,7 @@ AL_API void AL_APIENTRY alBufferSamplesSOFT(ALuint /*buffer*/, ALuint /*samplera
 AL_API void AL_APIENTRY alBufferSubSamplesSOFT(ALuint /*buffer*/, ALsizei /*offset*/,
     ALsizei /*samples*/, ALenum /*channels*/, ALenum /*type*/, const ALvoid* /*data*/) noexcept
 {
-    ContextRef context{GetContextRef()};
+    auto context = GetCurrentContext();
     if(!context) UNLIKELY return;
 
     context->setError(AL_INVALID_OPERATION, "alBufferSubSamplesSOFT not supported");
@@ -1482,7 +2527,7 @@ AL_API void AL_APIENTRY alBufferSubSamplesSOFT(ALuint /*buffer*/, ALsizei /*offs
 AL_API void AL_APIENTRY alGetBufferSamplesSOFT(ALuint /*buffer*/, ALsizei /*offset*/,
     ALsizei /*samples*/, ALenum /*channels*/, ALenum /*type*/, ALvoid* /*data*/) noexcept
 {
-    ContextRef context{GetContextRef()};
+    auto context = GetCurrentContext();
     if(!context) UNLIKELY return;
 
     context->setError(AL_INVALID_OPERATION, "alGetBufferSamplesSOFT not supported");
@@ -1490,7 +2535,7 @@ AL_API void AL_APIENTRY alGetBufferSamplesSOFT(ALuint /*buffer*/, ALsizei /*offs
 
 AL_API ALboolean AL_APIENTRY alIsBufferFormatSupportedSOFT(ALenum /*format*/) noexcept
 {
-    ContextRef context{GetContextRef()};
+    auto context = GetCurrentContext();
     if(!context) UNLIKELY return AL_FALSE;
 
     context->setError(AL_INVALID_OPERATION, "alIsBufferFormatSupportedSOFT not supported");
@@ -1501,7 +2546,7 @@ AL_API ALboolean AL_APIENTRY alIsBufferFormatSupportedSOFT(ALenum /*format*/) no
 void ALbuffer::SetName(ALCcontext *context, ALuint id, std::string_view name)
 {
     ALCdevice *device{context->mALDevice.get()};
-    std::lock_guard<std::mutex> buflock{device->BufferLock};
+    std::lock_guard<std::shared_mutex> buflock{device->BufferLock};
 
     auto buffer = LookupBuffer(device, id);
     if(!buffer)
@@ -1550,7 +2595,7 @@ try {
         throw al::context_error{AL_INVALID_VALUE, "Null AL buffers"};
 
     auto device = context->mALDevice.get();
-    std::lock_guard<std::mutex> devlock{device->BufferLock};
+    std::lock_guard<std::shared_mutex> devlock{device->BufferLock};
 
     /* Special-case setting a single buffer, to avoid extraneous allocations. */
     if(n == 1)
@@ -1649,7 +2694,7 @@ try {
         throw al::context_error{AL_INVALID_VALUE, "Non-null reserved parameter"};
 
     auto device = context->mALDevice.get();
-    std::lock_guard<std::mutex> devlock{device->BufferLock};
+    std::shared_lock<std::shared_mutex> devlock{device->BufferLock};
 
     const auto al_buffer = LookupBuffer(device, buffer);
     if(!al_buffer)
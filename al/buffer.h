@@ -5,16 +5,23 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string_view>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #include "AL/al.h"
 #include "AL/alc.h"
+#include "AL/alext.h"
 
 #include "alc/inprogext.h"
 #include "almalloc.h"
 #include "alnumeric.h"
+#include "alsem.h"
 #include "core/buffer_storage.h"
+#include "ringbuffer.h"
 #include "vector.h"
 
 #ifdef ALSOFT_EAX
@@ -26,10 +33,104 @@ enum class EaxStorage : uint8_t {
 #endif // ALSOFT_EAX
 
 
+/* A device's pool of sample storage, kept in size classes, so storage that's
+ * freed or outgrown by one buffer can be reused by another instead of going
+ * back to the system allocator.
+ */
+class BufferStoragePool {
+public:
+    using Storage = al::vector<std::byte,16>;
+
+    /** Sets the maximum number of bytes to keep pooled, freeing any excess. */
+    void setLimit(size_t limit);
+
+    /**
+     * Returns storage of at least the given size. Newly allocated storage is
+     * zeroed, but reused storage may have old samples.
+     */
+    [[nodiscard]] auto acquire(size_t size) -> Storage;
+
+    /** Keeps the storage for reuse, or frees it if the pool is full. */
+    void release(Storage&& storage) noexcept;
+
+    /** Returns the number of bytes of storage kept for reuse. */
+    [[nodiscard]] auto pooledSize() -> size_t;
+
+private:
+    static constexpr size_t MinClassSize{4096};
+    static constexpr size_t StepsPerOctave{4};
+    static constexpr size_t NumClasses{StepsPerOctave*16 + 1};
+
+    static auto classIndex(size_t size) noexcept -> size_t;
+    static auto classSize(size_t index) noexcept -> size_t;
+
+    std::mutex mLock;
+    std::array<std::vector<Storage>,NumClasses> mFree;
+    size_t mPooledSize{0};
+    size_t mLimit{0};
+};
+
+
+/* A ring buffer of sample frames written by the app and read by the mixer,
+ * as the callback of the buffer it's bound to.
+ */
+struct BufferRing {
+    RingBufferPtr mRing;
+    /* The byte value for silence, which fills any underrun. */
+    std::byte mSilence{};
+    /* Once set, the voice stops after playing what's left in the ring. */
+    std::atomic<bool> mEnded{false};
+};
+
+/* Calls a buffer callback from its own thread, keeping a ring of samples
+ * filled ahead of the mixer. The mixer reads from the ring instead of calling
+ * the callback itself.
+ */
+struct BufferCallbackThread {
+    BufferRing mRing;
+    ALBUFFERCALLBACKTYPESOFT mCallback{};
+    void *mUserData{};
+    /* The number of sample frames to request from the callback at once. */
+    size_t mRequestFrames{};
+
+    /* Posted by the mixer as it reads from the ring. */
+    al::semaphore mSem;
+    std::atomic<bool> mQuit{false};
+    std::thread mThread;
+
+    BufferCallbackThread() = default;
+    BufferCallbackThread(const BufferCallbackThread&) = delete;
+    ~BufferCallbackThread();
+
+    BufferCallbackThread& operator=(const BufferCallbackThread&) = delete;
+
+    void run();
+};
+
+
+/* Sample data shared between buffers, which may be on different devices. It
+ * can't be modified while shared, and is freed with the last buffer using it.
+ */
+struct BufferSharedData {
+    al::vector<std::byte,16> mData;
+    al::vector<std::byte,16> mDecoded;
+    /* A read-only file mapping holding the data instead of mData. */
+    std::shared_ptr<const void> mMapping;
+};
+
+
 struct ALbuffer : public BufferStorage {
     ALbitfieldSOFT Access{0u};
 
+    /* The sample storage, which may be larger than mData when it's being
+     * reused or has reserved space.
+     */
     al::vector<std::byte,16> mDataStorage;
+    /* The minimum storage size to allocate, so refills up to this size don't
+     * need to reallocate.
+     */
+    ALuint mReserveSize{0u};
+    al::vector<std::byte,16> mDecodedStorage;
 
     ALuint OriginalSize{0};
 
@@ -47,9 +148,50 @@ struct ALbuffer : public BufferStorage {
     /* Number of times buffer was attached to a source (deletion can only occur when 0) */
     std::atomic<ALuint> ref{0u};
 
+    /* Fence of the asynchronous upload filling this buffer, or 0 if none is
+     * pending. The upload holds a reference until it's done.
+     */
+    ALuint mUploadFence{0u};
+
+    /* Set when this buffer is a ring buffer, which mCallback reads. */
+    std::unique_ptr<BufferRing> mRing;
+
+    /* The minimum number of sample frames to request from a buffer callback
+     * at once, and how many requests to keep filled ahead on a separate
+     * thread (0 calls it from the mixer). Applied when setting the callback.
+     */
+    ALuint mCallbackRequestSize{0u};
+    ALuint mCallbackPrefetch{0u};
+
+    /* Set when the callback is called from its own thread, which mCallback
+     * reads from.
+     */
+    std::unique_ptr<BufferCallbackThread> mCallbackThread;
+
+    /* Set when the sample data is shared with other buffers, holding the data
+     * mData and mDecodedData refer to.
+     */
+    std::shared_ptr<const BufferSharedData> mSharedData;
+
+    /* The storage size counted in the device's memory usage. */
+    size_t mMemUsage{0};
+
     /* Self ID */
     ALuint id{0};
 
+    [[nodiscard]] auto decodedSamples() noexcept -> al::span<int16_t>
+    {
+        return {reinterpret_cast<int16_t*>(mDecodedData.data()),
+            mDecodedData.size()/sizeof(int16_t)};
+    }
+    void clearDecoded() noexcept
+    {
+        decltype(mDecodedStorage){}.swap(mDecodedStorage);
+        mDecodedData = {};
+        mIsDecoded = false;
+        mIsUhjDecoded = false;
+    }
+
     static void SetName(ALCcontext *context, ALuint id, std::string_view name);
 
     DISABLE_ALLOC
@@ -75,4 +217,11 @@ struct BufferSubList {
     { std::swap(FreeMask, rhs.FreeMask); std::swap(Buffers, rhs.Buffers); return *this; }
 };
 
+/**
+ * Sets a buffer to use the sample data of a buffer on the same or another
+ * device, without copying it. Returns an ALC error code.
+ */
+auto ShareBufferData(ALCdevice *device, ALuint buffer, ALCdevice *srcdevice, ALuint srcbuffer)
+    -> ALCenum;
+
 #endif
@@ -56,6 +56,19 @@ constexpr auto make_array_sequence()
 { return make_array_sequence(std::make_integer_sequence<T,N>{}); }
 
 
+constexpr auto GetDebugFilterIndex(uint source, uint type, uint severity) noexcept -> uint
+{ return (source*DebugTypeCount + type)*DebugSeverityCount + severity; }
+
+/* Messages with specific IDs are filtered by the source and type bits, along
+ * with the ID.
+ */
+constexpr auto GetDebugIdFilter(uint source, uint type, uint id) noexcept -> uint64_t
+{
+    return (1_u64 << (DebugSourceBase+source)) | (1_u64 << (DebugTypeBase+type))
+        | (uint64_t{id} << 32);
+}
+
+
 constexpr auto GetDebugSource(ALenum source) noexcept -> std::optional<DebugSource>
 {
     switch(source)
@@ -202,18 +215,11 @@ void ALCcontext::sendDebugMessage(std::unique_lock<std::mutex> &debuglock, Debug
 
     DebugGroup &debug = mDebugGroups.back();
 
-    const uint64_t idfilter{(1_u64 << (DebugSourceBase+al::to_underlying(source)))
-        | (1_u64 << (DebugTypeBase+al::to_underlying(type)))
-        | (uint64_t{id} << 32)};
-    auto iditer = std::lower_bound(debug.mIdFilters.cbegin(), debug.mIdFilters.cend(), idfilter);
-    if(iditer != debug.mIdFilters.cend() && *iditer == idfilter)
+    if(debug.mFilters.test(GetDebugFilterIndex(al::to_underlying(source),
+        al::to_underlying(type), al::to_underlying(severity))))
         return;
-
-    const uint filter{(1u << (DebugSourceBase+al::to_underlying(source)))
-        | (1u << (DebugTypeBase+al::to_underlying(type)))
-        | (1u << (DebugSeverityBase+al::to_underlying(severity)))};
-    auto iter = std::lower_bound(debug.mFilters.cbegin(), debug.mFilters.cend(), filter);
-    if(iter != debug.mFilters.cend() && *iter == filter)
+    if(!debug.mIdFilters.empty() && debug.mIdFilters.count(GetDebugIdFilter(
+        al::to_underlying(source), al::to_underlying(type), id)) != 0)
         return;
 
     if(mDebugCb)
@@ -311,10 +317,10 @@ try {
     if(enable != AL_TRUE && enable != AL_FALSE)
         throw al::context_error{AL_INVALID_ENUM, "Invalid debug enable %d", enable};
 
-    static constexpr size_t ElemCount{DebugSourceCount + DebugTypeCount + DebugSeverityCount};
-    static constexpr auto Values = make_array_sequence<uint8_t,ElemCount>();
+    static constexpr auto Values = make_array_sequence<uint8_t,DebugTypeCount>();
+    static_assert(DebugTypeCount >= DebugSourceCount && DebugTypeCount >= DebugSeverityCount);
 
-    auto srcIndices = al::span{Values}.subspan(DebugSourceBase,DebugSourceCount);
+    auto srcIndices = al::span{Values}.first(DebugSourceCount);
     if(source != AL_DONT_CARE_EXT)
     {
         auto dsource = GetDebugSource(source);
@@ -323,7 +329,7 @@ try {
         srcIndices = srcIndices.subspan(al::to_underlying(*dsource), 1);
     }
 
-    auto typeIndices = al::span{Values}.subspan(DebugTypeBase,DebugTypeCount);
+    auto typeIndices = al::span{Values}.first(DebugTypeCount);
     if(type != AL_DONT_CARE_EXT)
     {
         auto dtype = GetDebugType(type);
@@ -332,7 +338,7 @@ try {
         typeIndices = typeIndices.subspan(al::to_underlying(*dtype), 1);
     }
 
-    auto svrIndices = al::span{Values}.subspan(DebugSeverityBase,DebugSeverityCount);
+    auto svrIndices = al::span{Values}.first(DebugSeverityCount);
     if(severity != AL_DONT_CARE_EXT)
     {
         auto dseverity = GetDebugSeverity(severity);
@@ -345,42 +351,25 @@ try {
     DebugGroup &debug = context->mDebugGroups.back();
     if(count > 0)
     {
-        const uint filterbase{(1u<<srcIndices[0]) | (1u<<typeIndices[0])};
-
         for(const uint id : al::span{ids, static_cast<uint>(count)})
         {
-            const uint64_t filter{filterbase | (uint64_t{id} << 32)};
-
-            auto iter = std::lower_bound(debug.mIdFilters.cbegin(), debug.mIdFilters.cend(),
-                filter);
-            if(!enable && (iter == debug.mIdFilters.cend() || *iter != filter))
-                debug.mIdFilters.insert(iter, filter);
-            else if(enable && iter != debug.mIdFilters.cend() && *iter == filter)
-                debug.mIdFilters.erase(iter);
+            const uint64_t filter{GetDebugIdFilter(srcIndices[0], typeIndices[0], id)};
+            if(!enable)
+                debug.mIdFilters.insert(filter);
+            else
+                debug.mIdFilters.erase(filter);
         }
     }
     else
     {
-        auto apply_filter = [enable,&debug](const uint filter)
-        {
-            auto iter = std::lower_bound(debug.mFilters.cbegin(), debug.mFilters.cend(), filter);
-            if(!enable && (iter == debug.mFilters.cend() || *iter != filter))
-                debug.mFilters.insert(iter, filter);
-            else if(enable && iter != debug.mFilters.cend() && *iter == filter)
-                debug.mFilters.erase(iter);
-        };
-        auto apply_severity = [apply_filter,svrIndices](const uint filter)
+        for(const uint srcidx : srcIndices)
         {
-            std::for_each(svrIndices.cbegin(), svrIndices.cend(),
-                [apply_filter,filter](const uint idx){ apply_filter(filter | (1<<idx)); });
-        };
-        auto apply_type = [apply_severity,typeIndices](const uint filter)
-        {
-            std::for_each(typeIndices.cbegin(), typeIndices.cend(),
-                [apply_severity,filter](const uint idx){ apply_severity(filter | (1<<idx)); });
-        };
-        std::for_each(srcIndices.cbegin(), srcIndices.cend(),
-            [apply_type](const uint idx){ apply_type(1<<idx); });
+            for(const uint typeidx : typeIndices)
+            {
+                for(const uint svridx : svrIndices)
+                    debug.mFilters.set(GetDebugFilterIndex(srcidx, typeidx, svridx), !enable);
+            }
+        }
     }
 }
 catch(al::context_error& e) {
@@ -1,10 +1,11 @@
 #ifndef AL_DEBUG_H
 #define AL_DEBUG_H
 
+#include <bitset>
 #include <cstdint>
 #include <string>
+#include <unordered_set>
 #include <utility>
-#include <vector>
 
 using uint = unsigned int;
 
@@ -51,12 +52,16 @@ enum class DebugSeverity : std::uint8_t {
 };
 inline constexpr uint DebugSeverityCount{4};
 
+/* One filter bit for each source, type, and severity combination. */
+inline constexpr uint DebugFilterCount{DebugSourceCount * DebugTypeCount * DebugSeverityCount};
+
 struct DebugGroup {
     const uint mId;
     const DebugSource mSource;
     std::string mMessage;
-    std::vector<uint> mFilters;
-    std::vector<std::uint64_t> mIdFilters;
+    /* Disabled messages, checked for each message sent. */
+    std::bitset<DebugFilterCount> mFilters;
+    std::unordered_set<std::uint64_t> mIdFilters;
 
     template<typename T>
     DebugGroup(DebugSource source, uint id, T&& message)
@@ -14,7 +14,7 @@ constexpr void DefaultVal() noexcept { }
 #define DECL_FUNC(R, Name)                                                    \
 auto AL_APIENTRY Name() noexcept -> R                                         \
 {                                                                             \
-    auto context = GetContextRef();                                           \
+    auto context = GetCurrentContext();                                       \
     if(!context) UNLIKELY return detail_::DefaultVal<R>();                    \
     return Name##Direct(context.get());                                       \
 }
@@ -22,7 +22,7 @@ auto AL_APIENTRY Name() noexcept -> R                                         \
 #define DECL_FUNC1(R, Name, T1,n1)                                            \
 auto AL_APIENTRY Name(T1 n1) noexcept -> R                                    \
 {                                                                             \
-    auto context = GetContextRef();                                           \
+    auto context = GetCurrentContext();                                       \
     if(!context) UNLIKELY return detail_::DefaultVal<R>();                    \
     return Name##Direct(context.get(), n1);                                   \
 }
@@ -30,7 +30,7 @@ auto AL_APIENTRY Name(T1 n1) noexcept -> R                                    \
 #define DECL_FUNC2(R, Name, T1,n1, T2,n2)                                     \
 auto AL_APIENTRY Name(T1 n1, T2 n2) noexcept -> R                             \
 {                                                                             \
-    auto context = GetContextRef();                                           \
+    auto context = GetCurrentContext();                                       \
     if(!context) UNLIKELY return detail_::DefaultVal<R>();                    \
     return Name##Direct(context.get(), n1, n2);                               \
 }
@@ -38,7 +38,7 @@ auto AL_APIENTRY Name(T1 n1, T2 n2) noexcept -> R                             \
 #define DECL_FUNC3(R, Name, T1,n1, T2,n2, T3,n3)                              \
 auto AL_APIENTRY Name(T1 n1, T2 n2, T3 n3) noexcept -> R                      \
 {                                                                             \
-    auto context = GetContextRef();                                           \
+    auto context = GetCurrentContext();                                       \
     if(!context) UNLIKELY return detail_::DefaultVal<R>();                    \
     return Name##Direct(context.get(), n1, n2, n3);                           \
 }
@@ -46,7 +46,7 @@ auto AL_APIENTRY Name(T1 n1, T2 n2, T3 n3) noexcept -> R                      \
 #define DECL_FUNC4(R, Name, T1,n1, T2,n2, T3,n3, T4,n4)                       \
 auto AL_APIENTRY Name(T1 n1, T2 n2, T3 n3, T4 n4) noexcept -> R               \
 {                                                                             \
-    auto context = GetContextRef();                                           \
+    auto context = GetCurrentContext();                                       \
     if(!context) UNLIKELY return detail_::DefaultVal<R>();                    \
     return Name##Direct(context.get(), n1, n2, n3, n4);                       \
 }
@@ -54,7 +54,7 @@ auto AL_APIENTRY Name(T1 n1, T2 n2, T3 n3, T4 n4) noexcept -> R               \
 #define DECL_FUNC5(R, Name, T1,n1, T2,n2, T3,n3, T4,n4, T5,n5)                \
 auto AL_APIENTRY Name(T1 n1, T2 n2, T3 n3, T4 n4, T5 n5) noexcept -> R        \
 {                                                                             \
-    auto context = GetContextRef();                                           \
+    auto context = GetCurrentContext();                                       \
     if(!context) UNLIKELY return detail_::DefaultVal<R>();                    \
     return Name##Direct(context.get(), n1, n2, n3, n4, n5);                   \
 }
@@ -63,7 +63,7 @@ auto AL_APIENTRY Name(T1 n1, T2 n2, T3 n3, T4 n4, T5 n5) noexcept -> R        \
 #define DECL_FUNCEXT(R, Name,Ext)                                             \
 auto AL_APIENTRY Name##Ext() noexcept -> R                                    \
 {                                                                             \
-    auto context = GetContextRef();                                           \
+    auto context = GetCurrentContext();                                       \
     if(!context) UNLIKELY return detail_::DefaultVal<R>();                    \
     return Name##Direct##Ext(context.get());                                  \
 }
@@ -71,7 +71,7 @@ auto AL_APIENTRY Name##Ext() noexcept -> R                                    \
 #define DECL_FUNCEXT1(R, Name,Ext, T1,n1)                                     \
 auto AL_APIENTRY Name##Ext(T1 n1) noexcept -> R                               \
 {                                                                             \
-    auto context = GetContextRef();                                           \
+    auto context = GetCurrentContext();                                       \
     if(!context) UNLIKELY return detail_::DefaultVal<R>();                    \
     return Name##Direct##Ext(context.get(), n1);                              \
 }
@@ -79,7 +79,7 @@ auto AL_APIENTRY Name##Ext(T1 n1) noexcept -> R                               \
 #define DECL_FUNCEXT2(R, Name,Ext, T1,n1, T2,n2)                              \
 auto AL_APIENTRY Name##Ext(T1 n1, T2 n2) noexcept -> R                        \
 {                                                                             \
-    auto context = GetContextRef();                                           \
+    auto context = GetCurrentContext();                                       \
     if(!context) UNLIKELY return detail_::DefaultVal<R>();                    \
     return Name##Direct##Ext(context.get(), n1, n2);                          \
 }
@@ -87,7 +87,7 @@ auto AL_APIENTRY Name##Ext(T1 n1, T2 n2) noexcept -> R                        \
 #define DECL_FUNCEXT3(R, Name,Ext, T1,n1, T2,n2, T3,n3)                       \
 auto AL_APIENTRY Name##Ext(T1 n1, T2 n2, T3 n3) noexcept -> R                 \
 {                                                                             \
-    auto context = GetContextRef();                                           \
+    auto context = GetCurrentContext();                                       \
     if(!context) UNLIKELY return detail_::DefaultVal<R>();                    \
     return Name##Direct##Ext(context.get(), n1, n2, n3);                      \
 }
@@ -95,7 +95,7 @@ auto AL_APIENTRY Name##Ext(T1 n1, T2 n2, T3 n3) noexcept -> R                 \
 #define DECL_FUNCEXT4(R, Name,Ext, T1,n1, T2,n2, T3,n3, T4,n4)                \
 auto AL_APIENTRY Name##Ext(T1 n1, T2 n2, T3 n3, T4 n4) noexcept -> R          \
 {                                                                             \
-    auto context = GetContextRef();                                           \
+    auto context = GetCurrentContext();                                       \
     if(!context) UNLIKELY return detail_::DefaultVal<R>();                    \
     return Name##Direct##Ext(context.get(), n1, n2, n3, n4);                  \
 }
@@ -103,7 +103,7 @@ auto AL_APIENTRY Name##Ext(T1 n1, T2 n2, T3 n3, T4 n4) noexcept -> R          \
 #define DECL_FUNCEXT5(R, Name,Ext, T1,n1, T2,n2, T3,n3, T4,n4, T5,n5)         \
 auto AL_APIENTRY Name##Ext(T1 n1, T2 n2, T3 n3, T4 n4, T5 n5) noexcept -> R   \
 {                                                                             \
-    auto context = GetContextRef();                                           \
+    auto context = GetCurrentContext();                                       \
     if(!context) UNLIKELY return detail_::DefaultVal<R>();                    \
     return Name##Direct##Ext(context.get(), n1, n2, n3, n4, n5);              \
 }
@@ -111,7 +111,7 @@ auto AL_APIENTRY Name##Ext(T1 n1, T2 n2, T3 n3, T4 n4, T5 n5) noexcept -> R   \
 #define DECL_FUNCEXT6(R, Name,Ext, T1,n1, T2,n2, T3,n3, T4,n4, T5,n5, T6,n6)  \
 auto AL_APIENTRY Name##Ext(T1 n1, T2 n2, T3 n3, T4 n4, T5 n5, T6 n6) noexcept -> R \
 {                                                                             \
-    auto context = GetContextRef();                                           \
+    auto context = GetCurrentContext();                                       \
     if(!context) UNLIKELY return detail_::DefaultVal<R>();                    \
     return Name##Direct##Ext(context.get(), n1, n2, n3, n4, n5, n6);          \
 }
@@ -119,7 +119,7 @@ auto AL_APIENTRY Name##Ext(T1 n1, T2 n2, T3 n3, T4 n4, T5 n5, T6 n6) noexcept ->
 #define DECL_FUNCEXT8(R, Name,Ext, T1,n1, T2,n2, T3,n3, T4,n4, T5,n5, T6,n6, T7,n7, T8,n8) \
 auto AL_APIENTRY Name##Ext(T1 n1, T2 n2, T3 n3, T4 n4, T5 n5, T6 n6, T7 n7, T8 n8) noexcept -> R \
 {                                                                             \
-    auto context = GetContextRef();                                           \
+    auto context = GetCurrentContext();                                       \
     if(!context) UNLIKELY return detail_::DefaultVal<R>();                    \
     return Name##Direct##Ext(context.get(), n1, n2, n3, n4, n5, n6, n7, n8);  \
 }
@@ -58,7 +58,7 @@
 #include "opthelpers.h"
 
 
-const std::array<EffectList,16> gEffectList{{
+const std::array<EffectList,17> gEffectList{{
     { "eaxreverb",   EAXREVERB_EFFECT,   AL_EFFECT_EAXREVERB },
     { "reverb",      REVERB_EFFECT,      AL_EFFECT_REVERB },
     { "autowah",     AUTOWAH_EFFECT,     AL_EFFECT_AUTOWAH },
@@ -75,6 +75,7 @@ const std::array<EffectList,16> gEffectList{{
     { "dedicated",   DEDICATED_EFFECT,   AL_EFFECT_DEDICATED_LOW_FREQUENCY_EFFECT },
     { "dedicated",   DEDICATED_EFFECT,   AL_EFFECT_DEDICATED_DIALOGUE },
     { "convolution", CONVOLUTION_EFFECT, AL_EFFECT_CONVOLUTION_SOFT },
+    { "sourcegroup", SOURCE_GROUP_EFFECT, AL_EFFECT_SOURCE_GROUP_SOFT },
 }};
 
 
@@ -103,6 +104,7 @@ constexpr auto GetDefaultProps(ALenum type) noexcept -> const EffectProps&
     case AL_EFFECT_DEDICATED_DIALOGUE: return DedicatedDialogEffectProps;
     case AL_EFFECT_DEDICATED_LOW_FREQUENCY_EFFECT: return DedicatedLfeEffectProps;
     case AL_EFFECT_CONVOLUTION_SOFT: return ConvolutionEffectProps;
+    case AL_EFFECT_SOURCE_GROUP_SOFT: return SourceGroupEffectProps;
     }
     return NullEffectProps;
 }
@@ -134,6 +136,9 @@ void InitEffectParams(ALeffect *effect, ALenum type) noexcept
     case AL_EFFECT_CONVOLUTION_SOFT:
         effect->PropsVariant.emplace<ConvolutionEffectHandler>();
         break;
+    case AL_EFFECT_SOURCE_GROUP_SOFT:
+        effect->PropsVariant.emplace<SourceGroupEffectHandler>();
+        break;
     }
     effect->Props = GetDefaultProps(type);
     effect->type = type;
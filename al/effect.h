@@ -33,6 +33,7 @@ enum {
     VMORPHER_EFFECT,
     DEDICATED_EFFECT,
     CONVOLUTION_EFFECT,
+    SOURCE_GROUP_EFFECT,
 
     MAX_EFFECTS
 };
@@ -43,13 +44,14 @@ struct EffectList {
     ALuint type;
     ALenum val;
 };
-extern const std::array<EffectList,16> gEffectList;
+extern const std::array<EffectList,17> gEffectList;
 
 using EffectHandlerVariant = std::variant<NullEffectHandler,ReverbEffectHandler,
     StdReverbEffectHandler,AutowahEffectHandler,ChorusEffectHandler,CompressorEffectHandler,
     DistortionEffectHandler,EchoEffectHandler,EqualizerEffectHandler,FlangerEffectHandler,
     FshifterEffectHandler,ModulatorEffectHandler,PshifterEffectHandler,VmorpherEffectHandler,
-    DedicatedDialogEffectHandler,DedicatedLfeEffectHandler,ConvolutionEffectHandler>;
+    DedicatedDialogEffectHandler,DedicatedLfeEffectHandler,ConvolutionEffectHandler,
+    SourceGroupEffectHandler>;
 
 struct ALeffect {
     // Effect type (AL_EFFECT_NULL, ...)
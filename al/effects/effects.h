@@ -38,6 +38,7 @@ DECL_HANDLER(VmorpherEffectHandler, VmorpherProps)
 DECL_HANDLER(DedicatedDialogEffectHandler, DedicatedProps)
 DECL_HANDLER(DedicatedLfeEffectHandler, DedicatedProps)
 DECL_HANDLER(ConvolutionEffectHandler, ConvolutionProps)
+DECL_HANDLER(SourceGroupEffectHandler, SourceGroupProps)
 #undef DECL_HANDLER
 
 
@@ -62,5 +63,6 @@ extern const EffectProps VmorpherEffectProps;
 extern const EffectProps DedicatedDialogEffectProps;
 extern const EffectProps DedicatedLfeEffectProps;
 extern const EffectProps ConvolutionEffectProps;
+extern const EffectProps SourceGroupEffectProps;
 
 #endif /* AL_EFFECTS_EFFECTS_H */
@@ -4,11 +4,15 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <optional>
+#include <stdexcept>
+#include <string>
 #include <variant>
 
 #include "AL/al.h"
 #include "AL/efx.h"
 
+#include "alc/inprogext.h"
 #include "alnumeric.h"
 #include "alspan.h"
 #include "core/effects/base.h"
@@ -26,6 +30,27 @@
 
 namespace {
 
+constexpr std::optional<ReverbZoneMode> ZoneModeFromEnum(ALenum mode) noexcept
+{
+    switch(mode)
+    {
+    case AL_REVERB_FULL_SOFT: return ReverbZoneMode::Full;
+    case AL_REVERB_EARLY_ZONE_SOFT: return ReverbZoneMode::EarlyZone;
+    case AL_REVERB_SHARED_LATE_SOFT: return ReverbZoneMode::SharedLate;
+    }
+    return std::nullopt;
+}
+constexpr ALenum EnumFromZoneMode(ReverbZoneMode mode)
+{
+    switch(mode)
+    {
+    case ReverbZoneMode::Full: return AL_REVERB_FULL_SOFT;
+    case ReverbZoneMode::EarlyZone: return AL_REVERB_EARLY_ZONE_SOFT;
+    case ReverbZoneMode::SharedLate: return AL_REVERB_SHARED_LATE_SOFT;
+    }
+    throw std::runtime_error{"Invalid reverb zone mode: "+std::to_string(static_cast<int>(mode))};
+}
+
 constexpr EffectProps genDefaultProps() noexcept
 {
     ReverbProps props{};
@@ -56,6 +81,7 @@ constexpr EffectProps genDefaultProps() noexcept
     props.LFReference = AL_EAXREVERB_DEFAULT_LFREFERENCE;
     props.RoomRolloffFactor = AL_EAXREVERB_DEFAULT_ROOM_ROLLOFF_FACTOR;
     props.DecayHFLimit = AL_EAXREVERB_DEFAULT_DECAY_HFLIMIT;
+    props.ZoneMode = ReverbZoneMode::Full;
     return props;
 }
 
@@ -85,6 +111,7 @@ constexpr EffectProps genDefaultStdProps() noexcept
     props.LFReference = 250.0f;
     props.RoomRolloffFactor = AL_REVERB_DEFAULT_ROOM_ROLLOFF_FACTOR;
     props.DecayHFLimit = AL_REVERB_DEFAULT_DECAY_HFLIMIT;
+    props.ZoneMode = ReverbZoneMode::Full;
     return props;
 }
 
@@ -102,6 +129,13 @@ void ReverbEffectHandler::SetParami(ReverbProps &props, ALenum param, int val)
         props.DecayHFLimit = val != AL_FALSE;
         break;
 
+    case AL_EAXREVERB_ZONE_MODE_SOFT:
+        if(auto modeopt = ZoneModeFromEnum(val))
+            props.ZoneMode = *modeopt;
+        else
+            throw effect_exception{AL_INVALID_VALUE, "Invalid reverb zone mode: 0x%04x", val};
+        break;
+
     default:
         throw effect_exception{AL_INVALID_ENUM, "Invalid EAX reverb integer property 0x%04x",
             param};
@@ -267,6 +301,7 @@ void ReverbEffectHandler::GetParami(const ReverbProps &props, ALenum param, int
     switch(param)
     {
     case AL_EAXREVERB_DECAY_HFLIMIT: *val = props.DecayHFLimit; break;
+    case AL_EAXREVERB_ZONE_MODE_SOFT: *val = EnumFromZoneMode(props.ZoneMode); break;
     default:
         throw effect_exception{AL_INVALID_ENUM, "Invalid EAX reverb integer property 0x%04x",
             param};
@@ -336,6 +371,13 @@ void StdReverbEffectHandler::SetParami(ReverbProps &props, ALenum param, int val
         props.DecayHFLimit = val != AL_FALSE;
         break;
 
+    case AL_REVERB_ZONE_MODE_SOFT:
+        if(auto modeopt = ZoneModeFromEnum(val))
+            props.ZoneMode = *modeopt;
+        else
+            throw effect_exception{AL_INVALID_VALUE, "Invalid reverb zone mode: 0x%04x", val};
+        break;
+
     default:
         throw effect_exception{AL_INVALID_ENUM, "Invalid EAX reverb integer property 0x%04x",
             param};
@@ -431,6 +473,7 @@ void StdReverbEffectHandler::GetParami(const ReverbProps &props, ALenum param, i
     switch(param)
     {
     case AL_REVERB_DECAY_HFLIMIT: *val = props.DecayHFLimit; break;
+    case AL_REVERB_ZONE_MODE_SOFT: *val = EnumFromZoneMode(props.ZoneMode); break;
     default:
         throw effect_exception{AL_INVALID_ENUM, "Invalid EAX reverb integer property 0x%04x",
             param};
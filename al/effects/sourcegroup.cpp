@@ -0,0 +1,159 @@
+
+#include "config.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "AL/al.h"
+
+#include "alc/inprogext.h"
+#include "alnumeric.h"
+#include "alspan.h"
+#include "core/effects/base.h"
+#include "effects.h"
+
+
+namespace {
+
+constexpr EffectProps genDefaultProps() noexcept
+{
+    SourceGroupProps props{};
+    props.Position = {0.0f, 0.0f, 0.0f};
+    props.Gain = 1.0f;
+    props.RefDistance = 1.0f;
+    props.RolloffFactor = 1.0f;
+    props.HeadRelative = false;
+    return props;
+}
+
+} // namespace
+
+const EffectProps SourceGroupEffectProps{genDefaultProps()};
+
+void SourceGroupEffectHandler::SetParami(SourceGroupProps &props, ALenum param, int val)
+{
+    switch(param)
+    {
+    case AL_SOURCE_GROUP_RELATIVE_SOFT:
+        if(!(val == AL_FALSE || val == AL_TRUE))
+            throw effect_exception{AL_INVALID_VALUE, "Source group relative out of range"};
+        props.HeadRelative = val != AL_FALSE;
+        break;
+
+    default:
+        throw effect_exception{AL_INVALID_ENUM,
+            "Invalid source group effect integer property 0x%04x", param};
+    }
+}
+void SourceGroupEffectHandler::SetParamiv(SourceGroupProps &props, ALenum param, const int *vals)
+{
+    switch(param)
+    {
+    case AL_SOURCE_GROUP_POSITION_SOFT:
+        SetParamfv(props, param, std::array{static_cast<float>(vals[0]),
+            static_cast<float>(vals[1]), static_cast<float>(vals[2])}.data());
+        break;
+
+    default:
+        SetParami(props, param, *vals);
+    }
+}
+void SourceGroupEffectHandler::SetParamf(SourceGroupProps &props, ALenum param, float val)
+{
+    switch(param)
+    {
+    case AL_SOURCE_GROUP_GAIN_SOFT:
+        if(!(val >= 0.0f && std::isfinite(val)))
+            throw effect_exception{AL_INVALID_VALUE, "Source group gain out of range"};
+        props.Gain = val;
+        break;
+
+    case AL_SOURCE_GROUP_REFERENCE_DISTANCE_SOFT:
+        if(!(val >= 0.0f && std::isfinite(val)))
+            throw effect_exception{AL_INVALID_VALUE,
+                "Source group reference distance out of range"};
+        props.RefDistance = val;
+        break;
+
+    case AL_SOURCE_GROUP_ROLLOFF_FACTOR_SOFT:
+        if(!(val >= 0.0f && std::isfinite(val)))
+            throw effect_exception{AL_INVALID_VALUE, "Source group rolloff factor out of range"};
+        props.RolloffFactor = val;
+        break;
+
+    default:
+        throw effect_exception{AL_INVALID_ENUM,
+            "Invalid source group effect float property 0x%04x", param};
+    }
+}
+void SourceGroupEffectHandler::SetParamfv(SourceGroupProps &props, ALenum param,
+    const float *values)
+{
+    static constexpr auto finite_checker = [](float val) -> bool { return std::isfinite(val); };
+    al::span<const float> vals;
+    switch(param)
+    {
+    case AL_SOURCE_GROUP_POSITION_SOFT:
+        vals = {values, 3_uz};
+        if(!std::all_of(vals.cbegin(), vals.cend(), finite_checker))
+            throw effect_exception{AL_INVALID_VALUE, "Source group position out of range"};
+
+        std::copy(vals.cbegin(), vals.cend(), props.Position.begin());
+        break;
+
+    default:
+        SetParamf(props, param, *values);
+    }
+}
+
+void SourceGroupEffectHandler::GetParami(const SourceGroupProps &props, ALenum param, int *val)
+{
+    switch(param)
+    {
+    case AL_SOURCE_GROUP_RELATIVE_SOFT: *val = props.HeadRelative; break;
+
+    default:
+        throw effect_exception{AL_INVALID_ENUM,
+            "Invalid source group effect integer property 0x%04x", param};
+    }
+}
+void SourceGroupEffectHandler::GetParamiv(const SourceGroupProps &props, ALenum param, int *vals)
+{
+    switch(param)
+    {
+    case AL_SOURCE_GROUP_POSITION_SOFT:
+        std::transform(props.Position.cbegin(), props.Position.cend(), vals,
+            [](const float val) { return static_cast<int>(val); });
+        break;
+
+    default:
+        GetParami(props, param, vals);
+    }
+}
+void SourceGroupEffectHandler::GetParamf(const SourceGroupProps &props, ALenum param, float *val)
+{
+    switch(param)
+    {
+    case AL_SOURCE_GROUP_GAIN_SOFT: *val = props.Gain; break;
+    case AL_SOURCE_GROUP_REFERENCE_DISTANCE_SOFT: *val = props.RefDistance; break;
+    case AL_SOURCE_GROUP_ROLLOFF_FACTOR_SOFT: *val = props.RolloffFactor; break;
+
+    default:
+        throw effect_exception{AL_INVALID_ENUM,
+            "Invalid source group effect float property 0x%04x", param};
+    }
+}
+void SourceGroupEffectHandler::GetParamfv(const SourceGroupProps &props, ALenum param,
+    float *values)
+{
+    switch(param)
+    {
+    case AL_SOURCE_GROUP_POSITION_SOFT:
+        std::copy(props.Position.cbegin(), props.Position.cend(), values);
+        break;
+
+    default:
+        GetParamf(props, param, values);
+    }
+}
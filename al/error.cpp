@@ -27,6 +27,7 @@
 #include <windows.h>
 #endif
 
+#include <array>
 #include <atomic>
 #include <csignal>
 #include <cstdarg>
@@ -66,24 +67,30 @@ context_error::~context_error() = default;
 
 void ALCcontext::setError(ALenum errorCode, const char *msg, ...)
 {
-    auto message = std::vector<char>(256);
+    /* Most messages fit on the stack, so reporting an error usually doesn't
+     * allocate.
+     */
+    std::array<char,256> stcmsg{};
+    std::vector<char> dynmsg;
+    char *message{stcmsg.data()};
 
     /* NOLINTBEGIN(*-array-to-pointer-decay) */
     std::va_list args, args2;
     va_start(args, msg);
     va_copy(args2, args);
-    int msglen{std::vsnprintf(message.data(), message.size(), msg, args)};
-    if(msglen >= 0 && static_cast<size_t>(msglen) >= message.size())
+    int msglen{std::vsnprintf(stcmsg.data(), stcmsg.size(), msg, args)};
+    if(msglen >= 0 && static_cast<size_t>(msglen) >= stcmsg.size()) UNLIKELY
     {
-        message.resize(static_cast<size_t>(msglen) + 1u);
-        msglen = std::vsnprintf(message.data(), message.size(), msg, args2);
+        dynmsg.resize(static_cast<size_t>(msglen) + 1u);
+        message = dynmsg.data();
+        msglen = std::vsnprintf(dynmsg.data(), dynmsg.size(), msg, args2);
     }
     va_end(args2);
     va_end(args);
     /* NOLINTEND(*-array-to-pointer-decay) */
 
     if(msglen >= 0)
-        msg = message.data();
+        msg = message;
     else
     {
         msg = "<internal error constructing message>";
@@ -115,7 +122,7 @@ void ALCcontext::setError(ALenum errorCode, const char *msg, ...)
  */
 AL_API auto AL_APIENTRY alGetError() noexcept -> ALenum
 {
-    if(auto context = GetContextRef()) LIKELY
+    if(auto context = GetCurrentContext()) LIKELY
         return alGetErrorDirect(context.get());
 
     auto get_value = [](const char *envname, const char *optname) -> ALenum
@@ -3,9 +3,13 @@
 
 #include "event.h"
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <bitset>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
 #include <exception>
 #include <memory>
 #include <mutex>
@@ -15,14 +19,17 @@
 #include <string_view>
 #include <thread>
 #include <tuple>
+#include <unordered_map>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include "AL/al.h"
 #include "AL/alc.h"
 #include "AL/alext.h"
 
 #include "alc/context.h"
+#include "alc/inprogext.h"
 #include "alsem.h"
 #include "alspan.h"
 #include "core/async_event.h"
@@ -35,6 +42,7 @@
 #include "intrusive_ptr.h"
 #include "opthelpers.h"
 #include "ringbuffer.h"
+#include "source.h"
 
 
 namespace {
@@ -45,68 +53,84 @@ struct overloaded : Ts... { using Ts::operator()...; };
 template<typename... Ts>
 overloaded(Ts...) -> overloaded<Ts...>;
 
-int EventThread(ALCcontext *context)
+/* Dispatches the pending events in the context's ring buffer. */
+void ProcessEvents(ALCcontext *context)
 {
     RingBuffer *ring{context->mAsyncEvents.get()};
-    bool quitnow{false};
-    while(!quitnow)
-    {
-        auto evt_data = ring->getReadVector().first;
-        if(evt_data.len == 0)
-        {
-            context->mEventSem.wait();
-            continue;
-        }
+    /* Events for the batch callback, and where each source's buffer completed
+     * count is in the batch, so later completions can be added to it.
+     */
+    std::vector<ALeventSOFT> batch;
+    std::unordered_map<ALuint,size_t> completions;
 
-        std::lock_guard<std::mutex> eventlock{context->mEventCbLock};
+    std::lock_guard<std::mutex> eventlock{context->mEventCbLock};
+    const bool batching{context->mEventBatchCb != nullptr};
+    auto add_event = [&batch](ALenum type, ALuint object, ALuint param)
+    { batch.emplace_back(ALeventSOFT{type, object, param}); };
+
+    auto evt_data = ring->getReadVector().first;
+    while(evt_data.len > 0)
+    {
         auto evt_span = al::span{std::launder(reinterpret_cast<AsyncEvent*>(evt_data.buf)),
             evt_data.len};
         for(auto &event : evt_span)
         {
-            quitnow = std::holds_alternative<AsyncKillThread>(event);
-            if(quitnow) UNLIKELY break;
-
             auto enabledevts = context->mEnabledEvts.load(std::memory_order_acquire);
             auto proc_killthread = [](AsyncKillThread&) { };
             auto proc_release = [](AsyncEffectReleaseEvent &evt)
             {
                 al::intrusive_ptr<EffectState>{evt.mEffectState};
             };
-            auto proc_srcstate = [context,enabledevts](AsyncSourceStateEvent &evt)
+            auto proc_srcstate = [&](AsyncSourceStateEvent &evt)
             {
-                if(!context->mEventCb
-                    || !enabledevts.test(al::to_underlying(AsyncEnableBits::SourceState)))
+                if(!enabledevts.test(al::to_underlying(AsyncEnableBits::SourceState)))
                     return;
 
                 ALuint state{};
-                std::string msg{"Source ID " + std::to_string(evt.mId)};
-                msg += " state has changed to ";
+                const char *statename{};
                 switch(evt.mState)
                 {
-                case AsyncSrcState::Reset:
-                    msg += "AL_INITIAL";
-                    state = AL_INITIAL;
-                    break;
-                case AsyncSrcState::Stop:
-                    msg += "AL_STOPPED";
-                    state = AL_STOPPED;
-                    break;
-                case AsyncSrcState::Play:
-                    msg += "AL_PLAYING";
-                    state = AL_PLAYING;
-                    break;
-                case AsyncSrcState::Pause:
-                    msg += "AL_PAUSED";
-                    state = AL_PAUSED;
-                    break;
+                case AsyncSrcState::Reset: state = AL_INITIAL; statename = "AL_INITIAL"; break;
+                case AsyncSrcState::Stop: state = AL_STOPPED; statename = "AL_STOPPED"; break;
+                case AsyncSrcState::Play: state = AL_PLAYING; statename = "AL_PLAYING"; break;
+                case AsyncSrcState::Pause: state = AL_PAUSED; statename = "AL_PAUSED"; break;
                 }
+                if(batching)
+                {
+                    /* Don't add completions after this to ones before it. */
+                    completions.erase(evt.mId);
+                    add_event(AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT, evt.mId, state);
+                    return;
+                }
+                if(!context->mEventCb)
+                    return;
+
+                std::string msg{"Source ID " + std::to_string(evt.mId)};
+                msg += " state has changed to ";
+                msg += statename;
                 context->mEventCb(AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT, evt.mId, state,
                     static_cast<ALsizei>(msg.length()), msg.c_str(), context->mEventParam);
             };
-            auto proc_buffercomp = [context,enabledevts](AsyncBufferCompleteEvent &evt)
+            auto proc_buffercomp = [&](AsyncBufferCompleteEvent &evt)
             {
-                if(!context->mEventCb
-                    || !enabledevts.test(al::to_underlying(AsyncEnableBits::BufferCompleted)))
+                if(!enabledevts.test(al::to_underlying(AsyncEnableBits::BufferCompleted)))
+                    return;
+
+                /* Record when the buffers completed on the source before the
+                 * app hears about it, so it can be queried from the event.
+                 */
+                SetSourceCompletedClock(context, evt.mId, evt.mClockTime, evt.mSampleOffset);
+
+                if(batching)
+                {
+                    auto [iter, isnew] = completions.try_emplace(evt.mId, batch.size());
+                    if(isnew)
+                        add_event(AL_EVENT_TYPE_BUFFER_COMPLETED_SOFT, evt.mId, evt.mCount);
+                    else
+                        batch[iter->second].param += evt.mCount;
+                    return;
+                }
+                if(!context->mEventCb)
                     return;
 
                 std::string msg{std::to_string(evt.mCount)};
@@ -115,25 +139,145 @@ int EventThread(ALCcontext *context)
                 context->mEventCb(AL_EVENT_TYPE_BUFFER_COMPLETED_SOFT, evt.mId, evt.mCount,
                     static_cast<ALsizei>(msg.length()), msg.c_str(), context->mEventParam);
             };
-            auto proc_disconnect = [context,enabledevts](AsyncDisconnectEvent &evt)
+            auto proc_slotready = [&](AsyncEffectSlotReadyEvent &evt)
+            {
+                if(!enabledevts.test(al::to_underlying(AsyncEnableBits::EffectSlotReady)))
+                    return;
+
+                if(batching)
+                {
+                    add_event(AL_EVENT_TYPE_EFFECT_SLOT_READY_SOFT, evt.mId, 0);
+                    return;
+                }
+                if(!context->mEventCb)
+                    return;
+
+                std::string msg{"Effect slot ID " + std::to_string(evt.mId) + " is ready"};
+                context->mEventCb(AL_EVENT_TYPE_EFFECT_SLOT_READY_SOFT, evt.mId, 0,
+                    static_cast<ALsizei>(msg.length()), msg.c_str(), context->mEventParam);
+            };
+            auto proc_disconnect = [&](AsyncDisconnectEvent &evt)
             {
                 context->debugMessage(DebugSource::System, DebugType::Error, 0,
-                    DebugSeverity::High, evt.msg);
+                    DebugSeverity::High, evt.msg());
 
-                if(context->mEventCb
-                    && enabledevts.test(al::to_underlying(AsyncEnableBits::Disconnected)))
+                if(!enabledevts.test(al::to_underlying(AsyncEnableBits::Disconnected)))
+                    return;
+                if(batching)
+                    add_event(AL_EVENT_TYPE_DISCONNECTED_SOFT, 0, 0);
+                else if(context->mEventCb)
                     context->mEventCb(AL_EVENT_TYPE_DISCONNECTED_SOFT, 0, 0,
-                        static_cast<ALsizei>(evt.msg.length()), evt.msg.c_str(),
+                        static_cast<ALsizei>(std::strlen(evt.msg())), evt.msg(),
                         context->mEventParam);
             };
 
-            std::visit(overloaded{proc_srcstate, proc_buffercomp, proc_release, proc_disconnect,
-                proc_killthread}, event);
+            std::visit(overloaded{proc_srcstate, proc_buffercomp, proc_release,
+                proc_slotready, proc_disconnect, proc_killthread}, event);
         }
         std::destroy(evt_span.begin(), evt_span.end());
         ring->readAdvance(evt_span.size());
+
+        evt_data = ring->getReadVector().first;
+    }
+
+    if(!batch.empty() && context->mEventBatchCb)
+        context->mEventBatchCb(static_cast<ALsizei>(batch.size()), batch.data(),
+            context->mEventBatchParam);
+}
+
+
+/* A single thread dispatches the events for every context, so creating a
+ * context doesn't need to start a thread. It's started with the first context
+ * and left running.
+ */
+class EventDispatcher {
+    std::mutex mLock;
+    std::condition_variable mDoneCond;
+    std::vector<ALCcontext*> mContexts;
+    /* The context being processed, which can't be removed until it's done. */
+    ALCcontext *mCurrent{nullptr};
+    std::thread::id mThreadId;
+
+    void run();
+
+public:
+    al::semaphore mSem;
+
+    EventDispatcher()
+    {
+        std::thread thrd{&EventDispatcher::run, this};
+        mThreadId = thrd.get_id();
+        thrd.detach();
+    }
+
+    void add(ALCcontext *context)
+    {
+        std::lock_guard<std::mutex> dispatchlock{mLock};
+        mContexts.emplace_back(context);
+    }
+
+    void remove(ALCcontext *context)
+    {
+        std::unique_lock<std::mutex> dispatchlock{mLock};
+        mContexts.erase(std::remove(mContexts.begin(), mContexts.end(), context),
+            mContexts.end());
+
+        /* An event callback removing a context runs on the dispatcher itself,
+         * which has nothing to wait for.
+         */
+        if(std::this_thread::get_id() != mThreadId)
+            mDoneCond.wait(dispatchlock, [this,context]{ return mCurrent != context; });
+    }
+
+    /* Never destroyed, since the thread is left running. */
+    static auto Get() -> EventDispatcher&
+    {
+        static auto *dispatcher = new EventDispatcher{};
+        return *dispatcher;
+    }
+};
+
+void EventDispatcher::run()
+{
+    while(true)
+    {
+        /* With an event interval, a context's events are left to collect until
+         * it passes since its last batch.
+         */
+        auto nextwake = std::chrono::steady_clock::time_point::max();
+
+        std::unique_lock<std::mutex> dispatchlock{mLock};
+        for(size_t i{0};i < mContexts.size();++i)
+        {
+            ALCcontext *context{mContexts[i]};
+            if(context->mAsyncEvents->readSpace() == 0)
+                continue;
+
+            if(context->mEventInterval > std::chrono::milliseconds::zero()
+                && std::chrono::steady_clock::now() < context->mNextEventWake)
+            {
+                nextwake = std::min(nextwake, context->mNextEventWake);
+                continue;
+            }
+
+            mCurrent = context;
+            dispatchlock.unlock();
+
+            ProcessEvents(context);
+            context->mNextEventWake = std::chrono::steady_clock::now()
+                + context->mEventInterval;
+
+            dispatchlock.lock();
+            mCurrent = nullptr;
+            mDoneCond.notify_all();
+        }
+        dispatchlock.unlock();
+
+        if(nextwake != std::chrono::steady_clock::time_point::max())
+            std::this_thread::sleep_until(nextwake);
+        else
+            mSem.wait();
     }
-    return 0;
 }
 
 constexpr std::optional<AsyncEnableBits> GetEventType(ALenum etype) noexcept
@@ -143,6 +287,8 @@ constexpr std::optional<AsyncEnableBits> GetEventType(ALenum etype) noexcept
     case AL_EVENT_TYPE_BUFFER_COMPLETED_SOFT: return AsyncEnableBits::BufferCompleted;
     case AL_EVENT_TYPE_DISCONNECTED_SOFT: return AsyncEnableBits::Disconnected;
     case AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT: return AsyncEnableBits::SourceState;
+    case AL_EVENT_TYPE_EFFECT_SLOT_READY_SOFT: return AsyncEnableBits::EffectSlotReady;
+    case AL_EVENT_TYPE_BUFFER_UPLOADED_SOFT: return AsyncEnableBits::BufferUploaded;
     }
     return std::nullopt;
 }
@@ -153,7 +299,9 @@ constexpr std::optional<AsyncEnableBits> GetEventType(ALenum etype) noexcept
 void StartEventThrd(ALCcontext *ctx)
 {
     try {
-        ctx->mEventThread = std::thread{EventThread, ctx};
+        EventDispatcher &dispatcher = EventDispatcher::Get();
+        ctx->mEventSem = &dispatcher.mSem;
+        dispatcher.add(ctx);
     }
     catch(std::exception& e) {
         ERR("Failed to start event thread: %s\n", e.what());
@@ -165,21 +313,12 @@ void StartEventThrd(ALCcontext *ctx)
 
 void StopEventThrd(ALCcontext *ctx)
 {
-    RingBuffer *ring{ctx->mAsyncEvents.get()};
-    auto evt_data = ring->getWriteVector().first;
-    if(evt_data.len == 0)
-    {
-        do {
-            std::this_thread::yield();
-            evt_data = ring->getWriteVector().first;
-        } while(evt_data.len == 0);
-    }
-    std::ignore = InitAsyncEvent<AsyncKillThread>(evt_data.buf);
-    ring->writeAdvance(1);
-
-    ctx->mEventSem.post();
-    if(ctx->mEventThread.joinable())
-        ctx->mEventThread.join();
+    /* The mixer is done with the context, so once the dispatcher is too, any
+     * remaining events can be handled here.
+     */
+    if(ctx->mEventSem)
+        EventDispatcher::Get().remove(ctx);
+    ProcessEvents(ctx);
 }
 
 AL_API DECL_FUNCEXT3(void, alEventControl,SOFT, ALsizei,count, const ALenum*,types, ALboolean,enable)
@@ -238,3 +377,12 @@ FORCE_ALIGN void AL_APIENTRY alEventCallbackDirectSOFT(ALCcontext *context,
     context->mEventCb = callback;
     context->mEventParam = userParam;
 }
+
+AL_API DECL_FUNCEXT2(void, alEventBatchCallback,SOFT, ALEVENTBATCHPROCSOFT,callback, void*,userParam)
+FORCE_ALIGN void AL_APIENTRY alEventBatchCallbackDirectSOFT(ALCcontext *context,
+    ALEVENTBATCHPROCSOFT callback, void *userParam) noexcept
+{
+    std::lock_guard<std::mutex> eventlock{context->mEventCbLock};
+    context->mEventBatchCb = callback;
+    context->mEventBatchParam = userParam;
+}
@@ -25,12 +25,14 @@
 #include <algorithm>
 #include <cmath>
 #include <mutex>
+#include <shared_mutex>
 
 #include "AL/al.h"
 #include "AL/alc.h"
 #include "AL/efx.h"
 
 #include "alc/context.h"
+#include "alc/device.h"
 #include "alc/inprogext.h"
 #include "alspan.h"
 #include "direct_defs.h"
@@ -74,7 +76,7 @@ AL_API DECL_FUNC2(void, alListenerf, ALenum,param, ALfloat,value)
 FORCE_ALIGN void AL_APIENTRY alListenerfDirect(ALCcontext *context, ALenum param, ALfloat value) noexcept
 try {
     ALlistener &listener = context->mListener;
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
+    std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
     switch(param)
     {
     case AL_GAIN:
@@ -102,7 +104,7 @@ FORCE_ALIGN void AL_APIENTRY alListener3fDirect(ALCcontext *context, ALenum para
     ALfloat value2, ALfloat value3) noexcept
 try {
     ALlistener &listener = context->mListener;
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
+    std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
     switch(param)
     {
     case AL_POSITION:
@@ -151,7 +153,7 @@ try {
     }
 
     ALlistener &listener = context->mListener;
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
+    std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
     switch(param)
     {
     case AL_ORIENTATION:
@@ -174,7 +176,7 @@ catch(al::context_error& e) {
 AL_API DECL_FUNC2(void, alListeneri, ALenum,param, ALint,value)
 FORCE_ALIGN void AL_APIENTRY alListeneriDirect(ALCcontext *context, ALenum param, ALint /*value*/) noexcept
 try {
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
+    std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
     throw al::context_error{AL_INVALID_ENUM, "Invalid listener integer property 0x%x", param};
 }
 catch(al::context_error& e) {
@@ -194,7 +196,7 @@ try {
         return;
     }
 
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
+    std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
     throw al::context_error{AL_INVALID_ENUM, "Invalid listener 3-integer property 0x%x", param};
 }
 catch(al::context_error& e) {
@@ -228,7 +230,7 @@ try {
         return;
     }
 
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
+    std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
     throw al::context_error{AL_INVALID_ENUM, "Invalid listener integer-vector property 0x%x",
         param};
 }
@@ -245,7 +247,7 @@ try {
         throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
 
     ALlistener &listener = context->mListener;
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
+    std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
     switch(param)
     {
     case AL_GAIN: *value = listener.Gain; return;
@@ -265,7 +267,7 @@ try {
         throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
 
     ALlistener &listener = context->mListener;
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
+    std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
     switch(param)
     {
     case AL_POSITION:
@@ -308,7 +310,7 @@ try {
     }
 
     ALlistener &listener = context->mListener;
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
+    std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
     switch(param)
     {
     case AL_ORIENTATION:
@@ -329,7 +331,7 @@ AL_API DECL_FUNC2(void, alGetListeneri, ALenum,param, ALint*,value)
 FORCE_ALIGN void AL_APIENTRY alGetListeneriDirect(ALCcontext *context, ALenum param, ALint *value) noexcept
 try {
     if(!value) throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
+    std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
     throw al::context_error{AL_INVALID_ENUM, "Invalid listener integer property 0x%x", param};
 }
 catch(al::context_error& e) {
@@ -344,7 +346,7 @@ try {
         throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
 
     ALlistener &listener = context->mListener;
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
+    std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
     switch(param)
     {
     case AL_POSITION:
@@ -382,7 +384,7 @@ try {
     }
 
     ALlistener &listener = context->mListener;
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
+    std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
 
     static constexpr auto f2i = [](const float val) noexcept { return static_cast<ALint>(val); };
     switch(param)
@@ -400,3 +402,180 @@ try {
 catch(al::context_error& e) {
     context->setError(e.errorCode(), "%s", e.what());
 }
+
+
+namespace {
+
+/* Gets the given extra listener, after the first. Index 0 is the normal
+ * listener, which is handled by the caller.
+ */
+ALlistener &LookupExtraListener(ALCcontext *context, const ALuint index)
+{
+    if(index >= context->mALDevice->NumListeners)
+        throw al::context_error{AL_INVALID_VALUE, "Invalid listener index %u", index};
+    return context->mExtraListeners[index-1];
+}
+
+} // namespace
+
+AL_API DECL_FUNCEXT3(void, alListenerIndexedfv,SOFT, ALuint,index, ALenum,param, const ALfloat*,values)
+FORCE_ALIGN void AL_APIENTRY alListenerIndexedfvDirectSOFT(ALCcontext *context, ALuint index,
+    ALenum param, const ALfloat *values) noexcept
+try {
+    if(!values)
+        throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
+
+    if(index == 0)
+    {
+        switch(param)
+        {
+        case AL_GAIN:
+        case AL_POSITION:
+        case AL_ORIENTATION:
+            alListenerfvDirect(context, param, values);
+            return;
+        }
+        throw al::context_error{AL_INVALID_ENUM, "Invalid listener float-vector property 0x%x",
+            param};
+    }
+
+    std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
+    ALlistener &listener = LookupExtraListener(context, index);
+    switch(param)
+    {
+    case AL_GAIN:
+        if(!(*values >= 0.0f && std::isfinite(*values)))
+            throw al::context_error{AL_INVALID_VALUE, "Listener gain out of range"};
+        listener.Gain = *values;
+        UpdateProps(context);
+        return;
+
+    case AL_POSITION:
+    {
+        auto vals = al::span<const float,3>{values, 3_uz};
+        if(!std::all_of(vals.cbegin(), vals.cend(), [](float f) { return std::isfinite(f); }))
+            throw al::context_error{AL_INVALID_VALUE, "Listener position out of range"};
+        std::copy(vals.cbegin(), vals.cend(), listener.Position.begin());
+        UpdateProps(context);
+        return;
+    }
+
+    case AL_ORIENTATION:
+        auto vals = al::span<const float,6>{values, 6_uz};
+        if(!std::all_of(vals.cbegin(), vals.cend(), [](float f) { return std::isfinite(f); }))
+            throw al::context_error{AL_INVALID_VALUE, "Listener orientation out of range"};
+        /* AT then UP */
+        std::copy_n(vals.cbegin(), 3, listener.OrientAt.begin());
+        std::copy_n(vals.cbegin()+3, 3, listener.OrientUp.begin());
+        UpdateProps(context);
+        return;
+    }
+    throw al::context_error{AL_INVALID_ENUM, "Invalid listener float-vector property 0x%x", param};
+}
+catch(al::context_error& e) {
+    context->setError(e.errorCode(), "%s", e.what());
+}
+
+AL_API DECL_FUNCEXT3(void, alListenerIndexediv,SOFT, ALuint,index, ALenum,param, const ALint*,values)
+FORCE_ALIGN void AL_APIENTRY alListenerIndexedivDirectSOFT(ALCcontext *context, ALuint index,
+    ALenum param, const ALint *values) noexcept
+try {
+    if(!values)
+        throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
+
+    std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
+    if(index == 0)
+        throw al::context_error{AL_INVALID_ENUM, "Invalid listener integer-vector property 0x%x",
+            param};
+
+    ALlistener &listener = LookupExtraListener(context, index);
+    switch(param)
+    {
+    case AL_LISTENER_OUTPUT_SOFT:
+        auto vals = al::span<const int,2>{values, 2_uz};
+        if(!std::all_of(vals.cbegin(), vals.cend(), [](int i) { return i >= -1; }))
+            throw al::context_error{AL_INVALID_VALUE, "Listener output out of range"};
+        std::copy(vals.cbegin(), vals.cend(), listener.mOutput.begin());
+        UpdateProps(context);
+        return;
+    }
+    throw al::context_error{AL_INVALID_ENUM, "Invalid listener integer-vector property 0x%x",
+        param};
+}
+catch(al::context_error& e) {
+    context->setError(e.errorCode(), "%s", e.what());
+}
+
+AL_API DECL_FUNCEXT3(void, alGetListenerIndexedfv,SOFT, ALuint,index, ALenum,param, ALfloat*,values)
+FORCE_ALIGN void AL_APIENTRY alGetListenerIndexedfvDirectSOFT(ALCcontext *context, ALuint index,
+    ALenum param, ALfloat *values) noexcept
+try {
+    if(!values)
+        throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
+
+    if(index == 0)
+    {
+        switch(param)
+        {
+        case AL_GAIN:
+        case AL_POSITION:
+        case AL_ORIENTATION:
+            alGetListenerfvDirect(context, param, values);
+            return;
+        }
+        throw al::context_error{AL_INVALID_ENUM, "Invalid listener float-vector property 0x%x",
+            param};
+    }
+
+    std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
+    const ALlistener &listener = LookupExtraListener(context, index);
+    switch(param)
+    {
+    case AL_GAIN:
+        *values = listener.Gain;
+        return;
+
+    case AL_POSITION:
+        std::copy(listener.Position.cbegin(), listener.Position.cend(),
+            al::span<ALfloat,3>{values, 3_uz}.begin());
+        return;
+
+    case AL_ORIENTATION:
+        auto vals = al::span<ALfloat,6>{values, 6_uz};
+        /* AT then UP */
+        std::copy_n(listener.OrientAt.cbegin(), 3, vals.begin());
+        std::copy_n(listener.OrientUp.cbegin(), 3, vals.begin()+3);
+        return;
+    }
+    throw al::context_error{AL_INVALID_ENUM, "Invalid listener float-vector property 0x%x", param};
+}
+catch(al::context_error& e) {
+    context->setError(e.errorCode(), "%s", e.what());
+}
+
+AL_API DECL_FUNCEXT3(void, alGetListenerIndexediv,SOFT, ALuint,index, ALenum,param, ALint*,values)
+FORCE_ALIGN void AL_APIENTRY alGetListenerIndexedivDirectSOFT(ALCcontext *context, ALuint index,
+    ALenum param, ALint *values) noexcept
+try {
+    if(!values)
+        throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
+
+    std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
+    if(index == 0)
+        throw al::context_error{AL_INVALID_ENUM, "Invalid listener integer-vector property 0x%x",
+            param};
+
+    const ALlistener &listener = LookupExtraListener(context, index);
+    switch(param)
+    {
+    case AL_LISTENER_OUTPUT_SOFT:
+        std::copy(listener.mOutput.cbegin(), listener.mOutput.cend(),
+            al::span<ALint,2>{values, 2_uz}.begin());
+        return;
+    }
+    throw al::context_error{AL_INVALID_ENUM, "Invalid listener integer-vector property 0x%x",
+        param};
+}
+catch(al::context_error& e) {
+    context->setError(e.errorCode(), "%s", e.what());
+}
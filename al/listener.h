@@ -16,6 +16,9 @@ struct ALlistener {
     float Gain{1.0f};
     float mMetersPerUnit{AL_DEFAULT_METERS_PER_UNIT};
 
+    /* The output channels of an extra listener, or -1 for the default. */
+    std::array<int,2> mOutput{{-1, -1}};
+
     DISABLE_ALLOC
 };
 
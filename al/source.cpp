@@ -32,6 +32,7 @@
 #include <cmath>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <exception>
 #include <iterator>
 #include <limits>
@@ -92,7 +93,10 @@ using source_store_vector = std::vector<ALsource*>;
 using source_store_variant = std::variant<std::monostate,source_store_array,source_store_vector>;
 
 
-Voice *GetSourceVoice(ALsource *source, ALCcontext *context)
+/* Finds the source's voice without clearing a stale voice index, so it's safe
+ * to use with the source lock held shared.
+ */
+Voice *FindSourceVoice(const ALsource *source, ALCcontext *context)
 {
     auto voicelist = context->getVoicesSpan();
     ALuint idx{source->VoiceIdx};
@@ -103,25 +107,33 @@ Voice *GetSourceVoice(ALsource *source, ALCcontext *context)
         if(voice->mSourceID.load(std::memory_order_acquire) == sid)
             return voice;
     }
-    source->VoiceIdx = InvalidVoiceIndex;
     return nullptr;
 }
 
+Voice *GetSourceVoice(ALsource *source, ALCcontext *context)
+{
+    Voice *voice{FindSourceVoice(source, context)};
+    if(!voice) source->VoiceIdx = InvalidVoiceIndex;
+    return voice;
+}
+
 
 void UpdateSourceProps(const ALsource *source, Voice *voice, ALCcontext *context)
 {
-    /* Get an unused property container, or allocate a new one as needed. */
-    VoicePropsItem *props{context->mFreeVoiceProps.load(std::memory_order_acquire)};
-    if(!props)
+    /* Get an unused property container, or allocate a new one as needed.
+     * Property changes on different sources can get here concurrently, so
+     * only one may take from the free list at a time.
+     */
+    VoicePropsItem *props;
     {
-        context->allocVoiceProps();
-        props = context->mFreeVoiceProps.load(std::memory_order_acquire);
+        std::lock_guard<std::mutex> voicelock{context->mVoiceUpdateLock};
+        props = context->mFreeVoiceProps.pop();
+        if(!props)
+        {
+            context->allocVoiceProps();
+            props = context->mFreeVoiceProps.pop();
+        }
     }
-    VoicePropsItem *next;
-    do {
-        next = props->next.load(std::memory_order_relaxed);
-    } while(context->mFreeVoiceProps.compare_exchange_weak(props, next,
-        std::memory_order_acq_rel, std::memory_order_acquire) == false);
 
     props->Pitch = source->Pitch;
     props->Gain = source->Gain;
@@ -162,6 +174,8 @@ void UpdateSourceProps(const ALsource *source, Voice *voice, ALCcontext *context
     props->Radius = source->Radius;
     props->EnhWidth = source->EnhWidth;
     props->Panning = source->mPanningEnabled ? source->mPan : 0.0f;
+    props->DirectRoute = source->mDirectRoute;
+    props->Instancing = source->mInstancing;
 
     props->Direct.Gain = source->Direct.Gain;
     props->Direct.GainHF = source->Direct.GainHF;
@@ -191,10 +205,74 @@ void UpdateSourceProps(const ALsource *source, Voice *voice, ALCcontext *context
         /* If there was an unused update container, put it back in the
          * freelist.
          */
-        AtomicReplaceHead(context->mFreeVoiceProps, props);
+        context->mFreeVoiceProps.push(props);
     }
 }
 
+struct VoicePos {
+    int pos;
+    uint frac;
+    ALbufferQueueItem *bufferitem;
+};
+
+/* Gets the voice's current position, or the offset an in-place seek will move
+ * it to if the mixer hasn't applied it yet. As with reading the voice position
+ * directly, this needs to be synchronized with the mixer.
+ */
+VoicePos GetVoicePosition(const ALsource *source, const Voice *voice)
+{
+    if(voice->mPendingSeek.load(std::memory_order_relaxed)) UNLIKELY
+        return VoicePos{source->mSeekPosition, source->mSeekPositionFrac, source->mSeekBuffer};
+    return VoicePos{voice->mPosition.load(std::memory_order_relaxed),
+        voice->mPositionFrac.load(std::memory_order_relaxed),
+        static_cast<ALbufferQueueItem*>(voice->mCurrentBuffer.load(std::memory_order_relaxed))};
+}
+
+/* Gets the offset, in samples, of the given queue item from the start of the
+ * source's queue. A null item means the voice has played through the whole
+ * queue.
+ */
+int64_t GetQueueItemOffset(const ALsource *source, const VoiceBufferItem *item)
+{
+    if(source->mQueue.empty())
+        return 0;
+    const uint64_t start{source->mQueue.front().mSampleStart};
+    if(!item)
+    {
+        const auto &last = source->mQueue.back();
+        return static_cast<int64_t>(last.mSampleStart + last.mSampleLen - start);
+    }
+    return static_cast<int64_t>(static_cast<const ALbufferQueueItem*>(item)->mSampleStart
+        - start);
+}
+
+/* Counts the buffers of a non-looping streaming source that were played
+ * before the given current queue item.
+ */
+int CountProcessedBuffers(const ALsource *source, const VoiceBufferItem *current)
+{
+    if(source->state == AL_INITIAL)
+        return 0;
+    int played{0};
+    for(auto &item : source->mQueue)
+    {
+        if(&item == current)
+            break;
+        ++played;
+    }
+    return played;
+}
+
+/* Gets the first buffer in the source's queue, which has the format of the
+ * whole queue.
+ */
+const ALbuffer *GetQueueBufferFmt(const ALsource *source)
+{
+    auto iter = std::find_if(source->mQueue.cbegin(), source->mQueue.cend(),
+        [](const ALbufferQueueItem &item) noexcept { return item.mBuffer != nullptr; });
+    return (iter != source->mQueue.cend()) ? iter->mBuffer : nullptr;
+}
+
 /* GetSourceSampleOffset
  *
  * Gets the current read offset for the given Source, in 32.32 fixed-point
@@ -212,13 +290,14 @@ int64_t GetSourceSampleOffset(ALsource *Source, ALCcontext *context, nanoseconds
     do {
         refcount = device->waitForMix();
         *clocktime = device->getClockTime();
-        voice = GetSourceVoice(Source, context);
+        voice = FindSourceVoice(Source, context);
         if(voice)
         {
-            Current = voice->mCurrentBuffer.load(std::memory_order_relaxed);
+            const VoicePos vpos{GetVoicePosition(Source, voice)};
+            Current = vpos.bufferitem;
 
-            readPos  = int64_t{voice->mPosition.load(std::memory_order_relaxed)} << MixerFracBits;
-            readPos += voice->mPositionFrac.load(std::memory_order_relaxed);
+            readPos  = int64_t{vpos.pos} << MixerFracBits;
+            readPos += vpos.frac;
         }
         std::atomic_thread_fence(std::memory_order_acquire);
     } while(refcount != device->mMixCount.load(std::memory_order_relaxed));
@@ -226,11 +305,7 @@ int64_t GetSourceSampleOffset(ALsource *Source, ALCcontext *context, nanoseconds
     if(!voice)
         return 0;
 
-    for(auto &item : Source->mQueue)
-    {
-        if(&item == Current) break;
-        readPos += int64_t{item.mSampleLen} << MixerFracBits;
-    }
+    readPos += GetQueueItemOffset(Source, Current) << MixerFracBits;
     if(readPos > std::numeric_limits<int64_t>::max() >> (32-MixerFracBits))
         return std::numeric_limits<int64_t>::max();
     return readPos << (32-MixerFracBits);
@@ -252,13 +327,14 @@ double GetSourceSecOffset(ALsource *Source, ALCcontext *context, nanoseconds *cl
     do {
         refcount = device->waitForMix();
         *clocktime = device->getClockTime();
-        voice = GetSourceVoice(Source, context);
+        voice = FindSourceVoice(Source, context);
         if(voice)
         {
-            Current = voice->mCurrentBuffer.load(std::memory_order_relaxed);
+            const VoicePos vpos{GetVoicePosition(Source, voice)};
+            Current = vpos.bufferitem;
 
-            readPos  = int64_t{voice->mPosition.load(std::memory_order_relaxed)} << MixerFracBits;
-            readPos += voice->mPositionFrac.load(std::memory_order_relaxed);
+            readPos  = int64_t{vpos.pos} << MixerFracBits;
+            readPos += vpos.frac;
         }
         std::atomic_thread_fence(std::memory_order_acquire);
     } while(refcount != device->mMixCount.load(std::memory_order_relaxed));
@@ -266,69 +342,23 @@ double GetSourceSecOffset(ALsource *Source, ALCcontext *context, nanoseconds *cl
     if(!voice)
         return 0.0f;
 
-    const ALbuffer *BufferFmt{nullptr};
-    auto BufferList = Source->mQueue.cbegin();
-    while(BufferList != Source->mQueue.cend() && al::to_address(BufferList) != Current)
-    {
-        if(!BufferFmt) BufferFmt = BufferList->mBuffer;
-        readPos += int64_t{BufferList->mSampleLen} << MixerFracBits;
-        ++BufferList;
-    }
-    while(BufferList != Source->mQueue.cend() && !BufferFmt)
-    {
-        BufferFmt = BufferList->mBuffer;
-        ++BufferList;
-    }
+    readPos += GetQueueItemOffset(Source, Current) << MixerFracBits;
+    const ALbuffer *BufferFmt{GetQueueBufferFmt(Source)};
     ASSUME(BufferFmt != nullptr);
 
     return static_cast<double>(readPos) / double{MixerFracOne} / BufferFmt->mSampleRate;
 }
 
-/* GetSourceOffset
- *
- * Gets the current read offset for the given Source, in the appropriate format
- * (Bytes, Samples or Seconds). The offset is relative to the start of the
- * queue (not the start of the current buffer).
+/* Calculates the offset for the given source from its voice's position, in the
+ * appropriate format.
  */
 template<typename T>
-NOINLINE T GetSourceOffset(ALsource *Source, ALenum name, ALCcontext *context)
+T CalcSourceOffset(const ALsource *Source, ALenum name, const VoicePos &vpos)
 {
-    ALCdevice *device{context->mALDevice.get()};
-    const VoiceBufferItem *Current{};
-    int64_t readPos{};
-    uint readPosFrac{};
-    uint refcount;
-    Voice *voice;
-
-    do {
-        refcount = device->waitForMix();
-        voice = GetSourceVoice(Source, context);
-        if(voice)
-        {
-            Current = voice->mCurrentBuffer.load(std::memory_order_relaxed);
-
-            readPos = voice->mPosition.load(std::memory_order_relaxed);
-            readPosFrac = voice->mPositionFrac.load(std::memory_order_relaxed);
-        }
-        std::atomic_thread_fence(std::memory_order_acquire);
-    } while(refcount != device->mMixCount.load(std::memory_order_relaxed));
-
-    if(!voice)
-        return T{0};
-
-    const ALbuffer *BufferFmt{nullptr};
-    auto BufferList = Source->mQueue.cbegin();
-    while(BufferList != Source->mQueue.cend() && al::to_address(BufferList) != Current)
-    {
-        if(!BufferFmt) BufferFmt = BufferList->mBuffer;
-        readPos += BufferList->mSampleLen;
-        ++BufferList;
-    }
-    while(BufferList != Source->mQueue.cend() && !BufferFmt)
-    {
-        BufferFmt = BufferList->mBuffer;
-        ++BufferList;
-    }
+    int64_t readPos{vpos.pos};
+    const uint readPosFrac{vpos.frac};
+    readPos += GetQueueItemOffset(Source, vpos.bufferitem);
+    const ALbuffer *BufferFmt{GetQueueBufferFmt(Source)};
     ASSUME(BufferFmt != nullptr);
 
     T offset{};
@@ -378,6 +408,33 @@ NOINLINE T GetSourceOffset(ALsource *Source, ALenum name, ALCcontext *context)
     return offset;
 }
 
+/* GetSourceOffset
+ *
+ * Gets the current read offset for the given Source, in the appropriate format
+ * (Bytes, Samples or Seconds). The offset is relative to the start of the
+ * queue (not the start of the current buffer).
+ */
+template<typename T>
+NOINLINE T GetSourceOffset(ALsource *Source, ALenum name, ALCcontext *context)
+{
+    ALCdevice *device{context->mALDevice.get()};
+    VoicePos vpos{};
+    uint refcount;
+    Voice *voice;
+
+    do {
+        refcount = device->waitForMix();
+        voice = FindSourceVoice(Source, context);
+        if(voice)
+            vpos = GetVoicePosition(Source, voice);
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while(refcount != device->mMixCount.load(std::memory_order_relaxed));
+
+    if(!voice)
+        return T{0};
+    return CalcSourceOffset<T>(Source, name, vpos);
+}
+
 /* GetSourceLength
  *
  * Gets the length of the given Source's buffer queue, in the appropriate
@@ -432,12 +489,6 @@ NOINLINE T GetSourceLength(const ALsource *source, ALenum name)
 }
 
 
-struct VoicePos {
-    int pos;
-    uint frac;
-    ALbufferQueueItem *bufferitem;
-};
-
 /**
  * GetSampleOffset
  *
@@ -541,16 +592,17 @@ void InitVoice(Voice *voice, ALsource *source, ALbufferQueueItem *BufferList, AL
         voice->mFmtChannels = FmtSuperStereo;
     else
         voice->mFmtChannels = buffer->mChannels;
-    voice->mFmtType = buffer->mType;
-    voice->mFrameStep = buffer->channelsFromFmt();
-    voice->mBytesPerBlock = buffer->blockSizeFromFmt();
-    voice->mSamplesPerBlock = buffer->mBlockAlign;
+    voice->mFmtType = buffer->mixType();
+    voice->mFrameStep = buffer->mixChannels();
+    voice->mBytesPerBlock = buffer->mixBlockSize();
+    voice->mSamplesPerBlock = buffer->mixBlockAlign();
     voice->mAmbiLayout = IsUHJ(voice->mFmtChannels) ? AmbiLayout::FuMa : buffer->mAmbiLayout;
     voice->mAmbiScaling = IsUHJ(voice->mFmtChannels) ? AmbiScaling::UHJ : buffer->mAmbiScaling;
     voice->mAmbiOrder = (voice->mFmtChannels == FmtSuperStereo) ? 1 : buffer->mAmbiOrder;
 
     if(buffer->mCallback) voice->mFlags.set(VoiceIsCallback);
     else if(source->SourceType == AL_STATIC) voice->mFlags.set(VoiceIsStatic);
+    if(buffer->mIsUhjDecoded) voice->mFlags.set(VoiceIsUhjDecoded);
     voice->mNumCallbackBlocks = 0;
     voice->mCallbackBlockBase = 0;
 
@@ -608,46 +660,152 @@ void SendVoiceChanges(ALCcontext *ctx, VoiceChange *tail)
 }
 
 
-bool SetVoiceOffset(Voice *oldvoice, const VoicePos &vpos, ALsource *source, ALCcontext *context,
-    ALCdevice *device)
-{
-    /* First, get a free voice to start at the new offset. */
-    auto voicelist = context->getVoicesSpan();
-    Voice *newvoice{};
-    ALuint vidx{0};
-    for(Voice *voice : voicelist)
+/* Finds unused voices to play sources with. Voices the mixer last marked as
+ * unused are checked first, then the rest of the voices are scanned for any
+ * freed since. Each voice found needs to be taken (given a source or made
+ * pending) before looking for the next.
+ */
+class VoiceFinder {
+    al::span<Voice*> mVoices;
+    al::span<std::atomic<uint64_t>> mFreeMask;
+    size_t mMaskIdx{0};
+    uint64_t mMaskBits{0};
+    size_t mScanIdx{0};
+
+    static bool isUnused(const Voice *voice) noexcept
     {
-        if(voice->mPlayState.load(std::memory_order_acquire) == Voice::Stopped
+        return voice->mPlayState.load(std::memory_order_acquire) == Voice::Stopped
             && voice->mSourceID.load(std::memory_order_relaxed) == 0u
-            && voice->mPendingChange.load(std::memory_order_relaxed) == false)
-        {
-            newvoice = voice;
-            break;
-        }
-        ++vidx;
+            && voice->mPendingChange.load(std::memory_order_relaxed) == false;
     }
-    if(!newvoice) UNLIKELY
+
+public:
+    explicit VoiceFinder(ALCcontext *context) : mVoices{context->getVoicesSpan()}
     {
-        auto &allvoices = *context->mVoices.load(std::memory_order_relaxed);
-        if(allvoices.size() == voicelist.size())
-            context->allocVoices(1);
-        context->mActiveVoiceCount.fetch_add(1, std::memory_order_release);
-        voicelist = context->getVoicesSpan();
+        if(auto *freemask = context->mFreeVoiceMask.load(std::memory_order_relaxed))
+            mFreeMask = al::span{*freemask}.first(std::min(freemask->size(),
+                (mVoices.size()+63) / 64));
+        if(!mFreeMask.empty())
+            mMaskBits = mFreeMask[0].load(std::memory_order_relaxed);
+    }
 
-        vidx = 0;
-        for(Voice *voice : voicelist)
+    /** Counts the unused voices, up to the given limit. */
+    [[nodiscard]] auto count(size_t limit) const noexcept -> size_t
+    {
+        size_t total{0};
+        for(size_t idx{0};idx < mFreeMask.size() && total < limit;++idx)
         {
-            if(voice->mPlayState.load(std::memory_order_acquire) == Voice::Stopped
-                && voice->mSourceID.load(std::memory_order_relaxed) == 0u
-                && voice->mPendingChange.load(std::memory_order_relaxed) == false)
+            uint64_t bits{mFreeMask[idx].load(std::memory_order_relaxed)};
+            while(bits && total < limit)
             {
-                newvoice = voice;
+                const size_t vidx{idx*64 + static_cast<size_t>(al::countr_zero(bits))};
+                bits &= bits-1;
+                total += (vidx < mVoices.size() && isUnused(mVoices[vidx]));
+            }
+        }
+        if(total >= limit)
+            return total;
+
+        /* Not enough were marked, so count them all. */
+        total = 0;
+        for(const Voice *voice : mVoices)
+        {
+            total += isUnused(voice);
+            if(total == limit)
                 break;
+        }
+        return total;
+    }
+
+    /** Returns the index of the next unused voice, or the voice count if none. */
+    [[nodiscard]] auto next() noexcept -> size_t
+    {
+        while(mMaskIdx < mFreeMask.size())
+        {
+            while(mMaskBits)
+            {
+                const size_t vidx{mMaskIdx*64 + static_cast<size_t>(al::countr_zero(mMaskBits))};
+                mMaskBits &= mMaskBits-1;
+                if(vidx < mVoices.size() && isUnused(mVoices[vidx]))
+                    return vidx;
             }
-            ++vidx;
+            if(++mMaskIdx < mFreeMask.size())
+                mMaskBits = mFreeMask[mMaskIdx].load(std::memory_order_relaxed);
+        }
+        for(;mScanIdx < mVoices.size();++mScanIdx)
+        {
+            if(isUnused(mVoices[mScanIdx]))
+                return mScanIdx++;
         }
-        ASSUME(newvoice != nullptr);
+        return mVoices.size();
+    }
+};
+
+/* Seeks the voice to the given offset in place. The voice crossfades from its
+ * current offset to the new one itself, keeping its resampler, filter, and
+ * panning state, instead of a second voice starting at the new offset.
+ */
+bool SeekVoice(Voice *voice, const VoicePos &vpos, ALsource *source, ALCcontext *context)
+{
+    /* Report the new offset until the mixer takes it. */
+    source->mSeekPosition = vpos.pos;
+    source->mSeekPositionFrac = vpos.frac;
+    source->mSeekBuffer = vpos.bufferitem;
+    voice->mPendingSeek.store(true, std::memory_order_relaxed);
+    voice->mPendingChange.store(true, std::memory_order_relaxed);
+
+    std::unique_lock<std::mutex> voicelock{context->mVoiceUpdateLock};
+    VoiceChange *vchg{GetVoiceChanger(context)};
+    vchg->mOldVoice = nullptr;
+    vchg->mVoice = voice;
+    vchg->mSourceID = source->id;
+    vchg->mState = VChangeState::Seek;
+    vchg->mSeekPosition = vpos.pos;
+    vchg->mSeekPositionFrac = vpos.frac;
+    vchg->mSeekBuffer = vpos.bufferitem;
+    SendVoiceChanges(context, vchg);
+    voicelock.unlock();
+
+    /* If the voice still has a sourceID, it's still active and the seek will
+     * work on the next update.
+     */
+    if(voice->mSourceID.load(std::memory_order_acquire) != 0u) LIKELY
+        return true;
+
+    /* Otherwise, the voice stopped. If the mixer cleared the pending seek, it
+     * took the new offset before stopping. If not, the seek failed and the
+     * caller should store the source offset since it's stopped.
+     */
+    return !voice->mPendingSeek.exchange(false, std::memory_order_acq_rel);
+}
+
+bool SetVoiceOffset(Voice *oldvoice, const VoicePos &vpos, ALsource *source, ALCcontext *context,
+    ALCdevice *device)
+{
+    /* A voice with a decoder can't seek in place, since the decoder state is
+     * tied to the current offset.
+     */
+    if(!oldvoice->mDecoder)
+        return SeekVoice(oldvoice, vpos, source, context);
+
+    /* First, get a free voice to start at the new offset. Offsets may be set
+     * on different sources concurrently, so the voice list and voice changes
+     * need to be guarded.
+     */
+    std::unique_lock<std::mutex> voicelock{context->mVoiceUpdateLock};
+    auto voicelist = context->getVoicesSpan();
+    auto vidx = static_cast<ALuint>(VoiceFinder{context}.next());
+    if(vidx >= voicelist.size()) UNLIKELY
+    {
+        if(context->mAllocatedVoiceCount == voicelist.size())
+            context->allocVoices(1);
+        context->mActiveVoiceCount.fetch_add(1, std::memory_order_release);
+        voicelist = context->getVoicesSpan();
+
+        vidx = static_cast<ALuint>(VoiceFinder{context}.next());
+        ASSUME(vidx < voicelist.size());
     }
+    Voice *newvoice{voicelist[vidx]};
 
     /* Initialize the new voice and set its starting offset.
      * TODO: It might be better to have the VoiceChange processing copy the old
@@ -665,6 +823,8 @@ bool SetVoiceOffset(Voice *oldvoice, const VoicePos &vpos, ALsource *source, ALC
     if(vpos.pos > 0 || (vpos.pos == 0 && vpos.frac > 0)
         || vpos.bufferitem != &source->mQueue.front())
         newvoice->mFlags.set(VoiceIsFading);
+    /* The new voice is pending, so it won't be picked by anyone else. */
+    voicelock.unlock();
     InitVoice(newvoice, source, vpos.bufferitem, context, device);
     source->VoiceIdx = vidx;
 
@@ -673,12 +833,14 @@ bool SetVoiceOffset(Voice *oldvoice, const VoicePos &vpos, ALsource *source, ALC
      */
     oldvoice->mPendingChange.store(true, std::memory_order_relaxed);
 
+    voicelock.lock();
     VoiceChange *vchg{GetVoiceChanger(context)};
     vchg->mOldVoice = oldvoice;
     vchg->mVoice = newvoice;
     vchg->mSourceID = source->id;
     vchg->mState = VChangeState::Restart;
     SendVoiceChanges(context, vchg);
+    voicelock.unlock();
 
     /* If the old voice still has a sourceID, it's still active and the change-
      * over will work on the next update.
@@ -726,6 +888,14 @@ inline ALenum GetSourceState(ALsource *source, Voice *voice)
     return source->state;
 }
 
+/* Like GetSourceState, but doesn't update the stored state. */
+inline ALenum PeekSourceState(const ALsource *source, const Voice *voice)
+{
+    if(!voice && source->state == AL_PLAYING)
+        return AL_STOPPED;
+    return source->state;
+}
+
 
 bool EnsureSources(ALCcontext *context, size_t needed)
 {
@@ -1028,6 +1198,15 @@ enum SourceProp : ALenum {
     /* AL_SOFT_source_panning */
     srcPanningEnabledSOFT = AL_PANNING_ENABLED_SOFT,
     srcPanSOFT = AL_PAN_SOFT,
+
+    /* AL_SOFT_direct_routing */
+    srcDirectRouteSOFT = AL_DIRECT_ROUTE_SOFT,
+
+    /* AL_SOFT_source_instancing */
+    srcInstancingSOFT = AL_SOURCE_INSTANCING_SOFT,
+
+    /* AL_SOFT_buffer_completed_clock */
+    srcBufferCompletedClockSOFT = AL_BUFFER_COMPLETED_CLOCK_SOFT,
 };
 
 
@@ -1057,6 +1236,8 @@ constexpr ALuint IntValsByProp(ALenum prop)
     case AL_STEREO_MODE_SOFT:
     case AL_PANNING_ENABLED_SOFT:
     case AL_PAN_SOFT:
+    case AL_DIRECT_ROUTE_SOFT:
+    case AL_SOURCE_INSTANCING_SOFT:
         return 1;
 
     case AL_SOURCE_RADIUS: /*AL_BYTE_RW_OFFSETS_SOFT:*/
@@ -1100,6 +1281,7 @@ constexpr ALuint IntValsByProp(ALenum prop)
 
     case AL_SAMPLE_OFFSET_LATENCY_SOFT:
     case AL_SAMPLE_OFFSET_CLOCK_SOFT:
+    case AL_BUFFER_COMPLETED_CLOCK_SOFT:
     case AL_STEREO_ANGLES:
         break; /* i64 only */
     case AL_SEC_OFFSET_LATENCY_SOFT:
@@ -1136,6 +1318,8 @@ constexpr ALuint Int64ValsByProp(ALenum prop)
     case AL_STEREO_MODE_SOFT:
     case AL_PANNING_ENABLED_SOFT:
     case AL_PAN_SOFT:
+    case AL_DIRECT_ROUTE_SOFT:
+    case AL_SOURCE_INSTANCING_SOFT:
         return 1;
 
     case AL_SOURCE_RADIUS: /*AL_BYTE_RW_OFFSETS_SOFT:*/
@@ -1168,6 +1352,7 @@ constexpr ALuint Int64ValsByProp(ALenum prop)
 
     case AL_SAMPLE_OFFSET_LATENCY_SOFT:
     case AL_SAMPLE_OFFSET_CLOCK_SOFT:
+    case AL_BUFFER_COMPLETED_CLOCK_SOFT:
     case AL_STEREO_ANGLES:
         return 2;
 
@@ -1231,6 +1416,8 @@ constexpr ALuint FloatValsByProp(ALenum prop)
     case AL_SUPER_STEREO_WIDTH_SOFT:
     case AL_PANNING_ENABLED_SOFT:
     case AL_PAN_SOFT:
+    case AL_DIRECT_ROUTE_SOFT:
+    case AL_SOURCE_INSTANCING_SOFT:
         return 1;
 
     case AL_SOURCE_RADIUS: /*AL_BYTE_RW_OFFSETS_SOFT:*/
@@ -1261,6 +1448,7 @@ constexpr ALuint FloatValsByProp(ALenum prop)
         break; /* i/i64 only */
     case AL_SAMPLE_OFFSET_LATENCY_SOFT:
     case AL_SAMPLE_OFFSET_CLOCK_SOFT:
+    case AL_BUFFER_COMPLETED_CLOCK_SOFT:
         break; /* i64 only */
     }
     return 0;
@@ -1306,6 +1494,8 @@ constexpr ALuint DoubleValsByProp(ALenum prop)
     case AL_SUPER_STEREO_WIDTH_SOFT:
     case AL_PANNING_ENABLED_SOFT:
     case AL_PAN_SOFT:
+    case AL_DIRECT_ROUTE_SOFT:
+    case AL_SOURCE_INSTANCING_SOFT:
         return 1;
 
     case AL_SOURCE_RADIUS: /*AL_BYTE_RW_OFFSETS_SOFT:*/
@@ -1334,38 +1524,50 @@ constexpr ALuint DoubleValsByProp(ALenum prop)
         break; /* i/i64 only */
     case AL_SAMPLE_OFFSET_LATENCY_SOFT:
     case AL_SAMPLE_OFFSET_CLOCK_SOFT:
+    case AL_BUFFER_COMPLETED_CLOCK_SOFT:
         break; /* i64 only */
     }
     return 0;
 }
 
 
+/* Flags the source's properties to be updated with the next commit, adding it
+ * to the context's dirty list if it isn't already flagged.
+ */
+void MarkSourcePropsDirty(ALsource *source, ALCcontext *context)
+{
+    if(std::exchange(source->mPropsDirty, true))
+        return;
+    std::lock_guard<std::mutex> voicelock{context->mVoiceUpdateLock};
+    context->mDirtySources.emplace_back(source->id);
+}
+
 void UpdateSourceProps(ALsource *source, ALCcontext *context)
 {
-    if(!context->mDeferUpdates)
+    if(context->mDeferUpdates)
+        MarkSourcePropsDirty(source, context);
+    else if(Voice *voice{GetSourceVoice(source, context)})
+        UpdateSourceProps(source, voice, context);
+    else
     {
-        if(Voice *voice{GetSourceVoice(source, context)})
-        {
-            UpdateSourceProps(source, voice, context);
-            return;
-        }
+        /* Without a voice, the properties get applied when it's played. */
+        source->mPropsDirty = true;
     }
-    source->mPropsDirty = true;
 }
 #ifdef ALSOFT_EAX
 void CommitAndUpdateSourceProps(ALsource *source, ALCcontext *context)
 {
-    if(!context->mDeferUpdates)
+    if(context->mDeferUpdates)
+        MarkSourcePropsDirty(source, context);
+    else
     {
         if(context->hasEax())
             source->eaxCommit();
         if(Voice *voice{GetSourceVoice(source, context)})
-        {
             UpdateSourceProps(source, voice, context);
-            return;
-        }
+        else
+            source->mPropsDirty = true;
     }
-    source->mPropsDirty = true;
 }
 
 #else
@@ -1461,6 +1663,7 @@ NOINLINE void SetProperty(ALsource *const Source, ALCcontext *const Context, con
     case AL_SEC_OFFSET_LATENCY_SOFT:
     case AL_SAMPLE_OFFSET_CLOCK_SOFT:
     case AL_SEC_OFFSET_CLOCK_SOFT:
+    case AL_BUFFER_COMPLETED_CLOCK_SOFT:
         /* Query only */
         throw al::context_error{AL_INVALID_OPERATION, "Setting read-only source property 0x%04x",
             prop};
@@ -1612,7 +1815,7 @@ NOINLINE void SetProperty(ALsource *const Source, ALCcontext *const Context, con
             if(values[0])
             {
                 using UT = std::make_unsigned_t<T>;
-                std::lock_guard<std::mutex> buflock{device->BufferLock};
+                std::lock_guard<std::shared_mutex> buflock{device->BufferLock};
                 ALbuffer *buffer{LookupBuffer(device, static_cast<UT>(values[0]))};
                 if(!buffer)
                     throw al::context_error{AL_INVALID_VALUE, "Invalid buffer ID %s",
@@ -1623,17 +1826,21 @@ NOINLINE void SetProperty(ALsource *const Source, ALCcontext *const Context, con
                 if(buffer->mCallback && buffer->ref.load(std::memory_order_relaxed) != 0)
                     throw al::context_error{AL_INVALID_OPERATION,
                         "Setting already-set callback buffer %u", buffer->id};
+                if(buffer->mUploadFence != 0)
+                    throw al::context_error{AL_INVALID_OPERATION,
+                        "Setting buffer %u with a pending upload", buffer->id};
 
                 /* Add the selected buffer to a one-item queue */
                 std::deque<ALbufferQueueItem> newlist;
                 newlist.emplace_back();
                 newlist.back().mCallback = buffer->mCallback;
                 newlist.back().mUserData = buffer->mUserData;
-                newlist.back().mBlockAlign = buffer->mBlockAlign;
+                newlist.back().mCallbackRequest = buffer->mCallbackRequest;
+                newlist.back().mBlockAlign = buffer->mixBlockAlign();
                 newlist.back().mSampleLen = buffer->mSampleLen;
                 newlist.back().mLoopStart = buffer->mLoopStart;
                 newlist.back().mLoopEnd = buffer->mLoopEnd;
-                newlist.back().mSamples = buffer->mData;
+                newlist.back().mSamples = buffer->mixData();
                 newlist.back().mBuffer = buffer;
                 IncrementRef(buffer->ref);
 
@@ -1737,6 +1944,24 @@ NOINLINE void SetProperty(ALsource *const Source, ALCcontext *const Context, con
         Source->mPan = static_cast<float>(values[0]);
         return UpdateSourceProps(Source, Context);
 
+    case AL_DIRECT_ROUTE_SOFT:
+        if constexpr(std::is_integral_v<T>)
+        {
+            CheckSize(1);
+            CheckValue(values[0] >= -1 && values[0] < T{MaxOutputChannels});
+
+            Source->mDirectRoute = static_cast<int>(values[0]);
+            return UpdateSourceProps(Source, Context);
+        }
+        break;
+
+    case AL_SOURCE_INSTANCING_SOFT:
+        CheckSize(1);
+        CheckValue(values[0] == AL_FALSE || values[0] == AL_TRUE);
+
+        Source->mInstancing = values[0] != AL_FALSE;
+        return UpdateSourceProps(Source, Context);
+
     case AL_STEREO_ANGLES:
         CheckSize(2);
         if constexpr(std::is_floating_point_v<T>)
@@ -1903,6 +2128,7 @@ NOINLINE void SetProperty(ALsource *const Source, ALCcontext *const Context, con
             CheckValue(values[0] >= 0 && values[0] <= static_cast<int>(Resampler::Max));
 
             Source->mResampler = static_cast<Resampler>(values[0]);
+            PrepareResamplerTables(Source->mResampler);
             return UpdateSourceProps(Source, Context);
         }
         break;
@@ -2184,6 +2410,20 @@ NOINLINE void GetProperty(ALsource *const Source, ALCcontext *const Context, con
         values[0] = static_cast<T>(Source->mPan);
         return;
 
+    case AL_DIRECT_ROUTE_SOFT:
+        if constexpr(std::is_integral_v<T>)
+        {
+            CheckSize(1);
+            values[0] = Source->mDirectRoute;
+            return;
+        }
+        break;
+
+    case AL_SOURCE_INSTANCING_SOFT:
+        CheckSize(1);
+        values[0] = Source->mInstancing;
+        return;
+
     case AL_STEREO_ANGLES:
         if constexpr(std::is_floating_point_v<T>)
         {
@@ -2234,6 +2474,19 @@ NOINLINE void GetProperty(ALsource *const Source, ALCcontext *const Context, con
         }
         break;
 
+    case AL_BUFFER_COMPLETED_CLOCK_SOFT:
+        if constexpr(std::is_same_v<T,int64_t>)
+        {
+            /* Set by the event thread, so this doesn't need to wait on the
+             * mixer like the current offset does.
+             */
+            CheckSize(2);
+            values[0] = static_cast<int64_t>(Source->mCompletedSampleOffset);
+            values[1] = Source->mCompletedClockTime.count();
+            return;
+        }
+        break;
+
     case AL_SEC_OFFSET_LATENCY_SOFT:
         if constexpr(std::is_same_v<T,double>)
         {
@@ -2339,11 +2592,8 @@ NOINLINE void GetProperty(ALsource *const Source, ALCcontext *const Context, con
                 if(!Source->mQueue.empty())
                     BufferList = &Source->mQueue.front();
             }
-            else if(Voice *voice{GetSourceVoice(Source, Context)})
-            {
-                VoiceBufferItem *Current{voice->mCurrentBuffer.load(std::memory_order_relaxed)};
-                BufferList = static_cast<ALbufferQueueItem*>(Current);
-            }
+            else if(Voice *voice{FindSourceVoice(Source, Context)})
+                BufferList = GetVoicePosition(Source, voice).bufferitem;
             ALbuffer *buffer{BufferList ? BufferList->mBuffer : nullptr};
             values[0] = buffer ? static_cast<T>(buffer->id) : T{0};
             return;
@@ -2354,7 +2604,7 @@ NOINLINE void GetProperty(ALsource *const Source, ALCcontext *const Context, con
         if constexpr(std::is_integral_v<T>)
         {
             CheckSize(1);
-            values[0] = GetSourceState(Source, GetSourceVoice(Source, Context));
+            values[0] = PeekSourceState(Source, FindSourceVoice(Source, Context));
             return;
         }
         break;
@@ -2381,20 +2631,10 @@ NOINLINE void GetProperty(ALsource *const Source, ALCcontext *const Context, con
             }
             else
             {
-                int played{0};
-                if(Source->state != AL_INITIAL)
-                {
-                    const VoiceBufferItem *Current{nullptr};
-                    if(Voice *voice{GetSourceVoice(Source, Context)})
-                        Current = voice->mCurrentBuffer.load(std::memory_order_relaxed);
-                    for(auto &item : Source->mQueue)
-                    {
-                        if(&item == Current)
-                            break;
-                        ++played;
-                    }
-                }
-                values[0] = played;
+                const VoiceBufferItem *Current{nullptr};
+                if(Voice *voice{FindSourceVoice(Source, Context)})
+                    Current = GetVoicePosition(Source, voice).bufferitem;
+                values[0] = CountProcessedBuffers(Source, Current);
             }
             return;
         }
@@ -2516,30 +2756,21 @@ void StartSources(ALCcontext *const context, const al::span<ALsource*> srchandle
 
     /* Count the number of reusable voices. */
     auto voicelist = context->getVoicesSpan();
-    size_t free_voices{0};
-    for(const Voice *voice : voicelist)
-    {
-        free_voices += (voice->mPlayState.load(std::memory_order_acquire) == Voice::Stopped
-            && voice->mSourceID.load(std::memory_order_relaxed) == 0u
-            && voice->mPendingChange.load(std::memory_order_relaxed) == false);
-        if(free_voices == srchandles.size())
-            break;
-    }
+    const size_t free_voices{VoiceFinder{context}.count(srchandles.size())};
     if(srchandles.size() != free_voices) UNLIKELY
     {
         const size_t inc_amount{srchandles.size() - free_voices};
-        auto &allvoices = *context->mVoices.load(std::memory_order_relaxed);
-        if(inc_amount > allvoices.size() - voicelist.size())
+        const size_t allocated{context->mAllocatedVoiceCount};
+        if(inc_amount > allocated - voicelist.size())
         {
             /* Increase the number of voices to handle the request. */
-            context->allocVoices(inc_amount - (allvoices.size() - voicelist.size()));
+            context->allocVoices(inc_amount - (allocated - voicelist.size()));
         }
         context->mActiveVoiceCount.fetch_add(inc_amount, std::memory_order_release);
         voicelist = context->getVoicesSpan();
     }
 
-    auto voiceiter = voicelist.begin();
-    ALuint vidx{0};
+    VoiceFinder voicefinder{context};
     VoiceChange *tail{}, *cur{};
     for(ALsource *source : srchandles)
     {
@@ -2612,18 +2843,9 @@ void StartSources(ALCcontext *const context, const al::span<ALsource*> srchandle
         }
 
         /* Find the next unused voice to play this source with. */
-        for(;voiceiter != voicelist.end();++voiceiter,++vidx)
-        {
-            Voice *v{*voiceiter};
-            if(v->mPlayState.load(std::memory_order_acquire) == Voice::Stopped
-                && v->mSourceID.load(std::memory_order_relaxed) == 0u
-                && v->mPendingChange.load(std::memory_order_relaxed) == false)
-            {
-                voice = v;
-                break;
-            }
-        }
-        ASSUME(voice != nullptr);
+        const auto vidx = static_cast<ALuint>(voicefinder.next());
+        ASSUME(vidx < voicelist.size());
+        voice = voicelist[vidx];
 
         voice->mPosition.store(0, std::memory_order_relaxed);
         voice->mPositionFrac.store(0, std::memory_order_relaxed);
@@ -2670,7 +2892,7 @@ try {
         throw al::context_error{AL_INVALID_VALUE, "Generating %d sources", n};
     if(n <= 0) UNLIKELY return;
 
-    std::unique_lock<std::mutex> srclock{context->mSourceLock};
+    std::unique_lock<std::shared_mutex> srclock{context->mSourceLock};
     ALCdevice *device{context->mALDevice.get()};
 
     const al::span sids{sources, static_cast<ALuint>(n)};
@@ -2695,7 +2917,7 @@ try {
         throw al::context_error{AL_INVALID_VALUE, "Deleting %d sources", n};
     if(n <= 0) UNLIKELY return;
 
-    std::lock_guard<std::mutex> srclock{context->mSourceLock};
+    std::lock_guard<std::shared_mutex> srclock{context->mSourceLock};
 
     /* Check that all Sources are valid */
     auto validate_source = [context](const ALuint sid) -> bool
@@ -2721,7 +2943,7 @@ catch(al::context_error& e) {
 AL_API DECL_FUNC1(ALboolean, alIsSource, ALuint,source)
 FORCE_ALIGN ALboolean AL_APIENTRY alIsSourceDirect(ALCcontext *context, ALuint source) noexcept
 {
-    std::lock_guard<std::mutex> srclock{context->mSourceLock};
+    std::shared_lock<std::shared_mutex> srclock{context->mSourceLock};
     if(LookupSource(context, source) != nullptr)
         return AL_TRUE;
     return AL_FALSE;
@@ -2732,11 +2954,12 @@ AL_API DECL_FUNC3(void, alSourcef, ALuint,source, ALenum,param, ALfloat,value)
 FORCE_ALIGN void AL_APIENTRY alSourcefDirect(ALCcontext *context, ALuint source, ALenum param,
     ALfloat value) noexcept
 try {
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::shared_lock<std::shared_mutex> proplock{context->mPropLock};
+    std::shared_lock<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *Source{LookupSource(context, source)};
     if(!Source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
+    std::lock_guard<std::mutex> srcproplock{Source->mPropLock};
 
     SetProperty<float>(Source, context, static_cast<SourceProp>(param), {&value, 1u});
 }
@@ -2748,11 +2971,12 @@ AL_API DECL_FUNC5(void, alSource3f, ALuint,source, ALenum,param, ALfloat,value1,
 FORCE_ALIGN void AL_APIENTRY alSource3fDirect(ALCcontext *context, ALuint source, ALenum param,
     ALfloat value1, ALfloat value2, ALfloat value3) noexcept
 try {
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::shared_lock<std::shared_mutex> proplock{context->mPropLock};
+    std::shared_lock<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *Source{LookupSource(context, source)};
     if(!Source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
+    std::lock_guard<std::mutex> srcproplock{Source->mPropLock};
 
     const std::array fvals{value1, value2, value3};
     SetProperty<float>(Source, context, static_cast<SourceProp>(param), fvals);
@@ -2765,11 +2989,12 @@ AL_API DECL_FUNC3(void, alSourcefv, ALuint,source, ALenum,param, const ALfloat*,
 FORCE_ALIGN void AL_APIENTRY alSourcefvDirect(ALCcontext *context, ALuint source, ALenum param,
     const ALfloat *values) noexcept
 try {
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::shared_lock<std::shared_mutex> proplock{context->mPropLock};
+    std::shared_lock<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *Source{LookupSource(context, source)};
     if(!Source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
+    std::lock_guard<std::mutex> srcproplock{Source->mPropLock};
     if(!values)
         throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
 
@@ -2781,15 +3006,187 @@ catch(al::context_error& e) {
 }
 
 
+AL_API DECL_FUNCEXT4(void, alSourcesfv,SOFT, ALsizei,n, const ALuint*,sources, ALenum,param, const ALfloat*,values)
+FORCE_ALIGN void AL_APIENTRY alSourcesfvDirectSOFT(ALCcontext *context, ALsizei n,
+    const ALuint *sources, ALenum param, const ALfloat *values) noexcept
+try {
+    if(n < 0)
+        throw al::context_error{AL_INVALID_VALUE, "Setting %d sources", n};
+    if(n <= 0) UNLIKELY return;
+    if(!sources || !values)
+        throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
+
+    const ALuint count{FloatValsByProp(param)};
+    if(count == 0)
+        throw al::context_error{AL_INVALID_ENUM, "Invalid source float property 0x%04x",
+            param};
+
+    al::span sids{sources, static_cast<ALuint>(n)};
+    source_store_variant source_store;
+    const auto srchandles = [&source_store](size_t num) -> al::span<ALsource*>
+    {
+        if(num > std::tuple_size_v<source_store_array>)
+            return al::span{source_store.emplace<source_store_vector>(num)};
+        return al::span{source_store.emplace<source_store_array>()}.first(num);
+    }(sids.size());
+
+    std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
+
+    /* Defer the updates while setting each source, so they all get sent to
+     * the mixer together instead of one at a time. The source lock needs to
+     * be released before processing the updates.
+     */
+    const bool deferred{std::exchange(context->mDeferUpdates, true)};
+    try {
+        std::lock_guard<std::shared_mutex> sourcelock{context->mSourceLock};
+        auto lookup_src = [context](const ALuint sid) -> ALsource*
+        {
+            if(ALsource *src{LookupSource(context, sid)})
+                return src;
+            throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", sid};
+        };
+        std::transform(sids.cbegin(), sids.cend(), srchandles.begin(), lookup_src);
+
+        auto vals = al::span{values, size_t{count}*sids.size()};
+        for(ALsource *source : srchandles)
+        {
+            SetProperty(source, context, static_cast<SourceProp>(param), vals.first(count));
+            vals = vals.subspan(count);
+        }
+    }
+    catch(...) {
+        if(!deferred) context->processUpdates();
+        throw;
+    }
+    if(!deferred) context->processUpdates();
+}
+catch(al::context_error& e) {
+    context->setError(e.errorCode(), "%s", e.what());
+}
+
+AL_API DECL_FUNCEXT4(void, alGetSourcesiv,SOFT, ALsizei,n, const ALuint*,sources, ALenum,param, ALint*,values)
+FORCE_ALIGN void AL_APIENTRY alGetSourcesivDirectSOFT(ALCcontext *context, ALsizei n,
+    const ALuint *sources, ALenum param, ALint *values) noexcept
+try {
+    if(n < 0)
+        throw al::context_error{AL_INVALID_VALUE, "Getting %d sources", n};
+    if(n <= 0) UNLIKELY return;
+    if(!sources || !values)
+        throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
+
+    const ALuint count{IntValsByProp(param)};
+    if(count == 0)
+        throw al::context_error{AL_INVALID_ENUM, "Invalid source integer property 0x%04x",
+            param};
+
+    al::span sids{sources, static_cast<ALuint>(n)};
+    source_store_variant source_store;
+    const auto srchandles = [&source_store](size_t num) -> al::span<ALsource*>
+    {
+        if(num > std::tuple_size_v<source_store_array>)
+            return al::span{source_store.emplace<source_store_vector>(num)};
+        return al::span{source_store.emplace<source_store_array>()}.first(num);
+    }(sids.size());
+
+    std::shared_lock<std::shared_mutex> sourcelock{context->mSourceLock};
+    auto lookup_src = [context](const ALuint sid) -> ALsource*
+    {
+        if(ALsource *src{LookupSource(context, sid)})
+            return src;
+        throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", sid};
+    };
+    std::transform(sids.cbegin(), sids.cend(), srchandles.begin(), lookup_src);
+
+    auto vals = al::span{values, size_t{count}*sids.size()};
+    switch(param)
+    {
+    case AL_SOURCE_STATE:
+    case AL_BUFFERS_PROCESSED:
+    case AL_SEC_OFFSET:
+    case AL_SAMPLE_OFFSET:
+    case AL_BYTE_OFFSET:
+        break;
+
+    default:
+        for(ALsource *source : srchandles)
+        {
+            std::lock_guard<std::mutex> srcproplock{source->mPropLock};
+            GetProperty(source, context, static_cast<SourceProp>(param), vals.first(count));
+            vals = vals.subspan(count);
+        }
+        return;
+    }
+
+    /* The properties that depend on the voices' play state and position are
+     * read for all the sources between the same two mixes, rather than waiting
+     * on the mixer for each source.
+     */
+    struct VoiceSnapshot {
+        bool mHasVoice;
+        VoicePos mPos;
+    };
+    auto snapshots = std::vector<VoiceSnapshot>(srchandles.size());
+    ALCdevice *device{context->mALDevice.get()};
+    uint refcount;
+    do {
+        refcount = device->waitForMix();
+        std::transform(srchandles.cbegin(), srchandles.cend(), snapshots.begin(),
+            [context](const ALsource *source) -> VoiceSnapshot
+            {
+                if(Voice *voice{FindSourceVoice(source, context)})
+                    return VoiceSnapshot{true, GetVoicePosition(source, voice)};
+                return VoiceSnapshot{false, VoicePos{}};
+            });
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while(refcount != device->mMixCount.load(std::memory_order_relaxed));
+
+    auto snapshot = snapshots.cbegin();
+    for(ALsource *source : srchandles)
+    {
+        std::lock_guard<std::mutex> srcproplock{source->mPropLock};
+        switch(param)
+        {
+        case AL_SOURCE_STATE:
+            if(!snapshot->mHasVoice && source->state == AL_PLAYING)
+                vals[0] = AL_STOPPED;
+            else
+                vals[0] = source->state;
+            break;
+
+        case AL_BUFFERS_PROCESSED:
+            /* Buffers on a looping source are in a perpetual state of PENDING,
+             * so don't report any as PROCESSED.
+             */
+            if(source->Looping || source->SourceType != AL_STREAMING)
+                vals[0] = 0;
+            else
+                vals[0] = CountProcessedBuffers(source, snapshot->mPos.bufferitem);
+            break;
+
+        default:
+            vals[0] = snapshot->mHasVoice
+                ? CalcSourceOffset<ALint>(source, param, snapshot->mPos) : 0;
+            break;
+        }
+        vals = vals.subspan(1);
+        ++snapshot;
+    }
+}
+catch(al::context_error& e) {
+    context->setError(e.errorCode(), "%s", e.what());
+}
+
+
 AL_API DECL_FUNCEXT3(void, alSourced,SOFT, ALuint,source, ALenum,param, ALdouble,value)
 FORCE_ALIGN void AL_APIENTRY alSourcedDirectSOFT(ALCcontext *context, ALuint source, ALenum param,
     ALdouble value) noexcept
 try {
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::shared_lock<std::shared_mutex> proplock{context->mPropLock};
+    std::shared_lock<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *Source{LookupSource(context, source)};
     if(!Source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
+    std::lock_guard<std::mutex> srcproplock{Source->mPropLock};
 
     SetProperty<double>(Source, context, static_cast<SourceProp>(param), {&value, 1});
 }
@@ -2801,11 +3198,12 @@ AL_API DECL_FUNCEXT5(void, alSource3d,SOFT, ALuint,source, ALenum,param, ALdoubl
 FORCE_ALIGN void AL_APIENTRY alSource3dDirectSOFT(ALCcontext *context, ALuint source, ALenum param,
     ALdouble value1, ALdouble value2, ALdouble value3) noexcept
 try {
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::shared_lock<std::shared_mutex> proplock{context->mPropLock};
+    std::shared_lock<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *Source{LookupSource(context, source)};
     if(!Source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
+    std::lock_guard<std::mutex> srcproplock{Source->mPropLock};
 
     const std::array dvals{value1, value2, value3};
     SetProperty<double>(Source, context, static_cast<SourceProp>(param), dvals);
@@ -2818,11 +3216,12 @@ AL_API DECL_FUNCEXT3(void, alSourcedv,SOFT, ALuint,source, ALenum,param, const A
 FORCE_ALIGN void AL_APIENTRY alSourcedvDirectSOFT(ALCcontext *context, ALuint source, ALenum param,
     const ALdouble *values) noexcept
 try {
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::shared_lock<std::shared_mutex> proplock{context->mPropLock};
+    std::shared_lock<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *Source{LookupSource(context, source)};
     if(!Source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
+    std::lock_guard<std::mutex> srcproplock{Source->mPropLock};
     if(!values)
         throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
 
@@ -2838,11 +3237,12 @@ AL_API DECL_FUNC3(void, alSourcei, ALuint,source, ALenum,param, ALint,value)
 FORCE_ALIGN void AL_APIENTRY alSourceiDirect(ALCcontext *context, ALuint source, ALenum param,
     ALint value) noexcept
 try {
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::shared_lock<std::shared_mutex> proplock{context->mPropLock};
+    std::shared_lock<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *Source{LookupSource(context, source)};
     if(!Source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
+    std::lock_guard<std::mutex> srcproplock{Source->mPropLock};
 
     SetProperty<int>(Source, context, static_cast<SourceProp>(param), {&value, 1u});
 }
@@ -2854,11 +3254,12 @@ AL_API DECL_FUNC5(void, alSource3i, ALuint,buffer, ALenum,param, ALint,value1, A
 FORCE_ALIGN void AL_APIENTRY alSource3iDirect(ALCcontext *context, ALuint source, ALenum param,
     ALint value1, ALint value2, ALint value3) noexcept
 try {
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::shared_lock<std::shared_mutex> proplock{context->mPropLock};
+    std::shared_lock<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *Source{LookupSource(context, source)};
     if(!Source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
+    std::lock_guard<std::mutex> srcproplock{Source->mPropLock};
 
     const std::array ivals{value1, value2, value3};
     SetProperty<int>(Source, context, static_cast<SourceProp>(param), ivals);
@@ -2871,11 +3272,12 @@ AL_API DECL_FUNC3(void, alSourceiv, ALuint,source, ALenum,param, const ALint*,va
 FORCE_ALIGN void AL_APIENTRY alSourceivDirect(ALCcontext *context, ALuint source, ALenum param,
     const ALint *values) noexcept
 try {
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::shared_lock<std::shared_mutex> proplock{context->mPropLock};
+    std::shared_lock<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *Source{LookupSource(context, source)};
     if(!Source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
+    std::lock_guard<std::mutex> srcproplock{Source->mPropLock};
     if(!values)
         throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
 
@@ -2891,11 +3293,12 @@ AL_API DECL_FUNCEXT3(void, alSourcei64,SOFT, ALuint,source, ALenum,param, ALint6
 FORCE_ALIGN void AL_APIENTRY alSourcei64DirectSOFT(ALCcontext *context, ALuint source,
     ALenum param, ALint64SOFT value) noexcept
 try {
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::shared_lock<std::shared_mutex> proplock{context->mPropLock};
+    std::shared_lock<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *Source{LookupSource(context, source)};
     if(!Source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
+    std::lock_guard<std::mutex> srcproplock{Source->mPropLock};
 
     SetProperty<int64_t>(Source, context, static_cast<SourceProp>(param), {&value, 1u});
 }
@@ -2907,11 +3310,12 @@ AL_API DECL_FUNCEXT5(void, alSource3i64,SOFT, ALuint,source, ALenum,param, ALint
 FORCE_ALIGN void AL_APIENTRY alSource3i64DirectSOFT(ALCcontext *context, ALuint source,
     ALenum param, ALint64SOFT value1, ALint64SOFT value2, ALint64SOFT value3) noexcept
 try {
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::shared_lock<std::shared_mutex> proplock{context->mPropLock};
+    std::shared_lock<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *Source{LookupSource(context, source)};
     if(!Source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
+    std::lock_guard<std::mutex> srcproplock{Source->mPropLock};
 
     const std::array i64vals{value1, value2, value3};
     SetProperty<int64_t>(Source, context, static_cast<SourceProp>(param), i64vals);
@@ -2924,11 +3328,12 @@ AL_API DECL_FUNCEXT3(void, alSourcei64v,SOFT, ALuint,source, ALenum,param, const
 FORCE_ALIGN void AL_APIENTRY alSourcei64vDirectSOFT(ALCcontext *context, ALuint source,
     ALenum param, const ALint64SOFT *values) noexcept
 try {
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::shared_lock<std::shared_mutex> proplock{context->mPropLock};
+    std::shared_lock<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *Source{LookupSource(context, source)};
     if(!Source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
+    std::lock_guard<std::mutex> srcproplock{Source->mPropLock};
     if(!values)
         throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
 
@@ -2944,10 +3349,11 @@ AL_API DECL_FUNC3(void, alGetSourcef, ALuint,source, ALenum,param, ALfloat*,valu
 FORCE_ALIGN void AL_APIENTRY alGetSourcefDirect(ALCcontext *context, ALuint source, ALenum param,
     ALfloat *value) noexcept
 try {
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::shared_lock<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *Source{LookupSource(context, source)};
     if(!Source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
+    std::lock_guard<std::mutex> srcproplock{Source->mPropLock};
     if(!value)
         throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
 
@@ -2961,10 +3367,11 @@ AL_API DECL_FUNC5(void, alGetSource3f, ALuint,source, ALenum,param, ALfloat*,val
 FORCE_ALIGN void AL_APIENTRY alGetSource3fDirect(ALCcontext *context, ALuint source, ALenum param,
     ALfloat *value1, ALfloat *value2, ALfloat *value3) noexcept
 try {
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::shared_lock<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *Source{LookupSource(context, source)};
     if(!Source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
+    std::lock_guard<std::mutex> srcproplock{Source->mPropLock};
     if(!(value1 && value2 && value3))
         throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
 
@@ -2982,10 +3389,11 @@ AL_API DECL_FUNC3(void, alGetSourcefv, ALuint,source, ALenum,param, ALfloat*,val
 FORCE_ALIGN void AL_APIENTRY alGetSourcefvDirect(ALCcontext *context, ALuint source, ALenum param,
     ALfloat *values) noexcept
 try {
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::shared_lock<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *Source{LookupSource(context, source)};
     if(!Source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
+    std::lock_guard<std::mutex> srcproplock{Source->mPropLock};
     if(!values)
         throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
 
@@ -3001,10 +3409,11 @@ AL_API DECL_FUNCEXT3(void, alGetSourced,SOFT, ALuint,source, ALenum,param, ALdou
 FORCE_ALIGN void AL_APIENTRY alGetSourcedDirectSOFT(ALCcontext *context, ALuint source,
     ALenum param, ALdouble *value) noexcept
 try {
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::shared_lock<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *Source{LookupSource(context, source)};
     if(!Source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
+    std::lock_guard<std::mutex> srcproplock{Source->mPropLock};
     if(!value)
         throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
 
@@ -3018,10 +3427,11 @@ AL_API DECL_FUNCEXT5(void, alGetSource3d,SOFT, ALuint,source, ALenum,param, ALdo
 FORCE_ALIGN void AL_APIENTRY alGetSource3dDirectSOFT(ALCcontext *context, ALuint source,
     ALenum param, ALdouble *value1, ALdouble *value2, ALdouble *value3) noexcept
 try {
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::shared_lock<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *Source{LookupSource(context, source)};
     if(!Source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
+    std::lock_guard<std::mutex> srcproplock{Source->mPropLock};
     if(!(value1 && value2 && value3))
         throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
 
@@ -3039,10 +3449,11 @@ AL_API DECL_FUNCEXT3(void, alGetSourcedv,SOFT, ALuint,source, ALenum,param, ALdo
 FORCE_ALIGN void AL_APIENTRY alGetSourcedvDirectSOFT(ALCcontext *context, ALuint source,
     ALenum param, ALdouble *values) noexcept
 try {
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::shared_lock<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *Source{LookupSource(context, source)};
     if(!Source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
+    std::lock_guard<std::mutex> srcproplock{Source->mPropLock};
     if(!values)
         throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
 
@@ -3058,10 +3469,11 @@ AL_API DECL_FUNC3(void, alGetSourcei, ALuint,source, ALenum,param, ALint*,value)
 FORCE_ALIGN void AL_APIENTRY alGetSourceiDirect(ALCcontext *context, ALuint source, ALenum param,
     ALint *value) noexcept
 try {
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::shared_lock<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *Source{LookupSource(context, source)};
     if(!Source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
+    std::lock_guard<std::mutex> srcproplock{Source->mPropLock};
     if(!value)
         throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
 
@@ -3075,10 +3487,11 @@ AL_API DECL_FUNC5(void, alGetSource3i, ALuint,source, ALenum,param, ALint*,value
 FORCE_ALIGN void AL_APIENTRY alGetSource3iDirect(ALCcontext *context, ALuint source, ALenum param,
     ALint *value1, ALint *value2, ALint *value3) noexcept
 try {
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::shared_lock<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *Source{LookupSource(context, source)};
     if(!Source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
+    std::lock_guard<std::mutex> srcproplock{Source->mPropLock};
     if(!(value1 && value2 && value3))
         throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
     
@@ -3096,10 +3509,11 @@ AL_API DECL_FUNC3(void, alGetSourceiv, ALuint,source, ALenum,param, ALint*,value
 FORCE_ALIGN void AL_APIENTRY alGetSourceivDirect(ALCcontext *context, ALuint source, ALenum param,
     ALint *values) noexcept
 try {
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::shared_lock<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *Source{LookupSource(context, source)};
     if(!Source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
+    std::lock_guard<std::mutex> srcproplock{Source->mPropLock};
     if(!values)
         throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
 
@@ -3114,10 +3528,11 @@ catch(al::context_error& e) {
 AL_API DECL_FUNCEXT3(void, alGetSourcei64,SOFT, ALuint,source, ALenum,param, ALint64SOFT*,value)
 FORCE_ALIGN void AL_APIENTRY alGetSourcei64DirectSOFT(ALCcontext *context, ALuint source, ALenum param, ALint64SOFT *value) noexcept
 try {
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::shared_lock<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *Source{LookupSource(context, source)};
     if(!Source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
+    std::lock_guard<std::mutex> srcproplock{Source->mPropLock};
     if(!value)
         throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
 
@@ -3131,10 +3546,11 @@ AL_API DECL_FUNCEXT5(void, alGetSource3i64,SOFT, ALuint,source, ALenum,param, AL
 FORCE_ALIGN void AL_APIENTRY alGetSource3i64DirectSOFT(ALCcontext *context, ALuint source,
     ALenum param, ALint64SOFT *value1, ALint64SOFT *value2, ALint64SOFT *value3) noexcept
 try {
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::shared_lock<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *Source{LookupSource(context, source)};
     if(!Source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
+    std::lock_guard<std::mutex> srcproplock{Source->mPropLock};
     if(!(value1 && value2 && value3))
         throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
 
@@ -3152,10 +3568,11 @@ AL_API DECL_FUNCEXT3(void, alGetSourcei64v,SOFT, ALuint,source, ALenum,param, AL
 FORCE_ALIGN void AL_APIENTRY alGetSourcei64vDirectSOFT(ALCcontext *context, ALuint source,
     ALenum param, ALint64SOFT *values) noexcept
 try {
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::shared_lock<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *Source{LookupSource(context, source)};
     if(!Source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
+    std::lock_guard<std::mutex> srcproplock{Source->mPropLock};
     if(!values)
         throw al::context_error{AL_INVALID_VALUE, "NULL pointer"};
 
@@ -3170,7 +3587,7 @@ catch(al::context_error& e) {
 AL_API DECL_FUNC1(void, alSourcePlay, ALuint,source)
 FORCE_ALIGN void AL_APIENTRY alSourcePlayDirect(ALCcontext *context, ALuint source) noexcept
 try {
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::lock_guard<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *Source{LookupSource(context, source)};
     if(!Source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
@@ -3188,7 +3605,7 @@ try {
     if(start_time < 0)
         throw al::context_error{AL_INVALID_VALUE, "Invalid time point %" PRId64, start_time};
 
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::lock_guard<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *Source{LookupSource(context, source)};
     if(!Source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", source};
@@ -3216,7 +3633,7 @@ try {
         return al::span{source_store.emplace<source_store_array>()}.first(count);
     }(sids.size());
 
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::lock_guard<std::shared_mutex> sourcelock{context->mSourceLock};
     auto lookup_src = [context](const ALuint sid) -> ALsource*
     {
         if(ALsource *src{LookupSource(context, sid)})
@@ -3251,7 +3668,7 @@ try {
         return al::span{source_store.emplace<source_store_array>()}.first(count);
     }(sids.size());
 
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::lock_guard<std::shared_mutex> sourcelock{context->mSourceLock};
     auto lookup_src = [context](const ALuint sid) -> ALsource*
     {
         if(ALsource *src{LookupSource(context, sid)})
@@ -3288,7 +3705,7 @@ try {
         return al::span{source_store.emplace<source_store_array>()}.first(count);
     }(sids.size());
 
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::lock_guard<std::shared_mutex> sourcelock{context->mSourceLock};
     auto lookup_src = [context](const ALuint sid) -> ALsource*
     {
         if(ALsource *src{LookupSource(context, sid)})
@@ -3361,7 +3778,7 @@ try {
         return al::span{source_store.emplace<source_store_array>()}.first(count);
     }(sids.size());
 
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::lock_guard<std::shared_mutex> sourcelock{context->mSourceLock};
     auto lookup_src = [context](const ALuint sid) -> ALsource*
     {
         if(ALsource *src{LookupSource(context, sid)})
@@ -3421,7 +3838,7 @@ try {
         return al::span{source_store.emplace<source_store_array>()}.first(count);
     }(sids.size());
 
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::lock_guard<std::shared_mutex> sourcelock{context->mSourceLock};
     auto lookup_src = [context](const ALuint sid) -> ALsource*
     {
         if(ALsource *src{LookupSource(context, sid)})
@@ -3470,7 +3887,7 @@ try {
         throw al::context_error{AL_INVALID_VALUE, "Queueing %d buffers", nb};
     if(nb <= 0) UNLIKELY return;
 
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::lock_guard<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *source{LookupSource(context,src)};
     if(!source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", src};
@@ -3488,7 +3905,7 @@ try {
         if(BufferFmt) break;
     }
 
-    std::unique_lock<std::mutex> buflock{device->BufferLock};
+    std::unique_lock<std::shared_mutex> buflock{device->BufferLock};
     const auto bids = al::span{buffers, static_cast<ALuint>(nb)};
     const size_t NewListStart{source->mQueue.size()};
     try {
@@ -3513,8 +3930,14 @@ try {
                 if(buffer->MappedAccess != 0 && !(buffer->MappedAccess&AL_MAP_PERSISTENT_BIT_SOFT))
                     throw al::context_error{AL_INVALID_OPERATION,
                         "Queueing non-persistently mapped buffer %u", buffer->id};
+
+                if(buffer->mUploadFence != 0)
+                    throw al::context_error{AL_INVALID_OPERATION,
+                        "Queueing buffer %u with a pending upload", buffer->id};
             }
 
+            const uint64_t sampleStart{source->mQueue.empty() ? uint64_t{0u}
+                : source->mQueue.back().mSampleStart + source->mQueue.back().mSampleLen};
             source->mQueue.emplace_back();
             if(!BufferList)
                 BufferList = &source->mQueue.back();
@@ -3524,11 +3947,12 @@ try {
                 BufferList->mNext.store(&item, std::memory_order_relaxed);
                 BufferList = &item;
             }
+            BufferList->mSampleStart = sampleStart;
             if(!buffer) return;
-            BufferList->mBlockAlign = buffer->mBlockAlign;
+            BufferList->mBlockAlign = buffer->mixBlockAlign();
             BufferList->mSampleLen = buffer->mSampleLen;
             BufferList->mLoopEnd = buffer->mSampleLen;
-            BufferList->mSamples = buffer->mData;
+            BufferList->mSamples = buffer->mixData();
             BufferList->mBuffer = buffer;
             IncrementRef(buffer->ref);
 
@@ -3546,6 +3970,10 @@ try {
                     fmt_mismatch |= BufferFmt->mAmbiScaling != buffer->mAmbiScaling;
                 }
                 fmt_mismatch |= BufferFmt->mAmbiOrder != buffer->mAmbiOrder;
+                /* Voices mix the whole queue as one sample type, so decoded
+                 * and undecoded buffers can't be mixed.
+                 */
+                fmt_mismatch |= BufferFmt->mIsDecoded != buffer->mIsDecoded;
             }
             if(fmt_mismatch)
                 throw al::context_error{AL_INVALID_OPERATION,
@@ -3593,7 +4021,7 @@ try {
         throw al::context_error{AL_INVALID_VALUE, "Unqueueing %d buffers", nb};
     if(nb <= 0) UNLIKELY return;
 
-    std::lock_guard<std::mutex> sourcelock{context->mSourceLock};
+    std::lock_guard<std::shared_mutex> sourcelock{context->mSourceLock};
     ALsource *source{LookupSource(context,src)};
     if(!source)
         throw al::context_error{AL_INVALID_NAME, "Invalid source ID %u", src};
@@ -3610,7 +4038,7 @@ try {
     {
         VoiceBufferItem *Current{nullptr};
         if(Voice *voice{GetSourceVoice(source, context)})
-            Current = voice->mCurrentBuffer.load(std::memory_order_relaxed);
+            Current = GetVoicePosition(source, voice).bufferitem;
         for(auto &item : source->mQueue)
         {
             if(&item == Current)
@@ -3642,7 +4070,7 @@ catch(al::context_error& e) {
 
 AL_API void AL_APIENTRY alSourceQueueBufferLayersSOFT(ALuint, ALsizei, const ALuint*) noexcept
 {
-    ContextRef context{GetContextRef()};
+    auto context = GetCurrentContext();
     if(!context) UNLIKELY return;
 
     context->setError(AL_INVALID_OPERATION, "alSourceQueueBufferLayersSOFT not supported");
@@ -3680,9 +4108,32 @@ ALsource::~ALsource()
     std::for_each(Send.begin(), Send.end(), clear_send);
 }
 
+void UpdateDirtySourceProps(ALCcontext *context)
+{
+    /* Setting properties holds the source lock shared, so the dirty list can't
+     * change while it's held exclusively.
+     */
+    std::lock_guard<std::shared_mutex> srclock{context->mSourceLock};
+    for(const ALuint sid : context->mDirtySources)
+    {
+        /* The source may have been deleted since it was changed. A source
+         * without a voice stays flagged, to be applied when it's played.
+         */
+        ALsource *source{LookupSource(context, sid)};
+        if(!source || !source->mPropsDirty)
+            continue;
+        if(Voice *voice{GetSourceVoice(source, context)})
+        {
+            source->mPropsDirty = false;
+            UpdateSourceProps(source, voice, context);
+        }
+    }
+    context->mDirtySources.clear();
+}
+
 void UpdateAllSourceProps(ALCcontext *context)
 {
-    std::lock_guard<std::mutex> srclock{context->mSourceLock};
+    std::lock_guard<std::shared_mutex> srclock{context->mSourceLock};
     auto voicelist = context->getVoicesSpan();
     ALuint vidx{0u};
     for(Voice *voice : voicelist)
@@ -3698,9 +4149,20 @@ void UpdateAllSourceProps(ALCcontext *context)
     }
 }
 
+void SetSourceCompletedClock(ALCcontext *context, ALuint id, nanoseconds clocktime,
+    uint64_t sampleoffset)
+{
+    std::lock_guard<std::shared_mutex> srclock{context->mSourceLock};
+    if(ALsource *source{LookupSource(context, id)})
+    {
+        source->mCompletedClockTime = clocktime;
+        source->mCompletedSampleOffset = sampleoffset;
+    }
+}
+
 void ALsource::SetName(ALCcontext *context, ALuint id, std::string_view name)
 {
-    std::lock_guard<std::mutex> srclock{context->mSourceLock};
+    std::lock_guard<std::shared_mutex> srclock{context->mSourceLock};
 
     auto source = LookupSource(context, id);
     if(!source)
@@ -4154,7 +4616,7 @@ void ALsource::eax_update_direct_filter()
     Direct.HFReference = LowPassFreqRef;
     Direct.GainLF = 1.0f;
     Direct.LFReference = HighPassFreqRef;
-    mPropsDirty = true;
+    MarkSourcePropsDirty(this, mEaxAlContext);
 }
 
 void ALsource::eax_update_room_filters()
@@ -4548,18 +5010,47 @@ void ALsource::eax5_set(const EaxCall& call, Eax5Props& props)
 
 void ALsource::eax_set(const EaxCall& call)
 {
+    /* Applies the call to the deferred properties, returning whether they
+     * changed. Setting a property to the value it already has then doesn't
+     * cause the properties to be translated to EFX again on commit. A false
+     * difference (e.g. in padding) only costs an unnecessary translation.
+     */
+    auto set_deferred = [&call](auto &props, auto&& setter) -> bool
+    {
+        const auto old_props = props;
+        setter(call, props);
+        return std::memcmp(&old_props, &props, sizeof(props)) != 0;
+    };
+
     const auto eax_version = call.get_version();
+    auto changed = false;
     switch(eax_version)
     {
-    case 1: eax1_set(call, mEax1.d); break;
-    case 2: eax2_set(call, mEax2.d); break;
-    case 3: eax3_set(call, mEax3.d); break;
-    case 4: eax4_set(call, mEax4.d); break;
-    case 5: eax5_set(call, mEax5.d); break;
+    case 1:
+        changed = set_deferred(mEax1.d, &ALsource::eax1_set);
+        break;
+    case 2:
+        changed = set_deferred(mEax2.d, &ALsource::eax2_set);
+        break;
+    case 3:
+        changed = set_deferred(mEax3.d,
+            [this](const EaxCall &c, Eax3Props &props) { eax3_set(c, props); });
+        break;
+    case 4:
+        changed = set_deferred(mEax4.d,
+            [this](const EaxCall &c, Eax4Props &props) { eax4_set(c, props); });
+        break;
+    case 5:
+        changed = set_deferred(mEax5.d,
+            [this](const EaxCall &c, Eax5Props &props) { eax5_set(c, props); });
+        break;
     default: eax_fail_unknown_property_id();
     }
-    mEaxChanged = true;
-    mEaxVersion = eax_version;
+    if(changed || eax_version != mEaxVersion)
+    {
+        mEaxChanged = true;
+        mEaxVersion = eax_version;
+    }
 }
 
 void ALsource::eax_get_active_fx_slot_id(const EaxCall& call, const al::span<const GUID> src_ids)
@@ -4936,7 +5427,7 @@ void ALsource::eax_set_al_source_send(ALeffectslot *slot, size_t sendidx, const
         DecrementRef(oldslot->ref);
 
     send.Slot = slot;
-    mPropsDirty = true;
+    MarkSourcePropsDirty(this, mEaxAlContext);
 }
 
 void ALsource::eax_commit_active_fx_slots()
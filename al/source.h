@@ -2,10 +2,12 @@
 #define AL_SOURCE_H
 
 #include <array>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <deque>
 #include <limits>
+#include <mutex>
 #include <string_view>
 #include <utility>
 
@@ -84,11 +86,19 @@ struct ALsource {
     bool HeadRelative{false};
     bool Looping{false};
     DistanceModel mDistanceModel{DistanceModel::Default};
-    Resampler mResampler{ResamplerDefault};
+    Resampler mResampler{ResamplerDefault.load(std::memory_order_relaxed)};
     DirectMode DirectChannels{DirectMode::Off};
     SpatializeMode mSpatialize{SpatializeMode::Auto};
     SourceStereo mStereoMode{SourceStereo::Normal};
     bool mPanningEnabled{false};
+    /* The first real output channel to write the source's channels to, or -1
+     * for normal panning.
+     */
+    int mDirectRoute{-1};
+    /* Allows the mixer to share the resampled samples with other instancing
+     * sources playing the same data in lockstep.
+     */
+    bool mInstancing{false};
 
     bool DryGainHFAuto{true};
     bool WetGainAuto{true};
@@ -135,6 +145,14 @@ struct ALsource {
     double Offset{0.0};
     ALenum OffsetType{AL_NONE};
 
+    /**
+     * The offset of the last in-place seek on the source's voice, reported as
+     * the voice position until the mixer applies it.
+     */
+    int mSeekPosition{0};
+    ALuint mSeekPositionFrac{0};
+    ALbufferQueueItem *mSeekBuffer{nullptr};
+
     /** Source type (static, streaming, or undetermined) */
     ALenum SourceType{AL_UNDETERMINED};
 
@@ -154,6 +172,19 @@ struct ALsource {
     /** Self ID */
     ALuint id{0};
 
+    /**
+     * The device clock time and queue sample offset the last completed buffer
+     * ended at, from the last buffer completed event. Set by the event
+     * thread with the context's source lock held exclusively.
+     */
+    std::chrono::nanoseconds mCompletedClockTime{};
+    uint64_t mCompletedSampleOffset{0u};
+
+    /* Serializes property gets and sets on this source, which only hold the
+     * context's source lock shared.
+     */
+    std::mutex mPropLock;
+
 
     ALsource() noexcept;
     ~ALsource();
@@ -171,6 +202,7 @@ public:
     void eaxDispatch(const EaxCall& call);
     void eaxCommit();
     void eaxMarkAsChanged() noexcept { mEaxChanged = true; }
+    [[nodiscard]] bool eaxIsChanged() const noexcept { return mEaxChanged; }
 
     static ALsource* EaxLookupSource(ALCcontext& al_context, ALuint source_id) noexcept;
 
@@ -1052,6 +1084,9 @@ private:
 };
 
 void UpdateAllSourceProps(ALCcontext *context);
+void SetSourceCompletedClock(ALCcontext *context, ALuint id,
+    std::chrono::nanoseconds clocktime, uint64_t sampleoffset);
+void UpdateDirtySourceProps(ALCcontext *context);
 
 struct SourceSubList {
     uint64_t FreeMask{~0_u64};
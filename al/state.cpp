@@ -22,12 +22,14 @@
 
 #include "version.h"
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cmath>
 #include <deque>
 #include <mutex>
 #include <optional>
+#include <shared_mutex>
 #include <stdexcept>
 #include <string>
 #include <utility>
@@ -221,7 +223,7 @@ void GetValue(ALCcontext *context, ALenum pname, T *values)
         return;
 
     case AL_DEFAULT_RESAMPLER_SOFT:
-        *values = cast_value(al::to_underlying(ResamplerDefault));
+        *values = cast_value(al::to_underlying(ResamplerDefault.load(std::memory_order_relaxed)));
         return;
 
     case AL_DEBUG_LOGGED_MESSAGES_EXT:
@@ -275,7 +277,7 @@ void GetValue(ALCcontext *context, ALenum pname, T *values)
         if(eax_g_is_enabled)
         {
             auto device = context->mALDevice.get();
-            std::lock_guard<std::mutex> device_lock{device->BufferLock};
+            std::lock_guard<std::shared_mutex> device_lock{device->BufferLock};
             *values = cast_value(device->eax_x_ram_free_size);
             return;
         }
@@ -317,7 +319,7 @@ FORCE_ALIGN void AL_APIENTRY alEnableDirect(ALCcontext *context, ALenum capabili
     {
     case AL_SOURCE_DISTANCE_MODEL:
         {
-            std::lock_guard<std::mutex> proplock{context->mPropLock};
+            std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
             context->mSourceDistanceModel = true;
             UpdateProps(context);
         }
@@ -341,7 +343,7 @@ FORCE_ALIGN void AL_APIENTRY alDisableDirect(ALCcontext *context, ALenum capabil
     {
     case AL_SOURCE_DISTANCE_MODEL:
         {
-            std::lock_guard<std::mutex> proplock{context->mPropLock};
+            std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
             context->mSourceDistanceModel = false;
             UpdateProps(context);
         }
@@ -361,7 +363,7 @@ FORCE_ALIGN void AL_APIENTRY alDisableDirect(ALCcontext *context, ALenum capabil
 AL_API DECL_FUNC1(ALboolean, alIsEnabled, ALenum,capability)
 FORCE_ALIGN ALboolean AL_APIENTRY alIsEnabledDirect(ALCcontext *context, ALenum capability) noexcept
 {
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
+    std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
     switch(capability)
     {
     case AL_SOURCE_DISTANCE_MODEL: return context->mSourceDistanceModel ? AL_TRUE : AL_FALSE;
@@ -377,9 +379,9 @@ FORCE_ALIGN ALboolean AL_APIENTRY alIsEnabledDirect(ALCcontext *context, ALenum
 AL_API auto AL_APIENTRY Name##Ext(ALenum pname) noexcept -> R                 \
 {                                                                             \
     R value{};                                                                \
-    auto context = GetContextRef();                                           \
+    auto context = GetCurrentContext();                                       \
     if(!context) UNLIKELY return value;                                       \
-    Name##vDirect##Ext(GetContextRef().get(), pname, &value);                 \
+    Name##vDirect##Ext(context.get(), pname, &value);                        \
     return value;                                                             \
 }                                                                             \
 FORCE_ALIGN auto AL_APIENTRY Name##Direct##Ext(ALCcontext *context, ALenum pname) noexcept -> R \
@@ -496,7 +498,7 @@ FORCE_ALIGN void AL_APIENTRY alDopplerFactorDirect(ALCcontext *context, ALfloat
         context->setError(AL_INVALID_VALUE, "Doppler factor %f out of range", value);
     else
     {
-        std::lock_guard<std::mutex> proplock{context->mPropLock};
+        std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
         context->mDopplerFactor = value;
         UpdateProps(context);
     }
@@ -509,7 +511,7 @@ FORCE_ALIGN void AL_APIENTRY alSpeedOfSoundDirect(ALCcontext *context, ALfloat v
         context->setError(AL_INVALID_VALUE, "Speed of sound %f out of range", value);
     else
     {
-        std::lock_guard<std::mutex> proplock{context->mPropLock};
+        std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
         context->mSpeedOfSound = value;
         UpdateProps(context);
     }
@@ -520,7 +522,7 @@ FORCE_ALIGN void AL_APIENTRY alDistanceModelDirect(ALCcontext *context, ALenum v
 {
     if(auto model = DistanceModelFromALenum(value))
     {
-        std::lock_guard<std::mutex> proplock{context->mPropLock};
+        std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
         context->mDistanceModel = *model;
         if(!context->mSourceDistanceModel)
             UpdateProps(context);
@@ -533,14 +535,14 @@ FORCE_ALIGN void AL_APIENTRY alDistanceModelDirect(ALCcontext *context, ALenum v
 AL_API DECL_FUNCEXT(void, alDeferUpdates,SOFT)
 FORCE_ALIGN void AL_APIENTRY alDeferUpdatesDirectSOFT(ALCcontext *context) noexcept
 {
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
+    std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
     context->deferUpdates();
 }
 
 AL_API DECL_FUNCEXT(void, alProcessUpdates,SOFT)
 FORCE_ALIGN void AL_APIENTRY alProcessUpdatesDirectSOFT(ALCcontext *context) noexcept
 {
-    std::lock_guard<std::mutex> proplock{context->mPropLock};
+    std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
     context->processUpdates();
 }
 
@@ -563,7 +565,7 @@ FORCE_ALIGN const ALchar* AL_APIENTRY alGetStringiDirectSOFT(ALCcontext *context
 
 AL_API void AL_APIENTRY alDopplerVelocity(ALfloat value) noexcept
 {
-    ContextRef context{GetContextRef()};
+    auto context = GetCurrentContext();
     if(!context) UNLIKELY return;
 
     if(context->mContextFlags.test(ContextFlags::DebugBit)) UNLIKELY
@@ -576,7 +578,7 @@ AL_API void AL_APIENTRY alDopplerVelocity(ALfloat value) noexcept
         context->setError(AL_INVALID_VALUE, "Doppler velocity %f out of range", value);
     else
     {
-        std::lock_guard<std::mutex> proplock{context->mPropLock};
+        std::lock_guard<std::shared_mutex> proplock{context->mPropLock};
         context->mDopplerVelocity = value;
         UpdateProps(context.get());
     }
@@ -586,17 +588,12 @@ AL_API void AL_APIENTRY alDopplerVelocity(ALfloat value) noexcept
 void UpdateContextProps(ALCcontext *context)
 {
     /* Get an unused property container, or allocate a new one as needed. */
-    ContextProps *props{context->mFreeContextProps.load(std::memory_order_acquire)};
+    ContextProps *props{context->mFreeContextProps.pop()};
     if(!props)
     {
         context->allocContextProps();
-        props = context->mFreeContextProps.load(std::memory_order_acquire);
+        props = context->mFreeContextProps.pop();
     }
-    ContextProps *next;
-    do {
-        next = props->next.load(std::memory_order_relaxed);
-    } while(context->mFreeContextProps.compare_exchange_weak(props, next,
-        std::memory_order_acq_rel, std::memory_order_acquire) == false);
 
     /* Copy in current property values. */
     const auto &listener = context->mListener;
@@ -615,6 +612,13 @@ void UpdateContextProps(ALCcontext *context)
     props->SourceDistanceModel = context->mSourceDistanceModel;
     props->mDistanceModel = context->mDistanceModel;
 
+    std::transform(context->mExtraListeners.cbegin(), context->mExtraListeners.cend(),
+        props->ExtraListeners.begin(), [](const ALlistener &extra) noexcept
+        {
+            return ContextProps::ListenerProps{extra.Position, extra.OrientAt, extra.OrientUp,
+                extra.Gain, extra.mOutput};
+        });
+
     /* Set the new container for updating internal parameters. */
     props = context->mParams.ContextUpdate.exchange(props, std::memory_order_acq_rel);
     if(props)
@@ -622,6 +626,6 @@ void UpdateContextProps(ALCcontext *context)
         /* If there was an unused update container, put it back in the
          * freelist.
          */
-        AtomicReplaceHead(context->mFreeContextProps, props);
+        context->mFreeContextProps.push(props);
     }
 }
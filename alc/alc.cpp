@@ -50,9 +50,11 @@
 #include <mutex>
 #include <new>
 #include <optional>
+#include <shared_mutex>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -83,6 +85,8 @@
 #include "core/bformatdec.h"
 #include "core/bs2b.h"
 #include "core/context.h"
+#include "core/converter.h"
+#include "core/convolution_offload.h"
 #include "core/cpu_caps.h"
 #include "core/devformat.h"
 #include "core/device.h"
@@ -90,9 +94,15 @@
 #include "core/effectslot.h"
 #include "core/filters/nfc.h"
 #include "core/helpers.h"
+#include "core/hrtf.h"
 #include "core/mastering.h"
+#include "core/mixer/defs.h"
+#include "core/mixer_pool.h"
+#include "core/param_thread.h"
 #include "core/fpu_ctrl.h"
 #include "core/logging.h"
+#include "core/render_pool.h"
+#include "core/tracing.h"
 #include "core/uhjfilter.h"
 #include "core/voice.h"
 #include "core/voice_change.h"
@@ -103,6 +113,7 @@
 #include "inprogext.h"
 #include "intrusive_ptr.h"
 #include "opthelpers.h"
+#include "ringbuffer.h"
 #include "strutils.h"
 
 #include "backends/base.h"
@@ -156,6 +167,9 @@
 #ifdef HAVE_WAVE
 #include "backends/wave.h"
 #endif
+#ifdef HAVE_SHMEM
+#include "backends/shmem.h"
+#endif
 
 #ifdef ALSOFT_EAX
 #include "al/eax/api.h"
@@ -197,6 +211,10 @@ using float2 = std::array<float,2>;
 struct BackendInfo {
     const char *name;
     BackendFactory& (*getFactory)();
+
+    /* Set once the backend is initialized, which is only tried once. */
+    bool tried{false};
+    BackendFactory *factory{nullptr};
 };
 
 std::array BackendList{
@@ -250,11 +268,23 @@ std::array BackendList{
 #ifdef HAVE_WAVE
     BackendInfo{"wave", WaveBackendFactory::getFactory},
 #endif
+#ifdef HAVE_SHMEM
+    BackendInfo{"shm", ShmBackendFactory::getFactory},
+#endif
 };
 
 BackendFactory *PlaybackFactory{};
 BackendFactory *CaptureFactory{};
 
+/* The backends enabled by the drivers option, in order of priority. They
+ * aren't initialized until a playback or capture backend is first needed, so
+ * an app that only uses loopback devices doesn't load any.
+ */
+al::span<BackendInfo> EnabledBackends;
+std::mutex BackendInitLock;
+std::once_flag PlaybackInitOnce;
+std::once_flag CaptureInitOnce;
+
 
 [[nodiscard]] constexpr auto GetNoErrorString() noexcept { return "No Error"; }
 [[nodiscard]] constexpr auto GetInvalidDeviceString() noexcept { return "Invalid Device"; }
@@ -279,6 +309,21 @@ std::string alcCaptureDeviceList;
 std::string alcDefaultAllDevicesSpecifier;
 std::string alcCaptureDefaultDeviceSpecifier;
 
+/* Device enumeration results are cached while the backend can report devices
+ * being added and removed. A report invalidates the cached list, so the next
+ * query probes the backend again.
+ */
+struct DeviceListCache {
+    /* Incremented for each reported change. */
+    std::atomic<uint> mSerial{0u};
+    /* The serial the current list was probed for, if it's cached. Only
+     * accessed with the list lock held.
+     */
+    std::optional<uint> mCachedSerial;
+};
+DeviceListCache PlaybackListCache;
+DeviceListCache CaptureListCache;
+
 std::atomic<ALCenum> LastNullDeviceError{ALC_NO_ERROR};
 
 /* Flag to trap ALC device errors */
@@ -292,8 +337,16 @@ std::once_flag alc_config_once{};
  */
 bool SuspendDefers{true};
 
-/* Initial seed for dithering. */
-constexpr uint DitherRNGSeed{22222u};
+/* Thread pool for rendering batches of loopback devices, started on first
+ * use.
+ */
+std::once_flag LoopbackPoolOnce{};
+std::unique_ptr<RenderPool> LoopbackPool;
+
+/* Initial seeds for the dither generators. */
+constexpr std::array<uint,8> DitherRNGSeeds{
+    0x89868611u, 0xa5dcf7f0u, 0xfae6881bu, 0xf36bc202u,
+    0x7d69d3d5u, 0x1c23dd84u, 0xfe054bbfu, 0xd36faef6u};
 
 
 /************************************************
@@ -307,10 +360,22 @@ constexpr uint DitherRNGSeed{22222u};
         "ALC_EXT_direct_context "
         "ALC_EXT_EFX "
         "ALC_EXT_thread_local_context "
+        "ALC_SOFTX_backend_timing "
+        "ALC_SOFTX_buffer_share "
+        "ALC_SOFTX_capture_map "
+        "ALC_SOFTX_capture_notify "
+        "ALC_SOFTX_context_reserve "
         "ALC_SOFT_loopback "
         "ALC_SOFT_loopback_bformat "
+        "ALC_SOFTX_loopback_batch "
+        "ALC_SOFTX_loopback_planar "
+        "ALC_SOFTX_memory_usage "
+        "ALC_SOFTX_mixer_profile "
+        "ALC_SOFTX_output_xrun "
+        "ALC_SOFTX_reload_config "
         "ALC_SOFT_reopen_device "
-        "ALC_SOFT_system_events"sv;
+        "ALC_SOFT_system_events "
+        "ALC_SOFTX_hrtf_ready_event"sv;
 }
 [[nodiscard]] constexpr auto GetExtensionList() noexcept -> std::string_view
 {
@@ -323,15 +388,29 @@ constexpr uint DitherRNGSeed{22222u};
         "ALC_EXT_disconnect "
         "ALC_EXT_EFX "
         "ALC_EXT_thread_local_context "
+        "ALC_SOFTX_backend_timing "
+        "ALC_SOFTX_buffer_share "
+        "ALC_SOFTX_capture_map "
+        "ALC_SOFTX_capture_notify "
+        "ALC_SOFTX_context_reserve "
         "ALC_SOFT_device_clock "
+        "ALC_SOFTX_device_query "
         "ALC_SOFT_HRTF "
         "ALC_SOFT_loopback "
         "ALC_SOFT_loopback_bformat "
+        "ALC_SOFTX_loopback_batch "
+        "ALC_SOFTX_loopback_planar "
+        "ALC_SOFTX_memory_usage "
+        "ALC_SOFTX_mix_frequency "
+        "ALC_SOFTX_mixer_profile "
+        "ALC_SOFTX_output_xrun "
         "ALC_SOFT_output_limiter "
         "ALC_SOFT_output_mode "
         "ALC_SOFT_pause_device "
+        "ALC_SOFTX_reload_config "
         "ALC_SOFT_reopen_device "
-        "ALC_SOFT_system_events"sv;
+        "ALC_SOFT_system_events "
+        "ALC_SOFTX_hrtf_ready_event"sv;
 }
 
 constexpr int alcMajorVersion{1};
@@ -351,7 +430,23 @@ std::vector<ALCdevice*> DeviceList;
 std::vector<ALCcontext*> ContextList;
 
 std::recursive_mutex ListLock;
+/* Guards the context list separately, so validating a context handle (e.g.
+ * when making it current) only takes a shared lock, without serializing on
+ * ListLock. Changing the context list requires holding both.
+ */
+std::shared_mutex ContextListLock;
+
 
+std::optional<UhjQualityType> ParseUhjQuality(const std::string_view name)
+{
+    if(al::case_compare(name, "fir256"sv) == 0)
+        return UhjQualityType::FIR256;
+    if(al::case_compare(name, "fir512"sv) == 0)
+        return UhjQualityType::FIR512;
+    if(al::case_compare(name, "iir"sv) == 0)
+        return UhjQualityType::IIR;
+    return std::nullopt;
+}
 
 void alc_initconfig()
 {
@@ -427,6 +522,9 @@ void alc_initconfig()
 #elif defined(HAVE_SSE)
     capfilter |= CPU_CAP_SSE;
 #endif
+#ifdef HAVE_AVX2
+    capfilter |= CPU_CAP_AVX2;
+#endif
 #ifdef HAVE_NEON
     capfilter |= CPU_CAP_NEON;
 #endif
@@ -459,6 +557,8 @@ void alc_initconfig()
                 capfilter &= ~CPU_CAP_SSE3;
             else if(al::case_compare(entry, "sse4.1"sv) == 0)
                 capfilter &= ~CPU_CAP_SSE4_1;
+            else if(al::case_compare(entry, "avx2"sv) == 0)
+                capfilter &= ~CPU_CAP_AVX2;
             else if(al::case_compare(entry, "neon"sv) == 0)
                 capfilter &= ~CPU_CAP_NEON;
             else
@@ -473,11 +573,12 @@ void alc_initconfig()
             TRACE("Name: \"%s\"\n", cpuopt->mName.c_str());
         }
         const int caps{cpuopt->mCaps};
-        TRACE("Extensions:%s%s%s%s%s%s\n",
+        TRACE("Extensions:%s%s%s%s%s%s%s\n",
             ((capfilter&CPU_CAP_SSE)    ? ((caps&CPU_CAP_SSE)    ? " +SSE"    : " -SSE")    : ""),
             ((capfilter&CPU_CAP_SSE2)   ? ((caps&CPU_CAP_SSE2)   ? " +SSE2"   : " -SSE2")   : ""),
             ((capfilter&CPU_CAP_SSE3)   ? ((caps&CPU_CAP_SSE3)   ? " +SSE3"   : " -SSE3")   : ""),
             ((capfilter&CPU_CAP_SSE4_1) ? ((caps&CPU_CAP_SSE4_1) ? " +SSE4.1" : " -SSE4.1") : ""),
+            ((capfilter&CPU_CAP_AVX2)   ? ((caps&CPU_CAP_AVX2)   ? " +AVX2"   : " -AVX2")   : ""),
             ((capfilter&CPU_CAP_NEON)   ? ((caps&CPU_CAP_NEON)   ? " +NEON"   : " -NEON")   : ""),
             ((!capfilter) ? " -none-" : ""));
         CPUCapFlags = caps & capfilter;
@@ -487,6 +588,51 @@ void alc_initconfig()
         RTPrioLevel = *priopt;
     if(auto limopt = ConfigValueBool({}, {}, "rt-time-limit"sv))
         AllowRTTimeLimit = *limopt;
+    if(auto policyopt = ConfigValueStr({}, {}, "rt-policy"sv))
+    {
+        if(al::case_compare(*policyopt, "fifo"sv) == 0)
+            RTUseFifo = true;
+        else if(al::case_compare(*policyopt, "rr"sv) != 0)
+            ERR("Unhandled rt-policy: %s\n", policyopt->c_str());
+    }
+    if(auto cpusopt = ConfigValueStr({}, {}, "rt-cpus"sv))
+    {
+        /* Parse a list of CPU indices and ranges, e.g. "2,4-7". */
+        const char *next{cpusopt->c_str()};
+        while(*next != '\0')
+        {
+            char *end{};
+            const auto first = std::strtoul(next, &end, 10);
+            auto last = first;
+            if(end != next && *end == '-')
+            {
+                next = end+1;
+                last = std::strtoul(next, &end, 10);
+            }
+            if(end == next || (*end != ',' && *end != '\0') || last < first
+                || last-first >= 1024)
+            {
+                ERR("Invalid rt-cpus: %s\n", cpusopt->c_str());
+                RTCpuAffinity.clear();
+                break;
+            }
+            for(auto cpu = first;cpu <= last;++cpu)
+                RTCpuAffinity.emplace_back(static_cast<uint>(cpu));
+            next = (*end == ',') ? end+1 : end;
+        }
+    }
+    if(auto lockopt = ConfigValueBool({}, {}, "rt-memlock"sv))
+        RTLockMemory = *lockopt;
+
+    if(ConfigValueBool({}, {}, "hrtf-cache"sv).value_or(true))
+    {
+        auto cachepath = ConfigValueStr({}, {}, "hrtf-cache-path"sv);
+        HrtfCachePath = (cachepath && !cachepath->empty()) ? std::move(*cachepath)
+            : GetCachePath("openal/hrtf"sv);
+        TRACE("HRTF cache path: \"%s\"\n", HrtfCachePath.c_str());
+    }
+    if(auto shmopt = ConfigValueBool({}, {}, "hrtf-shared-memory"sv))
+        HrtfSharedMemory = *shmopt;
 
     {
         CompatFlagBitset compatflags{};
@@ -510,23 +656,15 @@ void alc_initconfig()
 
     if(auto uhjfiltopt = ConfigValueStr({}, "uhj"sv, "decode-filter"sv))
     {
-        if(al::case_compare(*uhjfiltopt, "fir256"sv) == 0)
-            UhjDecodeQuality = UhjQualityType::FIR256;
-        else if(al::case_compare(*uhjfiltopt, "fir512"sv) == 0)
-            UhjDecodeQuality = UhjQualityType::FIR512;
-        else if(al::case_compare(*uhjfiltopt, "iir"sv) == 0)
-            UhjDecodeQuality = UhjQualityType::IIR;
+        if(auto quality = ParseUhjQuality(*uhjfiltopt))
+            UhjDecodeQuality = *quality;
         else
             WARN("Unsupported uhj/decode-filter: %s\n", uhjfiltopt->c_str());
     }
     if(auto uhjfiltopt = ConfigValueStr({}, "uhj"sv, "encode-filter"sv))
     {
-        if(al::case_compare(*uhjfiltopt, "fir256"sv) == 0)
-            UhjEncodeQuality = UhjQualityType::FIR256;
-        else if(al::case_compare(*uhjfiltopt, "fir512"sv) == 0)
-            UhjEncodeQuality = UhjQualityType::FIR512;
-        else if(al::case_compare(*uhjfiltopt, "iir"sv) == 0)
-            UhjEncodeQuality = UhjQualityType::IIR;
+        if(auto quality = ParseUhjQuality(*uhjfiltopt))
+            UhjEncodeQuality = *quality;
         else
             WARN("Unsupported uhj/encode-filter: %s\n", uhjfiltopt->c_str());
     }
@@ -560,6 +698,30 @@ void alc_initconfig()
         const float valf{std::isfinite(*boostopt) ? std::clamp(*boostopt, -24.0f, 24.0f) : 0.0f};
         ReverbBoost *= std::pow(10.0f, valf / 20.0f);
     }
+    if(auto linesopt = ConfigValueUInt({}, "reverb"sv, "late-lines"sv))
+    {
+        if(*linesopt == 4 || *linesopt == 8 || *linesopt == 16)
+            ReverbLateLines = *linesopt;
+        else
+            ERR("Invalid reverb late-lines: %u (expected 4, 8, or 16)\n", *linesopt);
+    }
+    if(auto divopt = ConfigValueUInt({}, "reverb"sv, "rate-divisor"sv))
+    {
+        if(*divopt == 1 || *divopt == 2 || *divopt == 4)
+            ReverbRateDivisor = *divopt;
+        else
+            ERR("Invalid reverb rate-divisor: %u (expected 1, 2, or 4)\n", *divopt);
+    }
+    if(auto sizeopt = ConfigValueUInt({}, "pitch-shifter"sv, "stft-size"sv))
+    {
+        if(*sizeopt >= 256 && *sizeopt <= 8192 && al::popcount(*sizeopt) == 1)
+            PshifterStftSize = *sizeopt;
+        else
+            ERR("Invalid pitch-shifter stft-size: %u (expected a power of 2 from 256 to 8192)\n",
+                *sizeopt);
+    }
+    if(auto fastopt = ConfigValueBool({}, "pitch-shifter"sv, "fast-math"sv))
+        PshifterFastMath = *fastopt;
 
     auto BackendListEnd = BackendList.end();
     auto devopt = al::getenv("ALSOFT_DRIVERS");
@@ -619,39 +781,10 @@ void alc_initconfig()
             BackendListEnd = backendlist_cur;
     }
 
-    auto init_backend = [](BackendInfo &backend) -> void
-    {
-        if(PlaybackFactory && CaptureFactory)
-            return;
-
-        BackendFactory &factory = backend.getFactory();
-        if(!factory.init())
-        {
-            WARN("Failed to initialize backend \"%s\"\n", backend.name);
-            return;
-        }
-
-        TRACE("Initialized backend \"%s\"\n", backend.name);
-        if(!PlaybackFactory && factory.querySupport(BackendType::Playback))
-        {
-            PlaybackFactory = &factory;
-            TRACE("Added \"%s\" for playback\n", backend.name);
-        }
-        if(!CaptureFactory && factory.querySupport(BackendType::Capture))
-        {
-            CaptureFactory = &factory;
-            TRACE("Added \"%s\" for capture\n", backend.name);
-        }
-    };
-    std::for_each(BackendList.begin(), BackendListEnd, init_backend);
+    EnabledBackends = al::span{BackendList.begin(), BackendListEnd};
 
     LoopbackBackendFactory::getFactory().init();
 
-    if(!PlaybackFactory)
-        WARN("No playback backend available!\n");
-    if(!CaptureFactory)
-        WARN("No capture backend available!\n");
-
     if(auto exclopt = ConfigValueStr({}, {}, "excludefx"sv))
     {
         std::string_view exclude{*exclopt};
@@ -702,23 +835,100 @@ void alc_initconfig()
 inline void InitConfig()
 { std::call_once(alc_config_once, [](){alc_initconfig();}); }
 
+/* Initializes the enabled backends in order, until one supports the given
+ * type. Backends already tried for the other type aren't initialized again.
+ */
+void InitBackend(const BackendType type)
+{
+    const bool playback{type == BackendType::Playback};
+    BackendFactory *&factoryptr = playback ? PlaybackFactory : CaptureFactory;
+
+    std::lock_guard<std::mutex> initlock{BackendInitLock};
+    for(BackendInfo &backend : EnabledBackends)
+    {
+        if(!backend.tried)
+        {
+            backend.tried = true;
+            BackendFactory &factory = backend.getFactory();
+            if(!factory.init())
+            {
+                WARN("Failed to initialize backend \"%s\"\n", backend.name);
+                continue;
+            }
+            TRACE("Initialized backend \"%s\"\n", backend.name);
+            backend.factory = &factory;
+        }
+
+        if(backend.factory && backend.factory->querySupport(type))
+        {
+            factoryptr = backend.factory;
+            TRACE("Added \"%s\" for %s\n", backend.name, playback ? "playback" : "capture");
+            return;
+        }
+    }
+    WARN("No %s backend available!\n", playback ? "playback" : "capture");
+}
+
+auto GetPlaybackFactory() -> BackendFactory*
+{
+    InitConfig();
+    std::call_once(PlaybackInitOnce, InitBackend, BackendType::Playback);
+    return PlaybackFactory;
+}
+
+auto GetCaptureFactory() -> BackendFactory*
+{
+    InitConfig();
+    std::call_once(CaptureInitOnce, InitBackend, BackendType::Capture);
+    return CaptureFactory;
+}
+
 
 /************************************************
  * Device enumeration
  ************************************************/
+/* Gets the device names of the given type, or nothing if the previously
+ * returned list is still current.
+ */
+auto EnumerateDevices(BackendFactory &factory, const BackendType type)
+    -> std::optional<std::vector<std::string>>
+{
+    /* Without notifications for devices being added and removed, the backend
+     * needs to be probed each time.
+     */
+    if(factory.queryEventSupport(alc::EventType::DeviceAdded, type)
+            != alc::EventSupport::FullSupport
+        || factory.queryEventSupport(alc::EventType::DeviceRemoved, type)
+            != alc::EventSupport::FullSupport)
+        return factory.enumerate(type);
+
+    DeviceListCache &cache = (type == BackendType::Playback) ? PlaybackListCache
+        : CaptureListCache;
+    /* A change reported during the probe leaves the list marked stale, to be
+     * probed again on the next query.
+     */
+    const uint serial{cache.mSerial.load(std::memory_order_acquire)};
+    if(cache.mCachedSerial == serial)
+        return std::nullopt;
+
+    auto names = factory.enumerate(type);
+    cache.mCachedSerial = serial;
+    return names;
+}
+
 void ProbeAllDevicesList()
 {
-    InitConfig();
+    BackendFactory *factory{GetPlaybackFactory()};
 
     std::lock_guard<std::recursive_mutex> listlock{ListLock};
-    if(!PlaybackFactory)
+    if(!factory)
     {
         decltype(alcAllDevicesArray){}.swap(alcAllDevicesArray);
         decltype(alcAllDevicesList){}.swap(alcAllDevicesList);
     }
-    else
+    else if(auto names = EnumerateDevices(*factory, BackendType::Playback))
     {
-        alcAllDevicesArray = PlaybackFactory->enumerate(BackendType::Playback);
+        alcAllDevicesArray = std::move(*names);
         decltype(alcAllDevicesList){}.swap(alcAllDevicesList);
         if(alcAllDevicesArray.empty())
             alcAllDevicesList += '\0';
@@ -728,17 +938,17 @@ void ProbeAllDevicesList()
 }
 void ProbeCaptureDeviceList()
 {
-    InitConfig();
+    BackendFactory *factory{GetCaptureFactory()};
 
     std::lock_guard<std::recursive_mutex> listlock{ListLock};
-    if(!CaptureFactory)
+    if(!factory)
     {
         decltype(alcCaptureDeviceArray){}.swap(alcCaptureDeviceArray);
         decltype(alcCaptureDeviceList){}.swap(alcCaptureDeviceList);
     }
-    else
+    else if(auto names = EnumerateDevices(*factory, BackendType::Capture))
     {
-        alcCaptureDeviceArray = CaptureFactory->enumerate(BackendType::Capture);
+        alcCaptureDeviceArray = std::move(*names);
         decltype(alcCaptureDeviceList){}.swap(alcCaptureDeviceList);
         if(alcCaptureDeviceArray.empty())
             alcCaptureDeviceList += '\0';
@@ -977,7 +1187,8 @@ constexpr std::array X71Downmix{
 };
 
 
-std::unique_ptr<Compressor> CreateDeviceLimiter(const ALCdevice *device, const float threshold)
+std::unique_ptr<Compressor> CreateDeviceLimiter(const ALCdevice *device, const float threshold,
+    const uint controlDivisor, const bool truePeak)
 {
     static constexpr bool AutoKnee{true};
     static constexpr bool AutoAttack{true};
@@ -995,7 +1206,118 @@ std::unique_ptr<Compressor> CreateDeviceLimiter(const ALCdevice *device, const f
 
     return Compressor::Create(device->RealOut.Buffer.size(), static_cast<float>(device->Frequency),
         AutoKnee, AutoAttack, AutoRelease, AutoPostGain, AutoDeclip, LookAheadTime, HoldTime,
-        PreGainDb, PostGainDb, threshold, Ratio, KneeDb, AttackTime, ReleaseTime);
+        PreGainDb, PostGainDb, threshold, Ratio, KneeDb, AttackTime, ReleaseTime, controlDivisor,
+        truePeak);
+}
+
+/**
+ * Gets the dithering and output limiter settings for the device's output
+ * format from the config options.
+ */
+auto GetOutputSettings(ALCdevice *device) -> ALCdevice::OutputSettings
+{
+    ALCdevice::OutputSettings settings{};
+
+    if(device->getConfigValueBool({}, "dither"sv, true))
+    {
+        int depth{device->configValue<int>({}, "dither-depth"sv).value_or(0)};
+        if(depth <= 0)
+        {
+            switch(device->FmtType)
+            {
+            case DevFmtByte:
+            case DevFmtUByte:
+                depth = 8;
+                break;
+            case DevFmtShort:
+            case DevFmtUShort:
+                depth = 16;
+                break;
+            case DevFmtInt:
+            case DevFmtUInt:
+            case DevFmtFloat:
+                break;
+            }
+        }
+
+        if(depth > 0)
+        {
+            depth = std::clamp(depth, 2, 24);
+            settings.DitherDepth = std::pow(2.0f, static_cast<float>(depth-1));
+        }
+
+        if(auto shapeopt = device->configValue<std::string>({}, "dither-shape"sv))
+        {
+            if(al::case_compare(*shapeopt, "highpass"sv) == 0)
+                settings.DitherShaped = true;
+            else if(al::case_compare(*shapeopt, "flat"sv) != 0)
+                ERR("Unsupported dither-shape: %s\n", shapeopt->c_str());
+        }
+    }
+    if(!(settings.DitherDepth > 0.0f))
+        TRACE("Dithering disabled\n");
+    else
+        TRACE("Dithering enabled (%d-bit, %g, %s)\n",
+            float2int(std::log2(settings.DitherDepth)+0.5f)+1, settings.DitherDepth,
+            settings.DitherShaped ? "highpass" : "flat");
+
+    std::optional<bool> optlimit{device->mLimiterRequest};
+    if(!optlimit)
+        optlimit = device->configValue<bool>({}, "output-limiter");
+
+    /* If the gain limiter is unset, use the limiter for integer-based output
+     * (where samples must be clamped), and don't for floating-point (which can
+     * take unclamped samples).
+     */
+    if(!optlimit)
+    {
+        switch(device->FmtType)
+        {
+        case DevFmtByte:
+        case DevFmtUByte:
+        case DevFmtShort:
+        case DevFmtUShort:
+        case DevFmtInt:
+        case DevFmtUInt:
+            optlimit = true;
+            break;
+        case DevFmtFloat:
+            break;
+        }
+    }
+    if(!optlimit.value_or(false))
+        TRACE("Output limiter disabled\n");
+    else
+    {
+        float thrshld{1.0f};
+        switch(device->FmtType)
+        {
+        case DevFmtByte:
+        case DevFmtUByte:
+            thrshld = 127.0f / 128.0f;
+            break;
+        case DevFmtShort:
+        case DevFmtUShort:
+            thrshld = 32767.0f / 32768.0f;
+            break;
+        case DevFmtInt:
+        case DevFmtUInt:
+        case DevFmtFloat:
+            break;
+        }
+        if(settings.DitherDepth > 0.0f)
+            thrshld -= 1.0f / settings.DitherDepth;
+
+        settings.LimiterThreshold = std::log10(thrshld) * 20.0f;
+        settings.LimiterDivisor = device->configValue<uint>({}, "output-limiter-divisor"sv)
+            .value_or(1u);
+        settings.LimiterTruePeak = device->getConfigValueBool({}, "output-limiter-true-peak"sv,
+            false);
+        TRACE("Output limiter enabled, %.4fdB %s limit\n", *settings.LimiterThreshold,
+            settings.LimiterTruePeak ? "true-peak" : "sample-peak");
+    }
+
+    return settings;
 }
 
 /**
@@ -1012,15 +1334,18 @@ inline void UpdateClockBase(ALCdevice *device)
     auto clockBase = device->mClockBase.load(std::memory_order_relaxed);
 
     clockBase += nanoseconds{seconds{samplesDone}} / device->Frequency;
-    device->mClockBase.store(clockBase, std::memory_order_relaxed);
-    device->mSamplesDone.store(0, std::memory_order_relaxed);
+    device->setClock(clockBase, 0);
 }
 
+void StartHrtfLoad(ALCdevice *device, const uint rate);
+
 /**
  * Updates device parameters according to the attribute list (caller is
- * responsible for holding the list lock).
+ * responsible for holding the list lock). A playing device is only updated
+ * with new attributes, or when forced.
  */
-ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList)
+ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList,
+    const bool forceReset)
 {
     if(attrList.empty() && device->Type == DeviceType::Loopback)
     {
@@ -1031,9 +1356,11 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
     uint numMono{device->NumMonoSources};
     uint numStereo{device->NumStereoSources};
     uint numSends{device->NumAuxSends};
+    uint numListeners{device->NumListeners};
     std::optional<StereoEncoding> stereomode;
     std::optional<bool> optlimit;
     std::optional<uint> optsrate;
+    std::optional<uint> optmixrate;
     std::optional<DevFmtChannels> optchans;
     std::optional<DevFmtType> opttype;
     std::optional<DevAmbiLayout> optlayout;
@@ -1177,6 +1504,25 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
             ERR("Unexpected stereo-encoding: %s\n", encopt->c_str());
     }
 
+    device->mUhjEncodeQuality = UhjEncodeQuality;
+    device->mUhjDecodeQuality = UhjDecodeQuality;
+    if(auto uhjfiltopt = device->configValue<std::string>("uhj"sv, "encode-filter"sv))
+    {
+        if(auto quality = ParseUhjQuality(*uhjfiltopt))
+            device->mUhjEncodeQuality = *quality;
+    }
+    if(auto uhjfiltopt = device->configValue<std::string>("uhj"sv, "decode-filter"sv))
+    {
+        if(auto quality = ParseUhjQuality(*uhjfiltopt))
+            device->mUhjDecodeQuality = *quality;
+    }
+
+    if(auto mixfreqopt = device->configValue<uint>({}, "mix-frequency"sv))
+    {
+        if(*mixfreqopt > 0)
+            optmixrate = *mixfreqopt;
+    }
+
     // Check for app-specified attributes
     if(!attrList.empty())
     {
@@ -1203,6 +1549,13 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
                 freqAttr = attrList[attrIdx + 1];
                 break;
 
+            case ATTRIBUTE(ALC_MIX_FREQUENCY_SOFT)
+                if(attrList[attrIdx + 1] > 0)
+                    optmixrate = static_cast<uint>(attrList[attrIdx + 1]);
+                else
+                    optmixrate = std::nullopt;
+                break;
+
             case ATTRIBUTE(ALC_AMBISONIC_LAYOUT_SOFT)
                 if(device->Type == DeviceType::Loopback)
                     optlayout = DevAmbiLayoutFromEnum(attrList[attrIdx + 1]);
@@ -1234,6 +1587,11 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
                 else numSends = std::min(numSends, uint{MaxSendCount});
                 break;
 
+            case ATTRIBUTE(ALC_MAX_LISTENERS_SOFT)
+                numListeners = static_cast<uint>(std::clamp(attrList[attrIdx + 1], 1,
+                    int{MaxListenerCount}));
+                break;
+
             case ATTRIBUTE(ALC_HRTF_SOFT)
                 if(attrList[attrIdx + 1] == ALC_FALSE)
                     opthrtf = false;
@@ -1358,23 +1716,80 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
                 optsrate = static_cast<uint>(freqAttr);
             }
         }
+    }
 
-        /* If a context is already running on the device, stop playback so the
-         * device attributes can be updated.
-         */
-        if(device->mDeviceState == DeviceState::Playing)
+    if(device->mDeviceState == DeviceState::Playing && attrList.empty() && !forceReset)
+        return ALC_NO_ERROR;
+
+    /*************************************************************************
+     * Get the device format request
+     */
+
+    DeviceFormatRequest request{};
+    if(device->Type == DeviceType::Loopback)
+    {
+        request.mFrequency = *optsrate;
+        request.mChannels = *optchans;
+        request.mType = *opttype;
+        if(request.mChannels == DevFmtAmbi3D)
         {
-            device->Backend->stop();
-            device->mDeviceState = DeviceState::Unprepared;
+            request.mAmbiOrder = aorder;
+            request.mAmbiLayout = *optlayout;
+            request.mAmbiScale = *optscale;
         }
+        request.mFrequencyRequest = true;
+        request.mChannelsRequest = true;
+        request.mTypeRequest = true;
+    }
+    else
+    {
+        request.mType = opttype.value_or(DevFmtTypeDefault);
+        request.mChannels = optchans.value_or(DevFmtChannelsDefault);
+        request.mBufferSize = buffer_size;
+        request.mUpdateSize = period_size;
+        request.mFrequency = optsrate.value_or(DefaultOutputRate);
+        request.mFrequencyRequest = optsrate.has_value();
+        request.mChannelsRequest = optchans.has_value();
+        request.mTypeRequest = opttype.has_value();
 
-        UpdateClockBase(device);
+        if(request.mChannels == DevFmtAmbi3D)
+        {
+            request.mAmbiOrder = std::clamp(aorder, 1u, uint{MaxAmbiOrder});
+            request.mAmbiLayout = optlayout.value_or(DevAmbiLayout::Default);
+            request.mAmbiScale = optscale.value_or(DevAmbiScaling::Default);
+            if(request.mAmbiOrder > 3
+                && (request.mAmbiLayout == DevAmbiLayout::FuMa
+                    || request.mAmbiScale == DevAmbiScaling::FuMa))
+            {
+                ERR("FuMa is incompatible with %d%s order ambisonics (up to 3rd order only)\n",
+                    request.mAmbiOrder, GetCounterSuffix(request.mAmbiOrder));
+                request.mAmbiOrder = 3;
+            }
+        }
     }
 
+    /* If the device is playing and the backend would get the same format as
+     * before, keep it playing and hold the output while the mixing state is
+     * rebuilt. This avoids the gap from stopping and restarting the backend.
+     * Otherwise stop playback so the backend can be reset.
+     */
+    bool resetInPlace{false};
     if(device->mDeviceState == DeviceState::Playing)
-        return ALC_NO_ERROR;
+    {
+        if(device->Type != DeviceType::Loopback && device->mFormatRequest == request)
+        {
+            device->holdOutput();
+            resetInPlace = true;
+        }
+        else
+        {
+            device->Backend->stop();
+            device->mDeviceState = DeviceState::Unprepared;
+        }
+    }
 
-    device->mDeviceState = DeviceState::Unprepared;
+    if(!resetInPlace)
+        device->mDeviceState = DeviceState::Unprepared;
     device->AvgSpeakerDist = 0.0f;
     device->mNFCtrlFilter = NfcFilter{};
     device->mUhjEncoder = nullptr;
@@ -1383,7 +1798,14 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
     device->PostProcess = nullptr;
 
     device->Limiter = nullptr;
+    device->clearOutputUpdates();
+    device->mOutputConverter = nullptr;
+    device->mOutputBuffer.clear();
+    device->mOutputOffset = 0;
+    device->mOutputCount = 0;
     device->ChannelDelays = nullptr;
+    device->mMixerPool = nullptr;
+    device->mParamThread = nullptr;
 
     std::fill(std::begin(device->HrtfAccumData), std::end(device->HrtfAccumData), float2{});
 
@@ -1400,7 +1822,9 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
     device->FixedLatency = nanoseconds::zero();
 
     device->DitherDepth = 0.0f;
-    device->DitherSeed = DitherRNGSeed;
+    device->DitherShaped = false;
+    device->DitherSeeds = DitherRNGSeeds;
+    device->DitherLast.fill(0u);
 
     device->mHrtfStatus = ALC_HRTF_DISABLED_SOFT;
 
@@ -1408,88 +1832,84 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
      * Update device format request
      */
 
-    if(device->Type == DeviceType::Loopback)
+    if(resetInPlace)
+        TRACE("Resetting in place: %s, %s, %uhz, %u / %u buffer\n",
+            DevFmtChannelsString(device->FmtChans), DevFmtTypeString(device->FmtType),
+            device->Frequency, device->UpdateSize, device->BufferSize);
+    else
     {
-        device->Frequency = *optsrate;
-        device->FmtChans = *optchans;
-        device->FmtType = *opttype;
-        if(device->FmtChans == DevFmtAmbi3D)
+        device->Frequency = request.mFrequency;
+        device->FmtChans = request.mChannels;
+        device->FmtType = request.mType;
+        device->mAmbiOrder = request.mAmbiOrder;
+        if(request.mChannels == DevFmtAmbi3D)
         {
-            device->mAmbiOrder = aorder;
-            device->mAmbiLayout = *optlayout;
-            device->mAmbiScale = *optscale;
+            device->mAmbiLayout = request.mAmbiLayout;
+            device->mAmbiScale = request.mAmbiScale;
         }
-        device->Flags.set(FrequencyRequest).set(ChannelsRequest).set(SampleTypeRequest);
-    }
-    else
-    {
-        device->FmtType = opttype.value_or(DevFmtTypeDefault);
-        device->FmtChans = optchans.value_or(DevFmtChannelsDefault);
-        device->mAmbiOrder = 0;
-        device->BufferSize = buffer_size;
-        device->UpdateSize = period_size;
-        device->Frequency = optsrate.value_or(DefaultOutputRate);
-        device->Flags.set(FrequencyRequest, optsrate.has_value())
-            .set(ChannelsRequest, optchans.has_value())
-            .set(SampleTypeRequest, opttype.has_value());
-
-        if(device->FmtChans == DevFmtAmbi3D)
-        {
-            device->mAmbiOrder = std::clamp(aorder, 1u, uint{MaxAmbiOrder});
-            device->mAmbiLayout = optlayout.value_or(DevAmbiLayout::Default);
-            device->mAmbiScale = optscale.value_or(DevAmbiScaling::Default);
-            if(device->mAmbiOrder > 3
-                && (device->mAmbiLayout == DevAmbiLayout::FuMa
-                    || device->mAmbiScale == DevAmbiScaling::FuMa))
-            {
-                ERR("FuMa is incompatible with %d%s order ambisonics (up to 3rd order only)\n",
-                    device->mAmbiOrder, GetCounterSuffix(device->mAmbiOrder));
-                device->mAmbiOrder = 3;
-            }
+        if(device->Type != DeviceType::Loopback)
+        {
+            device->BufferSize = request.mBufferSize;
+            device->UpdateSize = request.mUpdateSize;
         }
-    }
+        device->Flags.set(FrequencyRequest, request.mFrequencyRequest)
+            .set(ChannelsRequest, request.mChannelsRequest)
+            .set(SampleTypeRequest, request.mTypeRequest);
 
-    TRACE("Pre-reset: %s%s, %s%s, %s%uhz, %u / %u buffer\n",
-        device->Flags.test(ChannelsRequest)?"*":"", DevFmtChannelsString(device->FmtChans),
-        device->Flags.test(SampleTypeRequest)?"*":"", DevFmtTypeString(device->FmtType),
-        device->Flags.test(FrequencyRequest)?"*":"", device->Frequency,
-        device->UpdateSize, device->BufferSize);
+        TRACE("Pre-reset: %s%s, %s%s, %s%uhz, %u / %u buffer\n",
+            device->Flags.test(ChannelsRequest)?"*":"", DevFmtChannelsString(device->FmtChans),
+            device->Flags.test(SampleTypeRequest)?"*":"", DevFmtTypeString(device->FmtType),
+            device->Flags.test(FrequencyRequest)?"*":"", device->Frequency,
+            device->UpdateSize, device->BufferSize);
 
-    const uint oldFreq{device->Frequency};
-    const DevFmtChannels oldChans{device->FmtChans};
-    const DevFmtType oldType{device->FmtType};
-    try {
-        auto backend = device->Backend.get();
-        if(!backend->reset())
-            throw al::backend_exception{al::backend_error::DeviceError, "Device reset failure"};
-    }
-    catch(std::exception &e) {
-        ERR("Device error: %s\n", e.what());
-        device->handleDisconnect("%s", e.what());
-        return ALC_INVALID_DEVICE;
-    }
+        device->mFormatRequest.reset();
+        try {
+            auto backend = device->Backend.get();
+            if(!backend->reset())
+                throw al::backend_exception{al::backend_error::DeviceError,
+                    "Device reset failure"};
+        }
+        catch(std::exception &e) {
+            ERR("Device error: %s\n", e.what());
+            device->handleDisconnect("%s", e.what());
+            return ALC_INVALID_DEVICE;
+        }
+        device->mFormatRequest = request;
 
-    if(device->FmtChans != oldChans && device->Flags.test(ChannelsRequest))
-    {
-        ERR("Failed to set %s, got %s instead\n", DevFmtChannelsString(oldChans),
-            DevFmtChannelsString(device->FmtChans));
-        device->Flags.reset(ChannelsRequest);
-    }
-    if(device->FmtType != oldType && device->Flags.test(SampleTypeRequest))
-    {
-        ERR("Failed to set %s, got %s instead\n", DevFmtTypeString(oldType),
-            DevFmtTypeString(device->FmtType));
-        device->Flags.reset(SampleTypeRequest);
+        if(device->FmtChans != request.mChannels && device->Flags.test(ChannelsRequest))
+        {
+            ERR("Failed to set %s, got %s instead\n", DevFmtChannelsString(request.mChannels),
+                DevFmtChannelsString(device->FmtChans));
+            device->Flags.reset(ChannelsRequest);
+        }
+        if(device->FmtType != request.mType && device->Flags.test(SampleTypeRequest))
+        {
+            ERR("Failed to set %s, got %s instead\n", DevFmtTypeString(request.mType),
+                DevFmtTypeString(device->FmtType));
+            device->Flags.reset(SampleTypeRequest);
+        }
+        if(device->Frequency != request.mFrequency && device->Flags.test(FrequencyRequest))
+        {
+            WARN("Failed to set %uhz, got %uhz instead\n", request.mFrequency,
+                device->Frequency);
+            device->Flags.reset(FrequencyRequest);
+        }
+
+        TRACE("Post-reset: %s, %s, %uhz, %u / %u buffer\n",
+            DevFmtChannelsString(device->FmtChans), DevFmtTypeString(device->FmtType),
+            device->Frequency, device->UpdateSize, device->BufferSize);
     }
-    if(device->Frequency != oldFreq && device->Flags.test(FrequencyRequest))
+
+    /* Mix at a lower rate than the output if requested, upsampling the final
+     * mix. Higher rates than the output wouldn't gain anything.
+     */
+    device->mMixFrequency = device->Frequency;
+    if(const uint mixrate{optmixrate.value_or(0u)}; mixrate > 0 && mixrate < device->Frequency)
     {
-        WARN("Failed to set %uhz, got %uhz instead\n", oldFreq, device->Frequency);
-        device->Flags.reset(FrequencyRequest);
+        device->mMixFrequency = std::max(mixrate, uint{MinOutputRate});
+        TRACE("Mixing at %uhz\n", device->mMixFrequency);
     }
 
-    TRACE("Post-reset: %s, %s, %uhz, %u / %u buffer\n",
-        DevFmtChannelsString(device->FmtChans), DevFmtTypeString(device->FmtType),
-        device->Frequency, device->UpdateSize, device->BufferSize);
 
     if(device->Type != DeviceType::Loopback)
     {
@@ -1505,6 +1925,13 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
     }
 
     aluInitRenderer(device, hrtf_id, stereomode);
+    if(device->mHrtfPending)
+    {
+        TRACE("HRTF not loaded yet, using %s stereo meanwhile\n",
+            device->mUhjEncoder ? "UHJ" : "basic");
+        device->mHrtfResetAttrs.assign(attrList.begin(), attrList.end());
+        StartHrtfLoad(device, device->mMixFrequency);
+    }
 
     /* Calculate the max number of sources, and split them between the mono and
      * stereo count given the requested number of stereo sources.
@@ -1528,10 +1955,20 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
     if(auto sendsopt = device->configValue<uint>({}, "sends"sv))
         numSends = std::min(numSends, std::clamp(*sendsopt, 0u, uint{MaxSendCount}));
     device->NumAuxSends = numSends;
+    device->NumListeners = numListeners;
 
     TRACE("Max sources: %d (%d + %d), effect slots: %d, sends: %d\n",
         device->SourcesMax, device->NumMonoSources, device->NumStereoSources,
         device->AuxiliaryEffectSlotMax, device->NumAuxSends);
+    if(device->NumListeners > 1)
+        TRACE("Listeners: %u\n", device->NumListeners);
+
+    if(auto poolopt = device->configValue<uint>({}, "buffer-pool-size"sv))
+    {
+        const size_t poolsize{std::min(*poolopt, 65536u) * 1024_uz * 1024_uz};
+        TRACE("Buffer storage pool size: %uMB\n", std::min(*poolopt, 65536u));
+        device->mBufferPool->setLimit(poolsize);
+    }
 
     switch(device->FmtChans)
     {
@@ -1550,101 +1987,132 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
     case DevFmtAmbi3D: break;
     }
 
-    size_t sample_delay{0};
+    /* The mix delay is in samples at the mixing rate, which is converted to
+     * the output rate with the output delay.
+     */
+    size_t mix_delay{0};
     if(auto *encoder{device->mUhjEncoder.get()})
-        sample_delay += encoder->getDelay();
+        mix_delay += encoder->getDelay();
 
-    if(device->getConfigValueBool({}, "dither"sv, true))
+    if(device->mMixFrequency != device->Frequency)
     {
-        int depth{device->configValue<int>({}, "dither-depth"sv).value_or(0)};
-        if(depth <= 0)
-        {
-            switch(device->FmtType)
-            {
-            case DevFmtByte:
-            case DevFmtUByte:
-                depth = 8;
-                break;
-            case DevFmtShort:
-            case DevFmtUShort:
-                depth = 16;
-                break;
-            case DevFmtInt:
-            case DevFmtUInt:
-            case DevFmtFloat:
-                break;
-            }
-        }
+        device->mOutputConverter = SampleConverter::Create(DevFmtFloat, DevFmtFloat,
+            device->RealOut.Buffer.size(), device->mMixFrequency, device->Frequency,
+            Resampler::BSinc24);
+        device->mOutputBuffer.resize(device->RealOut.Buffer.size());
+        mix_delay += MaxResamplerEdge;
+        TRACE("Upsampling mix from %uhz to %uhz\n", device->mMixFrequency, device->Frequency);
+    }
 
-        if(depth > 0)
-        {
-            depth = std::clamp(depth, 2, 24);
-            device->DitherDepth = std::pow(2.0f, static_cast<float>(depth-1));
-        }
+    size_t sample_delay{0};
+
+    device->mLimiterRequest = optlimit;
+    device->mOutputSettings = GetOutputSettings(device);
+    device->DitherDepth = device->mOutputSettings.DitherDepth;
+    device->DitherShaped = device->mOutputSettings.DitherShaped;
+    if(auto &settings = device->mOutputSettings; settings.LimiterThreshold)
+    {
+        auto limiter = CreateDeviceLimiter(device, *settings.LimiterThreshold,
+            settings.LimiterDivisor, settings.LimiterTruePeak);
+        settings.LimiterLookAhead = limiter->getLookAhead();
+        sample_delay += settings.LimiterLookAhead;
+        device->Limiter = std::move(limiter);
     }
-    if(!(device->DitherDepth > 0.0f))
-        TRACE("Dithering disabled\n");
+
+    if(auto threadsopt = device->configValue<uint>({}, "mix-threads"sv))
+    {
+        const uint numthreads{std::min(*threadsopt, 64u)};
+        if(numthreads > 1)
+            device->mMixerPool = MixerPool::Create(device, numthreads);
+    }
+    if(!device->mMixerPool)
+        TRACE("Mixer pool disabled\n");
     else
-        TRACE("Dithering enabled (%d-bit, %g)\n", float2int(std::log2(device->DitherDepth)+0.5f)+1,
-              device->DitherDepth);
+        TRACE("Mixer pool enabled, %zu threads\n", device->mMixerPool->threadCount());
 
-    if(!optlimit)
-        optlimit = device->configValue<bool>({}, "output-limiter");
+    if(device->getConfigValueBool({}, "param-update-thread"sv, false))
+        device->mParamThread = ParamUpdateThread::Create(device);
+    TRACE("Parameter update thread %s\n", device->mParamThread ? "enabled" : "disabled");
 
-    /* If the gain limiter is unset, use the limiter for integer-based output
-     * (where samples must be clamped), and don't for floating-point (which can
-     * take unclamped samples).
-     */
-    if(!optlimit)
+    if(!device->mConvolutionOffload
+        && device->getConfigValueBool("convolution"sv, "offload"sv, false))
     {
-        switch(device->FmtType)
+        device->mConvolutionOffload = ConvolutionOffload::Create();
+        if(device->mConvolutionOffload)
+            TRACE("Convolution offload thread enabled\n");
+    }
+
+    device->mVoiceCullGain = 0.0f;
+    device->mVoiceUncullGain = 0.0f;
+    if(auto cullopt = device->configValue<float>({}, "voice-cull-level"sv))
+    {
+        const float hysteresis{std::max(device->configValue<float>({}, "voice-cull-hysteresis"sv)
+            .value_or(6.0f), 0.0f)};
+        if(*cullopt < 0.0f)
         {
-        case DevFmtByte:
-        case DevFmtUByte:
-        case DevFmtShort:
-        case DevFmtUShort:
-        case DevFmtInt:
-        case DevFmtUInt:
-            optlimit = true;
-            break;
-        case DevFmtFloat:
-            break;
+            device->mVoiceCullGain = std::pow(10.0f, *cullopt / 20.0f);
+            device->mVoiceUncullGain = std::pow(10.0f, (*cullopt+hysteresis) / 20.0f);
+            TRACE("Voice culling enabled, %.2fdB level, %.2fdB hysteresis\n", *cullopt,
+                hysteresis);
         }
+        else
+            WARN("Ignoring non-negative voice-cull-level: %.2fdB\n", *cullopt);
     }
-    if(!optlimit.value_or(false))
-        TRACE("Output limiter disabled\n");
-    else
+
+    device->mRealVoiceLimit = device->configValue<uint>({}, "real-voices"sv).value_or(0u);
+    if(device->mRealVoiceLimit > 0)
+        TRACE("Real voices limited to %u\n", device->mRealVoiceLimit);
+
+    device->mHrtfVoiceLimit = device->configValue<uint>({}, "hrtf-voices"sv).value_or(0u);
+    if(device->mHrtfVoiceLimit > 0)
+        TRACE("HRTF voices limited to %u\n", device->mHrtfVoiceLimit);
+
+    device->mMixBudget = 0.0f;
+    device->mMixLoad.store(0.0f, std::memory_order_relaxed);
+    device->mXRunCount.store(0u, std::memory_order_relaxed);
+    device->mMixDegrade = MixDegrade::None;
+    device->mDegradeVoiceScale = 1.0f;
+    device->mDegradeHold = 0u;
+    if(auto budgetopt = device->configValue<float>({}, "mix-budget"sv))
     {
-        float thrshld{1.0f};
-        switch(device->FmtType)
+        if(*budgetopt > 0.0f && *budgetopt <= 1.0f)
         {
-        case DevFmtByte:
-        case DevFmtUByte:
-            thrshld = 127.0f / 128.0f;
-            break;
-        case DevFmtShort:
-        case DevFmtUShort:
-            thrshld = 32767.0f / 32768.0f;
-            break;
-        case DevFmtInt:
-        case DevFmtUInt:
-        case DevFmtFloat:
-            break;
+            device->mMixBudget = *budgetopt;
+            TRACE("Mixer time budget %.2f%%\n", *budgetopt*100.0f);
         }
-        if(device->DitherDepth > 0.0f)
-            thrshld -= 1.0f / device->DitherDepth;
+        else
+            WARN("Ignoring out-of-range mix-budget: %f\n", *budgetopt);
+    }
 
-        const float thrshld_dB{std::log10(thrshld) * 20.0f};
-        auto limiter = CreateDeviceLimiter(device, thrshld_dB);
+    device->mProfile = nullptr;
+    if(device->configValue<bool>({}, "mixer-profile"sv).value_or(false))
+    {
+        device->mProfile = std::make_unique<MixerProfile>();
+        TRACE("Mixer profiling enabled\n");
+    }
 
-        sample_delay += limiter->getLookAhead();
-        device->Limiter = std::move(limiter);
-        TRACE("Output limiter enabled, %.4fdB limit\n", thrshld_dB);
+    device->mLowDetailGain = 0.0f;
+    device->mFullDetailGain = 0.0f;
+    if(auto lodopt = device->configValue<float>({}, "low-detail-level"sv))
+    {
+        const float hysteresis{std::max(device->configValue<float>({}, "low-detail-hysteresis"sv)
+            .value_or(3.0f), 0.0f)};
+        if(*lodopt < 0.0f)
+        {
+            device->mLowDetailGain = std::pow(10.0f, *lodopt / 20.0f);
+            device->mFullDetailGain = std::pow(10.0f, (*lodopt+hysteresis) / 20.0f);
+            TRACE("Low-detail panning enabled, %.2fdB level, %.2fdB hysteresis\n", *lodopt,
+                hysteresis);
+        }
+        else
+            WARN("Ignoring non-negative low-detail-level: %.2fdB\n", *lodopt);
     }
 
     /* Convert the sample delay from samples to nanosamples to nanoseconds. */
     sample_delay = std::min<size_t>(sample_delay, std::numeric_limits<int>::max());
+    mix_delay = std::min<size_t>(mix_delay, std::numeric_limits<int>::max());
     device->FixedLatency += nanoseconds{seconds{sample_delay}} / device->Frequency;
+    device->FixedLatency += nanoseconds{seconds{mix_delay}} / device->mMixFrequency;
     TRACE("Fixed device latency: %" PRId64 "ns\n", int64_t{device->FixedLatency.count()});
 
     FPUCtl mixer_mode{};
@@ -1652,8 +2120,8 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
     {
         auto *context = static_cast<ALCcontext*>(ctxbase);
 
-        std::unique_lock<std::mutex> proplock{context->mPropLock};
-        std::unique_lock<std::mutex> slotlock{context->mEffectSlotLock};
+        std::unique_lock<std::shared_mutex> proplock{context->mPropLock};
+        std::unique_lock<std::shared_mutex> slotlock{context->mEffectSlotLock};
 
         /* Clear out unused effect slot clusters. */
         auto slot_cluster_not_in_use = [](ContextBase::EffectSlotCluster &clusterptr) -> bool
@@ -1687,11 +2155,12 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
             aluInitEffectPanning(slotbase, context);
 
             if(auto *props = slotbase->Update.exchange(nullptr, std::memory_order_relaxed))
-                AtomicReplaceHead(context->mFreeEffectSlotProps, props);
+                context->mFreeEffectSlotProps.push(props);
 
             EffectState *state{slot->Effect.State.get()};
             state->mOutTarget = device->Dry.Buffer;
             state->deviceUpdate(device, slot->Buffer);
+            slot->mBufferJob = 0u;
             slot->mPropsDirty = true;
         }
 
@@ -1710,11 +2179,12 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
                 aluInitEffectPanning(slotbase, context);
 
                 if(auto *props = slotbase->Update.exchange(nullptr, std::memory_order_relaxed))
-                    AtomicReplaceHead(context->mFreeEffectSlotProps, props);
+                    context->mFreeEffectSlotProps.push(props);
 
                 EffectState *state{slot.Effect.State.get()};
                 state->mOutTarget = device->Dry.Buffer;
                 state->deviceUpdate(device, slot.Buffer);
+                slot.mBufferJob = 0u;
                 slot.mPropsDirty = true;
             }
         };
@@ -1723,10 +2193,10 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
 
         /* Clear all effect slot props to let them get allocated again. */
         context->mEffectSlotPropClusters.clear();
-        context->mFreeEffectSlotProps.store(nullptr, std::memory_order_relaxed);
+        context->mFreeEffectSlotProps.clear();
         slotlock.unlock();
 
-        std::unique_lock<std::mutex> srclock{context->mSourceLock};
+        std::unique_lock<std::shared_mutex> srclock{context->mSourceLock};
         const uint num_sends{device->NumAuxSends};
         auto reset_sources = [num_sends](SourceSubList &sublist)
         {
@@ -1771,7 +2241,7 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
             std::for_each(voice->mChans.begin(), voice->mChans.end(), clear_wetparams);
 
             if(VoicePropsItem *props{voice->mUpdate.exchange(nullptr, std::memory_order_relaxed)})
-                AtomicReplaceHead(context->mFreeVoiceProps, props);
+                context->mFreeVoiceProps.push(props);
 
             /* Force the voice to stopped if it was stopping. */
             Voice::State vstate{Voice::Stopping};
@@ -1787,7 +2257,7 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
 
         /* Clear all voice props to let them get allocated again. */
         context->mVoicePropClusters.clear();
-        context->mFreeVoiceProps.store(nullptr, std::memory_order_relaxed);
+        context->mFreeVoiceProps.clear();
         srclock.unlock();
 
         context->mPropsDirty = false;
@@ -1795,10 +2265,28 @@ ALCenum UpdateDeviceParams(ALCdevice *device, const al::span<const int> attrList
         UpdateAllEffectSlotProps(context);
         UpdateAllSourceProps(context);
     };
+    /* Reset the spare effect states before the contexts, so a state taken
+     * while resetting a context isn't one made for the old parameters.
+     */
+    device->mEffectStatePool->reset(device,
+        device->configValue<uint>({}, "effect-state-pool"sv).value_or(0u));
+
     auto ctxspan = al::span{*device->mContexts.load()};
     std::for_each(ctxspan.begin(), ctxspan.end(), reset_context);
     mixer_mode.leave();
 
+    if(device->configValue<bool>({}, "prefault-memory").value_or(false))
+    {
+        if(!device->lockMixerMemory())
+            WARN("Failed to lock all mixer memory\n");
+    }
+
+    if(resetInPlace)
+    {
+        device->releaseOutput();
+        return ALC_NO_ERROR;
+    }
+
     device->mDeviceState = DeviceState::Configured;
     if(!device->Flags.test(DevicePaused))
     {
@@ -1841,24 +2329,31 @@ bool ResetDeviceParams(ALCdevice *device, const al::span<const int> attrList)
             /* Clear any pending voice changes and reallocate voices to get a
              * clean restart.
              */
-            std::lock_guard<std::mutex> sourcelock{ctx->mSourceLock};
+            std::lock_guard<std::shared_mutex> sourcelock{ctx->mSourceLock};
             auto *vchg = ctx->mCurrentVoiceChange.load(std::memory_order_acquire);
             while(auto *next = vchg->mNext.load(std::memory_order_acquire))
                 vchg = next;
             ctx->mCurrentVoiceChange.store(vchg, std::memory_order_release);
 
             ctx->mVoicePropClusters.clear();
-            ctx->mFreeVoiceProps.store(nullptr, std::memory_order_relaxed);
+            ctx->mFreeVoiceProps.clear();
 
             ctx->mVoiceClusters.clear();
             ctx->allocVoices(std::max<size_t>(256,
                 ctx->mActiveVoiceCount.load(std::memory_order_relaxed)));
         }
 
+        /* The backend has to be restarted too. */
+        if(device->mDeviceState == DeviceState::Playing)
+        {
+            device->Backend->stop();
+            device->mDeviceState = DeviceState::Configured;
+        }
+
         device->Connected.store(true);
     }
 
-    ALCenum err{UpdateDeviceParams(device, attrList)};
+    ALCenum err{UpdateDeviceParams(device, attrList, true)};
     if(err == ALC_NO_ERROR) LIKELY return ALC_TRUE;
 
     alcSetError(device, err);
@@ -1885,7 +2380,7 @@ DeviceRef VerifyDevice(ALCdevice *device)
  */
 ContextRef VerifyContext(ALCcontext *context)
 {
-    std::lock_guard<std::recursive_mutex> listlock{ListLock};
+    std::shared_lock<std::shared_mutex> ctxlock{ContextListLock};
     auto iter = std::lower_bound(ContextList.begin(), ContextList.end(), context);
     if(iter != ContextList.end() && *iter == context)
     {
@@ -1895,11 +2390,128 @@ ContextRef VerifyContext(ALCcontext *context)
     return nullptr;
 }
 
+
+/* Enumerates the HRTFs and loads the first usable one at the given rate, and
+ * resets the device with it if the device is waiting for it. Runs on its own
+ * thread, so the device may have been closed by the time it's loaded.
+ */
+void LoadHrtfProc(ALCdevice *device, const std::shared_ptr<HrtfLoader> loader,
+    const std::optional<std::string> pathopt, const std::optional<std::string> defhrtfopt,
+    const uint rate)
+{
+    std::vector<std::string> hrtflist{EnumerateHrtf(pathopt)};
+    if(defhrtfopt)
+    {
+        auto iter = std::find(hrtflist.begin(), hrtflist.end(), *defhrtfopt);
+        if(iter == hrtflist.end())
+            WARN("Failed to find default HRTF \"%s\"\n", defhrtfopt->c_str());
+        else if(iter != hrtflist.begin())
+            std::rotate(hrtflist.begin(), iter, iter+1);
+    }
+
+    HrtfStorePtr hrtf;
+    std::string hrtfname;
+    for(const std::string &name : hrtflist)
+    {
+        if((hrtf = GetLoadedHrtf(name, rate)))
+        {
+            hrtfname = name;
+            break;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> loadlock{loader->mMutex};
+        /* Drop it if a load for another rate was started since. */
+        if(loader->mRate != rate)
+            return;
+        loader->mList = std::move(hrtflist);
+        loader->mName = hrtfname;
+        loader->mHrtf = std::move(hrtf);
+        loader->mDone = true;
+    }
+
+    std::unique_lock<std::recursive_mutex> listlock{ListLock};
+    DeviceRef dev{VerifyDevice(device)};
+    if(!dev) return;
+    std::unique_lock<std::mutex> statelock{dev->StateLock};
+    listlock.unlock();
+
+    if(dev->mHrtfLoader != loader || !dev->mHrtfPending
+        || !dev->Connected.load(std::memory_order_relaxed))
+        return;
+
+    /* Force the reset so it isn't skipped without new attributes. */
+    TRACE("Resetting device with HRTF \"%s\"\n", hrtfname.c_str());
+    const std::vector<int> attrs{dev->mHrtfResetAttrs};
+    if(ALCenum err{UpdateDeviceParams(dev.get(), attrs, true)}; err != ALC_NO_ERROR)
+    {
+        ERR("Failed to reset device with the loaded HRTF\n");
+        alcSetError(dev.get(), err);
+        return;
+    }
+    if(!dev->mHrtf)
+        return;
+
+    const std::string msg{"HRTF enabled: "+dev->mHrtfName};
+    statelock.unlock();
+    alc::Event(alc::EventType::HrtfReady, alc::DeviceType::Playback, dev.get(), msg);
+}
+
+/* Starts loading the device's HRTF for the given rate in the background, if
+ * it isn't already loading or loaded for it.
+ */
+void StartHrtfLoad(ALCdevice *device, const uint rate)
+{
+    if(!device->mHrtfLoader)
+        return;
+
+    std::shared_ptr<HrtfLoader> loader{device->mHrtfLoader};
+    {
+        std::lock_guard<std::mutex> loadlock{loader->mMutex};
+        if(loader->mRate == rate)
+            return;
+        loader->mRate = rate;
+        loader->mDone = false;
+        loader->mList.clear();
+        loader->mName.clear();
+        loader->mHrtf = nullptr;
+    }
+
+    TRACE("Loading HRTF for %uhz in the background\n", rate);
+    try {
+        std::thread{LoadHrtfProc, device, loader, device->configValue<std::string>({},
+            "hrtf-paths"), device->configValue<std::string>({}, "default-hrtf"), rate}.detach();
+    }
+    catch(std::exception &e) {
+        ERR("Failed to start HRTF loader thread: %s\n", e.what());
+        /* Try again on the next reset. */
+        std::lock_guard<std::mutex> loadlock{loader->mMutex};
+        loader->mRate = 0;
+    }
+}
+
 } // namespace
 
+void alc::DeviceListChanged(DeviceType deviceType) noexcept
+{
+    DeviceListCache &cache = (deviceType == DeviceType::Playback) ? PlaybackListCache
+        : CaptureListCache;
+    cache.mSerial.fetch_add(1u, std::memory_order_acq_rel);
+}
+
 FORCE_ALIGN void ALC_APIENTRY alsoft_set_log_callback(LPALSOFTLOGCALLBACK callback, void *userptr) noexcept
 {
-    al_set_log_callback(callback, userptr);
+    al_set_log_callback(callback, userptr);
+}
+
+FORCE_ALIGN void ALC_APIENTRY alsoft_set_trace_callback(LPALSOFTTRACECALLBACK callback, void *userptr) noexcept
+{
+#ifndef ALSOFT_TRACING
+    if(callback)
+        WARN("Trace callback set, but tracing is not built in\n");
+#endif
+    al_set_trace_sink(callback, userptr);
 }
 
 /** Returns a new reference to the currently active context for this thread. */
@@ -1972,7 +2584,7 @@ ALC_API void ALC_APIENTRY alcSuspendContext(ALCcontext *context) noexcept
 
     if(SuspendDefers)
     {
-        std::lock_guard<std::mutex> proplock{ctx->mPropLock};
+        std::lock_guard<std::shared_mutex> proplock{ctx->mPropLock};
         ctx->deferUpdates();
     }
 }
@@ -1995,7 +2607,7 @@ ALC_API void ALC_APIENTRY alcProcessContext(ALCcontext *context) noexcept
 
     if(SuspendDefers)
     {
-        std::lock_guard<std::mutex> proplock{ctx->mPropLock};
+        std::lock_guard<std::shared_mutex> proplock{ctx->mPropLock};
         ctx->processUpdates();
     }
 }
@@ -2143,10 +2755,14 @@ static size_t GetIntegerv(ALCdevice *device, ALCenum param, const al::span<int>
         case ALC_MAX_AUXILIARY_SENDS:
             values[0] = MaxSendCount;
             return 1;
+        case ALC_MAX_LISTENERS_SOFT:
+            values[0] = MaxListenerCount;
+            return 1;
 
         case ALC_ATTRIBUTES_SIZE:
         case ALC_ALL_ATTRIBUTES:
         case ALC_FREQUENCY:
+        case ALC_MIX_FREQUENCY_SOFT:
         case ALC_REFRESH:
         case ALC_SYNC:
         case ALC_MONO_SOURCES:
@@ -2185,7 +2801,8 @@ static size_t GetIntegerv(ALCdevice *device, ALCenum param, const al::span<int>
                 values[i++] = ALC_MINOR_VERSION;
                 values[i++] = alcMinorVersion;
                 values[i++] = ALC_CAPTURE_SAMPLES;
-                values[i++] = static_cast<int>(device->Backend->availableSamples());
+                values[i++] = static_cast<int>(device->Backend->availableSamples()
+                    + device->mCaptureStaged);
                 values[i++] = ALC_CONNECTED;
                 values[i++] = device->Connected.load(std::memory_order_relaxed);
                 values[i++] = 0;
@@ -2203,7 +2820,8 @@ static size_t GetIntegerv(ALCdevice *device, ALCenum param, const al::span<int>
             return 1;
 
         case ALC_CAPTURE_SAMPLES:
-            values[0] = static_cast<int>(device->Backend->availableSamples());
+            values[0] = static_cast<int>(device->Backend->availableSamples()
+                + device->mCaptureStaged);
             return 1;
 
         case ALC_CONNECTED:
@@ -2289,7 +2907,7 @@ static size_t GetIntegerv(ALCdevice *device, ALCenum param, const al::span<int>
             values[i++] = device->mHrtfStatus;
 
             values[i++] = ALC_OUTPUT_LIMITER_SOFT;
-            values[i++] = device->Limiter ? ALC_TRUE : ALC_FALSE;
+            values[i++] = device->mOutputSettings.LimiterThreshold ? ALC_TRUE : ALC_FALSE;
 
             values[i++] = ALC_MAX_AMBISONIC_ORDER_SOFT;
             values[i++] = MaxAmbiOrder;
@@ -2324,6 +2942,10 @@ static size_t GetIntegerv(ALCdevice *device, ALCenum param, const al::span<int>
         values[0] = static_cast<int>(device->Frequency);
         return 1;
 
+    case ALC_MIX_FREQUENCY_SOFT:
+        values[0] = static_cast<int>(device->mMixFrequency);
+        return 1;
+
     case ALC_REFRESH:
         if(device->Type == DeviceType::Loopback)
         {
@@ -2399,6 +3021,10 @@ static size_t GetIntegerv(ALCdevice *device, ALCenum param, const al::span<int>
         values[0] = static_cast<int>(device->NumAuxSends);
         return 1;
 
+    case ALC_MAX_LISTENERS_SOFT:
+        values[0] = static_cast<int>(device->NumListeners);
+        return 1;
+
     case ALC_CONNECTED:
         values[0] = device->Connected.load(std::memory_order_acquire);
         return 1;
@@ -2418,7 +3044,7 @@ static size_t GetIntegerv(ALCdevice *device, ALCenum param, const al::span<int>
         return 1;
 
     case ALC_OUTPUT_LIMITER_SOFT:
-        values[0] = device->Limiter ? ALC_TRUE : ALC_FALSE;
+        values[0] = device->mOutputSettings.LimiterThreshold ? ALC_TRUE : ALC_FALSE;
         return 1;
 
     case ALC_MAX_AMBISONIC_ORDER_SOFT:
@@ -2429,6 +3055,92 @@ static size_t GetIntegerv(ALCdevice *device, ALCenum param, const al::span<int>
         values[0] = static_cast<ALCenum>(device->getOutputMode1());
         return 1;
 
+    case ALC_XRUN_COUNT_SOFT:
+        values[0] = static_cast<int>(std::min(device->mXRunCount.load(std::memory_order_relaxed),
+            uint{std::numeric_limits<int>::max()}));
+        return 1;
+
+    case ALC_BACKEND_TIMING_BUCKETS_SOFT:
+        values[0] = BackendTiming::NumBuckets;
+        return 1;
+
+    case ALC_BACKEND_TIMING_JITTER_SOFT:
+    case ALC_BACKEND_TIMING_DISPATCH_SOFT:
+    case ALC_BACKEND_TIMING_RENDER_SOFT:
+    case ALC_BACKEND_TIMING_COMMIT_SOFT:
+        if(values.size() < BackendTiming::NumBuckets)
+            alcSetError(device, ALC_INVALID_VALUE);
+        else
+        {
+            const auto stage = (param == ALC_BACKEND_TIMING_JITTER_SOFT) ? BackendTiming::Jitter
+                : (param == ALC_BACKEND_TIMING_DISPATCH_SOFT) ? BackendTiming::Dispatch
+                : (param == ALC_BACKEND_TIMING_RENDER_SOFT) ? BackendTiming::Render
+                : BackendTiming::Commit;
+            const auto &counts = device->Backend->mTiming.mCounts[stage];
+            std::transform(counts.cbegin(), counts.cend(), values.begin(),
+                [](const std::atomic<uint> &count) noexcept -> int
+                {
+                    return static_cast<int>(std::min(count.load(std::memory_order_relaxed),
+                        uint{std::numeric_limits<int>::max()}));
+                });
+            return BackendTiming::NumBuckets;
+        }
+        return 0;
+
+    case ALC_MIXER_PROFILE_SIZE_SOFT:
+        values[0] = MixerProfile::CounterCount;
+        return 1;
+
+    case ALC_MEMORY_USAGE_SIZE_SOFT:
+        values[0] = MemoryUsage::CounterCount;
+        return 1;
+
+    /* These only describe what the device can be set up with, so they don't
+     * need a context or any mixing state to have been made for it.
+     */
+    case ALC_DEVICE_CONFIGURED_SOFT:
+        values[0] = (device->mDeviceState != DeviceState::Unprepared) ? ALC_TRUE : ALC_FALSE;
+        return 1;
+
+    case ALC_MIN_FREQUENCY_SOFT:
+        values[0] = static_cast<int>(MinOutputRate);
+        return 1;
+
+    case ALC_MAX_FREQUENCY_SOFT:
+        values[0] = static_cast<int>(MaxOutputRate);
+        return 1;
+
+    case ALC_NUM_OUTPUT_MODES_SOFT:
+    case ALC_OUTPUT_MODES_SOFT:
+    {
+        /* HRTF output is only available with an HRTF to use. */
+        using OutputMode = ALCdevice::OutputMode;
+        static constexpr std::array modes{OutputMode::Mono, OutputMode::StereoBasic,
+            OutputMode::Uhj2, OutputMode::Hrtf, OutputMode::Quad, OutputMode::X51,
+            OutputMode::X61, OutputMode::X71};
+        device->enumerateHrtfs();
+        std::vector<int> supported;
+        supported.reserve(modes.size());
+        for(const OutputMode mode : modes)
+        {
+            if(mode != OutputMode::Hrtf || !device->mHrtfList.empty())
+                supported.emplace_back(static_cast<ALCenum>(mode));
+        }
+
+        if(param == ALC_NUM_OUTPUT_MODES_SOFT)
+        {
+            values[0] = static_cast<int>(supported.size());
+            return 1;
+        }
+        if(values.size() < supported.size())
+        {
+            alcSetError(device, ALC_INVALID_VALUE);
+            return 0;
+        }
+        std::copy(supported.cbegin(), supported.cend(), values.begin());
+        return supported.size();
+    }
+
     default:
         alcSetError(device, ALC_INVALID_ENUM);
     }
@@ -2528,7 +3240,7 @@ ALC_API void ALC_APIENTRY alcGetInteger64vSOFT(ALCdevice *device, ALCenum pname,
             valuespan[i++] = dev->mHrtfStatus;
 
             valuespan[i++] = ALC_OUTPUT_LIMITER_SOFT;
-            valuespan[i++] = dev->Limiter ? ALC_TRUE : ALC_FALSE;
+            valuespan[i++] = dev->mOutputSettings.LimiterThreshold ? ALC_TRUE : ALC_FALSE;
 
             ClockLatency clock{GetClockLatency(dev.get(), dev->Backend.get())};
             valuespan[i++] = ALC_DEVICE_CLOCK_SOFT;
@@ -2549,11 +3261,11 @@ ALC_API void ALC_APIENTRY alcGetInteger64vSOFT(ALCdevice *device, ALCenum pname,
             uint samplecount, refcount;
             nanoseconds basecount;
             do {
-                refcount = dev->waitForMix();
+                refcount = dev->waitForClock();
                 basecount = dev->mClockBase.load(std::memory_order_relaxed);
                 samplecount = dev->mSamplesDone.load(std::memory_order_relaxed);
                 std::atomic_thread_fence(std::memory_order_acquire);
-            } while(refcount != dev->mMixCount.load(std::memory_order_relaxed));
+            } while(refcount != dev->mClockCount.load(std::memory_order_relaxed));
             basecount += nanoseconds{seconds{samplecount}} / dev->Frequency;
             valuespan[0] = basecount.count();
         }
@@ -2574,6 +3286,39 @@ ALC_API void ALC_APIENTRY alcGetInteger64vSOFT(ALCdevice *device, ALCenum pname,
         }
         break;
 
+    case ALC_MIXER_PROFILE_SOFT:
+        if(valuespan.size() < MixerProfile::CounterCount)
+            alcSetError(dev.get(), ALC_INVALID_VALUE);
+        else if(!dev->mProfile)
+            std::fill_n(valuespan.begin(), MixerProfile::CounterCount, ALCint64SOFT{0});
+        else
+        {
+            const auto &counters = dev->mProfile->mCounters;
+            std::transform(counters.cbegin(), counters.cend(), valuespan.begin(),
+                [](const std::atomic<uint64_t> &counter) noexcept -> ALCint64SOFT
+                {
+                    return static_cast<ALCint64SOFT>(std::min(
+                        counter.load(std::memory_order_relaxed),
+                        uint64_t{std::numeric_limits<ALCint64SOFT>::max()}));
+                });
+        }
+        break;
+
+    case ALC_MEMORY_USAGE_SOFT:
+        if(valuespan.size() < MemoryUsage::CounterCount)
+            alcSetError(dev.get(), ALC_INVALID_VALUE);
+        else
+        {
+            const auto &counters = dev->mMemory->mCounters;
+            std::transform(counters.cbegin(), counters.cend(), valuespan.begin(),
+                [](const std::atomic<size_t> &counter) noexcept -> ALCint64SOFT
+                { return static_cast<ALCint64SOFT>(counter.load(std::memory_order_relaxed)); });
+            /* Storage the device pooled for reuse counts toward buffers. */
+            valuespan[MemoryUsage::Buffers] += static_cast<ALCint64SOFT>(
+                dev->mBufferPool->pooledSize());
+        }
+        break;
+
     default:
         auto ivals = std::vector<int>(valuespan.size());
         if(size_t got{GetIntegerv(dev.get(), pname, ivals)})
@@ -2687,7 +3432,7 @@ ALC_API ALCcontext* ALC_APIENTRY alcCreateContext(ALCdevice *device, const ALCin
     dev->LastError.store(ALC_NO_ERROR);
 
     const auto attrSpan = SpanFromAttributeList(attrList);
-    ALCenum err{UpdateDeviceParams(dev.get(), attrSpan)};
+    ALCenum err{UpdateDeviceParams(dev.get(), attrSpan, false)};
     if(err != ALC_NO_ERROR)
     {
         alcSetError(dev.get(), err);
@@ -2695,14 +3440,18 @@ ALC_API ALCcontext* ALC_APIENTRY alcCreateContext(ALCdevice *device, const ALCin
     }
 
     ContextFlagBitset ctxflags{0};
+    std::optional<uint> reservevoices, reserveslots;
     for(size_t i{0};i < attrSpan.size();i+=2)
     {
         if(attrSpan[i] == ALC_CONTEXT_FLAGS_EXT)
-        {
             ctxflags = static_cast<ALuint>(attrSpan[i+1]);
-            break;
-        }
+        else if(attrSpan[i] == ALC_RESERVE_VOICES_SOFT)
+            reservevoices = static_cast<uint>(std::max(attrSpan[i+1], 0));
+        else if(attrSpan[i] == ALC_RESERVE_EFFECT_SLOTS_SOFT)
+            reserveslots = static_cast<uint>(std::max(attrSpan[i+1], 0));
     }
+    if(!reservevoices) reservevoices = dev->configValue<uint>({}, "prealloc-voices");
+    if(!reserveslots) reserveslots = dev->configValue<uint>({}, "prealloc-effect-slots");
 
     auto context = ContextRef{new(std::nothrow) ALCcontext{dev, ctxflags}};
     if(!context)
@@ -2710,8 +3459,17 @@ ALC_API ALCcontext* ALC_APIENTRY alcCreateContext(ALCdevice *device, const ALCin
         alcSetError(dev.get(), ALC_OUT_OF_MEMORY);
         return nullptr;
     }
+    /* Reserve memory for the expected voices and effect slots before any are
+     * allocated, so they're all laid out together.
+     */
+    if(reservevoices || reserveslots)
+        context->reserveClusters(std::max(std::min(reservevoices.value_or(0u), 65536u), 256u),
+            std::min(reserveslots.value_or(0u), 1024u));
     context->init();
 
+    /* Make sure the default resampler's tables are ready before mixing. */
+    PrepareResamplerTables(ResamplerDefault.load(std::memory_order_relaxed));
+
     if(auto volopt = dev->configValue<float>({}, "volume-adjust"))
     {
         const float valf{*volopt};
@@ -2727,6 +3485,40 @@ ALC_API ALCcontext* ALC_APIENTRY alcCreateContext(ALCdevice *device, const ALCin
         }
     }
 
+    /* Allocate voices and effect slots up front as requested, so the mixer
+     * doesn't touch newly allocated memory when sources and slots are used.
+     */
+    if(reservevoices)
+    {
+        static constexpr size_t propsize{std::tuple_size_v<
+            ContextBase::VoicePropsCluster::element_type>};
+        static constexpr size_t changesize{std::tuple_size_v<
+            ContextBase::VoiceChangeCluster::element_type>};
+        const size_t numvoices{std::min(*reservevoices, 65536u)};
+        const size_t curvoices{context->mAllocatedVoiceCount};
+        if(numvoices > curvoices)
+            context->allocVoices(numvoices - curvoices);
+        /* Each voice may have a property update and a voice change in flight. */
+        while(context->mVoicePropClusters.size()*propsize < numvoices)
+            context->allocVoiceProps();
+        while(context->mVoiceChangeClusters.size()*changesize < numvoices)
+            context->allocVoiceChanges();
+    }
+    if(reserveslots)
+    {
+        static constexpr size_t propsize{std::tuple_size_v<
+            ContextBase::EffectSlotPropsCluster::element_type>};
+        const size_t numslots{std::min(*reserveslots, 1024u)};
+        context->allocEffectSlots(numslots);
+        while(context->mEffectSlotPropClusters.size()*propsize < numslots)
+            context->allocEffectSlotProps();
+    }
+    if(dev->configValue<bool>({}, "prefault-memory").value_or(false))
+    {
+        if(!context->lockMixerMemory())
+            WARN("Failed to lock all context mixer memory\n");
+    }
+
     {
         using ContextArray = al::FlexArray<ContextBase*>;
 
@@ -2752,8 +3544,10 @@ ALC_API ALCcontext* ALC_APIENTRY alcCreateContext(ALCdevice *device, const ALCin
 
     {
         listlock.lock();
+        std::unique_lock<std::shared_mutex> ctxlock{ContextListLock};
         auto iter = std::lower_bound(ContextList.cbegin(), ContextList.cend(), context.get());
         ContextList.emplace(iter, context.get());
+        ctxlock.unlock();
         listlock.unlock();
     }
 
@@ -2774,9 +3568,11 @@ ALC_API ALCcontext* ALC_APIENTRY alcCreateContext(ALCdevice *device, const ALCin
 ALC_API void ALC_APIENTRY alcDestroyContext(ALCcontext *context) noexcept
 {
     std::unique_lock<std::recursive_mutex> listlock{ListLock};
+    std::unique_lock<std::shared_mutex> ctxlock{ContextListLock};
     auto iter = std::lower_bound(ContextList.begin(), ContextList.end(), context);
     if(iter == ContextList.end() || *iter != context)
     {
+        ctxlock.unlock();
         listlock.unlock();
         alcSetError(nullptr, ALC_INVALID_CONTEXT);
         return;
@@ -2787,6 +3583,7 @@ ALC_API void ALC_APIENTRY alcDestroyContext(ALCcontext *context) noexcept
      */
     ContextRef ctx{*iter};
     ContextList.erase(iter);
+    ctxlock.unlock();
 
     ALCdevice *Device{ctx->mALDevice.get()};
 
@@ -2877,9 +3674,8 @@ ALC_API ALCdevice* ALC_APIENTRY alcGetContextsDevice(ALCcontext *Context) noexce
 
 ALC_API ALCdevice* ALC_APIENTRY alcOpenDevice(const ALCchar *deviceName) noexcept
 {
-    InitConfig();
-
-    if(!PlaybackFactory)
+    BackendFactory *factory{GetPlaybackFactory()};
+    if(!factory)
     {
         alcSetError(nullptr, ALC_INVALID_VALUE);
         return nullptr;
@@ -2929,6 +3725,7 @@ ALC_API ALCdevice* ALC_APIENTRY alcOpenDevice(const ALCchar *deviceName) noexcep
     device->FmtChans = DevFmtChannelsDefault;
     device->FmtType = DevFmtTypeDefault;
     device->Frequency = DefaultOutputRate;
+    device->mMixFrequency = DefaultOutputRate;
     device->UpdateSize = DefaultUpdateSize;
     device->BufferSize = DefaultUpdateSize * DefaultNumUpdates;
 
@@ -2939,7 +3736,7 @@ ALC_API ALCdevice* ALC_APIENTRY alcOpenDevice(const ALCchar *deviceName) noexcep
     device->NumAuxSends = DefaultSends;
 
     try {
-        auto backend = PlaybackFactory->createBackend(device.get(), BackendType::Playback);
+        auto backend = factory->createBackend(device.get(), BackendType::Playback);
         std::lock_guard<std::recursive_mutex> listlock{ListLock};
         backend->open(devname);
         device->Backend = std::move(backend);
@@ -2957,6 +3754,16 @@ ALC_API ALCdevice* ALC_APIENTRY alcOpenDevice(const ALCchar *deviceName) noexcep
         DeviceList.emplace(iter, device.get());
     }
 
+    /* Start loading the HRTF now, so it's ready sooner if it gets used. */
+    if(device->getConfigValueBool({}, "hrtf-async-load", false))
+    {
+        std::lock_guard<std::mutex> statelock{device->StateLock};
+        const uint rate{std::clamp<uint>(device->configValue<uint>({}, "frequency")
+            .value_or(DefaultOutputRate), MinOutputRate, MaxOutputRate)};
+        device->mHrtfLoader = std::make_shared<HrtfLoader>();
+        StartHrtfLoad(device.get(), rate);
+    }
+
     TRACE("Created device %p, \"%s\"\n", voidp{device.get()}, device->DeviceName.c_str());
     return device.release();
 }
@@ -2984,6 +3791,7 @@ ALC_API ALCboolean ALC_APIENTRY alcCloseDevice(ALCdevice *device) noexcept
 
     std::unique_lock<std::mutex> statelock{dev->StateLock};
     std::vector<ContextRef> orphanctxs;
+    std::unique_lock<std::shared_mutex> ctxlock{ContextListLock};
     for(ContextBase *ctx : *dev->mContexts.load())
     {
         auto ctxiter = std::lower_bound(ContextList.begin(), ContextList.end(), ctx);
@@ -2993,6 +3801,7 @@ ALC_API ALCboolean ALC_APIENTRY alcCloseDevice(ALCdevice *device) noexcept
             ContextList.erase(ctxiter);
         }
     }
+    ctxlock.unlock();
     listlock.unlock();
 
     for(ContextRef &context : orphanctxs)
@@ -3007,6 +3816,7 @@ ALC_API ALCboolean ALC_APIENTRY alcCloseDevice(ALCdevice *device) noexcept
         dev->Backend->stop();
         dev->mDeviceState = DeviceState::Configured;
     }
+    dev->mEffectStatePool->reset(dev.get(), 0);
 
     return ALC_TRUE;
 }
@@ -3017,9 +3827,8 @@ ALC_API ALCboolean ALC_APIENTRY alcCloseDevice(ALCdevice *device) noexcept
  ************************************************/
 ALC_API ALCdevice* ALC_APIENTRY alcCaptureOpenDevice(const ALCchar *deviceName, ALCuint frequency, ALCenum format, ALCsizei samples) noexcept
 {
-    InitConfig();
-
-    if(!CaptureFactory)
+    BackendFactory *factory{GetCaptureFactory()};
+    if(!factory)
     {
         alcSetError(nullptr, ALC_INVALID_VALUE);
         return nullptr;
@@ -3072,7 +3881,7 @@ ALC_API ALCdevice* ALC_APIENTRY alcCaptureOpenDevice(const ALCchar *deviceName,
         device->BufferSize);
 
     try {
-        auto backend = CaptureFactory->createBackend(device.get(), BackendType::Capture);
+        auto backend = factory->createBackend(device.get(), BackendType::Capture);
         std::lock_guard<std::recursive_mutex> listlock{ListLock};
         backend->open(devname);
         device->Backend = std::move(backend);
@@ -3119,6 +3928,7 @@ ALC_API ALCboolean ALC_APIENTRY alcCaptureCloseDevice(ALCdevice *device) noexcep
     {
         dev->Backend->stop();
         dev->mDeviceState = DeviceState::Configured;
+        dev->wakeCaptureWaiters();
     }
 
     return ALC_TRUE;
@@ -3164,6 +3974,7 @@ ALC_API void ALC_APIENTRY alcCaptureStop(ALCdevice *device) noexcept
         {
             dev->Backend->stop();
             dev->mDeviceState = DeviceState::Configured;
+            dev->wakeCaptureWaiters();
         }
     }
 }
@@ -3188,14 +3999,221 @@ ALC_API void ALC_APIENTRY alcCaptureSamples(ALCdevice *device, ALCvoid *buffer,
     std::lock_guard<std::mutex> statelock{dev->StateLock};
     BackendBase *backend{dev->Backend.get()};
 
+    auto usamples = static_cast<uint>(samples);
+    const uint staged{dev->mCaptureStaged};
+    if(usamples > backend->availableSamples() + staged)
+    {
+        alcSetError(dev.get(), ALC_INVALID_VALUE);
+        return;
+    }
+
+    dev->mCaptureMapped = 0;
+    dev->mCaptureArmed.store(true, std::memory_order_release);
+    auto *outbuf = static_cast<std::byte*>(buffer);
+    if(staged > 0) UNLIKELY
+    {
+        /* Samples staged by a capture map come first. */
+        const uint count{std::min(usamples, staged)};
+        const auto stagebytes = size_t{count} * dev->frameSizeFromFmt();
+        const auto stageend = dev->mCaptureStage.begin() + static_cast<ptrdiff_t>(stagebytes);
+        outbuf = std::copy(dev->mCaptureStage.begin(), stageend, outbuf);
+        dev->mCaptureStage.erase(dev->mCaptureStage.begin(), stageend);
+        dev->mCaptureStaged -= count;
+        usamples -= count;
+        if(usamples == 0)
+            return;
+    }
+
+    backend->captureSamples(outbuf, usamples);
+}
+
+/** Maps the available captured samples for reading in place. */
+ALC_API ALCsizei ALC_APIENTRY alcCaptureMapSamplesSOFT(ALCdevice *device, ALCvoid **buffers,
+    ALCsizei *samples) noexcept
+{
+    DeviceRef dev{VerifyDevice(device)};
+    if(!dev || dev->Type != DeviceType::Capture)
+    {
+        alcSetError(dev.get(), ALC_INVALID_DEVICE);
+        return 0;
+    }
+    if(!buffers || !samples)
+    {
+        alcSetError(dev.get(), ALC_INVALID_VALUE);
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> statelock{dev->StateLock};
+    BackendBase *backend{dev->Backend.get()};
+    const uint avail{backend->availableSamples()};
+
+    const auto bufspan = al::span{buffers, 2};
+    const auto lenspan = al::span{samples, 2};
+    if(RingBuffer *ring{backend->getCaptureRing()})
+    {
+        /* The ring buffer's readable regions are given directly. */
+        const auto data = ring->getReadVector();
+        bufspan[0] = data.first.len ? data.first.buf : nullptr;
+        lenspan[0] = static_cast<ALCsizei>(data.first.len);
+        bufspan[1] = data.second.len ? data.second.buf : nullptr;
+        lenspan[1] = static_cast<ALCsizei>(data.second.len);
+        dev->mCaptureMapped = static_cast<uint>(data.first.len + data.second.len);
+        return static_cast<ALCsizei>(dev->mCaptureMapped);
+    }
+
+    /* Otherwise read what's available into the staging buffer, which holds the
+     * samples until they're released.
+     */
+    if(avail > 0)
+    {
+        const size_t framesize{dev->frameSizeFromFmt()};
+        const uint staged{dev->mCaptureStaged};
+        try {
+            dev->mCaptureStage.resize((size_t{staged}+avail) * framesize);
+        }
+        catch(std::exception&) {
+            alcSetError(dev.get(), ALC_OUT_OF_MEMORY);
+            return 0;
+        }
+        backend->captureSamples(dev->mCaptureStage.data() + size_t{staged}*framesize, avail);
+        dev->mCaptureStaged += avail;
+    }
+    bufspan[0] = dev->mCaptureStaged ? dev->mCaptureStage.data() : nullptr;
+    lenspan[0] = static_cast<ALCsizei>(dev->mCaptureStaged);
+    bufspan[1] = nullptr;
+    lenspan[1] = 0;
+    dev->mCaptureMapped = dev->mCaptureStaged;
+    return static_cast<ALCsizei>(dev->mCaptureMapped);
+}
+
+/**
+ * Releases captured samples from the front of the last mapping. The device
+ * needs to be mapped again to access any remaining samples.
+ */
+ALC_API void ALC_APIENTRY alcCaptureReleaseSamplesSOFT(ALCdevice *device, ALCsizei samples) noexcept
+{
+    DeviceRef dev{VerifyDevice(device)};
+    if(!dev || dev->Type != DeviceType::Capture)
+    {
+        alcSetError(dev.get(), ALC_INVALID_DEVICE);
+        return;
+    }
+
+    std::lock_guard<std::mutex> statelock{dev->StateLock};
+    if(samples < 0 || static_cast<uint>(samples) > dev->mCaptureMapped)
+    {
+        alcSetError(dev.get(), ALC_INVALID_VALUE);
+        return;
+    }
+    dev->mCaptureMapped = 0;
+    if(samples < 1)
+        return;
+
+    dev->mCaptureArmed.store(true, std::memory_order_release);
     const auto usamples = static_cast<uint>(samples);
-    if(usamples > backend->availableSamples())
+    if(RingBuffer *ring{dev->Backend->getCaptureRing()})
+        ring->readAdvance(usamples);
+    else
+    {
+        const auto stagebytes = size_t{usamples} * dev->frameSizeFromFmt();
+        dev->mCaptureStage.erase(dev->mCaptureStage.begin(),
+            dev->mCaptureStage.begin() + static_cast<ptrdiff_t>(stagebytes));
+        dev->mCaptureStaged -= usamples;
+    }
+}
+
+/**
+ * Sets the number of captured samples that sends a capture-ready event, or 0
+ * to disable it. The event is sent once the backend has captured at least
+ * that many, and again after samples are read and more are captured.
+ */
+ALC_API void ALC_APIENTRY alcCaptureThresholdSOFT(ALCdevice *device, ALCsizei samples) noexcept
+{
+    DeviceRef dev{VerifyDevice(device)};
+    if(!dev || dev->Type != DeviceType::Capture)
+    {
+        alcSetError(dev.get(), ALC_INVALID_DEVICE);
+        return;
+    }
+    if(samples < 0)
     {
         alcSetError(dev.get(), ALC_INVALID_VALUE);
         return;
     }
 
-    backend->captureSamples(static_cast<std::byte*>(buffer), usamples);
+    dev->mCaptureThreshold.store(static_cast<uint>(samples), std::memory_order_relaxed);
+    dev->mCaptureArmed.store(true, std::memory_order_release);
+}
+
+/**
+ * Waits until the given number of samples can be captured, the timeout (in
+ * milliseconds) passes, or the device stops or disconnects. Returns ALC_TRUE
+ * if the samples are available.
+ */
+ALC_API ALCboolean ALC_APIENTRY alcCaptureWaitSOFT(ALCdevice *device, ALCsizei samples,
+    ALCuint timeout_ms) noexcept
+{
+    DeviceRef dev{VerifyDevice(device)};
+    if(!dev || dev->Type != DeviceType::Capture)
+    {
+        alcSetError(dev.get(), ALC_INVALID_DEVICE);
+        return ALC_FALSE;
+    }
+    if(samples < 0)
+    {
+        alcSetError(dev.get(), ALC_INVALID_VALUE);
+        return ALC_FALSE;
+    }
+
+    const auto usamples = static_cast<uint>(samples);
+    const auto timeout = std::chrono::steady_clock::now() + std::chrono::milliseconds{timeout_ms};
+
+    /* Backends that only read from the device when asked don't wake waiters,
+     * so they're checked again each update period.
+     */
+    auto polltime = std::chrono::steady_clock::duration::max();
+    if(BackendFactory *factory{GetCaptureFactory()})
+    {
+        if(factory->queryEventSupport(alc::EventType::CaptureReady, BackendType::Capture)
+            != alc::EventSupport::FullSupport)
+            polltime = std::max<std::chrono::steady_clock::duration>(std::chrono::milliseconds{1},
+                std::chrono::nanoseconds{std::chrono::seconds{dev->UpdateSize}} / dev->Frequency);
+    }
+
+    dev->mCaptureWaiters.fetch_add(1u, std::memory_order_relaxed);
+    auto ret = ALCboolean{ALC_FALSE};
+    while(true)
+    {
+        uint wakecount{};
+        {
+            std::lock_guard<std::mutex> waitlock{dev->mCaptureWaitLock};
+            wakecount = dev->mCaptureWakeCount;
+        }
+        /* Pairs with the fence in DeviceBase::wakeCaptureWaiters. */
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        {
+            std::lock_guard<std::mutex> statelock{dev->StateLock};
+            if(dev->Backend->availableSamples() + dev->mCaptureStaged >= usamples)
+            {
+                ret = ALC_TRUE;
+                break;
+            }
+            if(dev->mDeviceState != DeviceState::Playing
+                || !dev->Connected.load(std::memory_order_acquire))
+                break;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        if(now >= timeout)
+            break;
+        const auto waketime = (timeout-now > polltime) ? now+polltime : timeout;
+        std::unique_lock<std::mutex> waitlock{dev->mCaptureWaitLock};
+        dev->mCaptureWaitCond.wait_until(waitlock, waketime,
+            [&dev,wakecount]{ return dev->mCaptureWakeCount != wakecount; });
+    }
+    dev->mCaptureWaiters.fetch_sub(1u, std::memory_order_relaxed);
+
+    return ret;
 }
 
 
@@ -3239,6 +4257,7 @@ ALC_API ALCdevice* ALC_APIENTRY alcLoopbackOpenDeviceSOFT(const ALCchar *deviceN
     device->UpdateSize = 0;
 
     device->Frequency = DefaultOutputRate;
+    device->mMixFrequency = DefaultOutputRate;
     device->FmtChans = DevFmtChannelsDefault;
     device->FmtType = DevFmtTypeDefault;
 
@@ -3308,6 +4327,89 @@ ALC_API void ALC_APIENTRY alcRenderSamplesSOFT(ALCdevice *device, ALCvoid *buffe
         device->renderSamples(buffer, static_cast<uint>(samples), device->channelsFromFmt());
 }
 
+/**
+ * Renders some samples as planar float, one buffer per output channel, using
+ * the channel configuration and sample rate set by the attributes given to
+ * alcCreateContext (the sample type is ignored). Any number of samples may be
+ * rendered per call, with no buffering between calls.
+ */
+#if defined(__GNUC__) && defined(__i386__)
+[[gnu::force_align_arg_pointer]]
+#endif
+ALC_API void ALC_APIENTRY alcRenderSamplesPlanarSOFT(ALCdevice *device, ALCfloat *const *buffers,
+    ALCsizei numbuffers, ALCsizei samples) noexcept
+{
+    if(!device || device->Type != DeviceType::Loopback) UNLIKELY
+        return alcSetError(device, ALC_INVALID_DEVICE);
+    if(samples < 0 || numbuffers < 0
+        || static_cast<uint>(numbuffers) != device->channelsFromFmt()) UNLIKELY
+        return alcSetError(device, ALC_INVALID_VALUE);
+    if(samples == 0) return;
+
+    const auto bufspan = al::span{buffers, static_cast<uint>(numbuffers)};
+    if(!buffers || std::any_of(bufspan.begin(), bufspan.end(), [](ALCfloat *buf) noexcept
+        { return buf == nullptr; })) UNLIKELY
+        return alcSetError(device, ALC_INVALID_VALUE);
+
+    std::array<float*,MaxOutputChannels> chanptrs{};
+    std::copy(bufspan.begin(), bufspan.end(), chanptrs.begin());
+    device->renderSamples(al::span{chanptrs}.first(bufspan.size()), static_cast<uint>(samples));
+}
+
+/**
+ * Renders samples for multiple loopback devices, each into its own buffer,
+ * splitting the devices between a pool of threads.
+ */
+#if defined(__GNUC__) && defined(__i386__)
+[[gnu::force_align_arg_pointer]]
+#endif
+ALC_API void ALC_APIENTRY alcRenderSamplesBatchSOFT(ALCsizei n, ALCdevice *const *devices,
+    ALCvoid *const *buffers, ALCsizei samples) noexcept
+{
+    if(n < 0 || samples < 0) UNLIKELY
+        return alcSetError(nullptr, ALC_INVALID_VALUE);
+    if(n == 0) return;
+    if(!devices || !buffers) UNLIKELY
+        return alcSetError(nullptr, ALC_INVALID_VALUE);
+
+    const auto devlist = al::span{devices, static_cast<uint>(n)};
+    const auto buflist = al::span{buffers, static_cast<uint>(n)};
+    auto invalid_dev = std::find_if(devlist.begin(), devlist.end(),
+        [](const ALCdevice *device) noexcept
+        { return !device || device->Type != DeviceType::Loopback; });
+    if(invalid_dev != devlist.end()) UNLIKELY
+        return alcSetError(*invalid_dev, ALC_INVALID_DEVICE);
+    const bool missing_buf{std::find(buflist.begin(), buflist.end(), nullptr) != buflist.end()};
+    if(samples > 0 && missing_buf) UNLIKELY
+        return alcSetError(nullptr, ALC_INVALID_VALUE);
+
+    /* A device can't be rendered by two threads at once. */
+    auto sorted = std::vector<ALCdevice*>(devlist.begin(), devlist.end());
+    std::sort(sorted.begin(), sorted.end());
+    if(std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end()) UNLIKELY
+        return alcSetError(nullptr, ALC_INVALID_VALUE);
+
+    std::call_once(LoopbackPoolOnce, []
+    {
+        const uint numthreads{ConfigValueUInt({}, {}, "loopback-batch-threads"sv)
+            .value_or(std::thread::hardware_concurrency())};
+        LoopbackPool = RenderPool::Create(std::min(numthreads, 256u));
+    });
+
+    auto jobs = std::vector<RenderPool::Job>(devlist.size());
+    std::transform(devlist.begin(), devlist.end(), buflist.begin(), jobs.begin(),
+        [](ALCdevice *device, ALCvoid *buffer) noexcept
+        { return RenderPool::Job{device, buffer}; });
+    if(LoopbackPool)
+        LoopbackPool->render(jobs, static_cast<uint>(samples));
+    else
+    {
+        for(const RenderPool::Job &job : jobs)
+            job.mDevice->renderSamples(job.mBuffer, static_cast<uint>(samples),
+                job.mDevice->channelsFromFmt());
+    }
+}
+
 
 /************************************************
  * ALC DSP pause/resume functions
@@ -3417,16 +4519,99 @@ ALC_API ALCboolean ALC_APIENTRY alcResetDeviceSOFT(ALCdevice *device, const ALCi
     std::lock_guard<std::mutex> statelock{dev->StateLock};
     listlock.unlock();
 
-    /* Force the backend to stop mixing first since we're resetting. Also reset
-     * the connected state so lost devices can attempt recover.
+    /* The backend is only stopped if the reset needs a different output format
+     * or the device was lost, otherwise the mixing state is reset in place.
      */
-    if(dev->mDeviceState == DeviceState::Playing)
+    return ResetDeviceParams(dev.get(), SpanFromAttributeList(attribs)) ? ALC_TRUE : ALC_FALSE;
+}
+
+
+/**
+ * Reloads the config files, and applies the options that can change without a
+ * reset: the resampler for newly created sources, and the device's dithering
+ * and output limiter, which the mixer switches to at its next update. Options
+ * that affect the output format or mixing layout apply with the next reset.
+ */
+ALC_API ALCboolean ALC_APIENTRY alcReloadConfigSOFT(ALCdevice *device) noexcept
+{
+    std::unique_lock<std::recursive_mutex> listlock{ListLock};
+    DeviceRef dev{VerifyDevice(device)};
+    if(!dev || dev->Type == DeviceType::Capture)
     {
-        dev->Backend->stop();
-        dev->mDeviceState = DeviceState::Configured;
+        listlock.unlock();
+        alcSetError(dev.get(), ALC_INVALID_DEVICE);
+        return ALC_FALSE;
     }
+    std::lock_guard<std::mutex> statelock{dev->StateLock};
+    listlock.unlock();
 
-    return ResetDeviceParams(dev.get(), SpanFromAttributeList(attribs)) ? ALC_TRUE : ALC_FALSE;
+    TRACE("Reloading config\n");
+    ReadALConfig();
+
+    Voice::SetDefaultResampler(ConfigValueStr({}, {}, "resampler"sv));
+    PrepareResamplerTables(ResamplerDefault.load(std::memory_order_relaxed));
+
+    /* An unprepared device gets its output settings when it's reset. */
+    if(dev->mDeviceState == DeviceState::Unprepared)
+        return ALC_TRUE;
+
+    const ALCdevice::OutputSettings &oldsettings = dev->mOutputSettings;
+    ALCdevice::OutputSettings settings{GetOutputSettings(dev.get())};
+    const bool newlimiter{settings.LimiterThreshold != oldsettings.LimiterThreshold
+        || (settings.LimiterThreshold && (settings.LimiterDivisor != oldsettings.LimiterDivisor
+            || settings.LimiterTruePeak != oldsettings.LimiterTruePeak))};
+    if(!newlimiter && settings.DitherDepth == oldsettings.DitherDepth
+        && settings.DitherShaped == oldsettings.DitherShaped)
+        return ALC_TRUE;
+
+    auto update = std::make_unique<DeviceBase::OutputUpdate>();
+    update->DitherDepth = settings.DitherDepth;
+    update->DitherShaped = settings.DitherShaped;
+    settings.LimiterLookAhead = oldsettings.LimiterLookAhead;
+    if(newlimiter)
+    {
+        update->ReplaceLimiter = true;
+        settings.LimiterLookAhead = 0;
+        if(settings.LimiterThreshold)
+        {
+            update->Limiter = CreateDeviceLimiter(dev.get(), *settings.LimiterThreshold,
+                settings.LimiterDivisor, settings.LimiterTruePeak);
+            settings.LimiterLookAhead = update->Limiter->getLookAhead();
+        }
+
+        dev->FixedLatency -= nanoseconds{seconds{oldsettings.LimiterLookAhead}} / dev->Frequency;
+        dev->FixedLatency += nanoseconds{seconds{settings.LimiterLookAhead}} / dev->Frequency;
+    }
+    dev->mOutputSettings = settings;
+    dev->postOutputUpdate(std::move(update));
+
+    return ALC_TRUE;
+}
+
+/** Sets a buffer to use the sample data of another device's buffer. */
+ALC_API ALCboolean ALC_APIENTRY alcBufferShareDataSOFT(ALCdevice *device, ALCuint buffer,
+    ALCdevice *srcdevice, ALCuint srcbuffer) noexcept
+{
+    DeviceRef dev{VerifyDevice(device)};
+    if(!dev || dev->Type == DeviceType::Capture)
+    {
+        alcSetError(dev.get(), ALC_INVALID_DEVICE);
+        return ALC_FALSE;
+    }
+    DeviceRef srcdev{VerifyDevice(srcdevice)};
+    if(!srcdev || srcdev->Type == DeviceType::Capture)
+    {
+        alcSetError(dev.get(), ALC_INVALID_DEVICE);
+        return ALC_FALSE;
+    }
+
+    if(const ALCenum err{ShareBufferData(dev.get(), buffer, srcdev.get(), srcbuffer)};
+        err != ALC_NO_ERROR)
+    {
+        alcSetError(dev.get(), err);
+        return ALC_FALSE;
+    }
+    return ALC_TRUE;
 }
 
 
@@ -3531,17 +4716,30 @@ FORCE_ALIGN ALCenum ALC_APIENTRY alcEventIsSupportedSOFT(ALCenum eventType, ALCe
         return ALC_EVENT_NOT_SUPPORTED_SOFT;
     }
 
+    /* HRTF loads are signaled by the library itself, not the backend. */
+    if(*etype == alc::EventType::HrtfReady)
+    {
+        if(deviceType == ALC_PLAYBACK_DEVICE_SOFT)
+            return ALC_EVENT_SUPPORTED_SOFT;
+        if(deviceType != ALC_CAPTURE_DEVICE_SOFT)
+        {
+            WARN("Invalid device type: 0x%04x\n", deviceType);
+            alcSetError(nullptr, ALC_INVALID_ENUM);
+        }
+        return ALC_EVENT_NOT_SUPPORTED_SOFT;
+    }
+
     auto supported = alc::EventSupport::NoSupport;
     switch(deviceType)
     {
         case ALC_PLAYBACK_DEVICE_SOFT:
-            if(PlaybackFactory)
-                supported = PlaybackFactory->queryEventSupport(*etype, BackendType::Playback);
+            if(BackendFactory *factory{GetPlaybackFactory()})
+                supported = factory->queryEventSupport(*etype, BackendType::Playback);
             break;
 
         case ALC_CAPTURE_DEVICE_SOFT:
-            if(CaptureFactory)
-                supported = CaptureFactory->queryEventSupport(*etype, BackendType::Capture);
+            if(BackendFactory *factory{GetCaptureFactory()})
+                supported = factory->queryEventSupport(*etype, BackendType::Capture);
             break;
 
         default:
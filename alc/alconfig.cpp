@@ -38,10 +38,12 @@
 #include <fstream>
 #include <istream>
 #include <limits>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <utility>
-#include <vector>
 
 #include "almalloc.h"
 #include "alstring.h"
@@ -67,11 +69,14 @@ struct CoTaskMemDeleter {
 };
 #endif
 
-struct ConfigEntry {
-    std::string key;
-    std::string value;
-};
-std::vector<ConfigEntry> ConfOpts;
+/* Options are keyed by their full "block/device/key" name, hashed so lookups
+ * don't scan every loaded option.
+ */
+std::unordered_map<std::string,std::string> ConfOpts;
+/* Guards ConfOpts, since the config can be reloaded while other threads are
+ * looking up options.
+ */
+std::shared_mutex ConfOptsLock;
 
 
 std::string &lstrip(std::string &line)
@@ -274,21 +279,12 @@ void LoadConfigFromFile(std::istream &f)
 
         TRACE(" setting '%s' = '%.*s'\n", fullKey.c_str(), al::sizei(valpart), valpart.data());
 
-        /* Check if we already have this option set */
-        auto find_key = [&fullKey](const ConfigEntry &entry) -> bool
-        { return entry.key == fullKey; };
-        auto ent = std::find_if(ConfOpts.begin(), ConfOpts.end(), find_key);
-        if(ent != ConfOpts.end())
-        {
-            if(!valpart.empty())
-                ent->value = expdup(valpart);
-            else
-                ConfOpts.erase(ent);
-        }
-        else if(!valpart.empty())
-            ConfOpts.emplace_back(ConfigEntry{std::move(fullKey), expdup(valpart)});
+        /* An empty value unsets any previous setting of this option. */
+        if(!valpart.empty())
+            ConfOpts.insert_or_assign(std::move(fullKey), expdup(valpart));
+        else
+            ConfOpts.erase(fullKey);
     }
-    ConfOpts.shrink_to_fit();
 }
 
 const char *GetConfigValue(const std::string_view devName, const std::string_view blockName,
@@ -297,7 +293,20 @@ const char *GetConfigValue(const std::string_view devName, const std::string_vie
     if(keyName.empty())
         return nullptr;
 
+    /* An option that's set but expanded to an empty string is treated as
+     * unset, without falling back to the device-agnostic option.
+     */
+    auto get_value = [](const auto iter) -> const char*
+    {
+        TRACE("Found option %s = \"%s\"\n", iter->first.c_str(), iter->second.c_str());
+        return iter->second.empty() ? nullptr : iter->second.c_str();
+    };
+
+    /* Build the device-specific key first, then reuse the block prefix to
+     * fall back to the device-agnostic key if it isn't set.
+     */
     std::string key;
+    key.reserve(blockName.size() + devName.size() + keyName.size() + 2);
     if(!blockName.empty() && al::case_compare(blockName, "general"sv) != 0)
     {
         key = blockName;
@@ -305,24 +314,18 @@ const char *GetConfigValue(const std::string_view devName, const std::string_vie
     }
     if(!devName.empty())
     {
+        const size_t prefixlen{key.size()};
         key += devName;
         key += '/';
+        key += keyName;
+        if(auto iter = ConfOpts.find(key); iter != ConfOpts.cend())
+            return get_value(iter);
+        key.resize(prefixlen);
     }
     key += keyName;
-
-    auto iter = std::find_if(ConfOpts.cbegin(), ConfOpts.cend(),
-        [&key](const ConfigEntry &entry) -> bool { return entry.key == key; });
-    if(iter != ConfOpts.cend())
-    {
-        TRACE("Found option %s = \"%s\"\n", key.c_str(), iter->value.c_str());
-        if(!iter->value.empty())
-            return iter->value.c_str();
-        return nullptr;
-    }
-
-    if(devName.empty())
-        return nullptr;
-    return GetConfigValue({}, blockName, keyName);
+    if(auto iter = ConfOpts.find(key); iter != ConfOpts.cend())
+        return get_value(iter);
+    return nullptr;
 }
 
 } // namespace
@@ -332,6 +335,9 @@ const char *GetConfigValue(const std::string_view devName, const std::string_vie
 void ReadALConfig()
 {
     namespace fs = std::filesystem;
+    std::lock_guard<std::shared_mutex> conflock{ConfOptsLock};
+    ConfOpts.clear();
+
     fs::path path;
 
 #if !defined(_GAMING_XBOX)
@@ -382,6 +388,9 @@ void ReadALConfig()
 void ReadALConfig()
 {
     namespace fs = std::filesystem;
+    std::lock_guard<std::shared_mutex> conflock{ConfOptsLock};
+    ConfOpts.clear();
+
     fs::path path{"/etc/openal/alsoft.conf"};
 
     TRACE("Loading config %s...\n", path.u8string().c_str());
@@ -489,6 +498,7 @@ void ReadALConfig()
 std::optional<std::string> ConfigValueStr(const std::string_view devName,
     const std::string_view blockName, const std::string_view keyName)
 {
+    std::shared_lock<std::shared_mutex> conflock{ConfOptsLock};
     if(const char *val{GetConfigValue(devName, blockName, keyName)})
         return val;
     return std::nullopt;
@@ -497,6 +507,7 @@ std::optional<std::string> ConfigValueStr(const std::string_view devName,
 std::optional<int> ConfigValueInt(const std::string_view devName, const std::string_view blockName,
     const std::string_view keyName)
 {
+    std::shared_lock<std::shared_mutex> conflock{ConfOptsLock};
     if(const char *val{GetConfigValue(devName, blockName, keyName)})
         return static_cast<int>(std::strtol(val, nullptr, 0));
     return std::nullopt;
@@ -505,6 +516,7 @@ std::optional<int> ConfigValueInt(const std::string_view devName, const std::str
 std::optional<unsigned int> ConfigValueUInt(const std::string_view devName,
     const std::string_view blockName, const std::string_view keyName)
 {
+    std::shared_lock<std::shared_mutex> conflock{ConfOptsLock};
     if(const char *val{GetConfigValue(devName, blockName, keyName)})
         return static_cast<unsigned int>(std::strtoul(val, nullptr, 0));
     return std::nullopt;
@@ -513,6 +525,7 @@ std::optional<unsigned int> ConfigValueUInt(const std::string_view devName,
 std::optional<float> ConfigValueFloat(const std::string_view devName,
     const std::string_view blockName, const std::string_view keyName)
 {
+    std::shared_lock<std::shared_mutex> conflock{ConfOptsLock};
     if(const char *val{GetConfigValue(devName, blockName, keyName)})
         return std::strtof(val, nullptr);
     return std::nullopt;
@@ -521,6 +534,7 @@ std::optional<float> ConfigValueFloat(const std::string_view devName,
 std::optional<bool> ConfigValueBool(const std::string_view devName,
     const std::string_view blockName, const std::string_view keyName)
 {
+    std::shared_lock<std::shared_mutex> conflock{ConfOptsLock};
     if(const char *val{GetConfigValue(devName, blockName, keyName)})
         return al::strcasecmp(val, "on") == 0 || al::strcasecmp(val, "yes") == 0
             || al::strcasecmp(val, "true") == 0 || atoi(val) != 0;
@@ -530,6 +544,7 @@ std::optional<bool> ConfigValueBool(const std::string_view devName,
 bool GetConfigValueBool(const std::string_view devName, const std::string_view blockName,
     const std::string_view keyName, bool def)
 {
+    std::shared_lock<std::shared_mutex> conflock{ConfOptsLock};
     if(const char *val{GetConfigValue(devName, blockName, keyName)})
         return al::strcasecmp(val, "on") == 0 || al::strcasecmp(val, "yes") == 0
             || al::strcasecmp(val, "true") == 0 || atoi(val) != 0;
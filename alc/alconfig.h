@@ -6,6 +6,7 @@
 #include <string_view>
 
 
+/* Reads the config files, replacing any previously loaded options. */
 void ReadALConfig();
 
 bool GetConfigValueBool(const std::string_view devName, const std::string_view blockName,
@@ -32,15 +32,22 @@
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <functional>
 #include <iterator>
 #include <limits>
 #include <memory>
 #include <new>
 #include <optional>
+#include <tuple>
 #include <utility>
 
+#ifdef HAVE_SSE_INTRINSICS
+#include <emmintrin.h>
+#endif
+
 #include "almalloc.h"
+#include "albit.h"
 #include "alnumbers.h"
 #include "alnumeric.h"
 #include "alspan.h"
@@ -55,6 +62,7 @@
 #include "core/bufferline.h"
 #include "core/buffer_storage.h"
 #include "core/context.h"
+#include "core/converter.h"
 #include "core/cpu_caps.h"
 #include "core/cubic_tables.h"
 #include "core/devformat.h"
@@ -65,16 +73,21 @@
 #include "core/filters/nfc.h"
 #include "core/fpu_ctrl.h"
 #include "core/hrtf.h"
+#include "core/logging.h"
 #include "core/mastering.h"
 #include "core/mixer.h"
 #include "core/mixer/defs.h"
 #include "core/mixer/hrtfdefs.h"
+#include "core/mixer_pool.h"
+#include "core/param_thread.h"
 #include "core/resampler_limits.h"
+#include "core/tracing.h"
 #include "core/uhjfilter.h"
 #include "core/voice.h"
 #include "core/voice_change.h"
 #include "intrusive_ptr.h"
 #include "opthelpers.h"
+#include "pffft.h"
 #include "ringbuffer.h"
 #include "strutils.h"
 #include "vecmat.h"
@@ -90,6 +103,9 @@ struct SSE2Tag;
 #ifdef HAVE_SSE4_1
 struct SSE4Tag;
 #endif
+#ifdef HAVE_AVX2
+struct AVX2Tag;
+#endif
 #ifdef HAVE_NEON
 struct NEONTag;
 #endif
@@ -98,6 +114,8 @@ struct LerpTag;
 struct CubicTag;
 struct BSincTag;
 struct FastBSincTag;
+struct BSincPolyTag;
+struct FastBSincPolyTag;
 
 
 static_assert(!(MaxResamplerPadding&1), "MaxResamplerPadding is not a multiple of two");
@@ -109,23 +127,10 @@ using uint = unsigned int;
 using namespace std::chrono;
 using namespace std::string_view_literals;
 
-float InitConeScale()
-{
-    float ret{1.0f};
-    if(auto optval = al::getenv("__ALSOFT_HALF_ANGLE_CONES"))
-    {
-        if(al::case_compare(*optval, "true"sv) == 0
-            || strtol(optval->c_str(), nullptr, 0) == 1)
-            ret *= 0.5f;
-    }
-    return ret;
-}
-/* Cone scalar */
-const float ConeScale{InitConeScale()};
-
-/* Localized scalars for mono sources (initialized in aluInit, after
- * configuration is loaded).
+/* Cone scalar, and localized scalars for mono sources (initialized in aluInit,
+ * after configuration is loaded).
  */
+float ConeScale{1.0f};
 float XScale{1.0f};
 float YScale{1.0f};
 float ZScale{1.0f};
@@ -147,6 +152,10 @@ inline HrtfDirectMixerFunc SelectHrtfMixer()
     if((CPUCapFlags&CPU_CAP_NEON))
         return MixDirectHrtf_<NEONTag>;
 #endif
+#ifdef HAVE_AVX2
+    if((CPUCapFlags&CPU_CAP_AVX2))
+        return MixDirectHrtf_<AVX2Tag>;
+#endif
 #ifdef HAVE_SSE
     if((CPUCapFlags&CPU_CAP_SSE))
         return MixDirectHrtf_<SSETag>;
@@ -179,6 +188,13 @@ inline void BsincPrepare(const uint increment, BsincState *state, const BSincTab
     state->filter = table->Tab.subspan(table->filterOffset[si]);
 }
 
+/* Increments that are a multiple of 0.5 (e.g. 24khz->48khz, 48khz->48khz,
+ * 96khz->48khz) only ever use one or two filter phases, which the bsinc
+ * resamplers can calculate once for each mix instead of for each sample.
+ */
+constexpr bool IsPolyphaseIncrement(uint increment) noexcept
+{ return ((increment*2u) & MixerFracMask) == 0; }
+
 inline ResamplerFunc SelectResampler(Resampler resampler, uint increment)
 {
     switch(resampler)
@@ -190,6 +206,10 @@ inline ResamplerFunc SelectResampler(Resampler resampler, uint increment)
         if((CPUCapFlags&CPU_CAP_NEON))
             return Resample_<LerpTag,NEONTag>;
 #endif
+#ifdef HAVE_AVX2
+        if((CPUCapFlags&CPU_CAP_AVX2))
+            return Resample_<LerpTag,AVX2Tag>;
+#endif
 #ifdef HAVE_SSE4_1
         if((CPUCapFlags&CPU_CAP_SSE4_1))
             return Resample_<LerpTag,SSE4Tag>;
@@ -205,6 +225,10 @@ inline ResamplerFunc SelectResampler(Resampler resampler, uint increment)
         if((CPUCapFlags&CPU_CAP_NEON))
             return Resample_<CubicTag,NEONTag>;
 #endif
+#ifdef HAVE_AVX2
+        if((CPUCapFlags&CPU_CAP_AVX2))
+            return Resample_<CubicTag,AVX2Tag>;
+#endif
 #ifdef HAVE_SSE4_1
         if((CPUCapFlags&CPU_CAP_SSE4_1))
             return Resample_<CubicTag,SSE4Tag>;
@@ -225,6 +249,22 @@ inline ResamplerFunc SelectResampler(Resampler resampler, uint increment)
 #ifdef HAVE_NEON
             if((CPUCapFlags&CPU_CAP_NEON))
                 return Resample_<BSincTag,NEONTag>;
+#endif
+            if(IsPolyphaseIncrement(increment))
+            {
+#ifdef HAVE_AVX2
+                if((CPUCapFlags&CPU_CAP_AVX2))
+                    return Resample_<BSincPolyTag,AVX2Tag>;
+#endif
+#ifdef HAVE_SSE
+                if((CPUCapFlags&CPU_CAP_SSE))
+                    return Resample_<BSincPolyTag,SSETag>;
+#endif
+                return Resample_<BSincPolyTag,CTag>;
+            }
+#ifdef HAVE_AVX2
+            if((CPUCapFlags&CPU_CAP_AVX2))
+                return Resample_<BSincTag,AVX2Tag>;
 #endif
 #ifdef HAVE_SSE
             if((CPUCapFlags&CPU_CAP_SSE))
@@ -238,6 +278,22 @@ inline ResamplerFunc SelectResampler(Resampler resampler, uint increment)
 #ifdef HAVE_NEON
         if((CPUCapFlags&CPU_CAP_NEON))
             return Resample_<FastBSincTag,NEONTag>;
+#endif
+        if(IsPolyphaseIncrement(increment))
+        {
+#ifdef HAVE_AVX2
+            if((CPUCapFlags&CPU_CAP_AVX2))
+                return Resample_<FastBSincPolyTag,AVX2Tag>;
+#endif
+#ifdef HAVE_SSE
+            if((CPUCapFlags&CPU_CAP_SSE))
+                return Resample_<FastBSincPolyTag,SSETag>;
+#endif
+            return Resample_<FastBSincPolyTag,CTag>;
+        }
+#ifdef HAVE_AVX2
+        if((CPUCapFlags&CPU_CAP_AVX2))
+            return Resample_<FastBSincTag,AVX2Tag>;
 #endif
 #ifdef HAVE_SSE
         if((CPUCapFlags&CPU_CAP_SSE))
@@ -254,6 +310,16 @@ inline ResamplerFunc SelectResampler(Resampler resampler, uint increment)
 void aluInit(CompatFlagBitset flags, const float nfcscale)
 {
     MixDirectHrtf = SelectHrtfMixer();
+    pffft_enable_avx2((CPUCapFlags&CPU_CAP_AVX2) != 0);
+
+    ConeScale = 1.0f;
+    if(auto optval = al::getenv("__ALSOFT_HALF_ANGLE_CONES"))
+    {
+        if(al::case_compare(*optval, "true"sv) == 0
+            || strtol(optval->c_str(), nullptr, 0) == 1)
+            ConeScale *= 0.5f;
+    }
+
     XScale = flags.test(CompatFlags::ReverseX) ? -1.0f : 1.0f;
     YScale = flags.test(CompatFlags::ReverseY) ? -1.0f : 1.0f;
     ZScale = flags.test(CompatFlags::ReverseZ) ? -1.0f : 1.0f;
@@ -270,23 +336,43 @@ ResamplerFunc PrepareResampler(Resampler resampler, uint increment, InterpState
     case Resampler::Linear:
         break;
     case Resampler::Spline:
-        state->emplace<CubicState>(al::span{gSplineFilter.mTable});
+        state->emplace<CubicState>(al::span{GetSplineTable().mTable});
         break;
     case Resampler::Gaussian:
-        state->emplace<CubicState>(al::span{gGaussianFilter.mTable});
+        state->emplace<CubicState>(al::span{GetGaussianTable().mTable});
         break;
     case Resampler::FastBSinc12:
     case Resampler::BSinc12:
-        BsincPrepare(increment, &state->emplace<BsincState>(), &gBSinc12);
+        BsincPrepare(increment, &state->emplace<BsincState>(), &GetBSinc12Table());
         break;
     case Resampler::FastBSinc24:
     case Resampler::BSinc24:
-        BsincPrepare(increment, &state->emplace<BsincState>(), &gBSinc24);
+        BsincPrepare(increment, &state->emplace<BsincState>(), &GetBSinc24Table());
         break;
     }
     return SelectResampler(resampler, increment);
 }
 
+void PrepareResamplerTables(Resampler resampler)
+{
+    switch(resampler)
+    {
+    case Resampler::Point:
+    case Resampler::Linear:
+        break;
+    case Resampler::Spline: std::ignore = GetSplineTable(); break;
+    case Resampler::Gaussian: std::ignore = GetGaussianTable(); break;
+    case Resampler::FastBSinc12:
+    case Resampler::BSinc12:
+        std::ignore = GetBSinc12Table();
+        break;
+    case Resampler::FastBSinc24:
+    case Resampler::BSinc24:
+        std::ignore = GetBSinc24Table();
+        break;
+    }
+}
+
 
 void DeviceBase::ProcessHrtf(const size_t SamplesToDo)
 {
@@ -294,8 +380,12 @@ void DeviceBase::ProcessHrtf(const size_t SamplesToDo)
     const size_t lidx{RealOut.ChannelIndex[FrontLeft]};
     const size_t ridx{RealOut.ChannelIndex[FrontRight]};
 
-    MixDirectHrtf(RealOut.Buffer[lidx], RealOut.Buffer[ridx], Dry.Buffer, HrtfAccumData,
-        mHrtfState->mTemp, mHrtfState->mChannels, mHrtfState->mIrSize, SamplesToDo);
+    if(mHrtfState->mFft)
+        mHrtfState->mixFft(RealOut.Buffer[lidx], RealOut.Buffer[ridx], Dry.Buffer,
+            HrtfAccumData, SamplesToDo);
+    else
+        MixDirectHrtf(RealOut.Buffer[lidx], RealOut.Buffer[ridx], Dry.Buffer, HrtfAccumData,
+            mHrtfState->mTemp, mHrtfState->mChannels, mHrtfState->mIrSize, SamplesToDo);
 }
 
 void DeviceBase::ProcessAmbiDec(const size_t SamplesToDo)
@@ -306,11 +396,7 @@ void DeviceBase::ProcessAmbiDec(const size_t SamplesToDo)
 void DeviceBase::ProcessAmbiDecStablized(const size_t SamplesToDo)
 {
     /* Decode with front image stablization. */
-    const size_t lidx{RealOut.ChannelIndex[FrontLeft]};
-    const size_t ridx{RealOut.ChannelIndex[FrontRight]};
-    const size_t cidx{RealOut.ChannelIndex[FrontCenter]};
-
-    AmbiDecoder->processStablize(RealOut.Buffer, Dry.Buffer, lidx, ridx, cidx, SamplesToDo);
+    AmbiDecoder->processStablize(RealOut.Buffer, Dry.Buffer, SamplesToDo);
 }
 
 void DeviceBase::ProcessUhj(const size_t SamplesToDo)
@@ -340,22 +426,13 @@ void DeviceBase::ProcessBs2b(const size_t SamplesToDo)
 
 namespace {
 
-/* This RNG method was created based on the math found in opusdec. It's quick,
- * and starting with a seed value of 22222, is suitable for generating
- * whitenoise.
- */
-inline uint dither_rng(uint *seed) noexcept
-{
-    *seed = (*seed * 96314165) + 907633515;
-    return *seed;
-}
-
-
 /* Ambisonic upsampler function. It's effectively a matrix multiply. It takes
  * an 'upsampler' and 'rotator' as the input matrices, and creates a matrix
  * that behaves as if the B-Format input was first decoded to a speaker array
  * at its input order, encoded back into the higher order mix, then finally
- * rotated.
+ * rotated. Both inputs are sparse; an upsampler row only touches a few
+ * channels, and a rotation only mixes channels within the same order, so only
+ * the nonzero parts are accumulated.
  */
 void UpsampleBFormatTransform(
     const al::span<std::array<float,MaxAmbiChannels>,MaxAmbiChannels> output,
@@ -371,11 +448,13 @@ void UpsampleBFormatTransform(
         for(size_t k{0};k < num_chans;++k)
         {
             const float a{upsampler[i][k]};
-            /* Write the full number of channels. The compiler will have an
-             * easier time optimizing if it has a fixed length.
-             */
-            std::transform(rotator[k].cbegin(), rotator[k].cend(), output[i].cbegin(),
-                output[i].begin(), [a](float rot, float dst) noexcept { return rot*a + dst; });
+            if(a == 0.0f) continue;
+
+            const size_t order{AmbiIndex::OrderFromChannel[k]};
+            const auto rotrow = al::span{rotator[k]}.subspan(order*order, order*2 + 1);
+            const auto outrow = al::span{output[i]}.subspan(order*order, order*2 + 1);
+            std::transform(rotrow.begin(), rotrow.end(), outrow.begin(), outrow.begin(),
+                [a](float rot, float dst) noexcept { return rot*a + dst; });
         }
     }
 }
@@ -443,11 +522,63 @@ bool CalcContextParams(ContextBase *ctx)
     ctx->mParams.SourceDistanceModel = props->SourceDistanceModel;
     ctx->mParams.mDistanceModel = props->mDistanceModel;
 
-    AtomicReplaceHead(ctx->mFreeContextProps, props);
+    /* The extra listeners output to the front-left and -right channels by
+     * default, or front-center for mono output.
+     */
+    const DeviceBase *device{ctx->mDevice};
+    const uint numListeners{device->NumListeners-1};
+    for(uint i{0};i < numListeners;++i)
+    {
+        const auto &lprops = props->ExtraListeners[i];
+        auto &lparams = ctx->mParams.ExtraListeners[i];
+
+        alu::Vector at{lprops.OrientAt[0], lprops.OrientAt[1], lprops.OrientAt[2], 0.0f};
+        at.normalize();
+        alu::Vector up{lprops.OrientUp[0], lprops.OrientUp[1], lprops.OrientUp[2], 0.0f};
+        up.normalize();
+        alu::Vector right{at.cross_product(up)};
+        right.normalize();
+
+        lparams.Matrix = alu::Matrix{
+            right[0], up[0], -at[0], 0.0,
+            right[1], up[1], -at[1], 0.0,
+            right[2], up[2], -at[2], 0.0,
+                 0.0,   0.0,    0.0, 1.0};
+        lparams.Position = alu::Vector{lprops.Position[0], lprops.Position[1],
+            lprops.Position[2], 1.0f};
+        lparams.Gain = lprops.Gain * ctx->mGainBoost;
+
+        const uint center{device->channelIdxByName(FrontCenter)};
+        const std::array defchans{device->channelIdxByName(FrontLeft),
+            device->channelIdxByName(FrontRight)};
+        for(size_t side{0};side < 2;++side)
+        {
+            if(lprops.Output[side] >= 0)
+                lparams.Output[side] = static_cast<uint>(lprops.Output[side]);
+            else if(defchans[side] != InvalidChannelIndex)
+                lparams.Output[side] = defchans[side];
+            else
+                lparams.Output[side] = center;
+        }
+    }
+
+    ctx->mFreeContextProps.push(props);
     return true;
 }
 
-bool CalcEffectSlotParams(EffectSlot *slot, EffectSlot **sorted_slots, ContextBase *context)
+/* Gets the mix an effect slot outputs to, either the slot it targets or the
+ * device output.
+ */
+EffectTarget GetEffectSlotTarget(const EffectSlot *slot, ContextBase *context)
+{
+    if(EffectSlot *target{slot->Target})
+        return EffectTarget{&target->Wet, nullptr};
+    DeviceBase *device{context->mDevice};
+    return EffectTarget{&device->Dry, &device->RealOut};
+}
+
+bool CalcEffectSlotParams(EffectSlot *slot, EffectSlot **sorted_slots, ContextBase *context,
+    bool &wetChanged)
 {
     EffectSlotProps *props{slot->Update.exchange(nullptr, std::memory_order_acq_rel)};
     if(!props) return false;
@@ -460,6 +591,7 @@ bool CalcEffectSlotParams(EffectSlot *slot, EffectSlot **sorted_slots, ContextBa
     slot->Gain = props->Gain;
     slot->AuxSendAuto = props->AuxSendAuto;
     slot->Target = props->Target;
+    slot->mSleeping = false;
     slot->EffectType = props->Type;
     slot->mEffectProps = props->Props;
     if(auto *reverbprops = std::get_if<ReverbProps>(&props->Props))
@@ -485,6 +617,35 @@ bool CalcEffectSlotParams(EffectSlot *slot, EffectSlot **sorted_slots, ContextBa
     EffectState *oldstate{slot->mEffectState.release()};
     slot->mEffectState.reset(state);
 
+    /* Only use as many wet buffer channels as the effect reads. The buffer is
+     * allocated for the full ambisonic order, so this just limits the span.
+     */
+    const size_t numWet{std::min(slot->mWetBuffer.size(), state->inputChannels())};
+    if(slot->Wet.Buffer.size() != numWet)
+    {
+        slot->Wet.Buffer = al::span{slot->mWetBuffer}.first(numWet);
+        wetChanged = true;
+    }
+
+    /* Let the app know when a state that was prepared in the background starts
+     * being used.
+     */
+    if(props->ReadyId != 0 && state != oldstate)
+    {
+        const auto enabledevt = context->mEnabledEvts.load(std::memory_order_acquire);
+        if(enabledevt.test(al::to_underlying(AsyncEnableBits::EffectSlotReady)))
+        {
+            RingBuffer *ring{context->mAsyncEvents.get()};
+            auto evt_vec = ring->getWriteVector();
+            if(evt_vec.first.len > 0)
+            {
+                auto &evt = InitAsyncEvent<AsyncEffectSlotReadyEvent>(evt_vec.first.buf);
+                evt.mId = props->ReadyId;
+                ring->writeAdvance(1);
+            }
+        }
+    }
+
     /* Only release the old state if it won't get deleted, since we can't be
      * deleting/freeing anything in the mixer.
      */
@@ -510,20 +671,42 @@ bool CalcEffectSlotParams(EffectSlot *slot, EffectSlot **sorted_slots, ContextBa
         }
     }
 
-    AtomicReplaceHead(context->mFreeEffectSlotProps, props);
+    context->mFreeEffectSlotProps.push(props);
 
-    const auto output = [slot,context]() -> EffectTarget
-    {
-        if(EffectSlot *target{slot->Target})
-            return EffectTarget{&target->Wet, nullptr};
-        DeviceBase *device{context->mDevice};
-        return EffectTarget{&device->Dry, &device->RealOut};
-    }();
+    const EffectTarget output{GetEffectSlotTarget(slot, context)};
     state->update(context, slot, &slot->mEffectProps, output);
+
+    /* A dedicated effect outputting to a real output channel only applies a
+     * gain to the W channel, so voices can mix into that channel directly.
+     */
+    slot->mDirectOut.Buffer = {};
+    auto *dedicated = std::get_if<DedicatedProps>(&slot->mEffectProps);
+    if(dedicated && output.RealOut)
+    {
+        const auto chan = (dedicated->Target == DedicatedProps::Dialog) ? FrontCenter : LFE;
+        if(const uint idx{output.RealOut->ChannelIndex[chan]}; idx != InvalidChannelIndex)
+        {
+            slot->mDirectOut.AmbiMap[0] = BFChannelConfig{slot->Gain * dedicated->Gain, 0};
+            slot->mDirectOut.Buffer = output.RealOut->Buffer.subspan(idx, 1);
+        }
+    }
     return true;
 }
 
 
+/* Gets the HRIR coefficients and delays for a direction, through the
+ * device's coefficient cache if it has one.
+ */
+void GetHrtfCoeffs(const DeviceBase *device, const float elevation, const float azimuth,
+    const float distance, const float spread, const HrirSpan coeffs,
+    const al::span<uint,2> delays)
+{
+    if(HrtfCoeffCache *cache{device->mHrtfCoeffCache.get()})
+        cache->getCoeffs(*device->mHrtf, elevation, azimuth, distance, spread, coeffs, delays);
+    else
+        device->mHrtf->getCoeffs(elevation, azimuth, distance, spread, coeffs, delays);
+}
+
 /* Scales the azimuth of the given vector by 3 if it's in front. Effectively
  * scales +/-30 degrees to +/-90 degrees, leaving > +90 and < -90 alone.
  */
@@ -784,6 +967,84 @@ struct ChanPosMap {
 
 struct GainTriplet { float Base, HF, LF; };
 
+/* A small cache of filter coefficients, keyed on the parameters that make
+ * them. Sources often share a few filter settings (e.g. occlusion presets),
+ * which can reuse the coefficients instead of recalculating them. Voices may
+ * be updated on different threads, so each thread gets its own cache.
+ */
+class FilterCoeffCache {
+    struct Entry {
+        BiquadType mType{};
+        float mF0Norm{}, mGain{}, mSlope{};
+        BiquadFilter mFilter;
+        bool mValid{false};
+    };
+    std::array<Entry,32> mEntries;
+
+public:
+    auto getFromSlope(const BiquadType type, const float f0norm, const float gain,
+        const float slope) -> const BiquadFilter&
+    {
+        const size_t hash{(al::bit_cast<uint>(f0norm) ^ (al::bit_cast<uint>(gain)>>7)
+            ^ static_cast<uint>(type))*0x9e3779b1u >> 27};
+        Entry &entry = mEntries[hash];
+        if(!entry.mValid || entry.mType != type || entry.mF0Norm != f0norm
+            || entry.mGain != gain || entry.mSlope != slope)
+        {
+            entry.mFilter.setParamsFromSlope(type, f0norm, gain, slope);
+            entry.mType = type;
+            entry.mF0Norm = f0norm;
+            entry.mGain = gain;
+            entry.mSlope = slope;
+            entry.mValid = true;
+        }
+        return entry.mFilter;
+    }
+};
+thread_local FilterCoeffCache tFilterCoeffCache;
+
+/* Sets the low- and high-shelf filters of a voice's dry or wet mix, returning
+ * the filter type to apply. Stages with unity gain are skipped, leaving their
+ * filters unset. getparams(chan) returns the mix parameters of the given
+ * voice channel.
+ */
+template<typename F>
+int SetVoiceFilters(const size_t num_channels, const GainTriplet &gain, const float hfNorm,
+    const float lfNorm, F&& getparams)
+{
+    int type{AF_None};
+    if(gain.HF != 1.0f)
+    {
+        const BiquadFilter &filter = tFilterCoeffCache.getFromSlope(BiquadType::HighShelf,
+            hfNorm, gain.HF, 1.0f);
+        for(size_t c{0};c < num_channels;c++)
+            getparams(c).LowPass.copyParamsFrom(filter);
+        type |= AF_LowPass;
+    }
+    if(gain.LF != 1.0f)
+    {
+        const BiquadFilter &filter = tFilterCoeffCache.getFromSlope(BiquadType::LowShelf,
+            lfNorm, gain.LF, 1.0f);
+        for(size_t c{0};c < num_channels;c++)
+            getparams(c).HighPass.copyParamsFrom(filter);
+        type |= AF_HighPass;
+    }
+    return type;
+}
+
+/* Checks if a voice should be panned with less detail for the given dry gain,
+ * with some hysteresis so it doesn't keep switching near the level.
+ */
+bool UseLowDetailPanning(const Voice *voice, const float drygain, const DeviceBase *device)
+    noexcept
+{
+    if(!(device->mLowDetailGain > 0.0f) || voice->mFmtChannels != FmtMono)
+        return false;
+    if(voice->mFlags.test(VoiceIsLowDetail))
+        return !(drygain > device->mFullDetailGain);
+    return drygain < device->mLowDetailGain;
+}
+
 void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, const float zpos,
     const float Distance, const float Spread, const GainTriplet &DryGain,
     const al::span<const GainTriplet,MaxSendCount> WetGain,
@@ -836,7 +1097,7 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
         ChanPosMap{FrontRight,  std::array{ sin30, 0.0f, -cos30}},
     };
 
-    const auto Frequency = static_cast<float>(Device->Frequency);
+    const auto Frequency = static_cast<float>(Device->mMixFrequency);
     const uint NumSends{Device->NumAuxSends};
 
     const size_t num_channels{voice->mChans.size()};
@@ -844,11 +1105,25 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
 
     for(auto &chandata : voice->mChans)
     {
-        chandata.mDryParams.Hrtf.Target = HrtfFilter{};
-        chandata.mDryParams.Gains.Target.fill(0.0f);
+        if(chandata.mDryParams.Hrtf)
+            chandata.mDryParams.Hrtf->Target = HrtfFilter{};
+        std::fill(chandata.mDryParams.Gains.Target.begin(),
+            chandata.mDryParams.Gains.Target.end(), 0.0f);
         std::for_each(chandata.mWetParams.begin(), chandata.mWetParams.begin()+NumSends,
-            [](SendParams &params) -> void { params.Gains.Target.fill(0.0f); });
+            [](SendParams &params) -> void
+            { std::fill(params.Gains.Target.begin(), params.Gains.Target.end(), 0.0f); });
     }
+    voice->mDirect.Buffer = Device->Dry.Buffer;
+
+    /* Quiet mono sources are panned with first-order coefficients, and skip
+     * NFC and HRTF filtering.
+     */
+    const bool lowDetail{UseLowDetailPanning(voice, DryGain.Base, Device)};
+    voice->mFlags.set(VoiceIsLowDetail, lowDetail);
+    /* Mono sources past the HRTF voice limit are panned into the ambisonic
+     * mix, rather than getting their own HRTF filters.
+     */
+    const bool hrtfLimited{voice->mFlags.test(VoiceIsHrtfLimited)};
 
     const auto getChans = [props,&StereoMap](FmtChannels chanfmt) noexcept
         -> std::pair<DirectMode,al::span<const ChanPosMap>>
@@ -929,7 +1204,20 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
         return mingain;
     };
 
-    if(IsAmbisonic(voice->mFmtChannels))
+    if(props->DirectRoute >= 0 && !IsAmbisonic(voice->mFmtChannels))
+    {
+        /* Routed sources write each channel straight to consecutive real
+         * outputs, starting at the given one, with no panning or sends.
+         * Channels past the last output are dropped.
+         */
+        voice->mDirect.Buffer = Device->RealOut.Buffer;
+
+        const auto first = static_cast<size_t>(props->DirectRoute);
+        const size_t numouts{Device->RealOut.Buffer.size()};
+        for(size_t c{0};c < num_channels && first+c < numouts;++c)
+            voice->mChans[c].mDryParams.Gains.Target[first+c] = DryGain.Base;
+    }
+    else if(IsAmbisonic(voice->mFmtChannels))
     {
         /* Special handling for B-Format and UHJ sources. */
 
@@ -984,7 +1272,7 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
             for(uint i{0};i < NumSends;i++)
             {
                 if(const EffectSlot *Slot{SendSlots[i]})
-                    ComputePanGains(&Slot->Wet, coeffs, WetGain[i].Base*scales[0],
+                    ComputePanGains(Slot->getSendTarget(), coeffs, WetGain[i].Base*scales[0],
                         voice->mChans[0].mWetParams[i].Gains.Target);
             }
         }
@@ -1003,72 +1291,85 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
                 N = Context.Matrix * N;
                 V = Context.Matrix * V;
             }
-            /* Build and normalize right-vector */
-            alu::Vector U{N.cross_product(V)};
-            U.normalize();
 
-            /* Build a rotation matrix. Manually fill the zeroth- and first-
-             * order elements, then construct the rotation for the higher
-             * orders.
+            /* Get the ACN of each input channel, for the input ordering and
+             * whether input is 2D or 3D.
              */
-            AmbiRotateMatrix &shrot = Device->mAmbiRotateMatrix;
-            shrot.fill(AmbiRotateMatrix::value_type{});
-
-            shrot[0][0] = 1.0f;
-            shrot[1][1] =  U[0]; shrot[1][2] = -U[1]; shrot[1][3] =  U[2];
-            shrot[2][1] = -V[0]; shrot[2][2] =  V[1]; shrot[2][3] = -V[2];
-            shrot[3][1] = -N[0]; shrot[3][2] =  N[1]; shrot[3][3] = -N[2];
-            AmbiRotator(shrot, static_cast<int>(Device->mAmbiOrder));
+            const auto index_map = Is2DAmbisonic(voice->mFmtChannels) ?
+                GetAmbi2DLayout(voice->mAmbiLayout).subspan(0) :
+                GetAmbiLayout(voice->mAmbiLayout).subspan(0);
 
-            /* If the device is higher order than the voice, "upsample" the
-             * matrix.
-             *
-             * NOTE: Starting with second-order, a 2D upsample needs to be
-             * applied with a 2D source and 3D output, even when they're the
-             * same order. This is because higher orders have a height offset
-             * on various channels (i.e. when elevation=0, those height-related
-             * channels should be non-0).
+            /* The rotation only depends on the orientation, so only rebuild it
+             * when that changes. Otherwise each channel keeps the rotation
+             * from the last update.
              */
-            AmbiRotateMatrix &mixmatrix = Device->mAmbiRotateMatrix2;
-            if(Device->mAmbiOrder > voice->mAmbiOrder
-                || (Device->mAmbiOrder >= 2 && !Device->m2DMixing
-                    && Is2DAmbisonic(voice->mFmtChannels)))
+            const auto orientation = std::array{N[0], N[1], N[2], V[0], V[1], V[2]};
+            if(!voice->mAmbiRotationValid || voice->mAmbiOrientation != orientation)
             {
-                if(voice->mAmbiOrder == 1)
-                {
-                    const auto upsampler = Is2DAmbisonic(voice->mFmtChannels) ?
-                        al::span{AmbiScale::FirstOrder2DUp} : al::span{AmbiScale::FirstOrderUp};
-                    UpsampleBFormatTransform(mixmatrix, upsampler, shrot, Device->mAmbiOrder);
-                }
-                else if(voice->mAmbiOrder == 2)
-                {
-                    const auto upsampler = Is2DAmbisonic(voice->mFmtChannels) ?
-                        al::span{AmbiScale::SecondOrder2DUp} : al::span{AmbiScale::SecondOrderUp};
-                    UpsampleBFormatTransform(mixmatrix, upsampler, shrot, Device->mAmbiOrder);
-                }
-                else if(voice->mAmbiOrder == 3)
-                {
-                    const auto upsampler = Is2DAmbisonic(voice->mFmtChannels) ?
-                        al::span{AmbiScale::ThirdOrder2DUp} : al::span{AmbiScale::ThirdOrderUp};
-                    UpsampleBFormatTransform(mixmatrix, upsampler, shrot, Device->mAmbiOrder);
-                }
-                else if(voice->mAmbiOrder == 4)
+                /* Build and normalize right-vector */
+                alu::Vector U{N.cross_product(V)};
+                U.normalize();
+
+                /* Build a rotation matrix. Manually fill the zeroth- and
+                 * first-order elements, then construct the rotation for the
+                 * higher orders.
+                 */
+                AmbiRotateMatrix shrot{};
+                shrot[0][0] = 1.0f;
+                shrot[1][1] =  U[0]; shrot[1][2] = -U[1]; shrot[1][3] =  U[2];
+                shrot[2][1] = -V[0]; shrot[2][2] =  V[1]; shrot[2][3] = -V[2];
+                shrot[3][1] = -N[0]; shrot[3][2] =  N[1]; shrot[3][3] = -N[2];
+                AmbiRotator(shrot, static_cast<int>(Device->mAmbiOrder));
+
+                /* If the device is higher order than the voice, "upsample" the
+                 * matrix.
+                 *
+                 * NOTE: Starting with second-order, a 2D upsample needs to be
+                 * applied with a 2D source and 3D output, even when they're
+                 * the same order. This is because higher orders have a height
+                 * offset on various channels (i.e. when elevation=0, those
+                 * height-related channels should be non-0).
+                 */
+                AmbiRotateMatrix mixmatrix{};
+                if(Device->mAmbiOrder > voice->mAmbiOrder
+                    || (Device->mAmbiOrder >= 2 && !Device->m2DMixing
+                        && Is2DAmbisonic(voice->mFmtChannels)))
                 {
-                    const auto upsampler = al::span{AmbiScale::FourthOrder2DUp};
-                    UpsampleBFormatTransform(mixmatrix, upsampler, shrot, Device->mAmbiOrder);
+                    if(voice->mAmbiOrder == 1)
+                    {
+                        const auto upsampler = Is2DAmbisonic(voice->mFmtChannels) ?
+                            al::span{AmbiScale::FirstOrder2DUp} : al::span{AmbiScale::FirstOrderUp};
+                        UpsampleBFormatTransform(mixmatrix, upsampler, shrot, Device->mAmbiOrder);
+                    }
+                    else if(voice->mAmbiOrder == 2)
+                    {
+                        const auto upsampler = Is2DAmbisonic(voice->mFmtChannels) ?
+                            al::span{AmbiScale::SecondOrder2DUp}
+                            : al::span{AmbiScale::SecondOrderUp};
+                        UpsampleBFormatTransform(mixmatrix, upsampler, shrot, Device->mAmbiOrder);
+                    }
+                    else if(voice->mAmbiOrder == 3)
+                    {
+                        const auto upsampler = Is2DAmbisonic(voice->mFmtChannels) ?
+                            al::span{AmbiScale::ThirdOrder2DUp} : al::span{AmbiScale::ThirdOrderUp};
+                        UpsampleBFormatTransform(mixmatrix, upsampler, shrot, Device->mAmbiOrder);
+                    }
+                    else if(voice->mAmbiOrder == 4)
+                    {
+                        const auto upsampler = al::span{AmbiScale::FourthOrder2DUp};
+                        UpsampleBFormatTransform(mixmatrix, upsampler, shrot, Device->mAmbiOrder);
+                    }
+                    else
+                        al::unreachable();
                 }
                 else
-                    al::unreachable();
-            }
-            else
-                mixmatrix = shrot;
+                    mixmatrix = shrot;
 
-            /* Convert the rotation matrix for input ordering and scaling, and
-             * whether input is 2D or 3D.
-             */
-            const auto index_map = Is2DAmbisonic(voice->mFmtChannels) ?
-                GetAmbi2DLayout(voice->mAmbiLayout).subspan(0) :
-                GetAmbiLayout(voice->mAmbiLayout).subspan(0);
+                for(size_t c{0};c < num_channels;c++)
+                    voice->mChans[c].mAmbiRotation = mixmatrix[index_map[c]];
+                voice->mAmbiOrientation = orientation;
+                voice->mAmbiRotationValid = true;
+            }
 
             /* Scale the panned W signal inversely to coverage (full coverage
              * means no panned signal), and according to the channel scaling.
@@ -1085,8 +1386,9 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
                  * to the coverage amount) with the directional pan. For all
                  * other channels, use just the (scaled) B-Format signal.
                  */
-                std::transform(mixmatrix[acn].cbegin(), mixmatrix[acn].cend(), coeffs.begin(),
-                    coeffs.begin(), [scale](const float in, const float coeff) noexcept
+                const auto &rotation = voice->mChans[c].mAmbiRotation;
+                std::transform(rotation.cbegin(), rotation.cend(), coeffs.begin(), coeffs.begin(),
+                    [scale](const float in, const float coeff) noexcept
                     { return in*scale + coeff; });
 
                 ComputePanGains(&Device->Dry, coeffs, DryGain.Base,
@@ -1095,7 +1397,7 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
                 for(uint i{0};i < NumSends;i++)
                 {
                     if(const EffectSlot *Slot{SendSlots[i]})
-                        ComputePanGains(&Slot->Wet, coeffs, WetGain[i].Base,
+                        ComputePanGains(Slot->getSendTarget(), coeffs, WetGain[i].Base,
                             voice->mChans[c].mWetParams[i].Gains.Target);
                 }
 
@@ -1149,12 +1451,13 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
             for(uint i{0};i < NumSends;i++)
             {
                 if(const EffectSlot *Slot{SendSlots[i]})
-                    ComputePanGains(&Slot->Wet, coeffs, WetGain[i].Base * pangain,
+                    ComputePanGains(Slot->getSendTarget(), coeffs, WetGain[i].Base * pangain,
                         voice->mChans[c].mWetParams[i].Gains.Target);
             }
         }
     }
-    else if(Device->mRenderMode == RenderMode::Hrtf)
+    else if(Device->mRenderMode == RenderMode::Hrtf
+        && !((lowDetail || hrtfLimited) && Distance > std::numeric_limits<float>::epsilon()))
     {
         /* Full HRTF rendering. Skip the virtual channels and render to the
          * real outputs.
@@ -1168,16 +1471,16 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
                 const float src_ev{std::asin(std::clamp(ypos, -1.0f, 1.0f))};
                 const float src_az{std::atan2(xpos, -zpos)};
 
-                Device->mHrtf->getCoeffs(src_ev, src_az, Distance*NfcScale, Spread,
-                    voice->mChans[0].mDryParams.Hrtf.Target.Coeffs,
-                    voice->mChans[0].mDryParams.Hrtf.Target.Delay);
-                voice->mChans[0].mDryParams.Hrtf.Target.Gain = DryGain.Base;
+                GetHrtfCoeffs(Device, src_ev, src_az, Distance*NfcScale, Spread,
+                    voice->mChans[0].mDryParams.Hrtf->Target.Coeffs,
+                    voice->mChans[0].mDryParams.Hrtf->Target.Delay);
+                voice->mChans[0].mDryParams.Hrtf->Target.Gain = DryGain.Base;
 
                 const auto coeffs = CalcDirectionCoeffs(std::array{xpos, ypos, zpos}, Spread);
                 for(uint i{0};i < NumSends;i++)
                 {
                     if(const EffectSlot *Slot{SendSlots[i]})
-                        ComputePanGains(&Slot->Wet, coeffs, WetGain[i].Base,
+                        ComputePanGains(Slot->getSendTarget(), coeffs, WetGain[i].Base,
                             voice->mChans[0].mWetParams[i].Gains.Target);
                 }
             }
@@ -1210,16 +1513,16 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
                 const float ev{std::asin(std::clamp(pos[1], -1.0f, 1.0f))};
                 const float az{std::atan2(pos[0], -pos[2])};
 
-                Device->mHrtf->getCoeffs(ev, az, Distance*NfcScale, 0.0f,
-                    voice->mChans[c].mDryParams.Hrtf.Target.Coeffs,
-                    voice->mChans[c].mDryParams.Hrtf.Target.Delay);
-                voice->mChans[c].mDryParams.Hrtf.Target.Gain = DryGain.Base * pangain;
+                GetHrtfCoeffs(Device, ev, az, Distance*NfcScale, 0.0f,
+                    voice->mChans[c].mDryParams.Hrtf->Target.Coeffs,
+                    voice->mChans[c].mDryParams.Hrtf->Target.Delay);
+                voice->mChans[c].mDryParams.Hrtf->Target.Gain = DryGain.Base * pangain;
 
                 const auto coeffs = CalcDirectionCoeffs(pos, 0.0f);
                 for(uint i{0};i < NumSends;i++)
                 {
                     if(const EffectSlot *Slot{SendSlots[i]})
-                        ComputePanGains(&Slot->Wet, coeffs, WetGain[i].Base * pangain,
+                        ComputePanGains(Slot->getSendTarget(), coeffs, WetGain[i].Base * pangain,
                             voice->mChans[c].mWetParams[i].Gains.Target);
                 }
             }
@@ -1249,10 +1552,10 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
                 const float ev{std::asin(chans[c].pos[1])};
                 const float az{std::atan2(chans[c].pos[0], -chans[c].pos[2])};
 
-                Device->mHrtf->getCoeffs(ev, az, std::numeric_limits<float>::infinity(), spread,
-                    voice->mChans[c].mDryParams.Hrtf.Target.Coeffs,
-                    voice->mChans[c].mDryParams.Hrtf.Target.Delay);
-                voice->mChans[c].mDryParams.Hrtf.Target.Gain = DryGain.Base * pangain;
+                GetHrtfCoeffs(Device, ev, az, std::numeric_limits<float>::infinity(), spread,
+                    voice->mChans[c].mDryParams.Hrtf->Target.Coeffs,
+                    voice->mChans[c].mDryParams.Hrtf->Target.Delay);
+                voice->mChans[c].mDryParams.Hrtf->Target.Gain = DryGain.Base * pangain;
 
                 /* Normal panning for auxiliary sends. */
                 const auto coeffs = CalcDirectionCoeffs(chans[c].pos, spread);
@@ -1260,7 +1563,7 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
                 for(uint i{0};i < NumSends;i++)
                 {
                     if(const EffectSlot *Slot{SendSlots[i]})
-                        ComputePanGains(&Slot->Wet, coeffs, WetGain[i].Base * pangain,
+                        ComputePanGains(Slot->getSendTarget(), coeffs, WetGain[i].Base * pangain,
                             voice->mChans[c].mWetParams[i].Gains.Target);
                 }
             }
@@ -1275,7 +1578,7 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
         if(Distance > std::numeric_limits<float>::epsilon())
         {
             /* Calculate NFC filter coefficient if needed. */
-            if(Device->AvgSpeakerDist > 0.0f)
+            if(Device->AvgSpeakerDist > 0.0f && !lowDetail)
             {
                 /* Clamp the distance for really close sources, to prevent
                  * excessive bass.
@@ -1299,14 +1602,16 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
                     const auto pos = ScaleAzimuthFront3_2(std::array{xpos, ypos, zpos});
                     return CalcDirectionCoeffs(pos, Spread);
                 };
-                const auto coeffs = calc_coeffs(Device->mRenderMode);
+                auto coeffs = calc_coeffs(Device->mRenderMode);
+                if(lowDetail)
+                    std::fill(coeffs.begin()+4, coeffs.end(), 0.0f);
 
                 ComputePanGains(&Device->Dry, coeffs, DryGain.Base,
                     voice->mChans[0].mDryParams.Gains.Target);
                 for(uint i{0};i < NumSends;i++)
                 {
                     if(const EffectSlot *Slot{SendSlots[i]})
-                        ComputePanGains(&Slot->Wet, coeffs, WetGain[i].Base,
+                        ComputePanGains(Slot->getSendTarget(), coeffs, WetGain[i].Base,
                             voice->mChans[0].mWetParams[i].Gains.Target);
                 }
             }
@@ -1358,7 +1663,8 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
                     for(uint i{0};i < NumSends;i++)
                     {
                         if(const EffectSlot *Slot{SendSlots[i]})
-                            ComputePanGains(&Slot->Wet, coeffs, WetGain[i].Base * pangain,
+                            ComputePanGains(Slot->getSendTarget(), coeffs,
+                                WetGain[i].Base * pangain,
                                 voice->mChans[c].mWetParams[i].Gains.Target);
                     }
                 }
@@ -1407,58 +1713,268 @@ void CalcPanningAndFilters(Voice *voice, const float xpos, const float ypos, con
                 for(uint i{0};i < NumSends;i++)
                 {
                     if(const EffectSlot *Slot{SendSlots[i]})
-                        ComputePanGains(&Slot->Wet, coeffs, WetGain[i].Base * pangain,
+                        ComputePanGains(Slot->getSendTarget(), coeffs, WetGain[i].Base * pangain,
                             voice->mChans[c].mWetParams[i].Gains.Target);
                 }
             }
         }
     }
 
+    voice->mDirect.FilterType = SetVoiceFilters(num_channels, DryGain,
+        props->Direct.HFReference / Frequency, props->Direct.LFReference / Frequency,
+        [voice](size_t c) -> DirectParams& { return voice->mChans[c].mDryParams; });
+    for(uint i{0};i < NumSends;i++)
+        voice->mSend[i].FilterType = SetVoiceFilters(num_channels, WetGain[i],
+            props->Send[i].HFReference / Frequency, props->Send[i].LFReference / Frequency,
+            [voice,i](size_t c) -> SendParams& { return voice->mChans[c].mWetParams[i]; });
+
+    voice->mDryGainBase = DryGain.Base;
+    std::transform(WetGain.begin(), WetGain.begin()+NumSends, voice->mWetGainBase.begin(),
+        [](const GainTriplet &gain) noexcept { return gain.Base; });
+    voice->mPanningValid = true;
+    voice->updateMixFunc();
+}
+
+/* Rescales the voice's target gains for new base gains, when nothing that
+ * affects the panning or filters has changed. Returns false if the targets
+ * can't be rescaled and need to be recalculated.
+ */
+bool RescaleTargetGains(Voice *voice, const GainTriplet &DryGain,
+    const al::span<const GainTriplet,MaxSendCount> WetGain, const DeviceBase *Device)
+{
+    if(UseLowDetailPanning(voice, DryGain.Base, Device) != voice->mFlags.test(VoiceIsLowDetail))
+        return false;
+
+    const uint NumSends{Device->NumAuxSends};
+    if(!(voice->mDryGainBase > 0.0f))
+        return false;
+    for(uint i{0};i < NumSends;++i)
+    {
+        if(!(voice->mWetGainBase[i] > 0.0f))
+            return false;
+    }
+
+    const float dryscale{DryGain.Base / voice->mDryGainBase};
+    std::array<float,MaxSendCount> wetscale{};
+    for(uint i{0};i < NumSends;++i)
+        wetscale[i] = WetGain[i].Base / voice->mWetGainBase[i];
+
+    auto apply_scale = [](const al::span<float> gains, const float scale) noexcept
+    { std::for_each(gains.begin(), gains.end(), [scale](float &gain) noexcept { gain *= scale; }); };
+    for(auto &chandata : voice->mChans)
+    {
+        if(chandata.mDryParams.Hrtf)
+            chandata.mDryParams.Hrtf->Target.Gain *= dryscale;
+        apply_scale(chandata.mDryParams.Gains.Target, dryscale);
+        for(uint i{0};i < NumSends;++i)
+            apply_scale(chandata.mWetParams[i].Gains.Target, wetscale[i]);
+    }
+
+    voice->mDryGainBase = DryGain.Base;
+    std::transform(WetGain.begin(), WetGain.begin()+NumSends, voice->mWetGainBase.begin(),
+        [](const GainTriplet &gain) noexcept { return gain.Base; });
+    return true;
+}
+
+/* Gets the resampler to use for the voice, limited to linear resampling when
+ * the mix is degraded.
+ */
+Resampler GetVoiceResampler(const VoiceProps *props, const DeviceBase *Device) noexcept
+{
+    if(Device->mMixDegrade >= MixDegrade::Resampler)
+        return std::min(props->mResampler, Resampler::Linear);
+    return props->mResampler;
+}
+
+/* Gets the loudest of the voice's dry and wet gains. */
+float CalcVoiceLevel(const GainTriplet &DryGain,
+    const al::span<const GainTriplet,MaxSendCount> WetGain,
+    const al::span<EffectSlot*const,MaxSendCount> SendSlots, const uint NumSends) noexcept
+{
+    float level{DryGain.Base};
+    for(uint i{0};i < NumSends;++i)
     {
-        const float hfNorm{props->Direct.HFReference / Frequency};
-        const float lfNorm{props->Direct.LFReference / Frequency};
+        if(SendSlots[i])
+            level = std::max(level, WetGain[i].Base);
+    }
+    return level;
+}
 
-        voice->mDirect.FilterType = AF_None;
-        if(DryGain.HF != 1.0f) voice->mDirect.FilterType |= AF_LowPass;
-        if(DryGain.LF != 1.0f) voice->mDirect.FilterType |= AF_HighPass;
+/* Gets the dry path distance attenuation of a source, for the given distance
+ * model.
+ */
+float CalcDryDistanceAttn(const VoiceProps *props, const DistanceModel model, float distance)
+{
+    switch(model)
+    {
+    case DistanceModel::InverseClamped:
+        if(props->MaxDistance < props->RefDistance) break;
+        distance = std::clamp(distance, props->RefDistance, props->MaxDistance);
+        /*fall-through*/
+    case DistanceModel::Inverse:
+        if(props->RefDistance > 0.0f)
+        {
+            const float dist{lerpf(props->RefDistance, distance, props->RolloffFactor)};
+            if(dist > 0.0f) return props->RefDistance / dist;
+        }
+        break;
 
-        auto &lowpass = voice->mChans[0].mDryParams.LowPass;
-        auto &highpass = voice->mChans[0].mDryParams.HighPass;
-        lowpass.setParamsFromSlope(BiquadType::HighShelf, hfNorm, DryGain.HF, 1.0f);
-        highpass.setParamsFromSlope(BiquadType::LowShelf, lfNorm, DryGain.LF, 1.0f);
-        for(size_t c{1};c < num_channels;c++)
+    case DistanceModel::LinearClamped:
+        if(props->MaxDistance < props->RefDistance) break;
+        distance = std::clamp(distance, props->RefDistance, props->MaxDistance);
+        /*fall-through*/
+    case DistanceModel::Linear:
+        if(props->MaxDistance != props->RefDistance)
         {
-            voice->mChans[c].mDryParams.LowPass.copyParamsFrom(lowpass);
-            voice->mChans[c].mDryParams.HighPass.copyParamsFrom(highpass);
+            const float attn{(distance-props->RefDistance) /
+                (props->MaxDistance-props->RefDistance) * props->RolloffFactor};
+            return std::max(1.0f - attn, 0.0f);
         }
+        break;
+
+    case DistanceModel::ExponentClamped:
+        if(props->MaxDistance < props->RefDistance) break;
+        distance = std::clamp(distance, props->RefDistance, props->MaxDistance);
+        /*fall-through*/
+    case DistanceModel::Exponent:
+        if(distance > 0.0f && props->RefDistance > 0.0f)
+            return std::pow(distance/props->RefDistance, -props->RolloffFactor);
+        break;
+
+    case DistanceModel::Disable:
+        break;
     }
-    for(uint i{0};i < NumSends;i++)
+    return 1.0f;
+}
+
+/* Stops the voice from mixing for the context's extra listeners. */
+void ClearExtraListeners(Voice *voice, const DeviceBase *Device) noexcept
+{
+    const auto targets = al::span{voice->mListener}.first(Device->NumListeners-1);
+    std::for_each(targets.begin(), targets.end(),
+        [](Voice::TargetData &target) noexcept { target.Buffer = {}; });
+}
+
+/* Calculates the direct mixes of the context's extra listeners for an
+ * attenuated source, returning the loudest of their gains. Each listener gets
+ * its own distance attenuation, cone, and air absorption, and pans the source
+ * between its pair of outputs. The pitch and sends only follow the first
+ * listener. Head-relative sources are relative to each listener.
+ */
+float CalcExtraListenerParams(Voice *voice, const VoiceProps *props, const ContextBase *context,
+    const DeviceBase *Device)
+{
+    static constexpr float Rad2Deg{static_cast<float>(180.0 / al::numbers::pi)};
+
+    const uint numListeners{Device->NumListeners-1};
+    if(numListeners == 0)
+        return 0.0f;
+
+    /* Ambisonic sources only give their W channel to the extra listeners, as
+     * do mono sources with a duplicated channel. Otherwise, the channels all
+     * play from the source position with their power split between them.
+     */
+    const size_t num_channels{voice->mChans.size()};
+    const bool firstonly{IsAmbisonic(voice->mFmtChannels) || voice->mFmtChannels == FmtMonoDup};
+    const size_t num_mixed{firstonly ? 1u : num_channels};
+    const float chanscale{firstonly ? 1.0f : 1.0f/std::sqrt(static_cast<float>(num_channels))};
+    const size_t numouts{Device->RealOut.Buffer.size()};
+    const auto Frequency = static_cast<float>(Device->mMixFrequency);
+    const DistanceModel model{context->mParams.SourceDistanceModel ? props->mDistanceModel
+        : context->mParams.mDistanceModel};
+
+    float level{0.0f};
+    for(uint lidx{0};lidx < numListeners;++lidx)
     {
-        const float hfNorm{props->Send[i].HFReference / Frequency};
-        const float lfNorm{props->Send[i].LFReference / Frequency};
+        const auto &lparams = context->mParams.ExtraListeners[lidx];
+
+        alu::Vector Position{props->Position[0], props->Position[1], props->Position[2], 1.0f};
+        alu::Vector Direction{props->Direction[0], props->Direction[1], props->Direction[2],
+            0.0f};
+        if(!props->HeadRelative)
+        {
+            Position = TransformToListener(lparams.Matrix, Position - lparams.Position);
+            Direction = TransformToListener(lparams.Matrix, Direction);
+        }
+
+        const bool directional{Direction.normalize() > 0.0f};
+        alu::Vector ToSource{Position[0], Position[1], Position[2], 0.0f};
+        const float Distance{ToSource.normalize()};
+
+        float gain{props->Gain * CalcDryDistanceAttn(props, model, Distance)};
+        float ConeHF{1.0f};
+        if(directional && props->InnerAngle < 360.0f)
+        {
+            const float Angle{Rad2Deg*2.0f * std::acos(-Direction.dot_product(ToSource)) *
+                ConeScale};
+            if(Angle >= props->OuterAngle)
+            {
+                gain *= props->OuterGain;
+                if(props->DryGainHFAuto)
+                    ConeHF = props->OuterGainHF;
+            }
+            else if(Angle >= props->InnerAngle)
+            {
+                const float scale{(Angle-props->InnerAngle) /
+                    (props->OuterAngle-props->InnerAngle)};
+                gain *= lerpf(1.0f, props->OuterGain, scale);
+                if(props->DryGainHFAuto)
+                    ConeHF = lerpf(1.0f, props->OuterGainHF, scale);
+            }
+        }
 
-        voice->mSend[i].FilterType = AF_None;
-        if(WetGain[i].HF != 1.0f) voice->mSend[i].FilterType |= AF_LowPass;
-        if(WetGain[i].LF != 1.0f) voice->mSend[i].FilterType |= AF_HighPass;
+        GainTriplet DryGain{};
+        DryGain.Base = std::min(std::clamp(gain, props->MinGain, props->MaxGain) * lparams.Gain *
+            props->Direct.Gain, GainMixMax);
+        DryGain.HF = ConeHF * props->Direct.GainHF;
+        DryGain.LF = props->Direct.GainLF;
+        if(Distance > props->RefDistance)
+        {
+            const float distance_meters{(Distance-props->RefDistance) * props->RolloffFactor *
+                context->mParams.MetersPerUnit};
+            const float absorb{distance_meters * props->AirAbsorptionFactor};
+            if(absorb > std::numeric_limits<float>::epsilon())
+                DryGain.HF *= std::pow(context->mParams.AirAbsorptionGainHF, absorb);
+        }
+        level = std::max(level, DryGain.Base);
 
-        auto &lowpass = voice->mChans[0].mWetParams[i].LowPass;
-        auto &highpass = voice->mChans[0].mWetParams[i].HighPass;
-        lowpass.setParamsFromSlope(BiquadType::HighShelf, hfNorm, WetGain[i].HF, 1.0f);
-        highpass.setParamsFromSlope(BiquadType::LowShelf, lfNorm, WetGain[i].LF, 1.0f);
-        for(size_t c{1};c < num_channels;c++)
+        /* Constant-power panning between the two outputs, or the full gain if
+         * they're the same output.
+         */
+        const float pan{std::clamp(ToSource[0]*XScale, -1.0f, 1.0f)};
+        const bool sameout{lparams.Output[0] == lparams.Output[1]};
+        const std::array pangains{sameout ? 1.0f : std::sqrt((1.0f-pan) * 0.5f),
+            sameout ? 0.0f : std::sqrt((1.0f+pan) * 0.5f)};
+        for(size_t c{0};c < num_channels;++c)
         {
-            voice->mChans[c].mWetParams[i].LowPass.copyParamsFrom(lowpass);
-            voice->mChans[c].mWetParams[i].HighPass.copyParamsFrom(highpass);
+            const auto gains = voice->mChans[c].mListenerParams[lidx].Gains.Target;
+            std::fill(gains.begin(), gains.end(), 0.0f);
+            if(c >= num_mixed)
+                continue;
+            for(size_t side{0};side < 2;++side)
+            {
+                if(lparams.Output[side] < numouts)
+                    gains[lparams.Output[side]] += DryGain.Base * chanscale * pangains[side];
+            }
         }
+
+        voice->mListener[lidx].FilterType = SetVoiceFilters(num_channels, DryGain,
+            props->Direct.HFReference / Frequency, props->Direct.LFReference / Frequency,
+            [voice,lidx](size_t c) -> SendParams&
+            { return voice->mChans[c].mListenerParams[lidx]; });
+        voice->mListener[lidx].Buffer = Device->RealOut.Buffer;
     }
+    return level;
 }
 
-void CalcNonAttnSourceParams(Voice *voice, const VoiceProps *props, const ContextBase *context)
+void CalcNonAttnSourceParams(Voice *voice, const VoiceProps *props, const ContextBase *context,
+    const bool updatePanning)
 {
+    voice->mFlags.reset(VoiceIsCulled);
+
     DeviceBase *Device{context->mDevice};
     std::array<EffectSlot*,MaxSendCount> SendSlots{};
 
-    voice->mDirect.Buffer = Device->Dry.Buffer;
     for(uint i{0};i < Device->NumAuxSends;i++)
     {
         SendSlots[i] = props->Send[i].Slot;
@@ -1468,17 +1984,18 @@ void CalcNonAttnSourceParams(Voice *voice, const VoiceProps *props, const Contex
             voice->mSend[i].Buffer = {};
         }
         else
-            voice->mSend[i].Buffer = SendSlots[i]->Wet.Buffer;
+            voice->mSend[i].Buffer = SendSlots[i]->getSendTarget()->Buffer;
     }
 
     /* Calculate the stepping value */
     const auto Pitch = static_cast<float>(voice->mFrequency) /
-        static_cast<float>(Device->Frequency) * props->Pitch;
+        static_cast<float>(Device->mMixFrequency) * props->Pitch;
     if(Pitch > float{MaxPitch})
         voice->mStep = MaxPitch<<MixerFracBits;
     else
         voice->mStep = std::max(fastf2u(Pitch * MixerFracOne), 1u);
-    voice->mResampler = PrepareResampler(props->mResampler, voice->mStep, &voice->mResampleState);
+    voice->mResampler = PrepareResampler(GetVoiceResampler(props, Device), voice->mStep,
+        &voice->mResampleState);
 
     /* Calculate gains */
     GainTriplet DryGain{};
@@ -1496,17 +2013,24 @@ void CalcNonAttnSourceParams(Voice *voice, const VoiceProps *props, const Contex
         WetGain[i].LF = props->Send[i].GainLF;
     }
 
+    voice->mAudibility = CalcVoiceLevel(DryGain, WetGain, SendSlots, Device->NumAuxSends);
+
+    /* Non-attenuated sources are only heard by the first listener. */
+    ClearExtraListeners(voice, Device);
+
+    if(!updatePanning && RescaleTargetGains(voice, DryGain, WetGain, Device))
+        return;
     CalcPanningAndFilters(voice, 0.0f, 0.0f, -1.0f, 0.0f, 0.0f, DryGain, WetGain, SendSlots, props,
         context->mParams, Device);
 }
 
-void CalcAttnSourceParams(Voice *voice, const VoiceProps *props, const ContextBase *context)
+void CalcAttnSourceParams(Voice *voice, const VoiceProps *props, const ContextBase *context,
+    const bool updatePanning)
 {
     DeviceBase *Device{context->mDevice};
     const uint NumSends{Device->NumAuxSends};
 
     /* Set mixing buffers and get send parameters. */
-    voice->mDirect.Buffer = Device->Dry.Buffer;
     std::array<EffectSlot*,MaxSendCount> SendSlots{};
     std::array<float,MaxSendCount> RoomRolloff{};
     std::bitset<MaxSendCount> UseDryAttnForRoom{0};
@@ -1535,7 +2059,7 @@ void CalcAttnSourceParams(Voice *voice, const VoiceProps *props, const ContextBa
         if(!SendSlots[i])
             voice->mSend[i].Buffer = {};
         else
-            voice->mSend[i].Buffer = SendSlots[i]->Wet.Buffer;
+            voice->mSend[i].Buffer = SendSlots[i]->getSendTarget()->Buffer;
     }
 
     /* Transform source to listener space (convert to head relative) */
@@ -1544,10 +2068,17 @@ void CalcAttnSourceParams(Voice *voice, const VoiceProps *props, const ContextBa
     alu::Vector Direction{props->Direction[0], props->Direction[1], props->Direction[2], 0.0f};
     if(!props->HeadRelative)
     {
-        /* Transform source vectors */
-        Position = context->mParams.Matrix * (Position - context->mParams.Position);
-        Velocity = context->mParams.Matrix * Velocity;
-        Direction = context->mParams.Matrix * Direction;
+        /* Transform source vectors. Static emitters typically have no
+         * velocity or direction, which don't need transforming when zero.
+         */
+        auto is_zero = [](const std::array<float,3> &vec) noexcept
+        { return vec[0] == 0.0f && vec[1] == 0.0f && vec[2] == 0.0f; };
+        Position = TransformToListener(context->mParams.Matrix,
+            Position - context->mParams.Position);
+        if(!is_zero(props->Velocity))
+            Velocity = TransformToListener(context->mParams.Matrix, Velocity);
+        if(!is_zero(props->Direction))
+            Direction = TransformToListener(context->mParams.Matrix, Direction);
     }
     else
     {
@@ -1771,42 +2302,112 @@ void CalcAttnSourceParams(Voice *voice, const VoiceProps *props, const ContextBa
     /* Adjust pitch based on the buffer and output frequencies, and calculate
      * fixed-point stepping value.
      */
-    Pitch *= static_cast<float>(voice->mFrequency) / static_cast<float>(Device->Frequency);
+    Pitch *= static_cast<float>(voice->mFrequency) / static_cast<float>(Device->mMixFrequency);
     if(Pitch > float{MaxPitch})
         voice->mStep = MaxPitch<<MixerFracBits;
     else
         voice->mStep = std::max(fastf2u(Pitch * MixerFracOne), 1u);
-    voice->mResampler = PrepareResampler(props->mResampler, voice->mStep, &voice->mResampleState);
+    voice->mResampler = PrepareResampler(GetVoiceResampler(props, Device), voice->mStep,
+        &voice->mResampleState);
 
-    float spread{0.0f};
-    if(props->Radius > Distance)
-        spread = al::numbers::pi_v<float>*2.0f - Distance/props->Radius*al::numbers::pi_v<float>;
+    /* Cull the voice if it's too quiet to be heard, with some hysteresis so
+     * it doesn't keep toggling near the threshold. A culled voice doesn't need
+     * any panning or filter updates.
+     */
+    const float level{std::max(CalcVoiceLevel(DryGain, WetGain, SendSlots, NumSends),
+        CalcExtraListenerParams(voice, props, context, Device))};
+    voice->mAudibility = level;
+    if(Device->mVoiceCullGain > 0.0f && !voice->mFlags.test(VoiceIsCallback))
+    {
+        if(voice->mFlags.test(VoiceIsCulled))
+        {
+            if(level > Device->mVoiceUncullGain)
+                voice->mFlags.reset(VoiceIsCulled);
+        }
+        else if(level < Device->mVoiceCullGain)
+            voice->mFlags.set(VoiceIsCulled);
+        if(voice->mFlags.test(VoiceIsCulled))
+        {
+            voice->mPanningValid = false;
+            return;
+        }
+    }
+    else
+        voice->mFlags.reset(VoiceIsCulled);
+
+    float spread{0.0f};
+    if(props->Radius > Distance)
+        spread = al::numbers::pi_v<float>*2.0f - Distance/props->Radius*al::numbers::pi_v<float>;
     else if(Distance > 0.0f)
         spread = std::asin(props->Radius/Distance) * 2.0f;
 
+    if(!updatePanning && RescaleTargetGains(voice, DryGain, WetGain, Device))
+        return;
     CalcPanningAndFilters(voice, ToSource[0]*XScale, ToSource[1]*YScale, ToSource[2]*ZScale,
         Distance, spread, DryGain, WetGain, SendSlots, props, context->mParams, Device);
 }
 
+/* Checks if the new properties change anything besides the base gains and
+ * pitch. Those are cheap to recalculate, and don't need the panning or filters
+ * to be updated.
+ */
+bool PanningPropsChanged(const VoiceProps &lhs, const VoiceProps &rhs) noexcept
+{
+    auto filter_changed = [](const auto &a, const auto &b) noexcept
+    {
+        return a.GainHF != b.GainHF || a.HFReference != b.HFReference || a.GainLF != b.GainLF
+            || a.LFReference != b.LFReference;
+    };
+    auto send_changed = [filter_changed](const VoiceProps::SendData &a,
+        const VoiceProps::SendData &b) noexcept
+    { return a.Slot != b.Slot || filter_changed(a, b); };
+
+    return lhs.OuterGain != rhs.OuterGain || lhs.InnerAngle != rhs.InnerAngle
+        || lhs.OuterAngle != rhs.OuterAngle || lhs.RefDistance != rhs.RefDistance
+        || lhs.MaxDistance != rhs.MaxDistance || lhs.RolloffFactor != rhs.RolloffFactor
+        || lhs.Position != rhs.Position || lhs.Direction != rhs.Direction
+        || lhs.OrientAt != rhs.OrientAt || lhs.OrientUp != rhs.OrientUp
+        || lhs.HeadRelative != rhs.HeadRelative || lhs.mDistanceModel != rhs.mDistanceModel
+        || lhs.DirectChannels != rhs.DirectChannels || lhs.mSpatializeMode != rhs.mSpatializeMode
+        || lhs.DryGainHFAuto != rhs.DryGainHFAuto || lhs.WetGainAuto != rhs.WetGainAuto
+        || lhs.WetGainHFAuto != rhs.WetGainHFAuto || lhs.OuterGainHF != rhs.OuterGainHF
+        || lhs.AirAbsorptionFactor != rhs.AirAbsorptionFactor
+        || lhs.RoomRolloffFactor != rhs.RoomRolloffFactor || lhs.StereoPan != rhs.StereoPan
+        || lhs.Radius != rhs.Radius || lhs.EnhWidth != rhs.EnhWidth
+        || lhs.Panning != rhs.Panning || lhs.DirectRoute != rhs.DirectRoute
+        || filter_changed(lhs.Direct, rhs.Direct)
+        || !std::equal(lhs.Send.cbegin(), lhs.Send.cend(), rhs.Send.cbegin(),
+            [send_changed](const VoiceProps::SendData &a, const VoiceProps::SendData &b) noexcept
+            { return !send_changed(a, b); });
+}
+
 void CalcSourceParams(Voice *voice, ContextBase *context, bool force)
 {
     VoicePropsItem *props{voice->mUpdate.exchange(nullptr, std::memory_order_acq_rel)};
     if(!props && !force) return;
 
+    /* Forced updates (from context or effect slot changes) always recalculate
+     * the panning. Otherwise, compare with the current properties to see if
+     * anything besides the gain or pitch changed.
+     */
+    bool updatePanning{force || !voice->mPanningValid};
     if(props)
     {
+        if(!updatePanning)
+            updatePanning = PanningPropsChanged(voice->mProps, *props);
         voice->mProps = static_cast<VoiceProps&>(*props);
 
-        AtomicReplaceHead(context->mFreeVoiceProps, props);
+        context->mFreeVoiceProps.push(props);
     }
 
-    if((voice->mProps.DirectChannels != DirectMode::Off && voice->mFmtChannels != FmtMono
+    if((voice->mProps.DirectRoute >= 0 && !IsAmbisonic(voice->mFmtChannels))
+        || (voice->mProps.DirectChannels != DirectMode::Off && voice->mFmtChannels != FmtMono
             && !IsAmbisonic(voice->mFmtChannels))
         || voice->mProps.mSpatializeMode == SpatializeMode::Off
         || (voice->mProps.mSpatializeMode==SpatializeMode::Auto && voice->mFmtChannels != FmtMono))
-        CalcNonAttnSourceParams(voice, &voice->mProps, context);
+        CalcNonAttnSourceParams(voice, &voice->mProps, context, updatePanning);
     else
-        CalcAttnSourceParams(voice, &voice->mProps, context);
+        CalcAttnSourceParams(voice, &voice->mProps, context, updatePanning);
 }
 
 
@@ -1834,6 +2435,7 @@ void SendSourceStateEvent(ContextBase *context, uint id, VChangeState state)
         break;
     /* Shouldn't happen. */
     case VChangeState::Restart:
+    case VChangeState::Seek:
         al::unreachable();
     }
 
@@ -1842,6 +2444,8 @@ void SendSourceStateEvent(ContextBase *context, uint id, VChangeState state)
 
 void ProcessVoiceChanges(ContextBase *ctx)
 {
+    ctx->syncMixVoices();
+
     VoiceChange *cur{ctx->mCurrentVoiceChange.load(std::memory_order_acquire)};
     VoiceChange *next{cur->mNext.load(std::memory_order_acquire)};
     if(!next) return;
@@ -1850,6 +2454,12 @@ void ProcessVoiceChanges(ContextBase *ctx)
     do {
         cur = next;
 
+        /* The voice the change is for may be starting, so make sure it's in
+         * the mixer's list. Unused voices are dropped after mixing.
+         */
+        if(cur->mVoice)
+            ctx->addMixVoice(cur->mVoice);
+
         bool sendevt{false};
         if(cur->mState == VChangeState::Reset || cur->mState == VChangeState::Stop)
         {
@@ -1927,6 +2537,26 @@ void ProcessVoiceChanges(ContextBase *ctx)
             }
             oldvoice->mPendingChange.store(false, std::memory_order_release);
         }
+        else if(cur->mState == VChangeState::Seek)
+        {
+            /* Seeking a voice never sends a source change event. If there's no
+             * sourceID, the voice finished so leave the seek pending for the
+             * source to see it failed. Otherwise, a voice that's being mixed
+             * crossfades to the new offset, and a paused voice just moves.
+             */
+            Voice *voice{cur->mVoice};
+            if(voice->mSourceID.load(std::memory_order_relaxed) != 0u)
+            {
+                const Voice::SeekTarget target{cur->mSeekPosition, cur->mSeekPositionFrac,
+                    cur->mSeekBuffer};
+                if(voice->mPlayState.load(std::memory_order_acquire) == Voice::Stopped)
+                    voice->setPosition(target);
+                else
+                    voice->mSeekTarget = target;
+                voice->mPendingSeek.store(false, std::memory_order_release);
+            }
+            voice->mPendingChange.store(false, std::memory_order_release);
+        }
         if(sendevt && enabledevt.test(al::to_underlying(AsyncEnableBits::SourceState)))
             SendSourceStateEvent(ctx, cur->mSourceID, cur->mState);
 
@@ -1935,183 +2565,498 @@ void ProcessVoiceChanges(ContextBase *ctx)
     ctx->mCurrentVoiceChange.store(cur, std::memory_order_release);
 }
 
-void ProcessParamUpdates(ContextBase *ctx, const al::span<EffectSlot*> slots,
-    const al::span<EffectSlot*> sorted_slots, const al::span<Voice*> voices)
-{
-    ProcessVoiceChanges(ctx);
+/* The rank cutoff for keeping a limited number of voices. Voices ranked
+ * above hi are kept, and the remaining space is given to voices between lo
+ * and hi (which are mostly ties) in list order.
+ */
+struct VoiceCutoff {
+    float lo, hi;
+    size_t remaining;
+};
 
-    IncrementRef(ctx->mUpdateCount);
-    if(!ctx->mHoldUpdates.load(std::memory_order_acquire)) LIKELY
+/* Finds the rank cutoff for keeping limit of the voices that pass is_ranked,
+ * with a bisection search rather than sorting the voices, to avoid needing
+ * extra storage. The search is over the log of the rank from -120dB to
+ * maxrank, which is plenty precise enough to split the voices.
+ */
+template<typename F, typename R>
+auto FindVoiceCutoff(const al::span<Voice*> voices, const size_t limit, F is_ranked,
+    R get_rank, const float maxrank) noexcept -> VoiceCutoff
+{
+    auto count_above = [voices,is_ranked,get_rank](const float rank) noexcept -> size_t
     {
-        bool force{CalcContextParams(ctx)};
-        auto sorted_slot_base = al::to_address(sorted_slots.begin());
-        for(EffectSlot *slot : slots)
-            force |= CalcEffectSlotParams(slot, sorted_slot_base, ctx);
+        return static_cast<size_t>(std::count_if(voices.begin(), voices.end(),
+            [rank,is_ranked,get_rank](const Voice *voice) noexcept
+            { return is_ranked(voice) && get_rank(voice) > rank; }));
+    };
 
-        for(Voice *voice : voices)
-        {
-            /* Only update voices that have a source. */
-            if(voice->mSourceID.load(std::memory_order_relaxed) != 0)
-                CalcSourceParams(voice, ctx, force);
-        }
+    float lo{1e-6f};
+    float hi{maxrank};
+    if(count_above(lo) <= limit)
+        hi = lo;
+    else for(int i{0};i < 24;++i)
+    {
+        const float mid{std::sqrt(lo * hi)};
+        if(count_above(mid) > limit)
+            lo = mid;
+        else
+            hi = mid;
     }
-    IncrementRef(ctx->mUpdateCount);
+    return VoiceCutoff{lo, hi, limit - count_above(hi)};
 }
 
-void ProcessContexts(DeviceBase *device, const uint SamplesToDo)
+/* Applies a limit (0 for no limit) and a fraction of the ranked voices,
+ * whichever is lower.
+ */
+size_t ScaleVoiceLimit(size_t limit, const size_t numranked, const float scale) noexcept
 {
-    ASSUME(SamplesToDo > 0);
+    if(scale < 1.0f)
+    {
+        const auto scaled = static_cast<size_t>(std::ceil(static_cast<float>(numranked)*scale));
+        limit = limit ? std::min(limit, scaled) : scaled;
+    }
+    return limit ? limit : numranked;
+}
 
-    const nanoseconds curtime{device->mClockBase.load(std::memory_order_relaxed) +
-        nanoseconds{seconds{device->mSamplesDone.load(std::memory_order_relaxed)}}/
-        device->Frequency};
+/* Limits how many voices get mixed, to the given limit (0 for no limit) or
+ * the given fraction of the playing voices, whichever is lower. When more
+ * than that are playing, the quietest ones are made virtual. Voices that were
+ * mixed last time are ranked a bit higher, so voices near the cut don't keep
+ * switching.
+ */
+void LimitRealVoices(const al::span<Voice*> voices, size_t limit, const float scale)
+{
+    static constexpr float RealVoiceBoost{2.0f}; /* +6dB */
 
-    for(ContextBase *ctx : *device->mContexts.load(std::memory_order_acquire))
+    auto is_active = [](const Voice *voice) noexcept -> bool
     {
-        const auto auxslotspan = al::span{*ctx->mActiveAuxSlots.load(std::memory_order_acquire)};
-        const auto auxslots = auxslotspan.first(auxslotspan.size()>>1);
-        const auto sorted_slots = auxslotspan.last(auxslotspan.size()>>1);
-        const al::span<Voice*> voices{ctx->getVoicesSpanAcquired()};
+        const Voice::State vstate{voice->mPlayState.load(std::memory_order_acquire)};
+        return vstate != Voice::Stopped && vstate != Voice::Pending
+            && !voice->mFlags.test(VoiceIsCulled);
+    };
+    /* Callback voices can't be made virtual, so they always rank highest. */
+    auto get_rank = [](const Voice *voice) noexcept -> float
+    {
+        if(voice->mFlags.test(VoiceIsCallback))
+            return std::numeric_limits<float>::infinity();
+        if(voice->mFlags.test(VoiceIsVirtual))
+            return voice->mAudibility;
+        return voice->mAudibility * RealVoiceBoost;
+    };
 
-        /* Process pending property updates for objects on the context. */
-        ProcessParamUpdates(ctx, auxslots, sorted_slots, voices);
+    const auto numactive = static_cast<size_t>(std::count_if(voices.begin(), voices.end(),
+        is_active));
+    limit = ScaleVoiceLimit(limit, numactive, scale);
+    if(numactive <= limit)
+    {
+        for(Voice *voice : voices)
+            voice->mFlags.reset(VoiceIsVirtual);
+        return;
+    }
 
-        /* Clear auxiliary effect slot mixing buffers. */
-        for(EffectSlot *slot : auxslots)
+    VoiceCutoff cutoff{FindVoiceCutoff(voices, limit, is_active, get_rank,
+        GainMixMax * RealVoiceBoost)};
+    for(Voice *voice : voices)
+    {
+        bool isvirtual{false};
+        if(is_active(voice))
         {
-            for(auto &buffer : slot->Wet.Buffer)
-                buffer.fill(0.0f);
+            const float rank{get_rank(voice)};
+            if(!(rank > cutoff.hi))
+            {
+                isvirtual = !(rank > cutoff.lo && cutoff.remaining > 0);
+                if(!isvirtual) --cutoff.remaining;
+            }
         }
+        voice->mFlags.set(VoiceIsVirtual, isvirtual);
+    }
+}
 
-        /* Process voices that have a playing source. */
+/* Limits how many mono voices get their own HRTF filters, to the given limit
+ * (0 for no limit) or the given fraction of them, whichever is lower. The
+ * quietest ones past the limit are panned into the ambisonic mix instead,
+ * which the device renders through the HRTF once for all of them. Like with
+ * real voices, voices with their own filters are ranked a bit higher. Voices
+ * that change are updated right away, so must not be updated concurrently.
+ */
+void LimitHrtfVoices(ContextBase *ctx, const al::span<Voice*> voices, size_t limit,
+    const float scale)
+{
+    static constexpr float HrtfVoiceBoost{2.0f}; /* +6dB */
+
+    /* Only playing mono voices that get HRTF filters, or would without the
+     * limit, are ranked. Quiet low-detail voices already skip them.
+     */
+    auto is_ranked = [](const Voice *voice) noexcept -> bool
+    {
+        const Voice::State vstate{voice->mPlayState.load(std::memory_order_acquire)};
+        return vstate != Voice::Stopped && vstate != Voice::Pending
+            && voice->mFmtChannels == FmtMono
+            && (voice->mFlags.test(VoiceHasHrtf) || voice->mFlags.test(VoiceIsHrtfLimited));
+    };
+    auto get_rank = [](const Voice *voice) noexcept -> float
+    {
+        if(voice->mFlags.test(VoiceHasHrtf))
+            return voice->mAudibility * HrtfVoiceBoost;
+        return voice->mAudibility;
+    };
+    auto set_limited = [ctx](Voice *voice, const bool limited) -> void
+    {
+        if(voice->mFlags.test(VoiceIsHrtfLimited) == limited)
+            return;
+        voice->mFlags.set(VoiceIsHrtfLimited, limited);
+        if(voice->mSourceID.load(std::memory_order_relaxed) != 0)
+            CalcSourceParams(voice, ctx, true);
+    };
+
+    const auto numranked = static_cast<size_t>(std::count_if(voices.begin(), voices.end(),
+        is_ranked));
+    limit = ScaleVoiceLimit(limit, numranked, scale);
+    if(numranked <= limit)
+    {
         for(Voice *voice : voices)
+            set_limited(voice, false);
+        return;
+    }
+
+    VoiceCutoff cutoff{FindVoiceCutoff(voices, limit, is_ranked, get_rank,
+        GainMixMax * HrtfVoiceBoost)};
+    for(Voice *voice : voices)
+    {
+        bool limited{false};
+        if(is_ranked(voice))
         {
-            const Voice::State vstate{voice->mPlayState.load(std::memory_order_acquire)};
-            if(vstate != Voice::Stopped && vstate != Voice::Pending)
-                voice->mix(vstate, ctx, curtime, SamplesToDo);
+            const float rank{get_rank(voice)};
+            if(!(rank > cutoff.hi))
+            {
+                limited = !(rank > cutoff.lo && cutoff.remaining > 0);
+                if(!limited) --cutoff.remaining;
+            }
         }
+        set_limited(voice, limited);
+    }
+}
 
-        /* Process effects. */
-        if(!auxslots.empty())
+void ProcessParamUpdates(ContextBase *ctx, const al::span<EffectSlot*> slots,
+    const al::span<EffectSlot*> sorted_slots, const bool forceVoices, MixerPool *pool)
+{
+    ProcessVoiceChanges(ctx);
+    const auto voices = ctx->getMixVoices();
+
+    IncrementRef(ctx->mUpdateCount);
+    if(!ctx->mHoldUpdates.load(std::memory_order_acquire)) LIKELY
+    {
+        const bool listenerChanged{CalcContextParams(ctx)};
+        bool force{listenerChanged || forceVoices};
+        bool wetChanged{false};
+        auto sorted_slot_base = al::to_address(sorted_slots.begin());
+        for(EffectSlot *slot : slots)
         {
-            /* Sort the slots into extra storage, so that effect slots come
-             * before their effect slot target (or their targets' target). Skip
-             * sorting if it has already been done.
-             */
-            if(!sorted_slots[0])
+            if(CalcEffectSlotParams(slot, sorted_slot_base, ctx, wetChanged))
+                force = true;
+            else if(listenerChanged && slot->EffectType == EffectSlotType::SourceGroup)
             {
-                /* First, copy the slots to the sorted list, then partition the
-                 * sorted list so that all slots without a target slot go to
-                 * the end.
-                 */
-                std::copy(auxslots.begin(), auxslots.end(), sorted_slots.begin());
-                auto split_point = std::partition(sorted_slots.begin(), sorted_slots.end(),
-                    [](const EffectSlot *slot) noexcept -> bool
-                    { return slot->Target != nullptr; });
-                /* There must be at least one slot without a slot target. */
-                assert(split_point != sorted_slots.end());
-
-                /* Simple case: no more than 1 slot has a target slot. Either
-                 * all slots go right to the output, or the remaining one must
-                 * target an already-partitioned slot.
+                /* Source groups are panned relative to the listener, so they
+                 * need updating when it moves.
                  */
-                if(split_point - sorted_slots.begin() > 1)
-                {
-                    /* At least two slots target other slots. Starting from the
-                     * back of the sorted list, continue partitioning the front
-                     * of the list given each target until all targets are
-                     * accounted for. This ensures all slots without a target
-                     * go last, all slots directly targeting those last slots
-                     * go second-to-last, all slots directly targeting those
-                     * second-last slots go third-to-last, etc.
-                     */
-                    auto next_target = sorted_slots.end();
-                    do {
-                        /* This shouldn't happen, but if there's unsorted slots
-                         * left that don't target any sorted slots, they can't
-                         * contribute to the output, so leave them.
-                         */
-                        if(next_target == split_point) UNLIKELY
-                            break;
-
-                        --next_target;
-                        split_point = std::partition(sorted_slots.begin(), split_point,
-                            [next_target](const EffectSlot *slot) noexcept -> bool
-                            { return slot->Target != *next_target; });
-                    } while(split_point - sorted_slots.begin() > 1);
-                }
+                slot->mEffectState->update(ctx, slot, &slot->mEffectProps,
+                    GetEffectSlotTarget(slot, ctx));
             }
+        }
 
-            for(const EffectSlot *slot : sorted_slots)
+        /* Slots that target another slot need to update their output mix if
+         * the target's wet buffer changed size.
+         */
+        if(wetChanged)
+        {
+            for(EffectSlot *slot : slots)
             {
-                EffectState *state{slot->mEffectState.get()};
-                state->process(SamplesToDo, slot->Wet.Buffer, state->mOutTarget);
+                if(EffectSlot *target{slot->Target})
+                    slot->mEffectState->update(ctx, slot, &slot->mEffectProps,
+                        EffectTarget{&target->Wet, nullptr});
             }
         }
 
-        /* Signal the event handler if there are any events to read. */
-        RingBuffer *ring{ctx->mAsyncEvents.get()};
-        if(ring->readSpace() > 0)
-            ctx->mEventSem.post();
+        /* Only update voices that have a source. */
+        auto update_voice = [](Voice *voice, ContextBase *context, bool forceupd)
+        {
+            if(voice->mSourceID.load(std::memory_order_relaxed) != 0)
+                CalcSourceParams(voice, context, forceupd);
+        };
+
+        /* With a mixer pool, split the voices across it if there's enough
+         * that need updating.
+         */
+        bool updated{false};
+        if(pool)
+        {
+            const size_t numUpdates{force ? voices.size()
+                : static_cast<size_t>(std::count_if(voices.begin(), voices.end(),
+                    [](const Voice *voice) noexcept
+                    { return voice->mUpdate.load(std::memory_order_relaxed) != nullptr; }))};
+            updated = pool->updateVoices(ctx, voices, numUpdates, update_voice, force);
+        }
+        if(!updated)
+        {
+            for(Voice *voice : voices)
+                update_voice(voice, ctx, force);
+        }
+
+        /* Pan the quietest mono voices into the ambisonic mix if there's too
+         * many using HRTF.
+         */
+        DeviceBase *device{ctx->mDevice};
+        if(device->mRenderMode == RenderMode::Hrtf)
+            LimitHrtfVoices(ctx, voices, device->mHrtfVoiceLimit, device->mDegradeVoiceScale);
     }
+    IncrementRef(ctx->mUpdateCount);
 }
 
+/* Puts the slot to sleep if its effect is idle and nothing was mixed into its
+ * wet buffer, or wakes it otherwise. Must be called after the slots feeding it
+ * have been processed.
+ */
+void UpdateSlotSleep(EffectSlot *slot, const uint SamplesToDo)
+{
+    if(!slot->mEffectState->isIdle())
+    {
+        slot->mSleeping = false;
+        return;
+    }
+
+    auto is_silent = [SamplesToDo](const FloatBufferLine &buffer) noexcept -> bool
+    {
+        const auto samples = al::span{buffer}.first(SamplesToDo);
+        return std::all_of(samples.begin(), samples.end(),
+            [](const float sample) noexcept { return sample == 0.0f; });
+    };
+    slot->mSleeping = std::all_of(slot->Wet.Buffer.begin(), slot->Wet.Buffer.end(), is_silent);
+}
 
-void ApplyDistanceComp(const al::span<FloatBufferLine> Samples, const size_t SamplesToDo,
-    const al::span<const DistanceComp::ChanData,MaxOutputChannels> chandata)
+/* Times the stages of an update for the device's mixer profile, if it has one.
+ * Each mark adds the time since the previous one to the given counter.
+ */
+class ProfileTimer {
+    MixerProfile *mProfile;
+    steady_clock::time_point mStart;
+    steady_clock::time_point mLast;
+
+public:
+    explicit ProfileTimer(MixerProfile *profile) noexcept
+        : mProfile{profile}, mStart{profile ? steady_clock::now() : steady_clock::time_point{}}
+        , mLast{mStart}
+    { }
+
+    void mark(MixerProfile::Counter counter) noexcept
+    {
+        if(!mProfile) LIKELY return;
+
+        const auto now = steady_clock::now();
+        mProfile->add(counter, duration_cast<nanoseconds>(now - mLast));
+        mLast = now;
+    }
+    void restart() noexcept
+    { if(mProfile) UNLIKELY mLast = steady_clock::now(); }
+
+    /* Counts a finished update, keeping the longest time since construction.
+     * Only the mixing thread finishes updates, so the peak doesn't need an
+     * atomic compare-exchange.
+     */
+    void finishUpdate() noexcept
+    {
+        if(!mProfile) LIKELY return;
+
+        const auto total = static_cast<uint64_t>(duration_cast<nanoseconds>(mLast-mStart).count());
+        auto &peak = mProfile->mCounters[MixerProfile::PeakUpdateTime];
+        if(total > peak.load(std::memory_order_relaxed))
+            peak.store(total, std::memory_order_relaxed);
+        mProfile->add(MixerProfile::Updates, 1u);
+    }
+};
+
+/* Processes and mixes a context's sources and effects, using the given scratch
+ * storage. The mixer pool, if given, is used to split up the work within the
+ * context.
+ */
+void ProcessContext(ContextBase *ctx, const nanoseconds curtime, const uint SamplesToDo,
+    MixerScratch &scratch, MixerPool *pool)
 {
-    ASSUME(SamplesToDo > 0);
+    DeviceBase *device{ctx->mDevice};
+
+    const auto auxslotspan = al::span{*ctx->mActiveAuxSlots.load(std::memory_order_acquire)};
+    const auto auxslots = auxslotspan.first(auxslotspan.size()>>1);
+    const auto sorted_slots = auxslotspan.last(auxslotspan.size()>>1);
+    ProfileTimer timer{device->mProfile.get()};
 
-    auto distcomp = chandata.begin();
-    for(auto &chanbuffer : Samples)
+    al::span<Voice*> voices;
     {
-        const float gain{distcomp->Gain};
-        auto distbuf = al::span{al::assume_aligned<16>(distcomp->Buffer.data()),
-            distcomp->Buffer.size()};
-        ++distcomp;
+        TRACE_SPAN("ParamUpdate", 0u);
 
-        const size_t base{distbuf.size()};
-        if(base < 1) continue;
+        /* Process pending property updates for objects on the context. */
+        ProcessParamUpdates(ctx, auxslots, sorted_slots, device->mMixDegradeChanged, pool);
+        voices = ctx->getMixVoices();
 
-        const auto inout = al::span{al::assume_aligned<16>(chanbuffer.data()), SamplesToDo};
-        if(SamplesToDo >= base) LIKELY
+        /* Make the quietest voices virtual if there's too many playing. */
+        if(device->mRealVoiceLimit > 0 || device->mMixDegrade >= MixDegrade::Voices)
+            LimitRealVoices(voices, device->mRealVoiceLimit, device->mDegradeVoiceScale);
+    }
+    timer.mark(MixerProfile::ParamUpdateTime);
+
+    /* Clear auxiliary effect slot mixing buffers. Sleeping slots are already
+     * clear.
+     */
+    for(EffectSlot *slot : auxslots)
+    {
+        if(slot->mSleeping)
+            continue;
+        for(auto &buffer : slot->Wet.Buffer)
+            buffer.fill(0.0f);
+    }
+
+    /* Process voices that have a playing source, splitting them across
+     * the mixer pool if there is one and the voices can be split.
+     */
+    if(!pool || !pool->mixVoices(ctx, voices, auxslots, curtime, SamplesToDo))
+    {
+        for(Voice *voice : voices)
         {
-            auto delay_end = std::rotate(inout.begin(), inout.end()-ptrdiff_t(base), inout.end());
-            std::swap_ranges(inout.begin(), delay_end, distbuf.begin());
+            const Voice::State vstate{voice->mPlayState.load(std::memory_order_acquire)};
+            if(vstate != Voice::Stopped && vstate != Voice::Pending)
+                voice->mix(vstate, ctx, curtime, SamplesToDo, scratch);
         }
-        else
+        scratch.flushBatch();
+    }
+    ctx->compactMixVoices();
+
+    /* Process effects. Voices time themselves as they mix. */
+    timer.restart();
+    if(!auxslots.empty())
+    {
+        /* Sort the slots into extra storage, so that effect slots come
+         * before their effect slot target (or their targets' target). Skip
+         * sorting if it has already been done.
+         */
+        if(!sorted_slots[0])
         {
-            auto delay_start = std::swap_ranges(inout.begin(), inout.end(), distbuf.begin());
-            std::rotate(distbuf.begin(), delay_start, distbuf.begin()+ptrdiff_t(base));
+            /* First, copy the slots to the sorted list, then partition the
+             * sorted list so that all slots without a target slot go to
+             * the end.
+             */
+            std::copy(auxslots.begin(), auxslots.end(), sorted_slots.begin());
+            auto split_point = std::partition(sorted_slots.begin(), sorted_slots.end(),
+                [](const EffectSlot *slot) noexcept -> bool
+                { return slot->Target != nullptr; });
+            /* There must be at least one slot without a slot target. */
+            assert(split_point != sorted_slots.end());
+
+            /* Simple case: no more than 1 slot has a target slot. Either
+             * all slots go right to the output, or the remaining one must
+             * target an already-partitioned slot.
+             */
+            if(split_point - sorted_slots.begin() > 1)
+            {
+                /* At least two slots target other slots. Order them so each
+                 * slot directly follows the last slot in its feeding chain,
+                 * instead of grouping the slots by depth. A chain like A->B->C
+                 * then processes its stages back to back, with the wet buffer
+                 * just written by one stage still in cache when the next
+                 * stage reads it.
+                 *
+                 * This is a pre-order walk of each output slot's feeders,
+                 * filled in from the back of the list so the result is a
+                 * post-order: every slot still comes after all the slots
+                 * feeding it.
+                 */
+                auto fill_point = split_point;
+                for(EffectSlot *root : al::span{split_point, sorted_slots.end()})
+                {
+                    const EffectSlot *current{root};
+                    while(current)
+                    {
+                        auto feeder = std::find_if(sorted_slots.begin(), fill_point,
+                            [current](const EffectSlot *slot) noexcept -> bool
+                            { return slot->Target == current; });
+                        if(feeder == fill_point)
+                        {
+                            /* No more slots feed this one, go back to the
+                             * slot it feeds to look for its other feeders.
+                             */
+                            current = (current == root) ? nullptr : current->Target;
+                            continue;
+                        }
+
+                        --fill_point;
+                        std::iter_swap(feeder, fill_point);
+                        current = *fill_point;
+                    }
+                }
+                /* This shouldn't happen, but if there's unsorted slots left
+                 * that don't feed into any output slot, they can't contribute
+                 * to the output, so leave them at the front.
+                 */
+            }
         }
-        std::transform(inout.begin(), inout.end(), inout.begin(),
-            [gain](float s) { return s*gain; });
+
+        /* Slots without a target slot are sorted last. They only output to
+         * the device, so with a mixer pool they can be processed in
+         * parallel once the slots feeding them are done.
+         */
+        auto process_slot = [SamplesToDo,&scratch](const EffectSlot *slot)
+        {
+            if(slot->mSleeping)
+                return;
+            TRACE_SPAN("EffectSlot", slot->mId);
+            EffectState *state{slot->mEffectState.get()};
+            state->process(SamplesToDo, slot->Wet.Buffer, scratch.getTarget(state->mOutTarget));
+        };
+        const auto output_slots = std::find_if(sorted_slots.begin(), sorted_slots.end(),
+            [](const EffectSlot *slot) noexcept { return slot->Target == nullptr; });
+        std::for_each(sorted_slots.begin(), output_slots,
+            [SamplesToDo,&process_slot](EffectSlot *slot)
+            {
+                UpdateSlotSleep(slot, SamplesToDo);
+                process_slot(slot);
+            });
+
+        const auto outspan = sorted_slots.subspan(static_cast<size_t>(
+            std::distance(sorted_slots.begin(), output_slots)));
+        std::for_each(outspan.begin(), outspan.end(),
+            [SamplesToDo](EffectSlot *slot) { UpdateSlotSleep(slot, SamplesToDo); });
+        if(!pool || !pool->processEffects(outspan, SamplesToDo))
+            std::for_each(outspan.begin(), outspan.end(), process_slot);
     }
+    timer.mark(MixerProfile::EffectTime);
+
+    /* Signal the event handler if there are any events to read. */
+    RingBuffer *ring{ctx->mAsyncEvents.get()};
+    if(ring->readSpace() > 0 && ctx->mEventSem)
+        ctx->mEventSem->post();
 }
 
-void ApplyDither(const al::span<FloatBufferLine> Samples, uint *dither_seed,
-    const float quant_scale, const size_t SamplesToDo)
+void ProcessContexts(DeviceBase *device, const uint SamplesToDo)
 {
-    static constexpr double invRNGRange{1.0 / std::numeric_limits<uint>::max()};
     ASSUME(SamplesToDo > 0);
 
-    /* Dithering. Generate whitenoise (uniform distribution of random values
-     * between -1 and +1) and add it to the sample values, after scaling up to
-     * the desired quantization depth and before rounding.
+    const nanoseconds curtime{device->mClockBase.load(std::memory_order_relaxed) +
+        nanoseconds{seconds{device->mSamplesDone.load(std::memory_order_relaxed)}}/
+        device->Frequency};
+
+    /* With multiple contexts, mix each one separately on the mixer pool. Each
+     * context then processes serially on its thread.
      */
-    const float invscale{1.0f / quant_scale};
-    uint seed{*dither_seed};
-    auto dither_sample = [&seed,invscale,quant_scale](const float sample) noexcept -> float
+    const auto contexts = al::span{*device->mContexts.load(std::memory_order_acquire)};
+    MixerPool *pool{device->mMixerPool.get()};
+    if(pool)
     {
-        float val{sample * quant_scale};
-        uint rng0{dither_rng(&seed)};
-        uint rng1{dither_rng(&seed)};
-        val += static_cast<float>(rng0*invRNGRange - rng1*invRNGRange);
-        return fast_roundf(val) * invscale;
-    };
-    for(FloatBufferLine &inout : Samples)
-        std::transform(inout.begin(), inout.begin()+SamplesToDo, inout.begin(), dither_sample);
-    *dither_seed = seed;
+        auto process_context = [](ContextBase *ctx, const nanoseconds deviceTime,
+            const uint samplesToDo, MixerScratch &scratch)
+        { ProcessContext(ctx, deviceTime, samplesToDo, scratch, nullptr); };
+        if(pool->processContexts(contexts, process_context, curtime, SamplesToDo))
+            return;
+    }
+
+    for(ContextBase *ctx : contexts)
+        ProcessContext(ctx, curtime, SamplesToDo, device->mMixerScratch, pool);
 }
 
 
@@ -2145,8 +3090,324 @@ template<> inline uint16_t SampleConv(float val) noexcept
 template<> inline uint8_t SampleConv(float val) noexcept
 { return static_cast<uint8_t>(SampleConv<int8_t>(val) + 128); }
 
+/* Applies dithering to a block of samples. Generates triangular noise (the
+ * difference of two uniform random values between 0 and +1) and adds it to
+ * the sample values, after scaling up to the desired quantization depth and
+ * before rounding.
+ *
+ * The random values come from two sets of four interleaved xorshift
+ * generators, with sample i taking its values from generator i%4 of each set,
+ * so the SSE path produces the same noise as the scalar path. For highpass
+ * (shaped) noise, each sample only takes one new random value from the first
+ * set and subtracts the channel's previous one, which moves the noise power
+ * toward higher frequencies.
+ */
+void ApplyDither(const al::span<float> inout, const al::span<uint,8> seeds, uint &last,
+    const float quant_scale, const bool shaped)
+{
+    /* Each random value is reduced to 31 bits, so the difference of two fits
+     * in an int and converts to float with a single rounding.
+     */
+    static constexpr float invRNGRange{1.0f / 2147483648.0f};
+    const float invscale{1.0f / quant_scale};
+
+    auto iter = inout.begin();
+    const size_t todo{inout.size()>>2};
+#ifdef HAVE_SSE_INTRINSICS
+    if(todo > 0)
+    {
+        auto xorshift = [](__m128i x) noexcept -> __m128i
+        {
+            x = _mm_xor_si128(x, _mm_slli_epi32(x, 13));
+            x = _mm_xor_si128(x, _mm_srli_epi32(x, 17));
+            return _mm_xor_si128(x, _mm_slli_epi32(x, 5));
+        };
+        __m128i state0{_mm_loadu_si128(reinterpret_cast<const __m128i*>(&seeds[0]))};
+        __m128i state1{_mm_loadu_si128(reinterpret_cast<const __m128i*>(&seeds[4]))};
+        __m128i prev{_mm_slli_si128(_mm_cvtsi32_si128(static_cast<int>(last)), 12)};
+
+        const __m128 rngscale{_mm_set1_ps(invRNGRange)};
+        const __m128 scale4{_mm_set1_ps(quant_scale)};
+        const __m128 invscale4{_mm_set1_ps(invscale)};
+        const __m128 signmask{_mm_set1_ps(-0.0f)};
+        const __m128 ilim{_mm_set1_ps(8388608.0f)};
+        for(size_t i{0};i < todo;++i)
+        {
+            const __m128i rng0{state0 = xorshift(state0)};
+            __m128i rng1;
+            if(shaped)
+            {
+                /* The previous value for the first sample is the last value
+                 * of the previous group.
+                 */
+                rng1 = _mm_or_si128(_mm_slli_si128(rng0, 4), _mm_srli_si128(prev, 12));
+                prev = rng0;
+            }
+            else
+                rng1 = state1 = xorshift(state1);
+            const __m128i diff{_mm_sub_epi32(_mm_srli_epi32(rng0, 1), _mm_srli_epi32(rng1, 1))};
+            const __m128 noise{_mm_mul_ps(_mm_cvtepi32_ps(diff), rngscale)};
+
+            const __m128 val{_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&iter[0]), scale4), noise)};
+
+            /* Round the same way as fast_roundf, leaving values that can't
+             * have fractional bits unchanged.
+             */
+            const __m128 lim{_mm_or_ps(_mm_and_ps(val, signmask), ilim)};
+            const __m128 rounded{_mm_sub_ps(_mm_add_ps(val, lim), lim)};
+            const __m128 isint{_mm_cmpge_ps(_mm_andnot_ps(signmask, val), ilim)};
+            const __m128 res{_mm_or_ps(_mm_and_ps(isint, val), _mm_andnot_ps(isint, rounded))};
+            _mm_storeu_ps(&iter[0], _mm_mul_ps(res, invscale4));
+            iter += 4;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&seeds[0]), state0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&seeds[4]), state1);
+        if(shaped)
+            last = static_cast<uint>(_mm_cvtsi128_si32(_mm_srli_si128(prev, 12)));
+    }
+#endif
+
+    auto xorshift = [](uint x) noexcept -> uint
+    {
+        x ^= x << 13;
+        x ^= x >> 17;
+        return x ^ (x << 5);
+    };
+    auto dither_sample = [xorshift,invscale,quant_scale,shaped,&last](const float sample,
+        uint &state0, uint &state1) noexcept -> float
+    {
+        const uint rng0{state0 = xorshift(state0)};
+        uint rng1;
+        if(shaped)
+        {
+            rng1 = last;
+            last = rng0;
+        }
+        else
+            rng1 = state1 = xorshift(state1);
+        const int diff{static_cast<int>(rng0>>1) - static_cast<int>(rng1>>1)};
+
+        const float val{sample*quant_scale + static_cast<float>(diff)*invRNGRange};
+        return fast_roundf(val) * invscale;
+    };
+
+    /* Work on local copies of the generators, so they can stay in registers. */
+    std::array<uint,8> states{};
+    std::copy(seeds.begin(), seeds.end(), states.begin());
+    for(;inout.end()-iter >= 4;iter += 4)
+    {
+        iter[0] = dither_sample(iter[0], states[0], states[4]);
+        iter[1] = dither_sample(iter[1], states[1], states[5]);
+        iter[2] = dither_sample(iter[2], states[2], states[6]);
+        iter[3] = dither_sample(iter[3], states[3], states[7]);
+    }
+    for(size_t lane{0};iter != inout.end();++lane,++iter)
+        *iter = dither_sample(*iter, states[lane], states[lane+4]);
+    std::copy(states.begin(), states.end(), seeds.begin());
+}
+
+/* Applies distance compensation and dithering to the device's output mix, one
+ * channel at a time while it's in cache, ahead of the final conversion. The
+ * delay (and dither) goes through a small temporary block when needed, so
+ * each channel is only processed once.
+ */
+void ApplyOutputProcessing(DeviceBase *device, const size_t SamplesToDo)
+{
+    ASSUME(SamplesToDo > 0);
+
+    const auto Buffer = device->RealOut.Buffer;
+    auto *distcomp = device->ChannelDelays ? device->ChannelDelays->mChannels.data() : nullptr;
+    if(!distcomp && !(device->DitherDepth > 0.0f))
+        return;
+
+    alignas(16) std::array<float,BufferLineSize> temp{};
+    const auto block = al::span{temp}.first(SamplesToDo);
+    for(size_t c{0};c < Buffer.size();++c)
+    {
+        const auto inout = al::span{al::assume_aligned<16>(Buffer[c].data()), SamplesToDo};
+
+        /* Apply delays and attenuation for mismatched speaker distances. */
+        auto *chancomp = distcomp ? distcomp+c : nullptr;
+        if(!chancomp || chancomp->Buffer.empty())
+        {
+            /* Apply dithering. The compressor should have left enough
+             * headroom for the dither noise to not saturate.
+             */
+            if(device->DitherDepth > 0.0f)
+                ApplyDither(inout, device->DitherSeeds, device->DitherLast[c], device->DitherDepth,
+                    device->DitherShaped);
+            continue;
+        }
+
+        const float gain{chancomp->Gain};
+        auto apply_gain = [gain](const float s) noexcept { return s*gain; };
+
+        const auto distbuf = al::span{al::assume_aligned<16>(chancomp->Buffer.data()),
+            chancomp->Buffer.size()};
+        const size_t base{distbuf.size()};
+        if(SamplesToDo >= base) LIKELY
+        {
+            auto delay_end = std::transform(distbuf.begin(), distbuf.end(), block.begin(),
+                apply_gain);
+            std::transform(inout.begin(), inout.end()-ptrdiff_t(base), delay_end, apply_gain);
+            std::copy(inout.end()-ptrdiff_t(base), inout.end(), distbuf.begin());
+        }
+        else
+        {
+            std::transform(distbuf.begin(), distbuf.begin()+ptrdiff_t(SamplesToDo),
+                block.begin(), apply_gain);
+            auto delay_end = std::copy(distbuf.begin()+ptrdiff_t(SamplesToDo), distbuf.end(),
+                distbuf.begin());
+            std::copy(inout.begin(), inout.end(), delay_end);
+        }
+
+        if(device->DitherDepth > 0.0f)
+            ApplyDither(block, device->DitherSeeds, device->DitherLast[c], device->DitherDepth,
+                device->DitherShaped);
+        std::copy(block.begin(), block.end(), inout.begin());
+    }
+}
+
+
+/* Converts and interleaves the channels into the output, a frame at a time so
+ * the output is written sequentially.
+ */
+template<typename T>
+void Interleave(const al::span<const FloatBufferLine> InBuffer, const al::span<T> output,
+    const size_t SamplesToDo, const size_t FrameStep)
+{
+    auto out = output.begin();
+    for(size_t i{0};i < SamplesToDo;++i)
+    {
+        std::transform(InBuffer.begin(), InBuffer.end(), out,
+            [i](const FloatBufferLine &chanbuf) noexcept { return SampleConv<T>(chanbuf[i]); });
+        out += ptrdiff_t(FrameStep);
+    }
+}
+
+#ifdef HAVE_SSE_INTRINSICS
+/* Converts and stores four samples, or the low two samples, from a vector. */
+template<typename T>
+void StoreSamples4(const __m128 vals, T *dst) noexcept;
+template<typename T>
+void StoreSamples2(const __m128 vals, T *dst) noexcept;
+
+template<>
+inline void StoreSamples4(const __m128 vals, float *dst) noexcept
+{ _mm_storeu_ps(dst, vals); }
+template<>
+inline void StoreSamples2(const __m128 vals, float *dst) noexcept
+{ _mm_storel_pi(reinterpret_cast<__m64*>(dst), vals); }
+
+/* The same limits as SampleConv<int32_t>, which the conversion can't saturate
+ * to on its own.
+ */
+inline __m128i ConvertSamples_i32(const __m128 vals) noexcept
+{
+    const __m128 scaled{_mm_mul_ps(vals, _mm_set1_ps(2147483648.0f))};
+    return _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(scaled, _mm_set1_ps(-2147483648.0f)),
+        _mm_set1_ps(2147483520.0f)));
+}
+template<>
+inline void StoreSamples4(const __m128 vals, int32_t *dst) noexcept
+{ _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), ConvertSamples_i32(vals)); }
+template<>
+inline void StoreSamples2(const __m128 vals, int32_t *dst) noexcept
+{ _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), ConvertSamples_i32(vals)); }
+
+/* The pack saturates the same as the clamp in SampleConv<int16_t>. */
+inline __m128i ConvertSamples_i16(const __m128 vals) noexcept
+{
+    const __m128i ivals{_mm_cvtps_epi32(_mm_mul_ps(vals, _mm_set1_ps(32768.0f)))};
+    return _mm_packs_epi32(ivals, ivals);
+}
+template<>
+inline void StoreSamples4(const __m128 vals, int16_t *dst) noexcept
+{ _mm_storel_epi64(reinterpret_cast<__m128i*>(dst), ConvertSamples_i16(vals)); }
+template<>
+inline void StoreSamples2(const __m128 vals, int16_t *dst) noexcept
+{
+    const int pair{_mm_cvtsi128_si32(ConvertSamples_i16(vals))};
+    std::memcpy(dst, &pair, sizeof(pair));
+}
+
+/* Interleaves four frames at a time, transposing groups of four channels (and
+ * a remaining pair) in registers.
+ */
 template<typename T>
-void Write(const al::span<const FloatBufferLine> InBuffer, void *OutBuffer, const size_t Offset,
+void Interleave_SSE(const al::span<const FloatBufferLine> InBuffer, const al::span<T> output,
+    const size_t SamplesToDo, const size_t FrameStep)
+{
+    const size_t numchans{InBuffer.size()};
+    const size_t todo{SamplesToDo & ~size_t{3}};
+    auto out = output.begin();
+    for(size_t base{0};base < todo;base += 4)
+    {
+        size_t c{0};
+        for(;numchans-c >= 4;c += 4)
+        {
+            __m128 vals0{_mm_load_ps(&InBuffer[c  ][base])};
+            __m128 vals1{_mm_load_ps(&InBuffer[c+1][base])};
+            __m128 vals2{_mm_load_ps(&InBuffer[c+2][base])};
+            __m128 vals3{_mm_load_ps(&InBuffer[c+3][base])};
+            _MM_TRANSPOSE4_PS(vals0, vals1, vals2, vals3);
+            StoreSamples4(vals0, &out[c]);
+            StoreSamples4(vals1, &out[FrameStep   + c]);
+            StoreSamples4(vals2, &out[FrameStep*2 + c]);
+            StoreSamples4(vals3, &out[FrameStep*3 + c]);
+        }
+        if(numchans-c >= 2)
+        {
+            const __m128 vals0{_mm_load_ps(&InBuffer[c  ][base])};
+            const __m128 vals1{_mm_load_ps(&InBuffer[c+1][base])};
+            const __m128 lo{_mm_unpacklo_ps(vals0, vals1)};
+            const __m128 hi{_mm_unpackhi_ps(vals0, vals1)};
+            if(FrameStep == 2)
+            {
+                /* Plain stereo output is contiguous. */
+                StoreSamples4(lo, &out[0]);
+                StoreSamples4(hi, &out[4]);
+            }
+            else
+            {
+                StoreSamples2(lo, &out[c]);
+                StoreSamples2(_mm_movehl_ps(lo, lo), &out[FrameStep   + c]);
+                StoreSamples2(hi, &out[FrameStep*2 + c]);
+                StoreSamples2(_mm_movehl_ps(hi, hi), &out[FrameStep*3 + c]);
+            }
+            c += 2;
+        }
+        if(c < numchans)
+        {
+            for(size_t i{0};i < 4;++i)
+                out[FrameStep*i + c] = SampleConv<T>(InBuffer[c][base+i]);
+        }
+        out += ptrdiff_t(FrameStep*4);
+    }
+    for(size_t i{todo};i < SamplesToDo;++i)
+    {
+        std::transform(InBuffer.begin(), InBuffer.end(), out,
+            [i](const FloatBufferLine &chanbuf) noexcept { return SampleConv<T>(chanbuf[i]); });
+        out += ptrdiff_t(FrameStep);
+    }
+}
+
+template<>
+void Interleave<float>(const al::span<const FloatBufferLine> InBuffer,
+    const al::span<float> output, const size_t SamplesToDo, const size_t FrameStep)
+{ Interleave_SSE<float>(InBuffer, output, SamplesToDo, FrameStep); }
+template<>
+void Interleave<int32_t>(const al::span<const FloatBufferLine> InBuffer,
+    const al::span<int32_t> output, const size_t SamplesToDo, const size_t FrameStep)
+{ Interleave_SSE<int32_t>(InBuffer, output, SamplesToDo, FrameStep); }
+template<>
+void Interleave<int16_t>(const al::span<const FloatBufferLine> InBuffer,
+    const al::span<int16_t> output, const size_t SamplesToDo, const size_t FrameStep)
+{ Interleave_SSE<int16_t>(InBuffer, output, SamplesToDo, FrameStep); }
+#endif
+
+template<typename T>
+void WriteInterleaved(DeviceBase *device, void *OutBuffer, const size_t Offset,
     const size_t SamplesToDo, const size_t FrameStep)
 {
     ASSUME(FrameStep > 0);
@@ -2154,31 +3415,252 @@ void Write(const al::span<const FloatBufferLine> InBuffer, void *OutBuffer, cons
 
     const auto output = al::span{static_cast<T*>(OutBuffer), (Offset+SamplesToDo)*FrameStep}
         .subspan(Offset*FrameStep);
-    size_t c{0};
-    for(const FloatBufferLine &inbuf : InBuffer)
+    const auto InBuffer = al::span{std::as_const(device->RealOut.Buffer)};
+    const size_t numchans{InBuffer.size()};
+
+    ApplyOutputProcessing(device, SamplesToDo);
+    Interleave<T>(InBuffer, output, SamplesToDo, FrameStep);
+
+    if(const size_t extra{FrameStep - numchans})
+    {
+        const auto silence = SampleConv<T>(0.0f);
+        for(size_t i{0};i < SamplesToDo;++i)
+            std::fill_n(&output[i*FrameStep + numchans], extra, silence);
+    }
+}
+
+/* Writes the output mix to separate channel buffers. */
+template<typename T>
+void WriteSeparate(DeviceBase *device, const al::span<T*const> outputs, const size_t SamplesToDo)
+{
+    ASSUME(SamplesToDo > 0);
+
+    const auto InBuffer = al::span{std::as_const(device->RealOut.Buffer)};
+
+    ApplyOutputProcessing(device, SamplesToDo);
+    for(size_t c{0};c < outputs.size();++c)
     {
-        auto out = output.begin();
-        auto conv_sample = [FrameStep,c,&out](const float s) noexcept
+        const auto input = al::span{al::assume_aligned<16>(InBuffer[c].data()), SamplesToDo};
+        std::transform(input.begin(), input.end(), outputs[c], SampleConv<T>);
+    }
+}
+
+/* Writes silence for the held output, without touching the mixing state. */
+template<typename T>
+void WriteSilence(void *OutBuffer, const size_t Offset, const size_t SamplesToDo,
+    const size_t FrameStep)
+{
+    const auto output = al::span{static_cast<T*>(OutBuffer), (Offset+SamplesToDo)*FrameStep}
+        .subspan(Offset*FrameStep);
+    std::fill(output.begin(), output.end(), SampleConv<T>(0.0f));
+}
+
+/* Marks an update as rendering for DeviceBase::holdOutput, and fades the
+ * output in or out as needed.
+ */
+class OutputHoldScope {
+    using OutputHold = DeviceBase::OutputHold;
+
+    DeviceBase *const mDevice;
+    uint mEndVal;
+    OutputHold mHold;
+
+public:
+    explicit OutputHoldScope(DeviceBase *device) noexcept : mDevice{device}
+    {
+        /* The render count has to be odd before checking the hold state, so
+         * holdOutput can't miss an update it didn't hold.
+         */
+        auto renderCount = device->mRenderCount.load(std::memory_order_relaxed);
+        device->mRenderCount.store(++renderCount, std::memory_order_seq_cst);
+        mEndVal = renderCount+1;
+        mHold = device->mOutputHold.load(std::memory_order_seq_cst);
+    }
+    ~OutputHoldScope()
+    {
+        if(mHold == OutputHold::FadeOut || mHold == OutputHold::FadeIn)
         {
-            out[c] = SampleConv<T>(s);
-            out += ptrdiff_t(FrameStep);
-        };
-        std::for_each_n(inbuf.cbegin(), SamplesToDo, conv_sample);
-        ++c;
+            auto expected = mHold;
+            mDevice->mOutputHold.compare_exchange_strong(expected,
+                (mHold == OutputHold::FadeOut) ? OutputHold::Held : OutputHold::None);
+        }
+        mDevice->mRenderCount.store(mEndVal, std::memory_order_release);
     }
-    if(const size_t extra{FrameStep - c})
+    OutputHoldScope(const OutputHoldScope&) = delete;
+    OutputHoldScope& operator=(const OutputHoldScope&) = delete;
+
+    [[nodiscard]] auto isHeld() const noexcept -> bool { return mHold == OutputHold::Held; }
+
+    /* Applies a linear fade over the rendered samples if the output is being
+     * held or released.
+     */
+    void applyFade(const uint samplesToDo) const noexcept
     {
-        const auto silence = SampleConv<T>(0.0f);
-        for(size_t i{0};i < SamplesToDo;++i)
-            std::fill_n(&output[i*FrameStep + c], extra, silence);
+        if(mHold != OutputHold::FadeOut && mHold != OutputHold::FadeIn)
+            return;
+
+        const bool fadein{mHold == OutputHold::FadeIn};
+        const float step{1.0f / static_cast<float>(samplesToDo)};
+        for(FloatBufferLine &buffer : mDevice->RealOut.Buffer)
+        {
+            const auto output = al::span{buffer}.first(samplesToDo);
+            for(size_t i{0};i < output.size();++i)
+            {
+                const float gain{static_cast<float>(i) * step};
+                output[i] *= fadein ? gain : (1.0f-gain);
+            }
+        }
     }
+};
+
+/* Updates the device's average mixer load with the time taken to mix an
+ * update, and degrades or restores the mix quality a step if needed.
+ */
+void UpdateMixDegrade(DeviceBase *device, const nanoseconds mixtime, const uint samplesToDo)
+{
+    static constexpr float VoiceScaleStep{0.75f};
+    static constexpr float MinVoiceScale{1.0f / 64.0f};
+
+    const nanoseconds duration{nanoseconds{seconds{samplesToDo}} / device->mMixFrequency};
+    const float load{static_cast<float>(mixtime.count())
+        / static_cast<float>(duration.count())};
+    const float avgload{lerpf(device->mMixLoad.load(std::memory_order_relaxed), load, 0.1f)};
+    device->mMixLoad.store(avgload, std::memory_order_relaxed);
+
+    /* Give each change some time to take effect before checking again. */
+    if(device->mDegradeHold > samplesToDo)
+    {
+        device->mDegradeHold -= samplesToDo;
+        return;
+    }
+    device->mDegradeHold = 0;
+
+    const MixDegrade oldlevel{device->mMixDegrade};
+    if(avgload > device->mMixBudget)
+    {
+        switch(device->mMixDegrade)
+        {
+        case MixDegrade::None:
+            device->mMixDegrade = MixDegrade::Resampler;
+            break;
+        case MixDegrade::Resampler:
+            device->mMixDegrade = MixDegrade::Voices;
+            device->mDegradeVoiceScale = VoiceScaleStep;
+            break;
+        case MixDegrade::Voices:
+            if(!(device->mDegradeVoiceScale > MinVoiceScale))
+                return;
+            device->mDegradeVoiceScale = std::max(device->mDegradeVoiceScale*VoiceScaleStep,
+                MinVoiceScale);
+            break;
+        }
+    }
+    else if(avgload < device->mMixBudget*0.5f)
+    {
+        switch(device->mMixDegrade)
+        {
+        case MixDegrade::None:
+            return;
+        case MixDegrade::Resampler:
+            device->mMixDegrade = MixDegrade::None;
+            break;
+        case MixDegrade::Voices:
+            device->mDegradeVoiceScale /= VoiceScaleStep;
+            if(!(device->mDegradeVoiceScale < 1.0f))
+            {
+                device->mMixDegrade = MixDegrade::Resampler;
+                device->mDegradeVoiceScale = 1.0f;
+            }
+            break;
+        }
+    }
+    else
+        return;
+
+    /* Voices need to be updated when the resampler limit changes. */
+    device->mMixDegradeChanged = (device->mMixDegrade == MixDegrade::None)
+        != (oldlevel == MixDegrade::None);
+    device->mDegradeHold = device->mMixFrequency / 10;
 }
 
 } // namespace
 
+void DeviceBase::processUpdatesAhead()
+{
+    /* Hold the mix count like the mixer does, so objects being removed from a
+     * context wait until this is done with them.
+     */
+    const auto mixLock = getWriteMixLock();
+
+    for(ContextBase *ctx : *mContexts.load(std::memory_order_acquire))
+    {
+        const auto auxslotspan = al::span{*ctx->mActiveAuxSlots.load(std::memory_order_acquire)};
+        const auto auxslots = auxslotspan.first(auxslotspan.size()>>1);
+        const auto sorted_slots = auxslotspan.last(auxslotspan.size()>>1);
+
+        ProcessParamUpdates(ctx, auxslots, sorted_slots, false, nullptr);
+    }
+}
+
+void DeviceBase::applyOutputUpdate() noexcept
+{
+    auto update = mOutputUpdate.exchange(nullptr, std::memory_order_acq_rel);
+    if(!update) UNLIKELY return;
+
+    DitherDepth = update->DitherDepth;
+    DitherShaped = update->DitherShaped;
+    if(update->ReplaceLimiter)
+        std::swap(Limiter, update->Limiter);
+
+    /* Hand the update back with the old limiter, to be freed off the mixer. */
+    OutputUpdate *retired{update.release()};
+    OutputUpdate *head{mRetiredOutputUpdates.load(std::memory_order_relaxed)};
+    do {
+        retired->mNext = head;
+    } while(!mRetiredOutputUpdates.compare_exchange_weak(head, retired,
+        std::memory_order_release, std::memory_order_relaxed));
+}
+
 uint DeviceBase::renderSamples(const uint numSamples)
 {
-    const uint samplesToDo{std::min(numSamples, uint{BufferLineSize})};
+    /* With an upsampled output, write what's left of the last mix first. */
+    if(mOutputCount > 0)
+    {
+        const uint samplesToDo{std::min(numSamples, mOutputCount)};
+        auto outbuf = mOutputBuffer.cbegin();
+        for(FloatBufferLine &buffer : RealOut.Buffer)
+        {
+            std::copy_n(outbuf->cbegin()+mOutputOffset, samplesToDo, buffer.begin());
+            ++outbuf;
+        }
+        mOutputOffset += samplesToDo;
+        mOutputCount -= samplesToDo;
+        return samplesToDo;
+    }
+
+    if(mOutputUpdate.load(std::memory_order_relaxed)) UNLIKELY
+        applyOutputUpdate();
+
+    uint samplesToDo{std::min(numSamples, uint{BufferLineSize})};
+    uint outputToDo{samplesToDo};
+    SampleConverter *converter{mOutputConverter.get()};
+    if(converter)
+    {
+        /* Mix as many samples as can be upsampled without exceeding the
+         * requested output. The converter needs all mixed samples to be
+         * consumed, since it only keeps enough for the resampler's history.
+         */
+        const uint64_t srcEnd{(uint64_t{samplesToDo}*converter->mIncrement
+            + converter->mFracOffset) >> MixerFracBits};
+        samplesToDo = static_cast<uint>(std::clamp(srcEnd + MaxResamplerPadding
+            - converter->mSrcPrepCount, 1_u64, uint64_t{BufferLineSize}));
+        outputToDo = converter->availableOut(samplesToDo);
+    }
+
+    const auto mixStart = (mMixBudget > 0.0f) ? std::chrono::steady_clock::now()
+        : std::chrono::steady_clock::time_point{};
+    ProfileTimer timer{mProfile.get()};
+    TRACE_SPAN("Update", samplesToDo);
 
     /* Clear main mixing buffers. */
     for(FloatBufferLine &buffer : MixBuffer)
@@ -2189,54 +3671,110 @@ uint DeviceBase::renderSamples(const uint numSamples)
 
         /* Process and mix each context's sources and effects. */
         ProcessContexts(this, samplesToDo);
+        mMixDegradeChanged = false;
 
         /* Every second's worth of samples is converted and added to clock base
          * so that large sample counts don't overflow during conversion. This
-         * also guarantees a stable conversion.
+         * also guarantees a stable conversion. The clock counts output
+         * samples, which are ahead of what's been written while an upsampled
+         * mix is held.
          */
-        auto samplesDone = mSamplesDone.load(std::memory_order_relaxed) + samplesToDo;
+        auto samplesDone = mSamplesDone.load(std::memory_order_relaxed) + outputToDo;
         auto clockBase = mClockBase.load(std::memory_order_relaxed) +
             std::chrono::seconds{samplesDone/Frequency};
-        mSamplesDone.store(samplesDone%Frequency, std::memory_order_relaxed);
-        mClockBase.store(clockBase, std::memory_order_relaxed);
+        setClock(clockBase, samplesDone%Frequency);
     }
 
-    /* Apply any needed post-process for finalizing the Dry mix to the RealOut
-     * (Ambisonic decode, UHJ encode, etc).
+    /* Process the property updates that came in during this mix while its
+     * output gets finished, so the next mix has less to do first.
      */
-    postProcess(samplesToDo);
+    ParamUpdateThread *paramThread{mParamThread.get()};
+    if(paramThread)
+        paramThread->start();
+    timer.restart();
 
-    /* Apply compression, limiting sample amplitude if needed or desired. */
-    if(Limiter) Limiter->process(samplesToDo, RealOut.Buffer.data());
+    {
+        TRACE_SPAN("PostProcess", 0u);
 
-    /* Apply delays and attenuation for mismatched speaker distances. */
-    if(ChannelDelays)
-        ApplyDistanceComp(RealOut.Buffer, samplesToDo, ChannelDelays->mChannels);
+        /* Apply any needed post-process for finalizing the Dry mix to the
+         * RealOut (Ambisonic decode, UHJ encode, etc).
+         */
+        postProcess(samplesToDo);
 
-    /* Apply dithering. The compressor should have left enough headroom for the
-     * dither noise to not saturate.
+        /* Upsample the RealOut mix to the output rate. */
+        auto outbufs = al::span{RealOut.Buffer};
+        if(converter)
+        {
+            std::array<const void*,MaxOutputChannels> srcs{};
+            std::array<void*,MaxOutputChannels> dsts{};
+            std::transform(RealOut.Buffer.begin(), RealOut.Buffer.end(), srcs.begin(),
+                [](const FloatBufferLine &buffer) noexcept { return buffer.data(); });
+            std::transform(mOutputBuffer.begin(), mOutputBuffer.end(), dsts.begin(),
+                [](FloatBufferLine &buffer) noexcept { return buffer.data(); });
+
+            uint srcframes{samplesToDo};
+            [[maybe_unused]] const uint got{converter->convertPlanar(srcs.data(), &srcframes,
+                dsts.data(), BufferLineSize)};
+            assert(got == outputToDo && srcframes == 0);
+            outbufs = al::span{mOutputBuffer};
+        }
+
+        /* Apply compression, limiting sample amplitude if needed or desired.
+         * Distance compensation and dithering are applied when writing the
+         * output.
+         */
+        if(Limiter) Limiter->process(outputToDo, outbufs.data());
+    }
+    timer.mark(MixerProfile::PostProcessTime);
+
+    /* The mix degradation level is used by the parameter updates, so they
+     * need to be done before it changes.
      */
-    if(DitherDepth > 0.0f)
-        ApplyDither(RealOut.Buffer, &DitherSeed, DitherDepth, samplesToDo);
+    if(paramThread)
+        paramThread->finish();
+
+    if(mMixBudget > 0.0f)
+        UpdateMixDegrade(this, std::chrono::steady_clock::now() - mixStart, samplesToDo);
 
+    if(converter)
+    {
+        mOutputOffset = 0;
+        mOutputCount = outputToDo;
+        return renderSamples(numSamples);
+    }
     return samplesToDo;
 }
 
 void DeviceBase::renderSamples(const al::span<float*> outBuffers, const uint numSamples)
 {
     FPUCtl mixer_mode{};
+    LogRealtimeScope logscope{};
     uint total{0};
     while(const uint todo{numSamples - total})
     {
+        OutputHoldScope hold{this};
+        if(hold.isHeld())
+        {
+            for(float *dstbuf : outBuffers)
+                std::fill_n(dstbuf+total, todo, 0.0f);
+            total += todo;
+            continue;
+        }
+
+        ProfileTimer timer{mProfile.get()};
         const uint samplesToDo{renderSamples(todo)};
+        hold.applyFade(samplesToDo);
 
-        auto srcbuf = RealOut.Buffer.cbegin();
-        for(auto *dstbuf : outBuffers)
+        timer.restart();
         {
-            const auto dst = al::span{dstbuf, numSamples}.subspan(total);
-            std::copy_n(srcbuf->cbegin(), samplesToDo, dst.begin());
-            ++srcbuf;
+            TRACE_SPAN("Write", samplesToDo);
+            std::array<float*,MaxOutputChannels> chanptrs{};
+            std::transform(outBuffers.begin(), outBuffers.end(), chanptrs.begin(),
+                [total](float *dstbuf) noexcept { return dstbuf + total; });
+            WriteSeparate<float>(this, al::span{chanptrs}.first(outBuffers.size()), samplesToDo);
         }
+        timer.mark(MixerProfile::WriteTime);
+        timer.finishUpdate();
 
         total += samplesToDo;
     }
@@ -2245,20 +3783,49 @@ void DeviceBase::renderSamples(const al::span<float*> outBuffers, const uint num
 void DeviceBase::renderSamples(void *outBuffer, const uint numSamples, const size_t frameStep)
 {
     FPUCtl mixer_mode{};
+    LogRealtimeScope logscope{};
     uint total{0};
     while(const uint todo{numSamples - total})
     {
+        OutputHoldScope hold{this};
+        if(hold.isHeld())
+        {
+            if(outBuffer) LIKELY
+            {
+                switch(FmtType)
+                {
+#define HANDLE_WRITE(T) case T:                                               \
+    WriteSilence<DevFmtType_t<T>>(outBuffer, total, todo, frameStep); break;
+                HANDLE_WRITE(DevFmtByte)
+                HANDLE_WRITE(DevFmtUByte)
+                HANDLE_WRITE(DevFmtShort)
+                HANDLE_WRITE(DevFmtUShort)
+                HANDLE_WRITE(DevFmtInt)
+                HANDLE_WRITE(DevFmtUInt)
+                HANDLE_WRITE(DevFmtFloat)
+#undef HANDLE_WRITE
+                }
+            }
+            total += todo;
+            continue;
+        }
+
+        ProfileTimer timer{mProfile.get()};
         const uint samplesToDo{renderSamples(todo)};
+        hold.applyFade(samplesToDo);
 
+        timer.restart();
         if(outBuffer) LIKELY
         {
+            TRACE_SPAN("Write", samplesToDo);
+
             /* Finally, interleave and convert samples, writing to the device's
              * output buffer.
              */
             switch(FmtType)
             {
 #define HANDLE_WRITE(T) case T:                                               \
-    Write<DevFmtType_t<T>>(RealOut.Buffer, outBuffer, total, samplesToDo, frameStep); break;
+    WriteInterleaved<DevFmtType_t<T>>(this, outBuffer, total, samplesToDo, frameStep); break;
             HANDLE_WRITE(DevFmtByte)
             HANDLE_WRITE(DevFmtUByte)
             HANDLE_WRITE(DevFmtShort)
@@ -2269,6 +3836,15 @@ void DeviceBase::renderSamples(void *outBuffer, const uint numSamples, const siz
 #undef HANDLE_WRITE
             }
         }
+        else
+        {
+            /* With nowhere to write, still run the output processing so the
+             * distance compensation delays and dither state keep advancing.
+             */
+            ApplyOutputProcessing(this, samplesToDo);
+        }
+        timer.mark(MixerProfile::WriteTime);
+        timer.finishUpdate();
 
         total += samplesToDo;
     }
@@ -2280,36 +3856,36 @@ void DeviceBase::handleDisconnect(const char *msg, ...)
 
     if(Connected.exchange(false, std::memory_order_acq_rel))
     {
-        AsyncEvent evt{std::in_place_type<AsyncDisconnectEvent>};
-        auto &disconnect = std::get<AsyncDisconnectEvent>(evt);
+        /* Format the message on the stack, and copy it into a block from the
+         * device's event pool for each context's event. This may be called from the
+         * mixer thread, so nothing here may use the heap.
+         */
+        std::array<char,EventPoolBlockSize> msgbuf{};
 
         /* NOLINTBEGIN(*-array-to-pointer-decay) */
-        va_list args, args2;
+        va_list args;
         va_start(args, msg);
-        va_copy(args2, args);
-        if(int msglen{vsnprintf(nullptr, 0, msg, args)}; msglen > 0)
-        {
-            disconnect.msg.resize(static_cast<uint>(msglen)+1_uz);
-            vsnprintf(disconnect.msg.data(), disconnect.msg.size(), msg, args2);
-        }
-        else
-            disconnect.msg = "<failed constructing message>";
-        va_end(args2);
+        if(vsnprintf(msgbuf.data(), msgbuf.size(), msg, args) < 0)
+            std::strncpy(msgbuf.data(), "<failed constructing message>", msgbuf.size()-1);
         va_end(args);
         /* NOLINTEND(*-array-to-pointer-decay) */
 
-        while(!disconnect.msg.empty() && disconnect.msg.back() == '\0')
-            disconnect.msg.pop_back();
-
         for(ContextBase *ctx : *mContexts.load())
         {
             RingBuffer *ring{ctx->mAsyncEvents.get()};
             auto evt_data = ring->getWriteVector().first;
             if(evt_data.len > 0)
             {
-                al::construct_at(reinterpret_cast<AsyncEvent*>(evt_data.buf), evt);
+                auto &evt = InitAsyncEvent<AsyncDisconnectEvent>(evt_data.buf);
+                if(void *block{mEventPool.allocate()})
+                {
+                    evt.mMsg = al::FixedPoolPtr<char>{static_cast<char*>(block),
+                        al::FixedPoolDeleter{&mEventPool}};
+                    std::copy(msgbuf.cbegin(), msgbuf.cend(), evt.mMsg.get());
+                }
                 ring->writeAdvance(1);
-                ctx->mEventSem.post();
+                if(ctx->mEventSem)
+                    ctx->mEventSem->post();
             }
 
             if(!ctx->mStopVoicesOnDisconnect.load())
@@ -2327,6 +3903,11 @@ void DeviceBase::handleDisconnect(const char *msg, ...)
                 voice->mPlayState.store(Voice::Stopped, std::memory_order_release);
             };
             std::for_each(voicelist.begin(), voicelist.end(), stop_voice);
+            ctx->syncMixVoices();
+            ctx->compactMixVoices();
         }
+
+        /* Nothing more will be captured. */
+        wakeCaptureWaiters();
     }
 }
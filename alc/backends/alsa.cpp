@@ -110,6 +110,7 @@ using namespace std::string_view_literals;
     MAGIC(snd_pcm_wait);                                                      \
     MAGIC(snd_pcm_delay);                                                     \
     MAGIC(snd_pcm_state);                                                     \
+    MAGIC(snd_pcm_avail);                                                     \
     MAGIC(snd_pcm_avail_update);                                              \
     MAGIC(snd_pcm_mmap_begin);                                                \
     MAGIC(snd_pcm_mmap_commit);                                               \
@@ -190,6 +191,7 @@ ALSA_FUNCS(MAKE_FUNC);
 #define snd_pcm_wait psnd_pcm_wait
 #define snd_pcm_delay psnd_pcm_delay
 #define snd_pcm_state psnd_pcm_state
+#define snd_pcm_avail psnd_pcm_avail
 #define snd_pcm_avail_update psnd_pcm_avail_update
 #define snd_pcm_mmap_begin psnd_pcm_mmap_begin
 #define snd_pcm_mmap_commit psnd_pcm_mmap_commit
@@ -241,6 +243,14 @@ SwParamsPtr CreateSwParams()
     return SwParamsPtr{sp};
 }
 
+/* Minimum hardware buffer length (in microseconds) for timer scheduling. */
+constexpr uint TSchedBufferTime{250000};
+
+/* Seconds of playback without an underrun before adaptive buffering steps the
+ * fill target back down.
+ */
+constexpr uint AdaptiveCalmSeconds{10};
+
 
 struct DevMap {
     std::string name;
@@ -473,7 +483,9 @@ struct AlsaPlayback final : public BackendBase {
     AlsaPlayback(DeviceBase *device) noexcept : BackendBase{device} { }
     ~AlsaPlayback() override;
 
+    bool writeMMap(snd_pcm_uframes_t avail);
     int mixerProc();
+    int mixerTSchedProc();
     int mixerNoMMapProc();
 
     void open(std::string_view name) override;
@@ -488,6 +500,10 @@ struct AlsaPlayback final : public BackendBase {
     std::mutex mMutex;
 
     uint mFrameStep{};
+    bool mSeparate{false};
+    bool mTSched{false};
+    bool mAdaptive{false};
+    snd_pcm_uframes_t mHwBufferSize{};
     std::vector<std::byte> mBuffer;
 
     std::atomic<bool> mKillNow{true};
@@ -502,6 +518,75 @@ AlsaPlayback::~AlsaPlayback()
 }
 
 
+/* Renders the given number of sample frames into the device's mmap buffer.
+ * It is possible for the contiguous areas to be smaller, so this may loop.
+ */
+bool AlsaPlayback::writeMMap(snd_pcm_uframes_t avail)
+{
+    while(avail > 0)
+    {
+        snd_pcm_uframes_t frames{avail};
+
+        const snd_pcm_channel_area_t *areas{};
+        snd_pcm_uframes_t offset{};
+        int err{snd_pcm_mmap_begin(mPcmHandle, &areas, &offset, &frames)};
+        if(err < 0)
+        {
+            ERR("mmap begin error: %s\n", snd_strerror(err));
+            return false;
+        }
+
+        if(mSeparate)
+        {
+            /* With non-interleaved float access, each channel area is a
+             * plain float array the mix can be written to directly.
+             */
+            const auto chanareas = al::span{areas, mFrameStep};
+            if(std::any_of(chanareas.begin(), chanareas.end(),
+                [](const snd_pcm_channel_area_t &area) noexcept
+                { return area.step != sizeof(float)*8 || (area.first%8) != 0; }))
+            {
+                ERR("Unexpected mmap channel area layout\n");
+                return false;
+            }
+
+            std::array<float*,MaxOutputChannels> chanptrs{};
+            std::transform(chanareas.begin(), chanareas.end(), chanptrs.begin(),
+                [offset](const snd_pcm_channel_area_t &area) noexcept -> float*
+                {
+                    /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic) */
+                    char *base{static_cast<char*>(area.addr) + area.first/8};
+                    /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic) */
+                    return reinterpret_cast<float*>(base) + offset;
+                });
+            timeRenderStart();
+            mDevice->renderSamples(al::span{chanptrs}.first(mFrameStep),
+                static_cast<uint>(frames));
+            timeRenderEnd();
+        }
+        else
+        {
+            /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic) */
+            char *WritePtr{static_cast<char*>(areas->addr) + (offset * areas->step / 8)};
+            timeRenderStart();
+            mDevice->renderSamples(WritePtr, static_cast<uint>(frames), mFrameStep);
+            timeRenderEnd();
+        }
+
+        snd_pcm_sframes_t commitres{snd_pcm_mmap_commit(mPcmHandle, offset, frames)};
+        if(commitres < 0 || static_cast<snd_pcm_uframes_t>(commitres) != frames)
+        {
+            ERR("mmap commit error: %s\n",
+                snd_strerror(commitres >= 0 ? -EPIPE : static_cast<int>(commitres)));
+            return false;
+        }
+        timeCommit();
+
+        avail -= frames;
+    }
+    return true;
+}
+
 int AlsaPlayback::mixerProc()
 {
     SetRTPriority();
@@ -518,6 +603,8 @@ int AlsaPlayback::mixerProc()
             mDevice->handleDisconnect("Bad state: %s", snd_strerror(state));
             break;
         }
+        if(state == SND_PCM_STATE_XRUN)
+            xrunOccurred();
 
         snd_pcm_sframes_t avails{snd_pcm_avail_update(mPcmHandle)};
         if(avails < 0)
@@ -552,35 +639,111 @@ int AlsaPlayback::mixerProc()
         }
         avail -= avail%update_size;
 
-        // it is possible that contiguous areas are smaller, thus we use a loop
+        timeWakeup();
         std::lock_guard<std::mutex> dlock{mMutex};
-        while(avail > 0)
-        {
-            snd_pcm_uframes_t frames{avail};
+        writeMMap(avail);
+    }
 
-            const snd_pcm_channel_area_t *areas{};
-            snd_pcm_uframes_t offset{};
-            int err{snd_pcm_mmap_begin(mPcmHandle, &areas, &offset, &frames)};
-            if(err < 0)
+    return 0;
+}
+
+/* Timer-scheduled playback. The hardware buffer is large, but only kept
+ * filled to the device's buffer size. Rather than waking for each period, the
+ * mixer sleeps until the queued amount drains to a watermark, then tops the
+ * buffer back up with however many samples are needed.
+ */
+int AlsaPlayback::mixerTSchedProc()
+{
+    SetRTPriority();
+    althrd_setname(GetMixerThreadName());
+
+    const snd_pcm_uframes_t base_fill{mDevice->BufferSize};
+    const snd_pcm_uframes_t buffer_size{mHwBufferSize};
+    /* With adaptive buffering, the fill target grows on underruns, up to
+     * most of the hardware buffer, and shrinks back a step at a time after a
+     * while without any.
+     */
+    const snd_pcm_uframes_t max_fill{std::max(base_fill, buffer_size - buffer_size/4)};
+    const uint calm_time{mDevice->Frequency * AdaptiveCalmSeconds};
+    snd_pcm_uframes_t target_fill{base_fill};
+    uint calm_count{0u};
+    /* The amount left queued when waking, to cover scheduling delays and the
+     * time spent mixing. This is raised if underruns occur.
+     */
+    snd_pcm_uframes_t watermark{mDevice->UpdateSize};
+    while(!mKillNow.load(std::memory_order_acquire))
+    {
+        int state{verify_state(mPcmHandle)};
+        if(state < 0)
+        {
+            ERR("Invalid state detected: %s\n", snd_strerror(state));
+            mDevice->handleDisconnect("Bad state: %s", snd_strerror(state));
+            break;
+        }
+        if(state == SND_PCM_STATE_XRUN)
+        {
+            xrunOccurred();
+            calm_count = 0;
+            if(mAdaptive && target_fill < max_fill)
             {
-                ERR("mmap begin error: %s\n", snd_strerror(err));
-                break;
+                target_fill = std::min(target_fill + target_fill/2, max_fill);
+                bufferSizeChanged(static_cast<uint>(target_fill));
+            }
+            if(watermark < target_fill/2)
+            {
+                watermark = std::min(watermark*2, target_fill/2);
+                WARN("Underrun, raising wakeup watermark to %lu samples\n", watermark);
             }
+        }
+        else if(mAdaptive && target_fill > base_fill && calm_count >= calm_time)
+        {
+            calm_count = 0;
+            target_fill = std::max(target_fill - target_fill/4, base_fill);
+            watermark = std::min(watermark, target_fill/2);
+            bufferSizeChanged(static_cast<uint>(target_fill));
+        }
 
-            /* NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic) */
-            char *WritePtr{static_cast<char*>(areas->addr) + (offset * areas->step / 8)};
-            mDevice->renderSamples(WritePtr, static_cast<uint>(frames), mFrameStep);
+        snd_pcm_sframes_t avails{snd_pcm_avail(mPcmHandle)};
+        if(avails < 0)
+        {
+            ERR("available update failed: %s\n", snd_strerror(static_cast<int>(avails)));
+            continue;
+        }
+        const snd_pcm_uframes_t avail{static_cast<snd_pcm_uframes_t>(avails)};
+        if(avail > buffer_size)
+        {
+            WARN("available samples exceeds the buffer size\n");
+            snd_pcm_reset(mPcmHandle);
+            continue;
+        }
 
-            snd_pcm_sframes_t commitres{snd_pcm_mmap_commit(mPcmHandle, offset, frames)};
-            if(commitres < 0 || static_cast<snd_pcm_uframes_t>(commitres) != frames)
+        snd_pcm_uframes_t queued{buffer_size - avail};
+        if(queued < target_fill)
+        {
+            timeWakeup();
+            std::lock_guard<std::mutex> dlock{mMutex};
+            const snd_pcm_uframes_t todo{target_fill - queued};
+            if(writeMMap(todo))
             {
-                ERR("mmap commit error: %s\n",
-                    snd_strerror(commitres >= 0 ? -EPIPE : static_cast<int>(commitres)));
-                break;
+                queued = target_fill;
+                calm_count = static_cast<uint>(std::min<snd_pcm_uframes_t>(calm_count + todo,
+                    calm_time));
             }
+        }
 
-            avail -= frames;
+        if(snd_pcm_state(mPcmHandle) == SND_PCM_STATE_PREPARED)
+        {
+            int err{snd_pcm_start(mPcmHandle)};
+            if(err < 0)
+            {
+                ERR("start failed: %s\n", snd_strerror(err));
+                continue;
+            }
         }
+
+        const snd_pcm_uframes_t sleep_frames{(queued > watermark) ? queued - watermark : 0};
+        std::this_thread::sleep_for(std::chrono::nanoseconds{std::chrono::seconds{sleep_frames}}
+            / mDevice->Frequency);
     }
 
     return 0;
@@ -602,6 +765,8 @@ int AlsaPlayback::mixerNoMMapProc()
             mDevice->handleDisconnect("Bad state: %s", snd_strerror(state));
             break;
         }
+        if(state == SND_PCM_STATE_XRUN)
+            xrunOccurred();
 
         snd_pcm_sframes_t avail{snd_pcm_avail_update(mPcmHandle)};
         if(avail < 0)
@@ -635,8 +800,11 @@ int AlsaPlayback::mixerNoMMapProc()
 
         auto WritePtr = mBuffer.begin();
         avail = snd_pcm_bytes_to_frames(mPcmHandle, static_cast<ssize_t>(mBuffer.size()));
+        timeWakeup();
         std::lock_guard<std::mutex> dlock{mMutex};
+        timeRenderStart();
         mDevice->renderSamples(al::to_address(WritePtr), static_cast<uint>(avail), mFrameStep);
+        timeRenderEnd();
         while(avail > 0)
         {
             snd_pcm_sframes_t ret{snd_pcm_writei(mPcmHandle, al::to_address(WritePtr),
@@ -649,6 +817,9 @@ int AlsaPlayback::mixerNoMMapProc()
             case -ESTRPIPE:
 #endif
             case -EPIPE:
+                if(ret == -EPIPE)
+                    xrunOccurred();
+                [[fallthrough]];
             case -EINTR:
                 ret = snd_pcm_recover(mPcmHandle, static_cast<int>(ret), 1);
                 if(ret < 0)
@@ -668,6 +839,7 @@ int AlsaPlayback::mixerNoMMapProc()
                 if(ret < 0) break;
             }
         }
+        timeCommit();
     }
 
     return 0;
@@ -752,13 +924,48 @@ bool AlsaPlayback::reset()
             snd_strerror(err)};                                               \
 } while(0)
     CHECK(snd_pcm_hw_params_any(mPcmHandle, hp.get()));
+    /* Float output can use non-interleaved mmap access, letting the mixer
+     * write its channel buffers directly into the device's channel areas
+     * without a separate interleaving pass.
+     */
+    bool usemmap{false};
+    if(allowmmap && mDevice->FmtType == DevFmtFloat
+        && GetConfigValueBool(mDevice->DeviceName, "alsa"sv, "noninterleaved"sv, true)
+        && snd_pcm_hw_params_set_access(mPcmHandle, hp.get(),
+            SND_PCM_ACCESS_MMAP_NONINTERLEAVED) >= 0)
+    {
+        if(snd_pcm_hw_params_test_format(mPcmHandle, hp.get(), SND_PCM_FORMAT_FLOAT) >= 0)
+            usemmap = true;
+        else
+            CHECK(snd_pcm_hw_params_any(mPcmHandle, hp.get()));
+    }
     /* set interleaved access */
-    if(!allowmmap
-        || snd_pcm_hw_params_set_access(mPcmHandle, hp.get(), SND_PCM_ACCESS_MMAP_INTERLEAVED) < 0)
+    if(!usemmap && allowmmap
+        && snd_pcm_hw_params_set_access(mPcmHandle, hp.get(), SND_PCM_ACCESS_MMAP_INTERLEAVED) >= 0)
+        usemmap = true;
+    if(!usemmap)
     {
         /* No mmap */
         CHECK(snd_pcm_hw_params_set_access(mPcmHandle, hp.get(), SND_PCM_ACCESS_RW_INTERLEAVED));
     }
+    /* Timer-based scheduling needs mmap access. It uses a large hardware
+     * buffer, with the requested buffer length as the fill target and the
+     * period length as the wakeup watermark.
+     */
+    /* Adaptive buffering changes the fill target at runtime, so it implies
+     * timer-based scheduling by default.
+     */
+    const bool adaptive{GetConfigValueBool(mDevice->DeviceName, {}, "adaptive-buffering"sv,
+        false)};
+    const bool tsched{usemmap
+        && GetConfigValueBool(mDevice->DeviceName, "alsa"sv, "tsched"sv, adaptive)};
+    const uint targetLen{bufferLen};
+    const uint watermarkLen{periodLen};
+    if(tsched)
+    {
+        bufferLen = std::max(bufferLen, TSchedBufferTime);
+        periodLen = bufferLen / 4;
+    }
     /* test and set format (implicitly sets sample bits) */
     if(snd_pcm_hw_params_test_format(mPcmHandle, hp.get(), format) < 0)
     {
@@ -829,14 +1036,33 @@ bool AlsaPlayback::reset()
 
     SwParamsPtr sp{CreateSwParams()};
     CHECK(snd_pcm_sw_params_current(mPcmHandle, sp.get()));
-    CHECK(snd_pcm_sw_params_set_avail_min(mPcmHandle, sp.get(), periodSizeInFrames));
+    CHECK(snd_pcm_sw_params_set_avail_min(mPcmHandle, sp.get(),
+        tsched ? bufferSizeInFrames : periodSizeInFrames));
     CHECK(snd_pcm_sw_params_set_stop_threshold(mPcmHandle, sp.get(), bufferSizeInFrames));
     CHECK(snd_pcm_sw_params(mPcmHandle, sp.get()));
 #undef CHECK
     sp = nullptr;
 
-    mDevice->BufferSize = static_cast<uint>(bufferSizeInFrames);
-    mDevice->UpdateSize = static_cast<uint>(periodSizeInFrames);
+    mTSched = tsched;
+    mAdaptive = tsched && adaptive;
+    if(adaptive && !tsched)
+        WARN("Adaptive buffering requires timer-based scheduling\n");
+    mHwBufferSize = bufferSizeInFrames;
+    if(tsched)
+    {
+        const auto bufferSize = static_cast<uint>(std::min<uint64_t>(bufferSizeInFrames,
+            targetLen * uint64_t{rate} / 1000000));
+        const auto updateSize = static_cast<uint>(watermarkLen * uint64_t{rate} / 1000000);
+        mDevice->BufferSize = std::max(bufferSize, 2u);
+        mDevice->UpdateSize = std::clamp(updateSize, 1u, mDevice->BufferSize/2);
+        TRACE("Timer scheduling with %lu sample hardware buffer, %u target, %u watermark\n",
+            bufferSizeInFrames, mDevice->BufferSize, mDevice->UpdateSize);
+    }
+    else
+    {
+        mDevice->BufferSize = static_cast<uint>(bufferSizeInFrames);
+        mDevice->UpdateSize = static_cast<uint>(periodSizeInFrames);
+    }
     mDevice->Frequency = rate;
 
     setDefaultChannelOrder();
@@ -867,8 +1093,9 @@ void AlsaPlayback::start()
     }
     else
     {
+        mSeparate = (access == SND_PCM_ACCESS_MMAP_NONINTERLEAVED);
         CHECK(snd_pcm_prepare(mPcmHandle));
-        thread_func = &AlsaPlayback::mixerProc;
+        thread_func = mTSched ? &AlsaPlayback::mixerTSchedProc : &AlsaPlayback::mixerProc;
     }
 #undef CHECK
 
@@ -922,6 +1149,7 @@ struct AlsaCapture final : public BackendBase {
     void stop() override;
     void captureSamples(std::byte *buffer, uint samples) override;
     uint availableSamples() override;
+    RingBuffer *getCaptureRing() override { return mRing.get(); }
     ClockLatency getClockLatency() override;
 
     snd_pcm_t *mPcmHandle{nullptr};
@@ -1036,7 +1264,8 @@ void AlsaCapture::open(std::string_view name)
     hp = nullptr;
 
     if(needring)
-        mRing = RingBuffer::Create(mDevice->BufferSize, mDevice->frameSizeFromFmt(), false);
+        mRing = RingBuffer::Create(mDevice->BufferSize, mDevice->frameSizeFromFmt(), false,
+            true);
 
     mDevice->DeviceName = name;
 }
@@ -1270,6 +1499,26 @@ bool AlsaBackendFactory::init()
 bool AlsaBackendFactory::querySupport(BackendType type)
 { return (type == BackendType::Playback || type == BackendType::Capture); }
 
+alc::EventSupport AlsaBackendFactory::queryEventSupport(alc::EventType eventType, BackendType type)
+{
+    switch(eventType)
+    {
+    case alc::EventType::BufferSizeChanged:
+        if(type == BackendType::Playback)
+            return alc::EventSupport::FullSupport;
+        break;
+
+    case alc::EventType::DefaultDeviceChanged:
+    case alc::EventType::DeviceAdded:
+    case alc::EventType::DeviceRemoved:
+    case alc::EventType::HrtfReady:
+    case alc::EventType::CaptureReady:
+    case alc::EventType::Count:
+        break;
+    }
+    return alc::EventSupport::NoSupport;
+}
+
 auto AlsaBackendFactory::enumerate(BackendType type) -> std::vector<std::string>
 {
     std::vector<std::string> outnames;
@@ -9,6 +9,8 @@ public:
 
     auto querySupport(BackendType type) -> bool final;
 
+    auto queryEventSupport(alc::EventType eventType, BackendType type) -> alc::EventSupport final;
+
     auto enumerate(BackendType type) -> std::vector<std::string> final;
 
     auto createBackend(DeviceBase *device, BackendType type) -> BackendPtr final;
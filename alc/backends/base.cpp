@@ -6,8 +6,12 @@
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <cstdio>
+#include <numeric>
 
+#include "alc/device.h"
 #include "core/devformat.h"
+#include "core/logging.h"
 
 
 namespace al {
@@ -26,6 +30,52 @@ backend_exception::~backend_exception() = default;
 } // namespace al
 
 
+void BackendTiming::add(Stage stage, std::chrono::nanoseconds duration) noexcept
+{
+    const auto usec = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    /* Bucket 0 is <1us, bucket 1 is <2us, bucket 2 is <4us, etc. */
+    uint bucket{0};
+    while(bucket < NumBuckets-1 && usec >= (1ll<<bucket))
+        ++bucket;
+    mCounts[stage][bucket].fetch_add(1u, std::memory_order_relaxed);
+}
+
+
+BackendBase::~BackendBase()
+{
+    static constexpr std::array<const char*,BackendTiming::StageCount> names{{"Jitter",
+        "Dispatch", "Render", "Commit"}};
+
+    /* Log an approximate summary of the timing, as the upper bound of the
+     * buckets holding the median, 99th percentile, and maximum.
+     */
+    for(uint stage{0};stage < BackendTiming::StageCount;++stage)
+    {
+        std::array<uint,BackendTiming::NumBuckets> counts{};
+        std::transform(mTiming.mCounts[stage].cbegin(), mTiming.mCounts[stage].cend(),
+            counts.begin(), [](const std::atomic<uint> &count) noexcept -> uint
+            { return count.load(std::memory_order_relaxed); });
+        const auto total = std::accumulate(counts.cbegin(), counts.cend(), 0ull);
+        if(total == 0) continue;
+
+        auto bucket_for = [&counts](unsigned long long target) noexcept -> uint
+        {
+            auto sum = 0ull;
+            for(uint i{0};i < counts.size();++i)
+            {
+                sum += counts[i];
+                if(sum >= target) return i;
+            }
+            return static_cast<uint>(counts.size()-1);
+        };
+        const auto max_bucket = static_cast<uint>(std::distance(std::find_if(counts.crbegin(),
+            counts.crend(), [](uint count) noexcept { return count != 0; }), counts.crend()) - 1);
+        TRACE("%s timing (%llu updates): median <%lluus, 99%% <%lluus, max <%lluus\n",
+            names[stage], total, 1ull<<bucket_for((total+1)/2),
+            1ull<<bucket_for((total*99 + 99)/100), 1ull<<max_bucket);
+    }
+}
+
 bool BackendBase::reset()
 { throw al::backend_exception{al::backend_error::DeviceError, "Invalid BackendBase call"}; }
 
@@ -35,16 +85,19 @@ void BackendBase::captureSamples(std::byte*, uint)
 uint BackendBase::availableSamples()
 { return 0; }
 
+RingBuffer *BackendBase::getCaptureRing()
+{ return nullptr; }
+
 ClockLatency BackendBase::getClockLatency()
 {
     ClockLatency ret{};
 
     uint refcount;
     do {
-        refcount = mDevice->waitForMix();
+        refcount = mDevice->waitForClock();
         ret.ClockTime = mDevice->getClockTime();
         std::atomic_thread_fence(std::memory_order_acquire);
-    } while(refcount != mDevice->mMixCount.load(std::memory_order_relaxed));
+    } while(refcount != mDevice->mClockCount.load(std::memory_order_relaxed));
 
     /* NOTE: The device will generally have about all but one periods filled at
      * any given time during playback. Without a more accurate measurement from
@@ -56,6 +109,80 @@ ClockLatency BackendBase::getClockLatency()
     return ret;
 }
 
+void BackendBase::bufferSizeChanged(uint samples) const noexcept
+{
+    TRACE("Output buffering changed to %u samples\n", samples);
+
+    /* This may be called from the mixer thread, so avoid allocating for the
+     * message.
+     */
+    std::array<char,64> msg{};
+    const int len{std::snprintf(msg.data(), msg.size(), "Output buffering changed to %u samples",
+        samples)};
+    alc::Event(alc::EventType::BufferSizeChanged, alc::DeviceType::Playback,
+        static_cast<ALCdevice*>(mDevice), std::string_view{msg.data(),
+            static_cast<size_t>(std::clamp(len, 0, static_cast<int>(msg.size())-1))});
+}
+
+void BackendBase::captureWritten(uint available) const noexcept
+{
+    mDevice->wakeCaptureWaiters();
+
+    const uint threshold{mDevice->mCaptureThreshold.load(std::memory_order_relaxed)};
+    if(threshold == 0 || available < threshold)
+        return;
+    if(!mDevice->mCaptureArmed.exchange(false, std::memory_order_acq_rel))
+        return;
+
+    std::array<char,64> msg{};
+    const int len{std::snprintf(msg.data(), msg.size(), "%u capture samples available",
+        available)};
+    alc::Event(alc::EventType::CaptureReady, alc::DeviceType::Capture,
+        static_cast<ALCdevice*>(mDevice), std::string_view{msg.data(),
+            static_cast<size_t>(std::clamp(len, 0, static_cast<int>(msg.size())-1))});
+}
+
+void BackendBase::timeWakeup() noexcept
+{
+    const auto now = std::chrono::steady_clock::now();
+    const auto interval = std::chrono::duration_cast<std::chrono::nanoseconds>(now - mWakeTime);
+    /* Anything longer than a second isn't a periodic update, and is instead
+     * the first wakeup or one after the device was stopped.
+     */
+    if(interval >= std::chrono::seconds{1})
+        mWakeInterval = {};
+    else
+    {
+        if(mWakeInterval.count() != 0)
+        {
+            const auto change = interval - mWakeInterval;
+            mTiming.add(BackendTiming::Jitter, (change.count() < 0) ? -change : change);
+        }
+        mWakeInterval = interval;
+    }
+    mWakeTime = now;
+    mDispatchPending = true;
+}
+
+void BackendBase::timeRenderStart() noexcept
+{
+    mRenderStartTime = std::chrono::steady_clock::now();
+    if(mDispatchPending)
+    {
+        mTiming.add(BackendTiming::Dispatch, mRenderStartTime - mWakeTime);
+        mDispatchPending = false;
+    }
+}
+
+void BackendBase::timeRenderEnd() noexcept
+{
+    mRenderEndTime = std::chrono::steady_clock::now();
+    mTiming.add(BackendTiming::Render, mRenderEndTime - mRenderStartTime);
+}
+
+void BackendBase::timeCommit() noexcept
+{ mTiming.add(BackendTiming::Commit, std::chrono::steady_clock::now() - mRenderEndTime); }
+
 void BackendBase::setDefaultWFXChannelOrder() const
 {
     mDevice->RealOut.ChannelIndex.fill(InvalidChannelIndex);
@@ -1,6 +1,8 @@
 #ifndef ALC_BACKENDS_BASE_H
 #define ALC_BACKENDS_BASE_H
 
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <cstdarg>
 #include <cstddef>
@@ -17,11 +19,37 @@
 
 using uint = unsigned int;
 
+struct RingBuffer;
+
 struct ClockLatency {
     std::chrono::nanoseconds ClockTime;
     std::chrono::nanoseconds Latency;
 };
 
+/* Histograms of the time spent in each stage of a backend's periodic update.
+ * Bucket 0 counts times under 1us, and each bucket after counts times up to
+ * double the previous, with the last counting everything beyond.
+ */
+struct BackendTiming {
+    enum Stage : uint {
+        /* Change in the interval between consecutive wakeups. */
+        Jitter,
+        /* From wakeup to the start of rendering. */
+        Dispatch,
+        /* Rendering a period. */
+        Render,
+        /* From the end of rendering to handing the samples to the output. */
+        Commit,
+
+        StageCount
+    };
+    static constexpr uint NumBuckets{20};
+
+    std::array<std::array<std::atomic<uint>,NumBuckets>,StageCount> mCounts{};
+
+    void add(Stage stage, std::chrono::nanoseconds duration) noexcept;
+};
+
 struct BackendBase {
     virtual void open(std::string_view name) = 0;
 
@@ -31,16 +59,24 @@ struct BackendBase {
 
     virtual void captureSamples(std::byte *buffer, uint samples);
     virtual uint availableSamples();
+    /**
+     * Returns the ring buffer holding captured samples in the device format,
+     * if the backend uses one, so they can be read in place.
+     */
+    virtual RingBuffer *getCaptureRing();
 
     virtual ClockLatency getClockLatency();
 
     DeviceBase *const mDevice;
 
+    /* Timing of the periodic updates, for backends that mark them. */
+    BackendTiming mTiming;
+
     BackendBase() = delete;
     BackendBase(const BackendBase&) = delete;
     BackendBase(BackendBase&&) = delete;
     BackendBase(DeviceBase *device) noexcept : mDevice{device} { }
-    virtual ~BackendBase() = default;
+    virtual ~BackendBase();
 
     void operator=(const BackendBase&) = delete;
     void operator=(BackendBase&&) = delete;
@@ -50,6 +86,37 @@ protected:
     void setDefaultChannelOrder() const;
     /** Sets the default channel order used by WaveFormatEx. */
     void setDefaultWFXChannelOrder() const;
+
+    /** Counts an output underrun reported by the backend. */
+    void xrunOccurred() const noexcept
+    { mDevice->mXRunCount.fetch_add(1u, std::memory_order_relaxed); }
+    /**
+     * Reports a runtime change in the amount of output buffering, in sample
+     * frames, through the event callback.
+     */
+    void bufferSizeChanged(uint samples) const noexcept;
+    /**
+     * Reports newly captured samples, with the number of sample frames now
+     * available to read, to wake waiting threads and send the capture-ready
+     * event. Called from the backend's capture thread or callback.
+     */
+    void captureWritten(uint available) const noexcept;
+
+    /* Marks the stages of a periodic update for the timing histograms. These
+     * must only be called from the mixing thread or callback. Rendering may
+     * happen multiple times between a wakeup and commit.
+     */
+    void timeWakeup() noexcept;
+    void timeRenderStart() noexcept;
+    void timeRenderEnd() noexcept;
+    void timeCommit() noexcept;
+
+private:
+    std::chrono::steady_clock::time_point mWakeTime{};
+    std::chrono::steady_clock::time_point mRenderStartTime{};
+    std::chrono::steady_clock::time_point mRenderEndTime{};
+    std::chrono::nanoseconds mWakeInterval{};
+    bool mDispatchPending{false};
 };
 using BackendPtr = std::unique_ptr<BackendBase>;
 
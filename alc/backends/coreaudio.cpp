@@ -22,6 +22,8 @@
 
 #include "coreaudio.h"
 
+#include <algorithm>
+#include <array>
 #include <cinttypes>
 #include <cmath>
 #include <memory>
@@ -34,6 +36,7 @@
 #include <vector>
 #include <optional>
 
+#include "alc/alconfig.h"
 #include "alnumeric.h"
 #include "alstring.h"
 #include "core/converter.h"
@@ -337,6 +340,8 @@ struct CoreAudioPlayback final : public BackendBase {
     AudioUnit mAudioUnit{};
 
     uint mFrameSize{0u};
+    /* Set when rendering non-interleaved float, with one buffer per channel. */
+    bool mPlanar{false};
     AudioStreamBasicDescription mFormat{}; // This is the OpenAL format as a CoreAudio ASBD
 };
 
@@ -348,8 +353,21 @@ CoreAudioPlayback::~CoreAudioPlayback()
 
 
 OSStatus CoreAudioPlayback::MixerProc(AudioUnitRenderActionFlags*, const AudioTimeStamp*, UInt32,
-    UInt32, AudioBufferList *ioData) noexcept
+    UInt32 inNumberFrames, AudioBufferList *ioData) noexcept
 {
+    if(mPlanar)
+    {
+        /* Each buffer holds one channel, so the mix can be written to them
+         * directly.
+         */
+        std::array<float*,MaxOutputChannels> chanptrs{};
+        const size_t numchans{std::min<size_t>(ioData->mNumberBuffers, chanptrs.size())};
+        for(size_t i{0};i < numchans;++i)
+            chanptrs[i] = static_cast<float*>(ioData->mBuffers[i].mData);
+        mDevice->renderSamples(al::span{chanptrs}.first(numchans), inNumberFrames);
+        return noErr;
+    }
+
     for(size_t i{0};i < ioData->mNumberBuffers;++i)
     {
         auto &buffer = ioData->mBuffers[i];
@@ -500,11 +518,64 @@ bool CoreAudioPlayback::reset()
      */
     if(mDevice->Frequency != streamFormat.mSampleRate)
     {
+        mDevice->UpdateSize = static_cast<uint>(mDevice->UpdateSize*streamFormat.mSampleRate/
+            mDevice->Frequency + 0.5);
         mDevice->BufferSize = static_cast<uint>(mDevice->BufferSize*streamFormat.mSampleRate/
             mDevice->Frequency + 0.5);
         mDevice->Frequency = static_cast<uint>(streamFormat.mSampleRate);
     }
 
+#if CAN_ENUMERATE
+    /* The HAL's I/O buffer size determines how many samples are requested per
+     * callback. If the requested update size is smaller than the current I/O
+     * size, lower it as far as the device allows for lower latency.
+     */
+    UInt32 bufferFrames{};
+    size = sizeof(bufferFrames);
+    err = AudioUnitGetProperty(mAudioUnit, kAudioDevicePropertyBufferFrameSize,
+        kAudioUnitScope_Global, OutputElement, &bufferFrames, &size);
+    if(err == noErr && mDevice->UpdateSize < bufferFrames)
+    {
+        AudioDeviceID audioDevice{kAudioDeviceUnknown};
+        size = sizeof(audioDevice);
+        AudioUnitGetProperty(mAudioUnit, kAudioOutputUnitProperty_CurrentDevice,
+            kAudioUnitScope_Global, OutputElement, &audioDevice, &size);
+
+        AudioValueRange range{};
+        range.mMinimum = range.mMaximum = bufferFrames;
+        if(audioDevice != kAudioDeviceUnknown)
+        {
+            err = GetDevProperty(audioDevice, kAudioDevicePropertyBufferFrameSizeRange, false, 0,
+                sizeof(range), &range);
+            if(err != noErr)
+                ERR("Failed to get buffer frame size range: '%s' (%u)\n",
+                    FourCCPrinter{err}.c_str(), err);
+        }
+
+        const auto newFrames = static_cast<UInt32>(std::clamp(double{mDevice->UpdateSize},
+            range.mMinimum, range.mMaximum));
+        if(newFrames < bufferFrames)
+        {
+            err = AudioUnitSetProperty(mAudioUnit, kAudioDevicePropertyBufferFrameSize,
+                kAudioUnitScope_Global, OutputElement, &newFrames, sizeof(newFrames));
+            if(err != noErr)
+                ERR("AudioUnitSetProperty(BufferFrameSize) failed: '%s' (%u)\n",
+                    FourCCPrinter{err}.c_str(), err);
+            else
+            {
+                TRACE("Lowered I/O buffer size from %u to %u samples\n", bufferFrames,
+                    newFrames);
+                bufferFrames = newFrames;
+            }
+        }
+    }
+    if(bufferFrames > 0)
+    {
+        mDevice->UpdateSize = bufferFrames;
+        mDevice->BufferSize = std::max(mDevice->BufferSize, mDevice->UpdateSize*2u);
+    }
+#endif
+
     /* FIXME: How to tell what channels are what in the output device, and how
      * to specify what we're giving? e.g. 6.0 vs 5.1
      */
@@ -544,13 +615,39 @@ bool CoreAudioPlayback::reset()
     streamFormat.mBytesPerFrame = streamFormat.mChannelsPerFrame*streamFormat.mBitsPerChannel/8;
     streamFormat.mBytesPerPacket = streamFormat.mBytesPerFrame*streamFormat.mFramesPerPacket;
 
-    err = AudioUnitSetProperty(mAudioUnit, kAudioUnitProperty_StreamFormat, kAudioUnitScope_Input,
-        OutputElement, &streamFormat, sizeof(streamFormat));
-    if(err != noErr)
+    /* Float output can be given non-interleaved, with a separate buffer for
+     * each channel the mixer can write to directly.
+     */
+    mPlanar = false;
+    if(mDevice->FmtType == DevFmtFloat
+        && GetConfigValueBool(mDevice->DeviceName, "coreaudio", "noninterleaved", true))
     {
-        ERR("AudioUnitSetProperty(StreamFormat) failed: '%s' (%u)\n", FourCCPrinter{err}.c_str(),
-            err);
-        return false;
+        AudioStreamBasicDescription planarFormat{streamFormat};
+        planarFormat.mFormatFlags |= kAudioFormatFlagIsNonInterleaved;
+        /* For non-interleaved formats, the frame and packet sizes are for a
+         * single channel.
+         */
+        planarFormat.mBytesPerFrame = planarFormat.mBitsPerChannel/8;
+        planarFormat.mBytesPerPacket = planarFormat.mBytesPerFrame*planarFormat.mFramesPerPacket;
+
+        err = AudioUnitSetProperty(mAudioUnit, kAudioUnitProperty_StreamFormat,
+            kAudioUnitScope_Input, OutputElement, &planarFormat, sizeof(planarFormat));
+        if(err == noErr)
+            mPlanar = true;
+        else
+            WARN("Failed to set non-interleaved format: '%s' (%u)\n", FourCCPrinter{err}.c_str(),
+                err);
+    }
+    if(!mPlanar)
+    {
+        err = AudioUnitSetProperty(mAudioUnit, kAudioUnitProperty_StreamFormat,
+            kAudioUnitScope_Input, OutputElement, &streamFormat, sizeof(streamFormat));
+        if(err != noErr)
+        {
+            ERR("AudioUnitSetProperty(StreamFormat) failed: '%s' (%u)\n",
+                FourCCPrinter{err}.c_str(), err);
+            return false;
+        }
     }
 
     setDefaultWFXChannelOrder();
@@ -618,6 +715,8 @@ struct CoreAudioCapture final : public BackendBase {
     AudioStreamBasicDescription mFormat{};  // This is the OpenAL format as a CoreAudio ASBD
 
     SampleConverterPtr mConverter;
+    /* Converts ring buffer frames to OpenAL frames, when using the converter. */
+    double mConverterScale{1.0};
 
     std::vector<char> mCaptureData;
 
@@ -655,6 +754,7 @@ OSStatus CoreAudioCapture::RecordProc(AudioUnitRenderActionFlags *ioActionFlags,
     }
 
     std::ignore = mRing->write(mCaptureData.data(), inNumberFrames);
+    captureWritten(static_cast<uint>(static_cast<double>(mRing->readSpace()) * mConverterScale));
     return noErr;
 }
 
@@ -879,9 +979,12 @@ void CoreAudioCapture::open(std::string_view name)
 
     /* Set up sample converter if needed */
     if(outputFormat.mSampleRate != mDevice->Frequency)
+    {
         mConverter = SampleConverter::Create(mDevice->FmtType, mDevice->FmtType,
             mFormat.mChannelsPerFrame, static_cast<uint>(hardwareFormat.mSampleRate),
             mDevice->Frequency, Resampler::FastBSinc24);
+        mConverterScale = mDevice->Frequency / hardwareFormat.mSampleRate;
+    }
 
 #if CAN_ENUMERATE
     if(!name.empty())
@@ -1010,15 +1113,22 @@ BackendPtr CoreAudioBackendFactory::createBackend(DeviceBase *device, BackendTyp
     return nullptr;
 }
 
-alc::EventSupport CoreAudioBackendFactory::queryEventSupport(alc::EventType eventType, BackendType)
+alc::EventSupport CoreAudioBackendFactory::queryEventSupport(alc::EventType eventType, BackendType type)
 {
     switch(eventType)
     {
     case alc::EventType::DefaultDeviceChanged:
         return alc::EventSupport::FullSupport;
 
+    case alc::EventType::CaptureReady:
+        if(type == BackendType::Capture)
+            return alc::EventSupport::FullSupport;
+        break;
+
     case alc::EventType::DeviceAdded:
     case alc::EventType::DeviceRemoved:
+    case alc::EventType::HrtfReady:
+    case alc::EventType::BufferSizeChanged:
     case alc::EventType::Count:
         break;
     }
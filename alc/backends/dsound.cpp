@@ -551,6 +551,7 @@ struct DSoundCapture final : public BackendBase {
     void stop() override;
     void captureSamples(std::byte *buffer, uint samples) override;
     uint availableSamples() override;
+    RingBuffer *getCaptureRing() override { return mRing.get(); }
 
     ComPtr<IDirectSoundCapture> mDSC;
     ComPtr<IDirectSoundCaptureBuffer> mDSCbuffer;
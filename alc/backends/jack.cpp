@@ -23,6 +23,7 @@
 #include "jack.h"
 
 #include <array>
+#include <chrono>
 #include <cstdlib>
 #include <cstdio>
 #include <cstring>
@@ -305,6 +306,12 @@ struct JackPlayback final : public BackendBase {
 
     std::atomic<bool> mPlaying{false};
     bool mRTMixing{false};
+    /* Set while mixing in the process callback. Cleared if the mix takes too
+     * much of the period, handing rendering off to the mixer thread.
+     */
+    std::atomic<bool> mRTActive{false};
+    bool mRTFallback{false};
+    float mRTLoad{0.0f};
     RingBufferPtr mRing;
     al::semaphore mSem;
 
@@ -329,6 +336,14 @@ JackPlayback::~JackPlayback()
 
 int JackPlayback::processRt(jack_nframes_t numframes) noexcept
 {
+    /* Fraction of the period the average render time may use before falling
+     * back to the mixer thread.
+     */
+    static constexpr float RTMixBudget{0.8f};
+
+    if(!mRTActive.load(std::memory_order_acquire)) UNLIKELY
+        return process(numframes);
+
     auto outptrs = std::array<jack_default_audio_sample_t*,MaxOutputChannels>{};
     auto numchans = size_t{0};
     for(auto port : mPort)
@@ -340,7 +355,24 @@ int JackPlayback::processRt(jack_nframes_t numframes) noexcept
 
     const auto dst = al::span{outptrs}.first(numchans);
     if(mPlaying.load(std::memory_order_acquire)) LIKELY
+    {
+        const auto mixStart = std::chrono::steady_clock::now();
         mDevice->renderSamples(dst, static_cast<uint>(numframes));
+        if(mRTFallback)
+        {
+            const auto mixtime = std::chrono::steady_clock::now() - mixStart;
+            const auto duration = std::chrono::nanoseconds{std::chrono::seconds{numframes}}
+                / mDevice->Frequency;
+            const float load{static_cast<float>(mixtime.count())
+                / static_cast<float>(duration.count())};
+            mRTLoad = lerpf(mRTLoad, load, 0.1f);
+            if(mRTLoad > RTMixBudget) UNLIKELY
+            {
+                mRTActive.store(false, std::memory_order_release);
+                mSem.post();
+            }
+        }
+    }
     else
     {
         std::for_each(dst.begin(), dst.end(), [numframes](float *outbuf) -> void
@@ -418,6 +450,17 @@ int JackPlayback::mixerProc()
     const auto num_channels = size_t{mDevice->channelsFromFmt()};
     auto outptrs = std::vector<float*>(num_channels);
 
+    /* When mixing in the process callback, wait until it falls behind. */
+    while(mRTActive.load(std::memory_order_acquire))
+    {
+        if(mKillNow.load(std::memory_order_acquire))
+            return 0;
+        mSem.wait();
+    }
+    if(mRTMixing)
+        WARN("Mixing load of %.0f%% exceeds the JACK period budget, using the mixer thread\n",
+            mRTLoad*100.0f);
+
     while(!mKillNow.load(std::memory_order_acquire)
         && mDevice->Connected.load(std::memory_order_acquire))
     {
@@ -519,6 +562,8 @@ bool JackPlayback::reset()
     mPort.fill(nullptr);
 
     mRTMixing = GetConfigValueBool(mDevice->DeviceName, "jack", "rt-mix", true);
+    mRTFallback = mRTMixing
+        && GetConfigValueBool(mDevice->DeviceName, "jack", "rt-mix-fallback", true);
     jack_set_process_callback(mClient,
         mRTMixing ? &JackPlayback::processRtC : &JackPlayback::processC, this);
 
@@ -619,15 +664,21 @@ void JackPlayback::start()
     mDevice->BufferSize = mDevice->UpdateSize * 2;
 
     mRing = nullptr;
-    if(mRTMixing)
+    mRTActive.store(mRTMixing, std::memory_order_relaxed);
+    mRTLoad = 0.0f;
+    if(mRTMixing && !mRTFallback)
         mPlaying.store(true, std::memory_order_release);
     else
     {
+        /* With the real-time fallback, the ring buffer and mixer thread are
+         * set up but left idle until mixing in the callback falls behind.
+         */
         uint bufsize{ConfigValueUInt(devname, "jack", "buffer-size").value_or(mDevice->UpdateSize)};
         bufsize = std::max(NextPowerOf2(bufsize), mDevice->UpdateSize);
-        mDevice->BufferSize = bufsize + mDevice->UpdateSize;
+        if(!mRTMixing)
+            mDevice->BufferSize = bufsize + mDevice->UpdateSize;
 
-        mRing = RingBuffer::Create(bufsize, mDevice->frameSizeFromFmt(), true);
+        mRing = RingBuffer::Create(bufsize, mDevice->frameSizeFromFmt(), true, true);
 
         try {
             mPlaying.store(true, std::memory_order_release);
@@ -665,7 +716,8 @@ ClockLatency JackPlayback::getClockLatency()
     std::lock_guard<std::mutex> dlock{mMutex};
     ClockLatency ret{};
     ret.ClockTime = mDevice->getClockTime();
-    ret.Latency  = std::chrono::seconds{mRing ? mRing->readSpace() : mDevice->UpdateSize};
+    ret.Latency  = std::chrono::seconds{(mRing && !mRTActive.load(std::memory_order_acquire))
+        ? mRing->readSpace() : mDevice->UpdateSize};
     ret.Latency /= mDevice->Frequency;
 
     return ret;
@@ -23,18 +23,22 @@
 #include "null.h"
 
 #include <exception>
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <functional>
 #include <thread>
+#include <vector>
 
+#include "alc/alconfig.h"
 #include "almalloc.h"
 #include "alstring.h"
 #include "althrd_setname.h"
 #include "core/device.h"
 #include "core/helpers.h"
+#include "core/logging.h"
 
 
 namespace {
@@ -51,12 +55,16 @@ struct NullBackend final : public BackendBase {
     NullBackend(DeviceBase *device) noexcept : BackendBase{device} { }
 
     int mixerProc();
+    int benchmarkProc();
 
     void open(std::string_view name) override;
     bool reset() override;
     void start() override;
     void stop() override;
 
+    /* The render time of each update in benchmark mode. */
+    std::vector<nanoseconds> mUpdateTimes;
+
     std::atomic<bool> mKillNow{true};
     std::thread mThread;
 };
@@ -82,11 +90,15 @@ int NullBackend::mixerProc()
             std::this_thread::sleep_for(restTime);
             continue;
         }
+        timeWakeup();
         while(avail-done >= mDevice->UpdateSize)
         {
+            timeRenderStart();
             mDevice->renderSamples(nullptr, mDevice->UpdateSize, 0u);
+            timeRenderEnd();
             done += mDevice->UpdateSize;
         }
+        timeCommit();
 
         /* For every completed second, increment the start time and reduce the
          * samples done. This prevents the difference between the start time
@@ -104,6 +116,49 @@ int NullBackend::mixerProc()
     return 0;
 }
 
+/* Renders the configured number of updates back-to-back, without pacing to
+ * real time, timing each one. The timing statistics are logged once done, and
+ * the device is disconnected so the app can tell the run is finished.
+ */
+int NullBackend::benchmarkProc()
+{
+    SetRTPriority();
+    althrd_setname(GetMixerThreadName());
+
+    const size_t total{mUpdateTimes.size()};
+    size_t done{0};
+    while(done < total && !mKillNow.load(std::memory_order_acquire)
+        && mDevice->Connected.load(std::memory_order_acquire))
+    {
+        const auto start = std::chrono::steady_clock::now();
+        mDevice->renderSamples(nullptr, mDevice->UpdateSize, 0u);
+        mUpdateTimes[done++] = std::chrono::steady_clock::now() - start;
+    }
+    if(done == 0)
+        return 0;
+
+    const auto times = al::span{mUpdateTimes}.first(done);
+    std::sort(times.begin(), times.end());
+    const auto nth = [times](size_t pct) noexcept -> long long
+    { return static_cast<long long>(times[(times.size()-1) * pct / 100].count()); };
+
+    nanoseconds sum{};
+    for(const nanoseconds t : times)
+        sum += t;
+    const nanoseconds duration{nanoseconds{seconds{mDevice->UpdateSize}} / mDevice->Frequency};
+
+    TRACE("Benchmarked %zu updates of %u samples (%lldns each):\n"
+        "  min: %lldns, median: %lldns, p99: %lldns, max: %lldns, average load: %.2f%%\n",
+        done, mDevice->UpdateSize, static_cast<long long>(duration.count()),
+        static_cast<long long>(times.front().count()), nth(50), nth(99),
+        static_cast<long long>(times.back().count()),
+        static_cast<double>(sum.count()) / static_cast<double>(duration.count()*done) * 100.0);
+
+    if(done == total)
+        mDevice->handleDisconnect("Finished benchmarking %zu updates", done);
+    return 0;
+}
+
 
 void NullBackend::open(std::string_view name)
 {
@@ -125,8 +180,14 @@ bool NullBackend::reset()
 void NullBackend::start()
 {
     try {
+        const uint numupdates{ConfigValueUInt({}, "null", "benchmark").value_or(0u)};
+        mUpdateTimes.resize(numupdates);
+
         mKillNow.store(false, std::memory_order_release);
-        mThread = std::thread{std::mem_fn(&NullBackend::mixerProc), this};
+        if(numupdates > 0)
+            mThread = std::thread{std::mem_fn(&NullBackend::benchmarkProc), this};
+        else
+            mThread = std::thread{std::mem_fn(&NullBackend::mixerProc), this};
     }
     catch(std::exception& e) {
         throw al::backend_exception{al::backend_error::DeviceError,
@@ -3,10 +3,14 @@
 
 #include "oboe.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
 
+#include "alc/alconfig.h"
 #include "alnumeric.h"
 #include "alstring.h"
 #include "core/device.h"
@@ -37,6 +41,7 @@ struct OboePlayback final : public BackendBase, public oboe::AudioStreamCallback
     bool reset() override;
     void start() override;
     void stop() override;
+    ClockLatency getClockLatency() override;
 };
 
 
@@ -84,6 +89,12 @@ bool OboePlayback::reset()
     builder.setDirection(oboe::Direction::Output);
     builder.setPerformanceMode(oboe::PerformanceMode::LowLatency);
     builder.setUsage(oboe::Usage::Game);
+    /* An exclusive stream can use AAudio's MMAP path, writing directly into
+     * the device's buffer for the lowest latency. AAudio falls back to a
+     * shared stream when exclusive access isn't available.
+     */
+    if(GetConfigValueBool(mDevice->DeviceName, "oboe", "exclusive", true))
+        builder.setSharingMode(oboe::SharingMode::Exclusive);
     /* Don't let Oboe convert. We should be able to handle anything it gives
      * back.
      */
@@ -129,6 +140,13 @@ bool OboePlayback::reset()
         }
         builder.setFormat(format);
     }
+    else
+    {
+        /* Prefer float output, which the mixer can write without conversion.
+         * This falls back to the stream's default if unsupported.
+         */
+        builder.setFormat(oboe::AudioFormat::Float);
+    }
 
     oboe::Result result{builder.openManagedStream(mStream)};
     /* If the format failed, try asking for the defaults. */
@@ -147,8 +165,19 @@ bool OboePlayback::reset()
     if(result != oboe::Result::OK)
         throw al::backend_exception{al::backend_error::DeviceError, "Failed to create stream: %s",
             oboe::convertToText(result)};
-    mStream->setBufferSizeInFrames(std::min(static_cast<int32_t>(mDevice->BufferSize),
-        mStream->getBufferCapacityInFrames()));
+    /* Size the buffer to a whole number of bursts, the unit the device reads
+     * in, with at least two to avoid underruns.
+     */
+    if(const int32_t burst{mStream->getFramesPerBurst()}; burst > 0)
+    {
+        const auto bursts = std::max((static_cast<int32_t>(mDevice->BufferSize)+burst-1) / burst,
+            2);
+        mStream->setBufferSizeInFrames(std::min(bursts*burst,
+            mStream->getBufferCapacityInFrames()));
+    }
+    else
+        mStream->setBufferSizeInFrames(std::min(static_cast<int32_t>(mDevice->BufferSize),
+            mStream->getBufferCapacityInFrames()));
     TRACE("Got stream with properties:\n%s", oboe::convertToText(mStream.get()));
 
     if(static_cast<uint>(mStream->getChannelCount()) != mDevice->channelsFromFmt())
@@ -215,6 +244,33 @@ void OboePlayback::stop()
         ERR("Failed to stop stream: %s\n", oboe::convertToText(result));
 }
 
+ClockLatency OboePlayback::getClockLatency()
+{
+    ClockLatency ret{};
+
+    uint refcount;
+    do {
+        refcount = mDevice->waitForClock();
+        ret.ClockTime = mDevice->getClockTime();
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while(refcount != mDevice->mClockCount.load(std::memory_order_relaxed));
+
+    /* The stream can calculate the latency from its timestamps, which is the
+     * time until the most recently written sample is heard. If that fails,
+     * estimate from the amount of buffered audio.
+     */
+    if(auto latency = mStream->calculateLatencyMillis())
+        ret.Latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::duration<double,std::milli>{latency.value()});
+    else
+    {
+        ret.Latency = std::chrono::seconds{mStream->getBufferSizeInFrames()};
+        ret.Latency /= mDevice->Frequency;
+    }
+
+    return ret;
+}
+
 
 struct OboeCapture final : public BackendBase, public oboe::AudioStreamCallback {
     OboeCapture(DeviceBase *device) : BackendBase{device} { }
@@ -231,12 +287,14 @@ struct OboeCapture final : public BackendBase, public oboe::AudioStreamCallback
     void stop() override;
     void captureSamples(std::byte *buffer, uint samples) override;
     uint availableSamples() override;
+    RingBuffer *getCaptureRing() override { return mRing.get(); }
 };
 
 oboe::DataCallbackResult OboeCapture::onAudioReady(oboe::AudioStream*, void *audioData,
     int32_t numFrames)
 {
     std::ignore = mRing->write(audioData, static_cast<uint32_t>(numFrames));
+    captureWritten(static_cast<uint>(mRing->readSpace()));
     return oboe::DataCallbackResult::Continue;
 }
 
@@ -346,6 +404,26 @@ bool OboeBackendFactory::init() { return true; }
 bool OboeBackendFactory::querySupport(BackendType type)
 { return type == BackendType::Playback || type == BackendType::Capture; }
 
+alc::EventSupport OboeBackendFactory::queryEventSupport(alc::EventType eventType, BackendType type)
+{
+    switch(eventType)
+    {
+    case alc::EventType::CaptureReady:
+        if(type == BackendType::Capture)
+            return alc::EventSupport::FullSupport;
+        break;
+
+    case alc::EventType::DefaultDeviceChanged:
+    case alc::EventType::DeviceAdded:
+    case alc::EventType::DeviceRemoved:
+    case alc::EventType::HrtfReady:
+    case alc::EventType::BufferSizeChanged:
+    case alc::EventType::Count:
+        break;
+    }
+    return alc::EventSupport::NoSupport;
+}
+
 auto OboeBackendFactory::enumerate(BackendType type) -> std::vector<std::string>
 {
     switch(type)
@@ -615,6 +615,10 @@ void OpenSLCapture::process(SLAndroidSimpleBufferQueueItf) noexcept
 {
     /* A new chunk has been written into the ring buffer, advance it. */
     mRing->writeAdvance(1);
+    /* The app thread owns the read offset into the first chunk, so count
+     * only the chunks after it.
+     */
+    captureWritten(static_cast<uint>((mRing->readSpace()-1) * mDevice->UpdateSize));
 }
 
 
@@ -909,6 +913,26 @@ bool OSLBackendFactory::init() { return true; }
 bool OSLBackendFactory::querySupport(BackendType type)
 { return (type == BackendType::Playback || type == BackendType::Capture); }
 
+alc::EventSupport OSLBackendFactory::queryEventSupport(alc::EventType eventType, BackendType type)
+{
+    switch(eventType)
+    {
+    case alc::EventType::CaptureReady:
+        if(type == BackendType::Capture)
+            return alc::EventSupport::FullSupport;
+        break;
+
+    case alc::EventType::DefaultDeviceChanged:
+    case alc::EventType::DeviceAdded:
+    case alc::EventType::DeviceRemoved:
+    case alc::EventType::HrtfReady:
+    case alc::EventType::BufferSizeChanged:
+    case alc::EventType::Count:
+        break;
+    }
+    return alc::EventSupport::NoSupport;
+}
+
 auto OSLBackendFactory::enumerate(BackendType type) -> std::vector<std::string>
 {
     switch(type)
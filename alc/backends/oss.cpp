@@ -312,9 +312,12 @@ int OSSPlayback::mixerProc()
             continue;
         }
 
+        timeWakeup();
         al::span write_buf{mMixData};
+        timeRenderStart();
         mDevice->renderSamples(write_buf.data(), static_cast<uint>(write_buf.size()/frame_size),
             frame_step);
+        timeRenderEnd();
         while(!write_buf.empty() && !mKillNow.load(std::memory_order_acquire))
         {
             ssize_t wrote{write(mFd, write_buf.data(), write_buf.size())};
@@ -330,6 +333,7 @@ int OSSPlayback::mixerProc()
 
             write_buf = write_buf.subspan(static_cast<size_t>(wrote));
         }
+        timeCommit();
     }
 
     return 0;
@@ -473,6 +477,7 @@ struct OSScapture final : public BackendBase {
     void stop() override;
     void captureSamples(std::byte *buffer, uint samples) override;
     uint availableSamples() override;
+    RingBuffer *getCaptureRing() override { return mRing.get(); }
 
     int mFd{-1};
 
@@ -529,6 +534,7 @@ int OSScapture::recordProc()
                 break;
             }
             mRing->writeAdvance(static_cast<size_t>(amt)/frame_size);
+            captureWritten(static_cast<uint>(mRing->readSpace()));
         }
     }
 
@@ -613,7 +619,7 @@ void OSScapture::open(std::string_view name)
             "Failed to set %s samples, got OSS format %#x", DevFmtTypeString(mDevice->FmtType),
             ossFormat};
 
-    mRing = RingBuffer::Create(mDevice->BufferSize, frameSize, false);
+    mRing = RingBuffer::Create(mDevice->BufferSize, frameSize, false, true);
 
     mDevice->DeviceName = name;
 }
@@ -668,6 +674,26 @@ bool OSSBackendFactory::init()
 bool OSSBackendFactory::querySupport(BackendType type)
 { return (type == BackendType::Playback || type == BackendType::Capture); }
 
+alc::EventSupport OSSBackendFactory::queryEventSupport(alc::EventType eventType, BackendType type)
+{
+    switch(eventType)
+    {
+    case alc::EventType::CaptureReady:
+        if(type == BackendType::Capture)
+            return alc::EventSupport::FullSupport;
+        break;
+
+    case alc::EventType::DefaultDeviceChanged:
+    case alc::EventType::DeviceAdded:
+    case alc::EventType::DeviceRemoved:
+    case alc::EventType::HrtfReady:
+    case alc::EventType::BufferSizeChanged:
+    case alc::EventType::Count:
+        break;
+    }
+    return alc::EventSupport::NoSupport;
+}
+
 auto OSSBackendFactory::enumerate(BackendType type) -> std::vector<std::string>
 {
     std::vector<std::string> outnames;
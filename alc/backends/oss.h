@@ -8,6 +8,7 @@ public:
     auto init() -> bool final;
 
     auto querySupport(BackendType type) -> bool final;
+    auto queryEventSupport(alc::EventType eventType, BackendType type) -> alc::EventSupport final;
 
     auto enumerate(BackendType type) -> std::vector<std::string> final;
 
@@ -1475,6 +1475,7 @@ void PipeWirePlayback::ioChangedCallback(uint32_t id, void *area, uint32_t size)
 
 void PipeWirePlayback::outputCallback() noexcept
 {
+    timeWakeup();
     pw_buffer *pw_buf{pw_stream_dequeue_buffer(mStream.get())};
     if(!pw_buf) UNLIKELY return;
 
@@ -1497,24 +1498,37 @@ void PipeWirePlayback::outputCallback() noexcept
     /* For planar formats, each datas[] seems to contain one channel, so store
      * the pointers in an array. Limit the render length in case the available
      * buffer length in any one channel is smaller than we wanted (shouldn't
-     * be, but just in case).
+     * be, but just in case). The mix is rendered directly into these buffers,
+     * for however many channels were provided.
      */
     auto chanptr_end = mChannelPtrs.begin();
     for(const auto &data : datas)
     {
+        if(!data.data) UNLIKELY break;
         length = std::min(length, data.maxsize/uint{sizeof(float)});
         *chanptr_end = static_cast<float*>(data.data);
         ++chanptr_end;
+    }
+    const auto numchans = static_cast<size_t>(std::distance(mChannelPtrs.begin(), chanptr_end));
 
+    /* Set the chunk sizes once the final length is known. */
+    for(const auto &data : datas.first(numchans))
+    {
         data.chunk->offset = 0;
         data.chunk->stride = sizeof(float);
         data.chunk->size   = length * sizeof(float);
     }
 
-    mDevice->renderSamples(mChannelPtrs, length);
+    if(numchans > 0 && length > 0) LIKELY
+    {
+        timeRenderStart();
+        mDevice->renderSamples(al::span{mChannelPtrs}.first(numchans), length);
+        timeRenderEnd();
+    }
 
     pw_buf->size = length;
     pw_stream_queue_buffer(mStream.get(), pw_buf);
+    timeCommit();
 }
 
 
@@ -1846,11 +1860,11 @@ ClockLatency PipeWirePlayback::getClockLatency()
     timespec tspec{};
     uint refcount;
     do {
-        refcount = mDevice->waitForMix();
+        refcount = mDevice->waitForClock();
         mixtime = mDevice->getClockTime();
         clock_gettime(CLOCK_MONOTONIC, &tspec);
         std::atomic_thread_fence(std::memory_order_acquire);
-    } while(refcount != mDevice->mMixCount.load(std::memory_order_relaxed));
+    } while(refcount != mDevice->mClockCount.load(std::memory_order_relaxed));
 
     /* Convert the monotonic clock, stream ticks, and stream delay to
      * nanoseconds.
@@ -1916,6 +1930,7 @@ class PipeWireCapture final : public BackendBase {
     void stop() override;
     void captureSamples(std::byte *buffer, uint samples) override;
     uint availableSamples() override;
+    RingBuffer *getCaptureRing() override { return mRing.get(); }
 
     uint64_t mTargetId{PwIdAny};
     ThreadMainloop mLoop;
@@ -1957,6 +1972,7 @@ void PipeWireCapture::inputCallback() noexcept
         .subspan(offset, std::min(bufdata->chunk->size, bufdata->maxsize - offset));
 
     std::ignore = mRing->write(input.data(), input.size() / mRing->getElemSize());
+    captureWritten(static_cast<uint>(mRing->readSpace()));
 
     pw_stream_queue_buffer(mStream.get(), pw_buf);
 }
@@ -2298,7 +2314,7 @@ BackendFactory &PipeWireBackendFactory::getFactory()
     return factory;
 }
 
-alc::EventSupport PipeWireBackendFactory::queryEventSupport(alc::EventType eventType, BackendType)
+alc::EventSupport PipeWireBackendFactory::queryEventSupport(alc::EventType eventType, BackendType type)
 {
     switch(eventType)
     {
@@ -2307,6 +2323,13 @@ alc::EventSupport PipeWireBackendFactory::queryEventSupport(alc::EventType event
     case alc::EventType::DeviceRemoved:
         return alc::EventSupport::FullSupport;
 
+    case alc::EventType::CaptureReady:
+        if(type == BackendType::Capture)
+            return alc::EventSupport::FullSupport;
+        break;
+
+    case alc::EventType::HrtfReady:
+    case alc::EventType::BufferSizeChanged:
     case alc::EventType::Count:
         break;
     }
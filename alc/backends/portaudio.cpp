@@ -291,6 +291,7 @@ struct PortCapture final : public BackendBase {
     void stop() override;
     void captureSamples(std::byte *buffer, uint samples) override;
     uint availableSamples() override;
+    RingBuffer *getCaptureRing() override { return mRing.get(); }
 
     PaStream *mStream{nullptr};
     PaStreamParameters mParams{};
@@ -311,6 +312,7 @@ int PortCapture::readCallback(const void *inputBuffer, void*, unsigned long fram
     const PaStreamCallbackTimeInfo*, const PaStreamCallbackFlags) const noexcept
 {
     std::ignore = mRing->write(inputBuffer, framesPerBuffer);
+    captureWritten(static_cast<uint>(mRing->readSpace()));
     return 0;
 }
 
@@ -477,6 +479,26 @@ bool PortBackendFactory::init()
 bool PortBackendFactory::querySupport(BackendType type)
 { return (type == BackendType::Playback || type == BackendType::Capture); }
 
+alc::EventSupport PortBackendFactory::queryEventSupport(alc::EventType eventType, BackendType type)
+{
+    switch(eventType)
+    {
+    case alc::EventType::CaptureReady:
+        if(type == BackendType::Capture)
+            return alc::EventSupport::FullSupport;
+        break;
+
+    case alc::EventType::DefaultDeviceChanged:
+    case alc::EventType::DeviceAdded:
+    case alc::EventType::DeviceRemoved:
+    case alc::EventType::HrtfReady:
+    case alc::EventType::BufferSizeChanged:
+    case alc::EventType::Count:
+        break;
+    }
+    return alc::EventSupport::NoSupport;
+}
+
 auto PortBackendFactory::enumerate(BackendType type) -> std::vector<std::string>
 {
     std::vector<std::string> devices;
@@ -28,6 +28,7 @@
 #include <atomic>
 #include <bitset>
 #include <chrono>
+#include <cinttypes>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
@@ -91,6 +92,7 @@ using uint = unsigned int;
     MAGIC(pa_stream_is_suspended);                                            \
     MAGIC(pa_stream_get_device_name);                                         \
     MAGIC(pa_stream_get_latency);                                             \
+    MAGIC(pa_stream_get_timing_info);                                         \
     MAGIC(pa_stream_set_write_callback);                                      \
     MAGIC(pa_stream_set_buffer_attr);                                         \
     MAGIC(pa_stream_get_buffer_attr);                                         \
@@ -100,6 +102,7 @@ using uint = unsigned int;
     MAGIC(pa_stream_set_state_callback);                                      \
     MAGIC(pa_stream_set_moved_callback);                                      \
     MAGIC(pa_stream_set_underflow_callback);                                  \
+    MAGIC(pa_stream_set_latency_update_callback);                             \
     MAGIC(pa_stream_new_with_proplist);                                       \
     MAGIC(pa_stream_disconnect);                                              \
     MAGIC(pa_stream_set_buffer_attr_callback);                                \
@@ -162,6 +165,7 @@ PULSE_FUNCS(MAKE_FUNC)
 #define pa_stream_set_state_callback ppa_stream_set_state_callback
 #define pa_stream_set_moved_callback ppa_stream_set_moved_callback
 #define pa_stream_set_underflow_callback ppa_stream_set_underflow_callback
+#define pa_stream_set_latency_update_callback ppa_stream_set_latency_update_callback
 #define pa_stream_connect_record ppa_stream_connect_record
 #define pa_stream_connect_playback ppa_stream_connect_playback
 #define pa_stream_readable_size ppa_stream_readable_size
@@ -171,6 +175,7 @@ PULSE_FUNCS(MAKE_FUNC)
 #define pa_stream_is_suspended ppa_stream_is_suspended
 #define pa_stream_get_device_name ppa_stream_get_device_name
 #define pa_stream_get_latency ppa_stream_get_latency
+#define pa_stream_get_timing_info ppa_stream_get_timing_info
 #define pa_stream_set_buffer_attr_callback ppa_stream_set_buffer_attr_callback
 #define pa_stream_begin_write ppa_stream_begin_write
 #define pa_threaded_mainloop_free ppa_threaded_mainloop_free
@@ -435,7 +440,7 @@ struct MainloopUniqueLock : public std::unique_lock<PulseMainloop> {
     void setEventHandler()
     {
         pa_operation *op{pa_context_subscribe(mutex()->mContext,
-            PA_SUBSCRIPTION_MASK_SINK | PA_SUBSCRIPTION_MASK_SOURCE,
+            PA_SUBSCRIPTION_MASK_SINK | PA_SUBSCRIPTION_MASK_SOURCE | PA_SUBSCRIPTION_MASK_SERVER,
             [](pa_context*, int, void *pdata) noexcept
             { static_cast<PulseMainloop*>(pdata)->signal(); },
             mutex())};
@@ -462,6 +467,14 @@ struct MainloopUniqueLock : public std::unique_lock<PulseMainloop> {
                 else if(eventType == PA_SUBSCRIPTION_EVENT_REMOVE)
                     alc::Event(alc::EventType::DeviceRemoved, deviceType, "Device removed");
             }
+            else if(eventFacility == PA_SUBSCRIPTION_EVENT_SERVER)
+            {
+                /* A server change may be a new default sink or source, which
+                 * is listed first.
+                 */
+                alc::DeviceListChanged(alc::DeviceType::Playback);
+                alc::DeviceListChanged(alc::DeviceType::Capture);
+            }
         };
         pa_context_set_subscribe_callback(mutex()->mContext, handler, nullptr);
     }
@@ -588,6 +601,8 @@ void PulseMainloop::close(pa_stream *stream)
     pa_stream_set_moved_callback(stream, nullptr, nullptr);
     pa_stream_set_write_callback(stream, nullptr, nullptr);
     pa_stream_set_buffer_attr_callback(stream, nullptr, nullptr);
+    pa_stream_set_underflow_callback(stream, nullptr, nullptr);
+    pa_stream_set_latency_update_callback(stream, nullptr, nullptr);
     pa_stream_disconnect(stream);
     pa_stream_unref(stream);
 }
@@ -648,6 +663,9 @@ struct PulsePlayback final : public BackendBase {
     void bufferAttrCallback(pa_stream *stream) noexcept;
     void streamStateCallback(pa_stream *stream) noexcept;
     void streamWriteCallback(pa_stream *stream, size_t nbytes) noexcept;
+    void streamUnderflowCallback(pa_stream *stream) noexcept;
+    void streamLatencyCallback(pa_stream *stream) noexcept;
+    void updateBufferAttr(pa_stream *stream, const pa_buffer_attr &attr) noexcept;
     void sinkInfoCallback(pa_context *context, const pa_sink_info *info, int eol) noexcept;
     void sinkNameCallback(pa_context *context, const pa_sink_info *info, int eol) noexcept;
     void streamMovedCallback(pa_stream *stream) noexcept;
@@ -669,6 +687,19 @@ struct PulsePlayback final : public BackendBase {
     pa_stream *mStream{nullptr};
 
     uint mFrameSize{0u};
+
+    /* With adaptive buffering, underflows raise the stream's target length up
+     * to mMaxTLength.
+     */
+    bool mAdaptive{false};
+    bool mAttrPending{false};
+    uint mMaxTLength{0u};
+
+    /* When set, minreq follows the sink's measured latency, no lower than
+     * mBaseMinReq.
+     */
+    bool mAdaptMinReq{false};
+    uint mBaseMinReq{0u};
 };
 
 PulsePlayback::~PulsePlayback()
@@ -698,6 +729,7 @@ void PulsePlayback::streamStateCallback(pa_stream *stream) noexcept
 
 void PulsePlayback::streamWriteCallback(pa_stream *stream, size_t nbytes) noexcept
 {
+    timeWakeup();
     do {
         pa_free_cb_t free_func{nullptr};
         auto buflen = static_cast<size_t>(-1);
@@ -712,12 +744,85 @@ void PulsePlayback::streamWriteCallback(pa_stream *stream, size_t nbytes) noexce
             buflen = std::min(buflen, nbytes);
         nbytes -= buflen;
 
+        timeRenderStart();
         mDevice->renderSamples(buf, static_cast<uint>(buflen/mFrameSize), mSpec.channels);
+        timeRenderEnd();
 
         int ret{pa_stream_write(stream, buf, buflen, free_func, 0, PA_SEEK_RELATIVE)};
         if(ret != PA_OK) UNLIKELY
             ERR("Failed to write to stream: %d, %s\n", ret, pa_strerror(ret));
     } while(nbytes > 0);
+    timeCommit();
+}
+
+void PulsePlayback::streamUnderflowCallback(pa_stream *stream) noexcept
+{
+    xrunOccurred();
+    if(!mAdaptive || mAttrPending || mAttr.tlength >= mMaxTLength)
+        return;
+
+    pa_buffer_attr attr{mAttr};
+    attr.tlength = std::min(attr.tlength + attr.tlength/2, mMaxTLength);
+    attr.tlength -= attr.tlength%mFrameSize;
+    WARN("Underflow, raising target length to %u samples\n", attr.tlength/mFrameSize);
+    updateBufferAttr(stream, attr);
+}
+
+void PulsePlayback::streamLatencyCallback(pa_stream *stream) noexcept
+{
+    if(!mAdaptMinReq || mAttrPending)
+        return;
+
+    const pa_timing_info *info{pa_stream_get_timing_info(stream)};
+    if(!info || info->sink_usec == 0)
+        return;
+
+    /* When the sink itself buffers a lot, asking for small updates only adds
+     * wakeups without lowering the latency. Request updates of up to half the
+     * sink's latency instead, leaving at least half the target length queued.
+     */
+    const uint64_t sinkBytes{info->sink_usec * mSpec.rate / 1000000u * mFrameSize};
+    const uint maxreq{std::max(mBaseMinReq, mAttr.tlength/2)};
+    uint minreq{static_cast<uint>(std::clamp(sinkBytes/2, uint64_t{mBaseMinReq},
+        uint64_t{maxreq}))};
+    minreq -= minreq%mFrameSize;
+
+    /* Ignore small changes, so jitter in the measurement doesn't keep the
+     * attributes changing.
+     */
+    if(minreq == 0 || (uint64_t{minreq}*4 > uint64_t{mAttr.minreq}*3
+        && uint64_t{minreq}*4 < uint64_t{mAttr.minreq}*5))
+        return;
+
+    TRACE("Sink latency %" PRIu64 "us, setting minreq to %u samples\n",
+        uint64_t{info->sink_usec}, minreq/mFrameSize);
+    pa_buffer_attr attr{mAttr};
+    attr.minreq = minreq;
+    updateBufferAttr(stream, attr);
+}
+
+void PulsePlayback::updateBufferAttr(pa_stream *stream, const pa_buffer_attr &attr) noexcept
+{
+    /* The mainloop lock is held for callbacks, so the new attributes are
+     * requested without waiting, and a change in the target length is
+     * reported once the server applies them.
+     */
+    constexpr auto attr_set_callback = [](pa_stream *strm, int success, void *pdata) noexcept
+    {
+        auto *self = static_cast<PulsePlayback*>(pdata);
+        self->mAttrPending = false;
+        if(!success)
+            return;
+        const uint oldlength{self->mAttr.tlength};
+        self->bufferAttrCallback(strm);
+        if(self->mAttr.tlength != oldlength)
+            self->bufferSizeChanged(self->mAttr.tlength / self->mFrameSize);
+    };
+    if(pa_operation *op{pa_stream_set_buffer_attr(stream, &attr, attr_set_callback, this)})
+    {
+        mAttrPending = true;
+        pa_operation_unref(op);
+    }
 }
 
 void PulsePlayback::sinkInfoCallback(pa_context*, const pa_sink_info *info, int eol) noexcept
@@ -862,6 +967,8 @@ bool PulsePlayback::reset()
         pa_stream_set_moved_callback(mStream, nullptr, nullptr);
         pa_stream_set_write_callback(mStream, nullptr, nullptr);
         pa_stream_set_buffer_attr_callback(mStream, nullptr, nullptr);
+        pa_stream_set_underflow_callback(mStream, nullptr, nullptr);
+        pa_stream_set_latency_update_callback(mStream, nullptr, nullptr);
         pa_stream_disconnect(mStream);
         pa_stream_unref(mStream);
         mStream = nullptr;
@@ -877,7 +984,9 @@ bool PulsePlayback::reset()
         PA_STREAM_AUTO_TIMING_UPDATE | PA_STREAM_EARLY_REQUESTS};
     if(!GetConfigValueBool({}, "pulse", "allow-moves", true))
         flags |= PA_STREAM_DONT_MOVE;
-    if(GetConfigValueBool(mDevice->DeviceName, "pulse", "adjust-latency", false))
+    const bool adjustLatency{GetConfigValueBool(mDevice->DeviceName, "pulse", "adjust-latency",
+        false)};
+    if(adjustLatency)
     {
         /* ADJUST_LATENCY can't be specified with EARLY_REQUESTS, for some
          * reason. So if the user wants to adjust the overall device latency,
@@ -1005,6 +1114,24 @@ bool PulsePlayback::reset()
     mDevice->BufferSize = mAttr.tlength / mFrameSize;
     mDevice->UpdateSize = mAttr.minreq / mFrameSize;
 
+    mAdaptive = GetConfigValueBool(mDevice->DeviceName, {}, "adaptive-buffering", false);
+    mAttrPending = false;
+    mMaxTLength = static_cast<uint>(std::min(uint64_t{mAttr.tlength}*4,
+        uint64_t{std::numeric_limits<int>::max()}));
+    constexpr auto underflow_callback = [](pa_stream *stream, void *pdata) noexcept
+    { return static_cast<PulsePlayback*>(pdata)->streamUnderflowCallback(stream); };
+    pa_stream_set_underflow_callback(mStream, underflow_callback, this);
+
+    /* With ADJUST_LATENCY, the server sizes the sink's buffer from the
+     * requested attributes, so minreq is left as it gave.
+     */
+    mAdaptMinReq = !adjustLatency
+        && GetConfigValueBool(mDevice->DeviceName, "pulse", "adapt-minreq", true);
+    mBaseMinReq = mAttr.minreq;
+    constexpr auto latency_callback = [](pa_stream *stream, void *pdata) noexcept
+    { return static_cast<PulsePlayback*>(pdata)->streamLatencyCallback(stream); };
+    pa_stream_set_latency_update_callback(mStream, latency_callback, this);
+
     return true;
 }
 
@@ -1013,14 +1140,11 @@ void PulsePlayback::start()
     MainloopUniqueLock plock{mMainloop};
 
     /* Write some samples to fill the buffer before we start feeding it newly
-     * mixed samples.
+     * mixed samples. This renders directly into the stream's buffer, the same
+     * as the write callback.
      */
-    if(size_t todo{pa_stream_writable_size(mStream)})
-    {
-        void *buf{pa_xmalloc(todo)};
-        mDevice->renderSamples(buf, static_cast<uint>(todo/mFrameSize), mSpec.channels);
-        pa_stream_write(mStream, buf, todo, pa_xfree, 0, PA_SEEK_RELATIVE);
-    }
+    if(size_t todo{pa_stream_writable_size(mStream)}; todo > 0 && todo != size_t(-1))
+        streamWriteCallback(mStream, todo);
 
     constexpr auto stream_write = [](pa_stream *stream, size_t nbytes, void *pdata) noexcept
     { return static_cast<PulsePlayback*>(pdata)->streamWriteCallback(stream, nbytes); };
@@ -1496,7 +1620,7 @@ BackendFactory &PulseBackendFactory::getFactory()
     return factory;
 }
 
-alc::EventSupport PulseBackendFactory::queryEventSupport(alc::EventType eventType, BackendType)
+alc::EventSupport PulseBackendFactory::queryEventSupport(alc::EventType eventType, BackendType type)
 {
     switch(eventType)
     {
@@ -1504,7 +1628,14 @@ alc::EventSupport PulseBackendFactory::queryEventSupport(alc::EventType eventTyp
     case alc::EventType::DeviceRemoved:
         return alc::EventSupport::FullSupport;
 
+    case alc::EventType::BufferSizeChanged:
+        if(type == BackendType::Playback)
+            return alc::EventSupport::FullSupport;
+        break;
+
     case alc::EventType::DefaultDeviceChanged:
+    case alc::EventType::HrtfReady:
+    case alc::EventType::CaptureReady:
     case alc::EventType::Count:
         break;
     }
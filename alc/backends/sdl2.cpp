@@ -22,7 +22,9 @@
 
 #include "sdl2.h"
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstdlib>
 #include <cstring>
 #include <string>
@@ -61,6 +63,7 @@ struct Sdl2Backend final : public BackendBase {
     bool reset() override;
     void start() override;
     void stop() override;
+    ClockLatency getClockLatency() override;
 
     SDL_AudioDeviceID mDeviceID{0u};
     uint mFrameSize{0};
@@ -69,6 +72,11 @@ struct Sdl2Backend final : public BackendBase {
     DevFmtChannels mFmtChans{};
     DevFmtType     mFmtType{};
     uint mUpdateSize{0u};
+
+    /* The time the last callback finished mixing, protected by the SDL
+     * device lock.
+     */
+    std::chrono::steady_clock::time_point mLastCallback{};
 };
 
 Sdl2Backend::~Sdl2Backend()
@@ -82,7 +90,11 @@ void Sdl2Backend::audioCallback(Uint8 *stream, int len) noexcept
 {
     const auto ulen = static_cast<unsigned int>(len);
     assert((ulen % mFrameSize) == 0);
+    timeWakeup();
+    timeRenderStart();
     mDevice->renderSamples(stream, ulen / mFrameSize, mDevice->channelsFromFmt());
+    timeRenderEnd();
+    mLastCallback = std::chrono::steady_clock::now();
 }
 
 void Sdl2Backend::open(std::string_view name)
@@ -98,7 +110,7 @@ void Sdl2Backend::open(std::string_view name)
     case DevFmtShort: want.format = AUDIO_S16SYS; break;
     case DevFmtUInt: /* fall-through */
     case DevFmtInt: want.format = AUDIO_S32SYS; break;
-    case DevFmtFloat: want.format = AUDIO_F32; break;
+    case DevFmtFloat: want.format = AUDIO_F32SYS; break;
     }
     want.channels = (mDevice->FmtChans == DevFmtMono) ? 1 : 2;
     want.samples = static_cast<Uint16>(std::min(mDevice->UpdateSize, 8192u));
@@ -106,6 +118,11 @@ void Sdl2Backend::open(std::string_view name)
     { return static_cast<Sdl2Backend*>(ptr)->audioCallback(stream, len); };
     want.userdata = this;
 
+    /* Allowing any change makes SDL hand over the device's own format, channel
+     * count, and period size instead of adding a conversion stream to match
+     * what was asked for. The mixer renders whatever it gets directly.
+     */
+
     /* Passing nullptr to SDL_OpenAudioDevice opens a default, which isn't
      * necessarily the first in the list.
      */
@@ -174,6 +191,8 @@ void Sdl2Backend::open(std::string_view name)
     mFmtChans = devchans;
     mFmtType = devtype;
     mUpdateSize = have.samples;
+    TRACE("Got %dhz, %d channel%s, format 0x%04x, %u sample period\n", have.freq,
+        int{have.channels}, (have.channels==1)?"":"s", have.format, mUpdateSize);
 
     mDevice->DeviceName = name;
 }
@@ -190,11 +209,45 @@ bool Sdl2Backend::reset()
 }
 
 void Sdl2Backend::start()
-{ SDL_PauseAudioDevice(mDeviceID, 0); }
+{
+    mLastCallback = {};
+    SDL_PauseAudioDevice(mDeviceID, 0);
+}
 
 void Sdl2Backend::stop()
 { SDL_PauseAudioDevice(mDeviceID, 1); }
 
+ClockLatency Sdl2Backend::getClockLatency()
+{
+    using std::chrono::nanoseconds;
+
+    /* The device lock is held while the callback runs, so it keeps the clock
+     * and callback time in sync.
+     */
+    SDL_LockAudioDevice(mDeviceID);
+    ClockLatency ret{};
+    ret.ClockTime = mDevice->getClockTime();
+    const auto lastCallback = mLastCallback;
+    SDL_UnlockAudioDevice(mDeviceID);
+
+    /* SDL doesn't report its buffering, but it (tries to) keep two periods
+     * with the newest one written by the last callback. Estimate what's left
+     * from the time that's passed since, keeping at least the driver's
+     * period.
+     */
+    const auto period = nanoseconds{std::chrono::seconds{mDevice->UpdateSize}} /
+        mDevice->Frequency;
+    ret.Latency = nanoseconds{std::chrono::seconds{mDevice->BufferSize}} / mDevice->Frequency;
+    if(lastCallback.time_since_epoch().count() != 0
+        && SDL_GetAudioDeviceStatus(mDeviceID) == SDL_AUDIO_PLAYING)
+    {
+        const auto elapsed = std::chrono::duration_cast<nanoseconds>(
+            std::chrono::steady_clock::now() - lastCallback);
+        ret.Latency = std::clamp(ret.Latency - elapsed, period, ret.Latency);
+    }
+    return ret;
+}
+
 } // namespace
 
 BackendFactory &SDL2BackendFactory::getFactory()
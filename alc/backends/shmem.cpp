@@ -0,0 +1,496 @@
+/**
+ * OpenAL cross platform audio library
+ * Copyright (C) 2024 by authors.
+ * This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Library General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ *  License along with this library; if not, write to the
+ *  Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ * Or go to http://www.gnu.org/copyleft/lgpl.html
+ */
+
+#include "config.h"
+
+#include "shmem.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <new>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include "alc/alconfig.h"
+#include "alstring.h"
+#include "althrd_setname.h"
+#include "core/device.h"
+#include "core/helpers.h"
+#include "core/logging.h"
+
+
+namespace {
+
+using std::chrono::seconds;
+using std::chrono::milliseconds;
+using namespace std::string_view_literals;
+
+[[nodiscard]] constexpr auto GetDeviceName() noexcept { return "Shared Memory Output"sv; }
+
+
+/* The header at the start of the shared memory segment. The layout is fixed
+ * and documented in docs/shm-output.txt, for consumers in other processes.
+ * The producer's and consumer's positions are on separate cache lines, so
+ * they don't contend with each other.
+ */
+struct ShmHeader {
+    enum State : uint32_t {
+        Configuring,
+        Running,
+        Stopped,
+        Closed
+    };
+
+    static constexpr std::array<char,8> Magic{{'A','L','S','H','M','O','U','T'}};
+    static constexpr uint32_t Version{1};
+
+    std::array<char,8> mMagic;
+    uint32_t mVersion;
+    uint32_t mDataOffset;
+    uint64_t mMapSize;
+    uint32_t mFrequency;
+    uint32_t mChannels;
+    uint32_t mChannelMask;
+    uint32_t mAmbiOrder;
+    uint32_t mSampleType;
+    uint32_t mFrameSize;
+    uint32_t mCapacity;
+    uint32_t mUpdateSize;
+    std::atomic<uint32_t> mState;
+
+    /* Written by the producer. */
+    alignas(64) std::atomic<uint64_t> mWritePos;
+    std::atomic<uint64_t> mDropped;
+    std::atomic<uint32_t> mWakeSeq;
+
+    /* Written by the consumer. */
+    alignas(64) std::atomic<uint64_t> mReadPos;
+    std::atomic<uint32_t> mWaiting;
+};
+static_assert(std::atomic<uint64_t>::is_always_lock_free
+    && std::atomic<uint32_t>::is_always_lock_free,
+    "Shared memory positions must be lock-free");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+static_assert(sizeof(ShmHeader) == 192, "Unexpected shared memory header size");
+
+/* The sample ring starts on its own cache line after the header. */
+constexpr uint32_t ShmDataOffset{256};
+
+
+struct ShmBackend final : public BackendBase {
+    ShmBackend(DeviceBase *device) noexcept : BackendBase{device} { }
+    ~ShmBackend() override;
+
+    int mixerProc();
+
+    void open(std::string_view name) override;
+    bool reset() override;
+    void start() override;
+    void stop() override;
+
+    ClockLatency getClockLatency() override;
+
+    void wakeConsumer() noexcept;
+
+    std::string mName;
+    int mFd{-1};
+    void *mMapping{MAP_FAILED};
+    std::size_t mMapSize{0};
+
+    ShmHeader *mHeader{nullptr};
+    std::byte *mRing{nullptr};
+
+    /* Whether to pace rendering to real time. Otherwise, the consumer paces
+     * it by reading.
+     */
+    bool mRealtime{true};
+
+    std::atomic<bool> mKillNow{true};
+    std::thread mThread;
+};
+
+ShmBackend::~ShmBackend()
+{
+    if(mHeader)
+    {
+        mHeader->mState.store(ShmHeader::Closed, std::memory_order_release);
+        wakeConsumer();
+    }
+    if(mMapping != MAP_FAILED)
+        munmap(mMapping, mMapSize);
+    if(mFd != -1)
+    {
+        close(mFd);
+        shm_unlink(mName.c_str());
+    }
+}
+
+void ShmBackend::wakeConsumer() noexcept
+{
+    mHeader->mWakeSeq.fetch_add(1u);
+#ifdef __linux__
+    /* Only make the syscall when the consumer says it's waiting. The wake
+     * count is incremented first, so a consumer that starts waiting after
+     * this checks it won't sleep through the update.
+     */
+    if(mHeader->mWaiting.exchange(0u) != 0)
+        syscall(SYS_futex, static_cast<void*>(&mHeader->mWakeSeq), FUTEX_WAKE, INT_MAX, nullptr,
+            nullptr, 0);
+#endif
+}
+
+int ShmBackend::mixerProc()
+{
+    const milliseconds restTime{mDevice->UpdateSize*1000/mDevice->Frequency / 2};
+
+    SetRTPriority();
+    althrd_setname(GetMixerThreadName());
+
+    const uint updateSize{mDevice->UpdateSize};
+    const uint capacity{mHeader->mCapacity};
+    const size_t frameStep{mDevice->channelsFromFmt()};
+    const size_t frameSize{mDevice->frameSizeFromFmt()};
+
+    /* Gets the number of frames the consumer has left room for. The read
+     * position comes from another process, so don't trust it to be sane.
+     */
+    auto get_space = [this,capacity](const uint64_t writepos) noexcept -> uint64_t
+    {
+        const uint64_t readpos{mHeader->mReadPos.load(std::memory_order_acquire)};
+        const uint64_t used{std::min(writepos - std::min(readpos, writepos), uint64_t{capacity})};
+        return capacity - used;
+    };
+
+    int64_t done{0};
+    auto start = std::chrono::steady_clock::now();
+    while(!mKillNow.load(std::memory_order_acquire)
+        && mDevice->Connected.load(std::memory_order_acquire))
+    {
+        int64_t avail{done + updateSize};
+        if(mRealtime)
+        {
+            auto now = std::chrono::steady_clock::now();
+
+            /* This converts from nanoseconds to nanosamples, then to samples. */
+            avail = std::chrono::duration_cast<seconds>((now-start) * mDevice->Frequency).count();
+            if(avail-done < updateSize)
+            {
+                std::this_thread::sleep_for(restTime);
+                continue;
+            }
+        }
+        else if(get_space(mHeader->mWritePos.load(std::memory_order_relaxed)) < updateSize)
+        {
+            std::this_thread::sleep_for(restTime);
+            continue;
+        }
+
+        timeWakeup();
+        while(avail-done >= updateSize)
+        {
+            const uint64_t writepos{mHeader->mWritePos.load(std::memory_order_relaxed)};
+
+            timeRenderStart();
+            if(get_space(writepos) < updateSize)
+            {
+                /* The consumer isn't keeping up. Mix and discard the update,
+                 * rather than overwrite samples it may still be reading.
+                 */
+                mDevice->renderSamples(nullptr, updateSize, 0u);
+                timeRenderEnd();
+                mHeader->mDropped.fetch_add(updateSize, std::memory_order_relaxed);
+                xrunOccurred();
+            }
+            else
+            {
+                /* Render directly into the ring, in two parts if it wraps
+                 * around.
+                 */
+                const auto offset = static_cast<uint>(writepos & (capacity-1u));
+                const uint todo{std::min(updateSize, capacity-offset)};
+                mDevice->renderSamples(mRing + size_t{offset}*frameSize, todo, frameStep);
+                if(todo < updateSize)
+                    mDevice->renderSamples(mRing, updateSize-todo, frameStep);
+                timeRenderEnd();
+
+                mHeader->mWritePos.store(writepos+updateSize, std::memory_order_release);
+                wakeConsumer();
+            }
+            done += updateSize;
+        }
+        timeCommit();
+
+        /* For every completed second, increment the start time and reduce the
+         * samples done. This prevents the difference between the start time
+         * and current time from growing too large, while maintaining the
+         * correct number of samples to render.
+         */
+        if(done >= mDevice->Frequency)
+        {
+            seconds s{done/mDevice->Frequency};
+            start += s;
+            done -= mDevice->Frequency*s.count();
+        }
+    }
+
+    return 0;
+}
+
+
+void ShmBackend::open(std::string_view name)
+{
+    if(name.empty())
+        name = GetDeviceName();
+    else if(name != GetDeviceName())
+        throw al::backend_exception{al::backend_error::NoDevice, "Device name \"%.*s\" not found",
+            al::sizei(name), name.data()};
+
+    /* There's only one "device", so if it's already open, we're done. */
+    if(mFd != -1) return;
+
+    auto segname = ConfigValueStr({}, "shm", "name").value_or("/alsoft-output");
+    if(segname.empty())
+        throw al::backend_exception{al::backend_error::NoDevice,
+            "No shared memory segment name"};
+    if(segname.front() != '/')
+        segname.insert(segname.begin(), '/');
+
+    mFd = shm_open(segname.c_str(), O_RDWR | O_CREAT, 0600);
+    if(mFd == -1)
+        throw al::backend_exception{al::backend_error::DeviceError,
+            "Could not open shared memory segment '%s': %s", segname.c_str(),
+            std::generic_category().message(errno).c_str()};
+    mName = std::move(segname);
+
+    mRealtime = GetConfigValueBool({}, "shm", "realtime", true);
+    TRACE("Opened shared memory segment %s, %s\n", mName.c_str(),
+        mRealtime ? "paced to real time" : "paced by the consumer");
+
+    mDevice->DeviceName = name;
+}
+
+bool ShmBackend::reset()
+{
+    uint chanmask{0}, ambiorder{0};
+    switch(mDevice->FmtChans)
+    {
+    case DevFmtMono:   chanmask = 0x04; break;
+    case DevFmtStereo: chanmask = 0x01 | 0x02; break;
+    case DevFmtQuad:   chanmask = 0x01 | 0x02 | 0x10 | 0x20; break;
+    case DevFmtX51: chanmask = 0x01 | 0x02 | 0x04 | 0x08 | 0x200 | 0x400; break;
+    case DevFmtX61: chanmask = 0x01 | 0x02 | 0x04 | 0x08 | 0x100 | 0x200 | 0x400; break;
+    case DevFmtX71: chanmask = 0x01 | 0x02 | 0x04 | 0x08 | 0x010 | 0x020 | 0x200 | 0x400; break;
+    case DevFmtX7144:
+        mDevice->FmtChans = DevFmtX714;
+        [[fallthrough]];
+    case DevFmtX714:
+        chanmask = 0x01 | 0x02 | 0x04 | 0x08 | 0x010 | 0x020 | 0x200 | 0x400 | 0x1000 | 0x4000
+            | 0x8000 | 0x20000;
+        break;
+    /* NOTE: Same as 7.1. */
+    case DevFmtX3D71: chanmask = 0x01 | 0x02 | 0x04 | 0x08 | 0x010 | 0x020 | 0x200 | 0x400; break;
+    case DevFmtAmbi3D:
+        /* Always give the consumer ACN ordering with SN3D normalization. */
+        mDevice->mAmbiLayout = DevAmbiLayout::ACN;
+        mDevice->mAmbiScale = DevAmbiScaling::SN3D;
+        ambiorder = mDevice->mAmbiOrder;
+        break;
+    }
+    setDefaultWFXChannelOrder();
+
+    /* The ring holds a power-of-two number of frames, so the positions can
+     * wrap cleanly. By default, make it hold at least a quarter second and
+     * four updates.
+     */
+    uint minframes{ConfigValueUInt({}, "shm", "buffer-frames").value_or(0u)};
+    if(minframes == 0)
+        minframes = std::max(mDevice->Frequency/4u, mDevice->UpdateSize*4u);
+    minframes = std::clamp(minframes, mDevice->UpdateSize, 1u<<26);
+    uint capacity{1};
+    while(capacity < minframes)
+        capacity <<= 1;
+
+    const uint frameSize{mDevice->frameSizeFromFmt()};
+    const std::size_t mapsize{ShmDataOffset + std::size_t{capacity}*frameSize};
+
+    if(mHeader)
+    {
+        mHeader->mState.store(ShmHeader::Configuring, std::memory_order_release);
+        wakeConsumer();
+    }
+    if(mapsize > mMapSize)
+    {
+        /* Only grow the segment, so a consumer still mapping the old size
+         * doesn't fault.
+         */
+        if(ftruncate(mFd, static_cast<off_t>(mapsize)) != 0)
+        {
+            ERR("Failed to resize shared memory segment to %zu bytes: %s\n", mapsize,
+                std::generic_category().message(errno).c_str());
+            return false;
+        }
+
+        if(mMapping != MAP_FAILED)
+            munmap(mMapping, mMapSize);
+        mHeader = nullptr;
+        mRing = nullptr;
+        mMapSize = 0;
+
+        mMapping = mmap(nullptr, mapsize, PROT_READ | PROT_WRITE, MAP_SHARED, mFd, 0);
+        if(mMapping == MAP_FAILED)
+        {
+            ERR("Failed to map shared memory segment: %s\n",
+                std::generic_category().message(errno).c_str());
+            return false;
+        }
+        mMapSize = mapsize;
+
+        mHeader = ::new(mMapping) ShmHeader{};
+        mHeader->mMagic = ShmHeader::Magic;
+        mHeader->mVersion = ShmHeader::Version;
+        mHeader->mDataOffset = ShmDataOffset;
+        mHeader->mState.store(ShmHeader::Configuring, std::memory_order_relaxed);
+        mRing = static_cast<std::byte*>(mMapping) + ShmDataOffset;
+    }
+
+    mHeader->mMapSize = mMapSize;
+    mHeader->mFrequency = mDevice->Frequency;
+    mHeader->mChannels = mDevice->channelsFromFmt();
+    mHeader->mChannelMask = chanmask;
+    mHeader->mAmbiOrder = ambiorder;
+    mHeader->mSampleType = mDevice->FmtType;
+    mHeader->mFrameSize = frameSize;
+    mHeader->mCapacity = capacity;
+    mHeader->mUpdateSize = mDevice->UpdateSize;
+    mHeader->mWritePos.store(0u, std::memory_order_relaxed);
+    mHeader->mReadPos.store(0u, std::memory_order_relaxed);
+    mHeader->mDropped.store(0u, std::memory_order_relaxed);
+
+    /* The device latency is the ring, as far as the mixer's concerned. */
+    mDevice->BufferSize = capacity;
+
+    TRACE("Shared memory ring holds %u frames of %u bytes\n", capacity, frameSize);
+    return true;
+}
+
+void ShmBackend::start()
+{
+    try {
+        mHeader->mState.store(ShmHeader::Running, std::memory_order_release);
+        wakeConsumer();
+
+        mKillNow.store(false, std::memory_order_release);
+        mThread = std::thread{std::mem_fn(&ShmBackend::mixerProc), this};
+    }
+    catch(std::exception& e) {
+        mHeader->mState.store(ShmHeader::Stopped, std::memory_order_release);
+        throw al::backend_exception{al::backend_error::DeviceError,
+            "Failed to start mixing thread: %s", e.what()};
+    }
+}
+
+void ShmBackend::stop()
+{
+    if(mKillNow.exchange(true, std::memory_order_acq_rel) || !mThread.joinable())
+        return;
+    mThread.join();
+
+    mHeader->mState.store(ShmHeader::Stopped, std::memory_order_release);
+    wakeConsumer();
+}
+
+ClockLatency ShmBackend::getClockLatency()
+{
+    ClockLatency ret{};
+
+    uint refcount;
+    do {
+        refcount = mDevice->waitForClock();
+        ret.ClockTime = mDevice->getClockTime();
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while(refcount != mDevice->mClockCount.load(std::memory_order_relaxed));
+
+    /* The latency is however much the consumer has yet to read. */
+    uint64_t queued{0};
+    if(mHeader)
+    {
+        const uint64_t writepos{mHeader->mWritePos.load(std::memory_order_acquire)};
+        const uint64_t readpos{mHeader->mReadPos.load(std::memory_order_acquire)};
+        queued = std::min(writepos - std::min(readpos, writepos), uint64_t{mHeader->mCapacity});
+    }
+    ret.Latency = std::chrono::seconds{queued};
+    ret.Latency /= mDevice->Frequency;
+
+    return ret;
+}
+
+} // namespace
+
+
+bool ShmBackendFactory::init()
+{ return true; }
+
+bool ShmBackendFactory::querySupport(BackendType type)
+{ return type == BackendType::Playback; }
+
+auto ShmBackendFactory::enumerate(BackendType type) -> std::vector<std::string>
+{
+    switch(type)
+    {
+    case BackendType::Playback:
+        return std::vector{std::string{GetDeviceName()}};
+    case BackendType::Capture:
+        break;
+    }
+    return {};
+}
+
+BackendPtr ShmBackendFactory::createBackend(DeviceBase *device, BackendType type)
+{
+    if(type == BackendType::Playback)
+        return BackendPtr{new ShmBackend{device}};
+    return nullptr;
+}
+
+BackendFactory &ShmBackendFactory::getFactory()
+{
+    static ShmBackendFactory factory{};
+    return factory;
+}
@@ -0,0 +1,19 @@
+#ifndef BACKENDS_SHMEM_H
+#define BACKENDS_SHMEM_H
+
+#include "base.h"
+
+struct ShmBackendFactory final : public BackendFactory {
+public:
+    auto init() -> bool final;
+
+    auto querySupport(BackendType type) -> bool final;
+
+    auto enumerate(BackendType type) -> std::vector<std::string> final;
+
+    auto createBackend(DeviceBase *device, BackendType type) -> BackendPtr final;
+
+    static auto getFactory() -> BackendFactory&;
+};
+
+#endif /* BACKENDS_SHMEM_H */
@@ -290,6 +290,7 @@ struct SndioCapture final : public BackendBase {
     void stop() override;
     void captureSamples(std::byte *buffer, uint samples) override;
     uint availableSamples() override;
+    RingBuffer *getCaptureRing() override { return mRing.get(); }
 
     sio_hdl *mSndHandle{nullptr};
 
@@ -380,6 +381,7 @@ int SndioCapture::recordProc()
             static std::array<char,4096> junk;
             sio_read(mSndHandle, junk.data(), junk.size() - (junk.size()%frameSize));
         }
+        captureWritten(static_cast<uint>(mRing->readSpace()));
     }
 
     return 0;
@@ -520,6 +522,26 @@ bool SndIOBackendFactory::init()
 bool SndIOBackendFactory::querySupport(BackendType type)
 { return (type == BackendType::Playback || type == BackendType::Capture); }
 
+alc::EventSupport SndIOBackendFactory::queryEventSupport(alc::EventType eventType, BackendType type)
+{
+    switch(eventType)
+    {
+    case alc::EventType::CaptureReady:
+        if(type == BackendType::Capture)
+            return alc::EventSupport::FullSupport;
+        break;
+
+    case alc::EventType::DefaultDeviceChanged:
+    case alc::EventType::DeviceAdded:
+    case alc::EventType::DeviceRemoved:
+    case alc::EventType::HrtfReady:
+    case alc::EventType::BufferSizeChanged:
+    case alc::EventType::Count:
+        break;
+    }
+    return alc::EventSupport::NoSupport;
+}
+
 auto SndIOBackendFactory::enumerate(BackendType type) -> std::vector<std::string>
 {
     switch(type)
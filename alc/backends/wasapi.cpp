@@ -2164,6 +2164,7 @@ struct WasapiCapture final : public BackendBase, WasapiProxy {
 
     void captureSamples(std::byte *buffer, uint samples) override;
     uint availableSamples() override;
+    RingBuffer *getCaptureRing() override { return mRing.get(); }
 
     HRESULT mOpenStatus{E_FAIL};
     DeviceHandle mMMDev{nullptr};
@@ -2266,6 +2267,7 @@ FORCE_ALIGN int WasapiCapture::recordProc()
                 }
 
                 mRing->writeAdvance(dstframes);
+                captureWritten(static_cast<uint>(mRing->readSpace()));
 
                 hr = mCapture->ReleaseBuffer(numsamples);
                 if(FAILED(hr)) ERR("Failed to release capture buffer: 0x%08lx\n", hr);
@@ -2799,19 +2801,26 @@ BackendFactory &WasapiBackendFactory::getFactory()
     return factory;
 }
 
-alc::EventSupport WasapiBackendFactory::queryEventSupport(alc::EventType eventType, BackendType)
+alc::EventSupport WasapiBackendFactory::queryEventSupport(alc::EventType eventType, BackendType type)
 {
     switch(eventType)
     {
     case alc::EventType::DefaultDeviceChanged:
         return alc::EventSupport::FullSupport;
 
+    case alc::EventType::CaptureReady:
+        if(type == BackendType::Capture)
+            return alc::EventSupport::FullSupport;
+        break;
+
     case alc::EventType::DeviceAdded:
     case alc::EventType::DeviceRemoved:
 #if !defined(ALSOFT_UWP)
         return alc::EventSupport::FullSupport;
 #endif
 
+    case alc::EventType::HrtfReady:
+    case alc::EventType::BufferSizeChanged:
     case alc::EventType::Count:
         break;
     }
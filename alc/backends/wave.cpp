@@ -26,6 +26,7 @@
 #include <atomic>
 #include <cerrno>
 #include <chrono>
+#include <cinttypes>
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
@@ -109,11 +110,22 @@ struct WaveBackend final : public BackendBase {
     void start() override;
     void stop() override;
 
+    /* Buffer for the file stream, for offline rendering. It needs to outlive
+     * the file.
+     */
+    std::vector<char> mFileBuffer;
     FilePtr mFile{nullptr};
     long mDataStart{-1};
 
     std::vector<std::byte> mBuffer;
 
+    /* Whether to pace rendering to real time, and the number of sample frames
+     * to write before stopping (0 for no limit).
+     */
+    bool mRealtime{true};
+    uint64_t mLength{0};
+    uint64_t mWritten{0};
+
     std::atomic<bool> mKillNow{true};
     std::thread mThread;
 };
@@ -134,19 +146,29 @@ int WaveBackend::mixerProc()
     while(!mKillNow.load(std::memory_order_acquire)
         && mDevice->Connected.load(std::memory_order_acquire))
     {
-        auto now = std::chrono::steady_clock::now();
-
-        /* This converts from nanoseconds to nanosamples, then to samples. */
-        int64_t avail{std::chrono::duration_cast<seconds>((now-start) *
-            mDevice->Frequency).count()};
-        if(avail-done < mDevice->UpdateSize)
+        /* When not paced to real time, render an update whenever the loop
+         * comes around.
+         */
+        int64_t avail{done + mDevice->UpdateSize};
+        if(mRealtime)
         {
-            std::this_thread::sleep_for(restTime);
-            continue;
+            auto now = std::chrono::steady_clock::now();
+
+            /* This converts from nanoseconds to nanosamples, then to samples. */
+            avail = std::chrono::duration_cast<seconds>((now-start) * mDevice->Frequency).count();
+            if(avail-done < mDevice->UpdateSize)
+            {
+                std::this_thread::sleep_for(restTime);
+                continue;
+            }
         }
         while(avail-done >= mDevice->UpdateSize)
         {
-            mDevice->renderSamples(mBuffer.data(), mDevice->UpdateSize, frameStep);
+            uint todo{mDevice->UpdateSize};
+            if(mLength > 0)
+                todo = static_cast<uint>(std::min<uint64_t>(todo, mLength-mWritten));
+
+            mDevice->renderSamples(mBuffer.data(), todo, frameStep);
             done += mDevice->UpdateSize;
 
             if(al::endian::native != al::endian::little)
@@ -170,13 +192,25 @@ int WaveBackend::mixerProc()
                 }
             }
 
-            const size_t fs{fwrite(mBuffer.data(), frameSize, mDevice->UpdateSize, mFile.get())};
-            if(fs < mDevice->UpdateSize || ferror(mFile.get()))
+            const size_t fs{fwrite(mBuffer.data(), frameSize, todo, mFile.get())};
+            if(fs < todo || ferror(mFile.get()))
             {
                 ERR("Error writing to file\n");
                 mDevice->handleDisconnect("Failed to write playback samples");
                 break;
             }
+            mWritten += todo;
+
+            /* Disconnect the device once the requested length is written, so
+             * the app can tell the render is finished.
+             */
+            if(mLength > 0 && mWritten >= mLength)
+            {
+                TRACE("Finished writing %" PRIu64 " sample frames\n", mWritten);
+                mDevice->handleDisconnect("Finished writing %" PRIu64 " sample frames",
+                    mWritten);
+                break;
+            }
         }
 
         /* For every completed second, increment the start time and reduce the
@@ -222,6 +256,19 @@ void WaveBackend::open(std::string_view name)
         throw al::backend_exception{al::backend_error::DeviceError, "Could not open file '%s': %s",
             fname->c_str(), std::generic_category().message(errno).c_str()};
 
+    mRealtime = GetConfigValueBool({}, "wave", "realtime", true);
+    mLength = ConfigValueUInt({}, "wave", "length").value_or(0u);
+    if(!mRealtime)
+    {
+        /* Rendering offline goes as fast as it can, so write through a large
+         * buffer to avoid a write call for every update.
+         */
+        mFileBuffer.resize(size_t{1} << 20);
+        if(setvbuf(mFile.get(), mFileBuffer.data(), _IOFBF, mFileBuffer.size()) != 0)
+            WARN("Failed to set the file buffer size\n");
+        TRACE("Rendering offline, unpaced\n");
+    }
+
     mDevice->DeviceName = name;
 }
 
@@ -232,6 +279,7 @@ bool WaveBackend::reset()
 
     fseek(mFile.get(), 0, SEEK_SET);
     clearerr(mFile.get());
+    mWritten = 0;
 
     if(GetConfigValueBool({}, "wave", "bformat", false))
     {
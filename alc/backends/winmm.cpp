@@ -368,6 +368,7 @@ struct WinMMCapture final : public BackendBase {
     void stop() override;
     void captureSamples(std::byte *buffer, uint samples) override;
     uint availableSamples() override;
+    RingBuffer *getCaptureRing() override { return mRing.get(); }
 
     std::atomic<uint> mReadable{0u};
     al::semaphore mSem;
@@ -430,6 +431,7 @@ int WinMMCapture::captureProc()
             waveInAddBuffer(mInHdl, &waveHdr, sizeof(WAVEHDR));
         } while(--todo);
         mIdx = static_cast<uint>(widx);
+        captureWritten(static_cast<uint>(mRing->readSpace()));
     }
 
     return 0;
@@ -578,6 +580,26 @@ bool WinMMBackendFactory::init()
 bool WinMMBackendFactory::querySupport(BackendType type)
 { return type == BackendType::Playback || type == BackendType::Capture; }
 
+alc::EventSupport WinMMBackendFactory::queryEventSupport(alc::EventType eventType, BackendType type)
+{
+    switch(eventType)
+    {
+    case alc::EventType::CaptureReady:
+        if(type == BackendType::Capture)
+            return alc::EventSupport::FullSupport;
+        break;
+
+    case alc::EventType::DefaultDeviceChanged:
+    case alc::EventType::DeviceAdded:
+    case alc::EventType::DeviceRemoved:
+    case alc::EventType::HrtfReady:
+    case alc::EventType::BufferSizeChanged:
+    case alc::EventType::Count:
+        break;
+    }
+    return alc::EventSupport::NoSupport;
+}
+
 auto WinMMBackendFactory::enumerate(BackendType type) -> std::vector<std::string>
 {
     std::vector<std::string> outnames;
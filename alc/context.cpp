@@ -11,6 +11,7 @@
 #include <limits>
 #include <numeric>
 #include <stdexcept>
+#include <thread>
 #include <string_view>
 #include <utility>
 
@@ -72,19 +73,35 @@ std::vector<std::string_view> getContextExtensions() noexcept
         "AL_SOFT_bformat_ex"sv,
         "AL_SOFTX_bformat_hoa"sv,
         "AL_SOFT_block_alignment"sv,
+        "AL_SOFTX_buffer_completed_clock"sv,
+        "AL_SOFTX_buffer_file"sv,
         "AL_SOFT_buffer_length_query"sv,
+        "AL_SOFTX_buffer_reserve"sv,
+        "AL_SOFTX_buffer_upload_async"sv,
         "AL_SOFT_callback_buffer"sv,
+        "AL_SOFTX_callback_prefetch"sv,
         "AL_SOFTX_convolution_effect"sv,
         "AL_SOFT_deferred_updates"sv,
         "AL_SOFT_direct_channels"sv,
         "AL_SOFT_direct_channels_remix"sv,
+        "AL_SOFTX_direct_routing"sv,
         "AL_SOFT_effect_target"sv,
+        "AL_SOFTX_effect_slot_ready_event"sv,
+        "AL_SOFTX_event_batch"sv,
         "AL_SOFT_events"sv,
         "AL_SOFT_gain_clamp_ex"sv,
+        "AL_SOFTX_half_float"sv,
         "AL_SOFTX_hold_on_disconnect"sv,
+        "AL_SOFTX_IMA2_ADPCM"sv,
         "AL_SOFT_loop_points"sv,
         "AL_SOFTX_map_buffer"sv,
         "AL_SOFT_MSADPCM"sv,
+        "AL_SOFTX_multi_listener"sv,
+        "AL_SOFTX_reverb_zones"sv,
+        "AL_SOFTX_ring_buffer"sv,
+        "AL_SOFTX_source_batch"sv,
+        "AL_SOFTX_source_group"sv,
+        "AL_SOFTX_source_instancing"sv,
         "AL_SOFT_source_latency"sv,
         "AL_SOFT_source_length"sv,
         "AL_SOFTX_source_panning"sv,
@@ -224,7 +241,20 @@ void ALCcontext::init()
     mParams.mDistanceModel = mDistanceModel;
 
 
-    mAsyncEvents = RingBuffer::Create(1024, sizeof(AsyncEvent), false);
+    /* With an event interval, make room for the events of each update the
+     * event thread may sleep through.
+     */
+    size_t numevents{1024};
+    if(auto intervalopt = mALDevice->configValue<uint>({}, "event-interval"sv))
+    {
+        mEventInterval = std::chrono::milliseconds{std::min(*intervalopt, 100u)};
+        const uint updates{static_cast<uint>((mEventInterval.count()*mALDevice->Frequency
+            + 999) / 1000 / mALDevice->UpdateSize)};
+        numevents *= updates + 1;
+        TRACE("Event interval %lldms, %zu event slots\n",
+            static_cast<long long>(mEventInterval.count()), numevents);
+    }
+    mAsyncEvents = RingBuffer::Create(numevents, sizeof(AsyncEvent), false);
     StartEventThrd(this);
 
 
@@ -293,8 +323,13 @@ void ALCcontext::applyAllUpdates()
      * updating to finish, before providing updates.
      */
     mHoldUpdates.store(true, std::memory_order_release);
-    while((mUpdateCount.load(std::memory_order_acquire)&1) != 0) {
-        /* busy-wait */
+    /* The mixer only keeps the count odd while it applies the updates, so
+     * spin briefly before yielding to it.
+     */
+    for(uint spins{0u};(mUpdateCount.load(std::memory_order_acquire)&1) != 0;++spins)
+    {
+        if(spins >= 64)
+            std::this_thread::yield();
     }
 
 #ifdef ALSOFT_EAX
@@ -305,7 +340,7 @@ void ALCcontext::applyAllUpdates()
     if(std::exchange(mPropsDirty, false))
         UpdateContextProps(this);
     UpdateAllEffectSlotProps(this);
-    UpdateAllSourceProps(this);
+    UpdateDirtySourceProps(this);
 
     /* Now with all updates declared, let the mixer continue applying them so
      * they all happen at once.
@@ -638,21 +673,29 @@ void ALCcontext::eax_dispatch_fx_slot(const EaxCall& call)
     auto& fx_slot = eaxGetFxSlot(*fx_slot_index);
     if(fx_slot.eax_dispatch(call))
     {
-        std::lock_guard<std::mutex> source_lock{mSourceLock};
+        std::lock_guard<std::shared_mutex> source_lock{mSourceLock};
         ForEachSource(this, std::mem_fn(&ALsource::eaxMarkAsChanged));
+        mEaxAllSourcesDirty = true;
     }
 }
 
 void ALCcontext::eax_dispatch_source(const EaxCall& call)
 {
     const auto source_id = call.get_property_al_name();
-    std::lock_guard<std::mutex> source_lock{mSourceLock};
+    std::lock_guard<std::shared_mutex> source_lock{mSourceLock};
     const auto source = ALsource::EaxLookupSource(*this, source_id);
 
     if (source == nullptr)
         eax_fail("Source not found.");
 
     source->eaxDispatch(call);
+
+    /* Remember the source for the next commit if the call changed it. Repeated
+     * sets on the same source are only recorded once.
+     */
+    if(!call.is_get() && source->eaxIsChanged() && !mEaxAllSourcesDirty
+        && (mEaxDirtySources.empty() || mEaxDirtySources.back() != source_id))
+        mEaxDirtySources.emplace_back(source_id);
 }
 
 void ALCcontext::eax_get_misc(const EaxCall& call)
@@ -782,10 +825,21 @@ void ALCcontext::eax_initialize_fx_slots()
 
 void ALCcontext::eax_update_sources()
 {
-    std::unique_lock<std::mutex> source_lock{mSourceLock};
-    auto update_source = [](ALsource &source)
-    { source.eaxCommit(); };
-    ForEachSource(this, update_source);
+    std::unique_lock<std::shared_mutex> source_lock{mSourceLock};
+    if(mEaxAllSourcesDirty)
+    {
+        auto update_source = [](ALsource &source)
+        { source.eaxCommit(); };
+        ForEachSource(this, update_source);
+    }
+    else for(const ALuint source_id : mEaxDirtySources)
+    {
+        /* The source may have been deleted since it was changed. */
+        if(auto *source = ALsource::EaxLookupSource(*this, source_id))
+            source->eaxCommit();
+    }
+    mEaxDirtySources.clear();
+    mEaxAllSourcesDirty = false;
 }
 
 void ALCcontext::eax_set_misc(const EaxCall& call)
@@ -999,8 +1053,11 @@ void ALCcontext::eax_context_commit()
     if((dst_df & eax_macro_fx_factor_dirty_bit) != EaxDirtyFlags{})
         eax_context_commit_macro_fx_factor();
 
+    /* Every source needs to update its primary FX slot. That's done after the
+     * FX slots are committed.
+     */
     if((dst_df & eax_primary_fx_slot_id_dirty_bit) != EaxDirtyFlags{})
-        eax_update_sources();
+        mEaxAllSourcesDirty = true;
 }
 
 void ALCcontext::eaxCommit()
@@ -1015,7 +1072,7 @@ void ALCcontext::eaxCommit()
 FORCE_ALIGN auto AL_APIENTRY EAXSet(const GUID *property_set_id, ALuint property_id,
     ALuint source_id, ALvoid *value, ALuint value_size) noexcept -> ALenum
 {
-    auto context = GetContextRef();
+    auto context = GetCurrentContext();
     if(!context) UNLIKELY return AL_INVALID_OPERATION;
     return EAXSetDirect(context.get(), property_set_id, property_id, source_id, value, value_size);
 }
@@ -1024,7 +1081,7 @@ FORCE_ALIGN auto AL_APIENTRY EAXSetDirect(ALCcontext *context, const GUID *prope
     ALuint property_id, ALuint source_id, ALvoid *value, ALuint value_size) noexcept -> ALenum
 try
 {
-    std::lock_guard<std::mutex> prop_lock{context->mPropLock};
+    std::lock_guard<std::shared_mutex> prop_lock{context->mPropLock};
     return context->eax_eax_set(property_set_id, property_id, source_id, value, value_size);
 }
 catch(...)
@@ -1038,7 +1095,7 @@ catch(...)
 FORCE_ALIGN auto AL_APIENTRY EAXGet(const GUID *property_set_id, ALuint property_id,
     ALuint source_id, ALvoid *value, ALuint value_size) noexcept -> ALenum
 {
-    auto context = GetContextRef();
+    auto context = GetCurrentContext();
     if(!context) UNLIKELY return AL_INVALID_OPERATION;
     return EAXGetDirect(context.get(), property_set_id, property_id, source_id, value, value_size);
 }
@@ -1047,7 +1104,7 @@ FORCE_ALIGN auto AL_APIENTRY EAXGetDirect(ALCcontext *context, const GUID *prope
     ALuint property_id, ALuint source_id, ALvoid *value, ALuint value_size) noexcept -> ALenum
 try
 {
-    std::lock_guard<std::mutex> prop_lock{context->mPropLock};
+    std::lock_guard<std::shared_mutex> prop_lock{context->mPropLock};
     return context->eax_eax_get(property_set_id, property_id, source_id, value, value_size);
 }
 catch(...)
@@ -3,10 +3,12 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <deque>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -79,7 +81,10 @@ struct ALCcontext : public al::intrusive_ref<ALCcontext>, ContextBase {
     bool mPropsDirty{true};
     bool mDeferUpdates{false};
 
-    std::mutex mPropLock;
+    /* Held shared while setting properties on a single source, and exclusively
+     * for everything else that changes properties or defers/processes updates.
+     */
+    std::shared_mutex mPropLock;
 
     al::tss<ALenum> mLastThreadError{AL_NO_ERROR};
 
@@ -97,6 +102,13 @@ struct ALCcontext : public al::intrusive_ref<ALCcontext>, ContextBase {
     std::mutex mEventCbLock;
     ALEVENTPROCSOFT mEventCb{};
     void *mEventParam{nullptr};
+    ALEVENTBATCHPROCSOFT mEventBatchCb{};
+    void *mEventBatchParam{nullptr};
+    /* The minimum time between event thread wakeups, to deliver events in
+     * larger batches.
+     */
+    std::chrono::milliseconds mEventInterval{};
+    std::chrono::steady_clock::time_point mNextEventWake{};
 
     std::mutex mDebugCbLock;
     ALDEBUGPROCEXT mDebugCb{};
@@ -105,14 +117,32 @@ struct ALCcontext : public al::intrusive_ref<ALCcontext>, ContextBase {
     std::deque<DebugLogEntry> mDebugLog;
 
     ALlistener mListener{};
+    /* The listeners after the first, used up to the device's listener count. */
+    std::array<ALlistener,MaxListenerCount-1> mExtraListeners{};
 
     std::vector<SourceSubList> mSourceList;
     ALuint mNumSources{0};
-    std::mutex mSourceLock;
+    /* Held shared to look up, query, and set properties on sources (along with
+     * the source's own lock), and exclusively to create, delete, play, stop,
+     * or queue them.
+     */
+    std::shared_mutex mSourceLock;
+    /* Guards the voice, voice change, and voice property lists against
+     * concurrent property changes on different sources.
+     */
+    std::mutex mVoiceUpdateLock;
+    /* Sources with property changes waiting to be committed, so committing
+     * deferred updates doesn't need to check every voice. Appended to under
+     * mVoiceUpdateLock.
+     */
+    std::vector<ALuint> mDirtySources;
 
     std::vector<EffectSlotSubList> mEffectSlotList;
     ALuint mNumEffectSlots{0u};
-    std::mutex mEffectSlotLock;
+    /* Held shared to look up and query effect slots, and exclusively to
+     * create, delete, or modify them.
+     */
+    std::shared_mutex mEffectSlotLock;
 
     /* Default effect slot */
     std::unique_ptr<ALeffectslot> mDefaultSlot;
@@ -139,13 +169,14 @@ struct ALCcontext : public al::intrusive_ref<ALCcontext>, ContextBase {
     /**
      * Defers/suspends updates for the given context's listener and sources.
      * This does *NOT* stop mixing, but rather prevents certain property
-     * changes from taking effect. mPropLock must be held when called.
+     * changes from taking effect. mPropLock must be held exclusively when
+     * called.
      */
     void deferUpdates() noexcept { mDeferUpdates = true; }
 
     /**
      * Resumes update processing after being deferred. mPropLock must be held
-     * when called.
+     * exclusively when called.
      */
     void processUpdates()
     {
@@ -420,6 +451,12 @@ private:
 
     int mEaxVersion{}; // Current EAX version.
     bool mEaxNeedsCommit{};
+    /* IDs of the sources with EAX changes waiting to be committed, so a commit
+     * only needs to visit those. If all sources may be affected (e.g. an FX
+     * slot changed), they're all visited instead.
+     */
+    std::vector<ALuint> mEaxDirtySources;
+    bool mEaxAllSourcesDirty{};
     EaxDirtyFlags mEaxDf{}; // Dirty flags for the current EAX version.
     Eax5State mEax123{}; // EAX1/EAX2/EAX3 state.
     Eax4State mEax4{}; // EAX4 state.
@@ -539,6 +576,36 @@ using ContextRef = al::intrusive_ptr<ALCcontext>;
 
 ContextRef GetContextRef() noexcept;
 
+/* The current context for the duration of an AL call. A thread-local context
+ * holds a reference owned by the calling thread, which only that thread can
+ * release (by changing or clearing it), so it's borrowed without touching the
+ * refcount. The process-wide context can be released by another thread at any
+ * time, so that holds its own reference.
+ */
+class CurrentContext {
+    ALCcontext *mContext{};
+    ContextRef mHeldRef;
+
+public:
+    explicit CurrentContext(ALCcontext *context) noexcept : mContext{context} { }
+    explicit CurrentContext(ContextRef&& context) noexcept
+        : mContext{context.get()}, mHeldRef{std::move(context)}
+    { }
+    CurrentContext(const CurrentContext&) = delete;
+    CurrentContext& operator=(const CurrentContext&) = delete;
+
+    explicit operator bool() const noexcept { return mContext != nullptr; }
+    ALCcontext *operator->() const noexcept { return mContext; }
+    ALCcontext *get() const noexcept { return mContext; }
+};
+
+inline CurrentContext GetCurrentContext() noexcept
+{
+    if(ALCcontext *context{ALCcontext::getThreadContext()}) LIKELY
+        return CurrentContext{context};
+    return CurrentContext{GetContextRef()};
+}
+
 void UpdateContextProps(ALCcontext *context);
 
 
@@ -7,6 +7,7 @@
 #include <cstddef>
 #include <numeric>
 
+#include "al/auxeffectslot.h"
 #include "al/buffer.h"
 #include "al/effect.h"
 #include "al/filter.h"
@@ -28,7 +29,9 @@ using voidp = void*;
 } // namespace
 
 
-ALCdevice::ALCdevice(DeviceType type) : DeviceBase{type}
+ALCdevice::ALCdevice(DeviceType type)
+    : DeviceBase{type}, mBufferPool{std::make_unique<BufferStoragePool>()}
+    , mEffectStatePool{std::make_unique<EffectStatePool>()}
 { }
 
 ALCdevice::~ALCdevice()
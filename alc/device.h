@@ -5,6 +5,7 @@
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <string_view>
@@ -23,13 +24,56 @@
 #endif // ALSOFT_EAX
 
 struct BackendBase;
+class BufferStoragePool;
 struct BufferSubList;
+class EffectStatePool;
 struct EffectSubList;
 struct FilterSubList;
+struct HrtfStore;
 
 using uint = unsigned int;
 
 
+/* The state of a background HRTF load. The loader thread enumerates the HRTFs
+ * and loads the first usable one at the given rate, then resets the device if
+ * it's waiting for it.
+ */
+struct HrtfLoader {
+    std::mutex mMutex;
+    uint mRate{0u};
+    bool mDone{false};
+    std::vector<std::string> mList;
+    std::string mName;
+    al::intrusive_ptr<HrtfStore> mHrtf;
+};
+
+
+/* The output format a reset asks of the backend. */
+struct DeviceFormatRequest {
+    uint mFrequency{};
+    DevFmtChannels mChannels{};
+    DevFmtType mType{};
+    uint mAmbiOrder{};
+    DevAmbiLayout mAmbiLayout{};
+    DevAmbiScaling mAmbiScale{};
+    uint mUpdateSize{};
+    uint mBufferSize{};
+    bool mFrequencyRequest{};
+    bool mChannelsRequest{};
+    bool mTypeRequest{};
+
+    [[nodiscard]]
+    auto operator==(const DeviceFormatRequest &rhs) const noexcept -> bool
+    {
+        return mFrequency == rhs.mFrequency && mChannels == rhs.mChannels && mType == rhs.mType
+            && mAmbiOrder == rhs.mAmbiOrder && mAmbiLayout == rhs.mAmbiLayout
+            && mAmbiScale == rhs.mAmbiScale && mUpdateSize == rhs.mUpdateSize
+            && mBufferSize == rhs.mBufferSize && mFrequencyRequest == rhs.mFrequencyRequest
+            && mChannelsRequest == rhs.mChannelsRequest && mTypeRequest == rhs.mTypeRequest;
+    }
+};
+
+
 struct ALCdevice : public al::intrusive_ref<ALCdevice>, DeviceBase {
     /* This lock protects the device state (format, update size, etc) from
      * being from being changed in multiple threads, or being accessed while
@@ -50,6 +94,45 @@ struct ALCdevice : public al::intrusive_ref<ALCdevice>, DeviceBase {
     std::vector<std::string> mHrtfList;
     ALCenum mHrtfStatus{ALC_FALSE};
 
+    /* Loads the HRTF in the background, with the hrtf-async-load option. A
+     * reset that wants HRTF before it's loaded sets mHrtfPending and uses
+     * another stereo encoding meanwhile, and the loader resets the device
+     * again with mHrtfResetAttrs once it's ready.
+     */
+    std::shared_ptr<HrtfLoader> mHrtfLoader;
+    bool mHrtfPending{false};
+    std::vector<int> mHrtfResetAttrs;
+
+    /* The format the backend was last reset with. A reset that asks for the
+     * same format keeps the backend playing, and only rebuilds the mixing
+     * state while the output is held (see DeviceBase::holdOutput).
+     */
+    std::optional<DeviceFormatRequest> mFormatRequest;
+
+    /* The dithering and output limiter settings from the config, as last
+     * applied by a reset or config reload. The app's ALC_OUTPUT_LIMITER_SOFT
+     * request from the last reset overrides the output-limiter option.
+     */
+    struct OutputSettings {
+        float DitherDepth{0.0f};
+        bool DitherShaped{false};
+        std::optional<float> LimiterThreshold;
+        uint LimiterDivisor{1u};
+        bool LimiterTruePeak{false};
+        /* The limiter's delay, in samples, included in FixedLatency. */
+        uint LimiterLookAhead{0u};
+    };
+    OutputSettings mOutputSettings;
+    std::optional<bool> mLimiterRequest;
+
+    /* Captured sample frames held for ALC_SOFTX_capture_map, for backends
+     * that don't keep them in a ring buffer. mCaptureMapped is how many
+     * frames the last map call returned, which limits what can be released.
+     */
+    std::vector<std::byte> mCaptureStage;
+    uint mCaptureStaged{0};
+    uint mCaptureMapped{0};
+
     enum class OutputMode1 : ALCenum {
         Any = ALC_ANY_SOFT,
         Mono = ALC_MONO_SOFT,
@@ -68,14 +151,19 @@ struct ALCdevice : public al::intrusive_ref<ALCdevice>, DeviceBase {
 
     std::atomic<ALCenum> LastError{ALC_NO_ERROR};
 
-    // Map of Buffers for this device
-    std::mutex BufferLock;
+    // Map of Buffers for this device. Held shared to look up and query
+    // buffers, and exclusively to create, delete, or modify them.
+    std::shared_mutex BufferLock;
     std::vector<BufferSubList> BufferList;
+    const std::unique_ptr<BufferStoragePool> mBufferPool;
 
     // Map of Effects for this device
     std::mutex EffectLock;
     std::vector<EffectSubList> EffectList;
 
+    // Spare effect states, for effect slots changing their effect type.
+    const std::unique_ptr<EffectStatePool> mEffectStatePool;
+
     // Map of Filters for this device
     std::mutex FilterLock;
     std::vector<FilterSubList> FilterList;
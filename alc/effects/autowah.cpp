@@ -26,6 +26,10 @@
 #include <cstdlib>
 #include <variant>
 
+#ifdef HAVE_SSE_INTRINSICS
+#include <xmmintrin.h>
+#endif
+
 #include "alc/effects/base.h"
 #include "alnumbers.h"
 #include "alnumeric.h"
@@ -48,6 +52,17 @@ constexpr float MinFreq{20.0f};
 constexpr float MaxFreq{2500.0f};
 constexpr float QFactor{5.0f};
 
+/* The filter coefficients are calculated exactly every EnvStep samples, and
+ * linearly interpolated in between. If the interpolated frequency would be
+ * off by more than MaxInterpError (in radians) anywhere in the step, the
+ * step is calculated exactly instead.
+ */
+constexpr size_t EnvStep{16};
+constexpr float MaxInterpError{0.0001f};
+
+/* The number of channels filtered together. */
+constexpr size_t NumLanes{4};
+
 struct AutowahState final : public EffectState {
     /* Effect parameters */
     float mAttackRate{};
@@ -58,13 +73,16 @@ struct AutowahState final : public EffectState {
     float mBandwidthNorm{};
     float mEnvDelay{};
 
-    /* Filter components derived from the envelope. */
+    /* Filter coefficients derived from the envelope, normalized by a0. */
     struct FilterParam {
-        float cos_w0{};
-        float alpha{};
+        float b0{}, b1{}, b2{};
+        float a1{}, a2{};
     };
     std::array<FilterParam,BufferLineSize> mEnv;
 
+    /* The envelope's filter frequency for each sample. */
+    alignas(16) std::array<float,BufferLineSize> mFreqs{};
+
     struct ChannelData {
         uint mTargetChannel{InvalidChannelIndex};
 
@@ -80,7 +98,10 @@ struct AutowahState final : public EffectState {
     std::array<ChannelData,MaxAmbiChannels> mChans;
 
     /* Effects buffers */
-    alignas(16) FloatBufferLine mBufferOut{};
+    alignas(16) std::array<FloatBufferLine,NumLanes> mBufferOut{};
+
+    void filterChannels(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn,
+        const al::span<ChannelData> chans);
 
 
     void deviceUpdate(const DeviceBase *device, const BufferStorage *buffer) override;
@@ -102,11 +123,7 @@ void AutowahState::deviceUpdate(const DeviceBase*, const BufferStorage*)
     mBandwidthNorm = 0.05f;
     mEnvDelay      = 0.0f;
 
-    for(auto &e : mEnv)
-    {
-        e.cos_w0 = 0.0f;
-        e.alpha = 0.0f;
-    }
+    std::fill(mEnv.begin(), mEnv.end(), FilterParam{});
 
     for(auto &chan : mChans)
     {
@@ -122,7 +139,7 @@ void AutowahState::update(const ContextBase *context, const EffectSlot *slot,
 {
     auto &props = std::get<AutowahProps>(*props_);
     const DeviceBase *device{context->mDevice};
-    const auto frequency = static_cast<float>(device->Frequency);
+    const auto frequency = static_cast<float>(device->mMixFrequency);
 
     const float ReleaseTime{std::clamp(props.ReleaseTime, 0.001f, 1.0f)};
 
@@ -163,61 +180,172 @@ void AutowahState::process(const size_t samplesToDo,
         const float a{(sample > env_delay) ? attack_rate : release_rate};
         env_delay = lerpf(sample, env_delay, a);
 
-        /* Calculate the cos and alpha components for this sample's filter. */
-        const float w0{std::min(bandwidth*env_delay + freq_min, 0.46f) *
-            (al::numbers::pi_v<float>*2.0f)};
-        mEnv[i].cos_w0 = std::cos(w0);
-        mEnv[i].alpha = std::sin(w0)/(2.0f * QFactor);
+        mFreqs[i] = std::min(bandwidth*env_delay + freq_min, 0.46f) *
+            (al::numbers::pi_v<float>*2.0f);
     }
     mEnvDelay = env_delay;
 
-    auto chandata = mChans.begin();
-    for(const auto &insamples : samplesIn)
+    /* Calculate the peaking filter coefficients for a given frequency. Since
+     * the filter changes for each sample, the coefficients are transient and
+     * don't need to be held.
+     */
+    auto calc_params = [res_gain](const float cos_w0, const float alpha) noexcept -> FilterParam
+    {
+        const float a0{1.0f + alpha/res_gain};
+        const float rcp_a0{1.0f / a0};
+        return FilterParam{(1.0f + alpha*res_gain) * rcp_a0, -2.0f*cos_w0 * rcp_a0,
+            (1.0f - alpha*res_gain) * rcp_a0, -2.0f*cos_w0 * rcp_a0,
+            (1.0f - alpha/res_gain) * rcp_a0};
+    };
+    const auto freqs = al::span{mFreqs}.first(samplesToDo);
+    for(size_t base{0u};base < samplesToDo;base += EnvStep)
     {
-        const size_t outidx{chandata->mTargetChannel};
-        if(outidx == InvalidChannelIndex)
+        const size_t todo{std::min(EnvStep, samplesToDo-base)};
+        const auto stepfreqs = freqs.subspan(base, todo);
+
+        /* Check that the frequency is close enough to the line from the start
+         * to the end of the step for the cosine and sine to be interpolated.
+         * The error of interpolating them between exact endpoints is within
+         * the frequency change squared, over 8.
+         */
+        const float w0start{stepfreqs.front()}, w0end{stepfreqs.back()};
+        const float delta{w0end - w0start};
+        bool interp{todo > 2 && delta*delta*0.125f <= MaxInterpError};
+        for(size_t i{1};interp && i < todo-1;++i)
         {
-            ++chandata;
+            const float t{static_cast<float>(i) / static_cast<float>(todo-1)};
+            interp = std::fabs(stepfreqs[i] - (w0start + delta*t)) <= MaxInterpError;
+        }
+
+        const auto params = al::span{mEnv}.subspan(base, todo);
+        if(!interp)
+        {
+            std::transform(stepfreqs.begin(), stepfreqs.end(), params.begin(),
+                [calc_params](const float w0) noexcept
+                { return calc_params(std::cos(w0), std::sin(w0)/(2.0f * QFactor)); });
             continue;
         }
 
-        /* This effectively inlines BiquadFilter_setParams for a peaking
-         * filter and BiquadFilter_processC. The alpha and cosine components
-         * for the filter coefficients were previously calculated with the
-         * envelope. Because the filter changes for each sample, the
-         * coefficients are transient and don't need to be held.
-         */
+        const float cos0{std::cos(w0start)}, cos1{std::cos(w0end)};
+        const float alpha0{std::sin(w0start)/(2.0f * QFactor)};
+        const float alpha1{std::sin(w0end)/(2.0f * QFactor)};
+        for(size_t i{0};i < todo;++i)
+        {
+            const float t{static_cast<float>(i) / static_cast<float>(todo-1)};
+            params[i] = calc_params(lerpf(cos0, cos1, t), lerpf(alpha0, alpha1, t));
+        }
+    }
+
+    for(size_t base{0u};base < samplesIn.size();base += NumLanes)
+    {
+        const size_t numchans{std::min(samplesIn.size()-base, NumLanes)};
+        const auto chans = al::span{mChans}.subspan(base, numchans);
+        if(std::none_of(chans.begin(), chans.end(), [](const ChannelData &chan) noexcept
+            { return chan.mTargetChannel != InvalidChannelIndex; }))
+            continue;
+
+        filterChannels(samplesToDo, samplesIn.subspan(base, numchans), chans);
+
+        /* Now, mix the processed sound data to the output. */
+        for(size_t c{0};c < numchans;++c)
+        {
+            if(const size_t outidx{chans[c].mTargetChannel}; outidx != InvalidChannelIndex)
+                MixSamples(al::span{mBufferOut[c]}.first(samplesToDo), samplesOut[outidx],
+                    chans[c].mCurrentGain, chans[c].mTargetGain, samplesToDo);
+        }
+    }
+}
+
+void AutowahState::filterChannels(const size_t samplesToDo,
+    const al::span<const FloatBufferLine> samplesIn, const al::span<ChannelData> chans)
+{
+    /* This effectively inlines BiquadFilter_processC, using the coefficients
+     * previously calculated with the envelope.
+     */
+#ifdef HAVE_SSE_INTRINSICS
+    /* Each channel goes in its own lane, sharing the same coefficients. */
+    const size_t numchans{chans.size()};
+    alignas(16) std::array<float,NumLanes> vals1{}, vals2{};
+    for(size_t c{0};c < numchans;++c)
+    {
+        vals1[c] = chans[c].mFilter.z1;
+        vals2[c] = chans[c].mFilter.z2;
+    }
+    __m128 z1{_mm_load_ps(vals1.data())};
+    __m128 z2{_mm_load_ps(vals2.data())};
+
+    auto proc_sample = [&z1,&z2](const __m128 input, const FilterParam &params) noexcept
+    {
+        const __m128 output{_mm_add_ps(_mm_mul_ps(input, _mm_set1_ps(params.b0)), z1)};
+        z1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(input, _mm_set1_ps(params.b1)),
+            _mm_mul_ps(output, _mm_set1_ps(params.a1))), z2);
+        z2 = _mm_sub_ps(_mm_mul_ps(input, _mm_set1_ps(params.b2)),
+            _mm_mul_ps(output, _mm_set1_ps(params.a2)));
+        return output;
+    };
+    auto load_lane = [samplesIn,numchans](const size_t c, const size_t i) noexcept -> __m128
+    { return (c < numchans) ? _mm_loadu_ps(&samplesIn[c][i]) : _mm_setzero_ps(); };
+
+    /* Transpose four samples from each channel, so each vector holds one
+     * sample time for all the channels.
+     */
+    size_t i{0u};
+    for(;samplesToDo-i >= 4;i += 4)
+    {
+        __m128 v0{load_lane(0, i)}, v1{load_lane(1, i)};
+        __m128 v2{load_lane(2, i)}, v3{load_lane(3, i)};
+        _MM_TRANSPOSE4_PS(v0, v1, v2, v3);
+        v0 = proc_sample(v0, mEnv[i+0]);
+        v1 = proc_sample(v1, mEnv[i+1]);
+        v2 = proc_sample(v2, mEnv[i+2]);
+        v3 = proc_sample(v3, mEnv[i+3]);
+        _MM_TRANSPOSE4_PS(v0, v1, v2, v3);
+        _mm_store_ps(&mBufferOut[0][i], v0);
+        _mm_store_ps(&mBufferOut[1][i], v1);
+        _mm_store_ps(&mBufferOut[2][i], v2);
+        _mm_store_ps(&mBufferOut[3][i], v3);
+    }
+    for(;i < samplesToDo;++i)
+    {
+        for(size_t c{0};c < numchans;++c)
+            vals1[c] = samplesIn[c][i];
+        _mm_store_ps(vals1.data(), proc_sample(_mm_load_ps(vals1.data()), mEnv[i]));
+        for(size_t c{0};c < numchans;++c)
+            mBufferOut[c][i] = vals1[c];
+    }
+
+    _mm_store_ps(vals1.data(), z1);
+    _mm_store_ps(vals2.data(), z2);
+    for(size_t c{0};c < numchans;++c)
+    {
+        chans[c].mFilter.z1 = vals1[c];
+        chans[c].mFilter.z2 = vals2[c];
+    }
+
+#else
+
+    auto outbuf = mBufferOut.begin();
+    auto chandata = chans.begin();
+    for(const auto &insamples : samplesIn)
+    {
         float z1{chandata->mFilter.z1};
         float z2{chandata->mFilter.z2};
 
         for(size_t i{0u};i < samplesToDo;i++)
         {
-            const float alpha{mEnv[i].alpha};
-            const float cos_w0{mEnv[i].cos_w0};
-
-            const std::array b{
-                1.0f + alpha*res_gain,
-                -2.0f * cos_w0,
-                1.0f - alpha*res_gain};
-            const std::array a{
-                1.0f + alpha/res_gain,
-                -2.0f * cos_w0,
-                1.0f - alpha/res_gain};
-
+            const FilterParam &params = mEnv[i];
             const float input{insamples[i]};
-            const float output{input*(b[0]/a[0]) + z1};
-            z1 = input*(b[1]/a[0]) - output*(a[1]/a[0]) + z2;
-            z2 = input*(b[2]/a[0]) - output*(a[2]/a[0]);
-            mBufferOut[i] = output;
+            const float output{input*params.b0 + z1};
+            z1 = input*params.b1 - output*params.a1 + z2;
+            z2 = input*params.b2 - output*params.a2;
+            (*outbuf)[i] = output;
         }
         chandata->mFilter.z1 = z1;
         chandata->mFilter.z2 = z2;
-
-        /* Now, mix the processed sound data to the output. */
-        MixSamples(al::span{mBufferOut}.first(samplesToDo), samplesOut[outidx],
-            chandata->mCurrentGain, chandata->mTargetGain, samplesToDo);
         ++chandata;
+        ++outbuf;
     }
+#endif
 }
 
 
@@ -9,6 +9,22 @@
  */
 inline float ReverbBoost{1.0f};
 
+/* This is a user config option for the number of feedback lines used by the
+ * reverb effect's late reverb.
+ */
+inline unsigned int ReverbLateLines{4u};
+
+/* This is a user config option for the divisor of the device sample rate the
+ * reverb effect is processed at.
+ */
+inline unsigned int ReverbRateDivisor{1u};
+
+/* These are user config options for the pitch shifter effect's STFT size, and
+ * whether it uses faster approximations for its phase calculations.
+ */
+inline unsigned int PshifterStftSize{1024u};
+inline bool PshifterFastMath{false};
+
 
 EffectStateFactory *NullStateFactory_getFactory();
 EffectStateFactory *ReverbStateFactory_getFactory();
@@ -27,4 +43,6 @@ EffectStateFactory *DedicatedStateFactory_getFactory();
 
 EffectStateFactory *ConvolutionStateFactory_getFactory();
 
+EffectStateFactory *SourceGroupStateFactory_getFactory();
+
 #endif /* EFFECTS_BASE_H */
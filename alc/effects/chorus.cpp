@@ -28,6 +28,12 @@
 #include <variant>
 #include <vector>
 
+#ifdef HAVE_SSE_INTRINSICS
+#include <xmmintrin.h>
+#elif defined(HAVE_NEON)
+#include <arm_neon.h>
+#endif
+
 #include "alc/effects/base.h"
 #include "alnumbers.h"
 #include "alnumeric.h"
@@ -57,9 +63,30 @@ constexpr auto rcoeffs_pw = CalcDirectionCoeffs(std::array{ 1.0f, 0.0f, 0.0f});
 constexpr auto lcoeffs_nrml = CalcDirectionCoeffs(std::array{-inv_sqrt2, 0.0f, inv_sqrt2});
 constexpr auto rcoeffs_nrml = CalcDirectionCoeffs(std::array{ inv_sqrt2, 0.0f, inv_sqrt2});
 
+/* The number of samples the delay line is extended by, mirroring the start of
+ * the line, so the four samples for a tap can be read contiguously.
+ */
+constexpr size_t DelayPadding{3};
+
+/* The cubic filter coefficients rearranged so each phase has the four
+ * coefficients together, in increasing sample order.
+ */
+struct TapFilter {
+    alignas(16) std::array<std::array<float,4>,CubicFilter::sTableSteps> mCoeffs{};
+
+    TapFilter()
+    {
+        for(size_t i{0};i < CubicFilter::sTableSteps;++i)
+            mCoeffs[i] = {gCubicTable.getCoeff3(i), gCubicTable.getCoeff2(i),
+                gCubicTable.getCoeff1(i), gCubicTable.getCoeff0(i)};
+    }
+};
+const TapFilter gTapFilter{};
+
 
 struct ChorusState final : public EffectState {
     std::vector<float> mDelayBuffer;
+    size_t mDelayMask{0};
     uint mOffset{0};
 
     uint mLfoOffset{0};
@@ -86,6 +113,8 @@ struct ChorusState final : public EffectState {
     float mDepth{0.0f};
     float mFeedback{0.0f};
 
+    template<typename T>
+    void calcDelays(const size_t todo, T&& gen_lfo);
     void calcTriangleDelays(const size_t todo);
     void calcSinusoidDelays(const size_t todo);
 
@@ -99,16 +128,19 @@ struct ChorusState final : public EffectState {
         const EffectTarget target) final;
     void process(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn,
         const al::span<FloatBufferLine> samplesOut) final;
+    [[nodiscard]] auto inputChannels() const noexcept -> size_t final { return 1; }
 };
 
 
 void ChorusState::deviceUpdate(const DeviceBase *Device, const BufferStorage*)
 {
     constexpr auto MaxDelay = std::max(ChorusMaxDelay, FlangerMaxDelay);
-    const auto frequency = static_cast<float>(Device->Frequency);
+    const auto frequency = static_cast<float>(Device->mMixFrequency);
     const size_t maxlen{NextPowerOf2(float2uint(MaxDelay*2.0f*frequency) + 1u)};
-    if(maxlen != mDelayBuffer.size())
-        decltype(mDelayBuffer)(maxlen).swap(mDelayBuffer);
+    if(maxlen+DelayPadding != mDelayBuffer.size())
+        decltype(mDelayBuffer)(maxlen+DelayPadding).swap(mDelayBuffer);
+    mDelayMask = maxlen - 1;
+    setMemoryUsage(Device->mMemory, mDelayBuffer.size()*sizeof(float));
 
     std::fill(mDelayBuffer.begin(), mDelayBuffer.end(), 0.0f);
     for(auto &e : mGains)
@@ -128,7 +160,7 @@ void ChorusState::update(const ContextBase *context, const EffectSlot *slot,
      * delay and depth to allow enough padding for resampling.
      */
     const DeviceBase *device{context->mDevice};
-    const auto frequency = static_cast<float>(device->Frequency);
+    const auto frequency = static_cast<float>(device->mMixFrequency);
 
     mWaveform = props.Waveform;
 
@@ -188,121 +220,134 @@ void ChorusState::update(const ContextBase *context, const EffectSlot *slot,
 }
 
 
-void ChorusState::calcTriangleDelays(const size_t todo)
+/* Generates the modulated delays for the left and right outputs together. The
+ * right output's LFO is displaced from the left, so each run goes until either
+ * side's LFO wraps around.
+ */
+template<typename T>
+void ChorusState::calcDelays(const size_t todo, T&& gen_lfo)
 {
     const uint lfo_range{mLfoRange};
-    const float lfo_scale{mLfoScale};
-    const float depth{mDepth};
-    const int delay{mDelay};
+    uint loffset{mLfoOffset};
+    uint roffset{(mLfoOffset+mLfoDisp) % lfo_range};
+    ASSUME(lfo_range > loffset);
+    ASSUME(lfo_range > roffset);
 
-    auto gen_lfo = [lfo_scale,depth,delay](const uint offset) -> uint
-    {
-        const float offset_norm{static_cast<float>(offset) * lfo_scale};
-        return static_cast<uint>(fastf2i((1.0f-std::abs(2.0f-offset_norm)) * depth) + delay);
-    };
-
-    uint offset{mLfoOffset};
-    ASSUME(lfo_range > offset);
-    auto ldelays = mModDelays[0].begin();
+    const auto ldelays = al::span{mModDelays[0]}.first(todo);
+    const auto rdelays = al::span{mModDelays[1]}.first(todo);
     for(size_t i{0};i < todo;)
     {
-        const size_t rem{std::min(todo-i, size_t{lfo_range-offset})};
-        ldelays = std::generate_n(ldelays, rem, [&offset,gen_lfo] { return gen_lfo(offset++); });
-        if(offset == lfo_range) offset = 0;
-        i += rem;
-    }
-
-    offset = (mLfoOffset+mLfoDisp) % lfo_range;
-    auto rdelays = mModDelays[1].begin();
-    for(size_t i{0};i < todo;)
-    {
-        const size_t rem{std::min(todo-i, size_t{lfo_range-offset})};
-        rdelays = std::generate_n(rdelays, rem, [&offset,gen_lfo] { return gen_lfo(offset++); });
-        if(offset == lfo_range) offset = 0;
+        const size_t rem{std::min({todo-i, size_t{lfo_range-loffset},
+            size_t{lfo_range-roffset}})};
+        for(size_t j{0};j < rem;++j)
+        {
+            ldelays[i+j] = gen_lfo(loffset+static_cast<uint>(j));
+            rdelays[i+j] = gen_lfo(roffset+static_cast<uint>(j));
+        }
+        loffset += static_cast<uint>(rem);
+        roffset += static_cast<uint>(rem);
+        if(loffset == lfo_range) loffset = 0;
+        if(roffset == lfo_range) roffset = 0;
         i += rem;
     }
 
-    mLfoOffset = static_cast<uint>(mLfoOffset+todo) % lfo_range;
+    mLfoOffset = loffset;
 }
 
-void ChorusState::calcSinusoidDelays(const size_t todo)
+void ChorusState::calcTriangleDelays(const size_t todo)
 {
-    const uint lfo_range{mLfoRange};
     const float lfo_scale{mLfoScale};
     const float depth{mDepth};
     const int delay{mDelay};
 
-    auto gen_lfo = [lfo_scale,depth,delay](const uint offset) -> uint
+    calcDelays(todo, [lfo_scale,depth,delay](const uint offset) -> uint
     {
         const float offset_norm{static_cast<float>(offset) * lfo_scale};
-        return static_cast<uint>(fastf2i(std::sin(offset_norm)*depth) + delay);
-    };
+        return static_cast<uint>(fastf2i((1.0f-std::abs(2.0f-offset_norm)) * depth) + delay);
+    });
+}
 
-    uint offset{mLfoOffset};
-    ASSUME(lfo_range > offset);
-    auto ldelays = mModDelays[0].begin();
-    for(size_t i{0};i < todo;)
-    {
-        const size_t rem{std::min(todo-i, size_t{lfo_range-offset})};
-        ldelays = std::generate_n(ldelays, rem, [&offset,gen_lfo] { return gen_lfo(offset++); });
-        if(offset == lfo_range) offset = 0;
-        i += rem;
-    }
+void ChorusState::calcSinusoidDelays(const size_t todo)
+{
+    const float lfo_scale{mLfoScale};
+    const float depth{mDepth};
+    const int delay{mDelay};
 
-    offset = (mLfoOffset+mLfoDisp) % lfo_range;
-    auto rdelays = mModDelays[1].begin();
-    for(size_t i{0};i < todo;)
+    calcDelays(todo, [lfo_scale,depth,delay](const uint offset) -> uint
     {
-        const size_t rem{std::min(todo-i, size_t{lfo_range-offset})};
-        rdelays = std::generate_n(rdelays, rem, [&offset,gen_lfo] { return gen_lfo(offset++); });
-        if(offset == lfo_range) offset = 0;
-        i += rem;
-    }
-
-    mLfoOffset = static_cast<uint>(mLfoOffset+todo) % lfo_range;
+        const float offset_norm{static_cast<float>(offset) * lfo_scale};
+        return static_cast<uint>(fastf2i(std::sin(offset_norm)*depth) + delay);
+    });
 }
 
 void ChorusState::process(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn, const al::span<FloatBufferLine> samplesOut)
 {
     const auto delaybuf = al::span{mDelayBuffer};
-    const size_t bufmask{delaybuf.size()-1};
+    const size_t bufmask{mDelayMask};
     const float feedback{mFeedback};
     const uint avgdelay{(static_cast<uint>(mDelay) + MixerFracHalf) >> MixerFracBits};
-    uint offset{mOffset};
+    const size_t offset{mOffset};
 
     if(mWaveform == ChorusWaveform::Sinusoid)
         calcSinusoidDelays(samplesToDo);
     else /*if(mWaveform == ChorusWaveform::Triangle)*/
         calcTriangleDelays(samplesToDo);
 
+    /* Feed the delay line input, accumulating feedback from the average delay
+     * of the taps. The taps are always more than MaxResamplerEdge-1 samples
+     * behind the input, so they never read samples written here before their
+     * time, and all the input can go in ahead of the taps.
+     */
+    const auto input = al::span{samplesIn[0]}.first(samplesToDo);
+    for(size_t i{0u};i < samplesToDo;++i)
+    {
+        const size_t pos{(offset+i) & bufmask};
+        delaybuf[pos] = input[i];
+        delaybuf[pos] += delaybuf[(pos-avgdelay) & bufmask] * feedback;
+        if(pos < DelayPadding)
+            delaybuf[bufmask+1 + pos] = delaybuf[pos];
+    }
+
+    /* Tap the delay line for the left and right outputs together. Each tap is
+     * the cubic filter applied to the four samples around the delay.
+     */
     const auto ldelays = al::span{mModDelays[0]};
     const auto rdelays = al::span{mModDelays[1]};
     const auto lbuffer = al::span{mBuffer[0]};
     const auto rbuffer = al::span{mBuffer[1]};
+    auto tap_pos = [bufmask](const size_t pos, const uint moddelay) noexcept -> size_t
+    { return (pos - (moddelay >> gCubicTable.sTableBits) - 2) & bufmask; };
     for(size_t i{0u};i < samplesToDo;++i)
     {
-        // Feed the buffer's input first (necessary for delays < 1).
-        delaybuf[offset&bufmask] = samplesIn[0][i];
-
-        // Tap for the left output.
-        size_t delay{offset - (ldelays[i] >> gCubicTable.sTableBits)};
-        size_t phase{ldelays[i] & gCubicTable.sTableMask};
-        lbuffer[i] = delaybuf[(delay+1) & bufmask]*gCubicTable.getCoeff0(phase) +
-            delaybuf[(delay  ) & bufmask]*gCubicTable.getCoeff1(phase) +
-            delaybuf[(delay-1) & bufmask]*gCubicTable.getCoeff2(phase) +
-            delaybuf[(delay-2) & bufmask]*gCubicTable.getCoeff3(phase);
-
-        // Tap for the right output.
-        delay = offset - (rdelays[i] >> gCubicTable.sTableBits);
-        phase = rdelays[i] & gCubicTable.sTableMask;
-        rbuffer[i] = delaybuf[(delay+1) & bufmask]*gCubicTable.getCoeff0(phase) +
-            delaybuf[(delay  ) & bufmask]*gCubicTable.getCoeff1(phase) +
-            delaybuf[(delay-1) & bufmask]*gCubicTable.getCoeff2(phase) +
-            delaybuf[(delay-2) & bufmask]*gCubicTable.getCoeff3(phase);
-
-        // Accumulate feedback from the average delay of the taps.
-        delaybuf[offset&bufmask] += delaybuf[(offset-avgdelay) & bufmask] * feedback;
-        ++offset;
+        const auto lsrc = delaybuf.subspan(tap_pos(offset+i, ldelays[i])).first<4>();
+        const auto rsrc = delaybuf.subspan(tap_pos(offset+i, rdelays[i])).first<4>();
+        const auto &lcoeffs = gTapFilter.mCoeffs[ldelays[i] & gCubicTable.sTableMask];
+        const auto &rcoeffs = gTapFilter.mCoeffs[rdelays[i] & gCubicTable.sTableMask];
+#ifdef HAVE_SSE_INTRINSICS
+        const __m128 l4{_mm_mul_ps(_mm_loadu_ps(lsrc.data()), _mm_load_ps(lcoeffs.data()))};
+        const __m128 r4{_mm_mul_ps(_mm_loadu_ps(rsrc.data()), _mm_load_ps(rcoeffs.data()))};
+        /* [l0+l2, r0+r2, l1+l3, r1+r3] */
+        __m128 lr{_mm_add_ps(_mm_unpacklo_ps(l4, r4), _mm_unpackhi_ps(l4, r4))};
+        lr = _mm_add_ps(lr, _mm_movehl_ps(lr, lr));
+        lbuffer[i] = _mm_cvtss_f32(lr);
+        rbuffer[i] = _mm_cvtss_f32(_mm_shuffle_ps(lr, lr, _MM_SHUFFLE(1, 1, 1, 1)));
+
+#elif defined(HAVE_NEON)
+
+        const float32x4_t l4{vmulq_f32(vld1q_f32(lsrc.data()), vld1q_f32(lcoeffs.data()))};
+        const float32x4_t r4{vmulq_f32(vld1q_f32(rsrc.data()), vld1q_f32(rcoeffs.data()))};
+        const float32x2_t lr{vpadd_f32(vadd_f32(vget_low_f32(l4), vget_high_f32(l4)),
+            vadd_f32(vget_low_f32(r4), vget_high_f32(r4)))};
+        lbuffer[i] = vget_lane_f32(lr, 0);
+        rbuffer[i] = vget_lane_f32(lr, 1);
+
+#else
+
+        lbuffer[i] = lsrc[0]*lcoeffs[0] + lsrc[1]*lcoeffs[1] + lsrc[2]*lcoeffs[2]
+            + lsrc[3]*lcoeffs[3];
+        rbuffer[i] = rsrc[0]*rcoeffs[0] + rsrc[1]*rcoeffs[1] + rsrc[2]*rcoeffs[2]
+            + rsrc[3]*rcoeffs[3];
+#endif
     }
 
     MixSamples(lbuffer.first(samplesToDo), samplesOut, mGains[0].Current, mGains[0].Target,
@@ -310,7 +355,7 @@ void ChorusState::process(const size_t samplesToDo, const al::span<const FloatBu
     MixSamples(rbuffer.first(samplesToDo), samplesOut, mGains[1].Current, mGains[1].Target,
         samplesToDo, 0);
 
-    mOffset = offset;
+    mOffset = static_cast<uint>(offset + samplesToDo);
 }
 
 
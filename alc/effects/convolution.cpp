@@ -8,8 +8,12 @@
 #include <complex>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <exception>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <variant>
 
@@ -29,12 +33,14 @@
 #include "core/bufferline.h"
 #include "core/buffer_storage.h"
 #include "core/context.h"
+#include "core/convolution_offload.h"
 #include "core/devformat.h"
 #include "core/device.h"
 #include "core/effects/base.h"
 #include "core/effectslot.h"
 #include "core/filters/splitter.h"
 #include "core/fmt_traits.h"
+#include "core/logging.h"
 #include "core/mixer.h"
 #include "core/uhjfilter.h"
 #include "intrusive_ptr.h"
@@ -79,6 +85,15 @@ namespace {
  * segment is applied directly in the time-domain as the samples come in. Once
  * enough have been retrieved, the FFT is applied on the input and it's paired
  * with the remaining (FFT'd) filter segments for processing.
+ *
+ * Long impulse responses would need a great many 128-sample segments, so the
+ * tail of those is instead split into larger segments (the "tail size") that
+ * are processed the same way with a larger FFT, once per tail-sized input
+ * block. The 128-sample segments cover the first two tail sizes' worth of the
+ * response, so the tail's output for an input block isn't needed until a full
+ * block after its input is complete. This leaves a full block of time for the
+ * tail processing, which is spread out over each 128-sample update in that
+ * time, to avoid large spikes of work.
  */
 
 
@@ -114,9 +129,11 @@ void LoadSamples(const al::span<float> dst, const std::byte *src, const size_t c
     HANDLE_FMT(FmtDouble);
     HANDLE_FMT(FmtMulaw);
     HANDLE_FMT(FmtAlaw);
+    HANDLE_FMT(FmtHalf);
     /* FIXME: Handle ADPCM decoding here. */
     case FmtIMA4:
     case FmtMSADPCM:
+    case FmtIMA2:
         std::fill(dst.begin(), dst.end(), 0.0f);
         break;
     }
@@ -167,6 +184,10 @@ using complex_f = std::complex<float>;
 constexpr size_t ConvolveUpdateSize{256};
 constexpr size_t ConvolveUpdateSamples{ConvolveUpdateSize / 2};
 
+/* The range of tail sizes to consider for long impulse responses. */
+constexpr size_t MinTailSize{1024};
+constexpr size_t MaxTailSize{16384};
+
 
 void apply_fir(al::span<float> dst, const al::span<const float> input, const al::span<const float,ConvolveUpdateSamples> filter)
 {
@@ -216,6 +237,308 @@ void apply_fir(al::span<float> dst, const al::span<const float> input, const al:
 }
 
 
+/* The filter spectra for an impulse response, transformed for the device. This
+ * is shared between all effect slots convolving with the same buffer, as only
+ * the input history and output need to be kept separately for each.
+ */
+struct ConvolutionFilter {
+    size_t mNumChannels{0};
+    size_t mNumConvolveSegs{0};
+    size_t mTailSize{0};
+    size_t mNumTailSegs{0};
+
+    /* Each channel's first segment, reversed to apply as a FIR filter. */
+    al::vector<std::array<float,ConvolveUpdateSamples>,16> mFir;
+    /* Each channel's 128-sample segment responses. */
+    al::vector<float,16> mHead;
+    /* Each channel's tail segment responses, if there's a tail. */
+    al::vector<float,16> mTail;
+};
+
+struct ConvolutionFilterKey {
+    const std::byte *mData;
+    uint64_t mHash;
+    uint mSampleLen;
+    uint mSampleRate;
+    uint mDeviceRate;
+    FmtChannels mChannels;
+    FmtType mType;
+    uint mAmbiOrder;
+
+    friend bool operator==(const ConvolutionFilterKey &lhs, const ConvolutionFilterKey &rhs)
+        noexcept
+    {
+        return lhs.mData == rhs.mData && lhs.mHash == rhs.mHash
+            && lhs.mSampleLen == rhs.mSampleLen && lhs.mSampleRate == rhs.mSampleRate
+            && lhs.mDeviceRate == rhs.mDeviceRate && lhs.mChannels == rhs.mChannels
+            && lhs.mType == rhs.mType && lhs.mAmbiOrder == rhs.mAmbiOrder;
+    }
+};
+
+/* Buffer storage gets reused in place when a buffer is reloaded with the same
+ * size, so hash the sample data to make sure a cached filter is still for the
+ * same impulse response.
+ */
+uint64_t HashSampleData(const al::span<const std::byte> data) noexcept
+{
+    uint64_t hash{0xcbf29ce484222325_u64};
+    size_t i{0};
+    for(;i+8 <= data.size();i += 8)
+    {
+        uint64_t word{};
+        std::memcpy(&word, &data[i], sizeof(word));
+        hash = (hash^word) * 0x100000001b3_u64;
+    }
+    for(;i < data.size();++i)
+        hash = (hash^std::to_integer<uint64_t>(data[i])) * 0x100000001b3_u64;
+    return hash;
+}
+
+struct ConvolutionFilterCacheEntry {
+    ConvolutionFilterKey mKey;
+    std::weak_ptr<const ConvolutionFilter> mFilter;
+};
+std::mutex ConvolutionFilterCacheLock;
+std::vector<ConvolutionFilterCacheEntry> ConvolutionFilterCache;
+
+
+auto CreateConvolutionFilter(const DeviceBase *device, const BufferStorage *buffer,
+    const FmtChannels channels, const uint ambiOrder) -> std::shared_ptr<ConvolutionFilter>
+{
+    using UhjDecoderType = UhjDecoder<512>;
+    static constexpr auto DecoderPadding = UhjDecoderType::sInputPadding;
+
+    const auto realChannels = buffer->channelsFromFmt();
+    const auto numChannels = (channels == FmtUHJ2) ? 3u : ChannelsFromFmt(channels, ambiOrder);
+
+    auto filter = std::make_shared<ConvolutionFilter>();
+    filter->mNumChannels = numChannels;
+
+    /* The impulse response needs to have the same sample rate as the input and
+     * output. The bsinc24 resampler is decent, but there is high-frequency
+     * attenuation that some people may be able to pick up on. Since this is
+     * called very infrequently, go ahead and use the polyphase resampler.
+     */
+    PPhaseResampler resampler;
+    if(device->mMixFrequency != buffer->mSampleRate)
+        resampler.init(buffer->mSampleRate, device->mMixFrequency);
+    const auto resampledCount = static_cast<uint>(
+        (uint64_t{buffer->mSampleLen}*device->mMixFrequency+(buffer->mSampleRate-1)) /
+        buffer->mSampleRate);
+
+    /* Calculate the number of segments needed to hold the impulse response and
+     * the input history (rounded up), and allocate them. Exclude one segment
+     * which gets applied as a time-domain FIR filter. Make sure at least one
+     * segment is allocated to simplify handling.
+     */
+    size_t numConvolveSegs{(resampledCount+(ConvolveUpdateSamples-1)) / ConvolveUpdateSamples};
+    numConvolveSegs = std::max(numConvolveSegs, 2_uz) - 1_uz;
+
+    /* For long impulse responses, find the tail size that needs the fewest
+     * complex multiplies per sample. Each 128-sample segment and each tail
+     * segment costs about the same per sample, and the tail's FFTs cost about
+     * as much as a couple more segments.
+     */
+    size_t tailSize{0};
+    size_t numTailSegs{0};
+    size_t bestcost{numConvolveSegs};
+    for(size_t tailsize{MinTailSize};tailsize <= MaxTailSize;tailsize *= 2)
+    {
+        if(resampledCount < tailsize*4)
+            break;
+        const size_t headsegs{tailsize*2/ConvolveUpdateSamples - 1};
+        const size_t tailsegs{(resampledCount - tailsize*2 + (tailsize-1)) / tailsize};
+        const size_t cost{headsegs + tailsegs + 2};
+        if(cost < bestcost)
+        {
+            bestcost = cost;
+            tailSize = tailsize;
+            numTailSegs = tailsegs;
+        }
+    }
+    if(tailSize > 0)
+        numConvolveSegs = tailSize*2/ConvolveUpdateSamples - 1;
+
+    filter->mNumConvolveSegs = numConvolveSegs;
+    filter->mTailSize = tailSize;
+    filter->mNumTailSegs = numTailSegs;
+    filter->mFir.resize(numChannels, {});
+    filter->mHead.resize(numConvolveSegs * ConvolveUpdateSize * numChannels, 0.0f);
+    filter->mTail.resize(numTailSegs * tailSize*2 * numChannels, 0.0f);
+
+    /* Load the samples from the buffer. */
+    const size_t srclinelength{RoundUp(buffer->mSampleLen+DecoderPadding, 16)};
+    auto srcsamples = std::vector<float>(srclinelength * numChannels);
+    std::fill(srcsamples.begin(), srcsamples.end(), 0.0f);
+    for(size_t c{0};c < numChannels && c < realChannels;++c)
+        LoadSamples(al::span{srcsamples}.subspan(srclinelength*c, buffer->mSampleLen),
+            buffer->mData.data(), c, realChannels, buffer->mType);
+
+    if(IsUHJ(channels))
+    {
+        auto decoder = std::make_unique<UhjDecoderType>();
+        std::array<float*,4> samples{};
+        for(size_t c{0};c < numChannels;++c)
+            samples[c] = al::to_address(srcsamples.begin() + ptrdiff_t(srclinelength*c));
+        decoder->decode({samples.data(), numChannels}, buffer->mSampleLen, buffer->mSampleLen);
+    }
+
+    const PFFFTSetup fft{ConvolveUpdateSize, PFFFT_REAL};
+    const PFFFTSetup tailfft{tailSize ? PFFFTSetup{static_cast<uint>(tailSize*2), PFFFT_REAL}
+        : PFFFTSetup{}};
+
+    /* Resample each channel to match the device. The channels are
+     * independent, so with multiple channels to resample, the others are done
+     * on their own threads while this one does the first.
+     */
+    auto ressamples = std::vector<double>(size_t{resampledCount}*numChannels);
+    auto resample_channel = [&](const size_t c)
+    {
+        auto bufsamples = al::span{srcsamples}.subspan(srclinelength*c, buffer->mSampleLen);
+        auto chansamples = al::span{ressamples}.subspan(size_t{resampledCount}*c,
+            resampledCount);
+        if(!resampler)
+        {
+            std::copy(bufsamples.cbegin(), bufsamples.cend(), chansamples.begin());
+            return;
+        }
+        const auto restmp = std::vector<double>(bufsamples.cbegin(), bufsamples.cend());
+        resampler.process(restmp, chansamples);
+    };
+    {
+        std::vector<std::thread> threads;
+        size_t c{1};
+        if(resampler)
+        {
+            try {
+                for(;c < numChannels;++c)
+                    threads.emplace_back(resample_channel, c);
+            }
+            catch(std::exception &e) {
+                WARN("Failed to start resampler thread: %s\n", e.what());
+            }
+        }
+        resample_channel(0);
+        for(;c < numChannels;++c)
+            resample_channel(c);
+        std::for_each(threads.begin(), threads.end(), std::mem_fn(&std::thread::join));
+    }
+    auto ffttmp = al::vector<float,16>(ConvolveUpdateSize);
+    auto fftbuffer = std::vector<std::complex<double>>(ConvolveUpdateSize);
+
+    auto tailfftbuffer = std::vector<std::complex<double>>(tailSize*2);
+    auto tailffttmp = al::vector<float,16>(tailSize*2);
+
+    auto filteriter = filter->mHead.begin();
+    auto tailfilteriter = filter->mTail.begin();
+    for(size_t c{0};c < numChannels;++c)
+    {
+        const auto chansamples = al::span<const double>{ressamples}.subspan(
+            size_t{resampledCount}*c, resampledCount);
+
+        /* Store the first segment's samples in reverse in the time-domain, to
+         * apply as a FIR filter.
+         */
+        const size_t first_size{std::min(size_t{resampledCount}, ConvolveUpdateSamples)};
+        auto sampleseg = chansamples.first(first_size);
+        std::transform(sampleseg.cbegin(), sampleseg.cend(), filter->mFir[c].rbegin(),
+            [](const double d) noexcept -> float { return static_cast<float>(d); });
+
+        size_t done{first_size};
+        for(size_t s{0};s < numConvolveSegs;++s)
+        {
+            const size_t todo{std::min(resampledCount-done, ConvolveUpdateSamples)};
+            sampleseg = chansamples.subspan(done, todo);
+
+            /* Apply a double-precision forward FFT for more precise frequency
+             * measurements.
+             */
+            auto iter = std::copy(sampleseg.cbegin(), sampleseg.cend(), fftbuffer.begin());
+            done += todo;
+            std::fill(iter, fftbuffer.end(), std::complex<double>{});
+            forward_fft(al::span{fftbuffer});
+
+            /* Convert to, and pack in, a float buffer for PFFFT. Note that the
+             * first bin stores the real component of the half-frequency bin in
+             * the imaginary component. Also scale the FFT by its length so the
+             * iFFT'd output will be normalized.
+             */
+            static constexpr float fftscale{1.0f / float{ConvolveUpdateSize}};
+            for(size_t i{0};i < ConvolveUpdateSamples;++i)
+            {
+                ffttmp[i*2    ] = static_cast<float>(fftbuffer[i].real()) * fftscale;
+                ffttmp[i*2 + 1] = static_cast<float>((i == 0) ?
+                    fftbuffer[ConvolveUpdateSamples].real() : fftbuffer[i].imag()) * fftscale;
+            }
+            /* Reorder backward to make it suitable for pffft_zconvolve and the
+             * subsequent pffft_transform(..., PFFFT_BACKWARD).
+             */
+            fft.zreorder(ffttmp.data(), al::to_address(filteriter), PFFFT_BACKWARD);
+            filteriter += ConvolveUpdateSize;
+        }
+
+        /* Prepare the tail segments the same way, with the larger FFT. */
+        for(size_t s{0};s < numTailSegs;++s)
+        {
+            const size_t todo{std::min(resampledCount-done, tailSize)};
+            sampleseg = chansamples.subspan(done, todo);
+
+            auto iter = std::copy(sampleseg.cbegin(), sampleseg.cend(), tailfftbuffer.begin());
+            done += todo;
+            std::fill(iter, tailfftbuffer.end(), std::complex<double>{});
+            forward_fft(al::span{tailfftbuffer});
+
+            const float fftscale{1.0f / static_cast<float>(tailSize*2)};
+            for(size_t i{0};i < tailSize;++i)
+            {
+                tailffttmp[i*2    ] = static_cast<float>(tailfftbuffer[i].real()) * fftscale;
+                tailffttmp[i*2 + 1] = static_cast<float>((i == 0) ?
+                    tailfftbuffer[tailSize].real() : tailfftbuffer[i].imag()) * fftscale;
+            }
+            tailfft.zreorder(tailffttmp.data(), al::to_address(tailfilteriter), PFFFT_BACKWARD);
+            tailfilteriter += ptrdiff_t(tailSize*2);
+        }
+    }
+
+    return filter;
+}
+
+/* Gets the filter for the buffer at the device's sample rate, reusing one
+ * another effect slot already made if it's still around.
+ */
+auto GetConvolutionFilter(const DeviceBase *device, const BufferStorage *buffer,
+    const FmtChannels channels, const uint ambiOrder) -> std::shared_ptr<const ConvolutionFilter>
+{
+    const ConvolutionFilterKey key{buffer->mData.data(), HashSampleData(buffer->mData),
+        buffer->mSampleLen, buffer->mSampleRate, device->mMixFrequency, channels, buffer->mType,
+        ambiOrder};
+
+    std::lock_guard<std::mutex> cachelock{ConvolutionFilterCacheLock};
+    auto expired = [](const ConvolutionFilterCacheEntry &entry) noexcept -> bool
+    { return entry.mFilter.expired(); };
+    ConvolutionFilterCache.erase(std::remove_if(ConvolutionFilterCache.begin(),
+        ConvolutionFilterCache.end(), expired), ConvolutionFilterCache.end());
+
+    auto iter = std::find_if(ConvolutionFilterCache.cbegin(), ConvolutionFilterCache.cend(),
+        [&key](const ConvolutionFilterCacheEntry &entry) noexcept -> bool
+        { return entry.mKey == key; });
+    if(iter != ConvolutionFilterCache.cend())
+    {
+        if(auto filter = iter->mFilter.lock())
+        {
+            TRACE("Reusing convolution filter for %u samples at %uhz\n", key.mSampleLen,
+                key.mDeviceRate);
+            return filter;
+        }
+    }
+
+    auto filter = std::shared_ptr<const ConvolutionFilter>{CreateConvolutionFilter(device,
+        buffer, channels, ambiOrder)};
+    ConvolutionFilterCache.emplace_back(ConvolutionFilterCacheEntry{key, filter});
+    return filter;
+}
+
+
 struct ConvolutionState final : public EffectState {
     FmtChannels mChannels{};
     AmbiLayout mAmbiLayout{};
@@ -224,7 +547,7 @@ struct ConvolutionState final : public EffectState {
 
     size_t mFifoPos{0};
     alignas(16) std::array<float,ConvolveUpdateSamples*2> mInput{};
-    al::vector<std::array<float,ConvolveUpdateSamples>,16> mFilter;
+    std::shared_ptr<const ConvolutionFilter> mFilter;
     al::vector<std::array<float,ConvolveUpdateSamples*2>,16> mOutput;
 
     PFFFTSetup mFft{};
@@ -234,6 +557,38 @@ struct ConvolutionState final : public EffectState {
     size_t mCurrentSegment{0};
     size_t mNumConvolveSegs{0};
 
+    /* Larger segments for the tail of long impulse responses. A tail size of
+     * 0 means there's no separate tail. mTailComplex holds the input history,
+     * mTailAccum holds each channel's accumulation buffer, and mTailOutput
+     * holds each channel's current output, next output, and overflow blocks.
+     */
+    size_t mTailSize{0};
+    size_t mNumTailSegs{0};
+    size_t mTailPos{0};
+    size_t mTailCurrentSeg{0};
+    size_t mTailWorkDone{0};
+    PFFFTSetup mTailFft{};
+    al::vector<float,16> mTailInput;
+    al::vector<float,16> mTailWorkBuffer;
+    al::vector<float,16> mTailComplex;
+    al::vector<float,16> mTailAccum;
+    al::vector<float,16> mTailOutput;
+
+    /* The offload thread for the tail, if the device has one, and whether it
+     * was given the pending tail block. Each channel gets its own work buffer
+     * when offloading, so the thread and the mixer can process different
+     * channels at once.
+     */
+    struct TailJob final : public OffloadJob {
+        ConvolutionState &mState;
+
+        explicit TailJob(ConvolutionState &state) noexcept : mState{state} { }
+        void processItem(size_t item) noexcept override { mState.processTailChannel(item); }
+    };
+    ConvolutionOffload *mOffload{nullptr};
+    bool mTailOffloaded{false};
+    TailJob mTailJob{*this};
+
     struct ChannelData {
         alignas(16) FloatBufferLine mBuffer{};
         float mHfScale{}, mLfScale{};
@@ -246,7 +601,14 @@ struct ConvolutionState final : public EffectState {
 
 
     ConvolutionState() = default;
-    ~ConvolutionState() override = default;
+    ~ConvolutionState() override { mTailJob.drain(); }
+
+    [[nodiscard]] auto tailWorkCount() const noexcept -> size_t
+    { return mChans.size() * (mNumTailSegs+1); }
+    void processTailStep(const size_t c, const size_t s);
+    void processTailChannel(const size_t c);
+    void processTail(const size_t target);
+    void startTail();
 
     void NormalMix(const al::span<FloatBufferLine> samplesOut, const size_t samplesToDo);
     void UpsampleMix(const al::span<FloatBufferLine> samplesOut, const size_t samplesToDo);
@@ -258,6 +620,7 @@ struct ConvolutionState final : public EffectState {
         const EffectTarget target) override;
     void process(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn,
         const al::span<FloatBufferLine> samplesOut) override;
+    [[nodiscard]] auto inputChannels() const noexcept -> size_t override { return 1; }
 };
 
 void ConvolutionState::NormalMix(const al::span<FloatBufferLine> samplesOut,
@@ -280,19 +643,112 @@ void ConvolutionState::UpsampleMix(const al::span<FloatBufferLine> samplesOut,
 }
 
 
-void ConvolutionState::deviceUpdate(const DeviceBase *device, const BufferStorage *buffer)
+/* Does one step of the tail processing for the pending input block. Each
+ * channel has one step for each tail segment to accumulate, then one for the
+ * inverse FFT.
+ */
+void ConvolutionState::processTailStep(const size_t c, const size_t s)
 {
-    using UhjDecoderType = UhjDecoder<512>;
-    static constexpr auto DecoderPadding = UhjDecoderType::sInputPadding;
+    const size_t tailsize{mTailSize};
+    const size_t fftsize{tailsize * 2};
+    const size_t numsegs{mNumTailSegs};
+    const auto filters = al::span{mFilter->mTail};
 
+    const auto accum = al::span{mTailAccum}.subspan(c*fftsize, fftsize);
+    if(s < numsegs)
+    {
+        if(s == 0)
+            std::fill(accum.begin(), accum.end(), 0.0f);
+        const size_t inseg{(mTailCurrentSeg+s) % numsegs};
+        mTailFft.zconvolve_accumulate(&mTailComplex[inseg*fftsize],
+            &filters[(c*numsegs + s)*fftsize], accum.data());
+    }
+    else
+    {
+        /* Apply the iFFT, and combine the first half with the last overflow
+         * for the next output block. The second half is the new overflow.
+         */
+        const size_t workoffset{mOffload ? c*fftsize : 0_uz};
+        mTailFft.transform(accum.data(), accum.data(), &mTailWorkBuffer[workoffset],
+            PFFFT_BACKWARD);
+
+        const auto output = al::span{mTailOutput}.subspan(c*tailsize*3, tailsize*3);
+        const auto next = output.subspan(tailsize, tailsize);
+        const auto overflow = output.subspan(tailsize*2);
+        std::transform(accum.cbegin(), accum.cbegin()+ptrdiff_t(tailsize), overflow.cbegin(),
+            next.begin(), std::plus{});
+        std::copy(accum.cbegin()+ptrdiff_t(tailsize), accum.cend(), overflow.begin());
+    }
+}
+
+/* Does all the tail processing of one channel for the pending input block. */
+void ConvolutionState::processTailChannel(const size_t c)
+{
+    for(size_t s{0};s <= mNumTailSegs;++s)
+        processTailStep(c, s);
+}
+
+/* Does the tail processing for the pending input block, up to the target
+ * amount of work.
+ */
+void ConvolutionState::processTail(const size_t target)
+{
+    const size_t numsegs{mNumTailSegs};
+    for(;mTailWorkDone < target;++mTailWorkDone)
+        processTailStep(mTailWorkDone / (numsegs+1), mTailWorkDone % (numsegs+1));
+}
+
+/* Finishes the pending tail block, makes its output current, and starts
+ * processing the next input block.
+ */
+void ConvolutionState::startTail()
+{
+    const size_t tailsize{mTailSize};
+    const size_t fftsize{tailsize * 2};
+
+    if(mTailOffloaded)
+        mTailJob.finish();
+    else
+        processTail(tailWorkCount());
+    for(size_t c{0};c < mChans.size();++c)
+    {
+        const auto output = al::span{mTailOutput}.subspan(c*tailsize*3, tailsize*2);
+        std::copy(output.cbegin()+ptrdiff_t(tailsize), output.cend(), output.begin());
+    }
+
+    mTailCurrentSeg = mTailCurrentSeg ? (mTailCurrentSeg-1) : (mNumTailSegs-1);
+    mTailFft.transform(mTailInput.data(), &mTailComplex[mTailCurrentSeg*fftsize],
+        mTailWorkBuffer.data(), PFFFT_FORWARD);
+    std::fill_n(mTailInput.begin(), tailsize, 0.0f);
+    mTailWorkDone = 0;
+
+    /* Give the new block to the offload thread, if it's done with the last
+     * one. Otherwise, it's processed over the coming updates.
+     */
+    mTailOffloaded = mOffload && mTailJob.isIdle();
+    if(mTailOffloaded)
+    {
+        mTailWorkDone = tailWorkCount();
+        mOffload->submit(mTailJob, mChans.size());
+    }
+}
+
+
+void ConvolutionState::deviceUpdate(const DeviceBase *device, const BufferStorage *buffer)
+{
     static constexpr uint MaxConvolveAmbiOrder{1u};
 
+    /* Make sure the offload thread is done with the old tail. */
+    mTailJob.drain();
+    mOffload = device->mConvolutionOffload.get();
+    mTailOffloaded = false;
+
     if(!mFft)
         mFft = PFFFTSetup{ConvolveUpdateSize, PFFFT_REAL};
 
     mFifoPos = 0;
     mInput.fill(0.0f);
-    decltype(mFilter){}.swap(mFilter);
+    mFilter = nullptr;
     decltype(mOutput){}.swap(mOutput);
     mFftBuffer.fill(0.0f);
     mFftWorkBuffer.fill(0.0f);
@@ -300,128 +756,73 @@ void ConvolutionState::deviceUpdate(const DeviceBase *device, const BufferStorag
     mCurrentSegment = 0;
     mNumConvolveSegs = 0;
 
+    mTailSize = 0;
+    mNumTailSegs = 0;
+    mTailPos = 0;
+    mTailCurrentSeg = 0;
+    mTailWorkDone = 0;
+    decltype(mTailInput){}.swap(mTailInput);
+    decltype(mTailWorkBuffer){}.swap(mTailWorkBuffer);
+    decltype(mTailComplex){}.swap(mTailComplex);
+    decltype(mTailAccum){}.swap(mTailAccum);
+    decltype(mTailOutput){}.swap(mTailOutput);
+
     decltype(mChans){}.swap(mChans);
     decltype(mComplexData){}.swap(mComplexData);
 
     /* An empty buffer doesn't need a convolution filter. */
-    if(!buffer || buffer->mSampleLen < 1) return;
+    if(!buffer || buffer->mSampleLen < 1)
+    {
+        setMemoryUsage(device->mMemory, 0);
+        return;
+    }
 
     mChannels = buffer->mChannels;
     mAmbiLayout = IsUHJ(mChannels) ? AmbiLayout::FuMa : buffer->mAmbiLayout;
     mAmbiScaling = IsUHJ(mChannels) ? AmbiScaling::UHJ : buffer->mAmbiScaling;
     mAmbiOrder = std::min(buffer->mAmbiOrder, MaxConvolveAmbiOrder);
 
-    const auto realChannels = buffer->channelsFromFmt();
-    const auto numChannels = (mChannels == FmtUHJ2) ? 3u : ChannelsFromFmt(mChannels, mAmbiOrder);
+    mFilter = GetConvolutionFilter(device, buffer, mChannels, mAmbiOrder);
+    const size_t numChannels{mFilter->mNumChannels};
 
     mChans.resize(numChannels);
 
-    /* The impulse response needs to have the same sample rate as the input and
-     * output. The bsinc24 resampler is decent, but there is high-frequency
-     * attenuation that some people may be able to pick up on. Since this is
-     * called very infrequently, go ahead and use the polyphase resampler.
-     */
-    PPhaseResampler resampler;
-    if(device->Frequency != buffer->mSampleRate)
-        resampler.init(buffer->mSampleRate, device->Frequency);
-    const auto resampledCount = static_cast<uint>(
-        (uint64_t{buffer->mSampleLen}*device->Frequency+(buffer->mSampleRate-1)) /
-        buffer->mSampleRate);
-
-    const BandSplitter splitter{device->mXOverFreq / static_cast<float>(device->Frequency)};
+    const BandSplitter splitter{device->mXOverFreq / static_cast<float>(device->mMixFrequency)};
     for(auto &e : mChans)
         e.mFilter = splitter;
 
-    mFilter.resize(numChannels, {});
     mOutput.resize(numChannels, {});
 
-    /* Calculate the number of segments needed to hold the impulse response and
-     * the input history (rounded up), and allocate them. Exclude one segment
-     * which gets applied as a time-domain FIR filter. Make sure at least one
-     * segment is allocated to simplify handling.
+    /* Only the input history and output is needed for each effect state,
+     * which uses the shared filter's segment layout.
      */
-    mNumConvolveSegs = (resampledCount+(ConvolveUpdateSamples-1)) / ConvolveUpdateSamples;
-    mNumConvolveSegs = std::max(mNumConvolveSegs, 2_uz) - 1_uz;
-
-    const size_t complex_length{mNumConvolveSegs * ConvolveUpdateSize * (numChannels+1)};
-    mComplexData.resize(complex_length, 0.0f);
-
-    /* Load the samples from the buffer. */
-    const size_t srclinelength{RoundUp(buffer->mSampleLen+DecoderPadding, 16)};
-    auto srcsamples = std::vector<float>(srclinelength * numChannels);
-    std::fill(srcsamples.begin(), srcsamples.end(), 0.0f);
-    for(size_t c{0};c < numChannels && c < realChannels;++c)
-        LoadSamples(al::span{srcsamples}.subspan(srclinelength*c, buffer->mSampleLen),
-            buffer->mData.data(), c, realChannels, buffer->mType);
-
-    if(IsUHJ(mChannels))
+    mNumConvolveSegs = mFilter->mNumConvolveSegs;
+    mTailSize = mFilter->mTailSize;
+    mNumTailSegs = mFilter->mNumTailSegs;
+    if(mTailSize > 0)
     {
-        auto decoder = std::make_unique<UhjDecoderType>();
-        std::array<float*,4> samples{};
-        for(size_t c{0};c < numChannels;++c)
-            samples[c] = al::to_address(srcsamples.begin() + ptrdiff_t(srclinelength*c));
-        decoder->decode({samples.data(), numChannels}, buffer->mSampleLen, buffer->mSampleLen);
+        const size_t fftsize{mTailSize * 2};
+        mTailFft = PFFFTSetup{static_cast<uint>(fftsize), PFFFT_REAL};
+        mTailInput.resize(fftsize, 0.0f);
+        mTailWorkBuffer.resize(fftsize * (mOffload ? numChannels : 1_uz), 0.0f);
+        mTailComplex.resize(mNumTailSegs * fftsize, 0.0f);
+        mTailAccum.resize(fftsize * numChannels, 0.0f);
+        mTailOutput.resize(mTailSize * 3 * numChannels, 0.0f);
+        /* There's no pending input block to start with. */
+        mTailWorkDone = numChannels * (mNumTailSegs+1);
     }
 
-    auto ressamples = std::vector<double>(buffer->mSampleLen + (resampler ? resampledCount : 0));
-    auto ffttmp = al::vector<float,16>(ConvolveUpdateSize);
-    auto fftbuffer = std::vector<std::complex<double>>(ConvolveUpdateSize);
+    mComplexData.resize(mNumConvolveSegs * ConvolveUpdateSize, 0.0f);
 
-    auto filteriter = mComplexData.begin() + ptrdiff_t(mNumConvolveSegs*ConvolveUpdateSize);
-    for(size_t c{0};c < numChannels;++c)
-    {
-        auto bufsamples = al::span{srcsamples}.subspan(srclinelength*c, buffer->mSampleLen);
-        /* Resample to match the device. */
-        if(resampler)
-        {
-            auto restmp = al::span{ressamples}.subspan(resampledCount, buffer->mSampleLen);
-            std::copy(bufsamples.cbegin(), bufsamples.cend(), restmp.begin());
-            resampler.process(restmp, al::span{ressamples}.first(resampledCount));
-        }
-        else
-            std::copy(bufsamples.cbegin(), bufsamples.cend(), ressamples.begin());
-
-        /* Store the first segment's samples in reverse in the time-domain, to
-         * apply as a FIR filter.
-         */
-        const size_t first_size{std::min(size_t{resampledCount}, ConvolveUpdateSamples)};
-        auto sampleseg = al::span{ressamples.cbegin(), first_size};
-        std::transform(sampleseg.cbegin(), sampleseg.cend(), mFilter[c].rbegin(),
-            [](const double d) noexcept -> float { return static_cast<float>(d); });
-
-        size_t done{first_size};
-        for(size_t s{0};s < mNumConvolveSegs;++s)
-        {
-            const size_t todo{std::min(resampledCount-done, ConvolveUpdateSamples)};
-            sampleseg = al::span{ressamples}.subspan(done, todo);
-
-            /* Apply a double-precision forward FFT for more precise frequency
-             * measurements.
-             */
-            auto iter = std::copy(sampleseg.cbegin(), sampleseg.cend(), fftbuffer.begin());
-            done += todo;
-            std::fill(iter, fftbuffer.end(), std::complex<double>{});
-            forward_fft(al::span{fftbuffer});
-
-            /* Convert to, and pack in, a float buffer for PFFFT. Note that the
-             * first bin stores the real component of the half-frequency bin in
-             * the imaginary component. Also scale the FFT by its length so the
-             * iFFT'd output will be normalized.
-             */
-            static constexpr float fftscale{1.0f / float{ConvolveUpdateSize}};
-            for(size_t i{0};i < ConvolveUpdateSamples;++i)
-            {
-                ffttmp[i*2    ] = static_cast<float>(fftbuffer[i].real()) * fftscale;
-                ffttmp[i*2 + 1] = static_cast<float>((i == 0) ?
-                    fftbuffer[ConvolveUpdateSamples].real() : fftbuffer[i].imag()) * fftscale;
-            }
-            /* Reorder backward to make it suitable for pffft_zconvolve and the
-             * subsequent pffft_transform(..., PFFFT_BACKWARD).
-             */
-            mFft.zreorder(ffttmp.data(), al::to_address(filteriter), PFFFT_BACKWARD);
-            filteriter += ConvolveUpdateSize;
-        }
-    }
+    /* The filter's spectra are shared with other states using the same
+     * buffer, but are counted for each of them, as any can keep it alive.
+     */
+    const size_t filtersize{mFilter->mFir.size()*sizeof(mFilter->mFir[0])
+        + (mFilter->mHead.size() + mFilter->mTail.size())*sizeof(float)};
+    setMemoryUsage(device->mMemory, filtersize + mOutput.size()*sizeof(mOutput[0])
+        + mChans.size()*sizeof(ChannelData) + (mTailInput.size() + mTailWorkBuffer.size()
+        + mTailComplex.size() + mTailAccum.size() + mTailOutput.size()
+        + mComplexData.size())*sizeof(float));
 }
 
 
@@ -646,13 +1047,30 @@ void ConvolutionState::process(const size_t samplesToDo,
         for(size_t c{0};c < mChans.size();++c)
         {
             auto outspan = al::span{mChans[c].mBuffer}.subspan(base, todo);
-            apply_fir(outspan, al::span{mInput}.subspan(1+mFifoPos), mFilter[c]);
+            apply_fir(outspan, al::span{mInput}.subspan(1+mFifoPos), mFilter->mFir[c]);
 
             auto fifospan = al::span{mOutput[c]}.subspan(mFifoPos, todo);
             std::transform(fifospan.cbegin(), fifospan.cend(), outspan.cbegin(), outspan.begin(),
                 std::plus{});
         }
 
+        if(mTailSize > 0)
+        {
+            /* Add the tail's current output, and store the input for the next
+             * tail block.
+             */
+            for(size_t c{0};c < mChans.size();++c)
+            {
+                auto outspan = al::span{mChans[c].mBuffer}.subspan(base, todo);
+                auto tailspan = al::span{mTailOutput}.subspan(c*mTailSize*3 + mTailPos, todo);
+                std::transform(tailspan.cbegin(), tailspan.cend(), outspan.cbegin(),
+                    outspan.begin(), std::plus{});
+            }
+            std::copy_n(samplesIn[0].begin() + ptrdiff_t(base), todo,
+                mTailInput.begin()+ptrdiff_t(mTailPos));
+            mTailPos += todo;
+        }
+
         mFifoPos += todo;
         base += todo;
 
@@ -670,7 +1088,7 @@ void ConvolutionState::process(const size_t samplesToDo,
         mFft.transform(mInput.data(), &mComplexData[curseg*ConvolveUpdateSize],
             mFftWorkBuffer.data(), PFFFT_FORWARD);
 
-        auto filter = mComplexData.cbegin() + ptrdiff_t(mNumConvolveSegs*ConvolveUpdateSize);
+        auto filter = mFilter->mHead.cbegin();
         for(size_t c{0};c < mChans.size();++c)
         {
             /* Convolve each input segment with its IR filter counterpart
@@ -711,6 +1129,20 @@ void ConvolutionState::process(const size_t samplesToDo,
 
         /* Shift the input history. */
         curseg = curseg ? (curseg-1) : (mNumConvolveSegs-1);
+
+        /* Start the next tail block when the input for it is complete, or
+         * else continue with the pending block's processing.
+         */
+        if(mTailSize > 0)
+        {
+            if(mTailPos == mTailSize)
+            {
+                startTail();
+                mTailPos = 0;
+            }
+            else
+                processTail(tailWorkCount() * mTailPos / mTailSize);
+        }
     }
     mCurrentSegment = curseg;
 
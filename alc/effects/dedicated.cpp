@@ -57,6 +57,14 @@ struct DedicatedState final : public EffectState {
         const EffectTarget target) final;
     void process(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn,
         const al::span<FloatBufferLine> samplesOut) final;
+    [[nodiscard]] auto inputChannels() const noexcept -> size_t final { return 1; }
+
+    /* There's no internal state, so the slot can sleep whenever nothing is
+     * mixed into its wet buffer. When outputting to a real channel, voices
+     * mix there directly (see EffectSlot::mDirectOut), leaving the wet buffer
+     * for other slots targeting this one.
+     */
+    [[nodiscard]] bool isIdle() const noexcept final { return true; }
 };
 
 void DedicatedState::deviceUpdate(const DeviceBase*, const BufferStorage*)
@@ -26,6 +26,10 @@
 #include <cstdlib>
 #include <variant>
 
+#ifdef HAVE_SSE_INTRINSICS
+#include <xmmintrin.h>
+#endif
+
 #include "alc/effects/base.h"
 #include "alnumbers.h"
 #include "alnumeric.h"
@@ -45,6 +49,45 @@ struct BufferStorage;
 
 namespace {
 
+/* Applies the waveshaper function to emulate signal processing during tube
+ * overdriving. Three steps of waveshaping are intended to modify waveform
+ * without boost/clipping/attenuation process.
+ */
+void ApplyWaveshaper(const float fc, const al::span<const float> src, const al::span<float> dst)
+{
+    size_t i{0};
+#ifdef HAVE_SSE_INTRINSICS
+    const __m128 absmask{_mm_castsi128_ps(_mm_set1_epi32(0x7fffffff))};
+    const __m128 signmask{_mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000u)))};
+    const __m128 one{_mm_set1_ps(1.0f)};
+    const __m128 coeff{_mm_set1_ps(fc)};
+    const __m128 scale{_mm_set1_ps(1.0f + fc)};
+    auto shape = [absmask,one,coeff,scale](const __m128 smp) noexcept -> __m128
+    {
+        const __m128 den{_mm_add_ps(one, _mm_mul_ps(coeff, _mm_and_ps(smp, absmask)))};
+        return _mm_div_ps(_mm_mul_ps(scale, smp), den);
+    };
+    for(;src.size()-i >= 4;i += 4)
+    {
+        __m128 smp{_mm_loadu_ps(&src[i])};
+        smp = shape(smp);
+        smp = _mm_xor_ps(shape(smp), signmask);
+        smp = shape(smp);
+        _mm_storeu_ps(&dst[i], smp);
+    }
+#endif
+
+    auto proc_sample = [fc](float smp) noexcept -> float
+    {
+        smp = (1.0f + fc) * smp/(1.0f + fc*std::fabs(smp));
+        smp = (1.0f + fc) * smp/(1.0f + fc*std::fabs(smp)) * -1.0f;
+        smp = (1.0f + fc) * smp/(1.0f + fc*std::fabs(smp));
+        return smp;
+    };
+    std::transform(src.begin()+ptrdiff_t(i), src.end(), dst.begin()+ptrdiff_t(i), proc_sample);
+}
+
+
 struct DistortionState final : public EffectState {
     /* Effect gains for each channel */
     std::array<float,MaxAmbiChannels> mGain{};
@@ -63,6 +106,7 @@ struct DistortionState final : public EffectState {
         const EffectTarget target) override;
     void process(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn,
         const al::span<FloatBufferLine> samplesOut) override;
+    [[nodiscard]] auto inputChannels() const noexcept -> size_t override { return 1; }
 };
 
 void DistortionState::deviceUpdate(const DeviceBase*, const BufferStorage*)
@@ -87,7 +131,7 @@ void DistortionState::update(const ContextBase *context, const EffectSlot *slot,
     /* Divide normalized frequency by the amount of oversampling done during
      * processing.
      */
-    auto frequency = static_cast<float>(device->Frequency);
+    auto frequency = static_cast<float>(device->mMixFrequency);
     mLowpass.setParamsFromBandwidth(BiquadType::LowPass, cutoff/frequency/4.0f, 1.0f, bandwidth);
 
     cutoff = props.EQCenter;
@@ -113,33 +157,17 @@ void DistortionState::process(const size_t samplesToDo, const al::span<const Flo
          */
         size_t todo{std::min(BufferLineSize, (samplesToDo-base) * 4_uz)};
 
-        /* Fill oversample buffer using zero stuffing. Multiply the sample by
-         * the amount of oversampling to maintain the signal's power.
-         */
-        for(size_t i{0u};i < todo;i++)
-            mBuffer[0][i] = !(i&3) ? samplesIn[0][(i>>2)+base] * 4.0f : 0.0f;
-
         /* First step, do lowpass filtering of original signal. Additionally
          * perform buffer interpolation and lowpass cutoff for oversampling
          * (which is fortunately first step of distortion). So combine three
-         * operations into the one.
+         * operations into the one. The input is zero stuffed, and multiplied
+         * by the amount of oversampling to maintain the signal's power.
          */
-        mLowpass.process(al::span{mBuffer[0]}.first(todo), mBuffer[1]);
+        mLowpass.processZeroStuffed(al::span{samplesIn[0]}.subspan(base, todo>>2), 4.0f,
+            al::span{mBuffer[1]}.first(todo));
 
-        /* Second step, do distortion using waveshaper function to emulate
-         * signal processing during tube overdriving. Three steps of
-         * waveshaping are intended to modify waveform without boost/clipping/
-         * attenuation process.
-         */
-        auto proc_sample = [fc](float smp) -> float
-        {
-            smp = (1.0f + fc) * smp/(1.0f + fc*std::fabs(smp));
-            smp = (1.0f + fc) * smp/(1.0f + fc*std::fabs(smp)) * -1.0f;
-            smp = (1.0f + fc) * smp/(1.0f + fc*std::fabs(smp));
-            return smp;
-        };
-        std::transform(mBuffer[1].begin(), mBuffer[1].begin()+todo, mBuffer[0].begin(),
-            proc_sample);
+        /* Second step, do distortion using the waveshaper. */
+        ApplyWaveshaper(fc, al::span{mBuffer[1]}.first(todo), mBuffer[0]);
 
         /* Third step, do bandpass filtering of distorted signal. */
         mBandpass.process(al::span{mBuffer[0]}.first(todo), mBuffer[1]);
@@ -68,17 +68,19 @@ struct EchoState final : public EffectState {
     float mFeedGain{0.0f};
 
     alignas(16) std::array<FloatBufferLine,2> mTempBuffer{};
+    alignas(16) FloatBufferLine mFeedBuffer{};
 
     void deviceUpdate(const DeviceBase *device, const BufferStorage *buffer) override;
     void update(const ContextBase *context, const EffectSlot *slot, const EffectProps *props,
         const EffectTarget target) override;
     void process(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn,
         const al::span<FloatBufferLine> samplesOut) override;
+    [[nodiscard]] auto inputChannels() const noexcept -> size_t override { return 1; }
 };
 
 void EchoState::deviceUpdate(const DeviceBase *Device, const BufferStorage*)
 {
-    const auto frequency = static_cast<float>(Device->Frequency);
+    const auto frequency = static_cast<float>(Device->mMixFrequency);
 
     // Use the next power of 2 for the buffer length, so the tap offsets can be
     // wrapped using a mask instead of a modulo
@@ -86,6 +88,7 @@ void EchoState::deviceUpdate(const DeviceBase *Device, const BufferStorage*)
         float2uint(EchoMaxLRDelay*frequency + 0.5f))};
     if(maxlen != mSampleBuffer.size())
         decltype(mSampleBuffer)(maxlen).swap(mSampleBuffer);
+    setMemoryUsage(Device->mMemory, mSampleBuffer.size()*sizeof(float));
 
     std::fill(mSampleBuffer.begin(), mSampleBuffer.end(), 0.0f);
     for(auto &e : mGains)
@@ -100,7 +103,7 @@ void EchoState::update(const ContextBase *context, const EffectSlot *slot,
 {
     auto &props = std::get<EchoProps>(*props_);
     const DeviceBase *device{context->mDevice};
-    const auto frequency = static_cast<float>(device->Frequency);
+    const auto frequency = static_cast<float>(device->mMixFrequency);
 
     mDelayTap[0] = std::max(float2uint(std::round(props.Delay*frequency)), 1u);
     mDelayTap[1] = float2uint(std::round(props.LRDelay*frequency)) + mDelayTap[0];
@@ -132,31 +135,44 @@ void EchoState::process(const size_t samplesToDo, const al::span<const FloatBuff
 
     ASSUME(samplesToDo > 0);
 
-    const BiquadFilter filter{mFilter};
-    auto [z1, z2] = mFilter.getComponents();
-    for(size_t i{0u};i < samplesToDo;)
+    const auto input = al::span{samplesIn[0]}.first(samplesToDo);
+    for(size_t base{0u};base < samplesToDo;)
     {
         offset &= mask;
         tap1 &= mask;
         tap2 &= mask;
 
-        size_t td{std::min(mask+1 - std::max(offset, std::max(tap1, tap2)), samplesToDo-i)};
-        do {
-            /* Feed the delay buffer's input first. */
-            delaybuf[offset] = samplesIn[0][i];
-
-            /* Get delayed output from the first and second taps. Use the
-             * second tap for feedback.
-             */
-            mTempBuffer[0][i] = delaybuf[tap1++];
-            mTempBuffer[1][i] = delaybuf[tap2++];
-            const float feedb{mTempBuffer[1][i++]};
-
-            /* Add feedback to the delay buffer with damping and attenuation. */
-            delaybuf[offset++] += filter.processOne(feedb, z1, z2) * mFeedGain;
-        } while(--td);
+        /* Process in blocks no longer than the second tap's delay, so the
+         * feedback only reads samples written by previous blocks, and that
+         * don't wrap around the delay buffer.
+         */
+        const size_t todo{std::min({samplesToDo-base, mDelayTap[1],
+            mask+1 - std::max({offset, tap1, tap2})})};
+
+        /* Get the delayed output from the second tap, and filter it for the
+         * feedback.
+         */
+        const auto tap2out = al::span{mTempBuffer[1]}.subspan(base, todo);
+        const auto feedback = al::span{mFeedBuffer}.first(todo);
+        std::copy_n(delaybuf.begin()+ptrdiff_t(tap2), todo, tap2out.begin());
+        mFilter.processBlocks(tap2out, feedback);
+
+        /* Feed the delay buffer's input with damping and attenuated feedback. */
+        std::transform(input.begin()+ptrdiff_t(base), input.begin()+ptrdiff_t(base+todo),
+            feedback.begin(), delaybuf.begin()+ptrdiff_t(offset),
+            [feedgain=mFeedGain](const float in, const float feedb) noexcept -> float
+            { return in + feedb*feedgain; });
+
+        /* Get the delayed output from the first tap, which may include the
+         * input just written.
+         */
+        std::copy_n(delaybuf.begin()+ptrdiff_t(tap1), todo, mTempBuffer[0].begin()+ptrdiff_t(base));
+
+        base += todo;
+        offset += todo;
+        tap1 += todo;
+        tap2 += todo;
     }
-    mFilter.setComponents(z1, z2);
     mOffset = offset;
 
     for(size_t c{0};c < 2;c++)
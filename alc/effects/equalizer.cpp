@@ -98,7 +98,7 @@ struct EqualizerState final : public EffectState {
     };
     std::array<OutParams,MaxAmbiChannels> mChans;
 
-    alignas(16) FloatBufferLine mSampleBuffer{};
+    alignas(16) std::array<FloatBufferLine,BiquadFilter::ChainLanes> mSampleBuffer{};
 
 
     void deviceUpdate(const DeviceBase *device, const BufferStorage *buffer) override;
@@ -123,7 +123,7 @@ void EqualizerState::update(const ContextBase *context, const EffectSlot *slot,
 {
     auto &props = std::get<EqualizerProps>(*props_);
     const DeviceBase *device{context->mDevice};
-    auto frequency = static_cast<float>(device->Frequency);
+    auto frequency = static_cast<float>(device->mMixFrequency);
 
     /* Calculate coefficients for the each type of filter. Note that the shelf
      * and peaking filters' gain is for the centerpoint of the transition band,
@@ -169,20 +169,34 @@ void EqualizerState::update(const ContextBase *context, const EffectSlot *slot,
 
 void EqualizerState::process(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn, const al::span<FloatBufferLine> samplesOut)
 {
-    const auto buffer = al::span{mSampleBuffer}.first(samplesToDo);
-    auto chan = mChans.begin();
-    for(const auto &input : samplesIn)
+    static constexpr size_t NumLanes{BiquadFilter::ChainLanes};
+
+    /* Filter groups of input channels together, with each channel in its own
+     * SIMD lane.
+     */
+    for(size_t base{0};base < samplesIn.size();base += NumLanes)
     {
-        if(const size_t outidx{chan->mTargetChannel}; outidx != InvalidChannelIndex)
+        const size_t numchans{std::min(samplesIn.size()-base, NumLanes)};
+
+        std::array<al::span<BiquadFilter>,NumLanes> chains{};
+        std::array<al::span<const float>,NumLanes> inbufs{};
+        std::array<al::span<float>,NumLanes> outbufs{};
+        for(size_t c{0};c < numchans;++c)
         {
-            const auto inbuf = al::span{input}.first(samplesToDo);
-            DualBiquad{chan->mFilter[0], chan->mFilter[1]}.process(inbuf, buffer);
-            DualBiquad{chan->mFilter[2], chan->mFilter[3]}.process(buffer, buffer);
+            chains[c] = mChans[base+c].mFilter;
+            inbufs[c] = al::span{samplesIn[base+c]}.first(samplesToDo);
+            outbufs[c] = al::span{mSampleBuffer[c]}.first(samplesToDo);
+        }
+        BiquadFilter::processChain(al::span{chains}.first(numchans),
+            al::span{inbufs}.first(numchans), al::span{outbufs}.first(numchans));
 
-            MixSamples(buffer, samplesOut[outidx], chan->mCurrentGain, chan->mTargetGain,
-                samplesToDo);
+        for(size_t c{0};c < numchans;++c)
+        {
+            auto &chan = mChans[base+c];
+            if(const size_t outidx{chan.mTargetChannel}; outidx != InvalidChannelIndex)
+                MixSamples(outbufs[c], samplesOut[outidx], chan.mCurrentGain, chan.mTargetGain,
+                    samplesToDo);
         }
-        ++chan;
     }
 }
 
@@ -28,7 +28,6 @@
 #include <variant>
 
 #include "alc/effects/base.h"
-#include "alcomplex.h"
 #include "alnumbers.h"
 #include "alnumeric.h"
 #include "alspan.h"
@@ -42,53 +41,76 @@
 #include "core/mixer/defs.h"
 #include "intrusive_ptr.h"
 #include "opthelpers.h"
+#include "pffft.h"
 
 struct BufferStorage;
 
 namespace {
 
 using uint = unsigned int;
-using complex_d = std::complex<double>;
+using complex_f = std::complex<float>;
 
-constexpr size_t HilSize{1024};
-constexpr size_t HilHalfSize{HilSize >> 1};
-constexpr size_t OversampleFactor{4};
+/* The Hilbert transform is applied with a windowed FIR filter, convolved with
+ * the input using overlap-save FFT blocks. The FFT size must hold a block of
+ * input and the filter length.
+ */
+constexpr size_t HilFftSize{1024};
+constexpr size_t HilStep{256};
+constexpr size_t HilFilterLength{HilFftSize - HilStep - 1};
+constexpr size_t HilDelay{HilFilterLength / 2};
 
-static_assert(HilSize%OversampleFactor == 0, "Factor must be a clean divisor of the size");
-constexpr size_t HilStep{HilSize / OversampleFactor};
+static_assert(HilFilterLength+HilStep-1 <= HilFftSize, "FIR filter is too long for the FFT");
+static_assert((HilDelay&1) == 1, "FIR filter delay must be odd");
 
-/* Define a Hann window, used to filter the HIL input and output. */
-struct Windower {
-    alignas(16) std::array<double,HilSize> mData{};
+/* The output level of the analytic signal, matching the previous windowed STFT
+ * implementation.
+ */
+constexpr float HilOutputScale{0.75f};
 
-    Windower()
+/* Define the Hilbert FIR filter, stored in the frequency domain for the FFT
+ * convolution.
+ */
+struct HilbertFilter {
+    PFFFTSetup mFft;
+    alignas(16) std::array<float,HilFftSize> mFilter{};
+
+    HilbertFilter() : mFft{HilFftSize, PFFFT_REAL}
     {
-        /* Create lookup table of the Hann window for the desired size. */
-        for(size_t i{0};i < HilHalfSize;i++)
+        /* The ideal Hilbert transformer's impulse response is 2/(pi*n) for
+         * odd n, and 0 for even n. It's truncated and delayed to be causal,
+         * and shaped with a Hann window.
+         */
+        alignas(16) std::array<float,HilFftSize> filter{};
+        alignas(16) std::array<float,HilFftSize> work{};
+        for(size_t i{1};i <= HilDelay;i += 2)
         {
-            constexpr double scale{al::numbers::pi / double{HilSize}};
-            const double val{std::sin((static_cast<double>(i)+0.5) * scale)};
-            mData[i] = mData[HilSize-1-i] = val * val;
+            const auto n = static_cast<double>(i);
+            const double w{al::numbers::pi * (n+double{HilDelay}) / double{HilDelay}};
+            const double window{0.5 - 0.5*std::cos(w)};
+            const auto val = static_cast<float>(2.0 / (al::numbers::pi*n) * window);
+            filter[HilDelay+i] = val;
+            filter[HilDelay-i] = -val;
         }
+        mFft.transform(filter.data(), mFilter.data(), work.data(), PFFFT_FORWARD);
     }
 };
-const Windower gWindow{};
+const HilbertFilter gHilbert{};
 
 
 struct FshifterState final : public EffectState {
     /* Effect parameters */
     size_t mCount{};
-    size_t mPos{};
     std::array<uint,2> mPhaseStep{};
     std::array<uint,2> mPhase{};
     std::array<double,2> mSign{};
 
     /* Effects buffers */
-    std::array<double,HilSize> mInFIFO{};
-    std::array<complex_d,HilStep> mOutFIFO{};
-    std::array<complex_d,HilSize> mOutputAccum{};
-    std::array<complex_d,HilSize> mAnalytic{};
-    std::array<complex_d,BufferLineSize> mOutdata{};
+    alignas(16) std::array<float,HilFftSize> mInFIFO{};
+    alignas(16) std::array<float,HilFftSize> mFftBuffer{};
+    alignas(16) std::array<float,HilFftSize> mAnalytic{};
+    alignas(16) std::array<float,HilFftSize> mFftWork{};
+    std::array<complex_f,HilStep> mOutFIFO{};
+    std::array<complex_f,BufferLineSize> mOutdata{};
 
     alignas(16) FloatBufferLine mBufferOut{};
 
@@ -105,21 +127,19 @@ struct FshifterState final : public EffectState {
         const EffectTarget target) override;
     void process(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn,
         const al::span<FloatBufferLine> samplesOut) override;
+    [[nodiscard]] auto inputChannels() const noexcept -> size_t override { return 1; }
 };
 
 void FshifterState::deviceUpdate(const DeviceBase*, const BufferStorage*)
 {
     /* (Re-)initializing parameters and clear the buffers. */
     mCount = 0;
-    mPos = HilSize - HilStep;
 
     mPhaseStep.fill(0u);
     mPhase.fill(0u);
     mSign.fill(1.0);
-    mInFIFO.fill(0.0);
-    mOutFIFO.fill(complex_d{});
-    mOutputAccum.fill(complex_d{});
-    mAnalytic.fill(complex_d{});
+    mInFIFO.fill(0.0f);
+    mOutFIFO.fill(complex_f{});
 
     for(auto &gain : mGains)
     {
@@ -134,7 +154,7 @@ void FshifterState::update(const ContextBase *context, const EffectSlot *slot,
     auto &props = std::get<FshifterProps>(*props_);
     const DeviceBase *device{context->mDevice};
 
-    const float step{props.Frequency / static_cast<float>(device->Frequency)};
+    const float step{props.Frequency / static_cast<float>(device->mMixFrequency)};
     mPhaseStep[0] = mPhaseStep[1] = fastf2u(std::min(step, 1.0f) * MixerFracOne);
 
     switch(props.LeftDirection)
@@ -185,10 +205,9 @@ void FshifterState::process(const size_t samplesToDo, const al::span<const Float
         size_t todo{std::min(HilStep-mCount, samplesToDo-base)};
 
         /* Fill FIFO buffer with samples data */
-        const size_t pos{mPos};
         size_t count{mCount};
         do {
-            mInFIFO[pos+count] = samplesIn[0][base];
+            mInFIFO[HilFftSize-HilStep+count] = samplesIn[0][base];
             mOutdata[base] = mOutFIFO[count];
             ++base; ++count;
         } while(--todo);
@@ -197,26 +216,30 @@ void FshifterState::process(const size_t samplesToDo, const al::span<const Float
         /* Check whether FIFO buffer is filled */
         if(mCount < HilStep) break;
         mCount = 0;
-        mPos = (mPos+HilStep) & (HilSize-1);
-
-        /* Real signal windowing and store in Analytic buffer */
-        for(size_t src{mPos}, k{0u};src < HilSize;++src,++k)
-            mAnalytic[k] = mInFIFO[src]*gWindow.mData[k];
-        for(size_t src{0u}, k{HilSize-mPos};src < mPos;++src,++k)
-            mAnalytic[k] = mInFIFO[src]*gWindow.mData[k];
-
-        /* Processing signal by Discrete Hilbert Transform (analytical signal). */
-        complex_hilbert(mAnalytic);
-
-        /* Windowing and add to output accumulator */
-        for(size_t dst{mPos}, k{0u};dst < HilSize;++dst,++k)
-            mOutputAccum[dst] += 2.0/OversampleFactor*gWindow.mData[k]*mAnalytic[k];
-        for(size_t dst{0u}, k{HilSize-mPos};dst < mPos;++dst,++k)
-            mOutputAccum[dst] += 2.0/OversampleFactor*gWindow.mData[k]*mAnalytic[k];
-
-        /* Copy out the accumulated result, then clear for the next iteration. */
-        std::copy_n(mOutputAccum.cbegin() + mPos, HilStep, mOutFIFO.begin());
-        std::fill_n(mOutputAccum.begin() + mPos, HilStep, complex_d{});
+
+        /* Convolve the input with the Hilbert filter. The last HilStep samples
+         * of the (circular) convolution result are the valid output for the
+         * new input samples.
+         */
+        gHilbert.mFft.transform(mInFIFO.data(), mFftBuffer.data(), mFftWork.data(),
+            PFFFT_FORWARD);
+        mAnalytic.fill(0.0f);
+        gHilbert.mFft.zconvolve_scale_accumulate(mFftBuffer.data(), gHilbert.mFilter.data(),
+            mAnalytic.data(), 1.0f/float{HilFftSize});
+        gHilbert.mFft.transform(mAnalytic.data(), mAnalytic.data(), mFftWork.data(),
+            PFFFT_BACKWARD);
+
+        /* The analytic signal is the input delayed by the filter's delay, with
+         * the filtered result as the imaginary part.
+         */
+        const auto realin = al::span{mInFIFO}.subspan(HilFftSize-HilStep-HilDelay, HilStep);
+        const auto imagin = al::span{mAnalytic}.last<HilStep>();
+        std::transform(realin.begin(), realin.end(), imagin.begin(), mOutFIFO.begin(),
+            [](const float re, const float im) noexcept
+            { return complex_f{re*HilOutputScale, im*HilOutputScale}; });
+
+        /* Shift the input history for the next block. */
+        std::copy(mInFIFO.cbegin()+HilStep, mInFIFO.cend(), mInFIFO.begin());
     }
 
     /* Process frequency shifter using the analytic signal obtained. */
@@ -226,10 +249,10 @@ void FshifterState::process(const size_t samplesToDo, const al::span<const Float
         const uint phase_step{mPhaseStep[c]};
         uint phase_idx{mPhase[c]};
         std::transform(mOutdata.cbegin(), mOutdata.cbegin()+samplesToDo, mBufferOut.begin(),
-            [&phase_idx,phase_step,sign](const complex_d &in) -> float
+            [&phase_idx,phase_step,sign](const complex_f &in) -> float
             {
                 const double phase{phase_idx * (al::numbers::pi*2.0 / MixerFracOne)};
-                const auto out = static_cast<float>(in.real()*std::cos(phase) +
+                const auto out = static_cast<float>(in.real()*std::cos(phase) -
                     in.imag()*std::sin(phase)*sign);
 
                 phase_idx += phase_step;
@@ -70,6 +70,11 @@ struct OneFunc {
 };
 
 
+/* The most samples of the carrier to hold in a table. Carriers with longer
+ * cycles are generated as needed.
+ */
+constexpr size_t MaxCarrierTable{4096};
+
 struct ModulatorState final : public EffectState {
     std::variant<OneFunc,SinFunc,SawFunc,SquareFunc> mSampleGen;
 
@@ -77,13 +82,19 @@ struct ModulatorState final : public EffectState {
     uint mRange{1};
     float mIndexScale{0.0f};
 
+    /* Whole cycles of the carrier, repeated to fill as much of the table as
+     * possible, or empty if a cycle doesn't fit.
+     */
+    alignas(16) std::array<float,MaxCarrierTable> mCarrier{};
+    uint mCarrierLength{0};
+
     alignas(16) FloatBufferLine mModSamples{};
-    alignas(16) FloatBufferLine mBuffer{};
+    alignas(16) std::array<FloatBufferLine,BiquadFilter::ChainLanes> mBuffer{};
 
     struct OutParams {
         uint mTargetChannel{InvalidChannelIndex};
 
-        BiquadFilter mFilter;
+        std::array<BiquadFilter,1> mFilter;
 
         float mCurrentGain{};
         float mTargetGain{};
@@ -103,7 +114,7 @@ void ModulatorState::deviceUpdate(const DeviceBase*, const BufferStorage*)
     for(auto &e : mChans)
     {
         e.mTargetChannel = InvalidChannelIndex;
-        e.mFilter.clear();
+        e.mFilter[0].clear();
         e.mCurrentGain = 0.0f;
     }
 }
@@ -122,11 +133,13 @@ void ModulatorState::update(const ContextBase *context, const EffectSlot *slot,
      * many iterations per sample.
      */
     const float samplesPerCycle{props.Frequency > 0.0f
-        ? static_cast<float>(device->Frequency)/props.Frequency + 0.5f
+        ? static_cast<float>(device->mMixFrequency)/props.Frequency + 0.5f
         : 1.0f};
     const uint range{static_cast<uint>(std::clamp(samplesPerCycle, 1.0f,
-        static_cast<float>(device->Frequency)))};
+        static_cast<float>(device->mMixFrequency)))};
     mIndex = static_cast<uint>(uint64_t{mIndex} * range / mRange);
+    const uint oldRange{mRange};
+    const size_t oldGen{mSampleGen.index()};
     mRange = range;
 
     if(mRange == 1)
@@ -155,12 +168,34 @@ void ModulatorState::update(const ContextBase *context, const EffectSlot *slot,
         mSampleGen.emplace<SquareFunc>();
     }
 
-    float f0norm{props.HighPassCutoff / static_cast<float>(device->Frequency)};
+    /* Fill the carrier table when the waveform changes, so the generator
+     * doesn't need to be called for each sample.
+     */
+    if(mRange != oldRange || mSampleGen.index() != oldGen || mCarrierLength == 0)
+    {
+        mCarrierLength = 0;
+        if(mRange <= MaxCarrierTable)
+        {
+            const auto cycle = al::span{mCarrier}.first(mRange);
+            std::visit([cycle,scale=mIndexScale](auto&& type)
+            {
+                uint index{0};
+                std::generate(cycle.begin(), cycle.end(),
+                    [type,scale,&index] { return type.Get(index++, scale); });
+            }, mSampleGen);
+
+            mCarrierLength = static_cast<uint>(MaxCarrierTable / mRange * mRange);
+            for(size_t pos{mRange};pos < mCarrierLength;pos += mRange)
+                std::copy(cycle.begin(), cycle.end(), mCarrier.begin()+ptrdiff_t(pos));
+        }
+    }
+
+    float f0norm{props.HighPassCutoff / static_cast<float>(device->mMixFrequency)};
     f0norm = std::clamp(f0norm, 1.0f/512.0f, 0.49f);
     /* Bandwidth value is constant in octaves. */
-    mChans[0].mFilter.setParamsFromBandwidth(BiquadType::HighPass, f0norm, 1.0f, 0.75f);
+    mChans[0].mFilter[0].setParamsFromBandwidth(BiquadType::HighPass, f0norm, 1.0f, 0.75f);
     for(size_t i{1u};i < slot->Wet.Buffer.size();++i)
-        mChans[i].mFilter.copyParamsFrom(mChans[0].mFilter);
+        mChans[i].mFilter[0].copyParamsFrom(mChans[0].mFilter[0]);
 
     mOutTarget = target.Main->Buffer;
     auto set_channel = [this](size_t idx, uint outchan, float outgain)
@@ -175,39 +210,81 @@ void ModulatorState::process(const size_t samplesToDo, const al::span<const Floa
 {
     ASSUME(samplesToDo > 0);
 
-    std::visit([this,samplesToDo](auto&& type)
+    /* Generate the carrier once for all channels, copying it from the table
+     * when it fits.
+     */
+    if(const size_t tablelen{mCarrierLength}; tablelen > 0)
     {
         const uint range{mRange};
-        const float scale{mIndexScale};
-        uint index{mIndex};
-
-        ASSUME(range > 1);
-
+        size_t index{mIndex};
         for(size_t i{0};i < samplesToDo;)
         {
-            size_t rem{std::min(samplesToDo-i, size_t{range-index})};
-            do {
-                mModSamples[i++] = type.Get(index++, scale);
-            } while(--rem);
-            if(index == range)
-                index = 0;
+            const size_t todo{std::min(samplesToDo-i, tablelen-index)};
+            std::copy_n(mCarrier.cbegin()+ptrdiff_t(index), todo,
+                mModSamples.begin()+ptrdiff_t(i));
+            i += todo;
+            index = (index+todo) % range;
         }
-        mIndex = index;
-    }, mSampleGen);
+        mIndex = static_cast<uint>(index);
+    }
+    else
+    {
+        std::visit([this,samplesToDo](auto&& type)
+        {
+            const uint range{mRange};
+            const float scale{mIndexScale};
+            uint index{mIndex};
+
+            ASSUME(range > 1);
+
+            for(size_t i{0};i < samplesToDo;)
+            {
+                size_t rem{std::min(samplesToDo-i, size_t{range-index})};
+                do {
+                    mModSamples[i++] = type.Get(index++, scale);
+                } while(--rem);
+                if(index == range)
+                    index = 0;
+            }
+            mIndex = index;
+        }, mSampleGen);
+    }
 
-    auto chandata = mChans.begin();
-    for(const auto &input : samplesIn)
+    /* Filter groups of input channels together, with each channel in its own
+     * SIMD lane, then apply the carrier to each.
+     */
+    static constexpr size_t NumLanes{BiquadFilter::ChainLanes};
+    const auto carrier = al::span{mModSamples}.first(samplesToDo);
+    for(size_t base{0};base < samplesIn.size();base += NumLanes)
     {
-        if(const size_t outidx{chandata->mTargetChannel}; outidx != InvalidChannelIndex)
+        const size_t numchans{std::min(samplesIn.size()-base, NumLanes)};
+        const auto chans = al::span{mChans}.subspan(base, numchans);
+        if(std::none_of(chans.begin(), chans.end(), [](const OutParams &chan) noexcept
+            { return chan.mTargetChannel != InvalidChannelIndex; }))
+            continue;
+
+        std::array<al::span<BiquadFilter>,NumLanes> chains{};
+        std::array<al::span<const float>,NumLanes> inbufs{};
+        std::array<al::span<float>,NumLanes> outbufs{};
+        for(size_t c{0};c < numchans;++c)
         {
-            chandata->mFilter.process(al::span{input}.first(samplesToDo), mBuffer);
-            std::transform(mBuffer.cbegin(), mBuffer.cbegin()+samplesToDo, mModSamples.cbegin(),
-                mBuffer.begin(), std::multiplies<>{});
+            chains[c] = chans[c].mFilter;
+            inbufs[c] = al::span{samplesIn[base+c]}.first(samplesToDo);
+            outbufs[c] = al::span{mBuffer[c]}.first(samplesToDo);
+        }
+        BiquadFilter::processChain(al::span{chains}.first(numchans),
+            al::span{inbufs}.first(numchans), al::span{outbufs}.first(numchans));
 
-            MixSamples(al::span{mBuffer}.first(samplesToDo), samplesOut[outidx],
-                chandata->mCurrentGain, chandata->mTargetGain, std::min(samplesToDo, 64_uz));
+        for(size_t c{0};c < numchans;++c)
+        {
+            if(const size_t outidx{chans[c].mTargetChannel}; outidx != InvalidChannelIndex)
+            {
+                std::transform(outbufs[c].begin(), outbufs[c].end(), carrier.begin(),
+                    outbufs[c].begin(), std::multiplies<>{});
+                MixSamples(outbufs[c], samplesOut[outidx], chans[c].mCurrentGain,
+                    chans[c].mTargetGain, std::min(samplesToDo, 64_uz));
+            }
         }
-        ++chandata;
     }
 }
 
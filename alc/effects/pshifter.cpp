@@ -25,7 +25,9 @@
 #include <cmath>
 #include <complex>
 #include <cstdlib>
+#include <limits>
 #include <variant>
+#include <vector>
 
 #include "alc/effects/base.h"
 #include "alnumbers.h"
@@ -40,6 +42,7 @@
 #include "core/mixer/defs.h"
 #include "intrusive_ptr.h"
 #include "pffft.h"
+#include "vector.h"
 
 struct BufferStorage;
 struct ContextBase;
@@ -50,29 +53,46 @@ namespace {
 using uint = unsigned int;
 using complex_f = std::complex<float>;
 
-constexpr size_t StftSize{1024};
-constexpr size_t StftHalfSize{StftSize >> 1};
 constexpr size_t OversampleFactor{8};
 
-static_assert(StftSize%OversampleFactor == 0, "Factor must be a clean divisor of the size");
-constexpr size_t StftStep{StftSize / OversampleFactor};
 
-/* Define a Hann window, used to filter the STFT input and output. */
-struct Windower {
-    alignas(16) std::array<float,StftSize> mData{};
+/* Cheap approximations for converting between rectangular and polar forms.
+ * These are written to allow the compiler to vectorize the loops they're used
+ * in, unlike the standard library functions.
+ */
 
-    Windower()
-    {
-        /* Create lookup table of the Hann window for the desired size. */
-        for(size_t i{0};i < StftHalfSize;i++)
-        {
-            constexpr double scale{al::numbers::pi / double{StftSize}};
-            const double val{std::sin((static_cast<double>(i)+0.5) * scale)};
-            mData[i] = mData[StftSize-1-i] = static_cast<float>(val * val);
-        }
-    }
-};
-const Windower gWindow{};
+/* Approximates atan2(y, x) within about 1e-5 radians. */
+inline float FastAtan2(const float y, const float x) noexcept
+{
+    const float ax{std::abs(x)};
+    const float ay{std::abs(y)};
+    const float a{std::min(ax, ay) / std::max(std::max(ax, ay), std::numeric_limits<float>::min())};
+    const float s{a * a};
+    float r{((-0.0464964749f*s + 0.15931422f)*s - 0.327622764f)*s*a + a};
+    r = (ay > ax) ? al::numbers::pi_v<float>*0.5f - r : r;
+    r = (x < 0.0f) ? al::numbers::pi_v<float> - r : r;
+    return (y < 0.0f) ? -r : r;
+}
+
+/* Approximates sin(x) for x within -pi/2...+pi/2. */
+inline float FastSinHalf(const float x) noexcept
+{
+    const float x2{x * x};
+    return x*(1.0f + x2*(-1.0f/6.0f + x2*(1.0f/120.0f + x2*(-1.0f/5040.0f
+        + x2*(1.0f/362880.0f)))));
+}
+
+/* Approximates sin(x) for x within -pi...+pi. */
+inline float FastSin(const float x) noexcept
+{
+    constexpr float pi{al::numbers::pi_v<float>};
+    const float folded{(x > pi*0.5f) ? pi - x : (x < -pi*0.5f) ? -pi - x : x};
+    return FastSinHalf(folded);
+}
+
+/* Approximates cos(x) for x within -pi...+pi. */
+inline float FastCos(const float x) noexcept
+{ return FastSinHalf(al::numbers::pi_v<float>*0.5f - std::abs(x)); }
 
 
 struct FrequencyBin {
@@ -82,24 +102,38 @@ struct FrequencyBin {
 
 
 struct PshifterState final : public EffectState {
+    /* STFT size and options, set from the user config on device update. */
+    size_t mStftSize{};
+    size_t mStftHalfSize{};
+    size_t mStftStep{};
+    bool mFastMath{false};
+
     /* Effect parameters */
     size_t mCount{};
     size_t mPos{};
     uint mPitchShiftI{};
     float mPitchShift{};
 
+    /* Hann window, used to filter the STFT input and output. */
+    al::vector<float,16> mWindow;
+
     /* Effects buffers */
-    std::array<float,StftSize> mFIFO{};
-    std::array<float,StftHalfSize+1> mLastPhase{};
-    std::array<float,StftHalfSize+1> mSumPhase{};
-    std::array<float,StftSize> mOutputAccum{};
+    al::vector<float,16> mFIFO;
+    al::vector<float,16> mLastPhase;
+    al::vector<float,16> mSumPhase;
+    al::vector<float,16> mOutputAccum;
 
     PFFFTSetup mFft;
-    alignas(16) std::array<float,StftSize> mFftBuffer{};
-    alignas(16) std::array<float,StftSize> mFftWorkBuffer{};
+    al::vector<float,16> mFftBuffer;
+    al::vector<float,16> mFftWorkBuffer;
 
-    std::array<FrequencyBin,StftHalfSize+1> mAnalysisBuffer{};
-    std::array<FrequencyBin,StftHalfSize+1> mSynthesisBuffer{};
+    /* Analyzed magnitudes, phases, and frequency bins, stored separately for
+     * the vectorized loops.
+     */
+    al::vector<float,16> mMagnitude;
+    al::vector<float,16> mPhase;
+    al::vector<float,16> mFreqBin;
+    std::vector<FrequencyBin> mSynthesisBuffer;
 
     alignas(16) FloatBufferLine mBufferOut{};
 
@@ -107,35 +141,70 @@ struct PshifterState final : public EffectState {
     std::array<float,MaxAmbiChannels> mCurrentGains{};
     std::array<float,MaxAmbiChannels> mTargetGains{};
 
+    ~PshifterState() override;
 
     void deviceUpdate(const DeviceBase *device, const BufferStorage *buffer) override;
     void update(const ContextBase *context, const EffectSlot *slot, const EffectProps *props,
         const EffectTarget target) override;
     void process(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn,
         const al::span<FloatBufferLine> samplesOut) override;
+    [[nodiscard]] auto inputChannels() const noexcept -> size_t override { return 1; }
 };
 
-void PshifterState::deviceUpdate(const DeviceBase*, const BufferStorage*)
+PshifterState::~PshifterState() = default;
+
+void PshifterState::deviceUpdate(const DeviceBase *device, const BufferStorage*)
 {
+    if(mStftSize != PshifterStftSize)
+    {
+        mStftSize = PshifterStftSize;
+        mStftHalfSize = mStftSize >> 1;
+        mStftStep = mStftSize / OversampleFactor;
+
+        /* Create lookup table of the Hann window for the desired size. */
+        mWindow.resize(mStftSize);
+        for(size_t i{0};i < mStftHalfSize;i++)
+        {
+            const double scale{al::numbers::pi / static_cast<double>(mStftSize)};
+            const double val{std::sin((static_cast<double>(i)+0.5) * scale)};
+            mWindow[i] = mWindow[mStftSize-1-i] = static_cast<float>(val * val);
+        }
+
+        mFIFO.resize(mStftSize);
+        mOutputAccum.resize(mStftSize);
+        mFftBuffer.resize(mStftSize);
+        mFftWorkBuffer.resize(mStftSize);
+        mLastPhase.resize(mStftHalfSize+1);
+        mSumPhase.resize(mStftHalfSize+1);
+        mMagnitude.resize(mStftHalfSize+1);
+        mPhase.resize(mStftHalfSize+1);
+        mFreqBin.resize(mStftHalfSize+1);
+        mSynthesisBuffer.resize(mStftHalfSize+1);
+
+        mFft = PFFFTSetup{static_cast<uint>(mStftSize), PFFFT_REAL};
+    }
+    mFastMath = PshifterFastMath;
+    setMemoryUsage(device->mMemory, (mStftSize*5 + (mStftHalfSize+1)*5)*sizeof(float)
+        + mSynthesisBuffer.size()*sizeof(FrequencyBin));
+
     /* (Re-)initializing parameters and clear the buffers. */
     mCount       = 0;
-    mPos         = StftSize - StftStep;
+    mPos         = mStftSize - mStftStep;
     mPitchShiftI = MixerFracOne;
     mPitchShift  = 1.0f;
 
-    mFIFO.fill(0.0f);
-    mLastPhase.fill(0.0f);
-    mSumPhase.fill(0.0f);
-    mOutputAccum.fill(0.0f);
-    mFftBuffer.fill(0.0f);
-    mAnalysisBuffer.fill(FrequencyBin{});
-    mSynthesisBuffer.fill(FrequencyBin{});
+    std::fill(mFIFO.begin(), mFIFO.end(), 0.0f);
+    std::fill(mLastPhase.begin(), mLastPhase.end(), 0.0f);
+    std::fill(mSumPhase.begin(), mSumPhase.end(), 0.0f);
+    std::fill(mOutputAccum.begin(), mOutputAccum.end(), 0.0f);
+    std::fill(mFftBuffer.begin(), mFftBuffer.end(), 0.0f);
+    std::fill(mMagnitude.begin(), mMagnitude.end(), 0.0f);
+    std::fill(mPhase.begin(), mPhase.end(), 0.0f);
+    std::fill(mFreqBin.begin(), mFreqBin.end(), 0.0f);
+    std::fill(mSynthesisBuffer.begin(), mSynthesisBuffer.end(), FrequencyBin{});
 
     mCurrentGains.fill(0.0f);
     mTargetGains.fill(0.0f);
-
-    if(!mFft)
-        mFft = PFFFTSetup{StftSize, PFFFT_REAL};
 }
 
 void PshifterState::update(const ContextBase*, const EffectSlot *slot,
@@ -166,14 +235,18 @@ void PshifterState::process(const size_t samplesToDo,
      */
     constexpr float expected_cycles{al::numbers::pi_v<float>*2.0f / OversampleFactor};
 
+    const size_t stftSize{mStftSize};
+    const size_t halfSize{mStftHalfSize};
+    const size_t stftStep{mStftStep};
+
     for(size_t base{0u};base < samplesToDo;)
     {
-        const size_t todo{std::min(StftStep-mCount, samplesToDo-base)};
+        const size_t todo{std::min(stftStep-mCount, samplesToDo-base)};
 
         /* Retrieve the output samples from the FIFO and fill in the new input
          * samples.
          */
-        auto fifo_iter = mFIFO.begin()+mPos + mCount;
+        auto fifo_iter = mFIFO.begin() + ptrdiff_t(mPos+mCount);
         std::copy_n(fifo_iter, todo, mBufferOut.begin()+base);
 
         std::copy_n(samplesIn[0].begin()+base, todo, fifo_iter);
@@ -181,31 +254,49 @@ void PshifterState::process(const size_t samplesToDo,
         base += todo;
 
         /* Check whether FIFO buffer is filled with new samples. */
-        if(mCount < StftStep) break;
+        if(mCount < stftStep) break;
         mCount = 0;
-        mPos = (mPos+StftStep) & (mFIFO.size()-1);
+        mPos = (mPos+stftStep) & (stftSize-1);
 
         /* Time-domain signal windowing, store in FftBuffer, and apply a
          * forward FFT to get the frequency-domain signal.
          */
-        for(size_t src{mPos}, k{0u};src < StftSize;++src,++k)
-            mFftBuffer[k] = mFIFO[src] * gWindow.mData[k];
-        for(size_t src{0u}, k{StftSize-mPos};src < mPos;++src,++k)
-            mFftBuffer[k] = mFIFO[src] * gWindow.mData[k];
+        for(size_t src{mPos}, k{0u};src < stftSize;++src,++k)
+            mFftBuffer[k] = mFIFO[src] * mWindow[k];
+        for(size_t src{0u}, k{stftSize-mPos};src < mPos;++src,++k)
+            mFftBuffer[k] = mFIFO[src] * mWindow[k];
         mFft.transform_ordered(mFftBuffer.data(), mFftBuffer.data(), mFftWorkBuffer.data(),
             PFFFT_FORWARD);
 
         /* Analyze the obtained data. Since the real FFT is symmetric, only
-         * StftHalfSize+1 samples are needed.
+         * StftHalfSize+1 samples are needed. The DC and Nyquist bins are real
+         * and packed into the first two values.
          */
-        for(size_t k{0u};k < StftHalfSize+1;++k)
+        const auto fftbuf = al::span{mFftBuffer};
+        const auto magnitude = al::span{mMagnitude};
+        const auto phase = al::span{mPhase};
+        magnitude[0] = std::abs(fftbuf[0]);
+        phase[0] = std::arg(complex_f{fftbuf[0]});
+        magnitude[halfSize] = std::abs(fftbuf[1]);
+        phase[halfSize] = std::arg(complex_f{fftbuf[1]});
+        for(size_t k{1u};k < halfSize;++k)
+        {
+            const float re{fftbuf[k*2]}, im{fftbuf[k*2 + 1]};
+            magnitude[k] = std::sqrt(re*re + im*im);
+        }
+        if(mFastMath)
         {
-            const auto cplx = (k == 0) ? complex_f{mFftBuffer[0]} :
-                (k == StftHalfSize) ? complex_f{mFftBuffer[1]} :
-                complex_f{mFftBuffer[k*2], mFftBuffer[k*2 + 1]};
-            const float magnitude{std::abs(cplx)};
-            const float phase{std::arg(cplx)};
+            for(size_t k{1u};k < halfSize;++k)
+                phase[k] = FastAtan2(fftbuf[k*2 + 1], fftbuf[k*2]);
+        }
+        else
+        {
+            for(size_t k{1u};k < halfSize;++k)
+                phase[k] = std::atan2(fftbuf[k*2 + 1], fftbuf[k*2]);
+        }
 
+        for(size_t k{0u};k < halfSize+1;++k)
+        {
             /* Compute the phase difference from the last update and subtract
              * the expected phase difference for this bin.
              *
@@ -214,13 +305,13 @@ void PshifterState::process(const size_t samplesToDo,
              * every 'OversampleFactor' bin.
              */
             const auto bin_offset = static_cast<float>(k % OversampleFactor);
-            float tmp{(phase - mLastPhase[k]) - bin_offset*expected_cycles};
+            float tmp{(phase[k] - mLastPhase[k]) - bin_offset*expected_cycles};
             /* Store the actual phase for the next update. */
-            mLastPhase[k] = phase;
+            mLastPhase[k] = phase[k];
 
             /* Normalize from pi, and wrap the delta between -1 and +1. */
             tmp *= al::numbers::inv_pi_v<float>;
-            int qpd{float2int(tmp)};
+            const auto qpd = static_cast<int>(tmp);
             tmp -= static_cast<float>(qpd + (qpd%2));
 
             /* Get deviation from bin frequency (-0.5 to +0.5), and account for
@@ -228,13 +319,11 @@ void PshifterState::process(const size_t samplesToDo,
              */
             tmp *= 0.5f * OversampleFactor;
 
-            /* Compute the k-th partials' frequency bin target and store the
-             * magnitude and frequency bin in the analysis buffer. We don't
-             * need the "true frequency" since it's a linear relationship with
-             * the bin.
+            /* Compute the k-th partials' frequency bin target. We don't need
+             * the "true frequency" since it's a linear relationship with the
+             * bin.
              */
-            mAnalysisBuffer[k].Magnitude = magnitude;
-            mAnalysisBuffer[k].FreqBin = static_cast<float>(k) + tmp;
+            mFreqBin[k] = static_cast<float>(k) + tmp;
         }
 
         /* Shift the frequency bins according to the pitch adjustment,
@@ -242,8 +331,8 @@ void PshifterState::process(const size_t samplesToDo,
          */
         std::fill(mSynthesisBuffer.begin(), mSynthesisBuffer.end(), FrequencyBin{});
 
-        static constexpr size_t bin_limit{((StftHalfSize+1)<<MixerFracBits) - MixerFracHalf - 1};
-        const size_t bin_count{std::min(StftHalfSize+1, bin_limit/mPitchShiftI + 1)};
+        const size_t bin_limit{((halfSize+1)<<MixerFracBits) - MixerFracHalf - 1};
+        const size_t bin_count{std::min(halfSize+1, bin_limit/mPitchShiftI + 1)};
         for(size_t k{0u};k < bin_count;k++)
         {
             const size_t j{(k*mPitchShiftI + MixerFracHalf) >> MixerFracBits};
@@ -252,15 +341,15 @@ void PshifterState::process(const size_t samplesToDo,
              * bin for the one with the dominant magnitude. There might be a
              * better way to handle this, but it's better than last-index-wins.
              */
-            if(mAnalysisBuffer[k].Magnitude > mSynthesisBuffer[j].Magnitude)
-                mSynthesisBuffer[j].FreqBin = mAnalysisBuffer[k].FreqBin * mPitchShift;
-            mSynthesisBuffer[j].Magnitude += mAnalysisBuffer[k].Magnitude;
+            if(magnitude[k] > mSynthesisBuffer[j].Magnitude)
+                mSynthesisBuffer[j].FreqBin = mFreqBin[k] * mPitchShift;
+            mSynthesisBuffer[j].Magnitude += magnitude[k];
         }
 
         /* Reconstruct the frequency-domain signal from the adjusted frequency
          * bins.
          */
-        for(size_t k{0u};k < StftHalfSize+1;k++)
+        for(size_t k{0u};k < halfSize+1;k++)
         {
             /* Calculate the actual delta phase for this bin's target frequency
              * bin, and accumulate it to get the actual bin phase.
@@ -272,19 +361,29 @@ void PshifterState::process(const size_t samplesToDo,
              * phase over time.
              */
             tmp *= al::numbers::inv_pi_v<float>;
-            int qpd{float2int(tmp)};
+            const auto qpd = static_cast<int>(tmp);
             tmp -= static_cast<float>(qpd + (qpd%2));
             mSumPhase[k] = tmp * al::numbers::pi_v<float>;
 
-            const complex_f cplx{std::polar(mSynthesisBuffer[k].Magnitude, mSumPhase[k])};
-            if(k == 0)
-                mFftBuffer[0] = cplx.real();
-            else if(k == StftHalfSize)
-                mFftBuffer[1] = cplx.real();
-            else
+            magnitude[k] = mSynthesisBuffer[k].Magnitude;
+        }
+
+        fftbuf[0] = magnitude[0] * std::cos(mSumPhase[0]);
+        fftbuf[1] = magnitude[halfSize] * std::cos(mSumPhase[halfSize]);
+        if(mFastMath)
+        {
+            for(size_t k{1u};k < halfSize;k++)
+            {
+                fftbuf[k*2 + 0] = magnitude[k] * FastCos(mSumPhase[k]);
+                fftbuf[k*2 + 1] = magnitude[k] * FastSin(mSumPhase[k]);
+            }
+        }
+        else
+        {
+            for(size_t k{1u};k < halfSize;k++)
             {
-                mFftBuffer[k*2 + 0] = cplx.real();
-                mFftBuffer[k*2 + 1] = cplx.imag();
+                fftbuf[k*2 + 0] = magnitude[k] * std::cos(mSumPhase[k]);
+                fftbuf[k*2 + 1] = magnitude[k] * std::sin(mSumPhase[k]);
             }
         }
 
@@ -294,15 +393,16 @@ void PshifterState::process(const size_t samplesToDo,
         mFft.transform_ordered(mFftBuffer.data(), mFftBuffer.data(), mFftWorkBuffer.data(),
             PFFFT_BACKWARD);
 
-        static constexpr float scale{3.0f / OversampleFactor / StftSize};
-        for(size_t dst{mPos}, k{0u};dst < StftSize;++dst,++k)
-            mOutputAccum[dst] += gWindow.mData[k]*mFftBuffer[k] * scale;
-        for(size_t dst{0u}, k{StftSize-mPos};dst < mPos;++dst,++k)
-            mOutputAccum[dst] += gWindow.mData[k]*mFftBuffer[k] * scale;
+        const float scale{3.0f / OversampleFactor / static_cast<float>(stftSize)};
+        for(size_t dst{mPos}, k{0u};dst < stftSize;++dst,++k)
+            mOutputAccum[dst] += mWindow[k]*mFftBuffer[k] * scale;
+        for(size_t dst{0u}, k{stftSize-mPos};dst < mPos;++dst,++k)
+            mOutputAccum[dst] += mWindow[k]*mFftBuffer[k] * scale;
 
         /* Copy out the accumulated result, then clear for the next iteration. */
-        std::copy_n(mOutputAccum.begin() + mPos, StftStep, mFIFO.begin() + mPos);
-        std::fill_n(mOutputAccum.begin() + mPos, StftStep, 0.0f);
+        std::copy_n(mOutputAccum.begin() + ptrdiff_t(mPos), stftStep,
+            mFIFO.begin() + ptrdiff_t(mPos));
+        std::fill_n(mOutputAccum.begin() + ptrdiff_t(mPos), stftStep, 0.0f);
     }
 
     /* Now, mix the processed sound data to the output. */
@@ -27,6 +27,7 @@
 #include <cstdint>
 #include <cstdio>
 #include <functional>
+#include <memory>
 #include <numeric>
 #include <utility>
 #include <variant>
@@ -41,6 +42,7 @@
 #include "core/cubic_tables.h"
 #include "core/device.h"
 #include "core/effects/base.h"
+#include "core/effects/rate_converter.h"
 #include "core/effectslot.h"
 #include "core/filters/biquad.h"
 #include "core/filters/splitter.h"
@@ -59,6 +61,13 @@ using uint = unsigned int;
 constexpr float MaxModulationTime{4.0f};
 constexpr float DefaultModulationTime{0.25f};
 
+/* The largest changes in decay time (as a ratio) and diffusion that are
+ * applied to the current pipeline in place. Bigger changes cross-fade to a new
+ * pipeline instead.
+ */
+constexpr float MaxMorphDecayRatio{1.1f};
+constexpr float MaxMorphDiffusion{0.1f};
+
 #define MOD_FRACBITS 24
 #define MOD_FRACONE  (1<<MOD_FRACBITS)
 #define MOD_FRACMASK (MOD_FRACONE-1)
@@ -76,6 +85,13 @@ constexpr size_t MAX_UPDATE_SAMPLES{256};
  */
 constexpr size_t NUM_LINES{4u};
 
+/* The late reverb can use multiple banks of NUM_LINES feedback lines, for a
+ * denser tail. Each bank reuses the 4-line processing, and the banks are
+ * cross-coupled with a Hadamard matrix so they act as one larger feedback
+ * network. This must be a power of two.
+ */
+constexpr size_t MaxLateBanks{4u};
+
 
 /* This coefficient is used to define the maximum frequency range controlled by
  * the modulation depth. The current value of 0.05 will allow it to swing from
@@ -251,6 +267,14 @@ constexpr std::array<float,NUM_LINES> LATE_LINE_LENGTHS{{
     1.9419362e-3f, 2.4466860e-3f, 3.3791220e-3f, 3.8838720e-3f
 }};
 
+/* Additional late line banks scale the late line and all-pass lengths so the
+ * extra lines fall in between the first bank's, given as powers of two (1,
+ * 2^(1/4), 2^(-1/6), 2^(1/8)).
+ */
+constexpr std::array<float,MaxLateBanks> LATE_BANK_SCALES{{
+    1.0000000e+0f, 1.1892071e+0f, 8.9089871e-1f, 1.0905077e+0f
+}};
+
 
 using ReverbUpdateLine = std::array<float,MAX_UPDATE_SAMPLES>;
 
@@ -320,6 +344,20 @@ struct DelayLineU {
         }
     }
 
+    void read(size_t offset, const size_t c, al::span<float> out) const noexcept
+    {
+        const size_t stride{mLine.size() / NUM_LINES};
+        const auto input = mLine.subspan(c*stride, stride);
+        while(!out.empty())
+        {
+            offset &= stride-1;
+            const size_t td{std::min(stride - offset, out.size())};
+            std::copy_n(input.begin() + ptrdiff_t(offset), td, out.begin());
+            offset += td;
+            out = out.subspan(td);
+        }
+    }
+
     /* Writes the given input lines to the delay buffer, applying a geometric
      * reflection. This effectively applies the matrix
      *
@@ -448,23 +486,27 @@ struct Modulation {
 };
 
 struct LateReverb {
-    /* A recursive delay line is used fill in the reverb tail. */
-    DelayLineU Delay;
-    std::array<size_t,NUM_LINES> Offset{};
+    struct LineBank {
+        /* A recursive delay line is used fill in the reverb tail. */
+        DelayLineU Delay;
+        std::array<size_t,NUM_LINES> Offset{};
+
+        /* T60 decay filters are used to simulate absorption. */
+        std::array<T60Filter,NUM_LINES> T60;
+
+        /* A Gerzon vector all-pass filter is used to simulate diffusion. */
+        VecAllpass VecAp;
+    };
+    std::array<LineBank,MaxLateBanks> Banks;
+    size_t NumBanks{1};
 
     /* Attenuation to compensate for the modal density and decay rate of the
      * late lines.
      */
     float DensityGain{0.0f};
 
-    /* T60 decay filters are used to simulate absorption. */
-    std::array<T60Filter,NUM_LINES> T60;
-
     Modulation Mod;
 
-    /* A Gerzon vector all-pass filter is used to simulate diffusion. */
-    VecAllpass VecAp;
-
     /* The gain for each output channel based on 3D panning. */
     struct OutGains {
         std::array<float,MaxAmbiChannels> Current{};
@@ -480,7 +522,8 @@ struct LateReverb {
 
     void clear()
     {
-        std::for_each(T60.begin(), T60.end(), std::mem_fn(&T60Filter::clear));
+        for(auto &bank : Banks)
+            std::for_each(bank.T60.begin(), bank.T60.end(), std::mem_fn(&T60Filter::clear));
         Mod.clear();
         std::for_each(Gains.begin(), Gains.end(), std::mem_fn(&OutGains::clear));
     }
@@ -519,17 +562,23 @@ struct ReverbPipeline {
 
     size_t mFadeSampleCount{1};
 
+    ReverbZoneMode mMode{ReverbZoneMode::Full};
+
     void updateDelayLine(const float gain, const float earlyDelay, const float lateDelay,
         const float density_mult, const float decayTime, const float frequency);
     void update3DPanning(const al::span<const float,3> ReflectionsPan,
         const al::span<const float,3> LateReverbPan, const float earlyGain, const float lateGain,
         const bool doUpmix, const MixParams *mainMix);
 
+    void loadEarlyTaps(const DelayLineU &main_delay, const size_t offset, const size_t todo,
+        const al::span<ReverbUpdateLine,NUM_LINES> tempSamples);
     void processEarly(const DelayLineU &main_delay, size_t offset, const size_t samplesToDo,
         const al::span<ReverbUpdateLine,NUM_LINES> tempSamples,
         const al::span<FloatBufferLine,NUM_LINES> outSamples);
+    void processLateFeed(const DelayLineU &main_delay, size_t offset, const size_t samplesToDo,
+        const al::span<ReverbUpdateLine,NUM_LINES> tempSamples);
     void processLate(size_t offset, const size_t samplesToDo,
-        const al::span<ReverbUpdateLine,NUM_LINES> tempSamples,
+        const al::span<ReverbUpdateLine,NUM_LINES*MaxLateBanks> tempSamples,
         const al::span<FloatBufferLine,NUM_LINES> outSamples);
 
     void clear() noexcept
@@ -565,6 +614,7 @@ struct ReverbState final : public EffectState {
         float ModulationDepth{0.0f};
         float HFReference{5000.0f};
         float LFReference{250.0f};
+        ReverbZoneMode ZoneMode{ReverbZoneMode::Full};
     };
     Params mParams;
 
@@ -588,7 +638,7 @@ struct ReverbState final : public EffectState {
 
     /* Temporary storage used when processing. */
     alignas(16) FloatBufferLine mTempLine{};
-    alignas(16) std::array<ReverbUpdateLine,NUM_LINES> mTempSamples{};
+    alignas(16) std::array<ReverbUpdateLine,NUM_LINES*MaxLateBanks> mTempSamples{};
 
     alignas(16) std::array<FloatBufferLine,NUM_LINES> mEarlySamples{};
     alignas(16) std::array<FloatBufferLine,NUM_LINES> mLateSamples{};
@@ -597,6 +647,18 @@ struct ReverbState final : public EffectState {
 
     bool mUpmixOutput{false};
 
+    /* The number of samples it takes for input to reach the early and late
+     * reverb outputs, and how long the input has been silent for. Once the
+     * input's been silent for long enough and the output has decayed, the
+     * reverb goes idle.
+     */
+    size_t mIdleDelay{0u};
+    size_t mSilentCount{0u};
+    bool mIdle{false};
+
+    /* Set when the reverb runs at a reduced sample rate. */
+    std::unique_ptr<EffectRateConverter> mRateConverter;
+
 
     void MixOutPlain(ReverbPipeline &pipeline, const al::span<FloatBufferLine> samplesOut,
         const size_t todo) const
@@ -683,11 +745,17 @@ struct ReverbState final : public EffectState {
 
     void allocLines(const float frequency);
 
+    void processPipeline(ReverbPipeline &pipeline, const size_t offset, const size_t samplesToDo,
+        const al::span<FloatBufferLine> samplesOut);
+    void processSamples(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn,
+        const al::span<FloatBufferLine> samplesOut);
+
     void deviceUpdate(const DeviceBase *device, const BufferStorage *buffer) override;
     void update(const ContextBase *context, const EffectSlot *slot, const EffectProps *props,
         const EffectTarget target) override;
     void process(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn,
         const al::span<FloatBufferLine> samplesOut) override;
+    [[nodiscard]] bool isIdle() const noexcept override { return mIdle; }
 };
 
 /**************************************
@@ -713,7 +781,9 @@ void ReverbState::allocLines(const float frequency)
      */
     static constexpr float max_mod_delay{MaxModulationTime*MODULATION_DEPTH_COEFF / 2.0f};
 
-    std::array<size_t,11> linelengths{};
+    const size_t numBanks{std::clamp(size_t{ReverbLateLines}/NUM_LINES, 1_uz, MaxLateBanks)};
+
+    std::array<size_t,1 + 2*(3 + 2*MaxLateBanks)> linelengths{};
     size_t oidx{0};
 
     size_t totalSamples{0u};
@@ -746,22 +816,34 @@ void ReverbState::allocLines(const float frequency)
         linelengths[oidx++] = count;
         totalSamples += count;
 
-        /* The late vector all-pass line. */
-        length = LATE_ALLPASS_LENGTHS.back() * multiplier;
-        count = pipeline.mLate.VecAp.Delay.calcLineLength(length, frequency, 0);
-        linelengths[oidx++] = count;
-        totalSamples += count;
-
-        /* The late delay lines are calculated from the largest maximum density
-         * line length, and the maximum modulation delay. Four additional
-         * samples are needed for resampling the modulator delay.
-         */
-        length = LATE_LINE_LENGTHS.back()*multiplier + max_mod_delay;
-        count = pipeline.mLate.Delay.calcLineLength(length, frequency, 4);
-        linelengths[oidx++] = count;
-        totalSamples += count;
+        pipeline.mLate.NumBanks = numBanks;
+        for(size_t b{0};b < numBanks;++b)
+        {
+            auto &bank = pipeline.mLate.Banks[b];
+
+            /* The late vector all-pass line. */
+            length = LATE_ALLPASS_LENGTHS.back() * LATE_BANK_SCALES[b] * multiplier;
+            count = bank.VecAp.Delay.calcLineLength(length, frequency, 0);
+            linelengths[oidx++] = count;
+            totalSamples += count;
+
+            /* The late delay lines are calculated from the largest maximum
+             * density line length, and the maximum modulation delay. Four
+             * additional samples are needed for resampling the modulator
+             * delay.
+             */
+            length = LATE_LINE_LENGTHS.back()*LATE_BANK_SCALES[b]*multiplier + max_mod_delay;
+            count = bank.Delay.calcLineLength(length, frequency, 4);
+            linelengths[oidx++] = count;
+            totalSamples += count;
+        }
     }
-    assert(oidx == linelengths.size());
+    assert(oidx <= linelengths.size());
+
+    /* Input reaches the outputs after going through the main delay, the late
+     * input delay, and the early all-pass and reflection lines.
+     */
+    mIdleDelay = linelengths[0] + linelengths[1] + linelengths[2] + linelengths[3];
 
     if(totalSamples != mSampleBuffer.size())
         decltype(mSampleBuffer)(totalSamples).swap(mSampleBuffer);
@@ -782,20 +864,35 @@ void ReverbState::allocLines(const float frequency)
         bufferspan = bufferspan.subspan(linelengths[oidx++]);
         pipeline.mEarly.Delay.realizeLineOffset(bufferspan.first(linelengths[oidx]));
         bufferspan = bufferspan.subspan(linelengths[oidx++]);
-        pipeline.mLate.VecAp.Delay.realizeLineOffset(bufferspan.first(linelengths[oidx]));
-        bufferspan = bufferspan.subspan(linelengths[oidx++]);
-        pipeline.mLate.Delay.realizeLineOffset(bufferspan.first(linelengths[oidx]));
-        bufferspan = bufferspan.subspan(linelengths[oidx++]);
+        for(size_t b{0};b < pipeline.mLate.NumBanks;++b)
+        {
+            auto &bank = pipeline.mLate.Banks[b];
+            bank.VecAp.Delay.realizeLineOffset(bufferspan.first(linelengths[oidx]));
+            bufferspan = bufferspan.subspan(linelengths[oidx++]);
+            bank.Delay.realizeLineOffset(bufferspan.first(linelengths[oidx]));
+            bufferspan = bufferspan.subspan(linelengths[oidx++]);
+        }
     }
-    assert(oidx == linelengths.size());
+    assert(oidx <= linelengths.size());
 }
 
 void ReverbState::deviceUpdate(const DeviceBase *device, const BufferStorage*)
 {
-    const auto frequency = static_cast<float>(device->Frequency);
+    const uint divisor{EffectRateConverter::GetDivisor(ReverbRateDivisor, device->mMixFrequency)};
+    const auto frequency = static_cast<float>(device->mMixFrequency / divisor);
+
+    /* The output may go to the device's mixing buffer or another effect
+     * slot's.
+     */
+    if(divisor > 1)
+        mRateConverter = EffectRateConverter::Create(divisor, NUM_LINES,
+            std::max(device->MixBuffer.size(), MaxAmbiChannels));
+    else
+        mRateConverter = nullptr;
 
     /* Allocate the delay lines. */
     allocLines(frequency);
+    setMemoryUsage(device->mMemory, mSampleBuffer.size()*sizeof(float));
 
     std::for_each(mPipelines.begin(), mPipelines.end(), std::mem_fn(&ReverbPipeline::clear));
     mPipelineState = DeviceClear;
@@ -803,6 +900,9 @@ void ReverbState::deviceUpdate(const DeviceBase *device, const BufferStorage*)
     /* Reset offset base. */
     mOffset = 0;
 
+    mSilentCount = 0;
+    mIdle = false;
+
     if(device->mAmbiOrder > 1)
     {
         mUpmixOutput = true;
@@ -876,6 +976,10 @@ inline void CalcMatrixCoeffs(const float diffusion, float *x, float *y)
     *y = std::sin(t) / n;
 }
 
+/* Checks if a decay time change is small enough to be applied in place. */
+inline bool CanMorphDecay(const float oldtime, const float newtime)
+{ return std::max(oldtime, newtime) <= std::min(oldtime, newtime)*MaxMorphDecayRatio; }
+
 /* Calculate the limited HF ratio for use with the late reverb low-pass
  * filters.
  */
@@ -985,6 +1089,11 @@ void LateReverb::updateLines(const float density_mult, const float diffusion,
         std::accumulate(LATE_ALLPASS_LENGTHS.begin(), LATE_ALLPASS_LENGTHS.end(), 0.0f) /
         float{NUM_LINES}};
 
+    /* Extra banks are scaled up or down, changing the average line length. */
+    const auto banks = al::span{LATE_BANK_SCALES}.first(NumBanks);
+    const float bank_scale_avg{std::accumulate(banks.begin(), banks.end(), 0.0f) /
+        static_cast<float>(NumBanks)};
+
     /* To compensate for changes in modal density and decay time of the late
      * reverb signal, the input is attenuated based on the maximal energy of
      * the outgoing signal.  This approximation is used to keep the apparent
@@ -995,7 +1104,7 @@ void LateReverb::updateLines(const float density_mult, const float diffusion,
      */
     float length{std::accumulate(LATE_LINE_LENGTHS.begin(), LATE_LINE_LENGTHS.end(), 0.0f) /
         float{NUM_LINES} + late_allpass_avg};
-    length *= density_mult;
+    length *= density_mult * bank_scale_avg;
     /* The density gain calculation uses an average decay time weighted by
      * approximate bandwidth. This attempts to compensate for losses of energy
      * that reduce decay time due to scattering into highly attenuated bands.
@@ -1006,32 +1115,40 @@ void LateReverb::updateLines(const float density_mult, const float diffusion,
         (1.0f - hf0norm*norm_weight_factor)*hfDecayTime};
     DensityGain = CalcDensityGain(CalcDecayCoeff(length, decayTimeWeighted));
 
-    /* Calculate the all-pass feed-back/forward coefficient. */
-    VecAp.Coeff = diffusion*diffusion * InvSqrt2;
-
-    for(size_t i{0u};i < NUM_LINES;i++)
+    for(size_t b{0};b < NumBanks;++b)
     {
-        /* Calculate the delay length of each all-pass line. */
-        length = LATE_ALLPASS_LENGTHS[i] * density_mult;
-        VecAp.Offset[i] = float2uint(length * frequency);
+        auto &bank = Banks[b];
+        const float bank_mult{density_mult * LATE_BANK_SCALES[b]};
 
-        /* Calculate the delay length of each feedback delay line. A cubic
-         * resampler is used for modulation on the feedback delay, which
-         * includes one sample of delay. Reduce by one to compensate.
-         */
-        length = LATE_LINE_LENGTHS[i] * density_mult;
-        Offset[i] = std::max(float2uint(length*frequency + 0.5f), 1u) - 1u;
+        /* Calculate the all-pass feed-back/forward coefficient. */
+        bank.VecAp.Coeff = diffusion*diffusion * InvSqrt2;
 
-        /* Approximate the absorption that the vector all-pass would exhibit
-         * given the current diffusion so we don't have to process a full T60
-         * filter for each of its four lines. Also include the average
-         * modulation delay (depth is half the max delay in samples).
-         */
-        length += lerpf(LATE_ALLPASS_LENGTHS[i], late_allpass_avg, diffusion)*density_mult +
-            Mod.Depth/frequency;
+        for(size_t i{0u};i < NUM_LINES;i++)
+        {
+            /* Calculate the delay length of each all-pass line. */
+            length = LATE_ALLPASS_LENGTHS[i] * bank_mult;
+            bank.VecAp.Offset[i] = float2uint(length * frequency);
+
+            /* Calculate the delay length of each feedback delay line. A cubic
+             * resampler is used for modulation on the feedback delay, which
+             * includes one sample of delay. Reduce by one to compensate.
+             */
+            length = LATE_LINE_LENGTHS[i] * bank_mult;
+            bank.Offset[i] = std::max(float2uint(length*frequency + 0.5f), 1u) - 1u;
+
+            /* Approximate the absorption that the vector all-pass would
+             * exhibit given the current diffusion so we don't have to process
+             * a full T60 filter for each of its four lines. Also include the
+             * average modulation delay (depth is half the max delay in
+             * samples).
+             */
+            length += lerpf(LATE_ALLPASS_LENGTHS[i], late_allpass_avg, diffusion)*bank_mult +
+                Mod.Depth/frequency;
 
-        /* Calculate the T60 damping coefficients for each line. */
-        T60[i].calcCoeffs(length, lfDecayTime, mfDecayTime, hfDecayTime, lf0norm, hf0norm);
+            /* Calculate the T60 damping coefficients for each line. */
+            bank.T60[i].calcCoeffs(length, lfDecayTime, mfDecayTime, hfDecayTime, lf0norm,
+                hf0norm);
+        }
     }
 }
 
@@ -1191,7 +1308,8 @@ void ReverbState::update(const ContextBase *Context, const EffectSlot *Slot,
 {
     auto &props = std::get<ReverbProps>(*props_);
     const DeviceBase *Device{Context->mDevice};
-    const auto frequency = static_cast<float>(Device->Frequency);
+    const auto frequency = static_cast<float>(Device->mMixFrequency /
+        (mRateConverter ? mRateConverter->getDivisor() : 1u));
 
     /* If the HF limit parameter is flagged, calculate an appropriate limit
      * based on the air absorption parameter.
@@ -1206,19 +1324,20 @@ void ReverbState::update(const ContextBase *Context, const EffectSlot *Slot,
         MaxDecayTime)};
     const float hfDecayTime{std::clamp(props.DecayTime*hfRatio, MinDecayTime, MaxDecayTime)};
 
+    /* Determine if the diffusion or decay times changed. These alter the
+     * feedback coefficients and scattering matrices of the current pipeline.
+     */
+    const bool decayUpdate{mParams.Diffusion != props.Diffusion ||
+        mParams.DecayTime != props.DecayTime ||
+        mParams.HFDecayTime != hfDecayTime ||
+        mParams.LFDecayTime != lfDecayTime};
+
     /* Determine if a full update is required. */
     const bool fullUpdate{mPipelineState == DeviceClear ||
         /* Density is essentially a master control for the feedback delays, so
          * changes the offsets of many delay lines.
          */
         mParams.Density != props.Density ||
-        /* Diffusion and decay times influences the decay rate (gain) of the
-         * late reverb T60 filter.
-         */
-        mParams.Diffusion != props.Diffusion ||
-        mParams.DecayTime != props.DecayTime ||
-        mParams.HFDecayTime != hfDecayTime ||
-        mParams.LFDecayTime != lfDecayTime ||
         /* Modulation time and depth both require fading the modulation delay. */
         mParams.ModulationTime != props.ModulationTime ||
         mParams.ModulationDepth != props.ModulationDepth ||
@@ -1226,7 +1345,18 @@ void ReverbState::update(const ContextBase *Context, const EffectSlot *Slot,
          * gain.
          */
         mParams.HFReference != props.HFReference ||
-        mParams.LFReference != props.LFReference};
+        mParams.LFReference != props.LFReference ||
+        /* The zone mode changes which stages run. */
+        mParams.ZoneMode != props.ZoneMode ||
+        /* Small changes of the diffusion and decay times (the decay rate of
+         * the late reverb T60 filter) can be made to the current pipeline in
+         * place without being very noticeable, but larger changes need to
+         * fade to a new pipeline.
+         */
+        (decayUpdate && !(std::abs(mParams.Diffusion - props.Diffusion) <= MaxMorphDiffusion
+            && CanMorphDecay(mParams.DecayTime, props.DecayTime)
+            && CanMorphDecay(mParams.HFDecayTime, hfDecayTime)
+            && CanMorphDecay(mParams.LFDecayTime, lfDecayTime)))};
     if(fullUpdate)
     {
         mParams.Density = props.Density;
@@ -1238,6 +1368,7 @@ void ReverbState::update(const ContextBase *Context, const EffectSlot *Slot,
         mParams.ModulationDepth = props.ModulationDepth;
         mParams.HFReference = props.HFReference;
         mParams.LFReference = props.LFReference;
+        mParams.ZoneMode = props.ZoneMode;
 
         mPipelineState = (mPipelineState != DeviceClear) ? StartFade : Normal;
         mCurrentPipeline = !mCurrentPipeline;
@@ -1246,7 +1377,15 @@ void ReverbState::update(const ContextBase *Context, const EffectSlot *Slot,
         for(size_t j{0};j < NUM_LINES;++j)
             oldpipeline.mEarlyDelayCoeff[j][1] = 0.0f;
     }
+    else if(decayUpdate)
+    {
+        mParams.Diffusion = props.Diffusion;
+        mParams.DecayTime = props.DecayTime;
+        mParams.HFDecayTime = hfDecayTime;
+        mParams.LFDecayTime = lfDecayTime;
+    }
     auto &pipeline = mPipelines[mCurrentPipeline];
+    pipeline.mMode = props.ZoneMode;
 
     /* The density-based room size (delay length) multiplier. */
     const float density_mult{CalcDelayLengthMult(props.Density)};
@@ -1258,8 +1397,29 @@ void ReverbState::update(const ContextBase *Context, const EffectSlot *Slot,
     /* Update early and late 3D panning. */
     mOutTarget = target.Main->Buffer;
     const float gain{Slot->Gain * ReverbBoost};
-    pipeline.update3DPanning(props.ReflectionsPan, props.LateReverbPan, props.ReflectionsGain*gain,
-        props.LateReverbGain*gain, mUpmixOutput, target.Main);
+    switch(props.ZoneMode)
+    {
+    case ReverbZoneMode::Full:
+        pipeline.update3DPanning(props.ReflectionsPan, props.LateReverbPan,
+            props.ReflectionsGain*gain, props.LateReverbGain*gain, mUpmixOutput, target.Main);
+        break;
+    case ReverbZoneMode::EarlyZone:
+        /* An early zone leaves the reflections gain to the shared late reverb
+         * it feeds, so the late reverb gets the same level it would from its
+         * own early reflections.
+         */
+        pipeline.update3DPanning(props.ReflectionsPan, props.LateReverbPan, gain, 0.0f,
+            mUpmixOutput, target.Main);
+        break;
+    case ReverbZoneMode::SharedLate:
+        /* The input (the zones' early reflections) is passed through without
+         * panning, and already has the reverb boost applied.
+         */
+        static constexpr std::array<float,3> NoPan{};
+        pipeline.update3DPanning(NoPan, props.LateReverbPan, props.ReflectionsGain*Slot->Gain,
+            props.LateReverbGain*Slot->Gain, mUpmixOutput, target.Main);
+        break;
+    }
 
     /* Calculate the master filters */
     float hf0norm{std::min(props.HFReference/frequency, 0.49f)};
@@ -1272,9 +1432,12 @@ void ReverbState::update(const ContextBase *Context, const EffectSlot *Slot,
         pipeline.mFilter[i].Hp.copyParamsFrom(pipeline.mFilter[0].Hp);
     }
 
-    if(fullUpdate)
+    if(fullUpdate || decayUpdate)
     {
-        /* Update the early lines. */
+        /* Update the early lines. Without a full update, the density is
+         * unchanged so the line lengths stay the same, and only the decay and
+         * diffusion coefficients are changed.
+         */
         pipeline.mEarly.updateLines(density_mult, props.Diffusion, props.DecayTime, frequency);
 
         /* Get the mixing matrix coefficients. */
@@ -1474,6 +1637,53 @@ void Allpass4::process(const al::span<ReverbUpdateLine,NUM_LINES> samples, const
 }
 
 
+/* Loads the primary reflections from the main delay line, blending from the
+ * old taps to the new, and band-passes them.
+ */
+void ReverbPipeline::loadEarlyTaps(const DelayLineU &main_delay, const size_t offset,
+    const size_t todo, const al::span<ReverbUpdateLine,NUM_LINES> tempSamples)
+{
+    const auto fadeStep = float{1.0f / static_cast<float>(todo)};
+    for(size_t j{0_uz};j < NUM_LINES;j++)
+    {
+        const auto input = main_delay.get(j);
+        auto early_delay_tap0 = size_t{offset - mEarlyDelayTap[j][0]};
+        auto early_delay_tap1 = size_t{offset - mEarlyDelayTap[j][1]};
+        mEarlyDelayTap[j][0] = mEarlyDelayTap[j][1];
+        const auto coeff0 = float{mEarlyDelayCoeff[j][0]};
+        const auto coeff1 = float{mEarlyDelayCoeff[j][1]};
+        mEarlyDelayCoeff[j][0] = mEarlyDelayCoeff[j][1];
+        auto fadeCount = float{0.0f};
+
+        auto tmp = tempSamples[j].begin();
+        for(size_t i{0_uz};i < todo;)
+        {
+            early_delay_tap0 &= input.size()-1;
+            early_delay_tap1 &= input.size()-1;
+            const auto max_tap = size_t{std::max(early_delay_tap0, early_delay_tap1)};
+            const auto td = size_t{std::min(input.size()-max_tap, todo-i)};
+            const auto intap0 = input.subspan(early_delay_tap0, td);
+            const auto intap1 = input.subspan(early_delay_tap1, td);
+
+            auto do_blend = [coeff0,coeff1,fadeStep,&fadeCount](const float in0,
+                const float in1) noexcept -> float
+            {
+                const auto ret = lerpf(in0*coeff0, in1*coeff1, fadeStep*fadeCount);
+                fadeCount += 1.0f;
+                return ret;
+            };
+            tmp = std::transform(intap0.begin(), intap0.end(), intap1.begin(), tmp, do_blend);
+            early_delay_tap0 += td;
+            early_delay_tap1 += td;
+            i += td;
+        }
+
+        /* Band-pass the incoming samples. */
+        auto&& filter = DualBiquad{mFilter[j].Lp, mFilter[j].Hp};
+        filter.process(al::span{tempSamples[j]}.first(todo), tempSamples[j]);
+    }
+}
+
 /* This generates early reflections.
  *
  * This is done by obtaining the primary reflections (those arriving from the
@@ -1507,45 +1717,7 @@ void ReverbPipeline::processEarly(const DelayLineU &main_delay, size_t offset,
         /* First, load decorrelated samples from the main delay line as the
          * primary reflections.
          */
-        const auto fadeStep = float{1.0f / static_cast<float>(todo)};
-        for(size_t j{0_uz};j < NUM_LINES;j++)
-        {
-            const auto input = in_delay.get(j);
-            auto early_delay_tap0 = size_t{offset - mEarlyDelayTap[j][0]};
-            auto early_delay_tap1 = size_t{offset - mEarlyDelayTap[j][1]};
-            mEarlyDelayTap[j][0] = mEarlyDelayTap[j][1];
-            const auto coeff0 = float{mEarlyDelayCoeff[j][0]};
-            const auto coeff1 = float{mEarlyDelayCoeff[j][1]};
-            mEarlyDelayCoeff[j][0] = mEarlyDelayCoeff[j][1];
-            auto fadeCount = float{0.0f};
-
-            auto tmp = tempSamples[j].begin();
-            for(size_t i{0_uz};i < todo;)
-            {
-                early_delay_tap0 &= input.size()-1;
-                early_delay_tap1 &= input.size()-1;
-                const auto max_tap = size_t{std::max(early_delay_tap0, early_delay_tap1)};
-                const auto td = size_t{std::min(input.size()-max_tap, todo-i)};
-                const auto intap0 = input.subspan(early_delay_tap0, td);
-                const auto intap1 = input.subspan(early_delay_tap1, td);
-
-                auto do_blend = [coeff0,coeff1,fadeStep,&fadeCount](const float in0,
-                    const float in1) noexcept -> float
-                {
-                    const auto ret = lerpf(in0*coeff0, in1*coeff1, fadeStep*fadeCount);
-                    fadeCount += 1.0f;
-                    return ret;
-                };
-                tmp = std::transform(intap0.begin(), intap0.end(), intap1.begin(), tmp, do_blend);
-                early_delay_tap0 += td;
-                early_delay_tap1 += td;
-                i += td;
-            }
-
-            /* Band-pass the incoming samples. */
-            auto&& filter = DualBiquad{mFilter[j].Lp, mFilter[j].Hp};
-            filter.process(al::span{tempSamples[j]}.first(todo), tempSamples[j]);
-        }
+        loadEarlyTaps(in_delay, offset, todo, tempSamples);
 
         /* Apply an all-pass, to help color the initial reflections. */
         mEarly.VecAp.process(tempSamples, offset, todo);
@@ -1585,7 +1757,38 @@ void ReverbPipeline::processEarly(const DelayLineU &main_delay, size_t offset,
 
         /* Finally, apply a scatter and bounce to improve the initial diffusion
          * in the late reverb, writing the result to the late delay line input.
+         * An early zone has no late reverb to feed.
          */
+        if(mMode != ReverbZoneMode::EarlyZone)
+        {
+            VectorScatterRev(mixX, mixY, tempSamples, todo);
+            for(size_t j{0_uz};j < NUM_LINES;j++)
+                mLateDelayIn.write(offset, j, al::span{tempSamples[j]}.first(todo));
+        }
+
+        base += todo;
+        offset += todo;
+    }
+}
+
+/* This feeds the late reverb of a shared late reverb. The input is already
+ * early reflections, so the primary reflections are scattered and fed into
+ * the late reverb section directly, without an early stage.
+ */
+void ReverbPipeline::processLateFeed(const DelayLineU &main_delay, size_t offset,
+    const size_t samplesToDo, const al::span<ReverbUpdateLine,NUM_LINES> tempSamples)
+{
+    const float mixX{mMixX};
+    const float mixY{mMixY};
+
+    ASSUME(samplesToDo <= BufferLineSize);
+
+    for(size_t base{0};base < samplesToDo;)
+    {
+        const size_t todo{std::min(samplesToDo-base, MAX_UPDATE_SAMPLES)};
+
+        loadEarlyTaps(main_delay, offset, todo, tempSamples);
+
         VectorScatterRev(mixX, mixY, tempSamples, todo);
         for(size_t j{0_uz};j < NUM_LINES;j++)
             mLateDelayIn.write(offset, j, al::span{tempSamples[j]}.first(todo));
@@ -1618,6 +1821,35 @@ auto Modulation::calcDelays(size_t todo) -> al::span<const uint>
 }
 
 
+/* Cross-couples the late line banks with a normalized Hadamard matrix, which
+ * keeps the combined feedback matrix orthogonal.
+ */
+void BankScatter(const al::span<ReverbUpdateLine> samples, const size_t numBanks,
+    const size_t count) noexcept
+{
+    ASSUME(count > 0);
+
+    for(size_t stride{1};stride < numBanks;stride <<= 1)
+    {
+        for(size_t b{0};b < numBanks;++b)
+        {
+            if((b&stride) != 0)
+                continue;
+            for(size_t j{0};j < NUM_LINES;++j)
+            {
+                const auto lo = al::span{samples[b*NUM_LINES + j]}.first(count);
+                const auto hi = al::span{samples[(b+stride)*NUM_LINES + j]}.first(count);
+                for(size_t i{0};i < count;++i)
+                {
+                    const float a{lo[i]}, c{hi[i]};
+                    lo[i] = (a + c) * InvSqrt2;
+                    hi[i] = (a - c) * InvSqrt2;
+                }
+            }
+        }
+    }
+}
+
 /* This generates the reverb tail using a modified feed-back delay network
  * (FDN).
  *
@@ -1627,63 +1859,80 @@ auto Modulation::calcDelays(size_t todo) -> al::span<const uint>
  * The late response is then completed by T60 and all-pass filtering the mix.
  *
  * Finally, the lines are reversed (so they feed their opposite directions)
- * and scattered with the FDN matrix before re-feeding the delay lines.
+ * and scattered with the FDN matrix before re-feeding the delay lines. With
+ * multiple line banks, each bank takes the input channels in a different
+ * order, the banks' outputs are summed for each channel, and the banks are
+ * cross-coupled as they're re-fed.
  */
 void ReverbPipeline::processLate(size_t offset, const size_t samplesToDo,
-    const al::span<ReverbUpdateLine, NUM_LINES> tempSamples,
+    const al::span<ReverbUpdateLine, NUM_LINES*MaxLateBanks> tempSamples,
     const al::span<FloatBufferLine, NUM_LINES> outSamples)
 {
-    const DelayLineU late_delay{mLate.Delay};
     const DelayLineU in_delay{mLateDelayIn};
     const float mixX{mMixX};
     const float mixY{mMixY};
+    const size_t numBanks{mLate.NumBanks};
+    const auto banks = al::span{mLate.Banks}.first(numBanks);
 
     ASSUME(samplesToDo <= BufferLineSize);
 
+    /* The shortest feedback line limits how much can be done at once. */
+    const size_t maxTodo{std::accumulate(banks.begin(), banks.end(), MAX_UPDATE_SAMPLES,
+        [](const size_t todo, const LateReverb::LineBank &bank) noexcept -> size_t
+        { return std::min(todo, bank.Offset[0]); })};
+
     for(size_t base{0};base < samplesToDo;)
     {
-        const size_t todo{std::min(std::min(mLate.Offset[0], MAX_UPDATE_SAMPLES),
-            samplesToDo-base)};
+        const size_t todo{std::min(maxTodo, samplesToDo-base)};
         ASSUME(todo > 0);
 
         /* First, calculate the modulated delays for the late feedback. */
         const auto delays = mLate.Mod.calcDelays(todo);
 
-        /* Now load samples from the feedback delay lines. Filter the signal to
-         * apply its frequency-dependent decay.
-         */
-        for(size_t j{0_uz};j < NUM_LINES;++j)
+        for(size_t b{0};b < numBanks;++b)
         {
-            const auto input = late_delay.get(j);
-            const auto midGain = float{mLate.T60[j].MidGain};
-            auto late_feedb_tap = size_t{offset - mLate.Offset[j]};
+            auto &bank = banks[b];
+            const DelayLineU late_delay{bank.Delay};
+            const auto bankSamples = al::span<ReverbUpdateLine,NUM_LINES>{
+                tempSamples.begin() + ptrdiff_t(b*NUM_LINES), NUM_LINES};
 
-            auto proc_sample = [input,midGain,&late_feedb_tap](const size_t idelay) -> float
+            /* Now load samples from the feedback delay lines. Filter the
+             * signal to apply its frequency-dependent decay.
+             */
+            for(size_t j{0_uz};j < NUM_LINES;++j)
             {
-                /* Calculate the read sample offset and sub-sample offset
-                 * between it and the next sample.
-                 */
-                const auto delay = size_t{late_feedb_tap - (idelay>>gCubicTable.sTableBits)};
-                const auto delayoffset = size_t{idelay & gCubicTable.sTableMask};
-                ++late_feedb_tap;
+                const auto input = late_delay.get(j);
+                const auto midGain = float{bank.T60[j].MidGain};
+                auto late_feedb_tap = size_t{offset - bank.Offset[j]};
 
-                /* Get the samples around the delayed offset, interpolated for
-                 * output.
-                 */
-                const auto out0 = float{input[(delay  ) & (input.size()-1)]};
-                const auto out1 = float{input[(delay-1) & (input.size()-1)]};
-                const auto out2 = float{input[(delay-2) & (input.size()-1)]};
-                const auto out3 = float{input[(delay-3) & (input.size()-1)]};
-
-                const auto out = float{out0*gCubicTable.getCoeff0(delayoffset)
-                    + out1*gCubicTable.getCoeff1(delayoffset)
-                    + out2*gCubicTable.getCoeff2(delayoffset)
-                    + out3*gCubicTable.getCoeff3(delayoffset)};
-                return out * midGain;
-            };
-            std::transform(delays.begin(), delays.end(), tempSamples[j].begin(), proc_sample);
+                auto proc_sample = [input,midGain,&late_feedb_tap](const size_t idelay) -> float
+                {
+                    /* Calculate the read sample offset and sub-sample offset
+                     * between it and the next sample.
+                     */
+                    const auto delay = size_t{late_feedb_tap - (idelay>>gCubicTable.sTableBits)};
+                    const auto delayoffset = size_t{idelay & gCubicTable.sTableMask};
+                    ++late_feedb_tap;
+
+                    /* Get the samples around the delayed offset, interpolated
+                     * for output.
+                     */
+                    const auto out0 = float{input[(delay  ) & (input.size()-1)]};
+                    const auto out1 = float{input[(delay-1) & (input.size()-1)]};
+                    const auto out2 = float{input[(delay-2) & (input.size()-1)]};
+                    const auto out3 = float{input[(delay-3) & (input.size()-1)]};
+
+                    const auto out = float{out0*gCubicTable.getCoeff0(delayoffset)
+                        + out1*gCubicTable.getCoeff1(delayoffset)
+                        + out2*gCubicTable.getCoeff2(delayoffset)
+                        + out3*gCubicTable.getCoeff3(delayoffset)};
+                    return out * midGain;
+                };
+                std::transform(delays.begin(), delays.end(), bankSamples[j].begin(),
+                    proc_sample);
 
-            mLate.T60[j].process(al::span{tempSamples[j]}.first(todo));
+                bank.T60[j].process(al::span{bankSamples[j]}.first(todo));
+            }
         }
 
         /* Next load decorrelated samples from the main delay lines. */
@@ -1691,47 +1940,91 @@ void ReverbPipeline::processLate(size_t offset, const size_t samplesToDo,
         for(size_t j{0_uz};j < NUM_LINES;++j)
         {
             const auto input = in_delay.get(j);
-            auto late_delay_tap0 = size_t{offset - mLateDelayTap[j][0]};
-            auto late_delay_tap1 = size_t{offset - mLateDelayTap[j][1]};
+            const auto late_delay_tap0 = size_t{offset - mLateDelayTap[j][0]};
+            const auto late_delay_tap1 = size_t{offset - mLateDelayTap[j][1]};
             mLateDelayTap[j][0] = mLateDelayTap[j][1];
             const auto densityGain = float{mLate.DensityGain};
             const auto densityStep = float{late_delay_tap0 != late_delay_tap1
                 ? densityGain*fadeStep : 0.0f};
-            auto fadeCount = float{0.0f};
 
-            auto samples = tempSamples[j].begin();
-            for(size_t i{0u};i < todo;)
+            for(size_t b{0};b < numBanks;++b)
             {
-                late_delay_tap0 &= input.size()-1;
-                late_delay_tap1 &= input.size()-1;
-                const auto td = size_t{std::min(todo - i,
-                    input.size() - std::max(late_delay_tap0, late_delay_tap1))};
+                auto tap0 = late_delay_tap0;
+                auto tap1 = late_delay_tap1;
+                auto fadeCount = float{0.0f};
 
-                auto proc_sample = [input,densityGain,densityStep,&late_delay_tap0,
-                    &late_delay_tap1,&fadeCount](const float sample) noexcept -> float
+                auto samples = tempSamples[b*NUM_LINES + (j^b)].begin();
+                for(size_t i{0u};i < todo;)
                 {
-                    const auto fade0 = float{densityGain - densityStep*fadeCount};
-                    const auto fade1 = float{densityStep*fadeCount};
-                    fadeCount += 1.0f;
-                    return input[late_delay_tap0++]*fade0 + input[late_delay_tap1++]*fade1
-                        + sample;
-                };
-                samples = std::transform(samples, samples+ptrdiff_t(td), samples, proc_sample);
-                i += td;
+                    tap0 &= input.size()-1;
+                    tap1 &= input.size()-1;
+                    const auto td = size_t{std::min(todo - i,
+                        input.size() - std::max(tap0, tap1))};
+
+                    auto proc_sample = [input,densityGain,densityStep,&tap0,&tap1,
+                        &fadeCount](const float sample) noexcept -> float
+                    {
+                        const auto fade0 = float{densityGain - densityStep*fadeCount};
+                        const auto fade1 = float{densityStep*fadeCount};
+                        fadeCount += 1.0f;
+                        return input[tap0++]*fade0 + input[tap1++]*fade1 + sample;
+                    };
+                    samples = std::transform(samples, samples+ptrdiff_t(td), samples,
+                        proc_sample);
+                    i += td;
+                }
             }
         }
 
         /* Apply a vector all-pass to improve micro-surface diffusion, and
          * write out the results for mixing.
          */
-        mLate.VecAp.process(tempSamples, offset, mixX, mixY, todo);
-        for(size_t j{0_uz};j < NUM_LINES;++j)
-            std::copy_n(tempSamples[j].begin(), todo, outSamples[j].begin()+base);
+        for(size_t b{0};b < numBanks;++b)
+        {
+            const auto bankSamples = al::span<ReverbUpdateLine,NUM_LINES>{
+                tempSamples.begin() + ptrdiff_t(b*NUM_LINES), NUM_LINES};
+            banks[b].VecAp.process(bankSamples, offset, mixX, mixY, todo);
+        }
+        if(numBanks == 1)
+        {
+            for(size_t j{0_uz};j < NUM_LINES;++j)
+                std::copy_n(tempSamples[j].begin(), todo, outSamples[j].begin()+base);
+        }
+        else
+        {
+            const float bankGain{1.0f / std::sqrt(static_cast<float>(numBanks))};
+            for(size_t j{0_uz};j < NUM_LINES;++j)
+            {
+                const auto output = al::span{outSamples[j]}.subspan(base, todo);
+                std::transform(tempSamples[j].begin(), tempSamples[j].begin()+ptrdiff_t(todo),
+                    output.begin(), [bankGain](const float in) noexcept -> float
+                    { return in * bankGain; });
+                for(size_t b{1};b < numBanks;++b)
+                {
+                    const auto &input = tempSamples[b*NUM_LINES + j];
+                    std::transform(input.begin(), input.begin()+ptrdiff_t(todo), output.begin(),
+                        output.begin(), [bankGain](const float in, const float out) noexcept
+                        { return out + in*bankGain; });
+                }
+            }
+        }
 
         /* Finally, scatter and bounce the results to refeed the feedback buffer. */
-        VectorScatterRev(mixX, mixY, tempSamples, todo);
-        for(size_t j{0_uz};j < NUM_LINES;++j)
-            late_delay.write(offset, j, al::span{tempSamples[j]}.first(todo));
+        for(size_t b{0};b < numBanks;++b)
+        {
+            const auto bankSamples = al::span<ReverbUpdateLine,NUM_LINES>{
+                tempSamples.begin() + ptrdiff_t(b*NUM_LINES), NUM_LINES};
+            VectorScatterRev(mixX, mixY, bankSamples, todo);
+        }
+        if(numBanks > 1)
+            BankScatter(tempSamples, numBanks, todo);
+        for(size_t b{0};b < numBanks;++b)
+        {
+            const DelayLineU late_delay{banks[b].Delay};
+            for(size_t j{0_uz};j < NUM_LINES;++j)
+                late_delay.write(offset, j,
+                    al::span{tempSamples[b*NUM_LINES + j]}.first(todo));
+        }
 
         base += todo;
         offset += todo;
@@ -1739,6 +2032,48 @@ void ReverbPipeline::processLate(size_t offset, const size_t samplesToDo,
 }
 
 void ReverbState::process(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn, const al::span<FloatBufferLine> samplesOut)
+{
+    if(mRateConverter)
+    {
+        mRateConverter->process(samplesToDo, samplesIn, samplesOut,
+            [this](const size_t todo, const al::span<const FloatBufferLine> input,
+                const al::span<FloatBufferLine> output)
+            { processSamples(todo, input, output); });
+    }
+    else
+        processSamples(samplesToDo, samplesIn, samplesOut);
+}
+
+void ReverbState::processPipeline(ReverbPipeline &pipeline, const size_t offset,
+    const size_t samplesToDo, const al::span<FloatBufferLine> samplesOut)
+{
+    const auto tempSamples = al::span{mTempSamples}.first<NUM_LINES>();
+    switch(pipeline.mMode)
+    {
+    case ReverbZoneMode::Full:
+        pipeline.processEarly(mMainDelay, offset, samplesToDo, tempSamples, mEarlySamples);
+        pipeline.processLate(offset, samplesToDo, mTempSamples, mLateSamples);
+        break;
+
+    case ReverbZoneMode::EarlyZone:
+        pipeline.processEarly(mMainDelay, offset, samplesToDo, tempSamples, mEarlySamples);
+        for(auto &line : mLateSamples)
+            std::fill_n(line.begin(), samplesToDo, 0.0f);
+        break;
+
+    case ReverbZoneMode::SharedLate:
+        /* The A-Format input is passed through as the early output. */
+        for(size_t j{0_uz};j < NUM_LINES;j++)
+            mMainDelay.read(offset, j, al::span{mEarlySamples[j]}.first(samplesToDo));
+        pipeline.processLateFeed(mMainDelay, offset, samplesToDo, tempSamples);
+        pipeline.processLate(offset, samplesToDo, mTempSamples, mLateSamples);
+        break;
+    }
+    mixOut(pipeline, samplesOut, samplesToDo);
+}
+
+void ReverbState::processSamples(const size_t samplesToDo,
+    const al::span<const FloatBufferLine> samplesIn, const al::span<FloatBufferLine> samplesOut)
 {
     const size_t offset{mOffset};
 
@@ -1749,6 +2084,12 @@ void ReverbState::process(const size_t samplesToDo, const al::span<const FloatBu
 
     /* Convert B-Format to A-Format for processing. */
     const size_t numInput{std::min(samplesIn.size(), NUM_LINES)};
+    const bool silentInput{std::all_of(samplesIn.begin(), samplesIn.begin()+ptrdiff_t(numInput),
+        [samplesToDo](const FloatBufferLine &input) noexcept -> bool
+        {
+            return std::all_of(input.begin(), input.begin()+ptrdiff_t(samplesToDo),
+                [](const float sample) noexcept { return sample == 0.0f; });
+        })};
     const al::span<float> tmpspan{al::assume_aligned<16>(mTempLine.data()), samplesToDo};
     for(size_t c{0u};c < NUM_LINES;++c)
     {
@@ -1770,9 +2111,7 @@ void ReverbState::process(const size_t samplesToDo, const al::span<const FloatBu
         mPipelineState = Fading;
 
     /* Process reverb for these samples. and mix them to the output. */
-    pipeline.processEarly(mMainDelay, offset, samplesToDo, mTempSamples, mEarlySamples);
-    pipeline.processLate(offset, samplesToDo, mTempSamples, mLateSamples);
-    mixOut(pipeline, samplesOut, samplesToDo);
+    processPipeline(pipeline, offset, samplesToDo, samplesOut);
 
     if(mPipelineState != Normal)
     {
@@ -1806,13 +2145,27 @@ void ReverbState::process(const size_t samplesToDo, const al::span<const FloatBu
                 oldpipeline.mFadeSampleCount -= samplesToDo;
 
             /* Process the old reverb for these samples. */
-            oldpipeline.processEarly(mMainDelay, offset, samplesToDo, mTempSamples, mEarlySamples);
-            oldpipeline.processLate(offset, samplesToDo, mTempSamples, mLateSamples);
-            mixOut(oldpipeline, samplesOut, samplesToDo);
+            processPipeline(oldpipeline, offset, samplesToDo, samplesOut);
         }
     }
 
     mOffset = offset + samplesToDo;
+
+    /* Go idle once the input has been silent long enough to clear the delays,
+     * and the early and late outputs have decayed below -100dB.
+     */
+    mSilentCount = silentInput ? std::min(mSilentCount+samplesToDo, mIdleDelay) : 0_uz;
+    mIdle = false;
+    if(mSilentCount >= mIdleDelay && mPipelineState == Normal)
+    {
+        auto is_quiet = [samplesToDo](const FloatBufferLine &output) noexcept -> bool
+        {
+            return std::all_of(output.begin(), output.begin()+ptrdiff_t(samplesToDo),
+                [](const float sample) noexcept { return std::fabs(sample) < 0.00001f; });
+        };
+        mIdle = std::all_of(mEarlySamples.cbegin(), mEarlySamples.cend(), is_quiet)
+            && std::all_of(mLateSamples.cbegin(), mLateSamples.cend(), is_quiet);
+    }
 }
 
 
@@ -0,0 +1,106 @@
+
+#include "config.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <variant>
+
+#include "alc/effects/base.h"
+#include "alnumeric.h"
+#include "alspan.h"
+#include "core/ambidefs.h"
+#include "core/bufferline.h"
+#include "core/context.h"
+#include "core/device.h"
+#include "core/effects/base.h"
+#include "core/effectslot.h"
+#include "core/mixer.h"
+#include "intrusive_ptr.h"
+#include "vecmat.h"
+
+struct BufferStorage;
+
+
+namespace {
+
+/* Spatializes the sources sent to the slot as a single emitter. The sources
+ * mix into a mono bus (the W channel of the slot's wet buffer), which is then
+ * panned and attenuated once for the group's position relative to the
+ * listener.
+ */
+struct SourceGroupState final : public EffectState {
+    std::array<float,MaxAmbiChannels> mCurrentGains{};
+    std::array<float,MaxAmbiChannels> mTargetGains{};
+
+
+    void deviceUpdate(const DeviceBase *device, const BufferStorage *buffer) final;
+    void update(const ContextBase *context, const EffectSlot *slot, const EffectProps *props_,
+        const EffectTarget target) final;
+    void process(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn,
+        const al::span<FloatBufferLine> samplesOut) final;
+    [[nodiscard]] auto inputChannels() const noexcept -> size_t final { return 1; }
+
+    /* There's no internal state beyond the gains, so the slot can sleep
+     * whenever nothing is mixed into its wet buffer.
+     */
+    [[nodiscard]] bool isIdle() const noexcept final { return true; }
+};
+
+void SourceGroupState::deviceUpdate(const DeviceBase*, const BufferStorage*)
+{
+    std::fill(mCurrentGains.begin(), mCurrentGains.end(), 0.0f);
+}
+
+void SourceGroupState::update(const ContextBase *context, const EffectSlot *slot,
+    const EffectProps *props_, const EffectTarget target)
+{
+    auto &props = std::get<SourceGroupProps>(*props_);
+
+    /* Transform the group's position to listener space. */
+    alu::Vector position{props.Position[0], props.Position[1], props.Position[2], 1.0f};
+    if(!props.HeadRelative)
+        position = TransformToListener(context->mParams.Matrix,
+            position - context->mParams.Position);
+    position[3] = 0.0f;
+    const float distance{position.normalize()};
+
+    /* Attenuate with the inverse distance, clamped to the reference distance.
+     * The sources' own attenuation is applied to their sends, which is
+     * normally none when they're placed at the group's origin.
+     */
+    float gain{slot->Gain * props.Gain};
+    if(props.RefDistance > 0.0f)
+    {
+        const float dist{lerpf(props.RefDistance, std::max(distance, props.RefDistance),
+            props.RolloffFactor)};
+        if(dist > 0.0f) gain *= props.RefDistance / dist;
+    }
+
+    /* A group at the listener's position gets an omnidirectional response. */
+    const auto coeffs = CalcDirectionCoeffs(std::array{position[0], position[1], position[2]});
+
+    mOutTarget = target.Main->Buffer;
+    ComputePanGains(target.Main, coeffs, gain, mTargetGains);
+}
+
+void SourceGroupState::process(const size_t samplesToDo,
+    const al::span<const FloatBufferLine> samplesIn, const al::span<FloatBufferLine> samplesOut)
+{
+    MixSamples(al::span{samplesIn[0]}.first(samplesToDo), samplesOut, mCurrentGains, mTargetGains,
+        samplesToDo, 0);
+}
+
+
+struct SourceGroupStateFactory final : public EffectStateFactory {
+    al::intrusive_ptr<EffectState> create() override
+    { return al::intrusive_ptr<EffectState>{new SourceGroupState{}}; }
+};
+
+} // namespace
+
+EffectStateFactory *SourceGroupStateFactory_getFactory()
+{
+    static SourceGroupStateFactory SourceGroupFactory{};
+    return &SourceGroupFactory;
+}
@@ -39,6 +39,10 @@
 #include <functional>
 #include <variant>
 
+#ifdef HAVE_SSE_INTRINSICS
+#include <xmmintrin.h>
+#endif
+
 #include "alc/effects/base.h"
 #include "alnumbers.h"
 #include "alnumeric.h"
@@ -107,37 +111,6 @@ struct FormantFilter {
       : mCoeff{std::tan(al::numbers::pi_v<float> * f0norm)}, mGain{gain}
     { }
 
-    void process(const float *samplesIn, float *samplesOut, const size_t numInput) noexcept
-    {
-        /* A state variable filter from a topology-preserving transform.
-         * Based on a talk given by Ivan Cohen: https://www.youtube.com/watch?v=esjHXGPyrhg
-         */
-        const float g{mCoeff};
-        const float gain{mGain};
-        const float h{1.0f / (1.0f + (g*RcpQFactor) + (g*g))};
-        const float coeff{RcpQFactor + g};
-        float s1{mS1};
-        float s2{mS2};
-
-        const auto input = al::span{samplesIn, numInput};
-        const auto output = al::span{samplesOut, numInput};
-        std::transform(input.cbegin(), input.cend(), output.cbegin(), output.begin(),
-            [g,gain,h,coeff,&s1,&s2](const float in, const float out) noexcept -> float
-            {
-                const float H{(in - coeff*s1 - s2)*h};
-                const float B{g*H + s1};
-                const float L{g*B + s2};
-
-                s1 = g*H + B;
-                s2 = g*B + L;
-
-                // Apply peak and accumulate samples.
-                return out + B*gain;
-            });
-        mS1 = s1;
-        mS2 = s2;
-    }
-
     void clear() noexcept
     {
         mS1 = 0.0f;
@@ -146,6 +119,125 @@ struct FormantFilter {
 };
 
 
+using FormantBank = std::array<std::array<FormantFilter,NumFormants>,NumFilters>;
+
+/* Processes all the formant filters of both vowels on the same input, and
+ * blends the two vowels with the LFO.
+ *
+ * Each filter is a state variable filter from a topology-preserving
+ * transform, based on a talk given by Ivan Cohen:
+ * https://www.youtube.com/watch?v=esjHXGPyrhg
+ */
+void ProcessFormants(FormantBank &formants, const al::span<const float> input,
+    const al::span<const float> lfo, const al::span<float> output)
+{
+    size_t i{0};
+
+#ifdef HAVE_SSE_INTRINSICS
+    /* Each vowel's filters go in the lanes of a vector, so every filter is
+     * updated at once for each sample.
+     */
+    struct SseBank { __m128 g, gain, h, coeff, s1, s2; };
+    auto load_bank = [](const al::span<const FormantFilter,NumFormants> filters) -> SseBank
+    {
+        alignas(16) std::array<std::array<float,NumFormants>,6> vals{};
+        for(size_t f{0};f < NumFormants;++f)
+        {
+            const float g{filters[f].mCoeff};
+            vals[0][f] = g;
+            vals[1][f] = filters[f].mGain;
+            vals[2][f] = 1.0f / (1.0f + (g*RcpQFactor) + (g*g));
+            vals[3][f] = RcpQFactor + g;
+            vals[4][f] = filters[f].mS1;
+            vals[5][f] = filters[f].mS2;
+        }
+        return SseBank{_mm_load_ps(vals[0].data()), _mm_load_ps(vals[1].data()),
+            _mm_load_ps(vals[2].data()), _mm_load_ps(vals[3].data()),
+            _mm_load_ps(vals[4].data()), _mm_load_ps(vals[5].data())};
+    };
+    auto store_bank = [](const SseBank &bank, const al::span<FormantFilter,NumFormants> filters)
+    {
+        alignas(16) std::array<std::array<float,NumFormants>,2> vals{};
+        _mm_store_ps(vals[0].data(), bank.s1);
+        _mm_store_ps(vals[1].data(), bank.s2);
+        for(size_t f{0};f < NumFormants;++f)
+        {
+            filters[f].mS1 = vals[0][f];
+            filters[f].mS2 = vals[1][f];
+        }
+    };
+    /* Returns the peak-scaled band-pass output of each filter. */
+    auto proc_bank = [](SseBank &bank, const __m128 in) noexcept -> __m128
+    {
+        const __m128 H{_mm_mul_ps(_mm_sub_ps(_mm_sub_ps(in, _mm_mul_ps(bank.coeff, bank.s1)),
+            bank.s2), bank.h)};
+        const __m128 gH{_mm_mul_ps(bank.g, H)};
+        const __m128 B{_mm_add_ps(gH, bank.s1)};
+        const __m128 gB{_mm_mul_ps(bank.g, B)};
+        const __m128 L{_mm_add_ps(gB, bank.s2)};
+
+        bank.s1 = _mm_add_ps(gH, B);
+        bank.s2 = _mm_add_ps(gB, L);
+        return _mm_mul_ps(B, bank.gain);
+    };
+
+    SseBank bankA{load_bank(formants[VowelAIndex])};
+    SseBank bankB{load_bank(formants[VowelBIndex])};
+
+    /* Transposing four samples' worth of filter outputs lets them be summed
+     * for all four samples at once.
+     */
+    for(;input.size()-i >= 4;i += 4)
+    {
+        const __m128 in4{_mm_loadu_ps(&input[i])};
+        __m128 a0{proc_bank(bankA, _mm_shuffle_ps(in4, in4, _MM_SHUFFLE(0, 0, 0, 0)))};
+        __m128 b0{proc_bank(bankB, _mm_shuffle_ps(in4, in4, _MM_SHUFFLE(0, 0, 0, 0)))};
+        __m128 a1{proc_bank(bankA, _mm_shuffle_ps(in4, in4, _MM_SHUFFLE(1, 1, 1, 1)))};
+        __m128 b1{proc_bank(bankB, _mm_shuffle_ps(in4, in4, _MM_SHUFFLE(1, 1, 1, 1)))};
+        __m128 a2{proc_bank(bankA, _mm_shuffle_ps(in4, in4, _MM_SHUFFLE(2, 2, 2, 2)))};
+        __m128 b2{proc_bank(bankB, _mm_shuffle_ps(in4, in4, _MM_SHUFFLE(2, 2, 2, 2)))};
+        __m128 a3{proc_bank(bankA, _mm_shuffle_ps(in4, in4, _MM_SHUFFLE(3, 3, 3, 3)))};
+        __m128 b3{proc_bank(bankB, _mm_shuffle_ps(in4, in4, _MM_SHUFFLE(3, 3, 3, 3)))};
+        _MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+        _MM_TRANSPOSE4_PS(b0, b1, b2, b3);
+        const __m128 sumA{_mm_add_ps(_mm_add_ps(a0, a1), _mm_add_ps(a2, a3))};
+        const __m128 sumB{_mm_add_ps(_mm_add_ps(b0, b1), _mm_add_ps(b2, b3))};
+
+        const __m128 mu{_mm_loadu_ps(&lfo[i])};
+        _mm_storeu_ps(&output[i], _mm_add_ps(sumA, _mm_mul_ps(_mm_sub_ps(sumB, sumA), mu)));
+    }
+
+    store_bank(bankA, formants[VowelAIndex]);
+    store_bank(bankB, formants[VowelBIndex]);
+#endif
+
+    for(;i < input.size();++i)
+    {
+        std::array<float,NumFilters> sums{};
+        for(size_t v{0};v < NumFilters;++v)
+        {
+            for(auto &filter : formants[v])
+            {
+                const float g{filter.mCoeff};
+                const float h{1.0f / (1.0f + (g*RcpQFactor) + (g*g))};
+                const float coeff{RcpQFactor + g};
+
+                const float H{(input[i] - coeff*filter.mS1 - filter.mS2)*h};
+                const float B{g*H + filter.mS1};
+                const float L{g*B + filter.mS2};
+
+                filter.mS1 = g*H + B;
+                filter.mS2 = g*B + L;
+
+                /* Apply peak and accumulate samples. */
+                sums[v] += B*filter.mGain;
+            }
+        }
+        output[i] = lerpf(sums[VowelAIndex], sums[VowelBIndex], lfo[i]);
+    }
+}
+
+
 struct VmorpherState final : public EffectState {
     struct OutParams {
         uint mTargetChannel{InvalidChannelIndex};
@@ -165,8 +257,6 @@ struct VmorpherState final : public EffectState {
     uint mStep{1};
 
     /* Effects buffers */
-    alignas(16) std::array<float,MaxUpdateSamples> mSampleBufferA{};
-    alignas(16) std::array<float,MaxUpdateSamples> mSampleBufferB{};
     alignas(16) std::array<float,MaxUpdateSamples> mLfo{};
 
     void deviceUpdate(const DeviceBase *device, const BufferStorage *buffer) override;
@@ -249,7 +339,7 @@ void VmorpherState::update(const ContextBase *context, const EffectSlot *slot,
 {
     auto &props = std::get<VmorpherProps>(*props_);
     const DeviceBase *device{context->mDevice};
-    const float frequency{static_cast<float>(device->Frequency)};
+    const float frequency{static_cast<float>(device->mMixFrequency)};
     const float step{props.Rate / frequency};
     mStep = fastf2u(std::clamp(step*WaveformFracOne, 0.0f, WaveformFracOne-1.0f));
 
@@ -309,25 +399,8 @@ void VmorpherState::process(const size_t samplesToDo, const al::span<const Float
                 continue;
             }
 
-            const auto vowelA = al::span{chandata->mFormants[VowelAIndex]};
-            const auto vowelB = al::span{chandata->mFormants[VowelBIndex]};
-
-            /* Process first vowel. */
-            std::fill_n(mSampleBufferA.begin(), td, 0.0f);
-            vowelA[0].process(&input[base], mSampleBufferA.data(), td);
-            vowelA[1].process(&input[base], mSampleBufferA.data(), td);
-            vowelA[2].process(&input[base], mSampleBufferA.data(), td);
-            vowelA[3].process(&input[base], mSampleBufferA.data(), td);
-
-            /* Process second vowel. */
-            std::fill_n(mSampleBufferB.begin(), td, 0.0f);
-            vowelB[0].process(&input[base], mSampleBufferB.data(), td);
-            vowelB[1].process(&input[base], mSampleBufferB.data(), td);
-            vowelB[2].process(&input[base], mSampleBufferB.data(), td);
-            vowelB[3].process(&input[base], mSampleBufferB.data(), td);
-
-            for(size_t i{0u};i < td;i++)
-                blended[i] = lerpf(mSampleBufferA[i], mSampleBufferB[i], mLfo[i]);
+            ProcessFormants(chandata->mFormants, al::span{input}.subspan(base, td),
+                al::span{mLfo}.first(td), al::span{blended}.first(td));
 
             /* Now, mix the processed sound data to the output. */
             MixSamples(al::span{blended}.first(td), al::span{samplesOut[outidx]}.subspan(base),
@@ -17,6 +17,9 @@ ALCenum EnumFromEventType(const alc::EventType type)
     case alc::EventType::DefaultDeviceChanged: return ALC_EVENT_TYPE_DEFAULT_DEVICE_CHANGED_SOFT;
     case alc::EventType::DeviceAdded: return ALC_EVENT_TYPE_DEVICE_ADDED_SOFT;
     case alc::EventType::DeviceRemoved: return ALC_EVENT_TYPE_DEVICE_REMOVED_SOFT;
+    case alc::EventType::HrtfReady: return ALC_EVENT_TYPE_HRTF_READY_SOFT;
+    case alc::EventType::BufferSizeChanged: return ALC_EVENT_TYPE_BUFFER_SIZE_CHANGED_SOFT;
+    case alc::EventType::CaptureReady: return ALC_EVENT_TYPE_CAPTURE_READY_SOFT;
     case alc::EventType::Count: break;
     }
     throw std::runtime_error{"Invalid EventType: "+std::to_string(al::to_underlying(type))};
@@ -33,12 +36,19 @@ std::optional<alc::EventType> GetEventType(ALCenum type)
     case ALC_EVENT_TYPE_DEFAULT_DEVICE_CHANGED_SOFT: return alc::EventType::DefaultDeviceChanged;
     case ALC_EVENT_TYPE_DEVICE_ADDED_SOFT: return alc::EventType::DeviceAdded;
     case ALC_EVENT_TYPE_DEVICE_REMOVED_SOFT: return alc::EventType::DeviceRemoved;
+    case ALC_EVENT_TYPE_HRTF_READY_SOFT: return alc::EventType::HrtfReady;
+    case ALC_EVENT_TYPE_BUFFER_SIZE_CHANGED_SOFT: return alc::EventType::BufferSizeChanged;
+    case ALC_EVENT_TYPE_CAPTURE_READY_SOFT: return alc::EventType::CaptureReady;
     }
     return std::nullopt;
 }
 
 void Event(EventType eventType, DeviceType deviceType, ALCdevice *device, std::string_view message) noexcept
 {
+    if(eventType == EventType::DeviceAdded || eventType == EventType::DeviceRemoved
+        || eventType == EventType::DefaultDeviceChanged)
+        DeviceListChanged(deviceType);
+
     auto eventlock = std::unique_lock{EventMutex};
     if(EventCallback && EventsEnabled.test(al::to_underlying(eventType)))
         EventCallback(EnumFromEventType(eventType), al::to_underlying(deviceType), device,
@@ -16,6 +16,9 @@ enum class EventType : uint8_t {
     DefaultDeviceChanged,
     DeviceAdded,
     DeviceRemoved,
+    HrtfReady,
+    BufferSizeChanged,
+    CaptureReady,
 
     Count
 };
@@ -45,6 +48,12 @@ void Event(EventType eventType, DeviceType deviceType, ALCdevice *device, std::s
 inline void Event(EventType eventType, DeviceType deviceType, std::string_view message) noexcept
 { Event(eventType, deviceType, nullptr, message); }
 
+/* Invalidates the cached device list of the given type, after a device was
+ * added or removed, or the default device changed. Called for the matching
+ * events, and may be called directly for changes that don't get an event.
+ */
+void DeviceListChanged(DeviceType deviceType) noexcept;
+
 } // namespace alc
 
 #endif /* ALC_EVENTS_H */
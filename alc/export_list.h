@@ -39,6 +39,10 @@ inline const FuncExport alcFunctions[]{
     DECL(alcCaptureStart),
     DECL(alcCaptureStop),
     DECL(alcCaptureSamples),
+    DECL(alcCaptureMapSamplesSOFT),
+    DECL(alcCaptureReleaseSamplesSOFT),
+    DECL(alcCaptureThresholdSOFT),
+    DECL(alcCaptureWaitSOFT),
 
     DECL(alcSetThreadContext),
     DECL(alcGetThreadContext),
@@ -46,12 +50,17 @@ inline const FuncExport alcFunctions[]{
     DECL(alcLoopbackOpenDeviceSOFT),
     DECL(alcIsRenderFormatSupportedSOFT),
     DECL(alcRenderSamplesSOFT),
+    DECL(alcRenderSamplesBatchSOFT),
+    DECL(alcRenderSamplesPlanarSOFT),
 
     DECL(alcDevicePauseSOFT),
     DECL(alcDeviceResumeSOFT),
 
     DECL(alcGetStringiSOFT),
     DECL(alcResetDeviceSOFT),
+    DECL(alcReloadConfigSOFT),
+
+    DECL(alcBufferShareDataSOFT),
 
     DECL(alcGetInteger64vSOFT),
 
@@ -205,8 +214,22 @@ inline const FuncExport alcFunctions[]{
     DECL(alSourcePlayAtTimeSOFT),
     DECL(alSourcePlayAtTimevSOFT),
 
+    DECL(alSourcesfvSOFT),
+    DECL(alGetSourcesivSOFT),
+
+    DECL(alListenerIndexedfvSOFT),
+    DECL(alListenerIndexedivSOFT),
+    DECL(alGetListenerIndexedfvSOFT),
+    DECL(alGetListenerIndexedivSOFT),
+
     DECL(alBufferSubDataSOFT),
 
+    DECL(alBufferDataAsyncSOFT),
+    DECL(alBufferRingSOFT),
+    DECL(alBufferFileSOFT),
+    DECL(alEventBatchCallbackSOFT),
+    DECL(alBufferRingWriteSOFT),
+
     DECL(alBufferDataStatic),
 
     DECL(alDebugMessageCallbackEXT),
@@ -355,6 +378,17 @@ inline const FuncExport alcFunctions[]{
     DECL(alGetSourcedvDirectSOFT),
     DECL(alSourcePlayAtTimeDirectSOFT),
     DECL(alSourcePlayAtTimevDirectSOFT),
+    DECL(alSourcesfvDirectSOFT),
+    DECL(alGetSourcesivDirectSOFT),
+    DECL(alListenerIndexedfvDirectSOFT),
+    DECL(alListenerIndexedivDirectSOFT),
+    DECL(alGetListenerIndexedfvDirectSOFT),
+    DECL(alGetListenerIndexedivDirectSOFT),
+    DECL(alBufferDataAsyncDirectSOFT),
+    DECL(alBufferRingDirectSOFT),
+    DECL(alBufferFileDirectSOFT),
+    DECL(alEventBatchCallbackDirectSOFT),
+    DECL(alBufferRingWriteDirectSOFT),
 
     DECL(alEventControlDirectSOFT),
     DECL(alEventCallbackDirectSOFT),
@@ -372,6 +406,7 @@ inline const FuncExport alcFunctions[]{
 
     /* Extra functions */
     DECL(alsoft_set_log_callback),
+    DECL(alsoft_set_trace_callback),
 };
 #ifdef ALSOFT_EAX
 inline const std::array eaxFunctions{
@@ -494,6 +529,15 @@ inline const EnumExport alcEnumerations[]{
     DECL(ALC_EVENT_TYPE_DEFAULT_DEVICE_CHANGED_SOFT),
     DECL(ALC_EVENT_TYPE_DEVICE_ADDED_SOFT),
     DECL(ALC_EVENT_TYPE_DEVICE_REMOVED_SOFT),
+    DECL(ALC_EVENT_TYPE_BUFFER_SIZE_CHANGED_SOFT),
+
+    DECL(ALC_XRUN_COUNT_SOFT),
+
+    DECL(ALC_BACKEND_TIMING_BUCKETS_SOFT),
+    DECL(ALC_BACKEND_TIMING_JITTER_SOFT),
+    DECL(ALC_BACKEND_TIMING_DISPATCH_SOFT),
+    DECL(ALC_BACKEND_TIMING_RENDER_SOFT),
+    DECL(ALC_BACKEND_TIMING_COMMIT_SOFT),
 
 
     DECL(AL_INVALID),
@@ -862,6 +906,8 @@ inline const EnumExport alcEnumerations[]{
     DECL(AL_EFFECT_CONVOLUTION_SOFT),
     DECL(AL_EFFECTSLOT_STATE_SOFT),
 
+    DECL(AL_EFFECT_SOURCE_GROUP_SOFT),
+
     DECL(AL_DONT_CARE_EXT),
     DECL(AL_DEBUG_OUTPUT_EXT),
     DECL(AL_DEBUG_CALLBACK_FUNCTION_EXT),
@@ -901,6 +947,54 @@ inline const EnumExport alcEnumerations[]{
     DECL(AL_PANNING_ENABLED_SOFT),
     DECL(AL_PAN_SOFT),
 
+    DECL(AL_DIRECT_ROUTE_SOFT),
+
+    DECL(AL_SOURCE_INSTANCING_SOFT),
+
+    DECL(AL_BUFFER_UPLOAD_PENDING_SOFT),
+    DECL(AL_EVENT_TYPE_BUFFER_UPLOADED_SOFT),
+
+    DECL(AL_RESERVE_SIZE_SOFT),
+
+    DECL(AL_RING_WRITE_SPACE_SOFT),
+    DECL(AL_RING_END_OF_STREAM_SOFT),
+
+    DECL(AL_FORMAT_MONO_IMA2_SOFT),
+    DECL(AL_FORMAT_STEREO_IMA2_SOFT),
+
+    DECL(ALC_MIXER_PROFILE_SIZE_SOFT),
+    DECL(ALC_MIXER_PROFILE_SOFT),
+
+    DECL(ALC_RESERVE_VOICES_SOFT),
+    DECL(ALC_RESERVE_EFFECT_SLOTS_SOFT),
+
+    DECL(ALC_MIX_FREQUENCY_SOFT),
+
+    DECL(AL_FORMAT_MONO_HALF_SOFT),
+    DECL(AL_FORMAT_STEREO_HALF_SOFT),
+    DECL(AL_FORMAT_QUAD_HALF_SOFT),
+    DECL(AL_FORMAT_51CHN_HALF_SOFT),
+    DECL(AL_FORMAT_61CHN_HALF_SOFT),
+    DECL(AL_FORMAT_71CHN_HALF_SOFT),
+    DECL(AL_FORMAT_BFORMAT2D_HALF_SOFT),
+    DECL(AL_FORMAT_BFORMAT3D_HALF_SOFT),
+
+    DECL(ALC_MEMORY_USAGE_SIZE_SOFT),
+    DECL(ALC_MEMORY_USAGE_SOFT),
+
+    DECL(ALC_EVENT_TYPE_CAPTURE_READY_SOFT),
+
+    DECL(ALC_MAX_LISTENERS_SOFT),
+    DECL(AL_LISTENER_OUTPUT_SOFT),
+
+    DECL(AL_REVERB_ZONE_MODE_SOFT),
+    DECL(AL_EAXREVERB_ZONE_MODE_SOFT),
+    DECL(AL_REVERB_FULL_SOFT),
+    DECL(AL_REVERB_EARLY_ZONE_SOFT),
+    DECL(AL_REVERB_SHARED_LATE_SOFT),
+
+    DECL(AL_BUFFER_COMPLETED_CLOCK_SOFT),
+
     DECL(AL_STOP_SOURCES_ON_DISCONNECT_SOFT),
 };
 #ifdef ALSOFT_EAX
@@ -81,12 +81,280 @@ void AL_APIENTRY alFlushMappedBufferDirectSOFT(ALCcontext *context, ALuint buffe
 #define AL_PAN_SOFT                              0x19EB
 #endif
 
+#ifndef AL_SOFT_effect_slot_ready_event
+#define AL_SOFT_effect_slot_ready_event
+#define AL_EVENT_TYPE_EFFECT_SLOT_READY_SOFT     0x19EC
+#endif
+
+#ifndef ALC_SOFT_hrtf_ready_event
+#define ALC_SOFT_hrtf_ready_event
+#define ALC_EVENT_TYPE_HRTF_READY_SOFT           0x19ED
+#endif
+
+#ifndef ALC_SOFT_output_xrun
+#define ALC_SOFT_output_xrun
+#define ALC_EVENT_TYPE_BUFFER_SIZE_CHANGED_SOFT  0x19EE
+#define ALC_XRUN_COUNT_SOFT                      0x19EF
+#endif
+
+#ifndef AL_SOFT_direct_routing
+#define AL_SOFT_direct_routing
+#define AL_DIRECT_ROUTE_SOFT                     0x19F0
+#endif
+
+#ifndef ALC_SOFT_backend_timing
+#define ALC_SOFT_backend_timing
+#define ALC_BACKEND_TIMING_BUCKETS_SOFT          0x19F1
+#define ALC_BACKEND_TIMING_JITTER_SOFT           0x19F2
+#define ALC_BACKEND_TIMING_DISPATCH_SOFT         0x19F3
+#define ALC_BACKEND_TIMING_RENDER_SOFT           0x19F4
+#define ALC_BACKEND_TIMING_COMMIT_SOFT           0x19F5
+#endif
+
+#ifndef AL_SOFT_buffer_upload_async
+#define AL_SOFT_buffer_upload_async
+#define AL_BUFFER_UPLOAD_PENDING_SOFT            0x19F6
+#define AL_EVENT_TYPE_BUFFER_UPLOADED_SOFT       0x19F7
+typedef ALuint (AL_APIENTRY*LPALBUFFERDATAASYNCSOFT)(ALuint buffer, ALenum format, const ALvoid *data, ALsizei size, ALsizei samplerate) AL_API_NOEXCEPT17;
+typedef ALuint (AL_APIENTRY*LPALBUFFERDATAASYNCDIRECTSOFT)(ALCcontext *context, ALuint buffer, ALenum format, const ALvoid *data, ALsizei size, ALsizei samplerate) AL_API_NOEXCEPT17;
+#ifdef AL_ALEXT_PROTOTYPES
+AL_API ALuint AL_APIENTRY alBufferDataAsyncSOFT(ALuint buffer, ALenum format, const ALvoid *data, ALsizei size, ALsizei samplerate) AL_API_NOEXCEPT;
+ALuint AL_APIENTRY alBufferDataAsyncDirectSOFT(ALCcontext *context, ALuint buffer, ALenum format, const ALvoid *data, ALsizei size, ALsizei samplerate) AL_API_NOEXCEPT;
+#endif
+#endif
+
+#ifndef AL_SOFT_buffer_reserve
+#define AL_SOFT_buffer_reserve
+#define AL_RESERVE_SIZE_SOFT                     0x19F8
+#endif
+
+#ifndef AL_SOFT_ring_buffer
+#define AL_SOFT_ring_buffer
+#define AL_RING_WRITE_SPACE_SOFT                 0x19F9
+#define AL_RING_END_OF_STREAM_SOFT               0x19FA
+typedef void (AL_APIENTRY*LPALBUFFERRINGSOFT)(ALuint buffer, ALenum format, ALsizei samplerate, ALsizei size) AL_API_NOEXCEPT17;
+typedef ALsizei (AL_APIENTRY*LPALBUFFERRINGWRITESOFT)(ALuint buffer, const ALvoid *data, ALsizei size) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALBUFFERRINGDIRECTSOFT)(ALCcontext *context, ALuint buffer, ALenum format, ALsizei samplerate, ALsizei size) AL_API_NOEXCEPT17;
+typedef ALsizei (AL_APIENTRY*LPALBUFFERRINGWRITEDIRECTSOFT)(ALCcontext *context, ALuint buffer, const ALvoid *data, ALsizei size) AL_API_NOEXCEPT17;
+#ifdef AL_ALEXT_PROTOTYPES
+AL_API void AL_APIENTRY alBufferRingSOFT(ALuint buffer, ALenum format, ALsizei samplerate, ALsizei size) AL_API_NOEXCEPT;
+AL_API ALsizei AL_APIENTRY alBufferRingWriteSOFT(ALuint buffer, const ALvoid *data, ALsizei size) AL_API_NOEXCEPT;
+void AL_APIENTRY alBufferRingDirectSOFT(ALCcontext *context, ALuint buffer, ALenum format, ALsizei samplerate, ALsizei size) AL_API_NOEXCEPT;
+ALsizei AL_APIENTRY alBufferRingWriteDirectSOFT(ALCcontext *context, ALuint buffer, const ALvoid *data, ALsizei size) AL_API_NOEXCEPT;
+#endif
+#endif
+
+#ifndef AL_SOFT_buffer_file
+#define AL_SOFT_buffer_file
+typedef void (AL_APIENTRY*LPALBUFFERFILESOFT)(ALuint buffer, ALenum format, const ALchar *filename, ALint64SOFT offset, ALsizei size, ALsizei samplerate) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALBUFFERFILEDIRECTSOFT)(ALCcontext *context, ALuint buffer, ALenum format, const ALchar *filename, ALint64SOFT offset, ALsizei size, ALsizei samplerate) AL_API_NOEXCEPT17;
+#ifdef AL_ALEXT_PROTOTYPES
+AL_API void AL_APIENTRY alBufferFileSOFT(ALuint buffer, ALenum format, const ALchar *filename, ALint64SOFT offset, ALsizei size, ALsizei samplerate) AL_API_NOEXCEPT;
+void AL_APIENTRY alBufferFileDirectSOFT(ALCcontext *context, ALuint buffer, ALenum format, const ALchar *filename, ALint64SOFT offset, ALsizei size, ALsizei samplerate) AL_API_NOEXCEPT;
+#endif
+#endif
+
+#ifndef AL_SOFT_IMA2_ADPCM
+#define AL_SOFT_IMA2_ADPCM
+#define AL_FORMAT_MONO_IMA2_SOFT                 0x19FB
+#define AL_FORMAT_STEREO_IMA2_SOFT               0x19FC
+#endif
+
+#ifndef ALC_SOFT_mixer_profile
+#define ALC_SOFT_mixer_profile
+#define ALC_MIXER_PROFILE_SIZE_SOFT              0x19FD
+#define ALC_MIXER_PROFILE_SOFT                   0x19FE
+#endif
+
+#ifndef AL_SOFT_event_batch
+#define AL_SOFT_event_batch
+typedef struct ALeventSOFT {
+    ALenum type;
+    ALuint object;
+    ALuint param;
+} ALeventSOFT;
+typedef void (AL_APIENTRY*ALEVENTBATCHPROCSOFT)(ALsizei count, const ALeventSOFT *events, void *userParam) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALEVENTBATCHCALLBACKSOFT)(ALEVENTBATCHPROCSOFT callback, void *userParam) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALEVENTBATCHCALLBACKDIRECTSOFT)(ALCcontext *context, ALEVENTBATCHPROCSOFT callback, void *userParam) AL_API_NOEXCEPT17;
+#ifdef AL_ALEXT_PROTOTYPES
+AL_API void AL_APIENTRY alEventBatchCallbackSOFT(ALEVENTBATCHPROCSOFT callback, void *userParam) AL_API_NOEXCEPT;
+void AL_APIENTRY alEventBatchCallbackDirectSOFT(ALCcontext *context, ALEVENTBATCHPROCSOFT callback, void *userParam) AL_API_NOEXCEPT;
+#endif
+#endif
+
+#ifndef ALC_SOFT_context_reserve
+#define ALC_SOFT_context_reserve
+#define ALC_RESERVE_VOICES_SOFT                  0x19FF
+#define ALC_RESERVE_EFFECT_SLOTS_SOFT            0x1A00
+#endif
+
+#ifndef AL_SOFT_source_batch
+#define AL_SOFT_source_batch
+typedef void (AL_APIENTRY*LPALSOURCESFVSOFT)(ALsizei n, const ALuint *sources, ALenum param, const ALfloat *values) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALSOURCESFVDIRECTSOFT)(ALCcontext *context, ALsizei n, const ALuint *sources, ALenum param, const ALfloat *values) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALGETSOURCESIVSOFT)(ALsizei n, const ALuint *sources, ALenum param, ALint *values) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALGETSOURCESIVDIRECTSOFT)(ALCcontext *context, ALsizei n, const ALuint *sources, ALenum param, ALint *values) AL_API_NOEXCEPT17;
+#ifdef AL_ALEXT_PROTOTYPES
+AL_API void AL_APIENTRY alSourcesfvSOFT(ALsizei n, const ALuint *sources, ALenum param, const ALfloat *values) AL_API_NOEXCEPT;
+void AL_APIENTRY alSourcesfvDirectSOFT(ALCcontext *context, ALsizei n, const ALuint *sources, ALenum param, const ALfloat *values) AL_API_NOEXCEPT;
+AL_API void AL_APIENTRY alGetSourcesivSOFT(ALsizei n, const ALuint *sources, ALenum param, ALint *values) AL_API_NOEXCEPT;
+void AL_APIENTRY alGetSourcesivDirectSOFT(ALCcontext *context, ALsizei n, const ALuint *sources, ALenum param, ALint *values) AL_API_NOEXCEPT;
+#endif
+#endif
+
+#ifndef ALC_SOFT_loopback_batch
+#define ALC_SOFT_loopback_batch
+typedef void (ALC_APIENTRY*LPALCRENDERSAMPLESBATCHSOFT)(ALCsizei n, ALCdevice *const *devices, ALCvoid *const *buffers, ALCsizei samples) AL_API_NOEXCEPT17;
+#ifdef AL_ALEXT_PROTOTYPES
+ALC_API void ALC_APIENTRY alcRenderSamplesBatchSOFT(ALCsizei n, ALCdevice *const *devices, ALCvoid *const *buffers, ALCsizei samples) AL_API_NOEXCEPT;
+#endif
+#endif
+
+#ifndef ALC_SOFT_loopback_planar
+#define ALC_SOFT_loopback_planar
+typedef void (ALC_APIENTRY*LPALCRENDERSAMPLESPLANARSOFT)(ALCdevice *device, ALCfloat *const *buffers, ALCsizei numbuffers, ALCsizei samples) AL_API_NOEXCEPT17;
+#ifdef AL_ALEXT_PROTOTYPES
+ALC_API void ALC_APIENTRY alcRenderSamplesPlanarSOFT(ALCdevice *device, ALCfloat *const *buffers, ALCsizei numbuffers, ALCsizei samples) AL_API_NOEXCEPT;
+#endif
+#endif
+
+#ifndef ALC_SOFT_capture_map
+#define ALC_SOFT_capture_map
+typedef ALCsizei (ALC_APIENTRY*LPALCCAPTUREMAPSAMPLESSOFT)(ALCdevice *device, ALCvoid **buffers, ALCsizei *samples) AL_API_NOEXCEPT17;
+typedef void (ALC_APIENTRY*LPALCCAPTURERELEASESAMPLESSOFT)(ALCdevice *device, ALCsizei samples) AL_API_NOEXCEPT17;
+#ifdef AL_ALEXT_PROTOTYPES
+ALC_API ALCsizei ALC_APIENTRY alcCaptureMapSamplesSOFT(ALCdevice *device, ALCvoid **buffers, ALCsizei *samples) AL_API_NOEXCEPT;
+ALC_API void ALC_APIENTRY alcCaptureReleaseSamplesSOFT(ALCdevice *device, ALCsizei samples) AL_API_NOEXCEPT;
+#endif
+#endif
+
+#ifndef ALC_SOFT_buffer_share
+#define ALC_SOFT_buffer_share
+typedef ALCboolean (ALC_APIENTRY*LPALCBUFFERSHAREDATASOFT)(ALCdevice *device, ALCuint buffer, ALCdevice *srcdevice, ALCuint srcbuffer) AL_API_NOEXCEPT17;
+#ifdef AL_ALEXT_PROTOTYPES
+ALC_API ALCboolean ALC_APIENTRY alcBufferShareDataSOFT(ALCdevice *device, ALCuint buffer, ALCdevice *srcdevice, ALCuint srcbuffer) AL_API_NOEXCEPT;
+#endif
+#endif
+
+#ifndef ALC_SOFT_device_query
+#define ALC_SOFT_device_query
+#define ALC_DEVICE_CONFIGURED_SOFT               0x1A01
+#define ALC_MIN_FREQUENCY_SOFT                   0x1A02
+#define ALC_MAX_FREQUENCY_SOFT                   0x1A03
+#define ALC_NUM_OUTPUT_MODES_SOFT                0x1A04
+#define ALC_OUTPUT_MODES_SOFT                    0x1A05
+#endif
+
+#ifndef AL_SOFT_source_group
+#define AL_SOFT_source_group
+#define AL_EFFECT_SOURCE_GROUP_SOFT              0xA001
+#define AL_SOURCE_GROUP_RELATIVE_SOFT            0x0202 /* same as AL_SOURCE_RELATIVE */
+#define AL_SOURCE_GROUP_POSITION_SOFT            0x1004 /* same as AL_POSITION */
+#define AL_SOURCE_GROUP_GAIN_SOFT                0x100A /* same as AL_GAIN */
+#define AL_SOURCE_GROUP_REFERENCE_DISTANCE_SOFT  0x1020 /* same as AL_REFERENCE_DISTANCE */
+#define AL_SOURCE_GROUP_ROLLOFF_FACTOR_SOFT      0x1021 /* same as AL_ROLLOFF_FACTOR */
+#endif
+
+#ifndef AL_SOFT_source_instancing
+#define AL_SOFT_source_instancing
+#define AL_SOURCE_INSTANCING_SOFT                0x1A06
+#endif
+
+#ifndef AL_SOFT_callback_prefetch
+#define AL_SOFT_callback_prefetch
+#define AL_CALLBACK_REQUEST_SIZE_SOFT            0x1A07
+#define AL_CALLBACK_PREFETCH_SOFT                0x1A08
+#endif
+
+#ifndef ALC_SOFT_mix_frequency
+#define ALC_SOFT_mix_frequency
+#define ALC_MIX_FREQUENCY_SOFT                   0x1A09
+#endif
+
+#ifndef AL_SOFT_half_float
+#define AL_SOFT_half_float
+#define AL_FORMAT_MONO_HALF_SOFT                 0x1A0A
+#define AL_FORMAT_STEREO_HALF_SOFT               0x1A0B
+#define AL_FORMAT_QUAD_HALF_SOFT                 0x1A0C
+#define AL_FORMAT_51CHN_HALF_SOFT                0x1A0D
+#define AL_FORMAT_61CHN_HALF_SOFT                0x1A0E
+#define AL_FORMAT_71CHN_HALF_SOFT                0x1A0F
+#define AL_FORMAT_BFORMAT2D_HALF_SOFT            0x1A10
+#define AL_FORMAT_BFORMAT3D_HALF_SOFT            0x1A11
+#endif
+
+#ifndef ALC_SOFT_memory_usage
+#define ALC_SOFT_memory_usage
+#define ALC_MEMORY_USAGE_SIZE_SOFT               0x1A12
+#define ALC_MEMORY_USAGE_SOFT                    0x1A13
+#endif
+
+#ifndef ALC_SOFT_capture_notify
+#define ALC_SOFT_capture_notify
+#define ALC_EVENT_TYPE_CAPTURE_READY_SOFT        0x1A14
+typedef void (ALC_APIENTRY*LPALCCAPTURETHRESHOLDSOFT)(ALCdevice *device, ALCsizei samples) AL_API_NOEXCEPT17;
+typedef ALCboolean (ALC_APIENTRY*LPALCCAPTUREWAITSOFT)(ALCdevice *device, ALCsizei samples, ALCuint timeout_ms) AL_API_NOEXCEPT17;
+#ifdef AL_ALEXT_PROTOTYPES
+ALC_API void ALC_APIENTRY alcCaptureThresholdSOFT(ALCdevice *device, ALCsizei samples) AL_API_NOEXCEPT;
+ALC_API ALCboolean ALC_APIENTRY alcCaptureWaitSOFT(ALCdevice *device, ALCsizei samples, ALCuint timeout_ms) AL_API_NOEXCEPT;
+#endif
+#endif
+
+#ifndef AL_SOFT_multi_listener
+#define AL_SOFT_multi_listener
+#define ALC_MAX_LISTENERS_SOFT                   0x1A15
+#define AL_LISTENER_OUTPUT_SOFT                  0x1A16
+typedef void (AL_APIENTRY*LPALLISTENERINDEXEDFVSOFT)(ALuint index, ALenum param, const ALfloat *values) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALLISTENERINDEXEDIVSOFT)(ALuint index, ALenum param, const ALint *values) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALGETLISTENERINDEXEDFVSOFT)(ALuint index, ALenum param, ALfloat *values) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALGETLISTENERINDEXEDIVSOFT)(ALuint index, ALenum param, ALint *values) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALLISTENERINDEXEDFVDIRECTSOFT)(ALCcontext *context, ALuint index, ALenum param, const ALfloat *values) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALLISTENERINDEXEDIVDIRECTSOFT)(ALCcontext *context, ALuint index, ALenum param, const ALint *values) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALGETLISTENERINDEXEDFVDIRECTSOFT)(ALCcontext *context, ALuint index, ALenum param, ALfloat *values) AL_API_NOEXCEPT17;
+typedef void (AL_APIENTRY*LPALGETLISTENERINDEXEDIVDIRECTSOFT)(ALCcontext *context, ALuint index, ALenum param, ALint *values) AL_API_NOEXCEPT17;
+#ifdef AL_ALEXT_PROTOTYPES
+AL_API void AL_APIENTRY alListenerIndexedfvSOFT(ALuint index, ALenum param, const ALfloat *values) AL_API_NOEXCEPT;
+AL_API void AL_APIENTRY alListenerIndexedivSOFT(ALuint index, ALenum param, const ALint *values) AL_API_NOEXCEPT;
+AL_API void AL_APIENTRY alGetListenerIndexedfvSOFT(ALuint index, ALenum param, ALfloat *values) AL_API_NOEXCEPT;
+AL_API void AL_APIENTRY alGetListenerIndexedivSOFT(ALuint index, ALenum param, ALint *values) AL_API_NOEXCEPT;
+void AL_APIENTRY alListenerIndexedfvDirectSOFT(ALCcontext *context, ALuint index, ALenum param, const ALfloat *values) AL_API_NOEXCEPT;
+void AL_APIENTRY alListenerIndexedivDirectSOFT(ALCcontext *context, ALuint index, ALenum param, const ALint *values) AL_API_NOEXCEPT;
+void AL_APIENTRY alGetListenerIndexedfvDirectSOFT(ALCcontext *context, ALuint index, ALenum param, ALfloat *values) AL_API_NOEXCEPT;
+void AL_APIENTRY alGetListenerIndexedivDirectSOFT(ALCcontext *context, ALuint index, ALenum param, ALint *values) AL_API_NOEXCEPT;
+#endif
+#endif
+
+#ifndef AL_SOFT_reverb_zones
+#define AL_SOFT_reverb_zones
+#define AL_REVERB_ZONE_MODE_SOFT                 0x1A17
+#define AL_EAXREVERB_ZONE_MODE_SOFT              0x1A17
+#define AL_REVERB_FULL_SOFT                      0
+#define AL_REVERB_EARLY_ZONE_SOFT                1
+#define AL_REVERB_SHARED_LATE_SOFT               2
+#endif
+
+#ifndef AL_SOFT_buffer_completed_clock
+#define AL_SOFT_buffer_completed_clock
+#define AL_BUFFER_COMPLETED_CLOCK_SOFT           0x1A18
+#endif
+
+#ifndef ALC_SOFT_reload_config
+#define ALC_SOFT_reload_config
+typedef ALCboolean (ALC_APIENTRY*LPALCRELOADCONFIGSOFT)(ALCdevice *device) AL_API_NOEXCEPT17;
+#ifdef AL_ALEXT_PROTOTYPES
+ALC_API ALCboolean ALC_APIENTRY alcReloadConfigSOFT(ALCdevice *device) AL_API_NOEXCEPT;
+#endif
+#endif
+
 /* Non-standard exports. Not part of any extension. */
 AL_API const ALchar* AL_APIENTRY alsoft_get_version(void) noexcept;
 
 typedef void (ALC_APIENTRY*LPALSOFTLOGCALLBACK)(void *userptr, char level, const char *message, int length) noexcept;
 void ALC_APIENTRY alsoft_set_log_callback(LPALSOFTLOGCALLBACK callback, void *userptr) noexcept;
 
+typedef void (ALC_APIENTRY*LPALSOFTTRACECALLBACK)(void *userptr, const char *name, unsigned int id, int begin) noexcept;
+void ALC_APIENTRY alsoft_set_trace_callback(LPALSOFTTRACECALLBACK callback, void *userptr) noexcept;
+
 /* Functions from abandoned extensions. Only here for binary compatibility. */
 AL_API void AL_APIENTRY alSourceQueueBufferLayersSOFT(ALuint src, ALsizei nb,
     const ALuint *buffers) noexcept;
@@ -126,9 +126,12 @@ const char *GetLabelFromChannel(Channel channel)
 }
 
 
-std::unique_ptr<FrontStablizer> CreateStablizer(const size_t outchans, const uint srate)
+std::unique_ptr<FrontStablizer> CreateStablizer(const ALCdevice *device)
 {
-    auto stablizer = FrontStablizer::Create(outchans);
+    const uint srate{device->mMixFrequency};
+    auto stablizer = FrontStablizer::Create(device->channelsFromFmt(),
+        device->RealOut.ChannelIndex[FrontLeft], device->RealOut.ChannelIndex[FrontRight],
+        device->RealOut.ChannelIndex[FrontCenter]);
 
     /* Initialize band-splitting filter for the mid signal, with a crossover at
      * 5khz (could be higher).
@@ -205,12 +208,17 @@ struct DecoderConfig<DualBand, 0> {
     al::span<const ChannelCoeffs> mCoeffs;
     al::span<const float> mOrderGainLF;
     al::span<const ChannelCoeffs> mCoeffsLF;
+    /* Mixed-order decoders are periphonic for first-order, and horizontal-only
+     * for higher orders.
+     */
+    bool mIsMixed{};
 
     template<size_t N>
     DecoderConfig& operator=(const DecoderConfig<SingleBand,N> &rhs) noexcept
     {
         mOrder = rhs.mOrder;
         mIs3D = rhs.mIs3D;
+        mIsMixed = false;
         mChannels = rhs.mChannels;
         mScaling = rhs.mScaling;
         mOrderGain = rhs.mOrderGain;
@@ -225,6 +233,7 @@ struct DecoderConfig<DualBand, 0> {
     {
         mOrder = rhs.mOrder;
         mIs3D = rhs.mIs3D;
+        mIsMixed = false;
         mChannels = rhs.mChannels;
         mScaling = rhs.mScaling;
         mOrderGain = rhs.mOrderGain;
@@ -235,15 +244,34 @@ struct DecoderConfig<DualBand, 0> {
     }
 
     explicit operator bool() const noexcept { return !mChannels.empty(); }
+
+    /* The ACN of each ambisonic channel the decoder takes. */
+    [[nodiscard]] auto getAcnMap() const noexcept -> al::span<const uint8_t>
+    {
+        if(mIsMixed)
+            return al::span{AmbiIndex::FromACNMixed}.first(AmbiMixedChannelsFromOrder(mOrder));
+        if(mIs3D)
+            return al::span{AmbiIndex::FromACN}.first(AmbiChannelsFromOrder(mOrder));
+        return al::span{AmbiIndex::FromACN2D}.first(Ambi2DChannelsFromOrder(mOrder));
+    }
+
+    /* The order of each ambisonic channel the decoder takes. */
+    [[nodiscard]] auto getOrderMap() const noexcept -> al::span<const uint8_t>
+    {
+        if(mIsMixed)
+            return al::span{AmbiIndex::OrderFromMixedChannel}
+                .first(AmbiMixedChannelsFromOrder(mOrder));
+        if(mIs3D)
+            return al::span{AmbiIndex::OrderFromChannel}.first(AmbiChannelsFromOrder(mOrder));
+        return al::span{AmbiIndex::OrderFrom2DChannel}.first(Ambi2DChannelsFromOrder(mOrder));
+    }
 };
 using DecoderView = DecoderConfig<DualBand, 0>;
 
 
-void InitNearFieldCtrl(ALCdevice *device, const float ctrl_dist, const uint order, const bool is3d)
+void InitNearFieldCtrl(ALCdevice *device, const float ctrl_dist,
+    const al::span<const uint8_t> ordermap)
 {
-    static const std::array<uint,MaxAmbiOrder+1> chans_per_order2d{{1, 2, 2, 2}};
-    static const std::array<uint,MaxAmbiOrder+1> chans_per_order3d{{1, 3, 5, 7}};
-
     /* NFC is only used when AvgSpeakerDist is greater than 0. */
     if(!device->getConfigValueBool("decoder", "nfc", false) || !(ctrl_dist > 0.0f))
         return;
@@ -252,12 +280,13 @@ void InitNearFieldCtrl(ALCdevice *device, const float ctrl_dist, const uint orde
     TRACE("Using near-field reference distance: %.2f meters\n", device->AvgSpeakerDist);
 
     const float w1{SpeedOfSoundMetersPerSec /
-        (device->AvgSpeakerDist * static_cast<float>(device->Frequency))};
+        (device->AvgSpeakerDist * static_cast<float>(device->mMixFrequency))};
     device->mNFCtrlFilter.init(w1);
 
-    auto iter = std::copy_n(is3d ? chans_per_order3d.begin() : chans_per_order2d.begin(), order+1u,
-        device->NumChannelsPerOrder.begin());
-    std::fill(iter, device->NumChannelsPerOrder.end(), 0u);
+    /* The channels are grouped by order, so just count them. */
+    device->NumChannelsPerOrder.fill(0u);
+    for(const uint8_t order : ordermap)
+        ++device->NumChannelsPerOrder[order];
 }
 
 void InitDistanceComp(ALCdevice *device, const al::span<const Channel> channels,
@@ -354,6 +383,11 @@ DecoderView MakeDecoderView(ALCdevice *device, const AmbDecConf *conf,
         (conf->ChanMask > Ambi2OrderMask) ? uint8_t{3} :
         (conf->ChanMask > Ambi1OrderMask) ? uint8_t{2} : uint8_t{1};
     decoder.mIs3D = (conf->ChanMask&AmbiPeriphonicMask) != 0;
+    /* A higher-order decoder whose only height channel is first-order's Z is
+     * mixed-order, and only needs the channels it uses.
+     */
+    const bool is_mixed{decoder.mOrder > 1 && decoder.mIs3D
+        && (conf->ChanMask&AmbiPeriphonicMask&~Ambi1OrderMask) == 0};
 
     switch(conf->CoeffScale)
     {
@@ -368,9 +402,11 @@ DecoderView MakeDecoderView(ALCdevice *device, const AmbDecConf *conf,
     const auto lfordermin = std::min(conf->LFOrderGain.size(), decoder.mOrderGainLF.size());
     std::copy_n(conf->LFOrderGain.begin(), lfordermin, decoder.mOrderGainLF.begin());
 
-    const auto num_coeffs = decoder.mIs3D ? AmbiChannelsFromOrder(decoder.mOrder)
+    const auto num_coeffs = is_mixed ? AmbiMixedChannelsFromOrder(decoder.mOrder)
+        : decoder.mIs3D ? AmbiChannelsFromOrder(decoder.mOrder)
         : Ambi2DChannelsFromOrder(decoder.mOrder);
-    const auto idx_map = decoder.mIs3D ? al::span<const uint8_t>{AmbiIndex::FromACN}
+    const auto idx_map = is_mixed ? al::span<const uint8_t>{AmbiIndex::FromACNMixed}
+        : decoder.mIs3D ? al::span<const uint8_t>{AmbiIndex::FromACN}
         : al::span<const uint8_t>{AmbiIndex::FromACN2D};
     const auto hfmatrix = conf->HFMatrix;
     const auto lfmatrix = conf->LFMatrix;
@@ -471,6 +507,7 @@ DecoderView MakeDecoderView(ALCdevice *device, const AmbDecConf *conf,
     {
         ret.mOrder = decoder.mOrder;
         ret.mIs3D = decoder.mIs3D;
+        ret.mIsMixed = is_mixed;
         ret.mScaling = decoder.mScaling;
         ret.mChannels = al::span{decoder.mChannels}.first(chan_count);
         ret.mOrderGain = decoder.mOrderGain;
@@ -686,13 +723,15 @@ void InitPanning(ALCdevice *device, const bool hqdec=false, const bool stablize=
                 avg_dist = *delayopt * SpeedOfSoundMetersPerSec;
             }
 
-            InitNearFieldCtrl(device, avg_dist, device->mAmbiOrder, true);
+            InitNearFieldCtrl(device, avg_dist,
+                al::span{AmbiIndex::OrderFromChannel}.first(count));
             return;
         }
     }
 
-    const size_t ambicount{decoder.mIs3D ? AmbiChannelsFromOrder(decoder.mOrder) :
-        Ambi2DChannelsFromOrder(decoder.mOrder)};
+    const auto acnmap = decoder.getAcnMap();
+    const auto ordermap = decoder.getOrderMap();
+    const size_t ambicount{acnmap.size()};
     const bool dual_band{hqdec && !decoder.mCoeffsLF.empty()};
     std::vector<ChannelDec> chancoeffs, chancoeffslf;
     for(size_t i{0u};i < decoder.mChannels.size();++i)
@@ -705,9 +744,6 @@ void InitPanning(ALCdevice *device, const bool hqdec=false, const bool stablize=
             continue;
         }
 
-        auto ordermap = decoder.mIs3D ? al::span<const uint8_t>{AmbiIndex::OrderFromChannel}
-            : al::span<const uint8_t>{AmbiIndex::OrderFrom2DChannel};
-
         chancoeffs.resize(std::max(chancoeffs.size(), idx+1_zu), ChannelDec{});
         al::span<const float,MaxAmbiChannels> src{decoder.mCoeffs[i]};
         al::span<float,MaxAmbiChannels> dst{chancoeffs[idx]};
@@ -728,8 +764,6 @@ void InitPanning(ALCdevice *device, const bool hqdec=false, const bool stablize=
     device->mAmbiOrder = decoder.mOrder;
     device->m2DMixing = !decoder.mIs3D;
 
-    const auto acnmap = decoder.mIs3D ? al::span{AmbiIndex::FromACN}.first(ambicount)
-        : al::span{AmbiIndex::FromACN2D}.first(ambicount);
     const auto coeffscale = GetAmbiScales(decoder.mScaling);
     std::transform(acnmap.begin(), acnmap.end(), device->Dry.AmbiMap.begin(),
         [coeffscale](const uint8_t &acn) noexcept
@@ -756,7 +790,7 @@ void InitPanning(ALCdevice *device, const bool hqdec=false, const bool stablize=
         }
         if(!hasfc)
         {
-            stablizer = CreateStablizer(device->channelsFromFmt(), device->Frequency);
+            stablizer = CreateStablizer(device);
             TRACE("Front stablizer enabled\n");
         }
     }
@@ -766,9 +800,9 @@ void InitPanning(ALCdevice *device, const bool hqdec=false, const bool stablize=
         (decoder.mOrder > 3) ? "fourth" :
         (decoder.mOrder > 2) ? "third" :
         (decoder.mOrder > 1) ? "second" : "first",
-        decoder.mIs3D ? " periphonic" : "");
+        decoder.mIsMixed ? " mixed-order" : decoder.mIs3D ? " periphonic" : "");
     device->AmbiDecoder = BFormatDec::Create(ambicount, chancoeffs, chancoeffslf,
-        device->mXOverFreq/static_cast<float>(device->Frequency), std::move(stablizer));
+        device->mXOverFreq/static_cast<float>(device->mMixFrequency), std::move(stablizer));
 }
 
 void InitHrtfPanning(ALCdevice *device)
@@ -980,7 +1014,8 @@ void InitHrtfPanning(ALCdevice *device)
         AmbiOrderHFGain);
     device->mHrtfState = std::move(hrtfstate);
 
-    InitNearFieldCtrl(device, Hrtf->mFields[0].distance, ambi_order, true);
+    InitNearFieldCtrl(device, Hrtf->mFields[0].distance,
+        al::span{AmbiIndex::OrderFromChannel}.first(count));
 }
 
 void InitUhjPanning(ALCdevice *device)
@@ -998,6 +1033,28 @@ void InitUhjPanning(ALCdevice *device)
     AllocChannels(device, count, device->channelsFromFmt());
 }
 
+/* Takes the HRTF from the device's background loader, if it's done loading
+ * for the device's sample rate. Otherwise, flags the device as waiting for it.
+ */
+void UseLoadedHrtf(ALCdevice *device)
+{
+    HrtfLoader &loader = *device->mHrtfLoader;
+    std::lock_guard<std::mutex> loadlock{loader.mMutex};
+    if(!loader.mDone || loader.mRate != device->mMixFrequency)
+    {
+        device->mHrtfPending = true;
+        return;
+    }
+
+    if(device->mHrtfList.empty())
+        device->mHrtfList = loader.mList;
+    if(loader.mHrtf)
+    {
+        device->mHrtf = HrtfStorePtr{loader.mHrtf};
+        device->mHrtfName = loader.mName;
+    }
+}
+
 } // namespace
 
 void aluInitRenderer(ALCdevice *device, int hrtf_id, std::optional<StereoEncoding> stereomode)
@@ -1006,9 +1063,12 @@ void aluInitRenderer(ALCdevice *device, int hrtf_id, std::optional<StereoEncodin
     HrtfStorePtr old_hrtf{std::move(device->mHrtf)};
 
     device->mHrtfState = nullptr;
+    device->mHrtfCoeffCache = nullptr;
     device->mHrtf = nullptr;
+    device->mMemory->set(MemoryUsage::Hrtf, 0);
     device->mIrSize = 0;
     device->mHrtfName.clear();
+    device->mHrtfPending = false;
     device->mXOverFreq = 400.0f;
     device->m2DMixing = false;
     device->mRenderMode = RenderMode::Normal;
@@ -1106,7 +1166,7 @@ void aluInitRenderer(ALCdevice *device, int hrtf_id, std::optional<StereoEncodin
 
             const float avg_dist{(accum_dist > 0.0f && spkr_count > 0) ? accum_dist/spkr_count :
                 device->configValue<float>("decoder", "speaker-dist").value_or(1.0f)};
-            InitNearFieldCtrl(device, avg_dist, decoder.mOrder, decoder.mIs3D);
+            InitNearFieldCtrl(device, avg_dist, decoder.getOrderMap());
 
             if(spkr_count > 0)
                 InitDistanceComp(device, decoder.mChannels, speakerdists);
@@ -1126,28 +1186,34 @@ void aluInitRenderer(ALCdevice *device, int hrtf_id, std::optional<StereoEncodin
     if(stereomode.value_or(StereoEncoding::Default) == StereoEncoding::Hrtf
         || (!stereomode && device->Flags.test(DirectEar)))
     {
-        if(device->mHrtfList.empty())
-            device->enumerateHrtfs();
-
-        if(hrtf_id >= 0 && static_cast<uint>(hrtf_id) < device->mHrtfList.size())
+        /* A specifically requested HRTF is still loaded here. */
+        if(device->mHrtfLoader && hrtf_id < 0)
+            UseLoadedHrtf(device);
+        else
         {
-            const std::string_view hrtfname{device->mHrtfList[static_cast<uint>(hrtf_id)]};
-            if(HrtfStorePtr hrtf{GetLoadedHrtf(hrtfname, device->Frequency)})
-            {
-                device->mHrtf = std::move(hrtf);
-                device->mHrtfName = hrtfname;
-            }
-        }
+            if(device->mHrtfList.empty())
+                device->enumerateHrtfs();
 
-        if(!device->mHrtf)
-        {
-            for(const std::string_view hrtfname : device->mHrtfList)
+            if(hrtf_id >= 0 && static_cast<uint>(hrtf_id) < device->mHrtfList.size())
             {
-                if(HrtfStorePtr hrtf{GetLoadedHrtf(hrtfname, device->Frequency)})
+                const std::string_view hrtfname{device->mHrtfList[static_cast<uint>(hrtf_id)]};
+                if(HrtfStorePtr hrtf{GetLoadedHrtf(hrtfname, device->mMixFrequency)})
                 {
                     device->mHrtf = std::move(hrtf);
                     device->mHrtfName = hrtfname;
-                    break;
+                }
+            }
+
+            if(!device->mHrtf)
+            {
+                for(const std::string_view hrtfname : device->mHrtfList)
+                {
+                    if(HrtfStorePtr hrtf{GetLoadedHrtf(hrtfname, device->mMixFrequency)})
+                    {
+                        device->mHrtf = std::move(hrtf);
+                        device->mHrtfName = hrtfname;
+                        break;
+                    }
                 }
             }
         }
@@ -1164,7 +1230,23 @@ void aluInitRenderer(ALCdevice *device, int hrtf_id, std::optional<StereoEncodin
                     device->mIrSize = std::max(*hrtfsizeopt, MinIrLength);
             }
 
+            /* Cache blended HRIRs for per-source HRTF, if a direction
+             * resolution is given.
+             */
+            if(auto resopt = device->configValue<float>({}, "hrtf-angle-resolution"))
+            {
+                if(*resopt > 0.0f)
+                {
+                    const float res{std::clamp(*resopt, 0.1f, 45.0f)};
+                    TRACE("Caching HRIRs with %.2f degree resolution\n", res);
+                    device->mHrtfCoeffCache = std::make_unique<HrtfCoeffCache>(
+                        res * al::numbers::pi_v<float> / 180.0f);
+                }
+            }
+
             InitHrtfPanning(device);
+            device->mMemory->set(MemoryUsage::Hrtf, hrtf->mTotalSize
+                + DirectHrtfState::Sizeof(device->mHrtfState->mChannels.size()));
             device->PostProcess = &ALCdevice::ProcessHrtf;
             device->mHrtfStatus = ALC_HRTF_ENABLED_SOFT;
             return;
@@ -1174,7 +1256,7 @@ void aluInitRenderer(ALCdevice *device, int hrtf_id, std::optional<StereoEncodin
 
     if(stereomode.value_or(StereoEncoding::Default) == StereoEncoding::Uhj)
     {
-        switch(UhjEncodeQuality)
+        switch(device->mUhjEncodeQuality)
         {
         case UhjQualityType::IIR:
             device->mUhjEncoder = std::make_unique<UhjEncoderIIR>();
@@ -1202,7 +1284,7 @@ void aluInitRenderer(ALCdevice *device, int hrtf_id, std::optional<StereoEncodin
             if(*cflevopt > 0 && *cflevopt <= 6)
             {
                 auto bs2b = std::make_unique<Bs2b::bs2b>();
-                bs2b->set_params(*cflevopt, static_cast<int>(device->Frequency));
+                bs2b->set_params(*cflevopt, static_cast<int>(device->mMixFrequency));
                 device->Bs2b = std::move(bs2b);
                 TRACE("BS2B enabled\n");
                 InitPanning(device);
@@ -1230,4 +1312,6 @@ void aluInitEffectPanning(EffectSlot *slot, ALCcontext *context)
         [](const uint8_t &acn) noexcept -> BFChannelConfig { return BFChannelConfig{1.0f, acn}; });
     std::fill(iter, slot->Wet.AmbiMap.end(), BFChannelConfig{});
     slot->Wet.Buffer = slot->mWetBuffer;
+    slot->mDirectOut.Buffer = {};
+    slot->mSleeping = false;
 }
@@ -0,0 +1,473 @@
+/*
+ * OpenAL Scene Benchmark
+ *
+ * Copyright (c) 2026 by authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* This renders a synthetic scene on a loopback device as fast as possible and
+ * reports how quickly it mixes. The scene has a number of looping 3D sources
+ * circling the listener, optionally feeding reverb and convolution effect
+ * slots, rendered to a chosen output format with or without HRTF. Each
+ * alcRenderSamplesSOFT call is timed separately, giving the real-time factor
+ * and per-update render time percentiles. Source updates are made between
+ * render calls and aren't included in the timing.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "AL/al.h"
+#include "AL/alc.h"
+#include "AL/alext.h"
+#include "AL/efx.h"
+
+#include "win_main_utf8.h"
+
+namespace {
+
+using std::chrono::steady_clock;
+using std::chrono::duration;
+using std::chrono::duration_cast;
+using microseconds_f = duration<double,std::micro>;
+
+#ifndef AL_SOFT_convolution_effect
+#define AL_SOFT_convolution_effect
+#define AL_EFFECT_CONVOLUTION_SOFT               0xA000
+#endif
+
+constexpr float Pi{3.14159265358979323846f};
+
+LPALCLOOPBACKOPENDEVICESOFT p_alcLoopbackOpenDeviceSOFT{};
+LPALCISRENDERFORMATSUPPORTEDSOFT p_alcIsRenderFormatSupportedSOFT{};
+LPALCRENDERSAMPLESSOFT p_alcRenderSamplesSOFT{};
+
+LPALGENEFFECTS p_alGenEffects{};
+LPALDELETEEFFECTS p_alDeleteEffects{};
+LPALEFFECTI p_alEffecti{};
+LPALGENAUXILIARYEFFECTSLOTS p_alGenAuxiliaryEffectSlots{};
+LPALDELETEAUXILIARYEFFECTSLOTS p_alDeleteAuxiliaryEffectSlots{};
+LPALAUXILIARYEFFECTSLOTI p_alAuxiliaryEffectSloti{};
+
+
+struct Options {
+    ALCint mSources{32};
+    bool mHrtf{false};
+    ALCint mReverbs{0};
+    bool mConvolution{false};
+    ALCenum mChannels{ALC_STEREO_SOFT};
+    ALCint mAmbiOrder{0};
+    ALCint mRate{48000};
+    ALCint mUpdateSize{512};
+    double mSeconds{10.0};
+};
+
+struct ChannelName {
+    std::string_view mName;
+    ALCenum mChannels;
+    ALCint mCount;
+    ALCint mAmbiOrder;
+};
+constexpr ChannelName ChannelNames[]{
+    {"mono", ALC_MONO_SOFT, 1, 0},
+    {"stereo", ALC_STEREO_SOFT, 2, 0},
+    {"quad", ALC_QUAD_SOFT, 4, 0},
+    {"5.1", ALC_5POINT1_SOFT, 6, 0},
+    {"6.1", ALC_6POINT1_SOFT, 7, 0},
+    {"7.1", ALC_7POINT1_SOFT, 8, 0},
+    {"ambi1", ALC_BFORMAT3D_SOFT, 4, 1},
+    {"ambi2", ALC_BFORMAT3D_SOFT, 9, 2},
+    {"ambi3", ALC_BFORMAT3D_SOFT, 16, 3},
+    {"ambi4", ALC_BFORMAT3D_SOFT, 25, 4},
+};
+
+
+void printUsage(const char *argv0)
+{
+    std::printf("Usage: %s [options]\n\n"
+        "Options:\n"
+        "  --sources <n>      Number of moving 3D sources (default 32)\n"
+        "  --hrtf             Enable HRTF (stereo output only)\n"
+        "  --reverbs <n>      Number of reverb effect slots (default 0)\n"
+        "  --convolution      Add a convolution effect slot with a 1s stereo response\n"
+        "  --channels <name>  Output channels: mono, stereo, quad, 5.1, 6.1, 7.1,\n"
+        "                     ambi1, ambi2, ambi3, or ambi4 (default stereo)\n"
+        "  --rate <hz>        Output sample rate (default 48000)\n"
+        "  --update <frames>  Sample frames rendered per update (default 512)\n"
+        "  --seconds <s>      Seconds of audio to render (default 10)\n", argv0);
+}
+
+bool parseArgs(int argc, char **argv, Options &opts)
+{
+    for(int i{1};i < argc;++i)
+    {
+        const std::string_view arg{argv[i]};
+        const bool hasval{i+1 < argc};
+
+        if(arg == "--sources" && hasval)
+            opts.mSources = std::atoi(argv[++i]);
+        else if(arg == "--hrtf")
+            opts.mHrtf = true;
+        else if(arg == "--reverbs" && hasval)
+            opts.mReverbs = std::atoi(argv[++i]);
+        else if(arg == "--convolution")
+            opts.mConvolution = true;
+        else if(arg == "--channels" && hasval)
+        {
+            const std::string_view name{argv[++i]};
+            auto iter = std::find_if(std::begin(ChannelNames), std::end(ChannelNames),
+                [name](const ChannelName &chans) { return chans.mName == name; });
+            if(iter == std::end(ChannelNames))
+            {
+                std::fprintf(stderr, "Unknown channel configuration: %s\n", argv[i]);
+                return false;
+            }
+            opts.mChannels = iter->mChannels;
+            opts.mAmbiOrder = iter->mAmbiOrder;
+        }
+        else if(arg == "--rate" && hasval)
+            opts.mRate = std::atoi(argv[++i]);
+        else if(arg == "--update" && hasval)
+            opts.mUpdateSize = std::atoi(argv[++i]);
+        else if(arg == "--seconds" && hasval)
+            opts.mSeconds = std::atof(argv[++i]);
+        else
+        {
+            if(arg != "-h" && arg != "--help")
+                std::fprintf(stderr, "Invalid option: %s\n\n", argv[i]);
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+
+    if(opts.mSources < 0 || opts.mReverbs < 0 || opts.mRate < 8000 || opts.mUpdateSize < 1
+        || !(opts.mSeconds > 0.0))
+    {
+        std::fprintf(stderr, "Invalid option value\n");
+        return false;
+    }
+    if(opts.mHrtf && opts.mChannels != ALC_STEREO_SOFT)
+    {
+        std::fprintf(stderr, "HRTF requires stereo output\n");
+        return false;
+    }
+    return true;
+}
+
+ALCint channelCount(const Options &opts)
+{
+    auto iter = std::find_if(std::begin(ChannelNames), std::end(ChannelNames),
+        [&opts](const ChannelName &chans)
+        { return chans.mChannels == opts.mChannels && chans.mAmbiOrder == opts.mAmbiOrder; });
+    return iter->mCount;
+}
+
+bool loadProcs()
+{
+#define LOAD_ALC_PROC(x) p_##x = reinterpret_cast<decltype(p_##x)>(alcGetProcAddress(nullptr, #x))
+    LOAD_ALC_PROC(alcLoopbackOpenDeviceSOFT);
+    LOAD_ALC_PROC(alcIsRenderFormatSupportedSOFT);
+    LOAD_ALC_PROC(alcRenderSamplesSOFT);
+#undef LOAD_ALC_PROC
+    return p_alcLoopbackOpenDeviceSOFT && p_alcIsRenderFormatSupportedSOFT
+        && p_alcRenderSamplesSOFT;
+}
+
+bool loadEfxProcs()
+{
+#define LOAD_AL_PROC(x) p_##x = reinterpret_cast<decltype(p_##x)>(alGetProcAddress(#x))
+    LOAD_AL_PROC(alGenEffects);
+    LOAD_AL_PROC(alDeleteEffects);
+    LOAD_AL_PROC(alEffecti);
+    LOAD_AL_PROC(alGenAuxiliaryEffectSlots);
+    LOAD_AL_PROC(alDeleteAuxiliaryEffectSlots);
+    LOAD_AL_PROC(alAuxiliaryEffectSloti);
+#undef LOAD_AL_PROC
+    return p_alGenEffects && p_alDeleteEffects && p_alEffecti && p_alGenAuxiliaryEffectSlots
+        && p_alDeleteAuxiliaryEffectSlots && p_alAuxiliaryEffectSloti;
+}
+
+
+/* Creates a buffer of reproducible noise. With a decay time, each channel
+ * decays exponentially to -60dB, making a simple diffuse impulse response.
+ */
+ALuint createNoiseBuffer(ALenum format, ALsizei channels, ALsizei frames, ALsizei rate,
+    float decay, unsigned int seed)
+{
+    std::mt19937 rng{seed};
+    std::uniform_real_distribution<float> dist{-1.0f, 1.0f};
+
+    const float decaycoeff{(decay > 0.0f) ? std::pow(0.001f, 1.0f/(decay*static_cast<float>(rate)))
+        : 1.0f};
+    std::vector<float> data(static_cast<size_t>(frames*channels));
+    float gain{(decay > 0.0f) ? 1.0f : 0.25f};
+    for(ALsizei i{0};i < frames;++i)
+    {
+        for(ALsizei c{0};c < channels;++c)
+            data[static_cast<size_t>(i*channels + c)] = dist(rng) * gain;
+        gain *= decaycoeff;
+    }
+
+    ALuint buffer{};
+    alGenBuffers(1, &buffer);
+    alBufferData(buffer, format, data.data(),
+        static_cast<ALsizei>(data.size()*sizeof(float)), rate);
+    return buffer;
+}
+
+
+/* Each source circles the listener at its own radius, height, and speed. */
+struct SourceMotion {
+    float mRadius;
+    float mHeight;
+    float mAngle;
+    float mSpeed;
+};
+
+void updateSources(const std::vector<ALuint> &sources, std::vector<SourceMotion> &motions,
+    float seconds)
+{
+    for(size_t i{0};i < sources.size();++i)
+    {
+        SourceMotion &motion = motions[i];
+        motion.mAngle = std::fmod(motion.mAngle + motion.mSpeed*seconds, Pi*2.0f);
+
+        const float x{std::sin(motion.mAngle) * motion.mRadius};
+        const float z{-std::cos(motion.mAngle) * motion.mRadius};
+        const float vx{std::cos(motion.mAngle) * motion.mRadius * motion.mSpeed};
+        const float vz{std::sin(motion.mAngle) * motion.mRadius * motion.mSpeed};
+        alSource3f(sources[i], AL_POSITION, x, motion.mHeight, z);
+        alSource3f(sources[i], AL_VELOCITY, vx, 0.0f, vz);
+    }
+}
+
+double percentile(const std::vector<double> &sorted, double fraction)
+{
+    const auto idx = static_cast<size_t>(fraction*static_cast<double>(sorted.size()-1) + 0.5);
+    return sorted[std::min(idx, sorted.size()-1)];
+}
+
+int runScene(const Options &opts)
+{
+    if(!loadProcs())
+    {
+        std::fprintf(stderr, "ALC_SOFT_loopback not supported\n");
+        return 1;
+    }
+
+    ALCdevice *device{p_alcLoopbackOpenDeviceSOFT(nullptr)};
+    if(!device)
+    {
+        std::fprintf(stderr, "Failed to open loopback device\n");
+        return 1;
+    }
+    if(!p_alcIsRenderFormatSupportedSOFT(device, opts.mRate, opts.mChannels, ALC_FLOAT_SOFT))
+    {
+        std::fprintf(stderr, "Render format not supported\n");
+        alcCloseDevice(device);
+        return 1;
+    }
+
+    const ALCint numslots{opts.mReverbs + (opts.mConvolution ? 1 : 0)};
+    std::vector<ALCint> attrs{
+        ALC_FORMAT_CHANNELS_SOFT, opts.mChannels,
+        ALC_FORMAT_TYPE_SOFT, ALC_FLOAT_SOFT,
+        ALC_FREQUENCY, opts.mRate,
+        ALC_MONO_SOURCES, std::max(opts.mSources, 1),
+        ALC_MAX_AUXILIARY_SENDS, std::min(numslots, 6),
+        ALC_HRTF_SOFT, opts.mHrtf ? ALC_TRUE : ALC_FALSE};
+    if(opts.mChannels == ALC_BFORMAT3D_SOFT)
+    {
+        attrs.insert(attrs.end(), {ALC_AMBISONIC_LAYOUT_SOFT, ALC_ACN_SOFT,
+            ALC_AMBISONIC_SCALING_SOFT, ALC_SN3D_SOFT,
+            ALC_AMBISONIC_ORDER_SOFT, opts.mAmbiOrder});
+    }
+    attrs.push_back(0);
+
+    ALCcontext *context{alcCreateContext(device, attrs.data())};
+    if(!context || alcMakeContextCurrent(context) == ALC_FALSE)
+    {
+        std::fprintf(stderr, "Failed to set up context: %s\n",
+            alcGetString(device, alcGetError(device)));
+        if(context) alcDestroyContext(context);
+        alcCloseDevice(device);
+        return 1;
+    }
+
+    ALCint hrtfstate{ALC_FALSE}, numsends{0};
+    alcGetIntegerv(device, ALC_HRTF_SOFT, 1, &hrtfstate);
+    alcGetIntegerv(device, ALC_MAX_AUXILIARY_SENDS, 1, &numsends);
+    if(opts.mHrtf && !hrtfstate)
+        std::fprintf(stderr, "Warning: HRTF requested but not enabled\n");
+
+    std::vector<ALuint> effects, slots;
+    if(numslots > 0)
+    {
+        if(!loadEfxProcs())
+        {
+            std::fprintf(stderr, "ALC_EXT_EFX not supported\n");
+            alcMakeContextCurrent(nullptr);
+            alcDestroyContext(context);
+            alcCloseDevice(device);
+            return 1;
+        }
+        effects.resize(static_cast<size_t>(numslots));
+        slots.resize(static_cast<size_t>(numslots));
+        p_alGenEffects(numslots, effects.data());
+        p_alGenAuxiliaryEffectSlots(numslots, slots.data());
+        for(ALCint i{0};i < opts.mReverbs;++i)
+        {
+            const auto idx = static_cast<size_t>(i);
+            p_alEffecti(effects[idx], AL_EFFECT_TYPE, AL_EFFECT_EAXREVERB);
+            p_alAuxiliaryEffectSloti(slots[idx], AL_EFFECTSLOT_EFFECT,
+                static_cast<ALint>(effects[idx]));
+        }
+    }
+
+    ALuint irbuffer{};
+    if(opts.mConvolution)
+    {
+        const auto idx = static_cast<size_t>(opts.mReverbs);
+        irbuffer = createNoiseBuffer(AL_FORMAT_STEREO_FLOAT32, 2, opts.mRate, opts.mRate, 1.0f,
+            1234u);
+        p_alEffecti(effects[idx], AL_EFFECT_TYPE, AL_EFFECT_CONVOLUTION_SOFT);
+        p_alAuxiliaryEffectSloti(slots[idx], AL_EFFECTSLOT_EFFECT,
+            static_cast<ALint>(effects[idx]));
+        p_alAuxiliaryEffectSloti(slots[idx], AL_BUFFER, static_cast<ALint>(irbuffer));
+    }
+    if(alGetError() != AL_NO_ERROR)
+        std::fprintf(stderr, "Warning: failed to set up effect slots\n");
+
+    /* Every source plays the same looping noise, but from a different offset
+     * so they don't mix coherently.
+     */
+    const ALuint buffer{createNoiseBuffer(AL_FORMAT_MONO_FLOAT32, 1, opts.mRate, opts.mRate,
+        0.0f, 22050u)};
+    std::vector<ALuint> sources(static_cast<size_t>(opts.mSources));
+    std::vector<SourceMotion> motions(sources.size());
+    std::mt19937 rng{44100u};
+    std::uniform_real_distribution<float> unitdist{0.0f, 1.0f};
+    if(!sources.empty())
+        alGenSources(static_cast<ALsizei>(sources.size()), sources.data());
+    for(size_t i{0};i < sources.size();++i)
+    {
+        motions[i].mRadius = 1.0f + unitdist(rng)*9.0f;
+        motions[i].mHeight = (unitdist(rng) - 0.5f) * 4.0f;
+        motions[i].mAngle = unitdist(rng) * Pi * 2.0f;
+        motions[i].mSpeed = (unitdist(rng) - 0.5f) * Pi;
+
+        alSourcei(sources[i], AL_BUFFER, static_cast<ALint>(buffer));
+        alSourcei(sources[i], AL_LOOPING, AL_TRUE);
+        alSourcef(sources[i], AL_SEC_OFFSET, unitdist(rng));
+        for(ALCint s{0};s < numsends;++s)
+        {
+            const auto slot = slots[(i + static_cast<size_t>(s)) % slots.size()];
+            alSource3i(sources[i], AL_AUXILIARY_SEND_FILTER, static_cast<ALint>(slot), s,
+                AL_FILTER_NULL);
+        }
+    }
+    updateSources(sources, motions, 0.0f);
+    if(!sources.empty())
+        alSourcePlayv(static_cast<ALsizei>(sources.size()), sources.data());
+    if(alGetError() != AL_NO_ERROR)
+        std::fprintf(stderr, "Warning: failed to set up sources\n");
+
+    const auto numchans = static_cast<size_t>(channelCount(opts));
+    const float updatesecs{static_cast<float>(opts.mUpdateSize)/static_cast<float>(opts.mRate)};
+    const auto numupdates = static_cast<size_t>(std::ceil(opts.mSeconds*opts.mRate
+        / opts.mUpdateSize));
+    std::vector<float> output(numchans * static_cast<size_t>(opts.mUpdateSize));
+    std::vector<double> times(numupdates);
+
+    std::printf("Sources: %d, HRTF: %s, reverb slots: %d, convolution: %s, channels: %zu, "
+        "sends: %d\n", opts.mSources, hrtfstate ? "on" : "off", opts.mReverbs,
+        opts.mConvolution ? "on" : "off", numchans, numsends);
+    std::printf("Rendering %zu updates of %d samples at %dhz...\n", numupdates, opts.mUpdateSize,
+        opts.mRate);
+
+    /* Render a second's worth of updates first, so the effects and voices are
+     * all running and the caches are warm before anything is timed.
+     */
+    const auto warmupcount = static_cast<size_t>(opts.mRate / opts.mUpdateSize) + 1;
+    for(size_t i{0};i < warmupcount;++i)
+    {
+        updateSources(sources, motions, updatesecs);
+        p_alcRenderSamplesSOFT(device, output.data(), opts.mUpdateSize);
+    }
+
+    double total{0.0};
+    for(size_t i{0};i < numupdates;++i)
+    {
+        updateSources(sources, motions, updatesecs);
+
+        const auto start = steady_clock::now();
+        p_alcRenderSamplesSOFT(device, output.data(), opts.mUpdateSize);
+        const auto elapsed = duration_cast<microseconds_f>(steady_clock::now() - start).count();
+
+        times[i] = elapsed;
+        total += elapsed;
+    }
+
+    std::sort(times.begin(), times.end());
+    const double rendered{static_cast<double>(numupdates) * opts.mUpdateSize / opts.mRate};
+    const double budget{static_cast<double>(opts.mUpdateSize) * 1'000'000.0 / opts.mRate};
+    std::printf("Real-time factor: %.2fx (%.3fs of audio in %.3fs)\n",
+        rendered / (total/1'000'000.0), rendered, total/1'000'000.0);
+    std::printf("Update render time (budget %.1fus):\n"
+        "  mean %.1fus, p50 %.1fus, p90 %.1fus, p99 %.1fus, p99.9 %.1fus, max %.1fus\n",
+        budget, total/static_cast<double>(numupdates), percentile(times, 0.5),
+        percentile(times, 0.9), percentile(times, 0.99), percentile(times, 0.999),
+        times.back());
+
+    if(!sources.empty())
+    {
+        alSourceStopv(static_cast<ALsizei>(sources.size()), sources.data());
+        alDeleteSources(static_cast<ALsizei>(sources.size()), sources.data());
+    }
+    alDeleteBuffers(1, &buffer);
+    if(!slots.empty())
+    {
+        p_alDeleteAuxiliaryEffectSlots(static_cast<ALsizei>(slots.size()), slots.data());
+        p_alDeleteEffects(static_cast<ALsizei>(effects.size()), effects.data());
+    }
+    if(irbuffer)
+        alDeleteBuffers(1, &irbuffer);
+
+    alcMakeContextCurrent(nullptr);
+    alcDestroyContext(context);
+    alcCloseDevice(device);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options opts;
+    if(!parseArgs(argc, argv, opts))
+        return 1;
+    return runScene(opts);
+}
@@ -0,0 +1,345 @@
+#include "config.h"
+
+#include <array>
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "alcomplex.h"
+#include "alnumeric.h"
+#include "alspan.h"
+#include "benchdefs.h"
+#include "core/ambidefs.h"
+#include "core/bformatdec.h"
+#include "core/bufferline.h"
+#include "core/cpu_caps.h"
+#include "core/filters/biquad.h"
+#include "core/filters/nfc.h"
+#include "core/filters/splitter.h"
+#include "core/uhjfilter.h"
+#include "pffft.h"
+#include "vector.h"
+
+
+namespace {
+
+using uint = unsigned int;
+
+constexpr float SampleRate{48000.0f};
+
+
+void BM_BiquadFilter(benchmark::State &state)
+{
+    alignas(16) FloatBufferLine input{};
+    FillNoise(input);
+    alignas(16) FloatBufferLine output{};
+
+    BiquadFilter filter;
+    filter.setParamsFromSlope(BiquadType::Peaking, 1000.0f/SampleRate, 0.5f, 1.0f);
+
+    for(auto _ : state)
+    {
+        filter.process(input, output);
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * BufferLineSize));
+}
+
+void BM_BandSplitter(benchmark::State &state)
+{
+    alignas(16) FloatBufferLine input{};
+    FillNoise(input);
+    alignas(16) FloatBufferLine hpout{};
+    alignas(16) FloatBufferLine lpout{};
+
+    BandSplitter splitter{400.0f/SampleRate};
+
+    for(auto _ : state)
+    {
+        splitter.process(input, hpout, lpout);
+        benchmark::DoNotOptimize(hpout.data());
+        benchmark::DoNotOptimize(lpout.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * BufferLineSize));
+}
+
+void BM_BandSplitterHfScale(benchmark::State &state)
+{
+    alignas(16) FloatBufferLine samples{};
+    FillNoise(samples);
+
+    BandSplitter splitter{400.0f/SampleRate};
+
+    for(auto _ : state)
+    {
+        splitter.processHfScale(samples, 0.75f);
+        benchmark::DoNotOptimize(samples.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * BufferLineSize));
+}
+
+
+/* Creates a near-field filter for a source at 1m with a 1.5m control
+ * distance.
+ */
+auto MakeNfcFilter() -> NfcFilter
+{
+    static constexpr float SpeedOfSound{343.3f};
+    NfcFilter filter;
+    filter.init(SpeedOfSound / (1.5f*SampleRate));
+    filter.adjust(SpeedOfSound / (1.0f*SampleRate));
+    return filter;
+}
+
+void BM_NfcFilter(benchmark::State &state)
+{
+    const auto order = state.range(0);
+
+    alignas(16) FloatBufferLine input{};
+    FillNoise(input);
+    alignas(16) FloatBufferLine output{};
+    NfcFilter filter{MakeNfcFilter()};
+
+    for(auto _ : state)
+    {
+        switch(order)
+        {
+        case 1: filter.process1(input, output); break;
+        case 2: filter.process2(input, output); break;
+        case 3: filter.process3(input, output); break;
+        case 4: filter.process4(input, output); break;
+        }
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * BufferLineSize));
+}
+
+void BM_NfcFilterOrders(benchmark::State &state)
+{
+    alignas(16) FloatBufferLine input{};
+    FillNoise(input);
+    std::array<FloatBufferLine,4> outputs{};
+    const std::array<al::span<float>,4> dsts{outputs[0], outputs[1], outputs[2], outputs[3]};
+    NfcFilter filter{MakeNfcFilter()};
+
+    for(auto _ : state)
+    {
+        filter.processOrders(input, dsts);
+        benchmark::DoNotOptimize(outputs.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * BufferLineSize));
+}
+
+
+/* Decodes third-order ambisonics to 7.1, with single-band or dual-band
+ * decoding.
+ */
+void BM_BFormatDec(benchmark::State &state, bool dualBand)
+{
+    static constexpr size_t NumInputs{16};
+    static constexpr size_t NumOutputs{8};
+
+    std::vector<float> gains(NumOutputs*NumInputs);
+    FillNoise(gains);
+    std::vector<ChannelDec> coeffs(NumOutputs);
+    for(size_t i{0};i < NumOutputs;++i)
+    {
+        for(size_t j{0};j < NumInputs;++j)
+            coeffs[i][j] = gains[i*NumInputs + j] * 0.25f;
+    }
+    const auto coeffslf = dualBand ? al::span<const ChannelDec>{coeffs}
+        : al::span<const ChannelDec>{};
+    auto decoder = BFormatDec::Create(NumInputs, coeffs, coeffslf, 400.0f/SampleRate, nullptr);
+
+    std::vector<FloatBufferLine> input(NumInputs);
+    for(size_t i{0};i < NumInputs;++i)
+        FillNoise(input[i], static_cast<uint>(i+1));
+    std::vector<FloatBufferLine> output(NumOutputs);
+
+    for(auto _ : state)
+    {
+        decoder->process(output, input, BufferLineSize);
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * BufferLineSize));
+}
+
+
+/* Decodes third-order ambisonics to 7.1 with the front stablizer, which
+ * replaces the front-left and -right output with a recombined mid/side
+ * signal and pans some of it to the front-center.
+ */
+void BM_BFormatDecStablize(benchmark::State &state, bool dualBand)
+{
+    static constexpr size_t NumInputs{16};
+    static constexpr size_t NumOutputs{8};
+    static constexpr size_t LeftIdx{0}, RightIdx{1}, CenterIdx{2};
+
+    std::vector<float> gains(NumOutputs*NumInputs);
+    FillNoise(gains);
+    std::vector<ChannelDec> coeffs(NumOutputs);
+    for(size_t i{0};i < NumOutputs;++i)
+    {
+        if(i == CenterIdx) continue;
+        for(size_t j{0};j < NumInputs;++j)
+            coeffs[i][j] = gains[i*NumInputs + j] * 0.25f;
+    }
+    const auto coeffslf = dualBand ? al::span<const ChannelDec>{coeffs}
+        : al::span<const ChannelDec>{};
+
+    auto stablizer = FrontStablizer::Create(NumOutputs, LeftIdx, RightIdx, CenterIdx);
+    stablizer->MidFilter.init(5000.0f / SampleRate);
+    for(auto &filter : stablizer->ChannelFilters)
+        filter = stablizer->MidFilter;
+    auto decoder = BFormatDec::Create(NumInputs, coeffs, coeffslf, 400.0f/SampleRate,
+        std::move(stablizer));
+
+    std::vector<FloatBufferLine> input(NumInputs);
+    for(size_t i{0};i < NumInputs;++i)
+        FillNoise(input[i], static_cast<uint>(i+1));
+    std::vector<FloatBufferLine> output(NumOutputs);
+
+    for(auto _ : state)
+    {
+        decoder->processStablize(output, input, BufferLineSize);
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * BufferLineSize));
+}
+
+
+template<typename T>
+void BM_UhjEncoder(benchmark::State &state)
+{
+    std::array<FloatBufferLine,3> input{};
+    for(size_t i{0};i < input.size();++i)
+        FillNoise(input[i], static_cast<uint>(i+1));
+    const std::array<const float*,3> inptrs{input[0].data(), input[1].data(), input[2].data()};
+    alignas(16) FloatBufferLine left{};
+    alignas(16) FloatBufferLine right{};
+
+    auto encoder = std::make_unique<T>();
+
+    for(auto _ : state)
+    {
+        encoder->encode(left.data(), right.data(), inptrs, BufferLineSize);
+        benchmark::DoNotOptimize(left.data());
+        benchmark::DoNotOptimize(right.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * BufferLineSize));
+}
+
+
+void BM_PffftTransform(benchmark::State &state, pffft_transform_t type)
+{
+    const auto size = static_cast<uint>(state.range(0));
+    const size_t count{(type == PFFFT_REAL) ? size : size*2_uz};
+
+    const PFFFTSetup setup{size, type};
+    al::vector<float,16> input(count);
+    FillNoise(input);
+    al::vector<float,16> freqdata(count);
+    al::vector<float,16> output(count);
+    al::vector<float,16> work(count);
+
+    /* Does a forward and backward round trip, with the input unchanged. */
+    for(auto _ : state)
+    {
+        setup.transform(input.data(), freqdata.data(), work.data(), PFFFT_FORWARD);
+        setup.transform(freqdata.data(), output.data(), work.data(), PFFFT_BACKWARD);
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+
+void BM_PffftZConvolve(benchmark::State &state, bool useAVX2)
+{
+    const auto size = static_cast<uint>(state.range(0));
+
+    const PFFFTSetup setup{size, PFFFT_REAL};
+    al::vector<float,16> a(size), b(size), ab(size);
+    FillNoise(a, 1u);
+    FillNoise(b, 2u);
+
+    pffft_enable_avx2(useAVX2);
+    for(auto _ : state)
+    {
+        setup.zconvolve_accumulate(a.data(), b.data(), ab.data());
+        benchmark::DoNotOptimize(ab.data());
+        benchmark::ClobberMemory();
+    }
+    pffft_enable_avx2(false);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+
+void BM_ComplexFFT(benchmark::State &state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+
+    std::vector<float> noise(size*2);
+    FillNoise(noise);
+    std::vector<std::complex<double>> buffer(size);
+
+    /* The transform is in-place, so the input is copied in for each round.
+     * The copy is included in the timing, but is small next to the transform.
+     */
+    for(auto _ : state)
+    {
+        for(size_t i{0};i < size;++i)
+            buffer[i] = std::complex<double>{noise[i*2], noise[i*2 + 1]};
+        forward_fft(al::span{buffer});
+        benchmark::DoNotOptimize(buffer.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * size));
+}
+
+} // namespace
+
+void RegisterFilterBenchmarks()
+{
+    benchmark::RegisterBenchmark("BiquadFilterR<float>::process", BM_BiquadFilter);
+    benchmark::RegisterBenchmark("BandSplitterR<float>::process", BM_BandSplitter);
+    benchmark::RegisterBenchmark("BandSplitterR<float>::processHfScale", BM_BandSplitterHfScale);
+    benchmark::RegisterBenchmark("NfcFilter::process", BM_NfcFilter)->DenseRange(1, 4);
+    benchmark::RegisterBenchmark("NfcFilter::processOrders", BM_NfcFilterOrders);
+
+    benchmark::RegisterBenchmark("BFormatDec::process/single", BM_BFormatDec, false);
+    benchmark::RegisterBenchmark("BFormatDec::process/dual", BM_BFormatDec, true);
+    benchmark::RegisterBenchmark("BFormatDec::processStablize/single", BM_BFormatDecStablize,
+        false);
+    benchmark::RegisterBenchmark("BFormatDec::processStablize/dual", BM_BFormatDecStablize,
+        true);
+
+    benchmark::RegisterBenchmark("UhjEncoder<256>::encode", BM_UhjEncoder<UhjEncoder<UhjLength256>>);
+    benchmark::RegisterBenchmark("UhjEncoder<512>::encode", BM_UhjEncoder<UhjEncoder<UhjLength512>>);
+    benchmark::RegisterBenchmark("UhjEncoderIIR::encode", BM_UhjEncoder<UhjEncoderIIR>);
+
+    benchmark::RegisterBenchmark("pffft_transform/real", BM_PffftTransform, PFFFT_REAL)
+        ->RangeMultiplier(4)->Range(64, 16384);
+    benchmark::RegisterBenchmark("pffft_transform/complex", BM_PffftTransform, PFFFT_COMPLEX)
+        ->RangeMultiplier(4)->Range(64, 16384);
+    benchmark::RegisterBenchmark("pffft_zconvolve_accumulate<SIMD>", BM_PffftZConvolve, false)
+        ->RangeMultiplier(4)->Range(256, 16384);
+#ifdef HAVE_AVX2
+    if((CPUCapFlags&CPU_CAP_AVX2))
+        benchmark::RegisterBenchmark("pffft_zconvolve_accumulate<AVX2>", BM_PffftZConvolve,
+            true)->RangeMultiplier(4)->Range(256, 16384);
+#endif
+
+    benchmark::RegisterBenchmark("complex_fft", BM_ComplexFFT)->RangeMultiplier(4)
+        ->Range(64, 16384);
+}
@@ -0,0 +1,176 @@
+#include "config.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+
+#include "alstring.h"
+#include "benchdefs.h"
+#include "core/cpu_caps.h"
+#include "version.h"
+
+
+void FillNoise(const al::span<float> buffer, unsigned int seed)
+{
+    std::mt19937 rng{seed};
+    std::uniform_real_distribution<float> dist{-1.0f, 1.0f};
+    for(float &sample : buffer)
+        sample = dist(rng);
+}
+
+
+namespace {
+
+using namespace std::string_view_literals;
+
+struct CapName {
+    std::string_view mName;
+    int mCap;
+};
+constexpr CapName CapNames[]{
+    {"sse"sv, CPU_CAP_SSE},
+    {"sse2"sv, CPU_CAP_SSE2},
+    {"sse3"sv, CPU_CAP_SSE3},
+    {"sse4.1"sv, CPU_CAP_SSE4_1},
+    {"avx2"sv, CPU_CAP_AVX2},
+    {"neon"sv, CPU_CAP_NEON},
+};
+
+/* Parses a comma-separated list of instruction set names, as used by the
+ * disable-cpu-exts config option, into CPU cap flags. "all" and "none" are
+ * also accepted.
+ */
+bool ParseCaps(std::string_view list, int &caps)
+{
+    caps = 0;
+    if(al::case_compare(list, "all"sv) == 0)
+    {
+        for(const CapName &cap : CapNames)
+            caps |= cap.mCap;
+        return true;
+    }
+    if(al::case_compare(list, "none"sv) == 0)
+        return true;
+
+    while(!list.empty())
+    {
+        const auto nextpos = std::min(list.find(','), list.size());
+        auto entry = list.substr(0, nextpos);
+        list.remove_prefix(std::min(nextpos+1, list.size()));
+
+        while(!entry.empty() && std::isspace(entry.front()))
+            entry.remove_prefix(1);
+        while(!entry.empty() && std::isspace(entry.back()))
+            entry.remove_suffix(1);
+        if(entry.empty())
+            continue;
+
+        auto iter = std::find_if(std::begin(CapNames), std::end(CapNames),
+            [entry](const CapName &cap) { return al::case_compare(entry, cap.mName) == 0; });
+        if(iter == std::end(CapNames))
+        {
+            std::fprintf(stderr, "Invalid CPU extension \"%.*s\"\n",
+                static_cast<int>(entry.size()), entry.data());
+            return false;
+        }
+        caps |= iter->mCap;
+    }
+    return true;
+}
+
+std::string CapsString(const int caps)
+{
+    std::string ret;
+    for(const CapName &cap : CapNames)
+    {
+        if(!(caps&cap.mCap)) continue;
+        if(!ret.empty()) ret += ',';
+        ret += cap.mName;
+    }
+    return ret.empty() ? std::string{"none"} : ret;
+}
+
+/* Handles and removes the options for selecting the instruction sets, before
+ * the benchmark library sees the arguments. --cpu-exts selects which of the
+ * CPU's instruction sets the kernels are registered for (the C kernels are
+ * always registered), and --disable-cpu-exts removes them, like the config
+ * option.
+ */
+bool HandleCapArgs(int &argc, char **argv, const int detected)
+{
+    int outarg{1};
+    for(int i{1};i < argc;++i)
+    {
+        const std::string_view arg{argv[i]};
+        int caps{};
+        if(arg.substr(0, 11) == "--cpu-exts="sv)
+        {
+            if(!ParseCaps(arg.substr(11), caps))
+                return false;
+            if((caps&detected) != caps)
+                std::fprintf(stderr, "Ignoring unsupported CPU extensions: %s\n",
+                    CapsString(caps & ~detected).c_str());
+            CPUCapFlags = caps & detected;
+        }
+        else if(arg.substr(0, 19) == "--disable-cpu-exts="sv)
+        {
+            if(!ParseCaps(arg.substr(19), caps))
+                return false;
+            CPUCapFlags &= ~caps;
+        }
+        else
+            argv[outarg++] = argv[i];
+    }
+    argc = outarg;
+    argv[argc] = nullptr;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    /* Register the kernels for every instruction set the CPU supports, so
+     * they can be compared against each other, unless restricted by the
+     * command line.
+     */
+    std::string vendor, name;
+    int detected{0};
+    if(auto cpuinfo = GetCPUInfo())
+    {
+        vendor = std::move(cpuinfo->mVendor);
+        name = std::move(cpuinfo->mName);
+        detected = cpuinfo->mCaps;
+    }
+    CPUCapFlags = detected;
+    if(!HandleCapArgs(argc, argv, detected))
+        return 1;
+
+    /* Record the build and CPU in the results (shown in the console output,
+     * and the "context" object of the JSON output), so results from different
+     * machines and builds can be told apart.
+     */
+    benchmark::AddCustomContext("openal_version", ALSOFT_VERSION);
+    benchmark::AddCustomContext("openal_git_commit", ALSOFT_GIT_COMMIT_HASH);
+    benchmark::AddCustomContext("openal_git_branch", ALSOFT_GIT_BRANCH);
+    benchmark::AddCustomContext("cpu_vendor", vendor);
+    benchmark::AddCustomContext("cpu_name", name);
+    benchmark::AddCustomContext("cpu_exts_detected", CapsString(detected));
+    benchmark::AddCustomContext("cpu_exts_used", CapsString(CPUCapFlags));
+
+    RegisterMixerBenchmarks();
+    RegisterFilterBenchmarks();
+
+    benchmark::Initialize(&argc, argv);
+    if(benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,372 @@
+#include "config.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "alnumeric.h"
+#include "alspan.h"
+#include "benchdefs.h"
+#include "core/bsinc_defs.h"
+#include "core/bsinc_tables.h"
+#include "core/bufferline.h"
+#include "core/cubic_tables.h"
+#include "core/mixer/defs.h"
+#include "core/mixer/hrtfdefs.h"
+#include "core/resampler_limits.h"
+
+struct PointTag;
+struct LerpTag;
+struct CubicTag;
+struct BSincTag;
+struct FastBSincTag;
+struct BSincPolyTag;
+struct FastBSincPolyTag;
+
+
+namespace {
+
+using uint = unsigned int;
+
+/* The resampling increments to test with. Most resamplers get 44.1khz to
+ * 48khz, and the polyphase bsinc resamplers need a multiple of 0.5.
+ */
+constexpr uint ResampleIncrement{static_cast<uint>(44100_u64*MixerFracOne / 48000)};
+constexpr uint PolyIncrement{MixerFracOne / 2};
+
+/* The output channel count for the multi-channel mixes (7.1). */
+constexpr size_t MixChannels{8};
+
+/* Same as the BsincPrepare the mixer uses. */
+void PrepareBsinc(const uint increment, BsincState *state, const BSincTable &table)
+{
+    size_t si{BSincScaleCount - 1};
+    float sf{0.0f};
+
+    if(increment > MixerFracOne)
+    {
+        sf = MixerFracOne/static_cast<float>(increment) - table.scaleBase;
+        sf = std::max(0.0f, BSincScaleCount*sf*table.scaleRange - 1.0f);
+        si = float2uint(sf);
+        sf = 1.0f - std::cos(std::asin(sf - static_cast<float>(si)));
+    }
+
+    state->sf = sf;
+    state->m = table.m[si];
+    state->l = (state->m/2) - 1;
+    state->filter = table.Tab.subspan(table.filterOffset[si]);
+}
+
+auto MakeInterpState(Resampler resampler, uint increment) -> InterpState
+{
+    InterpState state;
+    switch(resampler)
+    {
+    case Resampler::Point:
+    case Resampler::Linear:
+        break;
+    case Resampler::Spline:
+        state.emplace<CubicState>(al::span{GetSplineTable().mTable});
+        break;
+    case Resampler::Gaussian:
+        state.emplace<CubicState>(al::span{GetGaussianTable().mTable});
+        break;
+    case Resampler::FastBSinc12:
+    case Resampler::BSinc12:
+        PrepareBsinc(increment, &state.emplace<BsincState>(), GetBSinc12Table());
+        break;
+    case Resampler::FastBSinc24:
+    case Resampler::BSinc24:
+        PrepareBsinc(increment, &state.emplace<BsincState>(), GetBSinc24Table());
+        break;
+    }
+    return state;
+}
+
+
+template<typename TypeTag, typename InstTag>
+void BM_Resample(benchmark::State &state, Resampler resampler, uint increment)
+{
+    const InterpState istate{MakeInterpState(resampler, increment)};
+
+    std::vector<float> src(BufferLineSize*2 + MaxResamplerPadding);
+    FillNoise(src);
+    alignas(16) FloatBufferLine dst{};
+
+    for(auto _ : state)
+    {
+        Resample_<TypeTag,InstTag>(&istate, src, 0, increment, dst);
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * dst.size()));
+}
+
+template<typename TypeTag, typename ...InstTags>
+void RegisterResampler(const char *typeName, Resampler resampler, uint increment)
+{
+    ForEachInstSet<InstTags...>([=](auto inst)
+    {
+        using InstT = decltype(inst);
+        const std::string name{std::string{"Resample_<"} + typeName + "," + InstT::Name + ">"};
+        benchmark::RegisterBenchmark(name.c_str(), BM_Resample<TypeTag,typename InstT::Tag>,
+            resampler, increment);
+    });
+}
+
+
+/* Mixes a line to multiple outputs, with the gains fading over the whole line
+ * when fading is set.
+ */
+template<typename InstTag>
+void BM_Mix(benchmark::State &state, bool fading)
+{
+    alignas(16) FloatBufferLine input{};
+    FillNoise(input);
+    std::vector<FloatBufferLine> output(MixChannels);
+    std::array<float,MixChannels> currentGains{};
+    std::array<float,MixChannels> targetGains{};
+    std::fill(targetGains.begin(), targetGains.end(), 0.5f);
+
+    for(auto _ : state)
+    {
+        if(fading)
+            std::fill(currentGains.begin(), currentGains.end(), 0.25f);
+        else
+            currentGains = targetGains;
+        Mix_<InstTag>(input, output, currentGains, targetGains, fading ? BufferLineSize : 0, 0);
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * BufferLineSize));
+}
+
+template<typename InstTag>
+void BM_MixLine(benchmark::State &state, bool fading)
+{
+    alignas(16) FloatBufferLine input{};
+    FillNoise(input);
+    alignas(16) FloatBufferLine output{};
+
+    for(auto _ : state)
+    {
+        float currentGain{fading ? 0.25f : 0.5f};
+        Mix_<InstTag>(input, output, currentGain, 0.5f, fading ? BufferLineSize : 0);
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * BufferLineSize));
+}
+
+/* Mixes the maximum number of batched inputs to multiple outputs. */
+template<typename InstTag>
+void BM_MixBatch(benchmark::State &state)
+{
+    std::array<FloatBufferLine,MaxMixBatchInputs> inputs{};
+    std::array<std::array<float,MixChannels>,MaxMixBatchInputs> currentGains{};
+    std::array<std::array<float,MixChannels>,MaxMixBatchInputs> targetGains{};
+    std::array<MixBatchInput,MaxMixBatchInputs> batch{};
+    for(size_t i{0};i < MaxMixBatchInputs;++i)
+    {
+        FillNoise(inputs[i], static_cast<uint>(i+1));
+        std::fill(targetGains[i].begin(), targetGains[i].end(), 0.5f);
+        batch[i] = MixBatchInput{inputs[i], currentGains[i], targetGains[i]};
+    }
+    std::vector<FloatBufferLine> output(MixChannels);
+
+    for(auto _ : state)
+    {
+        currentGains = targetGains;
+        MixBatch_<InstTag>(batch, output, 0, 0);
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * BufferLineSize
+        * MaxMixBatchInputs));
+}
+
+
+/* Storage for an HRTF voice mix: the input with its history, the filters,
+ * and the accumulation buffer.
+ */
+struct HrtfMixData {
+    std::vector<float> mInput;
+    std::vector<float2> mAccum;
+    alignas(16) HrirArray mCoeffs{};
+    HrtfFilter mOldParams{};
+
+    HrtfMixData() : mInput(HrtfHistoryLength + BufferLineSize), mAccum(BufferLineSize + HrirLength)
+    {
+        FillNoise(mInput);
+        std::vector<float> coeffs(HrirLength*2);
+        FillNoise(coeffs, 44100u);
+        for(size_t i{0};i < HrirLength;++i)
+            mCoeffs[i] = float2{{coeffs[i*2]*0.1f, coeffs[i*2 + 1]*0.1f}};
+        mOldParams.Coeffs = mCoeffs;
+        mOldParams.Delay = uint2{{4u, 12u}};
+        mOldParams.Gain = 0.5f;
+    }
+    ~HrtfMixData();
+
+    [[nodiscard]] auto newParams() const -> MixHrtfFilter
+    { return MixHrtfFilter{mCoeffs, uint2{{8u, 2u}}, 0.5f, 0.0f}; }
+};
+HrtfMixData::~HrtfMixData() = default;
+
+template<typename InstTag>
+void BM_MixHrtf(benchmark::State &state)
+{
+    const auto irSize = static_cast<uint>(state.range(0));
+    HrtfMixData data;
+    const MixHrtfFilter params{data.newParams()};
+
+    for(auto _ : state)
+    {
+        MixHrtf_<InstTag>(data.mInput, data.mAccum, irSize, &params, BufferLineSize);
+        benchmark::DoNotOptimize(data.mAccum.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * BufferLineSize));
+}
+
+template<typename InstTag>
+void BM_MixHrtfBlend(benchmark::State &state)
+{
+    const auto irSize = static_cast<uint>(state.range(0));
+    HrtfMixData data;
+    MixHrtfFilter params{data.newParams()};
+    params.Gain = 0.0f;
+    params.GainStep = 0.5f / BufferLineSize;
+
+    for(auto _ : state)
+    {
+        MixHrtfBlend_<InstTag>(data.mInput, data.mAccum, irSize, &data.mOldParams, &params,
+            BufferLineSize);
+        benchmark::DoNotOptimize(data.mAccum.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * BufferLineSize));
+}
+
+/* Mixes a first-order ambisonic signal to HRTF output. */
+template<typename InstTag>
+void BM_MixDirectHrtf(benchmark::State &state)
+{
+    static constexpr size_t NumChannels{4};
+    const auto irSize = static_cast<size_t>(state.range(0));
+
+    std::vector<FloatBufferLine> input(NumChannels);
+    for(size_t i{0};i < NumChannels;++i)
+        FillNoise(input[i], static_cast<uint>(i+1));
+    std::vector<float2> accum(BufferLineSize + HrirLength);
+    alignas(16) FloatBufferLine tempBuf{};
+    alignas(16) FloatBufferLine left{};
+    alignas(16) FloatBufferLine right{};
+
+    std::vector<HrtfChannelState> chanState(NumChannels);
+    std::vector<float> coeffs(HrirLength*2);
+    for(size_t c{0};c < NumChannels;++c)
+    {
+        FillNoise(coeffs, static_cast<uint>(100+c));
+        chanState[c].mSplitter.init(400.0f / 48000.0f);
+        chanState[c].mHfScale = 1.0f;
+        for(size_t i{0};i < HrirLength;++i)
+            chanState[c].mCoeffs[i] = float2{{coeffs[i*2]*0.1f, coeffs[i*2 + 1]*0.1f}};
+    }
+
+    for(auto _ : state)
+    {
+        MixDirectHrtf_<InstTag>(left, right, input, accum, tempBuf, chanState, irSize,
+            BufferLineSize);
+        benchmark::DoNotOptimize(left.data());
+        benchmark::DoNotOptimize(right.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * BufferLineSize));
+}
+
+/* Decodes a line of samples from one channel of stereo IMA4 data. */
+template<typename InstTag>
+void BM_LoadIMA4(benchmark::State &state)
+{
+    static constexpr size_t NumChannels{2};
+    static constexpr size_t SamplesPerBlock{65};
+    static constexpr size_t BlockBytes{((SamplesPerBlock-1)/2 + 4) * NumChannels};
+    static constexpr size_t NumBlocks{(BufferLineSize+SamplesPerBlock-1) / SamplesPerBlock};
+
+    std::vector<float> noise(BlockBytes*NumBlocks);
+    FillNoise(noise);
+    std::vector<std::byte> src(noise.size());
+    std::transform(noise.cbegin(), noise.cend(), src.begin(),
+        [](const float val) { return static_cast<std::byte>(float2int(val*127.0f)); });
+    alignas(16) FloatBufferLine dst{};
+
+    for(auto _ : state)
+    {
+        LoadIMA4_<InstTag>(dst, src, 0, 0, NumChannels, SamplesPerBlock);
+        benchmark::DoNotOptimize(dst.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * BufferLineSize));
+}
+
+} // namespace
+
+void RegisterMixerBenchmarks()
+{
+    RegisterResampler<PointTag,CTag>("Point", Resampler::Point, ResampleIncrement);
+    RegisterResampler<LerpTag,CTag,SSE2Tag,SSE4Tag,AVX2Tag,NEONTag>("Lerp",
+        Resampler::Linear, ResampleIncrement);
+    RegisterResampler<CubicTag,CTag,SSETag,SSE2Tag,SSE4Tag,AVX2Tag,NEONTag>("Cubic",
+        Resampler::Gaussian, ResampleIncrement);
+    RegisterResampler<FastBSincTag,CTag,SSETag,AVX2Tag,NEONTag>("FastBSinc24",
+        Resampler::FastBSinc24, ResampleIncrement);
+    RegisterResampler<BSincTag,CTag,SSETag,AVX2Tag,NEONTag>("BSinc24", Resampler::BSinc24,
+        ResampleIncrement);
+    RegisterResampler<FastBSincPolyTag,CTag,SSETag,AVX2Tag>("FastBSincPoly24",
+        Resampler::FastBSinc24, PolyIncrement);
+    RegisterResampler<BSincPolyTag,CTag,SSETag,AVX2Tag>("BSincPoly24", Resampler::BSinc24,
+        PolyIncrement);
+
+    ForEachInstSet<CTag,SSETag,AVX2Tag,NEONTag>([](auto inst)
+    {
+        using InstT = decltype(inst);
+        using InstTag = typename InstT::Tag;
+        const std::string suffix{std::string{"<"} + InstT::Name + ">"};
+
+        benchmark::RegisterBenchmark(("Mix_"+suffix+"/steady").c_str(), BM_Mix<InstTag>, false);
+        benchmark::RegisterBenchmark(("Mix_"+suffix+"/fade").c_str(), BM_Mix<InstTag>, true);
+        benchmark::RegisterBenchmark(("MixLine_"+suffix+"/steady").c_str(), BM_MixLine<InstTag>,
+            false);
+        benchmark::RegisterBenchmark(("MixLine_"+suffix+"/fade").c_str(), BM_MixLine<InstTag>,
+            true);
+
+        /* IR sizes from the shortest allowed, to the longest. */
+        benchmark::RegisterBenchmark(("MixHrtf_"+suffix).c_str(), BM_MixHrtf<InstTag>)
+            ->Arg(MinIrLength)->Arg(32)->Arg(HrirLength);
+        benchmark::RegisterBenchmark(("MixHrtfBlend_"+suffix).c_str(), BM_MixHrtfBlend<InstTag>)
+            ->Arg(MinIrLength)->Arg(32)->Arg(HrirLength);
+        benchmark::RegisterBenchmark(("MixDirectHrtf_"+suffix).c_str(),
+            BM_MixDirectHrtf<InstTag>)->Arg(MinIrLength)->Arg(32)->Arg(HrirLength);
+    });
+
+    ForEachInstSet<CTag,SSETag>([](auto inst)
+    {
+        using InstT = decltype(inst);
+        benchmark::RegisterBenchmark((std::string{"MixBatch_<"} + InstT::Name + ">").c_str(),
+            BM_MixBatch<typename InstT::Tag>);
+    });
+
+    ForEachInstSet<CTag,SSE4Tag>([](auto inst)
+    {
+        using InstT = decltype(inst);
+        benchmark::RegisterBenchmark((std::string{"LoadIMA4_<"} + InstT::Name + ">").c_str(),
+            BM_LoadIMA4<typename InstT::Tag>);
+    });
+}
@@ -0,0 +1,14 @@
+#ifndef BENCHMARKS_BENCHDEFS_H
+#define BENCHMARKS_BENCHDEFS_H
+
+#include "alspan.h"
+#include "core/mixer/instsets.h"
+
+
+/* Fills the buffer with reproducible noise in the range [-1, 1). */
+void FillNoise(const al::span<float> buffer, unsigned int seed=22050u);
+
+void RegisterMixerBenchmarks();
+void RegisterFilterBenchmarks();
+
+#endif /* BENCHMARKS_BENCHDEFS_H */
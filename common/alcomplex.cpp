@@ -10,6 +10,7 @@
 #include <functional>
 #include <iterator>
 #include <utility>
+#include <vector>
 
 #include "albit.h"
 #include "alnumbers.h"
@@ -93,21 +94,23 @@ constexpr std::array<al::span<const ushort2>,12> gBitReverses{{
     BitReverser11.mData
 }};
 
-/* Lookup table for std::polar(1, pi / (1<<index)); */
-template<typename T>
-constexpr std::array<std::complex<T>,gBitReverses.size()-1> gArgAngle{{
-    {static_cast<T>(-1.00000000000000000e+00), static_cast<T>(0.00000000000000000e+00)},
-    {static_cast<T>( 0.00000000000000000e+00), static_cast<T>(1.00000000000000000e+00)},
-    {static_cast<T>( 7.07106781186547524e-01), static_cast<T>(7.07106781186547524e-01)},
-    {static_cast<T>( 9.23879532511286756e-01), static_cast<T>(3.82683432365089772e-01)},
-    {static_cast<T>( 9.80785280403230449e-01), static_cast<T>(1.95090322016128268e-01)},
-    {static_cast<T>( 9.95184726672196886e-01), static_cast<T>(9.80171403295606020e-02)},
-    {static_cast<T>( 9.98795456205172393e-01), static_cast<T>(4.90676743274180143e-02)},
-    {static_cast<T>( 9.99698818696204220e-01), static_cast<T>(2.45412285229122880e-02)},
-    {static_cast<T>( 9.99924701839144541e-01), static_cast<T>(1.22715382857199261e-02)},
-    {static_cast<T>( 9.99981175282601143e-01), static_cast<T>(6.13588464915447536e-03)},
-    {static_cast<T>( 9.99995293809576172e-01), static_cast<T>(3.06795676296597627e-03)}
-}};
+/* Twiddle factors for the largest table-supported FFT size, std::polar(1, pi *
+ * j / 1024). Smaller transforms use a subset of them. Calculating each one
+ * directly is more precise than accumulating them.
+ */
+auto GetTwiddleTable() -> al::span<const complex_d>
+{
+    static constexpr std::size_t half{1_uz << (gBitReverses.size()-2)};
+    static const auto table = []
+    {
+        auto ret = std::array<complex_d,half>{};
+        for(std::size_t j{0};j < half;++j)
+            ret[j] = std::polar(1.0, al::numbers::pi * static_cast<double>(j)
+                / static_cast<double>(half));
+        return ret;
+    }();
+    return table;
+}
 
 } // namespace
 
@@ -119,39 +122,12 @@ void complex_fft(const al::span<std::complex<double>> buffer, const double sign)
      */
     const std::size_t log2_size{static_cast<std::size_t>(al::countr_zero(fftsize))};
 
+    al::span<const complex_d> twiddles;
     if(log2_size < gBitReverses.size()) LIKELY
     {
         for(auto &rev : gBitReverses[log2_size])
             std::swap(buffer[rev.first], buffer[rev.second]);
-
-        /* Iterative form of Danielson-Lanczos lemma */
-        for(std::size_t i{0};i < log2_size;++i)
-        {
-            const std::size_t step2{1_uz << i};
-            const std::size_t step{2_uz << i};
-            /* The first iteration of the inner loop would have u=1, which we
-             * can simplify to remove a number of complex multiplies.
-             */
-            for(std::size_t k{0};k < fftsize;k+=step)
-            {
-                const complex_d temp{buffer[k+step2]};
-                buffer[k+step2] = buffer[k] - temp;
-                buffer[k] += temp;
-            }
-
-            const complex_d w{gArgAngle<double>[i].real(), gArgAngle<double>[i].imag()*sign};
-            complex_d u{w};
-            for(std::size_t j{1};j < step2;j++)
-            {
-                for(std::size_t k{j};k < fftsize;k+=step)
-                {
-                    const complex_d temp{buffer[k+step2] * u};
-                    buffer[k+step2] = buffer[k] - temp;
-                    buffer[k] += temp;
-                }
-                u *= w;
-            }
-        }
+        twiddles = GetTwiddleTable();
     }
     else
     {
@@ -171,30 +147,64 @@ void complex_fft(const al::span<std::complex<double>> buffer, const double sign)
                 std::swap(buffer[idx], buffer[revidx]);
         }
 
-        const double pi{al::numbers::pi * sign};
-        for(std::size_t i{0};i < log2_size;++i)
+        /* Get the twiddle factors for the last stage, which the earlier
+         * stages use a subset of. They're kept for the next call of the same
+         * size, as large transforms tend to be repeated.
+         */
+        const std::size_t half{fftsize >> 1};
+        thread_local std::vector<complex_d> bigtwiddles;
+        if(bigtwiddles.size() != half)
         {
-            const std::size_t step2{1_uz << i};
-            const std::size_t step{2_uz << i};
-            for(std::size_t k{0};k < fftsize;k+=step)
-            {
-                const complex_d temp{buffer[k+step2]};
-                buffer[k+step2] = buffer[k] - temp;
-                buffer[k] += temp;
-            }
+            bigtwiddles.resize(half);
+            for(std::size_t j{0};j < half;++j)
+                bigtwiddles[j] = std::polar(1.0, al::numbers::pi * static_cast<double>(j)
+                    / static_cast<double>(half));
+        }
+        twiddles = bigtwiddles;
+    }
+
+    std::size_t i{0};
+    if(log2_size >= 2)
+    {
+        /* The first two stages only have twiddle factors of 1 and +/-i, so
+         * do them together as one radix-4 pass without any multiplies.
+         */
+        for(std::size_t k{0};k < fftsize;k+=4)
+        {
+            const auto x = buffer.subspan(k, 4);
+            const complex_d y0{x[0] + x[1]}, y1{x[0] - x[1]};
+            const complex_d y2{x[2] + x[3]}, y3{x[2] - x[3]};
+            const complex_d t{-y3.imag()*sign, y3.real()*sign};
+            x[0] = y0 + y2;
+            x[2] = y0 - y2;
+            x[1] = y1 + t;
+            x[3] = y1 - t;
+        }
+        i = 2;
+    }
 
-            const double arg{pi / static_cast<double>(step2)};
-            const complex_d w{std::polar(1.0, arg)};
-            complex_d u{w};
-            for(std::size_t j{1};j < step2;j++)
+    /* Iterative form of Danielson-Lanczos lemma, with the butterflies for
+     * each group running over contiguous elements.
+     */
+    for(;i < log2_size;++i)
+    {
+        const std::size_t step2{1_uz << i};
+        const std::size_t step{2_uz << i};
+        const std::size_t tstride{twiddles.size() >> i};
+        for(std::size_t k{0};k < fftsize;k+=step)
+        {
+            const auto lo = buffer.subspan(k, step2);
+            const auto hi = buffer.subspan(k+step2, step2);
+            for(std::size_t j{0};j < step2;++j)
             {
-                for(std::size_t k{j};k < fftsize;k+=step)
-                {
-                    const complex_d temp{buffer[k+step2] * u};
-                    buffer[k+step2] = buffer[k] - temp;
-                    buffer[k] += temp;
-                }
-                u *= w;
+                /* Write out the complex multiply, to avoid the NaN checks
+                 * std::complex does for it.
+                 */
+                const complex_d u{twiddles[j*tstride].real(), twiddles[j*tstride].imag()*sign};
+                const complex_d temp{hi[j].real()*u.real() - hi[j].imag()*u.imag(),
+                    hi[j].real()*u.imag() + hi[j].imag()*u.real()};
+                hi[j] = lo[j] - temp;
+                lo[j] += temp;
             }
         }
     }
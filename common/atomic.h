@@ -3,6 +3,7 @@
 
 #include <atomic>
 #include <cstddef>
+#include <initializer_list>
 #include <memory>
 
 #include "almalloc.h"
@@ -16,21 +17,71 @@ auto DecrementRef(std::atomic<T> &ref) noexcept
 { return ref.fetch_sub(1u, std::memory_order_acq_rel)-1u; }
 
 
-/* WARNING: A livelock is theoretically possible if another thread keeps
- * changing the head without giving this a chance to actually swap in the new
- * one (practically impossible with this little code, but...).
+namespace al {
+
+/* A free list of objects linked through an atomic 'next' member. Any thread
+ * may give objects back, while only one thread at a time may take them (the
+ * caller provides the serialization). Taking objects works from a private
+ * list, refilled by swapping out the whole shared list at once. So takers
+ * never race pushers with a compare-exchange on the same head, and there's no
+ * ABA issue from an object being taken and given back during a pop.
  */
 template<typename T>
-inline void AtomicReplaceHead(std::atomic<T> &head, T newhead)
-{
-    T first_ = head.load(std::memory_order_acquire);
-    do {
-        newhead->next.store(first_, std::memory_order_relaxed);
-    } while(!head.compare_exchange_weak(first_, newhead,
-            std::memory_order_acq_rel, std::memory_order_acquire));
-}
+class FreeList {
+    std::atomic<T*> mShared{nullptr};
+    T *mLocal{nullptr};
+
+public:
+    FreeList() = default;
+    FreeList(const FreeList&) = delete;
+    auto operator=(const FreeList&) -> FreeList& = delete;
+
+    /* Gives back a linked chain of objects, from first to last. */
+    void push(T *first, T *last) noexcept
+    {
+        T *oldhead{mShared.load(std::memory_order_acquire)};
+        do {
+            last->next.store(oldhead, std::memory_order_relaxed);
+        } while(!mShared.compare_exchange_weak(oldhead, first, std::memory_order_acq_rel,
+            std::memory_order_acquire));
+    }
+    void push(T *item) noexcept { push(item, item); }
+
+    /* Takes an object, or returns nullptr if there are none. */
+    [[nodiscard]]
+    auto pop() noexcept -> T*
+    {
+        if(!mLocal)
+            mLocal = mShared.exchange(nullptr, std::memory_order_acquire);
+        T *item{mLocal};
+        if(item)
+            mLocal = item->next.load(std::memory_order_relaxed);
+        return item;
+    }
+
+    /* Calls fn on each free object. Must be serialized with pop. */
+    template<typename F>
+    void forEach(F&& fn)
+    {
+        for(T *item : {mLocal, mShared.load(std::memory_order_acquire)})
+        {
+            while(item)
+            {
+                T *next{item->next.load(std::memory_order_relaxed)};
+                fn(*item);
+                item = next;
+            }
+        }
+    }
+
+    /* Forgets all free objects. Nothing else may be using the list. */
+    void clear() noexcept
+    {
+        mLocal = nullptr;
+        mShared.store(nullptr, std::memory_order_relaxed);
+    }
+};
 
-namespace al {
 
 template<typename T, typename D=std::default_delete<T>>
 class atomic_unique_ptr {
@@ -0,0 +1,60 @@
+#include "config.h"
+
+#include "fixedpool.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace al {
+
+FixedPool::FixedPool(std::size_t blocksize, std::size_t count)
+{
+    if(count >= sEndIndex)
+        throw std::overflow_error{"Fixed pool block count overflow"};
+
+    mBlockSize = (std::max(blocksize, std::size_t{1})+sBlockAlign-1) & ~(sBlockAlign-1);
+    mCapacity = count;
+    mStorage.resize(mBlockSize * count);
+    mNextFree = std::make_unique<std::atomic<std::uint32_t>[]>(count);
+
+    /* Link every block into the free list, in order. */
+    for(std::size_t i{0};i < count;++i)
+        mNextFree[i].store((i+1 < count) ? static_cast<std::uint32_t>(i+1) : sEndIndex,
+            std::memory_order_relaxed);
+    mFreeHead.store((count > 0) ? 0u : sEndIndex, std::memory_order_release);
+}
+
+auto FixedPool::allocate() noexcept -> void*
+{
+    auto head = mFreeHead.load(std::memory_order_acquire);
+    std::uint32_t index{};
+    do {
+        index = static_cast<std::uint32_t>(head);
+        if(index == sEndIndex)
+            return nullptr;
+        const auto next = mNextFree[index].load(std::memory_order_relaxed);
+        const auto newhead = ((head>>32) + 1)<<32 | next;
+        if(mFreeHead.compare_exchange_weak(head, newhead, std::memory_order_acq_rel,
+            std::memory_order_acquire))
+            break;
+    } while(true);
+    return &mStorage[index*mBlockSize];
+}
+
+void FixedPool::deallocate(void *block) noexcept
+{
+    if(!block) return;
+
+    const auto offset = static_cast<std::size_t>(static_cast<std::byte*>(block)
+        - mStorage.data());
+    const auto index = static_cast<std::uint32_t>(offset / mBlockSize);
+
+    auto head = mFreeHead.load(std::memory_order_relaxed);
+    do {
+        mNextFree[index].store(static_cast<std::uint32_t>(head), std::memory_order_relaxed);
+    } while(!mFreeHead.compare_exchange_weak(head, ((head>>32) + 1)<<32 | index,
+        std::memory_order_release, std::memory_order_relaxed));
+}
+
+} // namespace al
@@ -0,0 +1,60 @@
+#ifndef AL_FIXEDPOOL_H
+#define AL_FIXEDPOOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "almalloc.h"
+#include "vector.h"
+
+
+namespace al {
+
+/* A fixed number of equally sized memory blocks, allocated up front through
+ * al::allocator. Blocks are taken and given back with lock-free atomic
+ * operations, so a real-time thread can get storage without calling into the
+ * general heap, and any thread can return it. When every block is in use,
+ * allocation fails instead of growing the pool.
+ */
+class FixedPool {
+    static constexpr std::size_t sBlockAlign{16};
+    static constexpr std::uint32_t sEndIndex{~0u};
+
+    /* The free list head, holding the first free block index in the low 32
+     * bits and a change count in the high 32 bits, to avoid ABA issues when
+     * blocks are taken and given back concurrently.
+     */
+    std::atomic<std::uint64_t> mFreeHead{sEndIndex};
+    std::unique_ptr<std::atomic<std::uint32_t>[]> mNextFree;
+
+    std::size_t mBlockSize{0};
+    std::size_t mCapacity{0};
+    al::vector<std::byte,sBlockAlign> mStorage;
+
+public:
+    FixedPool(std::size_t blocksize, std::size_t count);
+    FixedPool(const FixedPool&) = delete;
+    FixedPool& operator=(const FixedPool&) = delete;
+
+    /* Returns a block of blockSize() bytes, or nullptr if none are free. */
+    [[nodiscard]] auto allocate() noexcept -> void*;
+    void deallocate(void *block) noexcept;
+
+    [[nodiscard]] auto blockSize() const noexcept -> std::size_t { return mBlockSize; }
+    [[nodiscard]] auto capacity() const noexcept -> std::size_t { return mCapacity; }
+};
+
+struct FixedPoolDeleter {
+    FixedPool *mPool{};
+    void operator()(void *block) const noexcept { mPool->deallocate(block); }
+};
+
+/* A block from a FixedPool, holding trivially destructible data. */
+template<typename T>
+using FixedPoolPtr = std::unique_ptr<T,FixedPoolDeleter>;
+
+} // namespace al
+
+#endif /* AL_FIXEDPOOL_H */
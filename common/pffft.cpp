@@ -59,11 +59,13 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <cmath>
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
+#include <mutex>
 #include <new>
 #include <utility>
 #include <vector>
@@ -152,7 +154,11 @@ force_inline v4sf vswaphl(v4sf a, v4sf b) noexcept
     (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
 
 #include <xmmintrin.h>
+#ifdef HAVE_AVX2
+#include <immintrin.h>
+#endif
 using v4sf = __m128;
+#define PFFFT_X86_SSE
 /* 4 floats by simd vector -- this is pretty much hardcoded in the preprocess/
  * finalize functions anyway so you will have to work if you want to enable AVX
  * with its 256-bit vectors.
@@ -1540,6 +1546,30 @@ void pffft_destroy_setup(gsl::owner<PFFFT_Setup*> s) noexcept
     ::operator delete[](gsl::owner<void*>{s}, V4sfAlignVal);
 }
 
+std::shared_ptr<const PFFFT_Setup> pffft_get_shared_setup(unsigned int N,
+    pffft_transform_t transform)
+{
+    struct SetupEntry {
+        uint N;
+        pffft_transform_t transform;
+        std::shared_ptr<const PFFFT_Setup> setup;
+    };
+    static std::mutex CacheLock;
+    static std::vector<SetupEntry> SetupCache;
+
+    std::lock_guard<std::mutex> cachelock{CacheLock};
+    auto iter = std::find_if(SetupCache.cbegin(), SetupCache.cend(),
+        [N,transform](const SetupEntry &entry) noexcept -> bool
+        { return entry.N == N && entry.transform == transform; });
+    if(iter != SetupCache.cend())
+        return iter->setup;
+
+    auto setup = std::shared_ptr<const PFFFT_Setup>{pffft_new_setup(N, transform)};
+    if(setup)
+        SetupCache.emplace_back(SetupEntry{N, transform, setup});
+    return setup;
+}
+
 #if !defined(PFFFT_SIMD_DISABLE)
 
 namespace {
@@ -1862,6 +1892,7 @@ void pffft_transform_internal(const PFFFT_Setup *setup, const v4sf *vinput, v4sf
 
     const size_t Ncvec{setup->Ncvec};
     const bool nf_odd{(setup->ifac[1]&1) != 0};
+    [[maybe_unused]] const v4sf *const finput{vinput};
 
     std::array buff{voutput, scratch};
     bool ib{nf_odd != ordered};
@@ -1920,7 +1951,7 @@ void pffft_transform_internal(const PFFFT_Setup *setup, const v4sf *vinput, v4sf
     if(buff[ib] != voutput)
     {
         /* extra copy required -- this situation should only happen when finput == foutput */
-        assert(vinput==voutput);
+        assert(finput==voutput);
         for(size_t k{0};k < Ncvec;++k)
         {
             v4sf a{buff[ib][2*k]}, b{buff[ib][2*k+1]};
@@ -1984,6 +2015,104 @@ void pffft_zreorder(const PFFFT_Setup *setup, const float *in, float *out,
     }
 }
 
+namespace {
+
+#if defined(HAVE_AVX2) && defined(PFFFT_X86_SSE)
+#if defined(__GNUC__) || defined(__clang__)
+#define AVX2_TARGET [[gnu::target("avx2,fma")]]
+#else
+#define AVX2_TARGET
+#endif
+
+std::atomic<bool> gUseAVX2{false};
+
+/* Handles two complex v4sf blocks (4 real parts followed by their 4 imaginary
+ * parts each) per iteration, with lane permutes gathering the real and
+ * imaginary halves into full 256-bit vectors. The data layout stays the same
+ * as the SSE version.
+ */
+template<bool Scale>
+AVX2_TARGET
+void zconvolve_accumulate_avx2(size_t Ncvec, const float *a, const float *b, float *ab,
+    float scaling)
+{
+    const __m256 vscale{_mm256_set1_ps(scaling)};
+    const auto sa = al::span{a, Ncvec*8};
+    const auto sb = al::span{b, Ncvec*8};
+    const auto sab = al::span{ab, Ncvec*8};
+
+    size_t i{0};
+    for(;Ncvec-i >= 2;i+=2)
+    {
+        const __m256 a0{_mm256_loadu_ps(&sa[i*8])}, a1{_mm256_loadu_ps(&sa[i*8 + 8])};
+        const __m256 b0{_mm256_loadu_ps(&sb[i*8])}, b1{_mm256_loadu_ps(&sb[i*8 + 8])};
+        const __m256 ar{_mm256_permute2f128_ps(a0, a1, 0x20)};
+        const __m256 ai{_mm256_permute2f128_ps(a0, a1, 0x31)};
+        const __m256 br{_mm256_permute2f128_ps(b0, b1, 0x20)};
+        const __m256 bi{_mm256_permute2f128_ps(b0, b1, 0x31)};
+
+        __m256 pr{_mm256_fmsub_ps(ar, br, _mm256_mul_ps(ai, bi))};
+        __m256 pi{_mm256_fmadd_ps(ar, bi, _mm256_mul_ps(ai, br))};
+
+        const __m256 ab0{_mm256_loadu_ps(&sab[i*8])}, ab1{_mm256_loadu_ps(&sab[i*8 + 8])};
+        const __m256 abr{_mm256_permute2f128_ps(ab0, ab1, 0x20)};
+        const __m256 abi{_mm256_permute2f128_ps(ab0, ab1, 0x31)};
+        if constexpr(Scale)
+        {
+            pr = _mm256_fmadd_ps(pr, vscale, abr);
+            pi = _mm256_fmadd_ps(pi, vscale, abi);
+        }
+        else
+        {
+            pr = _mm256_add_ps(pr, abr);
+            pi = _mm256_add_ps(pi, abi);
+        }
+        _mm256_storeu_ps(&sab[i*8], _mm256_permute2f128_ps(pr, pi, 0x20));
+        _mm256_storeu_ps(&sab[i*8 + 8], _mm256_permute2f128_ps(pr, pi, 0x31));
+    }
+    if(i < Ncvec)
+    {
+        const __m128 ar{_mm_loadu_ps(&sa[i*8])}, ai{_mm_loadu_ps(&sa[i*8 + 4])};
+        const __m128 br{_mm_loadu_ps(&sb[i*8])}, bi{_mm_loadu_ps(&sb[i*8 + 4])};
+        __m128 pr{_mm_fmsub_ps(ar, br, _mm_mul_ps(ai, bi))};
+        __m128 pi{_mm_fmadd_ps(ar, bi, _mm_mul_ps(ai, br))};
+        if constexpr(Scale)
+        {
+            pr = _mm_mul_ps(pr, _mm256_castps256_ps128(vscale));
+            pi = _mm_mul_ps(pi, _mm256_castps256_ps128(vscale));
+        }
+        _mm_storeu_ps(&sab[i*8], _mm_add_ps(pr, _mm_loadu_ps(&sab[i*8])));
+        _mm_storeu_ps(&sab[i*8 + 4], _mm_add_ps(pi, _mm_loadu_ps(&sab[i*8 + 4])));
+    }
+}
+#undef AVX2_TARGET
+
+#else
+
+constexpr bool gUseAVX2{false};
+
+template<bool Scale>
+void zconvolve_accumulate_avx2(size_t, const float*, const float*, float*, float) { }
+#endif
+
+auto UseAVX2() noexcept -> bool
+{
+#if defined(HAVE_AVX2) && defined(PFFFT_X86_SSE)
+    return gUseAVX2.load(std::memory_order_relaxed);
+#else
+    return gUseAVX2;
+#endif
+}
+
+} // namespace
+
+void pffft_enable_avx2([[maybe_unused]] bool enable) noexcept
+{
+#if defined(HAVE_AVX2) && defined(PFFFT_X86_SSE)
+    gUseAVX2.store(enable, std::memory_order_relaxed);
+#endif
+}
+
 void pffft_zconvolve_scale_accumulate(const PFFFT_Setup *s, const float *a, const float *b,
     float *ab, float scaling)
 {
@@ -2017,6 +2146,10 @@ void pffft_zconvolve_scale_accumulate(const PFFFT_Setup *s, const float *a, cons
     const float abr1{vextract0(vab[0])};
     const float abi1{vextract0(vab[1])};
 
+    if(UseAVX2())
+        zconvolve_accumulate_avx2<true>(Ncvec, a, b, ab, scaling);
+    else
+    {
 #ifdef ZCONVOLVE_USING_INLINE_ASM
     /* Inline asm version, unfortunately miscompiled by clang 3.2, at least on
      * Ubuntu. So this will be restricted to GCC.
@@ -2078,6 +2211,7 @@ void pffft_zconvolve_scale_accumulate(const PFFFT_Setup *s, const float *a, cons
         vab[2*i+3] = vmadd(ai4, vscal, vab[2*i+3]);
     }
 #endif
+    }
 
     if(s->transform == PFFFT_REAL)
     {
@@ -2118,7 +2252,9 @@ void pffft_zconvolve_accumulate(const PFFFT_Setup *s, const float *a, const floa
     /* No inline assembly for this version. I'm not familiar enough with NEON
      * assembly, and I don't know that it's needed with today's optimizers.
      */
-    for(size_t i{0};i < Ncvec;i += 2)
+    if(UseAVX2())
+        zconvolve_accumulate_avx2<false>(Ncvec, a, b, ab, 1.0f);
+    else for(size_t i{0};i < Ncvec;i += 2)
     {
         v4sf ar4{va[2*i+0]}, ai4{va[2*i+1]};
         v4sf br4{vb[2*i+0]}, bi4{vb[2*i+1]};
@@ -2248,6 +2384,8 @@ void pffft_zreorder(const PFFFT_Setup *setup, const float *in, float *RESTRICT o
     }
 }
 
+void pffft_enable_avx2(bool) noexcept { }
+
 void pffft_zconvolve_scale_accumulate(const PFFFT_Setup *s, const float *a, const float *b,
     float *ab, float scaling)
 {
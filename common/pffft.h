@@ -109,6 +109,14 @@ using PFFFTSetupPtr = std::unique_ptr<PFFFT_Setup,PFFFTSetupDeleter>;
  */
 PFFFTSetupPtr pffft_new_setup(unsigned int N, pffft_transform_t transform);
 
+/**
+ * Get a shared setup for transforms of size N. Setups are created on first use
+ * and cached for the life of the process, so repeated requests for the same
+ * size and type reuse the same twiddle factors. This is thread-safe.
+ */
+std::shared_ptr<const PFFFT_Setup> pffft_get_shared_setup(unsigned int N,
+    pffft_transform_t transform);
+
 /**
  * Perform a Fourier transform. The z-domain data is stored in the most
  * efficient order for transforming back or using for convolution, and as
@@ -173,16 +181,23 @@ void pffft_zconvolve_scale_accumulate(const PFFFT_Setup *setup, const float *dft
  */
 void pffft_zconvolve_accumulate(const PFFFT_Setup *setup, const float *dft_a, const float *dft_b, float *dft_ab);
 
+/**
+ * Lets the convolution functions use AVX2 with FMA, if built with support for
+ * it. The caller must make sure the CPU and OS support it. The data layout is
+ * unchanged, so it's safe to change at any time.
+ */
+void pffft_enable_avx2(bool enable) noexcept;
+
 
 struct PFFFTSetup {
-    PFFFTSetupPtr mSetup{};
+    std::shared_ptr<const PFFFT_Setup> mSetup{};
 
     PFFFTSetup() = default;
     PFFFTSetup(const PFFFTSetup&) = delete;
     PFFFTSetup(PFFFTSetup&& rhs) noexcept = default;
     explicit PFFFTSetup(std::nullptr_t) noexcept { }
     explicit PFFFTSetup(unsigned int n, pffft_transform_t transform)
-        : mSetup{pffft_new_setup(n, transform)}
+        : mSetup{pffft_get_shared_setup(n, transform)}
     { }
     ~PFFFTSetup() = default;
 
@@ -2,6 +2,7 @@
 #include "polyphase_resampler.h"
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstddef>
 #include <numeric>
@@ -139,6 +140,26 @@ double SincFilter(const uint l, const double beta, const double besseli_0_beta,
 
 } // namespace
 
+void MakeKaiserSincLowPass(const double rejection, const double stopfreq, const double gain,
+    const al::span<double> filter)
+{
+    if(filter.empty()) UNLIKELY
+        return;
+
+    /* Invert CalcKaiserOrder to get the transition width for the available
+     * order, and center the cutoff so the transition ends at stopfreq.
+     */
+    const uint l{static_cast<uint>((filter.size()-1) / 2)};
+    const double w_t{(l > 0) ? (rejection - 7.95) / (2.285 * 2.0 * l) : 0.0};
+    const double cutoff{stopfreq - w_t/(4.0*al::numbers::pi)};
+    const double beta{CalcKaiserBeta(rejection)};
+    const double besseli_0_beta{cyl_bessel_i(0, beta)};
+    for(uint i{0};i < filter.size();i++)
+        filter[i] = (i <= l*2) ? SincFilter(l, beta, besseli_0_beta, gain, cutoff, i) : 0.0;
+}
+
+PPhaseResampler::~PPhaseResampler() = default;
+
 // Calculate the resampling metrics and build the Kaiser-windowed sinc filter
 // that's used to cut frequencies above the destination nyquist.
 void PPhaseResampler::init(const uint srcRate, const uint dstRate)
@@ -164,11 +185,31 @@ void PPhaseResampler::init(const uint srcRate, const uint dstRate)
     mF.resize(mM);
     for(uint i{0};i < mM;i++)
         mF[i] = SincFilter(l, beta, besseli_0_beta, mP, cutoff, i);
+
+    /* Phase i uses every p'th coefficient starting at i, which are applied to
+     * successively earlier input samples. Reversing them lets each phase be
+     * applied to the input in order.
+     */
+    mPhaseF.clear();
+    mPhaseF.reserve(mM);
+    mPhaseOffset.resize(mP);
+    mPhaseLen.resize(mP);
+    for(uint i{0};i < mP;i++)
+    {
+        const uint len{(i < mM) ? (mM-i+mP-1) / mP : 0u};
+        mPhaseOffset[i] = static_cast<uint>(mPhaseF.size());
+        mPhaseLen[i] = len;
+        for(uint k{len};k > 0;)
+        {
+            --k;
+            mPhaseF.emplace_back(mF[i + size_t{mP}*k]);
+        }
+    }
 }
 
 // Perform the upsample-filter-downsample resampling operation using a
 // polyphase filter implementation.
-void PPhaseResampler::process(const al::span<const double> in, const al::span<double> out)
+void PPhaseResampler::process(const al::span<const double> in, const al::span<double> out) const
 {
     if(out.empty()) UNLIKELY
         return;
@@ -183,36 +224,44 @@ void PPhaseResampler::process(const al::span<const double> in, const al::span<do
     }
 
     // Resample the input.
-    const uint p{mP}, q{mQ}, m{mM}, l{mL};
-    const al::span<const double> f{mF};
+    const uint p{mP}, q{mQ}, l{mL};
+    const al::span<const double> phasef{mPhaseF};
     for(uint i{0};i < out.size();i++)
     {
         // Input starts at l to compensate for the filter delay.  This will
         // drop any build-up from the first half of the filter.
-        std::size_t j_f{(l + q*i) % p};
-        std::size_t j_s{(l + q*i) / p};
+        const std::size_t j_f{(l + size_t{q}*i) % p};
+        const std::size_t j_s{(l + size_t{q}*i) / p};
+
+        // The phase's coefficients apply to in[j_s-len+1] through in[j_s],
+        // clipped to the available input.
+        const std::size_t len{mPhaseLen[j_f]};
+        const std::size_t skip_front{(len > j_s+1) ? len - (j_s+1) : 0};
+        const std::size_t skip_back{(j_s+1 > in.size()) ? std::min(j_s+1 - in.size(), len) : 0};
+        if(skip_front + skip_back >= len)
+        {
+            work[i] = 0.0;
+            continue;
+        }
+
+        const std::size_t todo{len - skip_front - skip_back};
+        const auto coeffs = phasef.subspan(mPhaseOffset[j_f] + skip_front, todo);
+        const auto src = in.subspan(j_s+1 - len + skip_front, todo);
 
-        // Only take input when 0 <= j_s < in.size().
-        double r{0.0};
-        if(j_f < m) LIKELY
+        // Use separate accumulators so the sums can run in parallel (and be
+        // vectorized), rather than waiting on each previous addition.
+        std::array<double,4> r{};
+        std::size_t k{0};
+        for(;todo-k >= 4;k += 4)
         {
-            std::size_t filt_len{(m-j_f+p-1) / p};
-            if(j_s+1 > in.size()) LIKELY
-            {
-                std::size_t skip{std::min(j_s+1 - in.size(), filt_len)};
-                j_f += p*skip;
-                j_s -= skip;
-                filt_len -= skip;
-            }
-            std::size_t todo{std::min(j_s+1, filt_len)};
-            while(todo)
-            {
-                r += f[j_f] * in[j_s];
-                j_f += p; --j_s;
-                --todo;
-            }
+            r[0] += coeffs[k+0] * src[k+0];
+            r[1] += coeffs[k+1] * src[k+1];
+            r[2] += coeffs[k+2] * src[k+2];
+            r[3] += coeffs[k+3] * src[k+3];
         }
-        work[i] = r;
+        for(;k < todo;++k)
+            r[0] += coeffs[k] * src[k];
+        work[i] = (r[0]+r[1]) + (r[2]+r[3]);
     }
     // Clean up after in-place operation.
     if(work.data() != out.data())
@@ -36,14 +36,34 @@ using uint = unsigned int;
  */
 
 struct PPhaseResampler {
+    PPhaseResampler() = default;
+    ~PPhaseResampler();
+
     void init(const uint srcRate, const uint dstRate);
-    void process(const al::span<const double> in, const al::span<double> out);
+    void process(const al::span<const double> in, const al::span<double> out) const;
 
     explicit operator bool() const noexcept { return !mF.empty(); }
 
 private:
     uint mP{}, mQ{}, mM{}, mL{};
     std::vector<double> mF;
+
+    /* The filter split into its p phases, each stored contiguously and in
+     * reverse, so an output sample is a forward dot product with the input.
+     * Phase i has mPhaseLen[i] coefficients, starting at mPhaseOffset[i].
+     */
+    std::vector<double> mPhaseF;
+    std::vector<uint> mPhaseOffset;
+    std::vector<uint> mPhaseLen;
 };
 
+/**
+ * Builds a Kaiser-windowed sinc low-pass filter into the given span, with the
+ * stop band rejection in dB, and the transition band ending at the given
+ * normalized frequency (0.5 is nyquist). The filter is centered on its middle
+ * sample, so an even length leaves the last sample as 0.
+ */
+void MakeKaiserSincLowPass(const double rejection, const double stopfreq, const double gain,
+    const al::span<double> filter);
+
 #endif /* POLYPHASE_RESAMPLER_H */
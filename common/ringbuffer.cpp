@@ -28,10 +28,77 @@
 #include <stdexcept>
 #include <tuple>
 
+#ifdef HAVE_SHM_OPEN
+#include <atomic>
+#include <cerrno>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #include "alnumeric.h"
 
 
-auto RingBuffer::Create(std::size_t sz, std::size_t elem_sz, bool limit_writes) -> RingBufferPtr
+namespace {
+
+#ifdef HAVE_SHM_OPEN
+/* Maps `numbytes' (a multiple of the page size) of shared memory twice, back-
+ * to-back, returning the start of the first mapping or nullptr on failure.
+ */
+auto MapMirrored(std::size_t numbytes) noexcept -> std::byte*
+{
+    static std::atomic<unsigned int> sMapCount{0u};
+
+    /* The shared memory object only needs a name long enough to get a file
+     * descriptor for it.
+     */
+    int fd{-1};
+    for(int tries{0};fd == -1 && tries < 8;++tries)
+    {
+        const auto name = "/alsoft-ring-" + std::to_string(getpid()) + "-"
+            + std::to_string(sMapCount.fetch_add(1u, std::memory_order_relaxed));
+        fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if(fd != -1) shm_unlink(name.c_str());
+        else if(errno != EEXIST) return nullptr;
+    }
+    if(fd == -1) return nullptr;
+
+    std::byte *ret{nullptr};
+    if(ftruncate(fd, static_cast<off_t>(numbytes)) == 0)
+    {
+        /* Reserve the full range, then map the object over each half. */
+        void *base{mmap(nullptr, numbytes*2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)};
+        if(base != MAP_FAILED)
+        {
+            auto *first = static_cast<std::byte*>(base);
+            if(mmap(first, numbytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0)
+                    != MAP_FAILED
+                && mmap(first+numbytes, numbytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+                    fd, 0) != MAP_FAILED)
+                ret = first;
+            else
+                munmap(base, numbytes*2);
+        }
+    }
+    close(fd);
+    return ret;
+}
+#endif
+
+} // namespace
+
+RingBuffer::~RingBuffer()
+{
+#ifdef HAVE_SHM_OPEN
+    if(mMirrorBytes)
+        munmap(mData, mMirrorBytes*2);
+#endif
+}
+
+
+auto RingBuffer::Create(std::size_t sz, std::size_t elem_sz, bool limit_writes, bool mirrored)
+    -> RingBufferPtr
 {
     std::size_t power_of_two{0u};
     if(sz > 0)
@@ -50,6 +117,36 @@ auto RingBuffer::Create(std::size_t sz, std::size_t elem_sz, bool limit_writes)
         || power_of_two > std::numeric_limits<std::size_t>::max()/elem_sz)
         throw std::overflow_error{"Ring buffer size overflow"};
 
+#ifdef HAVE_SHM_OPEN
+    if(mirrored)
+    {
+        /* The mapping needs a whole number of pages, so keep doubling the
+         * element count until it fills them. The page size is a power of two,
+         * so it's at worst one element per byte of the page.
+         */
+        const auto pagesize = static_cast<std::size_t>(std::max(sysconf(_SC_PAGESIZE), 1l));
+        std::size_t mirror_count{power_of_two};
+        while(((mirror_count*elem_sz) % pagesize) != 0
+            && mirror_count <= std::numeric_limits<std::size_t>::max()/4/elem_sz)
+            mirror_count <<= 1;
+
+        if(((mirror_count*elem_sz) % pagesize) == 0)
+        {
+            const std::size_t mirrorbytes{mirror_count * elem_sz};
+            if(std::byte *mapping{MapMirrored(mirrorbytes)})
+            {
+                RingBufferPtr rb{new(FamCount(0)) RingBuffer{limit_writes ? sz : mirror_count,
+                    mirror_count-1, elem_sz, 0}};
+                rb->mData = mapping;
+                rb->mMirrorBytes = mirrorbytes;
+                return rb;
+            }
+        }
+    }
+#else
+    std::ignore = mirrored;
+#endif
+
     const std::size_t bufbytes{power_of_two * elem_sz};
     RingBufferPtr rb{new(FamCount(bufbytes)) RingBuffer{limit_writes ? sz : power_of_two,
         power_of_two-1, elem_sz, bufbytes}};
@@ -61,7 +158,7 @@ void RingBuffer::reset() noexcept
 {
     mWriteCount.store(0, std::memory_order_relaxed);
     mReadCount.store(0, std::memory_order_relaxed);
-    std::fill_n(mBuffer.begin(), (mSizeMask+1)*mElemSize, std::byte{});
+    std::fill_n(mData, (mSizeMask+1)*mElemSize, std::byte{});
 }
 
 
@@ -76,14 +173,14 @@ auto RingBuffer::read(void *dest, std::size_t count) noexcept -> std::size_t
     const std::size_t read_idx{r & mSizeMask};
 
     const std::size_t rdend{read_idx + to_read};
-    const auto [n1, n2] = (rdend <= mSizeMask+1) ? std::make_tuple(to_read, 0_uz)
+    const auto [n1, n2] = (mMirrorBytes || rdend <= mSizeMask+1)
+        ? std::make_tuple(to_read, 0_uz)
         : std::make_tuple(mSizeMask+1 - read_idx, rdend&mSizeMask);
 
     auto dstbytes = al::span{static_cast<std::byte*>(dest), count*mElemSize};
-    auto outiter = std::copy_n(mBuffer.begin() + ptrdiff_t(read_idx*mElemSize), n1*mElemSize,
-        dstbytes.begin());
+    auto outiter = std::copy_n(mData + read_idx*mElemSize, n1*mElemSize, dstbytes.begin());
     if(n2 > 0)
-        std::copy_n(mBuffer.begin(), n2*mElemSize, outiter);
+        std::copy_n(mData, n2*mElemSize, outiter);
     mReadCount.store(r+n1+n2, std::memory_order_release);
     return to_read;
 }
@@ -99,14 +196,14 @@ auto RingBuffer::peek(void *dest, std::size_t count) const noexcept -> std::size
     const std::size_t read_idx{r & mSizeMask};
 
     const std::size_t rdend{read_idx + to_read};
-    const auto [n1, n2] = (rdend <= mSizeMask+1) ? std::make_tuple(to_read, 0_uz)
+    const auto [n1, n2] = (mMirrorBytes || rdend <= mSizeMask+1)
+        ? std::make_tuple(to_read, 0_uz)
         : std::make_tuple(mSizeMask+1 - read_idx, rdend&mSizeMask);
 
     auto dstbytes = al::span{static_cast<std::byte*>(dest), count*mElemSize};
-    auto outiter = std::copy_n(mBuffer.begin() + ptrdiff_t(read_idx*mElemSize), n1*mElemSize,
-        dstbytes.begin());
+    auto outiter = std::copy_n(mData + read_idx*mElemSize, n1*mElemSize, dstbytes.begin());
     if(n2 > 0)
-        std::copy_n(mBuffer.begin(), n2*mElemSize, outiter);
+        std::copy_n(mData, n2*mElemSize, outiter);
     return to_read;
 }
 
@@ -121,13 +218,14 @@ auto RingBuffer::write(const void *src, std::size_t count) noexcept -> std::size
     const std::size_t write_idx{w & mSizeMask};
 
     const std::size_t wrend{write_idx + to_write};
-    const auto [n1, n2] = (wrend <= mSizeMask+1) ? std::make_tuple(to_write, 0_uz)
+    const auto [n1, n2] = (mMirrorBytes || wrend <= mSizeMask+1)
+        ? std::make_tuple(to_write, 0_uz)
         : std::make_tuple(mSizeMask+1 - write_idx, wrend&mSizeMask);
 
     auto srcbytes = al::span{static_cast<const std::byte*>(src), count*mElemSize};
-    std::copy_n(srcbytes.cbegin(), n1*mElemSize, mBuffer.begin() + ptrdiff_t(write_idx*mElemSize));
+    std::copy_n(srcbytes.cbegin(), n1*mElemSize, mData + write_idx*mElemSize);
     if(n2 > 0)
-        std::copy_n(srcbytes.cbegin() + ptrdiff_t(n1*mElemSize), n2*mElemSize, mBuffer.begin());
+        std::copy_n(srcbytes.cbegin() + ptrdiff_t(n1*mElemSize), n2*mElemSize, mData);
     mWriteCount.store(w+n1+n2, std::memory_order_release);
     return to_write;
 }
@@ -141,15 +239,15 @@ auto RingBuffer::getReadVector() noexcept -> DataPair
     const std::size_t read_idx{r & mSizeMask};
 
     const std::size_t rdend{read_idx + readable};
-    if(rdend > mSizeMask+1)
+    if(!mMirrorBytes && rdend > mSizeMask+1)
     {
         /* Two part vector: the rest of the buffer after the current read ptr,
          * plus some from the start of the buffer.
          */
-        return DataPair{{mBuffer.data() + read_idx*mElemSize, mSizeMask+1 - read_idx},
-            {mBuffer.data(), rdend&mSizeMask}};
+        return DataPair{{mData + read_idx*mElemSize, mSizeMask+1 - read_idx},
+            {mData, rdend&mSizeMask}};
     }
-    return DataPair{{mBuffer.data() + read_idx*mElemSize, readable}, {}};
+    return DataPair{{mData + read_idx*mElemSize, readable}, {}};
 }
 
 auto RingBuffer::getWriteVector() noexcept -> DataPair
@@ -160,13 +258,13 @@ auto RingBuffer::getWriteVector() noexcept -> DataPair
     const std::size_t write_idx{w & mSizeMask};
 
     const std::size_t wrend{write_idx + writable};
-    if(wrend > mSizeMask+1)
+    if(!mMirrorBytes && wrend > mSizeMask+1)
     {
         /* Two part vector: the rest of the buffer after the current write ptr,
          * plus some from the start of the buffer.
          */
-        return DataPair{{mBuffer.data() + write_idx*mElemSize, mSizeMask+1 - write_idx},
-            {mBuffer.data(), wrend&mSizeMask}};
+        return DataPair{{mData + write_idx*mElemSize, mSizeMask+1 - write_idx},
+            {mData, wrend&mSizeMask}};
     }
-    return DataPair{{mBuffer.data() + write_idx*mElemSize, writable}, {}};
+    return DataPair{{mData + write_idx*mElemSize, writable}, {}};
 }
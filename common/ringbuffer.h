@@ -33,6 +33,13 @@ private:
     const std::size_t mSizeMask;
     const std::size_t mElemSize;
 
+    /* The storage, which is either mBuffer or a mirrored mapping. A mirrored
+     * mapping places the same memory twice back-to-back, so any span of
+     * elements is contiguous from its start regardless of wrapping.
+     */
+    std::byte *mData{};
+    std::size_t mMirrorBytes{0u};
+
     al::FlexArray<std::byte, 16> mBuffer;
 
 public:
@@ -44,8 +51,12 @@ public:
 
     RingBuffer(const std::size_t writesize, const std::size_t mask, const std::size_t elemsize,
         const std::size_t numbytes)
-        : mWriteSize{writesize}, mSizeMask{mask}, mElemSize{elemsize}, mBuffer{numbytes}
-    { }
+        : mWriteSize{writesize}, mSizeMask{mask}, mElemSize{elemsize}, mData{},
+        mBuffer{numbytes}
+    { mData = mBuffer.data(); }
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+    ~RingBuffer();
 
     /** Reset the read and write pointers to zero. This is not thread safe. */
     auto reset() noexcept -> void;
@@ -76,7 +87,8 @@ public:
     /**
      * The non-copying data reader. Returns two ringbuffer data pointers that
      * hold the current readable data. If the readable data is in one segment
-     * the second segment has zero length.
+     * the second segment has zero length, which is always the case when the
+     * ringbuffer is mirrored.
      */
     [[nodiscard]] auto getReadVector() noexcept -> DataPair;
     /** Advance the read pointer `count' places. */
@@ -106,7 +118,8 @@ public:
     /**
      * The non-copying data writer. Returns two ringbuffer data pointers that
      * hold the current writeable data. If the writeable data is in one segment
-     * the second segment has zero length.
+     * the second segment has zero length, which is always the case when the
+     * ringbuffer is mirrored.
      */
     [[nodiscard]] auto getWriteVector() noexcept -> DataPair;
     /** Advance the write pointer `count' places. */
@@ -121,14 +134,20 @@ public:
 
     [[nodiscard]] auto getElemSize() const noexcept -> std::size_t { return mElemSize; }
 
+    /** Returns whether read and write vectors are always a single segment. */
+    [[nodiscard]] auto isMirrored() const noexcept -> bool { return mMirrorBytes != 0; }
+
     /**
      * Create a new ringbuffer to hold at least `sz' elements of `elem_sz'
      * bytes. The number of elements is rounded up to a power of two. If
      * `limit_writes' is true, the writable space will be limited to `sz'
-     * elements regardless of the rounded size.
+     * elements regardless of the rounded size. If `mirrored' is true, the
+     * storage is mapped twice back-to-back in virtual memory where supported,
+     * which may further round up the size to a whole number of pages.
      */
     [[nodiscard]] static
-    auto Create(std::size_t sz, std::size_t elem_sz, bool limit_writes) -> std::unique_ptr<RingBuffer>;
+    auto Create(std::size_t sz, std::size_t elem_sz, bool limit_writes, bool mirrored=false)
+        -> std::unique_ptr<RingBuffer>;
 
     DEF_FAM_NEWDEL(RingBuffer, mBuffer)
 };
@@ -0,0 +1,89 @@
+#ifndef CORE_ADPCM_DEFS_H
+#define CORE_ADPCM_DEFS_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+
+/* IMA ADPCM Stepsize table */
+inline constexpr std::array<int,89> IMAStep_size{{
+       7,    8,    9,   10,   11,   12,   13,   14,   16,   17,   19,
+      21,   23,   25,   28,   31,   34,   37,   41,   45,   50,   55,
+      60,   66,   73,   80,   88,   97,  107,  118,  130,  143,  157,
+     173,  190,  209,  230,  253,  279,  307,  337,  371,  408,  449,
+     494,  544,  598,  658,  724,  796,  876,  963, 1060, 1166, 1282,
+    1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660,
+    4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493,10442,
+   11487,12635,13899,15289,16818,18500,20350,22358,24633,27086,29794,
+   32767
+}};
+
+/* IMA4 ADPCM Codeword decode table */
+inline constexpr std::array<int,16> IMA4Codeword{{
+    1, 3, 5, 7, 9, 11, 13, 15,
+   -1,-3,-5,-7,-9,-11,-13,-15,
+}};
+
+/* IMA4 ADPCM Step index adjust decode table */
+inline constexpr std::array<int,16> IMA4Index_adjust{{
+   -1,-1,-1,-1, 2, 4, 6, 8,
+   -1,-1,-1,-1, 2, 4, 6, 8
+}};
+
+/* IMA4 ADPCM decode steps, for each step index and nibble. Each holds the
+ * sample delta (IMA4Codeword[nibble] * IMAStep_size[index] / 8) and the
+ * clamped step index for the next nibble, so decoding a nibble only needs the
+ * one lookup.
+ */
+struct IMA4DecodeStep {
+    int mDelta;
+    int mNextIndex;
+};
+inline constexpr auto IMA4DecodeTable = []
+{
+    constexpr int MaxStepIndex{static_cast<int>(IMAStep_size.size()) - 1};
+
+    std::array<std::array<IMA4DecodeStep,16>,IMAStep_size.size()> ret{};
+    for(size_t i{0};i < ret.size();++i)
+    {
+        for(size_t j{0};j < ret[i].size();++j)
+        {
+            const int next{static_cast<int>(i) + IMA4Index_adjust[j]};
+            ret[i][j].mDelta = IMA4Codeword[j] * IMAStep_size[i] / 8;
+            ret[i][j].mNextIndex = std::min(std::max(next, 0), MaxStepIndex);
+        }
+    }
+    return ret;
+}();
+
+/* IMA2 ADPCM Codeword decode table, in half steps. The high bit of each 2-bit
+ * code is the sign, and the low bit picks a delta of 1/2 or 3/2 steps.
+ */
+inline constexpr std::array<int,4> IMA2Codeword{{
+    1, 3, -1, -3
+}};
+
+/* IMA2 ADPCM Step index adjust decode table */
+inline constexpr std::array<int,4> IMA2Index_adjust{{
+   -1, 2, -1, 2
+}};
+
+/* MSADPCM Adaption table */
+inline constexpr std::array<int,16> MSADPCMAdaption{{
+    230, 230, 230, 230, 307, 409, 512, 614,
+    768, 614, 512, 409, 307, 230, 230, 230
+}};
+
+/* MSADPCM Adaption Coefficient tables */
+inline constexpr std::array MSADPCMAdaptionCoeff{
+    std::array{256,    0},
+    std::array{512, -256},
+    std::array{  0,    0},
+    std::array{192,   64},
+    std::array{240,    0},
+    std::array{460, -208},
+    std::array{392, -232}
+};
+
+#endif /* CORE_ADPCM_DEFS_H */
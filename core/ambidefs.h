@@ -43,6 +43,14 @@ inline constexpr auto Ambi2DChannelsFromOrder(std::size_t order) noexcept -> std
 { return order*2 + 1; }
 inline constexpr auto MaxAmbi2DChannels = std::size_t{Ambi2DChannelsFromOrder(MaxAmbiOrder)};
 
+/* The number of ambisonic channels for mixed-order (#H1P) representation, with
+ * full periphonic first-order and horizontal-only higher orders. This is 2 per
+ * each order above first-order, plus 4 for first-order. Or simply, o*2 + 2.
+ */
+inline constexpr auto AmbiMixedChannelsFromOrder(std::size_t order) noexcept -> std::size_t
+{ return order ? (order*2 + 2) : 1; }
+inline constexpr auto MaxAmbiMixedChannels = std::size_t{AmbiMixedChannelsFromOrder(MaxAmbiOrder)};
+
 
 /* NOTE: These are scale factors as applied to Ambisonics content. Decoder
  * coefficients should be divided by these values to get proper scalings.
@@ -146,6 +154,9 @@ struct AmbiIndex {
     static inline constexpr std::array<std::uint8_t,MaxAmbi2DChannels> FromACN2D{{
         0, 1,3, 4,8, 9,15
     }};
+    static inline constexpr std::array<std::uint8_t,MaxAmbiMixedChannels> FromACNMixed{{
+        0, 1,2,3, 4,8, 9,15
+    }};
 
 
     static inline constexpr std::array<std::uint8_t,MaxAmbiChannels> OrderFromChannel{{
@@ -154,6 +165,9 @@ struct AmbiIndex {
     static inline constexpr std::array<std::uint8_t,MaxAmbi2DChannels> OrderFrom2DChannel{{
         0, 1,1, 2,2, 3,3,
     }};
+    static inline constexpr std::array<std::uint8_t,MaxAmbiMixedChannels> OrderFromMixedChannel{{
+        0, 1,1,1, 2,2, 3,3,
+    }};
 };
 
 
@@ -2,11 +2,12 @@
 #define CORE_EVENT_H
 
 #include <array>
+#include <chrono>
 #include <cstdint>
-#include <string>
 #include <variant>
 
 #include "almalloc.h"
+#include "fixedpool.h"
 
 struct EffectState;
 
@@ -17,6 +18,8 @@ enum class AsyncEnableBits : std::uint8_t {
     SourceState,
     BufferCompleted,
     Disconnected,
+    EffectSlotReady,
+    BufferUploaded,
     Count
 };
 
@@ -35,23 +38,40 @@ struct AsyncSourceStateEvent {
     AsyncSrcState mState;
 };
 
+/* The clock time is the device clock time the last completed buffer ended
+ * at, and the sample offset is where it ended in the source's queue (see
+ * VoiceBufferItem::mSampleStart).
+ */
 struct AsyncBufferCompleteEvent {
     uint mId;
     uint mCount;
+    std::chrono::nanoseconds mClockTime;
+    std::uint64_t mSampleOffset;
 };
 
+/* The message is stored in a block from the device's event pool, since the
+ * event may be made on the mixer thread.
+ */
 struct AsyncDisconnectEvent {
-    std::string msg;
+    al::FixedPoolPtr<char> mMsg;
+
+    [[nodiscard]] auto msg() const noexcept -> const char*
+    { return mMsg ? mMsg.get() : ""; }
 };
 
 struct AsyncEffectReleaseEvent {
     EffectState *mEffectState;
 };
 
+struct AsyncEffectSlotReadyEvent {
+    uint mId;
+};
+
 using AsyncEvent = std::variant<AsyncKillThread,
         AsyncSourceStateEvent,
         AsyncBufferCompleteEvent,
         AsyncEffectReleaseEvent,
+        AsyncEffectSlotReadyEvent,
         AsyncDisconnectEvent>;
 
 template<typename T, typename ...Args>
@@ -6,15 +6,18 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
-#include <functional>
 #include <utility>
 
+#ifdef HAVE_SSE_INTRINSICS
+#include <xmmintrin.h>
+#endif
+
 #include "alnumbers.h"
 #include "bufferline.h"
 #include "filters/splitter.h"
 #include "flexarray.h"
 #include "front_stablizer.h"
-#include "mixer.h"
+#include "mixer/defs.h"
 #include "opthelpers.h"
 
 
@@ -58,6 +61,77 @@ BFormatDec::BFormatDec(const size_t inchans, const al::span<const ChannelDec> co
                 [j](const ChannelDec &incoeffs) { return incoeffs[j]; });
         }
     }
+
+    /* With the stablizer, the left and right outputs are turned into mid and
+     * side outputs, so the decode produces the signals the stablizer needs
+     * directly.
+     */
+    if(mStablizer)
+    {
+        const size_t lidx{mStablizer->LeftIdx};
+        const size_t ridx{mStablizer->RightIdx};
+        auto make_midside = [lidx,ridx](const al::span<float,MaxOutputChannels> gains) noexcept
+        {
+            const float left{gains[lidx]}, right{gains[ridx]};
+            gains[lidx] = left + right;
+            gains[ridx] = left - right;
+        };
+        std::visit(overloaded{
+            [make_midside](std::vector<ChannelDecoderDual> &decoder)
+            {
+                for(ChannelDecoderDual &chandec : decoder)
+                {
+                    make_midside(chandec.mGains[sHFBand]);
+                    make_midside(chandec.mGains[sLFBand]);
+                }
+            },
+            [make_midside](std::vector<ChannelDecoderSingle> &decoder)
+            {
+                for(ChannelDecoderSingle &chandec : decoder)
+                    make_midside(chandec.mGains);
+            }}, mChannelDec);
+    }
+
+    /* Pack the gains for the tiled decode. The dual-band decoder's inputs are
+     * the high-frequency tiles of each channel, followed by the low-frequency
+     * tiles.
+     */
+    auto gainrows = std::vector<al::span<const float,MaxOutputChannels>>{};
+    std::visit(overloaded{
+        [&gainrows](const std::vector<ChannelDecoderDual> &decoder)
+        {
+            for(size_t band : {sHFBand, sLFBand})
+            {
+                for(const ChannelDecoderDual &chandec : decoder)
+                    gainrows.emplace_back(chandec.mGains[band]);
+            }
+        },
+        [&gainrows](const std::vector<ChannelDecoderSingle> &decoder)
+        {
+            for(const ChannelDecoderSingle &chandec : decoder)
+                gainrows.emplace_back(chandec.mGains);
+        }}, mChannelDec);
+
+    const size_t numouts{coeffs.size()};
+    for(size_t o{0};o < numouts;o += sGroupSize)
+    {
+        auto &group = mDecodeGroups.emplace_back();
+        group.mOutput = o;
+        group.mCount = std::min(numouts-o, sGroupSize);
+        for(size_t k{0};k < gainrows.size();++k)
+        {
+            const auto gains = gainrows[k].subspan(o, group.mCount);
+            if(std::none_of(gains.begin(), gains.end(), [](const float gain) noexcept
+                { return std::abs(gain) > GainSilenceThreshold; }))
+                continue;
+
+            auto &row = group.mRows.emplace_back();
+            row.mInput = k;
+            row.mGains.fill({});
+            for(size_t j{0};j < gains.size();++j)
+                row.mGains[j].fill(gains[j]);
+        }
+    }
 }
 
 
@@ -66,106 +140,190 @@ void BFormatDec::process(const al::span<FloatBufferLine> OutBuffer,
 {
     ASSUME(SamplesToDo > 0);
 
-    auto decode_dualband = [=](std::vector<ChannelDecoderDual> &decoder)
+    /* The decode is a matrix multiply of the gains with the inputs, done a
+     * tile of samples at a time. Each group of outputs is written once per
+     * tile, rather than once for each input channel and band.
+     */
+    std::array<al::span<const float>,MaxAmbiChannels*sNumBands> inputs{};
+    auto decode_dualband = [&](std::vector<ChannelDecoderDual> &decoder)
     {
-        auto input = InSamples.cbegin();
-        const auto hfSamples = al::span<float>{mSamples[sHFBand]}.first(SamplesToDo);
-        const auto lfSamples = al::span<float>{mSamples[sLFBand]}.first(SamplesToDo);
-        for(auto &chandec : decoder)
+        const size_t numchans{decoder.size()};
+        std::array<BandSplitter*,MaxAmbiChannels> splitters{};
+        std::array<al::span<const float>,MaxAmbiChannels> chaninputs{};
+        std::array<al::span<float>,MaxAmbiChannels> hfSamples{}, lfSamples{};
+        for(size_t j{0};j < numchans;++j)
         {
-            chandec.mXOver.process(al::span{*input++}.first(SamplesToDo), hfSamples, lfSamples);
-            MixSamples(hfSamples, OutBuffer, chandec.mGains[sHFBand], chandec.mGains[sHFBand],0,0);
-            MixSamples(lfSamples, OutBuffer, chandec.mGains[sLFBand], chandec.mGains[sLFBand],0,0);
+            splitters[j] = &decoder[j].mXOver;
+            hfSamples[j] = mTiles[j];
+            lfSamples[j] = mTiles[numchans+j];
+            inputs[j] = mTiles[j];
+            inputs[numchans+j] = mTiles[numchans+j];
+        }
+
+        /* All the channels share the same crossover, so they're split
+         * together.
+         */
+        for(size_t base{0};base < SamplesToDo;base += sTileSize)
+        {
+            const size_t todo{std::min(SamplesToDo-base, sTileSize)};
+            for(size_t j{0};j < numchans;++j)
+                chaninputs[j] = al::span{InSamples[j]}.subspan(base, todo);
+            SplitBandsMulti(al::span{splitters}.first(numchans), chaninputs, hfSamples,
+                lfSamples, todo);
+            decodeTile(OutBuffer, base, inputs, todo);
         }
     };
-    auto decode_singleband = [=](std::vector<ChannelDecoderSingle> &decoder)
+    auto decode_singleband = [&](std::vector<ChannelDecoderSingle> &decoder)
     {
-        auto input = InSamples.cbegin();
-        for(auto &chandec : decoder)
+        const size_t numchans{decoder.size()};
+        for(size_t base{0};base < SamplesToDo;base += sTileSize)
         {
-            MixSamples(al::span{*input++}.first(SamplesToDo), OutBuffer, chandec.mGains,
-                chandec.mGains, 0, 0);
+            const size_t todo{std::min(SamplesToDo-base, sTileSize)};
+            for(size_t j{0};j < numchans;++j)
+                inputs[j] = al::span{InSamples[j]}.subspan(base, todo);
+            decodeTile(OutBuffer, base, inputs, todo);
         }
     };
 
     std::visit(overloaded{decode_dualband, decode_singleband}, mChannelDec);
 }
 
+void BFormatDec::decodeTile(const al::span<FloatBufferLine> OutBuffer, const size_t offset,
+    const al::span<const al::span<const float>> inputs, const size_t todo)
+{
+    ASSUME(todo > 0);
+    ASSUME(todo <= sTileSize);
+
+    for(const DecodeGroup &group : mDecodeGroups)
+    {
+        if(group.mRows.empty())
+            continue;
+
+        std::array<al::span<float>,sGroupSize> dsts{};
+        for(size_t j{0};j < group.mCount;++j)
+            dsts[j] = al::span{OutBuffer[group.mOutput+j]}.subspan(offset, todo);
+
+        size_t i{0};
+#ifdef HAVE_SSE_INTRINSICS
+        /* Keep the group's sums for four samples in registers while going
+         * through the inputs, and add them to the outputs at the end.
+         */
+        for(;todo-i >= 4;i += 4)
+        {
+            __m128 accum0{_mm_setzero_ps()}, accum1{_mm_setzero_ps()};
+            __m128 accum2{_mm_setzero_ps()}, accum3{_mm_setzero_ps()};
+            for(const DecodeRow &row : group.mRows)
+            {
+                const __m128 s{_mm_loadu_ps(&inputs[row.mInput][i])};
+                accum0 = _mm_add_ps(accum0, _mm_mul_ps(s, _mm_load_ps(row.mGains[0].data())));
+                accum1 = _mm_add_ps(accum1, _mm_mul_ps(s, _mm_load_ps(row.mGains[1].data())));
+                accum2 = _mm_add_ps(accum2, _mm_mul_ps(s, _mm_load_ps(row.mGains[2].data())));
+                accum3 = _mm_add_ps(accum3, _mm_mul_ps(s, _mm_load_ps(row.mGains[3].data())));
+            }
+            auto add_accum = [i](const al::span<float> dst, const __m128 accum) noexcept
+            { _mm_storeu_ps(&dst[i], _mm_add_ps(_mm_loadu_ps(&dst[i]), accum)); };
+            switch(group.mCount)
+            {
+            case 4: add_accum(dsts[3], accum3); [[fallthrough]];
+            case 3: add_accum(dsts[2], accum2); [[fallthrough]];
+            case 2: add_accum(dsts[1], accum1); [[fallthrough]];
+            case 1: add_accum(dsts[0], accum0);
+            }
+        }
+#endif
+        for(;i < todo;++i)
+        {
+            std::array<float,sGroupSize> accum{};
+            for(const DecodeRow &row : group.mRows)
+            {
+                const float s{inputs[row.mInput][i]};
+                accum[0] += s * row.mGains[0][0];
+                accum[1] += s * row.mGains[1][0];
+                accum[2] += s * row.mGains[2][0];
+                accum[3] += s * row.mGains[3][0];
+            }
+            for(size_t j{0};j < group.mCount;++j)
+                dsts[j][i] += accum[j];
+        }
+    }
+}
+
 void BFormatDec::processStablize(const al::span<FloatBufferLine> OutBuffer,
-    const al::span<const FloatBufferLine> InSamples, const size_t lidx, const size_t ridx,
-    const size_t cidx, const size_t SamplesToDo)
+    const al::span<const FloatBufferLine> InSamples, const size_t SamplesToDo)
 {
     ASSUME(SamplesToDo > 0);
 
+    const size_t lidx{mStablizer->LeftIdx};
+    const size_t ridx{mStablizer->RightIdx};
+    const size_t cidx{mStablizer->CenterIdx};
+
     /* Move the existing direct L/R signal out so it doesn't get processed by
-     * the stablizer.
+     * the stablizer. The direct side signal stays in the right channel, for
+     * the decoded side signal to be added to, and the left channel is cleared
+     * for the decoded mid signal.
      */
     const auto leftout = al::span<float>{OutBuffer[lidx]}.first(SamplesToDo);
-    const auto rightout = al::span<float>{OutBuffer[ridx]}.first(SamplesToDo);
+    const auto sideout = al::span<float>{OutBuffer[ridx]}.first(SamplesToDo);
     const al::span<float> mid{al::assume_aligned<16>(mStablizer->MidDirect.data()), SamplesToDo};
-    const al::span<float> side{al::assume_aligned<16>(mStablizer->Side.data()), SamplesToDo};
-    std::transform(leftout.cbegin(), leftout.cend(), rightout.cbegin(), mid.begin(),std::plus{});
-    std::transform(leftout.cbegin(), leftout.cend(), rightout.cbegin(), side.begin(),std::minus{});
-    std::fill_n(leftout.begin(), leftout.size(), 0.0f);
-    std::fill_n(rightout.begin(), rightout.size(), 0.0f);
-
-    /* Decode the B-Format input to OutBuffer. */
-    process(OutBuffer, InSamples, SamplesToDo);
-
-    /* Include the decoded side signal with the direct side signal. */
     for(size_t i{0};i < SamplesToDo;++i)
-        side[i] += leftout[i] - rightout[i];
+    {
+        const float left{leftout[i]}, right{sideout[i]};
+        mid[i] = left + right;
+        sideout[i] = left - right;
+        leftout[i] = 0.0f;
+    }
 
-    /* Get the decoded mid signal and band-split it. */
-    const auto tmpsamples = al::span{mStablizer->Temp}.first(SamplesToDo);
-    std::transform(leftout.cbegin(), leftout.cend(), rightout.cbegin(), tmpsamples.begin(),
-        std::plus{});
+    /* Decode the B-Format input to OutBuffer, with the mid signal going to the
+     * left channel and side going to the right.
+     */
+    process(OutBuffer, InSamples, SamplesToDo);
 
-    mStablizer->MidFilter.process(tmpsamples, mStablizer->MidHF, mStablizer->MidLF);
+    /* Band-split the decoded mid signal. */
+    mStablizer->MidFilter.process(leftout, mStablizer->MidHF, mStablizer->MidLF);
 
     /* Apply an all-pass to all channels to match the band-splitter's phase
      * shift. This is to keep the phase synchronized between the existing
-     * signal and the split mid signal.
+     * signal and the split mid signal. The left channel's filter is used for
+     * the direct mid signal, since the left channel gets overwritten.
      */
     const size_t NumChannels{OutBuffer.size()};
+    std::array<BandSplitter*,MaxOutputChannels> filters{};
+    std::array<al::span<float>,MaxOutputChannels> samples{};
     for(size_t i{0u};i < NumChannels;i++)
     {
-        /* Skip the left and right channels, which are going to get overwritten,
-         * and substitute the direct mid signal and direct+decoded side signal.
-         */
-        if(i == lidx)
-            mStablizer->ChannelFilters[i].processAllPass(mid);
-        else if(i == ridx)
-            mStablizer->ChannelFilters[i].processAllPass(side);
-        else
-            mStablizer->ChannelFilters[i].processAllPass({OutBuffer[i].data(), SamplesToDo});
+        filters[i] = &mStablizer->ChannelFilters[i];
+        samples[i] = (i == lidx) ? mid : al::span<float>{OutBuffer[i]};
     }
+    AllPassMulti(al::span{filters}.first(NumChannels), samples, SamplesToDo);
 
     /* This pans the separate low- and high-frequency signals between being on
      * the center channel and the left+right channels. The low-frequency signal
      * is panned 1/3rd toward center and the high-frequency signal is panned
-     * 1/4th toward center. These values can be tweaked.
+     * 1/4th toward center. These values can be tweaked. The gains include the
+     * 0.5 scale for recombining the mid/side signals.
      */
-    const float cos_lf{std::cos(1.0f/3.0f * (al::numbers::pi_v<float>*0.5f))};
-    const float cos_hf{std::cos(1.0f/4.0f * (al::numbers::pi_v<float>*0.5f))};
-    const float sin_lf{std::sin(1.0f/3.0f * (al::numbers::pi_v<float>*0.5f))};
-    const float sin_hf{std::sin(1.0f/4.0f * (al::numbers::pi_v<float>*0.5f))};
+    const float cos_lf{std::cos(1.0f/3.0f * (al::numbers::pi_v<float>*0.5f)) * 0.5f};
+    const float cos_hf{std::cos(1.0f/4.0f * (al::numbers::pi_v<float>*0.5f)) * 0.5f};
+    const float sin_lf{std::sin(1.0f/3.0f * (al::numbers::pi_v<float>*0.5f)) * 0.5f};
+    const float sin_hf{std::sin(1.0f/4.0f * (al::numbers::pi_v<float>*0.5f)) * 0.5f};
+    const auto midlf = al::span{mStablizer->MidLF}.first(SamplesToDo);
+    const auto midhf = al::span{mStablizer->MidHF}.first(SamplesToDo);
     const auto centerout = al::span<float>{OutBuffer[cidx]}.first(SamplesToDo);
     for(size_t i{0};i < SamplesToDo;i++)
     {
         /* Add the direct mid signal to the processed mid signal so it can be
          * properly combined with the direct+decoded side signal.
          */
-        const float m{mStablizer->MidLF[i]*cos_lf + mStablizer->MidHF[i]*cos_hf + mid[i]};
-        const float c{mStablizer->MidLF[i]*sin_lf + mStablizer->MidHF[i]*sin_hf};
-        const float s{side[i]};
+        const float m{midlf[i]*cos_lf + midhf[i]*cos_hf + mid[i]*0.5f};
+        const float c{midlf[i]*sin_lf + midhf[i]*sin_hf};
+        const float s{sideout[i]*0.5f};
 
         /* The generated center channel signal adds to the existing signal,
          * while the modified left and right channels replace.
          */
-        leftout[i] = (m + s) * 0.5f;
-        rightout[i] = (m - s) * 0.5f;
-        centerout[i] += c * 0.5f;
+        leftout[i] = m + s;
+        sideout[i] = m - s;
+        centerout[i] += c;
     }
 }
 
@@ -31,12 +31,36 @@ class BFormatDec {
         std::array<std::array<float,MaxOutputChannels>,sNumBands> mGains{};
     };
 
-    alignas(16) std::array<FloatBufferLine,2> mSamples{};
+    /* Samples are decoded in tiles small enough for all the inputs (both
+     * bands of them, with the dual-band decoder) to stay in the L1 cache.
+     */
+    static constexpr size_t sTileSize{64};
+    static constexpr size_t sGroupSize{4};
+
+    /* The decode matrix, packed for groups of sGroupSize outputs. Each row
+     * holds an input's gains for the group, with each gain repeated across a
+     * SIMD vector, and inputs that are silent for the group are left out.
+     */
+    struct DecodeRow {
+        size_t mInput;
+        alignas(16) std::array<std::array<float,4>,sGroupSize> mGains;
+    };
+    struct DecodeGroup {
+        size_t mOutput;
+        size_t mCount;
+        std::vector<DecodeRow> mRows;
+    };
+    std::vector<DecodeGroup> mDecodeGroups;
+
+    alignas(16) std::array<std::array<float,sTileSize>,MaxAmbiChannels*sNumBands> mTiles{};
 
     const std::unique_ptr<FrontStablizer> mStablizer;
 
     std::variant<std::vector<ChannelDecoderSingle>,std::vector<ChannelDecoderDual>> mChannelDec;
 
+    void decodeTile(const al::span<FloatBufferLine> OutBuffer, const size_t offset,
+        const al::span<const al::span<const float>> inputs, const size_t todo);
+
 public:
     BFormatDec(const size_t inchans, const al::span<const ChannelDec> coeffs,
         const al::span<const ChannelDec> coeffslf, const float xover_f0norm,
@@ -48,10 +72,12 @@ public:
     void process(const al::span<FloatBufferLine> OutBuffer,
         const al::span<const FloatBufferLine> InSamples, const size_t SamplesToDo);
 
-    /* Decodes the ambisonic input to the given output channels with stablization. */
+    /* Decodes the ambisonic input to the given output channels with
+     * stablization. A decoder with a stablizer must use this instead of
+     * process, as its decode matrix is set up for it.
+     */
     void processStablize(const al::span<FloatBufferLine> OutBuffer,
-        const al::span<const FloatBufferLine> InSamples, const size_t lidx, const size_t ridx,
-        const size_t cidx, const size_t SamplesToDo);
+        const al::span<const FloatBufferLine> InSamples, const size_t SamplesToDo);
 
     static std::unique_ptr<BFormatDec> Create(const size_t inchans,
         const al::span<const ChannelDec> coeffs, const al::span<const ChannelDec> coeffslf,
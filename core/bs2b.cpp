@@ -28,6 +28,10 @@
 #include <iterator>
 #include <stdexcept>
 
+#ifdef HAVE_SSE_INTRINSICS
+#include <xmmintrin.h>
+#endif
+
 #include "alnumbers.h"
 #include "alspan.h"
 #include "bs2b.h"
@@ -137,6 +141,59 @@ void bs2b::cross_feed(float *Left, float *Right, size_t SamplesToDo)
     al::span<float> lsamples{Left, SamplesToDo};
     al::span<float> rsamples{Right, SamplesToDo};
 
+#ifdef HAVE_SSE_INTRINSICS
+    if(const size_t todo{SamplesToDo & ~size_t{3}})
+    {
+        /* Run all four filters together, one per lane: the left high-boost,
+         * left low-pass, right low-pass, and right high-boost. The left output
+         * is then the sum of the first and third lanes, and the right output
+         * the sum of the second and fourth. The low-pass has no feed-forward
+         * history coefficient, so it gets 0 there.
+         */
+        const __m128 a0{_mm_setr_ps(a0hi, a0lo, a0lo, a0hi)};
+        const __m128 a1{_mm_setr_ps(a1hi, 0.0f, 0.0f, a1hi)};
+        const __m128 b1{_mm_setr_ps(b1hi, b1lo, b1lo, b1hi)};
+        __m128 z{_mm_setr_ps(history[0].hi, history[0].lo, history[1].lo, history[1].hi)};
+        auto filter = [a0,a1,b1,&z](const __m128 x) noexcept -> __m128
+        {
+            const __m128 y{_mm_add_ps(_mm_mul_ps(a0, x), z)};
+            z = _mm_add_ps(_mm_mul_ps(a1, x), _mm_mul_ps(b1, y));
+            /* Add the upper lanes (the right input's filters) to the lower
+             * lanes, giving the left and right output.
+             */
+            return _mm_add_ps(y, _mm_movehl_ps(y, y));
+        };
+
+        for(size_t i{0};i < todo;i += 4)
+        {
+            const __m128 left{_mm_loadu_ps(&lsamples[i])};
+            const __m128 right{_mm_loadu_ps(&rsamples[i])};
+            const __m128 lr01{_mm_unpacklo_ps(left, right)};
+            const __m128 lr23{_mm_unpackhi_ps(left, right)};
+
+            const __m128 out0{filter(_mm_shuffle_ps(lr01, lr01, _MM_SHUFFLE(1,1,0,0)))};
+            const __m128 out1{filter(_mm_shuffle_ps(lr01, lr01, _MM_SHUFFLE(3,3,2,2)))};
+            const __m128 out2{filter(_mm_shuffle_ps(lr23, lr23, _MM_SHUFFLE(1,1,0,0)))};
+            const __m128 out3{filter(_mm_shuffle_ps(lr23, lr23, _MM_SHUFFLE(3,3,2,2)))};
+
+            const __m128 out01{_mm_movelh_ps(out0, out1)};
+            const __m128 out23{_mm_movelh_ps(out2, out3)};
+            _mm_storeu_ps(&lsamples[i], _mm_shuffle_ps(out01, out23, _MM_SHUFFLE(2,0,2,0)));
+            _mm_storeu_ps(&rsamples[i], _mm_shuffle_ps(out01, out23, _MM_SHUFFLE(3,1,3,1)));
+        }
+
+        alignas(16) std::array<float,4> zvals{};
+        _mm_store_ps(zvals.data(), z);
+        history[0].hi = zvals[0];
+        history[0].lo = zvals[1];
+        history[1].lo = zvals[2];
+        history[1].hi = zvals[3];
+
+        lsamples = lsamples.subspan(todo);
+        rsamples = rsamples.subspan(todo);
+    }
+#endif
+
     while(!lsamples.empty())
     {
         const size_t todo{std::min(samples.size(), lsamples.size())};
@@ -282,9 +282,6 @@ struct BSincFilterArray {
     [[nodiscard]] constexpr auto getTable() const noexcept { return al::span{mTable}; }
 };
 
-const BSincFilterArray<bsinc12_hdr> bsinc12_filter{};
-const BSincFilterArray<bsinc24_hdr> bsinc24_filter{};
-
 template<typename T>
 constexpr BSincTable GenerateBSincTable(const T &filter)
 {
@@ -303,5 +300,16 @@ constexpr BSincTable GenerateBSincTable(const T &filter)
 
 } // namespace
 
-const BSincTable gBSinc12{GenerateBSincTable(bsinc12_filter)};
-const BSincTable gBSinc24{GenerateBSincTable(bsinc24_filter)};
+auto GetBSinc12Table() -> const BSincTable&
+{
+    static const BSincFilterArray<bsinc12_hdr> bsinc12_filter{};
+    static const BSincTable bsinc12{GenerateBSincTable(bsinc12_filter)};
+    return bsinc12;
+}
+
+auto GetBSinc24Table() -> const BSincTable&
+{
+    static const BSincFilterArray<bsinc24_hdr> bsinc24_filter{};
+    static const BSincTable bsinc24{GenerateBSincTable(bsinc24_filter)};
+    return bsinc24;
+}
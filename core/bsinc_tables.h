@@ -14,7 +14,11 @@ struct BSincTable {
     al::span<const float> Tab;
 };
 
-extern const BSincTable gBSinc12;
-extern const BSincTable gBSinc24;
+/* The tables are generated on first use, which takes some time. They should
+ * be gotten once a resampler is selected, so it isn't done in the mixer (see
+ * PrepareResamplerTables).
+ */
+auto GetBSinc12Table() -> const BSincTable&;
+auto GetBSinc24Table() -> const BSincTable&;
 
 #endif /* CORE_BSINC_TABLES_H */
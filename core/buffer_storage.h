@@ -1,6 +1,7 @@
 #ifndef CORE_BUFFER_STORAGE_H
 #define CORE_BUFFER_STORAGE_H
 
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 
@@ -39,6 +40,8 @@ using CallbackType = int(*)(void*, void*, int);
 struct BufferStorage {
     CallbackType mCallback{nullptr};
     void *mUserData{nullptr};
+    /* The minimum number of blocks to request from the callback at once. */
+    uint mCallbackRequest{0u};
 
     al::span<std::byte> mData;
 
@@ -52,6 +55,15 @@ struct BufferStorage {
     AmbiScaling mAmbiScaling{AmbiScaling::FuMa};
     uint mAmbiOrder{0u};
 
+    /* An optional copy of compressed sample data pre-decoded to interleaved
+     * 16-bit samples, or of UHJ sample data pre-decoded to interleaved float
+     * B-Format (FuMa ordering and UHJ scaling). When set, voices mix from this
+     * instead of decoding mData each update.
+     */
+    al::span<std::byte> mDecodedData;
+    bool mIsDecoded{false};
+    bool mIsUhjDecoded{false};
+
     [[nodiscard]] auto bytesFromFmt() const noexcept -> uint { return BytesFromFmt(mType); }
     [[nodiscard]] auto channelsFromFmt() const noexcept -> uint
     { return ChannelsFromFmt(mChannels, mAmbiOrder); }
@@ -62,9 +74,24 @@ struct BufferStorage {
     {
         if(mType == FmtIMA4) return ((mBlockAlign-1)/2 + 4) * channelsFromFmt();
         if(mType == FmtMSADPCM) return ((mBlockAlign-2)/2 + 7) * channelsFromFmt();
+        if(mType == FmtIMA2) return ((mBlockAlign-1)/4 + 4) * channelsFromFmt();
         return frameSizeFromFmt();
     };
 
+    /* The sample data and format voices should mix with, which is the
+     * decoded copy if there is one.
+     */
+    [[nodiscard]] auto mixData() const noexcept -> al::span<std::byte>
+    { return mIsDecoded ? mDecodedData : mData; }
+    [[nodiscard]] auto mixType() const noexcept -> FmtType
+    { return !mIsDecoded ? mType : mIsUhjDecoded ? FmtFloat : FmtShort; }
+    [[nodiscard]] auto mixChannels() const noexcept -> uint
+    { return mIsUhjDecoded ? std::max(channelsFromFmt(), 3u) : channelsFromFmt(); }
+    [[nodiscard]] auto mixBlockAlign() const noexcept -> uint
+    { return mIsDecoded ? 1u : mBlockAlign; }
+    [[nodiscard]] auto mixBlockSize() const noexcept -> uint
+    { return mIsDecoded ? mixChannels()*BytesFromFmt(mixType()) : blockSizeFromFmt(); }
+
     [[nodiscard]] auto isBFormat() const noexcept -> bool { return IsBFormat(mChannels); }
 };
 
@@ -7,9 +7,11 @@
 
 /* Size for temporary storage of buffer data, in floats. Larger values need
  * more memory and are harder on cache, while smaller values may need more
- * iterations for mixing.
+ * iterations for mixing. Set at build time with ALSOFT_BUFFER_LINE_SIZE.
  */
-inline constexpr size_t BufferLineSize{1024};
+inline constexpr size_t BufferLineSize{ALSOFT_BUFFER_LINE_SIZE};
+static_assert(BufferLineSize >= 64 && (BufferLineSize&(BufferLineSize-1)) == 0,
+    "BufferLineSize must be a power of 2, no less than 64");
 
 using FloatBufferLine = std::array<float,BufferLineSize>;
 using FloatBufferSpan = al::span<float,BufferLineSize>;
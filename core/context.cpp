@@ -1,17 +1,22 @@
 
 #include "config.h"
 
+#include <algorithm>
 #include <cassert>
 #include <functional>
 #include <limits>
 #include <memory>
 #include <stdexcept>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 
+#include "alnumeric.h"
 #include "async_event.h"
 #include "context.h"
 #include "device.h"
 #include "effectslot.h"
+#include "helpers.h"
 #include "logging.h"
 #include "ringbuffer.h"
 #include "voice.h"
@@ -22,6 +27,20 @@
 static_assert(std::atomic<ContextBase::AsyncEventBitset>::is_always_lock_free, "atomic<bitset> isn't lock-free");
 #endif
 
+auto TransformToListener(const alu::Matrix &matrix, const alu::Vector &vec) noexcept
+    -> alu::Vector
+{
+    /* The same as matrix*vec, written out since the operator is too large to
+     * be inlined.
+     */
+    return alu::Vector{
+        vec[0]*matrix[0][0] + vec[1]*matrix[1][0] + vec[2]*matrix[2][0] + vec[3]*matrix[3][0],
+        vec[0]*matrix[0][1] + vec[1]*matrix[1][1] + vec[2]*matrix[2][1] + vec[3]*matrix[3][1],
+        vec[0]*matrix[0][2] + vec[1]*matrix[1][2] + vec[2]*matrix[2][2] + vec[3]*matrix[3][2],
+        vec[0]*matrix[0][3] + vec[1]*matrix[1][3] + vec[2]*matrix[2][3] + vec[3]*matrix[3][3]};
+}
+
+
 ContextBase::ContextBase(DeviceBase *device) : mDevice{device}
 { assert(mEnabledEvts.is_lock_free()); }
 
@@ -29,6 +48,7 @@ ContextBase::~ContextBase()
 {
     mActiveAuxSlots.store(nullptr, std::memory_order_relaxed);
     mVoices.store(nullptr, std::memory_order_relaxed);
+    mFreeVoiceMask.store(nullptr, std::memory_order_relaxed);
 
     if(mAsyncEvents)
     {
@@ -53,11 +73,57 @@ ContextBase::~ContextBase()
 }
 
 
+template<typename T>
+auto ContextBase::newCluster(MemoryUsage::Counter counter) -> ClusterPtr<T>
+{
+    const std::shared_ptr<MemoryUsage> &usage = mDevice->mMemory;
+
+    void *ptr{mClusterMemoryFree.data()};
+    size_t space{mClusterMemoryFree.size()};
+    if(std::align(alignof(T), sizeof(T), ptr, space))
+    {
+        const auto offset = mClusterMemoryFree.size() - space;
+        mClusterMemoryFree = mClusterMemoryFree.subspan(offset + sizeof(T));
+        auto ret = ClusterPtr<T>{::new(ptr) T{}, ClusterDeleter<T>{true, usage, counter}};
+        usage->add(counter, sizeof(T));
+        return ret;
+    }
+    auto ret = ClusterPtr<T>{new T{}, ClusterDeleter<T>{false, usage, counter}};
+    usage->add(counter, sizeof(T));
+    return ret;
+}
+
+void ContextBase::reserveClusters(size_t numvoices, size_t numslots)
+{
+    if(mClusterMemory)
+        return;
+
+    size_t total{0};
+    auto add_clusters = [&total](auto *cluster, size_t count)
+    {
+        using cluster_t = std::remove_pointer_t<decltype(cluster)>;
+        const size_t num{(count + std::tuple_size_v<cluster_t>-1) / std::tuple_size_v<cluster_t>};
+        total += num * (sizeof(cluster_t) + alignof(cluster_t)-1);
+    };
+    /* Each voice may have a property update and a voice change in flight. */
+    add_clusters(static_cast<VoiceCluster::element_type*>(nullptr), numvoices);
+    add_clusters(static_cast<VoicePropsCluster::element_type*>(nullptr), numvoices);
+    add_clusters(static_cast<VoiceChangeCluster::element_type*>(nullptr), numvoices);
+    add_clusters(static_cast<EffectSlotCluster::element_type*>(nullptr), numslots);
+    add_clusters(static_cast<EffectSlotPropsCluster::element_type*>(nullptr), numslots);
+    add_clusters(static_cast<ContextPropsCluster::element_type*>(nullptr), 2);
+
+    TRACE("Reserving %zu bytes for %zu voices and %zu effect slots\n", total, numvoices,
+        numslots);
+    mClusterMemory = std::make_unique<std::byte[]>(total);
+    mClusterMemoryFree = {mClusterMemory.get(), total};
+}
+
 void ContextBase::allocVoiceChanges()
 {
     static constexpr size_t clustersize{std::tuple_size_v<VoiceChangeCluster::element_type>};
 
-    VoiceChangeCluster clusterptr{std::make_unique<VoiceChangeCluster::element_type>()};
+    auto clusterptr = newCluster<VoiceChangeCluster::element_type>(MemoryUsage::Voices);
     const auto cluster = al::span{*clusterptr};
 
     for(size_t i{1};i < clustersize;++i)
@@ -75,17 +141,13 @@ void ContextBase::allocVoiceProps()
     TRACE("Increasing allocated voice properties to %zu\n",
         (mVoicePropClusters.size()+1) * clustersize);
 
-    auto clusterptr = std::make_unique<VoicePropsCluster::element_type>();
+    auto clusterptr = newCluster<VoicePropsCluster::element_type>(MemoryUsage::Props);
     auto cluster = al::span{*clusterptr};
     for(size_t i{1};i < clustersize;++i)
         cluster[i-1].next.store(std::addressof(cluster[i]), std::memory_order_relaxed);
     mVoicePropClusters.emplace_back(std::move(clusterptr));
 
-    VoicePropsItem *oldhead{mFreeVoiceProps.load(std::memory_order_acquire)};
-    do {
-        mVoicePropClusters.back()->back().next.store(oldhead, std::memory_order_relaxed);
-    } while(mFreeVoiceProps.compare_exchange_weak(oldhead, mVoicePropClusters.back()->data(),
-        std::memory_order_acq_rel, std::memory_order_acquire) == false);
+    mFreeVoiceProps.push(&cluster.front(), &cluster.back());
 }
 
 void ContextBase::allocVoices(size_t addcount)
@@ -103,23 +165,134 @@ void ContextBase::allocVoices(size_t addcount)
 
     if(addcount >= std::numeric_limits<int>::max()/clustersize - mVoiceClusters.size())
         throw std::runtime_error{"Allocating too many voices"};
-    const size_t totalcount{(mVoiceClusters.size()+addcount) * clustersize};
+    const size_t oldcount{mVoiceClusters.size() * clustersize};
+    const size_t totalcount{oldcount + addcount*clustersize};
     TRACE("Increasing allocated voices to %zu\n", totalcount);
 
     while(addcount)
     {
-        mVoiceClusters.emplace_back(std::make_unique<VoiceCluster::element_type>());
+        mVoiceClusters.emplace_back(newCluster<VoiceCluster::element_type>(MemoryUsage::Voices));
         --addcount;
     }
 
-    auto newarray = VoiceArray::Create(totalcount);
-    auto voice_iter = newarray->begin();
-    for(VoiceCluster &cluster : mVoiceClusters)
-        voice_iter = std::transform(cluster->begin(), cluster->end(), voice_iter,
-            [](Voice &voice) noexcept -> Voice* { return &voice; });
+    auto store_voices = [this](const al::span<Voice*> dst, size_t idx)
+    {
+        auto voice_iter = dst.begin();
+        for(VoiceCluster &cluster : al::span{mVoiceClusters}.subspan(idx / clustersize))
+        {
+            for(Voice &voice : *cluster)
+            {
+                voice.mVoiceIdx = static_cast<uint>(idx++);
+                *(voice_iter++) = &voice;
+            }
+        }
+    };
+
+    /* If the existing array still holds the existing voices and has room,
+     * the new voices are added in place. The mixer won't look at them until
+     * the active voice count includes them.
+     */
+    VoiceArray *curvoices{mVoices.load(std::memory_order_relaxed)};
+    if(curvoices && oldcount == mAllocatedVoiceCount && totalcount <= (curvoices->size()>>1))
+    {
+        store_voices(al::span{*curvoices}.subspan(oldcount, totalcount-oldcount), oldcount);
+        mAllocatedVoiceCount = totalcount;
+        return;
+    }
 
+    /* Otherwise make a new array, at least doubling the room so a growing
+     * voice count doesn't need to keep replacing it.
+     */
+    const size_t capacity{std::max(totalcount, curvoices ? curvoices->size() : 0_uz)};
+    auto newarray = VoiceArray::Create(capacity*2);
+    std::fill(newarray->begin(), newarray->end(), nullptr);
+    store_voices(al::span{*newarray}.first(totalcount), 0);
+
+    /* No voices are marked free until the mixer updates the mask. */
+    auto newmask = VoiceMaskArray::Create((capacity+63) / 64);
+    for(auto &mask : *newmask)
+        mask.store(0, std::memory_order_relaxed);
+
+    /* The mask is set first, so the mixer won't see a mask that's smaller
+     * than the voice array.
+     */
+    auto oldmask = mFreeVoiceMask.exchange(std::move(newmask), std::memory_order_acq_rel);
     if(auto oldvoices = mVoices.exchange(std::move(newarray), std::memory_order_acq_rel))
         std::ignore = mDevice->waitForMix();
+    mAllocatedVoiceCount = totalcount;
+}
+
+
+void ContextBase::syncMixVoices() noexcept
+{
+    VoiceArray *voicearray{mVoices.load(std::memory_order_acquire)};
+    const size_t count{std::min(mActiveVoiceCount.load(std::memory_order_acquire),
+        voicearray->size()>>1)};
+    auto *freemask = mFreeVoiceMask.load(std::memory_order_acquire);
+
+    const auto voices = al::span{*voicearray}.first(count);
+    if(voicearray != mMixVoiceArray)
+    {
+        /* The back half of a new array is uninitialized, so rebuild the list
+         * from all the active voices.
+         */
+        for(Voice *voice : voices)
+            voice->mMixListed = false;
+        mMixVoiceArray = voicearray;
+        mMixVoiceCount = 0;
+        mNumMixVoices = 0;
+    }
+
+    for(Voice *voice : voices.subspan(std::min(mMixVoiceCount, count)))
+    {
+        if(voice->mPlayState.load(std::memory_order_relaxed) != Voice::Stopped
+            || voice->mSourceID.load(std::memory_order_relaxed) != 0u)
+            addMixVoice(voice);
+        else if(freemask)
+        {
+            const uint idx{voice->mVoiceIdx};
+            (*freemask)[idx>>6].fetch_or(1_u64 << (idx&63), std::memory_order_relaxed);
+        }
+    }
+    mMixVoiceCount = std::max(mMixVoiceCount, count);
+}
+
+void ContextBase::addMixVoice(Voice *voice) noexcept
+{
+    const auto mixlist = al::span{*mMixVoiceArray}.subspan(mMixVoiceArray->size()>>1);
+    if(voice->mMixListed || mNumMixVoices >= mixlist.size()) UNLIKELY
+        return;
+
+    voice->mMixListed = true;
+    mixlist[mNumMixVoices++] = voice;
+
+    if(auto *freemask = mFreeVoiceMask.load(std::memory_order_relaxed))
+    {
+        const uint idx{voice->mVoiceIdx};
+        (*freemask)[idx>>6].fetch_and(~(1_u64 << (idx&63)), std::memory_order_relaxed);
+    }
+}
+
+void ContextBase::compactMixVoices() noexcept
+{
+    auto *freemask = mFreeVoiceMask.load(std::memory_order_relaxed);
+    auto is_unused = [freemask](Voice *voice) noexcept -> bool
+    {
+        if(voice->mPlayState.load(std::memory_order_relaxed) != Voice::Stopped
+            || voice->mSourceID.load(std::memory_order_relaxed) != 0u)
+            return false;
+
+        voice->mMixListed = false;
+        if(freemask)
+        {
+            const uint idx{voice->mVoiceIdx};
+            (*freemask)[idx>>6].fetch_or(1_u64 << (idx&63), std::memory_order_relaxed);
+        }
+        return true;
+    };
+    const auto voices = getMixVoices();
+    const auto end = std::remove_if(voices.begin(), voices.end(), is_unused);
+    mNumMixVoices = static_cast<size_t>(std::distance(voices.begin(), end));
 }
 
 
@@ -130,17 +303,13 @@ void ContextBase::allocEffectSlotProps()
     TRACE("Increasing allocated effect slot properties to %zu\n",
         (mEffectSlotPropClusters.size()+1) * clustersize);
 
-    auto clusterptr = std::make_unique<EffectSlotPropsCluster::element_type>();
+    auto clusterptr = newCluster<EffectSlotPropsCluster::element_type>(MemoryUsage::Props);
     auto cluster = al::span{*clusterptr};
     for(size_t i{1};i < clustersize;++i)
         cluster[i-1].next.store(std::addressof(cluster[i]), std::memory_order_relaxed);
-    auto *newcluster = mEffectSlotPropClusters.emplace_back(std::move(clusterptr)).get();
+    mEffectSlotPropClusters.emplace_back(std::move(clusterptr));
 
-    EffectSlotProps *oldhead{mFreeEffectSlotProps.load(std::memory_order_acquire)};
-    do {
-        newcluster->back().next.store(oldhead, std::memory_order_relaxed);
-    } while(mFreeEffectSlotProps.compare_exchange_weak(oldhead, newcluster->data(),
-        std::memory_order_acq_rel, std::memory_order_acquire) == false);
+    mFreeEffectSlotProps.push(&cluster.front(), &cluster.back());
 }
 
 EffectSlot *ContextBase::getEffectSlot()
@@ -153,7 +322,7 @@ EffectSlot *ContextBase::getEffectSlot()
         if(iter != cluster.end()) return al::to_address(iter);
     }
 
-    auto clusterptr = std::make_unique<EffectSlotCluster::element_type>();
+    auto clusterptr = newCluster<EffectSlotCluster::element_type>(MemoryUsage::Effects);
     if(1 >= std::numeric_limits<int>::max()/clusterptr->size() - mEffectSlotClusters.size())
         throw std::runtime_error{"Allocating too many effect slots"};
     const size_t totalcount{(mEffectSlotClusters.size()+1) * clusterptr->size()};
@@ -163,6 +332,23 @@ EffectSlot *ContextBase::getEffectSlot()
     return mEffectSlotClusters.back()->data();
 }
 
+void ContextBase::allocEffectSlots(size_t count)
+{
+    static constexpr size_t clustersize{std::tuple_size_v<EffectSlotCluster::element_type>};
+    /* Convert element count to cluster count. */
+    count = (count+(clustersize-1)) / clustersize;
+    if(count <= mEffectSlotClusters.size())
+        return;
+
+    if(count >= std::numeric_limits<int>::max()/clustersize)
+        throw std::runtime_error{"Allocating too many effect slots"};
+    TRACE("Increasing allocated effect slots to %zu\n", count*clustersize);
+
+    mEffectSlotClusters.reserve(count);
+    while(mEffectSlotClusters.size() < count)
+        mEffectSlotClusters.emplace_back(newCluster<EffectSlotCluster::element_type>(MemoryUsage::Effects));
+}
+
 
 void ContextBase::allocContextProps()
 {
@@ -171,15 +357,42 @@ void ContextBase::allocContextProps()
     TRACE("Increasing allocated context properties to %zu\n",
         (mContextPropClusters.size()+1) * clustersize);
 
-    auto clusterptr = std::make_unique<ContextPropsCluster::element_type>();
+    auto clusterptr = newCluster<ContextPropsCluster::element_type>(MemoryUsage::Props);
     auto cluster = al::span{*clusterptr};
     for(size_t i{1};i < clustersize;++i)
         cluster[i-1].next.store(std::addressof(cluster[i]), std::memory_order_relaxed);
-    auto *newcluster = mContextPropClusters.emplace_back(std::move(clusterptr)).get();
+    mContextPropClusters.emplace_back(std::move(clusterptr));
+
+    mFreeContextProps.push(&cluster.front(), &cluster.back());
+}
 
-    ContextProps *oldhead{mFreeContextProps.load(std::memory_order_acquire)};
-    do {
-        newcluster->back().next.store(oldhead, std::memory_order_relaxed);
-    } while(mFreeContextProps.compare_exchange_weak(oldhead, newcluster->data(),
-        std::memory_order_acq_rel, std::memory_order_acquire) == false);
+
+bool ContextBase::lockMixerMemory()
+{
+    auto lock_clusters = [](auto&& clusters) -> bool
+    {
+        bool ok{true};
+        for(auto &cluster : clusters)
+            ok &= LockMemoryRange(cluster.get(), sizeof(*cluster));
+        return ok;
+    };
+
+    bool ok{lock_clusters(mVoiceChangeClusters)};
+    ok &= lock_clusters(mVoiceClusters);
+    ok &= lock_clusters(mVoicePropClusters);
+    ok &= lock_clusters(mEffectSlotClusters);
+    ok &= lock_clusters(mEffectSlotPropClusters);
+    ok &= lock_clusters(mContextPropClusters);
+    if(auto *voices = mVoices.load(std::memory_order_relaxed))
+        ok &= LockMemoryRange(voices->data(), voices->size()*sizeof(Voice*));
+    for(auto &cluster : mEffectSlotClusters)
+    {
+        for(EffectSlot &slot : *cluster)
+        {
+            if(!slot.mWetBuffer.empty())
+                ok &= LockMemoryRange(slot.mWetBuffer.data(),
+                    slot.mWetBuffer.size()*sizeof(slot.mWetBuffer[0]));
+        }
+    }
+    return ok;
 }
@@ -5,8 +5,8 @@
 #include <atomic>
 #include <bitset>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
-#include <thread>
 #include <vector>
 
 #include "almalloc.h"
@@ -15,6 +15,7 @@
 #include "async_event.h"
 #include "atomic.h"
 #include "flexarray.h"
+#include "memusage.h"
 #include "opthelpers.h"
 #include "vecmat.h"
 
@@ -31,6 +32,11 @@ inline constexpr float SpeedOfSoundMetersPerSec{343.3f};
 
 inline constexpr float AirAbsorbGainHF{0.99426f}; /* -0.05dB */
 
+/* The most listeners a context can render for. The first is the normal
+ * listener, and any others each mix their direct path to a pair of outputs.
+ */
+inline constexpr std::size_t MaxListenerCount{4};
+
 enum class DistanceModel : unsigned char {
     Disable,
     Inverse, InverseClamped,
@@ -56,6 +62,15 @@ struct ContextProps {
     bool SourceDistanceModel;
     DistanceModel mDistanceModel;
 
+    struct ListenerProps {
+        std::array<float,3> Position;
+        std::array<float,3> OrientAt;
+        std::array<float,3> OrientUp;
+        float Gain;
+        std::array<int,2> Output;
+    };
+    std::array<ListenerProps,MaxListenerCount-1> ExtraListeners;
+
     std::atomic<ContextProps*> next;
 };
 
@@ -76,7 +91,44 @@ struct ContextParams {
 
     bool SourceDistanceModel{false};
     DistanceModel mDistanceModel{};
+
+    struct ListenerParams {
+        alu::Vector Position{};
+        alu::Matrix Matrix{alu::Matrix::Identity()};
+        float Gain{1.0f};
+        /* The real output channels mixed to, with InvalidChannelIndex for
+         * none.
+         */
+        std::array<uint,2> Output{};
+    };
+    std::array<ListenerParams,MaxListenerCount-1> ExtraListeners;
+};
+
+/* Transforms a vector by a listener's orientation matrix, for the functions
+ * that calculate source and effect parameters for each listener.
+ */
+auto TransformToListener(const alu::Matrix &matrix, const alu::Vector &vec) noexcept
+    -> alu::Vector;
+
+/* Deletes a context's storage cluster, which is only destroyed in place if it
+ * was constructed in the context's reserved cluster memory, and removes it
+ * from the device's memory usage.
+ */
+template<typename T>
+struct ClusterDeleter {
+    bool mReserved{false};
+    std::shared_ptr<MemoryUsage> mUsage;
+    MemoryUsage::Counter mCounter{};
+
+    void operator()(gsl::owner<T*> cluster) const noexcept
+    {
+        if(mUsage) mUsage->sub(mCounter, sizeof(T));
+        if(mReserved) std::destroy_at(cluster);
+        else delete cluster;
+    }
 };
+template<typename T>
+using ClusterPtr = std::unique_ptr<T,ClusterDeleter<T>>;
 
 struct ContextBase {
     DeviceBase *const mDevice;
@@ -90,12 +142,13 @@ struct ContextBase {
 
     float mGainBoost{1.0f};
 
-    /* Linked lists of unused property containers, free to use for future
-     * updates.
+    /* Lists of unused property containers, free to use for future updates.
+     * The mixer gives containers back, and API calls take them while holding
+     * the relevant lock.
      */
-    std::atomic<ContextProps*> mFreeContextProps{nullptr};
-    std::atomic<VoicePropsItem*> mFreeVoiceProps{nullptr};
-    std::atomic<EffectSlotProps*> mFreeEffectSlotProps{nullptr};
+    al::FreeList<ContextProps> mFreeContextProps;
+    al::FreeList<VoicePropsItem> mFreeVoiceProps;
+    al::FreeList<EffectSlotProps> mFreeEffectSlotProps;
 
     /* The voice change tail is the beginning of the "free" elements, up to and
      * *excluding* the current. If tail==current, there's no free elements and
@@ -113,8 +166,20 @@ struct ContextBase {
     ContextParams mParams;
 
     using VoiceArray = al::FlexArray<Voice*>;
+    /* This array is split in half. The front half holds the allocated voices,
+     * with room to add more without replacing the array, and the back half is
+     * the mixer's list of voices in use.
+     */
     al::atomic_unique_ptr<VoiceArray> mVoices{};
     std::atomic<size_t> mActiveVoiceCount{};
+    size_t mAllocatedVoiceCount{0u};
+
+    /* A bit for each voice the mixer last saw as stopped and without a source,
+     * as a hint for quickly finding unused voices. It's only a hint, since
+     * voices may be taken or freed after the mixer updates it.
+     */
+    using VoiceMaskArray = al::FlexArray<std::atomic<uint64_t>>;
+    al::atomic_unique_ptr<VoiceMaskArray> mFreeVoiceMask{};
 
     void allocVoices(size_t addcount);
     [[nodiscard]] auto getVoicesSpan() const noexcept -> al::span<Voice*>
@@ -128,6 +193,28 @@ struct ContextBase {
             mActiveVoiceCount.load(std::memory_order_acquire)};
     }
 
+    /* Mixer-side state for the list of voices in use. Voices are added when a
+     * voice change is processed for them, and removed once they're stopped
+     * without a source, so the mixer only goes over the voices that may be
+     * playing.
+     */
+    VoiceArray *mMixVoiceArray{nullptr};
+    size_t mMixVoiceCount{0u};
+    size_t mNumMixVoices{0u};
+
+    /** Picks up a replaced voice array and newly activated voices. */
+    void syncMixVoices() noexcept;
+    void addMixVoice(Voice *voice) noexcept;
+    /**
+     * Removes unused voices from the mixer's list, and marks them in the free
+     * voice mask.
+     */
+    void compactMixVoices() noexcept;
+    [[nodiscard]] auto getMixVoices() const noexcept -> al::span<Voice*>
+    {
+        return al::span{*mMixVoiceArray}.subspan(mMixVoiceArray->size()>>1, mNumMixVoices);
+    }
+
 
     using EffectSlotArray = al::FlexArray<EffectSlot*>;
     /* This array is split in half. The front half is the list of activated
@@ -136,8 +223,8 @@ struct ContextBase {
      */
     al::atomic_unique_ptr<EffectSlotArray> mActiveAuxSlots;
 
-    std::thread mEventThread;
-    al::semaphore mEventSem;
+    /* Posted when events are written, for the thread dispatching them. */
+    al::semaphore *mEventSem{nullptr};
     std::unique_ptr<RingBuffer> mAsyncEvents;
     using AsyncEventBitset = std::bitset<al::to_underlying(AsyncEnableBits::Count)>;
     std::atomic<AsyncEventBitset> mEnabledEvts{0u};
@@ -147,30 +234,49 @@ struct ContextBase {
      * However, to avoid allocating each object individually, they're allocated
      * in clusters that are stored in a vector for easy automatic cleanup.
      */
-    using VoiceChangeCluster = std::unique_ptr<std::array<VoiceChange,128>>;
+    /* Memory reserved when the context is created, so the clusters expected
+     * to be needed are laid out together in one block. Clusters are taken
+     * from it in order until it runs out, and aren't given back. It must
+     * outlive the clusters, so it's declared before them.
+     */
+    std::unique_ptr<std::byte[]> mClusterMemory;
+    al::span<std::byte> mClusterMemoryFree;
+
+    void reserveClusters(size_t numvoices, size_t numslots);
+    template<typename T>
+    auto newCluster(MemoryUsage::Counter counter) -> ClusterPtr<T>;
+
+    using VoiceChangeCluster = ClusterPtr<std::array<VoiceChange,128>>;
     std::vector<VoiceChangeCluster> mVoiceChangeClusters;
 
-    using VoiceCluster = std::unique_ptr<std::array<Voice,32>>;
+    using VoiceCluster = ClusterPtr<std::array<Voice,32>>;
     std::vector<VoiceCluster> mVoiceClusters;
 
-    using VoicePropsCluster = std::unique_ptr<std::array<VoicePropsItem,32>>;
+    using VoicePropsCluster = ClusterPtr<std::array<VoicePropsItem,32>>;
     std::vector<VoicePropsCluster> mVoicePropClusters;
 
 
     EffectSlot *getEffectSlot();
+    void allocEffectSlots(size_t count);
 
-    using EffectSlotCluster = std::unique_ptr<std::array<EffectSlot,4>>;
+    using EffectSlotCluster = ClusterPtr<std::array<EffectSlot,4>>;
     std::vector<EffectSlotCluster> mEffectSlotClusters;
 
-    using EffectSlotPropsCluster = std::unique_ptr<std::array<EffectSlotProps,4>>;
+    using EffectSlotPropsCluster = ClusterPtr<std::array<EffectSlotProps,4>>;
     std::vector<EffectSlotPropsCluster> mEffectSlotPropClusters;
 
     /* This could be greater than 2, but there should be no way there can be
      * more than two context property updates in use simultaneously.
      */
-    using ContextPropsCluster = std::unique_ptr<std::array<ContextProps,2>>;
+    using ContextPropsCluster = ClusterPtr<std::array<ContextProps,2>>;
     std::vector<ContextPropsCluster> mContextPropClusters;
 
+    /**
+     * Locks the currently allocated mixer-side storage (voices, effect slots,
+     * and property updates) into memory. Returns false if any failed.
+     */
+    bool lockMixerMemory();
+
 
     ContextBase(DeviceBase *device);
     ContextBase(const ContextBase&) = delete;
@@ -4,12 +4,18 @@
 #include "converter.h"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <iterator>
 #include <climits>
+#include <limits>
+
+#ifdef HAVE_SSE_INTRINSICS
+#include <emmintrin.h>
+#endif
 
 #include "albit.h"
 #include "alnumeric.h"
@@ -132,6 +138,97 @@ void StoreSamples(void *dst, const al::span<const float> src, const size_t chann
 }
 
 
+/* Converts a contiguous (interleaved or single-channel) block of samples to
+ * float, using SIMD for the common integer types.
+ */
+void LoadSampleBlock(al::span<float> dst, const void *src, const DevFmtType srctype) noexcept
+{
+    size_t i{0};
+#ifdef HAVE_SSE_INTRINSICS
+    if(srctype == DevFmtInt)
+    {
+        const auto srcspan = al::span{static_cast<const int32_t*>(src), dst.size()};
+        const __m128 scale{_mm_set1_ps(1.0f/2147483648.0f)};
+        for(;dst.size()-i >= 4;i += 4)
+        {
+            const __m128i ival{_mm_loadu_si128(reinterpret_cast<const __m128i*>(&srcspan[i]))};
+            _mm_storeu_ps(&dst[i], _mm_mul_ps(_mm_cvtepi32_ps(ival), scale));
+        }
+    }
+    else if(srctype == DevFmtShort)
+    {
+        const auto srcspan = al::span{static_cast<const int16_t*>(src), dst.size()};
+        const __m128 scale{_mm_set1_ps(1.0f/32768.0f)};
+        for(;dst.size()-i >= 8;i += 8)
+        {
+            const __m128i sval{_mm_loadu_si128(reinterpret_cast<const __m128i*>(&srcspan[i]))};
+            /* Sign-extend the 16-bit values by putting them in the top half
+             * of each 32-bit lane and shifting down.
+             */
+            const __m128i lo{_mm_srai_epi32(_mm_unpacklo_epi16(sval, sval), 16)};
+            const __m128i hi{_mm_srai_epi32(_mm_unpackhi_epi16(sval, sval), 16)};
+            _mm_storeu_ps(&dst[i], _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+            _mm_storeu_ps(&dst[i+4], _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+        }
+    }
+#endif
+    if(i < dst.size())
+    {
+        const auto srcbytes = al::span{static_cast<const std::byte*>(src),
+            dst.size()*BytesFromDevFmt(srctype)};
+        LoadSamples(dst.subspan(i), srcbytes.subspan(i*BytesFromDevFmt(srctype)).data(), 0, 1,
+            srctype);
+    }
+}
+
+/* Converts a block of float samples to a contiguous block of the output type,
+ * using SIMD for the common integer types.
+ */
+void StoreSampleBlock(void *dst, const al::span<const float> src, const DevFmtType dsttype)
+    noexcept
+{
+    size_t i{0};
+#ifdef HAVE_SSE_INTRINSICS
+    if(dsttype == DevFmtInt)
+    {
+        const auto dstspan = al::span{static_cast<int32_t*>(dst), src.size()};
+        const __m128 scale{_mm_set1_ps(2147483648.0f)};
+        const __m128 minval{_mm_set1_ps(-2147483648.0f)};
+        const __m128 maxval{_mm_set1_ps(2147483520.0f)};
+        for(;src.size()-i >= 4;i += 4)
+        {
+            __m128 val{_mm_mul_ps(_mm_loadu_ps(&src[i]), scale)};
+            val = _mm_min_ps(_mm_max_ps(val, minval), maxval);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&dstspan[i]), _mm_cvtps_epi32(val));
+        }
+    }
+    else if(dsttype == DevFmtShort)
+    {
+        const auto dstspan = al::span{static_cast<int16_t*>(dst), src.size()};
+        const __m128 scale{_mm_set1_ps(32768.0f)};
+        const __m128 minval{_mm_set1_ps(-32768.0f)};
+        const __m128 maxval{_mm_set1_ps(32767.0f)};
+        for(;src.size()-i >= 8;i += 8)
+        {
+            __m128 val0{_mm_mul_ps(_mm_loadu_ps(&src[i]), scale)};
+            __m128 val1{_mm_mul_ps(_mm_loadu_ps(&src[i+4]), scale)};
+            val0 = _mm_min_ps(_mm_max_ps(val0, minval), maxval);
+            val1 = _mm_min_ps(_mm_max_ps(val1, minval), maxval);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&dstspan[i]),
+                _mm_packs_epi32(_mm_cvtps_epi32(val0), _mm_cvtps_epi32(val1)));
+        }
+    }
+#endif
+    if(i < src.size())
+    {
+        const auto dstbytes = al::span{static_cast<std::byte*>(dst),
+            src.size()*BytesFromDevFmt(dsttype)};
+        StoreSamples(dstbytes.subspan(i*BytesFromDevFmt(dsttype)).data(), src.subspan(i), 0, 1,
+            dsttype);
+    }
+}
+
+
 template<DevFmtType T>
 void Mono2Stereo(const al::span<float> dst, const void *src) noexcept
 {
@@ -141,28 +238,86 @@ void Mono2Stereo(const al::span<float> dst, const void *src) noexcept
     { sdst = std::fill_n(sdst, 2, LoadSample<T>(in)*0.707106781187f); });
 }
 
+#ifdef HAVE_SSE_INTRINSICS
+template<>
+void Mono2Stereo<DevFmtFloat>(const al::span<float> dst, const void *src) noexcept
+{
+    const auto srcspan = al::span{static_cast<const float*>(src), dst.size()>>1};
+    const __m128 scale{_mm_set1_ps(0.707106781187f)};
+    size_t i{0};
+    for(;srcspan.size()-i >= 4;i += 4)
+    {
+        const __m128 val{_mm_mul_ps(_mm_loadu_ps(&srcspan[i]), scale)};
+        _mm_storeu_ps(&dst[i*2], _mm_unpacklo_ps(val, val));
+        _mm_storeu_ps(&dst[i*2 + 4], _mm_unpackhi_ps(val, val));
+    }
+    for(;i < srcspan.size();++i)
+        dst[i*2] = dst[i*2 + 1] = srcspan[i]*0.707106781187f;
+}
+#endif
+
+/* Downmixes the channels selected by chanmask to mono. Each input frame is
+ * read once, summing the selected channels in order before scaling.
+ */
 template<DevFmtType T>
 void Multi2Mono(uint chanmask, const size_t step, const float scale, const al::span<float> dst,
     const void *src) noexcept
 {
     const auto srcspan = al::span{static_cast<const DevFmtType_t<T>*>(src), step*dst.size()};
-    std::fill_n(dst.begin(), dst.size(), 0.0f);
-    for(size_t c{0};chanmask;++c)
+
+    if(chanmask == 0x3 && step == 2)
     {
-        if((chanmask&1)) LIKELY
+        auto ssrc = srcspan.cbegin();
+        std::generate(dst.begin(), dst.end(), [&ssrc,scale]
         {
-            auto ssrc = srcspan.cbegin();
-            std::for_each(dst.begin(), dst.end(), [&ssrc,step,c](float &sample)
-            {
-                const float s{LoadSample<T>(ssrc[c])};
-                ssrc += ptrdiff_t(step);
-                sample += s;
-            });
-        }
-        chanmask >>= 1;
+            const float ret{(LoadSample<T>(ssrc[0]) + LoadSample<T>(ssrc[1])) * scale};
+            ssrc += 2;
+            return ret;
+        });
+        return;
+    }
+
+    std::array<uint8_t,32> chans{};
+    size_t numchans{0};
+    for(uint c{0};chanmask;++c, chanmask >>= 1)
+    {
+        if((chanmask&1))
+            chans[numchans++] = static_cast<uint8_t>(c);
+    }
+    const auto chanlist = al::span{chans}.first(numchans);
+
+    auto ssrc = srcspan.cbegin();
+    std::generate(dst.begin(), dst.end(), [&ssrc,step,scale,chanlist]
+    {
+        float sample{0.0f};
+        for(const uint8_t c : chanlist)
+            sample += LoadSample<T>(ssrc[c]);
+        ssrc += ptrdiff_t(step);
+        return sample * scale;
+    });
+}
+
+#ifdef HAVE_SSE_INTRINSICS
+/* Stereo to mono is the most common downmix, so give the float input case a
+ * SIMD version, adding the deinterleaved left and right samples.
+ */
+void Stereo2MonoFloat(const float scale, const al::span<float> dst, const void *src) noexcept
+{
+    const auto srcspan = al::span{static_cast<const float*>(src), dst.size()*2};
+    const __m128 vscale{_mm_set1_ps(scale)};
+    size_t i{0};
+    for(;dst.size()-i >= 4;i += 4)
+    {
+        const __m128 in0{_mm_loadu_ps(&srcspan[i*2])};
+        const __m128 in1{_mm_loadu_ps(&srcspan[i*2 + 4])};
+        const __m128 left{_mm_shuffle_ps(in0, in1, _MM_SHUFFLE(2, 0, 2, 0))};
+        const __m128 right{_mm_shuffle_ps(in0, in1, _MM_SHUFFLE(3, 1, 3, 1))};
+        _mm_storeu_ps(&dst[i], _mm_mul_ps(_mm_add_ps(left, right), vscale));
     }
-    std::for_each(dst.begin(), dst.end(), [scale](float &sample) noexcept { sample *= scale; });
+    for(;i < dst.size();++i)
+        dst[i] = (srcspan[i*2] + srcspan[i*2 + 1]) * scale;
 }
+#endif
 
 } // namespace
 
@@ -190,9 +345,11 @@ SampleConverterPtr SampleConverter::Create(DevFmtType srcType, DevFmtType dstTyp
     converter->mIncrement = std::max(static_cast<uint>(step), 1u);
     if(converter->mIncrement == MixerFracOne)
     {
-        converter->mResample = [](const InterpState*, const al::span<const float> src, uint,
-            const uint, const al::span<float> dst)
-        { std::copy_n(src.begin()+MaxResamplerEdge, dst.size(), dst.begin()); };
+        /* With matching rates, the samples are converted directly without
+         * resampling, so there's no delay for the resampler's history.
+         */
+        converter->mSrcPrepCount = MaxResamplerEdge;
+        converter->mResample = nullptr;
     }
     else
         converter->mResample = PrepareResampler(resampler, converter->mIncrement,
@@ -208,6 +365,8 @@ uint SampleConverter::availableOut(uint srcframes) const
         /* No output samples if there's no input samples. */
         return 0;
     }
+    if(isPassthrough())
+        return std::min(srcframes, uint{std::numeric_limits<int>::max()});
 
     const uint prepcount{mSrcPrepCount};
     if(prepcount < MaxResamplerPadding && MaxResamplerPadding - prepcount >= srcframes)
@@ -236,6 +395,29 @@ uint SampleConverter::convert(const void **src, uint *srcframes, void *dst, uint
     auto SamplesIn = al::span{static_cast<const std::byte*>(*src), NumSrcSamples*SrcFrameSize};
     auto SamplesOut = al::span{static_cast<std::byte*>(dst), dstframes*DstFrameSize};
 
+    if(isPassthrough())
+    {
+        /* The channels stay interleaved, so each block is converted as one
+         * contiguous run of samples.
+         */
+        const uint numframes{std::min(NumSrcSamples, dstframes)};
+        const uint blockframes{static_cast<uint>(BufferLineSize / mChan.size())};
+        for(uint pos{0};pos < numframes;)
+        {
+            const uint todo{std::min(numframes-pos, blockframes)};
+            const auto block = al::span{mSrcSamples}.first(todo*mChan.size());
+            LoadSampleBlock(block, SamplesIn.data(), mSrcType);
+            StoreSampleBlock(SamplesOut.data(), block, mDstType);
+
+            SamplesIn = SamplesIn.subspan(SrcFrameSize*todo);
+            SamplesOut = SamplesOut.subspan(DstFrameSize*todo);
+            pos += todo;
+        }
+        *src = SamplesIn.data();
+        *srcframes = NumSrcSamples - numframes;
+        return numframes;
+    }
+
     FPUCtl mixer_mode{};
     uint pos{0};
     while(pos < dstframes && NumSrcSamples > 0)
@@ -327,6 +509,31 @@ uint SampleConverter::convertPlanar(const void **src, uint *srcframes, void *con
     const uint increment{mIncrement};
     uint NumSrcSamples{*srcframes};
 
+    if(isPassthrough())
+    {
+        const uint numframes{std::min(NumSrcSamples, dstframes)};
+        for(size_t chan{0u};chan < mChan.size();chan++)
+        {
+            auto SamplesIn = al::span{static_cast<const std::byte*>(srcs[chan]),
+                numframes*size_t{mSrcTypeSize}};
+            auto SamplesOut = al::span{static_cast<std::byte*>(dsts[chan]),
+                numframes*size_t{mDstTypeSize}};
+            while(!SamplesIn.empty())
+            {
+                const auto todo = std::min(SamplesIn.size()/mSrcTypeSize, size_t{BufferLineSize});
+                const auto block = al::span{mSrcSamples}.first(todo);
+                LoadSampleBlock(block, SamplesIn.data(), mSrcType);
+                StoreSampleBlock(SamplesOut.data(), block, mDstType);
+
+                SamplesIn = SamplesIn.subspan(todo*mSrcTypeSize);
+                SamplesOut = SamplesOut.subspan(todo*mDstTypeSize);
+            }
+            srcs[chan] = SamplesIn.data();
+        }
+        *srcframes = NumSrcSamples - numframes;
+        return numframes;
+    }
+
     FPUCtl mixer_mode{};
     uint pos{0};
     while(pos < dstframes && NumSrcSamples > 0)
@@ -426,6 +633,10 @@ void ChannelConverter::convert(const void *src, float *dst, uint frames) const
     if(mDstChans == DevFmtMono)
     {
         const float scale{std::sqrt(1.0f / static_cast<float>(al::popcount(mChanMask)))};
+#ifdef HAVE_SSE_INTRINSICS
+        if(mSrcType == DevFmtFloat && mChanMask == 0x3 && mSrcStep == 2)
+            return Stereo2MonoFloat(scale, {dst, frames}, src);
+#endif
         switch(mSrcType)
         {
 #define HANDLE_FMT(T) case T: Multi2Mono<T>(mChanMask, mSrcStep, scale, {dst, frames}, src); break
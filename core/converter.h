@@ -41,6 +41,10 @@ struct SampleConverter {
     [[nodiscard]] auto convertPlanar(const void **src, uint *srcframes, void *const*dst, uint dstframes) -> uint;
     [[nodiscard]] auto availableOut(uint srcframes) const -> uint;
 
+    /* With matching rates, samples are only converted, without resampling. */
+    [[nodiscard]] auto isPassthrough() const noexcept -> bool
+    { return mIncrement == MixerFracOne; }
+
     using SampleOffset = std::chrono::duration<int64_t, std::ratio<1,MixerFracOne>>;
     [[nodiscard]] auto currentInputDelay() const noexcept -> SampleOffset
     {
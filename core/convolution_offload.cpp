@@ -0,0 +1,113 @@
+#include "config.h"
+
+#include "convolution_offload.h"
+
+#include <exception>
+
+#include "althrd_setname.h"
+#include "fpu_ctrl.h"
+#include "helpers.h"
+#include "logging.h"
+
+
+void OffloadJob::runItems() noexcept
+{
+    std::size_t item{mNextItem.fetch_add(1, std::memory_order_acq_rel)};
+    while(item < mNumItems)
+    {
+        processItem(item);
+        if(mItemsDone.fetch_add(1, std::memory_order_acq_rel)+1 == mNumItems)
+            mDoneSem.post();
+        item = mNextItem.fetch_add(1, std::memory_order_acq_rel);
+    }
+}
+
+void OffloadJob::finish() noexcept
+{
+    if(mFinished)
+        return;
+    mFinished = true;
+
+    runItems();
+    if(mNumItems > 0)
+        mDoneSem.wait();
+}
+
+void OffloadJob::drain() noexcept
+{
+    if(!mPending)
+        return;
+
+    finish();
+    mReleaseSem.wait();
+    mPending = false;
+}
+
+
+ConvolutionOffload::~ConvolutionOffload()
+{
+    mQuit.store(true, std::memory_order_release);
+    mSem.post();
+    if(mThread.joinable())
+        mThread.join();
+}
+
+void ConvolutionOffload::threadProc()
+{
+    /* This runs at the mixer's priority, since the mixer may need to wait
+     * for an item this thread is in the middle of.
+     */
+    SetRTPriority();
+    althrd_setname(GetConvolutionOffloadThreadName());
+
+    FPUCtl mixer_mode{};
+    while(true)
+    {
+        mSem.wait();
+
+        /* Take all the jobs queued so far. The queue is emptied before
+         * quitting, so nothing is left waiting on the thread.
+         */
+        OffloadJob *job{mHead.exchange(nullptr, std::memory_order_acquire)};
+        while(job)
+        {
+            /* The job may be resubmitted or freed once it's let go of. */
+            OffloadJob *next{job->mNext};
+            job->runItems();
+            job->mReleaseSem.post();
+            job = next;
+        }
+
+        if(mQuit.load(std::memory_order_acquire))
+            break;
+    }
+}
+
+void ConvolutionOffload::submit(OffloadJob &job, std::size_t numItems) noexcept
+{
+    job.mNumItems = numItems;
+    job.mNextItem.store(0, std::memory_order_relaxed);
+    job.mItemsDone.store(0, std::memory_order_relaxed);
+    job.mPending = true;
+    job.mFinished = false;
+
+    OffloadJob *head{mHead.load(std::memory_order_relaxed)};
+    do {
+        job.mNext = head;
+    } while(!mHead.compare_exchange_weak(head, &job, std::memory_order_release,
+        std::memory_order_relaxed));
+    mSem.post();
+}
+
+std::unique_ptr<ConvolutionOffload> ConvolutionOffload::Create()
+{
+    auto offload = std::unique_ptr<ConvolutionOffload>{new ConvolutionOffload{}};
+    try {
+        offload->mThread = std::thread{&ConvolutionOffload::threadProc, offload.get()};
+    }
+    catch(std::exception &e) {
+        ERR("Failed to start convolution offload thread: %s\n", e.what());
+        return nullptr;
+    }
+    return offload;
+}
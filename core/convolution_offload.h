@@ -0,0 +1,111 @@
+#ifndef CORE_CONVOLUTION_OFFLOAD_H
+#define CORE_CONVOLUTION_OFFLOAD_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+
+#include "alsem.h"
+
+
+/**
+ * A set of independent work items (e.g. one for each output channel of a
+ * convolution block) that can be processed by a ConvolutionOffload thread
+ * while the owner carries on mixing. The owner collects the result with
+ * finish(), which processes any items the thread hasn't started on itself,
+ * so a late thread doesn't stall the mixer any longer than it takes to
+ * finish the items it's already on. The owner blocks on semaphores instead of
+ * spinning, so a real-time mixer doesn't starve the thread it waits on.
+ */
+class OffloadJob {
+    friend class ConvolutionOffload;
+
+    std::size_t mNumItems{0};
+    std::atomic<std::size_t> mNextItem{0};
+    std::atomic<std::size_t> mItemsDone{0};
+
+    /* Posted once for each submission, when the last item is done (by
+     * whichever thread does it), and when the thread lets go of the job.
+     */
+    al::semaphore mDoneSem;
+    al::semaphore mReleaseSem;
+    OffloadJob *mNext{nullptr};
+
+    /* Only used by the owner, for whether the job was submitted and not yet
+     * let go of, and whether its items were collected.
+     */
+    bool mPending{false};
+    bool mFinished{true};
+
+    void runItems() noexcept;
+
+protected:
+    virtual void processItem(std::size_t item) noexcept = 0;
+
+public:
+    virtual ~OffloadJob() = default;
+
+    /**
+     * Checks if the job is free to be submitted again, without waiting. Only
+     * the owner may call this.
+     */
+    [[nodiscard]]
+    auto isIdle() noexcept -> bool
+    {
+        if(mPending && mReleaseSem.try_wait())
+            mPending = false;
+        return !mPending;
+    }
+
+    /**
+     * Processes the remaining items on the calling thread, and waits for the
+     * ones in progress to finish.
+     */
+    void finish() noexcept;
+
+    /**
+     * Finishes the job, and waits for the thread to let go of it. Must be
+     * called before the job's storage is changed or freed.
+     */
+    void drain() noexcept;
+};
+
+
+/**
+ * A background thread for the convolution effect. Each effect state submits
+ * the work for its long tail partitions when a tail block starts, and the
+ * thread processes the jobs from all effect slots in batches while the mixer
+ * continues. The results are collected when the next tail block starts, the
+ * same latency the tail has when its work is spread over the mixer updates.
+ */
+class ConvolutionOffload {
+    std::thread mThread;
+    al::semaphore mSem;
+    std::atomic<OffloadJob*> mHead{nullptr};
+    std::atomic<bool> mQuit{false};
+
+    void threadProc();
+
+    ConvolutionOffload() = default;
+
+public:
+    ConvolutionOffload(const ConvolutionOffload&) = delete;
+    ConvolutionOffload& operator=(const ConvolutionOffload&) = delete;
+    ~ConvolutionOffload();
+
+    /**
+     * Queues the job with the given number of items. The job must be idle.
+     * Safe to call from multiple mixing threads at once.
+     */
+    void submit(OffloadJob &job, std::size_t numItems) noexcept;
+
+    static std::unique_ptr<ConvolutionOffload> Create();
+};
+
+/* Must be less than 15 characters (16 including terminating null) for
+ * compatibility with pthread_setname_np limitations. */
+[[nodiscard]] constexpr
+auto GetConvolutionOffloadThreadName() noexcept -> const char* { return "alsoft-convolve"; }
+
+#endif /* CORE_CONVOLUTION_OFFLOAD_H */
@@ -36,6 +36,18 @@ inline std::array<reg_type,4> get_cpuid(unsigned int f)
     __get_cpuid(f, ret.data(), &ret[1], &ret[2], &ret[3]);
     return ret;
 }
+inline std::array<reg_type,4> get_cpuid_count(unsigned int f, unsigned int sub)
+{
+    std::array<reg_type,4> ret{};
+    __cpuid_count(f, sub, ret[0], ret[1], ret[2], ret[3]);
+    return ret;
+}
+inline unsigned long long get_xcr0()
+{
+    reg_type lo{}, hi{};
+    __asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return (static_cast<unsigned long long>(hi)<<32) | lo;
+}
 #define CAN_GET_CPUID
 #elif defined(HAVE_CPUID_INTRINSIC) \
     && (defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64))
@@ -46,6 +58,14 @@ inline std::array<reg_type,4> get_cpuid(unsigned int f)
     (__cpuid)(ret.data(), f);
     return ret;
 }
+inline std::array<reg_type,4> get_cpuid_count(unsigned int f, unsigned int sub)
+{
+    std::array<reg_type,4> ret{};
+    (__cpuidex)(ret.data(), static_cast<int>(f), static_cast<int>(sub));
+    return ret;
+}
+inline unsigned long long get_xcr0()
+{ return _xgetbv(0); }
 #define CAN_GET_CPUID
 #endif
 
@@ -106,12 +126,26 @@ std::optional<CPUInfo> GetCPUInfo()
             ret.mCaps |= CPU_CAP_SSE3;
         if((ret.mCaps&CPU_CAP_SSE3) && (cpuregs[2]&(1<<19)))
             ret.mCaps |= CPU_CAP_SSE4_1;
+
+        /* AVX2 needs FMA and F16C, and the OS has to save the XMM and YMM
+         * state (OSXSAVE set and XCR0 bits 1 and 2 enabled).
+         */
+        const bool has_avx{(cpuregs[2]&(1<<28)) && (cpuregs[2]&(1<<12))
+            && (cpuregs[2]&(1<<29)) && (cpuregs[2]&(1<<27)) && (get_xcr0()&0x6) == 0x6};
+        if((ret.mCaps&CPU_CAP_SSE4_1) && has_avx && maxfunc >= 7)
+        {
+            cpuregs = get_cpuid_count(7, 0);
+            if((cpuregs[1]&(1<<5)))
+                ret.mCaps |= CPU_CAP_AVX2;
+        }
     }
 
 #else
 
     /* Assume support for whatever's supported if we can't check for it */
-#if defined(HAVE_SSE4_1)
+#if defined(HAVE_AVX2) && defined(__AVX2__) && defined(__FMA__) && defined(__F16C__)
+    ret.mCaps |= CPU_CAP_SSE | CPU_CAP_SSE2 | CPU_CAP_SSE3 | CPU_CAP_SSE4_1 | CPU_CAP_AVX2;
+#elif defined(HAVE_SSE4_1)
 #warning "Assuming SSE 4.1 run-time support!"
     ret.mCaps |= CPU_CAP_SSE | CPU_CAP_SSE2 | CPU_CAP_SSE3 | CPU_CAP_SSE4_1;
 #elif defined(HAVE_SSE3)
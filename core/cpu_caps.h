@@ -12,6 +12,8 @@ enum {
     CPU_CAP_SSE3   = 1<<2,
     CPU_CAP_SSE4_1 = 1<<3,
     CPU_CAP_NEON   = 1<<4,
+    /* AVX2 with FMA and F16C, and the OS saving the YMM registers. */
+    CPU_CAP_AVX2   = 1<<5,
 };
 
 struct CPUInfo {
@@ -98,6 +98,18 @@ SplineTable::SplineTable()
     mTable[pi].mDeltas[3] = mTable[0].mCoeffs[2] - mTable[pi].mCoeffs[3];
 }
 
+auto GetGaussianTable() -> const GaussianTable&
+{
+    static const GaussianTable table{};
+    return table;
+}
+
+auto GetSplineTable() -> const SplineTable&
+{
+    static const SplineTable table{};
+    return table;
+}
+
 
 CubicFilter::CubicFilter()
 {
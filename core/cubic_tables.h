@@ -12,10 +12,11 @@ struct CubicTable {
 };
 
 struct GaussianTable : CubicTable { GaussianTable(); };
-inline const GaussianTable gGaussianFilter;
-
 struct SplineTable : CubicTable { SplineTable(); };
-inline const SplineTable gSplineFilter;
+
+/* The resampler tables are generated on first use, like the bsinc tables. */
+auto GetGaussianTable() -> const GaussianTable&;
+auto GetSplineTable() -> const SplineTable&;
 
 
 struct CubicFilter {
@@ -3,10 +3,18 @@
 
 #include "bformatdec.h"
 #include "bs2b.h"
+#include "context.h"
+#include "convolution_offload.h"
 #include "device.h"
 #include "front_stablizer.h"
+#include "helpers.h"
 #include "hrtf.h"
+#include "logging.h"
 #include "mastering.h"
+#include "mixer_pool.h"
+#include "param_thread.h"
+
+#include <thread>
 
 
 static_assert(std::atomic<std::chrono::nanoseconds>::is_always_lock_free);
@@ -15,6 +23,99 @@ static_assert(std::atomic<std::chrono::nanoseconds>::is_always_lock_free);
 DeviceBase::DeviceBase(DeviceType type)
     : Type{type}, mContexts{al::FlexArray<ContextBase*>::Create(0)}
 {
+    mMixerScratch.mHrtfAccum = HrtfAccumData;
+
+    /* Messages logged from the device's real-time threads are written out by
+     * the log thread, which runs while any device is open.
+     */
+    al_start_log_thread();
+}
+
+DeviceBase::~DeviceBase()
+{
+    clearOutputUpdates();
+    al_stop_log_thread();
+}
+
+DeviceBase::OutputUpdate::OutputUpdate() noexcept = default;
+DeviceBase::OutputUpdate::~OutputUpdate() = default;
+
+
+void DeviceBase::holdOutput() noexcept
+{
+    using namespace std::chrono_literals;
+
+    /* Give the mixer a moment to render the faded out update. If it isn't
+     * rendering, just hold the output.
+     */
+    mOutputHold.store(OutputHold::FadeOut);
+    const auto timeout = std::chrono::steady_clock::now() + 100ms;
+    while(mOutputHold.load() == OutputHold::FadeOut)
+    {
+        if(std::chrono::steady_clock::now() >= timeout)
+        {
+            auto fadeout = OutputHold::FadeOut;
+            mOutputHold.compare_exchange_strong(fadeout, OutputHold::Held);
+            break;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+
+    /* Wait for an update that didn't see the hold to finish. */
+    auto renderCount = mRenderCount.load();
+    while((renderCount&1))
+    {
+        std::this_thread::yield();
+        renderCount = mRenderCount.load();
+    }
+}
+
+void DeviceBase::releaseOutput() noexcept
+{ mOutputHold.store(OutputHold::FadeIn, std::memory_order_release); }
+
+void DeviceBase::postOutputUpdate(std::unique_ptr<OutputUpdate> update) noexcept
+{
+    /* An update the mixer hasn't picked up yet is superseded by the new one. */
+    mOutputUpdate.store(std::move(update), std::memory_order_acq_rel);
+
+    OutputUpdate *retired{mRetiredOutputUpdates.exchange(nullptr, std::memory_order_acquire)};
+    while(auto todelete = std::unique_ptr<OutputUpdate>{retired})
+        retired = todelete->mNext;
+}
+
+void DeviceBase::clearOutputUpdates() noexcept
+{
+    mOutputUpdate.store(nullptr, std::memory_order_relaxed);
+
+    OutputUpdate *retired{mRetiredOutputUpdates.exchange(nullptr, std::memory_order_acquire)};
+    while(auto todelete = std::unique_ptr<OutputUpdate>{retired})
+        retired = todelete->mNext;
+}
+
+void DeviceBase::wakeCaptureWaiters() noexcept
+{
+    /* Pairs with the fence in alcCaptureWaitSOFT, so either the waiter sees
+     * the new state or this sees the waiter.
+     */
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(mCaptureWaiters.load(std::memory_order_relaxed) == 0)
+        return;
+
+    {
+        std::lock_guard<std::mutex> waitlock{mCaptureWaitLock};
+        ++mCaptureWakeCount;
+    }
+    mCaptureWaitCond.notify_all();
 }
 
-DeviceBase::~DeviceBase() = default;
+
+bool DeviceBase::lockMixerMemory()
+{
+    /* This covers the scratch and HRTF accumulation buffers. */
+    bool ok{LockMemoryRange(this, sizeof(*this))};
+    if(!MixBuffer.empty())
+        ok &= LockMemoryRange(MixBuffer.data(), MixBuffer.size()*sizeof(MixBuffer[0]));
+    for(ContextBase *ctx : *mContexts.load(std::memory_order_acquire))
+        ok &= ctx->lockMixerMemory();
+    return ok;
+}
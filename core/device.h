@@ -5,9 +5,11 @@
 #include <atomic>
 #include <bitset>
 #include <chrono>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "almalloc.h"
@@ -15,10 +17,14 @@
 #include "ambidefs.h"
 #include "atomic.h"
 #include "bufferline.h"
+#include "converter.h"
 #include "devformat.h"
 #include "filters/nfc.h"
+#include "fixedpool.h"
 #include "flexarray.h"
 #include "intrusive_ptr.h"
+#include "memusage.h"
+#include "mixer/defs.h"
 #include "mixer/hrtfdefs.h"
 #include "opthelpers.h"
 #include "resampler_limits.h"
@@ -32,7 +38,10 @@ struct bs2b;
 class Compressor;
 struct ContextBase;
 struct DirectHrtfState;
+class HrtfCoeffCache;
 struct HrtfStore;
+struct Voice;
+struct VoiceBufferItem;
 
 using uint = unsigned int;
 
@@ -58,6 +67,13 @@ enum class RenderMode : std::uint8_t {
     Hrtf
 };
 
+/* How far the mix is degraded to stay within the mixer's time budget. */
+enum class MixDegrade : std::uint8_t {
+    None,
+    Resampler, /* Voices use at most linear resampling. */
+    Voices, /* Quiet voices are made virtual. */
+};
+
 enum class StereoEncoding : std::uint8_t {
     Basic,
     Uhj,
@@ -148,6 +164,142 @@ struct RealMixParams {
     al::span<FloatBufferLine> Buffer;
 };
 
+/**
+ * Temp storage used for mixing voices. The device holds one for the mixer
+ * thread, and each mixer pool worker holds its own.
+ */
+struct MixerScratch {
+    static constexpr std::size_t LineSize{BufferLineSize + DecoderBase::sMaxPadding};
+    static constexpr std::size_t ChannelsMax{16};
+
+    alignas(16) std::array<float,LineSize*ChannelsMax> mSampleData{};
+    alignas(16) std::array<float,LineSize+MaxResamplerPadding> mResampleData{};
+
+    alignas(16) std::array<float,BufferLineSize> FilteredData{};
+    alignas(16) std::array<float,BufferLineSize+HrtfHistoryLength> ExtraSampleData{};
+    /* Near-field filtered samples, for each ambisonic order above 0. */
+    alignas(16) std::array<FloatBufferLine,MaxAmbiOrder> NfcSampleData{};
+
+    /* The HRTF accumulation buffer voices mix into. */
+    al::span<float2> mHrtfAccum;
+
+    /* Output line redirection. Mixing targets within [mBegin...mEnd) get
+     * redirected to the same offset from mTarget. This lets mixer pool
+     * workers mix into private copies of the device and effect slot buffers.
+     */
+    struct LineMap {
+        const FloatBufferLine *mBegin;
+        const FloatBufferLine *mEnd;
+        FloatBufferLine *mTarget;
+    };
+    al::span<const LineMap> mLineMaps;
+
+    /* When set, voice events are stored with the voice for the mixer thread
+     * to send later, instead of being written to the context's event queue.
+     */
+    bool mDeferEvents{false};
+
+    /* Mixes waiting to be batched together. Consecutive mixes to the same
+     * output lines with the same length, offset, and fade are held here, and
+     * accumulated into the output in one pass when the batch fills up or
+     * something different gets mixed.
+     */
+    alignas(16) std::array<FloatBufferLine,MaxMixBatchInputs> mBatchSamples{};
+    std::array<MixBatchInput,MaxMixBatchInputs> mBatchInputs{};
+    al::span<FloatBufferLine> mBatchTarget;
+    std::size_t mBatchCount{0};
+    std::size_t mBatchCounter{0};
+    std::size_t mBatchOutPos{0};
+
+    /* The last instancing voice that loaded its samples, with the state it
+     * loaded from. Another instancing voice in the same update that starts
+     * from the same state can reuse the resampled samples still in
+     * mSampleData, instead of loading and resampling them again. The samples
+     * are only valid while mInstanceVoice is set.
+     */
+    struct InstanceState {
+        std::chrono::nanoseconds mDeviceTime{};
+        const VoiceBufferItem *mBufferItem{};
+        const VoiceBufferItem *mLoopItem{};
+        int mPosInt{};
+        uint mPosFrac{};
+        uint mOutPos{};
+        uint mSamplesToLoad{};
+        std::array<std::array<float,MaxResamplerPadding>,ChannelsMax> mHistory{};
+    };
+    const Voice *mInstanceVoice{nullptr};
+    InstanceState mInstance;
+
+    /**
+     * Adds a mix of the given samples to the batch, mixing the pending batch
+     * first if it can't be combined. The samples are copied, but the gains
+     * must remain valid until the batch is flushed.
+     */
+    void mixBatched(const al::span<const float> samples, const al::span<FloatBufferLine> outBuffer,
+        const al::span<float> currentGains, const al::span<const float> targetGains,
+        const std::size_t counter, const std::size_t outPos);
+
+    /** Mixes any pending batched mixes into their output. */
+    void flushBatch();
+
+    [[nodiscard]]
+    auto getTarget(const al::span<FloatBufferLine> buffer) const noexcept
+        -> al::span<FloatBufferLine>
+    {
+        for(const LineMap &linemap : mLineMaps)
+        {
+            if(buffer.data() >= linemap.mBegin && buffer.data() < linemap.mEnd)
+                return {linemap.mTarget + (buffer.data()-linemap.mBegin), buffer.size()};
+        }
+        return buffer;
+    }
+};
+
+class ConvolutionOffload;
+class MixerPool;
+class ParamUpdateThread;
+
+/* Running totals of where the mixer spends its time, for profiling. Times are
+ * in nanoseconds, and are summed over every thread taking part in the mix.
+ * Voice counts are summed over each update, so dividing by the update count
+ * gives the average per update.
+ */
+struct MixerProfile {
+    enum Counter : uint {
+        /* Number of updates rendered. */
+        Updates,
+        /* Applying pending source, listener, and effect property updates. */
+        ParamUpdateTime,
+        /* Mixing all voices, and the parts of that spent on voices with HRTF
+         * and near-field filters (the rest is resampling and panning).
+         */
+        VoiceTime,
+        HrtfVoiceTime,
+        NfcVoiceTime,
+        /* Processing effect slots. */
+        EffectTime,
+        /* Post-processing (decoding, UHJ encoding, limiting, etc). */
+        PostProcessTime,
+        /* Converting and writing the mix to the output buffer. */
+        WriteTime,
+        /* The longest time taken by a single update. */
+        PeakUpdateTime,
+        /* Voices mixed, and playing voices skipped for being too quiet or
+         * over the real voice limit.
+         */
+        ActiveVoices,
+        CulledVoices,
+
+        CounterCount
+    };
+    std::array<std::atomic<uint64_t>,CounterCount> mCounters{};
+
+    void add(Counter counter, uint64_t value) noexcept
+    { mCounters[counter].fetch_add(value, std::memory_order_relaxed); }
+    void add(Counter counter, std::chrono::nanoseconds duration) noexcept
+    { add(counter, static_cast<uint64_t>(duration.count())); }
+};
+
 using AmbiRotateMatrix = std::array<std::array<float,MaxAmbiChannels>,MaxAmbiChannels>;
 
 enum {
@@ -187,6 +339,12 @@ struct DeviceBase {
     uint UpdateSize{};
     uint BufferSize{};
 
+    /* The rate voices, effects, and post-processing are mixed at. Normally
+     * the same as Frequency, but may be lower with the output upsampled to
+     * Frequency (see mOutputConverter).
+     */
+    uint mMixFrequency{};
+
     DevFmtChannels FmtChans{};
     DevFmtType FmtType{};
     uint mAmbiOrder{0};
@@ -206,6 +364,8 @@ struct DeviceBase {
     DeviceState mDeviceState{DeviceState::Unprepared};
 
     uint NumAuxSends{};
+    /* The number of listeners each context renders for (at least 1). */
+    uint NumListeners{1};
 
     /* Rendering mode. */
     RenderMode mRenderMode{RenderMode::Normal};
@@ -224,17 +384,10 @@ struct DeviceBase {
     std::atomic<std::chrono::nanoseconds> mClockBase{std::chrono::nanoseconds{}};
     std::chrono::nanoseconds FixedLatency{0};
 
-    AmbiRotateMatrix mAmbiRotateMatrix{};
-    AmbiRotateMatrix mAmbiRotateMatrix2{};
-
     /* Temp storage used for mixer processing. */
-    static constexpr std::size_t MixerLineSize{BufferLineSize + DecoderBase::sMaxPadding};
-    static constexpr std::size_t MixerChannelsMax{16};
-    alignas(16) std::array<float,MixerLineSize*MixerChannelsMax> mSampleData{};
-    alignas(16) std::array<float,MixerLineSize+MaxResamplerPadding> mResampleData{};
-
-    alignas(16) std::array<float,BufferLineSize> FilteredData{};
-    alignas(16) std::array<float,BufferLineSize+HrtfHistoryLength> ExtraSampleData{};
+    static constexpr std::size_t MixerLineSize{MixerScratch::LineSize};
+    static constexpr std::size_t MixerChannelsMax{MixerScratch::ChannelsMax};
+    MixerScratch mMixerScratch;
 
     /* Persistent storage for HRTF mixing. */
     alignas(16) std::array<float2,BufferLineSize+HrirLength> HrtfAccumData{};
@@ -255,10 +408,16 @@ struct DeviceBase {
     std::unique_ptr<DirectHrtfState> mHrtfState;
     al::intrusive_ptr<HrtfStore> mHrtf;
     uint mIrSize{0};
+    /* Blended HRIRs for per-source HRTF, if enabled. */
+    std::unique_ptr<HrtfCoeffCache> mHrtfCoeffCache;
 
     /* Ambisonic-to-UHJ encoder */
     std::unique_ptr<UhjEncoderBase> mUhjEncoder;
 
+    /* Filter types for UHJ output encoding and UHJ/Super Stereo voices. */
+    UhjQualityType mUhjEncodeQuality{UhjQualityType::Default};
+    UhjQualityType mUhjDecodeQuality{UhjQualityType::Default};
+
     /* Ambisonic decoder for speakers */
     std::unique_ptr<BFormatDec> AmbiDecoder;
 
@@ -268,14 +427,124 @@ struct DeviceBase {
     using PostProc = void(DeviceBase::*)(const size_t SamplesToDo);
     PostProc PostProcess{nullptr};
 
+    /* Upsamples the RealOut mix from mMixFrequency to Frequency, when they
+     * differ. Each upsampled mix is held in mOutputBuffer until written.
+     */
+    std::unique_ptr<SampleConverter> mOutputConverter;
+    al::vector<FloatBufferLine, 16> mOutputBuffer;
+    uint mOutputOffset{0u};
+    uint mOutputCount{0u};
+
     std::unique_ptr<Compressor> Limiter;
 
+    /* Dithering and output limiter changes from a config reload, which the
+     * mixer picks up at the start of its next update. Once applied, an update
+     * holds the limiter it replaced until the next reload frees it, so the
+     * mixer never frees memory.
+     */
+    struct OutputUpdate {
+        float DitherDepth{0.0f};
+        bool DitherShaped{false};
+        bool ReplaceLimiter{false};
+        std::unique_ptr<Compressor> Limiter;
+
+        OutputUpdate *mNext{nullptr};
+
+        OutputUpdate() noexcept;
+        OutputUpdate(const OutputUpdate&) = delete;
+        OutputUpdate& operator=(const OutputUpdate&) = delete;
+        ~OutputUpdate();
+    };
+    al::atomic_unique_ptr<OutputUpdate> mOutputUpdate;
+    std::atomic<OutputUpdate*> mRetiredOutputUpdates{nullptr};
+
+    /* Optional worker threads for mixing voices in parallel. */
+    std::unique_ptr<MixerPool> mMixerPool;
+
+    /* Optional helper thread for processing property updates ahead of the
+     * next mix.
+     */
+    std::unique_ptr<ParamUpdateThread> mParamThread;
+
+    /* Optional background thread for the convolution effect's long tails.
+     * Effect states keep a pointer to it, so it stays across device resets.
+     */
+    std::unique_ptr<ConvolutionOffload> mConvolutionOffload;
+
+    /* Voices with a gain below mVoiceCullGain are culled, skipping everything
+     * but advancing their position, until the gain rises above
+     * mVoiceUncullGain. A cull gain of 0 disables culling.
+     */
+    float mVoiceCullGain{0.0f};
+    float mVoiceUncullGain{0.0f};
+
+    /* Mono voices with a dry gain below mLowDetailGain are panned with first-
+     * order coefficients and no NFC or HRTF filtering, until the gain rises
+     * above mFullDetailGain. A low-detail gain of 0 disables it.
+     */
+    float mLowDetailGain{0.0f};
+    float mFullDetailGain{0.0f};
+
+    /* The maximum number of voices to mix for each context. If more are
+     * playing, the quietest ones become virtual, only advancing their
+     * position until they rank high enough again. 0 means no limit.
+     */
+    uint mRealVoiceLimit{0u};
+
+    /* The maximum number of mono voices to render with their own HRTF filters
+     * for each context. The quieter ones beyond it are panned into the
+     * ambisonic mix instead, which gets HRTF applied once for all of them. 0
+     * means no limit.
+     */
+    uint mHrtfVoiceLimit{0u};
+
+    /* The fraction of each update's duration the mixer may spend on it. When
+     * the average mix time goes over the budget, the mix is degraded a step
+     * at a time, and restored once the load drops to half the budget. 0
+     * disables this. mMixLoad is the average load, as a fraction of the
+     * update duration.
+     */
+    float mMixBudget{0.0f};
+    std::atomic<float> mMixLoad{0.0f};
+    MixDegrade mMixDegrade{MixDegrade::None};
+    bool mMixDegradeChanged{false};
+    /* The fraction of each context's playing voices to keep mixing with
+     * MixDegrade::Voices.
+     */
+    float mDegradeVoiceScale{1.0f};
+    /* The number of output underruns the backend reported since the last
+     * reset.
+     */
+    std::atomic<uint> mXRunCount{0u};
+    /* The captured sample count that triggers the capture-ready event, or 0
+     * if disabled. The event is sent once, then re-armed when the app reads
+     * samples.
+     */
+    std::atomic<uint> mCaptureThreshold{0u};
+    std::atomic<bool> mCaptureArmed{true};
+    /* Threads waiting for captured samples, and the count of wakeups sent to
+     * them (guarded by mCaptureWaitLock).
+     */
+    std::atomic<uint> mCaptureWaiters{0u};
+    uint mCaptureWakeCount{0u};
+    std::mutex mCaptureWaitLock;
+    std::condition_variable mCaptureWaitCond;
+    /* Mixer profiling counters, or null if profiling is disabled. */
+    std::unique_ptr<MixerProfile> mProfile;
+    /* Memory allocated for the device's buffers, HRTF, effects, and voices. */
+    const std::shared_ptr<MemoryUsage> mMemory{std::make_shared<MemoryUsage>()};
+    /* Samples to wait before changing the degrade level again. */
+    uint mDegradeHold{0u};
+
     /* Delay buffers used to compensate for speaker distances. */
     std::unique_ptr<DistanceComp> ChannelDelays;
 
     /* Dithering control. */
     float DitherDepth{0.0f};
-    uint DitherSeed{0u};
+    bool DitherShaped{false};
+    std::array<uint,8> DitherSeeds{};
+    /* The last random value used for each channel, for shaped dither. */
+    std::array<uint,MaxOutputChannels> DitherLast{};
 
     /* Running count of the mixer invocations, in 31.1 fixed point. This
      * actually increments *twice* when mixing, first at the start and then at
@@ -284,9 +553,39 @@ struct DeviceBase {
      */
     std::atomic<uint> mMixCount{0u};
 
+    /* Like MixCount, but only held odd while the clock (SamplesDone and
+     * ClockBase) is being written. Clock readers watch this instead so they
+     * don't have to wait out a whole mix.
+     */
+    std::atomic<uint> mClockCount{0u};
+
+    /* For resetting the mixing state in place, while the backend keeps
+     * playing. The output fades out over one update and is held silent while
+     * the state is rebuilt, then fades back in over the next update.
+     */
+    enum class OutputHold : std::uint8_t {
+        None,
+        FadeOut,
+        Held,
+        FadeIn
+    };
+    std::atomic<OutputHold> mOutputHold{OutputHold::None};
+
+    /* Like MixCount, but held odd for each whole update rendered and written
+     * to the backend's output. Only used for holding the output.
+     */
+    std::atomic<uint> mRenderCount{0u};
+
     // Contexts created on this device
     al::atomic_unique_ptr<al::FlexArray<ContextBase*>> mContexts;
 
+    /* Storage for things the mixer thread needs to create, like disconnect
+     * messages, so it never has to use the general heap.
+     */
+    static constexpr size_t EventPoolBlockSize{256};
+    static constexpr size_t EventPoolBlockCount{16};
+    al::FixedPool mEventPool{EventPoolBlockSize, EventPoolBlockCount};
+
 
     DeviceBase(DeviceType type);
     DeviceBase(const DeviceBase&) = delete;
@@ -327,10 +626,32 @@ struct DeviceBase {
         return refcount;
     }
 
+    /** Waits for the mixer to not be updating the clock. */
+    [[nodiscard]] auto waitForClock() const noexcept -> uint
+    {
+        uint refcount{mClockCount.load(std::memory_order_acquire)};
+        while((refcount&1)) refcount = mClockCount.load(std::memory_order_acquire);
+        return refcount;
+    }
+
+    /**
+     * Publishes a new clock base and samples done count to readers watching
+     * the ClockCount.
+     */
+    void setClock(std::chrono::nanoseconds clockBase, uint samplesDone) noexcept
+    {
+        auto clockCount = mClockCount.load(std::memory_order_relaxed);
+        mClockCount.store(++clockCount, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        mClockBase.store(clockBase, std::memory_order_relaxed);
+        mSamplesDone.store(samplesDone, std::memory_order_relaxed);
+        mClockCount.store(++clockCount, std::memory_order_release);
+    }
+
     /**
      * Helper to get the current clock time from the device's ClockBase, and
      * SamplesDone converted from the sample rate. Should only be called while
-     * watching the MixCount.
+     * watching the ClockCount or MixCount.
      */
     [[nodiscard]] auto getClockTime() const noexcept -> std::chrono::nanoseconds
     {
@@ -341,6 +662,12 @@ struct DeviceBase {
         return mClockBase.load(std::memory_order_relaxed) + ns;
     }
 
+    /**
+     * Locks the device's mixing buffers, and the mixer-side storage of each
+     * context, into memory. Returns false if any failed.
+     */
+    bool lockMixerMemory();
+
     void ProcessHrtf(const std::size_t SamplesToDo);
     void ProcessAmbiDec(const std::size_t SamplesToDo);
     void ProcessAmbiDecStablized(const std::size_t SamplesToDo);
@@ -350,9 +677,42 @@ struct DeviceBase {
     inline void postProcess(const std::size_t SamplesToDo)
     { if(PostProcess) LIKELY (this->*PostProcess)(SamplesToDo); }
 
+    /**
+     * Processes each context's pending property updates outside of a mix.
+     * Only called from the parameter update thread, while the mixer thread
+     * isn't mixing.
+     */
+    void processUpdatesAhead();
+
     void renderSamples(const al::span<float*> outBuffers, const uint numSamples);
     void renderSamples(void *outBuffer, const uint numSamples, const std::size_t frameStep);
 
+    /**
+     * Fades out and holds the output silent, returning once the mixer isn't
+     * rendering. The mixing state can then be rebuilt, as long as the output
+     * format stays the same, until releaseOutput is called.
+     */
+    void holdOutput() noexcept;
+    void releaseOutput() noexcept;
+
+    /**
+     * Queues new dithering and limiter settings for the mixer to apply, and
+     * frees the previously applied updates. Calls must be serialized.
+     */
+    void postOutputUpdate(std::unique_ptr<OutputUpdate> update) noexcept;
+    /**
+     * Frees all output updates, applied or not. The mixer must not be
+     * running.
+     */
+    void clearOutputUpdates() noexcept;
+
+    /**
+     * Wakes threads waiting for captured samples, after more are captured or
+     * the device stops. Only takes a lock when something is waiting, and may
+     * be called from a backend's capture thread or callback.
+     */
+    void wakeCaptureWaiters() noexcept;
+
     /* Caller must lock the device state, and the mixer must not be running. */
 #ifdef __MINGW32__
     [[gnu::format(__MINGW_PRINTF_FORMAT,2,3)]]
@@ -369,6 +729,7 @@ struct DeviceBase {
     { return RealOut.ChannelIndex[chan]; }
 
 private:
+    void applyOutputUpdate() noexcept;
     uint renderSamples(const uint numSamples);
 };
 
@@ -3,10 +3,13 @@
 
 #include <array>
 #include <cstddef>
+#include <memory>
 #include <variant>
 
 #include "alspan.h"
+#include "core/ambidefs.h"
 #include "core/bufferline.h"
+#include "core/memusage.h"
 #include "intrusive_ptr.h"
 
 struct BufferStorage;
@@ -23,6 +26,18 @@ inline constexpr float ReverbDecayGain{0.001f}; /* -60 dB */
 inline constexpr float ReverbMaxReflectionsDelay{0.3f};
 inline constexpr float ReverbMaxLateReverbDelay{0.1f};
 
+/* How a reverb shares its stages with other reverbs. An EarlyZone reverb only
+ * renders early reflections (without its reflections gain), for the
+ * SharedLate reverb it targets. A SharedLate reverb passes its input through
+ * as the early reflections, and feeds it to its late reverb, so several zones
+ * can share one late reverb.
+ */
+enum class ReverbZoneMode {
+    Full,
+    EarlyZone,
+    SharedLate
+};
+
 enum class ChorusWaveform {
     Sinusoid,
     Triangle
@@ -82,6 +97,7 @@ struct ReverbProps {
     float LFReference;
     float RoomRolloffFactor;
     bool DecayHFLimit;
+    ReverbZoneMode ZoneMode;
 };
 
 struct AutowahProps {
@@ -172,6 +188,14 @@ struct ConvolutionProps {
     std::array<float,3> OrientUp;
 };
 
+struct SourceGroupProps {
+    std::array<float,3> Position;
+    float Gain;
+    float RefDistance;
+    float RolloffFactor;
+    bool HeadRelative;
+};
+
 using EffectProps = std::variant<std::monostate,
     ReverbProps,
     AutowahProps,
@@ -185,7 +209,8 @@ using EffectProps = std::variant<std::monostate,
     PshifterProps,
     VmorpherProps,
     DedicatedProps,
-    ConvolutionProps>;
+    ConvolutionProps,
+    SourceGroupProps>;
 
 
 struct EffectTarget {
@@ -197,13 +222,47 @@ struct EffectState : public al::intrusive_ref<EffectState> {
     al::span<FloatBufferLine> mOutTarget;
 
 
-    virtual ~EffectState() = default;
+    virtual ~EffectState()
+    { if(mMemUsage) mMemUsage->sub(MemoryUsage::Effects, mMemBytes); }
 
     virtual void deviceUpdate(const DeviceBase *device, const BufferStorage *buffer) = 0;
     virtual void update(const ContextBase *context, const EffectSlot *slot,
         const EffectProps *props, const EffectTarget target) = 0;
     virtual void process(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn,
         const al::span<FloatBufferLine> samplesOut) = 0;
+
+    /**
+     * Returns true if the effect's output has gone silent and will stay silent
+     * while the input is silent, allowing the mixer to skip processing until
+     * the input becomes non-silent again.
+     */
+    [[nodiscard]] virtual bool isIdle() const noexcept { return false; }
+
+    /**
+     * Returns how many of the wet buffer's channels (in ACN order) the effect
+     * reads. Effects that only process the W channel can return 1, so voices
+     * and other slots don't mix to channels that would be ignored.
+     */
+    [[nodiscard]] virtual auto inputChannels() const noexcept -> size_t
+    { return MaxAmbiChannels; }
+
+    /**
+     * Sets the number of bytes the state has allocated for delay lines,
+     * filters, and other storage, counting them in the given device memory
+     * usage in place of what was set before. The count is removed when the
+     * state is destroyed.
+     */
+    void setMemoryUsage(const std::shared_ptr<MemoryUsage> &usage, size_t bytes) noexcept
+    {
+        if(mMemUsage) mMemUsage->sub(MemoryUsage::Effects, mMemBytes);
+        mMemUsage = usage;
+        mMemBytes = bytes;
+        mMemUsage->add(MemoryUsage::Effects, mMemBytes);
+    }
+
+private:
+    std::shared_ptr<MemoryUsage> mMemUsage;
+    size_t mMemBytes{0};
 };
 
 
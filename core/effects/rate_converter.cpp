@@ -0,0 +1,183 @@
+#include "config.h"
+
+#include "rate_converter.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <functional>
+#include <numeric>
+
+#ifdef HAVE_SSE_INTRINSICS
+#include <xmmintrin.h>
+#endif
+
+#include "opthelpers.h"
+#include "polyphase_resampler.h"
+
+
+namespace {
+
+/* Stop band rejection for the decimation and interpolation filter, in dB. */
+constexpr double FilterRejection{60.0};
+
+/* Both spans are multiples of 4 in length. */
+[[nodiscard]]
+auto DotProduct(const al::span<const float> values, const al::span<const float> filter) noexcept
+    -> float
+{
+#ifdef HAVE_SSE_INTRINSICS
+    __m128 r4{_mm_setzero_ps()};
+    for(size_t j{0};j < filter.size();j+=4)
+    {
+        const __m128 coeffs{_mm_loadu_ps(&filter[j])};
+        const __m128 s{_mm_loadu_ps(&values[j])};
+        r4 = _mm_add_ps(r4, _mm_mul_ps(s, coeffs));
+    }
+    r4 = _mm_add_ps(r4, _mm_shuffle_ps(r4, r4, _MM_SHUFFLE(0, 1, 2, 3)));
+    r4 = _mm_add_ps(r4, _mm_movehl_ps(r4, r4));
+    return _mm_cvtss_f32(r4);
+
+#else
+
+    std::array<float,4> r{};
+    for(size_t j{0};j < filter.size();j+=4)
+    {
+        r[0] += values[j+0]*filter[j+0];
+        r[1] += values[j+1]*filter[j+1];
+        r[2] += values[j+2]*filter[j+2];
+        r[3] += values[j+3]*filter[j+3];
+    }
+    return (r[0] + r[1]) + (r[2] + r[3]);
+#endif
+}
+
+} // namespace
+
+EffectRateConverter::EffectRateConverter(const uint divisor, const size_t numInputs,
+    const size_t numOutputs)
+    : mDivisor{divisor}
+{
+    const size_t filterlen{PhaseTaps*mDivisor};
+
+    /* The transition band ends at the reduced rate's nyquist, so nothing
+     * above it is kept to alias or image.
+     */
+    auto filter = std::vector<double>(filterlen);
+    MakeKaiserSincLowPass(FilterRejection, 0.5/mDivisor, 1.0, filter);
+
+    /* Normalize the DC gain, since the filter is too short to guarantee it. */
+    const double dcgain{std::accumulate(filter.cbegin(), filter.cend(), 0.0)};
+    mFilter.resize(filterlen);
+    std::transform(filter.crbegin(), filter.crend(), mFilter.begin(),
+        [dcgain](const double f) noexcept { return static_cast<float>(f / dcgain); });
+
+    /* Interpolation phase j uses every mDivisor-th tap starting at j, scaled
+     * to make up for the zero-stuffed samples that aren't computed.
+     */
+    mPhaseFilters.resize(filterlen);
+    for(size_t j{0};j < mDivisor;++j)
+    {
+        const auto dst = al::span{mPhaseFilters}.subspan(j*PhaseTaps, PhaseTaps);
+        for(size_t k{0};k < PhaseTaps;++k)
+            dst[PhaseTaps-1 - k] = static_cast<float>(filter[k*mDivisor + j] / dcgain
+                * mDivisor);
+    }
+
+    mInHistory.resize(numInputs * (filterlen-1), 0.0f);
+    mOutHistory.resize(numOutputs * (PhaseTaps-1), 0.0f);
+    mOutPending.resize(numOutputs * (mDivisor-1), 0.0f);
+    /* Large enough for the input history and samples when decimating, or the
+     * output history, reduced-rate samples, and interpolated samples when
+     * interpolating.
+     */
+    mWork.resize(filterlen + BufferLineSize*2 + mDivisor*2);
+
+    mInput.resize(numInputs);
+    mOutput.resize(numOutputs);
+}
+
+size_t EffectRateConverter::decimate(const size_t samplesToDo,
+    const al::span<const FloatBufferLine> samplesIn)
+{
+    ASSUME(samplesToDo <= BufferLineSize);
+
+    const size_t filterlen{mFilter.size()};
+    const size_t histlen{filterlen - 1};
+
+    /* Decimated samples are taken from the input at mPhase, mPhase+divisor,
+     * etc.
+     */
+    const size_t todo{(samplesToDo > mPhase) ? (samplesToDo-mPhase + mDivisor-1) / mDivisor
+        : 0};
+
+    const auto work = al::span{mWork}.first(histlen + samplesToDo);
+    auto history = mInHistory.begin();
+    for(size_t c{0};c < samplesIn.size();++c)
+    {
+        /* Prepend the history so the filter reads through the input
+         * contiguously.
+         */
+        std::copy_n(history, histlen, work.begin());
+        std::copy_n(samplesIn[c].cbegin(), samplesToDo, work.begin()+ptrdiff_t(histlen));
+
+        size_t pos{mPhase};
+        for(size_t i{0};i < todo;++i)
+        {
+            mInput[c][i] = DotProduct(work.subspan(pos, filterlen), mFilter);
+            pos += mDivisor;
+        }
+
+        history = std::copy_n(work.end()-ptrdiff_t(histlen), histlen, history);
+    }
+
+    return todo;
+}
+
+void EffectRateConverter::interpolate(const size_t samplesToDo, const size_t todo,
+    const al::span<FloatBufferLine> samplesOut)
+{
+    const size_t histlen{PhaseTaps - 1};
+    const size_t pending{mPhase};
+    const size_t total{pending + todo*mDivisor};
+    assert(total >= samplesToDo && total - samplesToDo < mDivisor);
+
+    auto work = al::span{mWork}.first(histlen + todo + total);
+    const auto lowbuf = work.first(histlen + todo);
+    const auto highbuf = work.subspan(histlen + todo, total);
+
+    auto history = mOutHistory.begin();
+    auto held = mOutPending.begin();
+    for(size_t c{0};c < samplesOut.size();++c)
+    {
+        std::copy_n(history, histlen, lowbuf.begin());
+        std::copy_n(mOutput[c].cbegin(), todo, lowbuf.begin()+ptrdiff_t(histlen));
+
+        /* Start with the samples held over from the last update, then each
+         * reduced-rate sample produces mDivisor output samples.
+         */
+        auto output = std::copy_n(held, pending, highbuf.begin());
+        for(size_t i{0};i < todo;++i)
+        {
+            const auto values = lowbuf.subspan(i, PhaseTaps);
+            for(size_t j{0};j < mDivisor;++j)
+                *(output++) = DotProduct(values,
+                    al::span{mPhaseFilters}.subspan(j*PhaseTaps, PhaseTaps));
+        }
+
+        std::transform(highbuf.begin(), highbuf.begin()+ptrdiff_t(samplesToDo),
+            samplesOut[c].cbegin(), samplesOut[c].begin(), std::plus<float>{});
+
+        history = std::copy_n(lowbuf.end()-ptrdiff_t(histlen), histlen, history);
+        held = std::copy(highbuf.begin()+ptrdiff_t(samplesToDo), highbuf.end(), held);
+        held = std::fill_n(held, mDivisor-1 - (total-samplesToDo), 0.0f);
+    }
+
+    mPhase = total - samplesToDo;
+}
+
+std::unique_ptr<EffectRateConverter> EffectRateConverter::Create(const uint divisor,
+    const size_t numInputs, const size_t numOutputs)
+{
+    return std::make_unique<EffectRateConverter>(divisor, numInputs, numOutputs);
+}
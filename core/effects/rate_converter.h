@@ -0,0 +1,115 @@
+#ifndef CORE_EFFECTS_RATE_CONVERTER_H
+#define CORE_EFFECTS_RATE_CONVERTER_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "alspan.h"
+#include "core/bufferline.h"
+#include "vector.h"
+
+using uint = unsigned int;
+
+
+/**
+ * Runs an effect at a fraction of the device sample rate. The effect's input
+ * channels are low-pass filtered and decimated, the effect processes the
+ * reduced-rate samples, and its output is interpolated back to the device
+ * rate and added to the real output. Both directions use the same Kaiser-
+ * windowed sinc filter, applied as a polyphase filter when interpolating.
+ *
+ * This adds a delay of about PhaseTaps reduced-rate samples.
+ */
+class EffectRateConverter {
+public:
+    static constexpr uint MaxDivisor{4};
+    /* Filter length for each interpolation phase. The full filter is this
+     * times the divisor.
+     */
+    static constexpr size_t PhaseTaps{32};
+    /* The lowest sample rate to process at. Below this, the divisor is
+     * reduced.
+     */
+    static constexpr uint MinRate{24000};
+
+private:
+    const uint mDivisor;
+
+    /* Offset in the next input block to take the next decimated sample from.
+     * This is also the number of interpolated samples held over from the
+     * last update, since every decimated sample makes mDivisor output
+     * samples.
+     */
+    size_t mPhase{0};
+
+    /* Reversed decimation filter, and reversed interpolation filters for each
+     * phase (scaled by the divisor).
+     */
+    std::vector<float> mFilter;
+    std::vector<float> mPhaseFilters;
+
+    /* The last device-rate input samples for each input channel, and the last
+     * reduced-rate output samples and held over interpolated samples for each
+     * output channel.
+     */
+    std::vector<float> mInHistory;
+    std::vector<float> mOutHistory;
+    std::vector<float> mOutPending;
+
+    std::vector<float> mWork;
+
+    al::vector<FloatBufferLine,16> mInput;
+    al::vector<FloatBufferLine,16> mOutput;
+
+    size_t decimate(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn);
+    void interpolate(const size_t samplesToDo, const size_t todo,
+        const al::span<FloatBufferLine> samplesOut);
+
+public:
+    EffectRateConverter(const uint divisor, const size_t numInputs, const size_t numOutputs);
+
+    [[nodiscard]] auto getDivisor() const noexcept -> uint { return mDivisor; }
+
+    /**
+     * Decimates the input and calls proc with the reduced-rate sample count,
+     * input lines, and (cleared) output lines, then adds the interpolated
+     * output to samplesOut.
+     */
+    template<typename F>
+    void process(const size_t samplesToDo, const al::span<const FloatBufferLine> samplesIn,
+        const al::span<FloatBufferLine> samplesOut, F&& proc)
+    {
+        assert(samplesOut.size() <= mOutput.size());
+        const size_t numInputs{std::min(samplesIn.size(), mInput.size())};
+        const auto outlines = al::span{mOutput}.first(samplesOut.size());
+
+        const size_t todo{decimate(samplesToDo, samplesIn.first(numInputs))};
+        if(todo > 0)
+        {
+            for(auto &line : outlines)
+                std::fill_n(line.begin(), todo, 0.0f);
+            proc(todo, al::span<const FloatBufferLine>{mInput}.first(numInputs), outlines);
+        }
+        interpolate(samplesToDo, todo, samplesOut);
+    }
+
+    /**
+     * Returns the divisor to use for the requested divisor and device sample
+     * rate, keeping the reduced rate at or above MinRate.
+     */
+    static uint GetDivisor(uint divisor, const uint frequency) noexcept
+    {
+        divisor = std::clamp(divisor, 1u, MaxDivisor);
+        while(divisor > 1 && frequency/divisor < MinRate)
+            divisor /= 2;
+        return divisor;
+    }
+
+    static std::unique_ptr<EffectRateConverter> Create(const uint divisor,
+        const size_t numInputs, const size_t numOutputs);
+};
+
+#endif /* CORE_EFFECTS_RATE_CONVERTER_H */
@@ -30,6 +30,7 @@ enum class EffectSlotType : unsigned char {
     FrequencyShifter,
     PitchShifter,
     RingModulator,
+    SourceGroup,
     VocalMorpher,
 };
 
@@ -43,12 +44,21 @@ struct EffectSlotProps {
 
     al::intrusive_ptr<EffectState> State;
 
+    /* The effect slot ID to send a ready event for when the mixer starts using
+     * this state, or 0 for none.
+     */
+    uint ReadyId;
+
     std::atomic<EffectSlotProps*> next;
 };
 
 
 struct EffectSlot {
     bool InUse{false};
+    /* The AL ID of the slot using this, or 0 for the default slot. Only used
+     * to identify the slot in trace spans.
+     */
+    uint mId{0u};
 
     std::atomic<EffectSlotProps*> Update{nullptr};
 
@@ -74,9 +84,25 @@ struct EffectSlot {
     bool DecayHFLimit{false};
     float AirAbsorptionGainHF{1.0f};
 
+    /* Set when the effect state is idle and the wet buffer is silent. The wet
+     * buffer isn't cleared or processed while sleeping, since nothing wrote to
+     * it.
+     */
+    bool mSleeping{false};
+
     /* Mixing buffer used by the Wet mix. */
     al::vector<FloatBufferLine,16> mWetBuffer;
 
+    /* Set for dedicated effects that output to a single real output channel.
+     * Voices sending to the slot mix straight into that channel with the
+     * effect's gain, bypassing the wet buffer. The buffer is empty otherwise.
+     */
+    MixParams mDirectOut;
+
+    /** Gets the mixing parameters for voices sending to this slot. */
+    [[nodiscard]] auto getSendTarget() const noexcept -> const MixParams*
+    { return mDirectOut.Buffer.empty() ? &Wet : &mDirectOut; }
+
 
     static std::unique_ptr<EffectSlotArray> CreatePtrArray(size_t count);
 };
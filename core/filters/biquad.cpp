@@ -7,6 +7,11 @@
 #include <algorithm>
 #include <cassert>
 #include <cmath>
+#include <type_traits>
+
+#ifdef HAVE_SSE_INTRINSICS
+#include <xmmintrin.h>
+#endif
 
 #include "alnumbers.h"
 #include "opthelpers.h"
@@ -126,6 +131,47 @@ void BiquadFilterR<Real>::process(const al::span<const Real> src, const al::span
     mZ2 = z2;
 }
 
+template<typename Real>
+void BiquadFilterR<Real>::processZeroStuffed(const al::span<const Real> src, const Real scale,
+    const al::span<Real> dst)
+{
+    if(src.empty()) UNLIKELY
+        return;
+
+    const size_t factor{dst.size() / src.size()};
+    assert(factor > 0 && dst.size() == src.size()*factor);
+
+    const Real b0{mB0};
+    const Real b1{mB1};
+    const Real b2{mB2};
+    const Real a1{mA1};
+    const Real a2{mA2};
+    Real z1{mZ1};
+    Real z2{mZ2};
+
+    auto output = dst.begin();
+    for(const Real sample : src)
+    {
+        const Real input{sample * scale};
+        Real out{input*b0 + z1};
+        z1 = input*b1 - out*a1 + z2;
+        z2 = input*b2 - out*a2;
+        *(output++) = out;
+
+        /* With a zero input, only the feedback terms remain. */
+        for(size_t i{1};i < factor;++i)
+        {
+            out = z1;
+            z1 = z2 - out*a1;
+            z2 = -out*a2;
+            *(output++) = out;
+        }
+    }
+
+    mZ1 = z1;
+    mZ2 = z2;
+}
+
 template<typename Real>
 void BiquadFilterR<Real>::dualProcess(BiquadFilterR &other, const al::span<const Real> src,
     const al::span<Real> dst)
@@ -165,5 +211,357 @@ void BiquadFilterR<Real>::dualProcess(BiquadFilterR &other, const al::span<const
     other.mZ2 = z12;
 }
 
+template<typename Real>
+void BiquadFilterR<Real>::processBlocks(const al::span<const Real> src, const al::span<Real> dst)
+{
+    /* Finding the block response costs more than it saves for a few samples. */
+    if(src.size() < 16)
+        return process(src, dst);
+
+    /* Each block's outputs and ending state are linear combinations of the
+     * block's four inputs and its starting state. Find the contributions of
+     * each by running the filter on each input separately. The first four
+     * rows are the outputs, the last two are the ending z1 and z2.
+     */
+    std::array<std::array<Real,8>,6> response{};
+    for(size_t j{0};j < 6;++j)
+    {
+        std::array<double,6> vals{};
+        vals[j] = 1.0;
+        double z1{vals[4]}, z2{vals[5]};
+        for(size_t i{0};i < 4;++i)
+        {
+            const double output{vals[i]*mB0 + z1};
+            z1 = vals[i]*mB1 - output*mA1 + z2;
+            z2 = vals[i]*mB2 - output*mA2;
+            response[j][i] = static_cast<Real>(output);
+        }
+        response[j][4] = static_cast<Real>(z1);
+        response[j][5] = static_cast<Real>(z2);
+    }
+
+    Real z1{mZ1}, z2{mZ2};
+    const size_t numblocks{src.size() / 4};
+
+#ifdef HAVE_SSE_INTRINSICS
+    if constexpr(std::is_same_v<Real,float>)
+    {
+        /* Keep the outputs in one vector, and the ending state in the low
+         * half of another.
+         */
+        struct SseResponse { __m128 out, state; };
+        std::array<SseResponse,6> resp{};
+        for(size_t j{0};j < 6;++j)
+        {
+            resp[j].out = _mm_loadu_ps(response[j].data());
+            resp[j].state = _mm_loadu_ps(&response[j][4]);
+        }
+
+        __m128 state{_mm_setr_ps(z1, z2, 0.0f, 0.0f)};
+        for(size_t b{0};b < numblocks;++b)
+        {
+            /* The inputs' contributions don't depend on the previous block,
+             * leaving only the state's contribution in the dependency chain.
+             */
+            const __m128 in{_mm_loadu_ps(&src[b*4])};
+            const __m128 x0{_mm_shuffle_ps(in, in, _MM_SHUFFLE(0, 0, 0, 0))};
+            const __m128 x1{_mm_shuffle_ps(in, in, _MM_SHUFFLE(1, 1, 1, 1))};
+            const __m128 x2{_mm_shuffle_ps(in, in, _MM_SHUFFLE(2, 2, 2, 2))};
+            const __m128 x3{_mm_shuffle_ps(in, in, _MM_SHUFFLE(3, 3, 3, 3))};
+            const __m128 inout{_mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(x0, resp[0].out), _mm_mul_ps(x1, resp[1].out)),
+                _mm_add_ps(_mm_mul_ps(x2, resp[2].out), _mm_mul_ps(x3, resp[3].out)))};
+            const __m128 instate{_mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(x0, resp[0].state), _mm_mul_ps(x1, resp[1].state)),
+                _mm_add_ps(_mm_mul_ps(x2, resp[2].state), _mm_mul_ps(x3, resp[3].state)))};
+
+            const __m128 sz1{_mm_shuffle_ps(state, state, _MM_SHUFFLE(0, 0, 0, 0))};
+            const __m128 sz2{_mm_shuffle_ps(state, state, _MM_SHUFFLE(1, 1, 1, 1))};
+            const __m128 out{_mm_add_ps(inout, _mm_add_ps(_mm_mul_ps(sz1, resp[4].out),
+                _mm_mul_ps(sz2, resp[5].out)))};
+            state = _mm_add_ps(instate, _mm_add_ps(_mm_mul_ps(sz1, resp[4].state),
+                _mm_mul_ps(sz2, resp[5].state)));
+            _mm_storeu_ps(&dst[b*4], out);
+        }
+        z1 = _mm_cvtss_f32(state);
+        z2 = _mm_cvtss_f32(_mm_shuffle_ps(state, state, _MM_SHUFFLE(1, 1, 1, 1)));
+    }
+    else
+#endif
+    {
+        for(size_t b{0};b < numblocks;++b)
+        {
+            std::array<Real,6> vals{};
+            std::copy_n(src.begin()+ptrdiff_t(b*4), 4, vals.begin());
+            vals[4] = z1;
+            vals[5] = z2;
+
+            std::array<Real,6> accum{};
+            for(size_t j{0};j < 6;++j)
+            {
+                for(size_t i{0};i < 6;++i)
+                    accum[i] += vals[j] * response[j][i];
+            }
+            std::copy_n(accum.begin(), 4, dst.begin()+ptrdiff_t(b*4));
+            z1 = accum[4];
+            z2 = accum[5];
+        }
+    }
+
+    /* Finish any remaining samples normally. */
+    const Real b0{mB0}, b1{mB1}, b2{mB2}, a1{mA1}, a2{mA2};
+    for(size_t i{numblocks*4};i < src.size();++i)
+    {
+        const Real input{src[i]};
+        const Real output{input*b0 + z1};
+        z1 = input*b1 - output*a1 + z2;
+        z2 = input*b2 - output*a2;
+        dst[i] = output;
+    }
+
+    mZ1 = z1;
+    mZ2 = z2;
+}
+
+template<typename Real>
+void BiquadFilterR<Real>::processChain(const al::span<const al::span<BiquadFilterR>> chains,
+    const al::span<const al::span<const Real>> src, const al::span<const al::span<Real>> dst)
+{
+    const size_t numchans{chains.size()};
+    assert(numchans > 0 && numchans <= ChainLanes);
+    assert(src.size() == numchans && dst.size() == numchans);
+
+    const auto coeffs = chains[0];
+    const size_t numstages{coeffs.size()};
+    assert(numstages <= MaxChainLength);
+    const size_t todo{src[0].size()};
+
+#ifdef HAVE_SSE_INTRINSICS
+    if constexpr(std::is_same_v<Real,float>)
+    {
+        struct SseStage {
+            __m128 b0, b1, b2, a1, a2;
+            __m128 z1, z2;
+        };
+        std::array<SseStage,MaxChainLength> stages{};
+        for(size_t s{0};s < numstages;++s)
+        {
+            alignas(16) std::array<float,ChainLanes> c1{}, c2{};
+            for(size_t c{0};c < numchans;++c)
+            {
+                c1[c] = chains[c][s].mZ1;
+                c2[c] = chains[c][s].mZ2;
+            }
+            stages[s].b0 = _mm_set1_ps(coeffs[s].mB0);
+            stages[s].b1 = _mm_set1_ps(coeffs[s].mB1);
+            stages[s].b2 = _mm_set1_ps(coeffs[s].mB2);
+            stages[s].a1 = _mm_set1_ps(coeffs[s].mA1);
+            stages[s].a2 = _mm_set1_ps(coeffs[s].mA2);
+            stages[s].z1 = _mm_load_ps(c1.data());
+            stages[s].z2 = _mm_load_ps(c2.data());
+        }
+        const auto active = al::span{stages}.first(numstages);
+
+        /* Each lane is one channel's sample, filtered through all the stages
+         * in series.
+         */
+        auto proc_sample = [active](__m128 input) noexcept -> __m128
+        {
+            for(auto &st : active)
+            {
+                const __m128 output{_mm_add_ps(_mm_mul_ps(input, st.b0), st.z1)};
+                st.z1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(input, st.b1),
+                    _mm_mul_ps(output, st.a1)), st.z2);
+                st.z2 = _mm_sub_ps(_mm_mul_ps(input, st.b2), _mm_mul_ps(output, st.a2));
+                input = output;
+            }
+            return input;
+        };
+        auto load_lane = [src,numchans](size_t c, size_t i) noexcept -> __m128
+        { return (c < numchans) ? _mm_loadu_ps(&src[c][i]) : _mm_setzero_ps(); };
+
+        /* Load four samples from each channel and transpose them, so each
+         * vector holds one sample time for all the channels.
+         */
+        size_t i{0};
+        for(;todo-i >= 4;i += 4)
+        {
+            __m128 v0{load_lane(0, i)}, v1{load_lane(1, i)};
+            __m128 v2{load_lane(2, i)}, v3{load_lane(3, i)};
+            _MM_TRANSPOSE4_PS(v0, v1, v2, v3);
+            v0 = proc_sample(v0);
+            v1 = proc_sample(v1);
+            v2 = proc_sample(v2);
+            v3 = proc_sample(v3);
+            _MM_TRANSPOSE4_PS(v0, v1, v2, v3);
+            _mm_storeu_ps(&dst[0][i], v0);
+            if(numchans > 1) _mm_storeu_ps(&dst[1][i], v1);
+            if(numchans > 2) _mm_storeu_ps(&dst[2][i], v2);
+            if(numchans > 3) _mm_storeu_ps(&dst[3][i], v3);
+        }
+        for(;i < todo;++i)
+        {
+            alignas(16) std::array<float,ChainLanes> vals{};
+            for(size_t c{0};c < numchans;++c)
+                vals[c] = src[c][i];
+            _mm_store_ps(vals.data(), proc_sample(_mm_load_ps(vals.data())));
+            for(size_t c{0};c < numchans;++c)
+                dst[c][i] = vals[c];
+        }
+
+        for(size_t s{0};s < numstages;++s)
+        {
+            alignas(16) std::array<float,ChainLanes> c1{}, c2{};
+            _mm_store_ps(c1.data(), stages[s].z1);
+            _mm_store_ps(c2.data(), stages[s].z2);
+            for(size_t c{0};c < numchans;++c)
+            {
+                chains[c][s].mZ1 = c1[c];
+                chains[c][s].mZ2 = c2[c];
+            }
+        }
+        return;
+    }
+#endif
+
+    /* Without SIMD intrinsics, keep the lanes in arrays that the compiler can
+     * vectorize the per-stage operations over.
+     */
+    using LaneArray = std::array<Real,ChainLanes>;
+    std::array<LaneArray,MaxChainLength> z1{}, z2{};
+    for(size_t s{0};s < numstages;++s)
+    {
+        for(size_t c{0};c < numchans;++c)
+        {
+            z1[s][c] = chains[c][s].mZ1;
+            z2[s][c] = chains[c][s].mZ2;
+        }
+    }
+
+    for(size_t i{0};i < todo;++i)
+    {
+        LaneArray vals{};
+        for(size_t c{0};c < numchans;++c)
+            vals[c] = src[c][i];
+        for(size_t s{0};s < numstages;++s)
+        {
+            const Real b0{coeffs[s].mB0}, b1{coeffs[s].mB1}, b2{coeffs[s].mB2};
+            const Real a1{coeffs[s].mA1}, a2{coeffs[s].mA2};
+            for(size_t c{0};c < ChainLanes;++c)
+            {
+                const Real output{vals[c]*b0 + z1[s][c]};
+                z1[s][c] = vals[c]*b1 - output*a1 + z2[s][c];
+                z2[s][c] = vals[c]*b2 - output*a2;
+                vals[c] = output;
+            }
+        }
+        for(size_t c{0};c < numchans;++c)
+            dst[c][i] = vals[c];
+    }
+
+    for(size_t s{0};s < numstages;++s)
+    {
+        for(size_t c{0};c < numchans;++c)
+        {
+            chains[c][s].mZ1 = z1[s][c];
+            chains[c][s].mZ2 = z2[s][c];
+        }
+    }
+}
+
+template<typename Real>
+void BiquadFilterR<Real>::processFanout(const al::span<BiquadFilterR*const> filters,
+    const al::span<const Real> src, const al::span<const al::span<Real>> dst)
+{
+    const size_t numfilters{filters.size()};
+    assert(numfilters > 0 && numfilters <= ChainLanes);
+    assert(dst.size() == numfilters);
+
+    /* Unused lanes get zeroed coefficients and state, and stay silent. */
+    using LaneArray = std::array<Real,ChainLanes>;
+    alignas(16) LaneArray b0{}, b1{}, b2{}, a1{}, a2{}, z1{}, z2{};
+    for(size_t f{0};f < numfilters;++f)
+    {
+        b0[f] = filters[f]->mB0;
+        b1[f] = filters[f]->mB1;
+        b2[f] = filters[f]->mB2;
+        a1[f] = filters[f]->mA1;
+        a2[f] = filters[f]->mA2;
+        z1[f] = filters[f]->mZ1;
+        z2[f] = filters[f]->mZ2;
+    }
+    auto store_state = [filters,numfilters,&z1,&z2]() noexcept
+    {
+        for(size_t f{0};f < numfilters;++f)
+        {
+            filters[f]->mZ1 = z1[f];
+            filters[f]->mZ2 = z2[f];
+        }
+    };
+
+#ifdef HAVE_SSE_INTRINSICS
+    if constexpr(std::is_same_v<Real,float>)
+    {
+        const __m128 vb0{_mm_load_ps(b0.data())}, vb1{_mm_load_ps(b1.data())};
+        const __m128 vb2{_mm_load_ps(b2.data())};
+        const __m128 va1{_mm_load_ps(a1.data())}, va2{_mm_load_ps(a2.data())};
+        __m128 vz1{_mm_load_ps(z1.data())}, vz2{_mm_load_ps(z2.data())};
+
+        /* Each lane is the same input sample, run through a different filter. */
+        auto proc_sample = [&](const float sample) noexcept -> __m128
+        {
+            const __m128 input{_mm_set1_ps(sample)};
+            const __m128 output{_mm_add_ps(_mm_mul_ps(input, vb0), vz1)};
+            vz1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(input, vb1), _mm_mul_ps(output, va1)), vz2);
+            vz2 = _mm_sub_ps(_mm_mul_ps(input, vb2), _mm_mul_ps(output, va2));
+            return output;
+        };
+
+        /* Filter four samples and transpose them, so each vector holds four
+         * samples from one filter.
+         */
+        size_t i{0};
+        for(;src.size()-i >= 4;i += 4)
+        {
+            __m128 v0{proc_sample(src[i])}, v1{proc_sample(src[i+1])};
+            __m128 v2{proc_sample(src[i+2])}, v3{proc_sample(src[i+3])};
+            _MM_TRANSPOSE4_PS(v0, v1, v2, v3);
+            _mm_storeu_ps(&dst[0][i], v0);
+            if(numfilters > 1) _mm_storeu_ps(&dst[1][i], v1);
+            if(numfilters > 2) _mm_storeu_ps(&dst[2][i], v2);
+            if(numfilters > 3) _mm_storeu_ps(&dst[3][i], v3);
+        }
+        for(;i < src.size();++i)
+        {
+            alignas(16) LaneArray vals{};
+            _mm_store_ps(vals.data(), proc_sample(src[i]));
+            for(size_t f{0};f < numfilters;++f)
+                dst[f][i] = vals[f];
+        }
+
+        _mm_store_ps(z1.data(), vz1);
+        _mm_store_ps(z2.data(), vz2);
+        store_state();
+        return;
+    }
+#endif
+
+    for(size_t i{0};i < src.size();++i)
+    {
+        const Real input{src[i]};
+        LaneArray vals{};
+        for(size_t f{0};f < ChainLanes;++f)
+        {
+            const Real output{input*b0[f] + z1[f]};
+            z1[f] = input*b1[f] - output*a1[f] + z2[f];
+            z2[f] = input*b2[f] - output*a2[f];
+            vals[f] = output;
+        }
+        for(size_t f{0};f < numfilters;++f)
+            dst[f][i] = vals[f];
+    }
+    store_state();
+}
+
 template class BiquadFilterR<float>;
 template class BiquadFilterR<double>;
@@ -70,6 +70,12 @@ class BiquadFilterR {
     }
 
 public:
+    /* The number of channels processChain can filter at once, and the most
+     * filters each channel's chain can have.
+     */
+    static constexpr std::size_t ChainLanes{4};
+    static constexpr std::size_t MaxChainLength{4};
+
     void clear() noexcept { mZ1 = mZ2 = Real{0}; }
 
     /**
@@ -115,10 +121,43 @@ public:
     }
 
     void process(const al::span<const Real> src, const al::span<Real> dst);
+    /**
+     * Processes the filter four samples at a time, using the filter's
+     * combined response over each block. This shortens the dependency chain
+     * between samples so the blocks can be computed with SIMD, and only
+     * differs from process by rounding.
+     */
+    void processBlocks(const al::span<const Real> src, const al::span<Real> dst);
+    /**
+     * Upsamples src into dst by zero stuffing, using the filter to
+     * interpolate. Each input sample is scaled and followed by zeros, filling
+     * dst.size()/src.size() output samples, and the filter skips the
+     * multiplies with the stuffed zeros. Gives the same output as process on
+     * the zero-stuffed input.
+     */
+    void processZeroStuffed(const al::span<const Real> src, const Real scale,
+        const al::span<Real> dst);
     /** Processes this filter and the other at the same time. */
     void dualProcess(BiquadFilterR &other, const al::span<const Real> src,
         const al::span<Real> dst);
 
+    /**
+     * Processes up to ChainLanes channels through a series of filters at the
+     * same time, with each channel in its own SIMD lane. Every channel uses
+     * the coefficients of the first channel's filters, but keeps its own
+     * filter state.
+     */
+    static void processChain(const al::span<const al::span<BiquadFilterR>> chains,
+        const al::span<const al::span<const Real>> src, const al::span<const al::span<Real>> dst);
+
+    /**
+     * Processes one source through up to ChainLanes filters at the same time,
+     * with each filter in its own SIMD lane using its own coefficients and
+     * state. Each filter's output is written to the matching dst.
+     */
+    static void processFanout(const al::span<BiquadFilterR*const> filters,
+        const al::span<const Real> src, const al::span<const al::span<Real>> dst);
+
     /* Rather hacky. It's just here to support "manual" processing. */
     [[nodiscard]] auto getComponents() const noexcept -> std::pair<Real,Real> { return {mZ1, mZ2}; }
     void setComponents(Real z1, Real z2) noexcept { mZ1 = z1; mZ2 = z2; }
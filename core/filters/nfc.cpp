@@ -4,6 +4,11 @@
 #include "nfc.h"
 
 #include <algorithm>
+#include <cassert>
+
+#ifdef HAVE_SSE_INTRINSICS
+#include <xmmintrin.h>
+#endif
 
 #include "opthelpers.h"
 
@@ -355,3 +360,108 @@ void NfcFilter::process4(const al::span<const float> src, const al::span<float>
     fourth.z[2] = z3;
     fourth.z[3] = z4;
 }
+
+void NfcFilter::processOrders(const al::span<const float> src,
+    const al::span<const al::span<float>> dsts)
+{
+    assert(dsts.size() <= 4);
+#ifdef HAVE_SSE_INTRINSICS
+    /* Each order's filter goes in its own lane. The first-order filter is the
+     * first section of the others with no second coefficient, and the first-
+     * and second-order filters have no second section. The unused
+     * coefficients are 0, and the unused states are kept at 0 by scaling
+     * their updates by 0, so the results match the separate filters.
+     */
+    alignas(16) std::array<float,4> vals{first.gain, second.gain, third.gain, fourth.gain};
+    const __m128 gain{_mm_load_ps(vals.data())};
+    vals = {first.b1, second.b1, third.b1, fourth.b1};
+    const __m128 b1{_mm_load_ps(vals.data())};
+    vals = {0.0f, second.b2, third.b2, fourth.b2};
+    const __m128 b2{_mm_load_ps(vals.data())};
+    vals = {0.0f, 0.0f, third.b3, fourth.b3};
+    const __m128 b3{_mm_load_ps(vals.data())};
+    vals = {0.0f, 0.0f, 0.0f, fourth.b4};
+    const __m128 b4{_mm_load_ps(vals.data())};
+    vals = {first.a1, second.a1, third.a1, fourth.a1};
+    const __m128 a1{_mm_load_ps(vals.data())};
+    vals = {0.0f, second.a2, third.a2, fourth.a2};
+    const __m128 a2{_mm_load_ps(vals.data())};
+    vals = {0.0f, 0.0f, third.a3, fourth.a3};
+    const __m128 a3{_mm_load_ps(vals.data())};
+    vals = {0.0f, 0.0f, 0.0f, fourth.a4};
+    const __m128 a4{_mm_load_ps(vals.data())};
+
+    const __m128 mask2{_mm_setr_ps(0.0f, 1.0f, 1.0f, 1.0f)};
+    const __m128 mask3{_mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f)};
+    const __m128 mask4{_mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f)};
+
+    vals = {first.z[0], second.z[0], third.z[0], fourth.z[0]};
+    __m128 z1{_mm_load_ps(vals.data())};
+    vals = {0.0f, second.z[1], third.z[1], fourth.z[1]};
+    __m128 z2{_mm_load_ps(vals.data())};
+    vals = {0.0f, 0.0f, third.z[2], fourth.z[2]};
+    __m128 z3{_mm_load_ps(vals.data())};
+    vals = {0.0f, 0.0f, 0.0f, fourth.z[3]};
+    __m128 z4{_mm_load_ps(vals.data())};
+
+    auto proc_sample = [&](const float input) noexcept -> __m128
+    {
+        const __m128 in{_mm_set1_ps(input)};
+        __m128 y{_mm_sub_ps(_mm_sub_ps(_mm_mul_ps(in, gain), _mm_mul_ps(a1, z1)),
+            _mm_mul_ps(a2, z2))};
+        __m128 out{_mm_add_ps(_mm_add_ps(y, _mm_mul_ps(b1, z1)), _mm_mul_ps(b2, z2))};
+        z2 = _mm_add_ps(z2, _mm_mul_ps(z1, mask2));
+        z1 = _mm_add_ps(z1, y);
+
+        y = _mm_sub_ps(_mm_sub_ps(out, _mm_mul_ps(a3, z3)), _mm_mul_ps(a4, z4));
+        out = _mm_add_ps(_mm_add_ps(y, _mm_mul_ps(b3, z3)), _mm_mul_ps(b4, z4));
+        z4 = _mm_add_ps(z4, _mm_mul_ps(z3, mask4));
+        z3 = _mm_add_ps(z3, _mm_mul_ps(y, mask3));
+        return out;
+    };
+    auto store_order = [dsts](const size_t order, const size_t i, const __m128 value) noexcept
+    {
+        if(order < dsts.size())
+            _mm_storeu_ps(&dsts[order][i], value);
+    };
+
+    /* Each result holds one sample for all the orders, so transpose groups of
+     * four to get four samples for each order.
+     */
+    const size_t todo{src.size()};
+    size_t i{0};
+    for(;todo-i >= 4;i += 4)
+    {
+        __m128 v0{proc_sample(src[i+0])}, v1{proc_sample(src[i+1])};
+        __m128 v2{proc_sample(src[i+2])}, v3{proc_sample(src[i+3])};
+        _MM_TRANSPOSE4_PS(v0, v1, v2, v3);
+        store_order(0, i, v0);
+        store_order(1, i, v1);
+        store_order(2, i, v2);
+        store_order(3, i, v3);
+    }
+    for(;i < todo;++i)
+    {
+        _mm_store_ps(vals.data(), proc_sample(src[i]));
+        for(size_t order{0};order < dsts.size();++order)
+            dsts[order][i] = vals[order];
+    }
+
+    _mm_store_ps(vals.data(), z1);
+    first.z[0] = vals[0]; second.z[0] = vals[1]; third.z[0] = vals[2]; fourth.z[0] = vals[3];
+    _mm_store_ps(vals.data(), z2);
+    second.z[1] = vals[1]; third.z[1] = vals[2]; fourth.z[1] = vals[3];
+    _mm_store_ps(vals.data(), z3);
+    third.z[2] = vals[2]; fourth.z[2] = vals[3];
+    _mm_store_ps(vals.data(), z4);
+    fourth.z[3] = vals[3];
+
+#else
+
+    using FilterProc = void (NfcFilter::*)(const al::span<const float>, const al::span<float>);
+    static constexpr std::array<FilterProc,4> NfcProcess{{&NfcFilter::process1,
+        &NfcFilter::process2, &NfcFilter::process3, &NfcFilter::process4}};
+    for(size_t order{0};order < dsts.size();++order)
+        (this->*NfcProcess[order])(src, dsts[order]);
+#endif
+}
@@ -59,6 +59,14 @@ public:
 
     /* Near-field control filter for fourth-order ambisonic channels (16-24). */
     void process4(const al::span<const float> src, const al::span<float> dst);
+
+    /**
+     * Applies the near-field control filters for multiple orders at once,
+     * writing the first-order result to dsts[0], second-order to dsts[1], and
+     * so on, for up to four orders. The filters run together, each in its own
+     * SIMD lane.
+     */
+    void processOrders(const al::span<const float> src, const al::span<const al::span<float>> dsts);
 };
 
 #endif /* CORE_FILTERS_NFC_H */
@@ -8,6 +8,10 @@
 #include <cmath>
 #include <limits>
 
+#ifdef HAVE_SSE_INTRINSICS
+#include <xmmintrin.h>
+#endif
+
 #include "alnumbers.h"
 #include "opthelpers.h"
 
@@ -179,5 +183,203 @@ void BandSplitterR<Real>::processAllPass(const al::span<Real> samples)
 }
 
 
+void SplitBandsMulti(const al::span<BandSplitter*const> splitters,
+    const al::span<const al::span<const float>> inputs,
+    const al::span<const al::span<float>> hpouts, const al::span<const al::span<float>> lpouts,
+    const size_t todo)
+{
+    assert(inputs.size() >= splitters.size());
+    assert(hpouts.size() >= splitters.size() && lpouts.size() >= splitters.size());
+    if(splitters.empty() || todo == 0)
+        return;
+
+#ifdef HAVE_SSE_INTRINSICS
+    static constexpr size_t NumLanes{4};
+
+    const float coeff{splitters[0]->mCoeff};
+    const __m128 ap_coeff{_mm_set1_ps(coeff)};
+    const __m128 lp_coeff{_mm_set1_ps(coeff*0.5f + 0.5f)};
+    for(size_t base{0};base < splitters.size();base += NumLanes)
+    {
+        const size_t numchans{std::min(splitters.size()-base, NumLanes)};
+        const auto group = splitters.subspan(base, numchans);
+
+        /* Each channel goes in its own lane, sharing the same coefficients. */
+        alignas(16) std::array<float,NumLanes> vals1{}, vals2{}, vals3{};
+        for(size_t c{0};c < numchans;++c)
+        {
+            assert(group[c]->mCoeff == coeff);
+            vals1[c] = group[c]->mLpZ1;
+            vals2[c] = group[c]->mLpZ2;
+            vals3[c] = group[c]->mApZ1;
+        }
+        __m128 lp_z1{_mm_load_ps(vals1.data())};
+        __m128 lp_z2{_mm_load_ps(vals2.data())};
+        __m128 ap_z1{_mm_load_ps(vals3.data())};
+
+        auto proc_sample = [ap_coeff,lp_coeff,&lp_z1,&lp_z2,&ap_z1](const __m128 in,
+            __m128 &lpout) noexcept -> __m128
+        {
+            __m128 d{_mm_mul_ps(_mm_sub_ps(in, lp_z1), lp_coeff)};
+            __m128 lp_y{_mm_add_ps(lp_z1, d)};
+            lp_z1 = _mm_add_ps(lp_y, d);
+
+            d = _mm_mul_ps(_mm_sub_ps(lp_y, lp_z2), lp_coeff);
+            lp_y = _mm_add_ps(lp_z2, d);
+            lp_z2 = _mm_add_ps(lp_y, d);
+
+            lpout = lp_y;
+
+            const __m128 ap_y{_mm_add_ps(_mm_mul_ps(in, ap_coeff), ap_z1)};
+            ap_z1 = _mm_sub_ps(in, _mm_mul_ps(ap_y, ap_coeff));
+
+            return _mm_sub_ps(ap_y, lp_y);
+        };
+        auto load_lane = [inputs,base,numchans](const size_t c, const size_t i) noexcept
+        { return (c < numchans) ? _mm_loadu_ps(&inputs[base+c][i]) : _mm_setzero_ps(); };
+        auto store_lane = [base,numchans](const al::span<const al::span<float>> outs,
+            const size_t c, const size_t i, const __m128 value) noexcept
+        {
+            if(c < numchans)
+                _mm_storeu_ps(&outs[base+c][i], value);
+        };
+
+        /* Transpose four samples from each channel, so each vector holds one
+         * sample time for all the channels, and transpose the results back.
+         */
+        size_t i{0};
+        for(;todo-i >= 4;i += 4)
+        {
+            __m128 v0{load_lane(0, i)}, v1{load_lane(1, i)};
+            __m128 v2{load_lane(2, i)}, v3{load_lane(3, i)};
+            _MM_TRANSPOSE4_PS(v0, v1, v2, v3);
+            __m128 l0, l1, l2, l3;
+            v0 = proc_sample(v0, l0);
+            v1 = proc_sample(v1, l1);
+            v2 = proc_sample(v2, l2);
+            v3 = proc_sample(v3, l3);
+            _MM_TRANSPOSE4_PS(v0, v1, v2, v3);
+            _MM_TRANSPOSE4_PS(l0, l1, l2, l3);
+            store_lane(hpouts, 0, i, v0); store_lane(lpouts, 0, i, l0);
+            store_lane(hpouts, 1, i, v1); store_lane(lpouts, 1, i, l1);
+            store_lane(hpouts, 2, i, v2); store_lane(lpouts, 2, i, l2);
+            store_lane(hpouts, 3, i, v3); store_lane(lpouts, 3, i, l3);
+        }
+        for(;i < todo;++i)
+        {
+            for(size_t c{0};c < numchans;++c)
+                vals1[c] = inputs[base+c][i];
+            __m128 lp;
+            _mm_store_ps(vals1.data(), proc_sample(_mm_load_ps(vals1.data()), lp));
+            _mm_store_ps(vals2.data(), lp);
+            for(size_t c{0};c < numchans;++c)
+            {
+                hpouts[base+c][i] = vals1[c];
+                lpouts[base+c][i] = vals2[c];
+            }
+        }
+
+        _mm_store_ps(vals1.data(), lp_z1);
+        _mm_store_ps(vals2.data(), lp_z2);
+        _mm_store_ps(vals3.data(), ap_z1);
+        for(size_t c{0};c < numchans;++c)
+        {
+            group[c]->mLpZ1 = vals1[c];
+            group[c]->mLpZ2 = vals2[c];
+            group[c]->mApZ1 = vals3[c];
+        }
+    }
+
+#else
+
+    for(size_t c{0};c < splitters.size();++c)
+        splitters[c]->process(inputs[c].first(todo), hpouts[c].first(todo),
+            lpouts[c].first(todo));
+#endif
+}
+
+
 template class BandSplitterR<float>;
 template class BandSplitterR<double>;
+
+void AllPassMulti(const al::span<BandSplitter*const> splitters,
+    const al::span<const al::span<float>> samples, const size_t todo)
+{
+    assert(samples.size() >= splitters.size());
+    if(splitters.empty() || todo == 0)
+        return;
+
+#ifdef HAVE_SSE_INTRINSICS
+    static constexpr size_t NumLanes{4};
+
+    /* The state update is rearranged to not depend on the output, which
+     * shortens the dependency chain from one sample to the next:
+     * z1' = in - (in*coeff + z1)*coeff = in*(1 - coeff*coeff) - z1*coeff
+     */
+    const float coeff{splitters[0]->mCoeff};
+    const __m128 ap_coeff{_mm_set1_ps(coeff)};
+    const __m128 in_coeff{_mm_set1_ps(1.0f - coeff*coeff)};
+    for(size_t base{0};base < splitters.size();base += NumLanes)
+    {
+        const size_t numchans{std::min(splitters.size()-base, NumLanes)};
+        const auto group = splitters.subspan(base, numchans);
+
+        alignas(16) std::array<float,NumLanes> vals{};
+        for(size_t c{0};c < numchans;++c)
+        {
+            assert(group[c]->mCoeff == coeff);
+            vals[c] = group[c]->mApZ1;
+        }
+        __m128 ap_z1{_mm_load_ps(vals.data())};
+
+        auto proc_sample = [ap_coeff,in_coeff,&ap_z1](const __m128 in) noexcept -> __m128
+        {
+            const __m128 ap_y{_mm_add_ps(_mm_mul_ps(in, ap_coeff), ap_z1)};
+            ap_z1 = _mm_sub_ps(_mm_mul_ps(in, in_coeff), _mm_mul_ps(ap_z1, ap_coeff));
+            return ap_y;
+        };
+        auto load_lane = [samples,base,numchans](const size_t c, const size_t i) noexcept
+        { return (c < numchans) ? _mm_loadu_ps(&samples[base+c][i]) : _mm_setzero_ps(); };
+        auto store_lane = [samples,base,numchans](const size_t c, const size_t i,
+            const __m128 value) noexcept
+        {
+            if(c < numchans)
+                _mm_storeu_ps(&samples[base+c][i], value);
+        };
+
+        size_t i{0};
+        for(;todo-i >= 4;i += 4)
+        {
+            __m128 v0{load_lane(0, i)}, v1{load_lane(1, i)};
+            __m128 v2{load_lane(2, i)}, v3{load_lane(3, i)};
+            _MM_TRANSPOSE4_PS(v0, v1, v2, v3);
+            v0 = proc_sample(v0);
+            v1 = proc_sample(v1);
+            v2 = proc_sample(v2);
+            v3 = proc_sample(v3);
+            _MM_TRANSPOSE4_PS(v0, v1, v2, v3);
+            store_lane(0, i, v0);
+            store_lane(1, i, v1);
+            store_lane(2, i, v2);
+            store_lane(3, i, v3);
+        }
+        for(;i < todo;++i)
+        {
+            for(size_t c{0};c < numchans;++c)
+                vals[c] = samples[base+c][i];
+            _mm_store_ps(vals.data(), proc_sample(_mm_load_ps(vals.data())));
+            for(size_t c{0};c < numchans;++c)
+                samples[base+c][i] = vals[c];
+        }
+
+        _mm_store_ps(vals.data(), ap_z1);
+        for(size_t c{0};c < numchans;++c)
+            group[c]->mApZ1 = vals[c];
+    }
+
+#else
+
+    for(size_t c{0};c < splitters.size();++c)
+        splitters[c]->processAllPass(samples[c].first(todo));
+#endif
+}
@@ -7,6 +7,17 @@
 
 
 /* Band splitter. Splits a signal into two phase-matching frequency bands. */
+template<typename Real>
+class BandSplitterR;
+using BandSplitter = BandSplitterR<float>;
+
+void SplitBandsMulti(const al::span<BandSplitter*const> splitters,
+    const al::span<const al::span<const float>> inputs,
+    const al::span<const al::span<float>> hpouts, const al::span<const al::span<float>> lpouts,
+    const size_t todo);
+void AllPassMulti(const al::span<BandSplitter*const> splitters,
+    const al::span<const al::span<float>> samples, const size_t todo);
+
 template<typename Real>
 class BandSplitterR {
     Real mCoeff{0.0f};
@@ -36,7 +47,24 @@ public:
      * without splitting or scaling the signal.
      */
     void processAllPass(const al::span<Real> samples);
+
+    /**
+     * Splits multiple channels at once, each with its own splitter. The
+     * splitters must all share the same crossover frequency, letting four
+     * channels be processed together with each one's state in a SIMD lane.
+     * Only the first todo samples of each input and output are used.
+     */
+    friend void SplitBandsMulti(const al::span<BandSplitter*const> splitters,
+        const al::span<const al::span<const float>> inputs,
+        const al::span<const al::span<float>> hpouts, const al::span<const al::span<float>> lpouts,
+        const size_t todo);
+
+    /**
+     * Applies the all-pass to multiple channels at once, in place, like
+     * SplitBandsMulti.
+     */
+    friend void AllPassMulti(const al::span<BandSplitter*const> splitters,
+        const al::span<const al::span<float>> samples, const size_t todo);
 };
-using BandSplitter = BandSplitterR<float>;
 
 #endif /* CORE_FILTERS_SPLITTER_H */
@@ -4,6 +4,7 @@
 #include <array>
 #include <cstdint>
 
+#include "albit.h"
 #include "storage_formats.h"
 
 
@@ -63,6 +64,23 @@ struct FmtTypeTraits<FmtAlaw> {
     constexpr float operator()(const Type val) const noexcept
     { return float(aLawDecompressionTable[val]) * (1.0f/32768.0f); }
 };
+template<>
+struct FmtTypeTraits<FmtHalf> {
+    using Type = std::uint16_t;
+
+    float operator()(const Type val) const noexcept
+    {
+        /* Shifting the exponent and mantissa into place and scaling by the
+         * difference in exponent bias (2^112) gives the magnitude of normal
+         * and subnormal values. Infinity and NaN keep the max exponent.
+         */
+        const std::uint32_t bits{static_cast<std::uint32_t>(val&0x7fff) << 13};
+        const float mag{((val&0x7c00) == 0x7c00) ? al::bit_cast<float>(bits | 0x7f800000u)
+            : al::bit_cast<float>(bits) * 0x1p112f};
+        return al::bit_cast<float>(al::bit_cast<std::uint32_t>(mag)
+            | (static_cast<std::uint32_t>(val&0x8000) << 16));
+    }
+};
 
 } // namespace al
 
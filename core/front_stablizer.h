@@ -11,11 +11,17 @@
 
 
 struct FrontStablizer {
-    FrontStablizer(size_t numchans) : ChannelFilters{numchans} { }
+    FrontStablizer(size_t numchans, size_t lidx, size_t ridx, size_t cidx)
+        : LeftIdx{lidx}, RightIdx{ridx}, CenterIdx{cidx}, ChannelFilters{numchans}
+    { }
+
+    /* The decoder outputs the mid (left+right) signal to the left channel and
+     * the side (left-right) signal to the right channel, for the stablizer to
+     * recombine.
+     */
+    size_t LeftIdx, RightIdx, CenterIdx;
 
     alignas(16) std::array<float,BufferLineSize> MidDirect{};
-    alignas(16) std::array<float,BufferLineSize> Side{};
-    alignas(16) std::array<float,BufferLineSize> Temp{};
 
     BandSplitter MidFilter;
     alignas(16) FloatBufferLine MidLF{};
@@ -23,8 +29,12 @@ struct FrontStablizer {
 
     al::FlexArray<BandSplitter,16> ChannelFilters;
 
-    static std::unique_ptr<FrontStablizer> Create(size_t numchans)
-    { return std::unique_ptr<FrontStablizer>{new(FamCount(numchans)) FrontStablizer{numchans}}; }
+    static std::unique_ptr<FrontStablizer> Create(size_t numchans, size_t lidx, size_t ridx,
+        size_t cidx)
+    {
+        return std::unique_ptr<FrontStablizer>{new(FamCount(numchans))
+            FrontStablizer{numchans, lidx, ridx, cidx}};
+    }
 
     DEF_FAM_NEWDEL(FrontStablizer, ChannelFilters)
 };
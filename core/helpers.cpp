@@ -173,9 +173,41 @@ std::vector<std::string> SearchDataFiles(const std::string_view ext, const std::
     return results;
 }
 
+std::string GetCachePath(const std::string_view subdir)
+{
+#if !defined(ALSOFT_UWP) && !defined(_GAMING_XBOX)
+    std::unique_ptr<WCHAR,CoTaskMemDeleter> buffer;
+    const HRESULT hr{SHGetKnownFolderPath(FOLDERID_LocalAppData, KF_FLAG_DONT_UNEXPAND, nullptr,
+        al::out_ptr(buffer))};
+    if(SUCCEEDED(hr) && buffer && *buffer)
+        return (std::filesystem::path{buffer.get()}/std::filesystem::u8path(subdir)).u8string();
+#endif
+    return std::string{};
+}
+
 void SetRTPriority()
 {
+    /* Messages from this thread now go through the log thread, so writing
+     * them out can't stall the mixer.
+     */
+    al_log_enter_realtime();
 #if !defined(ALSOFT_UWP)
+    if(!RTCpuAffinity.empty())
+    {
+        DWORD_PTR mask{0};
+        for(const unsigned int cpu : RTCpuAffinity)
+        {
+            if(cpu < sizeof(mask)*8)
+                mask |= DWORD_PTR{1} << cpu;
+        }
+        if(!mask || !SetThreadAffinityMask(GetCurrentThread(), mask))
+            ERR("Failed to set CPU affinity for thread\n");
+    }
+    if(RTLockMemory)
+    {
+        static std::once_flag once;
+        std::call_once(once, []{ WARN("Memory locking not supported\n"); });
+    }
     if(RTPrioLevel > 0)
     {
         if(!SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL))
@@ -184,6 +216,16 @@ void SetRTPriority()
 #endif
 }
 
+bool LockMemoryRange(const void *ptr [[maybe_unused]], std::size_t size [[maybe_unused]])
+{
+#if !defined(ALSOFT_UWP)
+    /* NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast) */
+    return VirtualLock(const_cast<void*>(ptr), size) != FALSE;
+#else
+    return false;
+#endif
+}
+
 #else
 
 #include <cerrno>
@@ -202,6 +244,9 @@ void SetRTPriority()
 #include <pthread.h>
 #include <sched.h>
 #endif
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
 #ifdef HAVE_RTKIT
 #include <sys/resource.h>
 
@@ -345,27 +390,38 @@ std::vector<std::string> SearchDataFiles(const std::string_view ext, const std::
     return results;
 }
 
+std::string GetCachePath(const std::string_view subdir)
+{
+    const auto path = std::filesystem::u8path(subdir);
+    if(auto cachepath = al::getenv("XDG_CACHE_HOME"); cachepath && !cachepath->empty())
+        return (std::filesystem::path{*cachepath}/path).u8string();
+    if(auto homepath = al::getenv("HOME"); homepath && !homepath->empty())
+        return (std::filesystem::path{*homepath}/".cache"/path).u8string();
+    return std::string{};
+}
+
 namespace {
 
 bool SetRTPriorityPthread(int prio [[maybe_unused]])
 {
     int err{ENOTSUP};
 #if defined(HAVE_PTHREAD_SETSCHEDPARAM) && !defined(__OpenBSD__)
-    /* Get the min and max priority for SCHED_RR. Limit the max priority to
+    /* Get the min and max priority for the policy. Limit the max priority to
      * half, for now, to ensure the thread can't take the highest priority and
      * go rogue.
      */
-    int rtmin{sched_get_priority_min(SCHED_RR)};
-    int rtmax{sched_get_priority_max(SCHED_RR)};
+    const int policy{RTUseFifo ? SCHED_FIFO : SCHED_RR};
+    int rtmin{sched_get_priority_min(policy)};
+    int rtmax{sched_get_priority_max(policy)};
     rtmax = (rtmax-rtmin)/2 + rtmin;
 
     struct sched_param param{};
     param.sched_priority = std::clamp(prio, rtmin, rtmax);
 #ifdef SCHED_RESET_ON_FORK
-    err = pthread_setschedparam(pthread_self(), SCHED_RR|SCHED_RESET_ON_FORK, &param);
+    err = pthread_setschedparam(pthread_self(), policy|SCHED_RESET_ON_FORK, &param);
     if(err == EINVAL)
 #endif
-        err = pthread_setschedparam(pthread_self(), SCHED_RR, &param);
+        err = pthread_setschedparam(pthread_self(), policy, &param);
     if(err == 0) return true;
 #endif
     WARN("pthread_setschedparam failed: %s (%d)\n", std::generic_category().message(err).c_str(),
@@ -473,10 +529,60 @@ bool SetRTPriorityRTKit(int prio [[maybe_unused]])
     return false;
 }
 
+void SetRTAffinity()
+{
+#if defined(__linux__) && defined(HAVE_PTHREAD_SETSCHEDPARAM)
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    for(const unsigned int cpu : RTCpuAffinity)
+    {
+        if(cpu < CPU_SETSIZE)
+            CPU_SET(cpu, &cpuset);
+    }
+    const int err{CPU_COUNT(&cpuset) ? pthread_setaffinity_np(pthread_self(), sizeof(cpuset),
+        &cpuset) : EINVAL};
+    if(err == 0) return;
+    WARN("pthread_setaffinity_np failed: %s (%d)\n",
+        std::generic_category().message(err).c_str(), err);
+#else
+    WARN("CPU affinity not supported\n");
+#endif
+}
+
+void LockMemory()
+{
+#ifdef __linux__
+    /* Lock what's currently mapped, which also faults in the mixing buffers
+     * that are already allocated, and anything mapped later. This is process-
+     * wide so only needs to happen once.
+     */
+    if(mlockall(MCL_CURRENT | MCL_FUTURE) == 0)
+    {
+        TRACE("Locked process memory\n");
+        return;
+    }
+    WARN("mlockall failed: %s (%d)\n", std::generic_category().message(errno).c_str(), errno);
+#else
+    WARN("Memory locking not supported\n");
+#endif
+}
+
 } // namespace
 
 void SetRTPriority()
 {
+    /* Messages from this thread now go through the log thread, so writing
+     * them out can't stall the mixer.
+     */
+    al_log_enter_realtime();
+    if(!RTCpuAffinity.empty())
+        SetRTAffinity();
+    if(RTLockMemory)
+    {
+        static std::once_flag once;
+        std::call_once(once, LockMemory);
+    }
+
     if(RTPrioLevel <= 0)
         return;
 
@@ -486,4 +592,13 @@ void SetRTPriority()
         return;
 }
 
+bool LockMemoryRange(const void *ptr [[maybe_unused]], std::size_t size [[maybe_unused]])
+{
+#ifdef __linux__
+    return mlock(ptr, size) == 0;
+#else
+    return false;
+#endif
+}
+
 #endif
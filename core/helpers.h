@@ -1,6 +1,7 @@
 #ifndef CORE_HELPERS_H
 #define CORE_HELPERS_H
 
+#include <cstddef>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -17,8 +18,27 @@ inline int RTPrioLevel{1};
 /* Allow reducing the process's RTTime limit for RTKit. */
 inline bool AllowRTTimeLimit{true};
 
+/* Use the FIFO real-time policy instead of round-robin for the mixing thread. */
+inline bool RTUseFifo{false};
+
+/* CPUs the mixing thread is restricted to. Empty allows any CPU. */
+inline std::vector<unsigned int> RTCpuAffinity;
+
+/* Lock the process's memory so the mixing thread doesn't page fault. */
+inline bool RTLockMemory{false};
+
 void SetRTPriority();
 
+/* Faults in and locks the given memory range into RAM, so the mixer won't stall
+ * on a page fault when accessing it. Returns false if it couldn't be locked.
+ */
+bool LockMemoryRange(const void *ptr, std::size_t size);
+
 std::vector<std::string> SearchDataFiles(const std::string_view ext, const std::string_view subdir);
 
+/* Gets the given subdirectory of the user's cache directory, or an empty
+ * string if there is none.
+ */
+std::string GetCachePath(const std::string_view subdir);
+
 #endif /* CORE_HELPERS_H */
@@ -3,10 +3,22 @@
 
 #include "hrtf.h"
 
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <cctype>
+#include <cinttypes>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
@@ -15,10 +27,12 @@
 #include <filesystem>
 #include <fstream>
 #include <iterator>
+#include <limits>
 #include <memory>
 #include <mutex>
 #include <numeric>
 #include <optional>
+#include <system_error>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -79,6 +93,7 @@ LoadedHrtf::~LoadedHrtf() = default;
  */
 constexpr uint MinFdCount{1};
 constexpr uint MaxFdCount{16};
+static_assert(MaxFdCount <= std::tuple_size_v<decltype(HrtfStore::mFieldInfo)>);
 
 constexpr uint MinFdDistance{50};
 constexpr uint MaxFdDistance{2500};
@@ -217,76 +232,170 @@ IdxBlend CalcAzIndex(uint azcount, float az)
     return IdxBlend{idx%azcount, az-static_cast<float>(idx)};
 }
 
-} // namespace
-
-
-/* Calculates static HRIR coefficients and delays for the given polar elevation
- * and azimuth in radians. The coefficients are normalized.
+/* Adds the HRIRs and delays of the four measurements surrounding the given
+ * direction in one field, bilinearly blended and scaled by the given gain.
  */
-void HrtfStore::getCoeffs(float elevation, float azimuth, float distance, float spread,
-    const HrirSpan coeffs, const al::span<uint,2> delays) const
+void AccumFieldCoeffs(const HrtfStore &hrtf, const size_t fieldidx, const float elevation,
+    const float azimuth, const float gain, const HrirSpan coeffs, std::array<float,2> &delays)
 {
-    const float dirfact{1.0f - (al::numbers::inv_pi_v<float>/2.0f * spread)};
-
-    size_t ebase{0};
-    auto match_field = [&ebase,distance](const Field &field) noexcept -> bool
-    {
-        if(distance >= field.distance)
-            return true;
-        ebase += field.evCount;
-        return false;
-    };
-    auto field = std::find_if(mFields.begin(), mFields.end()-1, match_field);
+    const size_t ebase{hrtf.mFieldInfo[fieldidx].evOffset};
+    const uint evcount{hrtf.mFields[fieldidx].evCount};
 
     /* Calculate the elevation indices. */
-    const auto elev0 = CalcEvIndex(field->evCount, elevation);
-    const size_t elev1_idx{std::min(elev0.idx+1u, field->evCount-1u)};
-    const size_t ir0offset{mElev[ebase + elev0.idx].irOffset};
-    const size_t ir1offset{mElev[ebase + elev1_idx].irOffset};
+    const auto elev0 = CalcEvIndex(evcount, elevation);
+    const size_t elev1_idx{std::min(elev0.idx+1u, evcount-1u)};
+    const size_t ir0offset{hrtf.mElev[ebase + elev0.idx].irOffset};
+    const size_t ir1offset{hrtf.mElev[ebase + elev1_idx].irOffset};
 
     /* Calculate azimuth indices. */
-    const auto az0 = CalcAzIndex(mElev[ebase + elev0.idx].azCount, azimuth);
-    const auto az1 = CalcAzIndex(mElev[ebase + elev1_idx].azCount, azimuth);
+    const auto az0 = CalcAzIndex(hrtf.mElev[ebase + elev0.idx].azCount, azimuth);
+    const auto az1 = CalcAzIndex(hrtf.mElev[ebase + elev1_idx].azCount, azimuth);
 
     /* Calculate the HRIR indices to blend. */
     const std::array<size_t,4> idx{{
         ir0offset + az0.idx,
-        ir0offset + ((az0.idx+1) % mElev[ebase + elev0.idx].azCount),
+        ir0offset + ((az0.idx+1) % hrtf.mElev[ebase + elev0.idx].azCount),
         ir1offset + az1.idx,
-        ir1offset + ((az1.idx+1) % mElev[ebase + elev1_idx].azCount)
+        ir1offset + ((az1.idx+1) % hrtf.mElev[ebase + elev1_idx].azCount)
     }};
 
-    /* Calculate bilinear blending weights, attenuated according to the
-     * directional panning factor.
-     */
+    /* Calculate bilinear blending weights, scaled by the field's gain. */
     const std::array<float,4> blend{{
-        (1.0f-elev0.blend) * (1.0f-az0.blend) * dirfact,
-        (1.0f-elev0.blend) * (     az0.blend) * dirfact,
-        (     elev0.blend) * (1.0f-az1.blend) * dirfact,
-        (     elev0.blend) * (     az1.blend) * dirfact
+        (1.0f-elev0.blend) * (1.0f-az0.blend) * gain,
+        (1.0f-elev0.blend) * (     az0.blend) * gain,
+        (     elev0.blend) * (1.0f-az1.blend) * gain,
+        (     elev0.blend) * (     az1.blend) * gain
     }};
 
-    /* Calculate the blended HRIR delays. */
-    float d{float(mDelays[idx[0]][0])*blend[0] + float(mDelays[idx[1]][0])*blend[1]
-        + float(mDelays[idx[2]][0])*blend[2] + float(mDelays[idx[3]][0])*blend[3]};
-    delays[0] = fastf2u(d * float{1.0f/HrirDelayFracOne});
-    d = float(mDelays[idx[0]][1])*blend[0] + float(mDelays[idx[1]][1])*blend[1]
-        + float(mDelays[idx[2]][1])*blend[2] + float(mDelays[idx[3]][1])*blend[3];
-    delays[1] = fastf2u(d * float{1.0f/HrirDelayFracOne});
+    /* Add the blended HRIR delays. */
+    const auto &srcdelays = hrtf.mDelays;
+    delays[0] += float(srcdelays[idx[0]][0])*blend[0] + float(srcdelays[idx[1]][0])*blend[1]
+        + float(srcdelays[idx[2]][0])*blend[2] + float(srcdelays[idx[3]][0])*blend[3];
+    delays[1] += float(srcdelays[idx[0]][1])*blend[0] + float(srcdelays[idx[1]][1])*blend[1]
+        + float(srcdelays[idx[2]][1])*blend[2] + float(srcdelays[idx[3]][1])*blend[3];
 
-    /* Calculate the blended HRIR coefficients. */
-    auto coeffout = coeffs.begin();
-    coeffout[0][0] = PassthruCoeff * (1.0f-dirfact);
-    coeffout[0][1] = PassthruCoeff * (1.0f-dirfact);
-    std::fill_n(coeffout+1, size_t{HrirLength-1}, std::array{0.0f, 0.0f});
+    /* Add the blended HRIR coefficients. */
     for(size_t c{0};c < 4;c++)
     {
         const float mult{blend[c]};
         auto blend_coeffs = [mult](const float2 &src, const float2 &coeff) noexcept -> float2
         { return float2{{src[0]*mult + coeff[0], src[1]*mult + coeff[1]}}; };
-        std::transform(mCoeffs[idx[c]].cbegin(), mCoeffs[idx[c]].cend(), coeffout, coeffout,
-            blend_coeffs);
+        std::transform(hrtf.mCoeffs[idx[c]].cbegin(), hrtf.mCoeffs[idx[c]].cend(),
+            coeffs.begin(), coeffs.begin(), blend_coeffs);
+    }
+}
+
+} // namespace
+
+
+void HrtfStore::initFieldInfo() noexcept
+{
+    ushort evoffset{0};
+    for(size_t i{0};i < mFields.size();++i)
+    {
+        const float spacing{(i+1 < mFields.size())
+            ? mFields[i].distance - mFields[i+1].distance : 0.0f};
+        mFieldInfo[i].evOffset = evoffset;
+        mFieldInfo[i].invSpacing = (spacing > 0.0f) ? 1.0f/spacing : 0.0f;
+        evoffset = static_cast<ushort>(evoffset + mFields[i].evCount);
+    }
+}
+
+HrtfStore::FieldBlend HrtfStore::getFieldBlend(float distance) const noexcept
+{
+    /* Fields are ordered farthest to nearest, so find the first field that
+     * isn't farther than the given distance (or the nearest field). Between
+     * two fields, the farther one gets more weight the closer the distance is
+     * to it.
+     */
+    const auto field = std::partition_point(mFields.begin(), mFields.end()-1,
+        [distance](const Field &fd) noexcept { return distance < fd.distance; });
+    const auto idx = static_cast<uint>(std::distance(mFields.begin(), field));
+    if(idx == 0)
+        return FieldBlend{0u, 1.0f};
+
+    const float blend{(distance - field->distance) * mFieldInfo[idx-1].invSpacing};
+    if(!(blend > 0.0f))
+        return FieldBlend{idx, 1.0f};
+    return FieldBlend{idx-1, std::min(blend, 1.0f)};
+}
+
+/* Calculates static HRIR coefficients and delays for the given polar elevation
+ * and azimuth in radians, blended between the two fields surrounding the
+ * distance. The coefficients are normalized.
+ */
+void HrtfStore::getCoeffs(float elevation, float azimuth, const FieldBlend field, float spread,
+    const HrirSpan coeffs, const al::span<uint,2> delays) const
+{
+    const float dirfact{1.0f - (al::numbers::inv_pi_v<float>/2.0f * spread)};
+
+    auto coeffout = coeffs.begin();
+    coeffout[0][0] = PassthruCoeff * (1.0f-dirfact);
+    coeffout[0][1] = PassthruCoeff * (1.0f-dirfact);
+    std::fill_n(coeffout+1, size_t{HrirLength-1}, std::array{0.0f, 0.0f});
+
+    auto delaysum = std::array{0.0f, 0.0f};
+    AccumFieldCoeffs(*this, field.idx, elevation, azimuth, field.blend*dirfact, coeffs,
+        delaysum);
+    if(field.blend < 1.0f)
+        AccumFieldCoeffs(*this, field.idx+1, elevation, azimuth, (1.0f-field.blend)*dirfact,
+            coeffs, delaysum);
+
+    delays[0] = fastf2u(delaysum[0] * float{1.0f/HrirDelayFracOne});
+    delays[1] = fastf2u(delaysum[1] * float{1.0f/HrirDelayFracOne});
+}
+
+
+HrtfCoeffCache::HrtfCoeffCache(const float resolution, const size_t capacity)
+    : mResolution{resolution}, mInvResolution{1.0f / resolution}, mEntries(capacity)
+{
+    /* Mark the entries as unused, with a key no direction can produce. */
+    for(auto &entry : mEntries)
+        entry.mKey = ~0_u64;
+}
+
+void HrtfCoeffCache::getCoeffs(const HrtfStore &hrtf, float elevation, float azimuth,
+    float distance, float spread, const HrirSpan coeffs, const al::span<uint,2> delays)
+{
+    /* The distance selects the fields to use, with the blend between them
+     * quantized to a fixed number of steps.
+     */
+    static constexpr float FieldSteps{32.0f};
+    auto field = hrtf.getFieldBlend(distance);
+    const int qblend{fastf2i(field.blend * FieldSteps)};
+    field.blend = static_cast<float>(qblend) * (1.0f/FieldSteps);
+    const uint64_t fieldkey{(uint64_t{field.idx}<<6) | static_cast<uint64_t>(qblend)};
+
+    const int qev{fastf2i(elevation * mInvResolution)};
+    const int qaz{fastf2i(azimuth * mInvResolution)};
+    const int qspread{fastf2i(spread * mInvResolution)};
+    elevation = static_cast<float>(qev) * mResolution;
+    azimuth = static_cast<float>(qaz) * mResolution;
+    spread = static_cast<float>(qspread) * mResolution;
+
+    std::unique_lock<std::mutex> lock{mLock, std::try_to_lock};
+    if(!lock)
+    {
+        hrtf.getCoeffs(elevation, azimuth, field, spread, coeffs, delays);
+        return;
     }
+
+    const uint64_t key{(fieldkey<<48) | (uint64_t{static_cast<uint16_t>(qev)}<<32)
+        | (uint64_t{static_cast<uint16_t>(qaz)}<<16) | uint64_t{static_cast<uint16_t>(qspread)}};
+    auto entry = std::find_if(mEntries.begin(), mEntries.end(),
+        [key](const Entry &e) noexcept { return e.mKey == key; });
+    if(entry == mEntries.end())
+    {
+        entry = std::min_element(mEntries.begin(), mEntries.end(),
+            [](const Entry &lhs, const Entry &rhs) noexcept
+            { return lhs.mLastUse < rhs.mLastUse; });
+        hrtf.getCoeffs(elevation, azimuth, field, spread, entry->mCoeffs, entry->mDelays);
+        entry->mKey = key;
+    }
+    entry->mLastUse = ++mUseCount;
+
+    std::copy(entry->mCoeffs.cbegin(), entry->mCoeffs.cend(), coeffs.begin());
+    std::copy(entry->mDelays.cbegin(), entry->mDelays.cend(), delays.begin());
 }
 
 
@@ -318,24 +427,20 @@ void DirectHrtfState::build(const HrtfStore *Hrtf, const uint irSize, const bool
     std::vector<ImpulseResponse> impres; impres.reserve(AmbiPoints.size());
     auto calc_res = [Hrtf,&max_delay,&min_delay](const AngularPoint &pt) -> ImpulseResponse
     {
+        /* Use the HRIR closest to the point. The azimuth is rounded by its
+         * magnitude, so mirrored points get mirrored HRIRs.
+         */
         auto &field = Hrtf->mFields[0];
         const auto elev0 = CalcEvIndex(field.evCount, pt.Elev.value);
-        const size_t elev1_idx{std::min(elev0.idx+1u, field.evCount-1u)};
-        const size_t ir0offset{Hrtf->mElev[elev0.idx].irOffset};
-        const size_t ir1offset{Hrtf->mElev[elev1_idx].irOffset};
-
-        const auto az0 = CalcAzIndex(Hrtf->mElev[elev0.idx].azCount, pt.Azim.value);
-        const auto az1 = CalcAzIndex(Hrtf->mElev[elev1_idx].azCount, pt.Azim.value);
-
-        const std::array<size_t,4> idx{
-            ir0offset + az0.idx,
-            ir0offset + ((az0.idx+1) % Hrtf->mElev[elev0.idx].azCount),
-            ir1offset + az1.idx,
-            ir1offset + ((az1.idx+1) % Hrtf->mElev[elev1_idx].azCount)
-        };
-
-        /* The largest blend factor serves as the closest HRIR. */
-        const size_t irOffset{idx[(elev0.blend >= 0.5f)*2 + (az1.blend >= 0.5f)]};
+        const size_t evidx{std::min(elev0.idx + (elev0.blend >= 0.5f), field.evCount-1u)};
+        const uint azcount{Hrtf->mElev[evidx].azCount};
+        const float az{std::abs(pt.Azim.value) * static_cast<float>(azcount)
+            * (al::numbers::inv_pi_v<float>*0.5f)};
+        uint azidx{float2uint(az + 0.5f) % azcount};
+        if(pt.Azim.value < 0.0f)
+            azidx = (azcount - azidx) % azcount;
+
+        const size_t irOffset{Hrtf->mElev[evidx].irOffset + azidx};
         ImpulseResponse res{Hrtf->mCoeffs[irOffset],
             Hrtf->mDelays[irOffset][0], Hrtf->mDelays[irOffset][1]};
 
@@ -392,6 +497,152 @@ void DirectHrtfState::build(const HrtfStore *Hrtf, const uint irSize, const bool
     TRACE("New max delay: %.2f, FIR length: %u\n", max_delay/double{HrirDelayFracOne},
         max_length);
     mIrSize = max_length;
+
+    /* Left/right mirrored HRIRs with a symmetric decoder give each channel a
+     * right filter that's the same as its left filter, or its negation for
+     * channels that are antisymmetric across the median plane.
+     */
+    auto check_mirrored = [](HrtfChannelState &chan) noexcept -> bool
+    {
+        float peak{0.0f}, symdiff{0.0f}, antidiff{0.0f};
+        for(const float2 &coeff : chan.mCoeffs)
+        {
+            peak = std::max(peak, std::max(std::abs(coeff[0]), std::abs(coeff[1])));
+            symdiff = std::max(symdiff, std::abs(coeff[1] - coeff[0]));
+            antidiff = std::max(antidiff, std::abs(coeff[1] + coeff[0]));
+        }
+        const float epsilon{peak * 1.0f/16384.0f};
+        chan.mAntiSymmetric = antidiff < symdiff;
+        return std::min(symdiff, antidiff) <= epsilon;
+    };
+    mMirrored = std::all_of(mChannels.begin(), mChannels.end(), check_mirrored);
+
+    /* With long enough FIRs, it's cheaper to convolve in the frequency
+     * domain. The filters are stored transformed, with the inverse
+     * transform's 1/N scaling applied.
+     */
+    mFft = PFFFTSetup{};
+    if(mIrSize >= FftMinIrSize)
+    {
+        mFft = PFFFTSetup{FftSize, PFFFT_REAL};
+        /* Match the SIMD mixers, which round the FIR length up to a multiple
+         * of 2.
+         */
+        const size_t irsize{std::min(RoundUp(size_t{mIrSize}, 2_uz), size_t{HrirLength})};
+        const float scale{1.0f / float{FftSize}};
+        const size_t numfilters{mMirrored ? 1_uz : 2_uz};
+        for(auto &chan : mChannels)
+        {
+            for(size_t j{0};j < numfilters;++j)
+            {
+                const auto coeffs = al::span{chan.mCoeffs}.first(irsize);
+                auto fftiter = std::transform(coeffs.begin(), coeffs.end(), mFftBuffer.begin(),
+                    [j,scale](const float2 &coeff) noexcept { return coeff[j] * scale; });
+                std::fill(fftiter, mFftBuffer.end(), 0.0f);
+                mFft.transform(mFftBuffer.data(), chan.mFftCoeffs[j].data(), mFftWork.data(),
+                    PFFFT_FORWARD);
+            }
+        }
+        TRACE("Using frequency-domain HRTF filters%s\n", mMirrored ? " (mirrored)" : "");
+    }
+}
+
+void DirectHrtfState::mixFft(const FloatBufferSpan LeftOut, const FloatBufferSpan RightOut,
+    const al::span<const FloatBufferLine> InSamples, const al::span<float2> AccumSamples,
+    const size_t SamplesToDo)
+{
+    ASSUME(SamplesToDo > 0);
+    ASSUME(SamplesToDo <= BufferLineSize);
+    assert(mChannels.size() == InSamples.size());
+
+    const size_t numBlocks{(SamplesToDo+HrirLength-1) / HrirLength};
+    const auto accums = al::span{mFftAccum}.first(numBlocks*2);
+    std::for_each(accums.begin(), accums.end(), [](auto &accum) { accum.fill(0.0f); });
+
+    auto ChanState = mChannels.begin();
+    for(const FloatBufferLine &input : InSamples)
+    {
+        ChanState->mSplitter.processHfScale(al::span{input}.first(SamplesToDo), mTemp,
+            ChanState->mHfScale);
+
+        /* Transform each block of the input and accumulate its convolution
+         * with the left and right filters.
+         */
+        for(size_t b{0};b < numBlocks;++b)
+        {
+            const auto src = al::span{mTemp}.subspan(b*HrirLength,
+                std::min(size_t{HrirLength}, SamplesToDo - b*HrirLength));
+            std::fill(std::copy(src.begin(), src.end(), mFftBuffer.begin()), mFftBuffer.end(),
+                0.0f);
+            mFft.transform(mFftBuffer.data(), mFftBuffer.data(), mFftWork.data(),
+                PFFFT_FORWARD);
+            if(mMirrored)
+            {
+                /* Only the left filter is needed, accumulating into the
+                 * symmetric or antisymmetric sum.
+                 */
+                mFft.zconvolve_accumulate(mFftBuffer.data(), ChanState->mFftCoeffs[0].data(),
+                    accums[b*2 + ChanState->mAntiSymmetric].data());
+                continue;
+            }
+            mFft.zconvolve_accumulate(mFftBuffer.data(), ChanState->mFftCoeffs[0].data(),
+                accums[b*2].data());
+            mFft.zconvolve_accumulate(mFftBuffer.data(), ChanState->mFftCoeffs[1].data(),
+                accums[b*2 + 1].data());
+        }
+        ++ChanState;
+    }
+
+    /* Transform the summed blocks back and add them to the accumulation
+     * buffer, including the tails that extend into the following blocks. For
+     * mirrored filters, the left output is the symmetric sum plus the
+     * antisymmetric sum, and the right output is their difference.
+     */
+    for(size_t b{0};b < numBlocks;++b)
+    {
+        const size_t todo{std::min(size_t{HrirLength}, SamplesToDo - b*HrirLength)};
+        const auto dst = AccumSamples.subspan(b*HrirLength, todo + HrirLength - 1);
+        for(size_t j{0};j < 2;++j)
+        {
+            mFft.transform(accums[b*2 + j].data(), mFftBuffer.data(), mFftWork.data(),
+                PFFFT_BACKWARD);
+            if(mMirrored)
+            {
+                const float rsign{j ? -1.0f : 1.0f};
+                std::transform(dst.begin(), dst.end(), mFftBuffer.begin(), dst.begin(),
+                    [rsign](float2 accum, const float sample) noexcept -> float2
+                    {
+                        accum[0] += sample;
+                        accum[1] += sample*rsign;
+                        return accum;
+                    });
+                continue;
+            }
+            std::transform(dst.begin(), dst.end(), mFftBuffer.begin(), dst.begin(),
+                [j](float2 accum, const float sample) noexcept -> float2
+                {
+                    accum[j] += sample;
+                    return accum;
+                });
+        }
+    }
+
+    /* Add the HRTF signal to the existing "direct" signal. */
+    const auto left = al::span{al::assume_aligned<16>(LeftOut.data()), SamplesToDo};
+    std::transform(left.cbegin(), left.cend(), AccumSamples.cbegin(), left.begin(),
+        [](const float sample, const float2 &accum) noexcept -> float
+        { return sample + accum[0]; });
+    const auto right = al::span{al::assume_aligned<16>(RightOut.data()), SamplesToDo};
+    std::transform(right.cbegin(), right.cend(), AccumSamples.cbegin(), right.begin(),
+        [](const float sample, const float2 &accum) noexcept -> float
+        { return sample + accum[1]; });
+
+    /* Copy the new in-progress accumulation values to the front and clear the
+     * following samples for the next mix.
+     */
+    const auto accum_inprog = AccumSamples.subspan(SamplesToDo, HrirLength);
+    auto accum_iter = std::copy(accum_inprog.cbegin(), accum_inprog.cend(), AccumSamples.begin());
+    std::fill_n(accum_iter, SamplesToDo, float2{});
 }
 
 
@@ -461,6 +712,8 @@ std::unique_ptr<HrtfStore> CreateHrtfStore(uint rate, uint8_t irSize,
     Hrtf->mElev = elev_;
     Hrtf->mCoeffs = coeffs_;
     Hrtf->mDelays = delays_;
+    Hrtf->mTotalSize = total;
+    Hrtf->initFieldInfo();
 
     return Hrtf;
 }
@@ -1202,6 +1455,442 @@ al::span<const char> GetResource(int name)
 }
 #endif
 
+
+/* Pre-resampled data sets are cached as the final field, elevation,
+ * coefficient, and delay arrays, so later loads can map them in place instead
+ * of parsing and resampling the source data again. The cache is specific to
+ * the host's byte order and data layout, and the source is identified by its
+ * size and modification time (or content hash for built-in data).
+ */
+[[nodiscard]] constexpr auto GetCacheMarkerName() noexcept { return "ALHRTFC1"sv; }
+[[nodiscard]] constexpr auto GetCacheExtension() noexcept { return ".mhrc"sv; }
+
+constexpr uint32_t CacheByteOrderMark{0x01020304};
+
+struct CacheHeader {
+    std::array<char,GetCacheMarkerName().size()> mMagic;
+    uint32_t mByteOrder;
+    uint32_t mHrirArraySize;
+    uint32_t mSampleRate;
+    uint32_t mIrSize;
+    uint32_t mFieldCount;
+    uint32_t mElevCount;
+    uint32_t mIrCount;
+    uint32_t mNameLength;
+    uint64_t mSourceSize;
+    uint64_t mSourceId;
+};
+
+struct CacheLayout {
+    size_t mFields;
+    size_t mElevs;
+    size_t mCoeffs;
+    size_t mDelays;
+    size_t mTotal;
+};
+
+CacheLayout GetCacheLayout(const CacheHeader &header) noexcept
+{
+    CacheLayout layout{};
+    layout.mFields = RoundUp(sizeof(CacheHeader)+header.mNameLength,
+        alignof(HrtfStore::Field));
+    layout.mElevs = RoundUp(layout.mFields + sizeof(HrtfStore::Field)*header.mFieldCount,
+        alignof(HrtfStore::Elevation));
+    layout.mCoeffs = RoundUp(layout.mElevs + sizeof(HrtfStore::Elevation)*header.mElevCount,
+        16_uz);
+    layout.mDelays = layout.mCoeffs + sizeof(HrirArray)*header.mIrCount;
+    layout.mTotal = layout.mDelays + sizeof(ubyte2)*header.mIrCount;
+    return layout;
+}
+
+/* FNV-1a, for naming cache files and identifying built-in data. */
+uint64_t HashBytes(const al::span<const char> data) noexcept
+{
+    return std::accumulate(data.begin(), data.end(), 0xcbf29ce484222325_u64,
+        [](const uint64_t hash, const char c) noexcept -> uint64_t
+        { return (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3_u64; });
+}
+
+/* Gets the name used for the cache file and shared memory segment of the
+ * given data set at the given rate.
+ */
+std::string GetCacheName(const std::string_view fname, const uint devrate)
+{
+    std::array<char,32> name{};
+    std::snprintf(name.data(), name.size(), "%016" PRIx64 "-%u", HashBytes(fname), devrate);
+    return std::string{name.data()};
+}
+
+std::filesystem::path GetCacheFilename(const std::string_view fname, const uint devrate)
+{
+    auto path = std::filesystem::u8path(HrtfCachePath)
+        / std::filesystem::u8path(GetCacheName(fname, devrate));
+    path += GetCacheExtension();
+    return path;
+}
+
+
+#ifndef _WIN32
+/* Maps the given file descriptor as read-only shared memory, and closes it. */
+std::shared_ptr<const void> MapDescriptor(const int fd, size_t &size)
+{
+    struct stat st{};
+    if(fstat(fd, &st) != 0 || st.st_size <= 0
+        || static_cast<uintmax_t>(st.st_size) > std::numeric_limits<size_t>::max())
+    {
+        close(fd);
+        return nullptr;
+    }
+
+    /* The mapping stays valid after the descriptor is closed. */
+    const auto mapsize = static_cast<size_t>(st.st_size);
+    void *ptr{mmap(nullptr, mapsize, PROT_READ, MAP_SHARED, fd, 0)};
+    close(fd);
+    if(ptr == MAP_FAILED)
+        return nullptr;
+
+    size = mapsize;
+    /* NOLINTNEXTLINE(*-const-cast) */
+    return std::shared_ptr<const void>{ptr, [mapsize](const void *p)
+        { munmap(const_cast<void*>(p), mapsize); }};
+}
+#endif
+
+/* Maps the given file as read-only shared memory. */
+std::shared_ptr<const void> MapFile(const std::filesystem::path &path, size_t &size)
+{
+#ifdef _WIN32
+    HANDLE file{CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ|FILE_SHARE_DELETE,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr)};
+    if(file == INVALID_HANDLE_VALUE)
+        return nullptr;
+
+    LARGE_INTEGER filesize{};
+    if(!GetFileSizeEx(file, &filesize) || filesize.QuadPart <= 0
+        || static_cast<ULONGLONG>(filesize.QuadPart) > std::numeric_limits<size_t>::max())
+    {
+        CloseHandle(file);
+        return nullptr;
+    }
+
+    /* The view keeps the mapping alive after the handles are closed. */
+    HANDLE mapping{CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr)};
+    CloseHandle(file);
+    if(!mapping)
+        return nullptr;
+
+    void *ptr{MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)};
+    CloseHandle(mapping);
+    if(!ptr)
+        return nullptr;
+
+    size = static_cast<size_t>(filesize.QuadPart);
+    return std::shared_ptr<const void>{ptr, [](const void *p) { UnmapViewOfFile(p); }};
+
+#else
+
+    const int fd{open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+    if(fd == -1)
+        return nullptr;
+    return MapDescriptor(fd, size);
+#endif
+}
+
+
+/* Checks if the mapped data holds a complete cache header, which may not be
+ * the case for a shared memory segment that's still being written.
+ */
+bool IsCacheComplete(const al::span<const char> data)
+{
+    if(data.size() < sizeof(CacheHeader))
+        return false;
+    const auto magic = data.first(GetCacheMarkerName().size());
+    const bool complete{std::string_view{magic.data(), magic.size()} == GetCacheMarkerName()};
+    /* Pairs with the release fence before the marker is written. */
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return complete;
+}
+
+/* Creates an HrtfStore that references the data in the given mapping,
+ * provided it's a complete cache for the given source data set and rate.
+ */
+std::unique_ptr<HrtfStore> CreateMappedHrtf(std::shared_ptr<const void> mapping,
+    const size_t mapsize, const std::string_view fname, const uint devrate,
+    const uint64_t srcsize, const uint64_t srcid)
+{
+    const auto data = al::span{static_cast<const char*>(mapping.get()), mapsize};
+    if(!IsCacheComplete(data))
+        return nullptr;
+
+    CacheHeader header{};
+    std::memcpy(&header, data.data(), sizeof(header));
+    if(header.mByteOrder != CacheByteOrderMark || header.mHrirArraySize != sizeof(HrirArray)
+        || header.mSampleRate != devrate || header.mSourceSize != srcsize
+        || header.mSourceId != srcid || header.mNameLength != fname.size())
+        return nullptr;
+    if(header.mIrSize < 1 || header.mIrSize > HrirLength
+        || header.mFieldCount < MinFdCount || header.mFieldCount > MaxFdCount
+        || header.mElevCount < 1 || header.mIrCount < 1)
+        return nullptr;
+
+    /* Shared memory segments may be rounded up to the page size. */
+    const auto layout = GetCacheLayout(header);
+    if(layout.mTotal > data.size()
+        || std::string_view{&data[sizeof(CacheHeader)], fname.size()} != fname)
+        return nullptr;
+
+    /* The mapping is aligned to at least a page, so the offsets in the file
+     * give the same alignment in memory.
+     */
+    auto fields = al::span{reinterpret_cast<const HrtfStore::Field*>(
+        &data[layout.mFields]), header.mFieldCount};
+    auto elevs = al::span{reinterpret_cast<const HrtfStore::Elevation*>(
+        &data[layout.mElevs]), header.mElevCount};
+    auto coeffs = al::span{reinterpret_cast<const HrirArray*>(
+        &data[layout.mCoeffs]), header.mIrCount};
+    auto delays = al::span{reinterpret_cast<const ubyte2*>(
+        &data[layout.mDelays]), header.mIrCount};
+
+    /* Make sure the lookups can't index out of bounds with a damaged file. */
+    const size_t evtotal{std::accumulate(fields.begin(), fields.end(), 0_uz,
+        [](const size_t curval, const HrtfStore::Field &field) noexcept -> size_t
+        { return curval + field.evCount; })};
+    const bool elevs_ok{std::all_of(elevs.begin(), elevs.end(),
+        [irCount=header.mIrCount](const HrtfStore::Elevation &elev) noexcept -> bool
+        { return elev.azCount > 0 && size_t{elev.irOffset}+elev.azCount <= irCount; })};
+    const bool delays_ok{std::all_of(delays.begin(), delays.end(),
+        [](const ubyte2 &delay) noexcept -> bool
+        {
+            return delay[0] <= MaxHrirDelay*HrirDelayFracOne
+                && delay[1] <= MaxHrirDelay*HrirDelayFracOne;
+        })};
+    if(evtotal != elevs.size() || !elevs_ok || !delays_ok
+        || size_t{elevs.back().irOffset}+elevs.back().azCount != coeffs.size())
+        return nullptr;
+
+    static constexpr auto AlignVal = std::align_val_t{alignof(HrtfStore)};
+    std::unique_ptr<HrtfStore> Hrtf{::new(::operator new[](sizeof(HrtfStore), AlignVal))
+        HrtfStore{}};
+    Hrtf->mRef.store(1u, std::memory_order_relaxed);
+    Hrtf->mSampleRate = devrate & 0xff'ff'ff;
+    Hrtf->mIrSize = header.mIrSize & 0xff;
+    Hrtf->mFields = fields;
+    Hrtf->mElev = elevs;
+    Hrtf->mCoeffs = coeffs;
+    Hrtf->mDelays = delays;
+    Hrtf->mMapping = std::move(mapping);
+    Hrtf->mTotalSize = sizeof(HrtfStore) + fields.size_bytes() + elevs.size_bytes()
+        + coeffs.size_bytes() + delays.size_bytes();
+    Hrtf->initFieldInfo();
+
+    return Hrtf;
+}
+
+/* Serializes the HrtfStore's data in the cache layout. */
+std::vector<char> SerializeHrtf(const std::string_view fname, const HrtfStore &hrtf,
+    const uint64_t srcsize, const uint64_t srcid)
+{
+    CacheHeader header{};
+    std::copy(GetCacheMarkerName().begin(), GetCacheMarkerName().end(), header.mMagic.begin());
+    header.mByteOrder = CacheByteOrderMark;
+    header.mHrirArraySize = sizeof(HrirArray);
+    header.mSampleRate = hrtf.mSampleRate;
+    header.mIrSize = hrtf.mIrSize;
+    header.mFieldCount = static_cast<uint32_t>(hrtf.mFields.size());
+    header.mElevCount = static_cast<uint32_t>(hrtf.mElev.size());
+    header.mIrCount = static_cast<uint32_t>(hrtf.mCoeffs.size());
+    header.mNameLength = static_cast<uint32_t>(fname.size());
+    header.mSourceSize = srcsize;
+    header.mSourceId = srcid;
+
+    const auto layout = GetCacheLayout(header);
+    auto filedata = std::vector<char>(layout.mTotal);
+    auto copy_bytes = [&filedata](const size_t offset, const auto &src)
+    { std::memcpy(&filedata[offset], src.data(), src.size()*sizeof(src[0])); };
+    copy_bytes(0, al::span{&header, 1});
+    copy_bytes(sizeof(CacheHeader), fname);
+    copy_bytes(layout.mFields, hrtf.mFields);
+    copy_bytes(layout.mElevs, hrtf.mElev);
+    copy_bytes(layout.mCoeffs, hrtf.mCoeffs);
+    copy_bytes(layout.mDelays, hrtf.mDelays);
+    return filedata;
+}
+
+
+std::unique_ptr<HrtfStore> LoadCachedHrtf(const std::filesystem::path &path,
+    const std::string_view fname, const uint devrate, const uint64_t srcsize,
+    const uint64_t srcid)
+{
+    size_t mapsize{};
+    auto mapping = MapFile(path, mapsize);
+    if(!mapping)
+        return nullptr;
+    return CreateMappedHrtf(std::move(mapping), mapsize, fname, devrate, srcsize, srcid);
+}
+
+void SaveCachedHrtf(const std::filesystem::path &path, const al::span<const char> filedata)
+{
+    /* Write to a temporary file first and rename it over the cache file, so
+     * other processes never see (or map) a partially written file.
+     */
+    try {
+#ifdef _WIN32
+        const auto procid = static_cast<unsigned long>(GetCurrentProcessId());
+#else
+        const auto procid = static_cast<unsigned long>(getpid());
+#endif
+        std::filesystem::create_directories(path.parent_path());
+
+        auto tmppath = path;
+        tmppath += "."+std::to_string(procid)+".tmp";
+        {
+            std::ofstream file{tmppath, std::ios::binary | std::ios::trunc};
+            if(!file.write(filedata.data(), static_cast<std::streamsize>(filedata.size()))
+                || !file.flush())
+            {
+                file.close();
+                std::filesystem::remove(tmppath);
+                WARN("Failed to write HRTF cache file %s\n", tmppath.u8string().c_str());
+                return;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tmppath, path, ec);
+        if(ec)
+        {
+            std::filesystem::remove(tmppath, ec);
+            WARN("Failed to rename HRTF cache file %s\n", path.u8string().c_str());
+            return;
+        }
+        TRACE("Wrote HRTF cache file %s\n", path.u8string().c_str());
+    }
+    catch(std::exception &e) {
+        WARN("Failed to write HRTF cache file %s: %s\n", path.u8string().c_str(), e.what());
+    }
+}
+
+
+#if defined(_WIN32) || defined(HAVE_SHM_OPEN)
+#ifdef _WIN32
+std::wstring GetSharedName(const std::string_view fname, const uint devrate)
+{
+    const auto name = "Local\\openal-hrtf-"+GetCacheName(fname, devrate);
+    return std::wstring(name.cbegin(), name.cend());
+}
+#else
+std::string GetSharedName(const std::string_view fname, const uint devrate)
+{ return "/openal-hrtf-"+GetCacheName(fname, devrate); }
+#endif
+
+/* Attaches to an existing shared memory segment holding the data set. */
+std::unique_ptr<HrtfStore> AttachSharedHrtf(const std::string_view fname, const uint devrate,
+    const uint64_t srcsize, const uint64_t srcid)
+{
+    const auto name = GetSharedName(fname, devrate);
+    size_t mapsize{};
+#ifdef _WIN32
+    HANDLE mapping{OpenFileMappingW(FILE_MAP_READ, FALSE, name.c_str())};
+    if(!mapping)
+        return nullptr;
+    void *ptr{MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)};
+    CloseHandle(mapping);
+    if(!ptr)
+        return nullptr;
+
+    MEMORY_BASIC_INFORMATION meminfo{};
+    if(VirtualQuery(ptr, &meminfo, sizeof(meminfo)) != sizeof(meminfo))
+    {
+        UnmapViewOfFile(ptr);
+        return nullptr;
+    }
+    mapsize = meminfo.RegionSize;
+    auto view = std::shared_ptr<const void>{ptr, [](const void *p) { UnmapViewOfFile(p); }};
+#else
+    const int fd{shm_open(name.c_str(), O_RDONLY, 0)};
+    if(fd == -1)
+        return nullptr;
+    auto view = MapDescriptor(fd, mapsize);
+    if(!view)
+        return nullptr;
+#endif
+
+    const auto data = al::span{static_cast<const char*>(view.get()), mapsize};
+    const bool complete{IsCacheComplete(data)};
+    auto hrtf = CreateMappedHrtf(std::move(view), mapsize, fname, devrate, srcsize, srcid);
+#ifndef _WIN32
+    /* A complete segment that doesn't match the source is stale. Remove the
+     * name so it can be replaced, leaving it mapped for its current users.
+     */
+    if(!hrtf && complete)
+        shm_unlink(name.c_str());
+#endif
+    if(!hrtf && !complete)
+        TRACE("Shared HRTF segment for %.*s is incomplete\n", al::sizei(fname), fname.data());
+    return hrtf;
+}
+
+/* Creates a new shared memory segment with the serialized data set, and
+ * returns an HrtfStore referencing it. Returns null if the segment already
+ * exists or can't be created.
+ */
+std::unique_ptr<HrtfStore> CreateSharedHrtf(const std::string_view fname, const uint devrate,
+    const al::span<const char> filedata, const uint64_t srcsize, const uint64_t srcid)
+{
+    const auto name = GetSharedName(fname, devrate);
+#ifdef _WIN32
+    const auto mapsize = static_cast<ULONGLONG>(filedata.size());
+    HANDLE mapping{CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+        static_cast<DWORD>(mapsize>>32), static_cast<DWORD>(mapsize), name.c_str())};
+    if(!mapping)
+        return nullptr;
+    if(GetLastError() == ERROR_ALREADY_EXISTS)
+    {
+        CloseHandle(mapping);
+        return nullptr;
+    }
+    void *ptr{MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, 0)};
+    CloseHandle(mapping);
+    if(!ptr)
+        return nullptr;
+    auto view = std::shared_ptr<const void>{ptr, [](const void *p) { UnmapViewOfFile(p); }};
+#else
+    const int fd{shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644)};
+    if(fd == -1)
+        return nullptr;
+    if(ftruncate(fd, static_cast<off_t>(filedata.size())) != 0)
+    {
+        close(fd);
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+    void *ptr{mmap(nullptr, filedata.size(), PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0)};
+    close(fd);
+    if(ptr == MAP_FAILED)
+    {
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+    /* NOLINTNEXTLINE(*-const-cast) */
+    auto view = std::shared_ptr<const void>{ptr, [mapsize=filedata.size()](const void *p)
+        { munmap(const_cast<void*>(p), mapsize); }};
+#endif
+
+    /* Write the marker last, so other processes attaching while this is
+     * writing see an incomplete segment and load the data set themselves.
+     */
+    const auto dst = al::span{static_cast<char*>(ptr), filedata.size()};
+    const auto markersize = GetCacheMarkerName().size();
+    std::copy(filedata.begin()+ptrdiff_t(markersize), filedata.end(),
+        dst.begin()+ptrdiff_t(markersize));
+    std::atomic_thread_fence(std::memory_order_release);
+    std::copy_n(filedata.begin(), markersize, dst.begin());
+
+    TRACE("Created shared HRTF segment for %.*s\n", al::sizei(fname), fname.data());
+    return CreateMappedHrtf(std::move(view), filedata.size(), fname, devrate, srcsize, srcid);
+}
+#endif
+
 } // namespace
 
 
@@ -1289,18 +1978,73 @@ try {
         }
     }
 
-    std::unique_ptr<std::istream> stream;
+    /* Identify the source data to check the cache against. Files are
+     * identified by their size and modification time, and built-in data by
+     * its size and content hash.
+     */
+    al::span<const char> res;
+    uint64_t srcsize{};
+    uint64_t srcid{};
     int residx{};
     char ch{};
-    if(sscanf(fname.c_str(), "!%d%c", &residx, &ch) == 2 && ch == '_')
+    const bool isresource{sscanf(fname.c_str(), "!%d%c", &residx, &ch) == 2 && ch == '_'};
+    if(isresource)
     {
-        TRACE("Loading %s...\n", fname.c_str());
-        al::span<const char> res{GetResource(residx)};
+        res = GetResource(residx);
         if(res.empty())
         {
             ERR("Could not get resource %u, %.*s\n", residx, al::sizei(name), name.data());
             return nullptr;
         }
+        srcsize = res.size();
+        srcid = HashBytes(res);
+    }
+    else
+    {
+        std::error_code ec;
+        const auto fpath = std::filesystem::u8path(fname);
+        srcsize = std::filesystem::file_size(fpath, ec);
+        if(!ec)
+            srcid = static_cast<uint64_t>(
+                std::filesystem::last_write_time(fpath, ec).time_since_epoch().count());
+        if(ec) srcsize = srcid = 0;
+    }
+
+#if defined(_WIN32) || defined(HAVE_SHM_OPEN)
+    const bool useshared{HrtfSharedMemory && srcsize > 0};
+    if(useshared)
+    {
+        if(auto hrtf = AttachSharedHrtf(fname, devrate, srcsize, srcid))
+        {
+            handle = LoadedHrtfs.emplace(handle, fname, devrate, std::move(hrtf));
+            TRACE("Loaded HRTF %.*s for sample rate %uhz, %u-sample filter, from shared memory\n",
+                al::sizei(name), name.data(), handle->mEntry->mSampleRate,
+                handle->mEntry->mIrSize);
+            return HrtfStorePtr{handle->mEntry.get()};
+        }
+    }
+#else
+    constexpr bool useshared{false};
+#endif
+
+    std::filesystem::path cachefile;
+    if(!HrtfCachePath.empty() && srcsize > 0)
+    {
+        cachefile = GetCacheFilename(fname, devrate);
+        if(auto hrtf = LoadCachedHrtf(cachefile, fname, devrate, srcsize, srcid))
+        {
+            handle = LoadedHrtfs.emplace(handle, fname, devrate, std::move(hrtf));
+            TRACE("Loaded HRTF %.*s for sample rate %uhz, %u-sample filter, from cache %s\n",
+                al::sizei(name), name.data(), handle->mEntry->mSampleRate,
+                handle->mEntry->mIrSize, cachefile.u8string().c_str());
+            return HrtfStorePtr{handle->mEntry.get()};
+        }
+    }
+
+    std::unique_ptr<std::istream> stream;
+    if(isresource)
+    {
+        TRACE("Loading %s...\n", fname.c_str());
         /* NOLINTNEXTLINE(*-const-cast) */
         stream = std::make_unique<idstream>(al::span{const_cast<char*>(res.data()), res.size()});
     }
@@ -1423,6 +2167,23 @@ try {
         hrtf->mSampleRate = devrate & 0xff'ff'ff;
     }
 
+    if(!cachefile.empty() || useshared)
+    {
+        const auto filedata = SerializeHrtf(fname, *hrtf, srcsize, srcid);
+        if(!cachefile.empty())
+            SaveCachedHrtf(cachefile, filedata);
+#if defined(_WIN32) || defined(HAVE_SHM_OPEN)
+        /* Use the shared segment in place of the private copy, so this
+         * process's copy is shared too.
+         */
+        if(useshared)
+        {
+            if(auto shared = CreateSharedHrtf(fname, devrate, filedata, srcsize, srcid))
+                hrtf = std::move(shared);
+        }
+#endif
+    }
+
     handle = LoadedHrtfs.emplace(handle, fname, devrate, std::move(hrtf));
     TRACE("Loaded HRTF %.*s for sample rate %uhz, %u-sample filter\n", al::sizei(name),name.data(),
         handle->mEntry->mSampleRate, handle->mEntry->mIrSize);
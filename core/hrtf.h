@@ -3,7 +3,9 @@
 
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -17,6 +19,7 @@
 #include "flexarray.h"
 #include "intrusive_ptr.h"
 #include "mixer/hrtfdefs.h"
+#include "pffft.h"
 
 
 struct alignas(16) HrtfStore {
@@ -34,15 +37,44 @@ struct alignas(16) HrtfStore {
      */
     al::span<const Field> mFields;
 
+    /* Per-field lookup data, precomputed when the store is created: the index
+     * of the field's first elevation in mElev, and the reciprocal of the
+     * distance to the next nearer field (0 for the nearest).
+     */
+    struct FieldInfo {
+        ushort evOffset;
+        float invSpacing;
+    };
+    std::array<FieldInfo,16> mFieldInfo{};
+
     struct Elevation {
         ushort azCount;
         ushort irOffset;
     };
-    al::span<Elevation> mElev;
+    al::span<const Elevation> mElev;
     al::span<const HrirArray> mCoeffs;
     al::span<const ubyte2> mDelays;
 
+    /* Keeps the cache file mapped when the field, elevation, coefficient, and
+     * delay storage is in a memory-mapped cache file, rather than following
+     * this struct.
+     */
+    std::shared_ptr<const void> mMapping;
+
+    /* The size of the store and its data, in bytes, for reporting memory use. */
+    size_t mTotalSize{0};
+
+    /* A position between two fields. The blend is the weight given to the
+     * farther field, mFields[idx], over the nearer mFields[idx+1].
+     */
+    struct FieldBlend { uint idx; float blend; };
+    FieldBlend getFieldBlend(float distance) const noexcept;
+    void initFieldInfo() noexcept;
+
     void getCoeffs(float elevation, float azimuth, float distance, float spread,
+        const HrirSpan coeffs, const al::span<uint,2> delays) const
+    { getCoeffs(elevation, azimuth, getFieldBlend(distance), spread, coeffs, delays); }
+    void getCoeffs(float elevation, float azimuth, const FieldBlend field, float spread,
         const HrirSpan coeffs, const al::span<uint,2> delays) const;
 
     void add_ref();
@@ -60,6 +92,42 @@ struct alignas(16) HrtfStore {
 using HrtfStorePtr = al::intrusive_ptr<HrtfStore>;
 
 
+/* Caches blended HRIR coefficients and delays for directions quantized to a
+ * given angular resolution, so sources at nearby or repeated directions can
+ * skip blending. The least recently used entry is replaced when full. The
+ * cache is used from the mixer (and mixer pool) threads, so it never
+ * allocates after construction, and a lookup that finds the cache in use by
+ * another thread blends the coefficients directly instead of waiting.
+ */
+class HrtfCoeffCache {
+    struct Entry {
+        alignas(16) HrirArray mCoeffs;
+        uint2 mDelays;
+        uint64_t mKey;
+        uint64_t mLastUse;
+    };
+
+    std::mutex mLock;
+    float mResolution;
+    float mInvResolution;
+    uint64_t mUseCount{0};
+    std::vector<Entry> mEntries;
+
+public:
+    static constexpr size_t DefaultCapacity{256};
+
+    /** The resolution is in radians. */
+    HrtfCoeffCache(const float resolution, const size_t capacity=DefaultCapacity);
+
+    /**
+     * Gets the HRIR coefficients and delays like HrtfStore::getCoeffs, for
+     * the given direction and spread rounded to the cache's resolution.
+     */
+    void getCoeffs(const HrtfStore &hrtf, float elevation, float azimuth, float distance,
+        float spread, const HrirSpan coeffs, const al::span<uint,2> delays);
+};
+
+
 struct EvRadians { float value; };
 struct AzRadians { float value; };
 struct AngularPoint {
@@ -69,10 +137,30 @@ struct AngularPoint {
 
 
 struct DirectHrtfState {
+    /* FIRs at least this long are applied in the frequency domain. */
+    static constexpr uint FftMinIrSize{40};
+    static constexpr size_t FftSize{HrirLength*2};
+    static constexpr size_t FftBlockCount{(BufferLineSize+HrirLength-1) / HrirLength};
+
     std::array<float,BufferLineSize> mTemp{};
 
+    /* Frequency-domain processing works on HrirLength-sample blocks, zero-
+     * padded to FftSize so the full convolution fits without wrapping. Each
+     * block's left and right results are summed over all channels before
+     * being transformed back.
+     */
+    PFFFTSetup mFft;
+    alignas(16) std::array<float,FftSize> mFftBuffer{};
+    alignas(16) std::array<float,FftSize> mFftWork{};
+    alignas(16) std::array<std::array<float,FftSize>,FftBlockCount*2> mFftAccum{};
+
     /* HRTF filter state for dry buffer content */
     uint mIrSize{0};
+    /* Set when every channel's right filter matches its left filter, or its
+     * negation. The frequency-domain mixer then only applies the left filters,
+     * into separate symmetric and antisymmetric sums.
+     */
+    bool mMirrored{false};
     al::FlexArray<HrtfChannelState> mChannels;
 
     DirectHrtfState(size_t numchans) : mChannels{numchans} { }
@@ -87,12 +175,30 @@ struct DirectHrtfState {
         const al::span<const std::array<float,MaxAmbiChannels>> AmbiMatrix,
         const float XOverFreq, const al::span<const float,MaxAmbiOrder+1> AmbiOrderHFGain);
 
+    /**
+     * Applies the filters in the frequency domain, adding to the output like
+     * MixDirectHrtf. Only valid when mFft is set.
+     */
+    void mixFft(const FloatBufferSpan LeftOut, const FloatBufferSpan RightOut,
+        const al::span<const FloatBufferLine> InSamples, const al::span<float2> AccumSamples,
+        const size_t SamplesToDo);
+
     static std::unique_ptr<DirectHrtfState> Create(size_t num_chans);
 
     DEF_FAM_NEWDEL(DirectHrtfState, mChannels)
 };
 
 
+/* Directory to write pre-resampled HRTF data sets to, which are memory-mapped
+ * when loaded again. Empty to disable the cache.
+ */
+inline std::string HrtfCachePath;
+
+/* Shares loaded HRTF data sets with other processes through named shared
+ * memory, attaching to an existing segment when one was already created.
+ */
+inline bool HrtfSharedMemory{false};
+
 std::vector<std::string> EnumerateHrtf(std::optional<std::string> pathopt);
 HrtfStorePtr GetLoadedHrtf(const std::string_view name, const uint devrate);
 
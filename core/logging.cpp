@@ -3,16 +3,22 @@
 
 #include "logging.h"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cctype>
+#include <chrono>
 #include <cstdarg>
 #include <cstdio>
 #include <cstring>
+#include <exception>
 #include <mutex>
 #include <optional>
 #include <string>
+#include <thread>
 #include <vector>
 
+#include "alsem.h"
 #include "alspan.h"
 #include "opthelpers.h"
 #include "strutils.h"
@@ -48,6 +54,207 @@ LogState gLogState{LogState::FirstRun};
 LogCallbackFunc gLogCallback{};
 void *gLogCallbackPtr{};
 
+/* The nesting depth of real-time scopes on this thread. */
+thread_local uint tRealtimeDepth{0u};
+
+/* A bounded multi-producer queue of formatted messages from real-time threads,
+ * read by the log thread. Each record's sequence number says whether it's
+ * free to write for a given position, or ready to read.
+ */
+class RealtimeLogQueue {
+public:
+    static constexpr size_t QueueSize{64};
+    static constexpr size_t MaxMsgLength{256};
+
+    struct Record {
+        std::atomic<size_t> mSequence;
+        LogLevel mLevel;
+        std::array<char,MaxMsgLength> mMsg;
+    };
+
+private:
+    std::array<Record,QueueSize> mRecords{};
+    std::atomic<size_t> mWritePos{0u};
+    size_t mReadPos{0u};
+    al::semaphore mSem;
+    std::atomic<bool> mQuit{false};
+
+public:
+    std::atomic<uint> mDropped{0u};
+
+    RealtimeLogQueue()
+    {
+        for(size_t i{0};i < mRecords.size();++i)
+            mRecords[i].mSequence.store(i, std::memory_order_relaxed);
+    }
+
+    /* Claims a record to write into, or null if the queue is full. */
+    auto claim() noexcept -> Record*
+    {
+        auto pos = mWritePos.load(std::memory_order_relaxed);
+        while(true)
+        {
+            Record &rec = mRecords[pos%QueueSize];
+            const auto seq = rec.mSequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<ptrdiff_t>(seq - pos);
+            if(diff == 0)
+            {
+                if(mWritePos.compare_exchange_weak(pos, pos+1, std::memory_order_relaxed))
+                    return &rec;
+            }
+            else if(diff < 0)
+                return nullptr;
+            else
+                pos = mWritePos.load(std::memory_order_relaxed);
+        }
+    }
+    void publish(Record *rec) noexcept
+    {
+        const auto seq = rec->mSequence.load(std::memory_order_relaxed);
+        rec->mSequence.store(seq + 1, std::memory_order_release);
+        mSem.post();
+    }
+
+    /* Waits for, and returns, the next record to read. It must be released
+     * when done. Returns null once the queue is stopped and emptied.
+     */
+    auto next() noexcept -> Record*
+    {
+        while(true)
+        {
+            Record &rec = mRecords[mReadPos%QueueSize];
+            if(rec.mSequence.load(std::memory_order_acquire) == mReadPos+1)
+                return &rec;
+            if(mQuit.load(std::memory_order_acquire))
+                return nullptr;
+            mSem.wait();
+        }
+    }
+    void stop() noexcept
+    {
+        mQuit.store(true, std::memory_order_release);
+        mSem.post();
+    }
+    void reset() noexcept { mQuit.store(false, std::memory_order_relaxed); }
+    void release(Record &rec) noexcept
+    {
+        rec.mSequence.store(mReadPos + QueueSize, std::memory_order_release);
+        ++mReadPos;
+    }
+};
+
+std::atomic<RealtimeLogQueue*> gRealtimeLog{nullptr};
+
+void LogOutput(LogLevel level, const char *str, al::span<char> msg) noexcept;
+
+void LogThread(RealtimeLogQueue *queue)
+{
+    static constexpr auto RepeatWindow = std::chrono::seconds{1};
+
+    /* Repeats of the last message within the window are counted instead of
+     * written out, and reported when a different message comes in or the
+     * window passes.
+     */
+    std::array<char,RealtimeLogQueue::MaxMsgLength> lastmsg{};
+    auto lastlevel = LogLevel::Disable;
+    auto lasttime = std::chrono::steady_clock::time_point{};
+    uint repeats{0u};
+    uint lastdropped{0u};
+
+    auto flush_repeats = [&]
+    {
+        if(repeats == 0) return;
+        std::array<char,64> str{};
+        const int len{std::snprintf(str.data(), str.size(),
+            "[ALSOFT] (--) Last message repeated %u times\n", repeats)};
+        LogOutput(lastlevel, str.data(), al::span{str}.subspan(14,
+            static_cast<size_t>(std::max(len, 14)) - 14));
+        repeats = 0;
+    };
+
+    while(RealtimeLogQueue::Record *recptr{queue->next()})
+    {
+        RealtimeLogQueue::Record &rec = *recptr;
+        const auto now = std::chrono::steady_clock::now();
+
+        if(const uint dropped{queue->mDropped.load(std::memory_order_relaxed)};
+            dropped != lastdropped)
+        {
+            flush_repeats();
+            std::array<char,64> str{};
+            const int len{std::snprintf(str.data(), str.size(),
+                "[ALSOFT] (WW) %u real-time log messages dropped\n", dropped-lastdropped)};
+            LogOutput(LogLevel::Warning, str.data(), al::span{str}.subspan(14,
+                static_cast<size_t>(std::max(len, 14)) - 14));
+            lastdropped = dropped;
+        }
+
+        if(rec.mLevel == lastlevel && rec.mMsg == lastmsg && now-lasttime < RepeatWindow)
+            ++repeats;
+        else
+        {
+            flush_repeats();
+            lastmsg = rec.mMsg;
+            lastlevel = rec.mLevel;
+            lasttime = now;
+
+            const size_t len{strnlen(rec.mMsg.data(), rec.mMsg.size())};
+            LogOutput(rec.mLevel, rec.mMsg.data(), al::span{rec.mMsg}.subspan(14,
+                std::max(len, size_t{14}) - 14));
+        }
+        queue->release(rec);
+    }
+    flush_repeats();
+}
+
+/* Owns the log thread and its queue. The thread runs while any device is
+ * open, and is stopped and joined when the last one closes, so it's never
+ * left running when the library unloads, nor joined by a static destructor.
+ * This object is never freed, so a real-time thread that got the queue just
+ * before the thread stopped can still safely write to it. Anything it writes
+ * then is written out when the thread next starts.
+ */
+class RealtimeLogThread {
+    RealtimeLogQueue mQueue;
+    std::mutex mLock;
+    std::thread mThread;
+    uint mRefs{0u};
+
+public:
+    void start()
+    {
+        auto lock = std::lock_guard{mLock};
+        if(mRefs++ > 0)
+            return;
+
+        try {
+            mQueue.reset();
+            mThread = std::thread{LogThread, &mQueue};
+            gRealtimeLog.store(&mQueue, std::memory_order_release);
+        }
+        catch(std::exception &e) {
+            ERR("Failed to start log thread: %s\n", e.what());
+        }
+    }
+
+    void stop()
+    {
+        auto lock = std::lock_guard{mLock};
+        if(--mRefs > 0 || !mThread.joinable())
+            return;
+
+        gRealtimeLog.store(nullptr, std::memory_order_release);
+        mQueue.stop();
+        mThread.join();
+    }
+
+    static RealtimeLogThread &Get()
+    {
+        static auto *thrd = new RealtimeLogThread{};
+        return *thrd;
+    }
+};
+
 constexpr auto GetLevelCode(LogLevel level) noexcept -> std::optional<char>
 {
     switch(level)
@@ -77,6 +284,12 @@ void al_set_log_callback(LogCallbackFunc callback, void *userptr)
     }
 }
 
+void al_start_log_thread() { RealtimeLogThread::Get().start(); }
+void al_stop_log_thread() { RealtimeLogThread::Get().stop(); }
+
+void al_log_enter_realtime() noexcept { ++tRealtimeDepth; }
+void al_log_leave_realtime() noexcept { --tRealtimeDepth; }
+
 void al_print(LogLevel level, const char *fmt, ...) noexcept
 try {
     /* Kind of ugly since string literals are const char arrays with a size
@@ -92,6 +305,36 @@ try {
     case LogLevel::Trace: prefix = al::span{"[ALSOFT] (II) "}.first<14>(); break;
     }
 
+    if(tRealtimeDepth > 0)
+    {
+        /* Format into a queue record for the log thread to write out, without
+         * allocating or taking any locks. If the log thread isn't running, fall
+         * through to writing it out here.
+         */
+        if(auto *queue = gRealtimeLog.load(std::memory_order_acquire))
+        {
+            auto *rec = queue->claim();
+            if(!rec)
+            {
+                queue->mDropped.fetch_add(1u, std::memory_order_relaxed);
+                return;
+            }
+            rec->mLevel = level;
+            auto msgbegin = std::copy_n(prefix.begin(), prefix.size(), rec->mMsg.begin());
+            const auto msgspace = static_cast<size_t>(std::distance(msgbegin, rec->mMsg.end()));
+
+            /* NOLINTBEGIN(*-array-to-pointer-decay) */
+            std::va_list args;
+            va_start(args, fmt);
+            std::vsnprintf(al::to_address(msgbegin), msgspace, fmt, args);
+            va_end(args);
+            /* NOLINTEND(*-array-to-pointer-decay) */
+
+            queue->publish(rec);
+            return;
+        }
+    }
+
     std::vector<char> dynmsg;
     std::array<char,256> stcmsg{};
 
@@ -124,6 +367,19 @@ try {
     va_end(args);
     /* NOLINTEND(*-array-to-pointer-decay) */
 
+    LogOutput(level, str, msg);
+}
+catch(...) {
+    /* Swallow any exceptions */
+}
+
+namespace {
+
+/* Writes out a formatted message. str is the full message with the prefix,
+ * and msg is the part without it.
+ */
+void LogOutput(LogLevel level, const char *str, al::span<char> msg) noexcept
+try {
     if(gLogLevel >= level)
     {
         auto logfile = gLogFile;
@@ -174,3 +430,5 @@ try {
 catch(...) {
     /* Swallow any exceptions */
 }
+
+} // namespace
@@ -19,6 +19,31 @@ using LogCallbackFunc = void(*)(void *userptr, char level, const char *message,
 
 void al_set_log_callback(LogCallbackFunc callback, void *userptr);
 
+/* Starts and stops the thread that writes out messages logged from real-time
+ * threads. Each start must be paired with a stop, and the thread runs while
+ * any are unpaired. While it isn't running, those messages are written out
+ * directly.
+ */
+void al_start_log_thread();
+void al_stop_log_thread();
+
+/* Marks the calling thread as real-time, so its messages are formatted into a
+ * lock-free queue for the log thread to write out, instead of blocking on the
+ * log file or callback. Messages are truncated to a fixed length, and dropped
+ * if the queue is full.
+ */
+void al_log_enter_realtime() noexcept;
+void al_log_leave_realtime() noexcept;
+
+class LogRealtimeScope {
+public:
+    LogRealtimeScope() noexcept { al_log_enter_realtime(); }
+    ~LogRealtimeScope() { al_log_leave_realtime(); }
+
+    LogRealtimeScope(const LogRealtimeScope&) = delete;
+    LogRealtimeScope& operator=(const LogRealtimeScope&) = delete;
+};
+
 
 #ifdef __MINGW32__
 [[gnu::format(__MINGW_PRINTF_FORMAT,2,3)]]
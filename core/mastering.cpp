@@ -10,20 +10,24 @@
 #include <iterator>
 #include <limits>
 #include <new>
+#include <numeric>
+#include <vector>
+
+#ifdef HAVE_SSE_INTRINSICS
+#include <xmmintrin.h>
+#endif
 
 #include "alnumeric.h"
 #include "alspan.h"
 #include "opthelpers.h"
+#include "polyphase_resampler.h"
 
 
-/* These structures assume BufferLineSize is a power of 2. */
-static_assert((BufferLineSize & (BufferLineSize-1)) == 0, "BufferLineSize is not a power of 2");
-
 struct SlidingHold {
-    alignas(16) FloatBufferLine mValues;
-    std::array<uint,BufferLineSize> mExpiries;
-    uint mLowerIndex;
-    uint mUpperIndex;
+    /* The last mLength-1 input values, followed by the new input. */
+    alignas(16) std::array<float,BufferLineSize*2_uz> mValues;
+    /* Working storage for the maxima of increasingly wide windows. */
+    alignas(16) std::array<std::array<float,BufferLineSize*2_uz>,2> mMaxima;
     uint mLength;
 };
 
@@ -34,67 +38,80 @@ template<std::size_t A, typename T, std::size_t N>
 constexpr auto assume_aligned_span(const al::span<T,N> s) noexcept -> al::span<T,N>
 { return al::span<T,N>{al::assume_aligned<A>(s.data()), s.size()}; }
 
-/* This sliding hold follows the input level with an instant attack and a
- * fixed duration hold before an instant release to the next highest level.
- * It is a sliding window maximum (descending maxima) implementation based on
- * Richard Harter's ascending minima algorithm available at:
- *
- *   http://www.richardhartersworld.com/cri/2001/slidingmin.html
- */
-float UpdateSlidingHold(SlidingHold *Hold, const uint i, const float in)
+/* Both spans are multiples of 4 in length. */
+[[nodiscard]]
+auto DotProduct(const al::span<const float> values, const al::span<const float> filter) noexcept
+    -> float
 {
-    static constexpr uint mask{BufferLineSize - 1};
-    const uint length{Hold->mLength};
-    const al::span values{Hold->mValues};
-    const al::span expiries{Hold->mExpiries};
-    uint lowerIndex{Hold->mLowerIndex};
-    uint upperIndex{Hold->mUpperIndex};
-
-    if(i >= expiries[upperIndex])
-        upperIndex = (upperIndex + 1) & mask;
-
-    if(in >= values[upperIndex])
+#ifdef HAVE_SSE_INTRINSICS
+    __m128 r4{_mm_setzero_ps()};
+    for(size_t j{0};j < filter.size();j+=4)
     {
-        values[upperIndex] = in;
-        expiries[upperIndex] = i + length;
-        lowerIndex = upperIndex;
+        const __m128 coeffs{_mm_loadu_ps(&filter[j])};
+        const __m128 s{_mm_loadu_ps(&values[j])};
+        r4 = _mm_add_ps(r4, _mm_mul_ps(s, coeffs));
     }
-    else
-    {
-        auto findLowerIndex = [&lowerIndex,in,values]() noexcept -> bool
-        {
-            do {
-                if(!(in >= values[lowerIndex]))
-                    return true;
-            } while(lowerIndex--);
-            return false;
-        };
-        while(!findLowerIndex())
-            lowerIndex = mask;
+    r4 = _mm_add_ps(r4, _mm_shuffle_ps(r4, r4, _MM_SHUFFLE(0, 1, 2, 3)));
+    r4 = _mm_add_ps(r4, _mm_movehl_ps(r4, r4));
+    return _mm_cvtss_f32(r4);
 
-        lowerIndex = (lowerIndex + 1) & mask;
-        values[lowerIndex] = in;
-        expiries[lowerIndex] = i + length;
-    }
+#else
 
-    Hold->mLowerIndex = lowerIndex;
-    Hold->mUpperIndex = upperIndex;
+    std::array<float,4> r{};
+    for(size_t j{0};j < filter.size();j+=4)
+    {
+        r[0] += values[j+0]*filter[j+0];
+        r[1] += values[j+1]*filter[j+1];
+        r[2] += values[j+2]*filter[j+2];
+        r[3] += values[j+3]*filter[j+3];
+    }
+    return (r[0] + r[1]) + (r[2] + r[3]);
+#endif
+}
 
-    return values[upperIndex];
+/* Stores the element-wise maximum of a and b into dst. */
+void MaxOf(const al::span<const float> a, const al::span<const float> b, const al::span<float> dst)
+{
+    size_t i{0};
+#ifdef HAVE_SSE_INTRINSICS
+    for(;dst.size()-i >= 4;i += 4)
+        _mm_storeu_ps(&dst[i], _mm_max_ps(_mm_loadu_ps(&a[i]), _mm_loadu_ps(&b[i])));
+#endif
+    const auto a_end = a.begin() + ptrdiff_t(dst.size());
+    std::transform(a.begin()+ptrdiff_t(i), a_end, b.begin()+ptrdiff_t(i), dst.begin()+ptrdiff_t(i),
+        [](const float v0, const float v1) noexcept -> float { return std::max(v0, v1); });
 }
 
-void ShiftSlidingHold(SlidingHold *Hold, const uint n)
+/* This sliding hold follows the input level with an instant attack and a
+ * fixed duration hold before an instant release to the next highest level.
+ * Rather than tracking descending maxima sample-by-sample, it's a sliding
+ * window maximum calculated over the whole block: the maximum of each pair of
+ * values is taken, then each pair of pairs, etc, doubling the window width
+ * until it covers at least half the hold length. Two overlapping windows then
+ * cover the full hold length for each output. Each step is an element-wise
+ * maximum of two offset arrays, which vectorizes well.
+ */
+void UpdateSlidingHold(SlidingHold *Hold, const al::span<float> inout)
 {
-    auto exp_upper = Hold->mExpiries.begin() + Hold->mUpperIndex;
-    if(Hold->mLowerIndex < Hold->mUpperIndex)
+    const size_t length{Hold->mLength};
+    const auto values = al::span{Hold->mValues}.first(length-1 + inout.size());
+    std::copy(inout.begin(), inout.end(), values.begin()+ptrdiff_t(length-1));
+
+    al::span<const float> src{values};
+    size_t width{1};
+    size_t maxidx{0};
+    for(;width*2 <= length;width *= 2)
     {
-        std::transform(exp_upper, Hold->mExpiries.end(), exp_upper,
-            [n](const uint e) noexcept { return e - n; });
-        exp_upper = Hold->mExpiries.begin();
+        const auto dst = al::span{Hold->mMaxima[maxidx]}.first(src.size() - width);
+        MaxOf(src.first(dst.size()), src.subspan(width), dst);
+        src = dst;
+        maxidx ^= 1;
     }
-    const auto exp_lower = Hold->mExpiries.begin() + Hold->mLowerIndex;
-    std::transform(exp_upper, exp_lower+1, exp_upper,
-        [n](const uint e) noexcept { return e - n; });
+    MaxOf(src.first(inout.size()), src.subspan(length - width), inout);
+
+    /* Keep the last length-1 values for the next update. */
+    const auto history = values.last(length-1);
+    std::copy(history.begin(), history.end(), values.begin());
 }
 
 } // namespace
@@ -114,14 +131,82 @@ void Compressor::linkChannels(const uint SamplesToDo,
     auto fill_max = [sideChain](const FloatBufferLine &input) -> void
     {
         const auto buffer = assume_aligned_span<16>(al::span{input});
+        size_t i{0};
+#ifdef HAVE_SSE_INTRINSICS
+        const __m128 absmask{_mm_castsi128_ps(_mm_set1_epi32(0x7fffffff))};
+        for(;sideChain.size()-i >= 4;i += 4)
+        {
+            const __m128 s{_mm_and_ps(_mm_load_ps(&buffer[i]), absmask)};
+            _mm_storeu_ps(&sideChain[i], _mm_max_ps(_mm_loadu_ps(&sideChain[i]), s));
+        }
+#endif
         auto max_abs = [](const float s0, const float s1) noexcept -> float
         { return std::max(s0, std::fabs(s1)); };
-        std::transform(sideChain.begin(), sideChain.end(), buffer.begin(), sideChain.begin(),
-            max_abs);
+        std::transform(sideChain.begin()+ptrdiff_t(i), sideChain.end(),
+            buffer.begin()+ptrdiff_t(i), sideChain.begin()+ptrdiff_t(i), max_abs);
     };
     std::for_each(OutBuffer.begin(), OutBuffer.end(), fill_max);
 }
 
+/* With true-peak detection, each side-chain sample is the absolute maximum of
+ * all channels for the sample TruePeakDelay samples back, along with the
+ * interpolated points between it and the previous sample. Interpolating is
+ * the bulk of the cost, so it's skipped for runs of samples that couldn't
+ * produce a peak within 6dB of the threshold.
+ */
+void Compressor::linkChannelsTruePeak(const uint SamplesToDo,
+    const al::span<const FloatBufferLine> OutBuffer)
+{
+    static constexpr size_t HistLen{TruePeakTaps-1};
+    static constexpr size_t GateStep{16};
+
+    ASSUME(SamplesToDo > 0);
+    ASSUME(SamplesToDo <= BufferLineSize);
+
+    const auto sideChain = al::span{mSideChain}.subspan(mLookAhead, SamplesToDo);
+    std::fill_n(sideChain.begin(), sideChain.size(), 0.0f);
+
+    /* The work buffer holds the channel's history, followed by the new
+     * samples. Side-chain sample i is for work sample i+TruePeakDelay+1, and
+     * the filters run over work samples i through i+HistLen.
+     */
+    const auto work = al::span{mTruePeakWork}.first(HistLen + SamplesToDo);
+    auto history = mTruePeakHistory.begin();
+    for(const FloatBufferLine &input : OutBuffer)
+    {
+        std::copy(history->cbegin(), history->cend(), work.begin());
+        std::copy_n(input.cbegin(), SamplesToDo, work.begin()+HistLen);
+
+        std::transform(sideChain.begin(), sideChain.end(), work.begin()+TruePeakDelay+1,
+            sideChain.begin(), [](const float s0, const float s1) noexcept -> float
+            { return std::max(s0, std::fabs(s1)); });
+
+        for(size_t base{0};base < SamplesToDo;base += GateStep)
+        {
+            const size_t todo{std::min<size_t>(GateStep, SamplesToDo-base)};
+            const auto samples = work.subspan(base, todo+HistLen);
+            const float maxabs{std::accumulate(samples.begin(), samples.end(), 0.0f,
+                [](const float a, const float b) noexcept { return std::max(a, std::fabs(b)); })};
+            if(maxabs < mTruePeakGate)
+                continue;
+
+            for(size_t i{base};i < base+todo;++i)
+            {
+                float peak{sideChain[i]};
+                for(const TruePeakFilter &filter : mTruePeakFilter)
+                {
+                    const float s{DotProduct(work.subspan(i, TruePeakTaps), filter)};
+                    peak = std::max(peak, std::fabs(s));
+                }
+                sideChain[i] = peak;
+            }
+        }
+
+        std::copy(work.end()-HistLen, work.end(), history->begin());
+        ++history;
+    }
+}
+
 /* This calculates the squared crest factor of the control signal for the
  * basic automation of the attack/release times.  As suggested by the paper,
  * it uses an instantaneous squared peak detector and a squared RMS detector
@@ -175,17 +260,8 @@ void Compressor::peakHoldDetector(const uint SamplesToDo)
     ASSUME(SamplesToDo > 0);
     ASSUME(SamplesToDo <= BufferLineSize);
 
-    SlidingHold *hold{mHold.get()};
-    uint i{0};
-    auto detect_peak = [&i,hold](const float x_abs) -> float
-    {
-        const float x_G{std::log(std::max(0.000001f, x_abs))};
-        return UpdateSlidingHold(hold, i++, x_G);
-    };
-    auto sideChain = al::span{mSideChain}.subspan(mLookAhead, SamplesToDo);
-    std::transform(sideChain.cbegin(), sideChain.cend(), sideChain.begin(), detect_peak);
-
-    ShiftSlidingHold(hold, SamplesToDo);
+    peakDetector(SamplesToDo);
+    UpdateSlidingHold(mHold.get(), al::span{mSideChain}.subspan(mLookAhead, SamplesToDo));
 }
 
 /* This is the heart of the feed-forward compressor.  It operates in the log
@@ -205,22 +281,27 @@ void Compressor::gainCompressor(const uint SamplesToDo)
     const float attack{mAttack};
     const float release{mRelease};
     const float c_est{mGainEstimate};
-    const float a_adp{mAdaptCoeff};
-    auto lookAhead = mSideChain.cbegin() + mLookAhead;
-    auto crestFactor = mCrestFactor.cbegin();
+    const uint step{mControlStep};
+    const auto stepf = static_cast<float>(step);
+    const float a_adp{std::pow(mAdaptCoeff, stepf)};
     float postGain{mPostGain};
     float knee{mKnee};
     float t_att{attack};
     float t_rel{release - attack};
-    float a_att{std::exp(-1.0f / t_att)};
-    float a_rel{std::exp(-1.0f / t_rel)};
+    float a_att{std::exp(-stepf / t_att)};
+    float a_rel{std::exp(-stepf / t_rel)};
     float y_1{mLastRelease};
     float y_L{mLastAttack};
     float c_dev{mLastGainDev};
 
     ASSUME(SamplesToDo > 0);
 
-    auto process = [&](const float input) -> float
+    /* Runs the gain computer for the given number of samples, returning the
+     * log-domain gain. The coefficients are for a full control step, and are
+     * only recalculated for shorter ones.
+     */
+    auto process = [&](const float input, const float x_G, const float y2_crest,
+        const uint count) -> float
     {
         if(autoKnee)
             knee = std::max(0.0f, 2.5f * (c_dev + c_est));
@@ -229,23 +310,21 @@ void Compressor::gainCompressor(const uint SamplesToDo)
         /* This is the gain computer.  It applies a static compression curve
          * to the control signal.
          */
-        const float x_over{*(lookAhead++) - threshold};
+        const float x_over{x_G - threshold};
         const float y_G{
             (x_over <= -knee_h) ? 0.0f :
             (std::fabs(x_over) < knee_h) ? (x_over+knee_h) * (x_over+knee_h) / (2.0f * knee) :
             x_over};
 
-        const float y2_crest{*(crestFactor++)};
+        const auto n = static_cast<float>(count);
         if(autoAttack)
-        {
             t_att = 2.0f*attack/y2_crest;
-            a_att = std::exp(-1.0f / t_att);
-        }
         if(autoRelease)
-        {
             t_rel = 2.0f*release/y2_crest - t_att;
-            a_rel = std::exp(-1.0f / t_rel);
-        }
+        if(autoAttack || count != step)
+            a_att = std::exp(-n / t_att);
+        if(autoRelease || count != step)
+            a_rel = std::exp(-n / t_rel);
 
         /* Gain smoothing (ballistics) is done via a smooth decoupled peak
          * detector.  The attack time is subtracted from the release time
@@ -260,7 +339,7 @@ void Compressor::gainCompressor(const uint SamplesToDo)
          * The estimate is also used to bias the measurement to hot-start its
          * average.
          */
-        c_dev = lerpf(-(y_L+c_est), c_dev, a_adp);
+        c_dev = lerpf(-(y_L+c_est), c_dev, (count == step) ? a_adp : std::pow(mAdaptCoeff, n));
 
         if(autoPostGain)
         {
@@ -276,10 +355,50 @@ void Compressor::gainCompressor(const uint SamplesToDo)
             postGain = -(c_dev + c_est);
         }
 
-        return std::exp(postGain - y_L);
+        return postGain - y_L;
     };
+
+    const auto crestFactor = al::span{mCrestFactor}.first(SamplesToDo);
+    const auto lookAhead = al::span{mSideChain}.subspan(mLookAhead, SamplesToDo);
     auto sideChain = al::span{mSideChain}.first(SamplesToDo);
-    std::transform(sideChain.begin(), sideChain.end(), sideChain.begin(), process);
+    if(step == 1)
+    {
+        auto crest = crestFactor.begin();
+        std::transform(sideChain.begin(), sideChain.end(), lookAhead.begin(), sideChain.begin(),
+            [&process,&crest](const float input, const float x_G) -> float
+            { return std::exp(process(input, x_G, *(crest++), 1)); });
+    }
+    else
+    {
+        /* At a reduced control rate, the gain computer takes the peak of each
+         * step. Increases in gain are interpolated across the step, while
+         * reductions apply to the whole step so none of its samples exceed
+         * the limit.
+         */
+        float lastGain{mLastGain};
+        for(size_t base{0};base < SamplesToDo;base += step)
+        {
+            const size_t count{std::min<size_t>(step, SamplesToDo-base)};
+            const auto inputs = sideChain.subspan(base, count);
+            const auto x_Gs = lookAhead.subspan(base, count);
+
+            const float input{*std::max_element(inputs.begin(), inputs.end())};
+            const float x_G{*std::max_element(x_Gs.begin(), x_Gs.end())};
+            const float gain{std::exp(process(input, x_G, crestFactor[base+count-1],
+                static_cast<uint>(count)))};
+
+            if(!(gain > lastGain))
+                std::fill(inputs.begin(), inputs.end(), gain);
+            else
+            {
+                const float scale{1.0f / static_cast<float>(count)};
+                for(size_t i{0};i < count;++i)
+                    inputs[i] = lerpf(lastGain, gain, static_cast<float>(i+1) * scale);
+            }
+            lastGain = gain;
+        }
+        mLastGain = lastGain;
+    }
 
     mLastRelease = y_1;
     mLastAttack = y_L;
@@ -293,7 +412,7 @@ void Compressor::gainCompressor(const uint SamplesToDo)
  */
 void Compressor::signalDelay(const uint SamplesToDo, const al::span<FloatBufferLine> OutBuffer)
 {
-    const auto lookAhead = mLookAhead;
+    const auto lookAhead = mLookAhead + mPeakDelay;
 
     ASSUME(SamplesToDo > 0);
     ASSUME(SamplesToDo <= BufferLineSize);
@@ -325,10 +444,15 @@ std::unique_ptr<Compressor> Compressor::Create(const size_t NumChans, const floa
     const bool AutoKnee, const bool AutoAttack, const bool AutoRelease, const bool AutoPostGain,
     const bool AutoDeclip, const float LookAheadTime, const float HoldTime, const float PreGainDb,
     const float PostGainDb, const float ThresholdDb, const float Ratio, const float KneeDb,
-    const float AttackTime, const float ReleaseTime)
+    const float AttackTime, const float ReleaseTime, const uint ControlDivisor,
+    const bool TruePeak)
 {
+    /* The signal is delayed by the look-ahead and the true-peak detector's
+     * delay together, which needs to fit in a buffer line.
+     */
+    const uint peakDelay{TruePeak ? TruePeakDelay : 0u};
     const auto lookAhead = static_cast<uint>(std::clamp(std::round(LookAheadTime*SampleRate), 0.0f,
-        BufferLineSize-1.0f));
+        static_cast<float>(BufferLineSize-1 - peakDelay)));
     const auto hold = static_cast<uint>(std::clamp(std::round(HoldTime*SampleRate), 0.0f,
         BufferLineSize-1.0f));
 
@@ -340,6 +464,7 @@ std::unique_ptr<Compressor> Compressor::Create(const size_t NumChans, const floa
     Comp->mAuto.PostGain = AutoPostGain;
     Comp->mAuto.Declip = AutoPostGain && AutoDeclip;
     Comp->mLookAhead = lookAhead;
+    Comp->mControlStep = std::clamp(ControlDivisor, 1u, std::max(lookAhead, 1u));
     Comp->mPreGain = std::pow(10.0f, PreGainDb / 20.0f);
     Comp->mPostGain = std::log(10.0f)/20.0f * PostGainDb;
     Comp->mThreshold = std::log(10.0f)/20.0f * ThresholdDb;
@@ -355,17 +480,49 @@ std::unique_ptr<Compressor> Compressor::Create(const size_t NumChans, const floa
     if(AutoKnee)
         Comp->mSlope = -1.0f;
 
-    if(lookAhead > 0)
+    if(TruePeak)
+    {
+        /* The transition band ends a bit past the nyquist, to keep the pass
+         * band wide with only 12 taps per phase. Each phase's DC gain is
+         * normalized.
+         */
+        static constexpr double FilterRejection{60.0};
+        auto filter = std::vector<double>(TruePeakPhases*TruePeakTaps + 1);
+        MakeKaiserSincLowPass(FilterRejection, 0.6/TruePeakPhases, 1.0, filter);
+
+        float maxgain{0.0f};
+        for(size_t p{1};p < TruePeakPhases;++p)
+        {
+            TruePeakFilter &dst = Comp->mTruePeakFilter[p-1];
+            double dcgain{0.0};
+            for(size_t k{0};k < TruePeakTaps;++k)
+                dcgain += filter[k*TruePeakPhases + p];
+            for(size_t k{0};k < TruePeakTaps;++k)
+                dst[TruePeakTaps-1 - k] = static_cast<float>(filter[k*TruePeakPhases + p]
+                    / dcgain);
+
+            maxgain = std::max(maxgain, std::accumulate(dst.cbegin(), dst.cend(), 0.0f,
+                [](const float a, const float b) noexcept { return a + std::fabs(b); }));
+        }
+
+        /* Samples below this level can't interpolate to within 6dB of the
+         * threshold.
+         */
+        Comp->mPeakDelay = peakDelay;
+        Comp->mTruePeakGate = std::exp(Comp->mThreshold) * 0.5f / maxgain;
+        Comp->mTruePeakHistory.resize(NumChans, {});
+    }
+
+    if(lookAhead+peakDelay > 0)
     {
         /* The sliding hold implementation doesn't handle a length of 1. A 1-
          * sample hold is useless anyway, it would only ever give back what was
-         * just given to it.
+         * just given to it. The hold also needs a look-ahead to be of use.
          */
-        if(hold > 1)
+        if(hold > 1 && lookAhead > 0)
         {
             Comp->mHold = std::make_unique<SlidingHold>();
-            Comp->mHold->mValues[0] = -std::numeric_limits<float>::infinity();
-            Comp->mHold->mExpiries[0] = hold;
+            Comp->mHold->mValues.fill(-std::numeric_limits<float>::infinity());
             Comp->mHold->mLength = hold;
         }
         Comp->mDelay.resize(NumChans, FloatBufferLine{});
@@ -374,6 +531,7 @@ std::unique_ptr<Compressor> Compressor::Create(const size_t NumChans, const floa
     Comp->mCrestCoeff = std::exp(-1.0f / (0.200f * SampleRate)); // 200ms
     Comp->mGainEstimate = Comp->mThreshold * -0.5f * Comp->mSlope;
     Comp->mAdaptCoeff = std::exp(-1.0f / (2.0f * SampleRate)); // 2s
+    Comp->mLastGain = std::exp(Comp->mPostGain);
 
     return Comp;
 }
@@ -402,7 +560,10 @@ void Compressor::process(const uint SamplesToDo, FloatBufferLine *OutBuffer)
         std::for_each(output.begin(), output.end(), apply_gain);
     }
 
-    linkChannels(SamplesToDo, output);
+    if(mPeakDelay > 0)
+        linkChannelsTruePeak(SamplesToDo, output);
+    else
+        linkChannels(SamplesToDo, output);
 
     if(mAuto.Attack || mAuto.Release)
         crestDetector(SamplesToDo);
@@ -38,6 +38,22 @@ class Compressor {
     AutoFlags mAuto{};
 
     uint mLookAhead{0};
+    uint mControlStep{1};
+
+    /* True-peak detection interpolates three points between each sample (4x
+     * oversampling) with a polyphase filter, delaying the detector by a few
+     * samples.
+     */
+    static constexpr uint TruePeakPhases{4};
+    static constexpr uint TruePeakTaps{12}; /* Multiple of 4. */
+    static constexpr uint TruePeakDelay{TruePeakTaps/2 - 1};
+    using TruePeakFilter = std::array<float,TruePeakTaps>;
+
+    uint mPeakDelay{0};
+    float mTruePeakGate{0.0f};
+    std::array<TruePeakFilter,TruePeakPhases-1> mTruePeakFilter{};
+    al::vector<std::array<float,TruePeakTaps-1>,16> mTruePeakHistory;
+    alignas(16) std::array<float,BufferLineSize+TruePeakTaps> mTruePeakWork{};
 
     float mPreGain{0.0f};
     float mPostGain{0.0f};
@@ -64,10 +80,13 @@ class Compressor {
     float mLastRelease{0.0f};
     float mLastAttack{0.0f};
     float mLastGainDev{0.0f};
+    float mLastGain{1.0f};
 
     Compressor() = default;
 
     void linkChannels(const uint SamplesToDo, const al::span<const FloatBufferLine> OutBuffer);
+    void linkChannelsTruePeak(const uint SamplesToDo,
+        const al::span<const FloatBufferLine> OutBuffer);
     void crestDetector(const uint SamplesToDo);
     void peakDetector(const uint SamplesToDo);
     void peakHoldDetector(const uint SamplesToDo);
@@ -77,7 +96,7 @@ class Compressor {
 public:
     ~Compressor();
     void process(const uint SamplesToDo, FloatBufferLine *OutBuffer);
-    [[nodiscard]] auto getLookAhead() const noexcept -> uint { return mLookAhead; }
+    [[nodiscard]] auto getLookAhead() const noexcept -> uint { return mLookAhead + mPeakDelay; }
 
     /**
      * The compressor is initialized with the following settings:
@@ -104,13 +123,18 @@ public:
      *        automating attack time.
      * \param ReleaseTime   Release time (in seconds). Acts as a maximum when
      *        automating release time.
+     * \param ControlDivisor How many samples to run the gain computer for at
+     *        once. The gain is interpolated in between. Limited to the
+     *        look-ahead length.
+     * \param TruePeak      Whether to detect inter-sample (true) peaks, rather
+     *        than only sample peaks. Adds a few samples of delay.
      */
     static std::unique_ptr<Compressor> Create(const size_t NumChans, const float SampleRate,
         const bool AutoKnee, const bool AutoAttack, const bool AutoRelease,
         const bool AutoPostGain, const bool AutoDeclip, const float LookAheadTime,
         const float HoldTime, const float PreGainDb, const float PostGainDb,
         const float ThresholdDb, const float Ratio, const float KneeDb, const float AttackTime,
-        const float ReleaseTime);
+        const float ReleaseTime, const uint ControlDivisor, const bool TruePeak);
 };
 using CompressorPtr = std::unique_ptr<Compressor>;
 
@@ -0,0 +1,55 @@
+#ifndef CORE_MEMUSAGE_H
+#define CORE_MEMUSAGE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+using uint = unsigned int;
+
+
+/* Running totals of the memory a device has allocated, in bytes. The counters
+ * are adjusted where the storage is allocated and freed, and may be read from
+ * any thread. The device holds them with shared ownership, since some storage
+ * (like a context's, when the device is closed first) can be freed after the
+ * device is gone.
+ */
+struct MemoryUsage {
+    enum Counter : uint {
+        /* Sample storage for buffers. */
+        Buffers,
+        /* The HRTF data set and the device's HRTF filter state. */
+        Hrtf,
+        /* Effect slots, and the delay lines, filters, and other storage of
+         * their effect states.
+         */
+        Effects,
+        /* Voices, and the voice changes to start and stop them. */
+        Voices,
+        /* Source, effect slot, and context property updates. */
+        Props,
+
+        CounterCount
+    };
+    std::array<std::atomic<std::size_t>,CounterCount> mCounters{};
+
+    void add(Counter counter, std::size_t bytes) noexcept
+    { mCounters[counter].fetch_add(bytes, std::memory_order_relaxed); }
+    void sub(Counter counter, std::size_t bytes) noexcept
+    { mCounters[counter].fetch_sub(bytes, std::memory_order_relaxed); }
+    void set(Counter counter, std::size_t bytes) noexcept
+    { mCounters[counter].store(bytes, std::memory_order_relaxed); }
+
+    /* Replaces an amount previously added with a new one. */
+    void update(Counter counter, std::size_t oldbytes, std::size_t newbytes) noexcept
+    {
+        if(newbytes > oldbytes) add(counter, newbytes-oldbytes);
+        else if(oldbytes > newbytes) sub(counter, oldbytes-newbytes);
+    }
+
+    [[nodiscard]]
+    auto get(Counter counter) const noexcept -> std::size_t
+    { return mCounters[counter].load(std::memory_order_relaxed); }
+};
+
+#endif /* CORE_MEMUSAGE_H */
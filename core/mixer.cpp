@@ -5,6 +5,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <utility>
 
 #include "alnumbers.h"
@@ -17,6 +18,47 @@ struct CTag;
 
 MixerOutFunc MixSamplesOut{Mix_<CTag>};
 MixerOneFunc MixSamplesOne{Mix_<CTag>};
+MixerBatchFunc MixSamplesBatch{MixBatch_<CTag>};
+
+
+void MixerScratch::mixBatched(const al::span<const float> samples,
+    const al::span<FloatBufferLine> outBuffer, const al::span<float> currentGains,
+    const al::span<const float> targetGains, const std::size_t counter, const std::size_t outPos)
+{
+    if(mBatchCount > 0)
+    {
+        if(outBuffer.data() != mBatchTarget.data() || outBuffer.size() != mBatchTarget.size()
+            || samples.size() != mBatchInputs[0].Samples.size() || counter != mBatchCounter
+            || outPos != mBatchOutPos)
+            flushBatch();
+    }
+    if(mBatchCount == 0)
+    {
+        mBatchTarget = outBuffer;
+        mBatchCounter = counter;
+        mBatchOutPos = outPos;
+    }
+
+    auto &input = mBatchInputs[mBatchCount];
+    const auto batchline = al::span{mBatchSamples[mBatchCount]}.first(samples.size());
+    std::copy(samples.begin(), samples.end(), batchline.begin());
+    input.Samples = batchline;
+    input.CurrentGains = currentGains;
+    input.TargetGains = targetGains;
+
+    if(++mBatchCount == mBatchInputs.size())
+        flushBatch();
+}
+
+void MixerScratch::flushBatch()
+{
+    if(mBatchCount == 0)
+        return;
+
+    MixSamples(al::span{mBatchInputs}.first(mBatchCount), mBatchTarget, mBatchCounter,
+        mBatchOutPos);
+    mBatchCount = 0;
+}
 
 
 std::array<float,MaxAmbiChannels> CalcAmbiCoeffs(const float y, const float z, const float x,
@@ -84,13 +126,43 @@ std::array<float,MaxAmbiChannels> CalcAmbiCoeffs(const float y, const float z, c
     return coeffs;
 }
 
+namespace {
+
+/* Computes the pan gains for a fixed number of mix channels, so the common
+ * ambisonic buffer sizes (first-, second-, and third-order) get fully unrolled
+ * loops.
+ */
+template<size_t N>
+void ComputePanGainsN(const al::span<const BFChannelConfig,N> ambimap,
+    const al::span<const float,MaxAmbiChannels> coeffs, const float ingain,
+    const al::span<float,N> gains) noexcept
+{
+    for(size_t i{0};i < N;++i)
+        gains[i] = ambimap[i].Scale * coeffs[ambimap[i].Index] * ingain;
+}
+
+} // namespace
+
 void ComputePanGains(const MixParams *mix, const al::span<const float,MaxAmbiChannels> coeffs,
-    const float ingain, const al::span<float,MaxAmbiChannels> gains)
+    const float ingain, const al::span<float> gains)
 {
-    auto ambimap = al::span{std::as_const(mix->AmbiMap)}.first(mix->Buffer.size());
+    const auto ambimap = al::span{std::as_const(mix->AmbiMap)}.first(mix->Buffer.size());
 
-    auto iter = std::transform(ambimap.begin(), ambimap.end(), gains.begin(),
-        [coeffs,ingain](const BFChannelConfig &chanmap) noexcept -> float
-        { return chanmap.Scale * coeffs[chanmap.Index] * ingain; });
-    std::fill(iter, gains.end(), 0.0f);
+    switch(ambimap.size())
+    {
+    case 4:
+        ComputePanGainsN(ambimap.first<4>(), coeffs, ingain, gains.first<4>());
+        break;
+    case 9:
+        ComputePanGainsN(ambimap.first<9>(), coeffs, ingain, gains.first<9>());
+        break;
+    case 16:
+        ComputePanGainsN(ambimap.first<16>(), coeffs, ingain, gains.first<16>());
+        break;
+    default:
+        std::transform(ambimap.begin(), ambimap.end(), gains.begin(),
+            [coeffs,ingain](const BFChannelConfig &chanmap) noexcept -> float
+            { return chanmap.Scale * coeffs[chanmap.Index] * ingain; });
+    }
+    std::fill(gains.begin()+static_cast<ptrdiff_t>(ambimap.size()), gains.end(), 0.0f);
 }
@@ -9,6 +9,7 @@
 #include "ambidefs.h"
 #include "bufferline.h"
 
+struct MixBatchInput;
 struct MixParams;
 
 /* Mixer functions that handle one input and multiple output channels. */
@@ -31,6 +32,17 @@ inline void MixSamples(const al::span<const float> InSamples, const al::span<flo
     float &CurrentGain, const float TargetGain, const std::size_t Counter)
 { MixSamplesOne(InSamples, OutBuffer, CurrentGain, TargetGain, Counter); }
 
+/* Mixer functions that handle multiple inputs and multiple output channels. */
+using MixerBatchFunc = void(*)(const al::span<const MixBatchInput> Inputs,
+    const al::span<FloatBufferLine> OutBuffer, const std::size_t Counter,
+    const std::size_t OutPos);
+
+extern MixerBatchFunc MixSamplesBatch;
+inline void MixSamples(const al::span<const MixBatchInput> Inputs,
+    const al::span<FloatBufferLine> OutBuffer, const std::size_t Counter,
+    const std::size_t OutPos)
+{ MixSamplesBatch(Inputs, OutBuffer, Counter, OutPos); }
+
 
 /**
  * Calculates ambisonic encoder coefficients using the X, Y, and Z direction
@@ -99,9 +111,10 @@ inline std::array<float,MaxAmbiChannels> CalcAngleCoeffs(const float azimuth,
  * Computes panning gains using the given channel decoder coefficients and the
  * pre-calculated direction or angle coefficients. For B-Format sources, the
  * coeffs are a 'slice' of a transform matrix for the input channel, used to
- * scale and orient the sound samples.
+ * scale and orient the sound samples. The gains span must have room for at
+ * least as many channels as the mix has.
  */
 void ComputePanGains(const MixParams *mix, const al::span<const float,MaxAmbiChannels> coeffs,
-    const float ingain, const al::span<float,MaxAmbiChannels> gains);
+    const float ingain, const al::span<float> gains);
 
 #endif /* CORE_MIXER_H */
@@ -2,6 +2,7 @@
 #define CORE_MIXER_DEFS_H
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <utility>
@@ -69,6 +70,10 @@ using ResamplerFunc = void(*)(const InterpState *state, const al::span<const flo
     const uint increment, const al::span<float> dst);
 
 ResamplerFunc PrepareResampler(Resampler resampler, uint increment, InterpState *state);
+/* Generates the filter tables for the given resampler, if not already done.
+ * PrepareResampler does this as needed too, but the mixer shouldn't have to.
+ */
+void PrepareResamplerTables(Resampler resampler);
 
 
 template<typename TypeTag, typename InstTag>
@@ -83,6 +88,38 @@ template<typename InstTag>
 void Mix_(const al::span<const float> InSamples, const al::span<float> OutBuffer,
     float &CurrentGain, const float TargetGain, const size_t Counter);
 
+/* The maximum number of inputs a batched mix handles in one pass. */
+inline constexpr size_t MaxMixBatchInputs{4};
+
+struct MixBatchInput {
+    al::span<const float> Samples;
+    al::span<float> CurrentGains;
+    al::span<const float> TargetGains;
+};
+
+/* Mixes multiple inputs (each with the same length) to the same output lines,
+ * with the same fade length, accumulating all of them into each output in one
+ * pass.
+ */
+template<typename InstTag>
+void MixBatch_(const al::span<const MixBatchInput> Inputs,
+    const al::span<FloatBufferLine> OutBuffer, const size_t Counter, const size_t OutPos);
+
+/* Decodes IMA4 ADPCM samples for one channel, starting from the given sample
+ * offset.
+ */
+template<typename InstTag>
+void LoadIMA4_(const al::span<float> dstSamples, const al::span<const std::byte> src,
+    const size_t srcChan, const size_t srcOffset, const size_t srcStep,
+    const size_t samplesPerBlock) noexcept;
+
+/* Converts half-precision float samples for one channel to single-precision,
+ * starting from the given sample offset.
+ */
+template<typename InstTag>
+void LoadHalf_(const al::span<float> dstSamples, const al::span<const std::byte> src,
+    const size_t srcChan, const size_t srcOffset, const size_t srcStep) noexcept;
+
 template<typename InstTag>
 void MixHrtf_(const al::span<const float> InSamples, const al::span<float2> AccumSamples,
     const uint IrSize, const MixHrtfFilter *hrtfparams, const size_t SamplesToDo);
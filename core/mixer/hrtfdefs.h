@@ -48,6 +48,12 @@ struct HrtfChannelState {
     BandSplitter mSplitter;
     float mHfScale{};
     alignas(16) HrirArray mCoeffs{};
+    /* Set when the right filter is the negated left filter, for mirrored
+     * data sets.
+     */
+    bool mAntiSymmetric{};
+    /* Left and right frequency-domain filters, for long FIRs. */
+    alignas(16) std::array<std::array<float,HrirLength*2>,2> mFftCoeffs{};
 };
 
 #endif /* CORE_MIXER_HRTFDEFS_H */
@@ -0,0 +1,107 @@
+#ifndef CORE_MIXER_INSTSETS_H
+#define CORE_MIXER_INSTSETS_H
+
+#include "core/cpu_caps.h"
+
+
+struct CTag;
+struct SSETag;
+struct SSE2Tag;
+struct SSE4Tag;
+struct AVX2Tag;
+struct NEONTag;
+
+/* Describes an instruction set's kernel tag, whether its kernels were built,
+ * and the CPU caps needed to run them.
+ */
+template<typename T>
+struct InstSet;
+
+template<>
+struct InstSet<CTag> {
+    using Tag = CTag;
+    static constexpr bool Compiled{true};
+    static constexpr int Caps{0};
+    static constexpr auto Name = "C";
+};
+
+template<>
+struct InstSet<SSETag> {
+    using Tag = SSETag;
+#ifdef HAVE_SSE
+    static constexpr bool Compiled{true};
+#else
+    static constexpr bool Compiled{false};
+#endif
+    static constexpr int Caps{CPU_CAP_SSE};
+    static constexpr auto Name = "SSE";
+};
+
+template<>
+struct InstSet<SSE2Tag> {
+    using Tag = SSE2Tag;
+#ifdef HAVE_SSE2
+    static constexpr bool Compiled{true};
+#else
+    static constexpr bool Compiled{false};
+#endif
+    static constexpr int Caps{CPU_CAP_SSE2};
+    static constexpr auto Name = "SSE2";
+};
+
+template<>
+struct InstSet<SSE4Tag> {
+    using Tag = SSE4Tag;
+#ifdef HAVE_SSE4_1
+    static constexpr bool Compiled{true};
+#else
+    static constexpr bool Compiled{false};
+#endif
+    static constexpr int Caps{CPU_CAP_SSE4_1};
+    static constexpr auto Name = "SSE4.1";
+};
+
+template<>
+struct InstSet<AVX2Tag> {
+    using Tag = AVX2Tag;
+#ifdef HAVE_AVX2
+    static constexpr bool Compiled{true};
+#else
+    static constexpr bool Compiled{false};
+#endif
+    static constexpr int Caps{CPU_CAP_AVX2};
+    static constexpr auto Name = "AVX2";
+};
+
+template<>
+struct InstSet<NEONTag> {
+    using Tag = NEONTag;
+#ifdef HAVE_NEON
+    static constexpr bool Compiled{true};
+#else
+    static constexpr bool Compiled{false};
+#endif
+    static constexpr int Caps{CPU_CAP_NEON};
+    static constexpr auto Name = "NEON";
+};
+
+/* Calls fn(InstSet<T>{}) for each of the given kernel tags that the library
+ * was built with and the CPU supports. Kernels for the other tags don't get
+ * instantiated, so they needn't exist.
+ */
+template<typename ...InstTags, typename F>
+void ForEachInstSet(F&& fn)
+{
+    auto call_fn = [&fn](auto inst)
+    {
+        using InstT = decltype(inst);
+        if constexpr(InstT::Compiled)
+        {
+            if((CPUCapFlags&InstT::Caps) == InstT::Caps)
+                fn(inst);
+        }
+    };
+    (call_fn(InstSet<InstTags>{}), ...);
+}
+
+#endif /* CORE_MIXER_INSTSETS_H */
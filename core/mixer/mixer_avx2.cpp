@@ -0,0 +1,702 @@
+#include "config.h"
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <variant>
+
+#include "alnumeric.h"
+#include "alspan.h"
+#include "core/bsinc_defs.h"
+#include "core/bufferline.h"
+#include "core/cubic_defs.h"
+#include "core/mixer/hrtfdefs.h"
+#include "core/resampler_limits.h"
+#include "defs.h"
+#include "opthelpers.h"
+
+struct AVX2Tag;
+struct LerpTag;
+struct CubicTag;
+struct BSincTag;
+struct FastBSincTag;
+struct BSincPolyTag;
+struct FastBSincPolyTag;
+
+
+/* AVX2 is never part of the baseline target, so everything past here needs to
+ * be built for it explicitly. The HRTF mixer templates are included after this
+ * so their instantiations get the same target as the ApplyCoeffs method they
+ * use. Note that standard algorithms are avoided for anything passing __m256
+ * values, since those would be instantiated for the baseline target.
+ */
+#if defined(__GNUC__) && !defined(__clang__) \
+    && !(defined(__AVX2__) && defined(__FMA__) && defined(__F16C__))
+#pragma GCC target("avx2,fma,f16c")
+#elif defined(__clang__) && !(defined(__AVX2__) && defined(__FMA__) && defined(__F16C__))
+#pragma clang attribute push(__attribute__((target("avx2,fma,f16c"))), apply_to=function)
+#define ALSOFT_AVX2_ATTRIBUTE_PUSHED
+#endif
+
+#include "hrtfbase.h"
+
+using uint = unsigned int;
+
+namespace {
+
+constexpr uint BSincPhaseDiffBits{MixerFracBits - BSincPhaseBits};
+constexpr uint BSincPhaseDiffOne{1 << BSincPhaseDiffBits};
+constexpr uint BSincPhaseDiffMask{BSincPhaseDiffOne - 1u};
+
+constexpr uint CubicPhaseDiffBits{MixerFracBits - CubicPhaseBits};
+constexpr uint CubicPhaseDiffOne{1 << CubicPhaseDiffBits};
+constexpr uint CubicPhaseDiffMask{CubicPhaseDiffOne - 1u};
+
+force_inline __m256 vmadd(const __m256 x, const __m256 y, const __m256 z) noexcept
+{ return _mm256_fmadd_ps(y, z, x); }
+
+force_inline __m128 vmadd(const __m128 x, const __m128 y, const __m128 z) noexcept
+{ return _mm_fmadd_ps(y, z, x); }
+
+/* Combines two 128-bit vectors into one 256-bit vector, with lo in the lower
+ * lane and hi in the upper lane.
+ */
+force_inline __m256 vcombine(const __m128 lo, const __m128 hi) noexcept
+{ return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1); }
+
+/* Horizontally adds the elements of the given vector. */
+force_inline float vhsum(const __m256 r8, const __m128 r4) noexcept
+{
+    __m128 r{_mm_add_ps(_mm_add_ps(_mm256_castps256_ps128(r8), _mm256_extractf128_ps(r8, 1)),
+        r4)};
+    r = _mm_add_ps(r, _mm_shuffle_ps(r, r, _MM_SHUFFLE(0, 1, 2, 3)));
+    r = _mm_add_ps(r, _mm_movehl_ps(r, r));
+    return _mm_cvtss_f32(r);
+}
+
+inline void ApplyCoeffs(const al::span<float2> Values, const size_t IrSize,
+    const ConstHrirSpan Coeffs, const float left, const float right)
+{
+    ASSUME(IrSize >= MinIrLength);
+    ASSUME(IrSize <= HrirLength);
+    /* Round up the IR size to a multiple of 2 for SIMD (2 IRs for 2 channels
+     * is 4 floats), as with SSE. Values alternates between 8- and 16-byte
+     * alignment, so unaligned loads and stores are used throughout.
+     */
+    const auto count4 = size_t{(IrSize+1) >> 1};
+    const auto lrlr8 = _mm256_setr_ps(left, right, left, right, left, right, left, right);
+
+    float *vals{Values[0].data()};
+    const float *coeffs{Coeffs[0].data()};
+    for(size_t i{0};i < (count4>>1);++i)
+    {
+        const __m256 v8{vmadd(_mm256_loadu_ps(vals), lrlr8, _mm256_loadu_ps(coeffs))};
+        _mm256_storeu_ps(vals, v8);
+        vals += 8;
+        coeffs += 8;
+    }
+    if((count4&1))
+    {
+        const __m128 v4{vmadd(_mm_loadu_ps(vals), _mm256_castps256_ps128(lrlr8),
+            _mm_loadu_ps(coeffs))};
+        _mm_storeu_ps(vals, v4);
+    }
+}
+
+force_inline void MixLine(const al::span<const float> InSamples, const al::span<float> dst,
+    float &CurrentGain, const float TargetGain, const float delta, const size_t fade_len,
+    const size_t realign_len, size_t Counter)
+{
+    const auto step = float{(TargetGain-CurrentGain) * delta};
+
+    size_t pos{0};
+    if(std::abs(step) > std::numeric_limits<float>::epsilon())
+    {
+        const auto gain = float{CurrentGain};
+        auto step_count = float{0.0f};
+        /* Mix with applying gain steps in multiples of 8. */
+        if(const size_t todo{fade_len >> 3})
+        {
+            const auto eight8 = _mm256_set1_ps(8.0f);
+            const auto step8 = _mm256_set1_ps(step);
+            const auto gain8 = _mm256_set1_ps(gain);
+            auto step_count8 = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+
+            for(size_t i{0};i < todo;++i)
+            {
+                /* dry += val * (gain + step*step_count) */
+                const __m256 val8{_mm256_loadu_ps(&InSamples[pos])};
+                __m256 dry8{_mm256_loadu_ps(&dst[pos])};
+                dry8 = vmadd(dry8, val8, vmadd(gain8, step8, step_count8));
+                _mm256_storeu_ps(&dst[pos], dry8);
+                step_count8 = _mm256_add_ps(step_count8, eight8);
+                pos += 8;
+            }
+
+            /* NOTE: step_count8 now represents the next eight counts after the
+             * last eight mixed samples, so the lowest element represents the
+             * next step count to apply.
+             */
+            step_count = _mm256_cvtss_f32(step_count8);
+        }
+        /* Mix with applying left over gain steps that aren't multiples of 8. */
+        if(const size_t leftover{fade_len&7})
+        {
+            const auto in = InSamples.subspan(pos, leftover);
+            const auto out = dst.subspan(pos);
+
+            std::transform(in.begin(), in.end(), out.begin(), out.begin(),
+                [gain,step,&step_count](const float val, float dry) noexcept -> float
+                {
+                    dry += val * (gain + step*step_count);
+                    step_count += 1.0f;
+                    return dry;
+                });
+            pos += leftover;
+        }
+        if(pos < Counter)
+        {
+            CurrentGain = gain + step*step_count;
+            return;
+        }
+
+        /* Mix until pos is a multiple of 8 or the mix is done. */
+        if(const size_t leftover{realign_len&7})
+        {
+            const auto in = InSamples.subspan(pos, leftover);
+            const auto out = dst.subspan(pos);
+
+            std::transform(in.begin(), in.end(), out.begin(), out.begin(),
+                [TargetGain](const float val, const float dry) noexcept -> float
+                { return dry + val*TargetGain; });
+            pos += leftover;
+        }
+    }
+    CurrentGain = TargetGain;
+
+    if(!(std::abs(TargetGain) > GainSilenceThreshold))
+        return;
+    if(const size_t todo{(InSamples.size()-pos) >> 3})
+    {
+        const auto gain8 = _mm256_set1_ps(TargetGain);
+        for(size_t i{0};i < todo;++i)
+        {
+            const __m256 val8{_mm256_loadu_ps(&InSamples[pos])};
+            const __m256 dry8{_mm256_loadu_ps(&dst[pos])};
+            _mm256_storeu_ps(&dst[pos], vmadd(dry8, val8, gain8));
+            pos += 8;
+        }
+    }
+    if(const size_t leftover{(InSamples.size()-pos)&7})
+    {
+        const auto in = InSamples.last(leftover);
+        const auto out = dst.subspan(pos);
+
+        std::transform(in.begin(), in.end(), out.begin(), out.begin(),
+            [TargetGain](const float val, const float dry) noexcept -> float
+            { return dry + val*TargetGain; });
+    }
+}
+
+} // namespace
+
+template<>
+void Resample_<LerpTag,AVX2Tag>(const InterpState*, const al::span<const float> src, uint frac,
+    const uint increment, const al::span<float> dst)
+{
+    ASSUME(frac < MixerFracOne);
+
+    const __m256i increment8{_mm256_set1_epi32(static_cast<int>(increment*8))};
+    const __m256 fracOne8{_mm256_set1_ps(1.0f/MixerFracOne)};
+    const __m256i fracMask8{_mm256_set1_epi32(MixerFracMask)};
+    const __m256i one8{_mm256_set1_epi32(1)};
+
+    alignas(32) std::array<uint,8> pos_{}, frac_{};
+    InitPosArrays(MaxResamplerEdge, frac, increment, al::span{frac_}, al::span{pos_});
+    __m256i frac8{_mm256_load_si256(reinterpret_cast<const __m256i*>(frac_.data()))};
+    __m256i pos8{_mm256_load_si256(reinterpret_cast<const __m256i*>(pos_.data()))};
+
+    const float *srcdata{src.data()};
+    const size_t todo{dst.size() >> 3};
+    for(size_t i{0};i < todo;++i)
+    {
+        const __m256 val1{_mm256_i32gather_ps(srcdata, pos8, 4)};
+        const __m256 val2{_mm256_i32gather_ps(srcdata, _mm256_add_epi32(pos8, one8), 4)};
+
+        /* val1 + (val2-val1)*mu */
+        const __m256 r0{_mm256_sub_ps(val2, val1)};
+        const __m256 mu{_mm256_mul_ps(_mm256_cvtepi32_ps(frac8), fracOne8)};
+        _mm256_storeu_ps(&dst[i*8], vmadd(val1, mu, r0));
+
+        frac8 = _mm256_add_epi32(frac8, increment8);
+        pos8 = _mm256_add_epi32(pos8, _mm256_srli_epi32(frac8, MixerFracBits));
+        frac8 = _mm256_and_si256(frac8, fracMask8);
+    }
+
+    if(const size_t leftover{dst.size()&7})
+    {
+        /* NOTE: These eight elements represent the position *after* the last
+         * eight samples, so the lowest element is the next position to
+         * resample.
+         */
+        auto pos = size_t{static_cast<uint>(_mm256_cvtsi256_si32(pos8))};
+        frac = static_cast<uint>(_mm256_cvtsi256_si32(frac8));
+
+        auto out = dst.last(leftover);
+        std::generate(out.begin(), out.end(), [&pos,&frac,src,increment]
+        {
+            const float smp{lerpf(src[pos+0], src[pos+1],
+                static_cast<float>(frac) * (1.0f/MixerFracOne))};
+
+            frac += increment;
+            pos  += frac>>MixerFracBits;
+            frac &= MixerFracMask;
+            return smp;
+        });
+    }
+}
+
+template<>
+void Resample_<CubicTag,AVX2Tag>(const InterpState *state, const al::span<const float> src,
+    uint frac, const uint increment, const al::span<float> dst)
+{
+    ASSUME(frac < MixerFracOne);
+
+    const auto filter = std::get<CubicState>(*state).filter;
+
+    const __m256i increment8{_mm256_set1_epi32(static_cast<int>(increment*8))};
+    const __m256i fracMask8{_mm256_set1_epi32(MixerFracMask)};
+    const __m256 fracDiffOne8{_mm256_set1_ps(1.0f/CubicPhaseDiffOne)};
+    const __m256i fracDiffMask8{_mm256_set1_epi32(CubicPhaseDiffMask)};
+
+    alignas(32) std::array<uint,8> pos_{}, frac_{};
+    InitPosArrays(MaxResamplerEdge-1, frac, increment, al::span{frac_}, al::span{pos_});
+    __m256i frac8{_mm256_load_si256(reinterpret_cast<const __m256i*>(frac_.data()))};
+    __m256i pos8{_mm256_load_si256(reinterpret_cast<const __m256i*>(pos_.data()))};
+
+    /* Each output sample is the dot product of 4 source samples with its
+     * phase interpolated filter. Pairs of outputs (n and n+4) go into the
+     * lower and upper lanes of a 256-bit vector, which are then transposed
+     * in-lane so the products sum vertically.
+     */
+    const auto mul4 = [src,filter](const uint pos0, const uint pos1, const uint pi0,
+        const uint pi1, const __m256 pf) noexcept -> __m256
+    {
+        const __m256 vals{vcombine(_mm_loadu_ps(&src[pos0]), _mm_loadu_ps(&src[pos1]))};
+        const __m256 coeffs{vcombine(_mm_load_ps(filter[pi0].mCoeffs.data()),
+            _mm_load_ps(filter[pi1].mCoeffs.data()))};
+        const __m256 deltas{vcombine(_mm_load_ps(filter[pi0].mDeltas.data()),
+            _mm_load_ps(filter[pi1].mDeltas.data()))};
+        return _mm256_mul_ps(vals, vmadd(coeffs, pf, deltas));
+    };
+
+    const size_t todo{dst.size() >> 3};
+    for(size_t i{0};i < todo;++i)
+    {
+        alignas(32) std::array<uint,8> pos{}, pi{};
+        _mm256_store_si256(reinterpret_cast<__m256i*>(pos.data()), pos8);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(pi.data()),
+            _mm256_srli_epi32(frac8, CubicPhaseDiffBits));
+        ASSUME(pos[0] <= pos[1]); ASSUME(pos[1] <= pos[2]); ASSUME(pos[2] <= pos[3]);
+        ASSUME(pos[3] <= pos[4]); ASSUME(pos[4] <= pos[5]); ASSUME(pos[5] <= pos[6]);
+        ASSUME(pos[6] <= pos[7]);
+
+        const __m256 pf8{_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(frac8,
+            fracDiffMask8)), fracDiffOne8)};
+
+        const __m256 r0{mul4(pos[0], pos[4], pi[0], pi[4],
+            _mm256_permutevar8x32_ps(pf8, _mm256_setr_epi32(0, 0, 0, 0, 4, 4, 4, 4)))};
+        const __m256 r1{mul4(pos[1], pos[5], pi[1], pi[5],
+            _mm256_permutevar8x32_ps(pf8, _mm256_setr_epi32(1, 1, 1, 1, 5, 5, 5, 5)))};
+        const __m256 r2{mul4(pos[2], pos[6], pi[2], pi[6],
+            _mm256_permutevar8x32_ps(pf8, _mm256_setr_epi32(2, 2, 2, 2, 6, 6, 6, 6)))};
+        const __m256 r3{mul4(pos[3], pos[7], pi[3], pi[7],
+            _mm256_permutevar8x32_ps(pf8, _mm256_setr_epi32(3, 3, 3, 3, 7, 7, 7, 7)))};
+
+        const __m256 t0{_mm256_unpacklo_ps(r0, r1)};
+        const __m256 t1{_mm256_unpackhi_ps(r0, r1)};
+        const __m256 t2{_mm256_unpacklo_ps(r2, r3)};
+        const __m256 t3{_mm256_unpackhi_ps(r2, r3)};
+        const __m256 s0{_mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0))};
+        const __m256 s1{_mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2))};
+        const __m256 s2{_mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0))};
+        const __m256 s3{_mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2))};
+        _mm256_storeu_ps(&dst[i*8], _mm256_add_ps(_mm256_add_ps(s0, s1),
+            _mm256_add_ps(s2, s3)));
+
+        frac8 = _mm256_add_epi32(frac8, increment8);
+        pos8 = _mm256_add_epi32(pos8, _mm256_srli_epi32(frac8, MixerFracBits));
+        frac8 = _mm256_and_si256(frac8, fracMask8);
+    }
+
+    if(const size_t leftover{dst.size()&7})
+    {
+        auto pos = size_t{static_cast<uint>(_mm256_cvtsi256_si32(pos8))};
+        frac = static_cast<uint>(_mm256_cvtsi256_si32(frac8));
+
+        auto out = dst.last(leftover);
+        std::generate(out.begin(), out.end(), [&pos,&frac,src,increment,filter]
+        {
+            const uint pi{frac >> CubicPhaseDiffBits}; ASSUME(pi < CubicPhaseCount);
+            const float pf{static_cast<float>(frac&CubicPhaseDiffMask) * (1.0f/CubicPhaseDiffOne)};
+            const __m128 pf4{_mm_set1_ps(pf)};
+
+            const __m128 f4 = vmadd(_mm_load_ps(filter[pi].mCoeffs.data()), pf4,
+                _mm_load_ps(filter[pi].mDeltas.data()));
+            __m128 r4{_mm_mul_ps(f4, _mm_loadu_ps(&src[pos]))};
+
+            r4 = _mm_add_ps(r4, _mm_shuffle_ps(r4, r4, _MM_SHUFFLE(0, 1, 2, 3)));
+            r4 = _mm_add_ps(r4, _mm_movehl_ps(r4, r4));
+            const float output{_mm_cvtss_f32(r4)};
+
+            frac += increment;
+            pos  += frac>>MixerFracBits;
+            frac &= MixerFracMask;
+            return output;
+        });
+    }
+}
+
+template<>
+void Resample_<BSincTag,AVX2Tag>(const InterpState *state, const al::span<const float> src,
+    uint frac, const uint increment, const al::span<float> dst)
+{
+    const auto &bsinc = std::get<BsincState>(*state);
+    const auto sf8 = _mm256_set1_ps(bsinc.sf);
+    const auto m = size_t{bsinc.m};
+    ASSUME(m > 0);
+    ASSUME(m <= MaxResamplerPadding);
+    ASSUME(frac < MixerFracOne);
+
+    const auto filter = bsinc.filter.first(4_uz*BSincPhaseCount*m);
+
+    ASSUME(bsinc.l <= MaxResamplerEdge);
+    auto pos = size_t{MaxResamplerEdge-bsinc.l};
+    for(float &output : dst)
+    {
+        // Calculate the phase index and factor.
+        const size_t pi{frac >> BSincPhaseDiffBits}; ASSUME(pi < BSincPhaseCount);
+        const float pf{static_cast<float>(frac&BSincPhaseDiffMask) * (1.0f/BSincPhaseDiffOne)};
+
+        // Apply the scale and phase interpolated filter.
+        auto r8 = _mm256_setzero_ps();
+        auto r4 = _mm_setzero_ps();
+        {
+            const auto pf8 = _mm256_set1_ps(pf);
+            const auto fil = filter.subspan(2_uz*pi*m);
+            const auto phd = fil.subspan(m);
+            const auto scd = fil.subspan(2_uz*BSincPhaseCount*m);
+            const auto spd = scd.subspan(m);
+            auto j = size_t{0};
+
+            for(;j+8 <= m;j += 8)
+            {
+                /* f = ((fil + sf*scd) + pf*(phd + sf*spd)) */
+                const __m256 f8 = vmadd(
+                    vmadd(_mm256_loadu_ps(&fil[j]), sf8, _mm256_loadu_ps(&scd[j])),
+                    pf8, vmadd(_mm256_loadu_ps(&phd[j]), sf8, _mm256_loadu_ps(&spd[j])));
+                /* r += f*src */
+                r8 = vmadd(r8, f8, _mm256_loadu_ps(&src[pos+j]));
+            }
+            /* The filter length is always a multiple of 4, so there may be
+             * one set of 4 left over.
+             */
+            if(j < m)
+            {
+                const auto sf4 = _mm256_castps256_ps128(sf8);
+                const __m128 f4 = vmadd(
+                    vmadd(_mm_load_ps(&fil[j]), sf4, _mm_load_ps(&scd[j])),
+                    _mm256_castps256_ps128(pf8),
+                    vmadd(_mm_load_ps(&phd[j]), sf4, _mm_load_ps(&spd[j])));
+                r4 = _mm_mul_ps(f4, _mm_loadu_ps(&src[pos+j]));
+            }
+        }
+        output = vhsum(r8, r4);
+
+        frac += increment;
+        pos  += frac>>MixerFracBits;
+        frac &= MixerFracMask;
+    }
+}
+
+template<>
+void Resample_<FastBSincTag,AVX2Tag>(const InterpState *state, const al::span<const float> src,
+    uint frac, const uint increment, const al::span<float> dst)
+{
+    const auto &bsinc = std::get<BsincState>(*state);
+    const auto m = size_t{bsinc.m};
+    ASSUME(m > 0);
+    ASSUME(m <= MaxResamplerPadding);
+    ASSUME(frac < MixerFracOne);
+
+    const auto filter = bsinc.filter.first(2_uz*m*BSincPhaseCount);
+
+    ASSUME(bsinc.l <= MaxResamplerEdge);
+    size_t pos{MaxResamplerEdge-bsinc.l};
+    for(float &output : dst)
+    {
+        // Calculate the phase index and factor.
+        const size_t pi{frac >> BSincPhaseDiffBits}; ASSUME(pi < BSincPhaseCount);
+        const float pf{static_cast<float>(frac&BSincPhaseDiffMask) * (1.0f/BSincPhaseDiffOne)};
+
+        // Apply the phase interpolated filter.
+        auto r8 = _mm256_setzero_ps();
+        auto r4 = _mm_setzero_ps();
+        {
+            const auto pf8 = _mm256_set1_ps(pf);
+            const auto fil = filter.subspan(2_uz*m*pi);
+            const auto phd = fil.subspan(m);
+            auto j = size_t{0};
+
+            for(;j+8 <= m;j += 8)
+            {
+                /* f = fil + pf*phd */
+                const auto f8 = vmadd(_mm256_loadu_ps(&fil[j]), pf8, _mm256_loadu_ps(&phd[j]));
+                /* r += f*src */
+                r8 = vmadd(r8, f8, _mm256_loadu_ps(&src[pos+j]));
+            }
+            if(j < m)
+            {
+                const auto f4 = vmadd(_mm_load_ps(&fil[j]), _mm256_castps256_ps128(pf8),
+                    _mm_load_ps(&phd[j]));
+                r4 = _mm_mul_ps(f4, _mm_loadu_ps(&src[pos+j]));
+            }
+        }
+        output = vhsum(r8, r4);
+
+        frac += increment;
+        pos  += frac>>MixerFracBits;
+        frac &= MixerFracMask;
+    }
+}
+
+
+namespace {
+
+/* Resamples with an increment that's a multiple of 0.5, using the filters
+ * calculated for the two alternating phases.
+ */
+void DoPolyResample(const al::span<const float> src, const size_t m,
+    const al::span<const std::array<float,MaxResamplerPadding>,2> filters, const uint frac,
+    const uint increment, const al::span<float> dst)
+{
+    const uint frac1{(frac+increment) & MixerFracMask};
+    const size_t step0{(frac+increment) >> MixerFracBits};
+    const size_t step1{(frac1+increment) >> MixerFracBits};
+
+    auto dot_product = [src,m](const al::span<const float> fil, const size_t pos) noexcept
+    {
+        auto r8 = _mm256_setzero_ps();
+        auto r4 = _mm_setzero_ps();
+        auto j = size_t{0};
+
+        for(;j+8 <= m;j += 8)
+        {
+            /* r += f*src */
+            r8 = vmadd(r8, _mm256_load_ps(&fil[j]), _mm256_loadu_ps(&src[pos+j]));
+        }
+        if(j < m)
+            r4 = _mm_mul_ps(_mm_load_ps(&fil[j]), _mm_loadu_ps(&src[pos+j]));
+        return vhsum(r8, r4);
+    };
+
+    auto pos = size_t{0};
+    auto dstiter = dst.begin();
+    for(size_t todo{dst.size()>>1};todo;--todo)
+    {
+        *(dstiter++) = dot_product(filters[0], pos);
+        *(dstiter++) = dot_product(filters[1], pos+step0);
+        pos += step0 + step1;
+    }
+    if(dstiter != dst.end())
+        *dstiter = dot_product(filters[0], pos);
+}
+
+} // namespace
+
+template<>
+void Resample_<BSincPolyTag,AVX2Tag>(const InterpState *state, const al::span<const float> src,
+    uint frac, const uint increment, const al::span<float> dst)
+{
+    const auto &bsinc = std::get<BsincState>(*state);
+    const auto sf4 = _mm_set1_ps(bsinc.sf);
+    const auto m = size_t{bsinc.m};
+    ASSUME(m > 0);
+    ASSUME(m <= MaxResamplerPadding);
+    ASSUME(frac < MixerFracOne);
+
+    const auto filter = bsinc.filter.first(4_uz*BSincPhaseCount*m);
+
+    alignas(32) std::array<std::array<float,MaxResamplerPadding>,2> filters;
+    auto make_filter = [sf4,m,filter](const uint phase, const al::span<float> coeffs)
+    {
+        const size_t pi{phase >> BSincPhaseDiffBits}; ASSUME(pi < BSincPhaseCount);
+        const float pf{static_cast<float>(phase&BSincPhaseDiffMask) * (1.0f/BSincPhaseDiffOne)};
+
+        const auto pf4 = _mm_set1_ps(pf);
+        const auto fil = filter.subspan(2_uz*pi*m);
+        const auto phd = fil.subspan(m);
+        const auto scd = fil.subspan(2_uz*BSincPhaseCount*m);
+        const auto spd = scd.subspan(m);
+        for(size_t j{0};j < m;j += 4)
+        {
+            /* f = ((fil + sf*scd) + pf*(phd + sf*spd)) */
+            const __m128 f4 = vmadd(
+                vmadd(_mm_load_ps(&fil[j]), sf4, _mm_load_ps(&scd[j])),
+                pf4, vmadd(_mm_load_ps(&phd[j]), sf4, _mm_load_ps(&spd[j])));
+            _mm_store_ps(&coeffs[j], f4);
+        }
+    };
+    make_filter(frac, filters[0]);
+    make_filter((frac+increment) & MixerFracMask, filters[1]);
+
+    ASSUME(bsinc.l <= MaxResamplerEdge);
+    DoPolyResample(src.subspan(MaxResamplerEdge-bsinc.l), m, filters, frac, increment, dst);
+}
+
+template<>
+void Resample_<FastBSincPolyTag,AVX2Tag>(const InterpState *state, const al::span<const float> src,
+    uint frac, const uint increment, const al::span<float> dst)
+{
+    const auto &bsinc = std::get<BsincState>(*state);
+    const auto m = size_t{bsinc.m};
+    ASSUME(m > 0);
+    ASSUME(m <= MaxResamplerPadding);
+    ASSUME(frac < MixerFracOne);
+
+    const auto filter = bsinc.filter.first(2_uz*m*BSincPhaseCount);
+
+    alignas(32) std::array<std::array<float,MaxResamplerPadding>,2> filters;
+    auto make_filter = [m,filter](const uint phase, const al::span<float> coeffs)
+    {
+        const size_t pi{phase >> BSincPhaseDiffBits}; ASSUME(pi < BSincPhaseCount);
+        const float pf{static_cast<float>(phase&BSincPhaseDiffMask) * (1.0f/BSincPhaseDiffOne)};
+
+        const auto pf4 = _mm_set1_ps(pf);
+        const auto fil = filter.subspan(2_uz*m*pi);
+        const auto phd = fil.subspan(m);
+        for(size_t j{0};j < m;j += 4)
+        {
+            /* f = fil + pf*phd */
+            _mm_store_ps(&coeffs[j], vmadd(_mm_load_ps(&fil[j]), pf4, _mm_load_ps(&phd[j])));
+        }
+    };
+    make_filter(frac, filters[0]);
+    make_filter((frac+increment) & MixerFracMask, filters[1]);
+
+    ASSUME(bsinc.l <= MaxResamplerEdge);
+    DoPolyResample(src.subspan(MaxResamplerEdge-bsinc.l), m, filters, frac, increment, dst);
+}
+
+
+template<>
+void MixHrtf_<AVX2Tag>(const al::span<const float> InSamples, const al::span<float2> AccumSamples,
+    const uint IrSize, const MixHrtfFilter *hrtfparams, const size_t SamplesToDo)
+{ MixHrtfBase<ApplyCoeffs>(InSamples, AccumSamples, IrSize, hrtfparams, SamplesToDo); }
+
+template<>
+void MixHrtfBlend_<AVX2Tag>(const al::span<const float> InSamples,
+    const al::span<float2> AccumSamples, const uint IrSize, const HrtfFilter *oldparams,
+    const MixHrtfFilter *newparams, const size_t SamplesToDo)
+{
+    MixHrtfBlendBase<ApplyCoeffs>(InSamples, AccumSamples, IrSize, oldparams, newparams,
+        SamplesToDo);
+}
+
+template<>
+void MixDirectHrtf_<AVX2Tag>(const FloatBufferSpan LeftOut, const FloatBufferSpan RightOut,
+    const al::span<const FloatBufferLine> InSamples, const al::span<float2> AccumSamples,
+    const al::span<float,BufferLineSize> TempBuf, const al::span<HrtfChannelState> ChanState,
+    const size_t IrSize, const size_t SamplesToDo)
+{
+    MixDirectHrtfBase<ApplyCoeffs>(LeftOut, RightOut, InSamples, AccumSamples, TempBuf, ChanState,
+        IrSize, SamplesToDo);
+}
+
+
+template<>
+void Mix_<AVX2Tag>(const al::span<const float> InSamples, const al::span<FloatBufferLine> OutBuffer,
+    const al::span<float> CurrentGains, const al::span<const float> TargetGains,
+    const size_t Counter, const size_t OutPos)
+{
+    const float delta{(Counter > 0) ? 1.0f / static_cast<float>(Counter) : 0.0f};
+    const auto fade_len = std::min(Counter, InSamples.size());
+    const auto realign_len = std::min((fade_len+7_uz) & ~7_uz, InSamples.size()) - fade_len;
+
+    auto curgains = CurrentGains.begin();
+    auto targetgains = TargetGains.cbegin();
+    for(FloatBufferLine &output : OutBuffer)
+        MixLine(InSamples, al::span{output}.subspan(OutPos), *curgains++, *targetgains++, delta,
+            fade_len, realign_len, Counter);
+}
+
+template<>
+void Mix_<AVX2Tag>(const al::span<const float> InSamples, const al::span<float> OutBuffer,
+    float &CurrentGain, const float TargetGain, const size_t Counter)
+{
+    const float delta{(Counter > 0) ? 1.0f / static_cast<float>(Counter) : 0.0f};
+    const auto fade_len = std::min(Counter, InSamples.size());
+    const auto realign_len = std::min((fade_len+7_uz) & ~7_uz, InSamples.size()) - fade_len;
+
+    MixLine(InSamples, OutBuffer, CurrentGain, TargetGain, delta, fade_len, realign_len, Counter);
+}
+
+template<>
+void LoadHalf_<AVX2Tag>(const al::span<float> dstSamples, const al::span<const std::byte> src,
+    const size_t srcChan, const size_t srcOffset, const size_t srcStep) noexcept
+{
+    const al::span<const uint16_t> halfs{reinterpret_cast<const uint16_t*>(src.data()),
+        src.size()/sizeof(uint16_t)};
+    size_t pos{srcOffset*srcStep + srcChan};
+
+    /* Convert eight samples at a time with F16C, gathering them first for
+     * interleaved channels.
+     */
+    const size_t todo{dstSamples.size() & ~7_uz};
+    size_t i{0};
+    if(srcStep == 1)
+    {
+        for(;i < todo;i += 8)
+        {
+            const __m128i vals{_mm_loadu_si128(reinterpret_cast<const __m128i*>(&halfs[pos]))};
+            _mm256_storeu_ps(&dstSamples[i], _mm256_cvtph_ps(vals));
+            pos += 8;
+        }
+    }
+    else
+    {
+        for(;i < todo;i += 8)
+        {
+            const auto get_half = [halfs,pos,srcStep](const size_t idx) noexcept -> short
+            { return static_cast<short>(halfs[pos + idx*srcStep]); };
+            const __m128i vals{_mm_setr_epi16(get_half(0), get_half(1), get_half(2),
+                get_half(3), get_half(4), get_half(5), get_half(6), get_half(7))};
+            _mm256_storeu_ps(&dstSamples[i], _mm256_cvtph_ps(vals));
+            pos += srcStep*8;
+        }
+    }
+    if(const size_t rem{dstSamples.size() - i})
+    {
+        alignas(16) std::array<uint16_t,8> vals{};
+        for(size_t j{0};j < rem;++j)
+        {
+            vals[j] = halfs[pos];
+            pos += srcStep;
+        }
+        alignas(32) std::array<float,8> out{};
+        _mm256_store_ps(out.data(),
+            _mm256_cvtph_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(vals.data()))));
+        for(size_t j{0};j < rem;++j)
+            dstSamples[i+j] = out[j];
+    }
+}
+
+#ifdef ALSOFT_AVX2_ATTRIBUTE_PUSHED
+#pragma clang attribute pop
+#undef ALSOFT_AVX2_ATTRIBUTE_PUSHED
+#endif
@@ -2,15 +2,18 @@
 
 #include <algorithm>
 #include <array>
+#include <cassert>
 #include <cstddef>
 #include <limits>
 #include <variant>
 
 #include "alnumeric.h"
 #include "alspan.h"
+#include "core/adpcm_defs.h"
 #include "core/bsinc_defs.h"
 #include "core/bufferline.h"
 #include "core/cubic_defs.h"
+#include "core/fmt_traits.h"
 #include "core/mixer/hrtfdefs.h"
 #include "core/resampler_limits.h"
 #include "defs.h"
@@ -23,6 +26,8 @@ struct LerpTag;
 struct CubicTag;
 struct BSincTag;
 struct FastBSincTag;
+struct BSincPolyTag;
+struct FastBSincPolyTag;
 
 
 namespace {
@@ -106,6 +111,45 @@ auto do_bsinc(const BsincState &bsinc, const al::span<const float> vals, const s
     return r;
 }
 
+/* Calculates the phase interpolated filter for the given phase, as used by
+ * do_fastbsinc.
+ */
+void make_fastbsinc_filter(const BsincState &bsinc, const uint frac, const al::span<float> dst)
+    noexcept
+{
+    const size_t m{bsinc.m};
+    ASSUME(m > 0);
+    ASSUME(m <= MaxResamplerPadding);
+
+    const uint pi{frac >> BsincPhaseDiffBits}; ASSUME(pi < BSincPhaseCount);
+    const float pf{static_cast<float>(frac&BsincPhaseDiffMask) * (1.0f/BsincPhaseDiffOne)};
+
+    const auto fil = bsinc.filter.subspan(2_uz*pi*m);
+    const auto phd = fil.subspan(m);
+    for(size_t j_f{0};j_f < m;++j_f)
+        dst[j_f] = fil[j_f] + pf*phd[j_f];
+}
+/* Calculates the scale and phase interpolated filter for the given phase, as
+ * used by do_bsinc.
+ */
+void make_bsinc_filter(const BsincState &bsinc, const uint frac, const al::span<float> dst)
+    noexcept
+{
+    const size_t m{bsinc.m};
+    ASSUME(m > 0);
+    ASSUME(m <= MaxResamplerPadding);
+
+    const uint pi{frac >> BsincPhaseDiffBits}; ASSUME(pi < BSincPhaseCount);
+    const float pf{static_cast<float>(frac&BsincPhaseDiffMask) * (1.0f/BsincPhaseDiffOne)};
+
+    const auto fil = bsinc.filter.subspan(2_uz*pi*m);
+    const auto phd = fil.subspan(m);
+    const auto scd = fil.subspan(BSincPhaseCount*2_uz*m);
+    const auto spd = scd.subspan(m);
+    for(size_t j_f{0};j_f < m;++j_f)
+        dst[j_f] = fil[j_f] + bsinc.sf*scd[j_f] + pf*(phd[j_f] + bsinc.sf*spd[j_f]);
+}
+
 template<SamplerNST Sampler>
 void DoResample(const al::span<const float> src, uint frac, const uint increment,
     const al::span<float> dst)
@@ -138,6 +182,53 @@ void DoResample(const U istate, const al::span<const float> src, uint frac, cons
     });
 }
 
+using FilterMakerT = void(const BsincState&, const uint, const al::span<float>) noexcept;
+
+/* Resamples with an increment that's a multiple of 0.5, where the filter
+ * phase alternates between two values (or stays the same, for whole
+ * increments). The filter for each phase only needs to be calculated once,
+ * leaving a plain dot product for each output sample.
+ */
+template<FilterMakerT MakeFilter>
+void DoPolyResample(const BsincState &bsinc, const al::span<const float> src, const uint frac,
+    const uint increment, const al::span<float> dst)
+{
+    const size_t m{bsinc.m};
+    ASSUME(m > 0);
+    ASSUME(m <= MaxResamplerPadding);
+    ASSUME(frac < MixerFracOne);
+
+    /* The second phase, and the source offsets for stepping from the first
+     * phase to the second, and from the second back to the first.
+     */
+    const uint frac1{(frac+increment) & MixerFracMask};
+    const size_t step0{(frac+increment) >> MixerFracBits};
+    const size_t step1{(frac1+increment) >> MixerFracBits};
+
+    std::array<std::array<float,MaxResamplerPadding>,2> filters;
+    MakeFilter(bsinc, frac, filters[0]);
+    MakeFilter(bsinc, frac1, filters[1]);
+
+    auto dot_product = [src,m](const al::span<const float> fil, const size_t pos) noexcept
+    {
+        float r{0.0f};
+        for(size_t j_f{0};j_f < m;++j_f)
+            r += fil[j_f] * src[pos+j_f];
+        return r;
+    };
+
+    size_t pos{0};
+    auto dstiter = dst.begin();
+    for(size_t todo{dst.size()>>1};todo;--todo)
+    {
+        *(dstiter++) = dot_product(filters[0], pos);
+        *(dstiter++) = dot_product(filters[1], pos+step0);
+        pos += step0 + step1;
+    }
+    if(dstiter != dst.end())
+        *dstiter = dot_product(filters[0], pos);
+}
+
 inline void ApplyCoeffs(const al::span<float2> Values, const size_t IrSize,
     const ConstHrirSpan Coeffs, const float left, const float right) noexcept
 {
@@ -228,6 +319,26 @@ void Resample_<BSincTag,CTag>(const InterpState *state, const al::span<const flo
         increment, dst);
 }
 
+template<>
+void Resample_<FastBSincPolyTag,CTag>(const InterpState *state, const al::span<const float> src,
+    uint frac, const uint increment, const al::span<float> dst)
+{
+    const auto &istate = std::get<BsincState>(*state);
+    ASSUME(istate.l <= MaxResamplerEdge);
+    DoPolyResample<make_fastbsinc_filter>(istate, src.subspan(MaxResamplerEdge-istate.l), frac,
+        increment, dst);
+}
+
+template<>
+void Resample_<BSincPolyTag,CTag>(const InterpState *state, const al::span<const float> src,
+    uint frac, const uint increment, const al::span<float> dst)
+{
+    const auto &istate = std::get<BsincState>(*state);
+    ASSUME(istate.l <= MaxResamplerEdge);
+    DoPolyResample<make_bsinc_filter>(istate, src.subspan(MaxResamplerEdge-istate.l), frac,
+        increment, dst);
+}
+
 
 template<>
 void MixHrtf_<CTag>(const al::span<const float> InSamples, const al::span<float2> AccumSamples,
@@ -278,3 +389,196 @@ void Mix_<CTag>(const al::span<const float> InSamples, const al::span<float> Out
 
     MixLine(InSamples, OutBuffer, CurrentGain, TargetGain, delta, fade_len, Counter);
 }
+
+template<>
+void MixBatch_<CTag>(const al::span<const MixBatchInput> Inputs,
+    const al::span<FloatBufferLine> OutBuffer, const size_t Counter, const size_t OutPos)
+{
+    ASSUME(!Inputs.empty());
+    ASSUME(Inputs.size() <= MaxMixBatchInputs);
+
+    const float delta{(Counter > 0) ? 1.0f / static_cast<float>(Counter) : 0.0f};
+    const size_t todo{Inputs[0].Samples.size()};
+    const auto fade_len = std::min(Counter, todo);
+
+    std::array<al::span<const float>,MaxMixBatchInputs> fadesrcs{}, srcs{};
+    std::array<float,MaxMixBatchInputs> gains{}, steps{}, targets{};
+    for(size_t c{0};c < OutBuffer.size();++c)
+    {
+        /* Get the starting gain and step of each input, and its gain after
+         * the fade. Inputs that aren't fading start at their target, which is
+         * dropped if silent. Only the inputs that contribute to this output
+         * are kept, so sparse gains (e.g. upsampled B-Format, which doesn't
+         * reach every order) don't mix silence.
+         */
+        bool fading{false};
+        size_t numfade{0}, numsrcs{0};
+        for(size_t i{0};i < Inputs.size();++i)
+        {
+            float &CurrentGain = Inputs[i].CurrentGains[c];
+            const float TargetGain{Inputs[i].TargetGains[c]};
+            const float step{(TargetGain-CurrentGain) * delta};
+            const float target{(std::abs(TargetGain) > GainSilenceThreshold) ? TargetGain : 0.0f};
+            if(std::abs(step) > std::numeric_limits<float>::epsilon())
+            {
+                fadesrcs[numfade] = Inputs[i].Samples;
+                gains[numfade] = CurrentGain;
+                steps[numfade] = step;
+                ++numfade;
+                CurrentGain = (fade_len < Counter)
+                    ? CurrentGain + step*static_cast<float>(fade_len) : TargetGain;
+                fading = true;
+            }
+            else
+            {
+                if(target != 0.0f)
+                {
+                    fadesrcs[numfade] = Inputs[i].Samples;
+                    gains[numfade] = target;
+                    steps[numfade] = 0.0f;
+                    ++numfade;
+                }
+                CurrentGain = TargetGain;
+            }
+            if(target != 0.0f)
+            {
+                srcs[numsrcs] = Inputs[i].Samples;
+                targets[numsrcs] = target;
+                ++numsrcs;
+            }
+        }
+
+        const auto output = al::span{OutBuffer[c]}.subspan(OutPos, todo);
+        size_t pos{0};
+        if(fading)
+        {
+            for(;pos < fade_len;++pos)
+            {
+                const auto step_count = static_cast<float>(pos);
+                float sample{0.0f};
+                for(size_t i{0};i < numfade;++i)
+                    sample += fadesrcs[i][pos] * (gains[i] + steps[i]*step_count);
+                output[pos] += sample;
+            }
+        }
+        if(numsrcs == 0)
+            continue;
+        for(;pos < todo;++pos)
+        {
+            float sample{0.0f};
+            for(size_t i{0};i < numsrcs;++i)
+                sample += srcs[i][pos] * targets[i];
+            output[pos] += sample;
+        }
+    }
+}
+
+template<>
+void LoadIMA4_<CTag>(al::span<float> dstSamples, al::span<const std::byte> src,
+    const size_t srcChan, const size_t srcOffset, const size_t srcStep,
+    const size_t samplesPerBlock) noexcept
+{
+    static constexpr int MaxStepIndex{static_cast<int>(IMAStep_size.size()) - 1};
+
+    assert(srcStep > 0 || srcStep <= 2);
+    assert(srcChan < srcStep);
+    assert(samplesPerBlock > 1);
+    const size_t blockBytes{((samplesPerBlock-1)/2 + 4)*srcStep};
+
+    /* Skip to the ADPCM block containing the srcOffset sample. */
+    src = src.subspan(srcOffset/samplesPerBlock*blockBytes);
+    /* Calculate how many samples need to be skipped in the block. */
+    size_t skip{srcOffset % samplesPerBlock};
+
+    /* NOTE: This could probably be optimized better. */
+    while(!dstSamples.empty())
+    {
+        auto nibbleData = src.cbegin();
+        src = src.subspan(blockBytes);
+
+        /* Each IMA4 block starts with a signed 16-bit sample, and a signed
+         * 16-bit table index. The table index needs to be clamped.
+         */
+        int sample{int(nibbleData[srcChan*4]) | (int(nibbleData[srcChan*4 + 1]) << 8)};
+        int index{int(nibbleData[srcChan*4 + 2]) | (int(nibbleData[srcChan*4 + 3]) << 8)};
+        nibbleData += ptrdiff_t((srcStep+srcChan)*4);
+
+        sample = (sample^0x8000) - 32768;
+        index = std::clamp((index^0x8000) - 32768, 0, MaxStepIndex);
+
+        if(skip == 0)
+        {
+            dstSamples[0] = static_cast<float>(sample) / 32768.0f;
+            dstSamples = dstSamples.subspan<1>();
+            if(dstSamples.empty()) return;
+        }
+        else
+            --skip;
+
+        auto decode_sample = [&sample,&index](const uint nibble)
+        {
+            sample += IMA4Codeword[nibble] * IMAStep_size[static_cast<uint>(index)] / 8;
+            sample = std::clamp(sample, -32768, 32767);
+
+            index += IMA4Index_adjust[nibble];
+            index = std::clamp(index, 0, MaxStepIndex);
+
+            return sample;
+        };
+
+        /* The rest of the block is arranged as a series of nibbles, contained
+         * in 4 *bytes* per channel interleaved. So every 8 nibbles we need to
+         * skip 4 bytes per channel to get the next nibbles for this channel.
+         *
+         * First, decode the samples that we need to skip in the block (will
+         * always be less than the block size). They need to be decoded despite
+         * being ignored for proper state on the remaining samples.
+         */
+        size_t nibbleOffset{0};
+        const size_t startOffset{skip + 1};
+        for(;skip;--skip)
+        {
+            const size_t byteShift{(nibbleOffset&1) * 4};
+            const size_t wordOffset{(nibbleOffset>>1) & ~3_uz};
+            const size_t byteOffset{wordOffset*srcStep + ((nibbleOffset>>1)&3u)};
+            ++nibbleOffset;
+
+            std::ignore = decode_sample(uint(nibbleData[byteOffset]>>byteShift) & 15u);
+        }
+
+        /* Second, decode the rest of the block and write to the output, until
+         * the end of the block or the end of output.
+         */
+        const size_t todo{std::min(samplesPerBlock-startOffset, dstSamples.size())};
+        std::generate_n(dstSamples.begin(), todo, [&]
+        {
+            const size_t byteShift{(nibbleOffset&1) * 4};
+            const size_t wordOffset{(nibbleOffset>>1) & ~3_uz};
+            const size_t byteOffset{wordOffset*srcStep + ((nibbleOffset>>1)&3u)};
+            ++nibbleOffset;
+
+            const int result{decode_sample(uint(nibbleData[byteOffset]>>byteShift) & 15u)};
+            return static_cast<float>(result) / 32768.0f;
+        });
+        dstSamples = dstSamples.subspan(todo);
+    }
+}
+
+template<>
+void LoadHalf_<CTag>(const al::span<float> dstSamples, const al::span<const std::byte> src,
+    const size_t srcChan, const size_t srcOffset, const size_t srcStep) noexcept
+{
+    using TypeTraits = al::FmtTypeTraits<FmtHalf>;
+    using SampleType = TypeTraits::Type;
+    const auto converter = TypeTraits{};
+
+    const al::span<const SampleType> halfs{reinterpret_cast<const SampleType*>(src.data()),
+        src.size()/sizeof(SampleType)};
+    size_t pos{srcOffset*srcStep + srcChan};
+    std::generate(dstSamples.begin(), dstSamples.end(), [halfs,&pos,srcStep,converter]
+    {
+        const float ret{converter(halfs[pos])};
+        pos += srcStep;
+        return ret;
+    });
+}
@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <variant>
 
@@ -19,6 +20,7 @@
 #include "hrtfbase.h"
 #include "opthelpers.h"
 
+struct CTag;
 struct NEONTag;
 struct LerpTag;
 struct CubicTag;
@@ -482,3 +484,39 @@ void Mix_<NEONTag>(const al::span<const float> InSamples, const al::span<float>
 
     MixLine(InSamples, OutBuffer, CurrentGain, TargetGain, delta, fade_len, realign_len, Counter);
 }
+
+template<>
+void LoadHalf_<NEONTag>(const al::span<float> dstSamples, const al::span<const std::byte> src,
+    const size_t srcChan, const size_t srcOffset, const size_t srcStep) noexcept
+{
+#if defined(__aarch64__) || defined(_M_ARM64)
+    const al::span<const uint16_t> halfs{reinterpret_cast<const uint16_t*>(src.data()),
+        src.size()/sizeof(uint16_t)};
+    size_t pos{srcOffset*srcStep + srcChan};
+
+    /* AArch64 always has the half-precision conversions, which convert four
+     * samples at a time.
+     */
+    const size_t todo{dstSamples.size() & ~3_uz};
+    size_t i{0};
+    for(;i < todo;i += 4)
+    {
+        uint16x4_t vals;
+        if(srcStep == 1)
+            vals = vld1_u16(&halfs[pos]);
+        else
+        {
+            vals = vdup_n_u16(halfs[pos]);
+            vals = vset_lane_u16(halfs[pos + srcStep], vals, 1);
+            vals = vset_lane_u16(halfs[pos + srcStep*2], vals, 2);
+            vals = vset_lane_u16(halfs[pos + srcStep*3], vals, 3);
+        }
+        vst1q_f32(&dstSamples[i], vcvt_f32_f16(vreinterpret_f16_u16(vals)));
+        pos += srcStep*4;
+    }
+    if(i < dstSamples.size())
+        LoadHalf_<CTag>(dstSamples.subspan(i), src, srcChan, srcOffset+i, srcStep);
+#else
+    LoadHalf_<CTag>(dstSamples, src, srcChan, srcOffset, srcStep);
+#endif
+}
@@ -25,6 +25,8 @@ struct SSETag;
 struct CubicTag;
 struct BSincTag;
 struct FastBSincTag;
+struct BSincPolyTag;
+struct FastBSincPolyTag;
 
 
 #if defined(__GNUC__) && !defined(__clang__) && !defined(__SSE__)
@@ -333,6 +335,124 @@ void Resample_<FastBSincTag,SSETag>(const InterpState *state, const al::span<con
 }
 
 
+namespace {
+
+/* Resamples with an increment that's a multiple of 0.5, using the filters
+ * calculated for the two alternating phases.
+ */
+void DoPolyResample(const al::span<const float> src, const size_t m,
+    const al::span<const std::array<float,MaxResamplerPadding>,2> filters, const uint frac,
+    const uint increment, const al::span<float> dst)
+{
+    const uint frac1{(frac+increment) & MixerFracMask};
+    const size_t step0{(frac+increment) >> MixerFracBits};
+    const size_t step1{(frac1+increment) >> MixerFracBits};
+
+    auto dot_product = [src,m](const al::span<const float> fil, const size_t pos) noexcept
+    {
+        auto r4 = _mm_setzero_ps();
+        auto td = size_t{m >> 2};
+        auto j = size_t{0};
+
+        do {
+            /* r += f*src */
+            r4 = vmadd(r4, _mm_load_ps(&fil[j]), _mm_loadu_ps(&src[pos+j]));
+            j += 4;
+        } while(--td);
+        r4 = _mm_add_ps(r4, _mm_shuffle_ps(r4, r4, _MM_SHUFFLE(0, 1, 2, 3)));
+        r4 = _mm_add_ps(r4, _mm_movehl_ps(r4, r4));
+        return _mm_cvtss_f32(r4);
+    };
+
+    auto pos = size_t{0};
+    auto dstiter = dst.begin();
+    for(size_t todo{dst.size()>>1};todo;--todo)
+    {
+        *(dstiter++) = dot_product(filters[0], pos);
+        *(dstiter++) = dot_product(filters[1], pos+step0);
+        pos += step0 + step1;
+    }
+    if(dstiter != dst.end())
+        *dstiter = dot_product(filters[0], pos);
+}
+
+} // namespace
+
+template<>
+void Resample_<BSincPolyTag,SSETag>(const InterpState *state, const al::span<const float> src,
+    uint frac, const uint increment, const al::span<float> dst)
+{
+    const auto &bsinc = std::get<BsincState>(*state);
+    const auto sf4 = _mm_set1_ps(bsinc.sf);
+    const auto m = size_t{bsinc.m};
+    ASSUME(m > 0);
+    ASSUME(m <= MaxResamplerPadding);
+    ASSUME(frac < MixerFracOne);
+
+    const auto filter = bsinc.filter.first(4_uz*BSincPhaseCount*m);
+
+    alignas(16) std::array<std::array<float,MaxResamplerPadding>,2> filters;
+    auto make_filter = [sf4,m,filter](const uint phase, const al::span<float> coeffs)
+    {
+        const size_t pi{phase >> BSincPhaseDiffBits}; ASSUME(pi < BSincPhaseCount);
+        const float pf{static_cast<float>(phase&BSincPhaseDiffMask) * (1.0f/BSincPhaseDiffOne)};
+
+        const auto pf4 = _mm_set1_ps(pf);
+        const auto fil = filter.subspan(2_uz*pi*m);
+        const auto phd = fil.subspan(m);
+        const auto scd = fil.subspan(2_uz*BSincPhaseCount*m);
+        const auto spd = scd.subspan(m);
+        for(size_t j{0};j < m;j += 4)
+        {
+            /* f = ((fil + sf*scd) + pf*(phd + sf*spd)) */
+            const __m128 f4 = vmadd(
+                vmadd(_mm_load_ps(&fil[j]), sf4, _mm_load_ps(&scd[j])),
+                pf4, vmadd(_mm_load_ps(&phd[j]), sf4, _mm_load_ps(&spd[j])));
+            _mm_store_ps(&coeffs[j], f4);
+        }
+    };
+    make_filter(frac, filters[0]);
+    make_filter((frac+increment) & MixerFracMask, filters[1]);
+
+    ASSUME(bsinc.l <= MaxResamplerEdge);
+    DoPolyResample(src.subspan(MaxResamplerEdge-bsinc.l), m, filters, frac, increment, dst);
+}
+
+template<>
+void Resample_<FastBSincPolyTag,SSETag>(const InterpState *state, const al::span<const float> src,
+    uint frac, const uint increment, const al::span<float> dst)
+{
+    const auto &bsinc = std::get<BsincState>(*state);
+    const auto m = size_t{bsinc.m};
+    ASSUME(m > 0);
+    ASSUME(m <= MaxResamplerPadding);
+    ASSUME(frac < MixerFracOne);
+
+    const auto filter = bsinc.filter.first(2_uz*m*BSincPhaseCount);
+
+    alignas(16) std::array<std::array<float,MaxResamplerPadding>,2> filters;
+    auto make_filter = [m,filter](const uint phase, const al::span<float> coeffs)
+    {
+        const size_t pi{phase >> BSincPhaseDiffBits}; ASSUME(pi < BSincPhaseCount);
+        const float pf{static_cast<float>(phase&BSincPhaseDiffMask) * (1.0f/BSincPhaseDiffOne)};
+
+        const auto pf4 = _mm_set1_ps(pf);
+        const auto fil = filter.subspan(2_uz*m*pi);
+        const auto phd = fil.subspan(m);
+        for(size_t j{0};j < m;j += 4)
+        {
+            /* f = fil + pf*phd */
+            _mm_store_ps(&coeffs[j], vmadd(_mm_load_ps(&fil[j]), pf4, _mm_load_ps(&phd[j])));
+        }
+    };
+    make_filter(frac, filters[0]);
+    make_filter((frac+increment) & MixerFracMask, filters[1]);
+
+    ASSUME(bsinc.l <= MaxResamplerEdge);
+    DoPolyResample(src.subspan(MaxResamplerEdge-bsinc.l), m, filters, frac, increment, dst);
+}
+
+
 template<>
 void MixHrtf_<SSETag>(const al::span<const float> InSamples, const al::span<float2> AccumSamples,
     const uint IrSize, const MixHrtfFilter *hrtfparams, const size_t SamplesToDo)
@@ -384,3 +504,105 @@ void Mix_<SSETag>(const al::span<const float> InSamples, const al::span<float> O
 
     MixLine(InSamples, OutBuffer, CurrentGain, TargetGain, delta, fade_len, realign_len, Counter);
 }
+
+template<>
+void MixBatch_<SSETag>(const al::span<const MixBatchInput> Inputs,
+    const al::span<FloatBufferLine> OutBuffer, const size_t Counter, const size_t OutPos)
+{
+    ASSUME(!Inputs.empty());
+    ASSUME(Inputs.size() <= MaxMixBatchInputs);
+
+    const float delta{(Counter > 0) ? 1.0f / static_cast<float>(Counter) : 0.0f};
+    const size_t todo{Inputs[0].Samples.size()};
+    const auto fade_len = std::min(Counter, todo);
+    const auto four4 = _mm_set1_ps(4.0f);
+
+    std::array<al::span<const float>,MaxMixBatchInputs> fadesrcs{}, srcs{};
+    std::array<float,MaxMixBatchInputs> gains{}, steps{}, targets{};
+    for(size_t c{0};c < OutBuffer.size();++c)
+    {
+        /* Get the starting gain and step of each input, and its gain after
+         * the fade. Inputs that aren't fading start at their target, which is
+         * dropped if silent. Only the inputs that contribute to this output
+         * are kept, so sparse gains (e.g. upsampled B-Format, which doesn't
+         * reach every order) don't mix silence.
+         */
+        bool fading{false};
+        size_t numfade{0}, numsrcs{0};
+        for(size_t i{0};i < Inputs.size();++i)
+        {
+            float &CurrentGain = Inputs[i].CurrentGains[c];
+            const float TargetGain{Inputs[i].TargetGains[c]};
+            const float step{(TargetGain-CurrentGain) * delta};
+            const float target{(std::abs(TargetGain) > GainSilenceThreshold) ? TargetGain : 0.0f};
+            if(std::abs(step) > std::numeric_limits<float>::epsilon())
+            {
+                fadesrcs[numfade] = Inputs[i].Samples;
+                gains[numfade] = CurrentGain;
+                steps[numfade] = step;
+                ++numfade;
+                CurrentGain = (fade_len < Counter)
+                    ? CurrentGain + step*static_cast<float>(fade_len) : TargetGain;
+                fading = true;
+            }
+            else
+            {
+                if(target != 0.0f)
+                {
+                    fadesrcs[numfade] = Inputs[i].Samples;
+                    gains[numfade] = target;
+                    steps[numfade] = 0.0f;
+                    ++numfade;
+                }
+                CurrentGain = TargetGain;
+            }
+            if(target != 0.0f)
+            {
+                srcs[numsrcs] = Inputs[i].Samples;
+                targets[numsrcs] = target;
+                ++numsrcs;
+            }
+        }
+
+        const auto output = al::span{OutBuffer[c]}.subspan(OutPos, todo);
+        size_t pos{0};
+        if(fading)
+        {
+            auto step_count4 = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+            for(;pos+4 <= fade_len;pos += 4)
+            {
+                /* dry += val * (gain + step*step_count) */
+                auto dry4 = _mm_loadu_ps(&output[pos]);
+                for(size_t i{0};i < numfade;++i)
+                    dry4 = vmadd(dry4, _mm_loadu_ps(&fadesrcs[i][pos]),
+                        vmadd(_mm_set1_ps(gains[i]), _mm_set1_ps(steps[i]), step_count4));
+                _mm_storeu_ps(&output[pos], dry4);
+                step_count4 = _mm_add_ps(step_count4, four4);
+            }
+            for(;pos < fade_len;++pos)
+            {
+                const auto step_count = static_cast<float>(pos);
+                float sample{0.0f};
+                for(size_t i{0};i < numfade;++i)
+                    sample += fadesrcs[i][pos] * (gains[i] + steps[i]*step_count);
+                output[pos] += sample;
+            }
+        }
+        if(numsrcs == 0)
+            continue;
+        for(;pos+4 <= todo;pos += 4)
+        {
+            auto dry4 = _mm_loadu_ps(&output[pos]);
+            for(size_t i{0};i < numsrcs;++i)
+                dry4 = vmadd(dry4, _mm_loadu_ps(&srcs[i][pos]), _mm_set1_ps(targets[i]));
+            _mm_storeu_ps(&output[pos], dry4);
+        }
+        for(;pos < todo;++pos)
+        {
+            float sample{0.0f};
+            for(size_t i{0};i < numsrcs;++i)
+                sample += srcs[i][pos] * targets[i];
+            output[pos] += sample;
+        }
+    }
+}
@@ -31,11 +31,13 @@
 
 #include "alnumeric.h"
 #include "alspan.h"
+#include "core/adpcm_defs.h"
 #include "core/cubic_defs.h"
 #include "core/resampler_limits.h"
 #include "defs.h"
 #include "opthelpers.h"
 
+struct CTag;
 struct SSE4Tag;
 struct LerpTag;
 struct CubicTag;
@@ -217,3 +219,134 @@ void Resample_<CubicTag,SSE4Tag>(const InterpState *state, const al::span<const
         });
     }
 }
+
+template<>
+void LoadIMA4_<SSE4Tag>(const al::span<float> dstSamples, const al::span<const std::byte> src,
+    const size_t srcChan, const size_t srcOffset, const size_t srcStep,
+    const size_t samplesPerBlock) noexcept
+{
+    static constexpr int MaxStepIndex{static_cast<int>(IMAStep_size.size()) - 1};
+    /* The number of nibbles to decode at once. Must be a multiple of 8. */
+    static constexpr size_t ChunkSize{64};
+
+    const size_t blockBytes{((samplesPerBlock-1)/2 + 4)*srcStep};
+    const size_t firstBlock{srcOffset / samplesPerBlock};
+    const size_t skip{srcOffset % samplesPerBlock};
+    const size_t numBlocks{(skip + dstSamples.size() + samplesPerBlock-1) / samplesPerBlock};
+
+    /* Writes decoded samples given their position from the start of the first
+     * block, dropping those before srcOffset or past the end of the output.
+     */
+    auto write_samples = [dstSamples,skip](size_t pos, al::span<const float> samples)
+    {
+        if(pos < skip)
+        {
+            const size_t toskip{std::min(skip-pos, samples.size())};
+            samples = samples.subspan(toskip);
+            pos += toskip;
+        }
+        pos -= skip;
+        if(pos >= dstSamples.size()) return;
+        const size_t todo{std::min(samples.size(), dstSamples.size()-pos)};
+        std::copy_n(samples.begin(), todo, dstSamples.begin()+ptrdiff_t(pos));
+    };
+    auto read_word = [](const al::span<const std::byte> data) -> uint
+    {
+        return uint(data[0]) | (uint(data[1]) << 8) | (uint(data[2]) << 16)
+            | (uint(data[3]) << 24);
+    };
+
+    const __m128i sampleMin4{_mm_set1_epi32(-32768)};
+    const __m128i sampleMax4{_mm_set1_epi32(32767)};
+    const __m128 scale4{_mm_set1_ps(1.0f/32768.0f)};
+
+    /* Each IMA4 block starts fresh from its header, so the samples within a
+     * block depend on each other, but the blocks don't. Decode four blocks at
+     * a time, one per lane, with each block's step index chain interleaved.
+     */
+    alignas(16) std::array<std::array<int,4>,ChunkSize> deltas{};
+    alignas(16) std::array<std::array<float,ChunkSize>,4> output{};
+    size_t blk{0};
+    for(;numBlocks-blk >= 4;blk += 4)
+    {
+        const auto blocks = src.subspan((firstBlock+blk)*blockBytes, blockBytes*4);
+
+        std::array<uint,4> index{};
+        alignas(16) std::array<int,4> sample{};
+        for(size_t k{0};k < 4;++k)
+        {
+            const auto header = blocks.subspan(k*blockBytes + srcChan*4, 4);
+            const int smp{int(header[0]) | (int(header[1]) << 8)};
+            const int idx{int(header[2]) | (int(header[3]) << 8)};
+            sample[k] = (smp^0x8000) - 32768;
+            index[k] = static_cast<uint>(std::clamp((idx^0x8000) - 32768, 0, MaxStepIndex));
+
+            const float first{static_cast<float>(sample[k]) / 32768.0f};
+            write_samples((blk+k)*samplesPerBlock, {&first, 1});
+        }
+        __m128i sample4{_mm_load_si128(reinterpret_cast<const __m128i*>(sample.data()))};
+
+        const size_t nibbleStart{(srcStep+srcChan)*4};
+        size_t group{0};
+        for(size_t nibble{0};nibble < samplesPerBlock-1;)
+        {
+            const size_t todo{std::min(samplesPerBlock-1-nibble, ChunkSize)};
+            for(size_t i{0};i < todo;i += 8)
+            {
+                /* Each group of 8 nibbles is packed in 4 bytes, with the
+                 * channels interleaved per group.
+                 */
+                const size_t offset{nibbleStart + group*srcStep*4};
+                ++group;
+
+                std::array<uint,4> words{};
+                for(size_t k{0};k < 4;++k)
+                    words[k] = read_word(blocks.subspan(k*blockBytes + offset, 4));
+
+                for(size_t j{0};j < 8;++j)
+                {
+                    for(size_t k{0};k < 4;++k)
+                    {
+                        const uint code{(words[k] >> (j*4)) & 15u};
+                        const auto &step = IMA4DecodeTable[index[k]][code];
+                        deltas[i+j][k] = step.mDelta;
+                        index[k] = static_cast<uint>(step.mNextIndex);
+                    }
+                }
+            }
+
+            auto decode_step = [&sample4,&deltas,sampleMin4,sampleMax4,scale4](size_t i)
+            {
+                const __m128i delta4{_mm_load_si128(
+                    reinterpret_cast<const __m128i*>(deltas[i].data()))};
+                sample4 = _mm_min_epi32(_mm_max_epi32(_mm_add_epi32(sample4, delta4),
+                    sampleMin4), sampleMax4);
+                return _mm_mul_ps(_mm_cvtepi32_ps(sample4), scale4);
+            };
+            for(size_t i{0};i < todo;i += 4)
+            {
+                __m128 r0{decode_step(i)};
+                __m128 r1{decode_step(i+1)};
+                __m128 r2{decode_step(i+2)};
+                __m128 r3{decode_step(i+3)};
+                _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+                _mm_store_ps(&output[0][i], r0);
+                _mm_store_ps(&output[1][i], r1);
+                _mm_store_ps(&output[2][i], r2);
+                _mm_store_ps(&output[3][i], r3);
+            }
+
+            for(size_t k{0};k < 4;++k)
+                write_samples((blk+k)*samplesPerBlock + 1 + nibble,
+                    al::span{output[k]}.first(todo));
+            nibble += todo;
+        }
+    }
+
+    /* Decode any remaining blocks one at a time. */
+    if(blk == 0)
+        LoadIMA4_<CTag>(dstSamples, src, srcChan, srcOffset, srcStep, samplesPerBlock);
+    else if(blk < numBlocks)
+        LoadIMA4_<CTag>(dstSamples.subspan(blk*samplesPerBlock - skip), src, srcChan,
+            (firstBlock+blk)*samplesPerBlock, srcStep, samplesPerBlock);
+}
@@ -0,0 +1,416 @@
+#include "config.h"
+
+#include "mixer_pool.h"
+
+#include <algorithm>
+#include <array>
+#include <exception>
+#include <functional>
+#include <thread>
+
+#include "almalloc.h"
+#include "althrd_setname.h"
+#include "bufferline.h"
+#include "device.h"
+#include "effects/base.h"
+#include "effectslot.h"
+#include "fpu_ctrl.h"
+#include "helpers.h"
+#include "logging.h"
+#include "mixer/hrtfdefs.h"
+#include "tracing.h"
+#include "vector.h"
+#include "voice.h"
+
+
+struct MixerPool::Worker {
+    std::thread mThread;
+    al::semaphore mStartSem;
+
+    /* The voice partition this worker mixes, [1...threadCount). Partition 0
+     * is mixed by the mixer thread.
+     */
+    std::size_t mPartition{};
+
+    MixerScratch mScratch;
+    alignas(16) std::array<float2,BufferLineSize+HrirLength> mHrtfAccum{};
+
+    /* Private copies of the device and effect slot mixing buffers. */
+    al::vector<FloatBufferLine,16> mLines;
+    std::size_t mNumLines{0};
+    std::array<MixerScratch::LineMap,MaxLineMaps> mLineMaps{};
+
+    Worker() { mScratch.mHrtfAccum = mHrtfAccum; }
+};
+
+namespace {
+
+void MixPartition(ContextBase *context, const al::span<Voice*> voices, const std::size_t start,
+    const std::size_t step, const std::chrono::nanoseconds deviceTime, const uint SamplesToDo,
+    MixerScratch &scratch)
+{
+    for(std::size_t i{start};i < voices.size();i += step)
+    {
+        Voice *voice{voices[i]};
+        const Voice::State vstate{voice->mPlayState.load(std::memory_order_acquire)};
+        if(vstate != Voice::Stopped && vstate != Voice::Pending)
+            voice->mix(vstate, context, deviceTime, SamplesToDo, scratch);
+    }
+    scratch.flushBatch();
+}
+
+void UpdatePartition(ContextBase *context, const al::span<Voice*> voices, const std::size_t start,
+    const std::size_t step, MixerPool::VoiceUpdateFunc func, const bool force)
+{
+    for(std::size_t i{start};i < voices.size();i += step)
+        func(voices[i], context, force);
+}
+
+void ProcessPartition(const al::span<EffectSlot*> slots, const std::size_t start,
+    const std::size_t step, const uint SamplesToDo, const al::span<FloatBufferLine> mixbuffer,
+    const al::span<FloatBufferLine> lines)
+{
+    for(std::size_t i{start};i < slots.size();i += step)
+    {
+        if(slots[i]->mSleeping)
+            continue;
+        TRACE_SPAN("EffectSlot", slots[i]->mId);
+        EffectState *state{slots[i]->mEffectState.get()};
+        /* Redirect the output to the same lines in the private copy of the
+         * mixing buffer.
+         */
+        const auto offset = static_cast<std::size_t>(state->mOutTarget.data() - mixbuffer.data());
+        state->process(SamplesToDo, slots[i]->Wet.Buffer,
+            lines.subspan(offset, state->mOutTarget.size()));
+    }
+}
+
+void AddHrtfAccum(const al::span<float2> dst, const al::span<float2> accum)
+{
+    std::transform(dst.begin(), dst.end(), accum.begin(), dst.begin(),
+        [](const float2 &lhs, const float2 &rhs) noexcept -> float2
+        { return float2{{lhs[0]+rhs[0], lhs[1]+rhs[1]}}; });
+    std::fill(accum.begin(), accum.end(), float2{});
+}
+
+void AddLines(const al::span<FloatBufferLine> dst, const al::span<const FloatBufferLine> src,
+    const std::size_t SamplesToDo)
+{
+    auto srcline = src.cbegin();
+    for(FloatBufferLine &dstline : dst)
+    {
+        std::transform(dstline.cbegin(), dstline.cbegin()+SamplesToDo, srcline->cbegin(),
+            dstline.begin(), std::plus<>{});
+        ++srcline;
+    }
+}
+
+} // namespace
+
+
+MixerPool::MixerPool(DeviceBase *device) : mDevice{device} { }
+
+MixerPool::~MixerPool()
+{
+    mQuit.store(true, std::memory_order_release);
+    for(auto &worker : mWorkers)
+    {
+        worker->mStartSem.post();
+        if(worker->mThread.joinable())
+            worker->mThread.join();
+    }
+}
+
+void MixerPool::workerProc(Worker &worker)
+{
+    SetRTPriority();
+    althrd_setname(GetMixerPoolThreadName());
+
+    FPUCtl mixer_mode{};
+    while(true)
+    {
+        worker.mStartSem.wait();
+        if(mQuit.load(std::memory_order_acquire))
+            break;
+
+        if(mTask == Task::UpdateVoices)
+            UpdatePartition(mContext, mVoices, worker.mPartition, threadCount(), mUpdateFunc,
+                mForceUpdate);
+        else if(mTask == Task::ProcessContexts)
+        {
+            const auto lines = al::span{worker.mLines}.first(mDevice->MixBuffer.size());
+            for(FloatBufferLine &line : lines)
+                std::fill_n(line.begin(), mSamplesToDo, 0.0f);
+
+            for(std::size_t i{worker.mPartition};i < mContexts.size();i += threadCount())
+                mContextFunc(mContexts[i], mDeviceTime, mSamplesToDo, worker.mScratch);
+        }
+        else if(mTask == Task::ProcessEffects)
+        {
+            const auto lines = al::span{worker.mLines}.first(mDevice->MixBuffer.size());
+            for(FloatBufferLine &line : lines)
+                std::fill_n(line.begin(), mSamplesToDo, 0.0f);
+
+            ProcessPartition(mEffectSlots, worker.mPartition, threadCount(), mSamplesToDo,
+                mDevice->MixBuffer, lines);
+        }
+        else
+        {
+            auto lines = al::span{worker.mLines}.first(worker.mNumLines);
+            for(FloatBufferLine &line : lines)
+                std::fill_n(line.begin(), mSamplesToDo, 0.0f);
+
+            MixPartition(mContext, mVoices, worker.mPartition, threadCount(), mDeviceTime,
+                mSamplesToDo, worker.mScratch);
+        }
+
+        mDoneSem.post();
+    }
+}
+
+
+bool MixerPool::mixVoices(ContextBase *context, const al::span<Voice*> voices,
+    const al::span<EffectSlot*> slots, const std::chrono::nanoseconds deviceTime,
+    const uint SamplesToDo)
+{
+    const std::size_t numthreads{threadCount()};
+    if(voices.size() < numthreads*MinVoicesPerThread)
+        return false;
+
+    /* Make sure the workers can hold a copy of every buffer a voice may mix
+     * to.
+     */
+    if(slots.size()+1 > MaxLineMaps)
+        return false;
+    const std::size_t numDryLines{mDevice->MixBuffer.size()};
+    std::size_t numWetLines{0};
+    for(const EffectSlot *slot : slots)
+        numWetLines += slot->Wet.Buffer.size();
+    if(numWetLines > MaxWetLines)
+        return false;
+
+    for(auto &worker : mWorkers)
+    {
+        auto lines = worker->mLines.begin();
+        auto linemaps = worker->mLineMaps.begin();
+
+        const al::span<FloatBufferLine> drybuf{mDevice->MixBuffer};
+        *(linemaps++) = MixerScratch::LineMap{al::to_address(drybuf.begin()),
+            al::to_address(drybuf.end()), al::to_address(lines)};
+        lines += static_cast<ptrdiff_t>(drybuf.size());
+        for(const EffectSlot *slot : slots)
+        {
+            const al::span<const FloatBufferLine> wetbuf{slot->Wet.Buffer};
+            *(linemaps++) = MixerScratch::LineMap{al::to_address(wetbuf.begin()),
+                al::to_address(wetbuf.end()), al::to_address(lines)};
+            lines += static_cast<ptrdiff_t>(wetbuf.size());
+        }
+        worker->mNumLines = numDryLines + numWetLines;
+        worker->mScratch.mLineMaps = al::span{worker->mLineMaps}.first(slots.size()+1);
+        /* The context's event queue only takes one writer, so the workers
+         * must leave their voice events for the mixer thread to send.
+         */
+        worker->mScratch.mDeferEvents = true;
+    }
+
+    mContext = context;
+    mVoices = voices;
+    mDeviceTime = deviceTime;
+    mSamplesToDo = SamplesToDo;
+    for(auto &worker : mWorkers)
+        worker->mStartSem.post();
+
+    /* Mix the first partition directly into the real buffers while the
+     * workers run. Events are deferred here too, then all of them get sent
+     * in voice order, the same as a serial mix.
+     */
+    MixerScratch &scratch = mDevice->mMixerScratch;
+    scratch.mDeferEvents = true;
+    MixPartition(context, voices, 0, numthreads, deviceTime, SamplesToDo, scratch);
+    scratch.mDeferEvents = false;
+
+    for(std::size_t i{0};i < mWorkers.size();++i)
+        mDoneSem.wait();
+    for(auto &worker : mWorkers)
+        worker->mScratch.mDeferEvents = false;
+
+    /* Sum each worker's output into the real buffers. */
+    const bool hasHrtf{mDevice->mHrtfState != nullptr};
+    for(auto &worker : mWorkers)
+    {
+        auto lines = al::span{std::as_const(worker->mLines)};
+        AddLines(mDevice->MixBuffer, lines.first(numDryLines), SamplesToDo);
+        lines = lines.subspan(numDryLines);
+        for(EffectSlot *slot : slots)
+        {
+            AddLines(slot->Wet.Buffer, lines.first(slot->Wet.Buffer.size()), SamplesToDo);
+            lines = lines.subspan(slot->Wet.Buffer.size());
+        }
+
+        if(hasHrtf)
+            AddHrtfAccum(mDevice->HrtfAccumData, worker->mHrtfAccum);
+    }
+
+    for(Voice *voice : voices)
+        voice->sendDeferredEvents(context);
+
+    return true;
+}
+
+
+bool MixerPool::updateVoices(ContextBase *context, const al::span<Voice*> voices,
+    const std::size_t numUpdates, VoiceUpdateFunc func, const bool force)
+{
+    const std::size_t numthreads{threadCount()};
+    if(numUpdates < numthreads*MinUpdatesPerThread)
+        return false;
+
+    mTask = Task::UpdateVoices;
+    mContext = context;
+    mVoices = voices;
+    mUpdateFunc = func;
+    mForceUpdate = force;
+    for(auto &worker : mWorkers)
+        worker->mStartSem.post();
+
+    UpdatePartition(context, voices, 0, numthreads, func, force);
+
+    for(std::size_t i{0};i < mWorkers.size();++i)
+        mDoneSem.wait();
+    mTask = Task::MixVoices;
+    mUpdateFunc = nullptr;
+
+    return true;
+}
+
+
+bool MixerPool::processEffects(const al::span<EffectSlot*> slots, const uint SamplesToDo)
+{
+    if(slots.size() < 2)
+        return false;
+
+    const al::span<FloatBufferLine> mixbuffer{mDevice->MixBuffer};
+    const bool all_device_out{std::all_of(slots.begin(), slots.end(),
+        [mixbuffer](const EffectSlot *slot) noexcept -> bool
+        {
+            const auto target = slot->mEffectState->mOutTarget;
+            return target.data() >= mixbuffer.data()
+                && target.data()+target.size() <= mixbuffer.data()+mixbuffer.size();
+        })};
+    if(!all_device_out)
+        return false;
+
+    /* Only start the workers that have a slot to process. */
+    const std::size_t numworkers{std::min(slots.size(), threadCount()) - 1};
+
+    mTask = Task::ProcessEffects;
+    mEffectSlots = slots;
+    mSamplesToDo = SamplesToDo;
+    for(std::size_t i{0};i < numworkers;++i)
+        mWorkers[i]->mStartSem.post();
+
+    /* Process the first partition directly into the real buffers. */
+    const std::size_t numthreads{threadCount()};
+    for(std::size_t i{0};i < slots.size();i += numthreads)
+    {
+        if(slots[i]->mSleeping)
+            continue;
+        TRACE_SPAN("EffectSlot", slots[i]->mId);
+        EffectState *state{slots[i]->mEffectState.get()};
+        state->process(SamplesToDo, slots[i]->Wet.Buffer, state->mOutTarget);
+    }
+
+    for(std::size_t i{0};i < numworkers;++i)
+        mDoneSem.wait();
+    mTask = Task::MixVoices;
+
+    for(std::size_t i{0};i < numworkers;++i)
+    {
+        const auto lines = al::span{std::as_const(mWorkers[i]->mLines)};
+        AddLines(mixbuffer, lines.first(mixbuffer.size()), SamplesToDo);
+    }
+
+    return true;
+}
+
+
+bool MixerPool::processContexts(const al::span<ContextBase*> contexts, ContextProcessFunc func,
+    const std::chrono::nanoseconds deviceTime, const uint SamplesToDo)
+{
+    if(contexts.size() < 2)
+        return false;
+
+    /* Only start the workers that have a context to process. Each one mixes
+     * into a private copy of the device buffers. The effect slot buffers
+     * belong to their context, so they don't need copies.
+     */
+    const std::size_t numworkers{std::min(contexts.size(), threadCount()) - 1};
+    const al::span<FloatBufferLine> drybuf{mDevice->MixBuffer};
+    for(std::size_t i{0};i < numworkers;++i)
+    {
+        Worker &worker = *mWorkers[i];
+        worker.mLineMaps[0] = MixerScratch::LineMap{al::to_address(drybuf.begin()),
+            al::to_address(drybuf.end()), al::to_address(worker.mLines.begin())};
+        worker.mScratch.mLineMaps = al::span{worker.mLineMaps}.first(1);
+    }
+
+    mTask = Task::ProcessContexts;
+    mContexts = contexts;
+    mContextFunc = func;
+    mDeviceTime = deviceTime;
+    mSamplesToDo = SamplesToDo;
+    for(std::size_t i{0};i < numworkers;++i)
+        mWorkers[i]->mStartSem.post();
+
+    const std::size_t numthreads{threadCount()};
+    for(std::size_t i{0};i < contexts.size();i += numthreads)
+        func(contexts[i], deviceTime, SamplesToDo, mDevice->mMixerScratch);
+
+    for(std::size_t i{0};i < numworkers;++i)
+        mDoneSem.wait();
+    mTask = Task::MixVoices;
+    mContextFunc = nullptr;
+
+    const bool hasHrtf{mDevice->mHrtfState != nullptr};
+    for(std::size_t i{0};i < numworkers;++i)
+    {
+        Worker &worker = *mWorkers[i];
+        AddLines(drybuf, al::span{std::as_const(worker.mLines)}.first(drybuf.size()),
+            SamplesToDo);
+        if(hasHrtf)
+            AddHrtfAccum(mDevice->HrtfAccumData, worker.mHrtfAccum);
+    }
+
+    return true;
+}
+
+
+std::unique_ptr<MixerPool> MixerPool::Create(DeviceBase *device, std::size_t numthreads)
+{
+    if(numthreads < 2)
+        return nullptr;
+
+    auto pool = std::unique_ptr<MixerPool>{new MixerPool{device}};
+    const std::size_t numLines{device->MixBuffer.size() + MaxWetLines};
+    try {
+        pool->mWorkers.reserve(numthreads-1);
+        for(std::size_t i{1};i < numthreads;++i)
+        {
+            auto worker = std::make_unique<Worker>();
+            worker->mPartition = i;
+            worker->mLines.resize(numLines);
+            pool->mWorkers.emplace_back(std::move(worker));
+        }
+        for(auto &worker : pool->mWorkers)
+            worker->mThread = std::thread{&MixerPool::workerProc, pool.get(),
+                std::ref(*worker)};
+    }
+    catch(std::exception &e) {
+        ERR("Failed to start mixer pool threads: %s\n", e.what());
+        /* Just let the destructor stop any threads that were started. */
+        return nullptr;
+    }
+    TRACE("Started %zu mixer pool worker%s\n", pool->mWorkers.size(),
+        (pool->mWorkers.size() == 1) ? "" : "s");
+    return pool;
+}
@@ -0,0 +1,151 @@
+#ifndef CORE_MIXER_POOL_H
+#define CORE_MIXER_POOL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "alsem.h"
+#include "alspan.h"
+
+struct ContextBase;
+struct DeviceBase;
+struct EffectSlot;
+struct MixerScratch;
+struct Voice;
+
+using uint = unsigned int;
+
+
+/**
+ * A pool of worker threads for mixing voices in parallel. The voice list is
+ * split between the mixer thread and the workers, with each worker mixing
+ * into private copies of the device and effect slot buffers. The results are
+ * then summed into the real buffers in worker order, so the output is
+ * deterministic for a given thread count.
+ */
+class MixerPool {
+public:
+    /* The maximum number of effect slot mixing lines a worker can hold a
+     * private copy of. If the active slots need more, the voices are mixed
+     * on the mixer thread only.
+     */
+    static constexpr std::size_t MaxWetLines{64};
+    static constexpr std::size_t MaxLineMaps{17};
+
+    /* The minimum number of voices for each thread before the voice list gets
+     * split up. Below this, there's not enough work to benefit from it.
+     */
+    static constexpr std::size_t MinVoicesPerThread{16};
+
+    /* The minimum number of voices with pending parameter updates for each
+     * thread before the updates get split up. Updates are much cheaper than
+     * mixing, so there needs to be more of them to be worth waking the
+     * workers.
+     */
+    static constexpr std::size_t MinUpdatesPerThread{64};
+
+    using VoiceUpdateFunc = void(*)(Voice *voice, ContextBase *context, bool force);
+    using ContextProcessFunc = void(*)(ContextBase *context, std::chrono::nanoseconds deviceTime,
+        uint SamplesToDo, MixerScratch &scratch);
+
+    struct Worker;
+
+private:
+    DeviceBase *const mDevice;
+    std::vector<std::unique_ptr<Worker>> mWorkers;
+
+    /* Parameters for the current mix, valid while the workers are running. */
+    ContextBase *mContext{nullptr};
+    al::span<Voice*> mVoices;
+    std::chrono::nanoseconds mDeviceTime{};
+    uint mSamplesToDo{0};
+
+    /* What the workers do when they're started. */
+    enum class Task : unsigned char {
+        MixVoices,
+        UpdateVoices,
+        ProcessEffects,
+        ProcessContexts,
+    };
+    Task mTask{Task::MixVoices};
+
+    /* Parameters for the current voice update, valid while the workers are
+     * running.
+     */
+    VoiceUpdateFunc mUpdateFunc{nullptr};
+    bool mForceUpdate{false};
+
+    /* The effect slots being processed, valid while the workers are running. */
+    al::span<EffectSlot*> mEffectSlots;
+
+    /* The contexts being processed, valid while the workers are running. */
+    al::span<ContextBase*> mContexts;
+    ContextProcessFunc mContextFunc{nullptr};
+
+    std::atomic<bool> mQuit{false};
+    al::semaphore mDoneSem;
+
+    void workerProc(Worker &worker);
+
+    MixerPool(DeviceBase *device);
+
+public:
+    MixerPool(const MixerPool&) = delete;
+    MixerPool& operator=(const MixerPool&) = delete;
+    ~MixerPool();
+
+    [[nodiscard]] auto threadCount() const noexcept -> std::size_t { return mWorkers.size()+1; }
+
+    /**
+     * Mixes the given voices, splitting them between the calling thread and
+     * the workers. Returns false without mixing anything if there aren't
+     * enough voices to split, or the active effect slots need more mixing
+     * lines than the workers have.
+     */
+    bool mixVoices(ContextBase *context, const al::span<Voice*> voices,
+        const al::span<EffectSlot*> slots, const std::chrono::nanoseconds deviceTime,
+        const uint SamplesToDo);
+
+    /**
+     * Calls the update function for each of the given voices, splitting them
+     * between the calling thread and the workers. numUpdates is the number
+     * of voices expected to do work. Returns false without updating anything
+     * if there aren't enough to split.
+     */
+    bool updateVoices(ContextBase *context, const al::span<Voice*> voices,
+        const std::size_t numUpdates, VoiceUpdateFunc func, const bool force);
+
+    /**
+     * Processes the given effect slots, splitting them between the calling
+     * thread and the workers. The slots must not feed each other and must
+     * all output to the device's mixing buffers, which the workers hold
+     * private copies of. Returns false without processing anything if there
+     * aren't enough slots to split, or a slot outputs somewhere else.
+     */
+    bool processEffects(const al::span<EffectSlot*> slots, const uint SamplesToDo);
+
+    /**
+     * Processes the given contexts with the process function, splitting them
+     * between the calling thread and the workers. Each worker processes its
+     * contexts into a private copy of the device's mixing buffers. Returns
+     * false without processing anything if there aren't multiple contexts.
+     */
+    bool processContexts(const al::span<ContextBase*> contexts, ContextProcessFunc func,
+        const std::chrono::nanoseconds deviceTime, const uint SamplesToDo);
+
+    /**
+     * Creates a pool using the given total thread count (including the mixer
+     * thread). The device's mixing buffers must already be set up.
+     */
+    static std::unique_ptr<MixerPool> Create(DeviceBase *device, std::size_t numthreads);
+};
+
+/* Must be less than 15 characters (16 including terminating null) for
+ * compatibility with pthread_setname_np limitations. */
+[[nodiscard]] constexpr
+auto GetMixerPoolThreadName() noexcept -> const char* { return "alsoft-mixwork"; }
+
+#endif /* CORE_MIXER_POOL_H */
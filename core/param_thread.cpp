@@ -0,0 +1,50 @@
+#include "config.h"
+
+#include "param_thread.h"
+
+#include <exception>
+
+#include "althrd_setname.h"
+#include "device.h"
+#include "fpu_ctrl.h"
+#include "helpers.h"
+#include "logging.h"
+
+
+ParamUpdateThread::~ParamUpdateThread()
+{
+    mQuit.store(true, std::memory_order_release);
+    mStartSem.post();
+    if(mThread.joinable())
+        mThread.join();
+}
+
+void ParamUpdateThread::threadProc()
+{
+    SetRTPriority();
+    althrd_setname(GetParamUpdateThreadName());
+
+    FPUCtl mixer_mode{};
+    while(true)
+    {
+        mStartSem.wait();
+        if(mQuit.load(std::memory_order_acquire))
+            break;
+
+        mDevice->processUpdatesAhead();
+        mDoneSem.post();
+    }
+}
+
+std::unique_ptr<ParamUpdateThread> ParamUpdateThread::Create(DeviceBase *device)
+{
+    auto helper = std::unique_ptr<ParamUpdateThread>{new ParamUpdateThread{device}};
+    try {
+        helper->mThread = std::thread{&ParamUpdateThread::threadProc, helper.get()};
+    }
+    catch(std::exception &e) {
+        ERR("Failed to start parameter update thread: %s\n", e.what());
+        return nullptr;
+    }
+    return helper;
+}
@@ -0,0 +1,65 @@
+#ifndef CORE_PARAM_THREAD_H
+#define CORE_PARAM_THREAD_H
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+#include "alsem.h"
+
+struct DeviceBase;
+
+
+/**
+ * A helper thread for processing the device's pending property updates ahead
+ * of the next mix. After mixing an update, the mixer thread starts it while
+ * post-processing the output, so the parameter calculations for the next
+ * update are mostly done by the time it starts. Anything that arrives in the
+ * meantime is still processed by the mixer thread as normal.
+ */
+class ParamUpdateThread {
+    DeviceBase *const mDevice;
+    std::thread mThread;
+
+    al::semaphore mStartSem;
+    al::semaphore mDoneSem;
+    std::atomic<bool> mQuit{false};
+
+    /* Only accessed by the mixer thread. */
+    bool mRunning{false};
+
+    void threadProc();
+
+    ParamUpdateThread(DeviceBase *device) : mDevice{device} { }
+
+public:
+    ParamUpdateThread(const ParamUpdateThread&) = delete;
+    ParamUpdateThread& operator=(const ParamUpdateThread&) = delete;
+    ~ParamUpdateThread();
+
+    /** Starts processing the device's property updates. */
+    void start()
+    {
+        mRunning = true;
+        mStartSem.post();
+    }
+
+    /** Waits for the started processing to finish, if any. */
+    void finish() noexcept
+    {
+        if(mRunning)
+        {
+            mDoneSem.wait();
+            mRunning = false;
+        }
+    }
+
+    static std::unique_ptr<ParamUpdateThread> Create(DeviceBase *device);
+};
+
+/* Must be less than 15 characters (16 including terminating null) for
+ * compatibility with pthread_setname_np limitations. */
+[[nodiscard]] constexpr
+auto GetParamUpdateThreadName() noexcept -> const char* { return "alsoft-params"; }
+
+#endif /* CORE_PARAM_THREAD_H */
@@ -0,0 +1,110 @@
+#include "config.h"
+
+#include "render_pool.h"
+
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <thread>
+
+#include "althrd_setname.h"
+#include "device.h"
+#include "logging.h"
+
+
+struct RenderPool::Worker {
+    std::thread mThread;
+    al::semaphore mStartSem;
+};
+
+
+RenderPool::~RenderPool()
+{
+    mQuit.store(true, std::memory_order_release);
+    for(auto &worker : mWorkers)
+    {
+        worker->mStartSem.post();
+        if(worker->mThread.joinable())
+            worker->mThread.join();
+    }
+}
+
+void RenderPool::runJobs()
+{
+    while(true)
+    {
+        const std::size_t idx{mNextJob.fetch_add(1, std::memory_order_relaxed)};
+        if(idx >= mJobs.size())
+            break;
+
+        const Job &job = mJobs[idx];
+        job.mDevice->renderSamples(job.mBuffer, mSamples, job.mDevice->channelsFromFmt());
+    }
+}
+
+void RenderPool::workerProc(Worker &worker)
+{
+    althrd_setname(GetRenderPoolThreadName());
+
+    while(true)
+    {
+        worker.mStartSem.wait();
+        if(mQuit.load(std::memory_order_acquire))
+            break;
+
+        runJobs();
+        mDoneSem.post();
+    }
+}
+
+
+void RenderPool::render(const al::span<const Job> jobs, const uint samples)
+{
+    std::unique_lock<std::mutex> batchlock{mBatchLock, std::try_to_lock};
+    if(!batchlock.owns_lock())
+    {
+        for(const Job &job : jobs)
+            job.mDevice->renderSamples(job.mBuffer, samples, job.mDevice->channelsFromFmt());
+        return;
+    }
+
+    /* Only start the workers that have a device to render. */
+    const std::size_t numworkers{std::min(jobs.size(), threadCount()) - 1};
+
+    mJobs = jobs;
+    mSamples = samples;
+    mNextJob.store(0, std::memory_order_relaxed);
+    for(std::size_t i{0};i < numworkers;++i)
+        mWorkers[i]->mStartSem.post();
+
+    runJobs();
+
+    for(std::size_t i{0};i < numworkers;++i)
+        mDoneSem.wait();
+    mJobs = {};
+}
+
+
+std::unique_ptr<RenderPool> RenderPool::Create(std::size_t numthreads)
+{
+    if(numthreads < 2)
+        return nullptr;
+
+    auto pool = std::unique_ptr<RenderPool>{new RenderPool{}};
+    try {
+        pool->mWorkers.reserve(numthreads-1);
+        for(std::size_t i{1};i < numthreads;++i)
+            pool->mWorkers.emplace_back(std::make_unique<Worker>());
+        for(auto &worker : pool->mWorkers)
+            worker->mThread = std::thread{&RenderPool::workerProc, pool.get(),
+                std::ref(*worker)};
+    }
+    catch(std::exception &e) {
+        ERR("Failed to start render pool threads: %s\n", e.what());
+        /* Just let the destructor stop any threads that were started. */
+        return nullptr;
+    }
+    TRACE("Started %zu render pool worker%s\n", pool->mWorkers.size(),
+        (pool->mWorkers.size() == 1) ? "" : "s");
+    return pool;
+}
@@ -0,0 +1,80 @@
+#ifndef CORE_RENDER_POOL_H
+#define CORE_RENDER_POOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "alsem.h"
+#include "alspan.h"
+
+struct DeviceBase;
+
+using uint = unsigned int;
+
+
+/**
+ * A fixed-size pool of worker threads for rendering many devices at once. The
+ * calling thread and the workers each take the next unrendered device from
+ * the batch until none are left, so devices with uneven loads balance out
+ * across the threads instead of being split ahead of time.
+ */
+class RenderPool {
+public:
+    struct Job {
+        DeviceBase *mDevice;
+        void *mBuffer;
+    };
+
+    struct Worker;
+
+private:
+    std::vector<std::unique_ptr<Worker>> mWorkers;
+
+    /* Only one batch runs on the pool at a time. */
+    std::mutex mBatchLock;
+
+    /* Parameters for the current batch, valid while the workers are running. */
+    al::span<const Job> mJobs;
+    uint mSamples{0};
+    std::atomic<std::size_t> mNextJob{0};
+
+    std::atomic<bool> mQuit{false};
+    al::semaphore mDoneSem;
+
+    void runJobs();
+    void workerProc(Worker &worker);
+
+    RenderPool() = default;
+
+public:
+    RenderPool(const RenderPool&) = delete;
+    RenderPool& operator=(const RenderPool&) = delete;
+    ~RenderPool();
+
+    [[nodiscard]] auto threadCount() const noexcept -> std::size_t { return mWorkers.size()+1; }
+
+    /**
+     * Renders the given number of sample frames for each job's device into
+     * its buffer, using the device's output format, and returns once all of
+     * them are done. Each device must only appear once. If another batch is
+     * already running on the pool, this batch is rendered on the calling
+     * thread alone.
+     */
+    void render(const al::span<const Job> jobs, const uint samples);
+
+    /**
+     * Creates a pool using the given total thread count (including the
+     * calling thread).
+     */
+    static std::unique_ptr<RenderPool> Create(std::size_t numthreads);
+};
+
+/* Must be less than 15 characters (16 including terminating null) for
+ * compatibility with pthread_setname_np limitations. */
+[[nodiscard]] constexpr
+auto GetRenderPoolThreadName() noexcept -> const char* { return "alsoft-render"; }
+
+#endif /* CORE_RENDER_POOL_H */
@@ -19,6 +19,8 @@ const char *NameFromFormat(FmtType type) noexcept
     case FmtAlaw: return "aLaw";
     case FmtIMA4: return "IMA4 ADPCM";
     case FmtMSADPCM: return "MS ADPCM";
+    case FmtIMA2: return "IMA2 ADPCM";
+    case FmtHalf: return "Half";
     }
     return "<internal error>";
 }
@@ -58,6 +60,8 @@ uint BytesFromFmt(FmtType type) noexcept
     case FmtAlaw: return sizeof(std::uint8_t);
     case FmtIMA4: break;
     case FmtMSADPCM: break;
+    case FmtIMA2: break;
+    case FmtHalf: return sizeof(std::uint16_t);
     }
     return 0;
 }
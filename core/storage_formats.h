@@ -14,6 +14,8 @@ enum FmtType : unsigned char {
     FmtAlaw,
     FmtIMA4,
     FmtMSADPCM,
+    FmtIMA2,
+    FmtHalf,
 };
 enum FmtChannels : unsigned char {
     FmtMono,
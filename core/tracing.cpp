@@ -0,0 +1,34 @@
+
+#include "config.h"
+
+#include "tracing.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+std::atomic<const TraceSink*> gTraceSink{nullptr};
+
+namespace {
+
+std::mutex TraceSinkMutex;
+/* Replaced sinks are kept until the library unloads, since a mixing thread
+ * may still be using one it loaded before it was replaced.
+ */
+std::vector<std::unique_ptr<TraceSink>> TraceSinkList;
+
+} // namespace
+
+void al_set_trace_sink(TraceSinkFunc func, void *userptr)
+{
+    auto sinklock = std::lock_guard{TraceSinkMutex};
+    if(!func)
+    {
+        gTraceSink.store(nullptr, std::memory_order_release);
+        return;
+    }
+
+    TraceSinkList.emplace_back(std::make_unique<TraceSink>(TraceSink{func, userptr}));
+    gTraceSink.store(TraceSinkList.back().get(), std::memory_order_release);
+}
@@ -0,0 +1,56 @@
+#ifndef CORE_TRACING_H
+#define CORE_TRACING_H
+
+#include <atomic>
+
+
+/* Trace spans marking the mixer's stages, for external profilers (Tracy,
+ * Perfetto, etc) to show alongside the application's own timeline. The spans
+ * are only emitted when built with ALSOFT_TRACING, otherwise the TRACE_SPAN
+ * macro compiles to nothing.
+ *
+ * The sink is called on the mixing thread(s) when a span begins and ends, with
+ * the span name (a string literal), an ID for the object being processed (a
+ * source or effect slot ID, or 0), and whether it's beginning or ending. It
+ * must not block.
+ */
+using TraceSinkFunc = void(*)(void *userptr, const char *name, unsigned int id, int begin) noexcept;
+
+struct TraceSink {
+    TraceSinkFunc mFunc;
+    void *mUserPtr;
+};
+
+extern std::atomic<const TraceSink*> gTraceSink;
+
+void al_set_trace_sink(TraceSinkFunc func, void *userptr);
+
+
+#ifdef ALSOFT_TRACING
+
+class TraceSpan {
+    const TraceSink *mSink;
+    const char *mName;
+    unsigned int mId;
+
+public:
+    TraceSpan(const char *name, unsigned int id) noexcept
+        : mSink{gTraceSink.load(std::memory_order_acquire)}, mName{name}, mId{id}
+    { if(mSink) mSink->mFunc(mSink->mUserPtr, mName, mId, 1); }
+    ~TraceSpan() { if(mSink) mSink->mFunc(mSink->mUserPtr, mName, mId, 0); }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+};
+
+#define TRACE_SPAN_NAME2(line) traceSpan##line
+#define TRACE_SPAN_NAME(line) TRACE_SPAN_NAME2(line)
+#define TRACE_SPAN(name, id) const TraceSpan TRACE_SPAN_NAME(__LINE__){name, id}
+
+#else
+
+#define TRACE_SPAN(name, id) ((void)0)
+
+#endif
+
+#endif /* CORE_TRACING_H */
@@ -7,6 +7,7 @@
 #include <cmath>
 #include <complex>
 #include <functional>
+#include <tuple>
 #include <vector>
 
 #include "alcomplex.h"
@@ -15,7 +16,6 @@
 #include "core/bufferline.h"
 #include "opthelpers.h"
 #include "pffft.h"
-#include "phase_shifter.h"
 #include "vector.h"
 
 
@@ -110,11 +110,13 @@ struct SegmentedFilter {
     }
 };
 
+/* Generated on first use, when an encoder is created. */
 template<size_t N>
-const SegmentedFilter<N> gSegmentedFilter;
-
-template<size_t N>
-const PhaseShifterT<N> PShifter;
+auto GetSegmentedFilter() -> const SegmentedFilter<N>&
+{
+    static const SegmentedFilter<N> filter{};
+    return filter;
+}
 
 
 /* Filter coefficients for the 'base' all-pass IIR, which applies a frequency-
@@ -133,6 +135,80 @@ constexpr std::array<float,4> Filter2Coeff{{
 
 } // namespace
 
+/* The decoders apply the phase shift to a whole update's worth of samples at
+ * once, with the needed history and look-ahead already in the input buffer, so
+ * they use a stateless overlap-save convolution instead. The N-sample filter
+ * response is zero-padded to an FFT of N*2 samples, and each input block of
+ * N*2 samples produces N output samples. This replaces a time-domain FIR that
+ * costs N/2 multiply-adds per sample.
+ */
+template<size_t N>
+PhaseShiftFilter<N>::PhaseShiftFilter() : mFft{sFftLength, PFFFT_REAL}
+{
+    /* Generate the filter response reversed relative to the time-domain
+     * coefficients, so output sample i sums over input samples i through
+     * i+N-2. Every other coefficient is 0.
+     */
+    using complex_d = std::complex<double>;
+    auto fftBuffer = std::vector<complex_d>(sFftLength);
+    for(size_t i{0};i < N/2;++i)
+    {
+        const int k{static_cast<int>(i*2 + 1) - int{N/2}};
+
+        const double w{2.0*al::numbers::pi * static_cast<double>(i*2 + 1) / double{N}};
+        const double window{0.3635819 - 0.4891775*std::cos(w) + 0.1365995*std::cos(2.0*w)
+            - 0.0106411*std::cos(3.0*w)};
+
+        const double pk{al::numbers::pi * static_cast<double>(k)};
+        fftBuffer[N-2 - i*2] = window * (1.0-std::cos(pk)) / pk;
+    }
+    forward_fft(al::span{fftBuffer});
+
+    /* Convert to zdomain data for PFFFT, scaled by the FFT length so the iFFT
+     * result will be normalized.
+     */
+    auto fftTmp = al::vector<float,16>(sFftLength);
+    for(size_t i{0};i < sFftLength/2;++i)
+    {
+        fftTmp[i*2 + 0] = static_cast<float>(fftBuffer[i].real()) / float{sFftLength};
+        fftTmp[i*2 + 1] = static_cast<float>((i == 0) ? fftBuffer[sFftLength/2].real()
+            : fftBuffer[i].imag()) / float{sFftLength};
+    }
+    mFft.zreorder(fftTmp.data(), mFilterData.data(), PFFFT_BACKWARD);
+}
+
+template<size_t N>
+void PhaseShiftFilter<N>::process(const al::span<float> dst, const al::span<const float> src,
+    const al::span<float,sFftLength> inout, const al::span<float,sFftLength> accum,
+    const al::span<float,sFftLength> work) const
+{
+    for(size_t base{0};base < dst.size();base += sBlockSize)
+    {
+        const size_t todo{std::min(sBlockSize, dst.size()-base)};
+        const auto input = src.subspan(base, std::min(sFftLength, src.size()-base));
+
+        std::fill(std::copy(input.begin(), input.end(), inout.begin()), inout.end(), 0.0f);
+        mFft.transform(inout.data(), inout.data(), work.data(), PFFFT_FORWARD);
+
+        std::fill(accum.begin(), accum.end(), 0.0f);
+        mFft.zconvolve_accumulate(inout.data(), mFilterData.data(), accum.data());
+        mFft.transform(accum.data(), accum.data(), work.data(), PFFFT_BACKWARD);
+
+        /* The first N-2 samples are wrapped around from the end of the block,
+         * and are discarded.
+         */
+        std::copy_n(accum.begin()+(N-2), todo, dst.begin()+base);
+    }
+}
+
+/* Generated on first use, when a decoder is created. */
+template<size_t N>
+auto GetPhaseShiftFilter() -> const PhaseShiftFilter<N>&
+{
+    static const PhaseShiftFilter<N> filter{};
+    return filter;
+}
+
 void UhjAllPassFilter::processOne(const al::span<const float, 4> coeffs, float x)
 {
     auto state = mState;
@@ -184,14 +260,19 @@ void UhjAllPassFilter::process(const al::span<const float,4> coeffs,
  * impulse with the desired shift.
  */
 
+template<size_t N>
+UhjEncoder<N>::UhjEncoder() { std::ignore = GetSegmentedFilter<N>(); }
+
 template<size_t N>
 void UhjEncoder<N>::encode(float *LeftOut, float *RightOut,
     const al::span<const float*const,3> InSamples, const size_t SamplesToDo)
 {
-    static constexpr auto &Filter = gSegmentedFilter<N>;
-    static_assert(sFftLength == Filter.sFftLength);
-    static_assert(sSegmentSize == Filter.sSampleLength);
-    static_assert(sNumSegments == Filter.sNumSegments);
+    using FilterType = SegmentedFilter<N>;
+    static_assert(sFftLength == FilterType::sFftLength);
+    static_assert(sSegmentSize == FilterType::sSampleLength);
+    static_assert(sNumSegments == FilterType::sNumSegments);
+
+    const FilterType &Filter = GetSegmentedFilter<N>();
 
     ASSUME(SamplesToDo > 0);
     ASSUME(SamplesToDo <= BufferLineSize);
@@ -404,13 +485,16 @@ void UhjEncoderIIR::encode(float *LeftOut, float *RightOut,
  * where j is a +90 degree phase shift. 3-channel UHJ excludes Q, while 2-
  * channel excludes Q and T.
  */
+template<size_t N>
+UhjDecoder<N>::UhjDecoder() { std::ignore = GetPhaseShiftFilter<N>(); }
+
 template<size_t N>
 void UhjDecoder<N>::decode(const al::span<float*> samples, const size_t samplesToDo,
     const bool updateState)
 {
     static_assert(sInputPadding <= sMaxPadding, "Filter padding is too large");
 
-    constexpr auto &PShift = PShifter<N>;
+    const auto &PShift = GetPhaseShiftFilter<N>();
 
     ASSUME(samplesToDo > 0);
     ASSUME(samplesToDo <= BufferLineSize);
@@ -440,7 +524,8 @@ void UhjDecoder<N>::decode(const al::span<float*> samples, const size_t samplesT
         [](const float d, const float t) noexcept { return 0.828331f*d + 0.767820f*t; });
     if(updateState) LIKELY
         std::copy_n(mTemp.cbegin()+samplesToDo, mDTHistory.size(), mDTHistory.begin());
-    PShift.process(xoutput, mTemp);
+    PShift.process(xoutput, al::span{mTemp}.first(samplesToDo+sInputPadding*2-1), mFftBuffer,
+        mFftAccum, mWorkData);
 
     /* W = 0.981532*S + 0.197484*j(0.828331*D + 0.767820*T) */
     std::transform(mS.begin(), mS.begin()+samplesToDo, xoutput.begin(), woutput.begin(),
@@ -455,7 +540,8 @@ void UhjDecoder<N>::decode(const al::span<float*> samples, const size_t samplesT
     std::copy_n(mS.cbegin(), samplesToDo+sInputPadding, tmpiter);
     if(updateState) LIKELY
         std::copy_n(mTemp.cbegin()+samplesToDo, mSHistory.size(), mSHistory.begin());
-    PShift.process(youtput, mTemp);
+    PShift.process(youtput, al::span{mTemp}.first(samplesToDo+sInputPadding*2-1), mFftBuffer,
+        mFftAccum, mWorkData);
 
     /* Y = 0.795968*D - 0.676392*T + j(0.186633*S) */
     for(size_t i{0};i < samplesToDo;++i)
@@ -552,13 +638,16 @@ void UhjDecoderIIR::decode(const al::span<float*> samples, const size_t samplesT
  * where j is a +90 degree phase shift. w is a variable control for the
  * resulting stereo width, with the range 0 <= w <= 0.7.
  */
+template<size_t N>
+UhjStereoDecoder<N>::UhjStereoDecoder() { std::ignore = GetPhaseShiftFilter<N>(); }
+
 template<size_t N>
 void UhjStereoDecoder<N>::decode(const al::span<float*> samples, const size_t samplesToDo,
     const bool updateState)
 {
     static_assert(sInputPadding <= sMaxPadding, "Filter padding is too large");
 
-    constexpr auto &PShift = PShifter<N>;
+    const auto &PShift = GetPhaseShiftFilter<N>();
 
     ASSUME(samplesToDo > 0);
     ASSUME(samplesToDo <= BufferLineSize);
@@ -611,7 +700,8 @@ void UhjStereoDecoder<N>::decode(const al::span<float*> samples, const size_t sa
     std::copy_n(mD.cbegin(), samplesToDo+sInputPadding, tmpiter);
     if(updateState) LIKELY
         std::copy_n(mTemp.cbegin()+samplesToDo, mDTHistory.size(), mDTHistory.begin());
-    PShift.process(xoutput, mTemp);
+    PShift.process(xoutput, al::span{mTemp}.first(samplesToDo+sInputPadding*2-1), mFftBuffer,
+        mFftAccum, mWorkData);
 
     /* W = 0.6098637*S - 0.6896511*j*w*D */
     std::transform(mS.begin(), mS.begin()+samplesToDo, xoutput.begin(), woutput.begin(),
@@ -625,7 +715,8 @@ void UhjStereoDecoder<N>::decode(const al::span<float*> samples, const size_t sa
     std::copy_n(mS.cbegin(), samplesToDo+sInputPadding, tmpiter);
     if(updateState) LIKELY
         std::copy_n(mTemp.cbegin()+samplesToDo, mSHistory.size(), mSHistory.begin());
-    PShift.process(youtput, mTemp);
+    PShift.process(youtput, al::span{mTemp}.first(samplesToDo+sInputPadding*2-1), mFftBuffer,
+        mFftAccum, mWorkData);
 
     /* Y = 1.6822415*w*D - 0.2156194*j*S */
     std::transform(mD.begin(), mD.begin()+samplesToDo, youtput.begin(), youtput.begin(),
@@ -720,3 +811,7 @@ template struct UhjStereoDecoder<UhjLength256>;
 template struct UhjEncoder<UhjLength512>;
 template struct UhjDecoder<UhjLength512>;
 template struct UhjStereoDecoder<UhjLength512>;
+
+/* The UHJ file conversion utilities use a longer filter. */
+template struct PhaseShiftFilter<2048>;
+template auto GetPhaseShiftFilter<2048>() -> const PhaseShiftFilter<2048>&;
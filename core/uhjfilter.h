@@ -7,6 +7,7 @@
 
 #include "alspan.h"
 #include "bufferline.h"
+#include "pffft.h"
 
 
 inline constexpr std::size_t UhjLength256{256};
@@ -36,6 +37,34 @@ struct UhjAllPassFilter {
 };
 
 
+/* Applies a wide-band +90 degree phase shift with an N-sample FIR filter,
+ * using FFT convolution. The filter is stateless, so the caller provides the
+ * history and look-ahead with the input, and temporary storage for the
+ * transforms. A const filter may be used from multiple threads at once.
+ */
+template<std::size_t N>
+struct PhaseShiftFilter {
+    static constexpr std::size_t sFftLength{N*2};
+    static constexpr std::size_t sBlockSize{N};
+
+    PFFFTSetup mFft;
+    alignas(16) std::array<float,sFftLength> mFilterData;
+
+    PhaseShiftFilter();
+
+    /* Applies the phase shift to src, which must hold N-1 more samples than
+     * dst. The buffers are temporary storage for the transforms.
+     */
+    void process(const al::span<float> dst, const al::span<const float> src,
+        const al::span<float,sFftLength> inout, const al::span<float,sFftLength> accum,
+        const al::span<float,sFftLength> work) const;
+};
+
+/* Returns the shared filter for the given length, generating it on first use. */
+template<std::size_t N>
+auto GetPhaseShiftFilter() -> const PhaseShiftFilter<N>&;
+
+
 struct UhjEncoderBase {
     UhjEncoderBase() = default;
     UhjEncoderBase(const UhjEncoderBase&) = delete;
@@ -80,6 +109,9 @@ struct UhjEncoder final : public UhjEncoderBase {
 
     alignas(16) std::array<std::array<float,sFilterDelay>,2> mDirectDelay{};
 
+    /* Generates the shared filter, if needed. */
+    UhjEncoder();
+
     std::size_t getDelay() noexcept override { return sFilterDelay; }
 
     /**
@@ -159,6 +191,14 @@ struct UhjDecoder final : public DecoderBase {
 
     alignas(16) std::array<float,BufferLineSize + sInputPadding*2> mTemp{};
 
+    /* Temp storage for the FFT phase shift. */
+    alignas(16) std::array<float,N*2> mFftBuffer{};
+    alignas(16) std::array<float,N*2> mFftAccum{};
+    alignas(16) std::array<float,N*2> mWorkData{};
+
+    /* Generates the shared filter, if needed. */
+    UhjDecoder();
+
     /**
      * Decodes a 3- or 4-channel UHJ signal into a B-Format signal with FuMa
      * channel ordering and UHJ scaling. For 3-channel, the 3rd channel may be
@@ -209,6 +249,14 @@ struct UhjStereoDecoder final : public DecoderBase {
 
     alignas(16) std::array<float,BufferLineSize + sInputPadding*2> mTemp{};
 
+    /* Temp storage for the FFT phase shift. */
+    alignas(16) std::array<float,N*2> mFftBuffer{};
+    alignas(16) std::array<float,N*2> mFftAccum{};
+    alignas(16) std::array<float,N*2> mWorkData{};
+
+    /* Generates the shared filter, if needed. */
+    UhjStereoDecoder();
+
     /**
      * Applies Super Stereo processing on a stereo signal to create a B-Format
      * signal with FuMa channel ordering and UHJ scaling. The samples span
@@ -10,13 +10,17 @@
 #include <climits>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 #include <iterator>
 #include <memory>
 #include <new>
 #include <optional>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "adpcm_defs.h"
 #include "alnumeric.h"
 #include "alspan.h"
 #include "alstring.h"
@@ -38,6 +42,7 @@
 #include "opthelpers.h"
 #include "resampler_limits.h"
 #include "ringbuffer.h"
+#include "tracing.h"
 #include "vector.h"
 #include "voice_change.h"
 
@@ -45,6 +50,12 @@ struct CTag;
 #ifdef HAVE_SSE
 struct SSETag;
 #endif
+#ifdef HAVE_SSE4_1
+struct SSE4Tag;
+#endif
+#ifdef HAVE_AVX2
+struct AVX2Tag;
+#endif
 #ifdef HAVE_NEON
 struct NEONTag;
 #endif
@@ -70,8 +81,17 @@ using HrtfMixerBlendFunc = void(*)(const al::span<const float> InSamples,
     const al::span<float2> AccumSamples, const uint IrSize, const HrtfFilter *oldparams,
     const MixHrtfFilter *newparams, const size_t SamplesToDo);
 
+using AdpcmLoaderFunc = void(*)(const al::span<float> dstSamples,
+    const al::span<const std::byte> src, const size_t srcChan, const size_t srcOffset,
+    const size_t srcStep, const size_t samplesPerBlock) noexcept;
+using HalfLoaderFunc = void(*)(const al::span<float> dstSamples,
+    const al::span<const std::byte> src, const size_t srcChan, const size_t srcOffset,
+    const size_t srcStep) noexcept;
+
 HrtfMixerFunc MixHrtfSamples{MixHrtf_<CTag>};
 HrtfMixerBlendFunc MixHrtfBlendSamples{MixHrtfBlend_<CTag>};
+AdpcmLoaderFunc LoadIMA4Samples{LoadIMA4_<CTag>};
+HalfLoaderFunc LoadHalfSamples{LoadHalf_<CTag>};
 
 inline MixerOutFunc SelectMixer()
 {
@@ -79,6 +99,10 @@ inline MixerOutFunc SelectMixer()
     if((CPUCapFlags&CPU_CAP_NEON))
         return Mix_<NEONTag>;
 #endif
+#ifdef HAVE_AVX2
+    if((CPUCapFlags&CPU_CAP_AVX2))
+        return Mix_<AVX2Tag>;
+#endif
 #ifdef HAVE_SSE
     if((CPUCapFlags&CPU_CAP_SSE))
         return Mix_<SSETag>;
@@ -92,6 +116,10 @@ inline MixerOneFunc SelectMixerOne()
     if((CPUCapFlags&CPU_CAP_NEON))
         return Mix_<NEONTag>;
 #endif
+#ifdef HAVE_AVX2
+    if((CPUCapFlags&CPU_CAP_AVX2))
+        return Mix_<AVX2Tag>;
+#endif
 #ifdef HAVE_SSE
     if((CPUCapFlags&CPU_CAP_SSE))
         return Mix_<SSETag>;
@@ -99,12 +127,25 @@ inline MixerOneFunc SelectMixerOne()
     return Mix_<CTag>;
 }
 
+inline MixerBatchFunc SelectBatchMixer()
+{
+#ifdef HAVE_SSE
+    if((CPUCapFlags&CPU_CAP_SSE))
+        return MixBatch_<SSETag>;
+#endif
+    return MixBatch_<CTag>;
+}
+
 inline HrtfMixerFunc SelectHrtfMixer()
 {
 #ifdef HAVE_NEON
     if((CPUCapFlags&CPU_CAP_NEON))
         return MixHrtf_<NEONTag>;
 #endif
+#ifdef HAVE_AVX2
+    if((CPUCapFlags&CPU_CAP_AVX2))
+        return MixHrtf_<AVX2Tag>;
+#endif
 #ifdef HAVE_SSE
     if((CPUCapFlags&CPU_CAP_SSE))
         return MixHrtf_<SSETag>;
@@ -118,6 +159,10 @@ inline HrtfMixerBlendFunc SelectHrtfBlendMixer()
     if((CPUCapFlags&CPU_CAP_NEON))
         return MixHrtfBlend_<NEONTag>;
 #endif
+#ifdef HAVE_AVX2
+    if((CPUCapFlags&CPU_CAP_AVX2))
+        return MixHrtfBlend_<AVX2Tag>;
+#endif
 #ifdef HAVE_SSE
     if((CPUCapFlags&CPU_CAP_SSE))
         return MixHrtfBlend_<SSETag>;
@@ -125,11 +170,37 @@ inline HrtfMixerBlendFunc SelectHrtfBlendMixer()
     return MixHrtfBlend_<CTag>;
 }
 
+inline AdpcmLoaderFunc SelectIMA4Loader()
+{
+#ifdef HAVE_SSE4_1
+    if((CPUCapFlags&CPU_CAP_SSE4_1))
+        return LoadIMA4_<SSE4Tag>;
+#endif
+    return LoadIMA4_<CTag>;
+}
+
+inline HalfLoaderFunc SelectHalfLoader()
+{
+#ifdef HAVE_NEON
+    if((CPUCapFlags&CPU_CAP_NEON))
+        return LoadHalf_<NEONTag>;
+#endif
+#ifdef HAVE_AVX2
+    if((CPUCapFlags&CPU_CAP_AVX2))
+        return LoadHalf_<AVX2Tag>;
+#endif
+    return LoadHalf_<CTag>;
+}
+
 } // namespace
 
-void Voice::InitMixer(std::optional<std::string> resopt)
+Voice::~Voice() = default;
+
+void Voice::SetDefaultResampler(const std::optional<std::string> &resopt)
 {
-    if(resopt)
+    if(!resopt)
+        ResamplerDefault.store(Resampler::Gaussian, std::memory_order_relaxed);
+    else
     {
         struct ResamplerEntry {
             const std::string_view name;
@@ -167,61 +238,26 @@ void Voice::InitMixer(std::optional<std::string> resopt)
         if(iter == ResamplerList.end())
             ERR("Invalid resampler: %s\n", resopt->c_str());
         else
-            ResamplerDefault = iter->resampler;
+            ResamplerDefault.store(iter->resampler, std::memory_order_relaxed);
     }
+}
+
+void Voice::InitMixer(const std::optional<std::string> &resopt)
+{
+    SetDefaultResampler(resopt);
 
     MixSamplesOut = SelectMixer();
     MixSamplesOne = SelectMixerOne();
+    MixSamplesBatch = SelectBatchMixer();
     MixHrtfBlendSamples = SelectHrtfBlendMixer();
     MixHrtfSamples = SelectHrtfMixer();
+    LoadIMA4Samples = SelectIMA4Loader();
+    LoadHalfSamples = SelectHalfLoader();
 }
 
 
 namespace {
 
-/* IMA ADPCM Stepsize table */
-constexpr std::array<int,89> IMAStep_size{{
-       7,    8,    9,   10,   11,   12,   13,   14,   16,   17,   19,
-      21,   23,   25,   28,   31,   34,   37,   41,   45,   50,   55,
-      60,   66,   73,   80,   88,   97,  107,  118,  130,  143,  157,
-     173,  190,  209,  230,  253,  279,  307,  337,  371,  408,  449,
-     494,  544,  598,  658,  724,  796,  876,  963, 1060, 1166, 1282,
-    1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327, 3660,
-    4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493,10442,
-   11487,12635,13899,15289,16818,18500,20350,22358,24633,27086,29794,
-   32767
-}};
-
-/* IMA4 ADPCM Codeword decode table */
-constexpr std::array<int,16> IMA4Codeword{{
-    1, 3, 5, 7, 9, 11, 13, 15,
-   -1,-3,-5,-7,-9,-11,-13,-15,
-}};
-
-/* IMA4 ADPCM Step index adjust decode table */
-constexpr std::array<int,16>IMA4Index_adjust{{
-   -1,-1,-1,-1, 2, 4, 6, 8,
-   -1,-1,-1,-1, 2, 4, 6, 8
-}};
-
-/* MSADPCM Adaption table */
-constexpr std::array<int,16> MSADPCMAdaption{{
-    230, 230, 230, 230, 307, 409, 512, 614,
-    768, 614, 512, 409, 307, 230, 230, 230
-}};
-
-/* MSADPCM Adaption Coefficient tables */
-constexpr std::array MSADPCMAdaptionCoeff{
-    std::array{256,    0},
-    std::array{512, -256},
-    std::array{  0,    0},
-    std::array{192,   64},
-    std::array{240,    0},
-    std::array{460, -208},
-    std::array{392, -232}
-};
-
-
 void SendSourceStoppedEvent(ContextBase *context, uint id)
 {
     RingBuffer *ring{context->mAsyncEvents.get()};
@@ -286,95 +322,16 @@ inline void LoadSamples(const al::span<float> dstSamples, const al::span<const s
 }
 
 template<>
-inline void LoadSamples<FmtIMA4>(al::span<float> dstSamples, al::span<const std::byte> src,
-    const size_t srcChan, const size_t srcOffset, const size_t srcStep,
-    const size_t samplesPerBlock) noexcept
-{
-    static constexpr int MaxStepIndex{static_cast<int>(IMAStep_size.size()) - 1};
-
-    assert(srcStep > 0 || srcStep <= 2);
-    assert(srcChan < srcStep);
-    assert(samplesPerBlock > 1);
-    const size_t blockBytes{((samplesPerBlock-1)/2 + 4)*srcStep};
-
-    /* Skip to the ADPCM block containing the srcOffset sample. */
-    src = src.subspan(srcOffset/samplesPerBlock*blockBytes);
-    /* Calculate how many samples need to be skipped in the block. */
-    size_t skip{srcOffset % samplesPerBlock};
-
-    /* NOTE: This could probably be optimized better. */
-    while(!dstSamples.empty())
-    {
-        auto nibbleData = src.cbegin();
-        src = src.subspan(blockBytes);
-
-        /* Each IMA4 block starts with a signed 16-bit sample, and a signed
-         * 16-bit table index. The table index needs to be clamped.
-         */
-        int sample{int(nibbleData[srcChan*4]) | (int(nibbleData[srcChan*4 + 1]) << 8)};
-        int index{int(nibbleData[srcChan*4 + 2]) | (int(nibbleData[srcChan*4 + 3]) << 8)};
-        nibbleData += ptrdiff_t((srcStep+srcChan)*4);
-
-        sample = (sample^0x8000) - 32768;
-        index = std::clamp((index^0x8000) - 32768, 0, MaxStepIndex);
+inline void LoadSamples<FmtIMA4>(const al::span<float> dstSamples,
+    const al::span<const std::byte> src, const size_t srcChan, const size_t srcOffset,
+    const size_t srcStep, const size_t samplesPerBlock) noexcept
+{ LoadIMA4Samples(dstSamples, src, srcChan, srcOffset, srcStep, samplesPerBlock); }
 
-        if(skip == 0)
-        {
-            dstSamples[0] = static_cast<float>(sample) / 32768.0f;
-            dstSamples = dstSamples.subspan<1>();
-            if(dstSamples.empty()) return;
-        }
-        else
-            --skip;
-
-        auto decode_sample = [&sample,&index](const uint nibble)
-        {
-            sample += IMA4Codeword[nibble] * IMAStep_size[static_cast<uint>(index)] / 8;
-            sample = std::clamp(sample, -32768, 32767);
-
-            index += IMA4Index_adjust[nibble];
-            index = std::clamp(index, 0, MaxStepIndex);
-
-            return sample;
-        };
-
-        /* The rest of the block is arranged as a series of nibbles, contained
-         * in 4 *bytes* per channel interleaved. So every 8 nibbles we need to
-         * skip 4 bytes per channel to get the next nibbles for this channel.
-         *
-         * First, decode the samples that we need to skip in the block (will
-         * always be less than the block size). They need to be decoded despite
-         * being ignored for proper state on the remaining samples.
-         */
-        size_t nibbleOffset{0};
-        const size_t startOffset{skip + 1};
-        for(;skip;--skip)
-        {
-            const size_t byteShift{(nibbleOffset&1) * 4};
-            const size_t wordOffset{(nibbleOffset>>1) & ~3_uz};
-            const size_t byteOffset{wordOffset*srcStep + ((nibbleOffset>>1)&3u)};
-            ++nibbleOffset;
-
-            std::ignore = decode_sample(uint(nibbleData[byteOffset]>>byteShift) & 15u);
-        }
-
-        /* Second, decode the rest of the block and write to the output, until
-         * the end of the block or the end of output.
-         */
-        const size_t todo{std::min(samplesPerBlock-startOffset, dstSamples.size())};
-        std::generate_n(dstSamples.begin(), todo, [&]
-        {
-            const size_t byteShift{(nibbleOffset&1) * 4};
-            const size_t wordOffset{(nibbleOffset>>1) & ~3_uz};
-            const size_t byteOffset{wordOffset*srcStep + ((nibbleOffset>>1)&3u)};
-            ++nibbleOffset;
-
-            const int result{decode_sample(uint(nibbleData[byteOffset]>>byteShift) & 15u)};
-            return static_cast<float>(result) / 32768.0f;
-        });
-        dstSamples = dstSamples.subspan(todo);
-    }
-}
+template<>
+inline void LoadSamples<FmtHalf>(const al::span<float> dstSamples,
+    const al::span<const std::byte> src, const size_t srcChan, const size_t srcOffset,
+    const size_t srcStep, const size_t) noexcept
+{ LoadHalfSamples(dstSamples, src, srcChan, srcOffset, srcStep); }
 
 template<>
 inline void LoadSamples<FmtMSADPCM>(al::span<float> dstSamples, al::span<const std::byte> src,
@@ -484,6 +441,80 @@ inline void LoadSamples<FmtMSADPCM>(al::span<float> dstSamples, al::span<const s
     }
 }
 
+template<>
+inline void LoadSamples<FmtIMA2>(al::span<float> dstSamples, al::span<const std::byte> src,
+    const size_t srcChan, const size_t srcOffset, const size_t srcStep,
+    const size_t samplesPerBlock) noexcept
+{
+    static constexpr int MaxStepIndex{static_cast<int>(IMAStep_size.size()) - 1};
+
+    assert(srcStep > 0 || srcStep <= 2);
+    assert(srcChan < srcStep);
+    assert(samplesPerBlock > 1);
+    const size_t blockBytes{((samplesPerBlock-1)/4 + 4)*srcStep};
+
+    /* Blocks decode independently, so start at the one holding srcOffset and
+     * only decode through the samples skipped in it.
+     */
+    src = src.subspan(srcOffset/samplesPerBlock*blockBytes);
+    size_t skip{srcOffset % samplesPerBlock};
+
+    while(!dstSamples.empty())
+    {
+        auto codeData = src.cbegin();
+        src = src.subspan(blockBytes);
+
+        /* Each IMA2 block starts with the same header as IMA4, a signed 16-bit
+         * sample and a signed 16-bit table index.
+         */
+        int sample{int(codeData[srcChan*4]) | (int(codeData[srcChan*4 + 1]) << 8)};
+        int index{int(codeData[srcChan*4 + 2]) | (int(codeData[srcChan*4 + 3]) << 8)};
+        codeData += ptrdiff_t((srcStep+srcChan)*4);
+
+        sample = (sample^0x8000) - 32768;
+        index = std::clamp((index^0x8000) - 32768, 0, MaxStepIndex);
+
+        if(skip == 0)
+        {
+            dstSamples[0] = static_cast<float>(sample) / 32768.0f;
+            dstSamples = dstSamples.subspan<1>();
+            if(dstSamples.empty()) return;
+        }
+        else
+            --skip;
+
+        /* The rest of the block is 2-bit codes packed low bits first, in 4
+         * bytes (16 codes) per channel interleaved.
+         */
+        size_t codeOffset{0};
+        auto decode_sample = [&sample,&index,&codeOffset,codeData,srcStep]
+        {
+            const size_t wordOffset{(codeOffset>>2) & ~3_uz};
+            const size_t byteOffset{wordOffset*srcStep + ((codeOffset>>2)&3u)};
+            const size_t byteShift{(codeOffset&3) * 2};
+            ++codeOffset;
+
+            const uint code{uint(codeData[byteOffset]>>byteShift) & 3u};
+            sample += IMA2Codeword[code] * IMAStep_size[static_cast<uint>(index)] / 2;
+            sample = std::clamp(sample, -32768, 32767);
+
+            index += IMA2Index_adjust[code];
+            index = std::clamp(index, 0, MaxStepIndex);
+
+            return sample;
+        };
+
+        const size_t startOffset{skip + 1};
+        for(;skip;--skip)
+            std::ignore = decode_sample();
+
+        const size_t todo{std::min(samplesPerBlock-startOffset, dstSamples.size())};
+        std::generate_n(dstSamples.begin(), todo, [&decode_sample]
+        { return static_cast<float>(decode_sample()) / 32768.0f; });
+        dstSamples = dstSamples.subspan(todo);
+    }
+}
+
 void LoadSamples(const al::span<float> dstSamples, const al::span<const std::byte> src,
     const size_t srcChan, const size_t srcOffset, const FmtType srcType, const size_t srcStep,
     const size_t samplesPerBlock) noexcept
@@ -504,6 +535,8 @@ void LoadSamples(const al::span<float> dstSamples, const al::span<const std::byt
     HANDLE_FMT(FmtAlaw);
     HANDLE_FMT(FmtIMA4);
     HANDLE_FMT(FmtMSADPCM);
+    HANDLE_FMT(FmtIMA2);
+    HANDLE_FMT(FmtHalf);
     }
 #undef HANDLE_FMT
 }
@@ -606,23 +639,50 @@ void LoadBufferQueue(VoiceBufferItem *buffer, VoiceBufferItem *bufferLoopItem,
         std::fill_n(voiceSamples.begin(), toFill, lastSample);
 }
 
+/* Gets the samples for resampling straight out of a mono float buffer. This
+ * is only possible if the read window, including the resampler history, is
+ * within a contiguous part of the buffer and the history matches what the
+ * voice has. Otherwise, an empty span is returned and the samples need to be
+ * loaded.
+ */
+al::span<const float> GetDirectSamples(const VoiceBufferItem *buffer, const bool isLooping,
+    const int intPos, const size_t srcSize, const al::span<const float> history)
+{
+    if(intPos < int{MaxResamplerEdge})
+        return {};
+
+    const auto pos = static_cast<uint>(intPos);
+    const size_t end{isLooping ? buffer->mLoopEnd : buffer->mSampleLen};
+    if(pos >= end || srcSize > end-pos)
+        return {};
+
+    const auto samples = al::span{reinterpret_cast<const float*>(buffer->mSamples.data()),
+        buffer->mSamples.size()/sizeof(float)};
+    const auto window = samples.subspan(pos - MaxResamplerEdge, MaxResamplerEdge + srcSize);
+    if(std::memcmp(window.data(), history.data(), history.size_bytes()) != 0)
+        return {};
+    return window;
+}
+
 
 void DoHrtfMix(const al::span<const float> samples, DirectParams &parms, const float TargetGain,
-    const size_t Counter, size_t OutPos, const bool IsPlaying, DeviceBase *Device)
+    const size_t Counter, size_t OutPos, const bool IsPlaying, DeviceBase *Device,
+    MixerScratch &scratch)
 {
     const uint IrSize{Device->mIrSize};
-    const auto HrtfSamples = al::span{Device->ExtraSampleData};
-    const auto AccumSamples = al::span{Device->HrtfAccumData};
+    DirectParams::HrtfParams &hrtf = *parms.Hrtf;
+    const auto HrtfSamples = al::span{scratch.ExtraSampleData};
+    const auto AccumSamples = scratch.mHrtfAccum;
 
     /* Copy the HRTF history and new input samples into a temp buffer. */
-    auto src_iter = std::copy(parms.Hrtf.History.begin(), parms.Hrtf.History.end(),
+    auto src_iter = std::copy(hrtf.History.begin(), hrtf.History.end(),
         HrtfSamples.begin());
     std::copy_n(samples.begin(), samples.size(), src_iter);
     /* Copy the last used samples back into the history buffer for later. */
     if(IsPlaying) LIKELY
     {
-        const auto endsamples = HrtfSamples.subspan(samples.size(), parms.Hrtf.History.size());
-        std::copy_n(endsamples.cbegin(), endsamples.size(), parms.Hrtf.History.begin());
+        const auto endsamples = HrtfSamples.subspan(samples.size(), hrtf.History.size());
+        std::copy_n(endsamples.cbegin(), endsamples.size(), hrtf.History.begin());
     }
 
     /* If fading and this is the first mixing pass, fade between the IRs. */
@@ -641,19 +701,19 @@ void DoHrtfMix(const al::span<const float> samples, DirectParams &parms, const f
         if(Counter > fademix)
         {
             const float a{static_cast<float>(fademix) / static_cast<float>(Counter)};
-            gain = lerpf(parms.Hrtf.Old.Gain, TargetGain, a);
+            gain = lerpf(hrtf.Old.Gain, TargetGain, a);
         }
 
         MixHrtfFilter hrtfparams{
-            parms.Hrtf.Target.Coeffs,
-            parms.Hrtf.Target.Delay,
+            hrtf.Target.Coeffs,
+            hrtf.Target.Delay,
             0.0f, gain / static_cast<float>(fademix)};
-        MixHrtfBlendSamples(HrtfSamples, AccumSamples.subspan(OutPos), IrSize, &parms.Hrtf.Old,
+        MixHrtfBlendSamples(HrtfSamples, AccumSamples.subspan(OutPos), IrSize, &hrtf.Old,
             &hrtfparams, fademix);
 
         /* Update the old parameters with the result. */
-        parms.Hrtf.Old = parms.Hrtf.Target;
-        parms.Hrtf.Old.Gain = gain;
+        hrtf.Old = hrtf.Target;
+        hrtf.Old.Gain = gain;
         OutPos += fademix;
     }
 
@@ -668,63 +728,211 @@ void DoHrtfMix(const al::span<const float> samples, DirectParams &parms, const f
         if(Counter > samples.size())
         {
             const float a{static_cast<float>(todo) / static_cast<float>(Counter-fademix)};
-            gain = lerpf(parms.Hrtf.Old.Gain, TargetGain, a);
+            gain = lerpf(hrtf.Old.Gain, TargetGain, a);
         }
 
         MixHrtfFilter hrtfparams{
-            parms.Hrtf.Target.Coeffs,
-            parms.Hrtf.Target.Delay,
-            parms.Hrtf.Old.Gain,
-            (gain - parms.Hrtf.Old.Gain) / static_cast<float>(todo)};
+            hrtf.Target.Coeffs,
+            hrtf.Target.Delay,
+            hrtf.Old.Gain,
+            (gain - hrtf.Old.Gain) / static_cast<float>(todo)};
         MixHrtfSamples(HrtfSamples.subspan(fademix), AccumSamples.subspan(OutPos), IrSize,
             &hrtfparams, todo);
 
         /* Store the now-current gain for next time. */
-        parms.Hrtf.Old.Gain = gain;
+        hrtf.Old.Gain = gain;
     }
 }
 
 void DoNfcMix(const al::span<const float> samples, al::span<FloatBufferLine> OutBuffer,
-    DirectParams &parms, const al::span<const float,MaxOutputChannels> OutGains,
-    const uint Counter, const uint OutPos, DeviceBase *Device)
+    DirectParams &parms, const al::span<const float> OutGains,
+    const uint Counter, const uint OutPos, DeviceBase *Device, MixerScratch &scratch)
 {
-    using FilterProc = void (NfcFilter::*)(const al::span<const float>, const al::span<float>);
-    static constexpr std::array<FilterProc,MaxAmbiOrder+1> NfcProcess{{
-        nullptr, &NfcFilter::process1, &NfcFilter::process2, &NfcFilter::process3}};
-
-    auto CurrentGains = al::span{parms.Gains.Current}.subspan(0);
-    auto TargetGains = OutGains.subspan(0);
+    auto CurrentGains = parms.Gains.Current;
+    auto TargetGains = OutGains;
     MixSamples(samples, OutBuffer.first(1), CurrentGains, TargetGains, Counter, OutPos);
     OutBuffer = OutBuffer.subspan(1);
     CurrentGains = CurrentGains.subspan(1);
     TargetGains = TargetGains.subspan(1);
 
-    const auto nfcsamples = al::span{Device->ExtraSampleData}.subspan(samples.size());
-    size_t order{1};
-    while(const size_t chancount{Device->NumChannelsPerOrder[order]})
+    /* Filter the samples for all the used orders together, then mix each
+     * order's result to its channels.
+     */
+    std::array<al::span<float>,MaxAmbiOrder> nfcsamples{};
+    size_t numorders{0};
+    while(numorders < MaxAmbiOrder && Device->NumChannelsPerOrder[numorders+1] > 0)
     {
-        (parms.NFCtrlFilter.*NfcProcess[order])(samples, nfcsamples);
-        MixSamples(nfcsamples, OutBuffer.first(chancount), CurrentGains, TargetGains, Counter,
-            OutPos);
+        nfcsamples[numorders] = al::span{scratch.NfcSampleData[numorders]}.first(samples.size());
+        ++numorders;
+    }
+    parms.NFCtrlFilter.processOrders(samples, al::span{nfcsamples}.first(numorders));
+
+    for(size_t order{1};order <= numorders;++order)
+    {
+        const size_t chancount{Device->NumChannelsPerOrder[order]};
+        MixSamples(nfcsamples[order-1], OutBuffer.first(chancount), CurrentGains, TargetGains,
+            Counter, OutPos);
         OutBuffer = OutBuffer.subspan(chancount);
         CurrentGains = CurrentGains.subspan(chancount);
         TargetGains = TargetGains.subspan(chancount);
-        if(++order == MaxAmbiOrder+1)
-            break;
     }
 }
 
+/* Adds the time taken to mix a voice to the device's profile on leaving scope,
+ * attributing it to the HRTF or NFC filters if the voice used them.
+ */
+class VoiceProfileScope {
+    MixerProfile *mProfile;
+    const Voice &mVoice;
+    steady_clock::time_point mStart;
+
+public:
+    VoiceProfileScope(MixerProfile *profile, const Voice &voice) noexcept
+        : mProfile{profile}, mVoice{voice}
+        , mStart{profile ? steady_clock::now() : steady_clock::time_point{}}
+    { }
+    ~VoiceProfileScope()
+    {
+        if(!mProfile) LIKELY return;
+
+        const auto duration = duration_cast<nanoseconds>(steady_clock::now() - mStart);
+        mProfile->add(MixerProfile::VoiceTime, duration);
+        if(mVoice.mFlags.test(VoiceHasHrtf))
+            mProfile->add(MixerProfile::HrtfVoiceTime, duration);
+        else if(mVoice.mFlags.test(VoiceHasNfc))
+            mProfile->add(MixerProfile::NfcVoiceTime, duration);
+        const bool culled{mVoice.mFlags.test(VoiceIsCulled)
+            || mVoice.mFlags.test(VoiceIsVirtual)};
+        mProfile->add(culled ? MixerProfile::CulledVoices : MixerProfile::ActiveVoices, 1u);
+    }
+
+    VoiceProfileScope(const VoiceProfileScope&) = delete;
+    VoiceProfileScope& operator=(const VoiceProfileScope&) = delete;
+};
+
+/* Creates a UHJ decoder of the given quality, along with the number of input
+ * samples it needs past the ones being decoded.
+ */
+auto CreateUhjDecoder(const UhjQualityType quality) -> std::pair<std::unique_ptr<DecoderBase>,uint>
+{
+    switch(quality)
+    {
+    case UhjQualityType::IIR:
+        return {std::make_unique<UhjDecoderIIR>(), uint{UhjDecoderIIR::sInputPadding}};
+    case UhjQualityType::FIR256:
+        return {std::make_unique<UhjDecoder<UhjLength256>>(),
+            uint{UhjDecoder<UhjLength256>::sInputPadding}};
+    case UhjQualityType::FIR512:
+        return {std::make_unique<UhjDecoder<UhjLength512>>(),
+            uint{UhjDecoder<UhjLength512>::sInputPadding}};
+    }
+    return {};
+}
+
 } // namespace
 
-void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds deviceTime,
-    const uint SamplesToDo)
+void DecodeSamples(const al::span<int16_t> dst, const al::span<const std::byte> src,
+    const FmtType srcType, const uint numChannels, const uint samplesPerBlock) noexcept
+{
+    ASSUME(numChannels > 0);
+    ASSUME(samplesPerBlock > 0);
+
+    /* Decode whole blocks at a time where possible, so the ADPCM decoders
+     * don't have to redecode skipped samples.
+     */
+    const size_t chunkSize{(samplesPerBlock <= BufferLineSize)
+        ? BufferLineSize/samplesPerBlock*samplesPerBlock : BufferLineSize};
+    const size_t numFrames{dst.size() / numChannels};
+
+    std::array<float,BufferLineSize> samples{};
+    for(size_t pos{0};pos < numFrames;pos += chunkSize)
+    {
+        const auto todo = std::min(chunkSize, numFrames-pos);
+        const auto chunk = al::span{samples}.first(todo);
+        for(size_t chan{0};chan < numChannels;++chan)
+        {
+            LoadSamples(chunk, src, chan, pos, srcType, numChannels, samplesPerBlock);
+
+            /* All of the decoded values originate as 16-bit integers, so
+             * scaling back is exact.
+             */
+            auto output = dst.begin() + ptrdiff_t(pos*numChannels + chan);
+            for(const float sample : chunk)
+            {
+                *output = static_cast<int16_t>(sample * 32768.0f);
+                output += ptrdiff_t(numChannels);
+            }
+        }
+    }
+}
+
+void DecodeUhjSamples(const al::span<float> dst, const al::span<const std::byte> src,
+    const FmtChannels srcChannels, const FmtType srcType, const uint samplesPerBlock,
+    const UhjQualityType quality)
+{
+    const uint numInChans{ChannelsFromFmt(srcChannels, 1)};
+    const uint numOutChans{std::max(numInChans, 3u)};
+    const size_t numFrames{dst.size() / numOutChans};
+    auto [decoder, padding] = CreateUhjDecoder(quality);
+
+    /* Each pass decodes up to a line of samples, with the decoder's padding
+     * loaded after it. Like a non-looping voice, anything past the end of
+     * the buffer repeats the last sample.
+     */
+    using LineType = std::array<float,BufferLineSize+DecoderBase::sMaxPadding>;
+    auto lines = al::vector<LineType,16>(numOutChans);
+    auto linePtrs = std::array<float*,4>{};
+    std::transform(lines.begin(), lines.end(), linePtrs.begin(),
+        [](LineType &line) noexcept { return line.data(); });
+    const auto samples = al::span{linePtrs}.first(numOutChans);
+
+    for(size_t pos{0};pos < numFrames;pos += BufferLineSize)
+    {
+        const size_t todo{std::min(size_t{BufferLineSize}, numFrames-pos)};
+        const size_t toload{std::min(todo+padding, numFrames-pos)};
+        for(uint chan{0};chan < numOutChans;++chan)
+        {
+            const auto line = al::span{lines[chan]};
+            size_t loaded{0};
+            float lastSample{0.0f};
+            if(chan < numInChans)
+            {
+                LoadSamples(line.first(toload), src, chan, pos, srcType, numInChans,
+                    samplesPerBlock);
+                loaded = toload;
+                lastSample = line[toload-1];
+            }
+            std::fill(line.begin()+ptrdiff_t(loaded), line.end(), lastSample);
+        }
+
+        decoder->decode(samples, todo, true);
+
+        for(uint chan{0};chan < numOutChans;++chan)
+        {
+            auto output = dst.begin() + ptrdiff_t(pos*numOutChans + chan);
+            for(const float sample : al::span{lines[chan]}.first(todo))
+            {
+                *output = sample;
+                output += ptrdiff_t(numOutChans);
+            }
+        }
+    }
+}
+
+template<Voice::BufferMode BufMode, Voice::OutputMode OutMode>
+void Voice::mixWith(const State vstate, ContextBase *Context, const nanoseconds deviceTime,
+    const uint SamplesToDo, MixerScratch &scratch)
 {
+    const VoiceProfileScope profileScope{Context->mDevice->mProfile.get(), *this};
+    TRACE_SPAN("Voice", mSourceID.load(std::memory_order_relaxed));
+
     static constexpr std::array<float,MaxOutputChannels> SilentTarget{};
 
     ASSUME(SamplesToDo > 0);
 
     DeviceBase *Device{Context->mDevice};
     const uint NumSends{Device->NumAuxSends};
+    const uint NumListeners{Device->NumListeners-1};
 
     /* Get voice info */
     int DataPosInt{mPosition.load(std::memory_order_relaxed)};
@@ -745,11 +953,47 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
     /* If the static voice's current position is beyond the buffer loop end
      * position, disable looping.
      */
-    if(mFlags.test(VoiceIsStatic) && BufferLoopItem)
+    auto get_loop_item = [this,BufferLoopItem](const int posInt, const VoiceBufferItem *item)
     {
-        if(DataPosInt >= 0 && static_cast<uint>(DataPosInt) >= BufferListItem->mLoopEnd)
-            BufferLoopItem = nullptr;
+        if(BufMode == BufferMode::Static && BufferLoopItem)
+        {
+            if(posInt >= 0 && static_cast<uint>(posInt) >= item->mLoopEnd)
+                return static_cast<VoiceBufferItem*>(nullptr);
+        }
+        return BufferLoopItem;
+    };
+
+    /* Take any pending seek. A voice that's playing this update crossfades
+     * from its current position to the new one, otherwise it just moves.
+     */
+    int FadePosInt{};
+    uint FadePosFrac{};
+    VoiceBufferItem *FadeBufferItem{};
+    VoiceBufferItem *FadeLoopItem{};
+    bool seekFade{false};
+    if(mSeekTarget) UNLIKELY
+    {
+        const SeekTarget target{*mSeekTarget};
+        mSeekTarget.reset();
+
+        if(vstate == Playing && mStartTime <= deviceTime && !mFlags.test(VoiceIsCulled)
+            && !mFlags.test(VoiceIsVirtual))
+        {
+            FadePosInt = DataPosInt;
+            FadePosFrac = DataPosFrac;
+            FadeBufferItem = BufferListItem;
+            FadeLoopItem = BufferListItem ? get_loop_item(DataPosInt, BufferListItem) : nullptr;
+            seekFade = true;
+        }
+        else
+            setPosition(target);
+
+        DataPosInt = target.mPosition;
+        DataPosFrac = target.mPositionFrac;
+        BufferListItem = target.mBuffer;
     }
+    if(BufferListItem)
+        BufferLoopItem = get_loop_item(DataPosInt, BufferListItem);
 
     uint OutPos{0u};
 
@@ -778,7 +1022,7 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
          * This makes the start time accurate to 4 samples. This could be made
          * sample-accurate by forcing non-SIMD functions on the first run.
          */
-        seconds::rep sampleOffset{duration_cast<seconds>(diff * Device->Frequency).count()};
+        seconds::rep sampleOffset{duration_cast<seconds>(diff * Device->mMixFrequency).count()};
         sampleOffset = (sampleOffset+2) & ~seconds::rep{3};
         if(sampleOffset >= SamplesToDo)
             return;
@@ -792,6 +1036,36 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
     const uint samplesToMix{SamplesToDo - OutPos};
     const uint samplesToLoad{samplesToMix + mDecoderPadding};
 
+    if(mFlags.test(VoiceIsCulled) || mFlags.test(VoiceIsVirtual)) UNLIKELY
+    {
+        /* A culled or virtual voice isn't heard, so skip straight to updating
+         * its position. Clear the current gains so it fades back in when it's
+         * mixed again.
+         */
+        for(auto &chandata : mChans)
+        {
+            DirectParams &dryparms = chandata.mDryParams;
+            std::fill(dryparms.Gains.Current.begin(), dryparms.Gains.Current.end(), 0.0f);
+            if(dryparms.Hrtf)
+                dryparms.Hrtf->Old.Gain = 0.0f;
+            for(auto &parms : al::span{chandata.mWetParams}.first(NumSends))
+                std::fill(parms.Gains.Current.begin(), parms.Gains.Current.end(), 0.0f);
+            for(auto &parms : al::span{chandata.mListenerParams}.first(NumListeners))
+                std::fill(parms.Gains.Current.begin(), parms.Gains.Current.end(), 0.0f);
+        }
+        mFlags.set(VoiceIsFading);
+
+        if(vstate == Stopping)
+        {
+            mPlayState.store(Stopped, std::memory_order_release);
+            return;
+        }
+        advance(Context, DataPosInt, DataPosFrac, BufferListItem, BufferLoopItem, increment,
+            samplesToMix, deviceTime + nanoseconds{seconds{SamplesToDo}}/Device->mMixFrequency,
+            scratch);
+        return;
+    }
+
     /* Get a span of pointers to hold the floating point, deinterlaced,
      * resampled buffer data to be mixed.
      */
@@ -799,7 +1073,7 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
     const auto MixingSamples = al::span{SamplePointers}.first(mChans.size());
     {
         const uint channelStep{(samplesToLoad+3u)&~3u};
-        auto base = Device->mSampleData.end() - MixingSamples.size()*channelStep;
+        auto base = scratch.mSampleData.end() - MixingSamples.size()*channelStep;
         std::generate(MixingSamples.begin(), MixingSamples.end(), [&base,channelStep]
         {
             const auto ret = base;
@@ -809,27 +1083,91 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
     }
 
     /* UHJ2 and SuperStereo only have 2 buffer channels, but 3 mixing channels
-     * (3rd channel is generated from decoding). MonoDup only has 1 buffer
-     * channel, but 2 mixing channels (2nd channel is just duplicated).
+     * (3rd channel is generated from decoding), unless the buffer was already
+     * decoded. MonoDup only has 1 buffer channel, but 2 mixing channels (2nd
+     * channel is just duplicated).
      */
     const size_t realChannels{(mFmtChannels == FmtMonoDup) ? 1u
-        : (mFmtChannels == FmtUHJ2 || mFmtChannels == FmtSuperStereo) ? 2u
+        : (mFmtChannels == FmtUHJ2 || mFmtChannels == FmtSuperStereo) && mDecoder ? 2u
         : MixingSamples.size()};
-    for(size_t chan{0};chan < realChannels;++chan)
+    /* Mono float samples don't need converting or deinterleaving, so they can
+     * often be resampled directly from the buffer.
+     */
+    const bool directLoad{BufMode != BufferMode::Callback && mFmtType == FmtFloat
+        && mFrameStep == 1};
+
+    /* An instancing voice that plays the same samples from the same state as
+     * the last instancing voice mixed can reuse its resampled samples. Voices
+     * that modify the samples in place after loading can't share them.
+     */
+    const bool canInstance{mProps.Instancing && vstate == Playing && BufferListItem
+        && BufMode != BufferMode::Callback && !seekFade && !mDecoder
+        && !mFlags.test(VoiceIsAmbisonic)};
+    auto match_instance = [&]() -> bool
+    {
+        const MixerScratch::InstanceState &inst = scratch.mInstance;
+        if(inst.mDeviceTime != deviceTime || inst.mBufferItem != BufferListItem
+            || inst.mLoopItem != BufferLoopItem || inst.mPosInt != DataPosInt
+            || inst.mPosFrac != DataPosFrac || inst.mOutPos != OutPos
+            || inst.mSamplesToLoad != samplesToLoad)
+            return false;
+
+        const Voice &leader = *scratch.mInstanceVoice;
+        if(leader.mStep != increment || leader.mResampler != mResampler
+            || leader.mProps.mResampler != mProps.mResampler
+            || leader.mFmtChannels != mFmtChannels || leader.mFmtType != mFmtType
+            || leader.mFrameStep != mFrameStep || leader.mChans.size() != mChans.size()
+            || leader.mMixFunc != mMixFunc)
+            return false;
+        return std::equal(mPrevSamples.cbegin(), mPrevSamples.cbegin()+ptrdiff_t(realChannels),
+            inst.mHistory.cbegin());
+    };
+    const bool reuseInstance{canInstance && scratch.mInstanceVoice && match_instance()};
+    if(reuseInstance)
+    {
+        /* The resampled samples are already in place. Just take the sample
+         * history the other voice stored for next time.
+         */
+        std::copy_n(scratch.mInstanceVoice->mPrevSamples.cbegin(), realChannels,
+            mPrevSamples.begin());
+    }
+    else if(canInstance)
     {
-        static constexpr uint ResBufSize{std::tuple_size_v<decltype(DeviceBase::mResampleData)>};
+        MixerScratch::InstanceState &inst = scratch.mInstance;
+        inst.mDeviceTime = deviceTime;
+        inst.mBufferItem = BufferListItem;
+        inst.mLoopItem = BufferLoopItem;
+        inst.mPosInt = DataPosInt;
+        inst.mPosFrac = DataPosFrac;
+        inst.mOutPos = OutPos;
+        inst.mSamplesToLoad = samplesToLoad;
+        std::copy_n(mPrevSamples.cbegin(), realChannels, inst.mHistory.begin());
+        scratch.mInstanceVoice = this;
+    }
+    else
+        scratch.mInstanceVoice = nullptr;
+
+    /* Loads and resamples the given number of samples for a channel, from
+     * the given position. The sample history for the end of the mix is only
+     * stored when asked.
+     */
+    auto load_channel = [&,this](const size_t chan, float *dst, const uint count, int posInt,
+        uint posFrac, VoiceBufferItem *bufferItem, VoiceBufferItem *loopItem,
+        const bool storeHistory)
+    {
+        static constexpr uint ResBufSize{std::tuple_size_v<decltype(MixerScratch::mResampleData)>};
         static constexpr uint srcSizeMax{ResBufSize - MaxResamplerEdge};
 
         const al::span prevSamples{mPrevSamples[chan]};
-        std::copy(prevSamples.cbegin(), prevSamples.cend(), Device->mResampleData.begin());
-        const auto resampleBuffer = al::span{Device->mResampleData}.subspan<MaxResamplerEdge>();
-        int intPos{DataPosInt};
-        uint fracPos{DataPosFrac};
+        std::copy(prevSamples.cbegin(), prevSamples.cend(), scratch.mResampleData.begin());
+        const auto resampleBuffer = al::span{scratch.mResampleData}.subspan<MaxResamplerEdge>();
+        int intPos{posInt};
+        uint fracPos{posFrac};
 
         /* Load samples for this channel from the available buffer(s), with
          * resampling.
          */
-        for(uint samplesLoaded{0};samplesLoaded < samplesToLoad;)
+        for(uint samplesLoaded{0};samplesLoaded < count;)
         {
             /* Calculate the number of dst samples that can be loaded this
              * iteration, given the available resampler buffer size, and the
@@ -872,8 +1210,9 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
                 return std::make_pair(dstBufferSize, srcSizeMax);
             };
             const auto [dstBufferSize, srcBufferSize] = calc_buffer_sizes(
-                samplesToLoad - samplesLoaded);
+                count - samplesLoaded);
 
+            al::span<const float> srcSamples{scratch.mResampleData};
             size_t srcSampleDelay{0};
             if(intPos < 0) UNLIKELY
             {
@@ -886,7 +1225,7 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
                     /* If the number of silent source samples exceeds the
                      * number to load, the output will be silent.
                      */
-                    std::fill_n(MixingSamples[chan]+samplesLoaded, dstBufferSize, 0.0f);
+                    std::fill_n(dst+samplesLoaded, dstBufferSize, 0.0f);
                     std::fill_n(resampleBuffer.begin(), srcBufferSize, 0.0f);
                     goto skip_resample;
                 }
@@ -895,7 +1234,18 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
             }
 
             /* Load the necessary samples from the given buffer(s). */
-            if(!BufferListItem) UNLIKELY
+            if(directLoad && bufferItem && srcSampleDelay == 0)
+            {
+                const bool isLooping{BufMode == BufferMode::Static && loopItem};
+                if(auto direct = GetDirectSamples(bufferItem, isLooping, intPos,
+                    srcBufferSize, al::span{scratch.mResampleData}.first<MaxResamplerEdge>());
+                    !direct.empty())
+                {
+                    srcSamples = direct;
+                    goto resample;
+                }
+            }
+            if(!bufferItem) UNLIKELY
             {
                 const uint avail{std::min(srcBufferSize, MaxResamplerEdge)};
                 const uint tofill{std::max(srcBufferSize, MaxResamplerEdge)};
@@ -910,28 +1260,36 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
 
                 std::fill(srciter+1, srcbuf.end(), *srciter);
             }
-            else if(mFlags.test(VoiceIsStatic))
+            else if constexpr(BufMode == BufferMode::Static)
             {
                 const auto uintPos = static_cast<uint>(std::max(intPos, 0));
                 const auto bufferSamples = resampleBuffer.subspan(srcSampleDelay,
                     srcBufferSize-srcSampleDelay);
-                LoadBufferStatic(BufferListItem, BufferLoopItem, uintPos, mFmtType, chan,
+                LoadBufferStatic(bufferItem, loopItem, uintPos, mFmtType, chan,
                     mFrameStep, bufferSamples);
             }
-            else if(mFlags.test(VoiceIsCallback))
+            else if constexpr(BufMode == BufferMode::Callback)
             {
                 const auto uintPos = static_cast<uint>(std::max(intPos, 0));
                 const uint callbackBase{mCallbackBlockBase * mSamplesPerBlock};
                 const size_t bufferOffset{uintPos - callbackBase};
                 const size_t needSamples{bufferOffset + srcBufferSize - srcSampleDelay};
-                const size_t needBlocks{(needSamples + mSamplesPerBlock-1) / mSamplesPerBlock};
+                size_t needBlocks{(needSamples + mSamplesPerBlock-1) / mSamplesPerBlock};
                 if(!mFlags.test(VoiceCallbackStopped) && needBlocks > mNumCallbackBlocks)
                 {
+                    /* Ask for at least the buffer's request size at once, as
+                     * far as the storage allows, so the callback is called
+                     * less often.
+                     */
+                    const size_t maxBlocks{bufferItem->mSamples.size() / mBytesPerBlock};
+                    needBlocks = std::max(needBlocks, std::min(maxBlocks,
+                        size_t{mNumCallbackBlocks} + bufferItem->mCallbackRequest));
+
                     const size_t byteOffset{mNumCallbackBlocks*size_t{mBytesPerBlock}};
                     const size_t needBytes{(needBlocks-mNumCallbackBlocks)*size_t{mBytesPerBlock}};
 
-                    const int gotBytes{BufferListItem->mCallback(BufferListItem->mUserData,
-                        &BufferListItem->mSamples[byteOffset], static_cast<int>(needBytes))};
+                    const int gotBytes{bufferItem->mCallback(bufferItem->mUserData,
+                        &bufferItem->mSamples[byteOffset], static_cast<int>(needBytes))};
                     if(gotBytes < 0)
                         mFlags.set(VoiceCallbackStopped);
                     else if(static_cast<uint>(gotBytes) < needBytes)
@@ -945,7 +1303,7 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
                 const size_t numSamples{size_t{mNumCallbackBlocks} * mSamplesPerBlock};
                 const auto bufferSamples = resampleBuffer.subspan(srcSampleDelay,
                     srcBufferSize-srcSampleDelay);
-                LoadBufferCallback(BufferListItem, bufferOffset, numSamples, mFmtType, chan,
+                LoadBufferCallback(bufferItem, bufferOffset, numSamples, mFmtType, chan,
                     mFrameStep, bufferSamples);
             }
             else
@@ -953,22 +1311,23 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
                 const auto uintPos = static_cast<uint>(std::max(intPos, 0));
                 const auto bufferSamples = resampleBuffer.subspan(srcSampleDelay,
                     srcBufferSize-srcSampleDelay);
-                LoadBufferQueue(BufferListItem, BufferLoopItem, uintPos, mFmtType, chan,
+                LoadBufferQueue(bufferItem, loopItem, uintPos, mFmtType, chan,
                     mFrameStep, bufferSamples);
             }
 
+        resample:
             /* If there's a matching sample step and no phase offset, use a
              * simple copy for resampling.
              */
             if(increment == MixerFracOne && fracPos == 0)
-                std::copy_n(resampleBuffer.cbegin(), dstBufferSize,
-                    MixingSamples[chan]+samplesLoaded);
+                std::copy_n(srcSamples.cbegin()+MaxResamplerEdge, dstBufferSize,
+                    dst+samplesLoaded);
             else
-                mResampler(&mResampleState, Device->mResampleData, fracPos, increment,
-                    {MixingSamples[chan]+samplesLoaded, dstBufferSize});
+                mResampler(&mResampleState, srcSamples, fracPos, increment,
+                    {dst+samplesLoaded, dstBufferSize});
 
             /* Store the last source samples used for next time. */
-            if(vstate == Playing) LIKELY
+            if(storeHistory) LIKELY
             {
                 /* Only store samples for the end of the mix, excluding what
                  * gets loaded for decoder padding.
@@ -978,14 +1337,14 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
                 {
                     const size_t dstOffset{samplesToMix - samplesLoaded};
                     const size_t srcOffset{(dstOffset*increment + fracPos) >> MixerFracBits};
-                    std::copy_n(Device->mResampleData.cbegin()+srcOffset, prevSamples.size(),
+                    std::copy_n(srcSamples.cbegin()+ptrdiff_t(srcOffset), prevSamples.size(),
                         prevSamples.begin());
                 }
             }
 
         skip_resample:
             samplesLoaded += dstBufferSize;
-            if(samplesLoaded < samplesToLoad)
+            if(samplesLoaded < count)
             {
                 fracPos += dstBufferSize*increment;
                 const uint srcOffset{fracPos >> MixerFracBits};
@@ -993,13 +1352,48 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
                 intPos += static_cast<int>(srcOffset);
 
                 /* If more samples need to be loaded, copy the back of the
-                 * resampleBuffer to the front to reuse it. prevSamples isn't
-                 * reliable since it's only updated for the end of the mix.
+                 * source samples to the front of the resampleBuffer to reuse
+                 * it. prevSamples isn't reliable since it's only updated for
+                 * the end of the mix.
                  */
-                std::copy_n(Device->mResampleData.cbegin()+srcOffset, MaxResamplerPadding,
-                    Device->mResampleData.begin());
+                std::copy_n(srcSamples.cbegin()+srcOffset, MaxResamplerPadding,
+                    scratch.mResampleData.begin());
             }
         }
+    };
+
+    /* A seek crossfades from the old position to the new one over the start
+     * of the mix. The new position starts with a clear history, as a new
+     * voice would.
+     */
+    const uint fadeSamples{seekFade ? std::min(samplesToMix, 64u) : 0u};
+    const size_t loadChannels{reuseInstance ? 0u : realChannels};
+    for(size_t chan{0};chan < loadChannels;++chan)
+    {
+        if(fadeSamples == 0) LIKELY
+        {
+            load_channel(chan, MixingSamples[chan], samplesToLoad, DataPosInt, DataPosFrac,
+                BufferListItem, BufferLoopItem, vstate == Playing);
+            continue;
+        }
+
+        const auto fadeOut = al::span{scratch.FilteredData}.first(fadeSamples);
+        load_channel(chan, fadeOut.data(), fadeSamples, FadePosInt, FadePosFrac,
+            FadeBufferItem, FadeLoopItem, false);
+        mPrevSamples[chan].fill(0.0f);
+        load_channel(chan, MixingSamples[chan], samplesToLoad, DataPosInt, DataPosFrac,
+            BufferListItem, BufferLoopItem, vstate == Playing);
+
+        const auto fadeIn = al::span{MixingSamples[chan], fadeSamples};
+        const float fadeStep{1.0f / static_cast<float>(fadeSamples)};
+        float fade{0.0f};
+        std::transform(fadeOut.cbegin(), fadeOut.cend(), fadeIn.cbegin(), fadeIn.begin(),
+            [&fade,fadeStep](const float oldSample, const float newSample) noexcept
+            {
+                const float ret{oldSample + (newSample-oldSample)*fade};
+                fade += fadeStep;
+                return ret;
+            });
     }
     if(mFmtChannels == FmtMonoDup)
     {
@@ -1034,10 +1428,11 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
         {
             {
                 DirectParams &parms = chandata.mDryParams;
-                if(!mFlags.test(VoiceHasHrtf))
-                    parms.Gains.Current = parms.Gains.Target;
+                if constexpr(OutMode != OutputMode::Hrtf)
+                    std::copy(parms.Gains.Target.cbegin(), parms.Gains.Target.cend(),
+                        parms.Gains.Current.begin());
                 else
-                    parms.Hrtf.Old = parms.Hrtf.Target;
+                    parms.Hrtf->Old = parms.Hrtf->Target;
             }
             for(uint send{0};send < NumSends;++send)
             {
@@ -1045,55 +1440,185 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
                     continue;
 
                 SendParams &parms = chandata.mWetParams[send];
-                parms.Gains.Current = parms.Gains.Target;
+                std::copy(parms.Gains.Target.cbegin(), parms.Gains.Target.cend(),
+                    parms.Gains.Current.begin());
+            }
+            for(uint lidx{0};lidx < NumListeners;++lidx)
+            {
+                if(mListener[lidx].Buffer.empty())
+                    continue;
+
+                SendParams &parms = chandata.mListenerParams[lidx];
+                std::copy(parms.Gains.Target.cbegin(), parms.Gains.Target.cend(),
+                    parms.Gains.Current.begin());
             }
         }
     }
 
-    auto voiceSamples = MixingSamples.begin();
-    for(auto &chandata : mChans)
+    /* Single-stage filters on the dry and send paths are run together for
+     * each channel, reading the channel's samples once. The filtered samples
+     * are kept in the sample scratch lines not holding channel samples, if
+     * there's room. Any other paths are filtered when they're mixed.
+     */
+    using PathSamples = std::array<al::span<const float>,MaxSendCount+1>;
+    auto PreFiltered = std::array<PathSamples,DeviceBase::MixerChannelsMax>{};
     {
-        /* Now filter and mix to the appropriate outputs. */
-        const al::span<float,BufferLineSize> FilterBuf{Device->FilteredData};
+        auto is_single_stage = [](const int type) noexcept
+        { return type == AF_LowPass || type == AF_HighPass; };
+
+        auto fusePaths = std::array<uint,MaxSendCount+1>{};
+        size_t numFused{0};
+        if(is_single_stage(mDirect.FilterType))
+            fusePaths[numFused++] = 0;
+        for(uint send{0};send < NumSends;++send)
         {
-            DirectParams &parms = chandata.mDryParams;
-            const auto samples = DoFilters(parms.LowPass, parms.HighPass, FilterBuf,
-                {*voiceSamples, samplesToMix}, mDirect.FilterType);
+            if(!mSend[send].Buffer.empty() && is_single_stage(mSend[send].FilterType))
+                fusePaths[numFused++] = send+1;
+        }
 
-            if(mFlags.test(VoiceHasHrtf))
+        const size_t lineStep{(samplesToMix+3u)&~3u};
+        const auto freeLines = static_cast<size_t>(MixingSamples[0] - scratch.mSampleData.data())
+            / lineStep;
+        if(numFused > 1 && numFused*mChans.size() <= freeLines)
+        {
+            auto line = scratch.mSampleData.begin();
+            auto chanPaths = PreFiltered.begin();
+            auto voiceSamples = MixingSamples.begin();
+            for(auto &chandata : mChans)
             {
-                const float TargetGain{parms.Hrtf.Target.Gain * float(vstate == Playing)};
-                DoHrtfMix(samples, parms, TargetGain, Counter, OutPos, (vstate == Playing),
-                    Device);
+                for(size_t base{0};base < numFused;base += BiquadFilter::ChainLanes)
+                {
+                    const size_t count{std::min(numFused-base, BiquadFilter::ChainLanes)};
+                    auto filters = std::array<BiquadFilter*,BiquadFilter::ChainLanes>{};
+                    auto dsts = std::array<al::span<float>,BiquadFilter::ChainLanes>{};
+                    for(size_t i{0};i < count;++i)
+                    {
+                        const uint path{fusePaths[base+i]};
+                        auto [type, lpfilter, hpfilter] = (path == 0)
+                            ? std::tie(mDirect.FilterType, chandata.mDryParams.LowPass,
+                                chandata.mDryParams.HighPass)
+                            : std::tie(mSend[path-1].FilterType,
+                                chandata.mWetParams[path-1].LowPass,
+                                chandata.mWetParams[path-1].HighPass);
+                        if(type == AF_LowPass)
+                        {
+                            hpfilter.clear();
+                            filters[i] = &lpfilter;
+                        }
+                        else
+                        {
+                            lpfilter.clear();
+                            filters[i] = &hpfilter;
+                        }
+                        dsts[i] = {al::to_address(line), samplesToMix};
+                        line += ptrdiff_t(lineStep);
+                        (*chanPaths)[path] = dsts[i];
+                    }
+                    BiquadFilter::processFanout(al::span{filters}.first(count),
+                        {*voiceSamples, samplesToMix}, al::span{dsts}.first(count));
+                }
+                ++chanPaths;
+                ++voiceSamples;
             }
+        }
+    }
+
+    /* Now filter and mix to the appropriate outputs. Each output target is
+     * mixed for all channels before moving on to the next, so consecutive
+     * mixes to the same lines can be batched.
+     */
+    const al::span<float,BufferLineSize> FilterBuf{scratch.FilteredData};
+    auto voiceSamples = MixingSamples.begin();
+    auto chanPaths = PreFiltered.cbegin();
+    for(auto &chandata : mChans)
+    {
+        DirectParams &parms = chandata.mDryParams;
+        const auto samples = !(*chanPaths)[0].empty() ? (*chanPaths)[0]
+            : DoFilters(parms.LowPass, parms.HighPass, FilterBuf, {*voiceSamples, samplesToMix},
+                mDirect.FilterType);
+
+        if constexpr(OutMode == OutputMode::Hrtf)
+        {
+            const float TargetGain{parms.Hrtf->Target.Gain * float(vstate == Playing)};
+            DoHrtfMix(samples, parms, TargetGain, Counter, OutPos, (vstate == Playing), Device,
+                scratch);
+        }
+        else
+        {
+            const auto TargetGains = (vstate == Playing)
+                ? al::span<const float>{parms.Gains.Target}
+                : al::span<const float>{SilentTarget};
+            const auto OutBuffer = scratch.getTarget(mDirect.Buffer);
+            if constexpr(OutMode == OutputMode::Nfc)
+                DoNfcMix(samples, OutBuffer, parms, TargetGains, Counter, OutPos, Device,
+                    scratch);
             else
+                scratch.mixBatched(samples, OutBuffer, parms.Gains.Current, TargetGains,
+                    Counter, OutPos);
+        }
+
+        ++voiceSamples;
+        ++chanPaths;
+    }
+
+    for(uint send{0};send < NumSends;++send)
+    {
+        if(mSend[send].Buffer.empty())
+            continue;
+
+        const auto OutBuffer = scratch.getTarget(mSend[send].Buffer);
+        voiceSamples = MixingSamples.begin();
+        chanPaths = PreFiltered.cbegin();
+        for(auto &chandata : mChans)
+        {
+            SendParams &parms = chandata.mWetParams[send];
+            const auto samples = !(*chanPaths)[send+1].empty() ? (*chanPaths)[send+1]
+                : DoFilters(parms.LowPass, parms.HighPass, FilterBuf,
+                    {*voiceSamples, samplesToMix}, mSend[send].FilterType);
+
+            const auto TargetGains = (vstate == Playing)
+                ? al::span<const float>{parms.Gains.Target}
+                : al::span<const float>{SilentTarget};
+            scratch.mixBatched(samples, OutBuffer, parms.Gains.Current, TargetGains, Counter,
+                OutPos);
+
+            ++voiceSamples;
+            ++chanPaths;
+        }
+    }
+
+    /* The extra listeners reuse the same loaded and resampled samples, each
+     * with its own filters and gains. A listener not hearing the voice has
+     * its current gains cleared, so it fades in if it starts hearing it.
+     */
+    for(uint lidx{0};lidx < NumListeners;++lidx)
+    {
+        if(mListener[lidx].Buffer.empty())
+        {
+            for(auto &chandata : mChans)
             {
-                const auto TargetGains = (vstate == Playing) ? al::span{parms.Gains.Target}
-                    : al::span{SilentTarget};
-                if(mFlags.test(VoiceHasNfc))
-                    DoNfcMix(samples, mDirect.Buffer, parms, TargetGains, Counter, OutPos, Device);
-                else
-                    MixSamples(samples, mDirect.Buffer, parms.Gains.Current, TargetGains, Counter,
-                        OutPos);
+                const auto gains = chandata.mListenerParams[lidx].Gains.Current;
+                std::fill(gains.begin(), gains.end(), 0.0f);
             }
+            continue;
         }
 
-        for(uint send{0};send < NumSends;++send)
+        const auto OutBuffer = scratch.getTarget(mListener[lidx].Buffer);
+        voiceSamples = MixingSamples.begin();
+        for(auto &chandata : mChans)
         {
-            if(mSend[send].Buffer.empty())
-                continue;
-
-            SendParams &parms = chandata.mWetParams[send];
+            SendParams &parms = chandata.mListenerParams[lidx];
             const auto samples = DoFilters(parms.LowPass, parms.HighPass, FilterBuf,
-                {*voiceSamples, samplesToMix}, mSend[send].FilterType);
+                {*voiceSamples, samplesToMix}, mListener[lidx].FilterType);
 
-            const auto TargetGains = (vstate == Playing) ? al::span{parms.Gains.Target}
-                : al::span{SilentTarget};
-            MixSamples(samples, mSend[send].Buffer, parms.Gains.Current, TargetGains, Counter,
+            const auto TargetGains = (vstate == Playing)
+                ? al::span<const float>{parms.Gains.Target}
+                : al::span<const float>{SilentTarget};
+            scratch.mixBatched(samples, OutBuffer, parms.Gains.Current, TargetGains, Counter,
                 OutPos);
-        }
 
-        ++voiceSamples;
+            ++voiceSamples;
+        }
     }
 
     mFlags.set(VoiceIsFading);
@@ -1105,12 +1630,51 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
         return;
     }
 
+    advance(Context, DataPosInt, DataPosFrac, BufferListItem, BufferLoopItem, increment,
+        samplesToMix, deviceTime + nanoseconds{seconds{SamplesToDo}}/Device->mMixFrequency,
+        scratch);
+}
+
+void Voice::updateMixFunc() noexcept
+{
+    auto select_output = [this](auto bufmode) -> MixFunc
+    {
+        static constexpr BufferMode BufMode{decltype(bufmode)::value};
+        if(mFlags.test(VoiceHasHrtf))
+            return &Voice::mixWith<BufMode,OutputMode::Hrtf>;
+        if(mFlags.test(VoiceHasNfc))
+            return &Voice::mixWith<BufMode,OutputMode::Nfc>;
+        return &Voice::mixWith<BufMode,OutputMode::Panned>;
+    };
+    if(mFlags.test(VoiceIsStatic))
+        mMixFunc = select_output(std::integral_constant<BufferMode,BufferMode::Static>{});
+    else if(mFlags.test(VoiceIsCallback))
+        mMixFunc = select_output(std::integral_constant<BufferMode,BufferMode::Callback>{});
+    else
+        mMixFunc = select_output(std::integral_constant<BufferMode,BufferMode::Queue>{});
+}
+
+void Voice::setPosition(const SeekTarget &target)
+{
+    mPosition.store(target.mPosition, std::memory_order_relaxed);
+    mPositionFrac.store(target.mPositionFrac, std::memory_order_relaxed);
+    mCurrentBuffer.store(target.mBuffer, std::memory_order_relaxed);
+    std::for_each(mPrevSamples.begin(), mPrevSamples.end(),
+        [](HistoryLine &line) noexcept { line.fill(0.0f); });
+}
+
+void Voice::advance(ContextBase *Context, int DataPosInt, uint DataPosFrac,
+    VoiceBufferItem *BufferListItem, VoiceBufferItem *BufferLoopItem, const uint increment,
+    const uint samplesToMix, const nanoseconds endTime, MixerScratch &scratch)
+{
     /* Update voice positions and buffers as needed. */
     DataPosFrac += increment*samplesToMix;
     DataPosInt  += static_cast<int>(DataPosFrac>>MixerFracBits);
     DataPosFrac &= MixerFracMask;
 
     uint buffers_done{0u};
+    nanoseconds doneTime{};
+    uint64_t doneOffset{0u};
     if(BufferListItem && DataPosInt > 0) LIKELY
     {
         if(mFlags.test(VoiceIsStatic))
@@ -1165,11 +1729,25 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
                     break;
 
                 DataPosInt -= static_cast<int>(BufferListItem->mSampleLen);
+                doneOffset = BufferListItem->mSampleStart + BufferListItem->mSampleLen;
 
                 ++buffers_done;
                 BufferListItem = BufferListItem->mNext.load(std::memory_order_relaxed);
                 if(!BufferListItem) BufferListItem = BufferLoopItem;
             } while(BufferListItem);
+
+            if(buffers_done > 0)
+            {
+                /* The position past the end of the last completed buffer says
+                 * how many output samples before the end of the update it
+                 * ended at.
+                 */
+                const double srcSamples{DataPosInt + DataPosFrac*(1.0/MixerFracOne)};
+                const double outSamples{std::min(srcSamples * MixerFracOne / increment,
+                    static_cast<double>(samplesToMix))};
+                doneTime = endTime - duration_cast<nanoseconds>(
+                    duration<double>{outSamples / Context->mDevice->mMixFrequency});
+            }
         }
     }
 
@@ -1187,6 +1765,19 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
     }
     std::atomic_thread_fence(std::memory_order_release);
 
+    if(scratch.mDeferEvents)
+    {
+        /* Hold on to any events for the mixer thread to send later. */
+        mDeferredSourceID = SourceID;
+        mDeferredBuffersDone = buffers_done;
+        mDeferredStopped = !BufferListItem;
+        mDeferredClockTime = doneTime;
+        mDeferredSampleOffset = doneOffset;
+        if(!BufferListItem)
+            mPlayState.store(Stopping, std::memory_order_release);
+        return;
+    }
+
     /* Send any events now, after the position/buffer info was updated. */
     const auto enabledevt = Context->mEnabledEvts.load(std::memory_order_acquire);
     if(buffers_done > 0 && enabledevt.test(al::to_underlying(AsyncEnableBits::BufferCompleted)))
@@ -1198,6 +1789,8 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
             auto &evt = InitAsyncEvent<AsyncBufferCompleteEvent>(evt_vec.first.buf);
             evt.mId = SourceID;
             evt.mCount = buffers_done;
+            evt.mClockTime = doneTime;
+            evt.mSampleOffset = doneOffset;
             ring->writeAdvance(1);
         }
     }
@@ -1213,6 +1806,33 @@ void Voice::mix(const State vstate, ContextBase *Context, const nanoseconds devi
     }
 }
 
+void Voice::sendDeferredEvents(ContextBase *Context)
+{
+    const uint buffers_done{std::exchange(mDeferredBuffersDone, 0u)};
+    const bool stopped{std::exchange(mDeferredStopped, false)};
+    if(!buffers_done && !stopped)
+        return;
+
+    const auto enabledevt = Context->mEnabledEvts.load(std::memory_order_acquire);
+    if(buffers_done > 0 && enabledevt.test(al::to_underlying(AsyncEnableBits::BufferCompleted)))
+    {
+        RingBuffer *ring{Context->mAsyncEvents.get()};
+        auto evt_vec = ring->getWriteVector();
+        if(evt_vec.first.len > 0)
+        {
+            auto &evt = InitAsyncEvent<AsyncBufferCompleteEvent>(evt_vec.first.buf);
+            evt.mId = mDeferredSourceID;
+            evt.mCount = buffers_done;
+            evt.mClockTime = mDeferredClockTime;
+            evt.mSampleOffset = mDeferredSampleOffset;
+            ring->writeAdvance(1);
+        }
+    }
+
+    if(stopped && enabledevt.test(al::to_underlying(AsyncEnableBits::SourceState)))
+        SendSourceStoppedEvent(Context, mDeferredSourceID);
+}
+
 void Voice::prepare(DeviceBase *device)
 {
     /* Even if storing really high order ambisonics, we only mix channels for
@@ -1233,15 +1853,18 @@ void Voice::prepare(DeviceBase *device)
         decltype(mPrevSamples){}.swap(mPrevSamples);
     }
     mChans.reserve(std::max(2u, num_channels));
+    mAmbiRotationValid = false;
+    mPanningValid = false;
     mChans.resize(num_channels);
     mPrevSamples.reserve(std::max(2u, num_channels));
     mPrevSamples.resize(num_channels);
+    mSeekTarget.reset();
 
     mDecoder = nullptr;
     mDecoderPadding = 0;
     if(mFmtChannels == FmtSuperStereo)
     {
-        switch(UhjDecodeQuality)
+        switch(device->mUhjDecodeQuality)
         {
         case UhjQualityType::IIR:
             mDecoder = std::make_unique<UhjStereoDecoderIIR>();
@@ -1257,24 +1880,8 @@ void Voice::prepare(DeviceBase *device)
             break;
         }
     }
-    else if(IsUHJ(mFmtChannels))
-    {
-        switch(UhjDecodeQuality)
-        {
-        case UhjQualityType::IIR:
-            mDecoder = std::make_unique<UhjDecoderIIR>();
-            mDecoderPadding = UhjDecoderIIR::sInputPadding;
-            break;
-        case UhjQualityType::FIR256:
-            mDecoder = std::make_unique<UhjDecoder<UhjLength256>>();
-            mDecoderPadding = UhjDecoder<UhjLength256>::sInputPadding;
-            break;
-        case UhjQualityType::FIR512:
-            mDecoder = std::make_unique<UhjDecoder<UhjLength512>>();
-            mDecoderPadding = UhjDecoder<UhjLength512>::sInputPadding;
-            break;
-        }
-    }
+    else if(IsUHJ(mFmtChannels) && !mFlags.test(VoiceIsUhjDecoded))
+        std::tie(mDecoder, mDecoderPadding) = CreateUhjDecoder(device->mUhjDecodeQuality);
 
     /* Clear the stepping value explicitly so the mixer knows not to mix this
      * until the update gets applied.
@@ -1298,7 +1905,7 @@ void Voice::prepare(DeviceBase *device)
          * Note this isn't needed with UHJ output (UHJ2->B-Format->UHJ2 is
          * identity, so don't mess with it).
          */
-        const BandSplitter splitter{device->mXOverFreq / static_cast<float>(device->Frequency)};
+        const BandSplitter splitter{device->mXOverFreq / static_cast<float>(device->mMixFrequency)};
         for(auto &chandata : mChans)
         {
             chandata.mAmbiHFScale = 1.0f;
@@ -1307,6 +1914,7 @@ void Voice::prepare(DeviceBase *device)
             chandata.mDryParams = DirectParams{};
             chandata.mDryParams.NFCtrlFilter = device->mNFCtrlFilter;
             std::fill_n(chandata.mWetParams.begin(), device->NumAuxSends, SendParams{});
+            std::fill_n(chandata.mListenerParams.begin(), device->NumListeners-1, SendParams{});
         }
         mChans[0].mAmbiLFScale = DecoderBase::sWLFScale;
         mChans[1].mAmbiLFScale = DecoderBase::sXYLFScale;
@@ -1325,7 +1933,7 @@ void Voice::prepare(DeviceBase *device)
         const auto scales = AmbiScale::GetHFOrderScales(mAmbiOrder, device->mAmbiOrder,
             device->m2DMixing);
 
-        const BandSplitter splitter{device->mXOverFreq / static_cast<float>(device->Frequency)};
+        const BandSplitter splitter{device->mXOverFreq / static_cast<float>(device->mMixFrequency)};
         for(auto &chandata : mChans)
         {
             chandata.mAmbiHFScale = scales[*(OrderFromChan++)];
@@ -1334,6 +1942,7 @@ void Voice::prepare(DeviceBase *device)
             chandata.mDryParams = DirectParams{};
             chandata.mDryParams.NFCtrlFilter = device->mNFCtrlFilter;
             std::fill_n(chandata.mWetParams.begin(), device->NumAuxSends, SendParams{});
+            std::fill_n(chandata.mListenerParams.begin(), device->NumListeners-1, SendParams{});
         }
         mFlags.set(VoiceIsAmbisonic);
     }
@@ -1344,7 +1953,59 @@ void Voice::prepare(DeviceBase *device)
             chandata.mDryParams = DirectParams{};
             chandata.mDryParams.NFCtrlFilter = device->mNFCtrlFilter;
             std::fill_n(chandata.mWetParams.begin(), device->NumAuxSends, SendParams{});
+            std::fill_n(chandata.mListenerParams.begin(), device->NumListeners-1, SendParams{});
         }
         mFlags.reset(VoiceIsAmbisonic);
     }
+
+    /* Lay out the gain pool with each channel's direct gains followed by its
+     * send gains, then its extra listener gains, each padded to a multiple of
+     * 4 floats to stay aligned.
+     */
+    const size_t numDry{RoundUp(std::max(device->Dry.Buffer.size(),
+        device->RealOut.Buffer.size()), 4)};
+    const size_t numWet{RoundUp(AmbiChannelsFromOrder(device->mAmbiOrder), 4)};
+    const size_t numSends{device->NumAuxSends};
+    const size_t numReal{RoundUp(device->RealOut.Buffer.size(), 4)};
+    const size_t numListeners{device->NumListeners-1};
+    mGainPool.assign((numDry + numWet*numSends + numReal*numListeners) * 2 * mChans.size(),
+        0.0f);
+
+    auto gains = al::span{mGainPool};
+    auto take_gains = [&gains](const size_t count) -> al::span<float>
+    {
+        const auto ret = gains.first(count);
+        gains = gains.subspan(count);
+        return ret;
+    };
+    /* Only voices on a device rendering with HRTF need the HRTF filter state,
+     * so it's left unallocated otherwise.
+     */
+    if(device->mRenderMode == RenderMode::Hrtf)
+        mHrtfPool.assign(mChans.size(), DirectParams::HrtfParams{});
+    else
+    {
+        mHrtfPool.clear();
+        mHrtfPool.shrink_to_fit();
+    }
+
+    auto hrtfparams = mHrtfPool.begin();
+    for(auto &chandata : mChans)
+    {
+        chandata.mDryParams.Hrtf = mHrtfPool.empty() ? nullptr : al::to_address(hrtfparams++);
+        chandata.mDryParams.Gains.Current = take_gains(numDry);
+        chandata.mDryParams.Gains.Target = take_gains(numDry);
+        for(auto &parms : al::span{chandata.mWetParams}.first(numSends))
+        {
+            parms.Gains.Current = take_gains(numWet);
+            parms.Gains.Target = take_gains(numWet);
+        }
+        for(auto &parms : al::span{chandata.mListenerParams}.first(numListeners))
+        {
+            parms.Gains.Current = take_gains(numReal);
+            parms.Gains.Target = take_gains(numReal);
+        }
+    }
+    std::fill(mListener.begin(), mListener.end(), TargetData{});
+    updateMixFunc();
 }
@@ -6,14 +6,17 @@
 #include <bitset>
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
 
 #include "almalloc.h"
 #include "alspan.h"
+#include "ambidefs.h"
 #include "bufferline.h"
 #include "buffer_storage.h"
+#include "context.h"
 #include "devformat.h"
 #include "filters/biquad.h"
 #include "filters/nfc.h"
@@ -27,6 +30,7 @@
 struct ContextBase;
 struct DeviceBase;
 struct EffectSlot;
+struct MixerScratch;
 enum class DistanceModel : unsigned char;
 
 using uint = unsigned int;
@@ -70,11 +74,17 @@ struct DirectParams {
         HrtfFilter Target{};
         alignas(16) std::array<float,HrtfHistoryLength> History{};
     };
-    HrtfParams Hrtf;
+    /* A view into the owning voice's HRTF pool, which is only allocated when
+     * the device renders with HRTF.
+     */
+    HrtfParams *Hrtf{};
 
+    /* The gains are views into the owning voice's gain pool, sized for the
+     * device's output channels.
+     */
     struct GainParams {
-        std::array<float,MaxOutputChannels> Current{};
-        std::array<float,MaxOutputChannels> Target{};
+        al::span<float> Current;
+        al::span<float> Target;
     };
     GainParams Gains;
 };
@@ -83,9 +93,12 @@ struct SendParams {
     BiquadFilter LowPass;
     BiquadFilter HighPass;
 
+    /* The gains are views into the owning voice's gain pool, sized for the
+     * effect slots' mixing channels.
+     */
     struct GainParams {
-        std::array<float,MaxAmbiChannels> Current{};
-        std::array<float,MaxAmbiChannels> Target{};
+        al::span<float> Current;
+        al::span<float> Target;
     };
     GainParams Gains;
 };
@@ -96,12 +109,19 @@ struct VoiceBufferItem {
 
     CallbackType mCallback{nullptr};
     void *mUserData{nullptr};
+    uint mCallbackRequest{0u};
 
     uint mBlockAlign{0u};
     uint mSampleLen{0u};
     uint mLoopStart{0u};
     uint mLoopEnd{0u};
 
+    /* The sample offset of this item from the start of the source's queue,
+     * including any items unqueued since. Offsets relative to the current
+     * queue are taken from the difference with the first item's.
+     */
+    uint64_t mSampleStart{0u};
+
     al::span<std::byte> mSamples{};
 };
 
@@ -142,6 +162,8 @@ struct VoiceProps {
     float Radius;
     float EnhWidth;
     float Panning;
+    int DirectRoute;
+    bool Instancing;
 
     /** Direct filter and auxiliary send info. */
     struct DirectData {
@@ -176,6 +198,11 @@ enum : uint {
     VoiceIsFading,
     VoiceHasHrtf,
     VoiceHasNfc,
+    VoiceIsCulled,
+    VoiceIsLowDetail,
+    VoiceIsVirtual,
+    VoiceIsHrtfLimited,
+    VoiceIsUhjDecoded,
 
     VoiceFlagCount
 };
@@ -192,9 +219,17 @@ struct Voice {
 
     VoiceProps mProps{};
 
+    /* The voice's index in the context's voice array, and whether it's in
+     * the mixer's list of voices in use (only accessed by the mixer).
+     */
+    uint mVoiceIdx{0u};
+    bool mMixListed{false};
+
     std::atomic<uint> mSourceID{0u};
     std::atomic<State> mPlayState{Stopped};
     std::atomic<bool> mPendingChange{false};
+    /* Set while an in-place seek is waiting for the mixer to process it. */
+    std::atomic<bool> mPendingSeek{false};
 
     /**
      * Source offset in samples, relative to the currently playing buffer, NOT
@@ -214,6 +249,16 @@ struct Voice {
 
     std::chrono::nanoseconds mStartTime{};
 
+    /* The offset an in-place seek will move to, crossfading from the current
+     * position when the voice is next mixed. Only accessed by the mixer.
+     */
+    struct SeekTarget {
+        int mPosition;
+        uint mPositionFrac;
+        VoiceBufferItem *mBuffer;
+    };
+    std::optional<SeekTarget> mSeekTarget;
+
     /* Properties for the attached buffer(s). */
     FmtChannels mFmtChannels{};
     FmtType mFmtType{};
@@ -245,6 +290,8 @@ struct Voice {
     };
     TargetData mDirect;
     std::array<TargetData,MaxSendCount> mSend;
+    /* The direct mixes for the context's listeners after the first. */
+    std::array<TargetData,MaxListenerCount-1> mListener;
 
     /* The first MaxResamplerPadding/2 elements are the sample history from the
      * previous mix, with an additional MaxResamplerPadding/2 elements that are
@@ -258,25 +305,130 @@ struct Voice {
         float mAmbiHFScale{}, mAmbiLFScale{};
         BandSplitter mAmbiSplitter;
 
+        /* The row of the ambisonic rotation (and upsampling) matrix for this
+         * channel, when mixing a rotated B-Format source.
+         */
+        std::array<float,MaxAmbiChannels> mAmbiRotation{};
+
         DirectParams mDryParams;
         std::array<SendParams,MaxSendCount> mWetParams;
+        std::array<SendParams,MaxListenerCount-1> mListenerParams;
     };
     al::vector<ChannelData> mChans{2};
 
+    /* The voice's loudest output gain as of the last update, used to rank
+     * voices when limiting how many get mixed.
+     */
+    float mAudibility{0.0f};
+
+    /* The base gains the channels' target gains were last calculated with.
+     * When only the gains change, the targets can be rescaled instead of
+     * recalculating the panning.
+     */
+    float mDryGainBase{0.0f};
+    std::array<float,MaxSendCount> mWetGainBase{};
+    bool mPanningValid{false};
+
+    /* The (transformed) at and up vectors the channels' ambisonic rotations
+     * were calculated for. The rotations are only rebuilt when these change.
+     */
+    std::array<float,6> mAmbiOrientation{};
+    bool mAmbiRotationValid{false};
+
+    /* Storage for the current and target gains of each channel's direct,
+     * send, and extra listener mixes. These are the values touched for every mix, so they're kept
+     * together and sized for the device's actual output and send channel
+     * counts, rather than the maximums.
+     */
+    al::vector<float,16> mGainPool;
+
+    /* Storage for each channel's HRTF filter state, only allocated when the
+     * device renders with HRTF.
+     */
+    al::vector<DirectParams::HrtfParams,16> mHrtfPool;
+
+    /* Events from a mix with deferred events, which the mixer thread sends
+     * after all voices are mixed.
+     */
+    uint mDeferredSourceID{0u};
+    uint mDeferredBuffersDone{0u};
+    bool mDeferredStopped{false};
+    std::chrono::nanoseconds mDeferredClockTime{};
+    uint64_t mDeferredSampleOffset{0u};
+
     Voice() = default;
-    ~Voice() = default;
+    ~Voice();
 
     Voice(const Voice&) = delete;
     Voice& operator=(const Voice&) = delete;
 
     void mix(const State vstate, ContextBase *Context, const std::chrono::nanoseconds deviceTime,
-        const uint SamplesToDo);
+        const uint SamplesToDo, MixerScratch &scratch)
+    { (this->*mMixFunc)(vstate, Context, deviceTime, SamplesToDo, scratch); }
+
+    /**
+     * Selects the mix function for the voice's buffer type and output mode.
+     * Must be called when the static, callback, HRTF, or NFC flags change.
+     */
+    void updateMixFunc() noexcept;
+
+    /**
+     * Moves the voice to the given offset without a crossfade, clearing the
+     * resampler history. Only called by the mixer.
+     */
+    void setPosition(const SeekTarget &target);
+
+private:
+    enum class BufferMode : uint8_t { Static, Callback, Queue };
+    enum class OutputMode : uint8_t { Panned, Nfc, Hrtf };
+
+    template<BufferMode BufMode, OutputMode OutMode>
+    void mixWith(const State vstate, ContextBase *Context,
+        const std::chrono::nanoseconds deviceTime, const uint SamplesToDo, MixerScratch &scratch);
+
+    using MixFunc = void(Voice::*)(const State, ContextBase*, const std::chrono::nanoseconds,
+        const uint, MixerScratch&);
+    MixFunc mMixFunc{};
+
+    void advance(ContextBase *Context, int DataPosInt, uint DataPosFrac,
+        VoiceBufferItem *BufferListItem, VoiceBufferItem *BufferLoopItem, const uint increment,
+        const uint samplesToMix, const std::chrono::nanoseconds endTime, MixerScratch &scratch);
+
+public:
+
+    /** Sends any events held back from a mix with deferred events. */
+    void sendDeferredEvents(ContextBase *Context);
 
     void prepare(DeviceBase *device);
 
-    static void InitMixer(std::optional<std::string> resopt);
+    static void InitMixer(const std::optional<std::string> &resopt);
+    /**
+     * Sets the resampler new sources start with, from the resampler config
+     * option. Can be called again to reload it.
+     */
+    static void SetDefaultResampler(const std::optional<std::string> &resopt);
 };
 
-inline Resampler ResamplerDefault{Resampler::Gaussian};
+inline std::atomic<Resampler> ResamplerDefault{Resampler::Gaussian};
+
+/**
+ * Decodes compressed samples (mu-law, a-law, IMA4, or MSADPCM) to interleaved
+ * 16-bit samples. The source must start on a block boundary, and dst must
+ * hold a whole number of sample frames. Decoding is lossless, so the result
+ * mixes the same as the original.
+ */
+void DecodeSamples(const al::span<int16_t> dst, const al::span<const std::byte> src,
+    const FmtType srcType, const uint numChannels, const uint samplesPerBlock) noexcept;
+
+/**
+ * Decodes UHJ samples (2-, 3-, or 4-channel) to interleaved float B-Format,
+ * with FuMa channel ordering and UHJ scaling, as a voice's UHJ decoder would.
+ * The result has 3 channels for 2- and 3-channel UHJ, and 4 for 4-channel.
+ * The source must start on a block boundary, and dst must hold a whole number
+ * of sample frames.
+ */
+void DecodeUhjSamples(const al::span<float> dst, const al::span<const std::byte> src,
+    const FmtChannels srcChannels, const FmtType srcType, const uint samplesPerBlock,
+    const UhjQualityType quality);
 
 #endif /* CORE_VOICE_H */
@@ -4,6 +4,7 @@
 #include <atomic>
 
 struct Voice;
+struct VoiceBufferItem;
 
 using uint = unsigned int;
 
@@ -13,7 +14,8 @@ enum class VChangeState {
     Stop,
     Play,
     Pause,
-    Restart
+    Restart,
+    Seek
 };
 struct VoiceChange {
     Voice *mOldVoice{nullptr};
@@ -21,6 +23,11 @@ struct VoiceChange {
     uint mSourceID{0};
     VChangeState mState{};
 
+    /* The new offset for a Seek change. */
+    int mSeekPosition{};
+    uint mSeekPositionFrac{};
+    VoiceBufferItem *mSeekBuffer{nullptr};
+
     std::atomic<VoiceChange*> mNext{nullptr};
 };
 
@@ -0,0 +1,234 @@
+#include "config.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "alspan.h"
+#include "core/converter.h"
+#include "core/devformat.h"
+#include "core/mixer/defs.h"
+#include "core/mixer/instsets.h"
+
+/* Checks the sample converter's rate-matched passthrough, which converts the
+ * sample type without resampling, and the channel converter's up/downmixes,
+ * against a per-sample reference conversion.
+ */
+
+struct PointTag;
+
+/* The resampler selection lives in the mixer (alc/alu.cpp), outside of the
+ * core library. The resampled output isn't checked here, so use the point
+ * resampler.
+ */
+ResamplerFunc PrepareResampler(Resampler, uint, InterpState*)
+{ return Resample_<PointTag,CTag>; }
+
+namespace {
+
+constexpr uint NumChannels{3};
+constexpr uint NumFrames{1500};
+
+
+std::vector<float> MakeNoise(size_t count)
+{
+    std::mt19937 rng{48000u};
+    std::uniform_real_distribution<float> dist{-1.1f, 1.1f};
+    std::vector<float> ret(count);
+    std::generate(ret.begin(), ret.end(), [&rng,&dist] { return dist(rng); });
+    return ret;
+}
+
+std::vector<int32_t> ToInt(const al::span<const float> src)
+{
+    std::vector<int32_t> ret(src.size());
+    std::transform(src.begin(), src.end(), ret.begin(), [](const float f)
+    {
+        const double val{std::clamp(double{f}*2147483648.0, -2147483648.0, 2147483647.0)};
+        return static_cast<int32_t>(std::lrint(val));
+    });
+    return ret;
+}
+
+std::vector<int16_t> ToShort(const al::span<const float> src)
+{
+    std::vector<int16_t> ret(src.size());
+    std::transform(src.begin(), src.end(), ret.begin(), [](const float f)
+    { return static_cast<int16_t>(std::lrint(std::clamp(f*32768.0f, -32768.0f, 32767.0f))); });
+    return ret;
+}
+
+
+TEST(ConverterTest, PassthroughIntToFloat)
+{
+    const auto input = ToInt(MakeNoise(NumFrames*NumChannels));
+    auto converter = SampleConverter::Create(DevFmtInt, DevFmtFloat, NumChannels, 48000, 48000,
+        Resampler::FastBSinc24);
+    ASSERT_TRUE(converter);
+    EXPECT_TRUE(converter->isPassthrough());
+    EXPECT_EQ(converter->currentInputDelay().count(), 0);
+    EXPECT_EQ(converter->availableOut(NumFrames), NumFrames);
+
+    std::vector<float> output(NumFrames*NumChannels);
+    const void *src{input.data()};
+    uint srcframes{NumFrames};
+    const uint got{converter->convert(&src, &srcframes, output.data(), NumFrames)};
+    EXPECT_EQ(got, NumFrames);
+    EXPECT_EQ(srcframes, 0u);
+
+    for(size_t i{0};i < output.size();++i)
+        ASSERT_EQ(output[i], static_cast<float>(input[i]) * (1.0f/2147483648.0f)) << "at " << i;
+}
+
+TEST(ConverterTest, PassthroughShortToFloat)
+{
+    const auto input = ToShort(MakeNoise(NumFrames*NumChannels));
+    auto converter = SampleConverter::Create(DevFmtShort, DevFmtFloat, NumChannels, 44100,
+        44100, Resampler::FastBSinc24);
+    ASSERT_TRUE(converter);
+
+    std::vector<float> output(NumFrames*NumChannels);
+    const void *src{input.data()};
+    uint srcframes{NumFrames};
+    EXPECT_EQ(converter->convert(&src, &srcframes, output.data(), NumFrames), NumFrames);
+
+    for(size_t i{0};i < output.size();++i)
+        ASSERT_EQ(output[i], static_cast<float>(input[i]) * (1.0f/32768.0f)) << "at " << i;
+}
+
+TEST(ConverterTest, PassthroughFloatToInteger)
+{
+    const auto input = MakeNoise(NumFrames*NumChannels);
+    const auto expected_short = ToShort(input);
+
+    auto converter = SampleConverter::Create(DevFmtFloat, DevFmtShort, NumChannels, 48000, 48000,
+        Resampler::FastBSinc24);
+    ASSERT_TRUE(converter);
+
+    /* Convert in uneven pieces, to check the source and destination offsets
+     * are kept.
+     */
+    std::vector<int16_t> output(NumFrames*NumChannels);
+    const void *src{input.data()};
+    uint srcframes{NumFrames};
+    uint pos{0};
+    while(pos < NumFrames)
+    {
+        const uint todo{std::min(NumFrames-pos, 333u)};
+        pos += converter->convert(&src, &srcframes, &output[pos*NumChannels], todo);
+    }
+    EXPECT_EQ(srcframes, 0u);
+    EXPECT_EQ(output, expected_short);
+
+    const auto expected_int = ToInt(input);
+    converter = SampleConverter::Create(DevFmtFloat, DevFmtInt, NumChannels, 48000, 48000,
+        Resampler::FastBSinc24);
+    ASSERT_TRUE(converter);
+
+    std::vector<int32_t> output_int(NumFrames*NumChannels);
+    src = input.data();
+    srcframes = NumFrames;
+    EXPECT_EQ(converter->convert(&src, &srcframes, output_int.data(), NumFrames), NumFrames);
+    /* The largest positive float below 1.0 scaled to int32 is 2147483520. */
+    for(size_t i{0};i < output_int.size();++i)
+        ASSERT_EQ(output_int[i], std::min(expected_int[i], 2147483520)) << "at " << i;
+}
+
+TEST(ConverterTest, PassthroughPlanar)
+{
+    const auto noise = MakeNoise(NumFrames*NumChannels);
+    std::vector<std::vector<int32_t>> input;
+    std::vector<std::vector<float>> output;
+    std::vector<const void*> srcs;
+    std::vector<void*> dsts;
+    for(uint c{0};c < NumChannels;++c)
+    {
+        input.emplace_back(ToInt(al::span{noise}.subspan(c*NumFrames, NumFrames)));
+        output.emplace_back(NumFrames);
+        srcs.emplace_back(input.back().data());
+        dsts.emplace_back(output.back().data());
+    }
+
+    auto converter = SampleConverter::Create(DevFmtInt, DevFmtFloat, NumChannels, 16000, 16000,
+        Resampler::FastBSinc24);
+    ASSERT_TRUE(converter);
+
+    uint srcframes{NumFrames};
+    EXPECT_EQ(converter->convertPlanar(srcs.data(), &srcframes, dsts.data(), NumFrames),
+        NumFrames);
+    EXPECT_EQ(srcframes, 0u);
+    for(uint c{0};c < NumChannels;++c)
+    {
+        EXPECT_EQ(srcs[c], input[c].data()+NumFrames);
+        for(size_t i{0};i < NumFrames;++i)
+            ASSERT_EQ(output[c][i], static_cast<float>(input[c][i]) * (1.0f/2147483648.0f));
+    }
+}
+
+TEST(ConverterTest, ResamplingKeepsDelay)
+{
+    auto converter = SampleConverter::Create(DevFmtInt, DevFmtFloat, NumChannels, 48000, 16000,
+        Resampler::FastBSinc24);
+    ASSERT_TRUE(converter);
+    EXPECT_FALSE(converter->isPassthrough());
+    EXPECT_GT(converter->currentInputDelay().count(), 0);
+}
+
+
+TEST(ConverterTest, StereoToMono)
+{
+    const auto input = MakeNoise(NumFrames*2);
+    const ChannelConverter converter{DevFmtFloat, 2, 0x3, DevFmtMono};
+
+    std::vector<float> output(NumFrames);
+    converter.convert(input.data(), output.data(), NumFrames);
+
+    const float scale{std::sqrt(0.5f)};
+    for(size_t i{0};i < NumFrames;++i)
+        ASSERT_EQ(output[i], (input[i*2] + input[i*2 + 1]) * scale) << "at " << i;
+}
+
+TEST(ConverterTest, MultiToMono)
+{
+    /* 5.1 to mono, excluding the LFE (the fourth channel). */
+    constexpr uint step{6};
+    constexpr uint chanmask{0x37};
+    const auto input = ToShort(MakeNoise(NumFrames*step));
+    const ChannelConverter converter{DevFmtShort, step, chanmask, DevFmtMono};
+
+    std::vector<float> output(NumFrames);
+    converter.convert(input.data(), output.data(), NumFrames);
+
+    const float scale{std::sqrt(1.0f / 5.0f)};
+    for(size_t i{0};i < NumFrames;++i)
+    {
+        float sample{0.0f};
+        for(uint c{0};c < step;++c)
+        {
+            if((chanmask>>c)&1)
+                sample += static_cast<float>(input[i*step + c]) * (1.0f/32768.0f);
+        }
+        ASSERT_EQ(output[i], sample * scale) << "at " << i;
+    }
+}
+
+TEST(ConverterTest, MonoToStereo)
+{
+    const auto input = MakeNoise(NumFrames);
+    const ChannelConverter converter{DevFmtFloat, 1, 0x1, DevFmtStereo};
+
+    std::vector<float> output(NumFrames*2);
+    converter.convert(input.data(), output.data(), NumFrames);
+
+    for(size_t i{0};i < NumFrames;++i)
+    {
+        ASSERT_EQ(output[i*2], input[i]*0.707106781187f) << "at " << i;
+        ASSERT_EQ(output[i*2 + 1], input[i]*0.707106781187f) << "at " << i;
+    }
+}
+
+} // namespace
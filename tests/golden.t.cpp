@@ -0,0 +1,415 @@
+#include <gtest/gtest.h>
+
+#define AL_ALEXT_PROTOTYPES
+#include <AL/al.h>
+#include <AL/alc.h>
+#include <AL/alext.h>
+#include <AL/efx.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/* Renders fixed scenes through a loopback device and compares them against
+ * the stored reference renders in GOLDEN_REFERENCE_DIR. When the C mixer is
+ * used (ALSOFT_GOLDEN_DISABLE_CPU_EXTS=all, which the config passes on to
+ * disable-cpu-exts), the output must match bit-exact. Otherwise the SIMD
+ * mixers are used and the output must be within a small tolerance.
+ *
+ * The references are raw interleaved 32-bit little-endian float samples.
+ * Setting ALSOFT_GOLDEN_UPDATE=1 writes them from the current output instead,
+ * which should be done with the C mixer.
+ */
+
+#ifndef AL_SOFT_convolution_effect
+#define AL_SOFT_convolution_effect
+#define AL_EFFECT_CONVOLUTION_SOFT               0xA000
+#endif
+
+#ifndef AL_EVENT_TYPE_EFFECT_SLOT_READY_SOFT
+#define AL_EVENT_TYPE_EFFECT_SLOT_READY_SOFT     0x19EC
+#endif
+
+namespace {
+
+constexpr ALCint SampleRate{48000};
+constexpr ALCsizei UpdateSize{256};
+constexpr ALCsizei NumUpdates{16};
+
+/* The largest difference allowed from the references with the SIMD mixers. */
+constexpr float SimdTolerance{1.0f / 16384.0f};
+
+bool isExactMode()
+{
+    const char *exts{std::getenv("ALSOFT_GOLDEN_DISABLE_CPU_EXTS")};
+    return exts && std::string_view{exts} == "all";
+}
+
+bool isUpdateMode()
+{
+    const char *update{std::getenv("ALSOFT_GOLDEN_UPDATE")};
+    return update && std::string_view{update} == "1";
+}
+
+/* A simple xorshift generator, so the source data doesn't depend on the
+ * standard library's distributions.
+ */
+class Noise {
+    uint32_t mState;
+
+public:
+    explicit Noise(uint32_t seed) : mState{seed} { }
+
+    float operator()()
+    {
+        mState ^= mState << 13;
+        mState ^= mState >> 17;
+        mState ^= mState << 5;
+        return static_cast<float>(static_cast<int32_t>(mState) >> 8) / 8388608.0f;
+    }
+};
+
+ALuint createNoiseBuffer(ALenum format, int channels, int frames, uint32_t seed, float decay)
+{
+    Noise noise{seed};
+    std::vector<float> data(static_cast<size_t>(frames*channels));
+    float gain{0.5f};
+    for(int i{0};i < frames;++i)
+    {
+        for(int c{0};c < channels;++c)
+            data[static_cast<size_t>(i*channels + c)] = noise() * gain;
+        gain *= decay;
+    }
+
+    ALuint buffer{};
+    alGenBuffers(1, &buffer);
+    alBufferData(buffer, format, data.data(), static_cast<ALsizei>(data.size()*sizeof(float)),
+        SampleRate);
+    return buffer;
+}
+
+/* Each source moves in a straight line past the listener. The positions only
+ * use basic arithmetic, so they're the same everywhere.
+ */
+struct SourceMotion {
+    ALuint mSource;
+    float mPos[3];
+    float mStep[3];
+
+    void update()
+    {
+        for(int i{0};i < 3;++i)
+            mPos[i] += mStep[i];
+        alSource3f(mSource, AL_POSITION, mPos[0], mPos[1], mPos[2]);
+    }
+};
+
+struct Scene {
+    ALCdevice *mDevice{};
+    ALCcontext *mContext{};
+    int mChannels{};
+
+    std::vector<ALuint> mBuffers;
+    std::vector<SourceMotion> mSources;
+    std::vector<ALuint> mEffects;
+    std::vector<ALuint> mSlots;
+    std::vector<ALuint> mFilters;
+
+    std::atomic<bool> mSlotReady{false};
+
+    static void AL_APIENTRY EventCallback(ALenum eventType, ALuint, ALuint, ALsizei,
+        const ALchar*, void *userParam) noexcept
+    {
+        if(eventType == AL_EVENT_TYPE_EFFECT_SLOT_READY_SOFT)
+            static_cast<Scene*>(userParam)->mSlotReady.store(true);
+    }
+
+    ~Scene()
+    {
+        if(!mContext) return;
+        for(const SourceMotion &motion : mSources)
+            alDeleteSources(1, &motion.mSource);
+        if(!mSlots.empty())
+            alDeleteAuxiliaryEffectSlots(static_cast<ALsizei>(mSlots.size()), mSlots.data());
+        if(!mEffects.empty())
+            alDeleteEffects(static_cast<ALsizei>(mEffects.size()), mEffects.data());
+        if(!mFilters.empty())
+            alDeleteFilters(static_cast<ALsizei>(mFilters.size()), mFilters.data());
+        if(!mBuffers.empty())
+            alDeleteBuffers(static_cast<ALsizei>(mBuffers.size()), mBuffers.data());
+        alcMakeContextCurrent(nullptr);
+        alcDestroyContext(mContext);
+        alcCloseDevice(mDevice);
+    }
+
+    bool open(std::vector<ALCint> attrs, int channels)
+    {
+        mDevice = alcLoopbackOpenDeviceSOFT(nullptr);
+        if(!mDevice) return false;
+
+        attrs.insert(attrs.end(), {ALC_FORMAT_TYPE_SOFT, ALC_FLOAT_SOFT,
+            ALC_FREQUENCY, SampleRate, ALC_OUTPUT_LIMITER_SOFT, ALC_FALSE, 0});
+        mContext = alcCreateContext(mDevice, attrs.data());
+        if(!mContext || !alcMakeContextCurrent(mContext))
+        {
+            if(mContext) alcDestroyContext(mContext);
+            mContext = nullptr;
+            alcCloseDevice(mDevice);
+            return false;
+        }
+        mChannels = channels;
+
+        const ALenum evttypes[]{AL_EVENT_TYPE_EFFECT_SLOT_READY_SOFT};
+        alEventControlSOFT(1, evttypes, AL_TRUE);
+        alEventCallbackSOFT(EventCallback, this);
+        return true;
+    }
+
+    /* Adds count sources playing looping noise, each using the next
+     * resampler, moving from one side of the listener to the other.
+     */
+    void addSources(int count)
+    {
+        const ALuint buffer{createNoiseBuffer(AL_FORMAT_MONO_FLOAT32, 1, SampleRate, 22050u,
+            1.0f)};
+        mBuffers.push_back(buffer);
+
+        const ALint numresamplers{alGetInteger(AL_NUM_RESAMPLERS_SOFT)};
+        for(int i{0};i < count;++i)
+        {
+            SourceMotion motion{};
+            alGenSources(1, &motion.mSource);
+            alSourcei(motion.mSource, AL_BUFFER, static_cast<ALint>(buffer));
+            alSourcei(motion.mSource, AL_LOOPING, AL_TRUE);
+            alSourcei(motion.mSource, AL_SAMPLE_OFFSET, i*4410);
+            alSourcef(motion.mSource, AL_PITCH, 0.75f + static_cast<float>(i)*0.25f);
+            alSourcei(motion.mSource, AL_SOURCE_RESAMPLER_SOFT, i%numresamplers);
+
+            const float side{(i&1) ? 1.0f : -1.0f};
+            motion.mPos[0] = -4.0f * side;
+            motion.mPos[1] = static_cast<float>(i-count/2) * 0.5f;
+            motion.mPos[2] = -1.0f - static_cast<float>(i);
+            motion.mStep[0] = 0.5f * side;
+            motion.mStep[1] = 0.0f;
+            motion.mStep[2] = 0.125f;
+            mSources.push_back(motion);
+        }
+    }
+
+    ALuint addEffectSlot(ALenum type)
+    {
+        ALuint effect{}, slot{};
+        alGenEffects(1, &effect);
+        alEffecti(effect, AL_EFFECT_TYPE, type);
+        alGenAuxiliaryEffectSlots(1, &slot);
+        alAuxiliaryEffectSloti(slot, AL_EFFECTSLOT_EFFECT, static_cast<ALint>(effect));
+        mEffects.push_back(effect);
+        mSlots.push_back(slot);
+        return slot;
+    }
+
+    /* Effect slot buffers are prepared in the background, and the mixer
+     * switches to the new state during an update after that. This renders
+     * (before any source is playing) until it has.
+     */
+    bool waitForSlotBuffer()
+    {
+        std::vector<float> output(static_cast<size_t>(UpdateSize*mChannels));
+        const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+        while(!mSlotReady.load())
+        {
+            if(std::chrono::steady_clock::now() > timeout)
+                return false;
+            alcRenderSamplesSOFT(mDevice, output.data(), UpdateSize);
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        return true;
+    }
+
+    std::vector<float> render()
+    {
+        for(SourceMotion &motion : mSources)
+        {
+            motion.update();
+            alSourcePlay(motion.mSource);
+        }
+        EXPECT_EQ(alGetError(), AL_NO_ERROR);
+
+        std::vector<float> output(static_cast<size_t>(UpdateSize*NumUpdates*mChannels));
+        for(ALCsizei i{0};i < NumUpdates;++i)
+        {
+            alcRenderSamplesSOFT(mDevice, &output[static_cast<size_t>(i*UpdateSize*mChannels)],
+                UpdateSize);
+            for(SourceMotion &motion : mSources)
+                motion.update();
+        }
+        return output;
+    }
+};
+
+
+std::string referencePath(const std::string_view name)
+{
+    std::string path{GOLDEN_REFERENCE_DIR};
+    path += '/';
+    path += name;
+    path += ".f32";
+    return path;
+}
+
+bool isLittleEndian()
+{
+    const uint16_t val{1};
+    unsigned char byte{};
+    std::memcpy(&byte, &val, 1);
+    return byte == 1;
+}
+
+uint32_t byteSwap(uint32_t val)
+{
+    return (val>>24) | ((val>>8)&0xff00u) | ((val<<8)&0xff0000u) | (val<<24);
+}
+
+/* Converts between native floats and the little-endian file data. */
+void swapSamples(std::vector<float> &samples)
+{
+    if(isLittleEndian()) return;
+    for(float &sample : samples)
+    {
+        uint32_t bits{};
+        std::memcpy(&bits, &sample, sizeof(bits));
+        bits = byteSwap(bits);
+        std::memcpy(&sample, &bits, sizeof(bits));
+    }
+}
+
+void checkReference(const std::string_view name, std::vector<float> output)
+{
+    const std::string path{referencePath(name)};
+    if(isUpdateMode())
+    {
+        swapSamples(output);
+        std::ofstream file{path, std::ios::binary | std::ios::trunc};
+        ASSERT_TRUE(file.is_open()) << "Failed to create " << path;
+        file.write(reinterpret_cast<const char*>(output.data()),
+            static_cast<std::streamsize>(output.size()*sizeof(float)));
+        ASSERT_TRUE(file.good()) << "Failed to write " << path;
+        return;
+    }
+
+    std::ifstream file{path, std::ios::binary};
+    ASSERT_TRUE(file.is_open()) << "Missing reference " << path
+        << " (render it with ALSOFT_GOLDEN_UPDATE=1)";
+    std::vector<float> reference(output.size());
+    file.read(reinterpret_cast<char*>(reference.data()),
+        static_cast<std::streamsize>(reference.size()*sizeof(float)));
+    ASSERT_EQ(static_cast<size_t>(file.gcount()), reference.size()*sizeof(float))
+        << "Reference " << path << " is too short";
+    ASSERT_EQ(file.peek(), std::ifstream::traits_type::eof())
+        << "Reference " << path << " is too long";
+    swapSamples(reference);
+
+    size_t mismatches{0}, firstidx{0};
+    float maxdiff{0.0f};
+    const bool exact{isExactMode()};
+    for(size_t i{0};i < output.size();++i)
+    {
+        const float diff{std::fabs(output[i] - reference[i])};
+        const bool mismatch{exact ? std::memcmp(&output[i], &reference[i], sizeof(float)) != 0
+            : !(diff <= SimdTolerance)};
+        if(mismatch)
+        {
+            if(mismatches++ == 0) firstidx = i;
+        }
+        if(!(diff <= maxdiff)) maxdiff = diff;
+    }
+    EXPECT_EQ(mismatches, 0u) << (exact ? "Bit-exact" : "Tolerance") << " comparison with "
+        << path << " failed; first mismatch at sample " << firstidx << " (got "
+        << output[firstidx] << ", expected " << reference[firstidx] << "), max difference "
+        << maxdiff;
+}
+
+
+class GoldenTest : public ::testing::Test {
+protected:
+    Scene mScene;
+};
+
+TEST_F(GoldenTest, StereoPanning)
+{
+    ASSERT_TRUE(mScene.open({ALC_FORMAT_CHANNELS_SOFT, ALC_STEREO_SOFT, ALC_HRTF_SOFT, ALC_FALSE,
+        ALC_OUTPUT_MODE_SOFT, ALC_STEREO_BASIC_SOFT}, 2));
+    mScene.addSources(8);
+    checkReference("stereo_panning", mScene.render());
+}
+
+TEST_F(GoldenTest, StereoHrtf)
+{
+    ASSERT_TRUE(mScene.open({ALC_FORMAT_CHANNELS_SOFT, ALC_STEREO_SOFT, ALC_HRTF_SOFT, ALC_TRUE},
+        2));
+    ALCint hrtf{};
+    alcGetIntegerv(mScene.mDevice, ALC_HRTF_SOFT, 1, &hrtf);
+    ASSERT_EQ(hrtf, ALC_TRUE);
+    mScene.addSources(4);
+    checkReference("stereo_hrtf", mScene.render());
+}
+
+TEST_F(GoldenTest, StereoUhj)
+{
+    ASSERT_TRUE(mScene.open({ALC_FORMAT_CHANNELS_SOFT, ALC_STEREO_SOFT, ALC_HRTF_SOFT, ALC_FALSE,
+        ALC_OUTPUT_MODE_SOFT, ALC_STEREO_UHJ_SOFT}, 2));
+    mScene.addSources(4);
+    checkReference("stereo_uhj", mScene.render());
+}
+
+/* Low-passed sources sending to a reverb, with 5.1 output. */
+TEST_F(GoldenTest, Surround51Reverb)
+{
+    ASSERT_TRUE(mScene.open({ALC_FORMAT_CHANNELS_SOFT, ALC_5POINT1_SOFT,
+        ALC_MAX_AUXILIARY_SENDS, 1}, 6));
+    mScene.addSources(4);
+
+    const ALuint slot{mScene.addEffectSlot(AL_EFFECT_EAXREVERB)};
+    ALuint filter{};
+    alGenFilters(1, &filter);
+    mScene.mFilters.push_back(filter);
+    alFilteri(filter, AL_FILTER_TYPE, AL_FILTER_LOWPASS);
+    alFilterf(filter, AL_LOWPASS_GAIN, 0.75f);
+    alFilterf(filter, AL_LOWPASS_GAINHF, 0.25f);
+    for(const SourceMotion &motion : mScene.mSources)
+    {
+        alSourcei(motion.mSource, AL_DIRECT_FILTER, static_cast<ALint>(filter));
+        alSource3i(motion.mSource, AL_AUXILIARY_SEND_FILTER, static_cast<ALint>(slot), 0,
+            AL_FILTER_NULL);
+    }
+    checkReference("surround51_reverb", mScene.render());
+}
+
+/* Sources sending to a convolution reverb, with first-order ambisonic output. */
+TEST_F(GoldenTest, AmbisonicConvolution)
+{
+    ASSERT_TRUE(mScene.open({ALC_FORMAT_CHANNELS_SOFT, ALC_BFORMAT3D_SOFT,
+        ALC_AMBISONIC_LAYOUT_SOFT, ALC_ACN_SOFT, ALC_AMBISONIC_SCALING_SOFT, ALC_SN3D_SOFT,
+        ALC_AMBISONIC_ORDER_SOFT, 1, ALC_MAX_AUXILIARY_SENDS, 1}, 4));
+    mScene.addSources(2);
+
+    const ALuint irbuffer{createNoiseBuffer(AL_FORMAT_STEREO_FLOAT32, 2, 2048, 1234u, 0.997f)};
+    mScene.mBuffers.push_back(irbuffer);
+    const ALuint slot{mScene.addEffectSlot(AL_EFFECT_CONVOLUTION_SOFT)};
+    alAuxiliaryEffectSloti(slot, AL_BUFFER, static_cast<ALint>(irbuffer));
+    ASSERT_TRUE(mScene.waitForSlotBuffer());
+    for(const SourceMotion &motion : mScene.mSources)
+        alSource3i(motion.mSource, AL_AUXILIARY_SEND_FILTER, static_cast<ALint>(slot), 0,
+            AL_FILTER_NULL);
+    checkReference("ambi1_convolution", mScene.render());
+}
+
+} // namespace
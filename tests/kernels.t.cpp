@@ -0,0 +1,551 @@
+#include "config.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include "alnumeric.h"
+#include "alspan.h"
+#include "core/bsinc_defs.h"
+#include "core/bsinc_tables.h"
+#include "core/bufferline.h"
+#include "core/cpu_caps.h"
+#include "core/cubic_tables.h"
+#include "core/mixer/defs.h"
+#include "core/mixer/hrtfdefs.h"
+#include "core/mixer/instsets.h"
+#include "core/resampler_limits.h"
+
+/* Compares each instruction set's version of the mixer kernels against the C
+ * version, for the instruction sets that were built and the CPU supports.
+ * Floating-point operations may be ordered differently, so the results only
+ * need to be close, except for the integer ADPCM decoding.
+ */
+
+struct PointTag;
+struct LerpTag;
+struct CubicTag;
+struct BSincTag;
+struct FastBSincTag;
+struct BSincPolyTag;
+struct FastBSincPolyTag;
+
+namespace {
+
+using uint = unsigned int;
+
+constexpr float Tolerance{1.0f / 65536.0f};
+
+constexpr uint ResampleIncrement{static_cast<uint>(44100_u64*MixerFracOne / 48000)};
+constexpr uint DownsampleIncrement{static_cast<uint>(96000_u64*MixerFracOne / 44100)};
+constexpr uint PolyIncrement{MixerFracOne / 2};
+
+constexpr size_t MixChannels{8};
+
+
+void FillNoise(const al::span<float> buffer, unsigned int seed=22050u)
+{
+    std::mt19937 rng{seed};
+    std::uniform_real_distribution<float> dist{-1.0f, 1.0f};
+    for(float &sample : buffer)
+        sample = dist(rng);
+}
+
+float MaxDifference(const al::span<const float> a, const al::span<const float> b)
+{
+    float maxdiff{0.0f};
+    for(size_t i{0};i < a.size();++i)
+        maxdiff = std::max(maxdiff, std::fabs(a[i] - b[i]));
+    return maxdiff;
+}
+
+template<size_t N>
+float MaxDifference(const std::vector<std::array<float,N>> &a,
+    const std::vector<std::array<float,N>> &b)
+{
+    float maxdiff{0.0f};
+    for(size_t i{0};i < a.size();++i)
+        maxdiff = std::max(maxdiff, MaxDifference(al::span{a[i]}, al::span{b[i]}));
+    return maxdiff;
+}
+
+
+class KernelTest : public ::testing::Test {
+protected:
+    void SetUp() override
+    {
+        if(auto cpuinfo = GetCPUInfo())
+            CPUCapFlags = cpuinfo->mCaps;
+    }
+};
+
+
+/* Same as the BsincPrepare the mixer uses. */
+void PrepareBsinc(const uint increment, BsincState *state, const BSincTable &table)
+{
+    size_t si{BSincScaleCount - 1};
+    float sf{0.0f};
+
+    if(increment > MixerFracOne)
+    {
+        sf = MixerFracOne/static_cast<float>(increment) - table.scaleBase;
+        sf = std::max(0.0f, BSincScaleCount*sf*table.scaleRange - 1.0f);
+        si = float2uint(sf);
+        sf = 1.0f - std::cos(std::asin(sf - static_cast<float>(si)));
+    }
+
+    state->sf = sf;
+    state->m = table.m[si];
+    state->l = (state->m/2) - 1;
+    state->filter = table.Tab.subspan(table.filterOffset[si]);
+}
+
+auto MakeInterpState(Resampler resampler, uint increment) -> InterpState
+{
+    InterpState state;
+    switch(resampler)
+    {
+    case Resampler::Point:
+    case Resampler::Linear:
+        break;
+    case Resampler::Spline:
+        state.emplace<CubicState>(al::span{GetSplineTable().mTable});
+        break;
+    case Resampler::Gaussian:
+        state.emplace<CubicState>(al::span{GetGaussianTable().mTable});
+        break;
+    case Resampler::FastBSinc12:
+    case Resampler::BSinc12:
+        PrepareBsinc(increment, &state.emplace<BsincState>(), GetBSinc12Table());
+        break;
+    case Resampler::FastBSinc24:
+    case Resampler::BSinc24:
+        PrepareBsinc(increment, &state.emplace<BsincState>(), GetBSinc24Table());
+        break;
+    }
+    return state;
+}
+
+template<typename TypeTag, typename ...InstTags>
+void CheckResampler(Resampler resampler, uint increment)
+{
+    const InterpState istate{MakeInterpState(resampler, increment)};
+
+    std::vector<float> src(BufferLineSize*3 + MaxResamplerPadding);
+    FillNoise(src);
+    /* Start with a fractional offset, and an odd length to cover the SIMD
+     * remainders.
+     */
+    static constexpr size_t DstSize{BufferLineSize - 3};
+    static constexpr uint Frac{MixerFracOne / 3};
+    std::vector<float> expected(DstSize);
+    Resample_<TypeTag,CTag>(&istate, src, Frac, increment, expected);
+
+    ForEachInstSet<InstTags...>([&](auto inst)
+    {
+        using InstT = decltype(inst);
+        SCOPED_TRACE(InstT::Name);
+        std::vector<float> dst(DstSize);
+        Resample_<TypeTag,typename InstT::Tag>(&istate, src, Frac, increment, dst);
+        EXPECT_LE(MaxDifference(expected, dst), Tolerance);
+    });
+}
+
+TEST_F(KernelTest, ResampleLerp)
+{
+    CheckResampler<LerpTag,SSE2Tag,SSE4Tag,AVX2Tag,NEONTag>(Resampler::Linear,
+        ResampleIncrement);
+    CheckResampler<LerpTag,SSE2Tag,SSE4Tag,AVX2Tag,NEONTag>(Resampler::Linear,
+        DownsampleIncrement);
+}
+
+TEST_F(KernelTest, ResampleCubic)
+{
+    CheckResampler<CubicTag,SSETag,SSE2Tag,SSE4Tag,AVX2Tag,NEONTag>(Resampler::Gaussian,
+        ResampleIncrement);
+    CheckResampler<CubicTag,SSETag,SSE2Tag,SSE4Tag,AVX2Tag,NEONTag>(Resampler::Spline,
+        DownsampleIncrement);
+}
+
+TEST_F(KernelTest, ResampleBSinc)
+{
+    CheckResampler<FastBSincTag,SSETag,AVX2Tag,NEONTag>(Resampler::FastBSinc24,
+        ResampleIncrement);
+    CheckResampler<BSincTag,SSETag,AVX2Tag,NEONTag>(Resampler::BSinc24, DownsampleIncrement);
+    CheckResampler<FastBSincTag,SSETag,AVX2Tag,NEONTag>(Resampler::FastBSinc12,
+        ResampleIncrement);
+    CheckResampler<BSincTag,SSETag,AVX2Tag,NEONTag>(Resampler::BSinc12, DownsampleIncrement);
+}
+
+TEST_F(KernelTest, ResampleBSincPoly)
+{
+    CheckResampler<FastBSincPolyTag,SSETag,AVX2Tag>(Resampler::FastBSinc24, PolyIncrement);
+    CheckResampler<BSincPolyTag,SSETag,AVX2Tag>(Resampler::BSinc24, PolyIncrement);
+}
+
+
+/* Mixes a line to multiple outputs, fading over part of the line so both the
+ * fading and steady paths are used. The SIMD mixers need the output position
+ * to keep the lines aligned.
+ */
+TEST_F(KernelTest, Mix)
+{
+    static constexpr size_t Fade{BufferLineSize/2 + 1};
+    static constexpr size_t OutPos{4};
+    std::vector<float> input(BufferLineSize - OutPos);
+    FillNoise(input);
+    std::array<float,MixChannels> targetGains{};
+    FillNoise(targetGains, 1u);
+
+    auto mix = [&](auto fn)
+    {
+        std::vector<FloatBufferLine> output(MixChannels);
+        std::array<float,MixChannels> currentGains{};
+        std::fill(currentGains.begin(), currentGains.end(), 0.25f);
+        fn(input, output, currentGains, targetGains, Fade, OutPos);
+        return output;
+    };
+    using MixFunc = void(*)(const al::span<const float>, const al::span<FloatBufferLine>,
+        const al::span<float>, const al::span<const float>, const size_t, const size_t);
+    const auto expected = mix(static_cast<MixFunc>(Mix_<CTag>));
+
+    ForEachInstSet<SSETag,AVX2Tag,NEONTag>([&](auto inst)
+    {
+        using InstT = decltype(inst);
+        SCOPED_TRACE(InstT::Name);
+        const auto output = mix(static_cast<MixFunc>(Mix_<typename InstT::Tag>));
+        EXPECT_LE(MaxDifference(expected, output), Tolerance);
+    });
+}
+
+TEST_F(KernelTest, MixLine)
+{
+    static constexpr size_t Fade{BufferLineSize/2 + 1};
+    std::vector<float> input(BufferLineSize - 3);
+    FillNoise(input);
+
+    auto mix = [&](auto fn)
+    {
+        std::vector<float> output(input.size());
+        float currentGain{0.25f};
+        fn(input, output, currentGain, 0.75f, Fade);
+        return output;
+    };
+    using MixLineFunc = void(*)(const al::span<const float>, const al::span<float>, float&,
+        const float, const size_t);
+    const auto expected = mix(static_cast<MixLineFunc>(Mix_<CTag>));
+
+    ForEachInstSet<SSETag,AVX2Tag,NEONTag>([&](auto inst)
+    {
+        using InstT = decltype(inst);
+        SCOPED_TRACE(InstT::Name);
+        const auto output = mix(static_cast<MixLineFunc>(Mix_<typename InstT::Tag>));
+        EXPECT_LE(MaxDifference(expected, output), Tolerance);
+    });
+}
+
+TEST_F(KernelTest, MixBatch)
+{
+    static constexpr size_t Fade{BufferLineSize/2 + 1};
+    std::array<std::vector<float>,MaxMixBatchInputs> inputs;
+    std::array<std::array<float,MixChannels>,MaxMixBatchInputs> targetGains{};
+    for(size_t i{0};i < MaxMixBatchInputs;++i)
+    {
+        inputs[i].resize(BufferLineSize - 7);
+        FillNoise(inputs[i], static_cast<uint>(i+1));
+        FillNoise(targetGains[i], static_cast<uint>(i+100));
+    }
+
+    auto mix = [&](auto fn)
+    {
+        std::array<std::array<float,MixChannels>,MaxMixBatchInputs> currentGains{};
+        std::array<MixBatchInput,MaxMixBatchInputs> batch{};
+        for(size_t i{0};i < MaxMixBatchInputs;++i)
+            batch[i] = MixBatchInput{inputs[i], currentGains[i], targetGains[i]};
+        std::vector<FloatBufferLine> output(MixChannels);
+        fn(batch, output, Fade, 4);
+        return output;
+    };
+    const auto expected = mix(MixBatch_<CTag>);
+
+    ForEachInstSet<SSETag>([&](auto inst)
+    {
+        using InstT = decltype(inst);
+        SCOPED_TRACE(InstT::Name);
+        EXPECT_LE(MaxDifference(expected, mix(MixBatch_<typename InstT::Tag>)), Tolerance);
+    });
+}
+
+
+/* The HRTF mixes are checked with the shortest, longest, and a middle IR
+ * size. IR sizes are always rounded up to a multiple of 2.
+ */
+struct HrtfMixData {
+    std::vector<float> mInput;
+    alignas(16) HrirArray mCoeffs{};
+    HrtfFilter mOldParams{};
+
+    HrtfMixData() : mInput(HrtfHistoryLength + BufferLineSize)
+    {
+        FillNoise(mInput);
+        std::vector<float> coeffs(HrirLength*2);
+        FillNoise(coeffs, 44100u);
+        for(size_t i{0};i < HrirLength;++i)
+            mCoeffs[i] = float2{{coeffs[i*2]*0.1f, coeffs[i*2 + 1]*0.1f}};
+        mOldParams.Coeffs = mCoeffs;
+        mOldParams.Delay = uint2{{4u, 12u}};
+        mOldParams.Gain = 0.5f;
+    }
+};
+
+std::vector<float> FlattenAccum(const std::vector<float2> &accum)
+{
+    std::vector<float> ret;
+    ret.reserve(accum.size()*2);
+    for(const float2 &val : accum)
+        ret.insert(ret.end(), val.begin(), val.end());
+    return ret;
+}
+
+TEST_F(KernelTest, MixHrtf)
+{
+    const HrtfMixData data;
+    const MixHrtfFilter params{data.mCoeffs, uint2{{8u, 2u}}, 0.5f, -0.25f/BufferLineSize};
+
+    for(const uint irSize : {uint{MinIrLength}, 30u, uint{HrirLength}})
+    {
+        SCOPED_TRACE("IR size " + std::to_string(irSize));
+        auto mix = [&](auto fn)
+        {
+            std::vector<float2> accum(BufferLineSize + HrirLength);
+            fn(data.mInput, accum, irSize, &params, BufferLineSize);
+            return FlattenAccum(accum);
+        };
+        const auto expected = mix(MixHrtf_<CTag>);
+
+        ForEachInstSet<SSETag,AVX2Tag,NEONTag>([&](auto inst)
+        {
+            using InstT = decltype(inst);
+            SCOPED_TRACE(InstT::Name);
+            EXPECT_LE(MaxDifference(expected, mix(MixHrtf_<typename InstT::Tag>)), Tolerance);
+        });
+    }
+}
+
+TEST_F(KernelTest, MixHrtfBlend)
+{
+    const HrtfMixData data;
+    const MixHrtfFilter params{data.mCoeffs, uint2{{8u, 2u}}, 0.0f, 0.5f/BufferLineSize};
+
+    for(const uint irSize : {uint{MinIrLength}, 30u, uint{HrirLength}})
+    {
+        SCOPED_TRACE("IR size " + std::to_string(irSize));
+        auto mix = [&](auto fn)
+        {
+            std::vector<float2> accum(BufferLineSize + HrirLength);
+            fn(data.mInput, accum, irSize, &data.mOldParams, &params, BufferLineSize);
+            return FlattenAccum(accum);
+        };
+        const auto expected = mix(MixHrtfBlend_<CTag>);
+
+        ForEachInstSet<SSETag,AVX2Tag,NEONTag>([&](auto inst)
+        {
+            using InstT = decltype(inst);
+            SCOPED_TRACE(InstT::Name);
+            EXPECT_LE(MaxDifference(expected, mix(MixHrtfBlend_<typename InstT::Tag>)),
+                Tolerance);
+        });
+    }
+}
+
+TEST_F(KernelTest, MixDirectHrtf)
+{
+    static constexpr size_t NumChannels{4};
+
+    std::vector<FloatBufferLine> input(NumChannels);
+    for(size_t i{0};i < NumChannels;++i)
+        FillNoise(input[i], static_cast<uint>(i+1));
+    std::vector<float> coeffs(HrirLength*2);
+
+    for(const size_t irSize : {size_t{MinIrLength}, size_t{30}, size_t{HrirLength}})
+    {
+        SCOPED_TRACE("IR size " + std::to_string(irSize));
+        auto mix = [&](auto fn)
+        {
+            std::vector<HrtfChannelState> chanState(NumChannels);
+            for(size_t c{0};c < NumChannels;++c)
+            {
+                FillNoise(coeffs, static_cast<uint>(100+c));
+                chanState[c].mSplitter.init(400.0f / 48000.0f);
+                chanState[c].mHfScale = 0.75f;
+                for(size_t i{0};i < HrirLength;++i)
+                    chanState[c].mCoeffs[i] = float2{{coeffs[i*2]*0.1f, coeffs[i*2 + 1]*0.1f}};
+            }
+            std::vector<float2> accum(BufferLineSize + HrirLength);
+            alignas(16) FloatBufferLine tempBuf{};
+            std::vector<FloatBufferLine> output(2);
+            fn(output[0], output[1], input, accum, tempBuf, chanState, irSize, BufferLineSize);
+            return output;
+        };
+        const auto expected = mix(MixDirectHrtf_<CTag>);
+
+        ForEachInstSet<SSETag,AVX2Tag,NEONTag>([&](auto inst)
+        {
+            using InstT = decltype(inst);
+            SCOPED_TRACE(InstT::Name);
+            EXPECT_LE(MaxDifference(expected, mix(MixDirectHrtf_<typename InstT::Tag>)),
+                Tolerance);
+        });
+    }
+}
+
+/* Decodes one channel of stereo IMA4 data, starting partway into a block. */
+TEST_F(KernelTest, LoadIMA4)
+{
+    static constexpr size_t NumChannels{2};
+    static constexpr size_t SamplesPerBlock{65};
+    static constexpr size_t BlockBytes{((SamplesPerBlock-1)/2 + 4) * NumChannels};
+    static constexpr size_t NumBlocks{(BufferLineSize+SamplesPerBlock-1)/SamplesPerBlock + 1};
+
+    std::vector<float> noise(BlockBytes*NumBlocks);
+    FillNoise(noise);
+    std::vector<std::byte> src(noise.size());
+    std::transform(noise.cbegin(), noise.cend(), src.begin(),
+        [](const float val) { return static_cast<std::byte>(float2int(val*127.0f)); });
+    /* Keep the block headers' step indices in range. */
+    for(size_t b{0};b < NumBlocks;++b)
+    {
+        for(size_t c{0};c < NumChannels;++c)
+            src[b*BlockBytes + c*4 + 2] = std::byte{static_cast<unsigned char>((b*7 + c*3)%89)};
+    }
+
+    auto decode = [&](auto fn)
+    {
+        std::vector<float> dst(BufferLineSize);
+        fn(dst, src, 1, 10, NumChannels, SamplesPerBlock);
+        return dst;
+    };
+    const auto expected = decode(LoadIMA4_<CTag>);
+
+    ForEachInstSet<SSE4Tag>([&](auto inst)
+    {
+        using InstT = decltype(inst);
+        SCOPED_TRACE(InstT::Name);
+        EXPECT_EQ(expected, decode(LoadIMA4_<typename InstT::Tag>));
+    });
+}
+
+/* Decodes random IMA4 data with random offsets and lengths, for mono and
+ * stereo with a range of block sizes. The header step indices are random too,
+ * so the decoders also need to clamp them the same way.
+ */
+TEST_F(KernelTest, LoadIMA4Random)
+{
+    std::mt19937 rng{16807u};
+    for(const size_t numchans : {size_t{1}, size_t{2}})
+    {
+        for(const size_t blocksamples : {size_t{9}, size_t{17}, size_t{65}, size_t{129},
+            size_t{1017}})
+        {
+            const size_t blockbytes{((blocksamples-1)/2 + 4) * numchans};
+            const size_t maxoffset{blocksamples*3};
+            const size_t numblocks{(maxoffset+BufferLineSize)/blocksamples + 1};
+
+            std::vector<std::byte> src(blockbytes*numblocks);
+            std::uniform_int_distribution<int> bytedist{0, 255};
+            std::generate(src.begin(), src.end(),
+                [&]{ return static_cast<std::byte>(bytedist(rng)); });
+
+            std::uniform_int_distribution<size_t> offsetdist{0, maxoffset};
+            std::uniform_int_distribution<size_t> lendist{1, BufferLineSize};
+            for(size_t iter{0};iter < 16;++iter)
+            {
+                const size_t chan{iter % numchans};
+                const size_t offset{offsetdist(rng)};
+                const size_t len{lendist(rng)};
+                SCOPED_TRACE(testing::Message() << numchans << " channel(s), " << blocksamples
+                    << " samples per block, channel " << chan << ", offset " << offset
+                    << ", length " << len);
+
+                auto decode = [&](auto fn)
+                {
+                    std::vector<float> dst(len);
+                    fn(dst, src, chan, offset, numchans, blocksamples);
+                    return dst;
+                };
+                const auto expected = decode(LoadIMA4_<CTag>);
+
+                ForEachInstSet<SSE4Tag>([&](auto inst)
+                {
+                    using InstT = decltype(inst);
+                    SCOPED_TRACE(InstT::Name);
+                    EXPECT_EQ(expected, decode(LoadIMA4_<typename InstT::Tag>));
+                });
+            }
+        }
+    }
+}
+
+template<typename T>
+auto AsBytes(const T &samples) -> al::span<const std::byte>
+{
+    return {reinterpret_cast<const std::byte*>(samples.data()),
+        samples.size()*sizeof(typename T::value_type)};
+}
+
+/* Converts one channel of interleaved half-precision samples, with an odd
+ * length to cover the SIMD remainders.
+ */
+TEST_F(KernelTest, LoadHalf)
+{
+    static constexpr size_t NumSamples{BufferLineSize - 3};
+
+    /* Check some exact conversions first, including subnormals. */
+    const std::array<uint16_t,6> known{{0x3c00, 0xc000, 0x0001, 0x83ff, 0x7bff, 0x7c00}};
+    std::vector<float> dst(known.size());
+    LoadHalf_<CTag>(dst, AsBytes(known), 0, 0, 1);
+    EXPECT_EQ(dst[0], 1.0f);
+    EXPECT_EQ(dst[1], -2.0f);
+    EXPECT_EQ(dst[2], std::ldexp(1.0f, -24));
+    EXPECT_EQ(dst[3], -std::ldexp(1023.0f, -24));
+    EXPECT_EQ(dst[4], 65504.0f);
+    EXPECT_TRUE(std::isinf(dst[5]));
+
+    /* Then random finite values, for each channel of mono and stereo data. */
+    std::mt19937 rng{44100u};
+    std::uniform_int_distribution<uint16_t> dist{0, 0x7bff};
+    std::vector<uint16_t> src((NumSamples+8)*2);
+    std::generate(src.begin(), src.end(), [&]
+    { return static_cast<uint16_t>(dist(rng) | ((rng()&1) << 15)); });
+
+    for(const size_t step : {1_uz, 2_uz})
+    {
+        for(size_t chan{0};chan < step;++chan)
+        {
+            auto load = [&](auto fn)
+            {
+                std::vector<float> ret(NumSamples);
+                fn(ret, AsBytes(src), chan, 5, step);
+                return ret;
+            };
+            const auto expected = load(LoadHalf_<CTag>);
+
+            ForEachInstSet<AVX2Tag,NEONTag>([&](auto inst)
+            {
+                using InstT = decltype(inst);
+                SCOPED_TRACE(InstT::Name);
+                EXPECT_EQ(expected, load(LoadHalf_<typename InstT::Tag>));
+            });
+        }
+    }
+}
+
+} // namespace
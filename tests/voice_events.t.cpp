@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+
+#define AL_ALEXT_PROTOTYPES
+#include <AL/al.h>
+#include <AL/alc.h>
+#include <AL/alext.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <thread>
+#include <vector>
+
+/* Checks the events sent for voices that end while being mixed in parallel.
+ * This runs with mix-threads set in voice_events.conf, so the voices get split
+ * between the mixer thread and the worker threads, and many of them stop in
+ * the same update. Each source must get exactly one buffer-completed event
+ * and one stopped event for each time it plays, and the events must come in
+ * voice order, the same as with a serial mix.
+ */
+
+namespace {
+
+constexpr ALCint SampleRate{48000};
+constexpr ALCsizei UpdateSize{256};
+
+/* Enough sources for each of the mixer threads to get a share of them. */
+constexpr std::size_t NumSources{200};
+constexpr int NumRounds{25};
+
+struct EventCounts {
+    std::map<ALuint,std::size_t> mIndices;
+    std::vector<std::atomic<int>> mCompleted;
+    std::vector<std::atomic<int>> mStopped;
+    std::atomic<int> mUnknown{0};
+
+    /* The sources in the order their stopped events were received. */
+    std::vector<std::size_t> mStopOrder;
+    std::atomic<std::size_t> mNumStops{0};
+
+    EventCounts()
+        : mCompleted(NumSources), mStopped(NumSources), mStopOrder(NumSources*NumRounds)
+    { }
+
+    static void AL_APIENTRY EventCallback(ALenum eventType, ALuint object, ALuint param,
+        ALsizei, const ALchar*, void *userParam) noexcept
+    {
+        auto *self = static_cast<EventCounts*>(userParam);
+        const auto iter = self->mIndices.find(object);
+        if(iter == self->mIndices.end())
+        {
+            self->mUnknown.fetch_add(1);
+            return;
+        }
+        if(eventType == AL_EVENT_TYPE_BUFFER_COMPLETED_SOFT)
+            self->mCompleted[iter->second].fetch_add(static_cast<int>(param));
+        else if(eventType == AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT && param == AL_STOPPED)
+        {
+            const std::size_t idx{self->mNumStops.load(std::memory_order_relaxed)};
+            if(idx < self->mStopOrder.size())
+            {
+                self->mStopOrder[idx] = iter->second;
+                self->mNumStops.store(idx+1, std::memory_order_release);
+            }
+            self->mStopped[iter->second].fetch_add(1);
+        }
+    }
+
+    bool waitFor(const int count) const
+    {
+        const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+        auto is_done = [count](const std::atomic<int> &val) { return val.load() >= count; };
+        while(!std::all_of(mCompleted.begin(), mCompleted.end(), is_done)
+            || !std::all_of(mStopped.begin(), mStopped.end(), is_done))
+        {
+            if(std::chrono::steady_clock::now() > timeout)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        return true;
+    }
+};
+
+TEST(VoiceEvents, ManyVoicesStopTogether)
+{
+    ALCdevice *device{alcLoopbackOpenDeviceSOFT(nullptr)};
+    ASSERT_NE(device, nullptr);
+    const ALCint attrs[]{ALC_FORMAT_CHANNELS_SOFT, ALC_STEREO_SOFT, ALC_FORMAT_TYPE_SOFT,
+        ALC_FLOAT_SOFT, ALC_FREQUENCY, SampleRate, ALC_MONO_SOURCES,
+        static_cast<ALCint>(NumSources), 0};
+    ALCcontext *context{alcCreateContext(device, attrs)};
+    ASSERT_NE(context, nullptr);
+    ASSERT_TRUE(alcMakeContextCurrent(context));
+
+    EventCounts counts;
+    std::vector<ALuint> sources(NumSources);
+    alGenSources(static_cast<ALsizei>(sources.size()), sources.data());
+    ASSERT_EQ(alGetError(), AL_NO_ERROR);
+    for(std::size_t i{0};i < sources.size();++i)
+        counts.mIndices.emplace(sources[i], i);
+
+    const ALenum evttypes[]{AL_EVENT_TYPE_BUFFER_COMPLETED_SOFT,
+        AL_EVENT_TYPE_SOURCE_STATE_CHANGED_SOFT};
+    alEventCallbackSOFT(EventCounts::EventCallback, &counts);
+    alEventControlSOFT(2, evttypes, AL_TRUE);
+
+    /* A buffer short enough for every source to finish within one update. */
+    const std::vector<float> data(64, 0.25f);
+    ALuint buffer{};
+    alGenBuffers(1, &buffer);
+    alBufferData(buffer, AL_FORMAT_MONO_FLOAT32, data.data(),
+        static_cast<ALsizei>(data.size()*sizeof(float)), SampleRate);
+
+    std::vector<float> output(static_cast<std::size_t>(UpdateSize*2));
+    for(int round{1};round <= NumRounds;++round)
+    {
+        /* Buffer-completed events are only sent for queued buffers. */
+        for(const ALuint source : sources)
+        {
+            alSourcei(source, AL_BUFFER, 0);
+            alSourceQueueBuffers(source, 1, &buffer);
+        }
+        alSourcePlayv(static_cast<ALsizei>(sources.size()), sources.data());
+        ASSERT_EQ(alGetError(), AL_NO_ERROR);
+        for(int i{0};i < 2;++i)
+            alcRenderSamplesSOFT(device, output.data(), UpdateSize);
+
+        ASSERT_TRUE(counts.waitFor(round)) << "Missing events in round " << round;
+
+        /* The events must come in the same order as a serial mix would send
+         * them, which is the order the sources were played in.
+         */
+        ASSERT_EQ(counts.mNumStops.load(std::memory_order_acquire), NumSources*static_cast<std::size_t>(round));
+        const std::size_t first{NumSources*static_cast<std::size_t>(round-1)};
+        for(std::size_t i{0};i < NumSources;++i)
+            ASSERT_EQ(counts.mStopOrder[first+i], i) << "Stop event " << i << " in round "
+                << round;
+        for(std::size_t i{0};i < sources.size();++i)
+        {
+            ASSERT_EQ(counts.mCompleted[i].load(), round) << "Source " << i;
+            ASSERT_EQ(counts.mStopped[i].load(), round) << "Source " << i;
+
+            ALint state{};
+            alGetSourcei(sources[i], AL_SOURCE_STATE, &state);
+            ASSERT_EQ(state, AL_STOPPED) << "Source " << i;
+        }
+    }
+    EXPECT_EQ(counts.mUnknown.load(), 0);
+
+    alEventControlSOFT(2, evttypes, AL_FALSE);
+    alEventCallbackSOFT(nullptr, nullptr);
+    alDeleteSources(static_cast<ALsizei>(sources.size()), sources.data());
+    alDeleteBuffers(1, &buffer);
+    alcMakeContextCurrent(nullptr);
+    alcDestroyContext(context);
+    alcCloseDevice(device);
+}
+
+} // namespace
@@ -0,0 +1,200 @@
+#include <gtest/gtest.h>
+
+#define AL_ALEXT_PROTOTYPES
+#include <AL/al.h>
+#include <AL/alc.h>
+#include <AL/alext.h>
+
+#include <cstddef>
+#include <vector>
+
+/* Plays sources through a loopback device to check that voices are found
+ * and allocated for them: when the first free voice mask word fills up, when
+ * stopped sources free their voices for others to reuse, and when more
+ * voices are needed than are allocated. A source is only counted as playing
+ * if its offset advances, which means the mixer has its voice.
+ */
+
+namespace {
+
+constexpr ALCint SampleRate{48000};
+constexpr ALCsizei UpdateSize{256};
+
+/* A context starts with 256 voices allocated, with room for 512 before the
+ * voice array needs to be replaced.
+ */
+constexpr std::size_t MaxSources{640};
+
+class VoiceTest : public ::testing::Test {
+protected:
+    ALCdevice *mDevice{};
+    ALCcontext *mContext{};
+    ALuint mBuffer{};
+    std::vector<ALuint> mSources;
+    std::vector<ALint> mOffsets;
+
+    void SetUp() override
+    {
+        mDevice = alcLoopbackOpenDeviceSOFT(nullptr);
+        ASSERT_NE(mDevice, nullptr);
+        const ALCint attrs[]{ALC_FORMAT_CHANNELS_SOFT, ALC_STEREO_SOFT, ALC_FORMAT_TYPE_SOFT,
+            ALC_FLOAT_SOFT, ALC_FREQUENCY, SampleRate, ALC_MONO_SOURCES,
+            static_cast<ALCint>(MaxSources), 0};
+        mContext = alcCreateContext(mDevice, attrs);
+        ASSERT_NE(mContext, nullptr);
+        ASSERT_TRUE(alcMakeContextCurrent(mContext));
+
+        /* A quiet looping buffer, long enough that the offsets don't wrap
+         * between checks.
+         */
+        const std::vector<float> data(static_cast<std::size_t>(SampleRate), 1.0f/1024.0f);
+        alGenBuffers(1, &mBuffer);
+        alBufferData(mBuffer, AL_FORMAT_MONO_FLOAT32, data.data(),
+            static_cast<ALsizei>(data.size()*sizeof(float)), SampleRate);
+
+        mSources.resize(MaxSources);
+        mOffsets.resize(MaxSources);
+        alGenSources(static_cast<ALsizei>(mSources.size()), mSources.data());
+        for(const ALuint source : mSources)
+        {
+            alSourcei(source, AL_BUFFER, static_cast<ALint>(mBuffer));
+            alSourcei(source, AL_LOOPING, AL_TRUE);
+        }
+        ASSERT_EQ(alGetError(), AL_NO_ERROR);
+
+        /* Let the mixer run once, so it sets up the free voice mask. */
+        render();
+    }
+
+    void TearDown() override
+    {
+        if(!mContext) return;
+        alDeleteSources(static_cast<ALsizei>(mSources.size()), mSources.data());
+        alDeleteBuffers(1, &mBuffer);
+        alcMakeContextCurrent(nullptr);
+        alcDestroyContext(mContext);
+        alcCloseDevice(mDevice);
+    }
+
+    void render()
+    {
+        std::vector<float> output(static_cast<std::size_t>(UpdateSize*2));
+        alcRenderSamplesSOFT(mDevice, output.data(), UpdateSize);
+    }
+
+    void play(const std::size_t first, const std::size_t count)
+    {
+        alSourcePlayv(static_cast<ALsizei>(count), &mSources[first]);
+        ASSERT_EQ(alGetError(), AL_NO_ERROR);
+    }
+
+    void stop(const std::size_t first, const std::size_t count)
+    {
+        alSourceStopv(static_cast<ALsizei>(count), &mSources[first]);
+        ASSERT_EQ(alGetError(), AL_NO_ERROR);
+    }
+
+    /* Renders an update, then checks that the sources in [0...numplaying)
+     * are playing with advancing offsets, and the rest are stopped or were
+     * never played.
+     */
+    void checkPlaying(const std::size_t numplaying)
+    {
+        for(std::size_t i{0};i < mSources.size();++i)
+            alGetSourcei(mSources[i], AL_SAMPLE_OFFSET, &mOffsets[i]);
+        render();
+        for(std::size_t i{0};i < mSources.size();++i)
+        {
+            ALint state{}, offset{};
+            alGetSourcei(mSources[i], AL_SOURCE_STATE, &state);
+            alGetSourcei(mSources[i], AL_SAMPLE_OFFSET, &offset);
+            if(i < numplaying)
+            {
+                ASSERT_EQ(state, AL_PLAYING) << "Source " << i;
+                ASSERT_NE(offset, mOffsets[i]) << "Source " << i << " isn't being mixed";
+            }
+            else
+                ASSERT_EQ(state, (i < mPlayed) ? AL_STOPPED : AL_INITIAL) << "Source " << i;
+        }
+    }
+
+    std::size_t mPlayed{0};
+};
+
+
+/* Fills the first mask word's worth of voices, then needs one more. */
+TEST_F(VoiceTest, MaskWordFull)
+{
+    play(0, 64);
+    mPlayed = 64;
+    checkPlaying(64);
+
+    play(64, 1);
+    mPlayed = 65;
+    checkPlaying(65);
+    checkPlaying(65);
+}
+
+/* Stops every other source, so their voices are freed, then plays new
+ * sources that can reuse them.
+ */
+TEST_F(VoiceTest, FreedVoicesReused)
+{
+    play(0, 128);
+    mPlayed = 128;
+    checkPlaying(128);
+
+    for(std::size_t i{0};i < 128;i += 2)
+        stop(i, 1);
+    render();
+    for(std::size_t i{0};i < 128;i += 2)
+    {
+        ALint state{};
+        alGetSourcei(mSources[i], AL_SOURCE_STATE, &state);
+        ASSERT_EQ(state, AL_STOPPED) << "Source " << i;
+    }
+
+    /* Restart the stopped sources along with as many new ones, so the freed
+     * voices get reused and more are needed.
+     */
+    for(std::size_t i{0};i < 128;i += 2)
+        play(i, 1);
+    play(128, 64);
+    mPlayed = 192;
+    checkPlaying(192);
+
+    /* Again, without rendering in between, so the voices freed since the
+     * last mix need to be found too.
+     */
+    stop(0, 192);
+    play(0, 192);
+    checkPlaying(192);
+}
+
+/* Plays more sources than there are voices allocated, first growing the
+ * voice array in place, then needing a new one, while the earlier sources
+ * keep playing.
+ */
+TEST_F(VoiceTest, VoiceCountGrowth)
+{
+    play(0, 200);
+    mPlayed = 200;
+    checkPlaying(200);
+
+    play(200, 100);
+    mPlayed = 300;
+    checkPlaying(300);
+
+    play(300, MaxSources-300);
+    mPlayed = MaxSources;
+    checkPlaying(MaxSources);
+    checkPlaying(MaxSources);
+
+    /* Free them all and play them again, with the voices already there. */
+    stop(0, MaxSources);
+    render();
+    play(0, MaxSources);
+    checkPlaying(MaxSources);
+}
+
+} // namespace
@@ -24,11 +24,11 @@
 #include "loadsofa.h"
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cmath>
 #include <cstdio>
-#include <functional>
 #include <future>
 #include <iterator>
 #include <memory>
@@ -37,6 +37,7 @@
 #include <string>
 #include <string_view>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include "alspan.h"
@@ -60,11 +61,11 @@ using uint = unsigned int;
  * possible.  Those sets that contain purely random measurements or use
  * different major axes will fail.
  */
-auto PrepareLayout(const al::span<const float> xyzs, HrirDataT *hData) -> bool
+auto PrepareLayout(const al::span<const std::array<double,3>> aers, HrirDataT *hData) -> bool
 {
     fprintf(stdout, "Detecting compatible layout...\n");
 
-    auto fds = GetCompatibleLayout(xyzs);
+    auto fds = GetCompatibleLayout(aers);
     if(fds.size() > MAX_FD_COUNT)
     {
         fprintf(stdout, "Incompatible layout (inumerable radii).\n");
@@ -92,7 +93,7 @@ auto PrepareLayout(const al::span<const float> xyzs, HrirDataT *hData) -> bool
 
         ++fi;
     }
-    fprintf(stdout, "Using %u of %zu IRs.\n", ir_total, xyzs.size()/3);
+    fprintf(stdout, "Using %u of %zu IRs.\n", ir_total, aers.size());
     const auto azs = al::span{azCounts}.first<MAX_FD_COUNT>();
     return PrepareHrirData(al::span{distances}.first(fi), evCounts, azs, hData);
 }
@@ -234,6 +235,50 @@ bool CheckIrData(MYSOFA_HRTF *sofaHrtf)
 }
 
 
+/* Calls a worker on each index up to count, spread over the given number of
+ * threads, while reporting the progress with the given label. Each thread
+ * gets its own worker from make_worker, for any per-thread state it needs.
+ */
+template<typename F>
+void RunWorkers(const char *label, const uint numThreads, const size_t count, F make_worker)
+{
+    std::atomic<size_t> current{0};
+    std::atomic<size_t> done{0};
+    auto thread_proc = [&current,&done,count,&make_worker]()
+    {
+        auto worker = make_worker();
+        /* Claim the next index atomically, so other threads go on to the
+         * one after.
+         */
+        size_t idx;
+        while((idx=current.fetch_add(1, std::memory_order_relaxed)) < count)
+        {
+            worker(idx);
+            done.fetch_add(1);
+        }
+    };
+
+    std::vector<std::thread> thrds;
+    thrds.reserve(numThreads);
+    for(size_t i{0};i < numThreads;++i)
+        thrds.emplace_back(thread_proc);
+    size_t num_done;
+    do {
+        std::this_thread::sleep_for(std::chrono::milliseconds{50});
+        num_done = done.load();
+
+        printf("\r%s... %zu of %zu", label, num_done, count);
+        fflush(stdout);
+    } while(num_done != count);
+    fputc('\n', stdout);
+
+    for(auto &thrd : thrds)
+    {
+        if(thrd.joinable())
+            thrd.join();
+    }
+}
+
 /* Calculate the onset time of a HRIR. */
 constexpr int OnsetRateMultiple{10};
 auto CalcHrirOnset(PPhaseResampler &rs, const uint rate, al::span<double> upsampled,
@@ -258,35 +303,28 @@ void CalcHrirMagnitude(const uint points, al::span<complex_d> h, const al::span<
     MagnitudeResponse(h, hrir.first((h.size()/2) + 1));
 }
 
-bool LoadResponses(MYSOFA_HRTF *sofaHrtf, HrirDataT *hData, const DelayType delayType,
-    const uint outRate)
+bool LoadResponses(MYSOFA_HRTF *sofaHrtf, const al::span<const std::array<double,3>> aers,
+    HrirDataT *hData, const DelayType delayType)
 {
     std::atomic<uint> loaded_count{0u};
 
-    auto load_proc = [sofaHrtf,hData,delayType,outRate,&loaded_count]() -> bool
+    auto load_proc = [sofaHrtf,aers,hData,delayType,&loaded_count]() -> bool
     {
         const uint channels{(hData->mChannelType == CT_STEREO) ? 2u : 1u};
         hData->mHrirsBase.resize(channels * size_t{hData->mIrCount} * hData->mIrSize, 0.0);
         const auto hrirs = al::span{hData->mHrirsBase};
 
-        std::vector<double> restmp;
-        std::optional<PPhaseResampler> resampler;
-        if(outRate && outRate != hData->mIrRate)
-        {
-            resampler.emplace().init(hData->mIrRate, outRate);
-            restmp.resize(sofaHrtf->N);
-        }
-
-        const auto srcPosValues = al::span{sofaHrtf->SourcePosition.values, sofaHrtf->M*3_uz};
         const auto irValues = al::span{sofaHrtf->DataIR.values,
             size_t{sofaHrtf->M}*sofaHrtf->R*sofaHrtf->N};
         for(uint si{0u};si < sofaHrtf->M;++si)
         {
             loaded_count.fetch_add(1u);
 
-            std::array aer{srcPosValues[3_uz*si], srcPosValues[3_uz*si + 1],
-                srcPosValues[3_uz*si + 2]};
-            mysofa_c2s(aer.data());
+            /* The positions were converted from single-precision values, so
+             * this is lossless.
+             */
+            std::array aer{static_cast<float>(aers[si][0]), static_cast<float>(aers[si][1]),
+                static_cast<float>(aers[si][2])};
 
             if(std::abs(aer[1]) >= 89.999f)
                 aer[0] = 0.0f;
@@ -326,13 +364,7 @@ bool LoadResponses(MYSOFA_HRTF *sofaHrtf, HrirDataT *hData, const DelayType dela
                     (size_t{hData->mIrCount}*ti + azd.mIndex) * hData->mIrSize, hData->mIrSize);
                 const auto ir = irValues.subspan((size_t{si}*sofaHrtf->R + ti)*sofaHrtf->N,
                     sofaHrtf->N);
-                if(!resampler)
-                    std::copy_n(ir.cbegin(), ir.size(), azd.mIrs[ti].begin());
-                else
-                {
-                    std::copy_n(ir.cbegin(), ir.size(), restmp.begin());
-                    resampler->process(restmp, azd.mIrs[ti]);
-                }
+                std::copy_n(ir.cbegin(), ir.size(), azd.mIrs[ti].begin());
             }
 
             /* Include any per-channel or per-HRIR delays. */
@@ -352,14 +384,6 @@ bool LoadResponses(MYSOFA_HRTF *sofaHrtf, HrirDataT *hData, const DelayType dela
                         static_cast<float>(hData->mIrRate);
             }
         }
-
-        if(outRate && outRate != hData->mIrRate)
-        {
-            const double scale{static_cast<double>(outRate) / hData->mIrRate};
-            hData->mIrRate = outRate;
-            hData->mIrPoints = std::min(static_cast<uint>(std::ceil(hData->mIrPoints*scale)),
-                hData->mIrSize);
-        }
         return true;
     };
 
@@ -374,49 +398,10 @@ bool LoadResponses(MYSOFA_HRTF *sofaHrtf, HrirDataT *hData, const DelayType dela
     return load_future.get();
 }
 
-
-/* Calculates the frequency magnitudes of the HRIR set. Work is delegated to
- * this struct, which runs asynchronously on one or more threads (sharing the
- * same calculator object).
- */
-struct MagCalculator {
-    const uint mFftSize{};
-    const uint mIrPoints{};
-    std::vector<al::span<double>> mIrs{};
-    std::atomic<size_t> mCurrent{};
-    std::atomic<size_t> mDone{};
-
-    void Worker()
-    {
-        auto htemp = std::vector<complex_d>(mFftSize);
-
-        while(true)
-        {
-            /* Load the current index to process. */
-            size_t idx{mCurrent.load()};
-            do {
-                /* If the index is at the end, we're done. */
-                if(idx >= mIrs.size())
-                    return;
-                /* Otherwise, increment the current index atomically so other
-                 * threads know to go to the next one. If this call fails, the
-                 * current index was just changed by another thread and the new
-                 * value is loaded into idx, which we'll recheck.
-                 */
-            } while(!mCurrent.compare_exchange_weak(idx, idx+1, std::memory_order_relaxed));
-
-            CalcHrirMagnitude(mIrPoints, htemp, mIrs[idx]);
-
-            /* Increment the number of IRs done. */
-            mDone.fetch_add(1);
-        }
-    }
-};
-
 } // namespace
 
-bool LoadSofaFile(const std::string_view filename, const uint numThreads, const uint fftSize,
-    const uint truncSize, const uint outRate, const ChannelModeT chanMode, HrirDataT *hData)
+bool LoadSofaFile(const std::string_view filename, const uint fftSize, const uint truncSize,
+    const ChannelModeT chanMode, HrirDataT *hData)
 {
     int err;
     MySofaHrtfPtr sofaHrtf{mysofa_load(std::string{filename}.c_str(), &err)};
@@ -480,9 +465,11 @@ bool LoadSofaFile(const std::string_view filename, const uint numThreads, const
 
     if(!CheckIrData(sofaHrtf.get()))
         return false;
-    if(!PrepareLayout(al::span{sofaHrtf->SourcePosition.values, sofaHrtf->M*3_uz}, hData))
+    const auto aers = GetSofaPositions(al::span{sofaHrtf->SourcePosition.values,
+        sofaHrtf->M*3_uz});
+    if(!PrepareLayout(aers, hData))
         return false;
-    if(!LoadResponses(sofaHrtf.get(), hData, *delayType, outRate))
+    if(!LoadResponses(sofaHrtf.get(), aers, hData, *delayType))
         return false;
     sofaHrtf = nullptr;
 
@@ -520,8 +507,7 @@ bool LoadSofaFile(const std::string_view filename, const uint numThreads, const
         }
     }
 
-
-    size_t hrir_total{0};
+    /* Give the missing elevations storage for the HRIRs to be synthesized. */
     const uint channels{(hData->mChannelType == CT_STEREO) ? 2u : 1u};
     const auto hrirs = al::span{hData->mHrirsBase};
     for(uint fi{0u};fi < hData->mFds.size();fi++)
@@ -536,50 +522,23 @@ bool LoadSofaFile(const std::string_view filename, const uint numThreads, const
                         hData->mIrSize);
             }
         }
-
-        for(uint ei{hData->mFds[fi].mEvStart};ei < hData->mFds[fi].mEvs.size();ei++)
-            hrir_total += hData->mFds[fi].mEvs[ei].mAzs.size() * channels;
     }
+    return true;
+}
 
-    std::atomic<size_t> hrir_done{0};
-    auto onset_proc = [hData,channels,&hrir_done]() -> bool
+void PrepareSofaHrirs(const uint outRate, const uint numThreads, HrirDataT *hData)
+{
+    size_t hrir_total{0};
+    const uint channels{(hData->mChannelType == CT_STEREO) ? 2u : 1u};
+    for(const auto &field : hData->mFds)
     {
-        /* Temporary buffer used to calculate the IR's onset. */
-        auto upsampled = std::vector<double>(size_t{OnsetRateMultiple} * hData->mIrPoints);
-        /* This resampler is used to help detect the response onset. */
-        PPhaseResampler rs;
-        rs.init(hData->mIrRate, OnsetRateMultiple*hData->mIrRate);
-
-        for(auto &field : hData->mFds)
-        {
-            for(auto &elev : field.mEvs.subspan(field.mEvStart))
-            {
-                for(auto &azd : elev.mAzs)
-                {
-                    for(uint ti{0};ti < channels;ti++)
-                    {
-                        hrir_done.fetch_add(1u, std::memory_order_acq_rel);
-                        azd.mDelays[ti] += CalcHrirOnset(rs, hData->mIrRate, upsampled,
-                            azd.mIrs[ti].first(hData->mIrPoints));
-                    }
-                }
-            }
-        }
-        return true;
-    };
-
-    std::future_status load_status{};
-    auto load_future = std::async(std::launch::async, onset_proc);
-    do {
-        load_status = load_future.wait_for(std::chrono::milliseconds{50});
-        printf("\rCalculating HRIR onsets... %zu of %zu", hrir_done.load(), hrir_total);
-        fflush(stdout);
-    } while(load_status != std::future_status::ready);
-    fputc('\n', stdout);
-    if(!load_future.get())
-        return false;
+        for(const auto &elev : field.mEvs.subspan(field.mEvStart))
+            hrir_total += elev.mAzs.size() * channels;
+    }
 
-    MagCalculator calculator{hData->mFftSize, hData->mIrPoints};
+    /* Each loaded HRIR, along with its delay. */
+    std::vector<std::pair<al::span<double>,double*>> loaded_irs;
+    loaded_irs.reserve(hrir_total);
     for(auto &field : hData->mFds)
     {
         for(auto &elev : field.mEvs.subspan(field.mEvStart))
@@ -587,29 +546,58 @@ bool LoadSofaFile(const std::string_view filename, const uint numThreads, const
             for(auto &azd : elev.mAzs)
             {
                 for(uint ti{0};ti < channels;ti++)
-                    calculator.mIrs.push_back(azd.mIrs[ti]);
+                    loaded_irs.emplace_back(azd.mIrs[ti], &azd.mDelays[ti]);
             }
         }
     }
 
-    std::vector<std::thread> thrds;
-    thrds.reserve(numThreads);
-    for(size_t i{0};i < numThreads;++i)
-        thrds.emplace_back(std::mem_fn(&MagCalculator::Worker), &calculator);
-    size_t count;
-    do {
-        std::this_thread::sleep_for(std::chrono::milliseconds{50});
-        count = calculator.mDone.load();
-
-        printf("\rCalculating HRIR magnitudes... %zu of %zu", count, calculator.mIrs.size());
-        fflush(stdout);
-    } while(count != calculator.mIrs.size());
-    fputc('\n', stdout);
-
-    for(auto &thrd : thrds)
+    if(outRate && outRate != hData->mIrRate)
     {
-        if(thrd.joinable())
-            thrd.join();
+        /* Resample the HRIRs in place, from a copy of their input samples. */
+        PPhaseResampler resampler;
+        resampler.init(hData->mIrRate, outRate);
+        const uint irPoints{hData->mIrPoints};
+        RunWorkers("Resampling HRIRs", numThreads, loaded_irs.size(),
+            [resampler,irPoints,&loaded_irs]()
+            {
+                return [rs=resampler,restmp=std::vector<double>(irPoints),&loaded_irs](
+                    const size_t idx) mutable
+                {
+                    const al::span<double> ir{loaded_irs[idx].first};
+                    std::copy_n(ir.cbegin(), restmp.size(), restmp.begin());
+                    rs.process(restmp, ir);
+                };
+            });
+
+        const double scale{static_cast<double>(outRate) / hData->mIrRate};
+        hData->mIrRate = outRate;
+        hData->mIrPoints = std::min(static_cast<uint>(std::ceil(hData->mIrPoints*scale)),
+            hData->mIrSize);
     }
-    return true;
+
+    /* Add the onset of each HRIR to its delay. */
+    RunWorkers("Calculating HRIR onsets", numThreads, loaded_irs.size(),
+        [hData,&loaded_irs]()
+        {
+            /* This resampler is used to help detect the response onset. */
+            PPhaseResampler rs;
+            rs.init(hData->mIrRate, OnsetRateMultiple*hData->mIrRate);
+            return [rs,hData,&loaded_irs,
+                upsampled=std::vector<double>(size_t{OnsetRateMultiple} * hData->mIrPoints)](
+                const size_t idx) mutable
+            {
+                auto [ir, delay] = loaded_irs[idx];
+                *delay += CalcHrirOnset(rs, hData->mIrRate, upsampled,
+                    ir.first(hData->mIrPoints));
+            };
+        });
+
+    /* Replace each HRIR with its magnitude response. */
+    RunWorkers("Calculating HRIR magnitudes", numThreads, loaded_irs.size(),
+        [hData,&loaded_irs]()
+        {
+            return [hData,&loaded_irs,htemp=std::vector<complex_d>(hData->mFftSize)](
+                const size_t idx) mutable
+            { CalcHrirMagnitude(hData->mIrPoints, htemp, loaded_irs[idx].first); };
+        });
 }
@@ -6,7 +6,17 @@
 #include "makemhr.h"
 
 
-bool LoadSofaFile(const std::string_view filename, const uint numThreads, const uint fftSize,
-    const uint truncSize, const uint outRate, const ChannelModeT chanMode, HrirDataT *hData);
+/* Loads the HRIRs from a SOFA file at the file's sample rate, along with any
+ * delays it specifies.
+ */
+bool LoadSofaFile(const std::string_view filename, const uint fftSize, const uint truncSize,
+    const ChannelModeT chanMode, HrirDataT *hData);
+
+/* Resamples the loaded HRIRs to the given rate (if not 0), adds their onsets
+ * to the delays, and replaces them with their magnitude responses. The loaded
+ * data may be copied with CopyHrirData first, to prepare it for more than one
+ * rate.
+ */
+void PrepareSofaHrirs(const uint outRate, const uint numThreads, HrirDataT *hData);
 
 #endif /* LOADSOFA_H */
@@ -96,6 +96,7 @@
 #include "win_main_utf8.h"
 
 
+HrirDataT::HrirDataT() = default;
 HrirDataT::~HrirDataT() = default;
 
 namespace {
@@ -1145,66 +1146,49 @@ bool PrepareHrirData(const al::span<const double> distances,
 }
 
 
-namespace {
-
-/* Parse the data set definition and process the source data, storing the
- * resulting data set as desired.  If the input name is NULL it will read
- * from standard input.
- */
-bool ProcessDefinition(std::string_view inName, const uint outRate, const ChannelModeT chanMode,
-    const bool farfield, const uint numThreads, const uint fftSize, const bool equalize,
-    const bool surface, const double limit, const uint truncSize, const HeadModelT model,
-    const double radius, const std::string_view outName)
+void CopyHrirData(const HrirDataT &src, HrirDataT *dst)
 {
-    HrirDataT hData;
-
-    fprintf(stdout, "Using %u thread%s.\n", numThreads, (numThreads==1)?"":"s");
-    if(inName.empty() || inName == "-"sv)
+    dst->mIrRate = src.mIrRate;
+    dst->mSampleType = src.mSampleType;
+    dst->mChannelType = src.mChannelType;
+    dst->mIrPoints = src.mIrPoints;
+    dst->mFftSize = src.mFftSize;
+    dst->mIrSize = src.mIrSize;
+    dst->mRadius = src.mRadius;
+    dst->mIrCount = src.mIrCount;
+
+    dst->mHrirsBase = src.mHrirsBase;
+    dst->mEvsBase = src.mEvsBase;
+    dst->mAzsBase = src.mAzsBase;
+    dst->mFds = src.mFds;
+
+    /* Rebase the spans from the source's storage onto the copy's. */
+    auto rebase = [](auto span, const auto &srcbase, auto &dstbase)
     {
-        inName = "stdin"sv;
-        fprintf(stdout, "Reading HRIR definition from %.*s...\n", al::sizei(inName),
-            inName.data());
-        if(!LoadDefInput(std::cin, {}, inName, fftSize, truncSize, outRate, chanMode, &hData))
-            return false;
-    }
-    else
+        if(span.empty())
+            return decltype(span){};
+        const auto offset = static_cast<size_t>(span.data() - srcbase.data());
+        return al::span{dstbase}.subspan(offset, span.size());
+    };
+    for(auto &field : dst->mFds)
+        field.mEvs = rebase(field.mEvs, src.mEvsBase, dst->mEvsBase);
+    for(auto &elev : dst->mEvsBase)
+        elev.mAzs = rebase(elev.mAzs, src.mAzsBase, dst->mAzsBase);
+    for(auto &azd : dst->mAzsBase)
     {
-        auto input = std::make_unique<std::ifstream>(std::filesystem::u8path(inName));
-        if(!input->is_open())
-        {
-            fprintf(stderr, "Error: Could not open input file '%.*s'\n", al::sizei(inName),
-                inName.data());
-            return false;
-        }
+        for(auto &ir : azd.mIrs)
+            ir = rebase(ir, src.mHrirsBase, dst->mHrirsBase);
+    }
+}
 
-        std::array<char,4> startbytes{};
-        input->read(startbytes.data(), startbytes.size());
-        if(input->gcount() != startbytes.size() || !input->good())
-        {
-            fprintf(stderr, "Error: Could not read input file '%.*s'\n", al::sizei(inName),
-                inName.data());
-            return false;
-        }
 
-        if(startbytes[0] == '\x89' && startbytes[1] == 'H' && startbytes[2] == 'D'
-            && startbytes[3] == 'F')
-        {
-            input = nullptr;
-            fprintf(stdout, "Reading HRTF data from %.*s...\n", al::sizei(inName),
-                inName.data());
-            if(!LoadSofaFile(inName, numThreads, fftSize, truncSize, outRate, chanMode, &hData))
-                return false;
-        }
-        else
-        {
-            fprintf(stdout, "Reading HRIR definition from %.*s...\n", al::sizei(inName),
-                inName.data());
-            if(!LoadDefInput(*input, startbytes, inName, fftSize, truncSize, outRate, chanMode,
-                &hData))
-                return false;
-        }
-    }
+namespace {
 
+/* Process the loaded data set, storing the resulting data set as desired. */
+bool ProcessHrirs(HrirDataT &hData, const bool farfield, const uint numThreads,
+    const bool equalize, const bool surface, const double limit, const uint truncSize,
+    const HeadModelT model, const double radius, const std::string_view outName)
+{
     if(equalize)
     {
         uint c{(hData.mChannelType == CT_STEREO) ? 2u : 1u};
@@ -1253,12 +1237,115 @@ bool ProcessDefinition(std::string_view inName, const uint outRate, const Channe
     return StoreMhr(&hData, expName);
 }
 
+/* Parse the data set definition and process the source data, storing the
+ * resulting data set for each of the given rates (0 for the source rate). If
+ * the input name is NULL it will read from standard input.
+ */
+bool ProcessDefinition(std::string_view inName, const al::span<const uint> outRates,
+    const ChannelModeT chanMode, const bool farfield, const uint numThreads, const uint fftSize,
+    const bool equalize, const bool surface, const double limit, const uint truncSize,
+    const HeadModelT model, const double radius, const std::string_view outName)
+{
+    auto process_hrirs = [=](HrirDataT &hData) -> bool
+    {
+        return ProcessHrirs(hData, farfield, numThreads, equalize, surface, limit, truncSize,
+            model, radius, outName);
+    };
+
+    fprintf(stdout, "Using %u thread%s.\n", numThreads, (numThreads==1)?"":"s");
+    if(inName.empty() || inName == "-"sv)
+    {
+        inName = "stdin"sv;
+        if(outRates.size() > 1)
+        {
+            fprintf(stderr, "Error: Multiple output rates can't be used with %.*s\n",
+                al::sizei(inName), inName.data());
+            return false;
+        }
+        fprintf(stdout, "Reading HRIR definition from %.*s...\n", al::sizei(inName),
+            inName.data());
+        HrirDataT hData;
+        if(!LoadDefInput(std::cin, {}, inName, fftSize, truncSize, outRates[0], chanMode,
+            &hData))
+            return false;
+        return process_hrirs(hData);
+    }
+
+    std::unique_ptr<std::ifstream> input;
+    std::array<char,4> startbytes{};
+    auto open_input = [inName,&input,&startbytes]() -> bool
+    {
+        input = std::make_unique<std::ifstream>(std::filesystem::u8path(inName));
+        if(!input->is_open())
+        {
+            fprintf(stderr, "Error: Could not open input file '%.*s'\n", al::sizei(inName),
+                inName.data());
+            return false;
+        }
+
+        input->read(startbytes.data(), startbytes.size());
+        if(input->gcount() != startbytes.size() || !input->good())
+        {
+            fprintf(stderr, "Error: Could not read input file '%.*s'\n", al::sizei(inName),
+                inName.data());
+            return false;
+        }
+        return true;
+    };
+    if(!open_input())
+        return false;
+
+    if(startbytes[0] == '\x89' && startbytes[1] == 'H' && startbytes[2] == 'D'
+        && startbytes[3] == 'F')
+    {
+        input = nullptr;
+        fprintf(stdout, "Reading HRTF data from %.*s...\n", al::sizei(inName), inName.data());
+        HrirDataT sofaData;
+        if(!LoadSofaFile(inName, fftSize, truncSize, chanMode, &sofaData))
+            return false;
+
+        /* The SOFA file is only loaded once, with each rate being prepared and
+         * processed from a copy of the loaded HRIRs.
+         */
+        for(const uint outRate : outRates)
+        {
+            HrirDataT hData;
+            CopyHrirData(sofaData, &hData);
+            PrepareSofaHrirs(outRate, numThreads, &hData);
+            if(!process_hrirs(hData))
+                return false;
+        }
+        return true;
+    }
+
+    /* The sources referenced by a definition are resampled as they're loaded,
+     * so the definition is read again for each rate.
+     */
+    for(size_t ri{0};ri < outRates.size();++ri)
+    {
+        if(ri > 0 && !open_input())
+            return false;
+
+        fprintf(stdout, "Reading HRIR definition from %.*s...\n", al::sizei(inName),
+            inName.data());
+        HrirDataT hData;
+        if(!LoadDefInput(*input, startbytes, inName, fftSize, truncSize, outRates[ri], chanMode,
+            &hData))
+            return false;
+        if(!process_hrirs(hData))
+            return false;
+    }
+    return true;
+}
+
 void PrintHelp(const std::string_view argv0, FILE *ofile)
 {
     fprintf(ofile, "Usage:  %.*s [<option>...]\n\n", al::sizei(argv0), argv0.data());
     fprintf(ofile, "Options:\n");
-    fprintf(ofile, " -r <rate>       Change the data set sample rate to the specified value and\n");
-    fprintf(ofile, "                 resample the HRIRs accordingly.\n");
+    fprintf(ofile, " -r <rate>[,...] Change the data set sample rate to the specified value and\n");
+    fprintf(ofile, "                 resample the HRIRs accordingly. A comma-separated list of\n");
+    fprintf(ofile, "                 rates creates a data set for each, which needs '%%r' in the\n");
+    fprintf(ofile, "                 output file name.\n");
     fprintf(ofile, " -m              Change the data set to mono, mirroring the left ear for the\n");
     fprintf(ofile, "                 right ear.\n");
     fprintf(ofile, " -a              Change the data set to single field, using the farthest field.\n");
@@ -1289,7 +1376,7 @@ int main(al::span<std::string_view> args)
     }
 
     std::string_view outName{"./oalsoft_hrtf_%r.mhr"sv};
-    uint outRate{0};
+    std::vector<uint> outRates{0u};
     ChannelModeT chanMode{CM_AllowStereo};
     uint fftSize{DefaultFftSize};
     bool equalize{DefaultEqualize};
@@ -1361,11 +1448,26 @@ int main(al::span<std::string_view> args)
         switch(opt)
         {
         case 'r':
-            outRate = static_cast<uint>(std::stoul(std::string{optarg}, &endpos, 10));
-            if(endpos != optarg.size() || outRate < MIN_RATE || outRate > MAX_RATE)
+            outRates.clear();
+            for(std::string_view rates{optarg};!rates.empty();)
             {
-                fprintf(stderr, "\nError: Got unexpected value \"%.*s\" for option -%c, expected between %u to %u.\n",
-                    al::sizei(optarg), optarg.data(), opt, MIN_RATE, MAX_RATE);
+                const auto ratestr = rates.substr(0, rates.find(','));
+                rates.remove_prefix(std::min(ratestr.size()+1, rates.size()));
+
+                const auto outRate = static_cast<uint>(std::stoul(std::string{ratestr}, &endpos,
+                    10));
+                if(endpos != ratestr.size() || outRate < MIN_RATE || outRate > MAX_RATE)
+                {
+                    fprintf(stderr, "\nError: Got unexpected value \"%.*s\" for option -%c, expected between %u to %u.\n",
+                        al::sizei(optarg), optarg.data(), opt, MIN_RATE, MAX_RATE);
+                    exit(EXIT_FAILURE);
+                }
+                if(std::find(outRates.cbegin(), outRates.cend(), outRate) == outRates.cend())
+                    outRates.emplace_back(outRate);
+            }
+            if(outRates.empty())
+            {
+                fprintf(stderr, "\nError: Missing rates for option -%c.\n", opt);
                 exit(EXIT_FAILURE);
             }
             break;
@@ -1493,7 +1595,13 @@ int main(al::span<std::string_view> args)
         }
     }
 
-    const int ret{ProcessDefinition(inName, outRate, chanMode, farfield, numThreads, fftSize,
+    if(outRates.size() > 1 && outName.find("%r"sv) == std::string_view::npos)
+    {
+        fprintf(stderr, "\nError: Multiple rates need '%%r' in the output file name.\n");
+        exit(EXIT_FAILURE);
+    }
+
+    const int ret{ProcessDefinition(inName, outRates, chanMode, farfield, numThreads, fftSize,
         equalize, surface, limit, truncSize, model, radius, outName)};
     if(!ret) return -1;
     fprintf(stdout, "Operation completed.\n");
@@ -112,7 +112,8 @@ struct HrirDataT {
 
     std::vector<HrirFdT> mFds;
 
-    /* GCC warns when it tries to inline this. */
+    /* GCC warns when it tries to inline these. */
+    HrirDataT();
     ~HrirDataT();
 };
 
@@ -121,6 +122,9 @@ bool PrepareHrirData(const al::span<const double> distances,
     const al::span<const uint,MAX_FD_COUNT> evCounts,
     const al::span<const std::array<uint,MAX_EV_COUNT>,MAX_FD_COUNT> azCounts, HrirDataT *hData);
 
+/* Copies the HRIR data set, with the new copy referencing its own storage. */
+void CopyHrirData(const HrirDataT &src, HrirDataT *dst);
+
 /* Calculate the magnitude response of the given input.  This is used in
  * place of phase decomposition, since the phase residuals are discarded for
  * minimum phase reconstruction.  The mirrored half of the response is also
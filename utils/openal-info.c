@@ -45,6 +45,15 @@
 #define FUNCTION_CAST(T, ptr) (T)(ptr)
 #endif
 
+#ifndef ALC_SOFT_device_query
+#define ALC_SOFT_device_query
+#define ALC_DEVICE_CONFIGURED_SOFT               0x1A01
+#define ALC_MIN_FREQUENCY_SOFT                   0x1A02
+#define ALC_MAX_FREQUENCY_SOFT                   0x1A03
+#define ALC_NUM_OUTPUT_MODES_SOFT                0x1A04
+#define ALC_OUTPUT_MODES_SOFT                    0x1A05
+#endif
+
 enum { MaxWidth = 80 };
 
 static void printList(const char *list, char separator)
@@ -189,30 +198,74 @@ static void printALCIntegerValue(ALCdevice *device, ALCenum enumValue, char* enu
         printf("%s: %d\n", enumName, value);
 }
 
+static const char *getOutputModeName(ALCenum mode)
+{
+    switch(mode)
+    {
+    case ALC_ANY_SOFT: return "Unknown / unspecified";
+    case ALC_MONO_SOFT: return "Mono";
+    case ALC_STEREO_SOFT: return "Stereo (unspecified encoding)";
+    case ALC_STEREO_BASIC_SOFT: return "Stereo (basic)";
+    case ALC_STEREO_UHJ_SOFT: return "Stereo (UHJ)";
+    case ALC_STEREO_HRTF_SOFT: return "Stereo (HRTF)";
+    case ALC_QUAD_SOFT: return "Quadraphonic";
+    case ALC_SURROUND_5_1_SOFT: return "5.1 Surround";
+    case ALC_SURROUND_6_1_SOFT: return "6.1 Surround";
+    case ALC_SURROUND_7_1_SOFT: return "7.1 Surround";
+    }
+    return "(error)";
+}
+
+/* Prints what the device can be set up with, which doesn't need a context. */
+static void printDeviceQueryInfo(ALCdevice *device)
+{
+    ALCint configured = ALC_FALSE;
+    ALCint minrate = 0, maxrate = 0;
+    ALCint num_modes = 0;
+
+    if(alcIsExtensionPresent(device, "ALC_SOFTX_device_query") == ALC_FALSE)
+    {
+        printf("Device query extension not available\n");
+        return;
+    }
+
+    alcGetIntegerv(device, ALC_DEVICE_CONFIGURED_SOFT, 1, &configured);
+    alcGetIntegerv(device, ALC_MIN_FREQUENCY_SOFT, 1, &minrate);
+    alcGetIntegerv(device, ALC_MAX_FREQUENCY_SOFT, 1, &maxrate);
+    if(checkALCErrors(device) != ALC_NO_ERROR)
+        return;
+    printf("Device configured: %s\n", (configured == ALC_TRUE) ? "yes" : "no");
+    printf("Supported sample rates: %dhz - %dhz\n", minrate, maxrate);
+
+    alcGetIntegerv(device, ALC_NUM_OUTPUT_MODES_SOFT, 1, &num_modes);
+    if(checkALCErrors(device) == ALC_NO_ERROR && num_modes > 0)
+    {
+        ALCint *modes = calloc((size_t)num_modes, sizeof(ALCint));
+        ALCint i;
+
+        assert(modes != NULL);
+        alcGetIntegerv(device, ALC_OUTPUT_MODES_SOFT, num_modes, modes);
+        if(checkALCErrors(device) == ALC_NO_ERROR)
+        {
+            printf("Supported output modes:\n");
+            for(i = 0;i < num_modes;++i)
+                printf("    %s\n", getOutputModeName(modes[i]));
+        }
+        free(modes);
+    }
+}
+
 static void printModeInfo(ALCdevice *device)
 {
     ALCint srate = 0;
 
     if(alcIsExtensionPresent(device, "ALC_SOFT_output_mode"))
     {
-        const char *modename = "(error)";
+        const char *modename;
         ALCenum mode = 0;
 
         alcGetIntegerv(device, ALC_OUTPUT_MODE_SOFT, 1, &mode);
-        checkALCErrors(device);
-        switch(mode)
-        {
-        case ALC_ANY_SOFT: modename = "Unknown / unspecified"; break;
-        case ALC_MONO_SOFT: modename = "Mono"; break;
-        case ALC_STEREO_SOFT: modename = "Stereo (unspecified encoding)"; break;
-        case ALC_STEREO_BASIC_SOFT: modename = "Stereo (basic)"; break;
-        case ALC_STEREO_UHJ_SOFT: modename = "Stereo (UHJ)"; break;
-        case ALC_STEREO_HRTF_SOFT: modename = "Stereo (HRTF)"; break;
-        case ALC_QUAD_SOFT: modename = "Quadraphonic"; break;
-        case ALC_SURROUND_5_1_SOFT: modename = "5.1 Surround"; break;
-        case ALC_SURROUND_6_1_SOFT: modename = "6.1 Surround"; break;
-        case ALC_SURROUND_7_1_SOFT: modename = "7.1 Surround"; break;
-        }
+        modename = (checkALCErrors(device) == ALC_NO_ERROR) ? getOutputModeName(mode) : "(error)";
         printf("Device output mode: %s\n", modename);
     }
     else
@@ -448,19 +501,30 @@ static void printEFXInfo(ALCdevice *device)
 
 int main(int argc, char *argv[])
 {
+    const char *devname = NULL;
+    int devonly = 0;
     ALCdevice *device;
     ALCcontext *context;
+    int i;
 
 #ifdef _WIN32
     /* OpenAL Soft gives UTF-8 strings, so set the console to expect that. */
     SetConsoleOutputCP(CP_UTF8);
 #endif
 
-    if(argc > 1 && (strcmp(argv[1], "--help") == 0 ||
-                    strcmp(argv[1], "-h") == 0))
+    for(i = 1;i < argc;++i)
     {
-        printf("Usage: %s [playback device]\n", argv[0]);
-        return 0;
+        if(strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0)
+        {
+            printf("Usage: %s [--device-only] [playback device]\n\n", argv[0]);
+            printf("  --device-only    Only print device information, without creating a\n"
+                   "                   context for it\n");
+            return 0;
+        }
+        if(strcmp(argv[i], "--device-only") == 0)
+            devonly = 1;
+        else
+            devname = argv[i];
     }
 
     printf("Available playback devices:\n");
@@ -482,16 +546,26 @@ int main(int argc, char *argv[])
 
     printALCInfo(NULL);
 
-    device = alcOpenDevice((argc>1) ? argv[1] : NULL);
+    device = alcOpenDevice(devname);
     if(!device)
     {
-        printf("\n!!! Failed to open %s !!!\n\n", ((argc>1) ? argv[1] : "default device"));
+        printf("\n!!! Failed to open %s !!!\n\n", devname ? devname : "default device");
         return 1;
     }
     printALCInfo(device);
     printHRTFInfo(device);
+    printDeviceQueryInfo(device);
     printALC_SOFT_system_event();
 
+    /* Creating a context sets up the device for mixing, which isn't needed
+     * for the device information.
+     */
+    if(devonly)
+    {
+        alcCloseDevice(device);
+        return 0;
+    }
+
     context = alcCreateContext(device, NULL);
     if(!context || alcMakeContextCurrent(context) == ALC_FALSE)
     {
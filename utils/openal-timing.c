@@ -0,0 +1,308 @@
+/*
+ * OpenAL Backend Timing Utility
+ *
+ * Copyright (c) 2026 by authors.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+/* This opens a playback device on each given backend, lets it run for a while
+ * with nothing playing, then reports the backend's update timing histograms:
+ * the jitter between wakeups, the delay from wakeup to rendering (wakeup
+ * slop), the render time, and the time to hand the samples to the output.
+ */
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#include "AL/alc.h"
+#include "AL/alext.h"
+
+#include "win_main_utf8.h"
+
+/* C doesn't allow casting between function and non-function pointer types, so
+ * with C99 we need to use a union to reinterpret the pointer type. Pre-C99
+ * still needs to use a normal cast and live with the warning.
+ */
+#if __STDC_VERSION__ >= 199901L
+#define FUNCTION_CAST(T, ptr) (union{void *p; T f;}){ptr}.f
+#else
+#define FUNCTION_CAST(T, ptr) (T)(ptr)
+#endif
+
+#ifndef ALC_SOFT_backend_timing
+#define ALC_SOFT_backend_timing
+#define ALC_BACKEND_TIMING_BUCKETS_SOFT          0x19F1
+#define ALC_BACKEND_TIMING_JITTER_SOFT           0x19F2
+#define ALC_BACKEND_TIMING_DISPATCH_SOFT         0x19F3
+#define ALC_BACKEND_TIMING_RENDER_SOFT           0x19F4
+#define ALC_BACKEND_TIMING_COMMIT_SOFT           0x19F5
+#endif
+
+#ifndef ALC_SOFT_mixer_profile
+#define ALC_SOFT_mixer_profile
+#define ALC_MIXER_PROFILE_SIZE_SOFT              0x19FD
+#define ALC_MIXER_PROFILE_SOFT                   0x19FE
+#endif
+
+#ifndef ALC_SOFT_output_xrun
+#define ALC_SOFT_output_xrun
+#define ALC_XRUN_COUNT_SOFT                      0x19EF
+#endif
+
+
+static void sleepSeconds(int seconds)
+{
+#ifdef _WIN32
+    Sleep((DWORD)seconds * 1000);
+#else
+    struct timespec ts;
+    ts.tv_sec = seconds;
+    ts.tv_nsec = 0;
+    while(nanosleep(&ts, &ts) != 0)
+    { }
+#endif
+}
+
+/* Returns the upper bound, in microseconds, of the bucket holding the given
+ * fraction of the total count.
+ */
+static long long bucketBound(const ALCint *counts, ALCint numbuckets, long long total,
+    double fraction)
+{
+    long long target = (long long)((double)total*fraction + 0.5);
+    long long sum = 0;
+    ALCint i;
+
+    if(target < 1) target = 1;
+    for(i = 0;i < numbuckets;++i)
+    {
+        sum += counts[i];
+        if(sum >= target) break;
+    }
+    if(i >= numbuckets) i = numbuckets-1;
+    return 1ll << i;
+}
+
+static void printStage(ALCdevice *device, const char *name, ALCenum param, ALCint *counts,
+    ALCint numbuckets)
+{
+    long long total = 0;
+    ALCint maxbucket = 0;
+    ALCint i;
+
+    alcGetIntegerv(device, param, numbuckets, counts);
+    for(i = 0;i < numbuckets;++i)
+    {
+        total += counts[i];
+        if(counts[i] > 0) maxbucket = i;
+    }
+
+    if(total == 0)
+    {
+        printf("    %-9s %8s\n", name, "-");
+        return;
+    }
+    printf("    %-9s %8lld  <%6lldus  <%6lldus  <%6lldus\n", name, total,
+        bucketBound(counts, numbuckets, total, 0.5), bucketBound(counts, numbuckets, total, 0.99),
+        1ll << maxbucket);
+}
+
+/* Prints the average time per update of each mixer stage, when the device has
+ * mixer profiling enabled (mixer-profile in the config).
+ */
+static void printMixerProfile(ALCdevice *device)
+{
+    static const char *names[] = {
+        "Params", "Voices", " HRTF", " NFC", "Effects", "Post", "Write"
+    };
+    LPALCGETINTEGER64VSOFT alcGetInteger64vSOFT;
+    ALCint64SOFT profile[32] = { 0 };
+    ALCint numcounters = 0;
+    int i;
+
+    alcGetInteger64vSOFT = FUNCTION_CAST(LPALCGETINTEGER64VSOFT,
+        alcGetProcAddress(device, "alcGetInteger64vSOFT"));
+    alcGetIntegerv(device, ALC_MIXER_PROFILE_SIZE_SOFT, 1, &numcounters);
+    if(!alcGetInteger64vSOFT || numcounters < 11 || numcounters > 32)
+        return;
+    alcGetInteger64vSOFT(device, ALC_MIXER_PROFILE_SOFT, numcounters, profile);
+    if(profile[0] <= 0)
+    {
+        printf("    Mixer profiling disabled\n");
+        return;
+    }
+
+    /* The counters are the update count, the stage times in nanoseconds, the
+     * peak update time, and the voices mixed and culled.
+     */
+    printf("    %-9s %8s\n", "Mixer", "Avg");
+    for(i = 0;i < 7;++i)
+        printf("    %-9s %6lldus\n", names[i], (long long)(profile[i+1]/profile[0]/1000));
+    printf("    Peak update %lldus, %.1f voices mixed, %.1f culled\n",
+        (long long)(profile[8]/1000), (double)profile[9]/(double)profile[0],
+        (double)profile[10]/(double)profile[0]);
+}
+
+static int measureBackend(const char *name, int seconds)
+{
+    ALCdevice *device;
+    ALCcontext *context;
+    ALCint numbuckets = 0;
+    ALCint freq = 0, refresh = 0, xruns = 0;
+    ALCint *counts;
+
+    device = alcOpenDevice(NULL);
+    if(!device)
+    {
+        printf("%s: not available\n", name);
+        return 1;
+    }
+    if(!alcIsExtensionPresent(device, "ALC_SOFTX_backend_timing"))
+    {
+        printf("%s: ALC_SOFTX_backend_timing not supported\n", name);
+        alcCloseDevice(device);
+        return 1;
+    }
+
+    context = alcCreateContext(device, NULL);
+    if(!context)
+    {
+        printf("%s: failed to create context: 0x%04x\n", name, alcGetError(device));
+        alcCloseDevice(device);
+        return 1;
+    }
+
+    sleepSeconds(seconds);
+
+    alcGetIntegerv(device, ALC_FREQUENCY, 1, &freq);
+    alcGetIntegerv(device, ALC_REFRESH, 1, &refresh);
+    if(alcIsExtensionPresent(device, "ALC_SOFTX_output_xrun"))
+        alcGetIntegerv(device, ALC_XRUN_COUNT_SOFT, 1, &xruns);
+    alcGetIntegerv(device, ALC_BACKEND_TIMING_BUCKETS_SOFT, 1, &numbuckets);
+
+    printf("%s: %s\n", name, alcGetString(device, ALC_ALL_DEVICES_SPECIFIER));
+    printf("    %dhz, %d updates per second, %d underruns\n", freq, refresh, xruns);
+    printf("    %-9s %8s  %8s  %8s  %8s\n", "Stage", "Count", "Median", "99%", "Max");
+
+    counts = calloc((size_t)(numbuckets > 0 ? numbuckets : 1), sizeof(*counts));
+    if(counts && numbuckets > 0)
+    {
+        printStage(device, "Jitter", ALC_BACKEND_TIMING_JITTER_SOFT, counts, numbuckets);
+        printStage(device, "Dispatch", ALC_BACKEND_TIMING_DISPATCH_SOFT, counts, numbuckets);
+        printStage(device, "Render", ALC_BACKEND_TIMING_RENDER_SOFT, counts, numbuckets);
+        printStage(device, "Commit", ALC_BACKEND_TIMING_COMMIT_SOFT, counts, numbuckets);
+    }
+    free(counts);
+
+    if(alcIsExtensionPresent(device, "ALC_SOFTX_mixer_profile"))
+        printMixerProfile(device);
+
+    alcDestroyContext(context);
+    alcCloseDevice(device);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    int seconds = 5;
+    int ret = 0;
+    int first = 1;
+
+    if(argc > 1 && (strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0))
+    {
+        printf("Usage: %s [-t <seconds>] [backends...]\n\n"
+            "Runs an idle playback device on each backend for the given time (default 5\n"
+            "seconds), and reports the timing of its periodic updates.\n", argv[0]);
+        return 0;
+    }
+    if(argc > 2 && strcmp(argv[1], "-t") == 0)
+    {
+        seconds = atoi(argv[2]);
+        if(seconds < 1) seconds = 1;
+        first = 3;
+    }
+
+#ifdef _WIN32
+    /* Without fork(), the library can only be initialized once, so test
+     * whichever backend it picks (set ALSOFT_DRIVERS to choose one).
+     */
+    if(first < argc)
+        fprintf(stderr, "Backend selection unsupported, set ALSOFT_DRIVERS instead\n");
+    ret = measureBackend("default", seconds);
+#else
+    /* The backend is chosen when the library initializes, so measure each one
+     * in a separate process with ALSOFT_DRIVERS limited to it.
+     */
+    {
+        static const char *DefaultBackends[] = {
+            "pipewire", "pulse", "alsa", "jack", "oss", "sndio", "solaris", "sdl2", "null"
+        };
+        const char **backends = (const char**)(argv + first);
+        int numbackends = argc - first;
+        int i;
+
+        if(numbackends == 0)
+        {
+            backends = DefaultBackends;
+            numbackends = (int)(sizeof(DefaultBackends)/sizeof(DefaultBackends[0]));
+        }
+        for(i = 0;i < numbackends;++i)
+        {
+            pid_t pid;
+            int status;
+
+            fflush(stdout);
+            pid = fork();
+            if(pid < 0)
+            {
+                perror("fork");
+                return 1;
+            }
+            if(pid == 0)
+            {
+                setenv("ALSOFT_DRIVERS", backends[i], 1);
+                exit(measureBackend(backends[i], seconds));
+            }
+            if(waitpid(pid, &status, 0) < 0 || !WIFEXITED(status))
+            {
+                printf("%s: measurement failed\n", backends[i]);
+                ret = 1;
+            }
+        }
+    }
+#endif
+
+    return ret;
+}
@@ -29,6 +29,7 @@
 #include <array>
 #include <cmath>
 #include <cstdio>
+#include <iterator>
 #include <utility>
 #include <vector>
 
@@ -46,7 +47,7 @@ using double3 = std::array<double,3>;
  * of other axes as necessary.  The epsilons are used to constrain the
  * equality of unique elements.
  */
-std::vector<double> GetUniquelySortedElems(const std::vector<double3> &aers, const uint axis,
+std::vector<double> GetUniquelySortedElems(const al::span<const double3> aers, const uint axis,
     const std::array<const double*,3> &filters, const std::array<double,3> &epsilons)
 {
     std::vector<double> elems;
@@ -178,7 +179,7 @@ const char *SofaErrorStr(int err)
     return "Unknown";
 }
 
-auto GetCompatibleLayout(const al::span<const float> xyzs) -> std::vector<SofaField>
+auto GetSofaPositions(const al::span<const float> xyzs) -> std::vector<double3>
 {
     auto aers = std::vector<double3>(xyzs.size()/3, double3{});
     for(size_t i{0u};i < aers.size();++i)
@@ -187,19 +188,35 @@ auto GetCompatibleLayout(const al::span<const float> xyzs) -> std::vector<SofaFi
         mysofa_c2s(vals.data());
         aers[i] = {vals[0], vals[1], vals[2]};
     }
+    return aers;
+}
+
+auto GetCompatibleLayout(const al::span<const float> xyzs) -> std::vector<SofaField>
+{ return GetCompatibleLayout(GetSofaPositions(xyzs)); }
 
-    auto radii = GetUniquelySortedElems(aers, 2, {}, {0.1, 0.1, 0.001});
+auto GetCompatibleLayout(const al::span<const double3> allAers) -> std::vector<SofaField>
+{
+    auto radii = GetUniquelySortedElems(allAers, 2, {}, {0.1, 0.1, 0.001});
     std::vector<SofaField> fds;
     fds.reserve(radii.size());
 
+    std::vector<double3> aers;
     for(const double dist : radii)
     {
-        auto elevs = GetUniquelySortedElems(aers, 1, {nullptr, nullptr, &dist}, {0.1, 0.1, 0.001});
+        /* Only the measurements on this field need to be scanned for its
+         * elevations and azimuths.
+         */
+        aers.clear();
+        std::copy_if(allAers.begin(), allAers.end(), std::back_inserter(aers),
+            [dist](const double3 &aer) { return !(std::abs(aer[2] - dist) > 0.001); });
+
+        auto elevs = GetUniquelySortedElems(aers, 1, {}, {0.1, 0.1, 0.001});
 
         /* Remove elevations that don't have a valid set of azimuths. */
-        auto invalid_elev = [&dist,&aers](const double ev) -> bool
+        auto invalid_elev = [&aers](const double ev) -> bool
         {
-            auto azims = GetUniquelySortedElems(aers, 0, {nullptr, &ev, &dist}, {0.1, 0.1, 0.001});
+            auto azims = GetUniquelySortedElems(aers, 0, {nullptr, &ev, nullptr},
+                {0.1, 0.1, 0.001});
 
             if(std::abs(ev) > 89.999)
                 return azims.size() != 1;
@@ -261,7 +278,8 @@ auto GetCompatibleLayout(const al::span<const float> xyzs) -> std::vector<SofaFi
         for(uint ei{evStart};ei < evCount;ei++)
         {
             double ev{-90.0 + ei*180.0/(evCount - 1)};
-            auto azims = GetUniquelySortedElems(aers, 0, {nullptr, &ev, &dist}, {0.1, 0.1, 0.001});
+            auto azims = GetUniquelySortedElems(aers, 0, {nullptr, &ev, nullptr},
+                {0.1, 0.1, 0.001});
 
             if(ei == 0 || ei == (evCount-1))
             {
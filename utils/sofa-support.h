@@ -1,6 +1,7 @@
 #ifndef UTILS_SOFA_SUPPORT_H
 #define UTILS_SOFA_SUPPORT_H
 
+#include <array>
 #include <cstddef>
 #include <memory>
 #include <vector>
@@ -27,6 +28,13 @@ struct SofaField {
 
 const char *SofaErrorStr(int err);
 
+/* Converts the cartesian source positions of each measurement to spherical
+ * (azimuth, elevation, radius) coordinates. This is done once per file, so
+ * the layout detection and response loading can share it.
+ */
+auto GetSofaPositions(al::span<const float> xyzs) -> std::vector<std::array<double,3>>;
+
+auto GetCompatibleLayout(al::span<const std::array<double,3>> aers) -> std::vector<SofaField>;
 auto GetCompatibleLayout(al::span<const float> xyzs) -> std::vector<SofaField>;
 
 #endif /* UTILS_SOFA_SUPPORT_H */
@@ -0,0 +1,157 @@
+
+#include "config.h"
+
+#include "uhj-support.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <exception>
+#include <string>
+
+
+SndFileReader::SndFileReader(SNDFILE *sndfile, int channels, std::size_t blockFrames,
+    std::size_t numBlocks)
+    : mFile{sndfile}, mChannels{static_cast<std::size_t>(channels)}, mBlockFrames{blockFrames}
+{
+    mBlocks.resize(std::max(numBlocks, std::size_t{2}));
+    for(auto &block : mBlocks)
+        block.resize(mBlockFrames*mChannels);
+    mBlockFramesRead.resize(mBlocks.size());
+    mThread = std::thread{&SndFileReader::readerProc, this};
+}
+
+SndFileReader::~SndFileReader()
+{
+    {
+        std::lock_guard<std::mutex> _{mLock};
+        mQuit = true;
+    }
+    mCond.notify_all();
+    mThread.join();
+}
+
+void SndFileReader::readerProc()
+{
+    std::unique_lock<std::mutex> lock{mLock};
+    while(!mQuit && !mEndOfFile)
+    {
+        if(mFilled == mBlocks.size())
+        {
+            mCond.wait(lock);
+            continue;
+        }
+
+        /* The block being written isn't touched by the caller until it's
+         * marked as filled, so the file can be read without the lock.
+         */
+        const std::size_t idx{mWriteIdx};
+        lock.unlock();
+        const auto got = std::max<sf_count_t>(sf_readf_float(mFile, mBlocks[idx].data(),
+            static_cast<sf_count_t>(mBlockFrames)), 0);
+        lock.lock();
+
+        mBlockFramesRead[idx] = got;
+        mWriteIdx = (idx+1) % mBlocks.size();
+        ++mFilled;
+        if(static_cast<std::size_t>(got) < mBlockFrames)
+            mEndOfFile = true;
+        mCond.notify_all();
+    }
+}
+
+auto SndFileReader::readf(al::span<float> dst) -> sf_count_t
+{
+    std::unique_lock<std::mutex> lock{mLock};
+    mCond.wait(lock, [this]{ return mFilled > 0 || mEndOfFile; });
+    if(mFilled == 0)
+        return 0;
+
+    /* Likewise, the block being read isn't touched by the reader thread until
+     * it's released.
+     */
+    const std::size_t idx{mReadIdx};
+    const sf_count_t got{mBlockFramesRead[idx]};
+    lock.unlock();
+    std::copy_n(mBlocks[idx].cbegin(), static_cast<std::size_t>(got)*mChannels, dst.begin());
+    lock.lock();
+
+    mReadIdx = (idx+1) % mBlocks.size();
+    --mFilled;
+    mCond.notify_all();
+    return got;
+}
+
+
+void JobLog::print(FILE *stream, const char *fmt, ...)
+{
+    std::va_list args, args2;
+    va_start(args, fmt);
+    va_copy(args2, args);
+    auto &entry = mEntries.emplace_back(Entry{stream, std::string(256, '\0')});
+    const int msglen{std::vsnprintf(entry.mText.data(), entry.mText.size(), fmt, args)};
+    if(msglen >= 0 && static_cast<std::size_t>(msglen) >= entry.mText.size())
+    {
+        entry.mText.resize(static_cast<std::size_t>(msglen)+1);
+        std::vsnprintf(entry.mText.data(), entry.mText.size(), fmt, args2);
+    }
+    entry.mText.resize(static_cast<std::size_t>(std::max(msglen, 0)));
+    va_end(args2);
+    va_end(args);
+}
+
+void JobLog::flush()
+{
+    static std::mutex outputLock;
+
+    std::lock_guard<std::mutex> _{outputLock};
+    for(const auto &entry : mEntries)
+    {
+        std::fputs(entry.mText.c_str(), entry.mStream);
+        std::fflush(entry.mStream);
+    }
+    mEntries.clear();
+}
+
+
+auto ParseJobCount(std::string_view str) -> std::optional<unsigned int>
+{
+    try {
+        std::size_t endpos{};
+        const auto value = std::stoul(std::string{str}, &endpos, 10);
+        if(endpos != str.size() || value > 256)
+            return std::nullopt;
+        if(value == 0)
+            return std::max(std::thread::hardware_concurrency(), 1u);
+        return static_cast<unsigned int>(value);
+    }
+    catch(std::exception&) {
+    }
+    return std::nullopt;
+}
+
+void RunJobs(std::size_t count, unsigned int numThreads,
+    const std::function<void(std::size_t)> &func)
+{
+    if(count == 0)
+        return;
+
+    std::atomic<std::size_t> next{0};
+    auto worker = [count,&next,&func]
+    {
+        std::size_t idx{next.fetch_add(1, std::memory_order_relaxed)};
+        for(;idx < count;idx = next.fetch_add(1, std::memory_order_relaxed))
+            func(idx);
+    };
+
+    /* The calling thread works on the jobs too, with any extra threads. */
+    numThreads = static_cast<unsigned int>(std::clamp<std::size_t>(numThreads, 1, count));
+    std::vector<std::thread> thrds;
+    thrds.reserve(numThreads-1);
+    for(unsigned int i{1};i < numThreads;++i)
+        thrds.emplace_back(worker);
+    worker();
+    for(auto &thrd : thrds)
+        thrd.join();
+}
@@ -0,0 +1,95 @@
+#ifndef UTILS_UHJ_SUPPORT_H
+#define UTILS_UHJ_SUPPORT_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "alspan.h"
+
+#include "sndfile.h"
+
+
+/* Reads sample frames from a sound file on a background thread, staying a
+ * number of blocks ahead of the caller, so decoding the file overlaps with
+ * processing the samples already read.
+ */
+class SndFileReader {
+    SNDFILE *mFile{};
+    std::size_t mChannels{};
+    std::size_t mBlockFrames{};
+
+    std::vector<std::vector<float>> mBlocks;
+    std::vector<sf_count_t> mBlockFramesRead;
+    std::size_t mReadIdx{0}, mWriteIdx{0}, mFilled{0};
+    bool mEndOfFile{false};
+    bool mQuit{false};
+
+    std::mutex mLock;
+    std::condition_variable mCond;
+    std::thread mThread;
+
+    void readerProc();
+
+public:
+    SndFileReader(SNDFILE *sndfile, int channels, std::size_t blockFrames,
+        std::size_t numBlocks=4);
+    SndFileReader(const SndFileReader&) = delete;
+    ~SndFileReader();
+
+    SndFileReader& operator=(const SndFileReader&) = delete;
+
+    /**
+     * Reads the next block of interleaved sample frames into dst, which must
+     * hold at least the block size given at construction. Returns the number
+     * of frames read, which is less than the block size at the end of the
+     * file (or on a read error).
+     */
+    auto readf(al::span<float> dst) -> sf_count_t;
+};
+
+
+/* Holds a file's status messages while it's being processed, so the messages
+ * of files processed in parallel don't interleave.
+ */
+class JobLog {
+    struct Entry {
+        FILE *mStream;
+        std::string mText;
+    };
+    std::vector<Entry> mEntries;
+
+public:
+#ifdef __MINGW32__
+    [[gnu::format(__MINGW_PRINTF_FORMAT,3,4)]]
+#else
+    [[gnu::format(printf,3,4)]]
+#endif
+    void print(FILE *stream, const char *fmt, ...);
+
+    /* Writes out the held messages, and clears them. */
+    void flush();
+};
+
+
+/**
+ * Parses the value of a -j/--jobs option, returning nullopt if it's invalid.
+ * A value of 0 selects the number of hardware threads.
+ */
+auto ParseJobCount(std::string_view str) -> std::optional<unsigned int>;
+
+/**
+ * Calls func for each index in [0, count), from up to numThreads threads at
+ * once. Each index is processed once, in no particular order.
+ */
+void RunJobs(std::size_t count, unsigned int numThreads,
+    const std::function<void(std::size_t)> &func);
+
+#endif /* UTILS_UHJ_SUPPORT_H */
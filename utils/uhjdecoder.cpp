@@ -26,6 +26,7 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <cerrno>
 #include <complex>
@@ -33,9 +34,11 @@
 #include <cstdio>
 #include <cstring>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <system_error>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -44,9 +47,10 @@
 #include "alnumbers.h"
 #include "alspan.h"
 #include "alstring.h"
-#include "vector.h"
+#include "core/uhjfilter.h"
 #include "opthelpers.h"
-#include "phase_shifter.h"
+#include "uhj-support.h"
+#include "vector.h"
 
 #include "sndfile.h"
 
@@ -112,6 +116,7 @@ using FloatBufferSpan = al::span<float,BufferLineSize>;
 
 struct UhjDecoder {
     constexpr static std::size_t sFilterDelay{1024};
+    using PhaseShifter = PhaseShiftFilter<sFilterDelay*2>;
 
     alignas(16) std::array<float,BufferLineSize+sFilterDelay> mS{};
     alignas(16) std::array<float,BufferLineSize+sFilterDelay> mD{};
@@ -124,15 +129,17 @@ struct UhjDecoder {
 
     alignas(16) std::array<float,BufferLineSize + sFilterDelay*2> mTemp{};
 
+    /* Temp storage for the FFT phase shift. */
+    alignas(16) std::array<float,PhaseShifter::sFftLength> mFftBuffer{};
+    alignas(16) std::array<float,PhaseShifter::sFftLength> mFftAccum{};
+    alignas(16) std::array<float,PhaseShifter::sFftLength> mWorkData{};
+
     void decode(const al::span<const float> InSamples, const std::size_t InChannels,
         const al::span<FloatBufferLine> OutSamples, const std::size_t SamplesToDo);
     void decode2(const al::span<const float> InSamples, const al::span<FloatBufferLine> OutSamples,
         const std::size_t SamplesToDo);
 };
 
-const PhaseShifterT<UhjDecoder::sFilterDelay*2> PShift{};
-
-
 /* Decoding UHJ is done as:
  *
  * S = Left + Right
@@ -211,6 +218,8 @@ void UhjDecoder::decode(const al::span<const float> InSamples, const std::size_t
 {
     ASSUME(SamplesToDo > 0);
 
+    const auto &PShift = GetPhaseShiftFilter<sFilterDelay*2>();
+
     auto woutput = al::span{OutSamples[0]};
     auto xoutput = al::span{OutSamples[1]};
     auto youtput = al::span{OutSamples[2]};
@@ -245,7 +254,8 @@ void UhjDecoder::decode(const al::span<const float> InSamples, const std::size_t
     std::transform(mD.cbegin(), mD.cbegin()+SamplesToDo+sFilterDelay, mT.cbegin(), tmpiter,
         [](const float d, const float t) noexcept { return 0.828331f*d + 0.767820f*t; });
     std::copy_n(mTemp.cbegin()+SamplesToDo, mDTHistory.size(), mDTHistory.begin());
-    PShift.process(xoutput.first(SamplesToDo), mTemp);
+    PShift.process(xoutput.first(SamplesToDo),
+        al::span{mTemp}.first(SamplesToDo+sFilterDelay*2-1), mFftBuffer, mFftAccum, mWorkData);
 
     for(std::size_t i{0};i < SamplesToDo;++i)
     {
@@ -259,7 +269,8 @@ void UhjDecoder::decode(const al::span<const float> InSamples, const std::size_t
     tmpiter = std::copy(mSHistory.cbegin(), mSHistory.cend(), mTemp.begin());
     std::copy_n(mS.cbegin(), SamplesToDo+sFilterDelay, tmpiter);
     std::copy_n(mTemp.cbegin()+SamplesToDo, mSHistory.size(), mSHistory.begin());
-    PShift.process(youtput.first(SamplesToDo), mTemp);
+    PShift.process(youtput.first(SamplesToDo),
+        al::span{mTemp}.first(SamplesToDo+sFilterDelay*2-1), mFftBuffer, mFftAccum, mWorkData);
 
     for(std::size_t i{0};i < SamplesToDo;++i)
     {
@@ -305,6 +316,8 @@ void UhjDecoder::decode2(const al::span<const float> InSamples,
 {
     ASSUME(SamplesToDo > 0);
 
+    const auto &PShift = GetPhaseShiftFilter<sFilterDelay*2>();
+
     auto woutput = al::span{OutSamples[0]};
     auto xoutput = al::span{OutSamples[1]};
     auto youtput = al::span{OutSamples[2]};
@@ -321,7 +334,8 @@ void UhjDecoder::decode2(const al::span<const float> InSamples,
     auto tmpiter = std::copy(mDTHistory.cbegin(), mDTHistory.cend(), mTemp.begin());
     std::copy_n(mD.cbegin(), SamplesToDo+sFilterDelay, tmpiter);
     std::copy_n(mTemp.cbegin()+SamplesToDo, mDTHistory.size(), mDTHistory.begin());
-    PShift.process(xoutput.first(SamplesToDo), mTemp);
+    PShift.process(xoutput.first(SamplesToDo),
+        al::span{mTemp}.first(SamplesToDo+sFilterDelay*2-1), mFftBuffer, mFftAccum, mWorkData);
 
     for(std::size_t i{0};i < SamplesToDo;++i)
     {
@@ -335,7 +349,8 @@ void UhjDecoder::decode2(const al::span<const float> InSamples,
     tmpiter = std::copy(mSHistory.cbegin(), mSHistory.cend(), mTemp.begin());
     std::copy_n(mS.cbegin(), SamplesToDo+sFilterDelay, tmpiter);
     std::copy_n(mTemp.cbegin()+SamplesToDo, mSHistory.size(), mSHistory.begin());
-    PShift.process(youtput.first(SamplesToDo), mTemp);
+    PShift.process(youtput.first(SamplesToDo),
+        al::span{mTemp}.first(SamplesToDo+sFilterDelay*2-1), mFftBuffer, mFftAccum, mWorkData);
 
     for(std::size_t i{0};i < SamplesToDo;++i)
     {
@@ -348,6 +363,166 @@ void UhjDecoder::decode2(const al::span<const float> InSamples,
 }
 
 
+/* Decodes the given file from UHJ, returning true on success. Messages are
+ * written to the given log, since multiple files may be decoded at once.
+ */
+bool DecodeFile(const std::string_view inname, const bool use_general, JobLog &log)
+{
+    SF_INFO ininfo{};
+    SndFilePtr infile{sf_open(std::string{inname}.c_str(), SFM_READ, &ininfo)};
+    if(!infile)
+    {
+        log.print(stderr, "Failed to open %.*s\n", al::sizei(inname), inname.data());
+        return false;
+    }
+    if(sf_command(infile.get(), SFC_WAVEX_GET_AMBISONIC, nullptr, 0) == SF_AMBISONIC_B_FORMAT)
+    {
+        log.print(stderr, "%.*s is already B-Format\n", al::sizei(inname), inname.data());
+        return false;
+    }
+    uint outchans{};
+    if(ininfo.channels == 2)
+        outchans = 3;
+    else if(ininfo.channels == 3 || ininfo.channels == 4)
+        outchans = static_cast<uint>(ininfo.channels);
+    else
+    {
+        log.print(stderr, "%.*s is not a 2-, 3-, or 4-channel file\n", al::sizei(inname),
+            inname.data());
+        return false;
+    }
+    log.print(stdout, "Converting %.*s from %d-channel UHJ%s...\n", al::sizei(inname),
+        inname.data(), ininfo.channels,
+        (ininfo.channels == 2) ? use_general ? " (general)" : " (alternative)" : "");
+
+    std::string outname{inname};
+    auto lastslash = outname.find_last_of('/');
+    if(lastslash != std::string::npos)
+        outname.erase(0, lastslash+1);
+    auto lastdot = outname.find_last_of('.');
+    if(lastdot != std::string::npos)
+        outname.resize(lastdot+1);
+    outname += "amb";
+
+    FilePtr outfile{fopen(outname.c_str(), "wb")};
+    if(!outfile)
+    {
+        log.print(stderr, "Failed to create %s\n", outname.c_str());
+        return false;
+    }
+
+    fputs("RIFF", outfile.get());
+    fwrite32le(0xFFFFFFFF, outfile.get()); // 'RIFF' header len; filled in at close
+
+    fputs("WAVE", outfile.get());
+
+    fputs("fmt ", outfile.get());
+    fwrite32le(40, outfile.get()); // 'fmt ' header len; 40 bytes for EXTENSIBLE
+
+    // 16-bit val, format type id (extensible: 0xFFFE)
+    fwrite16le(0xFFFE, outfile.get());
+    // 16-bit val, channel count
+    fwrite16le(static_cast<ushort>(outchans), outfile.get());
+    // 32-bit val, frequency
+    fwrite32le(static_cast<uint>(ininfo.samplerate), outfile.get());
+    // 32-bit val, bytes per second
+    fwrite32le(static_cast<uint>(ininfo.samplerate)*outchans*uint{sizeof(float)}, outfile.get());
+    // 16-bit val, frame size
+    fwrite16le(static_cast<ushort>(sizeof(float)*outchans), outfile.get());
+    // 16-bit val, bits per sample
+    fwrite16le(static_cast<ushort>(sizeof(float)*8), outfile.get());
+    // 16-bit val, extra byte count
+    fwrite16le(22, outfile.get());
+    // 16-bit val, valid bits per sample
+    fwrite16le(static_cast<ushort>(sizeof(float)*8), outfile.get());
+    // 32-bit val, channel mask
+    fwrite32le(0, outfile.get());
+    // 16 byte GUID, sub-type format
+    fwrite(SUBTYPE_BFORMAT_FLOAT.data(), 1, SUBTYPE_BFORMAT_FLOAT.size(), outfile.get());
+
+    fputs("data", outfile.get());
+    fwrite32le(0xFFFFFFFF, outfile.get()); // 'data' header len; filled in at close
+    if(ferror(outfile.get()))
+    {
+        const int err{errno};
+        log.print(stderr, "Error writing wave file header: %s (%d)\n",
+            std::generic_category().message(err).c_str(), err);
+        return false;
+    }
+
+    auto DataStart = ftell(outfile.get());
+
+    auto decoder = std::make_unique<UhjDecoder>();
+    auto inmem = std::vector<float>(size_t{BufferLineSize}*static_cast<uint>(ininfo.channels));
+    auto decmem = al::vector<std::array<float,BufferLineSize>, 16>(outchans);
+    auto outmem = std::vector<byte4>(size_t{BufferLineSize}*outchans);
+
+    /* Decode the input file ahead of the UHJ decoder on another thread. */
+    SndFileReader reader{infile.get(), ininfo.channels, BufferLineSize};
+
+    /* A number of initial samples need to be skipped to cut the lead-in from
+     * the all-pass filter delay. The same number of samples need to be fed
+     * through the decoder after reaching the end of the input file to ensure
+     * none of the original input is lost.
+     */
+    std::size_t LeadIn{UhjDecoder::sFilterDelay};
+    sf_count_t LeadOut{UhjDecoder::sFilterDelay};
+    while(LeadOut > 0)
+    {
+        sf_count_t sgot{reader.readf(inmem)};
+        if(sgot < BufferLineSize)
+        {
+            const sf_count_t remaining{std::min(BufferLineSize - sgot, LeadOut)};
+            std::fill_n(inmem.begin() + sgot*ininfo.channels, remaining*ininfo.channels, 0.0f);
+            sgot += remaining;
+            LeadOut -= remaining;
+        }
+
+        auto got = static_cast<std::size_t>(sgot);
+        if(ininfo.channels > 2 || use_general)
+            decoder->decode(inmem, static_cast<uint>(ininfo.channels), decmem, got);
+        else
+            decoder->decode2(inmem, decmem, got);
+        if(LeadIn >= got)
+        {
+            LeadIn -= got;
+            continue;
+        }
+
+        got -= LeadIn;
+        for(std::size_t i{0};i < got;++i)
+        {
+            /* Attenuate by -3dB for FuMa output levels. */
+            constexpr auto inv_sqrt2 = static_cast<float>(1.0/al::numbers::sqrt2);
+            for(std::size_t j{0};j < outchans;++j)
+                outmem[i*outchans + j] = f32AsLEBytes(decmem[j][LeadIn+i] * inv_sqrt2);
+        }
+        LeadIn = 0;
+
+        std::size_t wrote{fwrite(outmem.data(), sizeof(byte4)*outchans, got, outfile.get())};
+        if(wrote < got)
+        {
+            const int err{errno};
+            log.print(stderr, "Error writing wave data: %s (%d)\n",
+                std::generic_category().message(err).c_str(), err);
+            break;
+        }
+    }
+
+    auto DataEnd = ftell(outfile.get());
+    if(DataEnd > DataStart)
+    {
+        long dataLen{DataEnd - DataStart};
+        if(fseek(outfile.get(), 4, SEEK_SET) == 0)
+            fwrite32le(static_cast<uint>(DataEnd-8), outfile.get()); // 'WAVE' header len
+        if(fseek(outfile.get(), DataStart-4, SEEK_SET) == 0)
+            fwrite32le(static_cast<uint>(dataLen), outfile.get()); // 'data' header len
+    }
+    fflush(outfile.get());
+    return true;
+}
+
+
 int main(al::span<std::string_view> args)
 {
     if(args.size() < 2 || args[1] == "-h" || args[1] == "--help")
@@ -356,6 +531,8 @@ int main(al::span<std::string_view> args)
             "  Options:\n"
             "    --general      Use the general equations for 2-channel UHJ (default).\n"
             "    --alternative  Use the alternative equations for 2-channel UHJ.\n"
+            "    -j <count>     Number of files to decode at once (default: one per hardware\n"
+            "                   thread, also selected with 0).\n"
             "\n"
             "Note: When decoding 2-channel UHJ to an .amb file, the result should not use\n"
             "the normal B-Format shelf filters! Only 3- and 4-channel UHJ can accurately\n"
@@ -364,8 +541,14 @@ int main(al::span<std::string_view> args)
         return 1;
     }
 
-    std::size_t num_files{0}, num_decoded{0};
+    struct DecodeJob {
+        std::string_view mName;
+        bool mUseGeneral;
+    };
+    std::vector<DecodeJob> jobs;
+
     bool use_general{true};
+    uint numThreads{std::max(std::thread::hardware_concurrency(), 1u)};
     for(size_t fidx{1};fidx < args.size();++fidx)
     {
         if(args[fidx] == "--general")
@@ -378,163 +561,37 @@ int main(al::span<std::string_view> args)
             use_general = false;
             continue;
         }
-        ++num_files;
-        SF_INFO ininfo{};
-        SndFilePtr infile{sf_open(std::string{args[fidx]}.c_str(), SFM_READ, &ininfo)};
-        if(!infile)
-        {
-            fprintf(stderr, "Failed to open %.*s\n", al::sizei(args[fidx]), args[fidx].data());
-            continue;
-        }
-        if(sf_command(infile.get(), SFC_WAVEX_GET_AMBISONIC, nullptr, 0) == SF_AMBISONIC_B_FORMAT)
-        {
-            fprintf(stderr, "%.*s is already B-Format\n", al::sizei(args[fidx]),
-                args[fidx].data());
-            continue;
-        }
-        uint outchans{};
-        if(ininfo.channels == 2)
-            outchans = 3;
-        else if(ininfo.channels == 3 || ininfo.channels == 4)
-            outchans = static_cast<uint>(ininfo.channels);
-        else
-        {
-            fprintf(stderr, "%.*s is not a 2-, 3-, or 4-channel file\n", al::sizei(args[fidx]),
-                args[fidx].data());
-            continue;
-        }
-        printf("Converting %.*s from %d-channel UHJ%s...\n", al::sizei(args[fidx]),
-            args[fidx].data(), ininfo.channels,
-            (ininfo.channels == 2) ? use_general ? " (general)" : " (alternative)" : "");
-
-        std::string outname{args[fidx]};
-        auto lastslash = outname.find_last_of('/');
-        if(lastslash != std::string::npos)
-            outname.erase(0, lastslash+1);
-        auto lastdot = outname.find_last_of('.');
-        if(lastdot != std::string::npos)
-            outname.resize(lastdot+1);
-        outname += "amb";
-
-        FilePtr outfile{fopen(outname.c_str(), "wb")};
-        if(!outfile)
-        {
-            fprintf(stderr, "Failed to create %s\n", outname.c_str());
-            continue;
-        }
-
-        fputs("RIFF", outfile.get());
-        fwrite32le(0xFFFFFFFF, outfile.get()); // 'RIFF' header len; filled in at close
-
-        fputs("WAVE", outfile.get());
-
-        fputs("fmt ", outfile.get());
-        fwrite32le(40, outfile.get()); // 'fmt ' header len; 40 bytes for EXTENSIBLE
-
-        // 16-bit val, format type id (extensible: 0xFFFE)
-        fwrite16le(0xFFFE, outfile.get());
-        // 16-bit val, channel count
-        fwrite16le(static_cast<ushort>(outchans), outfile.get());
-        // 32-bit val, frequency
-        fwrite32le(static_cast<uint>(ininfo.samplerate), outfile.get());
-        // 32-bit val, bytes per second
-        fwrite32le(static_cast<uint>(ininfo.samplerate)*outchans*uint{sizeof(float)}, outfile.get());
-        // 16-bit val, frame size
-        fwrite16le(static_cast<ushort>(sizeof(float)*outchans), outfile.get());
-        // 16-bit val, bits per sample
-        fwrite16le(static_cast<ushort>(sizeof(float)*8), outfile.get());
-        // 16-bit val, extra byte count
-        fwrite16le(22, outfile.get());
-        // 16-bit val, valid bits per sample
-        fwrite16le(static_cast<ushort>(sizeof(float)*8), outfile.get());
-        // 32-bit val, channel mask
-        fwrite32le(0, outfile.get());
-        // 16 byte GUID, sub-type format
-        fwrite(SUBTYPE_BFORMAT_FLOAT.data(), 1, SUBTYPE_BFORMAT_FLOAT.size(), outfile.get());
-
-        fputs("data", outfile.get());
-        fwrite32le(0xFFFFFFFF, outfile.get()); // 'data' header len; filled in at close
-        if(ferror(outfile.get()))
+        if(args[fidx] == "-j")
         {
-            fprintf(stderr, "Error writing wave file header: %s (%d)\n",
-                std::generic_category().message(errno).c_str(), errno);
-            continue;
-        }
-
-        auto DataStart = ftell(outfile.get());
-
-        auto decoder = std::make_unique<UhjDecoder>();
-        auto inmem = std::vector<float>(size_t{BufferLineSize}*static_cast<uint>(ininfo.channels));
-        auto decmem = al::vector<std::array<float,BufferLineSize>, 16>(outchans);
-        auto outmem = std::vector<byte4>(size_t{BufferLineSize}*outchans);
-
-        /* A number of initial samples need to be skipped to cut the lead-in
-         * from the all-pass filter delay. The same number of samples need to
-         * be fed through the decoder after reaching the end of the input file
-         * to ensure none of the original input is lost.
-         */
-        std::size_t LeadIn{UhjDecoder::sFilterDelay};
-        sf_count_t LeadOut{UhjDecoder::sFilterDelay};
-        while(LeadOut > 0)
-        {
-            sf_count_t sgot{sf_readf_float(infile.get(), inmem.data(), BufferLineSize)};
-            sgot = std::max<sf_count_t>(sgot, 0);
-            if(sgot < BufferLineSize)
-            {
-                const sf_count_t remaining{std::min(BufferLineSize - sgot, LeadOut)};
-                std::fill_n(inmem.begin() + sgot*ininfo.channels, remaining*ininfo.channels, 0.0f);
-                sgot += remaining;
-                LeadOut -= remaining;
-            }
-
-            auto got = static_cast<std::size_t>(sgot);
-            if(ininfo.channels > 2 || use_general)
-                decoder->decode(inmem, static_cast<uint>(ininfo.channels), decmem, got);
-            else
-                decoder->decode2(inmem, decmem, got);
-            if(LeadIn >= got)
-            {
-                LeadIn -= got;
-                continue;
-            }
-
-            got -= LeadIn;
-            for(std::size_t i{0};i < got;++i)
+            auto count = (fidx+1 < args.size()) ? ParseJobCount(args[++fidx]) : std::nullopt;
+            if(!count)
             {
-                /* Attenuate by -3dB for FuMa output levels. */
-                constexpr auto inv_sqrt2 = static_cast<float>(1.0/al::numbers::sqrt2);
-                for(std::size_t j{0};j < outchans;++j)
-                    outmem[i*outchans + j] = f32AsLEBytes(decmem[j][LeadIn+i] * inv_sqrt2);
+                fprintf(stderr, "Invalid or missing job count for -j\n");
+                return 1;
             }
-            LeadIn = 0;
-
-            std::size_t wrote{fwrite(outmem.data(), sizeof(byte4)*outchans, got, outfile.get())};
-            if(wrote < got)
-            {
-                fprintf(stderr, "Error writing wave data: %s (%d)\n",
-                    std::generic_category().message(errno).c_str(), errno);
-                break;
-            }
-        }
-
-        auto DataEnd = ftell(outfile.get());
-        if(DataEnd > DataStart)
-        {
-            long dataLen{DataEnd - DataStart};
-            if(fseek(outfile.get(), 4, SEEK_SET) == 0)
-                fwrite32le(static_cast<uint>(DataEnd-8), outfile.get()); // 'WAVE' header len
-            if(fseek(outfile.get(), DataStart-4, SEEK_SET) == 0)
-                fwrite32le(static_cast<uint>(dataLen), outfile.get()); // 'data' header len
+            numThreads = *count;
+            continue;
         }
-        fflush(outfile.get());
-        ++num_decoded;
+        jobs.emplace_back(DecodeJob{args[fidx], use_general});
     }
+
+    /* Each file is decoded on its own thread, with a separate decoder. */
+    std::atomic<std::size_t> num_decoded{0};
+    RunJobs(jobs.size(), numThreads, [&jobs,&num_decoded](const size_t idx)
+    {
+        JobLog log;
+        if(DecodeFile(jobs[idx].mName, jobs[idx].mUseGeneral, log))
+            num_decoded.fetch_add(1, std::memory_order_relaxed);
+        log.flush();
+    });
+
+    const std::size_t num_files{jobs.size()};
     if(num_decoded == 0)
         fprintf(stderr, "Failed to decode any input files\n");
     else if(num_decoded < num_files)
-        fprintf(stderr, "Decoded %zu of %zu files\n", num_decoded, num_files);
+        fprintf(stderr, "Decoded %zu of %zu files\n", num_decoded.load(), num_files);
     else
-        printf("Decoded %zu file%s\n", num_decoded, (num_decoded==1)?"":"s");
+        printf("Decoded %zu file%s\n", num_decoded.load(), (num_decoded==1)?"":"s");
     return 0;
 }
 
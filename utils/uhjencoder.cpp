@@ -26,20 +26,24 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <cinttypes>
 #include <cmath>
 #include <cstddef>
 #include <cstdio>
 #include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <vector>
 
 #include "alnumbers.h"
 #include "alspan.h"
 #include "alstring.h"
-#include "phase_shifter.h"
+#include "core/uhjfilter.h"
+#include "uhj-support.h"
 #include "vector.h"
 
 #include "sndfile.h"
@@ -65,6 +69,7 @@ using FloatBufferSpan = al::span<float,BufferLineSize>;
 
 struct UhjEncoder {
     constexpr static size_t sFilterDelay{1024};
+    using PhaseShifter = PhaseShiftFilter<sFilterDelay*2>;
 
     /* Delays and processing storage for the unfiltered signal. */
     alignas(16) std::array<float,BufferLineSize+sFilterDelay> mW{};
@@ -82,13 +87,15 @@ struct UhjEncoder {
 
     alignas(16) std::array<float,BufferLineSize + sFilterDelay*2> mTemp{};
 
+    /* Temp storage for the FFT phase shift. */
+    alignas(16) std::array<float,PhaseShifter::sFftLength> mFftBuffer{};
+    alignas(16) std::array<float,PhaseShifter::sFftLength> mFftAccum{};
+    alignas(16) std::array<float,PhaseShifter::sFftLength> mWorkData{};
+
     void encode(const al::span<FloatBufferLine> OutSamples,
         const al::span<const FloatBufferLine,4> InSamples, const size_t SamplesToDo);
 };
 
-const PhaseShifterT<UhjEncoder::sFilterDelay*2> PShift{};
-
-
 /* Encoding UHJ from B-Format is done as:
  *
  * S = 0.9396926*W + 0.1855740*X
@@ -105,6 +112,8 @@ const PhaseShifterT<UhjEncoder::sFilterDelay*2> PShift{};
 void UhjEncoder::encode(const al::span<FloatBufferLine> OutSamples,
     const al::span<const FloatBufferLine,4> InSamples, const size_t SamplesToDo)
 {
+    const auto &PShift = GetPhaseShiftFilter<sFilterDelay*2>();
+
     const auto winput = al::span{InSamples[0]}.first(SamplesToDo);
     const auto xinput = al::span{InSamples[1]}.first(SamplesToDo);
     const auto yinput = al::span{InSamples[2]}.first(SamplesToDo);
@@ -126,7 +135,8 @@ void UhjEncoder::encode(const al::span<FloatBufferLine> OutSamples,
         [](const float w, const float x) noexcept -> float
         { return -0.3420201f*w + 0.5098604f*x; });
     std::copy_n(mTemp.cbegin()+SamplesToDo, mWXHistory1.size(), mWXHistory1.begin());
-    PShift.process(al::span{mD}.first(SamplesToDo), mTemp);
+    PShift.process(al::span{mD}.first(SamplesToDo),
+        al::span{mTemp}.first(SamplesToDo+sFilterDelay*2-1), mFftBuffer, mFftAccum, mWorkData);
 
     /* D = j(-0.3420201*W + 0.5098604*X) + 0.6554516*Y */
     for(size_t i{0};i < SamplesToDo;++i)
@@ -149,7 +159,8 @@ void UhjEncoder::encode(const al::span<FloatBufferLine> OutSamples,
             [](const float w, const float x) noexcept -> float
             { return -0.1432f*w + 0.6512f*x; });
         std::copy_n(mTemp.cbegin()+SamplesToDo, mWXHistory2.size(), mWXHistory2.begin());
-        PShift.process(al::span{mT}.first(SamplesToDo), mTemp);
+        PShift.process(al::span{mT}.first(SamplesToDo),
+        al::span{mTemp}.first(SamplesToDo+sFilterDelay*2-1), mFftBuffer, mFftAccum, mWorkData);
 
         /* T = j(-0.1432*W + 0.6512*X) - 0.7071068*Y */
         auto t = al::span{OutSamples[2]};
@@ -245,297 +256,342 @@ constexpr auto GenCoeffs(double x /*+front*/, double y /*+left*/, double z /*+up
 }
 
 
-int main(al::span<std::string_view> args)
+/* Encodes the given file to UHJ, returning true on success. Messages are
+ * written to the given log, since multiple files may be encoded at once.
+ */
+bool EncodeFile(const std::string_view inname, const uint uhjchans, JobLog &log)
 {
-    if(args.size() < 2 || args[1] == "-h" || args[1] == "--help")
+    std::string outname{inname};
+    size_t lastslash{outname.find_last_of('/')};
+    if(lastslash != std::string::npos)
+        outname.erase(0, lastslash+1);
+    size_t extpos{outname.find_last_of('.')};
+    if(extpos != std::string::npos)
+        outname.resize(extpos);
+    outname += ".uhj.flac";
+
+    SF_INFO ininfo{};
+    SndFilePtr infile{sf_open(std::string{inname}.c_str(), SFM_READ, &ininfo)};
+    if(!infile)
     {
-        printf("Usage: %.*s <infile...>\n\n", al::sizei(args[0]), args[0].data());
-        return 1;
+        log.print(stderr, "Failed to open %.*s\n", al::sizei(inname), inname.data());
+        return false;
     }
-
-    uint uhjchans{2};
-    size_t num_files{0}, num_encoded{0};
-    for(size_t fidx{1};fidx < args.size();++fidx)
+    log.print(stdout, "Converting %.*s to %s...\n", al::sizei(inname), inname.data(),
+        outname.c_str());
+
+    /* Work out the channel map, preferably using the actual channel map from
+     * the file/format, but falling back to assuming WFX order.
+     */
+    al::span<const SpeakerPos> spkrs;
+    auto chanmap = std::vector<int>(static_cast<uint>(ininfo.channels), SF_CHANNEL_MAP_INVALID);
+    if(sf_command(infile.get(), SFC_GET_CHANNEL_MAP_INFO, chanmap.data(),
+        ininfo.channels*int{sizeof(int)}) == SF_TRUE)
     {
-        if(args[fidx] == "-bhj")
+        static const std::array<int,1> monomap{{SF_CHANNEL_MAP_CENTER}};
+        static const std::array<int,2> stereomap{{SF_CHANNEL_MAP_LEFT, SF_CHANNEL_MAP_RIGHT}};
+        static const std::array<int,4> quadmap{{SF_CHANNEL_MAP_LEFT, SF_CHANNEL_MAP_RIGHT,
+            SF_CHANNEL_MAP_REAR_LEFT, SF_CHANNEL_MAP_REAR_RIGHT}};
+        static const std::array<int,6> x51map{{SF_CHANNEL_MAP_LEFT, SF_CHANNEL_MAP_RIGHT,
+            SF_CHANNEL_MAP_CENTER, SF_CHANNEL_MAP_LFE,
+            SF_CHANNEL_MAP_SIDE_LEFT, SF_CHANNEL_MAP_SIDE_RIGHT}};
+        static const std::array<int,6> x51rearmap{{SF_CHANNEL_MAP_LEFT, SF_CHANNEL_MAP_RIGHT,
+            SF_CHANNEL_MAP_CENTER, SF_CHANNEL_MAP_LFE,
+            SF_CHANNEL_MAP_REAR_LEFT, SF_CHANNEL_MAP_REAR_RIGHT}};
+        static const std::array<int,8> x71map{{SF_CHANNEL_MAP_LEFT, SF_CHANNEL_MAP_RIGHT,
+            SF_CHANNEL_MAP_CENTER, SF_CHANNEL_MAP_LFE,
+            SF_CHANNEL_MAP_REAR_LEFT, SF_CHANNEL_MAP_REAR_RIGHT,
+            SF_CHANNEL_MAP_SIDE_LEFT, SF_CHANNEL_MAP_SIDE_RIGHT}};
+        static const std::array<int,12> x714map{{SF_CHANNEL_MAP_LEFT, SF_CHANNEL_MAP_RIGHT,
+            SF_CHANNEL_MAP_CENTER, SF_CHANNEL_MAP_LFE,
+            SF_CHANNEL_MAP_REAR_LEFT, SF_CHANNEL_MAP_REAR_RIGHT,
+            SF_CHANNEL_MAP_SIDE_LEFT, SF_CHANNEL_MAP_SIDE_RIGHT,
+            SF_CHANNEL_MAP_TOP_FRONT_LEFT, SF_CHANNEL_MAP_TOP_FRONT_RIGHT,
+            SF_CHANNEL_MAP_TOP_REAR_LEFT, SF_CHANNEL_MAP_TOP_REAR_RIGHT}};
+        static const std::array<int,3> ambi2dmap{{SF_CHANNEL_MAP_AMBISONIC_B_W,
+            SF_CHANNEL_MAP_AMBISONIC_B_X, SF_CHANNEL_MAP_AMBISONIC_B_Y}};
+        static const std::array<int,4> ambi3dmap{{SF_CHANNEL_MAP_AMBISONIC_B_W,
+            SF_CHANNEL_MAP_AMBISONIC_B_X, SF_CHANNEL_MAP_AMBISONIC_B_Y,
+            SF_CHANNEL_MAP_AMBISONIC_B_Z}};
+
+        auto match_chanmap = [](const al::span<int> a, const al::span<const int> b) -> bool
         {
-            uhjchans = 2;
-            continue;
-        }
-        if(args[fidx] == "-thj")
+            if(a.size() != b.size())
+                return false;
+            auto find_channel = [b](const int id) -> bool
+            { return std::find(b.begin(), b.end(), id) != b.end(); };
+            return std::all_of(a.cbegin(), a.cend(), find_channel);
+        };
+        if(match_chanmap(chanmap, monomap))
+            spkrs = MonoMap;
+        else if(match_chanmap(chanmap, stereomap))
+            spkrs = StereoMap;
+        else if(match_chanmap(chanmap, quadmap))
+            spkrs = QuadMap;
+        else if(match_chanmap(chanmap, x51map))
+            spkrs = X51Map;
+        else if(match_chanmap(chanmap, x51rearmap))
+            spkrs = X51RearMap;
+        else if(match_chanmap(chanmap, x71map))
+            spkrs = X71Map;
+        else if(match_chanmap(chanmap, x714map))
+            spkrs = X714Map;
+        else if(match_chanmap(chanmap, ambi2dmap) || match_chanmap(chanmap, ambi3dmap))
         {
-            uhjchans = 3;
-            continue;
+            /* Do nothing. */
         }
-        if(args[fidx] == "-phj")
+        else
         {
-            uhjchans = 4;
-            continue;
+            std::string mapstr;
+            if(!chanmap.empty())
+            {
+                mapstr = std::to_string(chanmap[0]);
+                for(int idx : al::span<int>{chanmap}.subspan<1>())
+                {
+                    mapstr += ',';
+                    mapstr += std::to_string(idx);
+                }
+            }
+            log.print(stderr, " ... %zu channels not supported (map: %s)\n", chanmap.size(),
+                mapstr.c_str());
+            return false;
         }
-        ++num_files;
-
-        std::string outname{args[fidx]};
-        size_t lastslash{outname.find_last_of('/')};
-        if(lastslash != std::string::npos)
-            outname.erase(0, lastslash+1);
-        size_t extpos{outname.find_last_of('.')};
-        if(extpos != std::string::npos)
-            outname.resize(extpos);
-        outname += ".uhj.flac";
-
-        SF_INFO ininfo{};
-        SndFilePtr infile{sf_open(std::string{args[fidx]}.c_str(), SFM_READ, &ininfo)};
-        if(!infile)
+    }
+    else if(ininfo.channels == 1)
+    {
+        log.print(stderr, " ... assuming front-center\n");
+        spkrs = MonoMap;
+        chanmap[0] = SF_CHANNEL_MAP_CENTER;
+    }
+    else if(ininfo.channels == 2)
+    {
+        log.print(stderr, " ... assuming WFX order stereo\n");
+        spkrs = StereoMap;
+        chanmap[0] = SF_CHANNEL_MAP_LEFT;
+        chanmap[1] = SF_CHANNEL_MAP_RIGHT;
+    }
+    else if(ininfo.channels == 6)
+    {
+        log.print(stderr, " ... assuming WFX order 5.1\n");
+        spkrs = X51Map;
+        chanmap[0] = SF_CHANNEL_MAP_LEFT;
+        chanmap[1] = SF_CHANNEL_MAP_RIGHT;
+        chanmap[2] = SF_CHANNEL_MAP_CENTER;
+        chanmap[3] = SF_CHANNEL_MAP_LFE;
+        chanmap[4] = SF_CHANNEL_MAP_SIDE_LEFT;
+        chanmap[5] = SF_CHANNEL_MAP_SIDE_RIGHT;
+    }
+    else if(ininfo.channels == 8)
+    {
+        log.print(stderr, " ... assuming WFX order 7.1\n");
+        spkrs = X71Map;
+        chanmap[0] = SF_CHANNEL_MAP_LEFT;
+        chanmap[1] = SF_CHANNEL_MAP_RIGHT;
+        chanmap[2] = SF_CHANNEL_MAP_CENTER;
+        chanmap[3] = SF_CHANNEL_MAP_LFE;
+        chanmap[4] = SF_CHANNEL_MAP_REAR_LEFT;
+        chanmap[5] = SF_CHANNEL_MAP_REAR_RIGHT;
+        chanmap[6] = SF_CHANNEL_MAP_SIDE_LEFT;
+        chanmap[7] = SF_CHANNEL_MAP_SIDE_RIGHT;
+    }
+    else
+    {
+        log.print(stderr, " ... unmapped %d-channel audio not supported\n", ininfo.channels);
+        return false;
+    }
+
+    SF_INFO outinfo{};
+    outinfo.frames = ininfo.frames;
+    outinfo.samplerate = ininfo.samplerate;
+    outinfo.channels = static_cast<int>(uhjchans);
+    outinfo.format = SF_FORMAT_PCM_24 | SF_FORMAT_FLAC;
+    SndFilePtr outfile{sf_open(outname.c_str(), SFM_WRITE, &outinfo)};
+    if(!outfile)
+    {
+        log.print(stderr, " ... failed to create %s\n", outname.c_str());
+        return false;
+    }
+
+    auto encoder = std::make_unique<UhjEncoder>();
+    auto splbuf = al::vector<FloatBufferLine, 16>(9);
+    auto ambmem = al::span{splbuf}.subspan<0,4>();
+    auto encmem = al::span{splbuf}.subspan<4,4>();
+    auto srcmem = al::span{splbuf[8]};
+    auto membuf = al::vector<float,16>((static_cast<uint>(ininfo.channels)+size_t{uhjchans})
+        * BufferLineSize);
+    auto outmem = al::span{membuf}.first(size_t{BufferLineSize}*uhjchans);
+    auto inmem = al::span{membuf}.last(size_t{BufferLineSize}
+        * static_cast<uint>(ininfo.channels));
+
+    /* Decode the input file ahead of the encoder on another thread. */
+    SndFileReader reader{infile.get(), ininfo.channels, BufferLineSize};
+
+    /* A number of initial samples need to be skipped to cut the lead-in from
+     * the all-pass filter delay. The same number of samples need to be fed
+     * through the encoder after reaching the end of the input file to ensure
+     * none of the original input is lost.
+     */
+    size_t total_wrote{0};
+    size_t LeadIn{UhjEncoder::sFilterDelay};
+    sf_count_t LeadOut{UhjEncoder::sFilterDelay};
+    while(LeadIn > 0 || LeadOut > 0)
+    {
+        auto sgot = reader.readf(inmem);
+        if(sgot < BufferLineSize)
         {
-            fprintf(stderr, "Failed to open %.*s\n", al::sizei(args[fidx]), args[fidx].data());
-            continue;
+            const sf_count_t remaining{std::min(BufferLineSize - sgot, LeadOut)};
+            std::fill_n(inmem.begin() + sgot*ininfo.channels, remaining*ininfo.channels, 0.0f);
+            sgot += remaining;
+            LeadOut -= remaining;
         }
-        printf("Converting %.*s to %s...\n", al::sizei(args[fidx]), args[fidx].data(),
-            outname.c_str());
-
-        /* Work out the channel map, preferably using the actual channel map
-         * from the file/format, but falling back to assuming WFX order.
-         */
-        al::span<const SpeakerPos> spkrs;
-        auto chanmap = std::vector<int>(static_cast<uint>(ininfo.channels), SF_CHANNEL_MAP_INVALID);
-        if(sf_command(infile.get(), SFC_GET_CHANNEL_MAP_INFO, chanmap.data(),
-            ininfo.channels*int{sizeof(int)}) == SF_TRUE)
+
+        for(auto&& buf : ambmem)
+            buf.fill(0.0f);
+
+        auto got = static_cast<size_t>(sgot);
+        if(spkrs.empty())
         {
-            static const std::array<int,1> monomap{{SF_CHANNEL_MAP_CENTER}};
-            static const std::array<int,2> stereomap{{SF_CHANNEL_MAP_LEFT, SF_CHANNEL_MAP_RIGHT}};
-            static const std::array<int,4> quadmap{{SF_CHANNEL_MAP_LEFT, SF_CHANNEL_MAP_RIGHT,
-                SF_CHANNEL_MAP_REAR_LEFT, SF_CHANNEL_MAP_REAR_RIGHT}};
-            static const std::array<int,6> x51map{{SF_CHANNEL_MAP_LEFT, SF_CHANNEL_MAP_RIGHT,
-                SF_CHANNEL_MAP_CENTER, SF_CHANNEL_MAP_LFE,
-                SF_CHANNEL_MAP_SIDE_LEFT, SF_CHANNEL_MAP_SIDE_RIGHT}};
-            static const std::array<int,6> x51rearmap{{SF_CHANNEL_MAP_LEFT, SF_CHANNEL_MAP_RIGHT,
-                SF_CHANNEL_MAP_CENTER, SF_CHANNEL_MAP_LFE,
-                SF_CHANNEL_MAP_REAR_LEFT, SF_CHANNEL_MAP_REAR_RIGHT}};
-            static const std::array<int,8> x71map{{SF_CHANNEL_MAP_LEFT, SF_CHANNEL_MAP_RIGHT,
-                SF_CHANNEL_MAP_CENTER, SF_CHANNEL_MAP_LFE,
-                SF_CHANNEL_MAP_REAR_LEFT, SF_CHANNEL_MAP_REAR_RIGHT,
-                SF_CHANNEL_MAP_SIDE_LEFT, SF_CHANNEL_MAP_SIDE_RIGHT}};
-            static const std::array<int,12> x714map{{SF_CHANNEL_MAP_LEFT, SF_CHANNEL_MAP_RIGHT,
-                SF_CHANNEL_MAP_CENTER, SF_CHANNEL_MAP_LFE,
-                SF_CHANNEL_MAP_REAR_LEFT, SF_CHANNEL_MAP_REAR_RIGHT,
-                SF_CHANNEL_MAP_SIDE_LEFT, SF_CHANNEL_MAP_SIDE_RIGHT,
-                SF_CHANNEL_MAP_TOP_FRONT_LEFT, SF_CHANNEL_MAP_TOP_FRONT_RIGHT,
-                SF_CHANNEL_MAP_TOP_REAR_LEFT, SF_CHANNEL_MAP_TOP_REAR_RIGHT}};
-            static const std::array<int,3> ambi2dmap{{SF_CHANNEL_MAP_AMBISONIC_B_W,
-                SF_CHANNEL_MAP_AMBISONIC_B_X, SF_CHANNEL_MAP_AMBISONIC_B_Y}};
-            static const std::array<int,4> ambi3dmap{{SF_CHANNEL_MAP_AMBISONIC_B_W,
-                SF_CHANNEL_MAP_AMBISONIC_B_X, SF_CHANNEL_MAP_AMBISONIC_B_Y,
-                SF_CHANNEL_MAP_AMBISONIC_B_Z}};
-
-            auto match_chanmap = [](const al::span<int> a, const al::span<const int> b) -> bool
+            /* B-Format is already in the correct order. It just needs a +3dB
+             * boost.
+             */
+            static constexpr float scale{al::numbers::sqrt2_v<float>};
+            const size_t chans{std::min<size_t>(static_cast<uint>(ininfo.channels), 4u)};
+            for(size_t c{0};c < chans;++c)
             {
-                if(a.size() != b.size())
-                    return false;
-                auto find_channel = [b](const int id) -> bool
-                { return std::find(b.begin(), b.end(), id) != b.end(); };
-                return std::all_of(a.cbegin(), a.cend(), find_channel);
-            };
-            if(match_chanmap(chanmap, monomap))
-                spkrs = MonoMap;
-            else if(match_chanmap(chanmap, stereomap))
-                spkrs = StereoMap;
-            else if(match_chanmap(chanmap, quadmap))
-                spkrs = QuadMap;
-            else if(match_chanmap(chanmap, x51map))
-                spkrs = X51Map;
-            else if(match_chanmap(chanmap, x51rearmap))
-                spkrs = X51RearMap;
-            else if(match_chanmap(chanmap, x71map))
-                spkrs = X71Map;
-            else if(match_chanmap(chanmap, x714map))
-                spkrs = X714Map;
-            else if(match_chanmap(chanmap, ambi2dmap) || match_chanmap(chanmap, ambi3dmap))
-            {
-                /* Do nothing. */
+                for(size_t i{0};i < got;++i)
+                    ambmem[c][i] = inmem[i*static_cast<uint>(ininfo.channels) + c] * scale;
             }
-            else
+        }
+        else for(size_t idx{0};idx < chanmap.size();++idx)
+        {
+            const int chanid{chanmap[idx]};
+            /* Skip LFE. Or mix directly into W? Or W+X? */
+            if(chanid == SF_CHANNEL_MAP_LFE)
+                continue;
+
+            const auto spkr = std::find_if(spkrs.cbegin(), spkrs.cend(),
+                [chanid](const SpeakerPos pos){return pos.mChannelID == chanid;});
+            if(spkr == spkrs.cend())
             {
-                std::string mapstr;
-                if(!chanmap.empty())
-                {
-                    mapstr = std::to_string(chanmap[0]);
-                    for(int idx : al::span<int>{chanmap}.subspan<1>())
-                    {
-                        mapstr += ',';
-                        mapstr += std::to_string(idx);
-                    }
-                }
-                fprintf(stderr, " ... %zu channels not supported (map: %s)\n", chanmap.size(),
-                    mapstr.c_str());
+                log.print(stderr, " ... failed to find channel ID %d\n", chanid);
                 continue;
             }
+
+            for(size_t i{0};i < got;++i)
+                srcmem[i] = inmem[i*static_cast<uint>(ininfo.channels) + idx];
+
+            static constexpr auto Deg2Rad = al::numbers::pi / 180.0;
+            const auto coeffs = GenCoeffs(
+                std::cos(spkr->mAzimuth*Deg2Rad) * std::cos(spkr->mElevation*Deg2Rad),
+                std::sin(spkr->mAzimuth*Deg2Rad) * std::cos(spkr->mElevation*Deg2Rad),
+                std::sin(spkr->mElevation*Deg2Rad));
+            for(size_t c{0};c < 4;++c)
+            {
+                for(size_t i{0};i < got;++i)
+                    ambmem[c][i] += srcmem[i] * coeffs[c];
+            }
         }
-        else if(ininfo.channels == 1)
-        {
-            fprintf(stderr, " ... assuming front-center\n");
-            spkrs = MonoMap;
-            chanmap[0] = SF_CHANNEL_MAP_CENTER;
-        }
-        else if(ininfo.channels == 2)
+
+        encoder->encode(encmem.subspan(0, uhjchans), ambmem, got);
+        if(LeadIn >= got)
         {
-            fprintf(stderr, " ... assuming WFX order stereo\n");
-            spkrs = StereoMap;
-            chanmap[0] = SF_CHANNEL_MAP_LEFT;
-            chanmap[1] = SF_CHANNEL_MAP_RIGHT;
+            LeadIn -= got;
+            continue;
         }
-        else if(ininfo.channels == 6)
+
+        got -= LeadIn;
+        for(size_t c{0};c < uhjchans;++c)
         {
-            fprintf(stderr, " ... assuming WFX order 5.1\n");
-            spkrs = X51Map;
-            chanmap[0] = SF_CHANNEL_MAP_LEFT;
-            chanmap[1] = SF_CHANNEL_MAP_RIGHT;
-            chanmap[2] = SF_CHANNEL_MAP_CENTER;
-            chanmap[3] = SF_CHANNEL_MAP_LFE;
-            chanmap[4] = SF_CHANNEL_MAP_SIDE_LEFT;
-            chanmap[5] = SF_CHANNEL_MAP_SIDE_RIGHT;
+            static constexpr float max_val{8388607.0f / 8388608.0f};
+            for(size_t i{0};i < got;++i)
+                outmem[i*uhjchans + c] = std::clamp(encmem[c][LeadIn+i], -1.0f, max_val);
         }
-        else if(ininfo.channels == 8)
+        LeadIn = 0;
+
+        sf_count_t wrote{sf_writef_float(outfile.get(), outmem.data(),
+            static_cast<sf_count_t>(got))};
+        if(wrote < 0)
+            log.print(stderr, " ... failed to write samples: %d\n", sf_error(outfile.get()));
+        else
+            total_wrote += static_cast<size_t>(wrote);
+    }
+    log.print(stdout, " ... wrote %zu samples (%" PRId64 ").\n", total_wrote,
+        int64_t{ininfo.frames});
+    return true;
+}
+
+
+int main(al::span<std::string_view> args)
+{
+    if(args.size() < 2 || args[1] == "-h" || args[1] == "--help")
+    {
+        printf("Usage: %.*s <[options] infile...>\n\n"
+            "  Options:\n"
+            "    -bhj          Encode 2-channel UHJ (default).\n"
+            "    -thj          Encode 3-channel UHJ.\n"
+            "    -phj          Encode 4-channel UHJ.\n"
+            "    -j <count>    Number of files to encode at once (default: one per hardware\n"
+            "                  thread, also selected with 0).\n",
+            al::sizei(args[0]), args[0].data());
+        return 1;
+    }
+
+    struct EncodeJob {
+        std::string_view mName;
+        uint mUhjChannels;
+    };
+    std::vector<EncodeJob> jobs;
+
+    uint uhjchans{2};
+    uint numThreads{std::max(std::thread::hardware_concurrency(), 1u)};
+    for(size_t fidx{1};fidx < args.size();++fidx)
+    {
+        if(args[fidx] == "-bhj")
         {
-            fprintf(stderr, " ... assuming WFX order 7.1\n");
-            spkrs = X71Map;
-            chanmap[0] = SF_CHANNEL_MAP_LEFT;
-            chanmap[1] = SF_CHANNEL_MAP_RIGHT;
-            chanmap[2] = SF_CHANNEL_MAP_CENTER;
-            chanmap[3] = SF_CHANNEL_MAP_LFE;
-            chanmap[4] = SF_CHANNEL_MAP_REAR_LEFT;
-            chanmap[5] = SF_CHANNEL_MAP_REAR_RIGHT;
-            chanmap[6] = SF_CHANNEL_MAP_SIDE_LEFT;
-            chanmap[7] = SF_CHANNEL_MAP_SIDE_RIGHT;
+            uhjchans = 2;
+            continue;
         }
-        else
+        if(args[fidx] == "-thj")
         {
-            fprintf(stderr, " ... unmapped %d-channel audio not supported\n", ininfo.channels);
+            uhjchans = 3;
             continue;
         }
-
-        SF_INFO outinfo{};
-        outinfo.frames = ininfo.frames;
-        outinfo.samplerate = ininfo.samplerate;
-        outinfo.channels = static_cast<int>(uhjchans);
-        outinfo.format = SF_FORMAT_PCM_24 | SF_FORMAT_FLAC;
-        SndFilePtr outfile{sf_open(outname.c_str(), SFM_WRITE, &outinfo)};
-        if(!outfile)
+        if(args[fidx] == "-phj")
         {
-            fprintf(stderr, " ... failed to create %s\n", outname.c_str());
+            uhjchans = 4;
             continue;
         }
-
-        auto encoder = std::make_unique<UhjEncoder>();
-        auto splbuf = al::vector<FloatBufferLine, 16>(9);
-        auto ambmem = al::span{splbuf}.subspan<0,4>();
-        auto encmem = al::span{splbuf}.subspan<4,4>();
-        auto srcmem = al::span{splbuf[8]};
-        auto membuf = al::vector<float,16>((static_cast<uint>(ininfo.channels)+size_t{uhjchans})
-            * BufferLineSize);
-        auto outmem = al::span{membuf}.first(size_t{BufferLineSize}*uhjchans);
-        auto inmem = al::span{membuf}.last(size_t{BufferLineSize}
-            * static_cast<uint>(ininfo.channels));
-
-        /* A number of initial samples need to be skipped to cut the lead-in
-         * from the all-pass filter delay. The same number of samples need to
-         * be fed through the encoder after reaching the end of the input file
-         * to ensure none of the original input is lost.
-         */
-        size_t total_wrote{0};
-        size_t LeadIn{UhjEncoder::sFilterDelay};
-        sf_count_t LeadOut{UhjEncoder::sFilterDelay};
-        while(LeadIn > 0 || LeadOut > 0)
+        if(args[fidx] == "-j")
         {
-            auto sgot = sf_readf_float(infile.get(), inmem.data(), BufferLineSize);
-
-            sgot = std::max<sf_count_t>(sgot, 0);
-            if(sgot < BufferLineSize)
-            {
-                const sf_count_t remaining{std::min(BufferLineSize - sgot, LeadOut)};
-                std::fill_n(inmem.begin() + sgot*ininfo.channels, remaining*ininfo.channels, 0.0f);
-                sgot += remaining;
-                LeadOut -= remaining;
-            }
-
-            for(auto&& buf : ambmem)
-                buf.fill(0.0f);
-
-            auto got = static_cast<size_t>(sgot);
-            if(spkrs.empty())
+            auto count = (fidx+1 < args.size()) ? ParseJobCount(args[++fidx]) : std::nullopt;
+            if(!count)
             {
-                /* B-Format is already in the correct order. It just needs a
-                 * +3dB boost.
-                 */
-                static constexpr float scale{al::numbers::sqrt2_v<float>};
-                const size_t chans{std::min<size_t>(static_cast<uint>(ininfo.channels), 4u)};
-                for(size_t c{0};c < chans;++c)
-                {
-                    for(size_t i{0};i < got;++i)
-                        ambmem[c][i] = inmem[i*static_cast<uint>(ininfo.channels) + c] * scale;
-                }
+                fprintf(stderr, "Invalid or missing job count for -j\n");
+                return 1;
             }
-            else for(size_t idx{0};idx < chanmap.size();++idx)
-            {
-                const int chanid{chanmap[idx]};
-                /* Skip LFE. Or mix directly into W? Or W+X? */
-                if(chanid == SF_CHANNEL_MAP_LFE)
-                    continue;
-
-                const auto spkr = std::find_if(spkrs.cbegin(), spkrs.cend(),
-                    [chanid](const SpeakerPos pos){return pos.mChannelID == chanid;});
-                if(spkr == spkrs.cend())
-                {
-                    fprintf(stderr, " ... failed to find channel ID %d\n", chanid);
-                    continue;
-                }
-
-                for(size_t i{0};i < got;++i)
-                    srcmem[i] = inmem[i*static_cast<uint>(ininfo.channels) + idx];
-
-                static constexpr auto Deg2Rad = al::numbers::pi / 180.0;
-                const auto coeffs = GenCoeffs(
-                    std::cos(spkr->mAzimuth*Deg2Rad) * std::cos(spkr->mElevation*Deg2Rad),
-                    std::sin(spkr->mAzimuth*Deg2Rad) * std::cos(spkr->mElevation*Deg2Rad),
-                    std::sin(spkr->mElevation*Deg2Rad));
-                for(size_t c{0};c < 4;++c)
-                {
-                    for(size_t i{0};i < got;++i)
-                        ambmem[c][i] += srcmem[i] * coeffs[c];
-                }
-            }
-
-            encoder->encode(encmem.subspan(0, uhjchans), ambmem, got);
-            if(LeadIn >= got)
-            {
-                LeadIn -= got;
-                continue;
-            }
-
-            got -= LeadIn;
-            for(size_t c{0};c < uhjchans;++c)
-            {
-                static constexpr float max_val{8388607.0f / 8388608.0f};
-                for(size_t i{0};i < got;++i)
-                    outmem[i*uhjchans + c] = std::clamp(encmem[c][LeadIn+i], -1.0f, max_val);
-            }
-            LeadIn = 0;
-
-            sf_count_t wrote{sf_writef_float(outfile.get(), outmem.data(),
-                static_cast<sf_count_t>(got))};
-            if(wrote < 0)
-                fprintf(stderr, " ... failed to write samples: %d\n", sf_error(outfile.get()));
-            else
-                total_wrote += static_cast<size_t>(wrote);
+            numThreads = *count;
+            continue;
         }
-        printf(" ... wrote %zu samples (%" PRId64 ").\n", total_wrote, int64_t{ininfo.frames});
-        ++num_encoded;
+        jobs.emplace_back(EncodeJob{args[fidx], uhjchans});
     }
+
+    /* Each file is encoded on its own thread, with a separate encoder. */
+    std::atomic<size_t> num_encoded{0};
+    RunJobs(jobs.size(), numThreads, [&jobs,&num_encoded](const size_t idx)
+    {
+        JobLog log;
+        if(EncodeFile(jobs[idx].mName, jobs[idx].mUhjChannels, log))
+            num_encoded.fetch_add(1, std::memory_order_relaxed);
+        log.flush();
+    });
+
+    const size_t num_files{jobs.size()};
     if(num_encoded == 0)
         fprintf(stderr, "Failed to encode any input files\n");
     else if(num_encoded < num_files)
-        fprintf(stderr, "Encoded %zu of %zu files\n", num_encoded, num_files);
+        fprintf(stderr, "Encoded %zu of %zu files\n", num_encoded.load(), num_files);
     else
-        printf("Encoded %s%zu file%s\n", (num_encoded > 1) ? "all " : "", num_encoded,
+        printf("Encoded %s%zu file%s\n", (num_encoded > 1) ? "all " : "", num_encoded.load(),
             (num_encoded == 1) ? "" : "s");
     return 0;
 }